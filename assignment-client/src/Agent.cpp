@@ -54,6 +54,10 @@
 
 static const int RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES = 10;
 
+// a host runs an agent process for each of its bots, so what they leave unused isn't kept around in each of them,
+// it is read again from the disk cache that they share
+static const qint64 AGENT_UNUSED_RESOURCES_MAX_SIZE = 16 * BYTES_PER_MEGABYTES;
+
 Agent::Agent(ReceivedMessage& message) :
     ThreadedAssignment(message),
     _receivedAudioStream(RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES, RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES),
@@ -82,6 +86,10 @@ Agent::Agent(ReceivedMessage& message) :
     DependencyManager::set<RecordingScriptingInterface>();
     DependencyManager::set<UsersScriptingInterface>();
 
+    for (auto cache : ResourceCache::getCaches()) {
+        cache->setUnusedResourceCacheSize(AGENT_UNUSED_RESOURCES_MAX_SIZE);
+    }
+
     // Needed to ensure the creation of the DebugDraw instance on the main thread
     DebugDraw::getInstance();
 
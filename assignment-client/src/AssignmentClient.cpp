@@ -38,6 +38,7 @@
 
 #include "AssignmentClient.h"
 #include "AssignmentClientLogging.h"
+#include "MetricsServer.h"
 #include "avatars/ScriptableAvatar.h"
 #include <Trace.h>
 #include <StatTracker.h>
@@ -47,7 +48,8 @@ const long long ASSIGNMENT_REQUEST_INTERVAL_MSECS = 1 * 1000;
 
 AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QString assignmentPool,
                                    quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                   quint16 assignmentServerPort, quint16 assignmentMonitorPort) :
+                                   quint16 assignmentServerPort, quint16 assignmentMonitorPort,
+                                   quint16 metricsPort) :
     _assignmentServerHostname(DEFAULT_ASSIGNMENT_SERVER_HOSTNAME)
 {
     LogUtils::init();
@@ -116,6 +118,11 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
     // Create Singleton objects on main thread
     NetworkAccessManager::getInstance();
 
+    // the metrics of the assignments this client runs, for a scraper
+    if (metricsPort > 0) {
+        _metricsServer = new MetricsServer(metricsPort, this);
+    }
+
     // did we get an assignment-client monitor port?
     if (assignmentMonitorPort > 0) {
         _assignmentClientMonitorSocket = HifiSockAddr(DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME, assignmentMonitorPort);
@@ -17,6 +17,8 @@
 
 #include "ThreadedAssignment.h"
 
+class MetricsServer;
+
 class QSharedMemory;
 
 class AssignmentClient : public QObject {
@@ -25,7 +27,7 @@ public:
     AssignmentClient(Assignment::Type requestAssignmentType, QString assignmentPool,
                      quint16 listenPort,
                      QUuid walletUUID, QString assignmentServerHostname, quint16 assignmentServerPort,
-                     quint16 assignmentMonitorPort);
+                     quint16 assignmentMonitorPort, quint16 metricsPort);
     ~AssignmentClient();
 
 private slots:
@@ -53,6 +55,7 @@ private:
     QTimer _requestTimer; // timer for requesting and assignment
     QTimer _statsTimerACM; // timer for sending stats to assignment client monitor
     QUuid _childAssignmentUUID = QUuid::createUuid();
+    MetricsServer* _metricsServer { nullptr };
 
  protected:
     HifiSockAddr _assignmentClientMonitorSocket;
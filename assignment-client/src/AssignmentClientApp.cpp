@@ -84,6 +84,10 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     const QCommandLineOption httpStatusPortOption(ASSIGNMENT_HTTP_STATUS_PORT, "http status server port", "http-status-port");
     parser.addOption(httpStatusPortOption);
 
+    const QCommandLineOption metricsPortOption(ASSIGNMENT_METRICS_PORT_OPTION,
+        "serve OpenMetrics on this port (forked children use the ports that follow)", "metrics-port");
+    parser.addOption(metricsPortOption);
+
     const QCommandLineOption logDirectoryOption(ASSIGNMENT_LOG_DIRECTORY, "directory to store logs", "log-directory");
     parser.addOption(logDirectoryOption);
 
@@ -133,6 +137,11 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         httpStatusPort = parser.value(httpStatusPortOption).toUShort();
     }
 
+    quint16 metricsPort { 0 };
+    if (parser.isSet(metricsPortOption)) {
+        metricsPort = parser.value(metricsPortOption).toUShort();
+    }
+
     QString logDirectory;
 
     if (parser.isSet(logDirectoryOption)) {
@@ -224,13 +233,14 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         AssignmentClientMonitor* monitor =  new AssignmentClientMonitor(numForks, minForks, maxForks,
                                                                         requestAssignmentType, assignmentPool,
                                                                         listenPort, walletUUID, assignmentServerHostname,
-                                                                        assignmentServerPort, httpStatusPort, logDirectory);
+                                                                        assignmentServerPort, httpStatusPort, logDirectory,
+                                                                        metricsPort);
         monitor->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, monitor, &AssignmentClientMonitor::aboutToQuit);
     } else {
         AssignmentClient* client = new AssignmentClient(requestAssignmentType, assignmentPool, listenPort,
                                                         walletUUID, assignmentServerHostname,
-                                                        assignmentServerPort, monitorPort);
+                                                        assignmentServerPort, monitorPort, metricsPort);
         client->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, client, &AssignmentClient::aboutToQuit);
     }
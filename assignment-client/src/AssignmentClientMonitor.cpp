@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <memory>
 #include <signal.h>
 
@@ -28,12 +29,17 @@
 const QString ASSIGNMENT_CLIENT_MONITOR_TARGET_NAME = "assignment-client-monitor";
 const int WAIT_FOR_CHILD_MSECS = 1000;
 
+// the spares that were taken in this long are started again ahead of the next ones being needed
+const qint64 SPARE_DEMAND_WINDOW_MSECS = 60 * 1000;
+const unsigned int MAX_SPARE_CHILDREN = 4;
+
 AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmentClientForks,
                                                  const unsigned int minAssignmentClientForks,
                                                  const unsigned int maxAssignmentClientForks,
                                                  Assignment::Type requestAssignmentType, QString assignmentPool,
                                                  quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory) :
+                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory,
+                                                 quint16 metricsPort) :
     _httpManager(QHostAddress::LocalHost, httpStatusServerPort, "", this),
     _numAssignmentClientForks(numAssignmentClientForks),
     _minAssignmentClientForks(minAssignmentClientForks),
@@ -42,7 +48,8 @@ AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmen
     _assignmentPool(assignmentPool),
     _walletUUID(walletUUID),
     _assignmentServerHostname(assignmentServerHostname),
-    _assignmentServerPort(assignmentServerPort)
+    _assignmentServerPort(assignmentServerPort),
+    _metricsPort(metricsPort)
 
 {
     qDebug() << "_requestAssignmentType =" << _requestAssignmentType;
@@ -94,6 +101,11 @@ void AssignmentClientMonitor::simultaneousWaitOnChildren(int waitMsecs) {
 void AssignmentClientMonitor::childProcessFinished(qint64 pid, int exitCode, QProcess::ExitStatus exitStatus) {
     auto message = "Child process " + QString::number(pid) + " has %1 with exit code " + QString::number(exitCode) + ".";
 
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    // a child that doesn't get as far as being a spare is left to the next check, rather than started over and over
+    bool wasRunning = _childProcesses.contains(pid) &&
+        now - _childProcesses.value(pid).startTime > (qint64)NODE_SILENCE_THRESHOLD_MSECS;
+
     if (_childProcesses.remove(pid)) {
         message.append(" Removed from internal map.");
     } else {
@@ -108,10 +120,16 @@ void AssignmentClientMonitor::childProcessFinished(qint64 pid, int exitCode, QPr
             qCritical() << qPrintable(message.arg("crashed"));
             break;
     }
+
+    // what the child was doing is taken by a spare, start the one that takes its place
+    if (!_isStopping && wasRunning) {
+        checkSpares();
+    }
 }
 
 void AssignmentClientMonitor::stopChildProcesses() {
     qDebug() << "Stopping child processes";
+    _isStopping = true;
     auto nodeList = DependencyManager::get<NodeList>();
 
     // ask child processes to terminate
@@ -175,6 +193,25 @@ void AssignmentClientMonitor::spawnChildClient() {
     _childArguments.append("--" + PARENT_PID_OPTION);
     _childArguments.append(QString::number(QCoreApplication::applicationPid()));
 
+    // each child serves its metrics on the first port after ours that no other child uses
+    quint16 childMetricsPort = 0;
+    if (_metricsPort > 0) {
+        childMetricsPort = _metricsPort + 1;
+        bool isPortUsed = true;
+        while (isPortUsed) {
+            isPortUsed = false;
+            for (const auto& child : _childProcesses) {
+                if (child.metricsPort == childMetricsPort) {
+                    isPortUsed = true;
+                    ++childMetricsPort;
+                    break;
+                }
+            }
+        }
+        _childArguments.append("--" + ASSIGNMENT_METRICS_PORT_OPTION);
+        _childArguments.append(QString::number(childMetricsPort));
+    }
+
     QString nowString, stdoutFilenameTemp, stderrFilenameTemp, stdoutPathTemp, stderrPathTemp;
 
 
@@ -240,10 +277,19 @@ void AssignmentClientMonitor::spawnChildClient() {
 
         qDebug() << "Spawned a child client with PID" << assignmentClient->processId();
 
-        _childProcesses.insert(assignmentClient->processId(), { assignmentClient, stdoutPath, stderrPath });
+        _childProcesses.insert(assignmentClient->processId(), { assignmentClient, stdoutPath, stderrPath, childMetricsPort,
+                                                                  QDateTime::currentMSecsSinceEpoch() });
     }
 }
 
+unsigned int AssignmentClientMonitor::getWantedSpareCount() {
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    while (!_spareTakenTimes.empty() && now - _spareTakenTimes.front() > SPARE_DEMAND_WINDOW_MSECS) {
+        _spareTakenTimes.pop_front();
+    }
+    return std::min(1 + (unsigned int)_spareTakenTimes.size(), MAX_SPARE_CHILDREN);
+}
+
 void AssignmentClientMonitor::checkSpares() {
     auto nodeList = DependencyManager::get<NodeList>();
     QUuid aSpareId = "";
@@ -261,15 +307,21 @@ void AssignmentClientMonitor::checkSpares() {
         }
     });
 
+    // children that have been started but haven't told us about themselves yet will be spares
+    unsigned int startingCount = (unsigned int)std::max(_childProcesses.size() - (int)totalCount, 0);
+    unsigned int wantedSpareCount = getWantedSpareCount();
+
     // Spawn or kill children, as needed.  If --min or --max weren't specified, allow the child count
     // to drift up or down as far as needed.
-    if (spareCount < 1 || totalCount < _minAssignmentClientForks) {
-        if (!_maxAssignmentClientForks || totalCount < _maxAssignmentClientForks) {
-            spawnChildClient();
+    while (spareCount + startingCount < wantedSpareCount || totalCount + startingCount < _minAssignmentClientForks) {
+        if (_maxAssignmentClientForks && totalCount + startingCount >= _maxAssignmentClientForks) {
+            break;
         }
+        spawnChildClient();
+        ++startingCount;
     }
 
-    if (spareCount > 1) {
+    if (spareCount > wantedSpareCount) {
         if (!_minAssignmentClientForks || totalCount > _minAssignmentClientForks) {
             // kill aSpareId
             qDebug() << "asking child" << aSpareId << "to exit.";
@@ -328,10 +380,17 @@ void AssignmentClientMonitor::handleChildStatusPacket(QSharedPointer<ReceivedMes
         quint8 assignmentType;
         message->readPrimitive(&assignmentType);
 
+        bool wasSpare = childData->getChildType() == Assignment::Type::AllTypes;
         childData->setChildType(Assignment::Type(assignmentType));
 
         // note when this child talked
         matchingNode->setLastHeardMicrostamp(usecTimestampNow());
+
+        // a spare was handed an assignment, start its replacement now rather than at the next check
+        if (wasSpare && childData->getChildType() != Assignment::Type::AllTypes) {
+            _spareTakenTimes.push_back(QDateTime::currentMSecsSinceEpoch());
+            checkSpares();
+        }
     }
 }
 
@@ -347,6 +406,9 @@ bool AssignmentClientMonitor::handleHTTPRequest(HTTPConnection* connection, cons
             server["pid"] = ac.process->processId();
             server["logStdout"] = ac.logStdoutPath;
             server["logStderr"] = ac.logStderrPath;
+            if (ac.metricsPort > 0) {
+                server["metricsPort"] = ac.metricsPort;
+            }
 
             servers[QString::number(ac.process->processId())] = server;
         }
@@ -18,6 +18,8 @@
 #include <QtCore/QDateTime>
 #include <QDir>
 
+#include <deque>
+
 #include <Assignment.h>
 
 #include "AssignmentClientChildData.h"
@@ -30,6 +32,8 @@ struct ACProcess {
     QProcess* process; // looks like a dangling pointer, but is parented by the AssignmentClientMonitor 
     QString logStdoutPath;
     QString logStderrPath;
+    quint16 metricsPort;
+    qint64 startTime; // msecs since epoch
 };
 
 class AssignmentClientMonitor : public QObject, public HTTPRequestHandler {
@@ -38,7 +42,8 @@ public:
     AssignmentClientMonitor(const unsigned int numAssignmentClientForks, const unsigned int minAssignmentClientForks,
                             const unsigned int maxAssignmentClientForks, Assignment::Type requestAssignmentType,
                             QString assignmentPool, quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                            quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory);
+                            quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory,
+                            quint16 metricsPort);
     ~AssignmentClientMonitor();
 
     void stopChildProcesses();
@@ -55,6 +60,7 @@ public slots:
 private:
     void spawnChildClient();
     void simultaneousWaitOnChildren(int waitMsecs);
+    unsigned int getWantedSpareCount();
 
     QTimer _checkSparesTimer; // every few seconds see if it need fewer or more spare children
 
@@ -71,9 +77,14 @@ private:
     QUuid _walletUUID;
     QString _assignmentServerHostname;
     quint16 _assignmentServerPort;
+    quint16 _metricsPort;
 
     QMap<qint64, ACProcess> _childProcesses;
 
+    // when spares were last handed an assignment, so that there are as many of them idle as there was recent demand for
+    std::deque<qint64> _spareTakenTimes;
+    bool _isStopping { false };
+
     bool _wantsChildFileLogging { false };
 };
 
@@ -0,0 +1,40 @@
+//
+//  MetricsServer.cpp
+//  assignment-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MetricsServer.h"
+
+#include <shared/Metrics.h>
+#include <Trace.h>
+
+#include "AssignmentClientLogging.h"
+
+static const char* OPEN_METRICS_CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+static const char* TRACE_CONTENT_TYPE = "application/json";
+
+MetricsServer::MetricsServer(quint16 port, QObject* parent) :
+    QObject(parent),
+    _httpManager(QHostAddress::AnyIPv4, port, "", this)
+{
+    qCDebug(assignment_client) << "Serving metrics on port" << port;
+}
+
+bool MetricsServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    if (url.path() == "/metrics") {
+        connection->respond(HTTPConnection::StatusCode200, metrics::Registry::getInstance().toOpenMetrics(),
+                            OPEN_METRICS_CONTENT_TYPE);
+    } else if (url.path() == "/trace" && DependencyManager::isSet<tracing::Tracer>()) {
+        // the last seconds of the flight recorder, for chrome://tracing
+        connection->respond(HTTPConnection::StatusCode200, DependencyManager::get<tracing::Tracer>()->getRecording(),
+                            TRACE_CONTENT_TYPE);
+    } else {
+        connection->respond(HTTPConnection::StatusCode404);
+    }
+    return true;
+}
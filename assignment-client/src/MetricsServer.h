@@ -0,0 +1,32 @@
+//
+//  MetricsServer.h
+//  assignment-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MetricsServer_h
+#define hifi_MetricsServer_h
+
+#include <QtCore/QObject>
+
+#include <HTTPConnection.h>
+#include <HTTPManager.h>
+
+// Serves the metrics registry of this assignment-client at /metrics, in the OpenMetrics text format, and the
+// last seconds of its trace flight recorder at /trace
+class MetricsServer : public QObject, public HTTPRequestHandler {
+    Q_OBJECT
+public:
+    MetricsServer(quint16 port, QObject* parent = nullptr);
+
+    bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
+
+private:
+    HTTPManager _httpManager;
+};
+
+#endif // hifi_MetricsServer_h
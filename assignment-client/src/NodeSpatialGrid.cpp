@@ -0,0 +1,43 @@
+//
+//  NodeSpatialGrid.cpp
+//  assignment-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeSpatialGrid.h"
+
+void NodeSpatialGrid::sortIntoCells() {
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) {
+        return a.cell < b.cell;
+    });
+
+    int numEntries = (int)_entries.size();
+    for (int i = 0; i < numEntries;) {
+        int first = i;
+        CellKey cell = _entries[i].cell;
+        while (i < numEntries && _entries[i].cell == cell) {
+            ++i;
+        }
+        _cells[cell] = { first, i };
+    }
+}
+
+void NodeSpatialGrid::clear() {
+    _entries.clear();
+    _cells.clear();
+    _maxRadius = 0.0f;
+}
+
+NodeSpatialGrid::CellKey NodeSpatialGrid::cellForPosition(const glm::vec3& position) const {
+    return cellKey(glm::ivec3(glm::floor(position / _cellSize)));
+}
+
+NodeSpatialGrid::CellKey NodeSpatialGrid::cellKey(const glm::ivec3& cell) {
+    // pack 21 bits per axis, which covers any domain at the cell sizes the mixers use
+    static const uint64_t AXIS_MASK = (1 << 21) - 1;
+    return ((uint64_t)(cell.x & AXIS_MASK) << 42) | ((uint64_t)(cell.y & AXIS_MASK) << 21) | (uint64_t)(cell.z & AXIS_MASK);
+}
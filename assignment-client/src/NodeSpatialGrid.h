@@ -0,0 +1,151 @@
+//
+//  NodeSpatialGrid.h
+//  assignment-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeSpatialGrid_h
+#define hifi_NodeSpatialGrid_h
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <NodeList.h>
+
+// Uniform grid of the nodes' positions, rebuilt once per frame by a mixer and shared read-only by its slaves,
+// so that each listener only considers the nodes near it
+class NodeSpatialGrid {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    // locate(node, position, radius) places a node in the grid, with the radius of the sphere around its position
+    // that forEachTouching() looks for overlaps of, and returns false to leave it out
+    template <typename F>
+    void rebuild(ConstIter begin, ConstIter end, float cellSize, F locate);
+    void clear();
+
+    // the number of nodes in the grid
+    int size() const { return (int)_entries.size(); }
+
+    // calls functor(node) for every node within range of center
+    template <typename F>
+    void forEachInRange(const glm::vec3& center, float range, F functor) const;
+
+    // calls functor(node) for every node whose sphere overlaps the one of radius around center
+    template <typename F>
+    void forEachTouching(const glm::vec3& center, float radius, F functor) const;
+
+    // calls functor(node) for one of numSlices round-robin slices of all the nodes, chosen by frame
+    // this lets nodes outside of range still be visited every numSlices frames
+    template <typename F>
+    void forEachInSlice(int frame, int numSlices, F functor) const;
+
+private:
+    using CellKey = uint64_t;
+
+    struct Entry {
+        CellKey cell;
+        glm::vec3 position;
+        float radius;
+        SharedNodePointer node;
+    };
+
+    // calls functor(entry) for the entries of the cells that a sphere of range around center overlaps
+    template <typename F>
+    void forEachNear(const glm::vec3& center, float range, F functor) const;
+
+    void sortIntoCells();
+    CellKey cellForPosition(const glm::vec3& position) const;
+    static CellKey cellKey(const glm::ivec3& cell);
+
+    float _cellSize { 0.0f };
+    float _maxRadius { 0.0f };
+
+    std::vector<Entry> _entries; // sorted by cell
+    std::unordered_map<CellKey, std::pair<int, int>> _cells; // cell -> range of _entries
+};
+
+template <typename F>
+void NodeSpatialGrid::rebuild(ConstIter begin, ConstIter end, float cellSize, F locate) {
+    clear();
+    _cellSize = cellSize;
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        glm::vec3 position;
+        float radius = 0.0f;
+        if (locate(node, position, radius)) {
+            _entries.push_back({ cellForPosition(position), position, radius, node });
+            _maxRadius = std::max(_maxRadius, radius);
+        }
+    });
+
+    sortIntoCells();
+}
+
+template <typename F>
+void NodeSpatialGrid::forEachNear(const glm::vec3& center, float range, F functor) const {
+    if (_entries.empty()) {
+        return;
+    }
+
+    glm::ivec3 minCell = glm::ivec3(glm::floor((center - range) / _cellSize));
+    glm::ivec3 maxCell = glm::ivec3(glm::floor((center + range) / _cellSize));
+
+    for (int x = minCell.x; x <= maxCell.x; ++x) {
+        for (int y = minCell.y; y <= maxCell.y; ++y) {
+            for (int z = minCell.z; z <= maxCell.z; ++z) {
+                auto it = _cells.find(cellKey(glm::ivec3(x, y, z)));
+                if (it == _cells.end()) {
+                    continue;
+                }
+
+                for (int i = it->second.first; i < it->second.second; ++i) {
+                    functor(_entries[i]);
+                }
+            }
+        }
+    }
+}
+
+template <typename F>
+void NodeSpatialGrid::forEachInRange(const glm::vec3& center, float range, F functor) const {
+    float rangeSquared = range * range;
+    forEachNear(center, range, [&](const Entry& entry) {
+        if (glm::distance2(entry.position, center) <= rangeSquared) {
+            functor(entry.node);
+        }
+    });
+}
+
+template <typename F>
+void NodeSpatialGrid::forEachTouching(const glm::vec3& center, float radius, F functor) const {
+    // an entry is in the cell of its position, so the cells to look in reach as far as the largest sphere does
+    forEachNear(center, radius + _maxRadius, [&](const Entry& entry) {
+        float range = radius + entry.radius;
+        if (glm::distance2(entry.position, center) <= range * range) {
+            functor(entry.node);
+        }
+    });
+}
+
+template <typename F>
+void NodeSpatialGrid::forEachInSlice(int frame, int numSlices, F functor) const {
+    int numEntries = (int)_entries.size();
+    int slice = frame % numSlices;
+    int begin = (slice * numEntries) / numSlices;
+    int end = ((slice + 1) * numEntries) / numSlices;
+
+    for (int i = begin; i < end; ++i) {
+        functor(_entries[i].node);
+    }
+}
+
+#endif // hifi_NodeSpatialGrid_h
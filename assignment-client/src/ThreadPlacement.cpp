@@ -0,0 +1,129 @@
+//
+//  ThreadPlacement.cpp
+//  assignment-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ThreadPlacement.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+
+#if defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+// the cores the process may run on, as narrowed by taskset or a cpuset
+static std::vector<int> readAllowedCores() {
+    std::vector<int> cores;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int i = 0; i < CPU_SETSIZE; ++i) {
+            if (CPU_ISSET(i, &allowed)) {
+                cores.push_back(i);
+            }
+        }
+    }
+    if (cores.empty()) {
+        int numCores = std::max((int)std::thread::hardware_concurrency(), 1);
+        for (int i = 0; i < numCores; ++i) {
+            cores.push_back(i);
+        }
+    }
+    return cores;
+}
+
+// read at startup, before any thread is pinned and narrows what the affinity of the threads it starts says
+static const std::vector<int> ALLOWED_CORES = readAllowedCores();
+
+// parses a kernel cpu list, e.g. "0-7,16-23"
+static std::vector<int> parseCoreList(const QString& list) {
+    std::vector<int> cores;
+    for (const auto& range : list.trimmed().split(',', QString::SkipEmptyParts)) {
+        auto bounds = range.split('-');
+        bool isFirstValid = false;
+        bool isLastValid = false;
+        int first = bounds[0].toInt(&isFirstValid);
+        int last = (bounds.size() > 1) ? bounds[1].toInt(&isLastValid) : first;
+        if (!isFirstValid || (bounds.size() > 1 && !isLastValid)) {
+            continue;
+        }
+        for (int core = first; core <= last; ++core) {
+            cores.push_back(core);
+        }
+    }
+    return cores;
+}
+
+// the cores of the NUMA node the core is on, empty where nodes are unknown
+static std::vector<int> getNodeCores(int core) {
+    QDir nodesDirectory("/sys/devices/system/node");
+    for (const auto& node : nodesDirectory.entryList({ "node*" }, QDir::Dirs)) {
+        QFile listFile(nodesDirectory.absoluteFilePath(node + "/cpulist"));
+        if (!listFile.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        auto cores = parseCoreList(QString::fromLatin1(listFile.readAll()));
+        if (std::find(cores.begin(), cores.end(), core) != cores.end()) {
+            return cores;
+        }
+    }
+    return std::vector<int>();
+}
+#endif
+
+std::vector<int> getThreadPlacementCores(int firstCore) {
+#if defined(Q_OS_LINUX)
+    auto cores = ALLOWED_CORES;
+    auto first = std::find(cores.begin(), cores.end(), firstCore);
+    if (first == cores.end()) {
+        return cores;
+    }
+
+    // the first core, then the rest of its node, then the other nodes, each in order on from the first core
+    auto nodeCores = getNodeCores(firstCore);
+    auto isOnNode = [&](int core) {
+        return std::find(nodeCores.begin(), nodeCores.end(), core) != nodeCores.end();
+    };
+    std::rotate(cores.begin(), first, cores.end());
+    std::stable_partition(cores.begin() + 1, cores.end(), isOnNode);
+    return cores;
+#else
+    Q_UNUSED(firstCore);
+    int numCores = std::max((int)std::thread::hardware_concurrency(), 1);
+    std::vector<int> cores;
+    for (int i = 0; i < numCores; ++i) {
+        cores.push_back(i);
+    }
+    return cores;
+#endif
+}
+
+bool pinThreadToCore(int core) {
+#if defined(Q_OS_LINUX)
+    cpu_set_t cores;
+    CPU_ZERO(&cores);
+    if (core < 0) {
+        for (int allowedCore : ALLOWED_CORES) {
+            CPU_SET(allowedCore, &cores);
+        }
+    } else {
+        CPU_SET(core, &cores);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores) == 0;
+#else
+    Q_UNUSED(core);
+    return false;
+#endif
+}
@@ -0,0 +1,31 @@
+//
+//  ThreadPlacement.h
+//  assignment-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ThreadPlacement_h
+#define hifi_ThreadPlacement_h
+
+#include <vector>
+
+// Placement of the threads of a mixer on the cores of its host (only Linux is supported).
+//
+// A mixer keeps the first cores of getThreadPlacementCores() for its own thread and the socket's, and pins its slaves
+// to the cores after them. The cores on the NUMA node of the first core come first there, so that a pool no larger
+// than a node runs on that node alone, and the memory its threads touch first (mix buffers, per-listener data) is
+// allocated on it too.
+
+// the cores the process may run on, the first core and the others of its NUMA node first, then those of the other nodes
+// never empty, all of them are returned in order if the process may not run on the first core
+std::vector<int> getThreadPlacementCores(int firstCore);
+
+// pins the calling thread to a core, or lets it run on any core the process may run on (core < 0)
+// returns false if it was not permitted
+bool pinThreadToCore(int core);
+
+#endif // hifi_ThreadPlacement_h
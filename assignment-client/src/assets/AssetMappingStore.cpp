@@ -0,0 +1,253 @@
+//
+//  AssetMappingStore.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingStore.h"
+
+#include <algorithm>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+static const QString MAP_FILE_NAME = "map.json";
+static const QString JOURNAL_FILE_NAME = "map.log";
+
+// the journal isn't folded into the snapshot before it has this many changes, however few mappings there are
+static const int MIN_JOURNAL_CHANGES_TO_COMPACT = 1000;
+
+static const QDataStream::Version JOURNAL_STREAM_VERSION = QDataStream::Qt_5_6;
+
+static bool isValidMapping(const AssetPath& path, const AssetHash& hash) {
+    if (!isValidFilePath(path)) {
+        qWarning() << "Will not keep mapping for" << path << "since it is not a valid path.";
+        return false;
+    }
+    if (!isValidHash(hash)) {
+        qWarning() << "Will not keep mapping for" << path << "since it does not have a valid hash.";
+        return false;
+    }
+    return true;
+}
+
+bool AssetMappingStore::load(const QDir& directory) {
+    _directory = directory;
+    _mappings.clear();
+    _hashPathCounts.clear();
+    _pendingChanges.clear();
+    _journalChangeCount = 0;
+
+    if (!loadSnapshot() || !replayJournal()) {
+        return false;
+    }
+
+    qInfo() << "Loaded" << _mappings.size() << "mappings from" << _directory.absolutePath() << "with"
+        << _journalChangeCount << "changes from the journal";
+    return true;
+}
+
+bool AssetMappingStore::loadSnapshot() {
+    auto mapFilePath = _directory.absoluteFilePath(MAP_FILE_NAME);
+
+    QFile mapFile { mapFilePath };
+    if (!mapFile.exists()) {
+        qInfo() << "No existing mappings loaded from file since no file was found at" << mapFilePath;
+        return true;
+    }
+
+    if (mapFile.open(QIODevice::ReadOnly)) {
+        QJsonParseError error;
+        auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
+
+        if (error.error == QJsonParseError::NoError) {
+            auto jsonObject = jsonDocument.object();
+            for (auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); ++it) {
+                auto hash = it.value().toString();
+                // remove any mappings that don't match the expected format
+                if (isValidMapping(it.key(), hash)) {
+                    apply(it.key(), hash);
+                }
+            }
+            return true;
+        }
+    }
+
+    qCritical() << "Failed to read mapping file at" << mapFilePath;
+    return false;
+}
+
+bool AssetMappingStore::replayJournal() {
+    QFile journalFile { _directory.absoluteFilePath(JOURNAL_FILE_NAME) };
+    if (!journalFile.exists()) {
+        return true;
+    }
+    if (!journalFile.open(QIODevice::ReadWrite)) {
+        qCritical() << "Failed to open mapping journal at" << journalFile.fileName();
+        return false;
+    }
+
+    QDataStream in(&journalFile);
+    in.setVersion(JOURNAL_STREAM_VERSION);
+
+    qint64 committedSize = 0;
+    while (!in.atEnd()) {
+        QByteArray record;
+        in >> record;
+        if (in.status() != QDataStream::Ok) {
+            // the last commit didn't make it to the disk whole, so none of it happened
+            qWarning() << "Dropping an incomplete commit from the end of the mapping journal";
+            break;
+        }
+        committedSize = journalFile.pos();
+
+        QDataStream changes(record);
+        changes.setVersion(JOURNAL_STREAM_VERSION);
+        quint32 count = 0;
+        changes >> count;
+        for (quint32 i = 0; i < count && changes.status() == QDataStream::Ok; ++i) {
+            AssetPath path;
+            AssetHash hash;
+            changes >> path >> hash;
+            if (hash.isEmpty()) {
+                apply(path, AssetHash());
+            } else if (isValidMapping(path, hash)) {
+                apply(path, hash);
+            }
+            ++_journalChangeCount;
+        }
+    }
+
+    if (committedSize < journalFile.size()) {
+        journalFile.resize(committedSize);
+    }
+    return true;
+}
+
+bool AssetMappingStore::writeSnapshot() {
+    QJsonObject jsonObject;
+    for (auto it = _mappings.cbegin(); it != _mappings.cend(); ++it) {
+        jsonObject.insert(it.key(), it.value());
+    }
+
+    // the old snapshot stays until the new one is all written
+    QSaveFile mapFile { _directory.absoluteFilePath(MAP_FILE_NAME) };
+    if (!mapFile.open(QIODevice::WriteOnly) || mapFile.write(QJsonDocument(jsonObject).toJson()) == -1 ||
+            !mapFile.commit()) {
+        qWarning() << "Failed to write JSON mappings to file at" << mapFile.fileName();
+        return false;
+    }
+
+    qDebug() << "Wrote JSON mappings to file at" << mapFile.fileName();
+    return true;
+}
+
+AssetPathList AssetMappingStore::getPathsInFolder(const AssetPath& folder) const {
+    AssetPathList paths;
+    for (auto it = _mappings.lowerBound(folder); it != _mappings.cend() && it.key().startsWith(folder); ++it) {
+        paths << it.key();
+    }
+    return paths;
+}
+
+void AssetMappingStore::countHash(const AssetHash& hash, int count) {
+    if (hash.isEmpty()) {
+        return;
+    }
+    int& pathCount = _hashPathCounts[hash];
+    pathCount += count;
+    if (pathCount <= 0) {
+        _hashPathCounts.remove(hash);
+    }
+}
+
+void AssetMappingStore::apply(const AssetPath& path, const AssetHash& hash) {
+    auto it = _mappings.find(path);
+    if (it != _mappings.end()) {
+        countHash(it.value(), -1);
+        if (hash.isEmpty()) {
+            _mappings.erase(it);
+        } else {
+            it.value() = hash;
+        }
+    } else if (!hash.isEmpty()) {
+        _mappings.insert(path, hash);
+    }
+    countHash(hash, 1);
+}
+
+void AssetMappingStore::setMapping(const AssetPath& path, const AssetHash& hash) {
+    _pendingChanges.push_back({ path, hash, _mappings.value(path) });
+    apply(path, hash);
+}
+
+AssetHash AssetMappingStore::removeMapping(const AssetPath& path) {
+    auto previousHash = _mappings.value(path);
+    if (!previousHash.isEmpty()) {
+        _pendingChanges.push_back({ path, AssetHash(), previousHash });
+        apply(path, AssetHash());
+    }
+    return previousHash;
+}
+
+void AssetMappingStore::rollback() {
+    for (auto it = _pendingChanges.rbegin(); it != _pendingChanges.rend(); ++it) {
+        apply(it->path, it->previousHash);
+    }
+    _pendingChanges.clear();
+}
+
+bool AssetMappingStore::commit() {
+    if (_pendingChanges.empty()) {
+        return true;
+    }
+
+    QByteArray record;
+    {
+        QDataStream changes(&record, QIODevice::WriteOnly);
+        changes.setVersion(JOURNAL_STREAM_VERSION);
+        changes << (quint32)_pendingChanges.size();
+        for (const auto& change : _pendingChanges) {
+            changes << change.path << change.hash;
+        }
+    }
+
+    QFile journalFile { _directory.absoluteFilePath(JOURNAL_FILE_NAME) };
+    bool isWritten = false;
+    if (journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qint64 startSize = journalFile.size();
+        QDataStream out(&journalFile);
+        out.setVersion(JOURNAL_STREAM_VERSION);
+        out << record;
+        isWritten = out.status() == QDataStream::Ok && journalFile.flush();
+        if (!isWritten) {
+            // leave nothing of it behind for the next commit to follow
+            journalFile.resize(startSize);
+        }
+    }
+
+    if (!isWritten) {
+        qWarning() << "Failed to write" << _pendingChanges.size() << "mapping changes to the journal at"
+            << journalFile.fileName() << ", rolling back";
+        rollback();
+        return false;
+    }
+
+    _journalChangeCount += (int)_pendingChanges.size();
+    _pendingChanges.clear();
+
+    if (_journalChangeCount > std::max(MIN_JOURNAL_CHANGES_TO_COMPACT, _mappings.size()) && writeSnapshot()) {
+        // replaying what is left in it over the new snapshot changes nothing, if this fails
+        journalFile.resize(0);
+        _journalChangeCount = 0;
+    }
+    return true;
+}
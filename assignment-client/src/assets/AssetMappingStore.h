@@ -0,0 +1,75 @@
+//
+//  AssetMappingStore.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AssetMappingStore_h
+#define hifi_AssetMappingStore_h
+
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+
+#include <AssetUtils.h>
+
+// The mappings of asset paths to hashes, in the order of their paths so that the mappings in a folder are together.
+//
+// They are stored as a snapshot of all of them, in the map.json the asset server always kept them in, and a journal
+// of the changes committed since, which a commit only appends to. The journal is folded into a new snapshot once it
+// has about as many changes in it as there are mappings.
+//
+// Changes are applied as they are made, and a commit writes them to the journal in one record, so that after a crash
+// they are either all there or none of them is. A commit that fails puts back the mappings they changed.
+class AssetMappingStore {
+public:
+    using Mappings = QMap<AssetPath, AssetHash>;
+
+    // reads the snapshot and replays the journal from the given directory, false if the mappings could not be read
+    bool load(const QDir& directory);
+
+    const Mappings& getMappings() const { return _mappings; }
+    int size() const { return _mappings.size(); }
+    AssetHash getMapping(const AssetPath& path) const { return _mappings.value(path); }
+    bool isHashMapped(const AssetHash& hash) const { return _hashPathCounts.contains(hash); }
+
+    // the paths of the mappings in a folder and its subfolders, a folder path ends with a slash
+    AssetPathList getPathsInFolder(const AssetPath& folder) const;
+
+    void setMapping(const AssetPath& path, const AssetHash& hash);
+    // the hash the path was mapped to, empty if it wasn't
+    AssetHash removeMapping(const AssetPath& path);
+
+    bool commit();
+    void rollback();
+
+private:
+    struct Change {
+        AssetPath path;
+        AssetHash hash; // empty for a removal
+        AssetHash previousHash; // empty if the path wasn't mapped
+    };
+
+    void apply(const AssetPath& path, const AssetHash& hash);
+    void countHash(const AssetHash& hash, int count);
+
+    bool loadSnapshot();
+    bool replayJournal();
+    bool writeSnapshot();
+
+    QDir _directory;
+    Mappings _mappings;
+    QHash<AssetHash, int> _hashPathCounts; // the number of paths each hash is mapped from
+    std::vector<Change> _pendingChanges;
+    int _journalChangeCount { 0 };
+};
+
+#endif // hifi_AssetMappingStore_h
@@ -0,0 +1,157 @@
+//
+//  AssetMemoryCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMemoryCache.h"
+
+#include <algorithm>
+
+#include <AssetUtils.h>
+
+const qint64 AssetMemoryCache::DEFAULT_CAPACITY;
+
+// a single asset can take no more than this share of the cache
+static const int MAX_ASSET_SHARE = 8;
+
+// the counts are halved after this many requests per counter, so that popularity fades
+static const int SAMPLES_PER_COUNTER = 10;
+
+// each row of the sketch takes different bits of one hash of the asset
+static const uint32_t ROW_MULTIPLIERS[] = { 0x9E3779B1, 0x85EBCA77, 0xC2B2AE3D, 0x27D4EB2F };
+
+AssetMemoryCache::AssetMemoryCache(qint64 capacity) :
+    _capacity(capacity)
+{
+    for (auto& row : _sketch) {
+        row.resize(SKETCH_WIDTH, 0);
+    }
+}
+
+QByteArray AssetMemoryCache::get(const QString& hexHash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    incrementFrequency(hexHash);
+
+    auto it = _index.find(hexHash);
+    if (it == _index.end()) {
+        ++_stats.misses;
+        return QByteArray();
+    }
+
+    ++_stats.hits;
+    _entries.splice(_entries.begin(), _entries, it.value());
+    return it.value()->second;
+}
+
+void AssetMemoryCache::offer(const QString& hexHash, const char* data, qint64 size) {
+    if (size <= 0 || size > _capacity / MAX_ASSET_SHARE) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_index.contains(hexHash)) {
+            return;
+        }
+
+        // find the assets that would have to go to make room, all of them must be less popular than this one
+        int frequency = estimateFrequency(hexHash);
+        qint64 freed = _capacity - _stats.size;
+        for (auto it = _entries.rbegin(); freed < size && it != _entries.rend(); ++it) {
+            if (estimateFrequency(it->first) >= frequency) {
+                return;
+            }
+            freed += it->second.size();
+        }
+    }
+
+    // copy and check it outside the lock, this is the slow part
+    QByteArray copy(data, size);
+    if (hashData(copy).toHex() != hexHash) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // another request may have put it in while we were copying
+    if (_index.contains(hexHash)) {
+        return;
+    }
+
+    while (!_entries.empty() && _stats.size + size > _capacity) {
+        _stats.size -= _entries.back().second.size();
+        _index.remove(_entries.back().first);
+        _entries.pop_back();
+    }
+
+    _entries.emplace_front(hexHash, copy);
+    _index.insert(hexHash, _entries.begin());
+    _stats.size += size;
+    _stats.numAssets = (int)_entries.size();
+}
+
+void AssetMemoryCache::remove(const QString& hexHash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _index.find(hexHash);
+    if (it != _index.end()) {
+        _stats.size -= it.value()->second.size();
+        _entries.erase(it.value());
+        _index.erase(it);
+        _stats.numAssets = (int)_entries.size();
+    }
+}
+
+void AssetMemoryCache::recordBytesSent(qint64 size, bool fromMemory) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (fromMemory) {
+        _stats.bytesFromMemory += size;
+    } else {
+        _stats.bytesFromDisk += size;
+    }
+}
+
+AssetMemoryCache::Stats AssetMemoryCache::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+int AssetMemoryCache::counterIndex(uint hash, int row) {
+    return (int)((uint32_t)(hash * ROW_MULTIPLIERS[row]) >> (32 - SKETCH_WIDTH_BITS));
+}
+
+void AssetMemoryCache::incrementFrequency(const QString& hexHash) {
+    auto hash = qHash(hexHash);
+    for (int row = 0; row < SKETCH_DEPTH; ++row) {
+        auto& counter = _sketch[row][counterIndex(hash, row)];
+        if (counter < MAX_FREQUENCY) {
+            ++counter;
+        }
+    }
+
+    if (++_numIncrements >= SKETCH_WIDTH * SAMPLES_PER_COUNTER) {
+        for (auto& row : _sketch) {
+            for (auto& counter : row) {
+                counter >>= 1;
+            }
+        }
+        _numIncrements = 0;
+    }
+}
+
+int AssetMemoryCache::estimateFrequency(const QString& hexHash) const {
+    auto hash = qHash(hexHash);
+    int frequency = MAX_FREQUENCY;
+    for (int row = 0; row < SKETCH_DEPTH; ++row) {
+        frequency = std::min(frequency, (int)_sketch[row][counterIndex(hash, row)]);
+    }
+    return frequency;
+}
@@ -0,0 +1,84 @@
+//
+//  AssetMemoryCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AssetMemoryCache_h
+#define hifi_AssetMemoryCache_h
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+// The assets asked for most often, kept in memory so that they don't wait on the disk
+//
+// Admission is TinyLFU: every request is counted in a small count-min sketch whose counts are halved every so often, and
+// an asset read from disk only goes in if it has been asked for more often than the least recently used assets it would
+// push out. One-off requests for large assets can't flush the skybox and default avatars everyone downloads on join.
+// Thread-safe.
+class AssetMemoryCache {
+public:
+    struct Stats {
+        quint64 hits { 0 };
+        quint64 misses { 0 };
+        quint64 bytesFromMemory { 0 };
+        quint64 bytesFromDisk { 0 };
+        qint64 size { 0 };
+        int numAssets { 0 };
+    };
+
+    AssetMemoryCache(qint64 capacity = DEFAULT_CAPACITY);
+
+    // returns a null QByteArray if the asset isn't in memory, every call counts as a request for the asset
+    QByteArray get(const QString& hexHash);
+
+    // an asset just read from disk, copied in if it is requested often enough
+    // the data is checked against the hash before it is kept
+    void offer(const QString& hexHash, const char* data, qint64 size);
+
+    void remove(const QString& hexHash);
+
+    void recordBytesSent(qint64 size, bool fromMemory);
+
+    Stats getStats() const;
+
+    static const qint64 DEFAULT_CAPACITY = 256 * 1024 * 1024;
+
+private:
+    using Entry = std::pair<QString, QByteArray>;
+
+    static int counterIndex(uint hash, int row);
+    void incrementFrequency(const QString& hexHash);
+    int estimateFrequency(const QString& hexHash) const;
+
+    static const int SKETCH_DEPTH = 4;
+    static const int SKETCH_WIDTH_BITS = 12;
+    static const int SKETCH_WIDTH = 1 << SKETCH_WIDTH_BITS;
+    static const int MAX_FREQUENCY = 15;
+
+    mutable std::mutex _mutex;
+    const qint64 _capacity;
+
+    std::list<Entry> _entries; // most recently used first
+    QHash<QString, std::list<Entry>::iterator> _index;
+
+    std::array<std::vector<uint8_t>, SKETCH_DEPTH> _sketch;
+    int _numIncrements { 0 }; // since the counts were last halved
+
+    Stats _stats;
+};
+
+#endif // hifi_AssetMemoryCache_h
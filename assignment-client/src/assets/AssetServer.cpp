@@ -12,6 +12,7 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
 #include <thread>
 
 #include <QtCore/QCoreApplication>
@@ -22,12 +23,18 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QString>
+#include <QtCore/QThread>
 
+#include <image/Image.h>
 #include <SharedUtil.h>
 #include <PathUtils.h>
 
 #include "NetworkLogging.h"
 #include "NodeType.h"
+
+#include "BakeModelProxyTask.h"
+#include "BakeTextureTask.h"
+#include "CompressAssetTask.h"
 #include "SendAssetTask.h"
 #include "UploadAssetTask.h"
 #include <ClientServerUtils.h>
@@ -74,7 +81,8 @@ void updateConsumedCores() {
 
 AssetServer::AssetServer(ReceivedMessage& message) :
     ThreadedAssignment(message),
-    _taskPool(this)
+    _taskPool(this),
+    _bakingPool(this)
 {
 
     // Most of the work will be I/O bound, reading from disk and constructing packet objects,
@@ -82,6 +90,13 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     static const int TASK_POOL_THREAD_COUNT = 50;
     _taskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
 
+    // leave most of the cores to the other assignments
+    static const int MAX_BAKING_THREAD_COUNT = 2;
+    _bakingPool.setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount() / 4, MAX_BAKING_THREAD_COUNT)));
+
+    // the baked copies are what clients would have made, with their mips compressed
+    image::setColorTexturesCompressionEnabled(true);
+
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
@@ -181,6 +196,11 @@ void AssetServer::completeSetup() {
     if (loadMappingsFromFile()) {
         qInfo() << "Serving files from: " << _filesDirectory.path();
 
+        // uploads that were still being written when the server last stopped will never be finished
+        for (const auto& fileName : _filesDirectory.entryList({ "*" + UPLOADING_ASSET_SUFFIX }, QDir::Files)) {
+            _filesDirectory.remove(fileName);
+        }
+
         // Check the asset directory to output some information about what we have
         auto files = _filesDirectory.entryList(QDir::Files);
 
@@ -189,8 +209,9 @@ void AssetServer::completeSetup() {
 
         qInfo() << "There are" << hashedFiles.size() << "asset files in the asset directory.";
 
-        if (_fileMappings.count() > 0) {
+        if (_mappingStore.size() > 0) {
             cleanupUnmappedFiles();
+            compressMappedFiles();
         }
 
         nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer });
@@ -202,19 +223,21 @@ void AssetServer::completeSetup() {
 }
 
 void AssetServer::cleanupUnmappedFiles() {
-    QRegExp hashFileRegex { "^[a-f0-9]{" + QString::number(SHA256_HASH_HEX_LENGTH) + "}" };
+    // matches assets and their compressed, baked and proxy copies
+    QRegExp hashFileRegex { "^([a-f0-9]{" + QString::number(SHA256_HASH_HEX_LENGTH) + "})"
+        + "(" + QRegExp::escape(COMPRESSED_ASSET_SUFFIX) + "|" + QRegExp::escape(BAKED_TEXTURE_SUFFIX)
+        + "|" + QRegExp::escape(MODEL_PROXY_SUFFIX) + ")?" };
 
     auto files = _filesDirectory.entryInfoList(QDir::Files);
 
-    // grab the currently mapped hashes
-    auto mappedHashes = _fileMappings.values();
-
     qInfo() << "Performing unmapped asset cleanup.";
 
     for (const auto& fileInfo : files) {
         if (hashFileRegex.exactMatch(fileInfo.fileName())) {
-            if (!mappedHashes.contains(fileInfo.fileName())) {
+            if (!_mappingStore.isHashMapped(hashFileRegex.cap(1))) {
                 // remove the unmapped file
+                _mappedAssets.remove(fileInfo.fileName());
+                _memoryCache.remove(fileInfo.fileName());
                 QFile removeableFile { fileInfo.absoluteFilePath() };
 
                 if (removeableFile.remove()) {
@@ -227,6 +250,26 @@ void AssetServer::cleanupUnmappedFiles() {
     }
 }
 
+void AssetServer::compressMappedFiles() {
+    // the compressed and baked copies are written in the background, any that already exist are left alone
+    const auto& mappings = _mappingStore.getMappings();
+    for (auto it = mappings.cbegin(); it != mappings.cend(); ++it) {
+        startCopyTasks(it.key(), it.value());
+    }
+}
+
+void AssetServer::startCopyTasks(const AssetPath& path, const AssetHash& hash) {
+    if (isCompressibleAssetPath(path)) {
+        _taskPool.start(new CompressAssetTask(hash, _filesDirectory));
+    }
+    if (isBakeableTexturePath(path)) {
+        _bakingPool.start(new BakeTextureTask(hash, _filesDirectory));
+    }
+    if (isProxyableModelPath(path)) {
+        _bakingPool.start(new BakeModelProxyTask(hash, _filesDirectory, QFileInfo(path).suffix().toLower() == "obj"));
+    }
+}
+
 void AssetServer::handleAssetMappingOperation(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     MessageID messageID;
     message->readPrimitive(&messageID);
@@ -267,9 +310,8 @@ void AssetServer::handleAssetMappingOperation(QSharedPointer<ReceivedMessage> me
 void AssetServer::handleGetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket) {
     QString assetPath = message.readString();
 
-    auto it = _fileMappings.find(assetPath);
-    if (it != _fileMappings.end()) {
-        auto assetHash = it->toString();
+    auto assetHash = _mappingStore.getMapping(assetPath);
+    if (!assetHash.isEmpty()) {
         replyPacket.writePrimitive(AssetServerError::NoError);
         replyPacket.write(QByteArray::fromHex(assetHash.toUtf8()));
     } else {
@@ -280,13 +322,14 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, SharedNode
 void AssetServer::handleGetAllMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket) {
     replyPacket.writePrimitive(AssetServerError::NoError);
 
-    auto count = _fileMappings.size();
+    const auto& mappings = _mappingStore.getMappings();
+    auto count = mappings.size();
 
     replyPacket.writePrimitive(count);
 
-    for (auto it = _fileMappings.cbegin(); it != _fileMappings.cend(); ++ it) {
+    for (auto it = mappings.cbegin(); it != mappings.cend(); ++ it) {
         replyPacket.writeString(it.key());
-        replyPacket.write(QByteArray::fromHex(it.value().toString().toUtf8()));
+        replyPacket.write(QByteArray::fromHex(it.value().toUtf8()));
     }
 }
 
@@ -354,7 +397,7 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
     message->readPrimitive(&messageID);
     assetHash = message->readWithoutCopy(SHA256_HASH_LENGTH);
 
-    auto size = qint64(sizeof(MessageID) + SHA256_HASH_LENGTH + sizeof(AssetServerError) + sizeof(qint64));
+    auto size = qint64(sizeof(MessageID) + SHA256_HASH_LENGTH + sizeof(AssetServerError) + 2 * sizeof(qint64));
     auto replyPacket = NLPacket::create(PacketType::AssetGetInfoReply, size, true);
 
     QByteArray hexHash = assetHash.toHex();
@@ -369,6 +412,9 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
         qDebug() << "Opening file: " << fileInfo.filePath();
         replyPacket->writePrimitive(AssetServerError::NoError);
         replyPacket->writePrimitive(fileInfo.size());
+
+        QFileInfo compressedFileInfo { _filesDirectory.filePath(assetFileName(fileName, AssetEncoding::Gzip)) };
+        replyPacket->writePrimitive(compressedFileInfo.exists() ? compressedFileInfo.size() : qint64(0));
     } else {
         qDebug() << "Asset not found: " << QString(hexHash);
         replyPacket->writePrimitive(AssetServerError::AssetNotFound);
@@ -380,7 +426,8 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
 
 void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
 
-    auto minSize = qint64(sizeof(MessageID) + SHA256_HASH_LENGTH + sizeof(DataOffset) + sizeof(DataOffset));
+    auto minSize = qint64(sizeof(MessageID) + SHA256_HASH_LENGTH + sizeof(DataOffset) + sizeof(DataOffset)
+                          + sizeof(AssetEncoding));
 
     if (message->getSize() < minSize) {
         qDebug() << "ERROR bad file request";
@@ -388,7 +435,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _mappedAssets, _memoryCache);
     _taskPool.start(task);
 }
 
@@ -424,6 +471,18 @@ void AssetServer::sendStatsPacket() {
 
     auto stats = DependencyManager::get<NodeList>()->sampleStatsForAllConnections();
 
+    auto memoryCacheStats = _memoryCache.getStats();
+    auto numRequests = memoryCacheStats.hits + memoryCacheStats.misses;
+    static const float BYTES_PER_MEGABYTE = 1000000.0f;
+
+    QJsonObject memoryCacheObject;
+    memoryCacheObject["1. Assets"] = memoryCacheStats.numAssets;
+    memoryCacheObject["2. Size (MB)"] = memoryCacheStats.size / BYTES_PER_MEGABYTE;
+    memoryCacheObject["3. Hit Rate"] = numRequests > 0 ? (float)memoryCacheStats.hits / (float)numRequests : 0.0f;
+    memoryCacheObject["4. Sent From Memory (MB)"] = memoryCacheStats.bytesFromMemory / BYTES_PER_MEGABYTE;
+    memoryCacheObject["5. Sent From Disk (MB)"] = memoryCacheStats.bytesFromDisk / BYTES_PER_MEGABYTE;
+    serverStats["memory_cache"] = memoryCacheObject;
+
     for (const auto& stat : stats) {
         QJsonObject nodeStats;
         auto endTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(stat.second.endTime);
@@ -488,77 +547,8 @@ void AssetServer::sendStatsPacket() {
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
 
-static const QString MAP_FILE_NAME = "map.json";
-
 bool AssetServer::loadMappingsFromFile() {
-
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QFile mapFile { mapFilePath };
-    if (mapFile.exists()) {
-        if (mapFile.open(QIODevice::ReadOnly)) {
-            QJsonParseError error;
-
-            auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
-
-            if (error.error == QJsonParseError::NoError) {
-                _fileMappings = jsonDocument.object().toVariantHash();
-
-                // remove any mappings that don't match the expected format
-                auto it = _fileMappings.begin();
-                while (it != _fileMappings.end()) {
-                    bool shouldDrop = false;
-
-                    if (!isValidFilePath(it.key())) {
-                        qWarning() << "Will not keep mapping for" << it.key() << "since it is not a valid path.";
-                        shouldDrop = true;
-                    }
-
-                    if (!isValidHash(it.value().toString())) {
-                        qWarning() << "Will not keep mapping for" << it.key() << "since it does not have a valid hash.";
-                        shouldDrop = true;
-                    }
-
-                    if (shouldDrop) {
-                        it = _fileMappings.erase(it);
-                    } else {
-                        ++it;
-                    }
-                }
-
-                qInfo() << "Loaded" << _fileMappings.count() << "mappings from map file at" << mapFilePath;
-                return true;
-            }
-        }
-
-        qCritical() << "Failed to read mapping file at" << mapFilePath;
-        return false;
-    } else {
-        qInfo() << "No existing mappings loaded from file since no file was found at" << mapFilePath;
-    }
-
-    return true;
-}
-
-bool AssetServer::writeMappingsToFile() {
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QFile mapFile { mapFilePath };
-    if (mapFile.open(QIODevice::WriteOnly)) {
-        auto jsonObject = QJsonObject::fromVariantHash(_fileMappings);
-        QJsonDocument jsonDocument { jsonObject };
-
-        if (mapFile.write(jsonDocument.toJson()) != -1) {
-            qDebug() << "Wrote JSON mappings to file at" << mapFilePath;
-            return true;
-        } else {
-            qWarning() << "Failed to write JSON mappings to file at" << mapFilePath;
-        }
-    } else {
-        qWarning() << "Failed to open map file at" << mapFilePath;
-    }
-
-    return false;
+    return _mappingStore.load(_resourcesDirectory);
 }
 
 bool AssetServer::setMapping(AssetPath path, AssetHash hash) {
@@ -574,25 +564,17 @@ bool AssetServer::setMapping(AssetPath path, AssetHash hash) {
         return false;
     }
 
-    // remember what the old mapping was in case persistence fails
-    auto oldMapping = _fileMappings.value(path).toString();
+    _mappingStore.setMapping(path, hash);
 
-    // update the in memory QHash
-    _fileMappings[path] = hash;
-
-    // attempt to write to file
-    if (writeMappingsToFile()) {
+    // attempt to persist it, the store puts back the old mapping if that fails
+    if (_mappingStore.commit()) {
         // persistence succeeded, we are good to go
         qDebug() << "Set mapping:" << path << "=>" << hash;
+
+        startCopyTasks(path, hash);
+
         return true;
     } else {
-        // failed to persist this mapping to file - put back the old one in our in-memory representation
-        if (oldMapping.isEmpty()) {
-            _fileMappings.remove(path);
-        } else {
-            _fileMappings[path] = oldMapping;
-        }
-
         qWarning() << "Failed to persist mapping:" << path << "=>" << hash;
 
         return false;
@@ -604,9 +586,6 @@ bool pathIsFolder(const AssetPath& path) {
 }
 
 bool AssetServer::deleteMappings(AssetPathList& paths) {
-    // take a copy of the current mappings in case persistence of these deletes fails
-    auto oldMappings = _fileMappings;
-
     QSet<QString> hashesToCheckForDeletion;
 
     // enumerate the paths to delete and remove them all
@@ -616,59 +595,60 @@ bool AssetServer::deleteMappings(AssetPathList& paths) {
 
         // figure out if this path will delete a file or folder
         if (pathIsFolder(path)) {
-            // enumerate the in memory file mappings and remove anything that matches
-            auto it = _fileMappings.begin();
-            auto sizeBefore = _fileMappings.size();
-
-            while (it != _fileMappings.end()) {
-                if (it.key().startsWith(path)) {
-                    // add this hash to the list we need to check for asset removal from the server
-                    hashesToCheckForDeletion << it.value().toString();
-
-                    it = _fileMappings.erase(it);
-                } else {
-                    ++it;
-                }
+            // the mappings are in order of their paths, the ones in the folder are together
+            auto folderPaths = _mappingStore.getPathsInFolder(path);
+            for (const auto& folderPath : folderPaths) {
+                // add this hash to the list we need to check for asset removal from the server
+                hashesToCheckForDeletion << _mappingStore.removeMapping(folderPath);
             }
 
-            auto sizeNow = _fileMappings.size();
-            if (sizeBefore != sizeNow) {
-                qDebug() << "Deleted" << sizeBefore - sizeNow << "mappings in folder: " << path;
+            if (!folderPaths.isEmpty()) {
+                qDebug() << "Deleted" << folderPaths.size() << "mappings in folder: " << path;
             } else {
                 qDebug() << "Did not find any mappings to delete in folder:" << path;
             }
 
         } else {
-            auto oldMapping = _fileMappings.take(path);
-            if (!oldMapping.isNull()) {
+            auto oldMapping = _mappingStore.removeMapping(path);
+            if (!oldMapping.isEmpty()) {
                 // add this hash to the list we need to check for asset removal from server
-                hashesToCheckForDeletion << oldMapping.toString();
+                hashesToCheckForDeletion << oldMapping;
 
-                qDebug() << "Deleted a mapping:" << path << "=>" << oldMapping.toString();
+                qDebug() << "Deleted a mapping:" << path << "=>" << oldMapping;
             } else {
                 qDebug() << "Unable to delete a mapping that was not found:" << path;
             }
         }
     }
 
-    // deleted the old mappings, attempt to persist to file
-    if (writeMappingsToFile()) {
+    // deleted the old mappings, attempt to persist them all at once
+    if (_mappingStore.commit()) {
         // persistence succeeded we are good to go
 
-        // grab the current mapped hashes
-        auto mappedHashes = _fileMappings.values();
-
-        // enumerate the mapped hashes and clear the list of hashes to check for anything that's present
-        for (auto& hashVariant : mappedHashes) {
-            auto it = hashesToCheckForDeletion.find(hashVariant.toString());
-            if (it != hashesToCheckForDeletion.end()) {
-                hashesToCheckForDeletion.erase(it);
+        // the hashes that other paths still map to stay
+        for (auto it = hashesToCheckForDeletion.begin(); it != hashesToCheckForDeletion.end();) {
+            if (_mappingStore.isHashMapped(*it)) {
+                it = hashesToCheckForDeletion.erase(it);
+            } else {
+                ++it;
             }
         }
 
         // we now have a set of hashes that are unmapped - we will delete those asset files
         for (auto& hash : hashesToCheckForDeletion) {
-            // remove the unmapped file
+            // remove the unmapped file, and its compressed, baked or proxy copy if it has one
+            auto compressedFileName = assetFileName(hash, AssetEncoding::Gzip);
+            auto bakedFileName = assetFileName(hash, AssetEncoding::BakedTexture);
+            auto proxyFileName = assetFileName(hash, AssetEncoding::ModelProxy);
+            _mappedAssets.remove(hash);
+            _mappedAssets.remove(compressedFileName);
+            _mappedAssets.remove(bakedFileName);
+            _mappedAssets.remove(proxyFileName);
+            _memoryCache.remove(hash);
+            QFile::remove(_filesDirectory.absoluteFilePath(compressedFileName));
+            QFile::remove(_filesDirectory.absoluteFilePath(bakedFileName));
+            QFile::remove(_filesDirectory.absoluteFilePath(proxyFileName));
+
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
 
             if (removeableFile.remove()) {
@@ -680,10 +660,8 @@ bool AssetServer::deleteMappings(AssetPathList& paths) {
 
         return true;
     } else {
-        qWarning() << "Failed to persist deleted mappings, rolling back";
-
-        // we didn't delete the previous mapping, put it back in our in-memory representation
-        _fileMappings = oldMappings;
+        // the store put back the deleted mappings
+        qWarning() << "Failed to persist deleted mappings, rolled back";
 
         return false;
     }
@@ -709,34 +687,24 @@ bool AssetServer::renameMapping(AssetPath oldPath, AssetPath newPath) {
             return false;
         }
 
-        // take a copy of the old mappings
-        auto oldMappings = _fileMappings;
-
-        // iterate the current mappings and adjust any that matches the renamed folder
-        auto it = oldMappings.begin();
-
-        while (it != oldMappings.end()) {
-            if (it.key().startsWith(oldPath)) {
-                auto newKey = it.key();
-                newKey.replace(0, oldPath.size(), newPath);
-
-                // remove the old version from the in memory file mappings
-                _fileMappings.remove(it.key());
-                _fileMappings.insert(newKey, it.value());
-            }
-
-            ++it;
+        // take the mappings out of the old folder before putting them in the new one, which may be inside it
+        AssetMappingStore::Mappings movedMappings;
+        for (const auto& path : _mappingStore.getPathsInFolder(oldPath)) {
+            auto newKey = path;
+            newKey.replace(0, oldPath.size(), newPath);
+            movedMappings.insert(newKey, _mappingStore.removeMapping(path));
+        }
+        for (auto it = movedMappings.cbegin(); it != movedMappings.cend(); ++it) {
+            _mappingStore.setMapping(it.key(), it.value());
         }
 
-        if (writeMappingsToFile()) {
+        if (_mappingStore.commit()) {
             // persisted the changed mappings, return success
             qDebug() << "Renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return true;
         } else {
-            // couldn't persist the renamed paths, rollback and return failure
-            _fileMappings = oldMappings;
-
+            // couldn't persist the renamed paths, the store rolled them back
             qWarning() << "Failed to persist renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return false;
@@ -750,31 +718,19 @@ bool AssetServer::renameMapping(AssetPath oldPath, AssetPath newPath) {
         }
 
         // take the old hash to remove the old mapping
-        auto oldSourceMapping = _fileMappings.take(oldPath).toString();
-
-        // in case we're overwriting, keep the current destination mapping for potential rollback
-        auto oldDestinationMapping = _fileMappings.value(newPath);
+        auto oldSourceMapping = _mappingStore.removeMapping(oldPath);
 
         if (!oldSourceMapping.isEmpty()) {
-            _fileMappings[newPath] = oldSourceMapping;
+            // this overwrites any mapping for the destination path, which the store keeps in case it rolls back
+            _mappingStore.setMapping(newPath, oldSourceMapping);
 
-            if (writeMappingsToFile()) {
+            if (_mappingStore.commit()) {
                 // persisted the renamed mapping, return success
                 qDebug() << "Renamed mapping:" << oldPath << "=>" << newPath;
 
                 return true;
             } else {
-                // we couldn't persist the renamed mapping, rollback and return failure
-                _fileMappings[oldPath] = oldSourceMapping;
-
-                if (!oldDestinationMapping.isNull()) {
-                    // put back the overwritten mapping for the destination path
-                    _fileMappings[newPath] = oldDestinationMapping.toString();
-                } else {
-                    // clear the new mapping
-                    _fileMappings.remove(newPath);
-                }
-
+                // we couldn't persist the renamed mapping, the store put back both paths
                 qDebug() << "Failed to persist renamed mapping:" << oldPath << "=>" << newPath;
 
                 return false;
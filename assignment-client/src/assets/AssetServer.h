@@ -17,7 +17,10 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetMappingStore.h"
+#include "AssetMemoryCache.h"
 #include "AssetUtils.h"
+#include "MappedAssetCache.h"
 #include "ReceivedMessage.h"
 
 class AssetServer : public ThreadedAssignment {
@@ -39,8 +42,6 @@ private slots:
     void sendStatsPacket() override;
 
 private:
-    using Mappings = QVariantHash;
-
     void handleGetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
     void handleGetAllMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
     void handleSetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
@@ -49,7 +50,6 @@ private:
 
     // Mapping file operations must be called from main assignment thread only
     bool loadMappingsFromFile();
-    bool writeMappingsToFile();
 
     /// Set the mapping for path to hash
     bool setMapping(AssetPath path, AssetHash hash);
@@ -63,11 +63,21 @@ private:
     // deletes any unmapped files from the local asset directory
     void cleanupUnmappedFiles();
 
-    Mappings _fileMappings;
+    // writes compressed copies of the mapped files that are worth compressing and don't have one yet,
+    // and baked copies of the mapped textures
+    void compressMappedFiles();
+    void startCopyTasks(const AssetPath& path, const AssetHash& hash);
+
+    AssetMappingStore _mappingStore;
 
     QDir _resourcesDirectory;
     QDir _filesDirectory;
+    // these outlive _taskPool, whose send tasks use them
+    MappedAssetCache _mappedAssets;
+    AssetMemoryCache _memoryCache;
     QThreadPool _taskPool;
+    // baking is CPU bound and slow, it is kept apart so that it never holds up sending
+    QThreadPool _bakingPool;
 };
 
 #endif
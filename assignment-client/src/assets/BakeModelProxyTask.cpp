@@ -0,0 +1,225 @@
+//
+//  BakeModelProxyTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeModelProxyTask.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QTextStream>
+
+#include <AssetUtils.h>
+#include <FBXReader.h>
+#include <OBJReader.h>
+
+#include "CompressAssetTask.h"
+
+// models with fewer triangles than this draw about as fast as their proxy would
+static const int MIN_PROXIED_TRIANGLE_COUNT = 2000;
+
+// the vertices of a model are merged into the cells of a grid this many cells along its longest side
+static const int PROXY_GRID_RESOLUTION = 32;
+
+namespace {
+
+struct ProxyVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec3 color;
+    int count { 0 };
+};
+
+}
+
+BakeModelProxyTask::BakeModelProxyTask(const QString& hexHash, const QDir& filesDir, bool isOBJ) :
+    _hexHash(hexHash),
+    _filesDir(filesDir),
+    _isOBJ(isOBJ)
+{
+
+}
+
+void BakeModelProxyTask::run() {
+    QString proxyFilePath = _filesDir.filePath(assetFileName(_hexHash, AssetEncoding::ModelProxy));
+    if (QFile::exists(proxyFilePath)) {
+        return;
+    }
+
+    QFile file { _filesDir.filePath(_hexHash) };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    if (hashData(data).toHex() != _hexHash) {
+        qWarning() << "Not making a proxy of model" << _hexHash << "whose contents do not match its hash";
+        return;
+    }
+
+    std::unique_ptr<FBXGeometry> geometry;
+    try {
+        // without a URL, an OBJ doesn't look for its material library, its parts keep the default material
+        geometry.reset(_isOBJ ? OBJReader().readOBJ(data, QVariantHash(), false) : readFBX(data, QVariantHash(), _hexHash));
+    } catch (const QString& error) {
+        qWarning() << "Could not read model" << _hexHash << "to make a proxy of:" << error;
+        return;
+    }
+    if (!geometry) {
+        return;
+    }
+
+    // the triangles, in the space of the model
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> colors;
+    int triangleCount = 0;
+    for (const auto& mesh : geometry->meshes) {
+        for (const auto& part : mesh.parts) {
+            glm::vec3 diffuseColor = geometry->materials.contains(part.materialID) ?
+                geometry->materials[part.materialID].diffuseColor : glm::vec3(1.0f);
+            for (const QVector<int>* indices : { &part.triangleIndices, &part.quadTrianglesIndices }) {
+                for (int i = 0; i + 2 < indices->size(); i += 3) {
+                    const int* triangle = indices->constData() + i;
+                    if (std::any_of(triangle, triangle + 3, [&](int index) {
+                            return index < 0 || index >= mesh.vertices.size();
+                        })) {
+                        continue;
+                    }
+                    for (int j = 0; j < 3; ++j) {
+                        int index = triangle[j];
+                        positions.push_back(glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[index], 1.0f)));
+                        colors.push_back(index < mesh.colors.size() ? diffuseColor * mesh.colors[index] : diffuseColor);
+                    }
+                    ++triangleCount;
+                }
+            }
+        }
+    }
+
+    if (triangleCount < MIN_PROXIED_TRIANGLE_COUNT) {
+        return;
+    }
+
+    glm::vec3 minimum = positions.empty() ? glm::vec3(0.0f) : positions[0];
+    glm::vec3 maximum = minimum;
+    for (const auto& position : positions) {
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+    glm::vec3 size = maximum - minimum;
+    float cellSize = std::max(std::max(size.x, size.y), size.z) / PROXY_GRID_RESOLUTION;
+    if (cellSize <= 0.0f) {
+        return;
+    }
+
+    // every vertex in a cell becomes the one at their average, and the triangles that collapse go away
+    QHash<int, int> cellVertices;
+    std::vector<ProxyVertex> vertices;
+    std::vector<int> vertexIndices;
+    vertexIndices.reserve(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        glm::ivec3 cell = glm::clamp(glm::ivec3((positions[i] - minimum) / cellSize),
+                                     glm::ivec3(0), glm::ivec3(PROXY_GRID_RESOLUTION - 1));
+        int key = cell.x + PROXY_GRID_RESOLUTION * (cell.y + PROXY_GRID_RESOLUTION * cell.z);
+        auto it = cellVertices.find(key);
+        if (it == cellVertices.end()) {
+            it = cellVertices.insert(key, (int)vertices.size());
+            vertices.emplace_back();
+        }
+        ProxyVertex& vertex = vertices[it.value()];
+        vertex.position += positions[i];
+        vertex.color += colors[i];
+        ++vertex.count;
+        vertexIndices.push_back(it.value());
+    }
+
+    std::vector<int> triangles;
+    std::unordered_set<uint64_t> seenTriangles;
+    const int VERTEX_INDEX_BITS = 16; // there are at most PROXY_GRID_RESOLUTION cubed vertices
+    for (size_t i = 0; i < vertexIndices.size(); i += 3) {
+        int a = vertexIndices[i];
+        int b = vertexIndices[i + 1];
+        int c = vertexIndices[i + 2];
+        if (a == b || b == c || c == a) {
+            continue;
+        }
+
+        // the normals of the vertices are the area weighted ones of the surviving triangles around them
+        glm::vec3 normal = glm::cross(positions[i + 1] - positions[i], positions[i + 2] - positions[i]);
+        vertices[a].normal += normal;
+        vertices[b].normal += normal;
+        vertices[c].normal += normal;
+
+        int sorted[3] = { a, b, c };
+        std::sort(sorted, sorted + 3);
+        uint64_t key = ((uint64_t)sorted[0] << (2 * VERTEX_INDEX_BITS)) |
+            ((uint64_t)sorted[1] << VERTEX_INDEX_BITS) | (uint64_t)sorted[2];
+        if (seenTriangles.insert(key).second) {
+            triangles.push_back(a);
+            triangles.push_back(b);
+            triangles.push_back(c);
+        }
+    }
+
+    QByteArray proxyData;
+    {
+        QTextStream out(&proxyData);
+        out.setRealNumberNotation(QTextStream::FixedNotation);
+        out.setRealNumberPrecision(4);
+        for (const auto& vertex : vertices) {
+            glm::vec3 position = vertex.position / (float)vertex.count;
+            glm::vec3 color = glm::clamp(vertex.color / (float)vertex.count, 0.0f, 1.0f);
+            out << "v " << position.x << " " << position.y << " " << position.z << " "
+                << color.r << " " << color.g << " " << color.b << "\n";
+        }
+        for (const auto& vertex : vertices) {
+            float length = glm::length(vertex.normal);
+            glm::vec3 normal = (length > 0.0f) ? vertex.normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            out << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
+        }
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            int a = triangles[i] + 1;
+            int b = triangles[i + 1] + 1;
+            int c = triangles[i + 2] + 1;
+            out << "f " << a << "//" << a << " " << b << "//" << b << " " << c << "//" << c << "\n";
+        }
+    }
+
+    // clients fetch the proxy in one piece
+    if (proxyData.size() > ASSET_CHUNK_SIZE) {
+        qWarning() << "Not keeping the proxy of model" << _hexHash << "which is" << proxyData.size() << "bytes";
+        return;
+    }
+
+    // write it under another name first, so that a partial file is never served
+    QString temporaryFilePath = proxyFilePath + ".part";
+    QFile proxyFile { temporaryFilePath };
+    if (!proxyFile.open(QIODevice::WriteOnly) || proxyFile.write(proxyData) != proxyData.size()) {
+        qWarning() << "Failed to write the proxy of model" << _hexHash;
+        proxyFile.remove();
+        return;
+    }
+    proxyFile.close();
+
+    if (!proxyFile.rename(proxyFilePath)) {
+        // another task got there first
+        proxyFile.remove();
+        return;
+    }
+
+    qDebug() << "Made a proxy of model" << _hexHash << "from" << triangleCount << "to" << triangles.size() / 3
+        << "triangles";
+}
@@ -0,0 +1,37 @@
+//
+//  BakeModelProxyTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BakeModelProxyTask_h
+#define hifi_BakeModelProxyTask_h
+
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QString>
+
+// the proxy of a model sits next to it, named after its hash with this suffix
+const QString MODEL_PROXY_SUFFIX = ".proxy.obj";
+
+// Writes a simplified proxy of a large model asset as an OBJ, with its material colors on the vertices, if it doesn't
+// have one yet. Clients render it in place of the model until it takes up enough of their view to need the real one
+class BakeModelProxyTask : public QRunnable {
+public:
+    BakeModelProxyTask(const QString& hexHash, const QDir& filesDir, bool isOBJ);
+
+    void run() override;
+
+private:
+    QString _hexHash;
+    QDir _filesDir;
+    bool _isOBJ;
+};
+
+#endif // hifi_BakeModelProxyTask_h
@@ -0,0 +1,86 @@
+//
+//  BakeTextureTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeTextureTask.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+
+#include <AssetUtils.h>
+#include <image/Image.h>
+#include <ktx/KTX.h>
+
+#include "CompressAssetTask.h"
+
+BakeTextureTask::BakeTextureTask(const QString& hexHash, const QDir& filesDir) :
+    _hexHash(hexHash),
+    _filesDir(filesDir)
+{
+
+}
+
+void BakeTextureTask::run() {
+    QString bakedFilePath = _filesDir.filePath(assetFileName(_hexHash, AssetEncoding::BakedTexture));
+    if (QFile::exists(bakedFilePath)) {
+        return;
+    }
+
+    QFile file { _filesDir.filePath(_hexHash) };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    if (hashData(data).toHex() != _hexHash) {
+        qWarning() << "Not baking texture" << _hexHash << "whose contents do not match its hash";
+        return;
+    }
+
+    // clients only take the baked copy for the color textures, which all process the same way
+    auto texture = image::processImage(data, _hexHash.toStdString(), ABSOLUTE_MAX_TEXTURE_NUM_PIXELS,
+                                       image::TextureUsage::DEFAULT_TEXTURE);
+    if (!texture) {
+        qWarning() << "Could not bake texture" << _hexHash;
+        return;
+    }
+
+    // clients look the KTX up in their cache by the hash of the original, the same as one they processed
+    texture->setSourceHash(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex().toStdString());
+
+    auto memKTX = gpu::Texture::serialize(*texture);
+    if (!memKTX) {
+        qWarning() << "Could not serialize baked texture" << _hexHash;
+        return;
+    }
+
+    const char* bakedData = reinterpret_cast<const char*>(memKTX->_storage->data());
+    const qint64 bakedSize = (qint64)memKTX->_storage->size();
+
+    // write it under another name first, so that a partial file is never served
+    QString temporaryFilePath = bakedFilePath + ".part";
+    QFile bakedFile { temporaryFilePath };
+    if (!bakedFile.open(QIODevice::WriteOnly) || bakedFile.write(bakedData, bakedSize) != bakedSize) {
+        qWarning() << "Failed to write baked texture" << _hexHash;
+        bakedFile.remove();
+        return;
+    }
+    bakedFile.close();
+
+    if (!bakedFile.rename(bakedFilePath)) {
+        // another task got there first
+        bakedFile.remove();
+        return;
+    }
+
+    qDebug() << "Baked texture" << _hexHash << "from" << data.size() << "to" << bakedSize << "bytes";
+}
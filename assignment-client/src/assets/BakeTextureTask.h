@@ -0,0 +1,36 @@
+//
+//  BakeTextureTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BakeTextureTask_h
+#define hifi_BakeTextureTask_h
+
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QString>
+
+// the baked copy of a texture sits next to it, named after its hash with this suffix
+const QString BAKED_TEXTURE_SUFFIX = ".ktx";
+
+// Writes the KTX of a texture asset, with its mips compressed, if it doesn't have one yet
+// Clients stream it by ranges from the smallest mip up instead of processing the original themselves
+class BakeTextureTask : public QRunnable {
+public:
+    BakeTextureTask(const QString& hexHash, const QDir& filesDir);
+
+    void run() override;
+
+private:
+    QString _hexHash;
+    QDir _filesDir;
+};
+
+#endif // hifi_BakeTextureTask_h
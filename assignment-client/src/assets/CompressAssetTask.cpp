@@ -0,0 +1,86 @@
+//
+//  CompressAssetTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompressAssetTask.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+
+#include <Gzip.h>
+
+#include "BakeModelProxyTask.h"
+#include "BakeTextureTask.h"
+
+// a compressed copy that saves less than this isn't worth decompressing
+static const float MAX_COMPRESSED_RATIO = 0.9f;
+
+QString assetFileName(const QString& hexHash, AssetEncoding encoding) {
+    switch (encoding) {
+        case AssetEncoding::Gzip:
+            return hexHash + COMPRESSED_ASSET_SUFFIX;
+        case AssetEncoding::BakedTexture:
+            return hexHash + BAKED_TEXTURE_SUFFIX;
+        case AssetEncoding::ModelProxy:
+            return hexHash + MODEL_PROXY_SUFFIX;
+        default:
+            return hexHash;
+    }
+}
+
+CompressAssetTask::CompressAssetTask(const QString& hexHash, const QDir& filesDir) :
+    _hexHash(hexHash),
+    _filesDir(filesDir)
+{
+
+}
+
+void CompressAssetTask::run() {
+    QString compressedFilePath = _filesDir.filePath(assetFileName(_hexHash, AssetEncoding::Gzip));
+    if (QFile::exists(compressedFilePath)) {
+        return;
+    }
+
+    QFile file { _filesDir.filePath(_hexHash) };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    // a copy of a corrupt file would be served as if it were fine
+    if (hashData(data).toHex() != _hexHash) {
+        qWarning() << "Not compressing asset" << _hexHash << "whose contents do not match its hash";
+        return;
+    }
+
+    QByteArray compressedData;
+    if (!gzip(data, compressedData) || compressedData.size() > data.size() * MAX_COMPRESSED_RATIO) {
+        return;
+    }
+
+    // write it under another name first, so that a partial file is never served
+    QString temporaryFilePath = compressedFilePath + ".part";
+    QFile compressedFile { temporaryFilePath };
+    if (!compressedFile.open(QIODevice::WriteOnly) || compressedFile.write(compressedData) != compressedData.size()) {
+        qWarning() << "Failed to write compressed copy of asset" << _hexHash;
+        compressedFile.remove();
+        return;
+    }
+    compressedFile.close();
+
+    if (!compressedFile.rename(compressedFilePath)) {
+        // another task got there first
+        compressedFile.remove();
+        return;
+    }
+
+    qDebug() << "Compressed asset" << _hexHash << "from" << data.size() << "to" << compressedData.size() << "bytes";
+}
@@ -0,0 +1,39 @@
+//
+//  CompressAssetTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_CompressAssetTask_h
+#define hifi_CompressAssetTask_h
+
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QString>
+
+#include <AssetUtils.h>
+
+// the compressed copy of an asset sits next to it, named after its hash with this suffix
+const QString COMPRESSED_ASSET_SUFFIX = ".gz";
+
+QString assetFileName(const QString& hexHash, AssetEncoding encoding);
+
+// Writes the compressed copy of an asset file, if it doesn't have one yet and compressing it is worth it
+class CompressAssetTask : public QRunnable {
+public:
+    CompressAssetTask(const QString& hexHash, const QDir& filesDir);
+
+    void run() override;
+
+private:
+    QString _hexHash;
+    QDir _filesDir;
+};
+
+#endif // hifi_CompressAssetTask_h
@@ -0,0 +1,91 @@
+//
+//  MappedAssetCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MappedAssetCache.h"
+
+#include <QtCore/QDebug>
+
+const size_t MappedAssetCache::DEFAULT_CAPACITY;
+
+MappedAssetCache::MappedAssetPointer MappedAssetCache::get(const QDir& filesDirectory, const QString& hexHash) {
+    QString filePath = filesDirectory.filePath(hexHash);
+    QFileInfo fileInfo { filePath };
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _index.find(hexHash);
+    if (it != _index.end()) {
+        auto entry = it.value();
+        auto& mappedAsset = entry->second;
+
+        if (fileInfo.exists() && fileInfo.size() == mappedAsset->getSize()
+                && fileInfo.lastModified() == mappedAsset->_lastModified) {
+            _entries.splice(_entries.begin(), _entries, entry);
+            return mappedAsset;
+        }
+
+        // the file has changed since it was mapped
+        _entries.erase(entry);
+        _index.erase(it);
+    }
+
+    if (!fileInfo.exists()) {
+        return nullptr;
+    }
+
+    auto mappedAsset = map(filePath, fileInfo);
+    if (!mappedAsset) {
+        return nullptr;
+    }
+
+    if (_entries.size() >= _capacity) {
+        _index.remove(_entries.back().first);
+        _entries.pop_back();
+    }
+    _entries.emplace_front(hexHash, mappedAsset);
+    _index.insert(hexHash, _entries.begin());
+
+    return mappedAsset;
+}
+
+void MappedAssetCache::remove(const QString& hexHash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _index.find(hexHash);
+    if (it != _index.end()) {
+        _entries.erase(it.value());
+        _index.erase(it);
+    }
+}
+
+MappedAssetCache::MappedAssetPointer MappedAssetCache::map(const QString& filePath, const QFileInfo& fileInfo) {
+    auto mappedAsset = std::make_shared<MappedAsset>();
+    mappedAsset->_file.setFileName(filePath);
+
+    if (!mappedAsset->_file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    mappedAsset->_size = mappedAsset->_file.size();
+    mappedAsset->_lastModified = fileInfo.lastModified();
+
+    // an empty file can't be mapped, and has nothing to send anyway
+    if (mappedAsset->_size > 0) {
+        auto data = mappedAsset->_file.map(0, mappedAsset->_size);
+        if (!data) {
+            qWarning() << "Could not map asset file" << filePath << "-" << mappedAsset->_file.errorString();
+            return nullptr;
+        }
+        mappedAsset->_data = reinterpret_cast<const char*>(data);
+    }
+
+    // QFile unmaps when it is destroyed, along with the last pointer to it
+    return mappedAsset;
+}
@@ -0,0 +1,72 @@
+//
+//  MappedAssetCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_MappedAssetCache_h
+#define hifi_MappedAssetCache_h
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+// Memory maps of the asset files most recently sent
+//
+// Sending from a map saves reading each request into a buffer of its own: every request for a popular asset reads the
+// same pages, which the OS keeps once and can drop when it needs the memory. Maps are checked against the file each
+// time they are handed out, so a file that has been replaced or removed is mapped again or reported missing.
+// Thread-safe.
+class MappedAssetCache {
+public:
+    class MappedAsset {
+    public:
+        const char* getData() const { return _data; }
+        qint64 getSize() const { return _size; }
+
+    private:
+        friend class MappedAssetCache;
+
+        QFile _file;
+        const char* _data { nullptr };
+        qint64 _size { 0 };
+        QDateTime _lastModified;
+    };
+    using MappedAssetPointer = std::shared_ptr<const MappedAsset>;
+
+    MappedAssetCache(size_t capacity = DEFAULT_CAPACITY) : _capacity(capacity) {}
+
+    // returns nullptr if the asset file can't be opened or mapped
+    // the map stays valid for as long as the pointer is held, even once the cache has dropped it
+    MappedAssetPointer get(const QDir& filesDirectory, const QString& hexHash);
+
+    // drop the map of an asset about to be deleted, some platforms won't delete a mapped file
+    void remove(const QString& hexHash);
+
+    static const size_t DEFAULT_CAPACITY = 64;
+
+private:
+    using Entry = std::pair<QString, MappedAssetPointer>;
+
+    MappedAssetPointer map(const QString& filePath, const QFileInfo& fileInfo);
+
+    std::mutex _mutex;
+    size_t _capacity;
+    std::list<Entry> _entries; // most recently used first
+    QHash<QString, std::list<Entry>::iterator> _index;
+};
+
+#endif // hifi_MappedAssetCache_h
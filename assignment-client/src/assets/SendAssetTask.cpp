@@ -13,8 +13,6 @@
 
 #include <cmath>
 
-#include <QFile>
-
 #include <DependencyManager.h>
 #include <NetworkLogging.h>
 #include <NLPacket.h>
@@ -25,12 +23,16 @@
 #include "AssetUtils.h"
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
+#include "CompressAssetTask.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             MappedAssetCache& mappedAssets, AssetMemoryCache& memoryCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _mappedAssets(mappedAssets),
+    _memoryCache(memoryCache)
 {
     
 }
@@ -47,6 +49,9 @@ void SendAssetTask::run() {
     // starting at index 1.
     _message->readPrimitive(&byteRange.fromInclusive);
     _message->readPrimitive(&byteRange.toExclusive);
+
+    AssetEncoding encoding;
+    _message->readPrimitive(&encoding);
     
     QString hexHash = assetHash.toHex();
     
@@ -55,26 +60,43 @@ void SendAssetTask::run() {
     
     qDebug() << "Starting task to send asset: " << hexHash << " for messageID " << messageID;
     auto replyPacketList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    // a big asset shouldn't hold up the other replies to the node while it goes out
+    replyPacketList->setPriority(udt::PacketList::Low);
 
     replyPacketList->write(assetHash);
 
     replyPacketList->writePrimitive(messageID);
 
+    // the asset comes from memory if it is there, otherwise from the asset file's map
+    QByteArray memoryData;
+    MappedAssetCache::MappedAssetPointer mappedAsset;
+    const char* assetData = nullptr;
+    qint64 fileSize = 0;
+    qint64 bytesSent = 0;
+
     if (!byteRange.isValid()) {
         replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
     } else {
-        QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
+        // only the originals are kept in memory, the compressed copies are read from their files
+        if (encoding == AssetEncoding::Raw) {
+            memoryData = _memoryCache.get(hexHash);
+        }
 
-        if (file.open(QIODevice::ReadOnly)) {
+        if (!memoryData.isNull()) {
+            assetData = memoryData.constData();
+            fileSize = memoryData.size();
+        } else if ((mappedAsset = _mappedAssets.get(_resourcesDir, assetFileName(hexHash, encoding)))) {
+            assetData = mappedAsset->getData();
+            fileSize = mappedAsset->getSize();
+        }
 
+        if (!memoryData.isNull() || mappedAsset) {
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(fileSize);
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (fileSize < byteRange.fromInclusive || fileSize < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -82,35 +104,33 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
-
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
-                    replyPacketList->writePrimitive(AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
-                } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
+                // a negative range starts back from the end of the file
+                auto start = (byteRange.fromInclusive >= 0) ? byteRange.fromInclusive : fileSize + byteRange.fromInclusive;
 
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
+                replyPacketList->writePrimitive(AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
 
-                    replyPacketList->writePrimitive(AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
-                }
+                // straight from memory or the map into the packets
+                replyPacketList->write(assetData + start, size);
+                bytesSent = size;
 
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
-            file.close();
         } else {
-            qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
+            qCDebug(networking) << "Asset not found: " << _resourcesDir.filePath(hexHash) << "(" << hexHash << ")";
             replyPacketList->writePrimitive(AssetServerError::AssetNotFound);
         }
     }
 
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->sendPacketList(std::move(replyPacketList), *_senderNode);
+
+    if (bytesSent > 0) {
+        _memoryCache.recordBytesSent(bytesSent, !memoryData.isNull());
+    }
+
+    // now that the reply is on its way, see if this asset has become popular enough to keep in memory
+    if (mappedAsset && encoding == AssetEncoding::Raw) {
+        _memoryCache.offer(hexHash, mappedAsset->getData(), mappedAsset->getSize());
+    }
 }
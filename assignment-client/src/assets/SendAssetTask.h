@@ -18,14 +18,17 @@
 #include <QtCore/QRunnable>
 
 #include "AssetUtils.h"
+#include "AssetMemoryCache.h"
 #include "AssetServer.h"
+#include "MappedAssetCache.h"
 #include "Node.h"
 
 class NLPacket;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  MappedAssetCache& mappedAssets, AssetMemoryCache& memoryCache);
 
     void run() override;
 
@@ -33,6 +36,8 @@ private:
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    MappedAssetCache& _mappedAssets;
+    AssetMemoryCache& _memoryCache;
 };
 
 #endif
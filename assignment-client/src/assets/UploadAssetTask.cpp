@@ -11,8 +11,12 @@
 
 #include "UploadAssetTask.h"
 
-#include <QtCore/QBuffer>
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryFile>
 
 #include <AssetUtils.h>
 #include <NodeList.h>
@@ -31,16 +35,11 @@ UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage
 }
 
 void UploadAssetTask::run() {
-    auto data = _receivedMessage->getMessage();
-    
-    QBuffer buffer { &data };
-    buffer.open(QIODevice::ReadOnly);
-    
     MessageID messageID;
-    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
+    _receivedMessage->readPrimitive(&messageID);
     
     uint64_t fileSize;
-    buffer.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    _receivedMessage->readPrimitive(&fileSize);
     
     qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes from"
         << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
@@ -50,56 +49,73 @@ void UploadAssetTask::run() {
     
     if (fileSize > MAX_UPLOAD_SIZE) {
         replyPacket->writePrimitive(AssetServerError::AssetTooLarge);
+    } else if (fileSize > (uint64_t)_receivedMessage->getBytesLeftToRead()) {
+        qWarning() << "Upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+            << "is shorter than the" << fileSize << "bytes it claims to be.";
+        replyPacket->writePrimitive(AssetServerError::FileOperationFailed);
     } else {
-        QByteArray fileData = buffer.read(fileSize);
+        // the upload is hashed as it is written out a chunk at a time, so that it is never copied whole in memory,
+        // and goes in under a name of its own so that uploads of the same file at once don't write over each other
+        QCryptographicHash hasher { QCryptographicHash::Sha256 };
+        QTemporaryFile uploadFile { _resourcesDir.filePath("XXXXXX" + UPLOADING_ASSET_SUFFIX) };
+
+        bool isWritten = uploadFile.open();
+        for (uint64_t bytesLeft = fileSize; isWritten && bytesLeft > 0;) {
+            auto chunkSize = std::min(bytesLeft, (uint64_t)ASSET_CHUNK_SIZE);
+            auto chunk = _receivedMessage->readWithoutCopy(chunkSize);
+            hasher.addData(chunk);
+            isWritten = uploadFile.write(chunk) == chunk.size();
+            bytesLeft -= chunkSize;
+        }
         
-        auto hash = hashData(fileData);
+        auto hash = hasher.result();
         auto hexHash = hash.toHex();
         
         qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
             << "is: (" << hexHash << ") ";
         
-        QFile file { _resourcesDir.filePath(QString(hexHash)) };
+        QString filePath = _resourcesDir.filePath(QString(hexHash));
 
-        bool existingCorrectFile = false;
-        
-        if (file.exists()) {
-            // check if the local file has the correct contents, otherwise we overwrite
-            if (file.open(QIODevice::ReadOnly) && hashData(file.readAll()) == hash) {
-                qDebug() << "Not overwriting existing verified file: " << hexHash;
+        if (!isWritten) {
+            qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
 
-                existingCorrectFile = true;
+            // the partial upload is removed along with the temporary file
+            replyPacket->writePrimitive(AssetServerError::FileOperationFailed);
+        } else if (QFileInfo(filePath).size() == qint64(fileSize)) {
+            // files are named by the hash of their contents, one of the same size is taken to already be this one
+            qDebug() << "Not overwriting existing file: " << hexHash;
 
-                replyPacket->writePrimitive(AssetServerError::NoError);
-                replyPacket->write(hash);
-            } else {
-                qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
-                file.close();
+            replyPacket->writePrimitive(AssetServerError::NoError);
+            replyPacket->write(hash);
+        } else {
+            if (QFile::exists(filePath)) {
+                qDebug() << "Replacing an existing file whose size did not match the upload: " << hexHash;
+
+                // replace rather than truncate the file, it may still be mapped by an asset being sent
+                QFile::remove(filePath);
+            }
+
+            uploadFile.close();
+            uploadFile.setAutoRemove(false);
+            bool isMoved = uploadFile.rename(filePath);
+            if (!isMoved) {
+                uploadFile.remove();
             }
-        }
 
-        if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
+            if (isMoved) {
                 qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
-                file.close();
 
+                replyPacket->writePrimitive(AssetServerError::NoError);
+                replyPacket->write(hash);
+            } else if (QFileInfo(filePath).size() == qint64(fileSize)) {
+                // another upload of the same file got there first
                 replyPacket->writePrimitive(AssetServerError::NoError);
                 replyPacket->write(hash);
             } else {
-                qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
-
-                // upload has failed - remove the file and return an error
-                auto removed = file.remove();
-
-                if (!removed) {
-                    qWarning() << "Removal of failed upload file" << hexHash << "failed.";
-                }
-                
+                qWarning() << "Failed to move upload into place as file" << hexHash << " - upload failed.";
                 replyPacket->writePrimitive(AssetServerError::FileOperationFailed);
             }
         }
-
-
     }
     
     auto nodeList = DependencyManager::get<NodeList>();
@@ -21,6 +21,9 @@
 
 #include "ReceivedMessage.h"
 
+// uploads are written to files with this suffix until they are whole and can be moved to the name of their hash
+const QString UPLOADING_ASSET_SUFFIX = ".upload";
+
 class NLPacketList;
 class Node;
 
@@ -0,0 +1,84 @@
+//
+//  AudioHRTFPremixCache.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cmath>
+#include <cstring>
+
+#include <glm/glm.hpp>
+
+#include <NumericalConstants.h>
+
+#include "AudioHRTFPremixCache.h"
+
+int AudioHRTFPremixCache::quantize(float& azimuth, float& distance) {
+    // wrap to [0, AZIMUTH_BUCKETS)
+    int azimuthBucket = (int)std::floor(azimuth * (AZIMUTH_BUCKETS / TWO_PI) + 0.5f) % AZIMUTH_BUCKETS;
+    if (azimuthBucket < 0) {
+        azimuthBucket += AZIMUTH_BUCKETS;
+    }
+
+    int distanceBucket = (int)std::floor(std::log2(glm::max(distance, 1.0f)) * DISTANCE_BUCKETS_PER_OCTAVE + 0.5f);
+    distanceBucket = glm::clamp(distanceBucket, 0, MAX_DISTANCE_BUCKET);
+
+    azimuth = azimuthBucket * (TWO_PI / AZIMUTH_BUCKETS);
+    distance = std::exp2((float)distanceBucket / DISTANCE_BUCKETS_PER_OCTAVE);
+
+    return distanceBucket * AZIMUTH_BUCKETS + azimuthBucket;
+}
+
+const float* AudioHRTFPremixCache::get(const QUuid& nodeID, const QUuid& streamID, int bucket, unsigned int frame,
+        int16_t* input, int index, float azimuth, float distance) {
+    Premix* premix;
+    {
+        // references into the maps are stable until removeStale, so only lookup is guarded
+        std::lock_guard<std::mutex> lock(_mutex);
+        premix = &_premixes[nodeID][PremixKey(streamID, bucket)];
+    }
+
+    // the first listener in this bucket renders, the rest reuse
+    std::lock_guard<std::mutex> lock(premix->mutex);
+    if (!premix->isRendered || premix->frame != frame) {
+        memset(premix->samples, 0, sizeof(premix->samples));
+        premix->hrtf.render(input, premix->samples, index, azimuth, distance, 1.0f,
+                            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        premix->frame = frame;
+        premix->isRendered = true;
+    }
+
+    return premix->samples;
+}
+
+void AudioHRTFPremixCache::removeStale(unsigned int frame) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto node = _premixes.begin();
+    while (node != _premixes.end()) {
+        auto& premixes = node->second;
+        auto premix = premixes.begin();
+        while (premix != premixes.end()) {
+            if (premix->second.frame != frame) {
+                premix = premixes.erase(premix);
+            } else {
+                ++premix;
+            }
+        }
+
+        if (premixes.empty()) {
+            node = _premixes.erase(node);
+        } else {
+            ++node;
+        }
+    }
+}
+
+void AudioHRTFPremixCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _premixes.clear();
+}
@@ -0,0 +1,72 @@
+//
+//  AudioHRTFPremixCache.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioHRTFPremixCache_h
+#define hifi_AudioHRTFPremixCache_h
+
+#include <mutex>
+#include <unordered_map>
+
+#include <QUuid>
+
+#include <AudioConstants.h>
+#include <AudioHRTF.h>
+#include <UUIDHasher.h>
+
+// Shared HRTF pre-mixes for the audio mixer
+//   Listeners near the same streamer compute nearly identical HRTF renders. In pre-mix mode, each stream is rendered
+//   once per frame for each (azimuth, distance) bucket it is heard from, at unity gain, and every listener in that
+//   bucket scales and accumulates the shared block instead of running its own FIR.
+//
+//   Azimuth is quantized to the HRTF table resolution and distance to the quarter-octave steps of the distance filter.
+//   Since the FIR state is per bucket rather than per listener, a listener crossing buckets may hear a short transient.
+//
+//   get() is thread-safe and may be called from any slave during a mix. removeStale() must be called between mixes.
+class AudioHRTFPremixCache {
+public:
+    static const int AZIMUTH_BUCKETS = HRTF_AZIMUTHS;
+    static const int DISTANCE_BUCKETS_PER_OCTAVE = 4;
+    static const int MAX_DISTANCE_BUCKET = 16 * DISTANCE_BUCKETS_PER_OCTAVE; // up to 2^16m
+
+    // returns the bucket for a given azimuth (radians) and distance (meters),
+    // and overwrites azimuth and distance with the values at the bucket center
+    static int quantize(float& azimuth, float& distance);
+
+    // returns the pre-mix (interleaved stereo, unity gain) of a stream for this bucket and frame,
+    // rendering it from input if this is the first request this frame
+    const float* get(const QUuid& nodeID, const QUuid& streamID, int bucket, unsigned int frame,
+            int16_t* input, int index, float azimuth, float distance);
+
+    // drop pre-mixes that were not requested on the given frame
+    void removeStale(unsigned int frame);
+
+    void clear();
+
+private:
+    struct Premix {
+        AudioHRTF hrtf;
+        float samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        unsigned int frame { 0 };
+        bool isRendered { false };
+        std::mutex mutex;
+    };
+
+    using PremixKey = std::pair<QUuid, int>;
+    struct PremixKeyHasher {
+        std::size_t operator()(const PremixKey& key) const { return qHash(key.first) ^ std::hash<int>()(key.second); }
+    };
+
+    // premixes of each stream (keyed by stream ID and bucket) for each source node
+    using PremixMap = std::unordered_map<PremixKey, Premix, PremixKeyHasher>;
+    std::unordered_map<QUuid, PremixMap> _premixes;
+    std::mutex _mutex;
+};
+
+#endif // hifi_AudioHRTFPremixCache_h
@@ -25,6 +25,7 @@
 #include <plugins/CodecPlugin.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
+#include <shared/Metrics.h>
 #include <StDev.h>
 #include <UUID.h>
 #include <CPUDetect.h>
@@ -32,8 +33,10 @@
 #include "AudioHelpers.h"
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
+#include "AudioMixerRealTime.h"
 #include "AvatarAudioStream.h"
 #include "InjectedAudioStream.h"
+#include "../ThreadPlacement.h"
 
 #include "AudioMixer.h"
 
@@ -44,10 +47,14 @@ static const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 static const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 static const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
 static const QString AUDIO_THREADING_GROUP_KEY = "audio_threading";
+static const float IGNORE_RADIUS_GRID_CELL_SIZE = 5.0f; // meters, about the size of an ignore zone
 
 int AudioMixer::_numStaticJitterFrames{ DISABLE_STATIC_JITTER_FRAMES };
+bool AudioMixer::_enableTimeStretch{ false };
 float AudioMixer::_noiseMutingThreshold{ DEFAULT_NOISE_MUTING_THRESHOLD };
 float AudioMixer::_attenuationPerDoublingInDistance{ DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE };
+int AudioMixer::_numForwardedStreams{ 0 };
+float AudioMixer::_ambisonicBedDistance{ 0.0f };
 std::map<QString, std::shared_ptr<CodecPlugin>> AudioMixer::_availableCodecs{ };
 QStringList AudioMixer::_codecPreferenceOrder{};
 QHash<QString, AABox> AudioMixer::_audioZones;
@@ -73,13 +80,17 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
 
-    // packets whose consequences are limited to their own node can be parallelized
-    packetReceiver.registerListenerForTypes({
+    // the audio streams are most of our packets, queue them straight from the network thread
+    packetReceiver.registerDirectListenerForTypes({
             PacketType::MicrophoneAudioNoEcho,
             PacketType::MicrophoneAudioWithEcho,
             PacketType::InjectAudio,
+            PacketType::SilentAudioFrame },
+            this, "queueAudioPacketDirect");
+
+    // packets whose consequences are limited to their own node can be parallelized
+    packetReceiver.registerListenerForTypes({
             PacketType::AudioStreamStats,
-            PacketType::SilentAudioFrame,
             PacketType::NegotiateAudioFormat,
             PacketType::MuteEnvironment,
             PacketType::NodeIgnoreRequest,
@@ -102,6 +113,16 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
         this, "queueReplicatedAudioPacket"
     );
 
+    // send parity with the mixes to clients that report losing them
+    nodeList->setFECEnabled(PacketType::MixedAudio, true);
+    nodeList->setFECEnabled(PacketType::ForwardedMixedAudio, true);
+    nodeList->setFECEnabled(PacketType::SilentAudioFrame, true);
+
+    // the environment and mute messages to a client share a datagram with whatever else goes to it in the frame
+    nodeList->setCoalescingEnabled(PacketType::AudioEnvironment, true);
+    nodeList->setCoalescingEnabled(PacketType::NoisyMute, true);
+    nodeList->setCoalescingEnabled(PacketType::MuteEnvironment, true);
+
     connect(nodeList.data(), &NodeList::nodeKilled, this, &AudioMixer::handleNodeKilled);
 }
 
@@ -110,7 +131,23 @@ void AudioMixer::queueAudioPacket(QSharedPointer<ReceivedMessage> message, Share
         _numSilentPackets++;
     }
 
-    getOrCreateClientData(node.data())->queuePacket(message, node);
+    getOrCreateClientData(node.data())->queuePacket(message);
+}
+
+void AudioMixer::queueAudioPacketDirect(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    // this is called on the network thread, so only the node's existing client data can be used here
+    auto clientData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+    if (!clientData) {
+        QMetaObject::invokeMethod(this, "queueAudioPacket", Qt::QueuedConnection,
+                                  Q_ARG(QSharedPointer<ReceivedMessage>, message),
+                                  Q_ARG(SharedNodePointer, node));
+        return;
+    }
+
+    if (message->getType() == PacketType::SilentAudioFrame) {
+        _numSilentPackets++;
+    }
+    clientData->queuePacket(message);
 }
 
 void AudioMixer::queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> message) {
@@ -137,7 +174,7 @@ void AudioMixer::queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> mess
                                                                      versionForPacketType(rewrittenType),
                                                                      message->getSenderSockAddr(), nodeID);
 
-    getOrCreateClientData(replicatedNode.data())->queuePacket(replicatedMessage, replicatedNode);
+    getOrCreateClientData(replicatedNode.data())->queuePacket(replicatedMessage);
 }
 
 void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -265,6 +302,7 @@ void AudioMixer::sendStatsPacket() {
     statsObject["useDynamicJitterBuffers"] = _numStaticJitterFrames == DISABLE_STATIC_JITTER_FRAMES;
 
     statsObject["threads"] = _slavePool.numThreads();
+    statsObject["real_time_scheduling"] = _useRealTimeScheduling;
 
     statsObject["trailing_mix_ratio"] = _trailingMixRatio;
     statsObject["throttling_ratio"] = _throttlingRatio;
@@ -272,6 +310,7 @@ void AudioMixer::sendStatsPacket() {
     statsObject["avg_streams_per_frame"] = (float)_stats.sumStreams / (float)_numStatFrames;
     statsObject["avg_listeners_per_frame"] = (float)_stats.sumListeners / (float)_numStatFrames;
     statsObject["avg_listeners_(silent)_per_frame"] = (float)_stats.sumListenersSilent / (float)_numStatFrames;
+    statsObject["avg_listeners_(idle_limiter)_per_frame"] = (float)_stats.idleLimiterMixes / (float)_numStatFrames;
 
     statsObject["silent_packets_per_frame"] = (float)_numSilentPackets / (float)_numStatFrames;
 
@@ -306,14 +345,35 @@ void AudioMixer::sendStatsPacket() {
     mixStats["%_hrtf_mixes"] = percentageForMixStats(_stats.hrtfRenders);
     mixStats["%_hrtf_silent_mixes"] = percentageForMixStats(_stats.hrtfSilentRenders);
     mixStats["%_hrtf_throttle_mixes"] = percentageForMixStats(_stats.hrtfThrottleRenders);
+    mixStats["%_hrtf_premix_mixes"] = percentageForMixStats(_stats.hrtfPremixes);
+    mixStats["%_ambisonic_bed_mixes"] = percentageForMixStats(_stats.ambisonicBedMixes);
     mixStats["%_manual_stereo_mixes"] = percentageForMixStats(_stats.manualStereoMixes);
     mixStats["%_manual_echo_mixes"] = percentageForMixStats(_stats.manualEchoMixes);
+    mixStats["%_forwarded_streams"] = percentageForMixStats(_stats.forwardedStreams);
 
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
+    // dormant streams are skipped rather than mixed
+    mixStats["avg_dormant_streams_per_block"] = _stats.dormantStreams / _numStatFrames;
 
     statsObject["mix_stats"] = mixStats;
 
+    // deadline stats
+    QJsonObject deadlineStats;
+
+    auto percentageForFrames = [&](int frames) {
+        return QString::number((float)frames / (float)_numStatFrames * 100.0f, 'f', 2);
+    };
+
+    deadlineStats["%_overrun_frames"] = percentageForFrames(_stats.deadlineSlack[0]);
+    deadlineStats["%_slack_under_1ms_frames"] = percentageForFrames(_stats.deadlineSlack[1]);
+    deadlineStats["%_slack_under_2.5ms_frames"] = percentageForFrames(_stats.deadlineSlack[2]);
+    deadlineStats["%_slack_under_5ms_frames"] = percentageForFrames(_stats.deadlineSlack[3]);
+    deadlineStats["%_slack_over_5ms_frames"] = percentageForFrames(_stats.deadlineSlack[4]);
+    deadlineStats["max_overrun_us"] = _stats.maxOverrunUsecs;
+
+    statsObject["deadline_stats"] = deadlineStats;
+
     _numStatFrames = _numSilentPackets = 0;
     _stats.reset();
 
@@ -384,10 +444,26 @@ void AudioMixer::start() {
         parseSettingsObject(settingsObject);
     }
 
+    // on a shared host, scheduling jitter otherwise makes frames overrun, which then throttles streams
+    if (_useRealTimeScheduling) {
+        const int REAL_TIME_PRIORITY = 40; // below the threaded interrupt handlers
+        // core 0 where the process may run on it, the slaves go on the cores of its NUMA node next
+        const int MIXER_CORE = getThreadPlacementCores(0).front();
+        if (setAudioMixerThreadPriority(REAL_TIME_PRIORITY) && pinAudioMixerThread(MIXER_CORE)) {
+            qDebug() << "Real-time scheduling enabled.";
+        } else {
+            qWarning() << "Real-time scheduling is not permitted (it needs CAP_SYS_NICE or an rtprio limit).";
+        }
+        _slavePool.setRealTime(true, REAL_TIME_PRIORITY, MIXER_CORE);
+    }
+
     // mix state
     unsigned int frame = 1;
     auto frameTimestamp = p_high_resolution_clock::now();
 
+    auto& frameMetric = metrics::Registry::getInstance().histogram("audio_mixer_frame_usecs",
+        "Time to prepare and mix a frame for every listener", metrics::timingBucketsUsecs());
+
     while (!_isFinished) {
         auto ticTimer = _ticTiming.timer();
 
@@ -398,6 +474,7 @@ void AudioMixer::start() {
         }
 
         auto frameTimer = _frameTiming.timer();
+        auto frameStart = p_high_resolution_clock::now();
 
         nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
             // prepare frames; pop off any new audio from their streams
@@ -408,18 +485,39 @@ void AudioMixer::start() {
                 });
             }
 
+            // index the ignore zones once, the slaves share them read-only
+            _ignoreRadiusGrid.rebuild(cbegin, cend, IGNORE_RADIUS_GRID_CELL_SIZE, [&](const SharedNodePointer& node,
+                                                                                  glm::vec3& position, float& radius) {
+                AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+                if (!nodeData || !nodeData->getAvatarAudioStream()) {
+                    return false;
+                }
+                const AABox& zone = nodeData->getIgnoreZone(frame);
+                position = zone.calcCenter();
+                radius = 0.5f * glm::length(zone.getScale());
+                return true;
+            });
+
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                _slavePool.mix(cbegin, cend, frame, _throttlingRatio, _useHRTFPremix ? &_hrtfPremixCache : nullptr,
+                               &_ignoreRadiusGrid);
             }
         });
 
+        // drop pre-mixes that no listener heard this frame
+        if (_useHRTFPremix) {
+            _hrtfPremixCache.removeStale(frame);
+        }
+
         // gather stats
         _slavePool.each([&](AudioMixerSlave& slave) {
             _stats.accumulate(slave.stats);
             slave.stats.reset();
         });
+        frameMetric.observe((double)std::chrono::duration_cast<std::chrono::microseconds>(
+            p_high_resolution_clock::now() - frameStart).count());
 
         ++frame;
         ++_numStatFrames;
@@ -456,13 +554,20 @@ std::chrono::microseconds AudioMixer::timeFrame(p_high_resolution_clock::time_po
     // compute how long the last frame took
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now - timestamp);
 
+    // and how much time it left before its deadline
+    _stats.addDeadlineSlack(std::chrono::duration_cast<std::chrono::microseconds>(nextTimestamp - now));
+
     // set the new frame timestamp
     timestamp = std::max(now, nextTimestamp);
 
     // sleep until the next frame should start
-    // WIN32 sleep_until is broken until VS2015 Update 2
-    // instead, std::max (above) guarantees that timestamp >= now, so we can sleep_for
-    std::this_thread::sleep_for(timestamp - now);
+    if (_useRealTimeScheduling) {
+        sleepUntilAudioMixerDeadline(timestamp);
+    } else {
+        // WIN32 sleep_until is broken until VS2015 Update 2
+        // instead, std::max (above) guarantees that timestamp >= now, so we can sleep_for
+        std::this_thread::sleep_for(timestamp - now);
+    }
 
     return duration;
 }
@@ -525,7 +630,10 @@ int AudioMixer::prepareFrame(const SharedNodePointer& node, unsigned int frame)
 
 void AudioMixer::clearDomainSettings() {
     _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
+    _enableTimeStretch = false;
     _attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE;
+    _numForwardedStreams = 0;
+    _ambisonicBedDistance = 0.0f;
     _noiseMutingThreshold = DEFAULT_NOISE_MUTING_THRESHOLD;
     _codecPreferenceOrder.clear();
     _audioZones.clear();
@@ -548,6 +656,9 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
                 _slavePool.setNumThreads(numThreads);
             }
         }
+
+        const QString REAL_TIME_SCHEDULING = "real_time_scheduling";
+        _useRealTimeScheduling = audioThreadingGroupObject[REAL_TIME_SCHEDULING].toBool();
     }
 
     if (settingsObject.contains(AUDIO_BUFFER_GROUP_KEY)) {
@@ -571,6 +682,10 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
         }
 
+        const QString TIME_STRETCH_JITTER_BUFFER_JSON_KEY = "time_stretch_jitter_buffer";
+        _enableTimeStretch = audioBufferGroupObject[TIME_STRETCH_JITTER_BUFFER_JSON_KEY].toBool();
+        qDebug() << "Time-stretch jitter buffers:" << _enableTimeStretch;
+
         // check for deprecated audio settings
         auto deprecationNotice = [](const QString& setting, const QString& value) {
             qInfo().nospace() << "[DEPRECATION NOTICE] " << setting << "(" << value << ") has been deprecated, and has no effect";
@@ -634,6 +749,34 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             }
         }
 
+        const QString FORWARDED_STREAMS = "forwarded_streams";
+        if (audioEnvGroupObject[FORWARDED_STREAMS].isString()) {
+            bool ok = false;
+            int numForwardedStreams = audioEnvGroupObject[FORWARDED_STREAMS].toString().toInt(&ok);
+            if (ok && numForwardedStreams >= 0) {
+                _numForwardedStreams = numForwardedStreams;
+                qDebug() << "Forwarded streams changed to" << _numForwardedStreams;
+            }
+        }
+
+        const QString AMBISONIC_BED_DISTANCE = "ambisonic_bed_distance";
+        if (audioEnvGroupObject[AMBISONIC_BED_DISTANCE].isString()) {
+            bool ok = false;
+            float ambisonicBedDistance = audioEnvGroupObject[AMBISONIC_BED_DISTANCE].toString().toFloat(&ok);
+            if (ok && ambisonicBedDistance >= 0.0f) {
+                _ambisonicBedDistance = ambisonicBedDistance;
+                qDebug() << "Ambisonic bed distance changed to" << _ambisonicBedDistance;
+            }
+        }
+
+        const QString SHARED_HRTF_PREMIX = "shared_hrtf_premix";
+        bool useHRTFPremix = audioEnvGroupObject[SHARED_HRTF_PREMIX].toBool();
+        if (useHRTFPremix != _useHRTFPremix) {
+            _useHRTFPremix = useHRTFPremix;
+            _hrtfPremixCache.clear();
+            qDebug() << "Shared HRTF pre-mix" << (_useHRTFPremix ? "enabled" : "disabled");
+        }
+
         const QString NOISE_MUTING_THRESHOLD = "noise_muting_threshold";
         if (audioEnvGroupObject[NOISE_MUTING_THRESHOLD].isString()) {
             bool ok = false;
@@ -12,14 +12,18 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <atomic>
+
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 
+#include "AudioHRTFPremixCache.h"
 #include "AudioMixerStats.h"
 #include "AudioMixerSlavePool.h"
+#include "../NodeSpatialGrid.h"
 
 class PositionalAudioStream;
 class AvatarAudioStream;
@@ -44,8 +48,14 @@ public:
     };
 
     static int getStaticJitterFrames() { return _numStaticJitterFrames; }
+    static bool getTimeStretchEnabled() { return _enableTimeStretch; }
     static bool shouldMute(float quietestFrame) { return quietestFrame > _noiseMutingThreshold; }
     static float getAttenuationPerDoublingInDistance() { return _attenuationPerDoublingInDistance; }
+    // how many of the loudest streams are forwarded to the listeners that accept them, instead of being mixed
+    static int getNumForwardedStreams() { return _numForwardedStreams; }
+    // how far a stream has to be from a listener to be mixed into its ambisonic bed rather than with its own HRTF,
+    // 0 when there is no bed
+    static float getAmbisonicBedDistance() { return _ambisonicBedDistance; }
     static const QHash<QString, AABox>& getAudioZones() { return _audioZones; }
     static const QVector<ZoneSettings>& getZoneSettings() { return _zoneSettings; }
     static const QVector<ReverbSettings>& getReverbSettings() { return _zoneReverbSettings; }
@@ -68,6 +78,7 @@ private slots:
     void handleKillAvatarPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
 
     void queueAudioPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
+    void queueAudioPacketDirect(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> packet);
     void removeHRTFsForFinishedInjector(const QUuid& streamID);
     void start();
@@ -90,13 +101,20 @@ private:
     float _trailingMixRatio { 0.0f };
     float _throttlingRatio { 0.0f };
 
-    int _numSilentPackets { 0 };
+    std::atomic<int> _numSilentPackets { 0 };
 
     int _numStatFrames { 0 };
     AudioMixerStats _stats;
 
     AudioMixerSlavePool _slavePool;
 
+    bool _useHRTFPremix { false };
+    AudioHRTFPremixCache _hrtfPremixCache;
+    NodeSpatialGrid _ignoreRadiusGrid;
+
+    // run the mixer and its slaves at real-time priority, pinned to cores, with precise frame deadlines
+    bool _useRealTimeScheduling { false };
+
     class Timer {
     public:
         class Timing{
@@ -127,8 +145,11 @@ private:
     Timer _packetsTiming;
 
     static int _numStaticJitterFrames; // -1 denotes dynamic jitter buffering
+    static bool _enableTimeStretch;
     static float _noiseMutingThreshold;
     static float _attenuationPerDoublingInDistance;
+    static int _numForwardedStreams;
+    static float _ambisonicBedDistance;
     static std::map<QString, CodecPluginPointer> _availableCodecs;
     static QStringList _codecPreferenceOrder;
     static QHash<QString, AABox> _audioZones;
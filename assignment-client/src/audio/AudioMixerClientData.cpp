@@ -48,21 +48,22 @@ AudioMixerClientData::~AudioMixerClientData() {
     }
 }
 
-void AudioMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
-    if (!_packetQueue.node) {
-        _packetQueue.node = node;
-    }
+void AudioMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message) {
     _packetQueue.push(message);
 }
 
-void AudioMixerClientData::processPackets() {
-    SharedNodePointer node = _packetQueue.node;
-    assert(_packetQueue.empty() || node);
-    _packetQueue.node.clear();
-
-    while (!_packetQueue.empty()) {
-        auto& packet = _packetQueue.front();
+void AudioMixerClientData::processPackets(const SharedNodePointer& node) {
+    // only the audio received for this frame is forwarded
+    {
+        QReadLocker readLocker { &_streamsLock };
+        for (auto& streamPair : _audioStreams) {
+            streamPair.second->clearEncodedFrames();
+        }
+    }
 
+    // packets can keep arriving while these are processed, leave those for the next frame
+    QSharedPointer<ReceivedMessage> packet;
+    for (size_t i = 0; i < _packetQueue.capacity() && _packetQueue.pop(packet); ++i) {
         switch (packet->getType()) {
             case PacketType::MicrophoneAudioNoEcho:
             case PacketType::MicrophoneAudioWithEcho:
@@ -84,6 +85,10 @@ void AudioMixerClientData::processPackets() {
                 QMutexLocker lock(&getMutex());
                 parseData(*packet);
 
+                // the client reports what it lost of the mix we send it, send it parity if that is enough to matter
+                DependencyManager::get<NodeList>()->setFECLossRate(*node,
+                    _downstreamAudioStreamStats._packetStreamWindowStats.getLostRate());
+
                 break;
             }
             case PacketType::NegotiateAudioFormat:
@@ -104,10 +109,7 @@ void AudioMixerClientData::processPackets() {
             default:
                 Q_UNREACHABLE();
         }
-
-        _packetQueue.pop();
     }
-    assert(_packetQueue.empty());
 }
 
 bool isReplicatedPacket(PacketType packetType) {
@@ -170,6 +172,13 @@ void AudioMixerClientData::negotiateAudioFormat(ReceivedMessage& message, const
     for (auto i = 0; i < numberOfCodecs; i++) {
         codecs.push_back(message.readString());
     }
+
+    // clients that spatialize the streams themselves say so after their codecs
+    _acceptsForwardedStreams = false;
+    if (message.getBytesLeftToRead() >= (qint64)sizeof(_acceptsForwardedStreams)) {
+        message.readPrimitive(&_acceptsForwardedStreams);
+    }
+
     const std::pair<QString, CodecPluginPointer> codec = AudioMixer::negotiateCodec(codecs);
 
     setupCodec(codec.second, codec.first);
@@ -276,6 +285,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
 
                 auto avatarAudioStream = new AvatarAudioStream(isStereo, AudioMixer::getStaticJitterFrames());
                 avatarAudioStream->setupCodec(_codec, _selectedCodecName, AudioConstants::MONO);
+                avatarAudioStream->setTimeStretchEnabled(AudioMixer::getTimeStretchEnabled());
                 qDebug() << "creating new AvatarAudioStream... codec:" << _selectedCodecName;
 
                 connect(avatarAudioStream, &InboundAudioStream::mismatchedAudioCodec,
@@ -312,6 +322,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
             if (streamIt == _audioStreams.end()) {
                 // we don't have this injected stream yet, so add it
                 auto injectorStream = new InjectedAudioStream(streamIdentifier, isStereo, AudioMixer::getStaticJitterFrames());
+                injectorStream->setTimeStretchEnabled(AudioMixer::getTimeStretchEnabled());
 
 #if INJECTORS_SUPPORT_CODECS
                 injectorStream->setupCodec(_codec, _selectedCodecName, isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
@@ -643,7 +654,8 @@ bool AudioMixerClientData::IgnoreNodeCache::shouldIgnore() {
     return ignore;
 }
 
-bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const SharedNodePointer node, unsigned int frame) {
+bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const SharedNodePointer node, unsigned int frame,
+        const std::unordered_set<const Node*>* ignoreRadiusNeighbors) {
     // this is symmetric over self / node; if computed, it is cached in the other
 
     // check the cache to avoid computation
@@ -667,9 +679,13 @@ bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const Shar
 
         // if either node is enabling an ignore radius, check their proximity
         if ((self->isIgnoreRadiusEnabled() || node->isIgnoreRadiusEnabled())) {
-            auto& zone = _ignoreZone.get(frame);
-            auto& nodeZone = nodeData->_ignoreZone.get(frame);
-            shouldIgnore = zone.touches(nodeZone);
+            if (ignoreRadiusNeighbors) {
+                shouldIgnore = ignoreRadiusNeighbors->count(node.data()) > 0;
+            } else {
+                auto& zone = _ignoreZone.get(frame);
+                auto& nodeZone = nodeData->_ignoreZone.get(frame);
+                shouldIgnore = zone.touches(nodeZone);
+            }
         } else {
             shouldIgnore = false;
         }
@@ -12,14 +12,16 @@
 #ifndef hifi_AudioMixerClientData_h
 #define hifi_AudioMixerClientData_h
 
-#include <queue>
+#include <unordered_set>
 
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioFOA.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
 #include <UUIDHasher.h>
+#include <shared/MPSCRingBuffer.h>
 
 #include <plugins/CodecPlugin.h>
 
@@ -35,16 +37,22 @@ public:
     using SharedStreamPointer = std::shared_ptr<PositionalAudioStream>;
     using AudioStreamMap = std::unordered_map<QUuid, SharedStreamPointer>;
 
-    void queuePacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer node);
-    void processPackets();
+    // safe to call from any thread, processPackets is only called from one mixer thread at a time
+    void queuePacket(QSharedPointer<ReceivedMessage> packet);
+    void processPackets(const SharedNodePointer& node);
 
     // locks the mutex to make a copy
     AudioStreamMap getAudioStreams() { QReadLocker readLock { &_streamsLock }; return _audioStreams; }
     AvatarAudioStream* getAvatarAudioStream();
 
     // returns whether self (this data's node) should ignore node, memoized by frame
+    // if ignoreRadiusNeighbors is set, it has the nodes whose ignore zones touch self's, found ahead for this frame
     // precondition: frame is increasing after first call (including overflow wrap)
-    bool shouldIgnore(SharedNodePointer self, SharedNodePointer node, unsigned int frame);
+    bool shouldIgnore(SharedNodePointer self, SharedNodePointer node, unsigned int frame,
+            const std::unordered_set<const Node*>* ignoreRadiusNeighbors = nullptr);
+
+    // returns the zone that another node's has to touch for the ignore radius of either to apply, memoized by frame
+    const AABox& getIgnoreZone(unsigned int frame) { return _ignoreZone.get(frame); }
 
     // the following methods should be called from the AudioMixer assignment thread ONLY
     // they are not thread-safe
@@ -84,6 +92,12 @@ public:
     bool shouldSendStats(int frameNumber);
 
     AudioLimiter audioLimiter;
+    int silentMixFrames { 0 }; // how many mixes in a row have been silent, up to when the limiter is idle
+
+    // the distant streams of a mix are encoded into a first order ambisonic bed that is decoded with this, see
+    // AudioMixer::getAmbisonicBedDistance()
+    AudioFOA ambisonicBed;
+    bool hasAmbisonicBedTail { false };
 
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
@@ -101,6 +115,9 @@ public:
 
     QString getCodecName() { return _selectedCodecName; }
 
+    // whether the client can be sent the loudest streams as they were received, to spatialize them itself
+    bool acceptsForwardedStreams() const { return _acceptsForwardedStreams; }
+
     bool shouldMuteClient() { return _shouldMuteClient; }
     void setShouldMuteClient(bool shouldMuteClient) { _shouldMuteClient = shouldMuteClient; }
     glm::vec3 getPosition() { return getAvatarAudioStream() ? getAvatarAudioStream()->getPosition() : glm::vec3(0); }
@@ -109,6 +126,11 @@ public:
 
     void setupCodecForReplicatedAgent(QSharedPointer<ReceivedMessage> message);
 
+    // time spent mixing for this listener on its last mix, used by the slave pool to balance work
+    // written by the mixing slave, read by the pool between frames
+    uint64_t getMixCost() const { return _mixCost; }
+    void setMixCost(uint64_t mixCostUsecs) { _mixCost = mixCostUsecs; }
+
 signals:
     void injectorStreamFinished(const QUuid& streamIdentifier);
 
@@ -117,10 +139,9 @@ public slots:
     void sendSelectAudioFormat(SharedNodePointer node, const QString& selectedCodecName);
 
 private:
-    struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
-        QWeakPointer<Node> node;
-    };
-    PacketQueue _packetQueue;
+    // a bit over two seconds of audio frames, if the mixer falls that far behind newer packets are dropped
+    static const size_t PACKET_QUEUE_CAPACITY = 256;
+    MPSCRingBuffer<QSharedPointer<ReceivedMessage>> _packetQueue { PACKET_QUEUE_CAPACITY };
 
     QReadWriteLock _streamsLock;
     AudioStreamMap _audioStreams; // microphone stream from avatar is stored under key of null UUID
@@ -181,9 +202,12 @@ private:
     Decoder* _decoder{ nullptr }; // for mic stream
 
     bool _shouldFlushEncoder { false };
+    bool _acceptsForwardedStreams { false };
 
     bool _shouldMuteClient { false };
     bool _requestsDomainListData { false };
+
+    uint64_t _mixCost { 0 };
 };
 
 #endif // hifi_AudioMixerClientData_h
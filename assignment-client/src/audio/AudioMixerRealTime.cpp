@@ -0,0 +1,73 @@
+//
+//  AudioMixerRealTime.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerRealTime.h"
+
+#include <chrono>
+#include <thread>
+
+#include <QtCore/QtGlobal>
+
+#include "../ThreadPlacement.h"
+
+#if defined(Q_OS_LINUX)
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/prctl.h>
+#endif
+
+bool setAudioMixerThreadPriority(int priority) {
+#if defined(Q_OS_LINUX)
+    sched_param param {};
+    param.sched_priority = priority;
+    int policy = (priority > 0) ? SCHED_FIFO : SCHED_OTHER;
+    if (pthread_setschedparam(pthread_self(), policy, &param) != 0) {
+        return false;
+    }
+
+    // timers of a real-time thread fire when they are due, rather than up to 50us later
+    const unsigned long REAL_TIME_TIMER_SLACK_NSECS = 1;
+    const unsigned long DEFAULT_TIMER_SLACK_NSECS = 0; // restores the default of the process
+    prctl(PR_SET_TIMERSLACK, (priority > 0) ? REAL_TIME_TIMER_SLACK_NSECS : DEFAULT_TIMER_SLACK_NSECS);
+    return true;
+#else
+    Q_UNUSED(priority);
+    return false;
+#endif
+}
+
+bool pinAudioMixerThread(int core) {
+    return pinThreadToCore(core);
+}
+
+void sleepUntilAudioMixerDeadline(p_high_resolution_clock::time_point deadline) {
+    auto now = p_high_resolution_clock::now();
+    if (deadline <= now) {
+        return;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+
+#if defined(Q_OS_LINUX)
+    // the frame clock is not necessarily monotonic, so the deadline is moved onto CLOCK_MONOTONIC once,
+    // and the sleep is resumed towards the same absolute time when it is interrupted
+    const long NSECS_PER_SEC = 1000000000L;
+    timespec wakeup;
+    clock_gettime(CLOCK_MONOTONIC, &wakeup);
+    long long nsecs = (long long)wakeup.tv_nsec + remaining.count();
+    wakeup.tv_sec += (time_t)(nsecs / NSECS_PER_SEC);
+    wakeup.tv_nsec = (long)(nsecs % NSECS_PER_SEC);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, nullptr) == EINTR) {}
+#else
+    std::this_thread::sleep_for(remaining);
+#endif
+}
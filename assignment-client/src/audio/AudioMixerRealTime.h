@@ -0,0 +1,31 @@
+//
+//  AudioMixerRealTime.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerRealTime_h
+#define hifi_AudioMixerRealTime_h
+
+#include <PortableHighResolutionClock.h>
+
+// Real-time scheduling for the audio mixer threads, where the platform and the permissions of the mixer allow it
+// (only Linux is supported, with CAP_SYS_NICE or an rtprio limit).
+
+// moves the calling thread to SCHED_FIFO at the given priority, or back to the default policy (priority 0)
+// returns false if it was not permitted
+bool setAudioMixerThreadPriority(int priority);
+
+// pins the calling thread to a core, or lets it run anywhere (core < 0), see ThreadPlacement.h for which cores
+// returns false if it was not permitted
+bool pinAudioMixerThread(int core);
+
+// sleeps until the deadline, which is an absolute time on the monotonic clock where possible,
+// so that a late wakeup is not carried into the next frame
+void sleepUntilAudioMixerDeadline(p_high_resolution_clock::time_point deadline);
+
+#endif // hifi_AudioMixerRealTime_h
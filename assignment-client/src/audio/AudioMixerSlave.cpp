@@ -10,6 +10,7 @@
 //
 
 #include <algorithm>
+#include <unordered_set>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/norm.hpp>
@@ -33,14 +34,26 @@
 #include "AvatarAudioStream.h"
 #include "InjectedAudioStream.h"
 #include "AudioHelpers.h"
+#include "AudioHRTFPremixCache.h"
+#include "../NodeSpatialGrid.h"
 
 #include "AudioMixerSlave.h"
 
 using AudioStreamMap = AudioMixerClientData::AudioStreamMap;
 
+static const int HRTF_DATASET_INDEX = 1;
+
+// the sum of the distant streams is kept below full scale by this much in the 16 bit bed that is decoded
+static const float AMBISONIC_BED_HEADROOM = 4.0f;
+
+// a second of silence, four times the release time of the limiter
+static const int LIMITER_IDLE_FRAMES = (int)AudioConstants::NETWORK_FRAMES_PER_SEC;
+
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
 void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
+void sendForwardedMixPacket(const SharedNodePointer& node, AudioMixerClientData& data,
+        const std::vector<ForwardedAudioStream>& streams, QByteArray& buffer);
 void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
 void sendMutePacket(const SharedNodePointer& node, AudioMixerClientData&);
 void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
@@ -56,15 +69,18 @@ inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const
 void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
     if (data) {
-        data->processPackets();
+        data->processPackets(node);
     }
 }
 
-void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        AudioHRTFPremixCache* premixCache, const NodeSpatialGrid* ignoreRadiusGrid) {
     _begin = begin;
     _end = end;
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _premixCache = premixCache;
+    _ignoreRadiusGrid = ignoreRadiusGrid;
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -78,6 +94,9 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
         return;
     }
 
+    // track the cost of this mix, as a scheduling hint for the next frame
+    auto mixCostStart = p_high_resolution_clock::now();
+
     // check that the stream is valid
     auto avatarStream = data->getAvatarAudioStream();
     if (avatarStream == nullptr) {
@@ -97,7 +116,9 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
         bool mixHasAudio = prepareMix(node);
 
         // send audio packet
-        if (mixHasAudio || data->shouldFlushEncoder()) {
+        // (forwarded streams are carried with a mix, even when it is silent)
+        bool hasForwardedStreams = !_forwardedStreams.empty();
+        if (mixHasAudio || hasForwardedStreams || data->shouldFlushEncoder()) {
             QByteArray encodedBuffer;
             if (mixHasAudio) {
                 // encode the audio
@@ -108,7 +129,11 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
                 data->encodeFrameOfZeros(encodedBuffer);
             }
 
-            sendMixPacket(node, *data, encodedBuffer);
+            if (hasForwardedStreams) {
+                sendForwardedMixPacket(node, *data, _forwardedStreams, encodedBuffer);
+            } else {
+                sendMixPacket(node, *data, encodedBuffer);
+            }
         } else {
             ++stats.sumListenersSilent;
             sendSilentPacket(node, *data);
@@ -123,6 +148,9 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
             data->sendAudioStreamStatsPackets(node);
         }
     }
+
+    data->setMixCost(std::chrono::duration_cast<std::chrono::microseconds>(
+        p_high_resolution_clock::now() - mixCostStart).count());
 }
 
 bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
@@ -131,6 +159,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     // zero out the mix for this listener
     memset(_mixSamples, 0, sizeof(_mixSamples));
+    _bedHasAudio = false;
 
     bool isThrottling = _throttlingRatio > 0.0f;
     std::vector<std::pair<float, SharedNodePointer>> throttledNodes;
@@ -145,6 +174,56 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     };
 
+    // the nodes close enough for an ignore radius to apply, looked up once rather than checked against each other
+    std::unordered_set<const Node*> ignoreRadiusNeighbors;
+    if (_ignoreRadiusGrid) {
+        const AABox& listenerZone = listenerData->getIgnoreZone(_frame);
+        _ignoreRadiusGrid->forEachTouching(listenerZone.calcCenter(), 0.5f * glm::length(listenerZone.getScale()),
+                [&](const SharedNodePointer& node) {
+            auto nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+            if (listenerZone.touches(nodeData->getIgnoreZone(_frame))) {
+                ignoreRadiusNeighbors.insert(node.data());
+            }
+        });
+    }
+
+    // the streams the listener spatializes itself are forwarded rather than mixed
+    bool isForwarding = AudioMixer::getNumForwardedStreams() > 0 && listenerData->acceptsForwardedStreams();
+    std::vector<SharedNodePointer> audibleNodes;
+    _forwardedStreams.clear();
+    _forwardedStreamSources.clear();
+
+    auto mixNode = [&](const SharedNodePointer& node, AudioMixerClientData* nodeData) {
+        if (!isThrottling) {
+            forAllStreams(node, nodeData, &AudioMixerSlave::mixStream);
+        } else {
+            auto nodeID = node->getUUID();
+
+            // compute the node's max relative volume
+            float nodeVolume;
+            for (auto& streamPair : nodeData->getAudioStreams()) {
+                auto nodeStream = streamPair.second;
+
+                // approximate the gain
+                glm::vec3 relativePosition = nodeStream->getPosition() - listenerAudioStream->getPosition();
+                float gain = approximateGain(*listenerAudioStream, *nodeStream, relativePosition);
+
+                // modify by hrtf gain adjustment
+                auto& hrtf = listenerData->hrtfForStream(nodeID, nodeStream->getStreamIdentifier());
+                gain *= hrtf.getGainAdjustment();
+
+                auto streamVolume = nodeStream->getLastPopOutputTrailingLoudness() * gain;
+                nodeVolume = std::max(streamVolume, nodeVolume);
+            }
+
+            // max-heapify the nodes by relative volume
+            throttledNodes.push_back(std::make_pair(nodeVolume, node));
+            if (!throttledNodes.empty()) {
+                std::push_heap(throttledNodes.begin(), throttledNodes.end());
+            }
+        }
+    };
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     auto mixStart = p_high_resolution_clock::now();
 #endif
@@ -163,38 +242,24 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                     mixStream(*listenerData, node->getUUID(), *listenerAudioStream, *nodeStream);
                 }
             }
-        } else if (!listenerData->shouldIgnore(listener, node, _frame)) {
-            if (!isThrottling) {
-                forAllStreams(node, nodeData, &AudioMixerSlave::mixStream);
+        } else if (!listenerData->shouldIgnore(listener, node, _frame,
+                                               _ignoreRadiusGrid ? &ignoreRadiusNeighbors : nullptr)) {
+            if (isForwarding) {
+                // the streams to forward are picked from all the audible ones before any is mixed
+                audibleNodes.push_back(node);
             } else {
-                auto nodeID = node->getUUID();
-
-                // compute the node's max relative volume
-                float nodeVolume;
-                for (auto& streamPair : nodeData->getAudioStreams()) {
-                    auto nodeStream = streamPair.second;
-
-                    // approximate the gain
-                    glm::vec3 relativePosition = nodeStream->getPosition() - listenerAudioStream->getPosition();
-                    float gain = approximateGain(*listenerAudioStream, *nodeStream, relativePosition);
-
-                    // modify by hrtf gain adjustment
-                    auto& hrtf = listenerData->hrtfForStream(nodeID, nodeStream->getStreamIdentifier());
-                    gain *= hrtf.getGainAdjustment();
-
-                    auto streamVolume = nodeStream->getLastPopOutputTrailingLoudness() * gain;
-                    nodeVolume = std::max(streamVolume, nodeVolume);
-                }
-
-                // max-heapify the nodes by relative volume
-                throttledNodes.push_back(std::make_pair(nodeVolume, node));
-                if (!throttledNodes.empty()) {
-                    std::push_heap(throttledNodes.begin(), throttledNodes.end());
-                }
+                mixNode(node, nodeData);
             }
         }
     });
 
+    if (isForwarding) {
+        pickForwardedStreams(*listenerData, *listenerAudioStream, audibleNodes);
+        for (const auto& node : audibleNodes) {
+            mixNode(node, static_cast<AudioMixerClientData*>(node->getLinkedData()));
+        }
+    }
+
     if (isThrottling) {
         // pop the loudest nodes off the heap and mix their streams
         int numToRetain = (int)(std::distance(_begin, _end) * (1 - _throttlingRatio));
@@ -226,6 +291,23 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     stats.mixTime += mixTime.count();
 #endif
 
+    // the bed is encoded in the listener's frame, so it is decoded without a rotation
+    // (once more after it goes quiet, to flush the tail of its filters)
+    if (_bedHasAudio || listenerData->hasAmbisonicBedTail) {
+        if (!_bedHasAudio) {
+            memset(_bedSamples, 0, sizeof(_bedSamples));
+        }
+        const float BED_SCALE = AudioConstants::MAX_SAMPLE_VALUE / AMBISONIC_BED_HEADROOM;
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC; ++i) {
+            float sample = glm::clamp(_bedSamples[i] * BED_SCALE,
+                (float)AudioConstants::MIN_SAMPLE_VALUE, (float)AudioConstants::MAX_SAMPLE_VALUE);
+            _bedBufferSamples[i] = (int16_t)sample;
+        }
+        listenerData->ambisonicBed.render(_bedBufferSamples, _mixSamples, HRTF_DATASET_INDEX, 1.0f, 0.0f, 0.0f, 0.0f,
+            AMBISONIC_BED_HEADROOM, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        listenerData->hasAmbisonicBedTail = _bedHasAudio;
+    }
+
     // check for silent audio before limiting
     // limiting uses a dither and can only guarantee abs(sample) <= 1
     bool hasAudio = false;
@@ -236,12 +318,100 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     }
 
-    // use the per listener AudioLimiter to render the mixed data
-    listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    // a silent mix isn't sent, so it only goes through the limiter until the limiter has released and its delay line
+    // is empty, after that it would be limiting silence to silence
+    if (hasAudio) {
+        listenerData->silentMixFrames = 0;
+    } else if (listenerData->silentMixFrames < LIMITER_IDLE_FRAMES) {
+        ++listenerData->silentMixFrames;
+    }
+
+    if (hasAudio || listenerData->silentMixFrames < LIMITER_IDLE_FRAMES) {
+        // use the per listener AudioLimiter to render the mixed data
+        listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        ++stats.idleLimiterMixes;
+    }
 
     return hasAudio;
 }
 
+void AudioMixerSlave::pickForwardedStreams(AudioMixerClientData& listenerData, const AvatarAudioStream& listenerStream,
+        const std::vector<SharedNodePointer>& audibleNodes) {
+    struct Candidate {
+        float volume;
+        QUuid nodeID;
+        const PositionalAudioStream* stream;
+    };
+    std::vector<Candidate> candidates;
+
+    // only mono streams the listener can decode as they were received are forwarded
+    QString codecName = listenerData.getCodecName();
+    for (const auto& node : audibleNodes) {
+        auto nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        auto nodeID = node->getUUID();
+        for (auto& streamPair : nodeData->getAudioStreams()) {
+            auto nodeStream = streamPair.second.get();
+            if (nodeStream->isStereo() || nodeStream == &listenerStream || !nodeStream->lastPopSucceeded() ||
+                nodeStream->getEncodedFrames().empty() || nodeStream->getSelectedCodecName() != codecName) {
+                continue;
+            }
+
+            glm::vec3 relativePosition = nodeStream->getPosition() - listenerStream.getPosition();
+            float gain = approximateGain(listenerStream, *nodeStream, relativePosition);
+            gain *= listenerData.hrtfForStream(nodeID, nodeStream->getStreamIdentifier()).getGainAdjustment();
+
+            float volume = nodeStream->getLastPopOutputTrailingLoudness() * gain;
+            if (volume > 0.0f) {
+                candidates.push_back({ volume, nodeID, nodeStream });
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.volume > b.volume;
+    });
+
+    // the forwarded streams share a packet with the mix, which takes at most a raw stereo frame
+    int budget = (int)NLPacket::maxPayloadSize(PacketType::ForwardedMixedAudio) - (int)sizeof(quint16) -
+        AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE - (int)sizeof(quint8) - AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+    int numForwarded = std::min((int)candidates.size(), AudioMixer::getNumForwardedStreams());
+
+    for (int i = 0; i < numForwarded; ++i) {
+        auto& candidate = candidates[i];
+        auto& stream = *candidate.stream;
+
+        glm::vec3 relativePosition = stream.getPosition() - listenerStream.getPosition();
+        auto& hrtf = listenerData.hrtfForStream(candidate.nodeID, stream.getStreamIdentifier());
+
+        ForwardedAudioStream forwardedStream;
+        forwardedStream.nodeID = candidate.nodeID;
+        forwardedStream.streamID = stream.getStreamIdentifier();
+        forwardedStream.azimuth = computeAzimuth(listenerStream, listenerStream, relativePosition);
+        forwardedStream.distance = glm::max(glm::length(relativePosition), EPSILON);
+        forwardedStream.gain = computeGain(listenerStream, stream, relativePosition, false) * hrtf.getGainAdjustment();
+        forwardedStream.frames = stream.getEncodedFrames();
+
+        int size = (int)ForwardedAudioStreams::getSizeOnWire(forwardedStream);
+        if (size > budget) {
+            // the quieter streams are mixed as usual
+            break;
+        }
+        budget -= size;
+
+        _forwardedStreams.push_back(std::move(forwardedStream));
+        _forwardedStreamSources.push_back(&stream);
+
+        ++stats.forwardedStreams;
+        ++stats.totalMixes;
+    }
+}
+
+bool AudioMixerSlave::isForwarded(const PositionalAudioStream& stream) const {
+    return std::find(_forwardedStreamSources.begin(), _forwardedStreamSources.end(), &stream) !=
+        _forwardedStreamSources.end();
+}
+
 void AudioMixerSlave::throttleStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd) {
     addStream(listenerNodeData, sourceNodeID, listeningNodeStream, streamToAdd, true);
@@ -255,6 +425,17 @@ void AudioMixerSlave::mixStream(AudioMixerClientData& listenerNodeData, const QU
 void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         bool throttle) {
+    if (isForwarded(streamToAdd)) {
+        // the listener spatializes it
+        return;
+    }
+
+    if (streamToAdd.isDormant()) {
+        // silent at ingest and already flushed from the filters, nothing to render until it wakes up
+        ++stats.dormantStreams;
+        return;
+    }
+
     ++stats.totalMixes;
 
     // to reduce artifacts we call the HRTF functor for every source, even if throttled or silent
@@ -268,7 +449,10 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     float distance = glm::max(glm::length(relativePosition), EPSILON);
     float gain = computeGain(listeningNodeStream, streamToAdd, relativePosition, isEcho);
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
-    const int HRTF_DATASET_INDEX = 1;
+
+    float ambisonicBedDistance = AudioMixer::getAmbisonicBedDistance();
+    bool isInAmbisonicBed = ambisonicBedDistance > 0.0f && distance > ambisonicBedDistance &&
+        !isEcho && !streamToAdd.isStereo();
 
     if (!streamToAdd.lastPopSucceeded()) {
         bool forceSilentBlock = true;
@@ -292,9 +476,12 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         if (forceSilentBlock) {
             // call renderSilent with a forced silent block to reduce artifacts
             // (this is not done for stereo streams since they do not go through the HRTF)
-            if (!streamToAdd.isStereo() && !isEcho) {
+            if (!streamToAdd.isStereo() && !isEcho && !isInAmbisonicBed) {
                 // get the existing listener-source HRTF object, or create a new one
                 auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+                if (streamToAdd.isWakingUp()) {
+                    hrtf.reset();
+                }
 
                 static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
                 hrtf.renderSilent(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
@@ -335,6 +522,23 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     // get the existing listener-source HRTF object, or create a new one
     auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
 
+    if (isInAmbisonicBed) {
+        // it isn't rendered while it is in the bed, so it starts over clean if it comes back within the bed distance
+        hrtf.reset();
+
+        // the bed keeps nothing of a stream from one frame to the next, so silent and throttled streams are left out
+        if (!throttle && streamToAdd.getLastPopOutputLoudness() != 0.0f) {
+            streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            addToAmbisonicBed(listeningNodeStream, relativePosition, gain * hrtf.getGainAdjustment());
+        }
+        return;
+    }
+
+    if (streamToAdd.isWakingUp()) {
+        // it was not rendered while dormant, so its filters and parameters are stale
+        hrtf.reset();
+    }
+
     streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
     if (streamToAdd.getLastPopOutputLoudness() == 0.0f) {
@@ -355,12 +559,57 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         return;
     }
 
+    if (_premixCache) {
+        // share the render with other listeners in the same bucket, applying this listener's gain
+        // (the per-listener hrtf is still kept for the silent and throttled paths, above)
+        float premixAzimuth = azimuth;
+        float premixDistance = distance;
+        int bucket = AudioHRTFPremixCache::quantize(premixAzimuth, premixDistance);
+        const float* premix = _premixCache->get(sourceNodeID, streamToAdd.getStreamIdentifier(), bucket, _frame,
+                                                _bufferSamples, HRTF_DATASET_INDEX, premixAzimuth, premixDistance);
+
+        float premixGain = gain * hrtf.getGainAdjustment();
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
+            _mixSamples[i] += premix[i] * premixGain;
+        }
+
+        ++stats.hrtfPremixes;
+        return;
+    }
+
     hrtf.render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
                 AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
     ++stats.hrtfRenders;
 }
 
+void AudioMixerSlave::addToAmbisonicBed(const AvatarAudioStream& listenerStream, const glm::vec3& relativePosition,
+        float gain) {
+    if (!_bedHasAudio) {
+        memset(_bedSamples, 0, sizeof(_bedSamples));
+        _bedHasAudio = true;
+    }
+
+    // the direction of the stream in the listener's frame, from Y-up (OpenGL) to Z-up (Ambisonic)
+    glm::vec3 direction = glm::normalize(glm::inverse(listenerStream.getOrientation()) * relativePosition);
+    float x = -direction.z;
+    float y = -direction.x;
+    float z = direction.y;
+
+    // a plane wave from that direction, in SN3D normalization
+    float scale = gain / AudioConstants::MAX_SAMPLE_VALUE;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+        float sample = _bufferSamples[i] * scale;
+        float* bedFrame = &_bedSamples[AudioConstants::AMBISONIC * i];
+        bedFrame[0] += sample;      // W
+        bedFrame[1] += sample * y;  // Y
+        bedFrame[2] += sample * z;  // Z
+        bedFrame[3] += sample * x;  // X
+    }
+
+    ++stats.ambisonicBedMixes;
+}
+
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec) {
     auto audioPacket = NLPacket::create(type, size);
     audioPacket->writePrimitive(sequence);
@@ -383,6 +632,21 @@ void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QB
     data.incrementOutgoingMixedAudioSequenceNumber();
 }
 
+void sendForwardedMixPacket(const SharedNodePointer& node, AudioMixerClientData& data,
+        const std::vector<ForwardedAudioStream>& streams, QByteArray& buffer) {
+    quint16 sequence = data.getOutgoingSequenceNumber();
+    QString codec = data.getCodecName();
+    auto mixPacket = createAudioPacket(PacketType::ForwardedMixedAudio, -1, sequence, codec);
+
+    // pack the forwarded streams, then the samples of the mix
+    ForwardedAudioStreams::write(*mixPacket, streams);
+    mixPacket->write(buffer.constData(), buffer.size());
+
+    // send packet
+    DependencyManager::get<NodeList>()->sendPacket(std::move(mixPacket), *node);
+    data.incrementOutgoingMixedAudioSequenceNumber();
+}
+
 void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data) {
     const int SILENT_PACKET_SIZE =
         sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE + sizeof(quint16);
@@ -19,12 +19,16 @@
 #include <UUIDHasher.h>
 #include <NodeList.h>
 
+#include <ForwardedAudioStreams.h>
+
 #include "AudioMixerStats.h"
 
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioHRTF;
 class AudioMixerClientData;
+class AudioHRTFPremixCache;
+class NodeSpatialGrid;
 
 class AudioMixerSlave {
 public:
@@ -34,7 +38,10 @@ public:
     void processPackets(const SharedNodePointer& node);
 
     // configure a round of mixing
-    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    // if premixCache is set, HRTF renders are shared between listeners through it
+    // if ignoreRadiusGrid is set, the nodes within a listener's ignore radius are looked up in it
+    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            AudioHRTFPremixCache* premixCache = nullptr, const NodeSpatialGrid* ignoreRadiusGrid = nullptr);
 
     // mix and broadcast non-ignored streams to the node (requires configuration using configureMix, above)
     // returns true if a mixed packet was sent to the node
@@ -53,15 +60,34 @@ private:
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer,
             bool throttle);
 
+    // pick the loudest streams of the audible nodes to forward to the listener instead of mixing them
+    void pickForwardedStreams(AudioMixerClientData& listenerData, const AvatarAudioStream& listenerStream,
+            const std::vector<SharedNodePointer>& audibleNodes);
+    bool isForwarded(const PositionalAudioStream& stream) const;
+
+    // encode a stream, from the listener's point of view, into the ambisonic bed of the current mix
+    void addToAmbisonicBed(const AvatarAudioStream& listenerStream, const glm::vec3& relativePosition, float gain);
+
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // ambisonic bed of the current mix, interleaved ambiX (W, Y, Z, X)
+    float _bedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+    int16_t _bedBufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+    bool _bedHasAudio { false };
+
+    // forwarding state, for the current listener
+    std::vector<ForwardedAudioStream> _forwardedStreams;
+    std::vector<const PositionalAudioStream*> _forwardedStreamSources;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    AudioHRTFPremixCache* _premixCache { nullptr };
+    const NodeSpatialGrid* _ignoreRadiusGrid { nullptr };
 };
 
 #endif // hifi_AudioMixerSlave_h
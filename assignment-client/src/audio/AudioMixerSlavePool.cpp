@@ -11,12 +11,27 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <functional>
+#include <queue>
+
+#include <QtCore/QDebug>
+
+#include <shared/Metrics.h>
+
+#include "AudioMixerClientData.h"
+#include "AudioMixerRealTime.h"
+#include "../ThreadPlacement.h"
 
 #include "AudioMixerSlavePool.h"
 
 void AudioMixerSlaveThread::run() {
+    auto& runMetric = metrics::Registry::getInstance().histogram("audio_mixer_slave_run_usecs",
+        "Time a slave thread spends on its share of a mix or of the packets", metrics::timingBucketsUsecs(),
+        QString("slave=\"%1\"").arg(_index));
+
     while (true) {
         wait();
+        auto runStart = p_high_resolution_clock::now();
 
         // iterate over all available nodes
         SharedNodePointer node;
@@ -24,6 +39,9 @@ void AudioMixerSlaveThread::run() {
             (this->*_function)(node);
         }
 
+        runMetric.observe((double)std::chrono::duration_cast<std::chrono::microseconds>(
+            p_high_resolution_clock::now() - runStart).count());
+
         bool stopping = _stop;
         notify(stopping);
         if (stopping) {
@@ -33,6 +51,8 @@ void AudioMixerSlaveThread::run() {
 }
 
 void AudioMixerSlaveThread::wait() {
+    bool isRealTime;
+    int priority, core;
     {
         Lock lock(_pool._mutex);
         _pool._slaveCondition.wait(lock, [&] {
@@ -40,6 +60,20 @@ void AudioMixerSlaveThread::wait() {
             return _pool._numStarted != _pool._numThreads;
         });
         ++_pool._numStarted;
+
+        isRealTime = _pool._isRealTime;
+        priority = _pool._realTimePriority;
+        const auto& cores = _pool._realTimeCores;
+        core = cores.empty() ? -1 : cores[(1 + _index) % cores.size()];
+    }
+
+    if (isRealTime != _isRealTime) {
+        _isRealTime = isRealTime;
+        bool isScheduled = setAudioMixerThreadPriority(isRealTime ? priority : 0);
+        bool isPinned = pinAudioMixerThread(isRealTime ? core : -1);
+        if (isRealTime && !(isScheduled && isPinned)) {
+            qWarning() << "audio-mixer slave" << _index << "could not be" << (isScheduled ? "pinned" : "scheduled in real time");
+        }
     }
 
     if (_pool._configure) {
@@ -61,7 +95,19 @@ void AudioMixerSlaveThread::notify(bool stopping) {
 }
 
 bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
+    return _queue.try_pop(node) || try_steal(node);
+}
+
+bool AudioMixerSlaveThread::try_steal(SharedNodePointer& node) {
+    // start with the next slave over, so that thieves spread out across victims
+    const int numSlaves = (int)_pool._slaves.size();
+    for (int i = 1; i < numSlaves; ++i) {
+        auto& victim = _pool._slaves[(_index + i) % numSlaves];
+        if (victim->_queue.try_pop(node)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 #ifdef AUDIO_SINGLE_THREADED
@@ -71,16 +117,21 @@ static AudioMixerSlave slave;
 void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
     _function = &AudioMixerSlave::processPackets;
     _configure = [](AudioMixerSlave& slave) {};
+    _useCostHints = false;
     run(begin, end);
 }
 
-void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        AudioHRTFPremixCache* premixCache, const NodeSpatialGrid* ignoreRadiusGrid) {
     _function = &AudioMixerSlave::mix;
     _configure = [=](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, _frame, _throttlingRatio);
+        slave.configureMix(_begin, _end, _frame, _throttlingRatio, _premixCache, _ignoreRadiusGrid);
     };
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _premixCache = premixCache;
+    _ignoreRadiusGrid = ignoreRadiusGrid;
+    _useCostHints = true;
 
     run(begin, end);
 }
@@ -95,10 +146,8 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
         _function(slave, node);
     });
 #else
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.emplace(node);
-    });
+    // fill the queues
+    distribute(_begin, _end, _useCostHints);
 
     {
         Lock lock(_mutex);
@@ -116,8 +165,66 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
         assert(_numStarted == _numThreads);
     }
 
-    assert(_queue.empty());
+#ifndef NDEBUG
+    for (auto& slave : _slaves) {
+        assert(slave->_queue.empty());
+    }
 #endif
+#endif
+}
+
+void AudioMixerSlavePool::distribute(ConstIter begin, ConstIter end, bool useCostHints) {
+    const size_t numSlaves = _slaves.size();
+    if (numSlaves == 0) {
+        return;
+    }
+
+    if (!useCostHints) {
+        size_t i = 0;
+        std::for_each(begin, end, [&](const SharedNodePointer& node) {
+            _slaves[i++ % numSlaves]->_queue.emplace(node);
+        });
+        return;
+    }
+
+    // nodes without a history (or negligible cost) still count, so they spread across slaves
+    static const uint64_t MIN_MIX_COST_USECS = 1;
+
+    using CostedNode = std::pair<uint64_t, SharedNodePointer>;
+    std::vector<CostedNode> nodes;
+    nodes.reserve(std::distance(begin, end));
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        auto data = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        uint64_t cost = data ? std::max(data->getMixCost(), MIN_MIX_COST_USECS) : MIN_MIX_COST_USECS;
+        nodes.emplace_back(cost, node);
+    });
+
+    // longest-processing-time first: assign the costliest remaining node to the least loaded slave,
+    // so a single expensive listener starts early instead of holding up the end of the frame
+    std::sort(nodes.begin(), nodes.end(), [](const CostedNode& a, const CostedNode& b) {
+        return a.first > b.first;
+    });
+
+    using Load = std::pair<uint64_t, size_t>;
+    std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+    for (size_t i = 0; i < numSlaves; ++i) {
+        loads.emplace(0, i);
+    }
+
+    for (auto& node : nodes) {
+        auto load = loads.top();
+        loads.pop();
+        _slaves[load.second]->_queue.emplace(std::move(node.second));
+        load.first += node.first;
+        loads.push(load);
+    }
+}
+
+void AudioMixerSlavePool::setRealTime(bool isRealTime, int priority, int firstCore) {
+    Lock lock(_mutex);
+    _isRealTime = isRealTime;
+    _realTimePriority = priority;
+    _realTimeCores = getThreadPlacementCores(firstCore);
 }
 
 void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> functor) {
@@ -162,8 +269,8 @@ void AudioMixerSlavePool::resize(int numThreads) {
 
     if (numThreads > _numThreads) {
         // start new slaves
-        for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this);
+        for (int i = _numThreads; i < numThreads; ++i) {
+            auto slave = new AudioMixerSlaveThread(*this, i);
             slave->start();
             _slaves.emplace_back(slave);
         }
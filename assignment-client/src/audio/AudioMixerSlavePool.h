@@ -31,7 +31,9 @@ class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool) : _pool(pool) {}
+    using Queue = tbb::concurrent_queue<SharedNodePointer>;
+
+    AudioMixerSlaveThread(AudioMixerSlavePool& pool, int index) : _pool(pool), _index(index) {}
 
     void run() override final;
 
@@ -40,17 +42,26 @@ private:
 
     void wait();
     void notify(bool stopping);
+    // pops from this slave's own queue, then steals from the other slaves' queues
     bool try_pop(SharedNodePointer& node);
+    bool try_steal(SharedNodePointer& node);
 
     AudioMixerSlavePool& _pool;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
     bool _stop { false };
+    bool _isRealTime { false };
+
+    // work queue for this slave, filled by the pool before each run
+    Queue _queue;
+    int _index { 0 };
 };
 
 // Slave pool for audio mixers
 //   AudioMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
+//
+//   Nodes are distributed across per-slave queues before each run; a slave that drains its own queue
+//   steals from the others. Mixes are balanced using the previous frame's per-listener mix time as a cost hint.
 class AudioMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using ConditionVariable = std::condition_variable;
@@ -65,7 +76,10 @@ public:
     void processPackets(ConstIter begin, ConstIter end);
 
     // mix on slave threads
-    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    // if premixCache is set, HRTF renders are shared between listeners through it
+    // if ignoreRadiusGrid is set, the nodes within a listener's ignore radius are looked up in it
+    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            AudioHRTFPremixCache* premixCache = nullptr, const NodeSpatialGrid* ignoreRadiusGrid = nullptr);
 
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
@@ -73,15 +87,25 @@ public:
     void setNumThreads(int numThreads);
     int numThreads() { return _numThreads; }
 
+    // run the slaves at the given SCHED_FIFO priority, each pinned to a core after firstCore, those on the NUMA node of
+    // firstCore first (see AudioMixerRealTime.h and ThreadPlacement.h)
+    // slaves switch over at the start of their next run
+    void setRealTime(bool isRealTime, int priority = 0, int firstCore = 0);
+    bool isRealTime() { return _isRealTime; }
+
 private:
     void run(ConstIter begin, ConstIter end);
     void resize(int numThreads);
 
+    // fill the slave queues, balancing by cost hint if useCostHints is set (round-robin otherwise)
+    void distribute(ConstIter begin, ConstIter end, bool useCostHints);
+
     std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
 
     friend void AudioMixerSlaveThread::wait();
     friend void AudioMixerSlaveThread::notify(bool stopping);
     friend bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node);
+    friend bool AudioMixerSlaveThread::try_steal(SharedNodePointer& node);
 
     // synchronization state
     Mutex _mutex;
@@ -94,10 +118,17 @@ private:
     int _numFinished { 0 }; // guarded by _mutex
     int _numStopped { 0 }; // guarded by _mutex
 
+    // scheduling state, read by the slaves under _mutex
+    bool _isRealTime { false };
+    int _realTimePriority { 0 };
+    std::vector<int> _realTimeCores; // the first is the mixer's, the slaves take the ones after it
+
     // frame state
-    Queue _queue;
+    bool _useCostHints { false };
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    AudioHRTFPremixCache* _premixCache { nullptr };
+    const NodeSpatialGrid* _ignoreRadiusGrid { nullptr };
     ConstIter _begin;
     ConstIter _end;
 };
@@ -11,6 +11,8 @@
 
 #include "AudioMixerStats.h"
 
+#include <algorithm>
+
 void AudioMixerStats::reset() {
     sumStreams = 0;
     sumListeners = 0;
@@ -19,8 +21,17 @@ void AudioMixerStats::reset() {
     hrtfRenders = 0;
     hrtfSilentRenders = 0;
     hrtfThrottleRenders = 0;
+    hrtfPremixes = 0;
+    ambisonicBedMixes = 0;
+    idleLimiterMixes = 0;
     manualStereoMixes = 0;
     manualEchoMixes = 0;
+    forwardedStreams = 0;
+    dormantStreams = 0;
+    for (int i = 0; i < NUM_DEADLINE_SLACK_BUCKETS; ++i) {
+        deadlineSlack[i] = 0;
+    }
+    maxOverrunUsecs = 0;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime = 0;
 #endif
@@ -34,9 +45,33 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     hrtfRenders += otherStats.hrtfRenders;
     hrtfSilentRenders += otherStats.hrtfSilentRenders;
     hrtfThrottleRenders += otherStats.hrtfThrottleRenders;
+    hrtfPremixes += otherStats.hrtfPremixes;
+    ambisonicBedMixes += otherStats.ambisonicBedMixes;
+    idleLimiterMixes += otherStats.idleLimiterMixes;
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
+    forwardedStreams += otherStats.forwardedStreams;
+    dormantStreams += otherStats.dormantStreams;
+    for (int i = 0; i < NUM_DEADLINE_SLACK_BUCKETS; ++i) {
+        deadlineSlack[i] += otherStats.deadlineSlack[i];
+    }
+    maxOverrunUsecs = std::max(maxOverrunUsecs, otherStats.maxOverrunUsecs);
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime += otherStats.mixTime;
 #endif
 }
+
+void AudioMixerStats::addDeadlineSlack(std::chrono::microseconds slack) {
+    static const int SLACK_BUCKET_USECS[NUM_DEADLINE_SLACK_BUCKETS - 1] = { 0, 1000, 2500, 5000 };
+
+    int usecs = (int)slack.count();
+    if (usecs < 0) {
+        maxOverrunUsecs = std::max(maxOverrunUsecs, -usecs);
+    }
+
+    int bucket = 0;
+    while (bucket < NUM_DEADLINE_SLACK_BUCKETS - 1 && usecs >= SLACK_BUCKET_USECS[bucket]) {
+        ++bucket;
+    }
+    ++deadlineSlack[bucket];
+}
@@ -16,6 +16,8 @@
 #include <cstdint>
 #endif
 
+#include <chrono>
+
 struct AudioMixerStats {
     int sumStreams { 0 };
     int sumListeners { 0 };
@@ -26,16 +28,31 @@ struct AudioMixerStats {
     int hrtfRenders { 0 };
     int hrtfSilentRenders { 0 };
     int hrtfThrottleRenders { 0 };
+    int hrtfPremixes { 0 };
+    int ambisonicBedMixes { 0 };
+    int idleLimiterMixes { 0 };
 
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    int forwardedStreams { 0 };
+    int dormantStreams { 0 };
+
+    // frames by the time that was left before their deadline, see AudioMixer::timeFrame
+    // (overrun, under 1ms, under 2.5ms, under 5ms, 5ms or more)
+    static const int NUM_DEADLINE_SLACK_BUCKETS = 5;
+    int deadlineSlack[NUM_DEADLINE_SLACK_BUCKETS] {};
+    int maxOverrunUsecs { 0 };
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     uint64_t mixTime { 0 };
 #endif
 
     void reset();
     void accumulate(const AudioMixerStats& otherStats);
+
+    // slack is negative for a frame that overran its deadline
+    void addDeadlineSlack(std::chrono::microseconds slack);
 };
 
 #endif // hifi_AudioMixerStats_h
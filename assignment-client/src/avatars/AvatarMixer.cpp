@@ -28,6 +28,7 @@
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
+#include <shared/Metrics.h>
 #include <UUID.h>
 #include <TryLocker.h>
 
@@ -38,6 +39,9 @@ const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 // FIXME - what we'd actually like to do is send to users at ~50% of their present rate down to 30hz. Assume 90 for now.
 const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 45;
 
+// without a cull range, the avatar grid is only used to find the avatars within each other's ignore radius
+const float IGNORE_RADIUS_GRID_CELL_SIZE = 10.0f; // meters
+
 AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     ThreadedAssignment(message)
 {
@@ -45,7 +49,7 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::AvatarData, this, "queueIncomingPacket");
+    packetReceiver.registerDirectListener(PacketType::AvatarData, this, "queueIncomingPacketDirect");
     packetReceiver.registerListener(PacketType::AdjustAvatarSorting, this, "handleAdjustAvatarSorting");
     packetReceiver.registerListener(PacketType::ViewFrustum, this, "handleViewFrustumPacket");
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "handleAvatarIdentityPacket");
@@ -62,6 +66,13 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     packetReceiver.registerListener(PacketType::ReplicatedBulkAvatarData, this, "handleReplicatedBulkAvatarPacket");
 
     auto nodeList = DependencyManager::get<NodeList>();
+
+    // send parity with the avatar data to nodes that are losing theirs
+    nodeList->setFECEnabled(PacketType::BulkAvatarData, true);
+
+    // the kills for every avatar that left go to each node together
+    nodeList->setCoalescingEnabled(PacketType::KillAvatar, true);
+
     connect(nodeList.data(), &NodeList::packetVersionMismatch, this, &AvatarMixer::handlePacketVersionMismatch);
     connect(nodeList.data(), &NodeList::nodeAdded, this, [this](const SharedNodePointer& node) {
         if (node->getType() == NodeType::DownstreamAvatarMixer) {
@@ -131,7 +142,7 @@ void AvatarMixer::handleReplicatedBulkAvatarPacket(QSharedPointer<ReceivedMessag
 
         // queue up the replicated avatar data with the client data for the replicated node
         auto start = usecTimestampNow();
-        getOrCreateClientData(replicatedNode)->queuePacket(replicatedMessage, replicatedNode);
+        getOrCreateClientData(replicatedNode)->queuePacket(replicatedMessage);
         auto end = usecTimestampNow();
         _queueIncomingPacketElapsedTime += (end - start);
     }
@@ -174,15 +185,26 @@ void AvatarMixer::optionallyReplicatePacket(ReceivedMessage& message, const Node
 
 void AvatarMixer::queueIncomingPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
     auto start = usecTimestampNow();
-    getOrCreateClientData(node)->queuePacket(message, node);
+    getOrCreateClientData(node)->queuePacket(message);
     auto end = usecTimestampNow();
     _queueIncomingPacketElapsedTime += (end - start);
 }
 
+void AvatarMixer::queueIncomingPacketDirect(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    // this is called on the network thread, the client data is created on the main thread when it is first needed
+    auto clientData = dynamic_cast<AvatarMixerClientData*>(node->getLinkedData());
+    if (!clientData) {
+        QMetaObject::invokeMethod(this, "queueIncomingPacket", Qt::QueuedConnection,
+                                  Q_ARG(QSharedPointer<ReceivedMessage>, message),
+                                  Q_ARG(SharedNodePointer, node));
+        return;
+    }
+    clientData->queuePacket(message);
+}
+
 void AvatarMixer::sendIdentityPacket(AvatarMixerClientData* nodeData, const SharedNodePointer& destinationNode) {
     if (destinationNode->getType() == NodeType::Agent && !destinationNode->isUpstream()) {
-        QByteArray individualData = nodeData->getAvatar().identityByteArray();
-        individualData.replace(0, NUM_BYTES_RFC4122_UUID, nodeData->getNodeID().toRfc4122());
+        QByteArray individualData = nodeData->getIdentityPayload(false);
         auto identityPackets = NLPacketList::create(PacketType::AvatarIdentity, QByteArray(), true, true);
         identityPackets->write(individualData);
         DependencyManager::get<NodeList>()->sendPacketList(std::move(identityPackets), *destinationNode);
@@ -217,6 +239,9 @@ void AvatarMixer::start() {
     unsigned int frame = 1;
     auto frameTimestamp = p_high_resolution_clock::now();
 
+    auto& broadcastMetric = metrics::Registry::getInstance().histogram("avatar_mixer_broadcast_usecs",
+        "Time to send the avatar data of a frame to every listener", metrics::timingBucketsUsecs());
+
     while (!_isFinished) {
 
         auto frameDuration = timeFrame(frameTimestamp); // calculates last frame duration and sleeps remainder of target amount
@@ -260,12 +285,27 @@ void AvatarMixer::start() {
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 auto start = usecTimestampNow();
-                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
+                // index every avatar once, the slaves share it read-only for culling and ignore radius checks
+                float cellSize = _avatarCullRange > 0.0f ? _avatarCullRange : IGNORE_RADIUS_GRID_CELL_SIZE;
+                _avatarGrid.rebuild(cbegin, cend, cellSize, [](const SharedNodePointer& node, glm::vec3& position,
+                                                               float& radius) {
+                    if (node->getType() != NodeType::Agent || !node->getLinkedData()) {
+                        return false;
+                    }
+                    auto nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+                    position = nodeData->getPosition();
+                    radius = nodeData->getIgnoreRadiusBoxReach();
+                    return true;
+                });
+                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio,
+                                               &_avatarGrid, _avatarCullRange, frame, _jointDeltaCompression,
+                                               _maxKbpsPerDownstreamMixer);
                 auto end = usecTimestampNow();
                 _broadcastAvatarDataInner += (end - start);
             }, &lockWait, &nodeTransform, &functor);
             auto end = usecTimestampNow();
             _broadcastAvatarDataElapsedTime += (end - start);
+            broadcastMetric.observe((double)(end - start));
 
             _broadcastAvatarDataLockWait += lockWait;
             _broadcastAvatarDataNodeTransform += nodeTransform;
@@ -741,6 +781,12 @@ void AvatarMixer::sendStatsPacket() {
         float averageOverBudgetAvatars = averageNodes ? stats.overBudgetAvatars / averageNodes : 0.0f;
         slaveObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
 
+        float averageOthersCulled = averageNodes ? stats.othersCulled / averageNodes : 0.0f;
+        slaveObject["sent_8_averageOthersCulled"] = TIGHT_LOOP_STAT(averageOthersCulled);
+
+        float averageOthersRateLimited = averageNodes ? stats.othersRateLimited / averageNodes : 0.0f;
+        slaveObject["sent_9_averageOthersRateLimited"] = TIGHT_LOOP_STAT(averageOthersRateLimited);
+
         slaveObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(stats.processIncomingPacketsElapsedTime);
         slaveObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(stats.ignoreCalculationElapsedTime);
         slaveObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(stats.toByteArrayElapsedTime);
@@ -774,6 +820,12 @@ void AvatarMixer::sendStatsPacket() {
     float averageOverBudgetAvatars = averageNodes ? aggregateStats.overBudgetAvatars / averageNodes : 0.0f;
     slavesAggregatObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
 
+    float averageOthersCulled = averageNodes ? aggregateStats.othersCulled / averageNodes : 0.0f;
+    slavesAggregatObject["sent_8_averageOthersCulled"] = TIGHT_LOOP_STAT(averageOthersCulled);
+
+    float averageOthersRateLimited = averageNodes ? aggregateStats.othersRateLimited / averageNodes : 0.0f;
+    slavesAggregatObject["sent_9_averageOthersRateLimited"] = TIGHT_LOOP_STAT(averageOthersRateLimited);
+
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
     slavesAggregatObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.toByteArrayElapsedTime);
@@ -921,6 +973,22 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qCDebug(avatars) << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
 
+    const QString AVATAR_CULL_RANGE_KEY = "avatar_cull_range";
+    _avatarCullRange = glm::max((float)avatarMixerGroupObject[AVATAR_CULL_RANGE_KEY].toDouble(0.0), 0.0f);
+    if (_avatarCullRange > 0.0f) {
+        qCDebug(avatars) << "Avatars further than" << _avatarCullRange << "m from a listener will be sent about once a second.";
+    }
+
+    const QString JOINT_DELTA_COMPRESSION_KEY = "joint_delta_compression";
+    _jointDeltaCompression = avatarMixerGroupObject[JOINT_DELTA_COMPRESSION_KEY].toBool(false);
+    qCDebug(avatars) << "Joint delta compression is" << (_jointDeltaCompression ? "enabled." : "disabled.");
+
+    const QString DOWNSTREAM_SEND_BANDWIDTH_KEY = "max_downstream_send_bandwidth";
+    _maxKbpsPerDownstreamMixer = std::max((float)avatarMixerGroupObject[DOWNSTREAM_SEND_BANDWIDTH_KEY].toDouble(0.0), 0.0f) * KILO_PER_MEGA;
+    if (_maxKbpsPerDownstreamMixer > 0.0f) {
+        qCDebug(avatars) << "The maximum send bandwidth per downstream mixer is" << _maxKbpsPerDownstreamMixer << "kbps.";
+    }
+
     const QString AUTO_THREADS = "auto_threads";
     bool autoThreads = avatarMixerGroupObject[AUTO_THREADS].toBool();
     if (!autoThreads) {
@@ -937,6 +1005,20 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         qCDebug(avatars) << "Avatar mixer will automatically determine number of threads to use. Using:" << _slavePool.numThreads() << "threads.";
     }
 
+    const QString PIN_THREADS = "pin_threads";
+    const QString RESERVED_CORES = "reserved_cores";
+    const int DEFAULT_RESERVED_CORES = 1;
+    bool pinThreads = avatarMixerGroupObject[PIN_THREADS].toBool(false);
+    bool ok;
+    int reservedCores = avatarMixerGroupObject[RESERVED_CORES].toString().toInt(&ok);
+    if (!ok) {
+        reservedCores = DEFAULT_RESERVED_CORES;
+    }
+    _slavePool.setPinned(pinThreads, reservedCores);
+    if (pinThreads) {
+        qCDebug(avatars) << "Avatar mixer threads are pinned to cores, after the" << reservedCores << "kept for the mixer and its socket.";
+    }
+
     const QString AVATARS_SETTINGS_KEY = "avatars";
 
     static const QString MIN_SCALE_OPTION = "min_avatar_scale";
@@ -22,6 +22,7 @@
 #include "AvatarMixerClientData.h"
 
 #include "AvatarMixerSlavePool.h"
+#include "../NodeSpatialGrid.h"
 
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
@@ -45,6 +46,7 @@ public slots:
 
 private slots:
     void queueIncomingPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
+    void queueIncomingPacketDirect(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
     void handleAdjustAvatarSorting(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleViewFrustumPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
@@ -90,6 +92,12 @@ private:
 
     float _maxKbpsPerNode = 0.0f;
 
+    // avatars further than this from a listener are only sent about once a second (0 disables culling)
+    float _avatarCullRange { 0.0f };
+    NodeSpatialGrid _avatarGrid;
+    bool _jointDeltaCompression { false };
+    float _maxKbpsPerDownstreamMixer { 0.0f };
+
     float _domainMinimumScale { MIN_AVATAR_SCALE };
     float _domainMaximumScale { MAX_AVATAR_SCALE };
 
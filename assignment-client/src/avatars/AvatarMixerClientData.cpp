@@ -25,22 +25,17 @@ AvatarMixerClientData::AvatarMixerClientData(const QUuid& nodeID) :
     _avatar->setID(nodeID);
 }
 
-void AvatarMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
-    if (!_packetQueue.node) {
-        _packetQueue.node = node;
-    }
+void AvatarMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message) {
+    // if the mixer has fallen a full queue behind, the newest avatar data is dropped
     _packetQueue.push(message);
 }
 
 int AvatarMixerClientData::processPackets() {
     int packetsProcessed = 0;
-    SharedNodePointer node = _packetQueue.node;
-    assert(_packetQueue.empty() || node);
-    _packetQueue.node.clear();
-
-    while (!_packetQueue.empty()) {
-        auto& packet = _packetQueue.front();
 
+    // packets can keep arriving while these are processed, leave those for the next frame
+    QSharedPointer<ReceivedMessage> packet;
+    for (size_t i = 0; i < _packetQueue.capacity() && _packetQueue.pop(packet); ++i) {
         packetsProcessed++;
 
         switch (packet->getType()) {
@@ -50,9 +45,7 @@ int AvatarMixerClientData::processPackets() {
             default:
                 Q_UNREACHABLE();
         }
-        _packetQueue.pop();
     }
-    assert(_packetQueue.empty());
 
     return packetsProcessed;
 }
@@ -68,10 +61,22 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message) {
         incrementNumOutOfOrderSends();
     }
     _lastReceivedSequenceNumber = sequenceNumber;
+    _incomingSequenceNumberStats.sequenceNumberReceived(sequenceNumber);
 
     // compute the offset to the data payload
     return _avatar->parseDataFromBuffer(message.readWithoutCopy(message.getBytesLeftToRead()));
 }
+bool AvatarMixerClientData::sampleIncomingLossRate(quint64 now, float& lossRate) {
+    if (now - _lastLossRateSampleTime < USECS_PER_SECOND) {
+        return false;
+    }
+    _lastLossRateSampleTime = now;
+
+    _incomingSequenceNumberStats.pushStatsToHistory();
+    lossRate = _incomingSequenceNumberStats.getStatsForHistoryWindow().getLostRate();
+    return true;
+}
+
 uint64_t AvatarMixerClientData::getLastBroadcastTime(const QUuid& nodeUUID) const {
     // return the matching PacketSequenceNumber, or the default if we don't have it
     auto nodeMatch = _lastBroadcastTimes.find(nodeUUID);
@@ -81,6 +86,126 @@ uint64_t AvatarMixerClientData::getLastBroadcastTime(const QUuid& nodeUUID) cons
     return 0;
 }
 
+uint64_t AvatarMixerClientData::getLastReplicatedTime(const QUuid& nodeUUID) const {
+    auto nodeMatch = _lastReplicatedTimes.find(nodeUUID);
+    if (nodeMatch != _lastReplicatedTimes.end()) {
+        return nodeMatch->second;
+    }
+    return 0;
+}
+
+QByteArray AvatarMixerClientData::getReplicatedAvatarData(unsigned int frame, int maxSize) {
+    std::lock_guard<std::mutex> lock(_replicatedAvatarDataMutex);
+    if (_hasReplicatedAvatarData && _replicatedAvatarDataFrame == frame) {
+        return _replicatedAvatarData;
+    }
+
+    // we cannot send a downstream avatar mixer any updates that expect them to have previous state for this avatar
+    // since we have no idea if they're online and receiving our packets, so we always send a full update
+    AvatarDataPacket::HasFlags flagsOut;
+    QVector<JointData> emptyLastJointSendData { _avatar->getJointCount() };
+
+    QByteArray avatarByteArray = _avatar->toByteArray(AvatarData::SendAllData, 0, emptyLastJointSendData,
+                                                      flagsOut, false, false, glm::vec3(0), nullptr);
+    if (avatarByteArray.size() > maxSize) {
+        qWarning() << "Replicated avatar data too large for" << _avatar->getSessionUUID()
+            << "-" << avatarByteArray.size() << "bytes";
+
+        avatarByteArray = _avatar->toByteArray(AvatarData::SendAllData, 0, emptyLastJointSendData,
+                                               flagsOut, true, false, glm::vec3(0), nullptr);
+
+        if (avatarByteArray.size() > maxSize) {
+            qWarning() << "Replicated avatar data without facial data still too large for"
+                << _avatar->getSessionUUID() << "-" << avatarByteArray.size() << "bytes";
+
+            avatarByteArray = _avatar->toByteArray(AvatarData::MinimumData, 0, emptyLastJointSendData,
+                                                   flagsOut, true, false, glm::vec3(0), nullptr);
+        }
+    }
+    if (avatarByteArray.size() > maxSize) {
+        qWarning() << "Could not fit minimum data avatar for" << _avatar->getSessionUUID()
+            << "to packet list -" << avatarByteArray.size() << "bytes";
+        avatarByteArray.clear();
+    }
+
+    _replicatedAvatarData = avatarByteArray;
+    _replicatedAvatarDataFrame = frame;
+    _hasReplicatedAvatarData = true;
+    return _replicatedAvatarData;
+}
+
+QByteArray AvatarMixerClientData::getIdentityPayload(bool isReplicated) const {
+    std::lock_guard<std::mutex> lock(_identityPayloadMutex);
+    IdentityPayload& payload = _identityPayloads[isReplicated ? 1 : 0];
+
+    // the mixer pushes the sequence number without flagging a change when it replaces a forbidden avatar
+    auto sequenceNumber = _avatar->getIdentitySequenceNumber();
+    if (payload.isValid && payload.changeTimestamp == _identityChangeTimestamp && payload.sequenceNumber == sequenceNumber) {
+        return payload.bytes;
+    }
+
+    payload.bytes = _avatar->identityByteArray(isReplicated);
+    payload.bytes.replace(0, NUM_BYTES_RFC4122_UUID, getNodeID().toRfc4122()); // FIXME, this looks suspicious
+    payload.changeTimestamp = _identityChangeTimestamp;
+    payload.sequenceNumber = sequenceNumber;
+    payload.isValid = true;
+    return payload.bytes;
+}
+
+bool AvatarMixerClientData::canShareAvatarData(AvatarData::AvatarDataDetail detail) {
+    // the other details cull the joints against the ones the listener was last sent, from its position
+    return detail == AvatarData::NoData || detail == AvatarData::PALMinimum
+        || detail == AvatarData::MinimumData || detail == AvatarData::SendAllData;
+}
+
+QByteArray AvatarMixerClientData::getSharedAvatarData(unsigned int frame, AvatarData::AvatarDataDetail detail,
+                                                      quint64 lastSentTime, int maxSize,
+                                                      AvatarDataPacket::HasFlags& hasFlagsOut) const {
+    assert(canShareAvatarData(detail));
+
+    std::lock_guard<std::mutex> lock(_sharedAvatarDataMutex);
+    SharedAvatarData& shared = _sharedAvatarData[detail];
+    if (shared.isValid && shared.frame == frame) {
+        hasFlagsOut = shared.hasFlags;
+        return shared.bytes;
+    }
+
+    // none of these details encode the joints against the last sent ones, they only have to be the right size
+    AvatarDataPacket::HasFlags flagsOut = 0;
+    QVector<JointData> lastSentJointData { _avatar->getJointCount() };
+
+    QByteArray avatarByteArray = _avatar->toByteArray(detail, lastSentTime, lastSentJointData,
+                                                      flagsOut, false, false, glm::vec3(0), nullptr);
+    if (avatarByteArray.size() > maxSize) {
+        qWarning() << "Shared avatar data too large for" << _avatar->getSessionUUID()
+            << "-" << avatarByteArray.size() << "bytes ... attempt to drop facial data";
+
+        avatarByteArray = _avatar->toByteArray(detail, lastSentTime, lastSentJointData,
+                                               flagsOut, true, false, glm::vec3(0), nullptr);
+
+        if (avatarByteArray.size() > maxSize) {
+            qWarning() << "Shared avatar data without facial data still too large for" << _avatar->getSessionUUID()
+                << "-" << avatarByteArray.size() << "bytes ... reduce to MinimumData";
+
+            avatarByteArray = _avatar->toByteArray(AvatarData::MinimumData, lastSentTime, lastSentJointData,
+                                                   flagsOut, true, false, glm::vec3(0), nullptr);
+        }
+    }
+    if (avatarByteArray.size() > maxSize) {
+        qWarning() << "Could not fit minimum data avatar for" << _avatar->getSessionUUID()
+            << "to packet list -" << avatarByteArray.size() << "bytes";
+        avatarByteArray.clear();
+    }
+
+    shared.bytes = avatarByteArray;
+    shared.hasFlags = flagsOut;
+    shared.frame = frame;
+    shared.isValid = true;
+
+    hasFlagsOut = shared.hasFlags;
+    return shared.bytes;
+}
+
 uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const {
     // return the matching PacketSequenceNumber, or the default if we don't have it
     auto nodeMatch = _lastBroadcastSequenceNumbers.find(nodeUUID);
@@ -105,6 +230,27 @@ void AvatarMixerClientData::ignoreOther(SharedNodePointer self, SharedNodePointe
     }
 }
 
+AABox AvatarMixerClientData::getIgnoreRadiusBox() const {
+    // Define the minimum bubble size
+    static const glm::vec3 minBubbleSize = glm::vec3(0.3f, 1.3f, 0.3f);
+    // Define the scale of the box for the node
+    glm::vec3 boxScale = (getPosition() - getGlobalBoundingBoxCorner()) * 2.0f;
+    // Set up the bounding box for the node
+    AABox box(getGlobalBoundingBoxCorner(), boxScale);
+    // Clamp the size of the bounding box to a minimum scale
+    if (glm::any(glm::lessThan(boxScale, minBubbleSize))) {
+        box.setScaleStayCentered(minBubbleSize);
+    }
+    // Quadruple the scale of the bounding box
+    box.embiggen(4.0f);
+    return box;
+}
+
+float AvatarMixerClientData::getIgnoreRadiusBoxReach() const {
+    AABox box = getIgnoreRadiusBox();
+    return glm::distance(getPosition(), box.calcCenter()) + 0.5f * glm::length(box.getScale());
+}
+
 void AvatarMixerClientData::removeFromRadiusIgnoringSet(SharedNodePointer self, const QUuid& other) {
     if (isRadiusIgnoring(other)) {
         _radiusIgnoredOthers.erase(other);
@@ -119,6 +265,36 @@ bool AvatarMixerClientData::otherAvatarInView(const AABox& otherAvatarBox) {
     return _currentViewFrustum.boxIntersectsKeyhole(otherAvatarBox);
 }
 
+int AvatarMixerClientData::getOtherAvatarUpdateInterval(const glm::vec3& otherPosition,
+                                                        const AABox& otherAvatarBox) const {
+    static const float FULL_RATE_DISTANCE = 10.0f; // meters
+    static const float HALF_RATE_DISTANCE = 25.0f;
+    static const float QUARTER_RATE_DISTANCE = 50.0f;
+    static const float LOOKED_AT_COS_ANGLE = 0.985f; // within 10 degrees of the view direction
+
+    float distance = glm::distance(getPosition(), otherPosition);
+    if (distance <= FULL_RATE_DISTANCE) {
+        return 1;
+    }
+
+    if (!_currentViewFrustum.boxIntersectsKeyhole(otherAvatarBox)) {
+        return distance <= HALF_RATE_DISTANCE ? 4 : 10;
+    }
+
+    glm::vec3 toOther = otherPosition - _currentViewFrustum.getPosition();
+    float toOtherLength = glm::length(toOther);
+    bool isLookedAt = toOtherLength > 0.0f
+        && glm::dot(toOther / toOtherLength, _currentViewFrustum.getDirection()) >= LOOKED_AT_COS_ANGLE;
+    if (isLookedAt) {
+        return 1;
+    }
+
+    if (distance <= HALF_RATE_DISTANCE) {
+        return 2;
+    }
+    return distance <= QUARTER_RATE_DISTANCE ? 4 : 10;
+}
+
 void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["display_name"] = _avatar->getDisplayName();
     jsonObject["num_avs_sent_last_frame"] = _numAvatarsSentLastFrame;
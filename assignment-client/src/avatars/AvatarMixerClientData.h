@@ -13,10 +13,11 @@
 #define hifi_AvatarMixerClientData_h
 
 #include <algorithm>
+#include <array>
 #include <cfloat>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
-#include <queue>
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QUrl>
@@ -26,13 +27,17 @@
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <PortableHighResolutionClock.h>
+#include <SequenceNumberStats.h>
 #include <SimpleMovingAverage.h>
 #include <UUIDHasher.h>
 #include <ViewFrustum.h>
+#include <shared/MPSCRingBuffer.h>
 
 const QString OUTBOUND_AVATAR_DATA_STATS_KEY = "outbound_av_data_kbps";
 const QString INBOUND_AVATAR_DATA_STATS_KEY = "inbound_av_data_kbps";
 
+const int LOSS_RATE_HISTORY_LENGTH = 5; // seconds of avatar data the loss rate is measured over
+
 class AvatarMixerClientData : public NodeData {
     Q_OBJECT
 public:
@@ -54,13 +59,33 @@ public:
     void setLastBroadcastTime(const QUuid& nodeUUID, uint64_t broadcastTime) { _lastBroadcastTimes[nodeUUID] = broadcastTime; }
     Q_INVOKABLE void removeLastBroadcastTime(const QUuid& nodeUUID) { _lastBroadcastTimes.erase(nodeUUID); }
 
+    // for a downstream mixer, when the avatar of the node was last replicated to it
+    uint64_t getLastReplicatedTime(const QUuid& nodeUUID) const;
+    void setLastReplicatedTime(const QUuid& nodeUUID, uint64_t replicatedTime) { _lastReplicatedTimes[nodeUUID] = replicatedTime; }
+
     Q_INVOKABLE void cleanupKilledNode(const QUuid& nodeUUID) {
         removeLastBroadcastSequenceNumber(nodeUUID);
         removeLastBroadcastTime(nodeUUID);
+        _lastReplicatedTimes.erase(nodeUUID);
     }
 
+    // The full avatar data replicated to the downstream mixers, the same for all of them so it is encoded once a frame.
+    // Safe to call from the slaves of every downstream mixer, empty when even the minimum data doesn't fit in maxSize.
+    QByteArray getReplicatedAvatarData(unsigned int frame, int maxSize);
+
+    // The encodings of the avatar that don't depend on what a listener was sent before, encoded once a frame for each
+    // detail and shared by all the listeners: NoData, PALMinimum, SendAllData, and MinimumData when lastSentTime is the
+    // same for every listener in the frame. Safe to call from every slave, empty when even the minimum data doesn't fit.
+    static bool canShareAvatarData(AvatarData::AvatarDataDetail detail);
+    QByteArray getSharedAvatarData(unsigned int frame, AvatarData::AvatarDataDetail detail, quint64 lastSentTime,
+                                   int maxSize, AvatarDataPacket::HasFlags& hasFlagsOut) const;
+
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
 
+    // The identity packet payload for this avatar, with its node ID in front. It is serialized once for each change to
+    // the identity and shared by every listener it is sent to. Safe to call from every slave.
+    QByteArray getIdentityPayload(bool isReplicated) const;
+
     uint64_t getIdentityChangeTimestamp() const { return _identityChangeTimestamp; }
     void flagIdentityChange() { _identityChangeTimestamp = usecTimestampNow(); }
     bool getAvatarSessionDisplayNameMustChange() const { return _avatarSessionDisplayNameMustChange; }
@@ -93,6 +118,10 @@ public:
 
     glm::vec3 getPosition() const { return _avatar ? _avatar->getPosition() : glm::vec3(0); }
     glm::vec3 getGlobalBoundingBoxCorner() const { return _avatar ? _avatar->getGlobalBoundingBoxCorner() : glm::vec3(0); }
+    // the box around the avatar that another avatar's has to touch for the ignore radius of either to apply
+    AABox getIgnoreRadiusBox() const;
+    // the radius around the avatar's position that its ignore radius box is within
+    float getIgnoreRadiusBoxReach() const;
     bool isRadiusIgnoring(const QUuid& other) const { return _radiusIgnoredOthers.find(other) != _radiusIgnoredOthers.end(); }
     void addToRadiusIgnoringSet(const QUuid& other) { _radiusIgnoredOthers.insert(other); }
     void removeFromRadiusIgnoringSet(SharedNodePointer self, const QUuid& other);
@@ -102,6 +131,10 @@ public:
 
     bool otherAvatarInView(const AABox& otherAvatarBox);
 
+    // every how many broadcast frames another avatar is sent to this node: every frame when it is near or looked at,
+    // less often the further away it is, and less often again out of view
+    int getOtherAvatarUpdateInterval(const glm::vec3& otherPosition, const AABox& otherAvatarBox) const;
+
     void resetInViewStats() { _recentOtherAvatarsInView = _recentOtherAvatarsOutOfView = 0; }
     void incrementAvatarInView() { _recentOtherAvatarsInView++; }
     void incrementAvatarOutOfView() { _recentOtherAvatarsOutOfView++; }
@@ -126,27 +159,65 @@ public:
         return _lastOtherAvatarSentJoints[otherAvatar];
     }
 
-    void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
+    // the joint keyframe that delta encoded joint data for the other avatar is sent relative to
+    AvatarDataPacket::JointKeyframe& getLastOtherAvatarJointKeyframe(QUuid otherAvatar) {
+        return _lastOtherAvatarJointKeyframes[otherAvatar];
+    }
+
+    // the other avatars in priority order as of the last broadcast to this node, re-sorted incrementally each frame
+    std::vector<AvatarPriority>& getOtherAvatarPriorities() { return _otherAvatarPriorities; }
+
+    // safe to call from any thread, processPackets is only called from one mixer thread at a time
+    void queuePacket(QSharedPointer<ReceivedMessage> message);
     int processPackets(); // returns number of packets processed
 
+    // about once a second, returns true with the loss of this node's avatar data over the last few seconds
+    bool sampleIncomingLossRate(quint64 now, float& lossRate);
+
 private:
-    struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
-        QWeakPointer<Node> node;
-    };
-    PacketQueue _packetQueue;
+    MPSCRingBuffer<QSharedPointer<ReceivedMessage>> _packetQueue;
 
     AvatarSharedPointer _avatar { new AvatarData() };
 
     uint16_t _lastReceivedSequenceNumber { 0 };
+    SequenceNumberStats _incomingSequenceNumberStats { LOSS_RATE_HISTORY_LENGTH };
+    quint64 _lastLossRateSampleTime { 0 };
     std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
     std::unordered_map<QUuid, uint64_t> _lastBroadcastTimes;
+    std::unordered_map<QUuid, uint64_t> _lastReplicatedTimes;
+
+    std::mutex _replicatedAvatarDataMutex;
+    QByteArray _replicatedAvatarData;
+    unsigned int _replicatedAvatarDataFrame { 0 };
+    bool _hasReplicatedAvatarData { false };
+
+    struct SharedAvatarData {
+        QByteArray bytes;
+        AvatarDataPacket::HasFlags hasFlags { 0 };
+        unsigned int frame { 0 };
+        bool isValid { false };
+    };
+    mutable std::mutex _sharedAvatarDataMutex;
+    mutable std::array<SharedAvatarData, AvatarData::SendJointDeltaData + 1> _sharedAvatarData;
 
     // this is a map of the last time we encoded an "other" avatar for
     // sending to "this" node
     std::unordered_map<QUuid, quint64> _lastOtherAvatarEncodeTime;
     std::unordered_map<QUuid, QVector<JointData>> _lastOtherAvatarSentJoints;
+    std::unordered_map<QUuid, AvatarDataPacket::JointKeyframe> _lastOtherAvatarJointKeyframes;
+
+    std::vector<AvatarPriority> _otherAvatarPriorities;
 
     uint64_t _identityChangeTimestamp;
+
+    struct IdentityPayload {
+        QByteArray bytes;
+        uint64_t changeTimestamp { 0 };
+        udt::SequenceNumber sequenceNumber;
+        bool isValid { false };
+    };
+    mutable std::mutex _identityPayloadMutex;
+    mutable std::array<IdentityPayload, 2> _identityPayloads; // not replicated, replicated
     bool _avatarSessionDisplayNameMustChange{ true };
     bool _avatarSkeletonModelUrlMustChange{ false };
 
@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <random>
+#include <unordered_set>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/norm.hpp>
@@ -31,6 +32,7 @@
 #include "AvatarMixer.h"
 #include "AvatarMixerClientData.h"
 #include "AvatarMixerSlave.h"
+#include "../NodeSpatialGrid.h"
 
 
 void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
@@ -40,12 +42,21 @@ void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
 
 void AvatarMixerSlave::configureBroadcast(ConstIter begin, ConstIter end, 
                                 p_high_resolution_clock::time_point lastFrameTimestamp,
-                                float maxKbpsPerNode, float throttlingRatio) {
+                                float maxKbpsPerNode, float throttlingRatio,
+                                const NodeSpatialGrid* grid, float avatarCullRange, unsigned int frame,
+                                bool jointDeltaCompression, float maxKbpsPerDownstreamMixer,
+                                quint64 lastBroadcastStart) {
     _begin = begin;
     _end = end;
     _lastFrameTimestamp = lastFrameTimestamp;
     _maxKbpsPerNode = maxKbpsPerNode;
     _throttlingRatio = throttlingRatio;
+    _grid = grid;
+    _avatarCullRange = avatarCullRange;
+    _frame = frame;
+    _jointDeltaCompression = jointDeltaCompression;
+    _maxKbpsPerDownstreamMixer = maxKbpsPerDownstreamMixer;
+    _lastBroadcastStart = lastBroadcastStart;
 }
 
 void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
@@ -60,6 +71,12 @@ void AvatarMixerSlave::processIncomingPackets(const SharedNodePointer& node) {
     if (nodeData) {
         _stats.nodesProcessed++;
         _stats.packetsProcessed += nodeData->processPackets();
+
+        // the loss we can measure is the node's upstream, take it as an estimate of the downstream the avatar data has
+        float lossRate;
+        if (nodeData->sampleIncomingLossRate(start, lossRate)) {
+            DependencyManager::get<NodeList>()->setFECLossRate(*node, lossRate);
+        }
     }
     auto end = usecTimestampNow();
     _stats.processIncomingPacketsElapsedTime += (end - start);
@@ -67,8 +84,7 @@ void AvatarMixerSlave::processIncomingPackets(const SharedNodePointer& node) {
 
 int AvatarMixerSlave::sendIdentityPacket(const AvatarMixerClientData* nodeData, const SharedNodePointer& destinationNode) {
     if (destinationNode->getType() == NodeType::Agent && !destinationNode->isUpstream()) {
-        QByteArray individualData = nodeData->getConstAvatarData()->identityByteArray();
-        individualData.replace(0, NUM_BYTES_RFC4122_UUID, nodeData->getNodeID().toRfc4122()); // FIXME, this looks suspicious
+        QByteArray individualData = nodeData->getIdentityPayload(false);
         auto identityPackets = NLPacketList::create(PacketType::AvatarIdentity, QByteArray(), true, true);
         identityPackets->write(individualData);
         DependencyManager::get<NodeList>()->sendPacketList(std::move(identityPackets), *destinationNode);
@@ -81,8 +97,7 @@ int AvatarMixerSlave::sendIdentityPacket(const AvatarMixerClientData* nodeData,
 
 int AvatarMixerSlave::sendReplicatedIdentityPacket(const Node& agentNode, const AvatarMixerClientData* nodeData, const Node& destinationNode) {
     if (AvatarMixer::shouldReplicateTo(agentNode, destinationNode)) {
-        QByteArray individualData = nodeData->getConstAvatarData()->identityByteArray(true);
-        individualData.replace(0, NUM_BYTES_RFC4122_UUID, nodeData->getNodeID().toRfc4122()); // FIXME, this looks suspicious
+        QByteArray individualData = nodeData->getIdentityPayload(true);
         auto identityPacket = NLPacketList::create(PacketType::ReplicatedAvatarIdentity, QByteArray(), true, true);
         identityPacket->write(individualData);
         DependencyManager::get<NodeList>()->sendPacketList(std::move(identityPacket), destinationNode);
@@ -95,6 +110,17 @@ int AvatarMixerSlave::sendReplicatedIdentityPacket(const Node& agentNode, const
 
 static const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 45;
 
+// avatars outside of the cull range are still considered once every this many frames
+static const int OUT_OF_RANGE_AVATAR_REFRESH_FRAMES = AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND;
+
+// toByteArray() starts a new joint keyframe when it encodes one, if that keyframe then doesn't go out
+// the receiver would drop every delta against it, so start over with another keyframe on the next send
+static void forgetUnsentJointKeyframe(AvatarDataPacket::JointKeyframe& keyframe) {
+    if (keyframe.age == 0) {
+        keyframe.isValid = false;
+    }
+}
+
 void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
     quint64 start = usecTimestampNow();
 
@@ -169,26 +195,26 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
     // setup a PacketList for the avatarPackets
     auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
 
-    // Define the minimum bubble size
-    static const glm::vec3 minBubbleSize = glm::vec3(0.3f, 1.3f, 0.3f);
-    // Define the scale of the box for the current node
-    glm::vec3 nodeBoxScale = (nodeData->getPosition() - nodeData->getGlobalBoundingBoxCorner()) * 2.0f;
-    // Set up the bounding box for the current node
-    AABox nodeBox(nodeData->getGlobalBoundingBoxCorner(), nodeBoxScale);
-    // Clamp the size of the bounding box to a minimum scale
-    if (glm::any(glm::lessThan(nodeBoxScale, minBubbleSize))) {
-        nodeBox.setScaleStayCentered(minBubbleSize);
-    }
-    // Quadruple the scale of both bounding boxes
-    nodeBox.embiggen(4.0f);
+    AABox nodeBox = nodeData->getIgnoreRadiusBox();
 
+    // the avatars close enough for an ignore radius to apply, looked up once rather than checked against each other
+    std::unordered_set<const Node*> ignoreRadiusNeighbors;
+    if (_grid) {
+        _grid->forEachTouching(nodeData->getPosition(), nodeData->getIgnoreRadiusBoxReach(),
+                               [&](const SharedNodePointer& otherNode) {
+            auto otherNodeData = reinterpret_cast<const AvatarMixerClientData*>(otherNode->getLinkedData());
+            if (nodeBox.touches(otherNodeData->getIgnoreRadiusBox())) {
+                ignoreRadiusNeighbors.insert(otherNode.data());
+            }
+        });
+    }
 
     // setup list of AvatarData as well as maps to map betweeen the AvatarData and the original nodes
     // for calling the AvatarData::sortAvatars() function and getting our sorted list of client nodes
     QList<AvatarSharedPointer> avatarList;
     std::unordered_map<AvatarSharedPointer, SharedNodePointer> avatarDataToNodes;
 
-    std::for_each(_begin, _end, [&](const SharedNodePointer& otherNode) {
+    auto considerOtherNode = [&](const SharedNodePointer& otherNode) {
         // make sure this is an agent that we have avatar data for before considering it for inclusion
         if (otherNode->getType() == NodeType::Agent
             && otherNode->getLinkedData()) {
@@ -198,11 +224,31 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             avatarList << otherAvatar;
             avatarDataToNodes[otherAvatar] = otherNode;
         }
-    });
+    };
+
+    // With a cull range, the grid gives us the avatars in range of this node. Those further away are
+    // considered in round-robin slices, so they still get an update about once a second.
+    // The PAL lists every avatar, so while it is open we consider all of them.
+    if (_grid && _avatarCullRange > 0.0f && !PALIsOpen) {
+        glm::vec3 gridPosition = nodeData->getPosition();
+        float cullRangeSquared = _avatarCullRange * _avatarCullRange;
+
+        _grid->forEachInRange(gridPosition, _avatarCullRange, considerOtherNode);
+        _grid->forEachInSlice(_frame, OUT_OF_RANGE_AVATAR_REFRESH_FRAMES, [&](const SharedNodePointer& otherNode) {
+            auto otherNodeData = reinterpret_cast<const AvatarMixerClientData*>(otherNode->getLinkedData());
+            if (glm::distance2(otherNodeData->getPosition(), gridPosition) > cullRangeSquared) {
+                considerOtherNode(otherNode);
+            }
+        });
+
+        _stats.othersCulled += _grid->size() - avatarList.size();
+    } else {
+        std::for_each(_begin, _end, considerOtherNode);
+    }
 
     AvatarSharedPointer thisAvatar = nodeData->getAvatarSharedPointer();
     ViewFrustum cameraView = nodeData->getViewFrustom();
-    std::priority_queue<AvatarPriority> sortedAvatars;
+    std::vector<AvatarPriority>& sortedAvatars = nodeData->getOtherAvatarPriorities();
     AvatarData::sortAvatars(avatarList, cameraView, sortedAvatars,
                             [&](AvatarSharedPointer avatar)->uint64_t {
         auto avatarNode = avatarDataToNodes[avatar];
@@ -245,19 +291,10 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             // Don't bother with these checks if the other avatar has their bubble enabled and we're gettingAnyIgnored
             if (node->isIgnoreRadiusEnabled() || (avatarNode->isIgnoreRadiusEnabled() && !getsAnyIgnored)) {
 
-                // Define the scale of the box for the current other node
-                glm::vec3 otherNodeBoxScale = (avatarNodeData->getPosition() - avatarNodeData->getGlobalBoundingBoxCorner()) * 2.0f;
-                // Set up the bounding box for the current other node
-                AABox otherNodeBox(avatarNodeData->getGlobalBoundingBoxCorner(), otherNodeBoxScale);
-                // Clamp the size of the bounding box to a minimum scale
-                if (glm::any(glm::lessThan(otherNodeBoxScale, minBubbleSize))) {
-                    otherNodeBox.setScaleStayCentered(minBubbleSize);
-                }
-                // Quadruple the scale of both bounding boxes
-                otherNodeBox.embiggen(4.0f);
-
                 // Perform the collision check between the two bounding boxes
-                if (nodeBox.touches(otherNodeBox)) {
+                bool isWithinIgnoreRadius = _grid ? ignoreRadiusNeighbors.count(avatarNode.data()) > 0
+                    : nodeBox.touches(avatarNodeData->getIgnoreRadiusBox());
+                if (isWithinIgnoreRadius) {
                     nodeData->ignoreOther(node, avatarNode);
                     shouldIgnore = !getsAnyIgnored;
                 }
@@ -292,6 +329,18 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
                 ++numAvatarsWithSkippedFrames;
             }
         }
+
+        // far away avatars are only sent every few frames, each on frames of its own so that they don't all go together
+        // the first update of an avatar isn't held back, and the PAL gets all of them
+        if (!shouldIgnore && !PALIsOpen && nodeData->getLastBroadcastSequenceNumber(avatarNode->getUUID()) != 0) {
+            glm::vec3 otherNodeBoxCorner = avatarNodeData->getGlobalBoundingBoxCorner();
+            AABox otherNodeBox(otherNodeBoxCorner, (avatarNodeData->getPosition() - otherNodeBoxCorner) * 2.0f);
+            int updateInterval = nodeData->getOtherAvatarUpdateInterval(avatarNodeData->getPosition(), otherNodeBox);
+            if (updateInterval > 1 && (_frame + qHash(avatarNode->getUUID())) % updateInterval != 0) {
+                ++_stats.othersRateLimited;
+                shouldIgnore = true;
+            }
+        }
         return shouldIgnore;
     });
 
@@ -301,9 +350,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
     // this is overly conservative, because it includes some avatars we might not consider
     int remainingAvatars = (int)sortedAvatars.size();
 
-    while (!sortedAvatars.empty()) {
-        AvatarPriority sortData = sortedAvatars.top();
-        sortedAvatars.pop();
+    for (const auto& sortData : sortedAvatars) {
         const auto& avatarData = sortData.avatar;
         avatarRank++;
         remainingAvatars--;
@@ -353,36 +400,60 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             nodeData->incrementAvatarOutOfView();
         } else {
             detail = distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO
-            ? AvatarData::SendAllData : AvatarData::CullSmallData;
+            ? AvatarData::SendAllData : (_jointDeltaCompression ? AvatarData::SendJointDeltaData : AvatarData::CullSmallData);
             nodeData->incrementAvatarInView();
         }
 
         bool includeThisAvatar = true;
         auto lastEncodeForOther = nodeData->getLastOtherAvatarEncodeTime(otherNode->getUUID());
         QVector<JointData>& lastSentJointsForOther = nodeData->getLastOtherAvatarSentJoints(otherNode->getUUID());
+        AvatarDataPacket::JointKeyframe& jointKeyframeForOther = nodeData->getLastOtherAvatarJointKeyframe(otherNode->getUUID());
         bool distanceAdjust = true;
         glm::vec3 viewerPosition = myPosition;
         AvatarDataPacket::HasFlags hasFlagsOut; // the result of the toByteArray
         bool dropFaceTracking = false;
 
+        static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
+
+        // The avatars changed since the listeners were last sent them only while the packets were processed, in between
+        // the broadcasts, so the minimum data is the same for every listener that was sent this avatar last frame
+        bool shareEncoding = AvatarMixerClientData::canShareAvatarData(detail)
+            && (detail != AvatarData::MinimumData || lastEncodeForOther >= _lastBroadcastStart);
+        quint64 sharedLastSentTime = (detail == AvatarData::MinimumData) ? _lastBroadcastStart : 0;
+
         quint64 start = usecTimestampNow();
-        QByteArray bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                                                    hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+        QByteArray bytes;
+        if (shareEncoding) {
+            bytes = otherNodeData->getSharedAvatarData(_frame, detail, sharedLastSentTime,
+                                                       MAX_ALLOWED_AVATAR_DATA, hasFlagsOut);
+        } else {
+            bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
+                                             hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther,
+                                             nullptr, &jointKeyframeForOther);
+        }
         quint64 end = usecTimestampNow();
         _stats.toByteArrayElapsedTime += (end - start);
 
-        static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
-        if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
+        if (shareEncoding) {
+            // the shared encoding already fell back to less data when it had to
+            includeThisAvatar = !bytes.isEmpty();
+        } else if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
             qCWarning(avatars) << "otherAvatar.toByteArray() resulted in very large buffer:" << bytes.size() << "... attempt to drop facial data";
 
+            // a keyframe that is not sent must not be the reference for the next deltas
+            forgetUnsentJointKeyframe(jointKeyframeForOther);
+
             dropFaceTracking = true; // first try dropping the facial data
             bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                                             hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                                             hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther,
+                                                    nullptr, &jointKeyframeForOther);
 
             if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
                 qCWarning(avatars) << "otherAvatar.toByteArray() without facial data resulted in very large buffer:" << bytes.size() << "... reduce to MinimumData";
+                forgetUnsentJointKeyframe(jointKeyframeForOther);
                 bytes = otherAvatar->toByteArray(AvatarData::MinimumData, lastEncodeForOther, lastSentJointsForOther,
-                                                 hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                                                 hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther,
+                                                    nullptr, &jointKeyframeForOther);
 
                 if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
                     qCWarning(avatars) << "otherAvatar.toByteArray() MinimumData resulted in very large buffer:" << bytes.size() << "... FAIL!!";
@@ -391,6 +462,10 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             }
         }
 
+        if (!includeThisAvatar || !(hasFlagsOut & AvatarDataPacket::PACKET_HAS_JOINT_DELTA_DATA)) {
+            forgetUnsentJointKeyframe(jointKeyframeForOther);
+        }
+
         if (includeThisAvatar) {
             numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
             numAvatarDataBytes += avatarPacketList->write(bytes);
@@ -453,99 +528,85 @@ void AvatarMixerSlave::broadcastAvatarDataToDownstreamMixer(const SharedNodePoin
     // reset the number of sent avatars
     nodeData->resetNumAvatarsSentLastFrame();
 
+    // collect agents that we have avatar data for that we are supposed to replicate
+    std::vector<std::pair<uint64_t, SharedNodePointer>> replicatedAgents;
     std::for_each(_begin, _end, [&](const SharedNodePointer& agentNode) {
-        if (!AvatarMixer::shouldReplicateTo(*agentNode, *node)) {
-            return;
+        if (AvatarMixer::shouldReplicateTo(*agentNode, *node) &&
+            agentNode->getType() == NodeType::Agent && agentNode->getLinkedData() && agentNode->isReplicated()) {
+            replicatedAgents.emplace_back(nodeData->getLastReplicatedTime(agentNode->getUUID()), agentNode);
         }
-        
-        // collect agents that we have avatar data for that we are supposed to replicate
-        if (agentNode->getType() == NodeType::Agent && agentNode->getLinkedData() && agentNode->isReplicated()) {
-            const AvatarMixerClientData* agentNodeData = reinterpret_cast<const AvatarMixerClientData*>(agentNode->getLinkedData());
-
-            AvatarSharedPointer otherAvatar = agentNodeData->getAvatarSharedPointer();
-
-            quint64 startAvatarDataPacking = usecTimestampNow();
-
-            // we cannot send a downstream avatar mixer any updates that expect them to have previous state for this avatar
-            // since we have no idea if they're online and receiving our packets
-
-            // so we always send a full update for this avatar
-            
-            quint64 start = usecTimestampNow();
-            AvatarDataPacket::HasFlags flagsOut;
-
-            QVector<JointData> emptyLastJointSendData { otherAvatar->getJointCount() };
-
-            QByteArray avatarByteArray = otherAvatar->toByteArray(AvatarData::SendAllData, 0, emptyLastJointSendData,
-                                                                  flagsOut, false, false, glm::vec3(0), nullptr);
-            quint64 end = usecTimestampNow();
-            _stats.toByteArrayElapsedTime += (end - start);
-
-            auto lastBroadcastTime = nodeData->getLastBroadcastTime(agentNode->getUUID());
-            if (lastBroadcastTime <= agentNodeData->getIdentityChangeTimestamp()
-                || (start - lastBroadcastTime) >= REBROADCAST_IDENTITY_TO_DOWNSTREAM_EVERY_US) {
-                sendReplicatedIdentityPacket(*agentNode, agentNodeData, *node);
-                nodeData->setLastBroadcastTime(agentNode->getUUID(), start);
-            }
-
-            // figure out how large our avatar byte array can be to fit in the packet list
-            // given that we need it and the avatar UUID and the size of the byte array (16 bit)
-            // to fit in a segment of the packet list
-            auto maxAvatarByteArraySize = avatarPacketList->getMaxSegmentSize();
-            maxAvatarByteArraySize -= NUM_BYTES_RFC4122_UUID;
-            maxAvatarByteArraySize -= sizeof(quint16);
+    });
 
-            auto sequenceNumberSize = sizeof(agentNodeData->getLastReceivedSequenceNumber());
-            maxAvatarByteArraySize -= sequenceNumberSize;
+    // Over the budget of the link, the avatars replicated the longest time ago go first
+    int maxAvatarBytesPerFrame = 0;
+    if (_maxKbpsPerDownstreamMixer > 0.0f) {
+        maxAvatarBytesPerFrame = (int)((_maxKbpsPerDownstreamMixer * BYTES_PER_KILOBIT) / AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND);
+        std::sort(replicatedAgents.begin(), replicatedAgents.end(),
+            [](const std::pair<uint64_t, SharedNodePointer>& a, const std::pair<uint64_t, SharedNodePointer>& b) {
+                return a.first < b.first;
+            });
+    }
 
-            if (avatarByteArray.size() > maxAvatarByteArraySize) {
-                qCWarning(avatars) << "Replicated avatar data too large for" << otherAvatar->getSessionUUID()
-                    << "-" << avatarByteArray.size() << "bytes";
+    for (const auto& replicatedAgent : replicatedAgents) {
+        const SharedNodePointer& agentNode = replicatedAgent.second;
+        AvatarMixerClientData* agentNodeData = reinterpret_cast<AvatarMixerClientData*>(agentNode->getLinkedData());
 
-                avatarByteArray = otherAvatar->toByteArray(AvatarData::SendAllData, 0, emptyLastJointSendData,
-                                                           flagsOut, true, false, glm::vec3(0), nullptr);
+        quint64 startAvatarDataPacking = usecTimestampNow();
 
-                if (avatarByteArray.size() > maxAvatarByteArraySize) {
-                    qCWarning(avatars) << "Replicated avatar data without facial data still too large for"
-                        << otherAvatar->getSessionUUID() << "-" << avatarByteArray.size() << "bytes";
+        // figure out how large our avatar byte array can be to fit in the packet list
+        // given that we need it and the avatar UUID and the size of the byte array (16 bit)
+        // to fit in a segment of the packet list
+        auto sequenceNumberSize = sizeof(agentNodeData->getLastReceivedSequenceNumber());
+        int maxAvatarByteArraySize = avatarPacketList->getMaxSegmentSize();
+        maxAvatarByteArraySize -= NUM_BYTES_RFC4122_UUID;
+        maxAvatarByteArraySize -= sizeof(quint16);
+        maxAvatarByteArraySize -= sequenceNumberSize;
 
-                    avatarByteArray = otherAvatar->toByteArray(AvatarData::MinimumData, 0, emptyLastJointSendData,
-                                                               flagsOut, true, false, glm::vec3(0), nullptr);
-                }
-            }
+        // every downstream mixer gets the same data, the first slave to get to the avatar this frame encodes it
+        quint64 start = usecTimestampNow();
+        QByteArray avatarByteArray = agentNodeData->getReplicatedAvatarData(_frame, maxAvatarByteArraySize);
+        quint64 end = usecTimestampNow();
+        _stats.toByteArrayElapsedTime += (end - start);
 
-            if (avatarByteArray.size() <= maxAvatarByteArraySize) {
-                // increment the number of avatars sent to this reciever
-                nodeData->incrementNumAvatarsSentLastFrame();
+        if (avatarByteArray.isEmpty()) {
+            continue;
+        }
+        if (maxAvatarBytesPerFrame > 0 && numAvatarDataBytes > 0 &&
+            numAvatarDataBytes + avatarByteArray.size() > maxAvatarBytesPerFrame) {
+            _stats.overBudgetAvatars++;
+            continue;
+        }
 
-                // set the last sent sequence number for this sender on the receiver
-                nodeData->setLastBroadcastSequenceNumber(agentNode->getUUID(),
-                                                         agentNodeData->getLastReceivedSequenceNumber());
+        auto lastBroadcastTime = nodeData->getLastBroadcastTime(agentNode->getUUID());
+        if (lastBroadcastTime <= agentNodeData->getIdentityChangeTimestamp()
+            || (start - lastBroadcastTime) >= REBROADCAST_IDENTITY_TO_DOWNSTREAM_EVERY_US) {
+            sendReplicatedIdentityPacket(*agentNode, agentNodeData, *node);
+            nodeData->setLastBroadcastTime(agentNode->getUUID(), start);
+        }
 
-                // increment the number of avatars sent to this reciever
-                nodeData->incrementNumAvatarsSentLastFrame();
+        // increment the number of avatars sent to this reciever
+        nodeData->incrementNumAvatarsSentLastFrame();
 
-                // start a new segment in the packet list for this avatar
-                avatarPacketList->startSegment();
+        // set the last sent sequence number for this sender on the receiver
+        nodeData->setLastBroadcastSequenceNumber(agentNode->getUUID(),
+                                                 agentNodeData->getLastReceivedSequenceNumber());
+        nodeData->setLastReplicatedTime(agentNode->getUUID(), start);
 
-                // write the node's UUID, the size of the replicated avatar data,
-                // the sequence number of the replicated avatar data, and the replicated avatar data
-                numAvatarDataBytes += avatarPacketList->write(agentNode->getUUID().toRfc4122());
-                numAvatarDataBytes += avatarPacketList->writePrimitive((quint16) (avatarByteArray.size() + sequenceNumberSize));
-                numAvatarDataBytes += avatarPacketList->writePrimitive(agentNodeData->getLastReceivedSequenceNumber());
-                numAvatarDataBytes += avatarPacketList->write(avatarByteArray);
+        // start a new segment in the packet list for this avatar
+        avatarPacketList->startSegment();
 
-                avatarPacketList->endSegment();
+        // write the node's UUID, the size of the replicated avatar data,
+        // the sequence number of the replicated avatar data, and the replicated avatar data
+        numAvatarDataBytes += avatarPacketList->write(agentNode->getUUID().toRfc4122());
+        numAvatarDataBytes += avatarPacketList->writePrimitive((quint16) (avatarByteArray.size() + sequenceNumberSize));
+        numAvatarDataBytes += avatarPacketList->writePrimitive(agentNodeData->getLastReceivedSequenceNumber());
+        numAvatarDataBytes += avatarPacketList->write(avatarByteArray);
 
-            } else {
-                qCWarning(avatars) << "Could not fit minimum data avatar for" << otherAvatar->getSessionUUID()
-                    << "to packet list -" << avatarByteArray.size() << "bytes";
-            }
+        avatarPacketList->endSegment();
 
-            quint64 endAvatarDataPacking = usecTimestampNow();
-            _stats.avatarDataPackingElapsedTime += (endAvatarDataPacking - startAvatarDataPacking);
-        }
-    });
+        quint64 endAvatarDataPacking = usecTimestampNow();
+        _stats.avatarDataPackingElapsedTime += (endAvatarDataPacking - startAvatarDataPacking);
+    }
 
     if (avatarPacketList->getNumPackets() > 0) {
         quint64 startPacketSending = usecTimestampNow();
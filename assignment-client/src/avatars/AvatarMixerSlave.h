@@ -13,6 +13,7 @@
 #define hifi_AvatarMixerSlave_h
 
 class AvatarMixerClientData;
+class NodeSpatialGrid;
 
 class AvatarMixerSlaveStats {
 public:
@@ -27,6 +28,8 @@ public:
     int numIdentityPackets { 0 };
     int numOthersIncluded { 0 };
     int overBudgetAvatars { 0 };
+    int othersCulled { 0 };
+    int othersRateLimited { 0 };
 
     quint64 ignoreCalculationElapsedTime { 0 };
     quint64 avatarDataPackingElapsedTime { 0 };
@@ -48,6 +51,8 @@ public:
         numIdentityPackets = 0;
         numOthersIncluded = 0;
         overBudgetAvatars = 0;
+        othersCulled = 0;
+        othersRateLimited = 0;
 
         ignoreCalculationElapsedTime = 0;
         avatarDataPackingElapsedTime = 0;
@@ -68,6 +73,8 @@ public:
         numIdentityPackets += rhs.numIdentityPackets;
         numOthersIncluded += rhs.numOthersIncluded;
         overBudgetAvatars += rhs.overBudgetAvatars;
+        othersCulled += rhs.othersCulled;
+        othersRateLimited += rhs.othersRateLimited;
 
         ignoreCalculationElapsedTime += rhs.ignoreCalculationElapsedTime;
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
@@ -86,7 +93,10 @@ public:
     void configure(ConstIter begin, ConstIter end);
     void configureBroadcast(ConstIter begin, ConstIter end, 
                     p_high_resolution_clock::time_point lastFrameTimestamp, 
-                    float maxKbpsPerNode, float throttlingRatio);
+                    float maxKbpsPerNode, float throttlingRatio,
+                    const NodeSpatialGrid* grid = nullptr, float avatarCullRange = 0.0f, unsigned int frame = 0,
+                    bool jointDeltaCompression = false, float maxKbpsPerDownstreamMixer = 0.0f,
+                    quint64 lastBroadcastStart = 0);
 
     void processIncomingPackets(const SharedNodePointer& node);
     void broadcastAvatarData(const SharedNodePointer& node);
@@ -108,6 +118,13 @@ private:
     float _maxKbpsPerNode { 0.0f };
     float _throttlingRatio { 0.0f };
 
+    const NodeSpatialGrid* _grid { nullptr };
+    float _avatarCullRange { 0.0f };
+    unsigned int _frame { 0 };
+    bool _jointDeltaCompression { false };
+    float _maxKbpsPerDownstreamMixer { 0.0f }; // 0 for no budget
+    quint64 _lastBroadcastStart { 0 }; // when the broadcast of the previous frame started
+
     AvatarMixerSlaveStats _stats;
 };
 
@@ -12,7 +12,12 @@
 #include <assert.h>
 #include <algorithm>
 
+#include <QtCore/QDebug>
+
+#include <SharedUtil.h>
+
 #include "AvatarMixerSlavePool.h"
+#include "../ThreadPlacement.h"
 
 void AvatarMixerSlaveThread::run() {
     while (true) {
@@ -33,6 +38,7 @@ void AvatarMixerSlaveThread::run() {
 }
 
 void AvatarMixerSlaveThread::wait() {
+    int core;
     {
         Lock lock(_pool._mutex);
         _pool._slaveCondition.wait(lock, [&] {
@@ -40,6 +46,16 @@ void AvatarMixerSlaveThread::wait() {
             return _pool._numStarted != _pool._numThreads;
         });
         ++_pool._numStarted;
+
+        const auto& cores = _pool._pinnedCores;
+        core = cores.empty() ? -1 : cores[_index % cores.size()];
+    }
+
+    if (core != _pinnedCore) {
+        _pinnedCore = core;
+        if (!pinThreadToCore(core) && core >= 0) {
+            qWarning() << "avatar-mixer slave" << _index << "could not be pinned to core" << core;
+        }
     }
     if (_pool._configure) {
         _pool._configure(*this);
@@ -77,10 +93,17 @@ void AvatarMixerSlavePool::processIncomingPackets(ConstIter begin, ConstIter end
 
 void AvatarMixerSlavePool::broadcastAvatarData(ConstIter begin, ConstIter end, 
                                                p_high_resolution_clock::time_point lastFrameTimestamp,
-                                               float maxKbpsPerNode, float throttlingRatio) {
+                                               float maxKbpsPerNode, float throttlingRatio,
+                                               const NodeSpatialGrid* grid, float avatarCullRange, unsigned int frame,
+                                               bool jointDeltaCompression, float maxKbpsPerDownstreamMixer) {
+    quint64 lastBroadcastStart = _lastBroadcastStart;
+    _lastBroadcastStart = usecTimestampNow();
+
     _function = &AvatarMixerSlave::broadcastAvatarData;
     _configure = [=](AvatarMixerSlave& slave) { 
-        slave.configureBroadcast(begin, end, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio);
+        slave.configureBroadcast(begin, end, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio,
+                                 grid, avatarCullRange, frame, jointDeltaCompression, maxKbpsPerDownstreamMixer,
+                                 lastBroadcastStart);
    };
     run(begin, end);
 }
@@ -131,6 +154,19 @@ void AvatarMixerSlavePool::each(std::function<void(AvatarMixerSlave& slave)> fun
 #endif
 }
 
+void AvatarMixerSlavePool::setPinned(bool isPinned, int numReservedCores) {
+    std::vector<int> pinnedCores;
+    if (isPinned) {
+        // placed from core 0, where the main thread of the mixer and its socket's run unless something else pins them
+        auto cores = getThreadPlacementCores(0);
+        numReservedCores = std::min(std::max(numReservedCores, 0), (int)cores.size() - 1);
+        pinnedCores.assign(cores.begin() + numReservedCores, cores.end());
+    }
+
+    Lock lock(_mutex);
+    _pinnedCores.swap(pinnedCores);
+}
+
 void AvatarMixerSlavePool::setNumThreads(int numThreads) {
     // clamp to allowed size
     {
@@ -164,7 +200,7 @@ void AvatarMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AvatarMixerSlaveThread(*this);
+            auto slave = new AvatarMixerSlaveThread(*this, (int)_slaves.size());
             slave->start();
             _slaves.emplace_back(slave);
         }
@@ -32,7 +32,7 @@ class AvatarMixerSlaveThread : public QThread, public AvatarMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool) : _pool(pool) {}
+    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, int index) : _pool(pool), _index(index) {}
 
     void run() override final;
 
@@ -46,6 +46,8 @@ private:
     AvatarMixerSlavePool& _pool;
     void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
     bool _stop { false };
+    int _index { 0 };
+    int _pinnedCore { -1 };
 };
 
 // Slave pool for avatar mixers
@@ -65,7 +67,9 @@ public:
     // Jobs the slave pool can do...
     void processIncomingPackets(ConstIter begin, ConstIter end);
     void broadcastAvatarData(ConstIter begin, ConstIter end, 
-                    p_high_resolution_clock::time_point lastFrameTimestamp, float maxKbpsPerNode, float throttlingRatio);
+                    p_high_resolution_clock::time_point lastFrameTimestamp, float maxKbpsPerNode, float throttlingRatio,
+                    const NodeSpatialGrid* grid = nullptr, float avatarCullRange = 0.0f, unsigned int frame = 0,
+                    bool jointDeltaCompression = false, float maxKbpsPerDownstreamMixer = 0.0f);
 
     // iterate over all slaves
     void each(std::function<void(AvatarMixerSlave& slave)> functor);
@@ -73,6 +77,11 @@ public:
     void setNumThreads(int numThreads);
     int numThreads() { return _numThreads; }
 
+    // pin each slave to a core, after the given number of cores kept for the mixer and its socket (see ThreadPlacement.h)
+    // slaves switch over at the start of their next run
+    void setPinned(bool isPinned, int numReservedCores = 1);
+    bool isPinned() { return !_pinnedCores.empty(); }
+
 private:
     void run(ConstIter begin, ConstIter end);
     void resize(int numThreads);
@@ -94,10 +103,15 @@ private:
     int _numFinished { 0 }; // guarded by _mutex
     int _numStopped { 0 }; // guarded by _mutex
 
+    // placement state, read by the slaves under _mutex
+    std::vector<int> _pinnedCores; // a core for each slave in turn, none when not pinned
+
     // frame state
     Queue _queue;
     ConstIter _begin;
     ConstIter _end;
+
+    quint64 _lastBroadcastStart { 0 }; // handed to the slaves, which share the encodings since the last broadcast
 };
 
 #endif // hifi_AvatarMixerSlavePool_h
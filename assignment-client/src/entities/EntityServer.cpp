@@ -12,7 +12,17 @@
 #include <QtCore/QEventLoop>
 #include <QTimer>
 #include <EntityTree.h>
+#include <LightEntityItem.h>
+#include <LineEntityItem.h>
+#include <ModelEntityItem.h>
+#include <ParticleEffectEntityItem.h>
+#include <PolyLineEntityItem.h>
+#include <PolyVoxEntityItem.h>
+#include <ShapeEntityItem.h>
 #include <SimpleEntitySimulation.h>
+#include <TextEntityItem.h>
+#include <WebEntityItem.h>
+#include <ZoneEntityItem.h>
 #include <ResourceCache.h>
 #include <ScriptCache.h>
 #include <EntityEditFilters.h>
@@ -58,7 +68,7 @@ void EntityServer::aboutToFinish() {
 
 void EntityServer::handleEntityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     if (_octreeInboundPacketProcessor) {
-        _octreeInboundPacketProcessor->queueReceivedPacket(message, senderNode);
+        _octreeInboundPacketProcessor->queueEditPacket(message, senderNode);
     }
 }
 
@@ -106,14 +116,17 @@ bool EntityServer::hasSpecialPacketsToSend(const SharedNodePointer& node) {
     // check to see if any new entities have been added since we last sent to this node...
     EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
     if (nodeData) {
-        quint64 deletedEntitiesSentAt = nodeData->getLastDeletedEntitiesSentAt();
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
-        shouldSendDeletedEntities = tree->hasEntitiesDeletedSince(deletedEntitiesSentAt);
+        quint64 deletedEntitiesCursor = nodeData->getDeletedEntitiesCursor();
+        if (deletedEntitiesCursor == EntityNodeData::NO_DELETED_ENTITIES_CURSOR) {
+            nodeData->setDeletedEntitiesCursor(tree->getRecentlyDeletedEntitiesEnd());
+        } else {
+            shouldSendDeletedEntities = tree->hasEntitiesDeletedSince(deletedEntitiesCursor);
+        }
 
         #ifdef EXTRA_ERASE_DEBUGGING
             if (shouldSendDeletedEntities) {
-                int elapsed = usecTimestampNow() - deletedEntitiesSentAt;
-                qDebug() << "shouldSendDeletedEntities to node:" << node->getUUID() << "deletedEntitiesSentAt:" << deletedEntitiesSentAt << "elapsed:" << elapsed;
+                qDebug() << "shouldSendDeletedEntities to node:" << node->getUUID() << "deletedEntitiesCursor:" << deletedEntitiesCursor;
             }
         #endif
     }
@@ -131,12 +144,7 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
     EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
     if (nodeData) {
 
-        quint64 deletedEntitiesSentAt = nodeData->getLastDeletedEntitiesSentAt();
-        quint64 considerEntitiesSince = EntityTree::getAdjustedConsiderSince(deletedEntitiesSentAt);
-
-        quint64 deletePacketSentAt = usecTimestampNow();
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
-        auto recentlyDeleted = tree->getRecentlyDeletedEntityIDs();
 
         packetsSent = 0;
 
@@ -160,76 +168,58 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
         qint64 numberOfIDsPos = deletesPacket->pos();
         deletesPacket->writePrimitive(numberOfIDs);
 
-        // we keep a multi map of entity IDs to timestamps, we only want to include the entity IDs that have been
-        // deleted since we last sent to this node
-        auto it = recentlyDeleted.constBegin();
-        while (it != recentlyDeleted.constEnd()) {
-
-            // if the timestamp is more recent then out last sent time, include it
-            if (it.key() > considerEntitiesSince) {
-
-                // get all the IDs for this timestamp
-                const auto& entityIDsFromTime = recentlyDeleted.values(it.key());
-
-                for (const auto& entityID : entityIDsFromTime) {
-
-                    // check to make sure we have room for one more ID, if we don't have more
-                    // room, then send out this packet and create another one
-                    if (NUM_BYTES_RFC4122_UUID > deletesPacket->bytesAvailableForWrite()) {
-
-                        // replace the count for the number of included IDs
-                        deletesPacket->seek(numberOfIDsPos);
-                        deletesPacket->writePrimitive(numberOfIDs);
-
-                        // Send the current packet
-                        queryNode->packetSent(*deletesPacket);
-                        auto thisPacketSize = deletesPacket->getDataSize();
-                        totalBytes += thisPacketSize;
-                        packetsSent++;
-                        DependencyManager::get<NodeList>()->sendPacket(std::move(deletesPacket), *node);
-
-                        #ifdef EXTRA_ERASE_DEBUGGING
-                            qDebug() << "EntityServer::sendSpecialPackets() sending packet packetsSent[" << packetsSent << "] size:" << thisPacketSize;
-                        #endif
+        // only the entity IDs that have been deleted since we last sent to this node are read from the tree's log
+        auto deletedEntitiesCursor = tree->forEachEntityDeletedSince(nodeData->getDeletedEntitiesCursor(),
+                                                                     [&](const QUuid& entityID) {
+            // check to make sure we have room for one more ID, if we don't have more
+            // room, then send out this packet and create another one
+            if (NUM_BYTES_RFC4122_UUID > deletesPacket->bytesAvailableForWrite()) {
 
+                // replace the count for the number of included IDs
+                deletesPacket->seek(numberOfIDsPos);
+                deletesPacket->writePrimitive(numberOfIDs);
 
-                        // create another packet
-                        deletesPacket = NLPacket::create(PacketType::EntityErase);
+                // Send the current packet
+                queryNode->packetSent(*deletesPacket);
+                auto thisPacketSize = deletesPacket->getDataSize();
+                totalBytes += thisPacketSize;
+                packetsSent++;
+                DependencyManager::get<NodeList>()->sendPacket(std::move(deletesPacket), *node);
 
-                        // pack in flags
-                        deletesPacket->writePrimitive(flags);
+                #ifdef EXTRA_ERASE_DEBUGGING
+                    qDebug() << "EntityServer::sendSpecialPackets() sending packet packetsSent[" << packetsSent << "] size:" << thisPacketSize;
+                #endif
 
-                        // pack in sequence number
-                        sequenceNumber = queryNode->getSequenceNumber();
-                        deletesPacket->writePrimitive(sequenceNumber);
 
-                        // pack in timestamp
-                        deletesPacket->writePrimitive(now);
+                // create another packet
+                deletesPacket = NLPacket::create(PacketType::EntityErase);
 
-                        // figure out where we are now and pack a temporary number of IDs
-                        numberOfIDs = 0;
-                        numberOfIDsPos = deletesPacket->pos();
-                        deletesPacket->writePrimitive(numberOfIDs);
-                    }
+                // pack in flags
+                deletesPacket->writePrimitive(flags);
 
-                    // FIXME - we still seem to see cases where incorrect EntityIDs get sent from the server
-                    // to the client. These were causing "lost" entities like flashlights and laser pointers
-                    // now that we keep around some additional history of the erased entities and resend that
-                    // history for a longer time window, these entities are not "lost". But we haven't yet
-                    // found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
-                    deletesPacket->write(entityID.toRfc4122());
-                    ++numberOfIDs;
+                // pack in sequence number
+                sequenceNumber = queryNode->getSequenceNumber();
+                deletesPacket->writePrimitive(sequenceNumber);
 
-                    #ifdef EXTRA_ERASE_DEBUGGING
-                        qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
-                    #endif
-                } // end for (ids)
+                // pack in timestamp
+                deletesPacket->writePrimitive(now);
 
-            } // end if (it.val > sinceLast)
+                // figure out where we are now and pack a temporary number of IDs
+                numberOfIDs = 0;
+                numberOfIDsPos = deletesPacket->pos();
+                deletesPacket->writePrimitive(numberOfIDs);
+            }
 
+            // FIXME - we still seem to see cases where incorrect EntityIDs get sent from the server
+            // to the client. These were causing "lost" entities like flashlights and laser pointers.
+            // We haven't yet found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
+            deletesPacket->write(entityID.toRfc4122());
+            ++numberOfIDs;
 
-            ++it;
-        } // end while
+            #ifdef EXTRA_ERASE_DEBUGGING
+                qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
+            #endif
+        });
 
         // replace the count for the number of included IDs
         deletesPacket->seek(numberOfIDsPos);
@@ -245,7 +235,7 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
             qDebug() << "EntityServer::sendSpecialPackets() sending packet packetsSent[" << packetsSent << "] size:" << thisPacketSize;
         #endif
 
-        nodeData->setLastDeletedEntitiesSentAt(deletePacketSentAt);
+        nodeData->setDeletedEntitiesCursor(deletedEntitiesCursor);
     }
 
     #ifdef EXTRA_ERASE_DEBUGGING
@@ -264,17 +254,18 @@ void EntityServer::pruneDeletedEntities() {
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     if (tree->hasAnyDeletedEntities()) {
 
-        quint64 earliestLastDeletedEntitiesSent = usecTimestampNow() + 1; // in the future
-        DependencyManager::get<NodeList>()->eachNode([&earliestLastDeletedEntitiesSent](const SharedNodePointer& node) {
+        // nodes that haven't been sent anything yet start after what there is now
+        quint64 earliestDeletedEntitiesCursor = tree->getRecentlyDeletedEntitiesEnd();
+        DependencyManager::get<NodeList>()->eachNode([&earliestDeletedEntitiesCursor](const SharedNodePointer& node) {
             if (node->getLinkedData()) {
                 EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
-                quint64 nodeLastDeletedEntitiesSentAt = nodeData->getLastDeletedEntitiesSentAt();
-                if (nodeLastDeletedEntitiesSentAt < earliestLastDeletedEntitiesSent) {
-                    earliestLastDeletedEntitiesSent = nodeLastDeletedEntitiesSentAt;
+                quint64 nodeDeletedEntitiesCursor = nodeData->getDeletedEntitiesCursor();
+                if (nodeDeletedEntitiesCursor < earliestDeletedEntitiesCursor) {
+                    earliestDeletedEntitiesCursor = nodeDeletedEntitiesCursor;
                 }
             }
         });
-        tree->forgetEntitiesDeletedBefore(earliestLastDeletedEntitiesSent);
+        tree->forgetEntitiesDeletedBefore(earliestDeletedEntitiesCursor);
     }
 }
 
@@ -357,6 +348,36 @@ void EntityServer::trackViewerGone(const QUuid& sessionID) {
     }
 }
 
+// the size of the objects the entity server makes for entities of a type, not counting what they point to
+static size_t getEntityItemSize(EntityTypes::EntityType type) {
+    switch (type) {
+        case EntityTypes::Model:
+            return sizeof(ModelEntityItem);
+        case EntityTypes::Box:
+        case EntityTypes::Sphere:
+        case EntityTypes::Shape:
+            return sizeof(ShapeEntityItem);
+        case EntityTypes::Light:
+            return sizeof(LightEntityItem);
+        case EntityTypes::Text:
+            return sizeof(TextEntityItem);
+        case EntityTypes::ParticleEffect:
+            return sizeof(ParticleEffectEntityItem);
+        case EntityTypes::Zone:
+            return sizeof(ZoneEntityItem);
+        case EntityTypes::Web:
+            return sizeof(WebEntityItem);
+        case EntityTypes::Line:
+            return sizeof(LineEntityItem);
+        case EntityTypes::PolyVox:
+            return sizeof(PolyVoxEntityItem);
+        case EntityTypes::PolyLine:
+            return sizeof(PolyLineEntityItem);
+        default:
+            return sizeof(EntityItem);
+    }
+}
+
 QString EntityServer::serverSubclassStats() {
     QLocale locale(QLocale::English);
     QString statsString;
@@ -365,6 +386,30 @@ QString EntityServer::serverSubclassStats() {
     statsString += "<b>Entity Server Memory Statistics</b>\r\n";
     statsString += QString().sprintf("EntityTreeElement size... %ld bytes\r\n", sizeof(EntityTreeElement));
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
+    statsString += "\r\n";
+
+    int typeCounts[EntityTypes::LAST + 1] = {};
+    if (_tree) {
+        std::static_pointer_cast<EntityTree>(_tree)->forEachEntity([&](const EntityItemPointer& entity) {
+            ++typeCounts[entity->getType()];
+        });
+    }
+    quint64 totalSize = 0;
+    for (int type = EntityTypes::Unknown; type <= EntityTypes::LAST; ++type) {
+        if (typeCounts[type] > 0) {
+            auto entityType = (EntityTypes::EntityType)type;
+            size_t itemSize = getEntityItemSize(entityType);
+            quint64 typeSize = (quint64)typeCounts[type] * itemSize;
+            totalSize += typeSize;
+            statsString += QString("%1 %2 entities of %3 bytes... %4 bytes\r\n")
+                .arg(EntityTypes::getEntityTypeName(entityType).rightJustified(16, ' '))
+                .arg(locale.toString(typeCounts[type]).rightJustified(10, ' '))
+                .arg((qulonglong)itemSize, 5)
+                .arg(locale.toString((qulonglong)typeSize));
+        }
+    }
+    statsString += QString("     all entities... %1 bytes, not counting the data they point to\r\n")
+        .arg(locale.toString((qulonglong)totalSize));
     statsString += "\r\n\r\n";
 
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
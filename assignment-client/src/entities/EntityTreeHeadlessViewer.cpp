@@ -10,6 +10,9 @@
 //
 
 #include "EntityTreeHeadlessViewer.h"
+
+#include <EntityNodeData.h>
+
 #include "SimpleEntitySimulation.h"
 
 EntityTreeHeadlessViewer::EntityTreeHeadlessViewer()
@@ -42,3 +45,37 @@ void EntityTreeHeadlessViewer::update() {
 void EntityTreeHeadlessViewer::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
     std::static_pointer_cast<EntityTree>(_tree)->processEraseMessage(message, sourceNode);
 }
+
+void EntityTreeHeadlessViewer::regionOfInterestChanged() {
+    auto jsonParameters = getOctreeQuery().getJSONParameters();
+    if (getRegionOfInterestRadius() > 0.0f) {
+        jsonParameters[EntityJSONQueryProperties::REGION_OF_INTEREST_PROPERTY] = getRegionOfInterestRadius();
+    } else {
+        jsonParameters.remove(EntityJSONQueryProperties::REGION_OF_INTEREST_PROPERTY);
+    }
+    getOctreeQuery().setJSONParameters(jsonParameters);
+}
+
+void EntityTreeHeadlessViewer::evictOutsideRegionOfInterest() {
+    EntityTreePointer tree = getTree();
+    if (!tree) {
+        return;
+    }
+
+    glm::vec3 center = getPosition();
+    float radius = getRegionOfInterestRadius();
+    tree->withWriteLock([&] {
+        // the same test the entity server puts the query cubes to against the keyhole
+        QSet<EntityItemID> evictedIDs;
+        tree->forEachEntity([&](const EntityItemPointer& entity) {
+            bool success;
+            AACube queryCube = entity->getQueryAACube(success);
+            if (success && !queryCube.touchesSphere(center, radius)) {
+                evictedIDs << entity->getEntityItemID();
+            }
+        });
+        if (!evictedIDs.isEmpty()) {
+            tree->deleteEntities(evictedIDs, true);
+        }
+    });
+}
@@ -43,6 +43,9 @@ public:
     virtual void init() override;
 
 protected:
+    virtual void regionOfInterestChanged() override;
+    virtual void evictOutsideRegionOfInterest() override;
+
     virtual OctreePointer createTree() override {
         EntityTreePointer newTree = EntityTreePointer(new EntityTree(true));
         newTree->createRootElement();
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
 #include <QBuffer>
@@ -30,29 +32,66 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    for (auto channel = _channelSubscribers.begin(); channel != _channelSubscribers.end();) {
+        channel->remove(killedNode->getUUID());
+        if (channel->isEmpty()) {
+            channel = _channelSubscribers.erase(channel);
+        } else {
+            ++channel;
+        }
     }
 }
 
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
-    QByteArray data;
-    QUuid senderID;
-    bool isText;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+    // only the channel is decoded, the message is forwarded to the subscribers as it came in
+    quint16 channelLength;
+    receivedMessage->readPrimitive(&channelLength);
+    QString channel = QString::fromUtf8(receivedMessage->read(channelLength));
+
+    auto& channelStats = _channelStats[channel];
+    channelStats.messagesReceived++;
+
+    if (_maxMessagesPerSecondPerChannel > 0) {
+        float secondsSinceStats = (float)(usecTimestampNow() - _lastStatsTime) / USECS_PER_SECOND;
+        if (channelStats.messagesReceived > std::max(1.0f, secondsSinceStats) * _maxMessagesPerSecondPerChannel) {
+            channelStats.messagesDropped++;
+            return;
+        }
+    }
+
+    if (!_channelSubscribers.contains(channel)) {
+        return;
+    }
+
+    // The messages that come in together are fanned out together, once the packets already received are handled
+    if (_pendingMessages.empty()) {
+        QMetaObject::invokeMethod(this, "sendPendingMessages", Qt::QueuedConnection);
+    }
+    _pendingMessages.push_back({ channel, receivedMessage->getMessage() });
+}
+
+void MessagesMixer::sendPendingMessages() {
+    MessagesMixerBatch batch;
+    batch.swap(_pendingMessages);
+    if (batch.empty()) {
+        return;
+    }
 
+    // the slaves split the destinations, each one sends all the messages to the nodes it takes
     auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
+        _slavePool.sendMessages(cbegin, cend, batch, _channelSubscribers);
+    });
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getActiveSocket() && _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = isText ? MessagesClient::encodeMessagesPacket(channel, message, senderID) :
-                                   MessagesClient::encodeMessagesDataPacket(channel, data, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
+    std::vector<int> numMessagesSent(batch.size(), 0);
+    _slavePool.each([&](MessagesMixerSlave& slave) {
+        slave.harvestStats(numMessagesSent);
     });
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto& channelStats = _channelStats[batch[i].channel];
+        channelStats.messagesSent += numMessagesSent[i];
+        channelStats.bytesSent += (qint64)numMessagesSent[i] * batch[i].payload.size();
+    }
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -62,8 +101,12 @@ void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> mess
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    auto subscribers = _channelSubscribers.find(channel);
+    if (subscribers != _channelSubscribers.end()) {
+        subscribers->remove(senderNode->getUUID());
+        if (subscribers->isEmpty()) {
+            _channelSubscribers.erase(subscribers);
+        }
     }
 }
 
@@ -80,11 +123,70 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesMixerObject;
+
+    // add stats for each channel that had messages or has subscribers
+    quint64 now = usecTimestampNow();
+    float secondsSinceStats = (_lastStatsTime > 0) ? (float)(now - _lastStatsTime) / USECS_PER_SECOND : 1.0f;
+    _lastStatsTime = now;
+
+    QJsonObject channelsObject;
+    for (auto channel = _channelSubscribers.cbegin(); channel != _channelSubscribers.cend(); ++channel) {
+        _channelStats[channel.key()]; // report the quiet channels too
+    }
+    for (auto channel = _channelStats.cbegin(); channel != _channelStats.cend(); ++channel) {
+        const auto& channelStats = channel.value();
+        QJsonObject channelObject;
+        channelObject["subscribers"] = _channelSubscribers.value(channel.key()).size();
+        channelObject["received_per_s"] = channelStats.messagesReceived / secondsSinceStats;
+        channelObject["dropped_per_s"] = channelStats.messagesDropped / secondsSinceStats;
+        channelObject["sent_per_s"] = channelStats.messagesSent / secondsSinceStats;
+        channelObject["outbound_kbps"] = channelStats.bytesSent / (secondsSinceStats * BYTES_PER_KILOBIT);
+        channelsObject[channel.key()] = channelObject;
+    }
+    _channelStats.clear();
+
+    statsObject["channels"] = channelsObject;
+    statsObject["threads"] = _slavePool.numThreads();
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void MessagesMixer::run() {
+    // the settings only tune the mixing, it runs with the defaults until they come in
+    DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
+    connect(&domainHandler, &DomainHandler::settingsReceived, this, &MessagesMixer::domainSettingsRequestComplete);
+
     ThreadedAssignment::commonInit(MESSAGES_MIXER_LOGGING_NAME, NodeType::MessagesMixer);
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer });
 }
+
+void MessagesMixer::domainSettingsRequestComplete() {
+    parseDomainServerSettings(DependencyManager::get<NodeList>()->getDomainHandler().getSettingsObject());
+}
+
+void MessagesMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
+    const QString MESSAGES_MIXER_SETTINGS_KEY = "messages_mixer";
+    QJsonObject messagesMixerGroupObject = domainSettings[MESSAGES_MIXER_SETTINGS_KEY].toObject();
+
+    const QString MAX_MESSAGES_PER_SECOND_PER_CHANNEL_KEY = "max_messages_per_second_per_channel";
+    _maxMessagesPerSecondPerChannel = std::max(messagesMixerGroupObject[MAX_MESSAGES_PER_SECOND_PER_CHANNEL_KEY].toInt(0), 0);
+    if (_maxMessagesPerSecondPerChannel > 0) {
+        qDebug() << "Channels are limited to" << _maxMessagesPerSecondPerChannel << "messages per second.";
+    }
+
+    const QString AUTO_THREADS = "auto_threads";
+    bool autoThreads = messagesMixerGroupObject[AUTO_THREADS].toBool();
+    if (!autoThreads) {
+        bool ok;
+        const QString NUM_THREADS = "num_threads";
+        int numThreads = messagesMixerGroupObject[NUM_THREADS].toString().toInt(&ok);
+        if (!ok) {
+            qWarning() << "Messages mixer: Error reading thread count. Using 1 thread.";
+            numThreads = 1;
+        }
+        qDebug() << "Messages mixer will use specified number of threads:" << numThreads;
+        _slavePool.setNumThreads(numThreads);
+    } else {
+        qDebug() << "Messages mixer will automatically determine number of threads to use. Using:" << _slavePool.numThreads() << "threads.";
+    }
+}
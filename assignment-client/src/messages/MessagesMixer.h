@@ -17,6 +17,8 @@
 
 #include <ThreadedAssignment.h>
 
+#include "MessagesMixerSlavePool.h"
+
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
 class MessagesMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -32,9 +34,27 @@ private slots:
     void handleMessages(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void domainSettingsRequestComplete();
+    void sendPendingMessages();
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    void parseDomainServerSettings(const QJsonObject& domainSettings);
+
+    // since the last stats packet, the rate limit of the channels counts over the same period
+    class ChannelStats {
+    public:
+        int messagesReceived { 0 };
+        int messagesDropped { 0 };
+        int messagesSent { 0 };
+        qint64 bytesSent { 0 };
+    };
+
+    MessagesMixerChannels _channelSubscribers; // channels without subscribers are removed
+    MessagesMixerBatch _pendingMessages; // received since the last fan out
+    MessagesMixerSlavePool _slavePool;
+    QHash<QString, ChannelStats> _channelStats;
+    int _maxMessagesPerSecondPerChannel { 0 }; // 0 for no limit
+    quint64 _lastStatsTime { 0 };
 };
 
 #endif // hifi_MessagesMixer_h
@@ -0,0 +1,46 @@
+//
+//  MessagesMixerSlave.cpp
+//  assignment-client/src/messages
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesMixerSlave.h"
+
+#include <udt/PacketHeaders.h>
+
+void MessagesMixerSlave::configure(const MessagesMixerBatch* batch, const MessagesMixerChannels* channelSubscribers) {
+    _batch = batch;
+    _channelSubscribers = channelSubscribers;
+    _numMessagesSent.assign(batch->size(), 0);
+}
+
+void MessagesMixerSlave::sendMessages(const SharedNodePointer& node) {
+    if (!node->getActiveSocket()) {
+        return;
+    }
+
+    // Every message to a node goes out from the same slave, in order, so the messages of each sender on each channel
+    // keep their order
+    auto nodeList = DependencyManager::get<NodeList>();
+    for (size_t i = 0; i < _batch->size(); i++) {
+        const auto& message = (*_batch)[i];
+        auto subscribers = _channelSubscribers->constFind(message.channel);
+        if (subscribers != _channelSubscribers->cend() && subscribers->contains(node->getUUID())) {
+            auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+            packetList->write(message.payload);
+            nodeList->sendPacketList(std::move(packetList), *node);
+            _numMessagesSent[i]++;
+        }
+    }
+}
+
+void MessagesMixerSlave::harvestStats(std::vector<int>& numMessagesSent) {
+    for (size_t i = 0; i < _numMessagesSent.size() && i < numMessagesSent.size(); i++) {
+        numMessagesSent[i] += _numMessagesSent[i];
+    }
+    _numMessagesSent.clear();
+}
@@ -0,0 +1,48 @@
+//
+//  MessagesMixerSlave.h
+//  assignment-client/src/messages
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesMixerSlave_h
+#define hifi_MessagesMixerSlave_h
+
+#include <vector>
+
+#include <NodeList.h>
+
+// A message to fan out, the payload is forwarded to the subscribers of the channel as it came in
+class MessagesMixerMessage {
+public:
+    QString channel;
+    QByteArray payload;
+};
+
+using MessagesMixerBatch = std::vector<MessagesMixerMessage>;
+using MessagesMixerChannels = QHash<QString, QSet<QUuid>>;
+
+class MessagesMixerSlave {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    // the batch and the channels are only read, and must not change until the job is done
+    void configure(const MessagesMixerBatch* batch, const MessagesMixerChannels* channelSubscribers);
+
+    // sends the messages of the batch on the channels the node subscribes to, in the order they were received
+    void sendMessages(const SharedNodePointer& node);
+
+    // adds the number of nodes each message of the batch was sent to by this slave
+    void harvestStats(std::vector<int>& numMessagesSent);
+
+private:
+    const MessagesMixerBatch* _batch { nullptr };
+    const MessagesMixerChannels* _channelSubscribers { nullptr };
+
+    std::vector<int> _numMessagesSent;
+};
+
+#endif // hifi_MessagesMixerSlave_h
@@ -0,0 +1,101 @@
+//
+//  MessagesMixerSlavePool.h
+//  assignment-client/src/messages
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesMixerSlavePool_h
+#define hifi_MessagesMixerSlavePool_h
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include <QThread>
+
+#include <TBBHelpers.h>
+#include <NodeList.h>
+
+#include "MessagesMixerSlave.h"
+
+class MessagesMixerSlavePool;
+
+class MessagesMixerSlaveThread : public QThread, public MessagesMixerSlave {
+    Q_OBJECT
+    using ConstIter = NodeList::const_iterator;
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+public:
+    MessagesMixerSlaveThread(MessagesMixerSlavePool& pool) : _pool(pool) {}
+
+    void run() override final;
+
+private:
+    friend class MessagesMixerSlavePool;
+
+    void wait();
+    void notify(bool stopping);
+    bool try_pop(SharedNodePointer& node);
+
+    MessagesMixerSlavePool& _pool;
+    void (MessagesMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
+    bool _stop { false };
+};
+
+// Slave pool for messages mixers
+//   MessagesMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
+class MessagesMixerSlavePool {
+    using Queue = tbb::concurrent_queue<SharedNodePointer>;
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+    using ConditionVariable = std::condition_variable;
+
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    MessagesMixerSlavePool(int numThreads = QThread::idealThreadCount()) { setNumThreads(numThreads); }
+    ~MessagesMixerSlavePool() { resize(0); }
+
+    // Jobs the slave pool can do...
+    void sendMessages(ConstIter begin, ConstIter end,
+                      const MessagesMixerBatch& batch, const MessagesMixerChannels& channelSubscribers);
+
+    // iterate over all slaves
+    void each(std::function<void(MessagesMixerSlave& slave)> functor);
+
+    void setNumThreads(int numThreads);
+    int numThreads() { return _numThreads; }
+
+private:
+    void run(ConstIter begin, ConstIter end);
+    void resize(int numThreads);
+
+    std::vector<std::unique_ptr<MessagesMixerSlaveThread>> _slaves;
+
+    friend void MessagesMixerSlaveThread::wait();
+    friend void MessagesMixerSlaveThread::notify(bool stopping);
+    friend bool MessagesMixerSlaveThread::try_pop(SharedNodePointer& node);
+
+    // synchronization state
+    Mutex _mutex;
+    ConditionVariable _slaveCondition;
+    ConditionVariable _poolCondition;
+    void (MessagesMixerSlave::*_function)(const SharedNodePointer& node);
+    std::function<void(MessagesMixerSlave&)> _configure;
+    int _numThreads { 0 };
+    int _numStarted { 0 }; // guarded by _mutex
+    int _numFinished { 0 }; // guarded by _mutex
+    int _numStopped { 0 }; // guarded by _mutex
+
+    // frame state
+    Queue _queue;
+    ConstIter _begin;
+    ConstIter _end;
+};
+
+#endif // hifi_MessagesMixerSlavePool_h
@@ -11,14 +11,35 @@
 
 #include "OctreeHeadlessViewer.h"
 
+#include <algorithm>
+
 #include <NodeList.h>
+#include <NumericalConstants.h>
 #include <OctreeLogging.h>
+#include <SharedUtil.h>
 
+// what has moved out of the region is let go of on a query this long after the last one that did
+static const quint64 REGION_OF_INTEREST_EVICTION_INTERVAL_USECS = USECS_PER_SECOND;
 
 OctreeHeadlessViewer::OctreeHeadlessViewer() {
     _viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO, DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
 }
 
+void OctreeHeadlessViewer::setRegionOfInterestRadius(float radius) {
+    radius = std::max(radius, 0.0f);
+    if (radius != _regionOfInterestRadius) {
+        _regionOfInterestRadius = radius;
+        regionOfInterestChanged();
+    }
+}
+
+bool OctreeHeadlessViewer::isServerInView(const AACube& serverBounds) const {
+    if (_regionOfInterestRadius > 0.0f) {
+        return serverBounds.touchesSphere(_viewFrustum.getPosition(), _regionOfInterestRadius);
+    }
+    return (bool)(_viewFrustum.calculateCubeKeyholeIntersection(serverBounds));
+}
+
 void OctreeHeadlessViewer::queryOctree() {
     char serverType = getMyNodeType();
     PacketType packetType = getMyQueryMessageType();
@@ -51,6 +72,19 @@ void OctreeHeadlessViewer::queryOctree() {
     _octreeQuery.setOctreeSizeScale(_voxelSizeScale);
     _octreeQuery.setBoundaryLevelAdjust(_boundaryLevelAdjust);
 
+    if (_regionOfInterestRadius > 0.0f) {
+        // the frustum is a sliver in front of the position, the keyhole around it is the region that is sent
+        _octreeQuery.setCameraNearClip(DEFAULT_NEAR_CLIP);
+        _octreeQuery.setCameraFarClip(2.0f * DEFAULT_NEAR_CLIP);
+        _octreeQuery.setCameraCenterRadius(_regionOfInterestRadius);
+
+        auto now = usecTimestampNow();
+        if (now - _lastEvictionTime > REGION_OF_INTEREST_EVICTION_INTERVAL_USECS) {
+            _lastEvictionTime = now;
+            evictOutsideRegionOfInterest();
+        }
+    }
+
     // Iterate all of the nodes, and get a count of how many voxel servers we have...
     int totalServers = 0;
     int inViewServers = 0;
@@ -86,7 +120,7 @@ void OctreeHeadlessViewer::queryOctree() {
 
             if (foundRootDetails) {
                 AACube serverBounds(glm::vec3(rootDetails.x, rootDetails.y, rootDetails.z), rootDetails.s);
-                if ((bool)(_viewFrustum.calculateCubeKeyholeIntersection(serverBounds))) {
+                if (isServerInView(serverBounds)) {
                     inViewServers++;
                 }
             }
@@ -157,7 +191,7 @@ void OctreeHeadlessViewer::queryOctree() {
 
             if (foundRootDetails) {
                 AACube serverBounds(glm::vec3(rootDetails.x, rootDetails.y, rootDetails.z), rootDetails.s);
-                inView = (bool)(_viewFrustum.calculateCubeKeyholeIntersection(serverBounds));
+                inView = isServerInView(serverBounds);
             }
 
             if (inView) {
@@ -40,6 +40,10 @@ public slots:
     void setCenterRadius(float radius) { _viewFrustum.setCenterRadius(radius); }
     void setKeyholeRadius(float radius) { _viewFrustum.setCenterRadius(radius); } // TODO: remove this legacy support
 
+    // only what is within this distance of the position is asked for, and what the tree has beyond it is let go of,
+    // 0 goes back to asking for everything in the view frustum
+    void setRegionOfInterestRadius(float radius);
+
     // setters for LOD and PPS
     void setVoxelSizeScale(float sizeScale) { _voxelSizeScale = sizeScale; }
     void setBoundaryLevelAdjust(int boundaryLevelAdjust) { _boundaryLevelAdjust = boundaryLevelAdjust; }
@@ -48,6 +52,7 @@ public slots:
     // getters for camera attributes
     const glm::vec3& getPosition() const { return _viewFrustum.getPosition(); }
     const glm::quat& getOrientation() const { return _viewFrustum.getOrientation(); }
+    float getRegionOfInterestRadius() const { return _regionOfInterestRadius; }
 
     // getters for LOD and PPS
     float getVoxelSizeScale() const { return _voxelSizeScale; }
@@ -56,7 +61,13 @@ public slots:
 
     unsigned getOctreeElementsCount() const { return _tree->getOctreeElementsCount(); }
 
+protected:
+    virtual void regionOfInterestChanged() {}
+    virtual void evictOutsideRegionOfInterest() {}
+
 private:
+    bool isServerInView(const AACube& serverBounds) const;
+
     JurisdictionListener* _jurisdictionListener = nullptr;
     OctreeQuery _octreeQuery;
 
@@ -64,6 +75,9 @@ private:
     float _voxelSizeScale { DEFAULT_OCTREE_SIZE_SCALE };
     int _boundaryLevelAdjust { 0 };
     int _maxPacketsPerSecond { DEFAULT_MAX_OCTREE_PPS };
+
+    float _regionOfInterestRadius { 0.0f };
+    quint64 _lastEvictionTime { 0 };
 };
 
 #endif // hifi_OctreeHeadlessViewer_h
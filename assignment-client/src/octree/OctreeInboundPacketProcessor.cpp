@@ -9,8 +9,13 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <PerfStat.h>
@@ -22,6 +27,28 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// the sequence number and sent time ahead of the edits in an edit packet
+const int EDIT_PACKET_HEADER_SIZE = sizeof(unsigned short int) + sizeof(quint64);
+
+// the read lock on the tree is let go of after this many edits or this long, for anyone waiting on the write lock
+const int MAX_EDITS_PER_TREE_READ_LOCK = 32;
+const quint64 MAX_TREE_READ_LOCK_USECS = 2 * USECS_PER_MSEC;
+
+const int MAX_DECODE_THREAD_COUNT = 4;
+
+namespace {
+
+class DecodeEditPacketTask : public QRunnable {
+public:
+    DecodeEditPacketTask(std::function<void()> decode) : _decode(decode) { }
+    void run() override { _decode(); }
+
+private:
+    std::function<void()> _decode;
+};
+
+}
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -33,6 +60,110 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _lastNackTime(usecTimestampNow()),
     _shuttingDown(false)
 {
+    // leave a core to the processing thread, which applies what they decode
+    _decodePool.setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount() - 1, MAX_DECODE_THREAD_COUNT)));
+}
+
+void OctreeInboundPacketProcessor::terminating() {
+    _shuttingDown = true;
+    _decodePool.clear();
+    ReceivedPacketProcessor::terminating();
+}
+
+void OctreeInboundPacketProcessor::queueEditPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    auto tree = _myServer->getOctree();
+    if (!_shuttingDown && tree && tree->handlesEditPacketType(message->getType())) {
+        auto pendingDecode = std::make_shared<PendingDecode>();
+        pendingDecode->nodeUUID = sendingNode->getUUID();
+        {
+            std::lock_guard<std::mutex> lock(_decodeMutex);
+            _pendingDecodes.insert(message.data(), pendingDecode);
+            countPendingDecode(pendingDecode->nodeUUID, 1);
+        }
+        _decodePool.start(new DecodeEditPacketTask([this, tree, message, pendingDecode] {
+            decodeEditPacket(tree, message, pendingDecode);
+        }));
+    }
+    queueReceivedPacket(message, sendingNode);
+}
+
+void OctreeInboundPacketProcessor::decodeEditPacket(const OctreePointer& tree, const QSharedPointer<ReceivedMessage>& message,
+                                                    const PendingDecodePointer& pendingDecode) {
+    {
+        std::lock_guard<std::mutex> lock(_decodeMutex);
+        if (pendingDecode->state != PendingDecode::Queued) {
+            return;
+        }
+        pendingDecode->state = PendingDecode::Decoding;
+    }
+
+    // the message isn't read from here, the processing thread has its position
+    auto decodedEdits = tree->decodeEditPacketData(*message, EDIT_PACKET_HEADER_SIZE);
+
+    {
+        std::lock_guard<std::mutex> lock(_decodeMutex);
+        pendingDecode->decodedEdits = decodedEdits;
+        pendingDecode->state = PendingDecode::Decoded;
+        countPendingDecode(pendingDecode->nodeUUID, -1);
+    }
+    _decodeCondition.notify_all();
+}
+
+OctreeDecodedEditsPointer OctreeInboundPacketProcessor::takeDecodedEdits(const ReceivedMessage& message,
+                                                                         int& decodeQueueDepth) {
+    std::unique_lock<std::mutex> lock(_decodeMutex);
+    auto it = _pendingDecodes.find(&message);
+    if (it == _pendingDecodes.end()) {
+        decodeQueueDepth = 0;
+        return nullptr;
+    }
+    auto pendingDecode = it.value();
+    _pendingDecodes.erase(it);
+    decodeQueueDepth = _nodePendingDecodeCounts.value(pendingDecode->nodeUUID);
+
+    if (pendingDecode->state == PendingDecode::Queued) {
+        pendingDecode->state = PendingDecode::Abandoned;
+        countPendingDecode(pendingDecode->nodeUUID, -1);
+        return nullptr;
+    }
+
+    if (pendingDecode->state == PendingDecode::Decoding) {
+        // nobody waiting on the write lock is kept waiting on a decoding thread too
+        lock.unlock();
+        unlockTreeForEdits();
+        lock.lock();
+        _decodeCondition.wait(lock, [&] { return pendingDecode->state == PendingDecode::Decoded; });
+    }
+    return pendingDecode->decodedEdits;
+}
+
+void OctreeInboundPacketProcessor::countPendingDecode(const QUuid& nodeUUID, int count) {
+    int& pendingCount = _nodePendingDecodeCounts[nodeUUID];
+    pendingCount += count;
+    if (pendingCount <= 0) {
+        _nodePendingDecodeCounts.remove(nodeUUID);
+    }
+}
+
+void OctreeInboundPacketProcessor::lockTreeForEdit(quint64& lockWaitTime) {
+    if (_treeReadLocker && (_editsUnderTreeReadLock >= MAX_EDITS_PER_TREE_READ_LOCK ||
+            usecTimestampNow() - _treeReadLockedAt >= MAX_TREE_READ_LOCK_USECS)) {
+        unlockTreeForEdits();
+    }
+
+    lockWaitTime = 0;
+    if (!_treeReadLocker) {
+        quint64 startLock = usecTimestampNow();
+        _treeReadLocker.reset(new QReadLocker(&_myServer->getOctree()->getLock()));
+        _treeReadLockedAt = usecTimestampNow();
+        lockWaitTime = _treeReadLockedAt - startLock;
+    }
+    _editsUnderTreeReadLock++;
+}
+
+void OctreeInboundPacketProcessor::unlockTreeForEdits() {
+    _treeReadLocker.reset();
+    _editsUnderTreeReadLock = 0;
 }
 
 void OctreeInboundPacketProcessor::resetStats() {
@@ -75,9 +206,15 @@ void OctreeInboundPacketProcessor::midProcess() {
     }
 }
 
+void OctreeInboundPacketProcessor::postProcess() {
+    unlockTreeForEdits();
+}
+
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
+        std::lock_guard<std::mutex> lock(_decodeMutex);
+        _pendingDecodes.remove(message.data());
         return;
     }
 
@@ -116,6 +253,15 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         quint64 processTime = 0;
         quint64 lockWaitTime = 0;
 
+        int decodeQueueDepth = 0;
+        auto decodedEdits = takeDecodedEdits(*message, decodeQueueDepth);
+        int applyQueueDepth = 0;
+        if (sendingNode) {
+            lock();
+            applyQueueDepth = _nodePacketCounts.value(sendingNode->getUUID());
+            unlock();
+        }
+
         if (debugProcessPacket || _myServer->wantsDebugReceiving()) {
             qDebug() << "PROCESSING THREAD: got '" << packetType << "' packet - " << _receivedPacketCount << " command from client";
             qDebug() << "    receivedBytes=" << message->getSize();
@@ -157,13 +303,24 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                         message->getPosition(), maxSize);
             }
 
-            quint64 startProcess, startLock = usecTimestampNow();
-            int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
-                    _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
-            });
+            // most edits only change properties, and can be applied without keeping the send threads out of the tree
+            quint64 readLockWaitTime;
+            lockTreeForEdit(readLockWaitTime);
+            quint64 startProcess = usecTimestampNow();
+            int editDataBytesRead = _myServer->getOctree()->processEditPacketDataUnderReadLock(*message, editData, maxSize,
+                                                                                               sendingNode, decodedEdits.get());
+
+            quint64 writeLockWaitTime = 0;
+            if (editDataBytesRead == EDIT_NEEDS_WRITE_LOCK) {
+                // the read lock held by this thread would keep it from ever getting the write lock
+                unlockTreeForEdits();
+                quint64 startWriteLock = usecTimestampNow();
+                _myServer->getOctree()->withWriteLock([&] {
+                    writeLockWaitTime = usecTimestampNow() - startWriteLock;
+                    editDataBytesRead = _myServer->getOctree()->processEditPacketData(*message, editData, maxSize,
+                                                                                      sendingNode, decodedEdits.get());
+                });
+            }
             quint64 endProcess = usecTimestampNow();
 
             if (debugProcessPacket) {
@@ -172,8 +329,8 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
             }
 
             editsInPacket++;
-            quint64 thisProcessTime = endProcess - startProcess;
-            quint64 thisLockWaitTime = startProcess - startLock;
+            quint64 thisProcessTime = endProcess - startProcess - writeLockWaitTime;
+            quint64 thisLockWaitTime = readLockWaitTime + writeLockWaitTime;
             processTime += thisProcessTime;
             lockWaitTime += thisLockWaitTime;
 
@@ -206,14 +363,15 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                 qDebug() << "sender has no known nodeUUID.";
             }
         }
-        trackInboundPacket(nodeUUID, sequence, transitTime, editsInPacket, processTime, lockWaitTime);
+        trackInboundPacket(nodeUUID, sequence, transitTime, editsInPacket, processTime, lockWaitTime,
+                           decodeQueueDepth, applyQueueDepth);
     } else {
         qDebug("unknown packet ignored... packetType=%hhu", (unsigned char)packetType);
     }
 }
 
 void OctreeInboundPacketProcessor::trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
-            int editsInPacket, quint64 processTime, quint64 lockWaitTime) {
+            int editsInPacket, quint64 processTime, quint64 lockWaitTime, int decodeQueueDepth, int applyQueueDepth) {
 
     _totalTransitTime += transitTime;
     _totalProcessTime += processTime;
@@ -227,11 +385,13 @@ void OctreeInboundPacketProcessor::trackInboundPacket(const QUuid& nodeUUID, uns
     // see if this is the first we've heard of this node...
     if (_singleSenderStats.find(nodeUUID) == _singleSenderStats.end()) {
         SingleSenderStats stats;
-        stats.trackInboundPacket(sequence, transitTime, editsInPacket, processTime, lockWaitTime);
+        stats.trackInboundPacket(sequence, transitTime, editsInPacket, processTime, lockWaitTime,
+                                 decodeQueueDepth, applyQueueDepth);
         _singleSenderStats[nodeUUID] = stats;
     } else {
         SingleSenderStats& stats = _singleSenderStats[nodeUUID];
-        stats.trackInboundPacket(sequence, transitTime, editsInPacket, processTime, lockWaitTime);
+        stats.trackInboundPacket(sequence, transitTime, editsInPacket, processTime, lockWaitTime,
+                                 decodeQueueDepth, applyQueueDepth);
     }
 }
 
@@ -315,13 +475,15 @@ SingleSenderStats::SingleSenderStats()
     _totalLockWaitTime(0),
     _totalElementsInPacket(0),
     _totalPackets(0),
+    _totalDecodeQueueDepth(0),
+    _totalApplyQueueDepth(0),
     _incomingEditSequenceNumberStats()
 {
 
 }
 
 void SingleSenderStats::trackInboundPacket(unsigned short int incomingSequence, quint64 transitTime,
-    int editsInPacket, quint64 processTime, quint64 lockWaitTime) {
+    int editsInPacket, quint64 processTime, quint64 lockWaitTime, int decodeQueueDepth, int applyQueueDepth) {
 
     // track sequence number
     _incomingEditSequenceNumberStats.sequenceNumberReceived(incomingSequence);
@@ -332,4 +494,6 @@ void SingleSenderStats::trackInboundPacket(unsigned short int incomingSequence,
     _totalLockWaitTime += lockWaitTime;
     _totalElementsInPacket += editsInPacket;
     _totalPackets++;
+    _totalDecodeQueueDepth += decodeQueueDepth;
+    _totalApplyQueueDepth += applyQueueDepth;
 }
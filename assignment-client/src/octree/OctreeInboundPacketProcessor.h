@@ -14,6 +14,13 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QThreadPool>
+
+#include <Octree.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -33,18 +40,26 @@ public:
                 { return _totalElementsInPacket == 0 ? 0 : _totalProcessTime / _totalElementsInPacket; }
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
+
+    // how many of the sender's packets were still to be decoded, and to be applied, as each of them was applied
+    float getAverageDecodeQueueDepth() const
+                { return _totalPackets == 0 ? 0.0f : (float)_totalDecodeQueueDepth / _totalPackets; }
+    float getAverageApplyQueueDepth() const
+                { return _totalPackets == 0 ? 0.0f : (float)_totalApplyQueueDepth / _totalPackets; }
     
     const SequenceNumberStats& getIncomingEditSequenceNumberStats() const { return _incomingEditSequenceNumberStats; }
     SequenceNumberStats& getIncomingEditSequenceNumberStats() { return _incomingEditSequenceNumberStats; }
 
     void trackInboundPacket(unsigned short int incomingSequence, quint64 transitTime,
-        int editsInPacket, quint64 processTime, quint64 lockWaitTime);
+        int editsInPacket, quint64 processTime, quint64 lockWaitTime, int decodeQueueDepth, int applyQueueDepth);
 
     quint64 _totalTransitTime;
     quint64 _totalProcessTime;
     quint64 _totalLockWaitTime;
     quint64 _totalElementsInPacket;
     quint64 _totalPackets;
+    quint64 _totalDecodeQueueDepth;
+    quint64 _totalApplyQueueDepth;
     SequenceNumberStats _incomingEditSequenceNumberStats;
 };
 
@@ -55,6 +70,10 @@ typedef QHash<QUuid, SingleSenderStats>::const_iterator NodeToSenderStatsMapCons
 
 /// Handles processing of incoming network packets for the octee servers. As with other ReceivedPacketProcessor classes
 /// the user is responsible for reading inbound packets and adding them to the processing queue by calling queueReceivedPacket()
+/// or, for the edits to be decoded ahead on the decoding threads, queueEditPacket().
+///
+/// Edits are then applied on the processing thread, with the tree's read lock held over the edits of consecutive packets
+/// until one of them needs the write lock, or they have held it long enough.
 class OctreeInboundPacketProcessor : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
@@ -74,7 +93,10 @@ public:
 
     NodeToSenderStatsMap getSingleSenderStats() { QReadLocker locker(&_senderStatsLock); return _singleSenderStats; }
 
-    virtual void terminating() override { _shuttingDown = true; ReceivedPacketProcessor::terminating(); }
+    /// Queues an edit packet to be processed, and starts decoding its edits on one of the decoding threads
+    void queueEditPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+
+    virtual void terminating() override;
 
 protected:
 
@@ -83,13 +105,32 @@ protected:
     virtual uint32_t getMaxWait() const override;
     virtual void preProcess() override;
     virtual void midProcess() override;
+    virtual void postProcess() override;
 
 private:
     int sendNackPackets();
 
 private:
+    struct PendingDecode {
+        enum State { Queued, Decoding, Decoded, Abandoned };
+        State state { Queued };
+        QUuid nodeUUID;
+        OctreeDecodedEditsPointer decodedEdits;
+    };
+    using PendingDecodePointer = std::shared_ptr<PendingDecode>;
+
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
-            int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
+            int elementsInPacket, quint64 processTime, quint64 lockWaitTime, int decodeQueueDepth, int applyQueueDepth);
+
+    void decodeEditPacket(const OctreePointer& tree, const QSharedPointer<ReceivedMessage>& message,
+                          const PendingDecodePointer& pendingDecode);
+    // the decoded edits of a message, waiting for a decoding thread that is at it. Nothing for a message no decoding
+    // thread got to, whose edits are decoded as they are processed instead
+    OctreeDecodedEditsPointer takeDecodedEdits(const ReceivedMessage& message, int& decodeQueueDepth);
+    void countPendingDecode(const QUuid& nodeUUID, int count);
+
+    void lockTreeForEdit(quint64& lockWaitTime);
+    void unlockTreeForEdits();
 
     OctreeServer* _myServer;
     int _receivedPacketCount;
@@ -105,5 +146,18 @@ private:
 
     std::atomic<uint64_t> _lastNackTime;
     bool _shuttingDown;
+
+    // the read lock on the tree held over the edits of consecutive packets, see lockTreeForEdit()
+    std::unique_ptr<QReadLocker> _treeReadLocker;
+    quint64 _treeReadLockedAt { 0 };
+    int _editsUnderTreeReadLock { 0 };
+
+    std::mutex _decodeMutex;
+    std::condition_variable _decodeCondition;
+    QHash<const ReceivedMessage*, PendingDecodePointer> _pendingDecodes;
+    QHash<QUuid, int> _nodePendingDecodeCounts; // the packets of each sender queued or being decoded
+
+    // last, so that it waits for the decoding threads before the rest of the processor goes away
+    QThreadPool _decodePool;
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
@@ -9,13 +9,17 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <unordered_map>
 
 #include <NodeList.h>
 #include <NumericalConstants.h>
+#include <OctalCode.h>
 #include <udt/PacketHeaders.h>
 #include <PerfStat.h>
+#include <TBBHelpers.h>
 
 #include "OctreeQueryNode.h"
 #include "OctreeSendThread.h"
@@ -26,6 +30,66 @@
 quint64 startSceneSleepTime = 0;
 quint64 endSceneSleepTime = 0;
 
+// elements this many levels below the root and deeper are grouped by their ancestor at that level, the
+// subtrees of different groups share no elements and can be encoded on different threads
+static const int PARALLEL_ENCODE_GROUP_SECTIONS = 2;
+
+// fewer groups than this in the element bag aren't worth farming out
+static const int MIN_PARALLEL_ENCODE_GROUPS = 4;
+
+// give up on a subtree that doesn't fit into an empty packet this many times in a row
+static const int MAX_PARALLEL_ENCODE_EMPTY_ATTEMPTS = 2;
+
+// elements changed this recently are sent before others the client sees as large
+static const quint64 RECENT_CHANGE_USECS = USECS_PER_SECOND;
+static const float RECENT_CHANGE_PRIORITY_BOOST = 4.0f;
+
+// the bytes sent per interval are halved when the client reports losses, and grow again by a fraction of a packet
+// each interval the budget is used up without any
+static const int MIN_BYTES_PER_INTERVAL = udt::MAX_PACKET_SIZE;
+static const int BYTES_PER_INTERVAL_INCREASE = udt::MAX_PACKET_SIZE / 8;
+
+namespace {
+
+struct ParallelEncodeJob {
+    std::vector<OctreeElementPointer> subtrees;
+    OctreeElementBag bag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreeSceneStats stats;
+    std::vector<QByteArray> sections;
+    float priority { 0.0f };
+};
+
+// the group an element belongs to, or -1 if it is too close to the root to be encoded in parallel
+int parallelEncodeGroup(const OctreeElement& element) {
+    const unsigned char* octalCode = element.getOctalCode();
+    if (numberOfThreeBitSectionsInCode(octalCode) < PARALLEL_ENCODE_GROUP_SECTIONS) {
+        return -1;
+    }
+    // the leading three bit sections follow the length byte
+    return octalCode[1] >> (BITS_IN_BYTE - 3 * PARALLEL_ENCODE_GROUP_SECTIONS);
+}
+
+// moves the extra encode data for element and its descendants, only elements that have it can have descendants with it
+void moveExtraEncodeData(const OctreeElementPointer& element,
+                         OctreeElementExtraEncodeData& from, OctreeElementExtraEncodeData& to) {
+    auto it = from.find(element.get());
+    if (it == from.end()) {
+        return;
+    }
+    to.insert(it.key(), it.value());
+    from.erase(it);
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElementPointer child = element->getChildAtIndex(i);
+        if (child) {
+            moveExtraEncodeData(child, from, to);
+        }
+    }
+}
+
+}
+
 OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) :
     _myServer(myServer),
     _node(node),
@@ -311,12 +375,14 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         return 0;
     }
 
-    if (nodeData->elementBag.isEmpty()) {
+    if (!hasSceneToSend(nodeData)) {
         // if we're about to do a fresh pass,
         // give our pre-distribution processing a chance to do what it needs
         preDistributionProcessing();
     }
 
+    updateBytesPerInterval(nodeData);
+
     _truePacketsSent = 0;
     _trueBytesSent = 0;
     _packetsSentThisInterval = 0;
@@ -340,12 +406,18 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     }
     int targetSize = MAX_OCTREE_PACKET_DATA_SIZE;
     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+    _sectionTargetSize = targetSize;
 
     _packetData.changeSettings(true, targetSize); // FIXME - eventually support only compressed packets
 
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
-    if (viewFrustumChanged || nodeData->elementBag.isEmpty()) {
+    if (viewFrustumChanged || !hasSceneToSend(nodeData)) {
+
+        // a scene that was still being sent is abandoned for the new one, one that was completed has already ended
+        if (hasSceneToSend(nodeData)) {
+            nodeData->sceneEnded(false);
+        }
 
         // if our view has changed, we need to reset these things...
         if (viewFrustumChanged) {
@@ -370,7 +442,9 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         // If we're starting a full scene, then definitely we want to empty the elementBag
         if (isFullScene) {
             nodeData->elementBag.deleteAll();
+            _encodedSections.clear();
         }
+        prioritizeElementBag(nodeData);
 
         // TODO: add these to stats page
         //::startSceneSleepTime = _usleepTime;
@@ -392,7 +466,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     }
 
     // If we have something in our elementBag, then turn them into packets and send them out...
-    if (!nodeData->elementBag.isEmpty()) {
+    if (hasSceneToSend(nodeData)) {
         quint64 start = usecTimestampNow();
 
         traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
@@ -420,7 +494,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         int maxPacketsPerInterval = std::min(clientMaxPacketsPerInterval, _myServer->getPacketsPerClientPerInterval());
 
         // Re-send packets that were nacked by the client
-        while (nodeData->hasNextNackedPacket() && _packetsSentThisInterval < maxPacketsPerInterval) {
+        while (nodeData->hasNextNackedPacket() && canSendMoreThisInterval(maxPacketsPerInterval)) {
             const NLPacket* packet = nodeData->getNextNackedPacket();
             if (packet) {
                 DependencyManager::get<NodeList>()->sendUnreliablePacket(*packet, *node);
@@ -441,9 +515,10 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
         // if after sending packets we've emptied our bag, then we want to remember that we've sent all
         // the octree elements from the current view frustum
-        if (nodeData->elementBag.isEmpty()) {
+        if (!hasSceneToSend(nodeData)) {
             nodeData->updateLastKnownViewFrustum();
             nodeData->setViewSent(true);
+            nodeData->sceneEnded(true);
 
             // If this was a full scene then make sure we really send out a stats packet at this point so that
             // the clients will know the scene is stable
@@ -466,8 +541,13 @@ void OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
     int extraPackingAttempts = 0;
     bool completedScene = false;
 
+    if (_myServer->wantsParallelSceneEncode()) {
+        encodeSubtreesInParallel(nodeData, viewFrustumChanged, isFullScene);
+    }
+    sendEncodedSections(node, nodeData, maxPacketsPerInterval);
+
     bool somethingToSend = true; // assume we have something
-    while (somethingToSend && _packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown()) {
+    while (somethingToSend && canSendMoreThisInterval(maxPacketsPerInterval) && !nodeData->isShuttingDown()) {
         float lockWaitElapsedUsec = OctreeServer::SKIP_TIME;
         float encodeElapsedUsec = OctreeServer::SKIP_TIME;
         float compressAndWriteElapsedUsec = OctreeServer::SKIP_TIME;
@@ -489,25 +569,7 @@ void OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
                     return;
                 }
 
-                float octreeSizeScale = nodeData->getOctreeSizeScale();
-                int boundaryLevelAdjustClient = nodeData->getBoundaryLevelAdjust();
-
-                int boundaryLevelAdjust = boundaryLevelAdjustClient +
-                                          (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
-
-                EncodeBitstreamParams params(INT_MAX, WANT_EXISTS_BITS, DONT_CHOP,
-                                             viewFrustumChanged, boundaryLevelAdjust, octreeSizeScale,
-                                             isFullScene, _myServer->getJurisdiction(), nodeData);
-                nodeData->copyCurrentViewFrustum(params.viewFrustum);
-                if (viewFrustumChanged) {
-                    nodeData->copyLastKnownViewFrustum(params.lastViewFrustum);
-                }
-
-                // Our trackSend() function is implemented by the server subclass, and will be called back
-                // during the encodeTreeBitstream() as new entities/data elements are sent
-                params.trackSend = [this](const QUuid& dataID, quint64 dataEdited) {
-                    _myServer->trackSend(dataID, dataEdited, _nodeUuid);
-                };
+                EncodeBitstreamParams params = createEncodeParams(nodeData, viewFrustumChanged, isFullScene);
 
                 // TODO: should this include the lock time or not? This stat is sent down to the client,
                 // it seems like it may be a good idea to include the lock time as part of the encode time
@@ -589,6 +651,241 @@ void OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
     if (somethingToSend && _myServer->wantsVerboseDebug()) {
         qCDebug(octree) << "Hit PPS Limit, packetsSentThisInterval =" << _packetsSentThisInterval
                         << "  maxPacketsPerInterval = " << maxPacketsPerInterval
-                        << "  clientMaxPacketsPerInterval = " << clientMaxPacketsPerInterval;
+                        << "  clientMaxPacketsPerInterval = " << clientMaxPacketsPerInterval
+                        << "  bytesSentThisInterval = " << _trueBytesSent
+                        << "  bytesPerInterval = " << _bytesPerInterval;
+    }
+}
+
+EncodeBitstreamParams OctreeSendThread::createEncodeParams(OctreeQueryNode* nodeData, bool viewFrustumChanged,
+                                                           bool isFullScene) {
+    float octreeSizeScale = nodeData->getOctreeSizeScale();
+    int boundaryLevelAdjustClient = nodeData->getBoundaryLevelAdjust();
+
+    int boundaryLevelAdjust = boundaryLevelAdjustClient +
+                              (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
+
+    EncodeBitstreamParams params(INT_MAX, WANT_EXISTS_BITS, DONT_CHOP,
+                                 viewFrustumChanged, boundaryLevelAdjust, octreeSizeScale,
+                                 isFullScene, _myServer->getJurisdiction(), nodeData);
+    nodeData->copyCurrentViewFrustum(params.viewFrustum);
+    if (viewFrustumChanged) {
+        nodeData->copyLastKnownViewFrustum(params.lastViewFrustum);
+    }
+
+    // Our trackSend() function is implemented by the server subclass, and will be called back
+    // during the encodeTreeBitstream() as new entities/data elements are sent
+    params.trackSend = [this](const QUuid& dataID, quint64 dataEdited) {
+        _myServer->trackSend(dataID, dataEdited, _nodeUuid);
+    };
+
+    return params;
+}
+
+void OctreeSendThread::encodeSubtreesInParallel(OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene) {
+    // JSON filters keep per node state that is updated as entities are encoded, so those queries stay serial
+    if ((int)nodeData->elementBag.size() < MIN_PARALLEL_ENCODE_GROUPS || nodeData->isShuttingDown() ||
+        !nodeData->getJSONParameters().isEmpty()) {
+        return;
+    }
+
+    float lockWaitElapsedUsec = OctreeServer::SKIP_TIME;
+    float encodeElapsedUsec = OctreeServer::SKIP_TIME;
+
+    quint64 lockWaitStart = usecTimestampNow();
+    _myServer->getOctree()->withReadLock([&]{
+        quint64 encodeStart = usecTimestampNow();
+        lockWaitElapsedUsec = (float)(encodeStart - lockWaitStart);
+
+        // sort the bag into groups, elements too close to the root stay in the bag for the serial encode
+        std::vector<OctreeElementPointer> shallowElements;
+        std::unordered_map<int, std::unique_ptr<ParallelEncodeJob>> jobsByGroup;
+        while (!nodeData->elementBag.isEmpty()) {
+            OctreeElementPointer element = nodeData->elementBag.extract();
+            if (!element) {
+                continue;
+            }
+            int group = parallelEncodeGroup(*element);
+            if (group == -1) {
+                shallowElements.push_back(element);
+            } else {
+                auto& job = jobsByGroup[group];
+                if (!job) {
+                    job.reset(new ParallelEncodeJob());
+                }
+                job->subtrees.push_back(element);
+            }
+        }
+
+        for (auto& element : shallowElements) {
+            nodeData->elementBag.insert(element);
+        }
+
+        if ((int)jobsByGroup.size() < MIN_PARALLEL_ENCODE_GROUPS) {
+            for (auto& entry : jobsByGroup) {
+                for (auto& element : entry.second->subtrees) {
+                    nodeData->elementBag.insert(element);
+                }
+            }
+            return;
+        }
+
+        // in a stable order, so that the sections go out in the same order the serial encode would find them
+        std::vector<ParallelEncodeJob*> jobs;
+        jobs.reserve(jobsByGroup.size());
+        for (auto& entry : jobsByGroup) {
+            jobs.push_back(entry.second.get());
+        }
+        const auto& priorityFunction = nodeData->elementBag.getPriorityFunction();
+        if (priorityFunction) {
+            // the groups holding what the client sees largest first
+            for (auto job : jobs) {
+                for (auto& element : job->subtrees) {
+                    job->priority = std::max(job->priority, priorityFunction(*element));
+                }
+            }
+            std::stable_sort(jobs.begin(), jobs.end(), [](const ParallelEncodeJob* a, const ParallelEncodeJob* b) {
+                return a->priority > b->priority;
+            });
+        } else {
+            std::sort(jobs.begin(), jobs.end(), [](const ParallelEncodeJob* a, const ParallelEncodeJob* b) {
+                return parallelEncodeGroup(*a->subtrees.front()) < parallelEncodeGroup(*b->subtrees.front());
+            });
+        }
+
+        // each job gets the partial encode state of its own subtrees, no other job touches those elements
+        for (auto job : jobs) {
+            job->bag.setPriorityFunction(priorityFunction);
+            for (auto& element : job->subtrees) {
+                job->bag.insert(element);
+                moveExtraEncodeData(element, nodeData->extraEncodeData, job->extraEncodeData);
+            }
+        }
+
+        EncodeBitstreamParams baseParams = createEncodeParams(nodeData, viewFrustumChanged, isFullScene);
+        auto octree = _myServer->getOctree();
+        int targetSize = _sectionTargetSize;
+
+        nodeData->stats.encodeStarted();
+
+        tbb::parallel_for(0, (int)jobs.size(), [&](int i) {
+            ParallelEncodeJob& job = *jobs[i];
+
+            EncodeBitstreamParams params = baseParams;
+            params.stats = &job.stats;
+            params.extraEncodeData = &job.extraEncodeData;
+
+            OctreePacketData packetData(true, targetSize);
+            int emptyAttempts = 0;
+
+            while (!job.bag.isEmpty() && !nodeData->isShuttingDown()) {
+                OctreeElementPointer subTree = job.bag.extract();
+                if (!subTree) {
+                    continue;
+                }
+
+                params.stopReason = EncodeBitstreamParams::UNKNOWN;
+                octree->encodeTreeBitstream(subTree, &packetData, job.bag, params);
+
+                bool didntFit = (params.stopReason == EncodeBitstreamParams::DIDNT_FIT);
+                if (didntFit && !packetData.hasContent() && ++emptyAttempts >= MAX_PARALLEL_ENCODE_EMPTY_ATTEMPTS) {
+                    break; // leave the rest of this job for the serial encode
+                }
+
+                if ((didntFit || job.bag.isEmpty()) && packetData.hasContent()) {
+                    job.sections.emplace_back(reinterpret_cast<const char*>(packetData.getFinalizedData()),
+                                              packetData.getFinalizedSize());
+                    packetData.changeSettings(true, targetSize);
+                    emptyAttempts = 0;
+                }
+            }
+        });
+
+        for (auto job : jobs) {
+            nodeData->stats.accumulateElementStats(job->stats);
+            for (auto it = job->extraEncodeData.cbegin(); it != job->extraEncodeData.cend(); ++it) {
+                nodeData->extraEncodeData.insert(it.key(), it.value());
+            }
+            while (!job->bag.isEmpty()) {
+                OctreeElementPointer element = job->bag.extract();
+                if (element) {
+                    nodeData->elementBag.insert(element);
+                }
+            }
+            for (auto& section : job->sections) {
+                _encodedSections.push_back(std::move(section));
+            }
+        }
+
+        nodeData->stats.encodeStopped();
+        encodeElapsedUsec = (float)(usecTimestampNow() - encodeStart);
+    });
+
+    OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
+    OctreeServer::trackEncodeTime(encodeElapsedUsec);
+}
+
+void OctreeSendThread::sendEncodedSections(SharedNodePointer node, OctreeQueryNode* nodeData, int maxPacketsPerInterval) {
+    if (_encodedSections.empty()) {
+        return;
+    }
+
+    while (!_encodedSections.empty() && canSendMoreThisInterval(maxPacketsPerInterval) && !nodeData->isShuttingDown()) {
+        const QByteArray& section = _encodedSections.front();
+
+        unsigned int additionalSize = section.size() + sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+        if (additionalSize > nodeData->getAvailable()) {
+            // no room --> flush what we've got
+            _packetsSentThisInterval += handlePacketSend(node, nodeData);
+        }
+        nodeData->writeToPacket(reinterpret_cast<const unsigned char*>(section.constData()), section.size());
+
+        _encodedSections.pop_front();
+    }
+
+    // the serial encode flushes the last packet of a scene when it empties the bag, do the same if it has nothing left
+    if (_encodedSections.empty() && nodeData->elementBag.isEmpty() && nodeData->isPacketWaiting()) {
+        _packetsSentThisInterval += handlePacketSend(node, nodeData);
+    }
+}
+
+bool OctreeSendThread::hasSceneToSend(OctreeQueryNode* nodeData) {
+    return !nodeData->elementBag.isEmpty() || !_encodedSections.empty();
+}
+
+void OctreeSendThread::prioritizeElementBag(OctreeQueryNode* nodeData) {
+    if (!nodeData->getUsesFrustum()) {
+        nodeData->elementBag.clearPriorityFunction();
+        return;
+    }
+
+    ViewFrustum viewFrustum;
+    nodeData->copyCurrentViewFrustum(viewFrustum);
+    glm::vec3 eyePosition = viewFrustum.getPosition();
+    quint64 recentlyChanged = usecTimestampNow() - RECENT_CHANGE_USECS;
+
+    nodeData->elementBag.setPriorityFunction([eyePosition, recentlyChanged](const OctreeElement& element) {
+        // about the solid angle the element covers
+        const AACube& cube = element.getAACube();
+        glm::vec3 offset = cube.calcCenter() - eyePosition;
+        float priority = cube.getScale() * cube.getScale() / std::max(glm::dot(offset, offset), EPSILON);
+        if (element.getLastChanged() > recentlyChanged) {
+            priority *= RECENT_CHANGE_PRIORITY_BOOST;
+        }
+        return priority;
+    });
+}
+
+void OctreeSendThread::updateBytesPerInterval(OctreeQueryNode* nodeData) {
+    int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxQueryPacketsPerSecond() / INTERVALS_PER_SECOND));
+    int maxPacketsPerInterval = std::min(clientMaxPacketsPerInterval, _myServer->getPacketsPerClientPerInterval());
+    int maxBytesPerInterval = std::max(MIN_BYTES_PER_INTERVAL, maxPacketsPerInterval * udt::MAX_PACKET_SIZE);
+
+    if (nodeData->takeNackPacketsReceived() > 0) {
+        _bytesPerInterval = std::max(MIN_BYTES_PER_INTERVAL, std::min(_bytesPerInterval, maxBytesPerInterval) / 2);
+    } else if (_trueBytesSent >= _bytesPerInterval) {
+        _bytesPerInterval = std::min(_bytesPerInterval, maxBytesPerInterval - BYTES_PER_INTERVAL_INCREASE) +
+            BYTES_PER_INTERVAL_INCREASE;
     }
+    _bytesPerInterval = std::min(_bytesPerInterval, maxBytesPerInterval);
 }
@@ -15,11 +15,14 @@
 #define hifi_OctreeSendThread_h
 
 #include <atomic>
+#include <climits>
+#include <deque>
 
 #include <GenericThread.h>
 #include <Node.h>
 #include <OctreePacketData.h>
 
+class EncodeBitstreamParams;
 class OctreeQueryNode;
 class OctreeServer;
 
@@ -62,14 +65,34 @@ private:
     int handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, bool dontSuppressDuplicate = false);
     int packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged);
 
+    EncodeBitstreamParams createEncodeParams(OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene);
+
+    // encodes the independent subtrees in the element bag on the worker threads, into _encodedSections
+    void encodeSubtreesInParallel(OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene);
+    void sendEncodedSections(SharedNodePointer node, OctreeQueryNode* nodeData, int maxPacketsPerInterval);
+    bool hasSceneToSend(OctreeQueryNode* nodeData);
+
+    // orders the element bag so that what the client sees largest is sent first
+    void prioritizeElementBag(OctreeQueryNode* nodeData);
+
+    // adjusts the bytes sent per interval to what the client seems to take, from the bytes sent in the last one
+    void updateBytesPerInterval(OctreeQueryNode* nodeData);
+    bool canSendMoreThisInterval(int maxPacketsPerInterval) const {
+        return _packetsSentThisInterval < maxPacketsPerInterval && _trueBytesSent < _bytesPerInterval;
+    }
+
 
     QUuid _nodeUuid;
 
     OctreePacketData _packetData;
 
+    std::deque<QByteArray> _encodedSections; // finalized OctreePacketData from encodeSubtreesInParallel(), in send order
+    int _sectionTargetSize { MAX_OCTREE_PACKET_DATA_SIZE };
+
     int _truePacketsSent { 0 }; // available for debug stats
     int _trueBytesSent { 0 }; // available for debug stats
     int _packetsSentThisInterval { 0 }; // used for bandwidth throttle condition
+    int _bytesPerInterval { INT_MAX }; // the estimate of what the client can take, also a throttle condition
     bool _isShuttingDown { false };
 };
 
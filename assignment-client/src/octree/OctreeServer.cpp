@@ -372,6 +372,13 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             statsString += getFileLoadTime();
             statsString += "\r\n";
 
+            if (_persistThread) {
+                const float USECS_PER_MSEC = 1000.0f;
+                statsString += QString().sprintf("Persist tree lock held: %.2f msecs last save, %.2f msecs max\r\n",
+                    _persistThread->getLastPersistLockTime() / USECS_PER_MSEC,
+                    _persistThread->getMaxPersistLockTime() / USECS_PER_MSEC);
+            }
+
             if (_persistFileDownload) {
                 statsString += QString("Persist file: <a href='%1'>Click to Download</a>\r\n").arg(PERSIST_FILE_DOWNLOAD_PATH);
             } else {
@@ -751,6 +758,10 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                 .arg(locale.toString((uint)averageProcessTimePerElement).rightJustified(COLUMN_WIDTH, ' '));
             statsString += QString("      Average Wait Lock Time/Element: %1 usecs\r\n")
                 .arg(locale.toString((uint)averageLockWaitTimePerElement).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString().sprintf("          Average Decode Queue Depth: %f packets\r\n",
+                                             (double)senderStats.getAverageDecodeQueueDepth());
+            statsString += QString().sprintf("           Average Apply Queue Depth: %f packets\r\n",
+                                             (double)senderStats.getAverageApplyQueueDepth());
 
             statsString += QString("\r\n       Inbound Edit Packets --------------------------------\r\n");
             statsString += QString("                            Received: %1\r\n")
@@ -1084,6 +1095,16 @@ void OctreeServer::readConfiguration() {
 
         if (hasRoot || hasEndNodes) {
             _jurisdiction = new JurisdictionMap(qPrintable(jurisdictionRoot), qPrintable(jurisdictionEndNodes));
+        } else {
+            // or, given in the payload of each assignment, which of the servers splitting the tree this one is
+            int jurisdictionPartitionIndex;
+            int jurisdictionPartitionCount;
+            if (readOptionInt(QString("jurisdictionPartitionIndex"), settingsSectionObject, jurisdictionPartitionIndex) &&
+                readOptionInt(QString("jurisdictionPartitionCount"), settingsSectionObject, jurisdictionPartitionCount)) {
+                qDebug() << "jurisdictionPartition=" << jurisdictionPartitionIndex << "of" << jurisdictionPartitionCount;
+                _jurisdiction = new JurisdictionMap(jurisdictionPartitionIndex, jurisdictionPartitionCount,
+                                                    getMyNodeType());
+            }
         }
     }
 
@@ -1099,6 +1120,11 @@ void OctreeServer::readConfiguration() {
     readOptionBool(QString("debugTimestampNow"), settingsSectionObject, _debugTimestampNow);
     qDebug() << "debugTimestampNow=" << _debugTimestampNow;
 
+    bool noParallelSceneEncode;
+    readOptionBool(QString("NoParallelSceneEncode"), settingsSectionObject, noParallelSceneEncode);
+    _parallelSceneEncode = !noParallelSceneEncode;
+    qDebug() << "parallelSceneEncode=" << _parallelSceneEncode;
+
     bool noPersist;
     readOptionBool(QString("NoPersist"), settingsSectionObject, noPersist);
     _wantPersist = !noPersist;
@@ -1112,7 +1138,10 @@ void OctreeServer::readConfiguration() {
 
         qDebug() << "persistFilePath=" << _persistFilePath;
 
-        _persistAsFileType = "json.gz";
+        bool persistAsBinary;
+        readOptionBool(QString("persistAsBinary"), settingsSectionObject, persistAsBinary);
+        _persistAsFileType = persistAsBinary ? "bin" : "json.gz";
+        qDebug() << "persistAsFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
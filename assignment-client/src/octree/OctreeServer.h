@@ -42,6 +42,7 @@ public:
     bool wantsDebugSending() const { return _debugSending; }
     bool wantsDebugReceiving() const { return _debugReceiving; }
     bool wantsVerboseDebug() const { return _verboseDebug; }
+    bool wantsParallelSceneEncode() const { return _parallelSceneEncode; }
 
     OctreePointer getOctree() { return _tree; }
     JurisdictionMap* getJurisdiction() { return _jurisdiction; }
@@ -184,6 +185,7 @@ protected:
     bool _debugReceiving;
     bool _debugTimestampNow;
     bool _verboseDebug;
+    bool _parallelSceneEncode { true };
     JurisdictionMap* _jurisdiction;
     JurisdictionSender* _jurisdictionSender;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
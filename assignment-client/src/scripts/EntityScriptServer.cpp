@@ -11,6 +11,7 @@
 
 #include "EntityScriptServer.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include <AudioConstants.h>
@@ -50,7 +51,13 @@ void messageHandler(QtMsgType type, const QMessageLogContext& context, const QSt
 
 int EntityScriptServer::_entitiesScriptEngineCount = 0;
 
-EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssignment(message) {
+static const int DEFAULT_ENTITY_SCRIPT_ENGINES = 1;
+static const int MAX_ENTITY_SCRIPT_ENGINES = 16;
+
+EntityScriptServer::EntityScriptServer(ReceivedMessage& message) :
+    ThreadedAssignment(message),
+    _numEntitiesScriptEngines(DEFAULT_ENTITY_SCRIPT_ENGINES) {
+
     qInstallMessageHandler(messageHandler);
 
     DependencyManager::get<EntityScriptingInterface>()->setPacketSender(&_entityEditSender);
@@ -105,9 +112,10 @@ void EntityScriptServer::handleReloadEntityServerScriptPacket(QSharedPointer<Rec
     if (senderNode->getCanRez() || senderNode->getCanRezTmp()) {
         auto entityID = QUuid::fromRfc4122(message->read(NUM_BYTES_RFC4122_UUID));
 
-        if (_entityViewer.getTree() && !_shuttingDown) {
+        auto engine = getEntitiesScriptEngine(entityID);
+        if (_entityViewer.getTree() && !_shuttingDown && engine) {
             qCDebug(entity_script_server) << "Reloading: " << entityID;
-            _entitiesScriptEngine->unloadEntityScript(entityID);
+            engine->unloadEntityScript(entityID);
             checkAndCallPreload(entityID, true);
         }
     }
@@ -125,7 +133,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto engine = getEntitiesScriptEngine(entityID);
+        if (engine && engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -154,6 +163,35 @@ void EntityScriptServer::handleSettings() {
 
     auto entityScriptServerSettings = settingsObject[ENTITY_SCRIPT_SERVER_SETTINGS_KEY].toObject();
 
+    static const QString SCRIPT_ENGINE_THREADS_OPTION = "script_engine_threads";
+    static const QString MAX_SCRIPT_USECS_PER_SECOND_OPTION = "max_script_usecs_per_second";
+
+    _maxScriptUsecsPerSecond = std::max(0, entityScriptServerSettings[MAX_SCRIPT_USECS_PER_SECOND_OPTION].toInt(0));
+
+    int numEntitiesScriptEngines = entityScriptServerSettings[SCRIPT_ENGINE_THREADS_OPTION].toInt(DEFAULT_ENTITY_SCRIPT_ENGINES);
+    numEntitiesScriptEngines = std::max(1, std::min(numEntitiesScriptEngines, MAX_ENTITY_SCRIPT_ENGINES));
+    if (numEntitiesScriptEngines != _numEntitiesScriptEngines) {
+        qDebug() << QString("Received entity script server settings, Script Engine Threads: %1").arg(numEntitiesScriptEngines);
+        _numEntitiesScriptEngines = numEntitiesScriptEngines;
+
+        // move the running entity scripts over to the new engines
+        if (!_entitiesScriptEngines.empty() && !_shuttingDown) {
+            stopEntitiesScriptEngines();
+            resetEntitiesScriptEngines();
+
+            auto tree = _entityViewer.getTree();
+            if (tree) {
+                QVector<EntityItemID> entityIDs;
+                tree->forEachEntity([&](const EntityItemPointer& entity) {
+                    entityIDs.push_back(entity->getEntityItemID());
+                });
+                for (const auto& entityID : entityIDs) {
+                    checkAndCallPreload(entityID);
+                }
+            }
+        }
+    }
+
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
 
@@ -170,7 +208,10 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = 0;
+    for (const auto& engine : _entitiesScriptEngines) {
+        numRunningScripts += engine->getNumRunningEntityScripts();
+    }
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplaction would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -253,8 +294,8 @@ void EntityScriptServer::run() {
         NodeType::EntityServer, NodeType::MessagesMixer, NodeType::AssetServer
     });
 
-    // Setup Script Engine
-    resetEntitiesScriptEngine();
+    // Setup Script Engines
+    resetEntitiesScriptEngines();
 
     // we need to make sure that init has been called for our EntityScriptingInterface
     // so that it actually has a jurisdiction listener when we ask it for it next
@@ -413,7 +454,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+QSharedPointer<ScriptEngine> EntityScriptServer::createEntitiesScriptEngine(bool updatesEntityTree) {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = QSharedPointer<ScriptEngine>(new ScriptEngine(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName),
                                                   &ScriptEngine::deleteLater);
@@ -430,40 +471,88 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
-        _entityViewer.queryOctree();
-        _entityViewer.getTree()->update();
-    });
-
+    // the tree is queried and updated once per frame, by the first engine
+    if (updatesEntityTree) {
+        connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+            _entityViewer.queryOctree();
+            _entityViewer.getTree()->update();
+        });
+    }
 
     newEngine->runInThread();
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngine.data());
 
-    disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
+    return newEngine;
 }
 
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    // nothing calls into the old engines once they are swapped out
+    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
+    entityScriptingInterface->setEntitiesScriptEngine(nullptr);
 
-void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
+    std::vector<QSharedPointer<ScriptEngine>> newEngines;
+    for (int i = 0; i < _numEntitiesScriptEngines; i++) {
+        newEngines.push_back(createEntitiesScriptEngine(i == 0));
+    }
+
+    for (const auto& engine : _entitiesScriptEngines) {
+        disconnect(engine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
+    }
+    _entitiesScriptEngines.swap(newEngines);
+    for (const auto& engine : _entitiesScriptEngines) {
+        connect(engine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
+    }
+
+    entityScriptingInterface->setEntitiesScriptEngine(this);
+}
+
+void EntityScriptServer::stopEntitiesScriptEngines() {
+    for (const auto& engine : _entitiesScriptEngines) {
         // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
+        engine->unloadAllEntityScripts();
+        engine->stop();
+    }
+}
+
+ScriptEngine* EntityScriptServer::getEntitiesScriptEngine(const EntityItemID& entityID) const {
+    if (_entitiesScriptEngines.empty()) {
+        return nullptr;
     }
+    return _entitiesScriptEngines[qHash(entityID) % _entitiesScriptEngines.size()].data();
+}
+
+void EntityScriptServer::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                const QStringList& params) {
+    // EntityScriptingInterface holds its engine lock while calling this, so the engines can't be swapped out meanwhile
+    auto engine = getEntitiesScriptEngine(entityID);
+    if (engine) {
+        engine->callEntityScriptMethod(entityID, methodName, params);
+    }
+}
+
+QFuture<QVariant> EntityScriptServer::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    auto engine = getEntitiesScriptEngine(entityID);
+    if (engine) {
+        return engine->getLocalEntityScriptDetails(entityID);
+    }
+    return QFuture<QVariant>();
+}
+
+
+void EntityScriptServer::clear() {
+    // unload and stop the engines
+    stopEntitiesScriptEngines();
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    for (const auto& engine : _entitiesScriptEngines) {
+        engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
@@ -475,37 +564,102 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    auto engine = getEntitiesScriptEngine(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
+        engine->unloadEntityScript(entityID, true);
     }
 }
 
 void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID, bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    auto engine = getEntitiesScriptEngine(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
+        engine->unloadEntityScript(entityID, true);
         checkAndCallPreload(entityID, reload);
     }
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    auto engine = getEntitiesScriptEngine(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
         EntityScriptDetails details;
-        bool notRunning = !_entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        bool notRunning = !engine->getEntityScriptDetails(entityID, details);
         if (entity && (reload || notRunning || details.scriptText != entity->getServerScripts())) {
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
                 qCDebug(entity_script_server) << "Loading entity server script" << scriptUrl << "for" << entityID;
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload);
+                engine->loadEntityScript(entityID, scriptUrl, reload);
             }
         }
     }
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    static const int MAX_REPORTED_ENTITY_SCRIPTS = 10;
+
+    quint64 now = usecTimestampNow();
+    float secondsSinceLastStats = _lastStatsTime > 0 ? (float)(now - _lastStatsTime) / USECS_PER_SECOND : 1.0f;
+    _lastStatsTime = now;
+    if (secondsSinceLastStats <= 0.0f) {
+        return;
+    }
+
+    struct ScriptStats {
+        EntityItemID entityID;
+        EntityScriptStats stats;
+        QString engineName;
+    };
+    std::vector<ScriptStats> scriptStats;
+    QSet<EntityItemID> throttledEntityScripts;
+    quint64 totalCallUsecs = 0;
+
+    for (const auto& engine : _entitiesScriptEngines) {
+        auto engineStats = engine->takeEntityScriptStats();
+        QSet<EntityItemID> engineThrottledEntityScripts;
+        for (auto it = engineStats.cbegin(); it != engineStats.cend(); ++it) {
+            float usecsPerSecond = (float)it.value().callUsecs / secondsSinceLastStats;
+            if (_maxScriptUsecsPerSecond > 0 && usecsPerSecond > (float)_maxScriptUsecsPerSecond) {
+                engineThrottledEntityScripts.insert(it.key());
+                if (!_throttledEntityScripts.contains(it.key())) {
+                    qCWarning(entity_script_server) << "Throttling the timers of" << it.key() << "which runs for"
+                        << (int)usecsPerSecond << "us per second";
+                }
+            }
+            totalCallUsecs += it.value().callUsecs;
+            scriptStats.push_back({ it.key(), it.value(), engine->getFilename() });
+        }
+        engine->setThrottledEntityScripts(engineThrottledEntityScripts);
+        throttledEntityScripts += engineThrottledEntityScripts;
+    }
+    _throttledEntityScripts = throttledEntityScripts;
+
+    // only the entity scripts that took the most time
+    auto reportedEnd = scriptStats.begin() + std::min((int)scriptStats.size(), MAX_REPORTED_ENTITY_SCRIPTS);
+    std::partial_sort(scriptStats.begin(), reportedEnd, scriptStats.end(), [](const ScriptStats& a, const ScriptStats& b) {
+        return a.stats.callUsecs > b.stats.callUsecs;
+    });
+
+    QJsonObject entityScriptsStats;
+    for (auto it = scriptStats.begin(); it != reportedEnd; ++it) {
+        QJsonObject entityScriptStats;
+        entityScriptStats["engine"] = it->engineName;
+        entityScriptStats["us_per_s"] = (qint64)((float)it->stats.callUsecs / secondsSinceLastStats);
+        entityScriptStats["calls_per_s"] = (float)it->stats.numCalls / secondsSinceLastStats;
+        entityScriptStats["allocated_bytes_per_s"] = (qint64)((float)it->stats.allocatedBytes / secondsSinceLastStats);
+        entityScriptStats["throttled"] = throttledEntityScripts.contains(it->entityID);
+        entityScriptsStats[it->entityID.toString()] = entityScriptStats;
+    }
+
+    QJsonObject statsObject;
+    statsObject["script_engines"] = (int)_entitiesScriptEngines.size();
+    statsObject["active_entity_scripts"] = (int)scriptStats.size();
+    statsObject["throttled_entity_scripts"] = throttledEntityScripts.size();
+    statsObject["entity_scripts_us_per_s"] = (qint64)((float)totalCallUsecs / secondsSinceLastStats);
+    statsObject["busiest_entity_scripts"] = entityScriptsStats;
 
+    addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -24,7 +24,9 @@
 #include <ThreadedAssignment.h>
 #include "../entities/EntityTreeHeadlessViewer.h"
 
-class EntityScriptServer : public ThreadedAssignment {
+// The entity scripts are spread over several script engines, each on its own thread.  An entity always runs its
+// script on the same engine, picked from its ID, and calls to entity scripts are routed to the engine running them.
+class EntityScriptServer : public ThreadedAssignment, public EntitiesScriptEngineProvider {
     Q_OBJECT
 
 public:
@@ -33,6 +35,11 @@ public:
 
     virtual void aboutToFinish() override;
 
+    // EntitiesScriptEngineProvider
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params = QStringList()) override;
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
 public slots:
     void run() override;
     void nodeActivated(SharedNodePointer activatedNode);
@@ -58,7 +65,10 @@ private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    QSharedPointer<ScriptEngine> createEntitiesScriptEngine(bool updatesEntityTree);
+    void resetEntitiesScriptEngines();
+    void stopEntitiesScriptEngines();
+    ScriptEngine* getEntitiesScriptEngine(const EntityItemID& entityID) const;
     void clear();
     void shutdownScriptEngine();
 
@@ -72,13 +82,18 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    QSharedPointer<ScriptEngine> _entitiesScriptEngine;
+    int _numEntitiesScriptEngines;
+    std::vector<QSharedPointer<ScriptEngine>> _entitiesScriptEngines;
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
     int _maxEntityPPS { DEFAULT_MAX_ENTITY_PPS };
     int _entityPPSPerScript { DEFAULT_ENTITY_PPS_PER_SCRIPT };
 
+    int _maxScriptUsecsPerSecond { 0 }; // the entity scripts above it are throttled, 0 doesn't throttle
+    QSet<EntityItemID> _throttledEntityScripts;
+    quint64 _lastStatsTime { 0 };
+
     std::set<QUuid> _logListeners;
     std::vector<std::pair<QUuid, quint64>> _killedListeners;
 
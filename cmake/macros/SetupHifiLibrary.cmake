@@ -52,6 +52,14 @@ macro(SETUP_HIFI_LIBRARY)
     endif()
   endforeach()
 
+  # add compiler flags to NEON source files (NEON is always enabled on AArch64)
+  file(GLOB_RECURSE NEON_SRCS "src/neon/*.cpp" "src/neon/*.c")
+  foreach(SRC ${NEON_SRCS})
+    if (CMAKE_SYSTEM_PROCESSOR MATCHES "^arm" AND NOT CMAKE_SYSTEM_PROCESSOR MATCHES "^arm64")
+      set_source_files_properties(${SRC} PROPERTIES COMPILE_FLAGS -mfpu=neon)
+    endif()
+  endforeach()
+
   setup_memory_debugger()
 
   # create a library and set the property so it can be referenced later
@@ -23,10 +23,17 @@
 
 using SharedAssignmentPointer = QSharedPointer<Assignment>;
 
+// during a connection storm, agents are admitted at up to 500 per second and at most a few seconds worth of them
+// wait in the queue, the others are told when to retry instead of timing out
+const int ADMISSION_INTERVAL_MSECS = 10;
+const int MAX_ADMISSIONS_PER_INTERVAL = 5;
+const int MAX_QUEUED_CONNECT_REQUESTS = 1000;
+
 DomainGatekeeper::DomainGatekeeper(DomainServer* server) :
     _server(server)
 {
-
+    _admissionTimer.setInterval(ADMISSION_INTERVAL_MSECS);
+    connect(&_admissionTimer, &QTimer::timeout, this, &DomainGatekeeper::admitQueuedConnectRequests);
 }
 
 void DomainGatekeeper::addPendingAssignedNode(const QUuid& nodeUUID, const QUuid& assignmentUUID,
@@ -83,31 +90,77 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
     // check if this connect request matches an assignment in the queue
     auto pendingAssignment = _pendingAssignedNodes.find(nodeConnection.connectUUID);
 
-    SharedNodePointer node;
-
     if (pendingAssignment != _pendingAssignedNodes.end()) {
-        node = processAssignmentConnectRequest(nodeConnection, pendingAssignment->second);
+        // assignments are few and expected, they don't wait behind the agents
+        SharedNodePointer node = processAssignmentConnectRequest(nodeConnection, pendingAssignment->second);
+        finishConnectRequest(node, nodeConnection);
     } else if (!STATICALLY_ASSIGNED_NODES.contains(nodeConnection.nodeType)) {
-        QString username;
-        QByteArray usernameSignature;
+        QueuedConnectRequest request { nodeConnection, QString(), QByteArray() };
 
         if (message->getBytesLeftToRead() > 0) {
             // read username from packet
-            packetStream >> username;
+            packetStream >> request.username;
 
             if (message->getBytesLeftToRead() > 0) {
                 // read user signature from packet
-                packetStream >> usernameSignature;
+                packetStream >> request.usernameSignature;
             }
         }
 
-        node = processAgentConnectRequest(nodeConnection, username, usernameSignature);
+        queueAgentConnectRequest(request);
+    } else {
+        finishConnectRequest(SharedNodePointer(), nodeConnection);
+    }
+}
+
+void DomainGatekeeper::queueAgentConnectRequest(const QueuedConnectRequest& request) {
+    const HifiSockAddr& senderSockAddr = request.nodeConnection.senderSockAddr;
+
+    auto queuedRequest = _queuedConnectRequests.find(senderSockAddr);
+    if (queuedRequest != _queuedConnectRequests.end()) {
+        // a retry of a request that is still waiting, it keeps its place with the latest data
+        queuedRequest.value() = request;
+        return;
+    }
+
+    if (_connectRequestQueue.size() >= MAX_QUEUED_CONNECT_REQUESTS) {
+        // tell the agent when the queue should have drained instead of letting it retry every check in
+        int retryMsecs = (_connectRequestQueue.size() / MAX_ADMISSIONS_PER_INTERVAL) * ADMISSION_INTERVAL_MSECS;
+        sendConnectionDeniedPacket("The domain is busy admitting other users.", senderSockAddr,
+                                   DomainHandler::ConnectionRefusedReason::Queued, QString::number(retryMsecs));
+        return;
     }
 
+    _queuedConnectRequests.insert(senderSockAddr, request);
+    _connectRequestQueue.enqueue(senderSockAddr);
+
+    if (!_admissionTimer.isActive()) {
+        _admissionTimer.start();
+
+        // admit right away when there is no storm
+        admitQueuedConnectRequests();
+    }
+}
+
+void DomainGatekeeper::admitQueuedConnectRequests() {
+    for (int i = 0; i < MAX_ADMISSIONS_PER_INTERVAL && !_connectRequestQueue.isEmpty(); ++i) {
+        QueuedConnectRequest request = _queuedConnectRequests.take(_connectRequestQueue.dequeue());
+
+        SharedNodePointer node = processAgentConnectRequest(request.nodeConnection, request.username,
+                                                            request.usernameSignature);
+        finishConnectRequest(node, request.nodeConnection);
+    }
+
+    if (_connectRequestQueue.isEmpty()) {
+        _admissionTimer.stop();
+    }
+}
+
+void DomainGatekeeper::finishConnectRequest(const SharedNodePointer& node, const NodeConnectionData& nodeConnection) {
     if (node) {
         // set the sending sock addr and node interest set on this node
         DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-        nodeData->setSendingSockAddr(message->getSenderSockAddr());
+        nodeData->setSendingSockAddr(nodeConnection.senderSockAddr);
 
         // guard against patched agents asking to hear about other agents
         auto safeInterestSet = nodeConnection.interestList.toSet();
@@ -119,14 +172,14 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
         nodeData->setPlaceName(nodeConnection.placeName);
 
         qDebug() << "Allowed connection from node" << uuidStringWithoutCurlyBraces(node->getUUID())
-            << "on" << message->getSenderSockAddr() << "with MAC" << nodeConnection.hardwareAddress
+            << "on" << nodeConnection.senderSockAddr << "with MAC" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
 
         // signal that we just connected a node so the DomainServer can get it a list
         // and broadcast its presence right away
         emit connectedNode(node);
     } else {
-        qDebug() << "Refusing connection from node at" << message->getSenderSockAddr()
+        qDebug() << "Refusing connection from node at" << nodeConnection.senderSockAddr
             << "with hardware address" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
     }
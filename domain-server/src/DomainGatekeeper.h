@@ -17,6 +17,8 @@
 #include <unordered_map>
 
 #include <QtCore/QObject>
+#include <QtCore/QQueue>
+#include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
 
 #include <DomainHandler.h>
@@ -68,7 +70,18 @@ public slots:
 
 private slots:
     void handlePeerPingTimeout();
+    void admitQueuedConnectRequests();
 private:
+    // an agent connect request waiting for its turn to be admitted
+    struct QueuedConnectRequest {
+        NodeConnectionData nodeConnection;
+        QString username;
+        QByteArray usernameSignature;
+    };
+
+    void queueAgentConnectRequest(const QueuedConnectRequest& request);
+    void finishConnectRequest(const SharedNodePointer& node, const NodeConnectionData& nodeConnection);
+
     SharedNodePointer processAssignmentConnectRequest(const NodeConnectionData& nodeConnection,
                                                       const PendingAssignedNodeData& pendingAssignment);
     SharedNodePointer processAgentConnectRequest(const NodeConnectionData& nodeConnection,
@@ -101,6 +114,11 @@ private:
     
     QHash<QString, QUuid> _connectionTokenHash;
 
+    // agent connect requests are admitted a few at a time, the latest request of each sender replacing its previous one
+    QQueue<HifiSockAddr> _connectRequestQueue;
+    QHash<HifiSockAddr, QueuedConnectRequest> _queuedConnectRequests;
+    QTimer _admissionTimer;
+
     // the word "optimistic" below is used for keys that we request during user connection before the user has
     // had a chance to upload a new public key
 
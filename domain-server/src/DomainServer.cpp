@@ -875,6 +875,11 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
 
+    // the version of the last DomainList this node applied, the next one can be a delta on top of it
+    quint32 acknowledgedListVersion = 0;
+    packetStream >> acknowledgedListVersion;
+    nodeData->setAcknowledgedDomainListVersion(acknowledgedListVersion);
+
     sendDomainListToNode(sendingNode, message->getSenderSockAddr());
 }
 
@@ -990,8 +995,12 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     broadcastNewNode(newNode);
 }
 
+// a full list is sent now and then even to a node that is in sync, in case it lost part of a list that spanned packets
+const int MAX_DOMAIN_LIST_DELTAS = 15;
+
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2
+        + 2 * sizeof(quint32);
 
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
@@ -1004,16 +1013,13 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getPermissions();
 
-    auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
-
-    // always send the node their own UUID back
-    QDataStream domainListStream(domainListPackets.get());
-
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
 
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
+    // gather the entry of each node this node should hear about
+    QHash<QUuid, QByteArray> listedNodes;
     if (nodeInterestSet.size() > 0) {
 
         // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
@@ -1021,25 +1027,87 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
             // if this authenticated node has any interest types, send back those nodes as well
             limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
                 if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+                    QByteArray entry;
+                    QDataStream entryStream(&entry, QIODevice::WriteOnly);
 
                     // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+                    entryStream << *otherNode.data();
 
                     // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+                    entryStream << connectionSecretForNodes(node, otherNode);
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
+                    listedNodes.insert(otherNode->getUUID(), entry);
                 }
             });
         }
     }
 
+    // if the node applied the last list we sent, only send what changed since then: the removed nodes first,
+    // then the added nodes and those whose sockets or permissions changed
+    auto& previousNodes = nodeData->getListedNodes();
+    bool sendDelta = nodeData->getDomainListVersion() != 0
+        && nodeData->getAcknowledgedDomainListVersion() == nodeData->getDomainListVersion()
+        && nodeData->getNumDomainListDeltas() < MAX_DOMAIN_LIST_DELTAS;
+
+    QByteArray delta;
+    bool deltaHasChanges = false;
+    if (sendDelta) {
+        QList<QUuid> removedNodes;
+        for (auto it = previousNodes.constBegin(); it != previousNodes.constEnd(); ++it) {
+            if (!listedNodes.contains(it.key())) {
+                removedNodes << it.key();
+            }
+        }
+
+        QDataStream deltaStream(&delta, QIODevice::WriteOnly);
+        deltaStream << (quint16)removedNodes.size();
+        for (const auto& removedNode : removedNodes) {
+            deltaStream << removedNode;
+        }
+        deltaHasChanges = !removedNodes.isEmpty();
+
+        for (auto it = listedNodes.constBegin(); it != listedNodes.constEnd(); ++it) {
+            auto previous = previousNodes.constFind(it.key());
+            if (previous == previousNodes.constEnd() || previous.value() != it.value()) {
+                delta.append(it.value());
+                deltaHasChanges = true;
+            }
+        }
+
+        // a delta has to fit in one packet, so that it is applied whole or not at all
+        if (delta.size() > NLPacket::maxPayloadSize(PacketType::DomainList) - NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES) {
+            sendDelta = false;
+        }
+    }
+
+    // a delta is marked by the version it applies on top of, a full list by a base version of 0
+    quint32 baseVersion = sendDelta ? nodeData->getDomainListVersion() : 0;
+    quint32 listVersion = nodeData->getDomainListVersion();
+    if (!sendDelta || deltaHasChanges) {
+        ++listVersion;
+    }
+    extendedHeaderStream << baseVersion << listVersion;
+
+    auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
+
+    if (sendDelta) {
+        domainListPackets->write(delta);
+    } else {
+        for (const auto& entry : listedNodes) {
+            // each node is a segment, so that it isn't split between two packets
+            domainListPackets->startSegment();
+            domainListPackets->write(entry);
+            domainListPackets->endSegment();
+        }
+    }
+
     // send an empty list to the node, in case there were no other nodes
     domainListPackets->closeCurrentPacket(true);
 
+    nodeData->setDomainListVersion(listVersion);
+    nodeData->setNumDomainListDeltas(sendDelta ? nodeData->getNumDomainListDeltas() + 1 : 0);
+    previousNodes.swap(listedNodes);
+
     // write the PacketList to this node
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
@@ -26,9 +26,32 @@ DomainServerNodeData::DomainServerNodeData() {
 }
 
 void DomainServerNodeData::updateJSONStats(QByteArray statsByteArray) {
-    auto document = QJsonDocument::fromBinaryData(statsByteArray);
-    Q_ASSERT(document.isObject());
-    _statsJSONObject = overrideValuesIfNeeded(document.object());
+    // a flag for a delta, the top level keys that are gone, then the new stats (or the changed top level values)
+    QDataStream statsStream(statsByteArray);
+    quint8 isDelta;
+    QStringList removedKeys;
+    statsStream >> isDelta >> removedKeys;
+    if (statsStream.status() != QDataStream::Ok) {
+        return;
+    }
+
+    auto document = QJsonDocument::fromBinaryData(statsByteArray.mid(statsStream.device()->pos()));
+    if (!document.isObject()) {
+        return;
+    }
+
+    if (!isDelta) {
+        _statsJSONObject = document.object();
+        return;
+    }
+
+    for (const auto& key : removedKeys) {
+        _statsJSONObject.remove(key);
+    }
+    auto changedStats = document.object();
+    for (auto it = changedStats.constBegin(); it != changedStats.constEnd(); ++it) {
+        _statsJSONObject.insert(it.key(), it.value());
+    }
 }
 
 QJsonObject DomainServerNodeData::overrideValuesIfNeeded(const QJsonObject& newStats) {
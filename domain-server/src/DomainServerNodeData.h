@@ -25,7 +25,8 @@ class DomainServerNodeData : public NodeData {
 public:
     DomainServerNodeData();
 
-    const QJsonObject& getStatsJSONObject() const { return _statsJSONObject; }
+    // the stats are only converted, with the overrides, when they are looked at
+    QJsonObject getStatsJSONObject() const { return overrideValuesIfNeeded(_statsJSONObject); }
 
     void updateJSONStats(QByteArray statsByteArray);
 
@@ -68,10 +69,21 @@ public:
 
     bool wasAssigned() const { return _wasAssigned; };
     void setWasAssigned(bool wasAssigned) { _wasAssigned = wasAssigned; }
+
+    // the version of the last DomainList sent to this node (0 before the first), and the last one it applied
+    quint32 getDomainListVersion() const { return _domainListVersion; }
+    void setDomainListVersion(quint32 version) { _domainListVersion = version; }
+    quint32 getAcknowledgedDomainListVersion() const { return _acknowledgedDomainListVersion; }
+    void setAcknowledgedDomainListVersion(quint32 version) { _acknowledgedDomainListVersion = version; }
+
+    // the entries of the nodes in the last DomainList sent to this node, the next one only carries what changed
+    QHash<QUuid, QByteArray>& getListedNodes() { return _listedNodes; }
+    int getNumDomainListDeltas() const { return _numDomainListDeltas; }
+    void setNumDomainListDeltas(int numDeltas) { _numDomainListDeltas = numDeltas; }
     
 private:
-    QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
-    QJsonArray overrideValuesIfNeeded(const QJsonArray& newStats);
+    static QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
+    static QJsonArray overrideValuesIfNeeded(const QJsonArray& newStats);
     
     QHash<QUuid, QUuid> _sessionSecretHash;
     QUuid _assignmentUUID;
@@ -93,6 +105,11 @@ private:
     QString _placeName;
 
     bool _wasAssigned { false };
+
+    quint32 _domainListVersion { 0 };
+    quint32 _acknowledgedDomainListVersion { 0 };
+    QHash<QUuid, QByteArray> _listedNodes;
+    int _numDomainListDeltas { 0 };
 };
 
 #endif // hifi_DomainServerNodeData_h
@@ -27,11 +27,15 @@
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+// one slot per sweep interval, a peer comes around to be checked once it was silent for the threshold
+const size_t NUM_EXPIRY_SLOTS = PEER_SILENCE_THRESHOLD_MSECS / CLEAR_INACTIVE_PEERS_INTERVAL_MSECS + 1;
+
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
     _id(QUuid::createUuid()),
     _serverSocket(0, false),
-    _activePeers()
+    _activePeers(),
+    _expiryWheel(NUM_EXPIRY_SLOTS)
 {
     // start the ice-server socket
     qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
@@ -155,6 +159,13 @@ SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
 
         // update our last heard microstamp for this network peer to now
         matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+
+        // and move it along to the current slot of the expiry wheel
+        auto expirySlot = _peerExpirySlots.find(senderUUID);
+        if (expirySlot == _peerExpirySlots.end() || expirySlot.value() != _expirySlot) {
+            _peerExpirySlots[senderUUID] = _expirySlot;
+            _expiryWheel[_expirySlot].push_back(senderUUID);
+        }
         
         return matchingPeer;
     } else {
@@ -175,6 +186,14 @@ bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& pla
 
             if (rsaPublicKey) {
                 auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+
+                auto verified = _verifiedHeartbeats.find(domainID);
+                if (verified != _verifiedHeartbeats.end()
+                    && verified->second.first == hashedPlaintext && verified->second.second == signature) {
+                    // the same heartbeat as the last one we verified with this key
+                    return true;
+                }
+
                 int verificationResult = RSA_verify(NID_sha256,
                                                     reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
                                                     hashedPlaintext.size(),
@@ -184,6 +203,7 @@ bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& pla
 
                 if (verificationResult == 1) {
                     // this is the only success case - we return true here to indicate that the heartbeat is verified
+                    _verifiedHeartbeats[domainID] = { hashedPlaintext, signature };
                     return true;
                 } else {
                     qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
@@ -254,6 +274,9 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
 
                 if (rsaPublicKey) {
                     _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
+
+                    // what was verified with the previous key no longer holds
+                    _verifiedHeartbeats.erase(domainID);
                 } else {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
@@ -290,22 +313,40 @@ void IceServer::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSoc
 }
 
 void IceServer::clearInactivePeers() {
-    NetworkPeerHash::iterator peerItem = _activePeers.begin();
+    // the slot after the current one holds the peers last heard the longest ago, it becomes the current one
+    _expirySlot = (_expirySlot + 1) % NUM_EXPIRY_SLOTS;
+
+    std::vector<QUuid> expiringPeers;
+    expiringPeers.swap(_expiryWheel[_expirySlot]);
+
+    auto now = usecTimestampNow();
+    for (const auto& peerID : expiringPeers) {
+        auto expirySlot = _peerExpirySlots.find(peerID);
+        if (expirySlot == _peerExpirySlots.end() || expirySlot.value() != _expirySlot) {
+            // removed already, or heard since and moved to a later slot
+            continue;
+        }
 
-    while (peerItem != _activePeers.end()) {
-        SharedNetworkPeer peer = peerItem.value();
+        SharedNetworkPeer peer = _activePeers.value(peerID);
+        if (peer && (now - peer->getLastHeardMicrostamp()) <= (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
+            // heard just within the threshold, check it again on the next turn of the wheel
+            _expiryWheel[_expirySlot].push_back(peerID);
+            continue;
+        }
 
-        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
+        if (peer) {
             qDebug() << "Removing peer from memory for inactivity -" << *peer;
-
-            // if we had a public key for this domain, remove it now
-            _domainPublicKeys.erase(peer->getUUID());
-
-            // remove the peer object
-            peerItem = _activePeers.erase(peerItem);
-        } else {
-            // we didn't kill this peer, push the iterator forwards
-            ++peerItem;
         }
+        removePeer(peerID);
     }
 }
+
+void IceServer::removePeer(const QUuid& peerID) {
+    // if we had a public key for this domain, remove it now
+    _domainPublicKeys.erase(peerID);
+    _verifiedHeartbeats.erase(peerID);
+
+    // remove the peer object
+    _activePeers.remove(peerID);
+    _peerExpirySlots.remove(peerID);
+}
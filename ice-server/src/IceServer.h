@@ -16,6 +16,8 @@
 #include <QtCore/QSharedPointer>
 #include <QUdpSocket>
 
+#include <vector>
+
 #include <openssl/rsa.h>
 
 #include <UUIDHasher.h>
@@ -44,6 +46,7 @@ private:
 
     bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
     void requestDomainPublicKey(const QUuid& domainID);
+    void removePeer(const QUuid& peerID);
 
     QUuid _id;
     udt::Socket _serverSocket;
@@ -51,10 +54,21 @@ private:
     using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
     NetworkPeerHash _activePeers;
 
+    // a timer wheel of the peers by the second they were last heard in, so that expiring them only
+    // looks at the peers heard in the oldest slot instead of the whole table
+    std::vector<std::vector<QUuid>> _expiryWheel;
+    size_t _expirySlot { 0 };
+    QHash<QUuid, size_t> _peerExpirySlots;
+
     using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
     using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
     DomainPublicKeyHash _domainPublicKeys;
 
+    // the hashed plaintext and signature of the last verified heartbeat of each domain - a domain sends the same
+    // heartbeat until its sockets change, so most heartbeats are verified without RSA_verify
+    using VerifiedHeartbeat = std::pair<QByteArray, QByteArray>;
+    std::unordered_map<QUuid, VerifiedHeartbeat> _verifiedHeartbeats;
+
     QSet<QUuid> _pendingPublicKeyRequests;
 };
 
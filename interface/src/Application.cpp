@@ -147,10 +147,12 @@
 #include "CrashHandler.h"
 #include "devices/DdeFaceTracker.h"
 #include "DiscoverabilityManager.h"
+#include "DynamicResolution.h"
 #include "GLCanvas.h"
 #include "InterfaceDynamicFactory.h"
 #include "InterfaceLogging.h"
 #include "LODManager.h"
+#include "MemoryBudget.h"
 #include "ModelPackager.h"
 #include "scripting/Audio.h"
 #include "networking/CloseEventSender.h"
@@ -553,6 +555,8 @@ bool setupEssentials(int& argc, char** argv, bool runningMarkerExisted) {
     DependencyManager::set<UsersScriptingInterface>();
     DependencyManager::set<AvatarManager>();
     DependencyManager::set<LODManager>();
+    DependencyManager::set<DynamicResolution>();
+    DependencyManager::set<MemoryBudget>();
     DependencyManager::set<StandAloneJSConsole>();
     DependencyManager::set<DialogsManager>();
     DependencyManager::set<BandwidthRecorder>();
@@ -664,6 +668,8 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     _lastFaceTrackerUpdate(0),
     _snapshotSound(nullptr)
 {
+    logStartupPhase("Essentials");
+
     auto steamClient = PluginManager::getInstance()->getSteamClientPlugin();
     setProperty(hifi::properties::STEAM, (steamClient && steamClient->isRunning()));
     setProperty(hifi::properties::CRASHED, _previousSessionCrashed);
@@ -955,6 +961,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     QCoreApplication::processEvents();
     _glWidget->createContext();
     _glWidget->makeCurrent();
+    logStartupPhase("Window and services");
 
     initializeGL();
     // Make sure we don't time out during slow operations at startup
@@ -1221,8 +1228,10 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
 
     // Make sure we don't time out during slow operations at startup
     updateHeartbeat();
+    logStartupPhase("Scripts and scripting interfaces");
 
     loadSettings();
+    logStartupPhase("Settings");
 
     // Now that we've loaded the menu and thus switched to the previous display plugin
     // we can unlock the desktop repositioning code, since all the positions will be
@@ -1619,6 +1628,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
 
     connect(this, &Application::applicationStateChanged, this, &Application::activeChanged);
     connect(_window, SIGNAL(windowMinimizedChanged(bool)), this, SLOT(windowMinimizedChanged(bool)));
+    logStartupPhase("Remaining setup");
     qCDebug(interfaceapp, "Startup time: %4.2f seconds.", (double)startupTimer.elapsed() / 1000.0);
 
     {
@@ -1847,6 +1857,7 @@ void Application::cleanupBeforeQuit() {
     // tell the packet receiver we're shutting down, so it can drop packets
     nodeList->getPacketReceiver().setShouldDropPackets(true);
 
+    _resourcePrefetcher.recordManifest(getEntities()->getTree());
     getEntities()->shutdown(); // tell the entities system we're shutting down, so it will stop running scripts
 
     // Clear any queued processing (I/O, FBX/OBJ/Texture parsing)
@@ -1921,7 +1932,7 @@ Application::~Application() {
     _physicsEngine->setCharacterController(nullptr);
 
     // the _shapeManager should have zero references
-    _shapeManager.collectGarbage();
+    _shapeManager.collectAllGarbage();
     assert(_shapeManager.getNumShapes() == 0);
 
     // shutdown render engine
@@ -1941,6 +1952,7 @@ Application::~Application() {
 
 
     DependencyManager::destroy<AvatarManager>();
+    DependencyManager::destroy<MemoryBudget>();
     DependencyManager::destroy<AnimationCache>();
     DependencyManager::destroy<FramebufferCache>();
     DependencyManager::destroy<TextureCache>();
@@ -2007,7 +2019,7 @@ void Application::initializeGL() {
     _glWidget->makeCurrent();
 
     initDisplay();
-    qCDebug(interfaceapp, "Initialized Display.");
+    logStartupPhase("Display");
 
     // Set up the render engine
     render::CullFunctor cullFunctor = LODManager::shouldRender;
@@ -2018,13 +2030,14 @@ void Application::initializeGL() {
     _renderEngine->addJob<RenderViewTask>("RenderMainView", cullFunctor, isDeferred);
     _renderEngine->load();
     _renderEngine->registerScene(_main3DScene);
+    logStartupPhase("Render engine");
 
     // The UI can't be created until the primary OpenGL
     // context is created, because it needs to share
     // texture resources
     // Needs to happen AFTER the render engine initialization to access its configuration
     initializeUi();
-    qCDebug(interfaceapp, "Initialized Offscreen UI.");
+    logStartupPhase("Offscreen UI");
     _glWidget->makeCurrent();
 
 
@@ -2033,7 +2046,7 @@ void Application::initializeGL() {
     _window->setMenuBar(Menu::getInstance());
 
     init();
-    qCDebug(interfaceapp, "init() complete.");
+    logStartupPhase("init()");
 
     // create thread for parsing of octree data independent of the main network and rendering threads
     _octreeProcessor.initialize(_enableProcessOctreeThread);
@@ -2052,6 +2065,13 @@ void Application::initializeGL() {
 
 }
 
+void Application::logStartupPhase(const char* phase) {
+    qint64 now = _sessionRunTimer.elapsed();
+    qCDebug(interfaceapp, "Startup phase %s took %4.2f seconds, %4.2f seconds since startup.", phase,
+        (double)(now - _lastStartupPhaseTime) / MSECS_PER_SECOND, (double)now / MSECS_PER_SECOND);
+    _lastStartupPhaseTime = now;
+}
+
 FrameTimingsScriptingInterface _frameTimingsScriptingInterface;
 
 extern void setupPreferences();
@@ -2217,6 +2237,9 @@ void Application::paintGL() {
     Finally clearFlag([this] { _inPaint = false; });
 
     _frameCount++;
+    if (_frameCount == 1) {
+        logStartupPhase("Waiting for the first frame");
+    }
 
     auto lastPaintBegin = usecTimestampNow();
     PROFILE_RANGE_EX(render, __FUNCTION__, 0xff0000ff, (uint64_t)_frameCount);
@@ -2464,6 +2487,7 @@ void Application::paintGL() {
 
             // Configure the type of display / stereo
             renderArgs._displayMode = (isHMDMode() ? RenderArgs::STEREO_HMD : RenderArgs::STEREO_MONITOR);
+            renderArgs._foveatedRadius = (isHMDMode() ? displayPlugin->getFoveatedRadius() : 0.0f);
         }
         renderArgs._blitFramebuffer = finalFramebuffer;
         displaySide(&renderArgs, _myCamera);
@@ -2494,6 +2518,8 @@ void Application::paintGL() {
 
     uint64_t lastPaintDuration = usecTimestampNow() - lastPaintBegin;
     _frameTimingsScriptingInterface.addValue(lastPaintDuration);
+
+    _frameSpikeCapture.addFrame(lastPaintDuration, _renderEngine, _physicsEngine);
 }
 
 void Application::runTests() {
@@ -2754,6 +2780,8 @@ void Application::handleSandboxStatus(QNetworkReply* reply) {
     });
 
     _connectionMonitor.init();
+    _resourcePrefetcher.init();
+    DependencyManager::get<MemoryBudget>()->init();
 
     // After all of the constructor is completed, then set firstRun to false.
     if (!skipTutorial) {
@@ -4302,7 +4330,17 @@ void Application::init() {
         }
 
         auto distance = glm::distance(getMyAvatar()->getPosition(), item.getPosition());
-        return atan2(maxSize, distance);
+        float priority = atan2(maxSize, distance);
+
+        // anything in view now is loaded before anything that isn't, which is only being prefetched
+        ViewFrustum viewFrustum;
+        copyViewFrustum(viewFrustum);
+        bool success;
+        AACube cube = item.getQueryAACube(success);
+        if (success && !viewFrustum.cubeIntersectsKeyhole(cube)) {
+            priority -= PI_OVER_TWO;
+        }
+        return priority;
     });
 
     ObjectMotionState::setShapeManager(&_shapeManager);
@@ -4343,6 +4381,13 @@ void Application::init() {
 
 void Application::updateLOD() const {
     PerformanceTimer perfTimer("LOD");
+    // the resolution follows the GPU time first, so that the LOD only answers the frames it can rescue
+    auto dynamicResolution = DependencyManager::get<DynamicResolution>();
+    dynamicResolution->setEnabled(Menu::getInstance()->isOptionChecked(MenuOption::RenderResolutionDynamic));
+    if (!isThrottleRendering()) {
+        dynamicResolution->update(getTargetFrameRate(), (float)_gpuContext->getFrameTimerGPUAverage());
+    }
+
     // adjust it unless we were asked to disable this feature, or if we're currently in throttleRendering mode
     if (!isThrottleRendering()) {
         DependencyManager::get<LODManager>()->autoAdjustLOD(_frameCounter.rate());
@@ -4956,6 +5001,7 @@ void Application::update(float deltaTime) {
         {
             PROFILE_RANGE_EX(simulation_physics, "StepSimulation", 0xffff8000, (uint64_t)getActiveDisplayPlugin()->presentCount());
             PerformanceTimer perfTimer("stepSimulation");
+            _physicsEngine->setMultithreaded(Menu::getInstance()->isOptionChecked(MenuOption::PhysicsMultithreaded));
             getEntities()->getTree()->withWriteLock([&] {
                 _physicsEngine->stepSimulation();
             });
@@ -4968,10 +5014,11 @@ void Application::update(float deltaTime) {
                 // we have a better idea of which objects we own or should own.
                 auto& collisionEvents = _physicsEngine->getCollisionEvents();
 
+                const VectorOfMotionStates& outgoingChanges = _physicsEngine->getChangedMotionStates();
+
                 getEntities()->getTree()->withWriteLock([&] {
                     PerformanceTimer perfTimer("handleOutgoingChanges");
 
-                    const VectorOfMotionStates& outgoingChanges = _physicsEngine->getChangedMotionStates();
                     _entitySimulation->handleChangedMotionStates(outgoingChanges);
                     avatarManager->handleChangedMotionStates(outgoingChanges);
 
@@ -5576,7 +5623,8 @@ void Application::clearDomainOctreeDetails() {
         _octreeServerSceneStats.clear();
     });
 
-    // reset the model renderer
+    // remember what this domain uses for the next time we go there, then reset the model renderer
+    _resourcePrefetcher.recordManifest(getEntities()->getTree());
     getEntities()->clear();
 
     auto skyStage = DependencyManager::get<SceneScriptingInterface>()->getSkyStage();
@@ -5908,6 +5956,8 @@ void Application::registerScriptEngineWithApplicationServices(ScriptEngine* scri
     scriptEngine->registerGlobalObject("UndoStack", &_undoStackScriptingInterface);
 
     scriptEngine->registerGlobalObject("LODManager", DependencyManager::get<LODManager>().data());
+    scriptEngine->registerGlobalObject("DynamicResolution", DependencyManager::get<DynamicResolution>().data());
+    scriptEngine->registerGlobalObject("MemoryBudget", DependencyManager::get<MemoryBudget>().data());
 
     scriptEngine->registerGlobalObject("Paths", DependencyManager::get<PathUtils>().data());
 
@@ -6830,6 +6880,8 @@ float Application::getRenderResolutionScale() const {
         return 0.333f;
     } else if (Menu::getInstance()->isOptionChecked(MenuOption::RenderResolutionQuarter)) {
         return 0.25f;
+    } else if (Menu::getInstance()->isOptionChecked(MenuOption::RenderResolutionDynamic)) {
+        return DependencyManager::get<DynamicResolution>()->getScale();
     } else {
         return 1.0f;
     }
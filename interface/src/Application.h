@@ -54,7 +54,9 @@
 #include "avatar/MyAvatar.h"
 #include "BandwidthRecorder.h"
 #include "FancyCamera.h"
+#include "FrameSpikeCapture.h"
 #include "ConnectionMonitor.h"
+#include "networking/ResourcePrefetcher.h"
 #include "CursorManager.h"
 #include "gpu/Context.h"
 #include "Menu.h"
@@ -512,8 +514,12 @@ private:
     void maybeToggleMenuVisible(QMouseEvent* event) const;
     void toggleTabletUI(bool shouldOpen = false) const;
 
+    // logs how long a phase of startup took, and how long it has been since startup began
+    void logStartupPhase(const char* phase);
+
     MainWindow* _window;
     QElapsedTimer& _sessionRunTimer;
+    qint64 _lastStartupPhaseTime { 0 };
 
     bool _previousSessionCrashed;
 
@@ -529,6 +535,7 @@ private:
     UndoStackScriptingInterface _undoStackScriptingInterface;
 
     uint32_t _frameCount { 0 };
+    FrameSpikeCapture _frameSpikeCapture;
 
     // Frame Rate Measurement
     RateCounter<> _frameCounter;
@@ -665,6 +672,7 @@ private:
     QString _returnFromFullScreenMirrorTo;
 
     ConnectionMonitor _connectionMonitor;
+    ResourcePrefetcher _resourcePrefetcher;
 
     model::SkyboxPointer _defaultSkybox { new ProceduralSkybox() } ;
     gpu::TexturePointer _defaultSkyboxTexture;
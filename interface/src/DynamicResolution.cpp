@@ -0,0 +1,95 @@
+//
+//  DynamicResolution.cpp
+//  interface/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DynamicResolution.h"
+
+#include <glm/glm.hpp>
+
+#include <NumericalConstants.h>
+#include <SettingHandle.h>
+#include <SharedUtil.h>
+
+#include "InterfaceLogging.h"
+
+static const float DEFAULT_MIN_SCALE = 0.5f;
+static const float DEFAULT_MAX_SCALE = 1.0f;
+static const float MIN_SCALE = 0.25f;
+
+// Each step changes the pixel count by about 10%
+static const float SCALE_STEP = 0.05f;
+
+// The GPU is bound above this part of the frame budget, and has room for a step up below the lower one
+static const float GPU_BOUND_BUDGET = 0.9f;
+static const float GPU_HEADROOM_BUDGET = 0.7f;
+
+// Going down is quick to rescue the frame rate, going up is slower so that the scale does not oscillate
+static const quint64 DOWN_STEP_INTERVAL = USECS_PER_SECOND / 4;
+static const quint64 UP_STEP_INTERVAL = USECS_PER_SECOND * 2;
+
+Setting::Handle<float> dynamicResolutionMinScale("dynamicResolutionMinScale", DEFAULT_MIN_SCALE);
+Setting::Handle<float> dynamicResolutionMaxScale("dynamicResolutionMaxScale", DEFAULT_MAX_SCALE);
+
+void DynamicResolution::setEnabled(bool enabled) {
+    if (_enabled != enabled) {
+        _enabled = enabled;
+        _scale = getMaxScale();
+        _isGPUBound = false;
+        emit scaleChanged(_scale);
+    }
+}
+
+void DynamicResolution::setMinScale(float minScale) {
+    dynamicResolutionMinScale.set(glm::clamp(minScale, MIN_SCALE, 1.0f));
+}
+
+float DynamicResolution::getMinScale() const {
+    return glm::clamp(dynamicResolutionMinScale.get(), MIN_SCALE, 1.0f);
+}
+
+void DynamicResolution::setMaxScale(float maxScale) {
+    dynamicResolutionMaxScale.set(glm::clamp(maxScale, MIN_SCALE, 1.0f));
+}
+
+float DynamicResolution::getMaxScale() const {
+    return glm::clamp(dynamicResolutionMaxScale.get(), getMinScale(), 1.0f);
+}
+
+void DynamicResolution::update(float targetFrameRate, float gpuFrameTime) {
+    if (!_enabled || targetFrameRate <= 0.0f || gpuFrameTime <= 0.0f) {
+        return;
+    }
+
+    float frameBudget = (float)MSECS_PER_SECOND / targetFrameRate;
+    float minScale = getMinScale();
+    float maxScale = getMaxScale();
+    _isGPUBound = gpuFrameTime > GPU_BOUND_BUDGET * frameBudget;
+
+    quint64 now = usecTimestampNow();
+    quint64 elapsed = now - _lastAdjustment;
+    float scale = _scale;
+    if (_isGPUBound && elapsed > DOWN_STEP_INTERVAL) {
+        scale -= SCALE_STEP;
+    } else if (gpuFrameTime < GPU_HEADROOM_BUDGET * frameBudget && elapsed > UP_STEP_INTERVAL) {
+        scale += SCALE_STEP;
+    }
+    scale = glm::clamp(scale, minScale, maxScale);
+
+    if (scale != _scale) {
+        qCDebug(interfaceapp) << "DynamicResolution: GPU frame time" << gpuFrameTime << "ms for a budget of"
+            << frameBudget << "ms, scaling the resolution to" << scale;
+        _scale = scale;
+        _lastAdjustment = now;
+        emit scaleChanged(_scale);
+    }
+}
+
+bool DynamicResolution::isHandlingGPULoad() const {
+    return _enabled && _isGPUBound && _scale > getMinScale();
+}
@@ -0,0 +1,58 @@
+//
+//  DynamicResolution.h
+//  interface/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DynamicResolution_h
+#define hifi_DynamicResolution_h
+
+#include <QtCore/QObject>
+
+#include <DependencyManager.h>
+
+// Scales the render resolution from the GPU frame time, for the frames that are bound by fill rate rather than
+// geometry. The scale moves in steps so that the framebuffers are not reallocated every frame, and while it still
+// can go down the LODManager leaves those frames to it.
+class DynamicResolution : public QObject, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+
+    Q_PROPERTY(float scale READ getScale NOTIFY scaleChanged)
+    Q_PROPERTY(float minScale READ getMinScale WRITE setMinScale)
+    Q_PROPERTY(float maxScale READ getMaxScale WRITE setMaxScale)
+
+public:
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    Q_INVOKABLE void setMinScale(float minScale);
+    Q_INVOKABLE float getMinScale() const;
+    Q_INVOKABLE void setMaxScale(float maxScale);
+    Q_INVOKABLE float getMaxScale() const;
+
+    float getScale() const { return _scale; }
+
+    // targetFrameRate: of the display, gpuFrameTime: average GPU time of the recent frames, in milliseconds
+    void update(float targetFrameRate, float gpuFrameTime);
+
+    // the GPU is the bottleneck and the resolution can still go down
+    bool isHandlingGPULoad() const;
+
+signals:
+    void scaleChanged(float scale);
+
+private:
+    DynamicResolution() {}
+
+    bool _enabled { false };
+    float _scale { 1.0f };
+    bool _isGPUBound { false };
+    quint64 _lastAdjustment { 0 };
+};
+
+#endif // hifi_DynamicResolution_h
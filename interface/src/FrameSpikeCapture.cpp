@@ -0,0 +1,140 @@
+//
+//  FrameSpikeCapture.cpp
+//  interface/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FrameSpikeCapture.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+#include <NumericalConstants.h>
+#include <PerfStat.h>
+#include <ResourceCache.h>
+#include <SharedUtil.h>
+#include <Trace.h>
+
+#include "avatar/AvatarManager.h"
+#include "InterfaceLogging.h"
+
+// enough to see the frames leading up to the spike
+static const size_t NUM_RECENT_FRAMES = 90;
+
+// the trace window spans the frames before the spike, loading hitches come in bursts so they are spaced out
+static const float CAPTURE_TRACE_SECONDS = 2.0f;
+static const uint64_t MIN_USECS_BETWEEN_CAPTURES = 60 * USECS_PER_SECOND;
+
+static const QString CAPTURE_FILE = "traces/spike-{DATE}-{TIME}.json.gz";
+
+static QJsonObject jobTimes(const QObject* config) {
+    QJsonObject job;
+    if (auto jobConfig = qobject_cast<const task::JobConfig*>(config)) {
+        job["cpuRunTime"] = jobConfig->getCPURunTime();
+    }
+    QJsonObject children;
+    for (const auto child : config->children()) {
+        if (qobject_cast<const task::JobConfig*>(child)) {
+            children[child->objectName()] = jobTimes(child);
+        }
+    }
+    if (!children.isEmpty()) {
+        job["jobs"] = children;
+    }
+    return job;
+}
+
+void FrameSpikeCapture::addFrame(uint64_t frameUsecs, const render::EnginePointer& renderEngine,
+                                 const PhysicsEnginePointer& physicsEngine) {
+    _recentFrameUsecs.push_back(frameUsecs);
+    if (_recentFrameUsecs.size() > NUM_RECENT_FRAMES) {
+        _recentFrameUsecs.pop_front();
+    }
+
+    int thresholdMsecs = _thresholdMsecs.get();
+    if (thresholdMsecs <= 0 || frameUsecs < (uint64_t)thresholdMsecs * USECS_PER_MSEC) {
+        return;
+    }
+    auto now = usecTimestampNow();
+    if (_lastCaptureTime != 0 && now - _lastCaptureTime < MIN_USECS_BETWEEN_CAPTURES) {
+        return;
+    }
+    auto tracer = DependencyManager::get<tracing::Tracer>();
+    if (!tracer || !tracer->isRecording()) {
+        return;
+    }
+    _lastCaptureTime = now;
+
+    // the stats are only current on this thread, the trace is serialized and written off it
+    QByteArray stats = QJsonDocument(getStats(frameUsecs, renderEngine, physicsEngine)).toJson(QJsonDocument::Compact);
+    qCDebug(interfaceapp) << "Frame took" << frameUsecs / USECS_PER_MSEC << "ms, saving a capture to" << CAPTURE_FILE;
+    QtConcurrent::run([tracer, stats] {
+        QByteArray data = "{\"traceEvents\":" + tracer->getRecording(CAPTURE_TRACE_SECONDS) + ",\"spike\":" + stats + "}";
+        tracing::Tracer::write(CAPTURE_FILE, data);
+    });
+}
+
+QJsonObject FrameSpikeCapture::getStats(uint64_t frameUsecs, const render::EnginePointer& renderEngine,
+                                        const PhysicsEnginePointer& physicsEngine) const {
+    QJsonObject stats;
+    stats["frameUsecs"] = (double)frameUsecs;
+    stats["thresholdMsecs"] = _thresholdMsecs.get();
+
+    QJsonArray recentFrames;
+    for (auto usecs : _recentFrameUsecs) {
+        recentFrames.append((double)usecs);
+    }
+    stats["recentFrameUsecs"] = recentFrames;
+
+    if (renderEngine) {
+        stats["renderJobs"] = jobTimes(renderEngine->getConfiguration().get());
+    }
+
+    // only kept while the timing details of the stats are displayed
+    if (PerformanceTimer::isActive()) {
+        QJsonObject timers;
+        const auto& records = PerformanceTimer::getAllTimerRecords();
+        for (auto it = records.cbegin(); it != records.cend(); ++it) {
+            timers[it.key()] = QJsonObject {
+                { "averageUsecs", (double)it.value().getMovingAverage() },
+                { "count", (double)it.value().getCount() }
+            };
+        }
+        stats["timers"] = timers;
+    }
+
+    QJsonArray loading;
+    for (const auto& resource : ResourceCache::getLoadingRequests()) {
+        if (resource) {
+            loading.append(QJsonObject {
+                { "url", resource->getURL().toString() },
+                { "bytesReceived", (double)resource->getBytesReceived() },
+                { "bytesTotal", (double)resource->getBytesTotal() }
+            });
+        }
+    }
+    stats["resourcesLoading"] = loading;
+    stats["resourcesPending"] = ResourceCache::getPendingRequestCount();
+
+    if (physicsEngine) {
+        stats["physics"] = QJsonObject {
+            { "substeps", (int)physicsEngine->getNumSubsteps() },
+            { "collisionObjects", physicsEngine->getNumCollisionObjects() },
+            { "contacts", (int)physicsEngine->getNumContacts() }
+        };
+    }
+
+    auto avatarManager = DependencyManager::get<AvatarManager>();
+    stats["avatars"] = QJsonObject {
+        { "count", avatarManager->size() - 1 },
+        { "updated", avatarManager->getNumAvatarsUpdated() },
+        { "notUpdated", avatarManager->getNumAvatarsNotUpdated() }
+    };
+
+    return stats;
+}
@@ -0,0 +1,46 @@
+//
+//  FrameSpikeCapture.h
+//  interface/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FrameSpikeCapture_h
+#define hifi_FrameSpikeCapture_h
+
+#include <stdint.h>
+#include <deque>
+
+#include <QtCore/QJsonObject>
+
+#include <render/Engine.h>
+#include <PhysicsEngine.h>
+#include <SettingHandle.h>
+
+// Saves a capture when a frame takes longer than a threshold, to attach to a bug report: the trace flight recorder
+// around the spike, the last frame times, the render job times, the resources loading and the physics and avatar stats.
+// The capture is a chrome://tracing file with the stats beside the events, written to traces/ in the documents.
+class FrameSpikeCapture {
+public:
+    // called once per frame on the main thread, after the frame was rendered
+    void addFrame(uint64_t frameUsecs, const render::EnginePointer& renderEngine,
+                  const PhysicsEnginePointer& physicsEngine);
+
+    int getThresholdMsecs() const { return _thresholdMsecs.get(); }
+    void setThresholdMsecs(int thresholdMsecs) { _thresholdMsecs.set(thresholdMsecs); }
+
+private:
+    QJsonObject getStats(uint64_t frameUsecs, const render::EnginePointer& renderEngine,
+                         const PhysicsEnginePointer& physicsEngine) const;
+
+    // 0 disables the capture
+    Setting::Handle<int> _thresholdMsecs { "frameSpikeCaptureThresholdMsecs", 100 };
+
+    std::deque<uint64_t> _recentFrameUsecs;
+    uint64_t _lastCaptureTime { 0 };
+};
+
+#endif // hifi_FrameSpikeCapture_h
@@ -14,6 +14,7 @@
 #include <Util.h>
 
 #include "Application.h"
+#include "DynamicResolution.h"
 #include "ui/DialogsManager.h"
 #include "InterfaceLogging.h"
 
@@ -87,6 +88,11 @@ void LODManager::autoAdjustLOD(float currentFPS) {
             doDownShift = (elapsedSinceStableOrUpShift > START_SHIFT_ELPASED 
                                 && _fpsAverageStartWindow.getAverage() < getLODDecreaseFPS());
         }
+
+        // while the dynamic resolution can still lower the GPU load, the slow frames are left to it
+        if (doDownShift && DependencyManager::get<DynamicResolution>()->isHandlingGPULoad()) {
+            doDownShift = false;
+        }
         
         if (doDownShift) {
 
@@ -0,0 +1,111 @@
+//
+//  MemoryBudget.cpp
+//  interface/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MemoryBudget.h"
+
+#include <algorithm>
+
+#include <gpu/Context.h>
+#include <gpu/Texture.h>
+#include <NumericalConstants.h>
+#include <ResourceCache.h>
+#include <SettingHandle.h>
+#include <SharedUtil.h>
+
+#include "InterfaceLogging.h"
+
+static const int UPDATE_INTERVAL_MSECS = 1000;
+
+// when the physical memory is unknown
+static const quint64 DEFAULT_BUDGET = MB_TO_BYTES(4096);
+
+// the textures keep at least their lowest mips, and never get more than the GL backend would allow them anyway
+static const quint64 MIN_ALLOWED_TEXTURE_MEMORY = MB_TO_BYTES(256);
+static const quint64 MAX_ALLOWED_TEXTURE_MEMORY = MB_TO_BYTES(1024);
+
+Setting::Handle<int> memoryBudgetMB("memoryBudgetMB", 0);
+
+MemoryBudget::MemoryBudget() {
+    connect(&_timer, &QTimer::timeout, this, &MemoryBudget::update);
+}
+
+void MemoryBudget::init() {
+    _timer.start(UPDATE_INTERVAL_MSECS);
+}
+
+void MemoryBudget::setBudgetMB(int budgetMB) {
+    budgetMB = std::max(budgetMB, 0);
+    if (budgetMB != memoryBudgetMB.get()) {
+        memoryBudgetMB.set(budgetMB);
+        emit budgetChanged();
+    }
+}
+
+int MemoryBudget::getBudgetMB() const {
+    return memoryBudgetMB.get();
+}
+
+quint64 MemoryBudget::getBudget() const {
+    int budgetMB = memoryBudgetMB.get();
+    if (budgetMB > 0) {
+        return MB_TO_BYTES(budgetMB);
+    }
+
+    MemoryInfo info;
+    if (getMemoryInfo(info) && info.totalMemoryBytes > 0) {
+        return info.totalMemoryBytes / 2;
+    }
+    return DEFAULT_BUDGET;
+}
+
+void MemoryBudget::update() {
+    QVariantMap usage;
+    quint64 cacheSize = 0;
+    for (auto cache : ResourceCache::getCaches()) {
+        QString name = cache->metaObject()->className();
+        quint64 size = (quint64)cache->getSizeTotalResources();
+        usage[name] = usage.value(name).toULongLong() + size;
+        cacheSize += size;
+    }
+    quint64 textureSize = gpu::Context::getTextureGPUMemSize();
+    quint64 bufferSize = gpu::Context::getBufferGPUMemSize();
+    usage["GPUTextures"] = textureSize;
+    usage["GPUBuffers"] = bufferSize;
+
+    quint64 budget = getBudget();
+    quint64 used = cacheSize + textureSize + bufferSize;
+
+    // the unused resources go first, they are only kept in case they are needed again
+    if (used > budget) {
+        qint64 freed = ResourceCache::evictUnusedResources((qint64)(used - budget));
+        if (freed > 0) {
+            qCDebug(interfaceapp) << "MemoryBudget: unloaded" << BYTES_TO_MB(freed) << "MB of unused resources";
+            cacheSize -= std::min(cacheSize, (quint64)freed);
+            used -= std::min(used, (quint64)freed);
+        }
+    }
+
+    // then the textures get what is left, unless a size was chosen in the menu
+    auto allowedTextureMemory = gpu::Texture::getAllowedGPUMemoryUsage();
+    if (allowedTextureMemory == 0 || allowedTextureMemory == _allowedTextureMemory) {
+        quint64 available = budget - std::min(budget, cacheSize + bufferSize);
+        quint64 newAllowedTextureMemory = std::min(std::max(available, MIN_ALLOWED_TEXTURE_MEMORY), MAX_ALLOWED_TEXTURE_MEMORY);
+        if (newAllowedTextureMemory != allowedTextureMemory) {
+            gpu::Texture::setAllowedGPUMemoryUsage(newAllowedTextureMemory);
+        }
+        _allowedTextureMemory = newAllowedTextureMemory;
+    }
+
+    usage["budget"] = budget;
+    usage["used"] = used;
+    _usage = usage;
+    _used = used;
+    emit updated();
+}
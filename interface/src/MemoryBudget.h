@@ -0,0 +1,62 @@
+//
+//  MemoryBudget.h
+//  interface/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MemoryBudget_h
+#define hifi_MemoryBudget_h
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVariantMap>
+
+#include <DependencyManager.h>
+
+// One memory budget for the resource caches and the GPU resources, instead of a size per cache.
+// When the budget is exceeded, the least recently used unused resources of any cache are unloaded first;
+// the GPU textures get what is left of the budget, and the GL backend demotes their least important mips to fit.
+class MemoryBudget : public QObject, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+
+    Q_PROPERTY(quint64 budget READ getBudget NOTIFY budgetChanged)
+    Q_PROPERTY(int budgetMB READ getBudgetMB WRITE setBudgetMB NOTIFY budgetChanged)
+    Q_PROPERTY(quint64 used READ getUsed NOTIFY updated)
+
+public:
+    void init();
+
+    // 0 is automatic: half of the physical memory
+    Q_INVOKABLE void setBudgetMB(int budgetMB);
+    Q_INVOKABLE int getBudgetMB() const;
+
+    quint64 getBudget() const;
+    quint64 getUsed() const { return _used; }
+
+    // the bytes used per resource cache and by the GPU, for telemetry
+    Q_INVOKABLE QVariantMap getUsage() const { return _usage; }
+
+signals:
+    void budgetChanged();
+    void updated();
+
+private slots:
+    void update();
+
+private:
+    MemoryBudget();
+
+    QTimer _timer;
+    quint64 _used { 0 };
+    QVariantMap _usage;
+
+    // the texture memory last allowed by the budget, any other value was chosen in the menu
+    quint64 _allowedTextureMemory { 0 };
+};
+
+#endif // hifi_MemoryBudget_h
@@ -12,6 +12,7 @@
 #include <string>
 
 #include <QScriptEngine>
+#include <QtConcurrent/QtConcurrentMap>
 
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic push
@@ -48,6 +49,9 @@
 const int CLIENT_TO_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 50;
 static const quint64 MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS = USECS_PER_SECOND / CLIENT_TO_AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND;
 
+// Below that many avatars to update, dispatching them to the job pool costs more than it saves
+static const int MIN_CONCURRENTLY_UPDATED_AVATARS = 4;
+
 // We add _myAvatar into the hash with all the other AvatarData, and we use the default NULL QUid as the key.
 const QUuid MY_AVATAR_KEY;  // NULL key
 
@@ -60,7 +64,7 @@ AvatarManager::AvatarManager(QObject* parent) :
 
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "processAvatarDataPacket");
+    packetReceiver.registerDirectListener(PacketType::BulkAvatarData, this, "processAvatarDataPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, this, "processKillAvatar");
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "processAvatarIdentityPacket");
 
@@ -132,10 +136,33 @@ float AvatarManager::getAvatarSimulationRate(const QUuid& sessionID, const QStri
     return avatar ? avatar->getSimulationRate(rateName) : 0.0f;
 }
 
+// How many frames the joints of an avatar wait between updates, from its angular radius.
+// Small on screen, the joints of a crowd mostly go unnoticed.
+static int computeJointsUpdatePeriod(const ViewFrustum& view, const std::shared_ptr<Avatar>& avatar) {
+    const float MIN_DISTANCE = 0.1f;
+    float distance = std::max(glm::distance(view.getPosition(), avatar->getPosition()), MIN_DISTANCE);
+    float angularRadius = avatar->getBoundingRadius() / distance;
+
+    // Roughly an avatar in the 10, 25 and 65 meters
+    const float FULL_RATE_ANGULAR_RADIUS = 0.1f;
+    const float HALF_RATE_ANGULAR_RADIUS = 0.04f;
+    const float QUARTER_RATE_ANGULAR_RADIUS = 0.015f;
+    if (angularRadius >= FULL_RATE_ANGULAR_RADIUS) {
+        return 1;
+    } else if (angularRadius >= HALF_RATE_ANGULAR_RADIUS) {
+        return 2;
+    } else if (angularRadius >= QUARTER_RATE_ANGULAR_RADIUS) {
+        return 4;
+    }
+    return Avatar::MAX_JOINTS_UPDATE_PERIOD;
+}
+
 void AvatarManager::updateOtherAvatars(float deltaTime) {
     // lock the hash for read to check the size
     QReadLocker lock(&_hashLock);
     if (_avatarHash.size() < 2 && _avatarsToFade.isEmpty()) {
+        // don't hold on to avatars that have gone away
+        _sortedAvatars.clear();
         return;
     }
     lock.unlock();
@@ -147,7 +174,8 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     ViewFrustum cameraView;
     qApp->copyDisplayViewFrustum(cameraView);
 
-    std::priority_queue<AvatarPriority> sortedAvatars;
+    // re-sorted from last frame's order, which priorities rarely stray far from
+    auto& sortedAvatars = _sortedAvatars;
     AvatarData::sortAvatars(avatarList, cameraView, sortedAvatars,
 
         [](AvatarSharedPointer avatar)->uint64_t{
@@ -168,15 +196,41 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             return false;
         });
 
+    const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
+
+    // The joints of the avatars in view are copied into their rigs on the job pool first, the rest of the
+    // simulation stays on the main thread. The performance timers are not thread safe, they keep it serial.
+    bool updateConcurrently = !PerformanceTimer::isActive();
+    std::vector<std::shared_ptr<Avatar>> avatarsToUpdate;
+    for (const auto& sortData : sortedAvatars) {
+        if (sortData.priority <= OUT_OF_VIEW_THRESHOLD) {
+            break;
+        }
+        const auto& avatar = std::static_pointer_cast<Avatar>(sortData.avatar);
+        avatar->setJointsUpdatePeriod(computeJointsUpdatePeriod(cameraView, avatar));
+        if (updateConcurrently && avatar->hasNewJointData() && avatar->isJointsUpdateDue()) {
+            avatarsToUpdate.push_back(avatar);
+        }
+    }
+    if (updateConcurrently) {
+        if ((int)avatarsToUpdate.size() >= MIN_CONCURRENTLY_UPDATED_AVATARS) {
+            PROFILE_RANGE(simulation, "updateJoints");
+            QtConcurrent::blockingMap(avatarsToUpdate, [](const std::shared_ptr<Avatar>& avatar) {
+                avatar->updateJointsFromJointData();
+            });
+        }
+    }
+
     uint64_t startTime = usecTimestampNow();
     const uint64_t UPDATE_BUDGET = 2000; // usec
     uint64_t updateExpiry = startTime + UPDATE_BUDGET;
     int numAvatarsUpdated = 0;
     int numAVatarsNotUpdated = 0;
 
+    std::vector<std::shared_ptr<Avatar>> simulatedAvatars;
     render::Transaction transaction;
-    while (!sortedAvatars.empty()) {
-        const AvatarPriority& sortData = sortedAvatars.top();
+    for (auto sortItr = sortedAvatars.begin(); sortItr != sortedAvatars.end(); ++sortItr) {
+        const AvatarPriority& sortData = *sortItr;
         const auto& avatar = std::static_pointer_cast<Avatar>(sortData.avatar);
 
         // for ALL avatars...
@@ -197,7 +251,6 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
         }
         avatar->animateScaleChanges(deltaTime);
 
-        const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
         uint64_t now = usecTimestampNow();
         if (now < updateExpiry) {
             // we're within budget
@@ -208,6 +261,9 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             avatar->simulate(deltaTime, inView);
             avatar->updateRenderItem(transaction);
             avatar->setLastRenderUpdateTime(startTime);
+            if (inView) {
+                simulatedAvatars.push_back(avatar);
+            }
         } else {
             // we've spent our full time budget --> bail on the rest of the avatar updates
             // --> more avatars may freeze until their priority trickles up
@@ -222,19 +278,27 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             if (inView && avatar->hasNewJointData()) {
                 numAVatarsNotUpdated++;
             }
-            sortedAvatars.pop();
-            while (inView && !sortedAvatars.empty()) {
-                const AvatarPriority& newSortData = sortedAvatars.top();
+            ++sortItr;
+            while (inView && sortItr != sortedAvatars.end()) {
+                const AvatarPriority& newSortData = *sortItr;
                 const auto& newAvatar = std::static_pointer_cast<Avatar>(newSortData.avatar);
                 inView = newSortData.priority > OUT_OF_VIEW_THRESHOLD;
                 if (inView && newAvatar->hasNewJointData()) {
                     numAVatarsNotUpdated++;
                 }
-                sortedAvatars.pop();
+                ++sortItr;
             }
             break;
         }
-        sortedAvatars.pop();
+    }
+
+    // The skinning matrices of the avatars simulated are computed on the job pool too,
+    // the render items pick them up at the end of the update instead of computing them there
+    if (updateConcurrently && (int)simulatedAvatars.size() >= MIN_CONCURRENTLY_UPDATED_AVATARS) {
+        PROFILE_RANGE(simulation, "updateClusterMatrices");
+        QtConcurrent::blockingMap(simulatedAvatars, [](const std::shared_ptr<Avatar>& avatar) {
+            avatar->getSkeletonModel()->updateClusterMatrices();
+        });
     }
 
     if (_shouldRender) {
@@ -94,6 +94,7 @@ private:
     void handleRemovedAvatar(const AvatarSharedPointer& removedAvatar, KillAvatarReason removalReason = KillAvatarReason::NoReason) override;
 
     QVector<AvatarSharedPointer> _avatarsToFade;
+    std::vector<AvatarPriority> _sortedAvatars; // last frame's update order
 
     using AvatarMotionStateMap = QMap<Avatar*, AvatarMotionState*>;
     AvatarMotionStateMap _motionStates;
@@ -30,6 +30,7 @@
 #include <FSTReader.h>
 #include <GeometryUtil.h>
 #include <NodeList.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <PathUtils.h>
 #include <PerfStat.h>
@@ -597,6 +598,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     locationChanged();
+    resolveWorldTransforms();
     // if a entity-child of this avatar has moved outside of its queryAACube, update the cube and tell the entity server.
     auto entityTreeRenderer = qApp->getEntities();
     EntityTreePointer entityTree = entityTreeRenderer ? entityTreeRenderer->getTree() : nullptr;
@@ -1198,11 +1200,11 @@ AttachmentData MyAvatar::loadAttachmentData(const QUrl& modelURL, const QString&
     return attachment;
 }
 
-int MyAvatar::parseDataFromBuffer(const QByteArray& buffer) {
+int MyAvatar::parsePreparedData(const PreparedData& prepared) {
     qCDebug(interfaceapp) << "Error: ignoring update packet for MyAvatar"
-        << " packetLength = " << buffer.size();
+        << " packetLength = " << prepared.buffer.size();
     // this packet is just bad, so we pretend that we unpacked it ALL
-    return buffer.size();
+    return prepared.buffer.size();
 }
 
 void MyAvatar::updateLookAtTargetAvatar() {
@@ -3110,6 +3112,14 @@ float MyAvatar::getIKErrorOnLastSolve() const {
     return _skeletonModel->getRig().getIKErrorOnLastSolve();
 }
 
+int MyAvatar::getIKLoopsOnLastSolve() const {
+    return _skeletonModel->getRig().getIKLoopsOnLastSolve();
+}
+
+float MyAvatar::getIKSolveMsecsOnLastSolve() const {
+    return (float)_skeletonModel->getRig().getIKSolveUsecsOnLastSolve() / (float)USECS_PER_MSEC;
+}
+
 // thread-safe
 void MyAvatar::addHoldAction(AvatarActionHold* holdAction) {
     std::lock_guard<std::mutex> guard(_holdActionsMutex);
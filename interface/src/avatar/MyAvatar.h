@@ -425,6 +425,8 @@ public:
     Q_INVOKABLE bool clearPinOnJoint(int index);
 
     Q_INVOKABLE float getIKErrorOnLastSolve() const;
+    Q_INVOKABLE int getIKLoopsOnLastSolve() const;
+    Q_INVOKABLE float getIKSolveMsecsOnLastSolve() const;
 
     Q_INVOKABLE void useFullAvatarURL(const QUrl& fullAvatarURL, const QString& modelName = QString());
     Q_INVOKABLE QUrl getFullAvatarURLFromPreferences() const { return _fullAvatarURLFromPreferences; }
@@ -593,7 +595,7 @@ private:
     void setShouldRenderLocally(bool shouldRender) { _shouldRender = shouldRender; setEnableMeshVisible(shouldRender); }
     bool getShouldRenderLocally() const { return _shouldRender; }
     bool isMyAvatar() const override { return true; }
-    virtual int parseDataFromBuffer(const QByteArray& buffer) override;
+    virtual int parsePreparedData(const PreparedData& prepared) override;
     virtual glm::vec3 getSkeletonPosition() const override;
 
     glm::vec3 getScriptedMotorVelocity() const { return _scriptedMotorVelocity; }
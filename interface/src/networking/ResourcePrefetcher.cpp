@@ -0,0 +1,300 @@
+//
+//  ResourcePrefetcher.cpp
+//  interface/src/networking
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourcePrefetcher.h"
+
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+#include <AddressManager.h>
+#include <EntityTreeElement.h>
+#include <ModelEntityItem.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <PathUtils.h>
+#include <ResourceManager.h>
+#include <ScriptCache.h>
+#include <ZoneEntityItem.h>
+#include <model-networking/ModelCache.h>
+#include <model-networking/TextureCache.h>
+
+#include "avatar/AvatarManager.h"
+#include "InterfaceLogging.h"
+
+static const QString MANIFEST_DIRECTORY = "prefetch/";
+static const int MAX_MANIFEST_ENTRIES = 4096;
+
+// how far from a destination what was used there is fetched, and how much of it, nearest first
+static const float PREFETCH_RADIUS = 100.0f;
+static const size_t MAX_PREFETCHES_PER_DESTINATION = 256;
+
+// well below the priorities the scene's models, textures and sounds are loaded at
+static const float PREFETCH_LOAD_PRIORITY = -20.0f;
+
+// prefetched resources are let go of once their entities have had time to take them over
+static const int PREFETCH_HOLD_MSECS = 60 * MSECS_PER_SECOND;
+
+static const int TRAVEL_PREDICTION_INTERVAL_MSECS = MSECS_PER_SECOND;
+static const float MIN_TRAVEL_SPEED = 5.0f; // meters per second, faster than walking
+static const float TRAVEL_PREDICTION_SECONDS = 5.0f;
+
+static const QHash<QString, int> TYPE_NAMES {
+    { "model", 0 },
+    { "cube_texture", 1 },
+    { "script", 2 }
+};
+
+static bool isPrefetchable(const QString& urlString) {
+    if (urlString.isEmpty()) {
+        return false;
+    }
+    QString scheme = QUrl(urlString).scheme();
+    return scheme == URL_SCHEME_HTTP || scheme == URL_SCHEME_HTTPS || scheme == URL_SCHEME_ATP;
+}
+
+void ResourcePrefetcher::init() {
+    auto addressManager = DependencyManager::get<AddressManager>();
+    connect(addressManager.data(), &AddressManager::locationChangeRequired, this,
+        [this](const glm::vec3& newPosition, bool hasOrientationChange, const glm::quat& newOrientation,
+               bool shouldFaceLocation) {
+        prefetchAround(newPosition);
+    });
+
+    const DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
+    connect(&domainHandler, &DomainHandler::connectedToDomain, this, &ResourcePrefetcher::connectedToDomain);
+
+    _releaseTimer.setSingleShot(true);
+    _releaseTimer.setInterval(PREFETCH_HOLD_MSECS);
+    connect(&_releaseTimer, &QTimer::timeout, this, &ResourcePrefetcher::releasePrefetches);
+
+    connect(&_travelTimer, &QTimer::timeout, this, &ResourcePrefetcher::predictTravel);
+    _travelTimer.start(TRAVEL_PREDICTION_INTERVAL_MSECS);
+}
+
+void ResourcePrefetcher::recordManifest(const EntityTreePointer& tree) {
+    if (_connectedHost.isEmpty() || !tree) {
+        return;
+    }
+
+    Manifest recorded;
+    QSet<QString> recordedURLs;
+    auto addEntry = [&](const QString& url, ResourceType type, const glm::vec3& position) {
+        if (isPrefetchable(url) && !recordedURLs.contains(url) && (int)recorded.size() < MAX_MANIFEST_ENTRIES) {
+            recordedURLs.insert(url);
+            recorded.push_back({ url, type, position });
+        }
+    };
+
+    tree->withReadLock([&] {
+        tree->recurseTreeWithOperation([&](const OctreeElementPointer& element, void* extraData) {
+            std::static_pointer_cast<EntityTreeElement>(element)->forEachEntity([&](EntityItemPointer entity) {
+                glm::vec3 position = entity->getPosition();
+                addEntry(entity->getScript(), ResourceType::Script, position);
+
+                if (entity->getType() == EntityTypes::Model) {
+                    auto modelEntity = std::static_pointer_cast<ModelEntityItem>(entity);
+                    addEntry(modelEntity->getModelURL(), ResourceType::Model, position);
+                } else if (entity->getType() == EntityTypes::Zone) {
+                    auto zoneEntity = std::static_pointer_cast<ZoneEntityItem>(entity);
+                    addEntry(zoneEntity->getSkyboxProperties().getURL(), ResourceType::CubeTexture, position);
+                    addEntry(zoneEntity->getKeyLightProperties().getAmbientURL(), ResourceType::CubeTexture, position);
+                }
+            });
+            return true;
+        });
+    });
+
+    if (recorded.empty()) {
+        return;
+    }
+
+    // what we saw this visit comes first, then what is left from earlier visits to other parts of the domain
+    for (auto& entry : getManifest(_connectedHost)) {
+        if ((int)recorded.size() >= MAX_MANIFEST_ENTRIES) {
+            break;
+        }
+        if (!recordedURLs.contains(entry.url)) {
+            recordedURLs.insert(entry.url);
+            recorded.push_back(entry);
+        }
+    }
+
+    _manifest = std::move(recorded);
+    saveManifest(_connectedHost, _manifest);
+}
+
+void ResourcePrefetcher::prefetchAround(const glm::vec3& position) {
+    QString host = DependencyManager::get<AddressManager>()->getHost();
+    if (host.isEmpty()) {
+        return;
+    }
+
+    std::vector<std::pair<float, const ManifestEntry*>> nearbyEntries;
+    for (auto& entry : getManifest(host)) {
+        float distance = glm::distance(entry.position, position);
+        if (distance < PREFETCH_RADIUS && !_prefetchedURLs.contains(entry.url)) {
+            nearbyEntries.push_back({ distance, &entry });
+        }
+    }
+    if (nearbyEntries.empty()) {
+        return;
+    }
+
+    std::sort(nearbyEntries.begin(), nearbyEntries.end(), [](const std::pair<float, const ManifestEntry*>& a,
+                                                             const std::pair<float, const ManifestEntry*>& b) {
+        return a.first < b.first;
+    });
+    if (nearbyEntries.size() > MAX_PREFETCHES_PER_DESTINATION) {
+        nearbyEntries.resize(MAX_PREFETCHES_PER_DESTINATION);
+    }
+
+    bool isConnected = host == _connectedHost && DependencyManager::get<NodeList>()->getDomainHandler().isConnected();
+    if (!isConnected && host != _deferredHost) {
+        _deferredHost = host;
+        _deferredPrefetches.clear();
+    }
+
+    qCDebug(interfaceapp) << "Prefetching" << nearbyEntries.size() << "resources used around" << host << position.x
+        << position.y << position.z;
+
+    for (auto& nearbyEntry : nearbyEntries) {
+        auto& entry = *nearbyEntry.second;
+        float priority = PREFETCH_LOAD_PRIORITY - nearbyEntry.first / PREFETCH_RADIUS;
+        _prefetchedURLs.insert(entry.url);
+
+        if (!isConnected && QUrl(entry.url).scheme() == URL_SCHEME_ATP) {
+            _deferredPrefetches.push_back({ entry, priority });
+        } else {
+            prefetch(entry, priority);
+        }
+    }
+
+    _releaseTimer.start();
+}
+
+void ResourcePrefetcher::connectedToDomain() {
+    _connectedHost = DependencyManager::get<AddressManager>()->getHost();
+
+    if (_connectedHost == _deferredHost) {
+        for (auto& deferredPrefetch : _deferredPrefetches) {
+            prefetch(deferredPrefetch.first, deferredPrefetch.second);
+        }
+    }
+    _deferredHost.clear();
+    _deferredPrefetches.clear();
+}
+
+void ResourcePrefetcher::predictTravel() {
+    auto myAvatar = DependencyManager::get<AvatarManager>()->getMyAvatar();
+    if (!myAvatar) {
+        return;
+    }
+
+    glm::vec3 velocity = myAvatar->getVelocity();
+    if (glm::length(velocity) >= MIN_TRAVEL_SPEED) {
+        prefetchAround(myAvatar->getPosition() + velocity * TRAVEL_PREDICTION_SECONDS);
+    }
+}
+
+void ResourcePrefetcher::releasePrefetches() {
+    // anything not yet taken over drops back to the unused resources of its cache, or out of the download queue
+    _prefetchedResources.clear();
+    _prefetchedURLs.clear();
+    _deferredHost.clear();
+    _deferredPrefetches.clear();
+}
+
+void ResourcePrefetcher::prefetch(const ManifestEntry& entry, float priority) {
+    QUrl url(entry.url);
+    QSharedPointer<Resource> resource;
+
+    switch (entry.type) {
+        case ResourceType::Model:
+            resource = DependencyManager::get<ModelCache>()->getGeometryResource(url);
+            break;
+        case ResourceType::CubeTexture:
+            resource = DependencyManager::get<TextureCache>()->getTexture(url, image::TextureUsage::CUBE_TEXTURE);
+            break;
+        case ResourceType::Script:
+            // the script cache keeps the contents once they arrive
+            DependencyManager::get<ScriptCache>()->getScriptContents(entry.url,
+                [](const QString& scriptOrURL, const QString& contents, bool isURL, bool success, const QString& status) {});
+            return;
+    }
+
+    if (resource) {
+        if (!resource->isLoaded()) {
+            resource->setLoadPriority(this, priority);
+        }
+        _prefetchedResources.append(resource);
+    }
+}
+
+QString ResourcePrefetcher::getManifestFilename(const QString& host) const {
+    QByteArray hostHash = QCryptographicHash::hash(host.toLower().toUtf8(), QCryptographicHash::Md5).toHex();
+    return PathUtils::getAppLocalDataPath() + MANIFEST_DIRECTORY + hostHash + ".json";
+}
+
+const ResourcePrefetcher::Manifest& ResourcePrefetcher::getManifest(const QString& host) {
+    if (host == _manifestHost) {
+        return _manifest;
+    }
+
+    _manifestHost = host;
+    _manifest.clear();
+
+    QFile file(getManifestFilename(host));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return _manifest;
+    }
+
+    auto entries = QJsonDocument::fromJson(file.readAll()).object()["entries"].toArray();
+    for (const auto& value : entries) {
+        auto object = value.toObject();
+        auto position = object["position"].toArray();
+        QString typeName = object["type"].toString();
+        if (!TYPE_NAMES.contains(typeName) || position.size() != 3) {
+            continue;
+        }
+
+        _manifest.push_back({ object["url"].toString(), (ResourceType)TYPE_NAMES.value(typeName),
+                              glm::vec3(position[0].toDouble(), position[1].toDouble(), position[2].toDouble()) });
+    }
+
+    return _manifest;
+}
+
+void ResourcePrefetcher::saveManifest(const QString& host, const Manifest& manifest) const {
+    QJsonArray entries;
+    for (auto& entry : manifest) {
+        entries.append(QJsonObject {
+            { "url", entry.url },
+            { "type", TYPE_NAMES.key((int)entry.type) },
+            { "position", QJsonArray { entry.position.x, entry.position.y, entry.position.z } }
+        });
+    }
+
+    QDir().mkpath(PathUtils::getAppLocalDataPath() + MANIFEST_DIRECTORY);
+
+    QSaveFile file(getManifestFilename(host));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(interfaceapp) << "Could not save the resource manifest for" << host << "-" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(QJsonObject { { "entries", entries } }).toJson(QJsonDocument::Compact));
+    file.commit();
+}
@@ -0,0 +1,81 @@
+//
+//  ResourcePrefetcher.h
+//  interface/src/networking
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourcePrefetcher_h
+#define hifi_ResourcePrefetcher_h
+
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QTimer>
+
+#include <glm/glm.hpp>
+
+#include <EntityTree.h>
+
+class Resource;
+
+// Starts loading what is around a destination before its entities have streamed in
+//
+// When we leave a domain, the models, skyboxes and scripts used by its entities are remembered along with where those
+// entities were, in a manifest per domain kept on disk. Teleporting, following a bookmark or moving quickly towards a
+// place we have a manifest for loads what was used nearby at a priority below anything in the scene, so that the
+// transition is spent downloading rather than waiting on the entity server.
+class ResourcePrefetcher : public QObject {
+    Q_OBJECT
+public:
+    void init();
+
+    // remembers the resources used by the entities of the domain we are connected to, call before the tree is cleared
+    void recordManifest(const EntityTreePointer& tree);
+
+public slots:
+    // the position is in the domain AddressManager is going to
+    void prefetchAround(const glm::vec3& position);
+
+private slots:
+    void connectedToDomain();
+    void predictTravel();
+    void releasePrefetches();
+
+private:
+    enum class ResourceType { Model, CubeTexture, Script };
+
+    struct ManifestEntry {
+        QString url;
+        ResourceType type;
+        glm::vec3 position;
+    };
+    using Manifest = std::vector<ManifestEntry>;
+
+    QString getManifestFilename(const QString& host) const;
+    const Manifest& getManifest(const QString& host);
+    void saveManifest(const QString& host, const Manifest& manifest) const;
+
+    void prefetch(const ManifestEntry& entry, float priority);
+
+    QString _connectedHost; // the domain the entity tree is from
+
+    QString _manifestHost;
+    Manifest _manifest;
+
+    // ATP paths can only be resolved once connected to the asset server of their domain
+    QString _deferredHost;
+    std::vector<std::pair<ManifestEntry, float>> _deferredPrefetches;
+
+    QSet<QString> _prefetchedURLs;
+    QList<QSharedPointer<Resource>> _prefetchedResources; // held until the entities that use them have arrived
+    QTimer _releaseTimer;
+    QTimer _travelTimer;
+};
+
+#endif // hifi_ResourcePrefetcher_h
@@ -257,6 +257,12 @@ void setupPreferences() {
         preference->setStep(1);
         preferences->addPreference(preference);
     }
+    {
+        auto getter = []()->bool { return DependencyManager::get<AudioClient>()->getReceivedAudioStream().timeStretchEnabled(); };
+        auto setter = [](bool value) { DependencyManager::get<AudioClient>()->getReceivedAudioStream().setTimeStretchEnabled(value); };
+        auto preference = new CheckPreference(AUDIO_BUFFERS, "Time-stretch jitter buffer", getter, setter);
+        preferences->addPreference(preference);
+    }
     {
         auto getter = []()->bool { return !DependencyManager::get<AudioClient>()->getOutputStarveDetectionEnabled(); };
         auto setter = [](bool value) { DependencyManager::get<AudioClient>()->setOutputStarveDetectionEnabled(!value); };
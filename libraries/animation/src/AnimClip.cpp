@@ -8,6 +8,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
+
 #include "GLMHelpers.h"
 #include "AnimClip.h"
 #include "AnimationLogging.h"
@@ -15,6 +17,39 @@
 
 bool AnimClip::usePreAndPostPoseFromAnim = true;
 
+static void hashCombine(uint64_t& hash, uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+}
+
+static void hashFloats(uint64_t& hash, const float* values, int count) {
+    for (int i = 0; i < count; i++) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        hashCombine(hash, bits);
+    }
+}
+
+static void hashPose(uint64_t& hash, const AnimPose& pose) {
+    hashFloats(hash, &pose.scale()[0], 3);
+    hashFloats(hash, &pose.rot()[0], 4);
+    hashFloats(hash, &pose.trans()[0], 3);
+}
+
+// Identifies all that retargeting an animation depends on, for skeletons of the same avatar to share the frames
+static uint64_t computeSkeletonHash(const AnimSkeleton& skeleton) {
+    uint64_t hash = 0;
+    hashCombine(hash, AnimClip::usePreAndPostPoseFromAnim ? 1 : 0);
+    int numJoints = skeleton.getNumJoints();
+    hashCombine(hash, (uint64_t)numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        hashCombine(hash, qHash(skeleton.getJointName(i)));
+        hashCombine(hash, (uint64_t)(int64_t)skeleton.getParentIndex(i));
+        hashPose(hash, skeleton.getRelativeDefaultPose(i));
+        hashFloats(hash, &skeleton.getRelativeBindPose(i).rot()[0], 4);
+    }
+    return hash;
+}
+
 AnimClip::AnimClip(const QString& id, const QString& url, float startFrame, float endFrame, float timeScale, bool loopFlag, bool mirrorFlag) :
     AnimNode(AnimNode::Type::Clip, id),
     _startFrame(startFrame),
@@ -50,10 +85,10 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
         _networkAnim.reset();
     }
 
-    if (_anim.size()) {
+    if (_anim && _anim->getNumFrames() > 0) {
 
         // lazy creation of mirrored animation frames.
-        if (_mirrorFlag && _anim.size() != _mirrorAnim.size()) {
+        if (_mirrorFlag && !_mirrorAnim) {
             buildMirrorAnim();
         }
 
@@ -67,15 +102,20 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
 
         // It can be quite possible for the user to set _startFrame and _endFrame to
         // values before or past valid ranges.  We clamp the frames here.
-        int frameCount = (int)_anim.size();
+        int frameCount = _anim->getNumFrames();
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
 
-        const AnimPoseVec& prevFrame = _mirrorFlag ? _mirrorAnim[prevIndex] : _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _mirrorFlag ? _mirrorAnim[nextIndex] : _anim[nextIndex];
+        const AnimCompressedFrames& frames = _mirrorFlag ? *_mirrorAnim : *_anim;
+        frames.getFrame(prevIndex, _prevPoses);
+        if (nextIndex != prevIndex) {
+            frames.getFrame(nextIndex, _nextPoses);
+        } else {
+            _nextPoses = _prevPoses;
+        }
         float alpha = glm::fract(_frame);
 
-        ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
+        ::blend(_poses.size(), &_prevPoses[0], &_nextPoses[0], alpha, &_poses[0]);
     }
 
     return _poses;
@@ -96,8 +136,19 @@ void AnimClip::setCurrentFrameInternal(float frame) {
 
 void AnimClip::copyFromNetworkAnim() {
     assert(_networkAnim && _networkAnim->isLoaded() && _skeleton);
-    _anim.clear();
+    _skeletonHash = computeSkeletonHash(*_skeleton);
+    auto animCache = DependencyManager::get<AnimationCache>();
+    _anim = animCache->getRetargetedFrames(QUrl(_url), _skeletonHash, false, [&] {
+        return retargetNetworkAnim();
+    });
+
+    // mirrorAnim will be re-built on demand, if needed.
+    _mirrorAnim.reset();
+
+    _poses.resize(_skeleton->getNumJoints());
+}
 
+AnimCompressedFrames::Pointer AnimClip::retargetNetworkAnim() const {
     // build a mapping from animation joint indices to skeleton joint indices.
     // by matching joints with the same name.
     const FBXGeometry& geom = _networkAnim->getGeometry();
@@ -115,7 +166,7 @@ void AnimClip::copyFromNetworkAnim() {
     }
 
     const int frameCount = geom.animationFrames.size();
-    _anim.resize(frameCount);
+    std::vector<AnimPoseVec> anim(frameCount);
 
     for (int frame = 0; frame < frameCount; frame++) {
 
@@ -123,9 +174,9 @@ void AnimClip::copyFromNetworkAnim() {
 
         // init all joints in animation to default pose
         // this will give us a resonable result for bones in the model skeleton but not in the animation.
-        _anim[frame].reserve(skeletonJointCount);
+        anim[frame].reserve(skeletonJointCount);
         for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
-            _anim[frame].push_back(_skeleton->getRelativeDefaultPose(skeletonJoint));
+            anim[frame].push_back(_skeleton->getRelativeDefaultPose(skeletonJoint));
         }
 
         for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
@@ -165,26 +216,30 @@ void AnimClip::copyFromNetworkAnim() {
 
                 AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), relDefaultPose.trans() + boneLengthScale * (fbxAnimTrans - fbxZeroTrans));
 
-                _anim[frame][skeletonJoint] = trans * preRot * rot * postRot;
+                anim[frame][skeletonJoint] = trans * preRot * rot * postRot;
             }
         }
     }
 
-    // mirrorAnim will be re-built on demand, if needed.
-    _mirrorAnim.clear();
-
-    _poses.resize(skeletonJointCount);
+    auto frames = std::make_shared<const AnimCompressedFrames>(anim);
+    qCDebug(animation) << "compressed" << frameCount << "frames of" << skeletonJointCount << "joints to"
+        << frames->getMemorySize() << "bytes from" << frameCount * skeletonJointCount * sizeof(AnimPose) << ", url =" << _url;
+    return frames;
 }
 
 void AnimClip::buildMirrorAnim() {
-    assert(_skeleton);
+    assert(_skeleton && _anim);
 
-    _mirrorAnim.clear();
-    _mirrorAnim.reserve(_anim.size());
-    for (auto& relPoses : _anim) {
-        _mirrorAnim.push_back(relPoses);
-        _skeleton->mirrorRelativePoses(_mirrorAnim.back());
-    }
+    auto animCache = DependencyManager::get<AnimationCache>();
+    _mirrorAnim = animCache->getRetargetedFrames(QUrl(_url), _skeletonHash, true, [&] {
+        int frameCount = _anim->getNumFrames();
+        std::vector<AnimPoseVec> mirrorAnim(frameCount);
+        for (int frame = 0; frame < frameCount; frame++) {
+            _anim->getFrame(frame, mirrorAnim[frame]);
+            _skeleton->mirrorRelativePoses(mirrorAnim[frame]);
+        }
+        return std::make_shared<const AnimCompressedFrames>(mirrorAnim);
+    });
 }
 
 const AnimPoseVec& AnimClip::getPosesInternal() const {
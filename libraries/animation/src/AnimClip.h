@@ -59,6 +59,7 @@ protected:
     virtual void setCurrentFrameInternal(float frame) override;
 
     void copyFromNetworkAnim();
+    AnimCompressedFrames::Pointer retargetNetworkAnim() const;
     void buildMirrorAnim();
 
     // for AnimDebugDraw rendering
@@ -67,9 +68,14 @@ protected:
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
-    std::vector<AnimPoseVec> _mirrorAnim;
+    // frames of the animation retargeted to _skeleton, shared with the other clips playing it
+    AnimCompressedFrames::Pointer _anim;
+    AnimCompressedFrames::Pointer _mirrorAnim;
+    uint64_t _skeletonHash { 0 };
+
+    // decompressed frames the poses are blended from
+    AnimPoseVec _prevPoses;
+    AnimPoseVec _nextPoses;
 
     QString _url;
     float _startFrame;
@@ -0,0 +1,243 @@
+//
+//  AnimCompressedFrames.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimCompressedFrames.h"
+
+#include <algorithm>
+
+#include "AnimUtil.h"
+
+// Angle, in radians, a rotation interpolated between keyframes may deviate from the frame by
+static const float ROTATION_TOLERANCE = 0.001f;
+// Distance, in skeleton units, a translation may deviate by, at least, and relative to the range of the track
+static const float TRANSLATION_TOLERANCE = 0.0001f;
+static const float RELATIVE_TRANSLATION_TOLERANCE = 0.001f;
+static const float SCALE_TOLERANCE = 0.0001f;
+
+// Keyframes are at most 2 seconds apart at 30 frames per second, this also bounds the time to fit them
+static const int MAX_KEY_FRAME_SPAN = 60;
+
+// Three 20 bits components of the quaternion, without the largest one which is recovered from the others,
+// and the index of the largest one in the 2 low bits
+static const int ROTATION_COMPONENT_BITS = 20;
+static const uint64_t ROTATION_COMPONENT_MASK = (1 << ROTATION_COMPONENT_BITS) - 1;
+static const float ROTATION_COMPONENT_RANGE = 0.70710678f; // the other components are within +/- sqrt(1/2)
+
+static const float VEC3_QUANTIZATION = 65535.0f;
+
+static uint64_t packRotation(const glm::quat& rotation) {
+    glm::quat q = glm::normalize(rotation);
+    float components[4] = { q.x, q.y, q.z, q.w };
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largest])) {
+            largest = i;
+        }
+    }
+
+    // q and -q are the same rotation, make the largest component positive
+    float sign = (components[largest] < 0.0f) ? -1.0f : 1.0f;
+    uint64_t packed = (uint64_t)largest;
+    int shift = 2;
+    for (int i = 0; i < 4; i++) {
+        if (i != largest) {
+            float normalized = glm::clamp(0.5f * sign * components[i] / ROTATION_COMPONENT_RANGE + 0.5f, 0.0f, 1.0f);
+            uint64_t quantized = (uint64_t)(normalized * (float)ROTATION_COMPONENT_MASK + 0.5f);
+            packed |= quantized << shift;
+            shift += ROTATION_COMPONENT_BITS;
+        }
+    }
+    return packed;
+}
+
+static glm::quat unpackRotation(uint64_t packed) {
+    int largest = (int)(packed & 3);
+    float components[4];
+    float sumOfSquares = 0.0f;
+    int shift = 2;
+    for (int i = 0; i < 4; i++) {
+        if (i != largest) {
+            float normalized = (float)((packed >> shift) & ROTATION_COMPONENT_MASK) / (float)ROTATION_COMPONENT_MASK;
+            components[i] = (2.0f * normalized - 1.0f) * ROTATION_COMPONENT_RANGE;
+            sumOfSquares += components[i] * components[i];
+            shift += ROTATION_COMPONENT_BITS;
+        }
+    }
+    components[largest] = sqrtf(std::max(0.0f, 1.0f - sumOfSquares));
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+static float rotationDistance(const glm::quat& a, const glm::quat& b) {
+    // The chord between unit quaternions is about half of the angle between the rotations
+    glm::quat c = (glm::dot(a, b) < 0.0f) ? -b : b;
+    glm::vec4 delta(a.x - c.x, a.y - c.y, a.z - c.z, a.w - c.w);
+    return 2.0f * glm::length(delta);
+}
+
+// Greedily keep the keyframes the frames in between can't be interpolated from within the tolerance,
+// the first frame is always a keyframe and so is the last one unless the track is constant
+template <typename T, typename Lerp, typename Distance>
+static std::vector<uint32_t> fitKeyFrames(const std::vector<T>& values, float tolerance, Lerp lerp, Distance distance) {
+    std::vector<uint32_t> keyFrames;
+    keyFrames.push_back(0);
+
+    int numFrames = (int)values.size();
+    bool isConstant = true;
+    for (int i = 1; i < numFrames && isConstant; i++) {
+        isConstant = distance(values[0], values[i]) <= tolerance;
+    }
+    if (isConstant) {
+        return keyFrames;
+    }
+
+    int first = 0;
+    while (first < numFrames - 1) {
+        int last = first + 1;
+        while (last + 1 < numFrames && last + 1 - first <= MAX_KEY_FRAME_SPAN) {
+            int candidate = last + 1;
+            bool fits = true;
+            for (int i = first + 1; i < candidate && fits; i++) {
+                float alpha = (float)(i - first) / (float)(candidate - first);
+                fits = distance(lerp(values[first], values[candidate], alpha), values[i]) <= tolerance;
+            }
+            if (!fits) {
+                break;
+            }
+            last = candidate;
+        }
+        keyFrames.push_back((uint32_t)last);
+        first = last;
+    }
+    return keyFrames;
+}
+
+// Index of the keyframe at or before the frame
+static int findKeyFrame(const std::vector<uint32_t>& keyFrames, int frame) {
+    auto next = std::upper_bound(keyFrames.begin(), keyFrames.end(), (uint32_t)frame);
+    return std::max(0, (int)(next - keyFrames.begin()) - 1);
+}
+
+template <typename T, typename Unpack, typename Lerp>
+static T sampleTrack(const std::vector<uint32_t>& keyFrames, int frame, Unpack unpack, Lerp lerp) {
+    int key = findKeyFrame(keyFrames, frame);
+    if (key + 1 >= (int)keyFrames.size() || (int)keyFrames[key] == frame) {
+        return unpack(key);
+    }
+    float alpha = (float)(frame - (int)keyFrames[key]) / (float)(keyFrames[key + 1] - keyFrames[key]);
+    return lerp(unpack(key), unpack(key + 1), alpha);
+}
+
+static glm::vec3 lerpVec3(const glm::vec3& a, const glm::vec3& b, float alpha) {
+    return a + (b - a) * alpha;
+}
+
+static float vec3Distance(const glm::vec3& a, const glm::vec3& b) {
+    return glm::length(a - b);
+}
+
+static glm::vec3 unpackVec3(const uint16_t* packed, const glm::vec3& minimum, const glm::vec3& extent) {
+    return minimum + extent * (glm::vec3(packed[0], packed[1], packed[2]) / VEC3_QUANTIZATION);
+}
+
+template <typename Track>
+static void compressVec3s(const std::vector<glm::vec3>& values, float tolerance, float relativeTolerance, Track& track) {
+    glm::vec3 minimum = values[0];
+    glm::vec3 maximum = values[0];
+    for (const auto& value : values) {
+        minimum = glm::min(minimum, value);
+        maximum = glm::max(maximum, value);
+    }
+    track.minimum = minimum;
+    track.extent = maximum - minimum;
+
+    // Fit the keyframes to the values as they will be decompressed
+    std::vector<uint16_t> packed(3 * values.size());
+    std::vector<glm::vec3> decompressed(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            float normalized = (track.extent[j] > 0.0f) ? (values[i][j] - minimum[j]) / track.extent[j] : 0.0f;
+            packed[3 * i + j] = (uint16_t)(glm::clamp(normalized, 0.0f, 1.0f) * VEC3_QUANTIZATION + 0.5f);
+        }
+        decompressed[i] = unpackVec3(&packed[3 * i], track.minimum, track.extent);
+    }
+
+    float trackTolerance = std::max(tolerance, relativeTolerance * glm::length(track.extent));
+    track.keyFrames = fitKeyFrames(decompressed, trackTolerance, lerpVec3, vec3Distance);
+    track.values.reserve(3 * track.keyFrames.size());
+    for (auto keyFrame : track.keyFrames) {
+        track.values.insert(track.values.end(), &packed[3 * keyFrame], &packed[3 * keyFrame] + 3);
+    }
+}
+
+AnimCompressedFrames::AnimCompressedFrames(const std::vector<AnimPoseVec>& frames) :
+    _numFrames((int)frames.size()) {
+    if (frames.empty()) {
+        return;
+    }
+
+    int numJoints = (int)frames[0].size();
+    _joints.resize(numJoints);
+
+    std::vector<uint64_t> packedRotations(_numFrames);
+    std::vector<glm::quat> rotations(_numFrames);
+    std::vector<glm::vec3> translations(_numFrames);
+    std::vector<glm::vec3> scales(_numFrames);
+    for (int joint = 0; joint < numJoints; joint++) {
+        for (int frame = 0; frame < _numFrames; frame++) {
+            const AnimPose& pose = frames[frame][joint];
+            packedRotations[frame] = packRotation(pose.rot());
+            rotations[frame] = unpackRotation(packedRotations[frame]);
+            translations[frame] = pose.trans();
+            scales[frame] = pose.scale();
+        }
+
+        JointTrack& track = _joints[joint];
+        track.rotation.keyFrames = fitKeyFrames(rotations, ROTATION_TOLERANCE, safeLerp, rotationDistance);
+        track.rotation.rotations.reserve(track.rotation.keyFrames.size());
+        for (auto keyFrame : track.rotation.keyFrames) {
+            track.rotation.rotations.push_back(packedRotations[keyFrame]);
+        }
+
+        compressVec3s(translations, TRANSLATION_TOLERANCE, RELATIVE_TRANSLATION_TOLERANCE, track.translation);
+        compressVec3s(scales, SCALE_TOLERANCE, 0.0f, track.scale);
+    }
+}
+
+void AnimCompressedFrames::getFrame(int frame, AnimPoseVec& poses) const {
+    poses.resize(_joints.size());
+    frame = std::min(std::max(0, frame), _numFrames - 1);
+
+    for (size_t joint = 0; joint < _joints.size(); joint++) {
+        const JointTrack& track = _joints[joint];
+
+        const auto& rotations = track.rotation.rotations;
+        poses[joint].rot() = sampleTrack<glm::quat>(track.rotation.keyFrames, frame,
+            [&](int key) { return unpackRotation(rotations[key]); }, safeLerp);
+
+        const Vec3Track& translation = track.translation;
+        poses[joint].trans() = sampleTrack<glm::vec3>(translation.keyFrames, frame,
+            [&](int key) { return unpackVec3(&translation.values[3 * key], translation.minimum, translation.extent); },
+            lerpVec3);
+
+        const Vec3Track& scale = track.scale;
+        poses[joint].scale() = sampleTrack<glm::vec3>(scale.keyFrames, frame,
+            [&](int key) { return unpackVec3(&scale.values[3 * key], scale.minimum, scale.extent); },
+            lerpVec3);
+    }
+}
+
+size_t AnimCompressedFrames::getMemorySize() const {
+    size_t size = sizeof(AnimCompressedFrames) + _joints.size() * sizeof(JointTrack);
+    for (const auto& track : _joints) {
+        size += track.rotation.keyFrames.size() * sizeof(uint32_t) + track.rotation.rotations.size() * sizeof(uint64_t);
+        size += track.translation.keyFrames.size() * sizeof(uint32_t) + track.translation.values.size() * sizeof(uint16_t);
+        size += track.scale.keyFrames.size() * sizeof(uint32_t) + track.scale.values.size() * sizeof(uint16_t);
+    }
+    return size;
+}
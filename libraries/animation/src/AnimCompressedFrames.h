@@ -0,0 +1,59 @@
+//
+//  AnimCompressedFrames.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimCompressedFrames_h
+#define hifi_AnimCompressedFrames_h
+
+#include <memory>
+#include <vector>
+
+#include "AnimPose.h"
+
+// The frames of an animation retargeted to a skeleton, compressed for the clips to share them.
+// Each joint only keeps the keyframes the frames in between can't be interpolated from within a tolerance,
+// rotations are quantized to the three smallest components of the quaternion, translations and scales to their range.
+class AnimCompressedFrames {
+public:
+    using Pointer = std::shared_ptr<const AnimCompressedFrames>;
+
+    // frames[frame][joint], with the same number of joints in every frame
+    explicit AnimCompressedFrames(const std::vector<AnimPoseVec>& frames);
+
+    int getNumFrames() const { return _numFrames; }
+    int getNumJoints() const { return (int)_joints.size(); }
+
+    // Decompress the relative poses of a frame, poses are resized to the number of joints
+    void getFrame(int frame, AnimPoseVec& poses) const;
+
+    size_t getMemorySize() const;
+
+protected:
+    struct RotationTrack {
+        std::vector<uint32_t> keyFrames;
+        std::vector<uint64_t> rotations;
+    };
+
+    struct Vec3Track {
+        std::vector<uint32_t> keyFrames;
+        std::vector<uint16_t> values; // 3 per keyframe, over the range of the track
+        glm::vec3 minimum;
+        glm::vec3 extent;
+    };
+
+    struct JointTrack {
+        RotationTrack rotation;
+        Vec3Track translation;
+        Vec3Track scale;
+    };
+
+    std::vector<JointTrack> _joints;
+    int _numFrames { 0 };
+};
+
+#endif // hifi_AnimCompressedFrames_h
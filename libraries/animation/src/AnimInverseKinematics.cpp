@@ -26,6 +26,10 @@
 static const int MAX_TARGET_MARKERS = 30;
 static const float JOINT_CHAIN_INTERP_TIME = 0.25f;
 
+// the solve stops once the position targets are this close (meters), or stop getting closer by more than this each loop
+static const float IK_CONVERGED_ERROR = 0.001f;
+static const float IK_STALLED_ERROR_CHANGE = 0.0001f;
+
 static void lookupJointInfo(const AnimInverseKinematics::JointChainInfo& jointChainInfo,
                             int indexA, int indexB,
                             const AnimInverseKinematics::JointInfo** jointInfoA,
@@ -227,13 +231,20 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
         accumulator.clearAndClean();
     }
 
-    float maxError = 0.0f;
+    uint64_t solveStart = usecTimestampNow();
+    float maxError = FLT_MAX;
+    float prevMaxError = FLT_MAX;
     int numLoops = 0;
     const int MAX_IK_LOOPS = 16;
-    while (numLoops < MAX_IK_LOOPS) {
+    bool isLastLoop = false;
+    while (!isLastLoop) {
         ++numLoops;
 
-        bool debug = context.getEnableDebugDrawIKChains() && numLoops == MAX_IK_LOOPS;
+        // once the previous loop converged this one finishes the solve, the joint chains are still interpolated on it
+        bool hasConverged = maxError < IK_CONVERGED_ERROR || prevMaxError - maxError < IK_STALLED_ERROR_CHANGE;
+        isLastLoop = numLoops == MAX_IK_LOOPS || (numLoops > 1 && hasConverged);
+
+        bool debug = context.getEnableDebugDrawIKChains() && isLastLoop;
 
         // solve all targets
         for (size_t i = 0; i < targets.size(); i++) {
@@ -250,7 +261,7 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
         }
 
         // on last iteration, interpolate jointChains, if necessary
-        if (numLoops == MAX_IK_LOOPS) {
+        if (isLastLoop) {
             for (size_t i = 0; i < _prevJointChainInfoVec.size(); i++) {
                 if (_prevJointChainInfoVec[i].timer > 0.0f) {
                     float alpha = (JOINT_CHAIN_INTERP_TIME - _prevJointChainInfoVec[i].timer) / JOINT_CHAIN_INTERP_TIME;
@@ -315,6 +326,7 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
         }
 
         // compute maxError
+        prevMaxError = maxError;
         maxError = 0.0f;
         for (size_t i = 0; i < targets.size(); i++) {
             if (targets[i].getType() == IKTarget::Type::RotationAndPosition || targets[i].getType() == IKTarget::Type::HmdHead ||
@@ -327,6 +339,8 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
         }
     }
     _maxErrorOnLastSolve = maxError;
+    _numLoopsOnLastSolve = numLoops;
+    _solveUsecsOnLastSolve = usecTimestampNow() - solveStart;
 
     // finally set the relative rotation of each tip to agree with absolute target rotation
     for (auto& target: targets) {
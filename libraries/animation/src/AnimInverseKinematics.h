@@ -60,6 +60,8 @@ public:
     void setMaxHipsOffsetLength(float maxLength);
 
     float getMaxErrorOnLastSolve() { return _maxErrorOnLastSolve; }
+    int getNumLoopsOnLastSolve() const { return _numLoopsOnLastSolve; }
+    uint64_t getSolveUsecsOnLastSolve() const { return _solveUsecsOnLastSolve; }
 
     enum class SolutionSource {
         RelaxToUnderPoses = 0,
@@ -161,6 +163,8 @@ protected:
     int _rightHandIndex { -1 };
 
     float _maxErrorOnLastSolve { FLT_MAX };
+    int _numLoopsOnLastSolve { 0 };
+    uint64_t _solveUsecsOnLastSolve { 0 };
     bool _previousEnableDebugIKTargets { false };
     SolutionSource _solutionSource { SolutionSource::RelaxToUnderPoses };
     QString _solutionSourceVar;
@@ -54,13 +54,30 @@ glm::vec3 AnimPose::xformVectorFast(const glm::vec3& rhs) const {
     return _rot * (_scale * rhs);
 }
 
+// Under a positive uniform scale, products and inverses of poses are poses again, composed directly.
+// Otherwise they go through matrices, and get decomposed back.
+static bool isPositiveUniformScale(const glm::vec3& scale) {
+    const float UNIFORM_SCALE_EPSILON = 0.0001f;
+    return scale.x > 0.0f &&
+        fabsf(scale.y - scale.x) <= UNIFORM_SCALE_EPSILON * scale.x &&
+        fabsf(scale.z - scale.x) <= UNIFORM_SCALE_EPSILON * scale.x;
+}
+
 AnimPose AnimPose::operator*(const AnimPose& rhs) const {
+    if (isPositiveUniformScale(_scale) && rhs._scale.x > 0.0f && rhs._scale.y > 0.0f && rhs._scale.z > 0.0f) {
+        return AnimPose(_scale.x * rhs._scale, _rot * rhs._rot, _trans + _rot * (_scale.x * rhs._trans));
+    }
     glm::mat4 result;
     glm_mat4u_mul(*this, rhs, result);
     return AnimPose(result);
 }
 
 AnimPose AnimPose::inverse() const {
+    if (isPositiveUniformScale(_scale)) {
+        float inverseScale = 1.0f / _scale.x;
+        glm::quat inverseRot = glm::inverse(_rot);
+        return AnimPose(glm::vec3(inverseScale), inverseRot, inverseRot * (-inverseScale * _trans));
+    }
     return AnimPose(glm::inverse(static_cast<glm::mat4>(*this)));
 }
 
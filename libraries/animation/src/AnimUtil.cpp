@@ -12,25 +12,44 @@
 #include "GLMHelpers.h"
 
 // TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
 
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    // The rotations are nlerped as 4 floats at once, component order doesn't matter to a dot, a lerp or a normalize
+    const __m128 alphas = _mm_set1_ps(alpha);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
 
-        // adjust signs if necessary
-        const glm::quat& q1 = aPose.rot();
-        glm::quat q2 = bPose.rot();
-        float dot = glm::dot(q1, q2);
-        if (dot < 0.0f) {
-            q2 = -q2;
-        }
+        __m128 q1 = _mm_loadu_ps((const float*)&aPose.rot());
+        __m128 q2 = _mm_loadu_ps((const float*)&bPose.rot());
+
+        // adjust signs if necessary, with the sign of the dot in all the lanes
+        __m128 dot = _mm_mul_ps(q1, q2);
+        dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+        dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+        q2 = _mm_xor_ps(q2, _mm_and_ps(dot, signMask));
+
+        __m128 q = _mm_add_ps(q1, _mm_mul_ps(_mm_sub_ps(q2, q1), alphas));
+        __m128 length2 = _mm_mul_ps(q, q);
+        length2 = _mm_add_ps(length2, _mm_shuffle_ps(length2, length2, _MM_SHUFFLE(2, 3, 0, 1)));
+        length2 = _mm_add_ps(length2, _mm_shuffle_ps(length2, length2, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        result[i].scale() = lerp(aPose.scale(), bPose.scale(), alpha);
+        _mm_storeu_ps((float*)&result[i].rot(), _mm_div_ps(q, _mm_sqrt_ps(length2)));
+        result[i].trans() = lerp(aPose.trans(), bPose.trans(), alpha);
+    }
+#else
+    for (size_t i = 0; i < numPoses; i++) {
+        const AnimPose& aPose = a[i];
+        const AnimPose& bPose = b[i];
 
         result[i].scale() = lerp(aPose.scale(), bPose.scale(), alpha);
         result[i].rot() = safeLerp(aPose.rot(), bPose.rot(), alpha);
         result[i].trans() = lerp(aPose.trans(), bPose.trans(), alpha);
     }
+#endif
 }
 
 glm::quat averageQuats(size_t numQuats, const glm::quat* quats) {
@@ -41,6 +41,43 @@ AnimationPointer AnimationCache::getAnimation(const QUrl& url) {
     return getResource(url).staticCast<Animation>();
 }
 
+AnimCompressedFrames::Pointer AnimationCache::getRetargetedFrames(const QUrl& url, uint64_t skeletonHash, bool mirrored,
+        const std::function<AnimCompressedFrames::Pointer()>& build) {
+    RetargetedFramesKey key(url.toString(), skeletonHash, mirrored);
+    {
+        std::lock_guard<std::mutex> lock(_retargetedFramesMutex);
+        auto itr = _retargetedFrames.find(key);
+        if (itr != _retargetedFrames.end()) {
+            auto frames = itr->second.lock();
+            if (frames) {
+                return frames;
+            }
+        }
+    }
+
+    // Build outside of the lock, if two clips race to build the same frames the first one in is kept
+    auto frames = build();
+    if (!frames) {
+        return frames;
+    }
+
+    std::lock_guard<std::mutex> lock(_retargetedFramesMutex);
+    for (auto itr = _retargetedFrames.begin(); itr != _retargetedFrames.end();) {
+        if (itr->second.expired()) {
+            itr = _retargetedFrames.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    auto& entry = _retargetedFrames[key];
+    auto existing = entry.lock();
+    if (existing) {
+        return existing;
+    }
+    entry = frames;
+    return frames;
+}
+
 QSharedPointer<Resource> AnimationCache::createResource(const QUrl& url, const QSharedPointer<Resource>& fallback,
     const void* extra) {
     return QSharedPointer<Resource>(new Animation(url), &Resource::deleter);
@@ -12,6 +12,11 @@
 #ifndef hifi_AnimationCache_h
 #define hifi_AnimationCache_h
 
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include <QtCore/QRunnable>
 #include <QtScript/QScriptEngine>
 #include <QtScript/QScriptValue>
@@ -20,6 +25,8 @@
 #include <FBXReader.h>
 #include <ResourceCache.h>
 
+#include "AnimCompressedFrames.h"
+
 class Animation;
 
 typedef QSharedPointer<Animation> AnimationPointer;
@@ -45,6 +52,11 @@ public:
     Q_INVOKABLE AnimationPointer getAnimation(const QString& url) { return getAnimation(QUrl(url)); }
     Q_INVOKABLE AnimationPointer getAnimation(const QUrl& url);
 
+    // The frames of an animation retargeted to a skeleton are shared by all the clips playing it on that skeleton,
+    // for as long as one of them holds on to the frames. build is called to make them when none does.
+    AnimCompressedFrames::Pointer getRetargetedFrames(const QUrl& url, uint64_t skeletonHash, bool mirrored,
+        const std::function<AnimCompressedFrames::Pointer()>& build);
+
 protected:
 
     virtual QSharedPointer<Resource> createResource(const QUrl& url, const QSharedPointer<Resource>& fallback,
@@ -53,6 +65,9 @@ private:
     explicit AnimationCache(QObject* parent = NULL);
     virtual ~AnimationCache() { }
 
+    using RetargetedFramesKey = std::tuple<QString, uint64_t, bool>;
+    std::mutex _retargetedFramesMutex;
+    std::map<RetargetedFramesKey, std::weak_ptr<const AnimCompressedFrames>> _retargetedFrames;
 };
 
 Q_DECLARE_METATYPE(AnimationPointer)
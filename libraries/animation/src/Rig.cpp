@@ -358,6 +358,36 @@ float Rig::getIKErrorOnLastSolve() const {
     return result;
 }
 
+int Rig::getIKLoopsOnLastSolve() const {
+    int result = 0;
+
+    if (_animNode) {
+        _animNode->traverse([&](AnimNode::Pointer node) {
+            auto ikNode = std::dynamic_pointer_cast<AnimInverseKinematics>(node);
+            if (ikNode) {
+                result = ikNode->getNumLoopsOnLastSolve();
+            }
+            return true;
+        });
+    }
+    return result;
+}
+
+uint64_t Rig::getIKSolveUsecsOnLastSolve() const {
+    uint64_t result = 0;
+
+    if (_animNode) {
+        _animNode->traverse([&](AnimNode::Pointer node) {
+            auto ikNode = std::dynamic_pointer_cast<AnimInverseKinematics>(node);
+            if (ikNode) {
+                result = ikNode->getSolveUsecsOnLastSolve();
+            }
+            return true;
+        });
+    }
+    return result;
+}
+
 int Rig::getJointParentIndex(int childIndex) const {
     if (_animSkeleton && isIndexValid(childIndex)) {
         return _animSkeleton->getParentIndex(childIndex);
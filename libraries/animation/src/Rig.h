@@ -127,6 +127,8 @@ public:
     float getMaxHipsOffsetLength() const;
 
     float getIKErrorOnLastSolve() const;
+    int getIKLoopsOnLastSolve() const;
+    uint64_t getIKSolveUsecsOnLastSolve() const;
 
     int getJointParentIndex(int childIndex) const;
 
@@ -159,6 +161,9 @@ public:
     // rig space
     glm::mat4 getJointTransform(int jointIndex) const;
 
+    // rig space, the poses getJointTransform makes matrices of
+    const AnimPoseVec& getJointPoses() const { return _internalPoseSet._absolutePoses; }
+
     // Start or stop animations as needed.
     void computeMotionAnimationState(float deltaTime, const glm::vec3& worldPosition, const glm::vec3& worldVelocity, const glm::quat& worldRotation, CharacterControllerState ccState);
 
@@ -54,6 +54,8 @@
 
 const int AudioClient::MIN_BUFFER_FRAMES = 1;
 const int AudioClient::MAX_BUFFER_FRAMES = 20;
+const int AudioClient::MIN_INJECTORS_PER_WORKER;
+const int AudioClient::MAX_LOCAL_INJECTOR_WORKERS;
 
 static const int RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES = 100;
 
@@ -74,6 +76,7 @@ Setting::Handle<bool> dynamicJitterBufferEnabled("dynamicJitterBuffersEnabled",
     InboundAudioStream::DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED);
 Setting::Handle<int> staticJitterBufferFrames("staticJitterBufferFrames",
     InboundAudioStream::DEFAULT_STATIC_JITTER_FRAMES);
+Setting::Handle<bool> jitterBufferTimeStretchEnabled("jitterBufferTimeStretchEnabled", true);
 
 // protect the Qt internal device list
 using Mutex = std::mutex;
@@ -200,6 +203,10 @@ AudioClient::AudioClient() :
     // avoid putting a lock in the device callback
     assert(_localSamplesAvailable.is_lock_free());
 
+    // the network thread writes the received audio, and only the device callback reads it
+    _receivedAudioStream.setSingleProducerConsumer(true);
+    _localInjectorsThreadPool.setMaxThreadCount(MAX_LOCAL_INJECTOR_WORKERS - 1);
+
     // deprecate legacy settings
     {
         Setting::Handle<int>::Deprecated("maxFramesOverDesired", InboundAudioStream::MAX_FRAMES_OVER_DESIRED);
@@ -237,11 +244,19 @@ AudioClient::AudioClient() :
 
     configureReverb();
 
-    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // send parity with our microphone stream once the mixer reports losing it
+    nodeList->setFECEnabled(PacketType::MicrophoneAudioNoEcho, true);
+    nodeList->setFECEnabled(PacketType::MicrophoneAudioWithEcho, true);
+    nodeList->setFECEnabled(PacketType::SilentAudioFrame, true);
+
+    auto& packetReceiver = nodeList->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AudioStreamStats, &_stats, "processStreamStatsPacket");
     packetReceiver.registerListener(PacketType::AudioEnvironment, this, "handleAudioEnvironmentDataPacket");
     packetReceiver.registerListener(PacketType::SilentAudioFrame, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::MixedAudio, this, "handleAudioDataPacket");
+    packetReceiver.registerListener(PacketType::ForwardedMixedAudio, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::NoisyMute, this, "handleNoisyMutePacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
     packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
@@ -756,6 +771,9 @@ void AudioClient::negotiateAudioFormat() {
         negotiateFormatPacket->writeString(codecName);
     }
 
+    // we spatialize the streams the mixer forwards rather than mixes
+    negotiateFormatPacket->writePrimitive(true);
+
     // grab our audio mixer from the NodeList, if it exists
     SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
 
@@ -1204,6 +1222,9 @@ void AudioClient::prepareLocalAudioInjectors(std::unique_ptr<Lock> localAudioLoc
     }
 }
 
+// below this gain (-80dB) a spatialized injector is not heard over anything else, so it is culled
+static const float LOCAL_INJECTOR_AUDIBILITY_THRESHOLD = 1e-4f;
+
 bool AudioClient::mixLocalAudioInjectors(float* mixBuffer) {
     // check the flag for injectors before attempting to lock
     if (!_localInjectorsAvailable.load(std::memory_order_acquire)) {
@@ -1213,88 +1234,143 @@ bool AudioClient::mixLocalAudioInjectors(float* mixBuffer) {
     // lock the injectors
     Lock lock(_injectorsMutex);
 
-    QVector<AudioInjectorPointer> injectorsToRemove;
-
     memset(mixBuffer, 0, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO * sizeof(float));
 
-    for (const AudioInjectorPointer& injector : _activeLocalAudioInjectors) {
-        // the lock guarantees that injectorBuffer, if found, is invariant
-        AudioInjectorLocalBuffer* injectorBuffer = injector->getLocalBuffer();
-        if (injectorBuffer) {
+    // the listener is sampled once, so that every injector is heard from the same place
+    glm::vec3 listenerPosition = _positionGetter();
+    glm::quat listenerOrientation = _orientationGetter();
 
-            static const int HRTF_DATASET_INDEX = 1;
+    int numInjectors = _activeLocalAudioInjectors.size();
+    QVector<char> isFinished(numInjectors, false);
 
-            int numChannels = injector->isAmbisonic() ? AudioConstants::AMBISONIC : (injector->isStereo() ? AudioConstants::STEREO : AudioConstants::MONO);
-            size_t bytesToRead = numChannels * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
+    auto mixInjectors = [&](int begin, int end, float* workerMixBuffer, int16_t* workerScratchBuffer) {
+        for (int i = begin; i < end; i++) {
+            isFinished[i] = !mixLocalAudioInjector(_activeLocalAudioInjectors[i], workerMixBuffer, workerScratchBuffer,
+                                                   listenerPosition, listenerOrientation);
+        }
+    };
+
+    // with many injectors, the frame is split across the workers, each into its own mix
+    int numWorkers = std::min(numInjectors / MIN_INJECTORS_PER_WORKER, MAX_LOCAL_INJECTOR_WORKERS);
+    if (numWorkers > 1) {
+        int injectorsPerWorker = (numInjectors + numWorkers - 1) / numWorkers;
+
+        QVector<QFuture<void>> workers;
+        for (int worker = 1; worker < numWorkers; worker++) {
+            int begin = worker * injectorsPerWorker;
+            int end = std::min(begin + injectorsPerWorker, numInjectors);
+            float* workerMixBuffer = _localInjectorsWorkerBuffers[worker - 1].mix;
+            int16_t* workerScratchBuffer = _localInjectorsWorkerBuffers[worker - 1].scratch;
+            memset(workerMixBuffer, 0, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO * sizeof(float));
+            workers.append(QtConcurrent::run(&_localInjectorsThreadPool, [&, begin, end, workerMixBuffer, workerScratchBuffer] {
+                mixInjectors(begin, end, workerMixBuffer, workerScratchBuffer);
+            }));
+        }
 
-            // get one frame from the injector
-            memset(_localScratchBuffer, 0, bytesToRead);
-            if (0 < injectorBuffer->readData((char*)_localScratchBuffer, bytesToRead)) {
+        // this thread takes the first share
+        mixInjectors(0, injectorsPerWorker, mixBuffer, _localScratchBuffer);
 
-                if (injector->isAmbisonic()) {
+        for (int worker = 1; worker < numWorkers; worker++) {
+            workers[worker - 1].waitForFinished();
+            const float* workerMixBuffer = _localInjectorsWorkerBuffers[worker - 1].mix;
+            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
+                mixBuffer[i] += workerMixBuffer[i];
+            }
+        }
+    } else {
+        mixInjectors(0, numInjectors, mixBuffer, _localScratchBuffer);
+    }
 
-                    // no distance attenuation
-                    float gain = injector->getVolume();
+    // finished injectors are removed on this thread, once the workers are done with them
+    QVector<AudioInjectorPointer> injectorsToRemove;
+    for (int i = 0; i < numInjectors; i++) {
+        if (isFinished[i]) {
+            const AudioInjectorPointer& injector = _activeLocalAudioInjectors[i];
+            qCDebug(audioclient) << "injector has no more data, marking finished for removal";
+            injector->finishLocalInjection();
+            injectorsToRemove.append(injector);
+        }
+    }
 
-                    //
-                    // Calculate the soundfield orientation relative to the listener.
-                    // Injector orientation can be used to align a recording to our world coordinates.
-                    //
-                    glm::quat relativeOrientation = injector->getOrientation() * glm::inverse(_orientationGetter());
+    for (const AudioInjectorPointer& injector : injectorsToRemove) {
+        qCDebug(audioclient) << "removing injector";
+        _activeLocalAudioInjectors.removeOne(injector);
+    }
 
-                    // convert from Y-up (OpenGL) to Z-up (Ambisonic) coordinate system
-                    float qw = relativeOrientation.w;
-                    float qx = -relativeOrientation.z;
-                    float qy = -relativeOrientation.x;
-                    float qz = relativeOrientation.y;
+    // update the flag
+    _localInjectorsAvailable.exchange(!_activeLocalAudioInjectors.empty(), std::memory_order_release);
 
-                    // Ambisonic gets spatialized into mixBuffer
-                    injector->getLocalFOA().render(_localScratchBuffer, mixBuffer, HRTF_DATASET_INDEX,
-                                                   qw, qx, qy, qz, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    return true;
+}
 
-                } else if (injector->isStereo()) {
+bool AudioClient::mixLocalAudioInjector(const AudioInjectorPointer& injector, float* mixBuffer, int16_t* scratchBuffer,
+                                        const glm::vec3& listenerPosition, const glm::quat& listenerOrientation) {
+    // the lock guarantees that injectorBuffer, if found, is invariant
+    AudioInjectorLocalBuffer* injectorBuffer = injector->getLocalBuffer();
+    if (!injectorBuffer) {
+        return false;
+    }
 
-                    // stereo gets directly mixed into mixBuffer
-                    float gain = injector->getVolume();
-                    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
-                        mixBuffer[i] += convertToFloat(_localScratchBuffer[i]) * gain;
-                    }
+    static const int HRTF_DATASET_INDEX = 1;
 
-                } else {
+    int numChannels = injector->isAmbisonic() ? AudioConstants::AMBISONIC : (injector->isStereo() ? AudioConstants::STEREO : AudioConstants::MONO);
+    size_t bytesToRead = numChannels * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
 
-                    // calculate distance, gain and azimuth for hrtf
-                    glm::vec3 relativePosition = injector->getPosition() - _positionGetter();
-                    float distance = glm::max(glm::length(relativePosition), EPSILON);
-                    float gain = gainForSource(distance, injector->getVolume());
-                    float azimuth = azimuthForSource(relativePosition);
+    // get one frame from the injector
+    memset(scratchBuffer, 0, bytesToRead);
+    if (0 >= injectorBuffer->readData((char*)scratchBuffer, bytesToRead)) {
+        return false;
+    }
 
-                    // mono gets spatialized into mixBuffer
-                    injector->getLocalHRTF().render(_localScratchBuffer, mixBuffer, HRTF_DATASET_INDEX,
-                                                    azimuth, distance, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-                }
+    if (injector->isAmbisonic()) {
 
-            } else {
+        // no distance attenuation
+        float gain = injector->getVolume();
 
-                qCDebug(audioclient) << "injector has no more data, marking finished for removal";
-                injector->finishLocalInjection();
-                injectorsToRemove.append(injector);
-            }
+        //
+        // Calculate the soundfield orientation relative to the listener.
+        // Injector orientation can be used to align a recording to our world coordinates.
+        //
+        glm::quat relativeOrientation = injector->getOrientation() * glm::inverse(listenerOrientation);
 
-        } else {
+        // convert from Y-up (OpenGL) to Z-up (Ambisonic) coordinate system
+        float qw = relativeOrientation.w;
+        float qx = -relativeOrientation.z;
+        float qy = -relativeOrientation.x;
+        float qz = relativeOrientation.y;
 
-            qCDebug(audioclient) << "injector has no local buffer, marking as finished for removal";
-            injector->finishLocalInjection();
-            injectorsToRemove.append(injector);
+        // Ambisonic gets spatialized into mixBuffer
+        injector->getLocalFOA().render(scratchBuffer, mixBuffer, HRTF_DATASET_INDEX,
+                                       qw, qx, qy, qz, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    } else if (injector->isStereo()) {
+
+        // stereo gets directly mixed into mixBuffer
+        float gain = injector->getVolume();
+        if (gain > 0.0f) {
+            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
+                mixBuffer[i] += convertToFloat(scratchBuffer[i]) * gain;
+            }
         }
-    }
 
-    for (const AudioInjectorPointer& injector : injectorsToRemove) {
-        qCDebug(audioclient) << "removing injector";
-        _activeLocalAudioInjectors.removeOne(injector);
-    }
+    } else {
 
-    // update the flag
-    _localInjectorsAvailable.exchange(!_activeLocalAudioInjectors.empty(), std::memory_order_release);
+        // calculate distance, gain and azimuth for hrtf
+        glm::vec3 relativePosition = injector->getPosition() - listenerPosition;
+        float distance = glm::max(glm::length(relativePosition), EPSILON);
+        float gain = gainForSource(distance, injector->getVolume());
+        float azimuth = azimuthForSource(relativePosition, listenerOrientation);
+
+        if (gain < LOCAL_INJECTOR_AUDIBILITY_THRESHOLD) {
+            // inaudible, though the hrtf follows along for when it is heard again
+            injector->getLocalHRTF().renderSilent(scratchBuffer, mixBuffer, HRTF_DATASET_INDEX,
+                                                  azimuth, distance, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        } else {
+            // mono gets spatialized into mixBuffer
+            injector->getLocalHRTF().render(scratchBuffer, mixBuffer, HRTF_DATASET_INDEX,
+                                            azimuth, distance, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        }
+    }
 
     return true;
 }
@@ -1759,8 +1835,8 @@ int AudioClient::calculateNumberOfFrameSamples(int numBytes) const {
     return frameSamples;
 }
 
-float AudioClient::azimuthForSource(const glm::vec3& relativePosition) {
-    glm::quat inverseOrientation = glm::inverse(_orientationGetter());
+float AudioClient::azimuthForSource(const glm::vec3& relativePosition, const glm::quat& listenerOrientation) {
+    glm::quat inverseOrientation = glm::inverse(listenerOrientation);
 
     glm::vec3 rotatedSourcePosition = inverseOrientation * relativePosition;
 
@@ -1811,10 +1887,10 @@ qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
     float* mixBuffer = _audio->_outputMixBuffer;
 
     int networkSamplesPopped;
-    if ((networkSamplesPopped = _receivedAudioStream.popSamples(samplesRequested, false)) > 0) {
+    bool hasStarted = _receivedAudioStream.hasStarted();
+    // the samples are copied out as they are popped, before the network thread may write over them
+    if ((networkSamplesPopped = _receivedAudioStream.popSamples(samplesRequested, false, scratchBuffer)) > 0) {
         qCDebug(audiostream, "Read %d samples from buffer (%d available, %d requested)", networkSamplesPopped, _receivedAudioStream.getSamplesAvailable(), samplesRequested);
-        AudioRingBuffer::ConstIterator lastPopOutput = _receivedAudioStream.getLastPopOutput();
-        lastPopOutput.readSamples(scratchBuffer, networkSamplesPopped);
 
         for (int i = 0; i < networkSamplesPopped; i++) {
             mixBuffer[i] = convertToFloat(scratchBuffer[i]);
@@ -1823,6 +1899,11 @@ qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
         samplesRequested = networkSamplesPopped;
     }
 
+    if (hasStarted && networkSamplesPopped < samplesRequested) {
+        // the network audio could not fill this callback
+        _audio->_stats.outputGlitch();
+    }
+
     int injectorSamplesPopped = 0;
     {
         bool append = networkSamplesPopped > 0;
@@ -1895,6 +1976,7 @@ qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
 void AudioClient::loadSettings() {
     _receivedAudioStream.setDynamicJitterBufferEnabled(dynamicJitterBufferEnabled.get());
     _receivedAudioStream.setStaticJitterBufferFrames(staticJitterBufferFrames.get());
+    _receivedAudioStream.setTimeStretchEnabled(jitterBufferTimeStretchEnabled.get());
 
     qCDebug(audioclient) << "---- Initializing Audio Client ----";
     auto codecPlugins = PluginManager::getInstance()->getCodecPlugins();
@@ -1907,6 +1989,7 @@ void AudioClient::loadSettings() {
 void AudioClient::saveSettings() {
     dynamicJitterBufferEnabled.set(_receivedAudioStream.dynamicJitterBufferEnabled());
     staticJitterBufferFrames.set(_receivedAudioStream.getStaticJitterBufferFrames());
+    jitterBufferTimeStretchEnabled.set(_receivedAudioStream.timeStretchEnabled());
 }
 
 void AudioClient::setAvatarBoundingBoxParameters(glm::vec3 corner, glm::vec3 scale) {
@@ -22,6 +22,7 @@
 #include <QtCore/QByteArray>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
+#include <QtCore/QThreadPool>
 #include <QtCore/QVector>
 #include <QtMultimedia/QAudio>
 #include <QtMultimedia/QAudioFormat>
@@ -247,7 +248,10 @@ private:
     void checkDevices();
     void prepareLocalAudioInjectors(std::unique_ptr<Lock> localAudioLock = nullptr);
     bool mixLocalAudioInjectors(float* mixBuffer);
-    float azimuthForSource(const glm::vec3& relativePosition);
+    // returns false once the injector has finished
+    bool mixLocalAudioInjector(const AudioInjectorPointer& injector, float* mixBuffer, int16_t* scratchBuffer,
+                               const glm::vec3& listenerPosition, const glm::quat& listenerOrientation);
+    float azimuthForSource(const glm::vec3& relativePosition, const glm::quat& listenerOrientation);
     float gainForSource(float distance, float volume);
 
     class Gate {
@@ -344,6 +348,16 @@ private:
     float* _localOutputMixBuffer { NULL };
     Mutex _localAudioMutex;
 
+    // with enough injectors, their mix is split across workers (used by audio injectors thread)
+    static const int MIN_INJECTORS_PER_WORKER = 8;
+    static const int MAX_LOCAL_INJECTOR_WORKERS = 4;
+    struct LocalInjectorsWorkerBuffers {
+        float mix[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        int16_t scratch[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+    };
+    LocalInjectorsWorkerBuffers _localInjectorsWorkerBuffers[MAX_LOCAL_INJECTOR_WORKERS - 1];
+    QThreadPool _localInjectorsThreadPool;
+
     AudioLimiter _audioLimiter;
 
     // Adds Reverb
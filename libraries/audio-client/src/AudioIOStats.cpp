@@ -44,9 +44,11 @@ void AudioIOStats::reset() {
     _inputMsRead.reset();
     _inputMsUnplayed.reset();
     _outputMsUnplayed.reset();
+    _outputGlitchCount.store(0);
     _packetTimegaps.reset();
 
     _interface->updateLocalBuffers(_inputMsRead, _inputMsUnplayed, _outputMsUnplayed, _packetTimegaps);
+    _interface->outputGlitchCount(0);
     _interface->updateMixerStream(AudioStreamStats());
     _interface->updateClientStream(AudioStreamStats());
     _interface->updateInjectorStreams(QHash<QUuid, AudioStreamStats>());
@@ -84,6 +86,10 @@ void AudioIOStats::processStreamStatsPacket(QSharedPointer<ReceivedMessage> mess
 
         if (streamStats._streamType == PositionalAudioStream::Microphone) {
             _interface->updateMixerStream(streamStats);
+
+            // the mixer reports what it lost of our microphone stream, send it parity if that is enough to matter
+            DependencyManager::get<NodeList>()->setFECLossRate(*sendingNode,
+                streamStats._packetStreamWindowStats.getLostRate());
         } else {
             _injectorStreams[streamStats._streamIdentifier] = streamStats;
         }
@@ -112,6 +118,7 @@ void AudioIOStats::publish() {
 
     // update the interface
     _interface->updateLocalBuffers(_inputMsRead, _inputMsUnplayed, _outputMsUnplayed, _packetTimegaps);
+    _interface->outputGlitchCount(_outputGlitchCount.load(std::memory_order_relaxed));
     _interface->updateClientStream(stats);
 
     // prepare a packet to the mixer
@@ -14,6 +14,8 @@
 
 #include "MovingMinMaxAvg.h"
 
+#include <atomic>
+
 #include <QObject>
 
 #include <AudioStreamStats.h>
@@ -73,6 +75,7 @@ class AudioStatsInterface : public QObject {
     AUDIO_PROPERTY(float, inputReadMsMax);
     AUDIO_PROPERTY(float, inputUnplayedMsMax);
     AUDIO_PROPERTY(float, outputUnplayedMsMax);
+    AUDIO_PROPERTY(int, outputGlitchCount);
 
     AUDIO_PROPERTY(quint64, sentTimegapMsMax);
     AUDIO_PROPERTY(quint64, sentTimegapMsAvg);
@@ -121,6 +124,8 @@ public:
     void updateInputMsRead(float ms) const { _inputMsRead.update(ms); }
     void updateInputMsUnplayed(float ms) const { _inputMsUnplayed.update(ms); }
     void updateOutputMsUnplayed(float ms) const { _outputMsUnplayed.update(ms); }
+    // called from the device callback, when the received audio falls short of a read
+    void outputGlitch() const { _outputGlitchCount.fetch_add(1, std::memory_order_relaxed); }
     void sentPacket() const;
 
     void publish();
@@ -134,6 +139,7 @@ private:
     mutable MovingMinMaxAvg<float> _inputMsRead;
     mutable MovingMinMaxAvg<float> _inputMsUnplayed;
     mutable MovingMinMaxAvg<float> _outputMsUnplayed;
+    mutable std::atomic<int> _outputGlitchCount { 0 };
 
     mutable quint64 _lastSentPacketTime;
     mutable MovingMinMaxAvg<quint64> _packetTimegaps;
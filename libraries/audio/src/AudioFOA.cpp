@@ -958,6 +958,26 @@ static void rotate_3x3(float* buf[4], const float m0[3][3], const float m1[3][3]
     (*f)(buf, m0, m1, win, numFrames);  // dispatch
 }
 
+#elif defined(__arm__) || defined(__aarch64__) || defined(_M_ARM) || defined(_M_ARM64)
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void rotate_3x3_NEON(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames);
+
+static auto& rfft512 = rfft512_ref;
+static auto& rifft512 = rifft512_ref;
+static auto& rfft512_cmadd_1X2 = rfft512_cmadd_1X2_ref;
+static auto& convertInput = convertInput_ref;
+
+static void rotate_3x3(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames) {
+    static auto f = cpuSupportsNEON() ? rotate_3x3_NEON : rotate_3x3_ref;
+    (*f)(buf, m0, m1, win, numFrames);  // dispatch
+}
+
 #else   // portable reference code
 
 static auto& rfft512 = rfft512_ref;
@@ -412,7 +412,7 @@ static void interpolate(float* dst, const float* src0, const float* src1, float
 #else   // portable reference code
 
 // 1 channel input, 4 channel output
-static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+static void FIR_1x4_ref(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
 
     float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
     float* coef1 = coef[1] + HRTF_TAPS - 1;
@@ -476,6 +476,28 @@ static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* ds
     }
 }
 
+#if defined(__arm__) || defined(__aarch64__) || defined(_M_ARM) || defined(_M_ARM64)
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void FIR_1x4_NEON(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+
+static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    static auto f = cpuSupportsNEON() ? FIR_1x4_NEON : FIR_1x4_ref;
+    (*f)(src, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
+}
+
+#else
+
+static auto& FIR_1x4 = FIR_1x4_ref;
+
+#endif
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -865,6 +887,13 @@ void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth,
     // apply global and local gain adjustment
     gain *= _gainAdjust;
 
+    if (_resetState) {
+        _azimuthState = azimuth;
+        _distanceState = distance;
+        _gainState = gain;
+        _resetState = false;
+    }
+
     // to avoid polluting the cache, old filters are recomputed instead of stored
     setFilters(firCoef, bqCoef, delay, index, _azimuthState, _distanceState, _gainState, L0);
 
@@ -951,3 +980,13 @@ void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azi
 
     _silentState = true;
 }
+
+void AudioHRTF::reset() {
+    memset(_firState, 0, sizeof(_firState));
+    memset(_delayState, 0, sizeof(_delayState));
+    memset(_bqState, 0, sizeof(_bqState));
+
+    // cleared filters have nothing left to flush
+    _silentState = true;
+    _resetState = true;
+}
@@ -44,6 +44,12 @@ public:
     //
     void renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
 
+    //
+    // Clears the filter history, for a source that was not rendered for a while.
+    // The next render starts from its own parameters instead of interpolating from stale ones.
+    //
+    void reset();
+
     //
     // HRTF local gain adjustment in amplitude (1.0 == unity)
     //
@@ -83,6 +89,7 @@ private:
     float _gainAdjust = HRTF_GAIN;
 
     bool _silentState = false;
+    bool _resetState = false;
 };
 
 #endif // AudioHRTF_h
@@ -101,7 +101,7 @@ void AudioInjector::restart() {
 
         if (!_options.localOnly) {
             // notify the AudioInjectorManager to wake up in case it's waiting for new injectors
-            injectorManager->notifyInjectorReadyCondition();
+            injectorManager->notifyInjectorReadyCondition(thread());
         }
 
         return;
@@ -213,11 +213,6 @@ int64_t AudioInjector::injectNextFrame() {
     }
 
     // if we haven't setup the packet to send then do so now
-    static int loopbackOptionOffset = -1;
-    static int positionOptionOffset = -1;
-    static int volumeOptionOffset = -1;
-    static int audioDataOffset = -1;
-
     if (!_currentPacket) {
         if (_currentSendOffset < 0 ||
             _currentSendOffset >= _audioData.size()) {
@@ -264,12 +259,12 @@ int64_t AudioInjector::injectNextFrame() {
             audioPacketStream << _options.stereo;
 
             // pack the flag for loopback, if requested
-            loopbackOptionOffset = _currentPacket->pos();
+            _loopbackOptionOffset = _currentPacket->pos();
             uchar loopbackFlag = (_localAudioInterface && _localAudioInterface->shouldLoopbackInjectors());
             audioPacketStream << loopbackFlag;
 
             // pack the position for injected audio
-            positionOptionOffset = _currentPacket->pos();
+            _positionOptionOffset = _currentPacket->pos();
             audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
                                            sizeof(_options.position));
 
@@ -288,12 +283,12 @@ int64_t AudioInjector::injectNextFrame() {
             audioPacketStream << radius;
 
             // pack 255 for attenuation byte
-            volumeOptionOffset = _currentPacket->pos();
+            _volumeOptionOffset = _currentPacket->pos();
             quint8 volume = MAX_INJECTOR_VOLUME;
             audioPacketStream << volume;
             audioPacketStream << _options.ignorePenumbra;
 
-            audioDataOffset = _currentPacket->pos();
+            _audioDataOffset = _currentPacket->pos();
 
         } else {
             // no samples to inject, return immediately
@@ -326,18 +321,18 @@ int64_t AudioInjector::injectNextFrame() {
     // pack the sequence number
     _currentPacket->writePrimitive(_outgoingSequenceNumber);
 
-    _currentPacket->seek(loopbackOptionOffset);
+    _currentPacket->seek(_loopbackOptionOffset);
     _currentPacket->writePrimitive((uchar)(_localAudioInterface && _localAudioInterface->shouldLoopbackInjectors()));
 
-    _currentPacket->seek(positionOptionOffset);
+    _currentPacket->seek(_positionOptionOffset);
     _currentPacket->writePrimitive(_options.position);
     _currentPacket->writePrimitive(_options.orientation);
 
     quint8 volume = packFloatGainToByte(_options.volume);
-    _currentPacket->seek(volumeOptionOffset);
+    _currentPacket->seek(_volumeOptionOffset);
     _currentPacket->writePrimitive(volume);
 
-    _currentPacket->seek(audioDataOffset);
+    _currentPacket->seek(_audioDataOffset);
 
     // This code is copying bytes from the _audioData directly into the packet, handling looping appropriately.
     // Might be a reasonable place to do the encode step here.
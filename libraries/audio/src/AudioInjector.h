@@ -113,6 +113,11 @@ private:
     float _loudness { 0.0f };
     int _currentSendOffset { 0 };
     std::unique_ptr<NLPacket> _currentPacket { nullptr };
+    // where in the packet the parts that change from one frame to the next are, it is packed on the injector's thread
+    int _loopbackOptionOffset { -1 };
+    int _positionOptionOffset { -1 };
+    int _volumeOptionOffset { -1 };
+    int _audioDataOffset { -1 };
     AudioInjectorLocalBuffer* _localBuffer { nullptr };
 
     int64_t _nextFrame { 0 };
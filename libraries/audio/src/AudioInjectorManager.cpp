@@ -11,6 +11,8 @@
 
 #include "AudioInjectorManager.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 
 #include <SharedUtil.h>
@@ -19,124 +21,167 @@
 #include "AudioInjector.h"
 #include "AudioLogging.h"
 
+static const int MAX_INJECTORS_PER_THREAD = 40; // calculated based on AudioInjector time to send frame, with sufficient padding
+static const int MAX_INJECTOR_THREADS = 4;
+
 AudioInjectorManager::~AudioInjectorManager() {
     _shouldStop = true;
 
-    Lock lock(_injectorsMutex);
+    Lock threadsLock(_threadsMutex);
 
-    // make sure any still living injectors are stopped and deleted
-    while (!_injectors.empty()) {
-        // grab the injector at the front
-        auto& timePointerPair = _injectors.top();
+    for (auto& injectorThread : _threads) {
+        Lock lock(injectorThread->injectorsMutex);
 
-        // ask it to stop and be deleted
-        timePointerPair.second->stop();
+        // make sure any still living injectors are stopped and deleted
+        while (!injectorThread->injectors.empty()) {
+            // grab the injector at the front
+            auto& timePointerPair = injectorThread->injectors.top();
 
-        _injectors.pop();
-    }
+            // ask it to stop and be deleted
+            timePointerPair.second->stop();
 
-    // get rid of the lock now that we've stopped all living injectors
-    lock.unlock();
+            injectorThread->injectors.pop();
+        }
 
-    // in case the thread is waiting for injectors wake it up now
-    _injectorReady.notify_one();
+        // in case the thread is waiting for injectors wake it up now
+        injectorThread->injectorReady.notify_one();
+    }
 
-    // quit and wait on the manager thread, if we ever created it
-    if (_thread) {
-        _thread->quit();
-        _thread->wait();
+    // quit and wait on the injector threads we created
+    for (auto& injectorThread : _threads) {
+        injectorThread->thread->quit();
+        injectorThread->thread->wait();
     }
 }
 
-void AudioInjectorManager::createThread() {
-    _thread = new QThread;
-    _thread->setObjectName("Audio Injector Thread");
+AudioInjectorManager::InjectorThread* AudioInjectorManager::createThread() {
+    auto injectorThread = new InjectorThread;
+    _threads.emplace_back(injectorThread);
 
-    // when the thread is started, have it call our run to handle injection of audio
-    connect(_thread, &QThread::started, this, &AudioInjectorManager::run, Qt::DirectConnection);
+    injectorThread->thread = new QThread;
+    injectorThread->thread->setObjectName("Audio Injector Thread " + QString::number(_threads.size()));
+
+    // when the thread is started, have it call our run to handle injection of audio on it
+    connect(injectorThread->thread, &QThread::started, this, [this, injectorThread] {
+        run(*injectorThread);
+    }, Qt::DirectConnection);
 
     // start the thread
-    _thread->start();
+    injectorThread->thread->start();
+
+    return injectorThread;
 }
 
-void AudioInjectorManager::run() {
+void AudioInjectorManager::run(InjectorThread& injectorThread) {
+    // the injectors that were due, they are sent from outside of the lock so that queueing others doesn't wait on them
+    std::vector<TimeInjectorPointerPair> heldInjectors;
+
     while (!_shouldStop) {
         // wait until the next injector is ready, or until we get a new injector given to us
-        Lock lock(_injectorsMutex);
+        Lock lock(injectorThread.injectorsMutex);
 
-        if (_injectors.size() > 0) {
+        if (injectorThread.injectors.size() > 0) {
             // when does the next injector need to send a frame?
             // do we get to wait or should we just go for it now?
-
-            auto timeInjectorPair = _injectors.top();
-
-            auto nextTimestamp = timeInjectorPair.first;
+            auto nextTimestamp = injectorThread.injectors.top().first;
             int64_t difference = int64_t(nextTimestamp - usecTimestampNow());
 
             if (difference > 0) {
-                _injectorReady.wait_for(lock, std::chrono::microseconds(difference));
+                // an injector queued in the meantime may be due before the one we were waiting on
+                injectorThread.injectorReady.wait_for(lock, std::chrono::microseconds(difference));
             }
 
-            if (_injectors.size() > 0) {
-                // loop through the injectors in the map and send whatever frames need to go out
-                auto front = _injectors.top();
-
-                // create an InjectorQueue to hold injectors to be queued
-                // this allows us to call processEvents even if a single injector wants to be re-queued immediately
-                std::vector<TimeInjectorPointerPair> heldInjectors;
-                heldInjectors.reserve(_injectors.size());
+            auto now = usecTimestampNow();
+            while (injectorThread.injectors.size() > 0 && injectorThread.injectors.top().first <= now) {
+                heldInjectors.push_back(injectorThread.injectors.top());
+                injectorThread.injectors.pop();
+            }
 
-                while (_injectors.size() > 0 && front.first <= usecTimestampNow()) {
-                    // either way we're popping this injector off - get a copy first
-                    auto injector = front.second;
-                    _injectors.pop();
+            lock.unlock();
 
-                    if (!injector.isNull()) {
-                        // this is an injector that's ready to go, have it send a frame now
-                        auto nextCallDelta = injector->injectNextFrame();
+            for (auto& timeInjectorPair : heldInjectors) {
+                auto& injector = timeInjectorPair.second;
 
-                        if (nextCallDelta >= 0 && !injector->isFinished()) {
-                            // enqueue the injector with the correct timing in our holding queue
-                            heldInjectors.emplace(heldInjectors.end(), usecTimestampNow() + nextCallDelta, injector);
-                        }
-                    }
+                if (!injector.isNull()) {
+                    // this is an injector that's ready to go, have it send a frame now
+                    auto nextCallDelta = injector->injectNextFrame();
 
-                    if (_injectors.size() > 0) {
-                        front = _injectors.top();
+                    if (nextCallDelta >= 0 && !injector->isFinished()) {
+                        // hold on to the injector with the correct timing until it goes back in the queue
+                        timeInjectorPair.first = usecTimestampNow() + nextCallDelta;
                     } else {
-                        // no more injectors to look at, break
-                        break;
+                        injector.reset();
                     }
                 }
-
-                // if there are injectors in the holding queue, push them to our persistent queue now
-                while (!heldInjectors.empty()) {
-                    _injectors.push(heldInjectors.back());
-                    heldInjectors.pop_back();
-                }
             }
-
         } else {
             // we have no current injectors, wait until we get at least one before we do anything
-            _injectorReady.wait(lock);
+            injectorThread.injectorReady.wait(lock);
+            lock.unlock();
         }
 
-        // unlock the lock in case something in process events needs to modify the queue
-        lock.unlock();
+        if (!heldInjectors.empty()) {
+            // push the injectors that want to send again back to the queue, this allows us to call processEvents
+            // even if a single injector wants to be re-queued immediately
+            lock.lock();
+            for (auto& timeInjectorPair : heldInjectors) {
+                if (!timeInjectorPair.second.isNull()) {
+                    injectorThread.injectors.push(timeInjectorPair);
+                }
+            }
+            lock.unlock();
+            heldInjectors.clear();
+        }
 
         QCoreApplication::processEvents();
     }
 }
 
-static const int MAX_INJECTORS_PER_THREAD = 40; // calculated based on AudioInjector time to send frame, with sufficient padding
+AudioInjectorManager::InjectorThread* AudioInjectorManager::findInjectorThread(QThread* thread) const {
+    auto it = std::find_if(_threads.cbegin(), _threads.cend(), [thread](const InjectorThreadPointer& injectorThread) {
+        return injectorThread->thread == thread;
+    });
+    return it != _threads.cend() ? it->get() : nullptr;
+}
+
+AudioInjectorManager::InjectorThread* AudioInjectorManager::pickInjectorThread() {
+    InjectorThread* leastBusyThread { nullptr };
+    size_t leastBusyCount { 0 };
 
-bool AudioInjectorManager::wouldExceedLimits() { // Should be called inside of a lock.
-    if (_injectors.size() >= MAX_INJECTORS_PER_THREAD) {
+    for (auto& injectorThread : _threads) {
+        Lock lock(injectorThread->injectorsMutex);
+        auto count = injectorThread->injectors.size();
+        if (!leastBusyThread || count < leastBusyCount) {
+            leastBusyThread = injectorThread.get();
+            leastBusyCount = count;
+        }
+    }
+
+    // only start another thread once each of the ones we have is sending for some injector
+    int maxThreads = std::max(1, std::min(QThread::idealThreadCount() / 2, MAX_INJECTOR_THREADS));
+    if ((!leastBusyThread || leastBusyCount > 0) && (int)_threads.size() < maxThreads) {
+        return createThread();
+    }
+
+    return leastBusyThread;
+}
+
+bool AudioInjectorManager::queueInjector(InjectorThread& injectorThread, const AudioInjectorPointer& injector) {
+    Lock lock(injectorThread.injectorsMutex);
+
+    if (injectorThread.injectors.size() >= MAX_INJECTORS_PER_THREAD) {
         qCDebug(audio)  << "AudioInjectorManager::threadInjector could not thread AudioInjector - at max of"
-            << MAX_INJECTORS_PER_THREAD << "current audio injectors.";
-        return true;
+            << MAX_INJECTORS_PER_THREAD << "current audio injectors on" << injectorThread.thread->objectName();
+        return false;
     }
-    return false;
+
+    // add the injector to the queue with a send timestamp of now
+    injectorThread.injectors.emplace(usecTimestampNow(), injector);
+
+    // notify our wait condition so we can inject two frames for this injector immediately
+    injectorThread.injectorReady.notify_one();
+
+    return true;
 }
 
 bool AudioInjectorManager::threadInjector(const AudioInjectorPointer& injector) {
@@ -145,27 +190,15 @@ bool AudioInjectorManager::threadInjector(const AudioInjectorPointer& injector)
         return false;
     }
 
-    // guard the injectors vector with a mutex
-    Lock lock(_injectorsMutex);
+    // guard the threads vector with a mutex
+    Lock threadsLock(_threadsMutex);
 
-    if (wouldExceedLimits()) {
-        return false;
-    } else {
-        if (!_thread) {
-            createThread();
-        }
-
-        // move the injector to the QThread
-        injector->moveToThread(_thread);
+    auto injectorThread = pickInjectorThread();
 
-        // add the injector to the queue with a send timestamp of now
-        _injectors.emplace(usecTimestampNow(), injector);
+    // move the injector to the thread it will be sent from
+    injector->moveToThread(injectorThread->thread);
 
-        // notify our wait condition so we can inject two frames for this injector immediately
-        _injectorReady.notify_one();
-
-        return true;
-    }
+    return queueInjector(*injectorThread, injector);
 }
 
 bool AudioInjectorManager::restartFinishedInjector(const AudioInjectorPointer& injector) {
@@ -174,17 +207,25 @@ bool AudioInjectorManager::restartFinishedInjector(const AudioInjectorPointer& i
         return false;
     }
 
-    // guard the injectors vector with a mutex
-    Lock lock(_injectorsMutex);
+    Lock threadsLock(_threadsMutex);
 
-    if (wouldExceedLimits()) {
-        return false;
-    } else {
-        // add the injector to the queue with a send timestamp of now
-        _injectors.emplace(usecTimestampNow(), injector);
+    // the injector goes back to the thread it was sent from before
+    auto injectorThread = findInjectorThread(injector->thread());
+    if (!injectorThread) {
+        threadsLock.unlock();
+        return threadInjector(injector);
+    }
+
+    return queueInjector(*injectorThread, injector);
+}
 
-        // notify our wait condition so we can inject two frames for this injector immediately
-        _injectorReady.notify_one();
+void AudioInjectorManager::notifyInjectorReadyCondition(QThread* thread) {
+    Lock threadsLock(_threadsMutex);
+
+    auto injectorThread = findInjectorThread(thread);
+    if (injectorThread) {
+        // taken so that the wake isn't missed by a thread that is about to wait
+        Lock lock(injectorThread->injectorsMutex);
+        injectorThread->injectorReady.notify_one();
     }
-    return true;
 }
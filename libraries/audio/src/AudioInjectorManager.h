@@ -14,9 +14,12 @@
 #ifndef hifi_AudioInjectorManager_h
 #define hifi_AudioInjectorManager_h
 
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <queue>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QPointer>
 #include <QtCore/QThread>
@@ -25,13 +28,14 @@
 
 #include "AudioInjector.h"
 
+// Network injectors are spread over a few threads, each with a queue of its own ordered by when its injectors next
+// have to send a frame. An injector stays on the thread it was given, so that its frames are only ever packed and
+// sent from one thread and its queued slots run there, and a thread only waits on its own queue.
 class AudioInjectorManager : public QObject, public Dependency {
     Q_OBJECT
     SINGLETON_DEPENDENCY
 public:
     ~AudioInjectorManager();
-private slots:
-    void run();
 private:
 
     using TimeInjectorPointerPair = std::pair<uint64_t, AudioInjectorPointer>;
@@ -48,22 +52,34 @@ private:
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
 
+    struct InjectorThread {
+        QThread* thread { nullptr };
+        InjectorQueue injectors;
+        Mutex injectorsMutex;
+        std::condition_variable injectorReady;
+    };
+    using InjectorThreadPointer = std::unique_ptr<InjectorThread>;
+
+    void run(InjectorThread& injectorThread);
+
     bool threadInjector(const AudioInjectorPointer& injector);
     bool restartFinishedInjector(const AudioInjectorPointer& injector);
-    void notifyInjectorReadyCondition() { _injectorReady.notify_one(); }
-    bool wouldExceedLimits();
+    void notifyInjectorReadyCondition(QThread* thread);
+    bool queueInjector(InjectorThread& injectorThread, const AudioInjectorPointer& injector);
+
+    // should be called with _threadsMutex locked
+    InjectorThread* findInjectorThread(QThread* thread) const;
+    InjectorThread* pickInjectorThread();
 
     AudioInjectorManager() {};
     AudioInjectorManager(const AudioInjectorManager&) = delete;
     AudioInjectorManager& operator=(const AudioInjectorManager&) = delete;
 
-    void createThread();
+    InjectorThread* createThread();
 
-    QThread* _thread { nullptr };
-    bool _shouldStop { false };
-    InjectorQueue _injectors;
-    Mutex _injectorsMutex;
-    std::condition_variable _injectorReady;
+    std::atomic<bool> _shouldStop { false };
+    std::vector<InjectorThreadPointer> _threads;
+    mutable Mutex _threadsMutex;
 
     friend class AudioInjector;
 };
@@ -1779,9 +1779,18 @@ AudioReverb::~AudioReverb() {
     delete[] _inout[1];
 }
 
+// the tail is considered decayed at -96dB, one LSB below full scale
+static const float TAIL_DECAY_DB = 96.0f;
+static const float SILENCE_THRESHOLD = 1/32768.0f;
+
 void AudioReverb::setParameters(ReverbParameters *p) {
     _params = *p;
     _impl->setParameters(p);
+
+    // reverbTime is the time to decay by 60dB, after both delays
+    float sampleRate = MIN(MAX(p->sampleRate, 24000.0f), 48000.0f);
+    float tailSeconds = p->reverbTime * (TAIL_DECAY_DB / 60.0f) + (p->preDelay + p->lateDelay) * (1/1000.0f);
+    _tailFrames = (int)(MIN(MAX(tailSeconds, 0.0f), 200.0f) * sampleRate);
 };
 
 void AudioReverb::getParameters(ReverbParameters *p) {
@@ -1790,10 +1799,42 @@ void AudioReverb::getParameters(ReverbParameters *p) {
 
 void AudioReverb::reset() {
     _impl->reset();
+    _silentFrames = 0;
+    _isIdle = false;
+}
+
+void AudioReverb::process(float** inputs, float** outputs, int numFrames) {
+
+    bool isSilent = true;
+    for (int i = 0; i < numFrames && isSilent; i++) {
+        isSilent = fabsf(inputs[0][i]) < SILENCE_THRESHOLD && fabsf(inputs[1][i]) < SILENCE_THRESHOLD;
+    }
+
+    if (!isSilent) {
+        _silentFrames = 0;
+        _isIdle = false;
+    } else if (!_isIdle) {
+        _silentFrames += numFrames;
+        if (_silentFrames > _tailFrames) {
+            // clear what is left of the tail, so that the reverb resumes from silence
+            _impl->reset();
+            _isIdle = true;
+        }
+    }
+
+    if (_isIdle) {
+        float dryMix = 1.0f - MIN(MAX(_params.wetDryMix * (1/100.0f), 0.0f), 1.0f);
+        for (int i = 0; i < numFrames; i++) {
+            outputs[0][i] = inputs[0][i] * dryMix;
+            outputs[1][i] = inputs[1][i] * dryMix;
+        }
+    } else {
+        _impl->process(inputs, outputs, numFrames);
+    }
 }
 
 void AudioReverb::render(float** inputs, float** outputs, int numFrames) {
-    _impl->process(inputs, outputs, numFrames);
+    process(inputs, outputs, numFrames);
 }
 
 //
@@ -2015,7 +2056,7 @@ void AudioReverb::render(const int16_t* input, int16_t* output, int numFrames) {
 
         convertInput(input, _inout, n);
 
-        _impl->process(_inout, _inout, n);
+        process(_inout, _inout, n);
 
         convertOutput(_inout, output, n);
 
@@ -2036,7 +2077,7 @@ void AudioReverb::render(const float* input, float* output, int numFrames) {
 
         convertInput(input, _inout, n);
 
-        _impl->process(_inout, _inout, n);
+        process(_inout, _inout, n);
 
         convertOutput(_inout, output, n);
 
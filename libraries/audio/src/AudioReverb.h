@@ -73,6 +73,14 @@ private:
 
     float* _inout[2];
 
+    // Once the input has been silent for longer than the tail takes to decay,
+    // only the dry path is rendered until the input is heard again.
+    void process(float** inputs, float** outputs, int numFrames);
+
+    int _tailFrames = 0;
+    int _silentFrames = 0;
+    bool _isIdle = false;
+
     void convertInput(const int16_t* input, float** outputs, int numFrames);
     void convertOutput(float** inputs, int16_t* output, int numFrames);
 
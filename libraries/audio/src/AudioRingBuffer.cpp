@@ -36,8 +36,8 @@ AudioRingBufferTemplate<T>::AudioRingBufferTemplate(int numFrameSamples, int num
     if (numFrameSamples) {
         _buffer = new Sample[_bufferLength];
         memset(_buffer, 0, _bufferLength * SampleSize);
-        _nextOutput = _buffer;
-        _endOfLastWrite = _buffer;
+        _nextOutput.store(_buffer);
+        _endOfLastWrite.store(_buffer);
     }
 
     static QString repeatedOverflowMessage = LogHandler::getInstance().addRepeatedMessageRegex(RING_BUFFER_OVERFLOW_DEBUG);
@@ -51,8 +51,8 @@ AudioRingBufferTemplate<T>::~AudioRingBufferTemplate() {
 
 template <class T>
 void AudioRingBufferTemplate<T>::clear() {
-    _endOfLastWrite = _buffer;
-    _nextOutput = _buffer;
+    _endOfLastWrite.store(_buffer);
+    _nextOutput.store(_buffer);
 }
 
 template <class T>
@@ -102,20 +102,22 @@ int AudioRingBufferTemplate<T>::readData(char *data, int maxSize) {
     // only copy up to the number of samples we have available
     int maxSamples = maxSize / SampleSize;
     int numReadSamples = std::min(maxSamples, samplesAvailable());
+    Sample* nextOutput = _nextOutput.load(std::memory_order_relaxed);
 
-    if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
+    if (nextOutput + numReadSamples > _buffer + _bufferLength) {
         // we're going to need to do two reads to get this data, it wraps around the edge
-        int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
+        int numSamplesToEnd = (_buffer + _bufferLength) - nextOutput;
 
         // read to the end of the buffer
-        memcpy(data, _nextOutput, numSamplesToEnd * SampleSize);
+        memcpy(data, nextOutput, numSamplesToEnd * SampleSize);
 
         // read the rest from the beginning of the buffer
         memcpy(data + (numSamplesToEnd * SampleSize), _buffer, (numReadSamples - numSamplesToEnd) * SampleSize);
     } else {
-        memcpy(data, _nextOutput, numReadSamples * SampleSize);
+        memcpy(data, nextOutput, numReadSamples * SampleSize);
     }
 
+    // the samples are copied before the producer may reuse them
     shiftReadPosition(numReadSamples);
 
     return numReadSamples * SampleSize;
@@ -128,10 +130,10 @@ int AudioRingBufferTemplate<T>::appendData(char *data, int maxSize) {
     int numReadSamples = std::min(maxSamples, samplesAvailable());
 
     Sample* dest = reinterpret_cast<Sample*>(data);
-    Sample* output = _nextOutput;
-    if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
+    Sample* output = _nextOutput.load(std::memory_order_relaxed);
+    if (output + numReadSamples > _buffer + _bufferLength) {
         // we're going to need to do two reads to get this data, it wraps around the edge
-        int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
+        int numSamplesToEnd = (_buffer + _bufferLength) - output;
 
         // read to the end of the buffer
         for (int i = 0; i < numSamplesToEnd; i++) {
@@ -158,43 +160,56 @@ template <class T>
 int AudioRingBufferTemplate<T>::writeData(const char* data, int maxSize) {
     // only copy up to the number of samples we have capacity for
     int maxSamples = maxSize / SampleSize;
-    int numWriteSamples = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-
-    if (numWriteSamples > samplesRoomFor) {
-        // there's not enough room for this write. erase old data to make room for this new data
-        int samplesToDelete = numWriteSamples - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-
-        qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
-    }
+    int numWriteSamples = reserveWrite(std::min(maxSamples, _sampleCapacity));
+    Sample* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
 
-    if (_endOfLastWrite + numWriteSamples > _buffer + _bufferLength) {
+    if (endOfLastWrite + numWriteSamples > _buffer + _bufferLength) {
         // we're going to need to do two writes to set this data, it wraps around the edge
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
 
         // write to the end of the buffer
-        memcpy(_endOfLastWrite, data, numSamplesToEnd * SampleSize);
+        memcpy(endOfLastWrite, data, numSamplesToEnd * SampleSize);
 
         // write the rest to the beginning of the buffer
         memcpy(_buffer, data + (numSamplesToEnd * SampleSize), (numWriteSamples - numSamplesToEnd) * SampleSize);
     } else {
-        memcpy(_endOfLastWrite, data, numWriteSamples * SampleSize);
+        memcpy(endOfLastWrite, data, numWriteSamples * SampleSize);
     }
 
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, numWriteSamples);
+    // the samples are copied before the consumer may read them
+    _endOfLastWrite.store(shiftedPositionAccomodatingWrap(endOfLastWrite, numWriteSamples), std::memory_order_release);
 
     return numWriteSamples * SampleSize;
 }
 
+template <class T>
+int AudioRingBufferTemplate<T>::reserveWrite(int numWriteSamples) {
+    int samplesRoomFor = _sampleCapacity - samplesAvailable();
+
+    if (numWriteSamples > samplesRoomFor) {
+        _overflowCount++;
+        qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
+
+        if (_isSingleProducerConsumer) {
+            // the read position belongs to the consumer, drop the new data that does not fit
+            return samplesRoomFor;
+        }
+
+        // there's not enough room for this write. erase old data to make room for this new data
+        int samplesToDelete = numWriteSamples - samplesRoomFor;
+        shiftReadPosition(samplesToDelete);
+    }
+    return numWriteSamples;
+}
+
 template <class T>
 int AudioRingBufferTemplate<T>::samplesAvailable() const {
-    if (!_endOfLastWrite) {
+    Sample* endOfLastWrite = _endOfLastWrite.load(std::memory_order_acquire);
+    if (!endOfLastWrite) {
         return 0;
     }
 
-    int sampleDifference = _endOfLastWrite - _nextOutput;
+    int sampleDifference = endOfLastWrite - _nextOutput.load(std::memory_order_acquire);
     if (sampleDifference < 0) {
         sampleDifference += _bufferLength;
     }
@@ -227,15 +242,16 @@ int AudioRingBufferTemplate<T>::addSilentSamples(int silentSamples) {
         qCDebug(audio) << qPrintable(DROPPED_SILENT_DEBUG);
     }
 
-    if (_endOfLastWrite + numWriteSamples > _buffer + _bufferLength) {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memset(_endOfLastWrite, 0, numSamplesToEnd * SampleSize);
+    Sample* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
+    if (endOfLastWrite + numWriteSamples > _buffer + _bufferLength) {
+        int numSamplesToEnd = (_buffer + _bufferLength) - endOfLastWrite;
+        memset(endOfLastWrite, 0, numSamplesToEnd * SampleSize);
         memset(_buffer, 0, (numWriteSamples - numSamplesToEnd) * SampleSize);
     } else {
-        memset(_endOfLastWrite, 0, numWriteSamples * SampleSize);
+        memset(endOfLastWrite, 0, numWriteSamples * SampleSize);
     }
 
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, numWriteSamples);
+    _endOfLastWrite.store(shiftedPositionAccomodatingWrap(endOfLastWrite, numWriteSamples), std::memory_order_release);
 
     return numWriteSamples;
 }
@@ -268,44 +284,32 @@ float AudioRingBufferTemplate<T>::getFrameLoudness(ConstIterator frameStart) con
 
 template <class T>
 int AudioRingBufferTemplate<T>::writeSamples(ConstIterator source, int maxSamples) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
-    }
+    int samplesToCopy = reserveWrite(std::min(maxSamples, _sampleCapacity));
 
     Sample* bufferLast = _buffer + _bufferLength - 1;
+    Sample* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = *source;
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = *source;
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.store(endOfLastWrite, std::memory_order_release);
 
     return samplesToCopy;
 }
 
 template <class T>
 int AudioRingBufferTemplate<T>::writeSamplesWithFade(ConstIterator source, int maxSamples, float fade) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
-    }
+    int samplesToCopy = reserveWrite(std::min(maxSamples, _sampleCapacity));
 
     Sample* bufferLast = _buffer + _bufferLength - 1;
+    Sample* endOfLastWrite = _endOfLastWrite.load(std::memory_order_relaxed);
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = (Sample)((float)(*source) * fade);
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        *endOfLastWrite = (Sample)((float)(*source) * fade);
+        endOfLastWrite = (endOfLastWrite == bufferLast) ? _buffer : endOfLastWrite + 1;
         ++source;
     }
+    _endOfLastWrite.store(endOfLastWrite, std::memory_order_release);
 
     return samplesToCopy;
 }
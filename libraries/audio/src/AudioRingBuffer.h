@@ -14,6 +14,8 @@
 
 #include "AudioConstants.h"
 
+#include <atomic>
+
 #include <QtCore/QIODevice>
 
 #include <SharedUtil.h>
@@ -21,6 +23,9 @@
 
 const int DEFAULT_RING_BUFFER_FRAME_CAPACITY = 10;
 
+// keeps the read and write positions, which are updated by different threads, from sharing a cache line
+const int RING_BUFFER_CACHE_LINE_SIZE = 64;
+
 template <class T>
 class AudioRingBufferTemplate {
     using Sample = T;
@@ -48,9 +53,18 @@ public:
     // Reading and writing to the buffer uses minimal shared data, such that
     // in cases that avoid overwriting the buffer, a single producer/consumer
     // may use this as a lock-free pipe (see audio-client/src/AudioClient.cpp).
+    // The read position is only written by reads, and the write position by writes,
+    // each published with release semantics once the samples are copied.
     // IMPORTANT: Avoid changes to the implementation that touch shared data unless you can
     // maintain this behavior.
 
+    /// In single producer/consumer mode a write never moves the read position:
+    /// the samples that do not fit are dropped (and counted as an overflow) instead of the oldest ones,
+    /// so the consumer may read from another thread without a lock.
+    /// Only reads, skips and shiftReadPosition() may then move the read position.
+    void setSingleProducerConsumer(bool enabled) { _isSingleProducerConsumer = enabled; }
+    bool isSingleProducerConsumer() const { return _isSingleProducerConsumer; }
+
     /// Read up to maxSamples into destination (will only read up to samplesAvailable())
     /// Returns number of read samples
     int readSamples(Sample* destination, int maxSamples);
@@ -85,17 +99,20 @@ public:
     int writeData(const char* source, int maxSize);
 
     /// Returns a reference to the index-th sample offset from the current read sample
-    Sample& operator[](const int index) { return *shiftedPositionAccomodatingWrap(_nextOutput, index); }
-    const Sample& operator[] (const int index) const { return *shiftedPositionAccomodatingWrap(_nextOutput, index); }
+    Sample& operator[](const int index) { return *shiftedPositionAccomodatingWrap(_nextOutput.load(), index); }
+    const Sample& operator[] (const int index) const { return *shiftedPositionAccomodatingWrap(_nextOutput.load(), index); }
 
     /// Essentially discards the next numSamples from the ring buffer
     /// NOTE: This is not checked - it is possible to shift past written data
     ///       Use samplesAvailable() to see the distance a valid shift can go
-    void shiftReadPosition(unsigned int numSamples) { _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numSamples); }
+    void shiftReadPosition(unsigned int numSamples) {
+        _nextOutput.store(shiftedPositionAccomodatingWrap(_nextOutput.load(std::memory_order_relaxed), numSamples),
+                          std::memory_order_release);
+    }
 
     int samplesAvailable() const;
     int framesAvailable() const { return (_numFrameSamples == 0) ? 0 : samplesAvailable() / _numFrameSamples; }
-    float getNextOutputFrameLoudness() const { return getFrameLoudness(_nextOutput); }
+    float getNextOutputFrameLoudness() const { return getFrameLoudness(_nextOutput.load()); }
 
 
     int getNumFrameSamples() const { return _numFrameSamples; }
@@ -199,10 +216,10 @@ public:
     };
 
     ConstIterator nextOutput() const {
-        return ConstIterator(_buffer, _bufferLength, _nextOutput);
+        return ConstIterator(_buffer, _bufferLength, _nextOutput.load(std::memory_order_acquire));
     }
     ConstIterator lastFrameWritten() const {
-        return ConstIterator(_buffer, _bufferLength, _endOfLastWrite) - _numFrameSamples;
+        return ConstIterator(_buffer, _bufferLength, _endOfLastWrite.load(std::memory_order_acquire)) - _numFrameSamples;
     }
 
     int writeSamples(ConstIterator source, int maxSamples);
@@ -214,15 +231,22 @@ protected:
     Sample* shiftedPositionAccomodatingWrap(Sample* position, int numSamplesShift) const;
     float getFrameLoudness(const Sample* frameStart) const;
 
+    // makes room for numWriteSamples, returns how many of them may be written
+    int reserveWrite(int numWriteSamples);
+
     int _numFrameSamples;
     int _frameCapacity;
     int _sampleCapacity;
     int _bufferLength; // actual _buffer length (_sampleCapacity + 1)
-    int _overflowCount{ 0 }; // times the ring buffer has overwritten data
+    int _overflowCount{ 0 }; // times the ring buffer has overwritten (or, with a single producer/consumer, dropped) data
+    bool _isSingleProducerConsumer{ false };
 
-    Sample* _nextOutput{ nullptr };
-    Sample* _endOfLastWrite{ nullptr };
     Sample* _buffer{ nullptr };
+
+    // written by the consumer
+    alignas(RING_BUFFER_CACHE_LINE_SIZE) std::atomic<Sample*> _nextOutput{ nullptr };
+    // written by the producer
+    alignas(RING_BUFFER_CACHE_LINE_SIZE) std::atomic<Sample*> _endOfLastWrite{ nullptr };
 };
 
 // expose explicit instantiations for scratch/mix buffers
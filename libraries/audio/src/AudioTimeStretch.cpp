@@ -0,0 +1,138 @@
+//
+//  AudioTimeStretch.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "AudioTimeStretch.h"
+
+// the splice is cross-faded over 2ms, at a lag of one 2.5ms to 6ms period (voiced speech is 80Hz and up,
+// and lower voices match at a multiple of their period anyway)
+static const float OVERLAP_SECONDS = 0.002f;
+static const float MIN_LAG_SECONDS = 0.0025f;
+static const float MAX_LAG_SECONDS = 0.006f;
+
+AudioTimeStretch::AudioTimeStretch(int sampleRate, int numChannels) :
+    _sampleRate(sampleRate),
+    _numChannels(numChannels),
+    _overlap((int)(OVERLAP_SECONDS * sampleRate)),
+    _minLag((int)(MIN_LAG_SECONDS * sampleRate)),
+    _maxLag((int)(MAX_LAG_SECONDS * sampleRate)) {
+    assert(numChannels > 0);
+    assert(_overlap > 0);
+}
+
+int AudioTimeStretch::findBestLag(const int16_t* input, int maxLag) {
+    int numFrames = maxLag + _overlap;
+
+    // the lag is searched on the sum of the channels
+    _mono.resize(numFrames);
+    for (int i = 0; i < numFrames; i++) {
+        float sum = 0.0f;
+        for (int c = 0; c < _numChannels; c++) {
+            sum += (float)input[i * _numChannels + c];
+        }
+        _mono[i] = sum;
+    }
+
+    const float* head = _mono.data();
+
+    float headEnergy = 0.0f;
+    for (int i = 0; i < _overlap; i++) {
+        headEnergy += head[i] * head[i];
+    }
+
+    float lagEnergy = 0.0f;
+    for (int i = 0; i < _overlap; i++) {
+        lagEnergy += head[_minLag + i] * head[_minLag + i];
+    }
+
+    int bestLag = _minLag;
+    float bestScore = -1.0f;
+    for (int lag = _minLag; lag <= maxLag; lag++) {
+        const float* segment = head + lag;
+
+        float correlation = 0.0f;
+        for (int i = 0; i < _overlap; i++) {
+            correlation += head[i] * segment[i];
+        }
+
+        // normalized, so a loud segment is no better a match than a quiet one
+        float energy = headEnergy * lagEnergy;
+        float score = (energy > 0.0f) ? correlation / sqrtf(energy) : 0.0f;
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+
+        // slide the energy of the lagged segment
+        if (lag < maxLag) {
+            lagEnergy += segment[_overlap] * segment[_overlap] - segment[0] * segment[0];
+            lagEnergy = std::max(lagEnergy, 0.0f);
+        }
+    }
+    return bestLag;
+}
+
+int AudioTimeStretch::render(const int16_t* input, int16_t* output, int numFrames, float speed) {
+
+    if (speed == 1.0f) {
+        _stretchFrames = 0.0f;
+    } else {
+        _stretchFrames += (speed - 1.0f) * numFrames;
+    }
+
+    int maxLag = std::min(_maxLag, numFrames - _overlap);
+    bool canSplice = maxLag >= _minLag;
+
+    if (!canSplice || fabsf(_stretchFrames) < (float)_minLag) {
+        memcpy(output, input, numFrames * _numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    int lag = findBestLag(input, maxLag);
+    bool shorten = _stretchFrames > 0.0f;
+
+    // cross-fade between the head of the block and the segment a lag later
+    const int16_t* fadeOut = shorten ? input : input + lag * _numChannels;
+    const int16_t* fadeIn = shorten ? input + lag * _numChannels : input;
+    int16_t* fade = output;
+    int numOutputFrames = numFrames;
+
+    if (shorten) {
+        // x[0, overlap) x-fade x[lag, lag + overlap), then x[lag + overlap, end)
+        numOutputFrames -= lag;
+        _stretchFrames -= lag;
+    } else {
+        // x[0, lag), then x[lag, lag + overlap) x-fade x[0, overlap), then x[overlap, end)
+        memcpy(output, input, lag * _numChannels * sizeof(int16_t));
+        fade += lag * _numChannels;
+        numOutputFrames += lag;
+        _stretchFrames += lag;
+    }
+
+    for (int i = 0; i < _overlap; i++) {
+        float weight = ((float)i + 0.5f) / (float)_overlap;
+        for (int c = 0; c < _numChannels; c++) {
+            int j = i * _numChannels + c;
+            float sample = (1.0f - weight) * (float)fadeOut[j] + weight * (float)fadeIn[j];
+            fade[j] = (int16_t)std::max(std::min(sample, 32767.0f), -32768.0f);
+        }
+    }
+
+    const int16_t* tail = fadeIn + _overlap * _numChannels;
+    int tailFrames = (int)(input + numFrames * _numChannels - tail) / _numChannels;
+    memcpy(fade + _overlap * _numChannels, tail, tailFrames * _numChannels * sizeof(int16_t));
+
+    return numOutputFrames;
+}
@@ -0,0 +1,58 @@
+//
+//  AudioTimeStretch.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretch_h
+#define hifi_AudioTimeStretch_h
+
+#include <stdint.h>
+#include <vector>
+
+//
+// Changes the playout speed of a stream by a few percent without changing its pitch (WSOLA).
+// Now and then a block is shortened or lengthened by about a pitch period: the block is cross-faded
+// with itself at the lag where it best matches, so the splice is not heard.
+//
+class AudioTimeStretch {
+public:
+    AudioTimeStretch(int sampleRate, int numChannels);
+
+    int getSampleRate() const { return _sampleRate; }
+    int getNumChannels() const { return _numChannels; }
+
+    // the most frames render() can add to a block
+    int getMaxStretchFrames() const { return _maxLag; }
+
+    //
+    // input: interleaved int16_t block
+    // output: interleaved int16_t, room for numFrames + getMaxStretchFrames() frames (in-place is not allowed)
+    // speed: playout speed (1.0 == unchanged), above 1.0 shortens the stream
+    // returns the number of output frames
+    //
+    int render(const int16_t* input, int16_t* output, int numFrames, float speed);
+
+    void reset() { _stretchFrames = 0.0f; }
+
+private:
+    int findBestLag(const int16_t* input, int maxLag);
+
+    int _sampleRate;
+    int _numChannels;
+
+    int _overlap;   // cross-fade length, in frames
+    int _minLag;
+    int _maxLag;
+
+    // frames owed to the requested speed, spent a lag at a time
+    float _stretchFrames { 0.0f };
+
+    std::vector<float> _mono;
+};
+
+#endif // hifi_AudioTimeStretch_h
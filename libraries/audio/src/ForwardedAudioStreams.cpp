@@ -0,0 +1,183 @@
+//
+//  ForwardedAudioStreams.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardedAudioStreams.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <NLPacket.h>
+#include <UUID.h>
+
+#include "AudioConstants.h"
+
+// the mixer spatializes with the same subject
+static const int HRTF_DATASET_INDEX = 1;
+
+// the decoders and filters of streams that stopped being forwarded are released after about a second
+static const unsigned int STALE_STREAM_FRAMES = 100;
+
+static const size_t STREAM_HEADER_SIZE = 2 * NUM_BYTES_RFC4122_UUID + 3 * sizeof(float) + sizeof(quint8);
+
+ForwardedAudioStreams::~ForwardedAudioStreams() {
+    clear();
+}
+
+size_t ForwardedAudioStreams::getSizeOnWire(const ForwardedAudioStream& stream) {
+    size_t size = STREAM_HEADER_SIZE;
+    for (const auto& frame : stream.frames) {
+        size += sizeof(quint16) + frame.size();
+    }
+    return size;
+}
+
+void ForwardedAudioStreams::write(NLPacket& packet, const std::vector<ForwardedAudioStream>& streams) {
+    packet.writePrimitive((quint8)streams.size());
+    for (const auto& stream : streams) {
+        packet.write(stream.nodeID.toRfc4122());
+        packet.write(stream.streamID.toRfc4122());
+        packet.writePrimitive(stream.azimuth);
+        packet.writePrimitive(stream.distance);
+        packet.writePrimitive(stream.gain);
+        packet.writePrimitive((quint8)stream.frames.size());
+        for (const auto& frame : stream.frames) {
+            packet.writePrimitive((quint16)frame.size());
+            packet.write(frame);
+        }
+    }
+}
+
+int ForwardedAudioStreams::parse(const QByteArray& packetAfterCodec) {
+    _parsedStreams.clear();
+
+    const char* data = packetAfterCodec.constData();
+    const char* end = data + packetAfterCodec.size();
+    auto readBytes = [&](void* destination, size_t size) {
+        if ((size_t)(end - data) < size) {
+            return false;
+        }
+        memcpy(destination, data, size);
+        data += size;
+        return true;
+    };
+
+    quint8 numStreams;
+    if (!readBytes(&numStreams, sizeof(numStreams))) {
+        return -1;
+    }
+    _parsedStreams.resize(numStreams);
+    for (auto& stream : _parsedStreams) {
+        char uuids[2 * NUM_BYTES_RFC4122_UUID];
+        quint8 numFrames;
+        if (!readBytes(uuids, sizeof(uuids)) || !readBytes(&stream.azimuth, sizeof(float)) ||
+            !readBytes(&stream.distance, sizeof(float)) || !readBytes(&stream.gain, sizeof(float)) ||
+            !readBytes(&numFrames, sizeof(numFrames))) {
+            _parsedStreams.clear();
+            return -1;
+        }
+        stream.nodeID = QUuid::fromRfc4122(QByteArray::fromRawData(uuids, NUM_BYTES_RFC4122_UUID));
+        stream.streamID = QUuid::fromRfc4122(QByteArray::fromRawData(uuids + NUM_BYTES_RFC4122_UUID, NUM_BYTES_RFC4122_UUID));
+
+        stream.frames.resize(numFrames);
+        for (auto& frame : stream.frames) {
+            quint16 frameSize;
+            if (!readBytes(&frameSize, sizeof(frameSize)) || (end - data) < frameSize) {
+                _parsedStreams.clear();
+                return -1;
+            }
+            frame = QByteArray(data, frameSize);
+            data += frameSize;
+        }
+    }
+    return (int)(data - packetAfterCodec.constData());
+}
+
+void ForwardedAudioStreams::render(const CodecPluginPointer& codec, QByteArray& decodedMix) {
+    ++_frame;
+
+    if (!_parsedStreams.empty() && decodedMix.size() == AudioConstants::NETWORK_FRAME_BYTES_STEREO) {
+        float mix[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        int16_t* mixSamples = reinterpret_cast<int16_t*>(decodedMix.data());
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
+            mix[i] = (float)mixSamples[i] / (float)AudioConstants::MAX_SAMPLE_VALUE;
+        }
+
+        for (auto& parsedStream : _parsedStreams) {
+            auto& stream = decodedStream({ parsedStream.nodeID, parsedStream.streamID }, codec);
+            stream.lastFrame = _frame;
+
+            // every frame goes through the decoder to keep its state, only the latest one is heard
+            QByteArray decoded;
+            for (const auto& frame : parsedStream.frames) {
+                if (stream.decoder) {
+                    stream.decoder->decode(frame, decoded);
+                } else {
+                    decoded = frame;
+                }
+            }
+            if (decoded.size() != AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL) {
+                continue;
+            }
+
+            stream.hrtf.render(reinterpret_cast<int16_t*>(decoded.data()), mix, HRTF_DATASET_INDEX,
+                               parsedStream.azimuth, parsedStream.distance, parsedStream.gain,
+                               AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        }
+
+        // the mix was limited by the mixer already, the few streams on top of it are only clipped
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
+            float sample = mix[i] * (float)AudioConstants::MAX_SAMPLE_VALUE;
+            mixSamples[i] = (int16_t)std::min(std::max(sample, (float)AudioConstants::MIN_SAMPLE_VALUE),
+                                              (float)AudioConstants::MAX_SAMPLE_VALUE);
+        }
+    }
+    _parsedStreams.clear();
+
+    for (auto it = _decodedStreams.begin(); it != _decodedStreams.end();) {
+        if (_frame - it->second->lastFrame > STALE_STREAM_FRAMES) {
+            release(*it->second);
+            it = _decodedStreams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ForwardedAudioStreams::clear() {
+    for (auto& streamPair : _decodedStreams) {
+        release(*streamPair.second);
+    }
+    _decodedStreams.clear();
+    _parsedStreams.clear();
+}
+
+ForwardedAudioStreams::DecodedStream& ForwardedAudioStreams::decodedStream(const StreamKey& key,
+                                                                           const CodecPluginPointer& codec) {
+    auto& stream = _decodedStreams[key];
+    if (!stream) {
+        stream.reset(new DecodedStream());
+    }
+    if (stream->codec != codec) {
+        release(*stream);
+        stream->codec = codec;
+        if (codec) {
+            stream->decoder = codec->createDecoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
+        }
+    }
+    return *stream;
+}
+
+void ForwardedAudioStreams::release(DecodedStream& stream) {
+    if (stream.codec && stream.decoder) {
+        stream.codec->releaseDecoder(stream.decoder);
+    }
+    stream.decoder = nullptr;
+    stream.codec = nullptr;
+}
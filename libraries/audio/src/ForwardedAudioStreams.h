@@ -0,0 +1,81 @@
+//
+//  ForwardedAudioStreams.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ForwardedAudioStreams_h
+#define hifi_ForwardedAudioStreams_h
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QUuid>
+
+#include <plugins/CodecPlugin.h>
+
+#include "AudioHRTF.h"
+
+class NLPacket;
+
+// One of the loudest streams the audio mixer forwards to a listener as it was received instead of mixing it,
+// along with where the mixer hears it from
+struct ForwardedAudioStream {
+    QUuid nodeID;
+    QUuid streamID;
+    float azimuth { 0.0f }; // clockwise from the front of the listener, in radians
+    float distance { 0.0f }; // in meters
+    float gain { 0.0f }; // the attenuation over the distance and the gain the listener set for the node
+    std::vector<QByteArray> frames; // encoded in the codec of the listener, received since the last mix
+};
+
+// The forwarded streams of a ForwardedMixedAudio packet, which is laid out as
+//    sequence number (quint16), codec name (string), number of streams (quint8)
+//    for each stream:
+//        node ID, stream ID (RFC 4122), azimuth, distance, gain (float), number of frames (quint8)
+//        for each frame: size (quint16), encoded audio
+//    the encoded mix of the streams that were not forwarded, as in a MixedAudio packet
+// The listener decodes each forwarded stream and spatializes it on top of the mix.
+class ForwardedAudioStreams {
+public:
+    ForwardedAudioStreams() {}
+    ~ForwardedAudioStreams();
+
+    static size_t getSizeOnWire(const ForwardedAudioStream& stream);
+    static void write(NLPacket& packet, const std::vector<ForwardedAudioStream>& streams);
+
+    // keeps the streams for the next render, returns the bytes read or -1 if the data is truncated
+    int parse(const QByteArray& packetAfterCodec);
+
+    // decodes and spatializes the parsed streams into the decoded stereo mix, then forgets them
+    void render(const CodecPluginPointer& codec, QByteArray& decodedMix);
+
+    void clear();
+
+private:
+    ForwardedAudioStreams(const ForwardedAudioStreams&) = delete;
+    ForwardedAudioStreams& operator=(const ForwardedAudioStreams&) = delete;
+
+    struct DecodedStream {
+        CodecPluginPointer codec;
+        Decoder* decoder { nullptr };
+        AudioHRTF hrtf;
+        unsigned int lastFrame { 0 };
+    };
+    using StreamKey = std::pair<QUuid, QUuid>;
+
+    DecodedStream& decodedStream(const StreamKey& key, const CodecPluginPointer& codec);
+    void release(DecodedStream& stream);
+
+    std::vector<ForwardedAudioStream> _parsedStreams;
+    std::map<StreamKey, std::unique_ptr<DecodedStream>> _decodedStreams;
+    unsigned int _frame { 0 };
+};
+
+#endif // hifi_ForwardedAudioStreams_h
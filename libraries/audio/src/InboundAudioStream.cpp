@@ -46,6 +46,15 @@ static const int STATS_FOR_STATS_PACKET_WINDOW_SECONDS = 30;
 // _currentJitterBufferFrames is updated with the time-weighted avg and the running time-weighted avg is reset.
 static const quint64 FRAMES_AVAILABLE_STAT_WINDOW_USECS = 10 * USECS_PER_SECOND;
 
+// when time-stretching, the playout speed changes by this much while the buffer is off its desired frames,
+// which catches up a frame in a quarter second
+static const float TIME_STRETCH_SPEED_CHANGE = 0.04f;
+// the buffer is sped up past this many frames over the desired, and slowed down under this many below it
+static const float TIME_STRETCH_FRAMES_OVER_DESIRED = 1.0f;
+static const float TIME_STRETCH_FRAMES_UNDER_DESIRED = 0.5f;
+// smooths the frames available, which bounce by a frame between the writes and the pops
+static const float TIME_STRETCH_FRAMES_AVAILABLE_SMOOTHING = 0.9f;
+
 InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBlocks, int numStaticJitterBlocks) :
     _ringBuffer(numChannels * numFrames, numBlocks),
     _numChannels(numChannels),
@@ -67,6 +76,10 @@ void InboundAudioStream::reset() {
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
     _hasStarted = false;
+    if (_timeStretch) {
+        _timeStretch->reset();
+    }
+    _averageFramesAvailable = 0.0f;
     resetStats();
     // FIXME: calling cleanupCodec() seems to be the cause of the buzzsaw -- we get an assert
     // after this is called in AudioClient.  Ponder and fix...
@@ -94,6 +107,7 @@ void InboundAudioStream::resetStats() {
 
 void InboundAudioStream::clearBuffer() {
     _ringBuffer.clear();
+    _samplesToDrop.store(0);
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
 }
@@ -130,6 +144,14 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
 
     message.seek(prePropertyPosition + propertyBytes);
 
+    bool isSilentFrame = message.getType() == PacketType::SilentAudioFrame
+        || message.getType() == PacketType::ReplicatedSilentAudioFrame;
+
+    // note: PCM and no codec are identical
+    bool selectedPCM = _selectedCodecName == "pcm" || _selectedCodecName == "";
+    bool packetPCM = codecInPacket == "pcm" || codecInPacket == "";
+    bool isSelectedCodec = codecInPacket == _selectedCodecName || (packetPCM && selectedPCM);
+
     // handle this packet based on its arrival status.
     switch (arrivalInfo._status) {
         case SequenceNumberStats::Unreasonable: {
@@ -139,25 +161,30 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
         case SequenceNumberStats::Early: {
             // Packet is early. Treat the packets as if all the packets between the last
             // OnTime packet and this packet were lost. If we're using a codec this will 
-            // also result in allowing the codec to interpolate lost data. Then
-            // fall through to the "on time" logic to actually handle this packet
+            // also result in allowing the codec to interpolate lost data, or to recover the
+            // last of them from the redundancy of this packet. Then fall through to the
+            // "on time" logic to actually handle this packet
             int packetsDropped = arrivalInfo._seqDiffFromExpected;
-            lostAudioData(packetsDropped);
+            if (!isSilentFrame && isSelectedCodec) {
+                int position = message.getPosition();
+                lostAudioData(packetsDropped, message.readWithoutCopy(message.getBytesLeftToRead()));
+                message.seek(position);
+            } else {
+                lostAudioData(packetsDropped);
+            }
 
             // fall through to OnTime case
         }
         case SequenceNumberStats::OnTime: {
             // Packet is on time; parse its data to the ringbuffer
-            if (message.getType() == PacketType::SilentAudioFrame
-                || message.getType() == PacketType::ReplicatedSilentAudioFrame) {
+            if (isSilentFrame) {
                 // If we recieved a SilentAudioFrame from our sender, we might want to drop
                 // some of the samples in order to catch up to our desired jitter buffer size.
                 writeDroppableSilentFrames(networkFrames);
+                _isReceivingSilence = true;
             } else {
-                // note: PCM and no codec are identical
-                bool selectedPCM = _selectedCodecName == "pcm" || _selectedCodecName == "";
-                bool packetPCM = codecInPacket == "pcm" || codecInPacket == "";
-                if (codecInPacket == _selectedCodecName || (packetPCM && selectedPCM)) {
+                _isReceivingSilence = false;
+                if (isSelectedCodec) {
                     auto afterProperties = message.readWithoutCopy(message.getBytesLeftToRead());
                     parseAudioData(message.getType(), afterProperties);
                 } else {
@@ -195,7 +222,12 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
     // drop the oldest frames so the ringbuffer is down to the desired size.
     if (framesAvailable > _desiredJitterBufferFrames + MAX_FRAMES_OVER_DESIRED) {
         int framesToDrop = framesAvailable - (_desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING);
-        _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
+        if (_ringBuffer.isSingleProducerConsumer()) {
+            // the read position belongs to the consumer, which drops them on its next pop
+            _samplesToDrop.store(framesToDrop * _ringBuffer.getNumFrameSamples(), std::memory_order_release);
+        } else {
+            _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
+        }
         
         _framesAvailableStat.reset();
         _currentJitterBufferFrames = 0;
@@ -224,17 +256,19 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
     }
 }
 
-int InboundAudioStream::lostAudioData(int numPackets) {
+int InboundAudioStream::lostAudioData(int numPackets, const QByteArray& nextEncodedAudio) {
     QByteArray decodedBuffer;
 
     while (numPackets--) {
-        if (_decoder) {
+        if (_decoder && numPackets == 0 && !nextEncodedAudio.isEmpty()) {
+            _decoder->recoverFrame(nextEncodedAudio, decodedBuffer);
+        } else if (_decoder) {
             _decoder->lostFrame(decodedBuffer);
         } else {
             decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
             memset(decodedBuffer.data(), 0, decodedBuffer.size());
         }
-        _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
+        writeToRingBuffer(decodedBuffer, AudioConstants::SAMPLE_RATE, _numChannels);
     }
     return 0;
 }
@@ -246,8 +280,36 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
     } else {
         decodedBuffer = packetAfterStreamProperties;
     }
-    auto actualSize = decodedBuffer.size();
-    return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
+    return writeToRingBuffer(decodedBuffer, AudioConstants::SAMPLE_RATE, _numChannels);
+}
+
+int InboundAudioStream::writeToRingBuffer(const QByteArray& samples, int sampleRate, int numChannels) {
+    if (!_timeStretchEnabled || numChannels <= 0 || sampleRate <= 0) {
+        return _ringBuffer.writeData(samples.data(), samples.size());
+    }
+
+    if (!_timeStretch || _timeStretch->getSampleRate() != sampleRate || _timeStretch->getNumChannels() != numChannels) {
+        _timeStretch.reset(new AudioTimeStretch(sampleRate, numChannels));
+    }
+
+    float framesAvailable = (float)_ringBuffer.samplesAvailable() / (float)_ringBuffer.getNumFrameSamples();
+    _averageFramesAvailable = TIME_STRETCH_FRAMES_AVAILABLE_SMOOTHING * _averageFramesAvailable +
+        (1.0f - TIME_STRETCH_FRAMES_AVAILABLE_SMOOTHING) * framesAvailable;
+
+    float speed = 1.0f;
+    if (_averageFramesAvailable > _desiredJitterBufferFrames + TIME_STRETCH_FRAMES_OVER_DESIRED) {
+        speed += TIME_STRETCH_SPEED_CHANGE;
+    } else if (_averageFramesAvailable < _desiredJitterBufferFrames - TIME_STRETCH_FRAMES_UNDER_DESIRED) {
+        speed -= TIME_STRETCH_SPEED_CHANGE;
+    }
+
+    int frameSize = numChannels * (int)sizeof(int16_t);
+    int numFrames = samples.size() / frameSize;
+    _timeStretchBuffer.resize((numFrames + _timeStretch->getMaxStretchFrames()) * frameSize);
+
+    int numOutputFrames = _timeStretch->render(reinterpret_cast<const int16_t*>(samples.data()),
+                                               reinterpret_cast<int16_t*>(_timeStretchBuffer.data()), numFrames, speed);
+    return _ringBuffer.writeData(_timeStretchBuffer.data(), numOutputFrames * frameSize);
 }
 
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -258,8 +320,8 @@ int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
     // leave the decoder holding some unknown loud state. To handle this 
     // case we will call the decoder's lostFrame() method, which indicates
     // that it should interpolate from its last known state down toward 
-    // silence.
-    if (_decoder) {
+    // silence. Once it has, the following silent frames leave it alone.
+    if (_decoder && !_isReceivingSilence) {
         // FIXME - We could potentially use the output from the codec, in which 
         // case we might get a cleaner fade toward silence. NOTE: The below logic 
         // attempts to catch up in the event that the jitter buffers have grown. 
@@ -301,7 +363,12 @@ int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
     return ret;
 }
 
-int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
+int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing, int16_t* destination) {
+    int samplesToDrop = _samplesToDrop.exchange(0, std::memory_order_acquire);
+    if (samplesToDrop > 0) {
+        _ringBuffer.skipSamples(samplesToDrop);
+    }
+
     int samplesPopped = 0;
     int samplesAvailable = _ringBuffer.samplesAvailable();
     if (_isStarved) {
@@ -311,12 +378,12 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
     } else {
         if (samplesAvailable >= maxSamples) {
             // we have enough samples to pop, so we're good to pop
-            popSamplesNoCheck(maxSamples);
+            popSamplesNoCheck(maxSamples, destination);
             samplesPopped = maxSamples;
         } else if (!allOrNothing && samplesAvailable > 0) {
             // we don't have the requested number of samples, but we do have some
             // samples available, so pop all those (except in all-or-nothing mode)
-            popSamplesNoCheck(samplesAvailable);
+            popSamplesNoCheck(samplesAvailable, destination);
             samplesPopped = samplesAvailable;
         } else {
             // we can't pop any samples, set this stream to starved
@@ -334,12 +401,16 @@ int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing) {
     return samplesPopped / numFrameSamples;
 }
 
-void InboundAudioStream::popSamplesNoCheck(int samples) {
+void InboundAudioStream::popSamplesNoCheck(int samples, int16_t* destination) {
     float unplayedMs = (_ringBuffer.samplesAvailable() / (float)_ringBuffer.getNumFrameSamples()) * AudioConstants::NETWORK_FRAME_MSECS;
     _unplayedMs.update(unplayedMs);
 
     _lastPopOutput = _ringBuffer.nextOutput();
-    _ringBuffer.shiftReadPosition(samples);
+    if (destination) {
+        _ringBuffer.readSamples(destination, samples);
+    } else {
+        _ringBuffer.shiftReadPosition(samples);
+    }
     framesAvailableChanged();
 
     _hasStarted = true;
@@ -418,6 +489,13 @@ void InboundAudioStream::setDynamicJitterBufferEnabled(bool enable) {
     _dynamicJitterBufferEnabled = enable;
 }
 
+void InboundAudioStream::setTimeStretchEnabled(bool enable) {
+    if (enable != _timeStretchEnabled && _timeStretch) {
+        _timeStretch->reset();
+    }
+    _timeStretchEnabled = enable;
+}
+
 void InboundAudioStream::setStaticJitterBufferFrames(int staticJitterBufferFrames) {
     _staticJitterBufferFrames = staticJitterBufferFrames;
     if (!_dynamicJitterBufferEnabled) {
@@ -12,6 +12,9 @@
 #ifndef hifi_InboundAudioStream_h
 #define hifi_InboundAudioStream_h
 
+#include <atomic>
+#include <memory>
+
 #include <Node.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
@@ -22,6 +25,7 @@
 #include <plugins/CodecPlugin.h>
 
 #include "AudioRingBuffer.h"
+#include "AudioTimeStretch.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
 #include "AudioStreamStats.h"
@@ -57,7 +61,11 @@ public:
     virtual int parseData(ReceivedMessage& packet) override;
 
     int popFrames(int maxFrames, bool allOrNothing);
-    int popSamples(int maxSamples, bool allOrNothing);
+    /// when given a destination, the popped samples are copied to it before the buffer may reuse them
+    int popSamples(int maxSamples, bool allOrNothing, int16_t* destination = nullptr);
+
+    /// lets packets be parsed and samples be popped from two threads without a lock (see AudioRingBuffer)
+    void setSingleProducerConsumer(bool enabled) { _ringBuffer.setSingleProducerConsumer(enabled); }
 
     bool lastPopSucceeded() const { return _lastPopSucceeded; };
     const AudioRingBuffer::ConstIterator& getLastPopOutput() const { return _lastPopOutput; }
@@ -69,6 +77,11 @@ public:
     void setDynamicJitterBufferEnabled(bool enable);
     void setStaticJitterBufferFrames(int staticJitterBufferFrames);
 
+    /// when enabled, the playout speed is changed by a few percent to keep the buffer at the desired frames,
+    /// instead of waiting to drop or starve a whole frame
+    void setTimeStretchEnabled(bool enable);
+    bool timeStretchEnabled() const { return _timeStretchEnabled; }
+
     virtual AudioStreamStats getAudioStreamStats() const;
 
     /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
@@ -85,6 +98,8 @@ public:
     int getSamplesAvailable() const { return _ringBuffer.samplesAvailable(); }
 
     bool isStarved() const { return _isStarved; }
+    // true from a SilentAudioFrame until the next packet with audio
+    bool isReceivingSilence() const { return _isReceivingSilence; }
     bool hasStarted() const { return _hasStarted; }
 
     int getConsecutiveNotMixedCount() const { return _consecutiveNotMixedCount; }
@@ -102,6 +117,7 @@ public:
 
     void setupCodec(CodecPluginPointer codec, const QString& codecName, int numChannels);
     void cleanupCodec();
+    const QString& getSelectedCodecName() const { return _selectedCodecName; }
 
 signals:
     void mismatchedAudioCodec(SharedNodePointer sendingNode, const QString& currentCodec, const QString& recievedCodec);
@@ -115,7 +131,7 @@ public slots:
 private:
     void packetReceivedUpdateTimingStats();
 
-    void popSamplesNoCheck(int samples);
+    void popSamplesNoCheck(int samples, int16_t* destination);
     void framesAvailableChanged();
 
 protected:
@@ -133,10 +149,14 @@ protected:
     virtual int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties);
 
     /// produces audio data for lost network packets.
-    virtual int lostAudioData(int numPackets);
+    /// the last of them is recovered from the encoded audio of the packet that followed, when given and the codec can
+    virtual int lostAudioData(int numPackets, const QByteArray& nextEncodedAudio = QByteArray());
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
+
+    /// writes decoded audio to the buffer, time-stretched towards the desired frames when enabled
+    int writeToRingBuffer(const QByteArray& samples, int sampleRate, int numChannels);
     
 protected:
 
@@ -150,7 +170,15 @@ protected:
     int _staticJitterBufferFrames { DEFAULT_STATIC_JITTER_FRAMES };
     int _desiredJitterBufferFrames;
 
+    bool _timeStretchEnabled { false };
+    std::unique_ptr<AudioTimeStretch> _timeStretch;
+    QByteArray _timeStretchBuffer;
+    float _averageFramesAvailable { 0.0f };
+
     bool _isStarved { true };
+    // old samples to drop, when they can only be dropped by the consumer
+    std::atomic<int> _samplesToDrop { 0 };
+    bool _isReceivingSilence { false };
     bool _hasStarted { false };
 
     // stats
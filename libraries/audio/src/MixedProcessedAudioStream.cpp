@@ -31,12 +31,30 @@ int MixedProcessedAudioStream::writeDroppableSilentFrames(int silentFrames) {
     return deviceSilentFramesWritten;
 }
 
-int MixedProcessedAudioStream::lostAudioData(int numPackets) {
+int MixedProcessedAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum,
+                                                     int& networkSamples) {
+    if (type != PacketType::ForwardedMixedAudio) {
+        return InboundAudioStream::parseStreamProperties(type, packetAfterSeqNum, networkSamples);
+    }
+
+    networkSamples = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    int forwardedStreamsBytes = _forwardedStreams.parse(packetAfterSeqNum);
+    if (forwardedStreamsBytes < 0) {
+        qCDebug(audiostream, "Truncated forwarded streams, dropping the mix");
+        // leaves no audio, which is handled as a lost frame
+        return packetAfterSeqNum.size();
+    }
+    return forwardedStreamsBytes;
+}
+
+int MixedProcessedAudioStream::lostAudioData(int numPackets, const QByteArray& nextEncodedAudio) {
     QByteArray decodedBuffer;
     QByteArray outputBuffer;
 
     while (numPackets--) {
-        if (_decoder) {
+        if (_decoder && numPackets == 0 && !nextEncodedAudio.isEmpty()) {
+            _decoder->recoverFrame(nextEncodedAudio, decodedBuffer);
+        } else if (_decoder) {
             _decoder->lostFrame(decodedBuffer);
         } else {
             decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
@@ -47,13 +65,19 @@ int MixedProcessedAudioStream::lostAudioData(int numPackets) {
 
         emit processSamples(decodedBuffer, outputBuffer);
 
-        _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+        writeToRingBuffer(outputBuffer, (int)_outputSampleRate, (int)_outputChannelCount);
         qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
     }
     return 0;
 }
 
 int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties) {
+    bool hasForwardedStreams = (type == PacketType::ForwardedMixedAudio);
+    if (hasForwardedStreams && packetAfterStreamProperties.isEmpty()) {
+        lostAudioData(1);
+        return 0;
+    }
+
     QByteArray decodedBuffer;
     if (_decoder) {
         _decoder->decode(packetAfterStreamProperties, decodedBuffer);
@@ -61,12 +85,16 @@ int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray&
         decodedBuffer = packetAfterStreamProperties;
     }
 
+    if (hasForwardedStreams) {
+        _forwardedStreams.render(_codec, decodedBuffer);
+    }
+
     emit addedStereoSamples(decodedBuffer);
 
     QByteArray outputBuffer;
     emit processSamples(decodedBuffer, outputBuffer);
 
-    _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+    writeToRingBuffer(outputBuffer, (int)_outputSampleRate, (int)_outputChannelCount);
     qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
 
     return packetAfterStreamProperties.size();
@@ -12,6 +12,7 @@
 #ifndef hifi_MixedProcessedAudioStream_h
 #define hifi_MixedProcessedAudioStream_h
 
+#include "ForwardedAudioStreams.h"
 #include "InboundAudioStream.h"
 
 class AudioClient;
@@ -34,8 +35,9 @@ public:
 
 protected:
     int writeDroppableSilentFrames(int silentFrames) override;
+    int parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& networkSamples) override;
     int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties) override;
-    int lostAudioData(int numPackets) override;
+    int lostAudioData(int numPackets, const QByteArray& nextEncodedAudio = QByteArray()) override;
 
 private:
     int networkToDeviceFrames(int networkFrames);
@@ -44,6 +46,9 @@ private:
 private:
     quint64 _outputSampleRate;
     quint64 _outputChannelCount;
+
+    // the streams the mixer forwarded instead of mixing them, spatialized here on top of the mix
+    ForwardedAudioStreams _forwardedStreams;
 };
 
 #endif // hifi_MixedProcessedAudioStream_h
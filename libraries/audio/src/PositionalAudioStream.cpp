@@ -41,11 +41,21 @@ PositionalAudioStream::PositionalAudioStream(PositionalAudioStream::Type type, b
 void PositionalAudioStream::resetStats() {
     _lastPopOutputTrailingLoudness = 0.0f;
     _lastPopOutputLoudness = 0.0f;
+    _consecutiveSilentPops = 0;
+    _isDormant = false;
+    _isWakingUp = false;
 }
 
 void PositionalAudioStream::updateLastPopOutputLoudnessAndTrailingLoudness() {
     _lastPopOutputLoudness = _ringBuffer.getFrameLoudness(_lastPopOutput);
 
+    // the first silent frame is still rendered, to flush the filters of the listeners
+    const int DORMANT_SILENT_POPS = 2;
+    _consecutiveSilentPops = (_lastPopOutputLoudness == 0.0f) ? _consecutiveSilentPops + 1 : 0;
+    bool wasDormant = _isDormant;
+    _isDormant = isReceivingSilence() && _consecutiveSilentPops >= DORMANT_SILENT_POPS;
+    _isWakingUp = wasDormant && !_isDormant;
+
     const int TRAILING_MUTE_THRESHOLD_FRAMES = 400;
     const int TRAILING_LOUDNESS_FRAMES = 200;
     const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_LOUDNESS_FRAMES;
@@ -72,6 +82,17 @@ void PositionalAudioStream::updateLastPopOutputLoudnessAndTrailingLoudness() {
     }
 }
 
+// bounds the frames kept when they aren't cleared, a few mix frames worth
+static const size_t MAX_ENCODED_FRAMES = 4;
+
+int PositionalAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties) {
+    if (_encodedFrames.size() < MAX_ENCODED_FRAMES) {
+        // the packet data is only borrowed, keep a copy
+        _encodedFrames.emplace_back(packetAfterStreamProperties.constData(), packetAfterStreamProperties.size());
+    }
+    return InboundAudioStream::parseAudioData(type, packetAfterStreamProperties);
+}
+
 int PositionalAudioStream::parsePositionalData(const QByteArray& positionalByteArray) {
     QDataStream packetStream(positionalByteArray);
 
@@ -12,6 +12,8 @@
 #ifndef hifi_PositionalAudioStream_h
 #define hifi_PositionalAudioStream_h
 
+#include <vector>
+
 #include <glm/gtx/quaternion.hpp>
 #include <AABox.h>
 
@@ -41,6 +43,11 @@ public:
     float getLastPopOutputLoudness() const { return _lastPopOutputLoudness; }
     float getQuietestFrameLoudness() const { return _quietestFrameLoudness; }
 
+    // the sender is silent and the silence has reached the output, so there is nothing to decode or render
+    // until it speaks again; the frame it wakes up, the filters rendering it are reset
+    bool isDormant() const { return _isDormant && _lastPopSucceeded; }
+    bool isWakingUp() const { return _isWakingUp && _lastPopSucceeded; }
+
     bool shouldLoopbackForNode() const { return _shouldLoopbackForNode; }
     bool isStereo() const { return _isStereo; }
     PositionalAudioStream::Type getType() const { return _type; }
@@ -49,6 +56,10 @@ public:
     const glm::vec3& getAvatarBoundingBoxCorner() const { return _avatarBoundingBoxCorner; }
     const glm::vec3& getAvatarBoundingBoxScale() const { return _avatarBoundingBoxScale; }
 
+    // the audio of the packets parsed since clearEncodedFrames(), as it was received in the selected codec,
+    // for the mixer to forward to the listeners that spatialize it themselves
+    const std::vector<QByteArray>& getEncodedFrames() const { return _encodedFrames; }
+    void clearEncodedFrames() { _encodedFrames.clear(); }
 
 protected:
     // disallow copying of PositionalAudioStream objects
@@ -57,6 +68,8 @@ protected:
 
     int parsePositionalData(const QByteArray& positionalByteArray);
 
+    virtual int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties) override;
+
 protected:
     Type _type;
     glm::vec3 _position;
@@ -75,6 +88,12 @@ protected:
     float _quietestTrailingFrameLoudness;
     float _quietestFrameLoudness;
     int _frameCounter;
+
+    int _consecutiveSilentPops { 0 };
+    bool _isDormant { false };
+    bool _isWakingUp { false };
+
+    std::vector<QByteArray> _encodedFrames;
 };
 
 #endif // hifi_PositionalAudioStream_h
@@ -53,12 +53,25 @@ Sound::Sound(const QUrl& url, bool isStereo, bool isAmbisonic) :
 {
 }
 
+// decoding and resampling a long sound takes a while, so sounds get a few threads of their own
+// instead of holding up the global pool
+static const int SOUND_PROCESSOR_THREADS = 2;
+
+static QThreadPool* soundProcessorPool() {
+    static QThreadPool* pool = [] {
+        QThreadPool* pool = new QThreadPool();
+        pool->setMaxThreadCount(SOUND_PROCESSOR_THREADS);
+        return pool;
+    }();
+    return pool;
+}
+
 void Sound::downloadFinished(const QByteArray& data) {
     // this is a QRunnable, will delete itself after it has finished running
     SoundProcessor* soundProcessor = new SoundProcessor(_url, data, _isStereo, _isAmbisonic);
     connect(soundProcessor, &SoundProcessor::onSuccess, this, &Sound::soundProcessSuccess);
     connect(soundProcessor, &SoundProcessor::onError, this, &Sound::soundProcessError);
-    QThreadPool::globalInstance()->start(soundProcessor);
+    soundProcessorPool()->start(soundProcessor);
 }
 
 void Sound::soundProcessSuccess(QByteArray data, bool stereo, bool ambisonic, float duration) {
@@ -70,6 +83,9 @@ void Sound::soundProcessSuccess(QByteArray data, bool stereo, bool ambisonic, fl
     _isAmbisonic = ambisonic;
     _duration = duration;
     _isReady = true;
+
+    // the cache is bounded by the decoded audio, which is what stays in memory
+    setSize(_byteArray.size());
     finishedLoading(true);
 
     emit ready();
@@ -85,30 +101,30 @@ void SoundProcessor::run() {
 
     qCDebug(audio) << "Processing sound file" << _url.toDisplayString();
 
-    // replace our byte array with the downloaded data
-    QByteArray rawAudioByteArray = QByteArray(_data);
+    // the audio is decoded from the downloaded data in place, which is then released
     QString fileName = _url.fileName().toLower();
 
     static const QString WAV_EXTENSION = ".wav";
     static const QString RAW_EXTENSION = ".raw";
     if (fileName.endsWith(WAV_EXTENSION)) {
 
-        QByteArray outputAudioByteArray;
+        int dataOffset = 0;
+        int dataSize = 0;
 
-        int sampleRate = interpretAsWav(rawAudioByteArray, outputAudioByteArray);
+        int sampleRate = interpretAsWav(_data, dataOffset, dataSize);
         if (sampleRate != 0) {
-            downSample(outputAudioByteArray, sampleRate);
+            downSample(dataOffset, dataSize, sampleRate);
         }
     } else if (fileName.endsWith(RAW_EXTENSION)) {
         // check if this was a stereo raw file
         // since it's raw the only way for us to know that is if the file was called .stereo.raw
         if (fileName.toLower().endsWith("stereo.raw")) {
             _isStereo = true;
-            qCDebug(audio) << "Processing sound of" << rawAudioByteArray.size() << "bytes from" << _url << "as stereo audio file.";
+            qCDebug(audio) << "Processing sound of" << _data.size() << "bytes from" << _url << "as stereo audio file.";
         }
 
         // Process as 48khz RAW file
-        downSample(rawAudioByteArray, 48000);
+        downSample(0, _data.size(), 48000);
     } else {
         qCDebug(audio) << "Unknown sound file type";
         emit onError(300, "Failed to load sound file, reason: unknown sound file type");
@@ -118,32 +134,35 @@ void SoundProcessor::run() {
     emit onSuccess(_data, _isStereo, _isAmbisonic, _duration);
 }
 
-void SoundProcessor::downSample(const QByteArray& rawAudioByteArray, int sampleRate) {
+void SoundProcessor::downSample(int offset, int numBytes, int sampleRate) {
 
     // we want to convert it to the format that the audio-mixer wants
     // which is signed, 16-bit, 24Khz
 
     if (sampleRate == AudioConstants::SAMPLE_RATE) {
-        // no resampling needed
-        _data = rawAudioByteArray;
+        // no resampling needed, only the audio is kept
+        if (offset != 0 || numBytes != _data.size()) {
+            _data = _data.mid(offset, numBytes);
+        }
     } else {
 
         int numChannels = _isAmbisonic ? AudioConstants::AMBISONIC : (_isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
         AudioSRC resampler(sampleRate, AudioConstants::SAMPLE_RATE, numChannels);
 
         // resize to max possible output
-        int numSourceFrames = rawAudioByteArray.size() / (numChannels * sizeof(AudioConstants::AudioSample));
+        int numSourceFrames = numBytes / (numChannels * sizeof(AudioConstants::AudioSample));
         int maxDestinationFrames = resampler.getMaxOutput(numSourceFrames);
         int maxDestinationBytes = maxDestinationFrames * numChannels * sizeof(AudioConstants::AudioSample);
-        _data.resize(maxDestinationBytes);
+        QByteArray outputAudioByteArray(maxDestinationBytes, Qt::Uninitialized);
 
-        int numDestinationFrames = resampler.render((int16_t*)rawAudioByteArray.data(), 
-                                                    (int16_t*)_data.data(),
+        int numDestinationFrames = resampler.render((const int16_t*)(_data.constData() + offset),
+                                                    (int16_t*)outputAudioByteArray.data(),
                                                     numSourceFrames);
 
         // truncate to actual output
         int numDestinationBytes = numDestinationFrames * numChannels * sizeof(AudioConstants::AudioSample);
-        _data.resize(numDestinationBytes);
+        outputAudioByteArray.resize(numDestinationBytes);
+        _data = outputAudioByteArray;
     }
 }
 
@@ -191,8 +210,8 @@ struct WAVEFormat {
     quint16     bitsPerSample;
 };
 
-// returns wavfile sample rate, used for resampling
-int SoundProcessor::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray) {
+// returns wavfile sample rate, used for resampling, and where the audio is in the file
+int SoundProcessor::interpretAsWav(const QByteArray& inputAudioByteArray, int& dataOffset, int& dataSize) {
 
     // Create a data stream to analyze the data
     QDataStream waveStream(const_cast<QByteArray *>(&inputAudioByteArray), QIODevice::ReadOnly);
@@ -271,13 +290,15 @@ int SoundProcessor::interpretAsWav(const QByteArray& inputAudioByteArray, QByteA
         waveStream.skipRawData(qFromLittleEndian<quint32>(data.size));  // next chunk
     }
 
-    // Read the "data" chunk
+    // Locate the "data" chunk, which is read where it is
     quint32 outputAudioByteArraySize = qFromLittleEndian<quint32>(data.size);
-    outputAudioByteArray.resize(outputAudioByteArraySize);
-    if (waveStream.readRawData(outputAudioByteArray.data(), outputAudioByteArraySize) != (int)outputAudioByteArraySize) {
+    qint64 outputAudioByteArrayOffset = waveStream.device()->pos();
+    if (outputAudioByteArrayOffset + outputAudioByteArraySize > (qint64)inputAudioByteArray.size()) {
         qCDebug(audio) << "Error reading WAV file";
         return 0;
     }
+    dataOffset = (int)outputAudioByteArrayOffset;
+    dataSize = (int)outputAudioByteArraySize;
 
     _duration = (float)(outputAudioByteArraySize / (wave.sampleRate * wave.numChannels * wave.bitsPerSample / 8.0f));
     return wave.sampleRate;
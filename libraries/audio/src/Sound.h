@@ -24,6 +24,8 @@ class Sound : public Resource {
 
 public:
     Sound(const QUrl& url, bool isStereo = false, bool isAmbisonic = false);
+
+    QString getType() const override { return "Sound"; }
     
     bool isStereo() const { return _isStereo; }    
     bool isAmbisonic() const { return _isAmbisonic; }    
@@ -60,8 +62,8 @@ public:
 
     virtual void run() override;
 
-    void downSample(const QByteArray& rawAudioByteArray, int sampleRate);
-    int interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray);
+    void downSample(int offset, int numBytes, int sampleRate);
+    int interpretAsWav(const QByteArray& inputAudioByteArray, int& dataOffset, int& dataSize);
 
 signals:
     void onSuccess(QByteArray data, bool stereo, bool ambisonic, float duration);
@@ -0,0 +1,68 @@
+//
+//  AudioFOA_neon.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+
+#include <assert.h>
+#include <arm_neon.h>
+
+// in-place rotation of the soundfield
+// crossfade between old and new rotation, to prevent artifacts
+void rotate_3x3_NEON(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames) {
+
+    const float md[3][3] = { 
+        { m0[0][0] - m1[0][0], m0[0][1] - m1[0][1], m0[0][2] - m1[0][2] },
+        { m0[1][0] - m1[1][0], m0[1][1] - m1[1][1], m0[1][2] - m1[1][2] },
+        { m0[2][0] - m1[2][0], m0[2][1] - m1[2][1], m0[2][2] - m1[2][2] },
+    };
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        float32x4_t frac = vld1q_f32(&win[i]);
+
+        // interpolate the matrix
+        float32x4_t m00 = vmlaq_n_f32(vdupq_n_f32(m1[0][0]), frac, md[0][0]);
+        float32x4_t m10 = vmlaq_n_f32(vdupq_n_f32(m1[1][0]), frac, md[1][0]);
+        float32x4_t m20 = vmlaq_n_f32(vdupq_n_f32(m1[2][0]), frac, md[2][0]);
+
+        float32x4_t m01 = vmlaq_n_f32(vdupq_n_f32(m1[0][1]), frac, md[0][1]);
+        float32x4_t m11 = vmlaq_n_f32(vdupq_n_f32(m1[1][1]), frac, md[1][1]);
+        float32x4_t m21 = vmlaq_n_f32(vdupq_n_f32(m1[2][1]), frac, md[2][1]);
+
+        float32x4_t m02 = vmlaq_n_f32(vdupq_n_f32(m1[0][2]), frac, md[0][2]);
+        float32x4_t m12 = vmlaq_n_f32(vdupq_n_f32(m1[1][2]), frac, md[1][2]);
+        float32x4_t m22 = vmlaq_n_f32(vdupq_n_f32(m1[2][2]), frac, md[2][2]);
+
+        float32x4_t b1 = vld1q_f32(&buf[1][i]);
+        float32x4_t b2 = vld1q_f32(&buf[2][i]);
+        float32x4_t b3 = vld1q_f32(&buf[3][i]);
+
+        // matrix multiply
+        float32x4_t x = vmulq_f32(m00, b1);
+        float32x4_t y = vmulq_f32(m10, b1);
+        float32x4_t z = vmulq_f32(m20, b1);
+
+        x = vmlaq_f32(x, m01, b2);
+        y = vmlaq_f32(y, m11, b2);
+        z = vmlaq_f32(z, m21, b2);
+
+        x = vmlaq_f32(x, m02, b3);
+        y = vmlaq_f32(y, m12, b3);
+        z = vmlaq_f32(z, m22, b3);
+
+        vst1q_f32(&buf[1][i], x);
+        vst1q_f32(&buf[2][i], y);
+        vst1q_f32(&buf[3][i], z);
+    }
+}
+
+#endif
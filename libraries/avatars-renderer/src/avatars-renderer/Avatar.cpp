@@ -105,6 +105,9 @@ Avatar::Avatar(QThread* thread) :
     // we may have been created in the network thread, but we live in the main thread
     moveToThread(thread);
 
+    // spread the avatars updating their joints at a reduced rate over the frames
+    _framesSinceJointsUpdate = randIntInRange(0, MAX_JOINTS_UPDATE_PERIOD - 1);
+
     setScale(glm::vec3(1.0f)); // avatar scale is uniform
 
     auto geometryCache = DependencyManager::get<GeometryCache>();
@@ -342,19 +345,28 @@ void Avatar::simulate(float deltaTime, bool inView) {
     }
 
     PerformanceTimer perfTimer("simulate");
+    updatePoseFromSamples(usecTimestampNow());
     {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView) {
             Head* head = getHead();
-            if (_hasNewJointData) {
-                _skeletonModel->getRig().copyJointsFromJointData(_jointData);
-                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
-                _skeletonModel->getRig().computeExternalPoses(rootTransform);
+            bool isUpdateDue = isJointsUpdateDue();
+            _framesSinceJointsUpdate = std::min(_framesSinceJointsUpdate + 1, MAX_JOINTS_UPDATE_PERIOD);
+            if (_hasNewJointData && !isUpdateDue) {
+                // the joints wait for a later frame, the position, rotation, scale and bounds still follow
+                _skeletonModel->simulate(deltaTime, false);
+            } else if (_hasNewJointData) {
+                _framesSinceJointsUpdate = 0;
+                if (!_hasJointsFromJointData) {
+                    updateJointsFromJointData();
+                }
+                _hasJointsFromJointData = false;
                 _jointDataSimulationRate.increment();
 
                 _skeletonModel->simulate(deltaTime, true);
 
                 locationChanged(); // joints changed, so if there are any children, update them.
+                resolveWorldTransforms();
                 _hasNewJointData = false;
 
                 glm::vec3 headPosition = getPosition();
@@ -401,6 +413,21 @@ void Avatar::simulate(float deltaTime, bool inView) {
     }
 }
 
+void Avatar::setJointsUpdatePeriod(int period) {
+    _jointsUpdatePeriod = glm::clamp(period, 1, MAX_JOINTS_UPDATE_PERIOD);
+}
+
+bool Avatar::isJointsUpdateDue() const {
+    return _framesSinceJointsUpdate + 1 >= _jointsUpdatePeriod;
+}
+
+void Avatar::updateJointsFromJointData() {
+    _skeletonModel->getRig().copyJointsFromJointData(_jointData);
+    glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
+    _skeletonModel->getRig().computeExternalPoses(rootTransform);
+    _hasJointsFromJointData = true;
+}
+
 float Avatar::getSimulationRate(const QString& rateName) const {
     if (rateName == "") {
         return _simulationRate.rate();
@@ -1176,8 +1203,19 @@ void Avatar::setAttachmentData(const QVector<AttachmentData>& attachmentData) {
     }
 }
 
+static const float MOVE_DISTANCE_THRESHOLD = 0.001f;
+
+// a remote avatar is shown this many of its average packet intervals behind, and never more than the max behind
+static const float POSE_SAMPLE_INTERVALS_BEHIND = 2.0f;
+static const float MAX_POSE_DELAY = 0.3f * USECS_PER_SECOND;
+static const float POSE_SAMPLE_INTERVAL_TIMESCALE = 10.0f; // samples
+static const size_t MAX_POSE_SAMPLES = 8;
+// a pose is carried on from the last two for no longer than this once it runs out of samples
+static const quint64 MAX_POSE_EXTRAPOLATION = 100 * USECS_PER_MSEC;
+// anything moving faster than this between two samples was put there, it isn't slid across
+static const float MAX_INTERPOLATED_SPEED = 50.0f; // meters per second
 
-int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
+int Avatar::parsePreparedData(const PreparedData& prepared) {
     PerformanceTimer perfTimer("unpack");
     if (!_initialized) {
         // now that we have data for this Avatar we are go for init
@@ -1186,10 +1224,13 @@ int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
 
     // change in position implies movement
     glm::vec3 oldPosition = getPosition();
+    glm::vec3 shownPosition = getLocalPosition();
+    glm::quat shownOrientation = getLocalOrientation();
+    quint64 now = usecTimestampNow();
 
-    int bytesRead = AvatarData::parseDataFromBuffer(buffer);
+    int bytesRead = AvatarData::parsePreparedData(prepared);
+    addPoseSample(now, shownPosition, shownOrientation, parentInfoChangedSince(now));
 
-    const float MOVE_DISTANCE_THRESHOLD = 0.001f;
     _moving = glm::distance(oldPosition, getPosition()) > MOVE_DISTANCE_THRESHOLD;
     if (_moving) {
         addPhysicsFlags(Simulation::DIRTY_POSITION);
@@ -1201,6 +1242,89 @@ int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
     return bytesRead;
 }
 
+void Avatar::addPoseSample(quint64 now, const glm::vec3& shownPosition, const glm::quat& shownOrientation,
+                           bool isParentChanged) {
+    // what parsing left untouched is still the last pose received, not the one shown
+    glm::vec3 position = getLocalPosition();
+    glm::quat orientation = getLocalOrientation();
+    if (!_poseSamples.empty()) {
+        if (position == shownPosition) {
+            position = _poseSamples.back().position;
+        }
+        if (orientation == shownOrientation) {
+            orientation = _poseSamples.back().orientation;
+        }
+    }
+
+    if (!_poseSamples.empty() && !isParentChanged) {
+        const PoseSample& lastSample = _poseSamples.back();
+        float interval = (float)(now - lastSample.time);
+        float distance = glm::distance(position, lastSample.position);
+        if (distance <= MAX_INTERPOLATED_SPEED * (interval / USECS_PER_SECOND)) {
+            if (_averagePoseSampleInterval == 0.0f) {
+                _averagePoseSampleInterval = interval;
+            } else {
+                interval = std::min(interval, MAX_POSE_DELAY);
+                _averagePoseSampleInterval += (interval - _averagePoseSampleInterval) / POSE_SAMPLE_INTERVAL_TIMESCALE;
+            }
+            if (_poseSamples.size() == MAX_POSE_SAMPLES) {
+                _poseSamples.pop_front();
+            }
+            _poseSamples.push_back({ now, position, orientation });
+
+            // the new pose is shown once the render time gets to it
+            setLocalPosition(shownPosition);
+            setLocalOrientation(shownOrientation);
+            return;
+        }
+    }
+
+    // the first pose, or one in another frame or far away, is shown as it is
+    _poseSamples.clear();
+    _poseSamples.push_back({ now, position, orientation });
+}
+
+void Avatar::updatePoseFromSamples(quint64 now) {
+    if (_poseSamples.size() < 2) {
+        return;
+    }
+
+    quint64 delay = (quint64)std::min(POSE_SAMPLE_INTERVALS_BEHIND * _averagePoseSampleInterval, MAX_POSE_DELAY);
+    quint64 renderTime = now - std::min(now, delay);
+    while (_poseSamples.size() > 2 && _poseSamples[1].time <= renderTime) {
+        _poseSamples.pop_front();
+    }
+
+    const PoseSample& previous = _poseSamples[0];
+    const PoseSample& next = _poseSamples[1];
+    glm::vec3 position;
+    glm::quat orientation;
+    float interval = (float)(next.time - previous.time);
+    if (renderTime <= previous.time) {
+        position = previous.position;
+        orientation = previous.orientation;
+    } else if (renderTime <= next.time) {
+        float alpha = (interval > 0.0f) ? (float)(renderTime - previous.time) / interval : 1.0f;
+        position = glm::mix(previous.position, next.position, alpha);
+        orientation = safeMix(previous.orientation, next.orientation, alpha);
+    } else {
+        // dead reckoning: it keeps going the way it went between the last two, for a little while
+        float extrapolation = (float)std::min(renderTime - next.time, MAX_POSE_EXTRAPOLATION);
+        glm::vec3 velocity = (interval > 0.0f) ? (next.position - previous.position) / interval : glm::vec3(0.0f);
+        position = next.position + velocity * extrapolation;
+        orientation = next.orientation;
+    }
+
+    _moving = glm::distance(previous.position, next.position) > MOVE_DISTANCE_THRESHOLD;
+    if (position != getLocalPosition()) {
+        setLocalPosition(position);
+        addPhysicsFlags(Simulation::DIRTY_POSITION);
+    }
+    if (orientation != getLocalOrientation()) {
+        setLocalOrientation(orientation);
+    }
+}
+
 int Avatar::_jointConesID = GeometryCache::UNKNOWN_ID;
 
 // render a makeshift cone section that serves as a body part connecting joint spheres
@@ -11,6 +11,7 @@
 #ifndef hifi_Avatar_h
 #define hifi_Avatar_h
 
+#include <deque>
 #include <functional>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -88,6 +89,17 @@ public:
     void simulate(float deltaTime, bool inView);
     virtual void simulateAttachments(float deltaTime);
 
+    // Level of detail of the joints: the joint data received is only applied once every so many frames,
+    // chosen from the size of the avatar on screen. Off screen avatars don't update their joints at all.
+    static const int MAX_JOINTS_UPDATE_PERIOD { 8 };
+    void setJointsUpdatePeriod(int period);
+    int getJointsUpdatePeriod() const { return _jointsUpdatePeriod; }
+    bool isJointsUpdateDue() const;
+
+    // Copies the joint data received into the rig, ahead of simulate which then skips that part.
+    // It only touches this avatar, so it can run off the main thread for several avatars at once.
+    void updateJointsFromJointData();
+
     virtual void render(RenderArgs* renderArgs);
 
     void addToScene(AvatarSharedPointer self, const render::ScenePointer& scene,
@@ -160,7 +172,7 @@ public:
     void updateDisplayNameAlpha(bool showDisplayName);
     virtual void setSessionDisplayName(const QString& sessionDisplayName) override { }; // no-op
 
-    virtual int parseDataFromBuffer(const QByteArray& buffer) override;
+    virtual int parsePreparedData(const PreparedData& prepared) override;
 
     static void renderJointConnectingCone( gpu::Batch& batch, glm::vec3 position1, glm::vec3 position2,
                                                 float radius1, float radius2, const glm::vec4& color);
@@ -326,6 +338,24 @@ protected:
     RateCounter<> _skeletonModelSimulationRate;
     RateCounter<> _jointDataSimulationRate;
 
+    // The rig holds the joint data received, set by updateJointsFromJointData and cleared by simulate
+    std::atomic<bool> _hasJointsFromJointData { false };
+    int _jointsUpdatePeriod { 1 };
+    int _framesSinceJointsUpdate { 0 };
+
+    // The local poses received, shown a little behind time so that there are two of them to blend between
+    // when a packet is late, and carried on from the last two for a short while when there aren't.
+    struct PoseSample {
+        quint64 time;
+        glm::vec3 position;
+        glm::quat orientation;
+    };
+    void addPoseSample(quint64 now, const glm::vec3& shownPosition, const glm::quat& shownOrientation,
+                       bool isParentChanged);
+    void updatePoseFromSamples(quint64 now);
+    std::deque<PoseSample> _poseSamples;
+    float _averagePoseSampleInterval { 0.0f }; // usecs
+
 private:
     class AvatarEntityDataHash {
     public:
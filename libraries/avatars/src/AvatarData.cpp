@@ -14,9 +14,12 @@
 
 #include <cstdio>
 #include <cstring>
+#include <iterator>
 #include <stdint.h>
+#include <unordered_map>
 
 #include <QtCore/QDataStream>
+#include <QtCore/QtAlgorithms>
 #include <QtCore/QThread>
 #include <QtCore/QUuid>
 #include <QtCore/QJsonDocument>
@@ -58,9 +61,27 @@ static const float DEFAULT_AVATAR_DENSITY = 1000.0f; // density of water
 #define ASSERT(COND)  do { if (!(COND)) { abort(); } } while(0)
 
 size_t AvatarDataPacket::maxFaceTrackerInfoSize(size_t numBlendshapeCoefficients) {
-    return FACE_TRACKER_INFO_SIZE + numBlendshapeCoefficients * sizeof(float);
+    const size_t validityBitsSize = (size_t)std::ceil(numBlendshapeCoefficients / (float)BITS_IN_BYTE);
+    return FACE_TRACKER_INFO_SIZE + validityBitsSize + numBlendshapeCoefficients * sizeof(uint8_t);
 }
 
+// the size of the validity bits and coefficients that follow the FaceTrackerInfo, only the size of the validity bits
+// if those aren't all in the buffer
+static int faceTrackerCoefficientsSize(const AvatarDataPacket::FaceTrackerInfo* faceTrackerInfo, const uint8_t* validityBits,
+                                       const uint8_t* endPosition) {
+    int numValidityBytes = (int)std::ceil(faceTrackerInfo->numBlendshapeCoefficients / (float)BITS_IN_BYTE);
+    if ((endPosition - validityBits) < numValidityBytes) {
+        return numValidityBytes;
+    }
+    int numValidCoefficients = 0;
+    for (int i = 0; i < numValidityBytes; i++) {
+        numValidCoefficients += qPopulationCount(validityBits[i]);
+    }
+    return numValidityBytes + numValidCoefficients;
+}
+
+static const float BLENDSHAPE_COEFFICIENT_SCALE = 255.0f;
+
 size_t AvatarDataPacket::maxJointDataSize(size_t numJoints) {
     const size_t validityBitsSize = (size_t)std::ceil(numJoints / (float)BITS_IN_BYTE);
 
@@ -77,6 +98,156 @@ size_t AvatarDataPacket::maxJointDataSize(size_t numJoints) {
     return totalSize;
 }
 
+static const int JOINT_DELTA_WIDTH_BITS = 5;
+static const int JOINT_DELTA_MAX_WIDTH = 16;
+static const uint8_t JOINT_KEYFRAME_BIT = 0x80;
+static const uint8_t JOINT_KEYFRAME_ID_MASK = 0x7f;
+
+size_t AvatarDataPacket::maxJointDeltaDataSize(size_t numJoints) {
+    const size_t validityBitsSize = (size_t)std::ceil(numJoints / (float)BITS_IN_BYTE);
+
+    size_t totalSize = sizeof(uint8_t); // numJoints
+    totalSize += sizeof(uint8_t); // keyframe
+
+    totalSize += 2 * validityBitsSize; // Orientations and translations masks
+
+    // worst case every rotation and translation is present, at full width
+    size_t maxDeltaBits = 2 * numJoints * (JOINT_DELTA_WIDTH_BITS + 3 * JOINT_DELTA_MAX_WIDTH);
+    totalSize += (maxDeltaBits + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+
+    size_t NUM_FAUX_JOINT = 2;
+    totalSize += NUM_FAUX_JOINT * (sizeof(SixByteQuat) + sizeof(SixByteTrans)); // faux joints
+
+    return totalSize;
+}
+
+namespace {
+
+class JointDeltaWriter {
+public:
+    JointDeltaWriter(unsigned char* buffer) : _buffer(buffer) {}
+
+    // writes the differences of three quantized components, as a width and then zig-zag values of that width
+    void writeDelta(const uint16_t values[3], const uint16_t references[3]) {
+        uint16_t zigZags[3];
+        int width = 0;
+        for (int i = 0; i < 3; ++i) {
+            int16_t difference = (int16_t)(uint16_t)(values[i] - references[i]);
+            zigZags[i] = (uint16_t)(((uint16_t)difference << 1) ^ (uint16_t)(difference >> 15));
+            while (width < JOINT_DELTA_MAX_WIDTH && (zigZags[i] >> width) != 0) {
+                ++width;
+            }
+        }
+        writeBits(width, JOINT_DELTA_WIDTH_BITS);
+        for (int i = 0; i < 3; ++i) {
+            writeBits(zigZags[i], width);
+        }
+    }
+
+    // pads to a whole byte, and returns the number of bytes written
+    int finish() {
+        if (_numBits > 0) {
+            _buffer[_position++] = (unsigned char)(_bits << (BITS_IN_BYTE - _numBits));
+            _bits = _numBits = 0;
+        }
+        return _position;
+    }
+
+private:
+    void writeBits(uint32_t value, int numBits) {
+        for (int i = numBits - 1; i >= 0; --i) {
+            _bits = (_bits << 1) | ((value >> i) & 1);
+            if (++_numBits == BITS_IN_BYTE) {
+                _buffer[_position++] = (unsigned char)_bits;
+                _bits = _numBits = 0;
+            }
+        }
+    }
+
+    unsigned char* _buffer;
+    int _position { 0 };
+    uint32_t _bits { 0 };
+    int _numBits { 0 };
+};
+
+class JointDeltaReader {
+public:
+    JointDeltaReader(const unsigned char* buffer, const unsigned char* end) : _buffer(buffer), _end(end) {}
+
+    // the inverse of JointDeltaWriter::writeDelta(), false if the buffer ran out
+    bool readDelta(uint16_t valuesOut[3], const uint16_t references[3]) {
+        uint32_t width;
+        if (!readBits(width, JOINT_DELTA_WIDTH_BITS) || width > JOINT_DELTA_MAX_WIDTH) {
+            return false;
+        }
+        for (int i = 0; i < 3; ++i) {
+            uint32_t zigZag;
+            if (!readBits(zigZag, width)) {
+                return false;
+            }
+            int16_t difference = (int16_t)((zigZag >> 1) ^ (~(zigZag & 1) + 1));
+            valuesOut[i] = (uint16_t)(references[i] + (uint16_t)difference);
+        }
+        return true;
+    }
+
+    // the number of whole bytes read
+    int finish() const { return _position + (_bitPosition > 0 ? 1 : 0); }
+
+private:
+    bool readBits(uint32_t& value, int numBits) {
+        value = 0;
+        for (int i = 0; i < numBits; ++i) {
+            if (_buffer + _position >= _end) {
+                return false;
+            }
+            value = (value << 1) | ((_buffer[_position] >> (BITS_IN_BYTE - 1 - _bitPosition)) & 1);
+            if (++_bitPosition == BITS_IN_BYTE) {
+                ++_position;
+                _bitPosition = 0;
+            }
+        }
+        return true;
+    }
+
+    const unsigned char* _buffer;
+    const unsigned char* _end;
+    int _position { 0 };
+    int _bitPosition { 0 };
+};
+
+void quantizeJointRotation(const glm::quat& rotation, uint16_t quantized[3]) {
+    unsigned char bytes[6];
+    packOrientationQuatToSixBytes(bytes, rotation);
+    for (int i = 0; i < 3; ++i) {
+        quantized[i] = (uint16_t)((bytes[2 * i] << 8) | bytes[2 * i + 1]);
+    }
+}
+
+glm::quat dequantizeJointRotation(const uint16_t quantized[3]) {
+    unsigned char bytes[6];
+    for (int i = 0; i < 3; ++i) {
+        bytes[2 * i] = (unsigned char)(quantized[i] >> 8);
+        bytes[2 * i + 1] = (unsigned char)(quantized[i] & 0xff);
+    }
+    glm::quat rotation;
+    unpackOrientationQuatFromSixBytes(bytes, rotation);
+    return rotation;
+}
+
+void quantizeJointTranslation(const glm::vec3& translation, int16_t quantized[3]) {
+    packFloatVec3ToSignedTwoByteFixed(reinterpret_cast<unsigned char*>(quantized), translation, TRANSLATION_COMPRESSION_RADIX);
+}
+
+glm::vec3 dequantizeJointTranslation(const int16_t quantized[3]) {
+    glm::vec3 translation;
+    unpackFloatVec3FromSignedTwoByteFixed(reinterpret_cast<const unsigned char*>(quantized), translation,
+                                          TRANSLATION_COMPRESSION_RADIX);
+    return translation;
+}
+
+}
+
 
 AvatarData::AvatarData() :
     SpatiallyNestable(NestableType::Avatar, QUuid()),
@@ -168,9 +339,15 @@ QByteArray AvatarData::toByteArrayStateful(AvatarDataDetail dataDetail, bool dro
 
 QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
     AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust,
-    glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut) const {
+    glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut,
+    AvatarDataPacket::JointKeyframe* jointKeyframeInOut) const {
+
+    if (dataDetail == SendJointDeltaData && !jointKeyframeInOut) {
+        dataDetail = CullSmallData;
+    }
 
-    bool cullSmallChanges = (dataDetail == CullSmallData);
+    bool sendJointDelta = (dataDetail == SendJointDeltaData);
+    bool cullSmallChanges = (dataDetail == CullSmallData) || sendJointDelta;
     bool sendAll = (dataDetail == SendAllData);
     bool sendMinimum = (dataDetail == MinimumData);
     bool sendPALMinimum = (dataDetail == PALMinimum);
@@ -238,14 +415,16 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             tranlationChangedSince(lastSentTime) ||
             parentInfoChangedSince(lastSentTime));
 
-        hasFaceTrackerInfo = !dropFaceTracking && hasFaceTracker() && (sendAll || faceTrackerInfoChangedSince(lastSentTime));
+        hasFaceTrackerInfo = !dropFaceTracking && hasFaceTracker() && (sendAll || faceTrackerInfoChangedSince(lastSentTime)) &&
+            (!distanceAdjust || glm::distance(_globalPosition, viewerPosition) < AVATAR_FACE_TRACKER_INFO_DISTANCE);
         hasJointData = sendAll || !sendMinimum;
     }
 
 
     const size_t byteArraySize = AvatarDataPacket::MAX_CONSTANT_HEADER_SIZE +
         (hasFaceTrackerInfo ? AvatarDataPacket::maxFaceTrackerInfoSize(_headData->getNumSummedBlendshapeCoefficients()) : 0) +
-        (hasJointData ? AvatarDataPacket::maxJointDataSize(_jointData.size()) : 0);
+        (hasJointData ? (sendJointDelta ? AvatarDataPacket::maxJointDeltaDataSize(_jointData.size())
+                                        : AvatarDataPacket::maxJointDataSize(_jointData.size())) : 0);
 
     QByteArray avatarDataByteArray((int)byteArraySize, 0);
     unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
@@ -264,7 +443,9 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         | (hasParentInfo ? AvatarDataPacket::PACKET_HAS_PARENT_INFO : 0)
         | (hasAvatarLocalPosition ? AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION : 0)
         | (hasFaceTrackerInfo ? AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO : 0)
-        | (hasJointData ? AvatarDataPacket::PACKET_HAS_JOINT_DATA : 0);
+        | (hasJointData ? (sendJointDelta ? AvatarDataPacket::PACKET_HAS_JOINT_DELTA_DATA
+                                          : AvatarDataPacket::PACKET_HAS_JOINT_DATA) : 0);
+    hasFlagsOut = packetStateFlags;
 
     memcpy(destinationBuffer, &packetStateFlags, sizeof(packetStateFlags));
     destinationBuffer += sizeof(packetStateFlags);
@@ -447,11 +628,23 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         faceTrackerInfo->rightEyeBlink = _headData->_rightEyeBlink;
         faceTrackerInfo->averageLoudness = _headData->_averageLoudness;
         faceTrackerInfo->browAudioLift = _headData->_browAudioLift;
-        faceTrackerInfo->numBlendshapeCoefficients = blendshapeCoefficients.size();
+        int numCoefficients = std::min(blendshapeCoefficients.size(), (int)UINT8_MAX);
+        faceTrackerInfo->numBlendshapeCoefficients = numCoefficients;
         destinationBuffer += sizeof(AvatarDataPacket::FaceTrackerInfo);
 
-        memcpy(destinationBuffer, blendshapeCoefficients.data(), blendshapeCoefficients.size() * sizeof(float));
-        destinationBuffer += blendshapeCoefficients.size() * sizeof(float);
+        // most of the coefficients of a face are 0 at any time, those are only a bit left unset
+        int numValidityBytes = (int)std::ceil(numCoefficients / (float)BITS_IN_BYTE);
+        unsigned char* validity = destinationBuffer;
+        memset(validity, 0, numValidityBytes);
+        destinationBuffer += numValidityBytes;
+        for (int i = 0; i < numCoefficients; i++) {
+            float coefficient = glm::clamp(blendshapeCoefficients[i], 0.0f, 1.0f);
+            uint8_t quantized = (uint8_t)glm::round(coefficient * BLENDSHAPE_COEFFICIENT_SCALE);
+            if (quantized != 0) {
+                validity[i / BITS_IN_BYTE] |= (1 << (i % BITS_IN_BYTE));
+                *destinationBuffer++ = quantized;
+            }
+        }
 
         int numBytes = destinationBuffer - startSection;
         if (outboundDataRateOut) {
@@ -459,8 +652,109 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         }
     }
 
-    // If it is connected, pack up the data
-    if (hasJointData) {
+    if (hasJointData && sendJointDelta) {
+        auto startSection = destinationBuffer;
+        QReadLocker readLock(&_jointDataLock);
+
+        auto& keyframe = *jointKeyframeInOut;
+        int numJoints = _jointData.size();
+        bool isKeyframe = !keyframe.isValid || (int)keyframe.joints.size() != numJoints
+            || keyframe.age >= AvatarDataPacket::JOINT_KEYFRAME_INTERVAL;
+
+        if (isKeyframe) {
+            keyframe.id = (keyframe.id + 1) & JOINT_KEYFRAME_ID_MASK;
+            keyframe.age = 0;
+            keyframe.isValid = false; // until it has been filled in below
+            keyframe.joints.assign(numJoints, AvatarDataPacket::JointKeyframe::Joint());
+        } else {
+            ++keyframe.age;
+        }
+
+        *destinationBuffer++ = (uint8_t)numJoints;
+        *destinationBuffer++ = keyframe.id | (isKeyframe ? JOINT_KEYFRAME_BIT : 0);
+
+        int numValidityBytes = (int)std::ceil(numJoints / (float)BITS_IN_BYTE);
+        unsigned char* rotationValidity = destinationBuffer;
+        unsigned char* translationValidity = destinationBuffer + numValidityBytes;
+        memset(destinationBuffer, 0, 2 * numValidityBytes);
+        destinationBuffer += 2 * numValidityBytes;
+
+        float minRotationDOT = !distanceAdjust ? AVATAR_MIN_ROTATION_DOT : getDistanceBasedMinRotationDOT(viewerPosition);
+        float minTranslation = !distanceAdjust ? AVATAR_MIN_TRANSLATION : getDistanceBasedMinTranslationDistance(viewerPosition);
+
+        static const uint16_t ZERO_REFERENCE[3] = { 0, 0, 0 };
+        JointDeltaWriter writer(destinationBuffer);
+
+        // rotations, then translations - a joint that is left out takes the keyframe's value
+        for (int i = 0; i < numJoints; i++) {
+            const JointData& data = _jointData[i];
+            auto& keyframeJoint = keyframe.joints[i];
+            if (!data.rotationSet) {
+                continue;
+            }
+
+            uint16_t quantized[3];
+            quantizeJointRotation(data.rotation, quantized);
+
+            if (isKeyframe) {
+                memcpy(keyframeJoint.rotation, quantized, sizeof(quantized));
+                keyframeJoint.rotationValid = true;
+            } else if (keyframeJoint.rotationValid) {
+                if (memcmp(quantized, keyframeJoint.rotation, sizeof(quantized)) == 0 ||
+                    fabsf(glm::dot(data.rotation, dequantizeJointRotation(keyframeJoint.rotation))) >= minRotationDOT) {
+                    continue;
+                }
+            }
+
+            rotationValidity[i / BITS_IN_BYTE] |= (1 << (i % BITS_IN_BYTE));
+            writer.writeDelta(quantized, (keyframeJoint.rotationValid && !isKeyframe) ? keyframeJoint.rotation : ZERO_REFERENCE);
+        }
+
+        for (int i = 0; i < numJoints; i++) {
+            const JointData& data = _jointData[i];
+            auto& keyframeJoint = keyframe.joints[i];
+            if (!data.translationSet) {
+                continue;
+            }
+
+            int16_t quantized[3];
+            quantizeJointTranslation(data.translation, quantized);
+
+            if (isKeyframe) {
+                memcpy(keyframeJoint.translation, quantized, sizeof(quantized));
+                keyframeJoint.translationValid = true;
+            } else if (keyframeJoint.translationValid) {
+                if (memcmp(quantized, keyframeJoint.translation, sizeof(quantized)) == 0 ||
+                    glm::distance(data.translation, dequantizeJointTranslation(keyframeJoint.translation)) <= minTranslation) {
+                    continue;
+                }
+            }
+
+            translationValidity[i / BITS_IN_BYTE] |= (1 << (i % BITS_IN_BYTE));
+            auto reference = (keyframeJoint.translationValid && !isKeyframe) ?
+                reinterpret_cast<const uint16_t*>(keyframeJoint.translation) : ZERO_REFERENCE;
+            writer.writeDelta(reinterpret_cast<const uint16_t*>(quantized), reference);
+        }
+
+        destinationBuffer += writer.finish();
+        keyframe.isValid = true;
+
+        // faux joints
+        Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
+        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
+        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
+            TRANSLATION_COMPRESSION_RADIX);
+        Transform controllerRightHandTransform = Transform(getControllerRightHandMatrix());
+        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
+        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
+            TRANSLATION_COMPRESSION_RADIX);
+
+        int numBytes = destinationBuffer - startSection;
+        if (outboundDataRateOut) {
+            outboundDataRateOut->jointDataRate.increment(numBytes);
+        }
+    } else if (hasJointData) {
+        // If it is connected, pack up the data
         auto startSection = destinationBuffer;
         QReadLocker readLock(&_jointDataLock);
 
@@ -671,8 +965,282 @@ const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSa
         return buffer.size();                                                             \
     }
 
-// read data in packet starting at byte offset and return number of bytes parsed
+#define PREPARE_READ_CHECK(ITEM_NAME, SIZE_TO_READ)                                      \
+    if ((endPosition - sourceBuffer) < (int)SIZE_TO_READ) {                               \
+        if (shouldLogError(now)) {                                                        \
+            qCWarning(avatars) << "AvatarData packet too small, attempting to read " <<   \
+                #ITEM_NAME << ", only " << (endPosition - sourceBuffer) <<                \
+                " bytes left, " << getSessionUUID();                                      \
+        }                                                                                 \
+        return prepared;                                                                  \
+    }
+
+#define HAS_FLAG(B,F) ((B & F) == F)
+
+static const int FAUX_JOINTS_SIZE = 2 * (sizeof(SixByteQuat) + sizeof(SixByteTrans));
+
+AvatarData::PreparedData AvatarData::prepareDataFromBuffer(const QByteArray& buffer) {
+    PreparedData prepared;
+    prepared.buffer = buffer;
+    prepared.size = buffer.size();
+
+    const unsigned char* startPosition = reinterpret_cast<const unsigned char*>(buffer.data());
+    const unsigned char* endPosition = startPosition + buffer.size();
+    const unsigned char* sourceBuffer = startPosition;
+    quint64 now = usecTimestampNow();
+
+    AvatarDataPacket::HasFlags packetStateFlags;
+    PREPARE_READ_CHECK(HasFlags, sizeof(packetStateFlags));
+    memcpy(&packetStateFlags, sourceBuffer, sizeof(packetStateFlags));
+    sourceBuffer += sizeof(packetStateFlags);
+
+    // the sections before the joints are quick to read, they are only stepped over here and read when applied
+    static const struct {
+        AvatarDataPacket::HasFlags flag;
+        size_t size;
+    } FIXED_SIZE_SECTIONS[] = {
+        { AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION, sizeof(AvatarDataPacket::AvatarGlobalPosition) },
+        { AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX, sizeof(AvatarDataPacket::AvatarBoundingBox) },
+        { AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION, sizeof(AvatarDataPacket::AvatarOrientation) },
+        { AvatarDataPacket::PACKET_HAS_AVATAR_SCALE, sizeof(AvatarDataPacket::AvatarScale) },
+        { AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION, sizeof(AvatarDataPacket::LookAtPosition) },
+        { AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS, sizeof(AvatarDataPacket::AudioLoudness) },
+        { AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX, sizeof(AvatarDataPacket::SensorToWorldMatrix) },
+        { AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS, sizeof(AvatarDataPacket::AdditionalFlags) },
+        { AvatarDataPacket::PACKET_HAS_PARENT_INFO, sizeof(AvatarDataPacket::ParentInfo) },
+        { AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION, sizeof(AvatarDataPacket::AvatarLocalPosition) }
+    };
+    for (const auto& section : FIXED_SIZE_SECTIONS) {
+        if (HAS_FLAG(packetStateFlags, section.flag)) {
+            if ((endPosition - sourceBuffer) < (int)section.size) {
+                return prepared;
+            }
+            sourceBuffer += section.size;
+        }
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO)) {
+        if ((endPosition - sourceBuffer) < (int)sizeof(AvatarDataPacket::FaceTrackerInfo)) {
+            return prepared;
+        }
+        auto faceTrackerInfo = reinterpret_cast<const AvatarDataPacket::FaceTrackerInfo*>(sourceBuffer);
+        sourceBuffer += sizeof(AvatarDataPacket::FaceTrackerInfo);
+        int coefficientsSize = faceTrackerCoefficientsSize(faceTrackerInfo, sourceBuffer, endPosition);
+        if ((endPosition - sourceBuffer) < coefficientsSize) {
+            return prepared;
+        }
+        sourceBuffer += coefficientsSize;
+    }
+
+    bool hasJointData = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DATA);
+    bool hasJointDeltaData = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DELTA_DATA);
+    if (!hasJointData && !hasJointDeltaData) {
+        prepared.size = sourceBuffer - startPosition;
+        return prepared;
+    }
+
+    // until they have all been read, the joints are unreadable
+    prepared.jointsOffset = sourceBuffer - startPosition;
+    auto startSection = sourceBuffer;
+
+    if (hasJointDeltaData) {
+        PREPARE_READ_CHECK(NumJoints, sizeof(uint8_t));
+        int numJoints = *sourceBuffer++;
+        PREPARE_READ_CHECK(JointKeyframe, sizeof(uint8_t));
+        uint8_t keyframeByte = *sourceBuffer++;
+        bool isKeyframe = (keyframeByte & JOINT_KEYFRAME_BIT) != 0;
+        uint8_t keyframeID = keyframeByte & JOINT_KEYFRAME_ID_MASK;
+
+        const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
+        PREPARE_READ_CHECK(JointValidityBits, 2 * bytesOfValidity);
+        const unsigned char* rotationValidity = sourceBuffer;
+        const unsigned char* translationValidity = sourceBuffer + bytesOfValidity;
+        sourceBuffer += 2 * bytesOfValidity;
+
+        std::lock_guard<std::mutex> lock(_receivedJointKeyframeMutex);
+
+        // a delta can only be applied to the keyframe it was encoded against, deltas for
+        // a keyframe that never arrived are read past and dropped until the next keyframe
+        auto& keyframe = _receivedJointKeyframe;
+        bool canApply = isKeyframe ||
+            (keyframe.isValid && keyframe.id == keyframeID && (int)keyframe.joints.size() == numJoints);
+        if (isKeyframe) {
+            keyframe.id = keyframeID;
+            keyframe.isValid = false; // until it has been completely read
+            keyframe.joints.assign(numJoints, AvatarDataPacket::JointKeyframe::Joint());
+        }
+        if (canApply) {
+            prepared.joints.resize(numJoints);
+        }
+
+        static const uint16_t ZERO_REFERENCE[3] = { 0, 0, 0 };
+        JointDeltaReader reader(sourceBuffer, endPosition);
+        AvatarDataPacket::JointKeyframe::Joint discardedJoint;
+
+        // rotations, then translations - a joint that is left out of a delta takes the keyframe's value
+        for (int i = 0; i < numJoints; i++) {
+            auto& keyframeJoint = canApply ? keyframe.joints[i] : discardedJoint;
+            uint16_t quantized[3];
+            if (rotationValidity[i / BITS_IN_BYTE] & (1 << (i % BITS_IN_BYTE))) {
+                bool hasReference = !isKeyframe && keyframeJoint.rotationValid;
+                if (!reader.readDelta(quantized, hasReference ? keyframeJoint.rotation : ZERO_REFERENCE)) {
+                    if (shouldLogError(now)) {
+                        qCWarning(avatars) << "AvatarData packet too small, attempting to read JointRotationDeltas"
+                            << getSessionUUID();
+                    }
+                    return prepared;
+                }
+                if (isKeyframe) {
+                    memcpy(keyframeJoint.rotation, quantized, sizeof(quantized));
+                    keyframeJoint.rotationValid = true;
+                }
+            } else if (!isKeyframe && keyframeJoint.rotationValid) {
+                memcpy(quantized, keyframeJoint.rotation, sizeof(quantized));
+            } else {
+                continue;
+            }
+
+            if (canApply) {
+                JointData& data = prepared.joints[i];
+                data.rotation = dequantizeJointRotation(quantized);
+                data.rotationSet = true;
+            }
+        }
+
+        for (int i = 0; i < numJoints; i++) {
+            auto& keyframeJoint = canApply ? keyframe.joints[i] : discardedJoint;
+            int16_t quantized[3];
+            if (translationValidity[i / BITS_IN_BYTE] & (1 << (i % BITS_IN_BYTE))) {
+                bool hasReference = !isKeyframe && keyframeJoint.translationValid;
+                if (!reader.readDelta(reinterpret_cast<uint16_t*>(quantized), hasReference ?
+                        reinterpret_cast<const uint16_t*>(keyframeJoint.translation) : ZERO_REFERENCE)) {
+                    if (shouldLogError(now)) {
+                        qCWarning(avatars) << "AvatarData packet too small, attempting to read JointTranslationDeltas"
+                            << getSessionUUID();
+                    }
+                    return prepared;
+                }
+                if (isKeyframe) {
+                    memcpy(keyframeJoint.translation, quantized, sizeof(quantized));
+                    keyframeJoint.translationValid = true;
+                }
+            } else if (!isKeyframe && keyframeJoint.translationValid) {
+                memcpy(quantized, keyframeJoint.translation, sizeof(quantized));
+            } else {
+                continue;
+            }
+
+            if (canApply) {
+                JointData& data = prepared.joints[i];
+                data.translation = dequantizeJointTranslation(quantized);
+                data.translationSet = true;
+            }
+        }
+        sourceBuffer += reader.finish();
+
+        if (isKeyframe) {
+            keyframe.isValid = true;
+        }
+        prepared.areJointsApplicable = canApply;
+    } else {
+        PREPARE_READ_CHECK(NumJoints, sizeof(uint8_t));
+        int numJoints = *sourceBuffer++;
+        const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
+        PREPARE_READ_CHECK(JointRotationValidityBits, bytesOfValidity);
+
+        int numValidJointRotations = 0;
+        QVector<bool> validRotations;
+        validRotations.resize(numJoints);
+        { // rotation validity bits
+            unsigned char validity = 0;
+            int validityBit = 0;
+            for (int i = 0; i < numJoints; i++) {
+                if (validityBit == 0) {
+                    validity = *sourceBuffer++;
+                }
+                bool valid = (bool)(validity & (1 << validityBit));
+                if (valid) {
+                    ++numValidJointRotations;
+                }
+                validRotations[i] = valid;
+                validityBit = (validityBit + 1) % BITS_IN_BYTE;
+            }
+        }
+
+        prepared.joints.resize(numJoints);
+
+        // each joint rotation is stored in 6 bytes.
+        const int COMPRESSED_QUATERNION_SIZE = 6;
+        PREPARE_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
+        for (int i = 0; i < numJoints; i++) {
+            JointData& data = prepared.joints[i];
+            if (validRotations[i]) {
+                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
+                data.rotationSet = true;
+            }
+        }
+
+        PREPARE_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
+
+        // get translation validity bits -- these indicate which translations were packed
+        int numValidJointTranslations = 0;
+        QVector<bool> validTranslations;
+        validTranslations.resize(numJoints);
+        { // translation validity bits
+            unsigned char validity = 0;
+            int validityBit = 0;
+            for (int i = 0; i < numJoints; i++) {
+                if (validityBit == 0) {
+                    validity = *sourceBuffer++;
+                }
+                bool valid = (bool)(validity & (1 << validityBit));
+                if (valid) {
+                    ++numValidJointTranslations;
+                }
+                validTranslations[i] = valid;
+                validityBit = (validityBit + 1) % BITS_IN_BYTE;
+            }
+        } // 1 + bytesOfValidity bytes
+
+        // each joint translation component is stored in 6 bytes.
+        const int COMPRESSED_TRANSLATION_SIZE = 6;
+        PREPARE_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
+
+        for (int i = 0; i < numJoints; i++) {
+            JointData& data = prepared.joints[i];
+            if (validTranslations[i]) {
+                sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
+                data.translationSet = true;
+            }
+        }
+
+#ifdef WANT_DEBUG
+        if (numValidJointRotations > 15) {
+            qCDebug(avatars) << "RECEIVING -- rotations:" << numValidJointRotations
+                << "translations:" << numValidJointTranslations
+                << "size:" << (int)(sourceBuffer - startPosition);
+        }
+#endif
+        prepared.areJointsApplicable = true;
+    }
+
+    prepared.jointsSize = sourceBuffer - startSection;
+
+    // the faux joints are left to be read when the joints are applied
+    if ((endPosition - sourceBuffer) >= FAUX_JOINTS_SIZE) {
+        prepared.size = (sourceBuffer + FAUX_JOINTS_SIZE) - startPosition;
+    }
+    return prepared;
+}
+
 int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
+    return parsePreparedData(prepareDataFromBuffer(buffer));
+}
+
+// read data in packet starting at byte offset and return number of bytes parsed
+int AvatarData::parsePreparedData(const PreparedData& prepared) {
+    const QByteArray& buffer = prepared.buffer;
+
     // lazily allocate memory for HeadData in case we're not an Avatar instance
     lazyInitHeadData();
 
@@ -686,8 +1254,6 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     memcpy(&packetStateFlags, sourceBuffer, sizeof(packetStateFlags));
     sourceBuffer += sizeof(packetStateFlags);
 
-    #define HAS_FLAG(B,F) ((B & F) == F)
-
     bool hasAvatarGlobalPosition = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION);
     bool hasAvatarBoundingBox    = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX);
     bool hasAvatarOrientation    = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION);
@@ -700,6 +1266,7 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     bool hasAvatarLocalPosition  = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION);
     bool hasFaceTrackerInfo      = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO);
     bool hasJointData            = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DATA);
+    bool hasJointDeltaData       = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DELTA_DATA);
 
     quint64 now = usecTimestampNow();
 
@@ -949,102 +1516,53 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         _headData->_browAudioLift = faceTrackerInfo->browAudioLift;
 
         int numCoefficients = faceTrackerInfo->numBlendshapeCoefficients;
-        const int coefficientsSize = sizeof(float) * numCoefficients;
+        const int coefficientsSize = faceTrackerCoefficientsSize(faceTrackerInfo, sourceBuffer, endPosition);
         PACKET_READ_CHECK(FaceTrackerCoefficients, coefficientsSize);
         _headData->_blendshapeCoefficients.resize(numCoefficients);  // make sure there's room for the copy!
         _headData->_transientBlendshapeCoefficients.resize(numCoefficients);
-        memcpy(_headData->_blendshapeCoefficients.data(), sourceBuffer, coefficientsSize);
+        const uint8_t* validity = sourceBuffer;
+        const uint8_t* quantized = sourceBuffer + (int)std::ceil(numCoefficients / (float)BITS_IN_BYTE);
+        for (int i = 0; i < numCoefficients; i++) {
+            bool isValid = validity[i / BITS_IN_BYTE] & (1 << (i % BITS_IN_BYTE));
+            _headData->_blendshapeCoefficients[i] = isValid ? (float)(*quantized++) / BLENDSHAPE_COEFFICIENT_SCALE : 0.0f;
+        }
         sourceBuffer += coefficientsSize;
         int numBytesRead = sourceBuffer - startSection;
         _faceTrackerRate.increment(numBytesRead);
         _faceTrackerUpdateRate.increment();
     }
 
-    if (hasJointData) {
+    if (hasJointData || hasJointDeltaData) {
         auto startSection = sourceBuffer;
 
-        PACKET_READ_CHECK(NumJoints, sizeof(uint8_t));
-        int numJoints = *sourceBuffer++;
-        const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
-        PACKET_READ_CHECK(JointRotationValidityBits, bytesOfValidity);
-
-        int numValidJointRotations = 0;
-        QVector<bool> validRotations;
-        validRotations.resize(numJoints);
-        { // rotation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
-            for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
-                }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointRotations;
-                }
-                validRotations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
-        }
-
-        // each joint rotation is stored in 6 bytes.
-        QWriteLocker writeLock(&_jointDataLock);
-        _jointData.resize(numJoints);
-
-        const int COMPRESSED_QUATERNION_SIZE = 6;
-        PACKET_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (validRotations[i]) {
-                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
-                _hasNewJointData = true;
-                data.rotationSet = true;
-            }
+        // the joints were unpacked when the data was prepared, which already warned if they couldn't be
+        if (prepared.jointsOffset != startSection - startPosition || prepared.jointsSize < 0) {
+            return buffer.size();
         }
+        sourceBuffer += prepared.jointsSize;
 
-        PACKET_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
-
-        // get translation validity bits -- these indicate which translations were packed
-        int numValidJointTranslations = 0;
-        QVector<bool> validTranslations;
-        validTranslations.resize(numJoints);
-        { // translation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
+        if (prepared.areJointsApplicable) {
+            QWriteLocker writeLock(&_jointDataLock);
+            int numJoints = prepared.joints.size();
+            _jointData.resize(numJoints);
             for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
+                const JointData& preparedData = prepared.joints[i];
+                JointData& data = _jointData[i];
+                if (preparedData.rotationSet) {
+                    data.rotation = preparedData.rotation;
+                    data.rotationSet = true;
+                    _hasNewJointData = true;
                 }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointTranslations;
+                if (preparedData.translationSet) {
+                    data.translation = preparedData.translation;
+                    data.translationSet = true;
+                    _hasNewJointData = true;
                 }
-                validTranslations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
-        } // 1 + bytesOfValidity bytes
-
-        // each joint translation component is stored in 6 bytes.
-        const int COMPRESSED_TRANSLATION_SIZE = 6;
-        PACKET_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
-
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (validTranslations[i]) {
-                sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
-                _hasNewJointData = true;
-                data.translationSet = true;
             }
         }
 
-#ifdef WANT_DEBUG
-        if (numValidJointRotations > 15) {
-            qCDebug(avatars) << "RECEIVING -- rotations:" << numValidJointRotations
-                << "translations:" << numValidJointTranslations
-                << "size:" << (int)(sourceBuffer - startPosition);
-        }
-#endif
         // faux joints
+        PACKET_READ_CHECK(FauxJoints, FAUX_JOINTS_SIZE);
         sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerLeftHandMatrixCache);
         sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerRightHandMatrixCache);
 
@@ -2440,6 +2958,41 @@ float AvatarData::_avatarSortCoefficientSize { 0.5f };
 float AvatarData::_avatarSortCoefficientCenter { 0.25 };
 float AvatarData::_avatarSortCoefficientAge { 1.0f };
 
+static float computeAvatarPriority(const AvatarSharedPointer& avatar, const ViewFrustum& cameraView, uint64_t now,
+                                   const std::function<uint64_t(AvatarSharedPointer)>& getLastUpdated,
+                                   const std::function<float(AvatarSharedPointer)>& getBoundingRadius) {
+    // priority = weighted linear combination of:
+    //   (a) apparentSize
+    //   (b) proximity to center of view
+    //   (c) time since last update
+    glm::vec3 avatarPosition = avatar->getPosition();
+    glm::vec3 offset = avatarPosition - cameraView.getPosition();
+    float distance = glm::length(offset) + 0.001f; // add 1mm to avoid divide by zero
+
+    // FIXME - AvatarData has something equivolent to this
+    float radius = getBoundingRadius(avatar);
+
+    float apparentSize = 2.0f * radius / distance;
+    float cosineAngle = glm::dot(offset, cameraView.getDirection()) / distance;
+    float age = (float)(now - getLastUpdated(avatar)) / (float)(USECS_PER_SECOND);
+
+    // NOTE: we are adding values of different units to get a single measure of "priority".
+    // Thus we multiply each component by a conversion "weight" that scales its units relative to the others.
+    // These weights are pure magic tuning and should be hard coded in the relation below,
+    // but are currently exposed for anyone who would like to explore fine tuning:
+    float priority = AvatarData::_avatarSortCoefficientSize * apparentSize
+        + AvatarData::_avatarSortCoefficientCenter * cosineAngle
+        + AvatarData::_avatarSortCoefficientAge * age;
+
+    // decrement priority of avatars outside keyhole
+    if (distance > cameraView.getCenterRadius()) {
+        if (!cameraView.sphereIntersectsFrustum(avatarPosition, radius)) {
+            priority += AvatarData::OUT_OF_VIEW_PENALTY;
+        }
+    }
+    return priority;
+}
+
 void AvatarData::sortAvatars(
         QList<AvatarSharedPointer> avatarList,
         const ViewFrustum& cameraView,
@@ -2451,8 +3004,6 @@ void AvatarData::sortAvatars(
     PROFILE_RANGE(simulation, "sort");
     uint64_t now = usecTimestampNow();
 
-    glm::vec3 frustumCenter = cameraView.getPosition();
-    const glm::vec3& forward = cameraView.getDirection();
     for (int32_t i = 0; i < avatarList.size(); ++i) {
         const auto& avatar = avatarList.at(i);
 
@@ -2460,39 +3011,78 @@ void AvatarData::sortAvatars(
             continue;
         }
 
-        // priority = weighted linear combination of:
-        //   (a) apparentSize
-        //   (b) proximity to center of view
-        //   (c) time since last update
-        glm::vec3 avatarPosition = avatar->getPosition();
-        glm::vec3 offset = avatarPosition - frustumCenter;
-        float distance = glm::length(offset) + 0.001f; // add 1mm to avoid divide by zero
-
-        // FIXME - AvatarData has something equivolent to this
-        float radius = getBoundingRadius(avatar);
-
-        float apparentSize = 2.0f * radius / distance;
-        float cosineAngle = glm::dot(offset, forward) / distance;
-        float age = (float)(now - getLastUpdated(avatar)) / (float)(USECS_PER_SECOND);
-
-        // NOTE: we are adding values of different units to get a single measure of "priority".
-        // Thus we multiply each component by a conversion "weight" that scales its units relative to the others.
-        // These weights are pure magic tuning and should be hard coded in the relation below,
-        // but are currently exposed for anyone who would like to explore fine tuning:
-        float priority = _avatarSortCoefficientSize * apparentSize
-            + _avatarSortCoefficientCenter * cosineAngle
-            + _avatarSortCoefficientAge * age;
-
-        // decrement priority of avatars outside keyhole
-        if (distance > cameraView.getCenterRadius()) {
-            if (!cameraView.sphereIntersectsFrustum(avatarPosition, radius)) {
-                priority += OUT_OF_VIEW_PENALTY;
-            }
-        }
+        float priority = computeAvatarPriority(avatar, cameraView, now, getLastUpdated, getBoundingRadius);
         sortedAvatarsOut.push(AvatarPriority(avatar, priority));
     }
 }
 
+void AvatarData::sortAvatars(
+        QList<AvatarSharedPointer> avatarList,
+        const ViewFrustum& cameraView,
+        std::vector<AvatarPriority>& sortedAvatarsInOut,
+        std::function<uint64_t(AvatarSharedPointer)> getLastUpdated,
+        std::function<float(AvatarSharedPointer)> getBoundingRadius,
+        std::function<bool(AvatarSharedPointer)> shouldIgnore) {
+
+    PROFILE_RANGE(simulation, "sort");
+    uint64_t now = usecTimestampNow();
+
+    // where each avatar was in the previous order
+    std::unordered_map<const AvatarData*, int> previousIndices;
+    previousIndices.reserve(sortedAvatarsInOut.size());
+    for (int i = 0; i < (int)sortedAvatarsInOut.size(); ++i) {
+        previousIndices[sortedAvatarsInOut[i].avatar.get()] = i;
+    }
+
+    // slot the avatars we still have back into their previous positions, and append new ones
+    std::vector<AvatarPriority> previousOrder;
+    previousOrder.swap(sortedAvatarsInOut);
+    std::vector<bool> isPresent(previousOrder.size(), false);
+    std::vector<AvatarPriority> newAvatars;
+
+    for (int32_t i = 0; i < avatarList.size(); ++i) {
+        const auto& avatar = avatarList.at(i);
+
+        if (shouldIgnore(avatar)) {
+            continue;
+        }
+
+        float priority = computeAvatarPriority(avatar, cameraView, now, getLastUpdated, getBoundingRadius);
+
+        auto it = previousIndices.find(avatar.get());
+        if (it != previousIndices.end()) {
+            previousOrder[it->second].avatar = avatar;
+            previousOrder[it->second].priority = priority;
+            isPresent[it->second] = true;
+        } else {
+            newAvatars.emplace_back(avatar, priority);
+        }
+    }
+
+    sortedAvatarsInOut.reserve(previousOrder.size() + newAvatars.size());
+    for (int i = 0; i < (int)previousOrder.size(); ++i) {
+        if (isPresent[i]) {
+            sortedAvatarsInOut.push_back(std::move(previousOrder[i]));
+        }
+    }
+    std::move(newAvatars.begin(), newAvatars.end(), std::back_inserter(sortedAvatarsInOut));
+
+    // insertion sort, highest priority first
+    for (int i = 1; i < (int)sortedAvatarsInOut.size(); ++i) {
+        if (sortedAvatarsInOut[i - 1].priority >= sortedAvatarsInOut[i].priority) {
+            continue;
+        }
+
+        AvatarPriority moving = std::move(sortedAvatarsInOut[i]);
+        int j = i;
+        while (j > 0 && sortedAvatarsInOut[j - 1].priority < moving.priority) {
+            sortedAvatarsInOut[j] = std::move(sortedAvatarsInOut[j - 1]);
+            --j;
+        }
+        sortedAvatarsInOut[j] = std::move(moving);
+    }
+}
+
 QScriptValue AvatarEntityMapToScriptValue(QScriptEngine* engine, const AvatarEntityMap& value) {
     QScriptValue obj = engine->newObject();
     for (auto entityID : value.keys()) {
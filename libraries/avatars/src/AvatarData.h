@@ -14,6 +14,7 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 #include <queue>
 
 /* VS2010 defines stdint.h, but not inttypes.h */
@@ -138,6 +139,7 @@ namespace AvatarDataPacket {
     const HasFlags PACKET_HAS_AVATAR_LOCAL_POSITION  = 1U << 9;
     const HasFlags PACKET_HAS_FACE_TRACKER_INFO      = 1U << 10;
     const HasFlags PACKET_HAS_JOINT_DATA             = 1U << 11;
+    const HasFlags PACKET_HAS_JOINT_DELTA_DATA       = 1U << 12;
     const size_t AVATAR_HAS_FLAGS_SIZE = 2;
 
     using SixByteQuat = uint8_t[6];
@@ -253,7 +255,8 @@ namespace AvatarDataPacket {
         float averageLoudness;
         float browAudioLift;
         uint8_t numBlendshapeCoefficients;
-        // float blendshapeCoefficients[numBlendshapeCoefficients];
+        // uint8_t validityBits[ceil(numBlendshapeCoefficients / BITS_IN_BYTE)]; // the coefficients that aren't 0
+        // uint8_t blendshapeCoefficients[numValidBlendshapeCoefficients];       // quantized in [0, 1]
     } PACKED_END;
     const size_t FACE_TRACKER_INFO_SIZE = 17;
     static_assert(sizeof(FaceTrackerInfo) == FACE_TRACKER_INFO_SIZE, "AvatarDataPacket::FaceTrackerInfo size doesn't match.");
@@ -269,6 +272,37 @@ namespace AvatarDataPacket {
     };
     */
     size_t maxJointDataSize(size_t numJoints);
+
+    /*
+    struct JointDeltaData {
+        uint8_t numJoints;
+        uint8_t keyframe;                                      // keyframe ID in the low 7 bits, high bit set if this is a keyframe
+        uint8_t rotationValidityBits[ceil(numJoints / 8)];     // one bit per joint, if true then a rotation delta follows.
+        uint8_t translationValidityBits[ceil(numJoints / 8)];  // one bit per joint, if true then a translation delta follows.
+        bits deltas[];              // per valid rotation, then per valid translation: a 5 bit width W, followed by the three
+                                    // quantized components' zig-zag encoded differences from the keyframe in W bits each,
+                                    // padded to a whole byte. A keyframe's differences are from zero.
+        SixByteQuat/SixByteTrans fauxJoints[2];
+    };
+    */
+    size_t maxJointDeltaDataSize(size_t numJoints);
+
+    // Quantized joint state that JointDeltaData is relative to. The sender keeps one per receiver, and starts a new
+    // keyframe every JOINT_KEYFRAME_INTERVAL packets. The receiver keeps the last keyframe it got, and ignores deltas
+    // against any other, so a lost packet can only hold an avatar's joints until the next keyframe.
+    struct JointKeyframe {
+        struct Joint {
+            uint16_t rotation[3] {};      // packOrientationQuatToSixBytes(), as three words
+            int16_t translation[3] {};    // packFloatVec3ToSignedTwoByteFixed()
+            bool rotationValid { false };
+            bool translationValid { false };
+        };
+        std::vector<Joint> joints;
+        uint8_t id { 0 };
+        int age { 0 };                    // delta packets sent against this keyframe (sender only)
+        bool isValid { false };
+    };
+    const int JOINT_KEYFRAME_INTERVAL = 15;
 }
 
 static const float MAX_AVATAR_SCALE = 1000.0f;
@@ -297,6 +331,9 @@ const float AVATAR_DISTANCE_LEVEL_2 = 100.0f;
 const float AVATAR_DISTANCE_LEVEL_3 = 1000.0f;
 const float AVATAR_DISTANCE_LEVEL_4 = 10000.0f;
 
+// past this distance from the viewer, a face is too small on screen for its blendshapes to be sent
+const float AVATAR_FACE_TRACKER_INFO_DISTANCE = 20.0f;
+
 
 // Where one's own Avatar begins in the world (will be overwritten if avatar data file is found).
 // This is the start location in the Sandbox (xyz: 6270, 211, 6000).
@@ -413,24 +450,43 @@ public:
         MinimumData,
         CullSmallData,
         IncludeSmallData,
-        SendAllData
+        SendAllData,
+        SendJointDeltaData // as CullSmallData, with joints delta encoded against a JointKeyframe
     } AvatarDataDetail;
 
     virtual QByteArray toByteArrayStateful(AvatarDataDetail dataDetail, bool dropFaceTracking = false);
 
     virtual QByteArray toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
         AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
-        QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut = nullptr) const;
+        QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut = nullptr,
+        AvatarDataPacket::JointKeyframe* jointKeyframeInOut = nullptr) const;
 
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
     bool shouldLogError(const quint64& now);
 
+    // The avatar's data in a packet with its joints already unpacked, which is what takes the longest to read.
+    struct PreparedData {
+        QByteArray buffer;
+        int size { 0 };                     // bytes of the buffer that are this avatar's data
+        int jointsOffset { -1 };            // where the joints start in the buffer, -1 if the data doesn't get to them
+        int jointsSize { -1 };              // bytes of joints before the faux joints, -1 if they couldn't be read
+        bool areJointsApplicable { false }; // false for deltas against a keyframe that didn't arrive
+        QVector<JointData> joints;          // with rotationSet and translationSet for the ones that were sent
+    };
+
+    /// doesn't change anything the avatar is made of, so it can be called on another thread than the one
+    /// parsing the prepared data, as long as the avatar's data is prepared in the order it was sent
+    PreparedData prepareDataFromBuffer(const QByteArray& buffer);
+
+    /// \return number of bytes parsed
+    virtual int parsePreparedData(const PreparedData& prepared);
+
     /// \param packet byte array of data
     /// \param offset number of bytes into packet where data starts
     /// \return number of bytes parsed
-    virtual int parseDataFromBuffer(const QByteArray& buffer);
+    int parseDataFromBuffer(const QByteArray& buffer);
 
     // Body Rotation (degrees)
     float getBodyYaw() const;
@@ -644,6 +700,18 @@ public:
         std::function<float(AvatarSharedPointer)> getBoundingRadius,
         std::function<bool(AvatarSharedPointer)> shouldIgnore);
 
+    // Incremental version of the above, for a listener that sorts the same avatars every frame.
+    // sortedAvatarsInOut holds the previous order (highest priority first) and is updated in place:
+    // avatars that went away are dropped, new ones are appended, then an insertion sort restores the order,
+    // which is close to linear since priorities change slowly from one frame to the next.
+    static void sortAvatars(
+        QList<AvatarSharedPointer> avatarList,
+        const ViewFrustum& cameraView,
+        std::vector<AvatarPriority>& sortedAvatarsInOut,
+        std::function<uint64_t(AvatarSharedPointer)> getLastUpdated,
+        std::function<float(AvatarSharedPointer)> getBoundingRadius,
+        std::function<bool(AvatarSharedPointer)> shouldIgnore);
+
     // TODO: remove this HACK once we settle on optimal sort coefficients
     // These coefficients exposed for fine tuning the sort priority for transfering new _jointData to the render pipeline.
     static float _avatarSortCoefficientSize;
@@ -654,6 +722,7 @@ public:
     void markIdentityDataChanged() { _identityDataChanged = true; }
 
     void pushIdentitySequenceNumber() { ++_identitySequenceNumber; };
+    udt::SequenceNumber getIdentitySequenceNumber() const { return _identitySequenceNumber; }
     bool hasProcessedFirstIdentity() const { return _hasProcessedFirstIdentity; }
 
     float getDensity() const { return _density; }
@@ -715,6 +784,8 @@ protected:
     QVector<JointData> _jointData; ///< the state of the skeleton joints
     QVector<JointData> _lastSentJointData; ///< the state of the skeleton joints last time we transmitted
     mutable QReadWriteLock _jointDataLock;
+    AvatarDataPacket::JointKeyframe _receivedJointKeyframe; ///< the keyframe that received joint deltas apply to
+    std::mutex _receivedJointKeyframeMutex;
 
     // key state
     KeyState _keyState;
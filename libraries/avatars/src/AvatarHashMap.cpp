@@ -91,20 +91,58 @@ AvatarSharedPointer AvatarHashMap::findAvatar(const QUuid& sessionUUID) const {
 }
 
 void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    PerformanceTimer perfTimer("receiveAvatar");
-    // enumerate over all of the avatars in this packet
-    // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
+    PreparedAvatarDataPacket packet { message, sendingNode, {} };
+
+    // enumerate over all of the avatars in this packet, unpacking their joints here and leaving the rest to be
+    // parsed on this object's thread
     while (message->getBytesLeftToRead()) {
-        parseAvatarData(message, sendingNode);
+        PreparedAvatar preparedAvatar;
+        preparedAvatar.sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+
+        int positionBeforeRead = message->getPosition();
+        QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
+
+        preparedAvatar.avatar = findAvatar(preparedAvatar.sessionUUID);
+        if (preparedAvatar.avatar) {
+            preparedAvatar.data = preparedAvatar.avatar->prepareDataFromBuffer(byteArray);
+        } else {
+            // an avatar that isn't there yet parses its own data once it is added, this only finds where it ends
+            AvatarData standInData;
+            preparedAvatar.data = standInData.prepareDataFromBuffer(byteArray);
+        }
+        message->seek(positionBeforeRead + preparedAvatar.data.size);
+        packet.avatars.push_back(std::move(preparedAvatar));
+    }
+
+    bool isProcessingQueued;
+    {
+        std::lock_guard<std::mutex> lock(_preparedAvatarDataMutex);
+        isProcessingQueued = !_preparedAvatarData.empty();
+        _preparedAvatarData.push_back(std::move(packet));
+    }
+    if (!isProcessingQueued) {
+        QMetaObject::invokeMethod(this, "processPreparedAvatarData", Qt::QueuedConnection);
     }
 }
 
-AvatarSharedPointer AvatarHashMap::parseAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+void AvatarHashMap::processPreparedAvatarData() {
+    PerformanceTimer perfTimer("receiveAvatar");
+    std::vector<PreparedAvatarDataPacket> packets;
+    {
+        std::lock_guard<std::mutex> lock(_preparedAvatarDataMutex);
+        packets.swap(_preparedAvatarData);
+    }
 
-    int positionBeforeRead = message->getPosition();
+    // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
+    for (const auto& packet : packets) {
+        for (const auto& preparedAvatar : packet.avatars) {
+            parseAvatarData(preparedAvatar, packet.sendingNode);
+        }
+    }
+}
 
-    QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
+AvatarSharedPointer AvatarHashMap::parseAvatarData(const PreparedAvatar& preparedAvatar, SharedNodePointer sendingNode) {
+    const QUuid& sessionUUID = preparedAvatar.sessionUUID;
 
     // make sure this isn't our own avatar data or for a previously ignored node
     auto nodeList = DependencyManager::get<NodeList>();
@@ -113,14 +151,14 @@ AvatarSharedPointer AvatarHashMap::parseAvatarData(QSharedPointer<ReceivedMessag
         auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
 
         // have the matching (or new) avatar parse the data from the packet
-        int bytesRead = avatar->parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
+        if (avatar == preparedAvatar.avatar) {
+            avatar->parsePreparedData(preparedAvatar.data);
+        } else {
+            avatar->parseDataFromBuffer(preparedAvatar.data.buffer);
+        }
         return avatar;
     } else {
-        // create a dummy AvatarData class to throw this data on the ground
-        AvatarData dummyData;
-        int bytesRead = dummyData.parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
+        // the data was already read past, it is just thrown on the ground
         return std::make_shared<AvatarData>();
     }
 }
@@ -18,6 +18,8 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -57,14 +59,24 @@ public slots:
 protected slots:
     void sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& oldUUID);
 
+    // can be called on the thread that received the packet, the data is parsed into the avatars on this object's
     void processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
     void processAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
     void processKillAvatar(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
 
+private slots:
+    void processPreparedAvatarData();
+
 protected:
+    struct PreparedAvatar {
+        QUuid sessionUUID;
+        AvatarSharedPointer avatar; // what the data was prepared by, null for an avatar that wasn't there yet
+        AvatarData::PreparedData data;
+    };
+
     AvatarHashMap();
 
-    virtual AvatarSharedPointer parseAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+    virtual AvatarSharedPointer parseAvatarData(const PreparedAvatar& preparedAvatar, SharedNodePointer sendingNode);
     virtual AvatarSharedPointer newSharedAvatar();
     virtual AvatarSharedPointer addAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer);
     AvatarSharedPointer newOrExistingAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer);
@@ -79,7 +91,16 @@ protected:
     mutable QReadWriteLock _hashLock;
 
 private:
+    struct PreparedAvatarDataPacket {
+        QSharedPointer<ReceivedMessage> message; // keeps the buffers of its avatars' data
+        SharedNodePointer sendingNode;
+        std::vector<PreparedAvatar> avatars;
+    };
+
     QUuid _lastOwnerSessionUUID;
+
+    std::mutex _preparedAvatarDataMutex;
+    std::vector<PreparedAvatarDataPacket> _preparedAvatarData;
 };
 
 #endif // hifi_AvatarHashMap_h
@@ -8,6 +8,7 @@
 
 #include "UserInputMapper.h"
 
+#include <algorithm>
 #include <set>
 
 #include <QtCore/QThread>
@@ -469,7 +470,7 @@ void UserInputMapper::runMappings() {
     if (debugRoutes) {
         qCDebug(controllers) << "Beginning mapping frame";
     }
-    for (auto endpointEntry : this->_endpointsByInput) {
+    for (const auto& endpointEntry : _endpointsByInput) {
         endpointEntry.second->reset();
     }
 
@@ -477,12 +478,12 @@ void UserInputMapper::runMappings() {
         qCDebug(controllers) << "Processing device routes";
     }
     // Now process the current values for each level of the stack
-    applyRoutes(_deviceRoutes);
+    applyRoutes(_compiledDeviceRoutes);
 
     if (debugRoutes) {
         qCDebug(controllers) << "Processing standard routes";
     }
-    applyRoutes(_standardRoutes);
+    applyRoutes(_compiledStandardRoutes);
 
     if (debugRoutes) {
         qCDebug(controllers) << "Done with mappings";
@@ -491,26 +492,25 @@ void UserInputMapper::runMappings() {
 }
 
 // Encapsulate the logic that routes should not be read before they are written
-void UserInputMapper::applyRoutes(const Route::List& routes) {
-    Route::List deferredRoutes;
+void UserInputMapper::applyRoutes(const RouteVector& routes) {
+    // kept between frames so that deferring a route doesn't allocate
+    _deferredRoutes.clear();
 
     for (const auto& route : routes) {
-        if (!route) {
-            continue;
-        }
-
         // Try all the deferred routes
-        deferredRoutes.remove_if([](Route::Pointer route) {
-            return UserInputMapper::applyRoute(route);
-        });
+        if (!_deferredRoutes.empty()) {
+            _deferredRoutes.erase(std::remove_if(_deferredRoutes.begin(), _deferredRoutes.end(), [](const Route::Pointer& route) {
+                return UserInputMapper::applyRoute(route);
+            }), _deferredRoutes.end());
+        }
 
         if (!applyRoute(route)) {
-            deferredRoutes.push_back(route);
+            _deferredRoutes.push_back(route);
         }
     }
 
     bool force = true;
-    for (const auto& route : deferredRoutes) {
+    for (const auto& route : _deferredRoutes) {
         UserInputMapper::applyRoute(route, force);
     }
 }
@@ -1192,6 +1192,7 @@ void UserInputMapper::enableMapping(const Mapping::Pointer& mapping) {
     if (!debuggableRoutes) {
         debuggableRoutes = hasDebuggableRoute(_deviceRoutes) || hasDebuggableRoute(_standardRoutes);
     }
+    compileRoutes();
 }
 
 void UserInputMapper::disableMapping(const Mapping::Pointer& mapping) {
@@ -1208,6 +1209,23 @@ void UserInputMapper::disableMapping(const Mapping::Pointer& mapping) {
     if (debuggableRoutes) {
         debuggableRoutes = hasDebuggableRoute(_deviceRoutes) || hasDebuggableRoute(_standardRoutes);
     }
+    compileRoutes();
+}
+
+void UserInputMapper::compileRoutes() {
+    // the order of the routes is kept, a route whose source isn't written yet is still deferred as it is run
+    auto compile = [](const Route::List& routes, RouteVector& compiledRoutes) {
+        compiledRoutes.clear();
+        compiledRoutes.reserve(routes.size());
+        for (const auto& route : routes) {
+            if (route) {
+                compiledRoutes.push_back(route);
+            }
+        }
+    };
+    compile(_deviceRoutes, _compiledDeviceRoutes);
+    compile(_standardRoutes, _compiledStandardRoutes);
+    _deferredRoutes.reserve(_compiledDeviceRoutes.size() + _compiledStandardRoutes.size());
 }
 
 }
@@ -16,6 +16,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <QtQml/QJSValue>
 #include <QtScript/QScriptValue>
@@ -155,7 +156,9 @@ namespace controller {
 
         void runMappings();
 
-        static void applyRoutes(const RouteList& route);
+        using RouteVector = std::vector<RoutePointer>;
+        void compileRoutes();
+        void applyRoutes(const RouteVector& routes);
         static bool applyRoute(const RoutePointer& route, bool force = false);
         void enableMapping(const MappingPointer& mapping);
         void disableMapping(const MappingPointer& mapping);
@@ -189,6 +192,11 @@ namespace controller {
         RouteList _deviceRoutes;
         RouteList _standardRoutes;
 
+        // the routes as they are run each frame, made again only when a mapping is enabled or disabled
+        RouteVector _compiledDeviceRoutes;
+        RouteVector _compiledStandardRoutes;
+        RouteVector _deferredRoutes;
+
         QSet<QString> _loadedRouteJsonFiles;
 
         InputCalibrationData inputCalibrationData;
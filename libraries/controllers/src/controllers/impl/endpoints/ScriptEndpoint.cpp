@@ -30,7 +30,7 @@ void ScriptEndpoint::updateValue() {
     // If the callable ever returns a non-number, we assume it's a pose
     // and start reporting ourselves as a pose.
     if (result.isNumber()) {
-        _lastValueRead = (float)_callable.call().toNumber();
+        _lastValueRead = (float)result.toNumber();
     } else {
         Pose::fromScriptValue(result, _lastPoseRead);
         _returnPose = true;
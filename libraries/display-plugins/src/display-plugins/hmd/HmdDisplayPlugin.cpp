@@ -38,9 +38,11 @@
 
 static const QString MONO_PREVIEW = "Mono Preview";
 static const QString DISABLE_PREVIEW = "Disable Preview";
+static const QString FOVEATED_RENDERING = "Foveated Rendering";
 static const QString FRAMERATE = DisplayPlugin::MENU_PATH() + ">Framerate";
 static const QString DEVELOPER_MENU_PATH = "Developer>" + DisplayPlugin::MENU_PATH();
 static const bool DEFAULT_MONO_VIEW = true;
+static const bool DEFAULT_FOVEATED_RENDERING = false;
 #if !defined(Q_OS_MAC)
 static const bool DEFAULT_DISABLE_PREVIEW = false;
 #endif
@@ -64,6 +66,8 @@ static QString readFile(const QString& filename) {
     return result;
 }
 
+const float HmdDisplayPlugin::FOVEATED_RADIUS = 0.6f;
+
 glm::uvec2 HmdDisplayPlugin::getRecommendedUiSize() const {
     return CompositorHelper::VIRTUAL_SCREEN_SIZE;
 }
@@ -98,6 +102,14 @@ bool HmdDisplayPlugin::internalActivate() {
         _container->setBoolSetting("monoPreview", _monoPreview);
     }, true, _monoPreview);
 
+    auto foveatedRenderingSetting = getName() + "/foveatedRendering";
+    _foveatedRendering = _container->getBoolSetting(foveatedRenderingSetting, DEFAULT_FOVEATED_RENDERING);
+    _container->addMenuItem(PluginType::DISPLAY_PLUGIN, MENU_PATH(), FOVEATED_RENDERING,
+        [this, foveatedRenderingSetting](bool clicked) {
+        _foveatedRendering = clicked;
+        _container->setBoolSetting(foveatedRenderingSetting, clicked);
+    }, true, _foveatedRendering);
+
 #if defined(Q_OS_MAC)
     _disablePreview = true;
 #else
@@ -374,6 +386,8 @@ void HmdDisplayPlugin::updateFrameData() {
         });
     }
 
+    // The frame is executed on this thread, so sampling the pose here latches the newest tracking
+    // into the rendering instead of the one the frame was submitted with
     updatePresentPose();
 
     if (_currentFrame) {
@@ -381,6 +395,12 @@ void HmdDisplayPlugin::updateFrameData() {
         auto currentPose = _currentPresentFrameInfo.presentPose;
         auto correction = glm::inverse(batchPose) * currentPose;
         getGLBackend()->setCameraCorrection(correction);
+
+        static const float CORRECTION_AVERAGE_WEIGHT = 0.1f;
+        float correctionW = glm::clamp(fabsf(glm::quat_cast(correction).w), 0.0f, 1.0f);
+        float correctionDegrees = glm::degrees(2.0f * acosf(correctionW));
+        float averageDegrees = _presentPoseCorrection.load();
+        _presentPoseCorrection.store(averageDegrees + CORRECTION_AVERAGE_WEIGHT * (correctionDegrees - averageDegrees));
     }
 
     withPresentThreadLock([&] {
@@ -746,6 +766,12 @@ void HmdDisplayPlugin::compositeExtra() {
 HmdDisplayPlugin::~HmdDisplayPlugin() {
 }
 
+QJsonObject HmdDisplayPlugin::getHardwareStats() const {
+    QJsonObject hardwareStats = Parent::getHardwareStats();
+    hardwareStats["present_pose_correction_degrees"] = _presentPoseCorrection.load();
+    return hardwareStats;
+}
+
 float HmdDisplayPlugin::stutterRate() const {
     return _stutterRate.rate();
 }
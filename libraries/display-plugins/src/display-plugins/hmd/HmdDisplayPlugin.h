@@ -10,6 +10,7 @@
 #include <ThreadSafeValueCache.h>
 
 #include <array>
+#include <atomic>
 
 #include <QtGlobal>
 #include <Transform.h>
@@ -32,6 +33,7 @@ public:
     glm::uvec2 getRecommendedUiSize() const override final;
     glm::uvec2 getRecommendedRenderSize() const override final { return _renderTargetSize; }
     bool isDisplayVisible() const override { return isHmdMounted(); }
+    float getFoveatedRadius() const override { return _foveatedRendering ? FOVEATED_RADIUS : 0.0f; }
 
     QRect getRecommendedOverlayRect() const override final;
 
@@ -46,6 +48,9 @@ public:
 
     float stutterRate() const override;
 
+    // includes how far the head turned between the render and the present of the frames
+    QJsonObject getHardwareStats() const override;
+
     virtual bool onDisplayTextureReset() override { _clearPreviewFlag = true; return true; };
 
 protected:
@@ -112,7 +117,14 @@ protected:
     FrameInfo _currentRenderFrameInfo;
     RateCounter<> _stutterRate;
 
+    // the rotation between the render and present poses, in degrees, averaged over the recent presents
+    std::atomic<float> _presentPoseCorrection { 0.0f };
+
     bool _disablePreview { true };
+
+    // set per plugin, a mid-range GPU may need it on one headset and not the other
+    static const float FOVEATED_RADIUS;
+    std::atomic<bool> _foveatedRendering { false };
 private:
     ivec4 getViewportForSourceSize(const uvec2& size) const;
     float getLeftCenterPixel() const;
@@ -11,6 +11,8 @@
 
 #include "EntityTreeRenderer.h"
 
+#include <algorithm>
+
 #include <glm/gtx/quaternion.hpp>
 
 #include <QEventLoop>
@@ -144,9 +146,12 @@ void EntityTreeRenderer::clear() {
         qCWarning(entitiesrenderer) << "EntitityTreeRenderer::clear(), Unexpected null scene, possibly during application shutdown";
     }
     _entitiesInScene.clear();
+    _entitiesToAdd.clear();
 
     // reset the zone to the default (while we load the next scene)
     _layeredZones.clear();
+    _triggerEntities.clear();
+    _shouldFindTriggerEntities = true;
 
     OctreeProcessor::clear();
 }
@@ -156,7 +161,8 @@ void EntityTreeRenderer::reloadEntityScripts() {
     _entitiesScriptEngine->resetModuleCache();
     foreach(auto entity, _entitiesInScene) {
         if (!entity->getScript().isEmpty()) {
-            _entitiesScriptEngine->loadEntityScript(entity->getEntityItemID(), entity->getScript(), true);
+            _entitiesScriptEngine->loadEntityScript(entity->getEntityItemID(), entity->getScript(), true,
+                                                    getEntityLoadingPriority(*entity));
         }
     }
 }
@@ -207,51 +213,88 @@ void EntityTreeRenderer::update() {
             _entitiesScriptEngine->callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", _lastPointerEvent);
         }
 
+        addPendingEntitiesToScene();
+
+        quint64 now = usecTimestampNow();
+        if (now - _lastLoadingPriorityUpdate > LOADING_PRIORITY_UPDATE_INTERVAL) {
+            _lastLoadingPriorityUpdate = now;
+            updateLoadingPriorities();
+        }
     }
     deleteReleasedModels();
 }
 
+void EntityTreeRenderer::updateLoadingPriorities() {
+    // the priority of a model depends on where we are looking, so the ones still waiting on their geometry
+    // are moved in the download queue as the view changes
+    foreach(auto entity, _entitiesInScene) {
+        if (entity->getType() != EntityTypes::Model) {
+            continue;
+        }
+        auto model = std::static_pointer_cast<RenderableModelEntityItem>(entity)->getModelNotSafe();
+        if (model && !model->isLoaded()) {
+            model->setLoadingPriority(getEntityLoadingPriority(*entity));
+        }
+    }
+}
+
+void EntityTreeRenderer::findTriggerEntities() {
+    // NOTE: assumes caller has the tree read locked
+    glm::vec3 cellCorner = glm::floor(_avatarPosition / TRIGGER_CELL_SIZE) * TRIGGER_CELL_SIZE;
+    _triggerCell = AABox(cellCorner, TRIGGER_CELL_SIZE);
+    _shouldFindTriggerEntities = false;
+    _lastTriggerEntitiesSearch = usecTimestampNow();
+
+    QVector<EntityItemPointer> foundEntities;
+    std::static_pointer_cast<EntityTree>(_tree)->findEntities(_triggerCell, foundEntities);
+
+    // only consider entities that are zones or have scripts, all other entities can
+    // be ignored because they can have events fired on them.
+    // FIXME - this could be optimized further by determining if the script is loaded
+    // and if it has either an enterEntity or leaveEntity method
+    _triggerEntities.clear();
+    for (auto& entity : foundEntities) {
+        if (entity->getType() == EntityTypes::Zone || !entity->getScript().isEmpty()) {
+            _triggerEntities.push_back(entity);
+        }
+    }
+}
+
 bool EntityTreeRenderer::findBestZoneAndMaybeContainingEntities(QVector<EntityItemID>* entitiesContainingAvatar) {
     bool didUpdate = false;
-    float radius = 0.01f; // for now, assume 0.01 meter radius, because we actually check the point inside later
-    QVector<EntityItemPointer> foundEntities;
 
-    // find the entities near us
     // don't let someone else change our tree while we search
     _tree->withReadLock([&] {
-
-        // FIXME - if EntityTree had a findEntitiesContainingPoint() this could theoretically be a little faster
-        std::static_pointer_cast<EntityTree>(_tree)->findEntities(_avatarPosition, radius, foundEntities);
+        if (_shouldFindTriggerEntities || !_triggerCell.contains(_avatarPosition)) {
+            findTriggerEntities();
+        }
 
         LayeredZones oldLayeredZones(std::move(_layeredZones));
         _layeredZones.clear();
 
         // create a list of entities that actually contain the avatar's position
-        for (auto& entity : foundEntities) {
+        for (auto& triggerEntity : _triggerEntities) {
+            auto entity = triggerEntity.lock();
+            if (!entity) {
+                continue;
+            }
             auto isZone = entity->getType() == EntityTypes::Zone;
-            auto hasScript = !entity->getScript().isEmpty();
-
-            // only consider entities that are zones or have scripts, all other entities can
-            // be ignored because they can have events fired on them.
-            // FIXME - this could be optimized further by determining if the script is loaded
-            // and if it has either an enterEntity or leaveEntity method
-            if (isZone || hasScript) {
-                // now check to see if the point contains our entity, this can be expensive if
-                // the entity has a collision hull
-                if (entity->contains(_avatarPosition)) {
-                    if (entitiesContainingAvatar) {
-                        *entitiesContainingAvatar << entity->getEntityItemID();
-                    }
 
-                    // if this entity is a zone and visible, determine if it is the bestZone
-                    if (isZone && entity->getVisible()) {
-                        auto renderID = std::dynamic_pointer_cast<RenderableZoneEntityItem>(entity)->getRenderItemID();
-                        bool isValidRenderID = (renderID != render::Item::INVALID_ITEM_ID);
+            // now check to see if the point contains our entity, this can be expensive if
+            // the entity has a collision hull
+            if (entity->contains(_avatarPosition)) {
+                if (entitiesContainingAvatar) {
+                    *entitiesContainingAvatar << entity->getEntityItemID();
+                }
+
+                // if this entity is a zone and visible, determine if it is the bestZone
+                if (isZone && entity->getVisible()) {
+                    auto renderID = std::dynamic_pointer_cast<RenderableZoneEntityItem>(entity)->getRenderItemID();
+                    bool isValidRenderID = (renderID != render::Item::INVALID_ITEM_ID);
 
-                        if (isValidRenderID) {
-                            auto zone = std::dynamic_pointer_cast<ZoneEntityItem>(entity);
-                            _layeredZones.insert(zone);
-                        }
+                    if (isValidRenderID) {
+                        auto zone = std::dynamic_pointer_cast<ZoneEntityItem>(entity);
+                        _layeredZones.insert(zone);
                     }
                 }
             }
@@ -295,6 +338,11 @@ bool EntityTreeRenderer::checkEnterLeaveEntities() {
         if (movedEnough || enoughTimeElapsed) {
             _avatarPosition = avatarPosition;
             _lastZoneCheck = now;
+            // moving within the cell only tests the entities already found in it, these are looked for again
+            // every so often for the ones that were moved into it
+            if (now - _lastTriggerEntitiesSearch > TRIGGER_ENTITIES_SEARCH_INTERVAL) {
+                _shouldFindTriggerEntities = true;
+            }
             QVector<EntityItemID> entitiesContainingAvatar;
             didUpdate = findBestZoneAndMaybeContainingEntities(&entitiesContainingAvatar);
             
@@ -346,6 +394,7 @@ void EntityTreeRenderer::forceRecheckEntities() {
     // make sure our "last avatar position" is something other than our current position, 
     // so that on our next chance, we'll check for enter/leave entity events.
     _avatarPosition = _viewState->getAvatarPosition() + glm::vec3((float)TREE_SCALE);
+    _shouldFindTriggerEntities = true;
 }
 
 bool EntityTreeRenderer::applyLayeredZones() {
@@ -777,6 +826,14 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event) {
 }
 
 void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
+    if (_entitiesToAdd.remove(entityID) > 0) {
+        // it never made it to the scene, only its script was loaded
+        if (_tree && !_shuttingDown && _entitiesScriptEngine) {
+            _entitiesScriptEngine->unloadEntityScript(entityID, true);
+        }
+        return;
+    }
+
     if (!_entitiesInScene.contains(entityID)) {
         return;
     }
@@ -810,34 +867,92 @@ void EntityTreeRenderer::addingEntity(const EntityItemID& entityID) {
     forceRecheckEntities(); // reset our state to force checking our inside/outsideness of entities
     checkAndCallPreload(entityID);
     auto entity = std::static_pointer_cast<EntityTree>(_tree)->findEntityByID(entityID);
-    if (entity) {
-        addEntityToScene(entity);
+    if (!entity) {
+        return;
+    }
+
+    if (entity->getType() == EntityTypes::Zone) {
+        // the layered zones are looked up in the tree, they need their render item as soon as they are found there
+        auto scene = _viewState->getMain3DScene();
+        if (!scene) {
+            qCWarning(entitiesrenderer) << "EntityTreeRenderer::addingEntity(), Unexpected null scene, possibly during application shutdown";
+            return;
+        }
+        render::Transaction transaction;
+        addEntityToScene(entity, scene, transaction);
+        scene->enqueueTransaction(transaction);
+    } else {
+        _entitiesToAdd.insert(entityID, entity);
     }
 }
 
-void EntityTreeRenderer::addEntityToScene(const EntityItemPointer& entity) {
-    // here's where we add the entity payload to the scene
+void EntityTreeRenderer::addPendingEntitiesToScene() {
+    if (_entitiesToAdd.isEmpty()) {
+        return;
+    }
+
+    // here's where we add the entity payloads to the scene
     auto scene = _viewState->getMain3DScene();
     if (!scene) {
-        qCWarning(entitiesrenderer) << "EntityTreeRenderer::addEntityToScene(), Unexpected null scene, possibly during application shutdown";
+        qCWarning(entitiesrenderer) << "EntityTreeRenderer::addPendingEntitiesToScene(), Unexpected null scene, possibly during application shutdown";
         return;
     }
 
+    PerformanceTimer perfTimer("addPendingEntitiesToScene");
+
+    using PriorityEntity = std::pair<float, EntityItemPointer>;
+    std::vector<PriorityEntity> sortedEntities;
+    sortedEntities.reserve(_entitiesToAdd.size());
+    for (auto it = _entitiesToAdd.cbegin(); it != _entitiesToAdd.cend(); ++it) {
+        auto entity = it.value().lock();
+        if (entity) {
+            sortedEntities.emplace_back(getEntityLoadingPriority(*entity), entity);
+        }
+    }
+    std::sort(sortedEntities.begin(), sortedEntities.end(), [](const PriorityEntity& a, const PriorityEntity& b) {
+        return a.first > b.first;
+    });
+
+    // all of this frame's entities go to the scene in one transaction, at least one is added however long it takes
+    render::Transaction transaction;
+    quint64 start = usecTimestampNow();
+    size_t numAdded = 0;
+    while (numAdded < sortedEntities.size()) {
+        addEntityToScene(sortedEntities[numAdded].second, scene, transaction);
+        ++numAdded;
+        if (usecTimestampNow() - start > MAX_ADD_TO_SCENE_USECS_PER_FRAME) {
+            break;
+        }
+    }
+    scene->enqueueTransaction(transaction);
+
+    if (numAdded == sortedEntities.size()) {
+        // the ones that went away without us hearing about it yet go too
+        _entitiesToAdd.clear();
+    } else {
+        for (size_t i = 0; i < numAdded; ++i) {
+            _entitiesToAdd.remove(sortedEntities[i].second->getEntityItemID());
+        }
+    }
+}
+
+void EntityTreeRenderer::addEntityToScene(const EntityItemPointer& entity, const render::ScenePointer& scene,
+                                          render::Transaction& transaction) {
     auto renderable = entity->getRenderableInterface();
     if (!renderable) {
         qCWarning(entitiesrenderer) << "EntityTreeRenderer::addEntityToScene(), Unexpected non-renderable entity";
         return;
     }
 
-    render::Transaction transaction;
     if (renderable->addToScene(entity, scene, transaction)) {
         _entitiesInScene.insert(entity->getEntityItemID(), entity);
     }
-    scene->enqueueTransaction(transaction);
 }
 
 
 void EntityTreeRenderer::entityScriptChanging(const EntityItemID& entityID, bool reload) {
+    // an entity that gets or loses a script around us starts or stops being one we can enter
+    _shouldFindTriggerEntities = true;
     checkAndCallPreload(entityID, reload, true);
 }
 
@@ -855,7 +970,8 @@ void EntityTreeRenderer::checkAndCallPreload(const EntityItemID& entityID, bool
         }
         if (shouldLoad) {
             scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
-            _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload);
+            // the nearer and bigger ones are preloaded first
+            _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload, getEntityLoadingPriority(*entity));
             entity->scriptHasPreloaded();
         }
     }
@@ -963,7 +1079,8 @@ void EntityTreeRenderer::updateEntityRenderStatus(bool shouldRenderEntities) {
         }
         _entityIDsLastInScene.clear();
     } else {
-        _entityIDsLastInScene = _entitiesInScene.keys();
+        // the ones still waiting to be put in the scene are taken out of the queue, and come back with the others
+        _entityIDsLastInScene = _entitiesInScene.keys() + _entitiesToAdd.keys();
         for (auto entityID : _entityIDsLastInScene) {
             // FIXME - is this really right? do we want to do the deletingEntity() code or just remove from the scene.
             deletingEntity(entityID);
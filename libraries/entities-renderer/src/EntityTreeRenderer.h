@@ -142,8 +142,11 @@ protected:
 private:
     void resetEntitiesScriptEngine();
 
-    void addEntityToScene(const EntityItemPointer& entity);
+    void addEntityToScene(const EntityItemPointer& entity, const render::ScenePointer& scene,
+                          render::Transaction& transaction);
+    void addPendingEntitiesToScene();
     bool findBestZoneAndMaybeContainingEntities(QVector<EntityItemID>* entitiesContainingAvatar = nullptr);
+    void findTriggerEntities();
 
     bool applyLayeredZones();
 
@@ -166,6 +169,12 @@ private:
     glm::vec3 _avatarPosition { 0.0f };
     QVector<EntityItemID> _currentEntitiesInside;
 
+    // the zones and scripted entities touching the cell of the grid the avatar is in, which are the only ones it can
+    // be inside of, looked for again in the tree once it leaves the cell or they may have changed
+    std::vector<EntityItemWeakPointer> _triggerEntities;
+    AABox _triggerCell;
+    bool _shouldFindTriggerEntities { true };
+
     bool _wantScripts;
     QSharedPointer<ScriptEngine> _entitiesScriptEngine;
 
@@ -237,8 +246,19 @@ private:
     quint64 _lastZoneCheck { 0 };
     const quint64 ZONE_CHECK_INTERVAL = USECS_PER_MSEC * 100; // ~10hz
     const float ZONE_CHECK_DISTANCE = 0.001f;
+    const float TRIGGER_CELL_SIZE = 4.0f; // meters
+    quint64 _lastTriggerEntitiesSearch { 0 };
+    const quint64 TRIGGER_ENTITIES_SEARCH_INTERVAL = USECS_PER_SECOND; // for the ones moved into the cell
+
+    void updateLoadingPriorities();
+
+    quint64 _lastLoadingPriorityUpdate { 0 };
+    const quint64 LOADING_PRIORITY_UPDATE_INTERVAL = USECS_PER_MSEC * 250; // ~4hz
 
     QHash<EntityItemID, EntityItemPointer> _entitiesInScene;
+    // added entities wait here to be put in the scene, the ones with the highest loading priority first, a few each frame
+    QHash<EntityItemID, EntityItemWeakPointer> _entitiesToAdd;
+    const quint64 MAX_ADD_TO_SCENE_USECS_PER_FRAME = USECS_PER_MSEC * 2;
     // For Scene.shouldRenderEntities
     QList<EntityItemID> _entityIDsLastInScene;
 
@@ -18,6 +18,7 @@
 #include <glm/gtx/transform.hpp>
 
 #include <AbstractViewStateInterface.h>
+#include <AssetUtils.h>
 #include <CollisionRenderMeshCache.h>
 #include <Model.h>
 #include <PerfStat.h>
@@ -387,6 +388,14 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
         }
     }
 
+    updateModelProxy(args);
+    if (_model && _model->didVisualGeometryRequestFail() && isModelProxyUrl(_model->getURL())) {
+        // the asset server has no proxy of this model, it is small enough not to need one or hasn't made it yet
+        _modelProxyFailedURL = getModelURL();
+        _usingModelProxy = false;
+        getModel();
+    }
+
     if (!hasModel() || (_model && _model->didVisualGeometryRequestFail())) {
         static glm::vec4 greenColor(0.0f, 1.0f, 0.0f, 1.0f);
         gpu::Batch& batch = *args->_batch;
@@ -493,14 +502,50 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
             scene->enqueueTransaction(transaction);
         }
 
-        auto& currentURL = getParsedModelURL();
-        if (currentURL != _model->getURL()) {
+        if (QUrl(getRenderedModelURL()) != _model->getURL()) {
             // Defer setting the url to the render thread
             getModel();
         }
     }
 }
 
+bool RenderableModelEntityItem::canUseModelProxy() const {
+    // the proxy has no joints to animate, nor the triangles a shape made from the model needs
+    ShapeType type = getShapeType();
+    bool shapeUsesModel = type >= SHAPE_TYPE_SIMPLE_HULL && type <= SHAPE_TYPE_STATIC_MESH;
+    if (!_dimensionsInitialized || hasAnimation() || shapeUsesModel || getModelURL() == _modelProxyFailedURL) {
+        return false;
+    }
+
+    // only models mapped to a path have a proxy, it is asked for by the path
+    const QUrl& url = getParsedModelURL();
+    return url.scheme() == URL_SCHEME_ATP && url.path().startsWith("/") && isProxyableModelPath(url.path());
+}
+
+void RenderableModelEntityItem::updateModelProxy(RenderArgs* args) {
+    // models that are smaller than this in view, in radians across, are drawn with their proxy
+    static const float MAX_MODEL_PROXY_ANGULAR_SIZE = 0.02f;
+    // and switch to it once they are this much smaller, so that one at the limit does not flip back and forth
+    static const float MODEL_PROXY_HYSTERESIS = 0.75f;
+
+    if (args->_renderMode != RenderArgs::DEFAULT_RENDER_MODE) {
+        return; // the shadow and mirror views don't decide what is loaded
+    }
+    if (!canUseModelProxy()) {
+        _usingModelProxy = false;
+        return;
+    }
+
+    float distance = glm::distance(args->getViewFrustum().getPosition(), getPosition());
+    float angularSize = glm::length(getDimensions()) / std::max(distance, EPSILON);
+    float limit = _usingModelProxy ? MAX_MODEL_PROXY_ANGULAR_SIZE : MODEL_PROXY_HYSTERESIS * MAX_MODEL_PROXY_ANGULAR_SIZE;
+    _usingModelProxy = angularSize < limit;
+}
+
+QString RenderableModelEntityItem::getRenderedModelURL() const {
+    return _usingModelProxy ? getModelProxyUrl(getParsedModelURL()).toString() : getModelURL();
+}
+
 ModelPointer RenderableModelEntityItem::getModelNotSafe() {
     return _model;
 }
@@ -521,13 +566,13 @@ ModelPointer RenderableModelEntityItem::getModel() {
     if (!getModelURL().isEmpty()) {
         // If we don't have a model, allocate one *immediately*
         if (!_model) {
-            _model = _myRenderer->allocateModel(getModelURL(), _myRenderer->getEntityLoadingPriority(*this), this);
+            _model = _myRenderer->allocateModel(getRenderedModelURL(), _myRenderer->getEntityLoadingPriority(*this), this);
             _needsInitialSimulation = true;
         // If we need to change URLs, update it *after rendering* (to avoid access violations)
-        } else if (QUrl(getModelURL()) != _model->getURL()) {
+        } else if (QUrl(getRenderedModelURL()) != _model->getURL()) {
             QMetaObject::invokeMethod(_myRenderer.data(), "updateModel", Qt::QueuedConnection,
                 Q_ARG(ModelPointer, _model),
-                Q_ARG(const QString&, getModelURL()));
+                Q_ARG(const QString&, getRenderedModelURL()));
             _needsInitialSimulation = true;
         }
         // Else we can just return the _model
@@ -122,6 +122,11 @@ private:
     QVariantMap parseTexturesToMap(QString textures);
     void remapTextures();
 
+    // far enough away, models the asset server has a proxy of are drawn with that instead
+    bool canUseModelProxy() const;
+    void updateModelProxy(RenderArgs* args);
+    QString getRenderedModelURL() const;
+
     void getCollisionGeometryResource();
     GeometryResource::Pointer _compoundShapeResource;
     ModelPointer _model = nullptr;
@@ -133,6 +138,8 @@ private:
     QVariantMap _originalTextures;
     bool _originalTexturesRead = false;
     bool _dimensionsInitialized = true;
+    bool _usingModelProxy { false };
+    QString _modelProxyFailedURL; // the model URL the asset server had no proxy for
 
     AnimationPropertyGroup _renderAnimationProperties;
 
@@ -49,13 +49,18 @@ public:
         InterpolationData<float> radius;
         InterpolationData<glm::vec4> color; // rgba
         float lifespan;
-        glm::vec3 spare;
+        float time; // secs since the epoch of the particle buffer
+        glm::vec2 spare;
     };
     
+    // a particle as it was emitted, the vertex shader moves it
     struct ParticlePrimitive {
-        ParticlePrimitive(glm::vec3 xyzIn, glm::vec2 uvIn) : xyz(xyzIn), uv(uvIn) {}
-        glm::vec3 xyz; // Position
-        glm::vec2 uv; // Lifetime + seed
+        glm::vec3 position;
+        float birth; // secs since the epoch of the particle buffer
+        glm::vec3 velocity;
+        float seed;
+        glm::vec3 acceleration;
+        float spare;
     };
     
     using Payload = render::Payload<ParticlePayloadData>;
@@ -73,10 +78,12 @@ public:
         ParticleUniforms uniforms;
         _uniformBuffer = std::make_shared<Buffer>(sizeof(ParticleUniforms), (const gpu::Byte*) &uniforms);
         
-        _vertexFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element::VEC3F_XYZ,
-                                    offsetof(ParticlePrimitive, xyz), gpu::Stream::PER_INSTANCE);
-        _vertexFormat->setAttribute(gpu::Stream::COLOR, 0, gpu::Element::VEC2F_UV,
-                                    offsetof(ParticlePrimitive, uv), gpu::Stream::PER_INSTANCE);
+        _vertexFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element::VEC4F_XYZW,
+                                    offsetof(ParticlePrimitive, position), gpu::Stream::PER_INSTANCE);
+        _vertexFormat->setAttribute(gpu::Stream::NORMAL, 0, gpu::Element::VEC4F_XYZW,
+                                    offsetof(ParticlePrimitive, velocity), gpu::Stream::PER_INSTANCE);
+        _vertexFormat->setAttribute(gpu::Stream::COLOR, 0, gpu::Element::VEC4F_XYZW,
+                                    offsetof(ParticlePrimitive, acceleration), gpu::Stream::PER_INSTANCE);
     }
 
     const Transform& getModelTransform() const { return _modelTransform; }
@@ -88,6 +95,14 @@ public:
     BufferPointer getParticleBuffer() { return _particleBuffer; }
     const BufferPointer& getParticleBuffer() const { return _particleBuffer; }
     
+    // the particles alive are numParticles slots of the ring, from firstParticle
+    void setParticleRange(uint32_t firstParticle, uint32_t numParticles, uint32_t capacity) {
+        _firstParticle = firstParticle;
+        _numParticles = numParticles;
+        _capacity = capacity;
+    }
+    uint32_t getCapacity() const { return _capacity; }
+
     const ParticleUniforms& getParticleUniforms() const { return _uniformBuffer.get<ParticleUniforms>(); }
     ParticleUniforms& editParticleUniforms() { return _uniformBuffer.edit<ParticleUniforms>(); }
 
@@ -110,10 +125,18 @@ public:
         batch.setModelTransform(_modelTransform);
         batch.setUniformBuffer(0, _uniformBuffer);
         batch.setInputFormat(_vertexFormat);
-        batch.setInputBuffer(0, _particleBuffer, 0, sizeof(ParticlePrimitive));
 
-        auto numParticles = _particleBuffer->getSize() / sizeof(ParticlePrimitive);
-        batch.drawInstanced((gpu::uint32)numParticles, gpu::TRIANGLE_STRIP, (gpu::uint32)VERTEX_PER_PARTICLE);
+        // up to the end of the ring, then from its start
+        uint32_t numFirst = std::min(_numParticles, _capacity - _firstParticle);
+        if (numFirst > 0) {
+            batch.setInputBuffer(0, _particleBuffer, _firstParticle * sizeof(ParticlePrimitive), sizeof(ParticlePrimitive));
+            batch.drawInstanced((gpu::uint32)numFirst, gpu::TRIANGLE_STRIP, (gpu::uint32)VERTEX_PER_PARTICLE);
+        }
+        if (_numParticles > numFirst) {
+            batch.setInputBuffer(0, _particleBuffer, 0, sizeof(ParticlePrimitive));
+            batch.drawInstanced((gpu::uint32)(_numParticles - numFirst), gpu::TRIANGLE_STRIP,
+                                (gpu::uint32)VERTEX_PER_PARTICLE);
+        }
     }
 
 protected:
@@ -121,6 +144,9 @@ protected:
     AABox _bound;
     FormatPointer _vertexFormat { std::make_shared<Format>() };
     BufferPointer _particleBuffer { std::make_shared<Buffer>() };
+    uint32_t _firstParticle { 0 };
+    uint32_t _numParticles { 0 };
+    uint32_t _capacity { 0 };
     BufferView _uniformBuffer;
     TexturePointer _texture;
     bool _visibleFlag = true;
@@ -203,6 +229,8 @@ bool RenderableParticleEffectEntityItem::addToScene(const EntityItemPointer& sel
     makeEntityItemStatusGetters(getThisPointer(), statusGetters);
     renderPayload->addStatusGetters(statusGetters);
     transaction.resetItem(_renderItemId, renderPayload);
+    // its particle buffer is empty
+    _particleCapacity = 0;
     return true;
 }
 
@@ -261,13 +289,6 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
     particleUniforms.color.finish = glm::vec4(getColorFinishRGB(), getAlphaFinish());
     particleUniforms.color.spread = glm::vec4(getColorSpreadRGB(), getAlphaSpread());
     particleUniforms.lifespan = getLifespan();
-    
-    // Build particle primitives
-    auto particlePrimitives = std::make_shared<ParticlePrimitives>();
-    particlePrimitives->reserve(_particles.size()); // Reserve space
-    for (auto& particle : _particles) {
-        particlePrimitives->emplace_back(particle.position, glm::vec2(particle.lifetime, particle.seed));
-    }
 
     bool successb, successp, successr;
     auto bounds = getAABox(successb);
@@ -283,6 +304,40 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
         transform.setRotation(rotation);
     }
 
+    // The particles are written once, to the slot of their emission number in a ring that holds at least as many
+    // as are alive. Their times are seconds since an epoch that moves on before floats lose precision.
+    const quint64 EPOCH_USECS = 1000 * USECS_PER_SECOND;
+    quint64 now = _lastSimulated;
+    uint32_t numAlive = (uint32_t)_particles.size();
+    bool rewrite = false;
+    if (numAlive > _particleCapacity) {
+        _particleCapacity = std::min(std::max(numAlive, 2 * _particleCapacity), _maxParticles);
+        rewrite = true;
+    }
+    if (now - _particleEpoch > EPOCH_USECS) {
+        _particleEpoch = now;
+        rewrite = true;
+    }
+    uint32_t capacity = std::max(_particleCapacity, 1u);
+    particleUniforms.time = (float)(((double)now - (double)_particleEpoch) / USECS_PER_SECOND);
+
+    uint32_t numNew = rewrite ? numAlive : (uint32_t)std::min((quint64)numAlive, _particlesEmitted - _particlesWritten);
+    auto newParticles = std::make_shared<ParticlePrimitives>();
+    newParticles->reserve(numNew);
+    for (uint32_t i = numAlive - numNew; i < numAlive; ++i) {
+        const auto& particle = _particles[i];
+        ParticlePrimitive primitive;
+        primitive.position = particle.position;
+        primitive.birth = (float)(((double)particle.birthTime - (double)_particleEpoch) / USECS_PER_SECOND);
+        primitive.velocity = particle.velocity;
+        primitive.seed = particle.seed;
+        primitive.acceleration = particle.acceleration;
+        primitive.spare = 0.0f;
+        newParticles->push_back(primitive);
+    }
+    uint32_t firstNew = (uint32_t)((_particlesEmitted - numNew) % capacity);
+    uint32_t firstAlive = (uint32_t)((_particlesEmitted - numAlive) % capacity);
+    _particlesWritten = _particlesEmitted;
 
     render::Transaction transaction;
     transaction.updateItem<ParticlePayloadData>(_renderItemId, [=](ParticlePayloadData& payload) {
@@ -291,14 +346,21 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
         // Update particle uniforms
         memcpy(&payload.editParticleUniforms(), &particleUniforms, sizeof(ParticleUniforms));
         
-        // Update particle buffer
+        // Write the new particles, wrapping around the end of the ring
         auto particleBuffer = payload.getParticleBuffer();
-        size_t numBytes = sizeof(ParticlePrimitive) * particlePrimitives->size();
-        particleBuffer->resize(numBytes);
-        if (numBytes == 0) {
-            return;
+        if (payload.getCapacity() != capacity) {
+            particleBuffer->resize(sizeof(ParticlePrimitive) * capacity);
+        }
+        uint32_t numFirst = std::min((uint32_t)newParticles->size(), capacity - firstNew);
+        if (numFirst > 0) {
+            particleBuffer->setSubData(sizeof(ParticlePrimitive) * firstNew, sizeof(ParticlePrimitive) * numFirst,
+                                       (const gpu::Byte*)newParticles->data());
+        }
+        if (newParticles->size() > numFirst) {
+            particleBuffer->setSubData(0, sizeof(ParticlePrimitive) * (newParticles->size() - numFirst),
+                                       (const gpu::Byte*)(newParticles->data() + numFirst));
         }
-        particleBuffer->setData(numBytes, (const gpu::Byte*)particlePrimitives->data());
+        payload.setParticleRange(firstAlive, numAlive, capacity);
 
         // Update transform and bounds
         payload.setModelTransform(transform);
@@ -41,6 +41,11 @@ protected:
     
     NetworkTexturePointer _texture;
 
+    // the ring of particles of the render item
+    uint32_t _particleCapacity { 0 };
+    quint64 _particleEpoch { 0 };
+    quint64 _particlesWritten { 0 };
+
 };
 
 
@@ -60,13 +60,14 @@
 #include "PhysicalEntitySimulation.h"
 
 const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
+const int POLYVOX_CHUNK_SIZE = 16;
 
 /*
   A PolyVoxEntity has several interdependent parts:
 
   _voxelData -- compressed QByteArray representation of which voxels have which values
   _volData -- datastructure from the PolyVox library which holds which voxels have which values
-  _mesh -- renderable representation of the voxels
+  _chunks -- renderable representation of the voxels, and the convex hulls of the collision shape
   _shape -- used for bullet collisions
 
   Each one depends on the one before it, except that _voxelData is set from _volData if a script edits the voxels.
@@ -79,9 +80,13 @@ const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
 
   In RenderablePolyVoxEntityItem::render, these flags are checked and changes are propagated along the chain.
   decompressVolumeData() is called to decompress _voxelData into _volData.  recomputeMesh() is called to invoke the
-  polyVox surface extractor to create _mesh (as well as set Simulation _dirtyFlags).  Because Simulation::DIRTY_SHAPE
-  is set, isReadyToComputeShape() gets called and _shape is created either from _volData or _shape, depending on
-  the surface style.
+  polyVox surface extractor to create _chunks (as well as set Simulation _dirtyFlags).  Because Simulation::DIRTY_SHAPE
+  is set, isReadyToComputeShape() gets called and _shape is created from the convex hulls of the chunks.
+
+  The volume is split into chunks of POLYVOX_CHUNK_SIZE voxels on a side.  Changing a voxel marks the chunks whose
+  surface or convex hulls can depend on it in _dirtyChunks, and recomputeMesh() only runs the surface extractor on
+  those.  The convex hulls of a chunk are made from _volData for cubic extractors and from its mesh for marching-cube
+  extractors.  Only one recomputeMesh() runs at a time, edits made meanwhile are picked up by the next one.
 
   When a script changes _volData, compressVolumeDataAndSendEditPacket is called to update _voxelData and to
   send a packet to the entity-server.
@@ -121,7 +126,6 @@ EntityItemPointer RenderablePolyVoxEntityItem::factory(const EntityItemID& entit
 
 RenderablePolyVoxEntityItem::RenderablePolyVoxEntityItem(const EntityItemID& entityItemID) :
     PolyVoxEntityItem(entityItemID),
-    _mesh(new model::Mesh()),
     _meshDirty(true),
     _xTexture(nullptr),
     _yTexture(nullptr),
@@ -189,6 +193,7 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
             _volDataDirty = true;
             _voxelSurfaceStyle = voxelSurfaceStyle;
         }
+        _allChunksDirty = true;
     });
 
     if (volSizeChanged) {
@@ -645,7 +650,7 @@ bool RenderablePolyVoxEntityItem::isReadyToComputeShape() {
     // we determine if we are ready to compute the physics shape by actually doing so.
     // if _voxelDataDirty or _volDataDirty is set, don't do this yet -- wait for their
     // threads to finish before creating the collision shape.
-    if (_meshDirty && !_voxelDataDirty && !_volDataDirty) {
+    if (_meshDirty && !_voxelDataDirty && !_volDataDirty && !_meshJobRunning) {
         _meshDirty = false;
         computeShapeInfoWorker();
         return false;
@@ -691,20 +696,25 @@ void RenderablePolyVoxEntityItem::setZTextureURL(const QString& zTextureURL) {
 bool RenderablePolyVoxEntityItem::updateDependents() {
     bool voxelDataDirty;
     bool volDataDirty;
+    bool meshJobRunning;
     withWriteLock([&] {
         voxelDataDirty = _voxelDataDirty;
         volDataDirty = _volDataDirty;
+        meshJobRunning = _meshJobRunning;
         if (_voxelDataDirty) {
             _voxelDataDirty = false;
         } else if (_volDataDirty) {
-            _volDataDirty = false;
+            // leave it dirty until the chunks being extracted are in, the edits made meanwhile go in the next ones
+            if (!_meshJobRunning) {
+                _volDataDirty = false;
+            }
         } else {
             _meshReady = true;
         }
     });
     if (voxelDataDirty) {
         decompressVolumeData();
-    } else if (volDataDirty) {
+    } else if (volDataDirty && !meshJobRunning) {
         recomputeMesh();
     }
 
@@ -721,15 +731,18 @@ void RenderablePolyVoxEntityItem::render(RenderArgs* args) {
         updateDependents();
     }
 
-    model::MeshPointer mesh;
+    std::vector<model::MeshPointer> meshes;
     glm::vec3 voxelVolumeSize;
     withReadLock([&] {
-        mesh = _mesh;
+        for (const auto& chunk : _chunks) {
+            if (chunk.mesh && chunk.mesh->getIndexBuffer()._buffer) {
+                meshes.push_back(chunk.mesh);
+            }
+        }
         voxelVolumeSize = _voxelVolumeSize;
     });
 
-    if (!mesh ||
-        !mesh->getIndexBuffer()._buffer) {
+    if (meshes.empty()) {
         return;
     }
 
@@ -745,17 +758,6 @@ void RenderablePolyVoxEntityItem::render(RenderArgs* args) {
     Transform transform(voxelToWorldMatrix());
     batch.setModelTransform(transform);
     batch.setInputFormat(_vertexFormat);
-    batch.setInputBuffer(gpu::Stream::POSITION, mesh->getVertexBuffer()._buffer,
-                         0,
-                         sizeof(PolyVox::PositionMaterialNormal));
-
-    // TODO -- should we be setting this?
-    // batch.setInputBuffer(gpu::Stream::NORMAL, mesh->getVertexBuffer()._buffer,
-    //                      12,
-    //                      sizeof(PolyVox::PositionMaterialNormal));
-
-
-    batch.setIndexBuffer(gpu::UINT32, mesh->getIndexBuffer()._buffer, 0);
 
     if (!_xTextureURL.isEmpty() && !_xTexture) {
         _xTexture = DependencyManager::get<TextureCache>()->getTexture(_xTextureURL);
@@ -786,7 +788,21 @@ void RenderablePolyVoxEntityItem::render(RenderArgs* args) {
     int voxelVolumeSizeLocation = args->_shapePipeline->pipeline->getProgram()->getUniforms().findLocation("voxelVolumeSize");
     batch._glUniform3f(voxelVolumeSizeLocation, voxelVolumeSize.x, voxelVolumeSize.y, voxelVolumeSize.z);
 
-    batch.drawIndexed(gpu::TRIANGLES, (gpu::uint32)mesh->getNumIndices(), 0);
+    // each chunk keeps its buffers until it is extracted again
+    for (const auto& mesh : meshes) {
+        batch.setInputBuffer(gpu::Stream::POSITION, mesh->getVertexBuffer()._buffer,
+                             0,
+                             sizeof(PolyVox::PositionMaterialNormal));
+
+        // TODO -- should we be setting this?
+        // batch.setInputBuffer(gpu::Stream::NORMAL, mesh->getVertexBuffer()._buffer,
+        //                      12,
+        //                      sizeof(PolyVox::PositionMaterialNormal));
+
+
+        batch.setIndexBuffer(gpu::UINT32, mesh->getIndexBuffer()._buffer, 0);
+        batch.drawIndexed(gpu::TRIANGLES, (gpu::uint32)mesh->getNumIndices(), 0);
+    }
 }
 
 bool RenderablePolyVoxEntityItem::addToScene(const EntityItemPointer& self,
@@ -924,6 +940,7 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(glm::vec3 voxelVolumeSize)
         }
 
         _voxelDataDirty = true;
+        _allChunksDirty = true;
         _voxelVolumeSize = voxelVolumeSize;
 
         if (_volData) {
@@ -1009,12 +1026,19 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(int x, int y, int z, uint8_t
         return result;
     }
 
+    uint8_t fromValue = getVoxelInternal(x, y, z);
     result = updateOnCount(x, y, z, toValue);
 
     if (isEdged(_voxelSurfaceStyle)) {
         _volData->setVoxelAt(x + 1, y + 1, z + 1, toValue);
+        if (fromValue != toValue) {
+            markChunksDirty(x + 1, y + 1, z + 1);
+        }
     } else {
         _volData->setVoxelAt(x, y, z, toValue);
+        if (fromValue != toValue) {
+            markChunksDirty(x, y, z);
+        }
     }
 
     if (x == 0 || y == 0 || z == 0) {
@@ -1027,6 +1051,26 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(int x, int y, int z, uint8_t
 }
 
 
+void RenderablePolyVoxEntityItem::markChunksDirty(int x, int y, int z) {
+    // x, y, z are in polyvox volume coords.  The surface of a chunk is extracted from its voxels and those on its
+    // upper faces, and a cubic convex hull depends on the neighbors of its voxel, so the chunks of the voxels
+    // on either side are marked as well.  This assumes that the caller has write-locked the entity.
+    if (_allChunksDirty) {
+        return;
+    }
+    PolyVox::Vector3DInt32 lowCorner = _volData->getEnclosingRegion().getLowerCorner();
+    glm::ivec3 voxel = glm::ivec3(x, y, z) - glm::ivec3(lowCorner.getX(), lowCorner.getY(), lowCorner.getZ());
+    glm::ivec3 lowChunk = glm::clamp((voxel - 1) / POLYVOX_CHUNK_SIZE, glm::ivec3(0), _numChunks - 1);
+    glm::ivec3 highChunk = glm::clamp((voxel + 1) / POLYVOX_CHUNK_SIZE, glm::ivec3(0), _numChunks - 1);
+    for (int k = lowChunk.z; k <= highChunk.z; k++) {
+        for (int j = lowChunk.y; j <= highChunk.y; j++) {
+            for (int i = lowChunk.x; i <= highChunk.x; i++) {
+                _dirtyChunks.insert((k * _numChunks.y + j) * _numChunks.x + i);
+            }
+        }
+    }
+}
+
 bool RenderablePolyVoxEntityItem::updateOnCount(int x, int y, int z, uint8_t toValue) {
     // keep _onCount up to date
     if (!inUserBounds(_volData, _voxelSurfaceStyle, x, y, z)) {
@@ -1225,6 +1269,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int y = 0; y < _volData->getHeight(); y++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentXPNeighbor->getVoxel(0, y, z);
+                    if (_volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
+                        markChunksDirty(_volData->getWidth() - 1, y, z);
+                    }
                     if ((y == 0 || z == 0) && _volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
                         bonkNeighbors();
                     }
@@ -1240,6 +1287,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentYPNeighbor->getVoxel(x, 0, z);
+                    if (_volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
+                        markChunksDirty(x, _volData->getHeight() - 1, z);
+                    }
                     if ((x == 0 || z == 0) && _volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
                         bonkNeighbors();
                     }
@@ -1255,6 +1305,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int y = 0; y < _volData->getHeight(); y++) {
                     uint8_t neighborValue = currentZPNeighbor->getVoxel(x, y, 0);
+                    if (_volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
+                        markChunksDirty(x, y, _volData->getDepth() - 1);
+                    }
                     _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
                     if ((x == 0 || y == 0) && _volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
                         bonkNeighbors();
@@ -1266,8 +1319,153 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
     }
 }
 
+static model::MeshPointer buildPolyVoxMesh(const std::vector<PolyVox::PositionMaterialNormal>& vecVertices,
+                                           const std::vector<uint32_t>& vecIndices) {
+    // convert PolyVox mesh to a Sam mesh
+    model::MeshPointer mesh(new model::Mesh());
+
+    auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
+                                                     (gpu::Byte*)vecIndices.data());
+    auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
+    gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
+    mesh->setIndexBuffer(indexBufferView);
+
+    auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
+                                                      (gpu::Byte*)vecVertices.data());
+    auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
+    gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
+                                     vertexBufferPtr->getSize(),
+                                     sizeof(PolyVox::PositionMaterialNormal),
+                                     gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+    mesh->setVertexBuffer(vertexBufferView);
+
+
+    // TODO -- use 3-byte normals rather than 3-float normals
+    mesh->addAttribute(gpu::Stream::NORMAL,
+                       gpu::BufferView(vertexBufferPtr,
+                                       sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
+                                       vertexBufferPtr->getSize(),
+                                       sizeof(PolyVox::PositionMaterialNormal),
+                                       gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+
+    std::vector<model::Mesh::Part> parts;
+    parts.emplace_back(model::Mesh::Part((model::Index)0, // startIndex
+                                         (model::Index)vecIndices.size(), // numIndices
+                                         (model::Index)0, // baseVertex
+                                         model::Mesh::TRIANGLES)); // topology
+    mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(model::Mesh::Part),
+                                                        (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
+    return mesh;
+}
+
+static glm::vec3 toGlm(const PolyVox::Vector3DFloat& vector) {
+    return glm::vec3(vector.getX(), vector.getY(), vector.getZ());
+}
+
+static RenderablePolyVoxEntityItem::Chunk extractChunk(RenderablePolyVoxEntityItem* entity,
+                                                       PolyVoxEntityItem::PolyVoxSurfaceStyle voxelSurfaceStyle,
+                                                       glm::ivec3 voxelVolumeSize, const PolyVox::Region& region,
+                                                       const PolyVox::Region& voxels) {
+    // region is the part of the volume the surface of the chunk is extracted from, voxels are the ones that
+    // belong to the chunk.  This assumes that the caller has read-locked the entity.
+    RenderablePolyVoxEntityItem::Chunk chunk;
+    PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
+
+    // A mesh object to hold the result of surface extraction
+    PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+
+    switch (voxelSurfaceStyle) {
+        case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES:
+        case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
+            PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (volData, region, &polyVoxMesh);
+            surfaceExtractor.execute();
+            break;
+        }
+        case PolyVoxEntityItem::SURFACE_EDGED_CUBIC:
+        case PolyVoxEntityItem::SURFACE_CUBIC: {
+            PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                (volData, region, &polyVoxMesh);
+            surfaceExtractor.execute();
+            break;
+        }
+    }
+
+    // the extracted vertices are relative to the lower corner of the region, move them into voxel-space
+    PolyVox::Vector3DInt32 lowCorner = region.getLowerCorner();
+    PolyVox::Vector3DFloat offset((float)lowCorner.getX(), (float)lowCorner.getY(), (float)lowCorner.getZ());
+    std::vector<PolyVox::PositionMaterialNormal> vecVertices = polyVoxMesh.getRawVertexData();
+    for (auto& vertex : vecVertices) {
+        vertex.setPosition(vertex.getPosition() + offset);
+    }
+    const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
+    if (!vecIndices.empty()) {
+        chunk.mesh = buildPolyVoxMesh(vecVertices, vecIndices);
+    }
+
+    if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
+        voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
+        // pull each triangle in the mesh into a polyhedron which can be collided with
+        for (size_t i = 0; i + 2 < vecIndices.size(); i += 3) {
+            glm::vec3 p0 = toGlm(vecVertices[vecIndices[i]].getPosition());
+            glm::vec3 p1 = toGlm(vecVertices[vecIndices[i + 1]].getPosition());
+            glm::vec3 p2 = toGlm(vecVertices[vecIndices[i + 2]].getPosition());
+
+            glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
+            glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+            glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
+
+            // add next convex hull
+            QVector<glm::vec3> pointsInPart;
+            pointsInPart << p0 << p1 << p2 << p3;
+            chunk.collisionPoints << pointsInPart;
+        }
+        return chunk;
+    }
+
+    // x, y, z are in user voxel-coords, the voxels of the chunk are in polyvox volume coords
+    int edge = isEdged(voxelSurfaceStyle) ? 1 : 0;
+    float offL = -0.5f + edge;
+    float offH = 0.5f + edge;
+    PolyVox::Vector3DInt32 firstVoxel = voxels.getLowerCorner();
+    PolyVox::Vector3DInt32 lastVoxel = voxels.getUpperCorner();
+    for (int z = firstVoxel.getZ() - edge; z <= lastVoxel.getZ() - edge; z++) {
+        for (int y = firstVoxel.getY() - edge; y <= lastVoxel.getY() - edge; y++) {
+            for (int x = firstVoxel.getX() - edge; x <= lastVoxel.getX() - edge; x++) {
+                if (x < 0 || y < 0 || z < 0 || x >= voxelVolumeSize.x || y >= voxelVolumeSize.y || z >= voxelVolumeSize.z ||
+                    entity->getVoxelInternal(x, y, z) == 0) {
+                    continue;
+                }
+                if ((x > 0 && entity->getVoxelInternal(x - 1, y, z) > 0) &&
+                    (y > 0 && entity->getVoxelInternal(x, y - 1, z) > 0) &&
+                    (z > 0 && entity->getVoxelInternal(x, y, z - 1) > 0) &&
+                    (x < voxelVolumeSize.x - 1 && entity->getVoxelInternal(x + 1, y, z) > 0) &&
+                    (y < voxelVolumeSize.y - 1 && entity->getVoxelInternal(x, y + 1, z) > 0) &&
+                    (z < voxelVolumeSize.z - 1 && entity->getVoxelInternal(x, y, z + 1) > 0)) {
+                    // this voxel has neighbors in every cardinal direction, so there's no need
+                    // to include it in the collision hull.
+                    continue;
+                }
+
+                // add next convex hull
+                QVector<glm::vec3> pointsInPart;
+                pointsInPart << glm::vec3(x + offL, y + offL, z + offL);
+                pointsInPart << glm::vec3(x + offL, y + offL, z + offH);
+                pointsInPart << glm::vec3(x + offL, y + offH, z + offL);
+                pointsInPart << glm::vec3(x + offL, y + offH, z + offH);
+                pointsInPart << glm::vec3(x + offH, y + offL, z + offL);
+                pointsInPart << glm::vec3(x + offH, y + offL, z + offH);
+                pointsInPart << glm::vec3(x + offH, y + offH, z + offL);
+                pointsInPart << glm::vec3(x + offH, y + offH, z + offH);
+                chunk.collisionPoints << pointsInPart;
+            }
+        }
+    }
+    return chunk;
+}
+
 void RenderablePolyVoxEntityItem::recomputeMesh() {
-    // use _volData to make a renderable mesh
+    // use _volData to make a renderable mesh of each of the chunks with changed voxels
     PolyVoxSurfaceStyle voxelSurfaceStyle;
     withReadLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
@@ -1276,92 +1474,74 @@ void RenderablePolyVoxEntityItem::recomputeMesh() {
     cacheNeighbors();
     copyUpperEdgesFromNeighbors();
 
-    auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
-
-    QtConcurrent::run([entity, voxelSurfaceStyle] {
-        model::MeshPointer mesh(new model::Mesh());
+    Chunks chunks;
+    std::vector<int> dirtyChunks;
+    glm::ivec3 numChunks;
+    glm::ivec3 voxelVolumeSize;
+    withWriteLock([&] {
+        numChunks = (glm::ivec3(_volData->getWidth(), _volData->getHeight(), _volData->getDepth()) +
+            POLYVOX_CHUNK_SIZE - 1) / POLYVOX_CHUNK_SIZE;
+        int numChunksInVolume = numChunks.x * numChunks.y * numChunks.z;
+        if (_allChunksDirty || numChunks != _numChunks || (int)_chunks.size() != numChunksInVolume) {
+            chunks.resize(numChunksInVolume);
+            for (int i = 0; i < numChunksInVolume; i++) {
+                dirtyChunks.push_back(i);
+            }
+        } else {
+            chunks = _chunks;
+            dirtyChunks.assign(_dirtyChunks.begin(), _dirtyChunks.end());
+        }
+        _numChunks = numChunks;
+        _dirtyChunks.clear();
+        _allChunksDirty = false;
+        _meshJobRunning = true;
+        voxelVolumeSize = _voxelVolumeSize;
+    });
 
-        // A mesh object to hold the result of surface extraction
-        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+    auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
+    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, chunks, dirtyChunks, numChunks]() mutable {
         entity->withReadLock([&] {
-            PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
-            switch (voxelSurfaceStyle) {
-                case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
+            // if the volume was resized meanwhile, the next recomputeMesh will extract all of it again
+            PolyVox::Region enclosingRegion = entity->getVolData()->getEnclosingRegion();
+            PolyVox::Vector3DInt32 volumeLowCorner = enclosingRegion.getLowerCorner();
+            PolyVox::Vector3DInt32 volumeHighCorner = enclosingRegion.getUpperCorner();
+            for (int index : dirtyChunks) {
+                glm::ivec3 chunk(index % numChunks.x, (index / numChunks.x) % numChunks.y,
+                                 index / (numChunks.x * numChunks.y));
+                chunk *= POLYVOX_CHUNK_SIZE;
+                PolyVox::Vector3DInt32 lowCorner = volumeLowCorner + PolyVox::Vector3DInt32(chunk.x, chunk.y, chunk.z);
+                PolyVox::Vector3DInt32 highCorner(std::min(lowCorner.getX() + POLYVOX_CHUNK_SIZE, volumeHighCorner.getX()),
+                                                  std::min(lowCorner.getY() + POLYVOX_CHUNK_SIZE, volumeHighCorner.getY()),
+                                                  std::min(lowCorner.getZ() + POLYVOX_CHUNK_SIZE, volumeHighCorner.getZ()));
+                PolyVox::Vector3DInt32 lastVoxel(std::min(lowCorner.getX() + POLYVOX_CHUNK_SIZE - 1, volumeHighCorner.getX()),
+                                                 std::min(lowCorner.getY() + POLYVOX_CHUNK_SIZE - 1, volumeHighCorner.getY()),
+                                                 std::min(lowCorner.getZ() + POLYVOX_CHUNK_SIZE - 1, volumeHighCorner.getZ()));
+                if (highCorner.getX() < lowCorner.getX() || highCorner.getY() < lowCorner.getY() ||
+                    highCorner.getZ() < lowCorner.getZ()) {
+                    chunks[index] = Chunk();
+                    continue;
                 }
+                // neighboring chunks share the voxels on their faces, so their surfaces knit together
+                chunks[index] = extractChunk(entity.get(), voxelSurfaceStyle, voxelVolumeSize,
+                                             PolyVox::Region(lowCorner, highCorner), PolyVox::Region(lowCorner, lastVoxel));
             }
         });
-
-        // convert PolyVox mesh to a Sam mesh
-        const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
-        auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
-                                                         (gpu::Byte*)vecIndices.data());
-        auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
-        gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
-        mesh->setIndexBuffer(indexBufferView);
-
-        const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getRawVertexData();
-        auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
-                                                          (gpu::Byte*)vecVertices.data());
-        auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
-        gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
-                                         vertexBufferPtr->getSize(),
-                                         sizeof(PolyVox::PositionMaterialNormal),
-                                         gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-        mesh->setVertexBuffer(vertexBufferView);
-
-
-        // TODO -- use 3-byte normals rather than 3-float normals
-        mesh->addAttribute(gpu::Stream::NORMAL,
-                           gpu::BufferView(vertexBufferPtr,
-                                           sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
-                                           vertexBufferPtr->getSize(),
-                                           sizeof(PolyVox::PositionMaterialNormal),
-                                           gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
-
-        std::vector<model::Mesh::Part> parts;
-        parts.emplace_back(model::Mesh::Part((model::Index)0, // startIndex
-                                             (model::Index)vecIndices.size(), // numIndices
-                                             (model::Index)0, // baseVertex
-                                             model::Mesh::TRIANGLES)); // topology
-        mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(model::Mesh::Part),
-                                                            (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
-        entity->setMesh(mesh);
+        entity->setChunks(chunks);
     });
 }
 
-void RenderablePolyVoxEntityItem::setMesh(model::MeshPointer mesh) {
+void RenderablePolyVoxEntityItem::setChunks(Chunks chunks) {
     // this catches the payload from recomputeMesh
     bool neighborsNeedUpdate;
     withWriteLock([&] {
         if (!_collisionless) {
             _dirtyFlags |= Simulation::DIRTY_SHAPE | Simulation::DIRTY_MASS;
         }
-        _mesh = mesh;
+        _chunks = std::move(chunks);
         _meshDirty = true;
         _meshReady = true;
+        _meshJobRunning = false;
         neighborsNeedUpdate = _neighborsNeedUpdate;
         _neighborsNeedUpdate = false;
     });
@@ -1371,132 +1551,43 @@ void RenderablePolyVoxEntityItem::setMesh(model::MeshPointer mesh) {
 }
 
 void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
-    // this creates a collision-shape for the physics engine.  The shape comes from
-    // _volData for cubic extractors and from _mesh for marching-cube extractors
+    // this creates a collision-shape for the physics engine.  The convex hulls of each chunk were made when
+    // its mesh was extracted, they only need to be moved out of voxel-space.
     if (!_meshReady) {
         return;
     }
 
     EntityItemPointer entity = getThisPointer();
 
-    PolyVoxSurfaceStyle voxelSurfaceStyle;
-    glm::vec3 voxelVolumeSize;
-    model::MeshPointer mesh;
-
+    Chunks chunks;
     withReadLock([&] {
-        voxelSurfaceStyle = _voxelSurfaceStyle;
-        voxelVolumeSize = _voxelVolumeSize;
-        mesh = _mesh;
+        chunks = _chunks;
     });
 
-    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, mesh] {
+    QtConcurrent::run([entity, chunks] {
         auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
         QVector<QVector<glm::vec3>> pointCollection;
         AABox box;
-        glm::mat4 vtoM = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->voxelToLocalMatrix();
-
-        if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
-            voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
-            // pull each triangle in the mesh into a polyhedron which can be collided with
-            unsigned int i = 0;
-
-            const gpu::BufferView& vertexBufferView = mesh->getVertexBuffer();
-            const gpu::BufferView& indexBufferView = mesh->getIndexBuffer();
+        glm::mat4 vtoM = polyVoxEntity->voxelToLocalMatrix();
 
-            gpu::BufferView::Iterator<const uint32_t> it = indexBufferView.cbegin<uint32_t>();
-            while (it != indexBufferView.cend<uint32_t>()) {
-                uint32_t p0Index = *(it++);
-                uint32_t p1Index = *(it++);
-                uint32_t p2Index = *(it++);
-
-                const glm::vec3& p0 = vertexBufferView.get<const glm::vec3>(p0Index);
-                const glm::vec3& p1 = vertexBufferView.get<const glm::vec3>(p1Index);
-                const glm::vec3& p2 = vertexBufferView.get<const glm::vec3>(p2Index);
-
-                glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
-                glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-                glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
-
-                glm::vec3 p0Model = glm::vec3(vtoM * glm::vec4(p0, 1.0f));
-                glm::vec3 p1Model = glm::vec3(vtoM * glm::vec4(p1, 1.0f));
-                glm::vec3 p2Model = glm::vec3(vtoM * glm::vec4(p2, 1.0f));
-                glm::vec3 p3Model = glm::vec3(vtoM * glm::vec4(p3, 1.0f));
-
-                box += p0Model;
-                box += p1Model;
-                box += p2Model;
-                box += p3Model;
+        int numParts = 0;
+        for (const auto& chunk : chunks) {
+            numParts += chunk.collisionPoints.size();
+        }
+        pointCollection.reserve(numParts);
 
+        for (const auto& chunk : chunks) {
+            for (const auto& pointsInVoxel : chunk.collisionPoints) {
                 QVector<glm::vec3> pointsInPart;
-                pointsInPart << p0Model;
-                pointsInPart << p1Model;
-                pointsInPart << p2Model;
-                pointsInPart << p3Model;
+                pointsInPart.reserve(pointsInVoxel.size());
+                for (const auto& point : pointsInVoxel) {
+                    glm::vec3 pointModel = glm::vec3(vtoM * glm::vec4(point, 1.0f));
+                    box += pointModel;
+                    pointsInPart << pointModel;
+                }
                 // add next convex hull
-                QVector<glm::vec3> newMeshPoints;
-                pointCollection << newMeshPoints;
-                // add points to the new convex hull
-                pointCollection[i++] << pointsInPart;
+                pointCollection << pointsInPart;
             }
-        } else {
-            unsigned int i = 0;
-            polyVoxEntity->forEachVoxelValue(voxelVolumeSize.x, voxelVolumeSize.y, voxelVolumeSize.z,
-                                             [&](int x, int y, int z, uint8_t value) {
-                if (value > 0) {
-                    if ((x > 0 && polyVoxEntity->getVoxelInternal(x - 1, y, z) > 0) &&
-                        (y > 0 && polyVoxEntity->getVoxelInternal(x, y - 1, z) > 0) &&
-                        (z > 0 && polyVoxEntity->getVoxelInternal(x, y, z - 1) > 0) &&
-                        (x < voxelVolumeSize.x - 1 && polyVoxEntity->getVoxelInternal(x + 1, y, z) > 0) &&
-                        (y < voxelVolumeSize.y - 1 && polyVoxEntity->getVoxelInternal(x, y + 1, z) > 0) &&
-                        (z < voxelVolumeSize.z - 1 && polyVoxEntity->getVoxelInternal(x, y, z + 1) > 0)) {
-                        // this voxel has neighbors in every cardinal direction, so there's no need
-                        // to include it in the collision hull.
-                        return;
-                    }
-
-                    QVector<glm::vec3> pointsInPart;
-
-                    float offL = -0.5f;
-                    float offH = 0.5f;
-                    if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
-                        offL += 1.0f;
-                        offH += 1.0f;
-                    }
-
-                    glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
-                    glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
-                    glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
-                    glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
-                    glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
-                    glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
-                    glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
-                    glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
-
-                    box += p000;
-                    box += p001;
-                    box += p010;
-                    box += p011;
-                    box += p100;
-                    box += p101;
-                    box += p110;
-                    box += p111;
-
-                    pointsInPart << p000;
-                    pointsInPart << p001;
-                    pointsInPart << p010;
-                    pointsInPart << p011;
-                    pointsInPart << p100;
-                    pointsInPart << p101;
-                    pointsInPart << p110;
-                    pointsInPart << p111;
-
-                    // add next convex hull
-                    QVector<glm::vec3> newMeshPoints;
-                    pointCollection << newMeshPoints;
-                    // add points to the new convex hull
-                    pointCollection[i++] << pointsInPart;
-                }
-            });
         }
         polyVoxEntity->setCollisionPoints(pointCollection, box);
     });
@@ -1651,7 +1742,24 @@ bool RenderablePolyVoxEntityItem::getMeshes(MeshProxyList& result) {
     MeshProxy* meshProxy = nullptr;
     glm::mat4 transform = voxelToLocalMatrix();
     withReadLock([&] {
-        gpu::BufferView::Index numVertices = (gpu::BufferView::Index)_mesh->getNumVertices();
+        // knit the chunks back into one mesh
+        std::vector<PolyVox::PositionMaterialNormal> vecVertices;
+        std::vector<uint32_t> vecIndices;
+        for (const auto& chunk : _chunks) {
+            if (!chunk.mesh) {
+                continue;
+            }
+            uint32_t baseVertex = (uint32_t)vecVertices.size();
+            auto vertices = reinterpret_cast<const PolyVox::PositionMaterialNormal*>(
+                chunk.mesh->getVertexBuffer()._buffer->getData());
+            vecVertices.insert(vecVertices.end(), vertices, vertices + chunk.mesh->getNumVertices());
+            auto indices = reinterpret_cast<const uint32_t*>(chunk.mesh->getIndexBuffer()._buffer->getData());
+            for (size_t i = 0; i < chunk.mesh->getNumIndices(); i++) {
+                vecIndices.push_back(baseVertex + indices[i]);
+            }
+        }
+
+        gpu::BufferView::Index numVertices = (gpu::BufferView::Index)vecVertices.size();
         if (!_meshReady) {
             // we aren't ready to return a mesh.  the caller will have to try again later.
             success = false;
@@ -1661,8 +1769,9 @@ bool RenderablePolyVoxEntityItem::getMeshes(MeshProxyList& result) {
         } else {
             success = true;
             // the mesh will be in voxel-space.  transform it into object-space
+            model::MeshPointer mesh = buildPolyVoxMesh(vecVertices, vecIndices);
             meshProxy = new SimpleMeshProxy(
-                _mesh->map([=](glm::vec3 position){ return glm::vec3(transform * glm::vec4(position, 1.0f)); },
+                mesh->map([=](glm::vec3 position){ return glm::vec3(transform * glm::vec4(position, 1.0f)); },
                            [=](glm::vec3 color){ return color; },
                            [=](glm::vec3 normal){ return glm::normalize(glm::vec3(transform * glm::vec4(normal, 0.0f))); },
                            [&](uint32_t index){ return index; }));
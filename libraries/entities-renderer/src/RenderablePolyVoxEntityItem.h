@@ -13,6 +13,7 @@
 #define hifi_RenderablePolyVoxEntityItem_h
 
 #include <atomic>
+#include <set>
 
 #include <QSemaphore>
 
@@ -152,7 +153,15 @@ public:
                            std::function<void(int, int, int, uint8_t)> thunk);
     QByteArray volDataToArray(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) const;
 
-    void setMesh(model::MeshPointer mesh);
+    // The volume is meshed in cubes of POLYVOX_CHUNK_SIZE voxels, so an edit only extracts the chunks around it again.
+    // Each chunk has its own gpu buffers and the convex hulls of its part of the collision shape, both in voxel-space.
+    struct Chunk {
+        model::MeshPointer mesh;
+        ShapeInfo::PointCollection collisionPoints;
+    };
+    using Chunks = std::vector<Chunk>;
+
+    void setChunks(Chunks chunks);
     void setCollisionPoints(ShapeInfo::PointCollection points, AABox box);
     PolyVox::SimpleVolume<uint8_t>* getVolData() { return _volData; }
 
@@ -173,7 +182,11 @@ private:
     // The PolyVoxEntityItem class has _voxelData which contains dimensions and compressed voxel data.  The dimensions
     // may not match _voxelVolumeSize.
 
-    model::MeshPointer _mesh;
+    Chunks _chunks;
+    glm::ivec3 _numChunks { 0 };
+    std::set<int> _dirtyChunks; // indices in _chunks of the chunks recomputeMesh needs to extract again
+    bool _allChunksDirty { true };
+    bool _meshJobRunning { false };
     gpu::Stream::FormatPointer _vertexFormat;
     bool _meshDirty { true }; // does collision-shape need to be recomputed?
     bool _meshReady { false };
@@ -193,6 +206,7 @@ private:
     bool _neighborsNeedUpdate { false };
 
     bool updateOnCount(int x, int y, int z, uint8_t toValue);
+    void markChunksDirty(int x, int y, int z);
     PolyVox::RaycastResult doRayCast(glm::vec4 originInVoxel, glm::vec4 farInVoxel, glm::vec4& result) const;
 
     // these are run off the main thread
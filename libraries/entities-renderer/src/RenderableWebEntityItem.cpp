@@ -40,6 +40,11 @@ static float OPAQUE_ALPHA_THRESHOLD = 0.99f;
 static int DEFAULT_MAX_FPS = 10;
 static int YOUTUBE_MAX_FPS = 30;
 
+// A surface that spans less than this angle (as its size over its distance) is refreshed less often,
+// down to MIN_MAX_FPS, the pixels it takes would not show the difference
+static float FULL_FPS_ANGULAR_SIZE = 0.5f;
+static int MIN_MAX_FPS = 2;
+
 EntityItemPointer RenderableWebEntityItem::factory(const EntityItemID& entityID, const EntityItemProperties& properties) {
     EntityItemPointer entity{ new RenderableWebEntityItem(entityID) };
     entity->setProperties(properties);
@@ -102,7 +107,8 @@ bool RenderableWebEntityItem::buildWebSurface() {
 
     // FIXME, the max FPS could be better managed by being dynamic (based on the number of current surfaces
     // and the current rendering load)
-    _webSurface->setMaxFps(DEFAULT_MAX_FPS);
+    _maxFps = DEFAULT_MAX_FPS;
+    _webSurface->setMaxFps(_maxFps);
 
     // The lifetime of the QML surface MUST be managed by the main thread
     // Additionally, we MUST use local variables copied by value, rather than
@@ -197,6 +203,17 @@ void RenderableWebEntityItem::render(RenderArgs* args) {
 
     glm::vec2 windowSize = getWindowSize();
 
+    // A surface that is not rendered is not refreshed either, as it only renders once its last frame was fetched.
+    // One that is rendered far away is refreshed at a rate that matches its size in the view.
+    if (args->hasViewFrustum()) {
+        float distance = glm::distance(args->getViewFrustum().getPosition(), getPosition());
+        glm::vec3 dimensions = getDimensions();
+        float angularSize = glm::max(dimensions.x, dimensions.y) / glm::max(distance, EPSILON);
+        float fpsRatio = glm::min(angularSize / FULL_FPS_ANGULAR_SIZE, 1.0f);
+        int maxFps = glm::max((int)glm::round(fpsRatio * _maxFps), glm::min(MIN_MAX_FPS, _maxFps));
+        _webSurface->setMaxFps(maxFps);
+    }
+
     // The offscreen surface is idempotent for resizes (bails early
     // if it's a no-op), so it's safe to just call resize every frame
     // without worrying about excessive overhead.
@@ -249,10 +266,11 @@ void RenderableWebEntityItem::loadSourceURL() {
 
         // We special case YouTube URLs since we know they are videos that we should play with at least 30 FPS.
         if (sourceUrl.host().endsWith("youtube.com", Qt::CaseInsensitive)) {
-            _webSurface->setMaxFps(YOUTUBE_MAX_FPS);
+            _maxFps = YOUTUBE_MAX_FPS;
         } else {
-            _webSurface->setMaxFps(DEFAULT_MAX_FPS);
+            _maxFps = DEFAULT_MAX_FPS;
         }
+        _webSurface->setMaxFps(_maxFps);
 
         _webSurface->load("WebEntityView.qml");
         _webSurface->getRootItem()->setProperty("url", _sourceUrl);
@@ -66,6 +66,7 @@ private:
     gpu::TexturePointer _texture;
     bool _pressed{ false };
     uint64_t _lastRenderTime{ 0 };
+    int _maxFps { 0 }; // when the surface fills the view, it is refreshed less often as it gets smaller
     QTouchDevice _touchDevice;
 
     QMetaObject::Connection _mousePressConnection;
@@ -0,0 +1,333 @@
+//
+//  EntityBVH.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityBVH.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "EntityItem.h"
+
+static const int MAX_LEAF_ENTRIES = 4;
+static const int MAX_DEPTH = 64; // the hierarchy is balanced, this is far more than it needs
+
+// the entities tested one by one, at most, before building again
+static const size_t MIN_UNINDEXED_ENTITIES = 64;
+
+static bool findRayBoxIntersection(const glm::vec3& origin, const glm::vec3& inverseDirection,
+                                   const glm::vec3& minimum, const glm::vec3& maximum, float& distance) {
+    glm::vec3 t0 = (minimum - origin) * inverseDirection;
+    glm::vec3 t1 = (maximum - origin) * inverseDirection;
+    glm::vec3 nearest = glm::min(t0, t1);
+    glm::vec3 farthest = glm::max(t0, t1);
+    float entry = std::max(std::max(nearest.x, nearest.y), std::max(nearest.z, 0.0f));
+    float exit = std::min(std::min(farthest.x, farthest.y), farthest.z);
+    distance = entry;
+    return exit >= entry;
+}
+
+void EntityBVH::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    {
+        std::lock_guard<std::mutex> pendingLock(_pendingMutex);
+        _isBuilt = false;
+        _pendingAdded.clear();
+        _pendingRemoved.clear();
+        _pendingMoved.clear();
+    }
+    _nodes.clear();
+    _entries.clear();
+    _entryIndices.clear();
+    _unindexed.clear();
+    _removedCount = 0;
+}
+
+void EntityBVH::entityAdded(const EntityItemPointer& entity) {
+    if (_isBuilt) {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pendingAdded.push_back(entity);
+    }
+}
+
+void EntityBVH::entityRemoved(const EntityItemID& id) {
+    if (_isBuilt) {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pendingRemoved.push_back(id);
+    }
+}
+
+void EntityBVH::entityMoved(const EntityItemPointer& entity) {
+    if (_isBuilt) {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pendingMoved.push_back(entity);
+    }
+}
+
+void EntityBVH::build() {
+    _nodes.clear();
+    _entries.clear();
+    _entryIndices.clear();
+    _unindexed.clear();
+    _removedCount = 0;
+    {
+        // from here on, the changes build on what is read below
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pendingAdded.clear();
+        _pendingRemoved.clear();
+        _pendingMoved.clear();
+        _isBuilt = true;
+    }
+
+    _entries.reserve(_entityMap.size());
+    _entityMap.forEach([&](const QUuid&, const EntityItemPointer& entity) {
+        // cleared before reading the bounds, so that a concurrent move is refit with the next pick
+        entity->clearPickBoundsChanged();
+        bool success;
+        AABox box = entity->getAABox(success);
+        if (success) {
+            Entry entry;
+            entry.entity = entity;
+            entry.minimum = box.getMinimumPoint();
+            entry.maximum = box.getMaximumPoint();
+            _entries.push_back(entry);
+        } else {
+            // its parent isn't known yet
+            _unindexed.push_back(entity);
+        }
+    });
+
+    if (!_entries.empty()) {
+        _nodes.reserve(2 * _entries.size());
+        _nodes.emplace_back();
+        buildNode(0, 0, (int)_entries.size());
+    }
+    for (int i = 0; i < (int)_entries.size(); ++i) {
+        if (auto entity = _entries[i].entity.lock()) {
+            _entryIndices[entity->getEntityItemID()] = i;
+        }
+    }
+}
+
+void EntityBVH::buildNode(int nodeIndex, int first, int count) {
+    glm::vec3 minimum(std::numeric_limits<float>::max());
+    glm::vec3 maximum(-std::numeric_limits<float>::max());
+    glm::vec3 minimumCenter = minimum;
+    glm::vec3 maximumCenter = maximum;
+    for (int i = first; i < first + count; ++i) {
+        const auto& entry = _entries[i];
+        minimum = glm::min(minimum, entry.minimum);
+        maximum = glm::max(maximum, entry.maximum);
+        glm::vec3 center = 0.5f * (entry.minimum + entry.maximum);
+        minimumCenter = glm::min(minimumCenter, center);
+        maximumCenter = glm::max(maximumCenter, center);
+    }
+    _nodes[nodeIndex].minimum = minimum;
+    _nodes[nodeIndex].maximum = maximum;
+
+    if (count <= MAX_LEAF_ENTRIES) {
+        _nodes[nodeIndex].first = first;
+        _nodes[nodeIndex].count = count;
+        for (int i = first; i < first + count; ++i) {
+            _entries[i].node = nodeIndex;
+        }
+        return;
+    }
+
+    // halve the entries along the axis their centers spread most on
+    glm::vec3 spread = maximumCenter - minimumCenter;
+    int axis = (spread.x > spread.y) ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+    int middle = first + count / 2;
+    std::nth_element(_entries.begin() + first, _entries.begin() + middle, _entries.begin() + first + count,
+        [axis](const Entry& a, const Entry& b) {
+            return a.minimum[axis] + a.maximum[axis] < b.minimum[axis] + b.maximum[axis];
+        });
+
+    int childIndex = (int)_nodes.size();
+    _nodes.emplace_back();
+    _nodes.emplace_back();
+    _nodes[nodeIndex].first = childIndex;
+    _nodes[nodeIndex].count = 0;
+    _nodes[childIndex].parent = nodeIndex;
+    _nodes[childIndex + 1].parent = nodeIndex;
+    buildNode(childIndex, first, middle - first);
+    buildNode(childIndex + 1, middle, first + count - middle);
+}
+
+void EntityBVH::refit(int nodeIndex) {
+    while (nodeIndex >= 0) {
+        Node& node = _nodes[nodeIndex];
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        if (node.count > 0) {
+            minimum = _entries[node.first].minimum;
+            maximum = _entries[node.first].maximum;
+            for (int i = node.first + 1; i < node.first + node.count; ++i) {
+                minimum = glm::min(minimum, _entries[i].minimum);
+                maximum = glm::max(maximum, _entries[i].maximum);
+            }
+        } else {
+            const Node& left = _nodes[node.first];
+            const Node& right = _nodes[node.first + 1];
+            minimum = glm::min(left.minimum, right.minimum);
+            maximum = glm::max(left.maximum, right.maximum);
+        }
+        if (minimum == node.minimum && maximum == node.maximum) {
+            return; // and so are the ancestors
+        }
+        node.minimum = minimum;
+        node.maximum = maximum;
+        nodeIndex = node.parent;
+    }
+}
+
+void EntityBVH::update() {
+    if (!_isBuilt) {
+        build();
+        return;
+    }
+
+    std::vector<EntityItemWeakPointer> added;
+    std::vector<EntityItemID> removed;
+    std::vector<EntityItemWeakPointer> moved;
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        added.swap(_pendingAdded);
+        removed.swap(_pendingRemoved);
+        moved.swap(_pendingMoved);
+    }
+
+    for (const auto& id : removed) {
+        auto it = _entryIndices.find(id);
+        if (it != _entryIndices.end()) {
+            // the bounds of its node are left as they are, too large is only slower
+            _entries[it.value()].entity.reset();
+            _entryIndices.erase(it);
+            ++_removedCount;
+        }
+    }
+    for (const auto& entity : added) {
+        _unindexed.push_back(entity);
+    }
+    if (!removed.empty()) {
+        _unindexed.erase(std::remove_if(_unindexed.begin(), _unindexed.end(), [&](const EntityItemWeakPointer& weak) {
+            auto entity = weak.lock();
+            return !entity || std::find(removed.begin(), removed.end(), entity->getEntityItemID()) != removed.end();
+        }), _unindexed.end());
+    }
+
+    if (_unindexed.size() > std::max(MIN_UNINDEXED_ENTITIES, _entries.size() / 8) || _removedCount > _entries.size() / 4) {
+        build();
+        return;
+    }
+
+    for (const auto& weak : moved) {
+        auto entity = weak.lock();
+        if (!entity) {
+            continue;
+        }
+        entity->clearPickBoundsChanged();
+        auto it = _entryIndices.find(entity->getEntityItemID());
+        if (it == _entryIndices.end()) {
+            continue; // unindexed, its bounds are read as it is tested
+        }
+        bool success;
+        AABox box = entity->getAABox(success);
+        if (!success) {
+            // its parent went away, test it one by one until it moves again
+            _unindexed.push_back(entity);
+            continue;
+        }
+        Entry& entry = _entries[it.value()];
+        entry.minimum = box.getMinimumPoint();
+        entry.maximum = box.getMaximumPoint();
+        refit(entry.node);
+    }
+}
+
+void EntityBVH::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+                                    const RayVisitor& visitor) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    update();
+
+    for (const auto& weak : _unindexed) {
+        if (auto entity = weak.lock()) {
+            visitor(entity, distance);
+        }
+    }
+    if (_nodes.empty()) {
+        return;
+    }
+
+    // a ray parallel to a slab is inside it or not, whatever the distance
+    const float LARGE = std::numeric_limits<float>::max();
+    glm::vec3 inverseDirection;
+    for (int axis = 0; axis < 3; ++axis) {
+        inverseDirection[axis] = (direction[axis] != 0.0f) ? 1.0f / direction[axis] : LARGE;
+    }
+
+    struct StackEntry {
+        int node;
+        float distance;
+    };
+    StackEntry stack[MAX_DEPTH * 2];
+    int stackSize = 0;
+
+    float rootDistance;
+    if (!findRayBoxIntersection(origin, inverseDirection, _nodes[0].minimum, _nodes[0].maximum, rootDistance)) {
+        return;
+    }
+    stack[stackSize++] = { 0, rootDistance };
+
+    while (stackSize > 0) {
+        StackEntry top = stack[--stackSize];
+        if (top.distance > distance) {
+            continue; // something nearer was found since it was pushed
+        }
+        const Node& node = _nodes[top.node];
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                const Entry& entry = _entries[i];
+                float entryDistance;
+                if (findRayBoxIntersection(origin, inverseDirection, entry.minimum, entry.maximum, entryDistance) &&
+                        entryDistance <= distance) {
+                    if (auto entity = entry.entity.lock()) {
+                        visitor(entity, distance);
+                    }
+                }
+            }
+            continue;
+        }
+
+        float leftDistance;
+        float rightDistance;
+        const Node& left = _nodes[node.first];
+        const Node& right = _nodes[node.first + 1];
+        bool hitsLeft = findRayBoxIntersection(origin, inverseDirection, left.minimum, left.maximum, leftDistance) &&
+            leftDistance <= distance;
+        bool hitsRight = findRayBoxIntersection(origin, inverseDirection, right.minimum, right.maximum, rightDistance) &&
+            rightDistance <= distance;
+
+        // the nearer child on top
+        if (hitsLeft && hitsRight) {
+            if (leftDistance < rightDistance) {
+                stack[stackSize++] = { node.first + 1, rightDistance };
+                stack[stackSize++] = { node.first, leftDistance };
+            } else {
+                stack[stackSize++] = { node.first, leftDistance };
+                stack[stackSize++] = { node.first + 1, rightDistance };
+            }
+        } else if (hitsLeft) {
+            stack[stackSize++] = { node.first, leftDistance };
+        } else if (hitsRight) {
+            stack[stackSize++] = { node.first + 1, rightDistance };
+        }
+    }
+}
@@ -0,0 +1,90 @@
+//
+//  EntityBVH.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityBVH_h
+#define hifi_EntityBVH_h
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QHash>
+
+#include <shared/ConcurrentUUIDMap.h>
+
+#include "EntityDynamicInterface.h"
+#include "EntityItemID.h"
+
+// A flattened bounding volume hierarchy over the bounds of the entities of a tree, for ray picks. The octree keeps
+// entities in elements sized by their query cubes, which a ray walks through top down; this visits the entities a ray
+// actually passes, nearest first, so that picks stop early.
+//
+// It is built on the first pick, then refit as entities move. Entities added since are tested one by one until
+// there are enough of them, or enough deleted, to build it again.
+class EntityBVH {
+public:
+    // the visitor tests the entity and lowers distance if the ray intersects it nearer
+    using RayVisitor = std::function<void(const EntityItemPointer& entity, float& distance)>;
+
+    EntityBVH(const ConcurrentUUIDMap<EntityItem>& entityMap) : _entityMap(entityMap) {}
+
+    void clear();
+
+    // from any thread, as the entities of the tree come and go and move
+    void entityAdded(const EntityItemPointer& entity);
+    void entityRemoved(const EntityItemID& id);
+    void entityMoved(const EntityItemPointer& entity);
+
+    // visits the entities whose bounds the ray intersects nearer than distance, nearest first
+    void findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+                             const RayVisitor& visitor);
+
+private:
+    struct Node {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int first { 0 }; // the first of the two children of an inner node, the first entry of a leaf
+        int count { 0 }; // the number of entries of a leaf, 0 for an inner node
+        int parent { -1 };
+    };
+
+    struct Entry {
+        EntityItemWeakPointer entity;
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int node { -1 };
+    };
+
+    void update();
+    void build();
+    void buildNode(int nodeIndex, int first, int count);
+    void refit(int nodeIndex);
+
+    const ConcurrentUUIDMap<EntityItem>& _entityMap;
+
+    std::mutex _mutex;
+    std::vector<Node> _nodes;
+    std::vector<Entry> _entries;
+    QHash<EntityItemID, int> _entryIndices;
+    std::vector<EntityItemWeakPointer> _unindexed; // tested one by one, the entities added since the build
+    size_t _removedCount { 0 };
+
+    // notified until the next pick, nothing is kept until the first one
+    std::atomic<bool> _isBuilt { false };
+    std::mutex _pendingMutex;
+    std::vector<EntityItemWeakPointer> _pendingAdded;
+    std::vector<EntityItemID> _pendingRemoved;
+    std::vector<EntityItemWeakPointer> _pendingMoved;
+};
+
+#endif // hifi_EntityBVH_h
@@ -10,11 +10,117 @@
 //
 
 
+#include <algorithm>
+
 #include <QUrl>
 
+#include <NumericalConstants.h>
+#include <RegisteredMetaTypes.h>
 #include <ResourceManager.h>
+#include <SharedUtil.h>
+
 #include "EntityEditFilters.h"
 
+// the times of the edits that no longer limit the next are dropped when more entities than this have them
+static const int MAX_RATE_LIMITED_ENTITIES = 1000;
+
+static EntityEditFilters::Rules rulesFromScriptValue(const QScriptValue& value) {
+    EntityEditFilters::Rules rules;
+    rules.isDeclared = true;
+
+    auto allowedTypes = value.property("allowedTypes");
+    if (allowedTypes.isArray()) {
+        int length = allowedTypes.property("length").toInt32();
+        for (int i = 0; i < length; ++i) {
+            auto typeName = allowedTypes.property(i).toString();
+            auto type = EntityTypes::getEntityTypeFromName(typeName);
+            if (type != EntityTypes::Unknown) {
+                rules.allowedTypes.insert(type);
+            } else {
+                qWarning() << "Entity edit filter rules allow unknown type" << typeName;
+            }
+        }
+        if (rules.allowedTypes.isEmpty()) {
+            // none of the types named is known, so none can be added
+            rules.allowedTypes.insert(EntityTypes::Unknown);
+        }
+    }
+
+    auto positionBounds = value.property("positionBounds");
+    if (positionBounds.isObject()) {
+        vec3FromScriptValue(positionBounds.property("min"), rules.minPosition);
+        vec3FromScriptValue(positionBounds.property("max"), rules.maxPosition);
+        rules.hasPositionBounds = true;
+    }
+
+    auto maxDimensions = value.property("maxDimensions");
+    if (maxDimensions.isObject()) {
+        vec3FromScriptValue(maxDimensions, rules.maxDimensions);
+        rules.hasMaxDimensions = true;
+    }
+
+    auto maxEditsPerSecond = value.property("maxEditsPerSecond");
+    if (maxEditsPerSecond.isNumber()) {
+        rules.maxEditsPerSecond = std::max((float)maxEditsPerSecond.toNumber(), 0.0f);
+    }
+    return rules;
+}
+
+static bool applyRules(const EntityEditFilters::FilterData& filterData, EntityItemProperties& propertiesIn,
+                       EntityItemProperties& propertiesOut, bool& wasChanged, EntityTree::FilterType filterType,
+                       const EntityItemID& itemID) {
+    const auto& rules = filterData.rules;
+    if (!rules.isDeclared) {
+        return true;
+    }
+
+    if (filterType == EntityTree::FilterType::Add && !rules.allowedTypes.isEmpty() &&
+            !rules.allowedTypes.contains(propertiesIn.getType())) {
+        return false;
+    }
+
+    if (filterType == EntityTree::FilterType::Edit && rules.maxEditsPerSecond > 0.0f && !itemID.isInvalidID()) {
+        quint64 now = usecTimestampNow();
+        quint64 minInterval = (quint64)(USECS_PER_SECOND / rules.maxEditsPerSecond);
+        auto& lastEditTimes = *filterData.lastEditTimes;
+        auto it = lastEditTimes.find(itemID);
+        if (it != lastEditTimes.end() && now - it.value() < minInterval) {
+            return false;
+        }
+        if (it == lastEditTimes.end() && lastEditTimes.size() >= MAX_RATE_LIMITED_ENTITIES) {
+            for (auto timeIt = lastEditTimes.begin(); timeIt != lastEditTimes.end();) {
+                if (now - timeIt.value() >= minInterval) {
+                    timeIt = lastEditTimes.erase(timeIt);
+                } else {
+                    ++timeIt;
+                }
+            }
+        }
+        lastEditTimes[itemID] = now;
+    }
+
+    if (rules.hasPositionBounds && propertiesIn.containsPositionChange()) {
+        auto position = propertiesIn.getPosition();
+        auto clampedPosition = glm::clamp(position, rules.minPosition, rules.maxPosition);
+        if (clampedPosition != position) {
+            propertiesIn.setPosition(clampedPosition);
+            propertiesOut.setPosition(clampedPosition);
+            wasChanged = true;
+        }
+    }
+
+    if (rules.hasMaxDimensions && propertiesIn.containsDimensionsChange()) {
+        auto dimensions = propertiesIn.getDimensions();
+        auto clampedDimensions = glm::min(dimensions, rules.maxDimensions);
+        if (clampedDimensions != dimensions) {
+            propertiesIn.setDimensions(clampedDimensions);
+            propertiesOut.setDimensions(clampedDimensions);
+            wasChanged = true;
+        }
+    }
+    return true;
+}
+
 QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
     QList<EntityItemID> zones;
     QList<EntityItemID> missingZones;
@@ -61,6 +167,12 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
             if (filterData.rejectAll) {
                 return false;
             }
+            if (!applyRules(filterData, propertiesIn, propertiesOut, wasChanged, filterType, itemID)) {
+                return false;
+            }
+            if (!filterData.isScripted()) {
+                continue;
+            }
             auto oldProperties = propertiesIn.getDesiredProperties();
             auto specifiedProperties = propertiesIn.getChangedProperties();
             propertiesIn.setDesiredProperties(specifiedProperties);
@@ -201,7 +313,7 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
                 QScriptEngine& engineRef = *engine;
                 filterData.uncaughtExceptions = [this, &engineRef, urlString]() { return hadUncaughtExceptions(engineRef, urlString); };
 
-                // now get the filter function
+                // now get the filter function, and the rules that are checked without it
                 auto global = engine->globalObject();
                 auto entitiesObject = engine->newObject();
                 entitiesObject.setProperty("ADD_FILTER_TYPE", EntityTree::FilterType::Add);
@@ -209,7 +321,14 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
                 entitiesObject.setProperty("PHYSICS_FILTER_TYPE", EntityTree::FilterType::Physics);
                 global.setProperty("Entities", entitiesObject);
                 filterData.filterFn = global.property("filter");
-                if (!filterData.filterFn.isFunction()) {
+                auto rulesValue = global.property("filterRules");
+                if (rulesValue.isObject()) {
+                    filterData.rules = rulesFromScriptValue(rulesValue);
+                    filterData.lastEditTimes = std::make_shared<QHash<EntityItemID, quint64>>();
+                }
+                if (!filterData.filterFn.isFunction() && filterData.rules.isDeclared) {
+                    qDebug() << "No filter function specified, only the filter rules will be checked.";
+                } else if (!filterData.filterFn.isFunction()) {
                     qDebug() << "Filter function specified but not found. Will reject all edits for those without lock rights.";
                     delete engine;
                     filterData.rejectAll=true;
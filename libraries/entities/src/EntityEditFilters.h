@@ -12,28 +12,58 @@
 #define hifi_EntityEditFilters_h
 
 #include <QObject>
+#include <QHash>
 #include <QMap>
+#include <QSet>
 #include <QScriptValue>
 #include <QScriptEngine>
 #include <glm/glm.hpp>
 
 #include <functional>
+#include <memory>
 
 #include "EntityItemID.h"
 #include "EntityItemProperties.h"
 #include "EntityTree.h"
 
+// A filter script can declare the rules it checks that don't need script in a global filterRules object, e.g.
+//
+//     var filterRules = {
+//         allowedTypes: ["Box", "Sphere"],                      // the types of entities that can be added
+//         positionBounds: { min: { x: -100, y: -10, z: -100 }, // positions are clamped into these
+//                           max: { x: 100, y: 50, z: 100 } },
+//         maxDimensions: { x: 10, y: 10, z: 10 },              // and dimensions down to these
+//         maxEditsPerSecond: 10                                // edits to one entity beyond this are rejected
+//     };
+//
+// These are checked natively, before its filter function is called, and a script with no filter function is only
+// checked against them, so that the edits it lets through never go through its engine.
 class EntityEditFilters : public QObject, public Dependency {
     Q_OBJECT
 public:
+    struct Rules {
+        bool isDeclared { false };
+        QSet<EntityTypes::EntityType> allowedTypes; // any type can be added if empty
+        bool hasPositionBounds { false };
+        glm::vec3 minPosition;
+        glm::vec3 maxPosition;
+        bool hasMaxDimensions { false };
+        glm::vec3 maxDimensions;
+        float maxEditsPerSecond { 0.0f }; // the edits aren't limited if 0
+    };
+
     struct FilterData {
         QScriptValue filterFn;
         std::function<bool()> uncaughtExceptions;
         QScriptEngine* engine;
         bool rejectAll;
-        
+        Rules rules;
+        // when each entity was last let through by the rate limit of the rules
+        std::shared_ptr<QHash<EntityItemID, quint64>> lastEditTimes;
+
         FilterData(): engine(nullptr), rejectAll(false) {};
-        bool valid() { return (rejectAll || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
+        bool isScripted() const { return filterFn.isFunction() && uncaughtExceptions; }
+        bool valid() { return (rejectAll || (engine != nullptr && (isScripted() || rules.isDeclared))); }
     };
 
     EntityEditFilters() {};
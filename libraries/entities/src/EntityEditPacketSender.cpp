@@ -19,6 +19,9 @@
 #include "EntityItem.h"
 #include "EntityItemProperties.h"
 
+// scripts commonly edit at the frame rate, this holds them to about the rate the entity server broadcasts at
+const quint64 EntityEditPacketSender::DEFAULT_EDIT_COALESCING_WINDOW_USECS = USECS_PER_SECOND / 30;
+
 EntityEditPacketSender::EntityEditPacketSender() {
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerDirectListener(PacketType::EntityEditNack, this, "processEntityEditNackPacket");
@@ -90,6 +93,92 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType type,
         return;
     }
 
+    if (type == PacketType::EntityEdit) {
+        bool coalesce = _editCoalescingWindow > 0 && !isPriorityEdit(entityTree, entityItemID, properties);
+
+        std::unique_lock<std::mutex> lock(_coalescedEditsMutex);
+        auto it = _coalescedEdits.find(entityItemID);
+        if (coalesce) {
+            if (it == _coalescedEdits.end()) {
+                _coalescedEdits.insert(entityItemID, { properties, usecTimestampNow() });
+            } else {
+                // later values win, and the merged edit carries the time of the latest one
+                it->properties.merge(properties);
+                it->properties.setType(properties.getType());
+                it->properties.setLastEdited(properties.getLastEdited());
+            }
+            return;
+        }
+
+        if (it != _coalescedEdits.end()) {
+            // send what is still held for this entity along with this edit, so that it isn't sent out of order after it
+            EntityItemProperties mergedProperties = it->properties;
+            _coalescedEdits.erase(it);
+            lock.unlock();
+
+            mergedProperties.merge(properties);
+            mergedProperties.setType(properties.getType());
+            mergedProperties.setLastEdited(properties.getLastEdited());
+            sendEditEntityMessage(type, entityItemID, mergedProperties);
+            return;
+        }
+    }
+
+    sendEditEntityMessage(type, entityItemID, properties);
+}
+
+bool EntityEditPacketSender::isPriorityEdit(EntityTreePointer entityTree, EntityItemID entityItemID,
+                                            const EntityItemProperties& properties) const {
+    if (properties.simulationOwnerChanged()) {
+        return true;
+    }
+    if (!entityTree) {
+        return false;
+    }
+
+    // physics updates for the entities we simulate are already paced by the motion states
+    EntityItemPointer entity = entityTree->findEntityByEntityItemID(entityItemID);
+    return entity && entity->getSimulatorID() == DependencyManager::get<NodeList>()->getSessionUUID();
+}
+
+void EntityEditPacketSender::releaseCoalescedEdits(bool releaseAll) {
+    std::vector<std::pair<EntityItemID, EntityItemProperties>> released;
+    {
+        std::lock_guard<std::mutex> lock(_coalescedEditsMutex);
+        if (_coalescedEdits.isEmpty()) {
+            return;
+        }
+
+        quint64 now = usecTimestampNow();
+        quint64 window = _editCoalescingWindow;
+        auto it = _coalescedEdits.begin();
+        while (it != _coalescedEdits.end()) {
+            if (releaseAll || now - it->firstQueued >= window) {
+                released.emplace_back(it.key(), it->properties);
+                it = _coalescedEdits.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (auto& edit : released) {
+        sendEditEntityMessage(PacketType::EntityEdit, edit.first, edit.second);
+    }
+}
+
+void EntityEditPacketSender::releaseQueuedMessages() {
+    releaseCoalescedEdits(_editCoalescingWindow == 0);
+    OctreeEditPacketSender::releaseQueuedMessages();
+}
+
+bool EntityEditPacketSender::process() {
+    releaseCoalescedEdits(_editCoalescingWindow == 0);
+    return OctreeEditPacketSender::process();
+}
+
+void EntityEditPacketSender::sendEditEntityMessage(PacketType type, EntityItemID entityItemID,
+                                                   const EntityItemProperties& properties) {
     QByteArray bufferOut(NLPacket::maxPayloadSize(type), 0);
 
     bool success;
@@ -118,6 +207,12 @@ void EntityEditPacketSender::queueEraseEntityMessage(const EntityItemID& entityI
         return; // bail early
     }
 
+    {
+        // an edit still held for an entity that is being erased has nothing left to change
+        std::lock_guard<std::mutex> lock(_coalescedEditsMutex);
+        _coalescedEdits.remove(entityItemID);
+    }
+
     // in case this was a clientOnly entity:
     if(_myAvatar) {
         _myAvatar->clearAvatarEntity(entityItemID);
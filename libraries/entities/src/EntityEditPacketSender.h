@@ -14,8 +14,11 @@
 
 #include <OctreeEditPacketSender.h>
 
+#include <atomic>
 #include <mutex>
 
+#include <QtCore/QHash>
+
 #include "EntityItem.h"
 #include "AvatarData.h"
 
@@ -39,6 +42,19 @@ public:
 
     void queueEraseEntityMessage(const EntityItemID& entityItemID);
 
+    /// Edits to the same entity queued within this window of each other are merged and sent as one edit. Edits to
+    /// entities this node simulates, and edits that change simulation ownership, are never held back. Zero disables this.
+    void setEditCoalescingWindow(quint64 usecs) { _editCoalescingWindow = usecs; }
+    quint64 getEditCoalescingWindow() const { return _editCoalescingWindow; }
+
+    static const quint64 DEFAULT_EDIT_COALESCING_WINDOW_USECS;
+
+    /// Queues the coalesced edits whose window has passed, or all of them, for the next release of queued messages.
+    void releaseCoalescedEdits(bool releaseAll);
+
+    virtual void releaseQueuedMessages() override;
+    virtual bool process() override;
+
     // My server type is the model server
     virtual char getMyNodeType() const override { return NodeType::EntityServer; }
     virtual void adjustEditPacketForClockSkew(PacketType type, QByteArray& buffer, qint64 clockSkew) override;
@@ -49,10 +65,23 @@ public slots:
 private:
     void queueEditAvatarEntityMessage(PacketType type, EntityTreePointer entityTree,
                                       EntityItemID entityItemID, const EntityItemProperties& properties);
+    void sendEditEntityMessage(PacketType type, EntityItemID entityItemID, const EntityItemProperties& properties);
+
+    bool isPriorityEdit(EntityTreePointer entityTree, EntityItemID entityItemID,
+                        const EntityItemProperties& properties) const;
 
 private:
+    struct CoalescedEdit {
+        EntityItemProperties properties;
+        quint64 firstQueued;
+    };
+
     std::mutex _mutex;
     AvatarData* _myAvatar { nullptr };
     QScriptEngine _scriptEngine;
+
+    std::mutex _coalescedEditsMutex;
+    QHash<EntityItemID, CoalescedEdit> _coalescedEdits;
+    std::atomic<quint64> _editCoalescingWindow { DEFAULT_EDIT_COALESCING_WINDOW_USECS };
 };
 #endif // hifi_EntityEditPacketSender_h
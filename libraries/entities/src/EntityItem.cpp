@@ -745,43 +745,49 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
             bool simulationChanged = lastEdited > updatedTimestamp;
             return otherOverwrites && simulationChanged && (valueChanged || filterRejection);
         };
-        auto customUpdatePositionFromNetwork = [this, shouldUpdate, lastEdited](glm::vec3 value){
-            if (shouldUpdate(_lastUpdatedPositionTimestamp, value != _lastUpdatedPositionValue)) {
+        // nothing is updated unless others overwrite, so they are only kept from then on
+        if (otherOverwrites && !_lastNetworkPhysicsUpdates) {
+            _lastNetworkPhysicsUpdates.reset(new NetworkPhysicsUpdates());
+        }
+        NetworkPhysicsUpdates* updates = _lastNetworkPhysicsUpdates.get();
+
+        auto customUpdatePositionFromNetwork = [this, updates, shouldUpdate, lastEdited](glm::vec3 value){
+            if (updates && shouldUpdate(updates->positionTimestamp, value != updates->positionValue)) {
                 updatePositionFromNetwork(value);
-                _lastUpdatedPositionTimestamp = lastEdited;
-                _lastUpdatedPositionValue = value;
+                updates->positionTimestamp = lastEdited;
+                updates->positionValue = value;
             }
         };
 
-        auto customUpdateRotationFromNetwork = [this, shouldUpdate, lastEdited](glm::quat value){
-            if (shouldUpdate(_lastUpdatedRotationTimestamp, value != _lastUpdatedRotationValue)) {
+        auto customUpdateRotationFromNetwork = [this, updates, shouldUpdate, lastEdited](glm::quat value){
+            if (updates && shouldUpdate(updates->rotationTimestamp, value != updates->rotationValue)) {
                 updateRotationFromNetwork(value);
-                _lastUpdatedRotationTimestamp = lastEdited;
-                _lastUpdatedRotationValue = value;
+                updates->rotationTimestamp = lastEdited;
+                updates->rotationValue = value;
             }
         };
 
-        auto customUpdateVelocityFromNetwork = [this, shouldUpdate, lastEdited](glm::vec3 value){
-             if (shouldUpdate(_lastUpdatedVelocityTimestamp, value != _lastUpdatedVelocityValue)) {
+        auto customUpdateVelocityFromNetwork = [this, updates, shouldUpdate, lastEdited](glm::vec3 value){
+             if (updates && shouldUpdate(updates->velocityTimestamp, value != updates->velocityValue)) {
                 updateVelocityFromNetwork(value);
-                _lastUpdatedVelocityTimestamp = lastEdited;
-                _lastUpdatedVelocityValue = value;
+                updates->velocityTimestamp = lastEdited;
+                updates->velocityValue = value;
             }
         };
 
-        auto customUpdateAngularVelocityFromNetwork = [this, shouldUpdate, lastEdited](glm::vec3 value){
-            if (shouldUpdate(_lastUpdatedAngularVelocityTimestamp, value != _lastUpdatedAngularVelocityValue)) {
+        auto customUpdateAngularVelocityFromNetwork = [this, updates, shouldUpdate, lastEdited](glm::vec3 value){
+            if (updates && shouldUpdate(updates->angularVelocityTimestamp, value != updates->angularVelocityValue)) {
                 updateAngularVelocityFromNetwork(value);
-                _lastUpdatedAngularVelocityTimestamp = lastEdited;
-                _lastUpdatedAngularVelocityValue = value;
+                updates->angularVelocityTimestamp = lastEdited;
+                updates->angularVelocityValue = value;
             }
         };
 
-        auto customSetAcceleration = [this, shouldUpdate, lastEdited](glm::vec3 value){
-            if (shouldUpdate(_lastUpdatedAccelerationTimestamp, value != _lastUpdatedAccelerationValue)) {
+        auto customSetAcceleration = [this, updates, shouldUpdate, lastEdited](glm::vec3 value){
+            if (updates && shouldUpdate(updates->accelerationTimestamp, value != updates->accelerationValue)) {
                 setAcceleration(value);
-                _lastUpdatedAccelerationTimestamp = lastEdited;
-                _lastUpdatedAccelerationValue = value;
+                updates->accelerationTimestamp = lastEdited;
+                updates->accelerationValue = value;
             }
         };
 
@@ -2465,6 +2471,14 @@ void EntityItem::requiresRecalcBoxes() {
         _recalcMinAACube = true; 
         _recalcMaxAACube = true;
     });
+
+    // once, until the tree has refit its pick hierarchy to the new bounds
+    if (!_pickBoundsChanged.load(std::memory_order_relaxed)) {
+        EntityTreePointer tree = getTree();
+        if (tree && !_pickBoundsChanged.exchange(true)) {
+            tree->entityBoundsChanged(getThisPointer());
+        }
+    }
 }
 
 QString EntityItem::getHref() const {
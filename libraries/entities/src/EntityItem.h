@@ -12,6 +12,7 @@
 #ifndef hifi_EntityItem_h
 #define hifi_EntityItem_h
 
+#include <atomic>
 #include <memory>
 #include <stdint.h>
 
@@ -181,6 +182,9 @@ public:
 
     void requiresRecalcBoxes();
 
+    // raised as the bounds change, until the pick hierarchy of the tree refits to them, see EntityBVH
+    void clearPickBoundsChanged() { _pickBoundsChanged = false; }
+
     // Hyperlink related getters and setters
     QString getHref() const;
     void setHref(QString value);
@@ -498,6 +502,7 @@ protected:
     mutable bool _recalcAABox { true };
     mutable bool _recalcMinAACube { true };
     mutable bool _recalcMaxAACube { true };
+    std::atomic<bool> _pickBoundsChanged { false };
 
     float _localRenderAlpha;
     float _density { ENTITY_ITEM_DEFAULT_DENSITY }; // kg/m^3
@@ -532,10 +537,10 @@ protected:
     uint8_t _collisionMask { ENTITY_COLLISION_MASK_DEFAULT };
     bool _dynamic;
     bool _locked;
+    bool _shouldHighlight { false };
     QString _userData;
     SimulationOwner _simulationOwner;
     QString _marketplaceID;
-    bool _shouldHighlight { false };
     QString _name;
     QString _href; //Hyperlink href
     QString _description; //Hyperlink description
@@ -593,18 +598,22 @@ protected:
     QUuid _owningAvatarID;
 
     // physics related changes from the network to suppress any duplicates and make
-    // sure redundant applications are idempotent
-    glm::vec3 _lastUpdatedPositionValue;
-    glm::quat _lastUpdatedRotationValue;
-    glm::vec3 _lastUpdatedVelocityValue;
-    glm::vec3 _lastUpdatedAngularVelocityValue;
-    glm::vec3 _lastUpdatedAccelerationValue;
-
-    quint64 _lastUpdatedPositionTimestamp { 0 };
-    quint64 _lastUpdatedRotationTimestamp { 0 };
-    quint64 _lastUpdatedVelocityTimestamp { 0 };
-    quint64 _lastUpdatedAngularVelocityTimestamp { 0 };
-    quint64 _lastUpdatedAccelerationTimestamp { 0 };
+    // sure redundant applications are idempotent, only allocated for the entities that are sent them, so not
+    // for any of those of the entity server
+    struct NetworkPhysicsUpdates {
+        glm::vec3 positionValue;
+        glm::quat rotationValue;
+        glm::vec3 velocityValue;
+        glm::vec3 angularVelocityValue;
+        glm::vec3 accelerationValue;
+
+        quint64 positionTimestamp { 0 };
+        quint64 rotationTimestamp { 0 };
+        quint64 velocityTimestamp { 0 };
+        quint64 angularVelocityTimestamp { 0 };
+        quint64 accelerationTimestamp { 0 };
+    };
+    std::unique_ptr<NetworkPhysicsUpdates> _lastNetworkPhysicsUpdates;
 
     quint64 _fadeStartTime { usecTimestampNow() };
     static std::function<bool()> _entitiesShouldFadeFunction;
@@ -18,6 +18,8 @@
 #include "EntityItemID.h"
 #include <RegisteredMetaTypes.h>
 
+// propertiesDidntFit always starts out as requestedProperties and only has flags removed from it, so a property that
+// wasn't requested is never in it, and the only work done for the (usually many) unrequested properties is the test
 #define APPEND_ENTITY_PROPERTY(P,V) \
         if (requestedProperties.getHasProperty(P)) {                \
             LevelDetails propertyLevel = packetData->startLevel();  \
@@ -31,8 +33,6 @@
                 packetData->discardLevel(propertyLevel);            \
                 appendState = OctreeElement::PARTIAL;               \
             }                                                       \
-        } else {                                                    \
-            propertiesDidntFit -= P;                                \
         }
 
 #define READ_ENTITY_PROPERTY(P,T,S)                                                \
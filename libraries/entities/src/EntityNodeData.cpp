@@ -28,3 +28,26 @@ bool EntityNodeData::isEntityFlaggedAsExtra(const QUuid& entityID) const {
 
     return false;
 }
+
+bool EntityNodeData::hasKnownEntityVersion(const QUuid& entityID, quint64 lastChangedOnServer) const {
+    auto it = _knownEntityVersions.constFind(entityID);
+    return it != _knownEntityVersions.constEnd() && it.value() == lastChangedOnServer;
+}
+
+void EntityNodeData::sentEntityVersion(const QUuid& entityID, quint64 lastChangedOnServer) {
+    std::lock_guard<std::mutex> lock(_sentEntityVersionsMutex);
+    _sentEntityVersions[entityID] = lastChangedOnServer;
+}
+
+void EntityNodeData::sceneEnded(bool completed) {
+    std::lock_guard<std::mutex> lock(_sentEntityVersionsMutex);
+
+    // an entity encoded into a level that was later discarded is encoded again before its scene completes, but an
+    // abandoned scene may not have sent everything it encoded
+    if (completed) {
+        for (auto it = _sentEntityVersions.cbegin(); it != _sentEntityVersions.cend(); ++it) {
+            _knownEntityVersions[it.key()] = it.value();
+        }
+    }
+    _sentEntityVersions.clear();
+}
@@ -12,6 +12,9 @@
 #ifndef hifi_EntityNodeData_h
 #define hifi_EntityNodeData_h
 
+#include <limits>
+#include <mutex>
+
 #include <udt/PacketHeaders.h>
 
 #include <OctreeQueryNode.h>
@@ -21,14 +24,21 @@ namespace EntityJSONQueryProperties {
     static const QString FLAGS_PROPERTY = "flags";
     static const QString INCLUDE_ANCESTORS_PROPERTY = "includeAncestors";
     static const QString INCLUDE_DESCENDANTS_PROPERTY = "includeDescendants";
+    // the radius of the keyhole of a node that lets go of the entities outside of it, so none of them are taken to be
+    // ones it still has when they come back in
+    static const QString REGION_OF_INTEREST_PROPERTY = "regionOfInterest";
 }
 
 class EntityNodeData : public OctreeQueryNode {
 public:
     virtual PacketType getMyPacketType() const override { return PacketType::EntityData; }
 
-    quint64 getLastDeletedEntitiesSentAt() const { return _lastDeletedEntitiesSentAt; }
-    void setLastDeletedEntitiesSentAt(quint64 sentAt) { _lastDeletedEntitiesSentAt = sentAt; }
+    // the index in the tree's log of deletes of the first one this node hasn't been sent, see
+    // EntityTree::getRecentlyDeletedEntitiesEnd(), until the first send the deletes from before the node came along
+    // aren't for it
+    static const quint64 NO_DELETED_ENTITIES_CURSOR = std::numeric_limits<quint64>::max();
+    quint64 getDeletedEntitiesCursor() const { return _deletedEntitiesCursor; }
+    void setDeletedEntitiesCursor(quint64 cursor) { _deletedEntitiesCursor = cursor; }
     
     // these can only be called from the OctreeSendThread for the given Node
     void insertSentFilteredEntity(const QUuid& entityID) { _sentFilteredEntities.insert(entityID); }
@@ -44,11 +54,24 @@ public:
     bool isEntityFlaggedAsExtra(const QUuid& entityID) const;
     void resetFlaggedExtraEntities() { _previousFlaggedExtraEntities = _flaggedExtraEntities; _flaggedExtraEntities.clear(); }
 
+    // the node keeps every entity it has been sent, so once a scene with an entity in it has been completely sent,
+    // re-sending that scene (as happens every time the view settles) only needs the entities changed since then
+    bool hasKnownEntityVersion(const QUuid& entityID, quint64 lastChangedOnServer) const;
+
+    // may be called from the parallel encode jobs, the versions only become known when the scene completes
+    void sentEntityVersion(const QUuid& entityID, quint64 lastChangedOnServer);
+
+    virtual void sceneEnded(bool completed) override;
+
 private:
-    quint64 _lastDeletedEntitiesSentAt { usecTimestampNow() };
+    quint64 _deletedEntitiesCursor { NO_DELETED_ENTITIES_CURSOR };
     QSet<QUuid> _sentFilteredEntities;
     QHash<QUuid, QSet<QUuid>> _flaggedExtraEntities;
     QHash<QUuid, QSet<QUuid>> _previousFlaggedExtraEntities;
+
+    QHash<QUuid, quint64> _knownEntityVersions; // only touched by the OctreeSendThread between encodes
+    std::mutex _sentEntityVersionsMutex;
+    QHash<QUuid, quint64> _sentEntityVersions;
 };
 
 #endif // hifi_EntityNodeData_h
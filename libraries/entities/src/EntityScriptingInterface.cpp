@@ -16,6 +16,7 @@
 
 #include <QFutureWatcher>
 #include <QtConcurrent/QtConcurrentRun>
+#include <QtScript/QScriptValueIterator>
 
 #include <shared/QtHelpers.h>
 #include <VariantMapToScriptValue.h>
@@ -272,6 +273,28 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
     return getEntityProperties(identity, noSpecificProperties);
 }
 
+static EntityItemProperties getScriptSideProperties(const EntityItemPointer& entity, EntityPropertyFlags desiredProperties) {
+    if (desiredProperties.getHasProperty(PROP_POSITION) ||
+        desiredProperties.getHasProperty(PROP_ROTATION) ||
+        desiredProperties.getHasProperty(PROP_LOCAL_POSITION) ||
+        desiredProperties.getHasProperty(PROP_LOCAL_ROTATION)) {
+        // if we are explicitly getting position or rotation, we need parent information to make sense of them.
+        desiredProperties.setHasProperty(PROP_PARENT_ID);
+        desiredProperties.setHasProperty(PROP_PARENT_JOINT_INDEX);
+    }
+
+    if (desiredProperties.isEmpty()) {
+        // these are left out of EntityItem::getEntityProperties so that localPosition and localRotation
+        // don't end up in json saves, etc.  We still want them here, though.
+        EncodeBitstreamParams params; // unknown
+        desiredProperties = entity->getEntityProperties(params);
+        desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
+        desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
+    }
+
+    return entity->getProperties(desiredProperties);
+}
+
 EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identity, EntityPropertyFlags desiredProperties) {
     PROFILE_RANGE(script_entities, __FUNCTION__);
 
@@ -280,30 +303,35 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
         _entityTree->withReadLock([&] {
             EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(identity));
             if (entity) {
-                if (desiredProperties.getHasProperty(PROP_POSITION) ||
-                    desiredProperties.getHasProperty(PROP_ROTATION) ||
-                    desiredProperties.getHasProperty(PROP_LOCAL_POSITION) ||
-                    desiredProperties.getHasProperty(PROP_LOCAL_ROTATION)) {
-                    // if we are explicitly getting position or rotation, we need parent information to make sense of them.
-                    desiredProperties.setHasProperty(PROP_PARENT_ID);
-                    desiredProperties.setHasProperty(PROP_PARENT_JOINT_INDEX);
-                }
+                results = getScriptSideProperties(entity, desiredProperties);
+            }
+        });
+    }
 
-                if (desiredProperties.isEmpty()) {
-                    // these are left out of EntityItem::getEntityProperties so that localPosition and localRotation
-                    // don't end up in json saves, etc.  We still want them here, though.
-                    EncodeBitstreamParams params; // unknown
-                    desiredProperties = entity->getEntityProperties(params);
-                    desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
-                    desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
-                }
+    return convertLocationToScriptSemantics(results);
+}
 
-                results = entity->getProperties(desiredProperties);
+QVector<EntityItemProperties> EntityScriptingInterface::getMultipleEntityProperties(const QVector<QUuid>& entityIDs,
+                                                                                    EntityPropertyFlags desiredProperties) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    QVector<EntityItemProperties> results(entityIDs.size());
+    if (_entityTree) {
+        // look up every entity under a single hold of the tree lock
+        _entityTree->withReadLock([&] {
+            for (int i = 0; i < entityIDs.size(); ++i) {
+                EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(entityIDs[i]));
+                if (entity) {
+                    results[i] = getScriptSideProperties(entity, desiredProperties);
+                }
             }
         });
     }
 
-    return convertLocationToScriptSemantics(results);
+    for (auto& properties : results) {
+        properties = convertLocationToScriptSemantics(properties);
+    }
+    return results;
 }
 
 QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties& scriptSideProperties) {
@@ -482,6 +510,41 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
     return id;
 }
 
+QVector<QUuid> EntityScriptingInterface::editEntities(const QScriptValue& entityIDsToProperties) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    QVector<QUuid> results;
+    auto editAll = [&] {
+        QScriptValueIterator it(entityIDsToProperties);
+        while (it.hasNext()) {
+            it.next();
+            QUuid id(it.name());
+            if (id.isNull()) {
+                qCWarning(entities) << "editEntities ignoring invalid entity ID" << it.name();
+                continue;
+            }
+
+            EntityItemProperties properties;
+            EntityItemPropertiesFromScriptValueHonorReadOnly(it.value(), properties);
+            QUuid editedID = editEntity(id, properties);
+            if (!editedID.isNull()) {
+                results.push_back(editedID);
+            }
+        }
+    };
+
+    // the tree lock is recursive, so holding it across the batch keeps each editEntity from taking it again
+    if (_entityTree) {
+        _entityTree->withWriteLock(editAll);
+    } else {
+        editAll();
+    }
+
+    // release the batch together, packed into as few packets as it fits in, rather than as the pending packets fill
+    getEntityPacketSender()->releaseQueuedMessages();
+    return results;
+}
+
 void EntityScriptingInterface::deleteEntity(QUuid id) {
     PROFILE_RANGE(script_entities, __FUNCTION__);
 
@@ -697,6 +760,30 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionBlock
     return findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entitiesToInclude, entitiesToDiscard);
 }
 
+QVector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersections(const QVector<PickRay>& rays,
+                bool precisionPicking, const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard,
+                bool visibleOnly, bool collidableOnly) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    QVector<EntityItemID> entitiesToInclude = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
+    QVector<EntityItemID> entitiesToDiscard = qVectorEntityItemIDFromScriptValue(entityIdsToDiscard);
+    QVector<RayToEntityIntersectionResult> results;
+    results.reserve(rays.size());
+    auto findAll = [&] {
+        for (const auto& ray : rays) {
+            // the tree lock is recursive, each ray takes it again without waiting
+            results.push_back(findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entitiesToInclude,
+                                                        entitiesToDiscard, visibleOnly, collidableOnly));
+        }
+    };
+    if (_entityTree) {
+        _entityTree->withReadLock(findAll);
+    } else {
+        findAll();
+    }
+    return results;
+}
+
 RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorker(const PickRay& ray,
         Octree::lockType lockType, bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude,
         const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly) {
@@ -718,6 +805,98 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorke
     return result;
 }
 
+void EntityScriptingInterface::findRayIntersectionAsync(const PickRay& ray, QScriptValue callback, bool precisionPicking,
+                const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard,
+                bool visibleOnly, bool collidableOnly) {
+    if (!callback.isFunction()) {
+        qCWarning(entities) << "Entities.findRayIntersectionAsync() needs a callback function";
+        return;
+    }
+    RayPick pick { ray, precisionPicking, qVectorEntityItemIDFromScriptValue(entityIdsToInclude),
+        qVectorEntityItemIDFromScriptValue(entityIdsToDiscard), visibleOnly, collidableOnly, callback };
+    std::lock_guard<std::mutex> lock(_picksLock);
+    _rayPicks.push_back(pick);
+    schedulePicks();
+}
+
+void EntityScriptingInterface::findEntitiesAsync(const glm::vec3& center, float radius, QScriptValue callback) {
+    if (!callback.isFunction()) {
+        qCWarning(entities) << "Entities.findEntitiesAsync() needs a callback function";
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_picksLock);
+    _spherePicks.push_back({ center, radius, callback });
+    schedulePicks();
+}
+
+void EntityScriptingInterface::schedulePicks() {
+    // called with _picksLock held, the picks asked for by every script until then go in one batch
+    if (!_picksScheduled) {
+        _picksScheduled = true;
+        QMetaObject::invokeMethod(this, "runPicks", Qt::QueuedConnection);
+    }
+}
+
+void EntityScriptingInterface::runPicks() {
+    auto rayPicks = std::make_shared<std::vector<RayPick>>();
+    auto spherePicks = std::make_shared<std::vector<SpherePick>>();
+    {
+        std::lock_guard<std::mutex> lock(_picksLock);
+        rayPicks->swap(_rayPicks);
+        spherePicks->swap(_spherePicks);
+        _picksScheduled = false;
+    }
+
+    auto rayResults = std::make_shared<QVector<RayToEntityIntersectionResult>>();
+    auto sphereResults = std::make_shared<QVector<QVector<QUuid>>>();
+    EntityTreePointer tree = _entityTree;
+    QFuture<void> future = QtConcurrent::run([this, tree, rayPicks, spherePicks, rayResults, sphereResults] {
+        PROFILE_RANGE(script_entities, "runPicks");
+        rayResults->reserve((int)rayPicks->size());
+        sphereResults->reserve((int)spherePicks->size());
+        auto findAll = [&] {
+            for (const auto& pick : *rayPicks) {
+                // the tree lock is recursive, each ray takes it again without waiting
+                rayResults->push_back(findRayIntersectionWorker(pick.ray, Octree::Lock, pick.precisionPicking,
+                    pick.entityIdsToInclude, pick.entityIdsToDiscard, pick.visibleOnly, pick.collidableOnly));
+            }
+            for (const auto& pick : *spherePicks) {
+                QVector<QUuid> entityIDs;
+                if (tree) {
+                    QVector<EntityItemPointer> entities;
+                    tree->findEntities(pick.center, pick.radius, entities);
+                    for (const auto& entity : entities) {
+                        entityIDs << entity->getEntityItemID();
+                    }
+                }
+                sphereResults->push_back(entityIDs);
+            }
+        };
+        if (tree) {
+            tree->withReadLock(findAll);
+        } else {
+            findAll();
+        }
+    });
+
+    // each result goes back to the thread of the script that asked for it
+    auto watcher = new QFutureWatcher<void>();
+    connect(watcher, &QFutureWatcher<void>::finished, watcher, &QObject::deleteLater);
+    for (int i = 0; i < (int)rayPicks->size(); ++i) {
+        QScriptValue callback = (*rayPicks)[i].callback;
+        connect(watcher, &QFutureWatcher<void>::finished, callback.engine(), [callback, rayResults, i]() mutable {
+            callback.call(QScriptValue(), { callback.engine()->toScriptValue(rayResults->at(i)) });
+        });
+    }
+    for (int i = 0; i < (int)spherePicks->size(); ++i) {
+        QScriptValue callback = (*spherePicks)[i].callback;
+        connect(watcher, &QFutureWatcher<void>::finished, callback.engine(), [callback, sphereResults, i]() mutable {
+            callback.call(QScriptValue(), { callback.engine()->toScriptValue(sphereResults->at(i)) });
+        });
+    }
+    watcher->setFuture(future);
+}
+
 bool EntityScriptingInterface::reloadServerScripts(QUuid entityID) {
     auto client = DependencyManager::get<EntityScriptClient>();
     return client->reloadServerScript(entityID);
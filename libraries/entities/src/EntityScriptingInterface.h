@@ -14,6 +14,9 @@
 #ifndef hifi_EntityScriptingInterface_h
 #define hifi_EntityScriptingInterface_h
 
+#include <mutex>
+#include <vector>
+
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
 #include <QtQml/QJSValue>
@@ -160,6 +163,20 @@ public slots:
     Q_INVOKABLE EntityItemProperties getEntityProperties(QUuid entityID);
     Q_INVOKABLE EntityItemProperties getEntityProperties(QUuid identity, EntityPropertyFlags desiredProperties);
 
+    /**jsdoc
+     * Return the properties for each of the specified {EntityID}s, in the same order. This looks up all of the
+     * entities at once, so it is much cheaper than calling getEntityProperties for each of them.
+     *
+     * @function Entities.getMultipleEntityProperties
+     * @param {EntityID[]} entityIDs The IDs of the entities to get the properties of.
+     * @param {EntityPropertyFlags} [desiredProperties=[]] Array containing the names of the properties you
+     *     would like to get. If the array is empty, all properties will be returned.
+     * @return {EntityItemProperties[]} The entity properties for each entity, with no properties set for an unknown
+     *     entity.
+     */
+    Q_INVOKABLE QVector<EntityItemProperties> getMultipleEntityProperties(const QVector<QUuid>& entityIDs,
+        EntityPropertyFlags desiredProperties = EntityPropertyFlags());
+
     /**jsdoc
      * Updates an entity with the specified properties.
      *
@@ -168,6 +185,16 @@ public slots:
      */
     Q_INVOKABLE QUuid editEntity(QUuid entityID, const EntityItemProperties& properties);
 
+    /**jsdoc
+     * Updates a number of entities at once, as though editEntity was called for each of them, and sends all of the
+     * edits to the server together.
+     *
+     * @function Entities.editEntities
+     * @param {Object} entityIDsToProperties An object with an {EntityItemProperties} value for each {EntityID} key.
+     * @return {EntityID[]} The EntityIDs of the entities that were successfully edited.
+     */
+    Q_INVOKABLE QVector<QUuid> editEntities(const QScriptValue& entityIDsToProperties);
+
     /**jsdoc
      * Deletes an entity.
      *
@@ -233,6 +260,23 @@ public slots:
     /// order to return an accurate result
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
 
+    /// Determines the intersections of several rays at once, as findRayIntersection does for each of them, locking the
+    /// entities once for all of them. The results are in the order of the rays.
+    Q_INVOKABLE QVector<RayToEntityIntersectionResult> findRayIntersections(const QVector<PickRay>& rays,
+        bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(),
+        const QScriptValue& entityIdsToDiscard = QScriptValue(), bool visibleOnly = false, bool collidableOnly = false);
+
+    /// Determines a ray intersection as findRayIntersection does, without waiting on the entities. The picks asked
+    /// for until the next turn of the main thread are found together on a worker thread, then callback(result) is
+    /// called in the thread of the script.
+    Q_INVOKABLE void findRayIntersectionAsync(const PickRay& ray, QScriptValue callback, bool precisionPicking = false,
+        const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue(),
+        bool visibleOnly = false, bool collidableOnly = false);
+
+    /// Finds the entities within a sphere as findEntities does, picked with the ray intersections above, then calls
+    /// callback(entityIDs) in the thread of the script.
+    Q_INVOKABLE void findEntitiesAsync(const glm::vec3& center, float radius, QScriptValue callback);
+
     Q_INVOKABLE bool reloadServerScripts(QUuid entityID);
 
     /**jsdoc
@@ -394,6 +438,9 @@ protected:
         std::lock_guard<std::recursive_mutex> lock(_entitiesScriptEngineLock);
         function(_entitiesScriptEngine);
     };
+private slots:
+    void runPicks();
+
 private:
     bool actionWorker(const QUuid& entityID, std::function<bool(EntitySimulationPointer, EntityItemPointer)> actor);
     bool polyVoxWorker(QUuid entityID, std::function<bool(PolyVoxEntityItem&)> actor);
@@ -409,6 +456,30 @@ private:
         bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
         bool visibleOnly = false, bool collidableOnly = false);
 
+    struct RayPick {
+        PickRay ray;
+        bool precisionPicking;
+        QVector<EntityItemID> entityIdsToInclude;
+        QVector<EntityItemID> entityIdsToDiscard;
+        bool visibleOnly;
+        bool collidableOnly;
+        QScriptValue callback;
+    };
+
+    struct SpherePick {
+        glm::vec3 center;
+        float radius;
+        QScriptValue callback;
+    };
+
+    void schedulePicks();
+
+    // the async picks asked for since the last batch
+    std::mutex _picksLock;
+    std::vector<RayPick> _rayPicks;
+    std::vector<SpherePick> _spherePicks;
+    bool _picksScheduled { false };
+
     EntityTreePointer _entityTree;
 
     std::recursive_mutex _entitiesScriptEngineLock;
@@ -9,16 +9,21 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <AACube.h>
 
 #include "EntitySimulation.h"
 #include "EntitiesLogging.h"
 #include "MovingEntitiesOperator.h"
 
+// the expiries left over from lifetime changes are dropped all at once when there are more of them than this
+// and than there are mortal entities
+static const size_t MIN_STALE_EXPIRIES_TO_COMPACT = 64;
+
 void EntitySimulation::setEntityTree(EntityTreePointer tree) {
     if (_entityTree && _entityTree != tree) {
-        _mortalEntities.clear();
-        _nextExpiry = quint64(-1);
+        clearMortalEntities();
         _entitiesToUpdate.clear();
         _entitiesToSort.clear();
         _simpleKinematicEntities.clear();
@@ -91,30 +96,48 @@ void EntitySimulation::changeEntityInternal(EntityItemPointer entity) {
     }
 }
 
+void EntitySimulation::addMortalEntity(const EntityItemPointer& entity) {
+    _mortalEntities.insert(entity);
+    if (_expiries.size() > 2 * (size_t)_mortalEntities.size() + MIN_STALE_EXPIRIES_TO_COMPACT) {
+        _expiries.clear();
+        for (auto& mortalEntity : _mortalEntities) {
+            _expiries.push_back({ mortalEntity->getExpiry(), mortalEntity });
+        }
+        std::make_heap(_expiries.begin(), _expiries.end());
+    } else {
+        _expiries.push_back({ entity->getExpiry(), entity });
+        std::push_heap(_expiries.begin(), _expiries.end());
+    }
+}
+
+void EntitySimulation::clearMortalEntities() {
+    _mortalEntities.clear();
+    _expiries.clear();
+}
+
 // protected
 void EntitySimulation::expireMortalEntities(const quint64& now) {
-    if (now > _nextExpiry) {
-        // only search for expired entities if we expect to find one
-        _nextExpiry = quint64(-1);
-        QMutexLocker lock(&_mutex);
-        SetOfEntities::iterator itemItr = _mortalEntities.begin();
-        while (itemItr != _mortalEntities.end()) {
-            EntityItemPointer entity = *itemItr;
-            quint64 expiry = entity->getExpiry();
-            if (expiry < now) {
-                itemItr = _mortalEntities.erase(itemItr);
-                entity->die();
-                prepareEntityForDelete(entity);
-            } else {
-                if (expiry < _nextExpiry) {
-                    // remember the smallest _nextExpiry so we know when to start the next search
-                    _nextExpiry = expiry;
-                }
-                ++itemItr;
-            }
+    QMutexLocker lock(&_mutex);
+    // only the expiries that are due are looked at
+    while (!_expiries.empty() && _expiries.front().time < now) {
+        std::pop_heap(_expiries.begin(), _expiries.end());
+        Expiry expiry = _expiries.back();
+        _expiries.pop_back();
+
+        EntityItemPointer entity = expiry.entity.lock();
+        if (!entity || !_mortalEntities.contains(entity)) {
+            // it was removed or made immortal since
+            continue;
         }
-        if (_mortalEntities.size() < 1) {
-            _nextExpiry = -1;
+        quint64 entityExpiry = entity->getExpiry();
+        if (entityExpiry < now) {
+            _mortalEntities.remove(entity);
+            entity->die();
+            prepareEntityForDelete(entity);
+        } else if (entityExpiry != expiry.time) {
+            // its lifetime was made longer, this puts an expiry in for it in case the change didn't
+            _expiries.push_back({ entityExpiry, entity });
+            std::push_heap(_expiries.begin(), _expiries.end());
         }
     }
 }
@@ -172,11 +195,7 @@ void EntitySimulation::addEntity(EntityItemPointer entity) {
     assert(entity);
     entity->deserializeActions();
     if (entity->isMortal()) {
-        _mortalEntities.insert(entity);
-        quint64 expiry = entity->getExpiry();
-        if (expiry < _nextExpiry) {
-            _nextExpiry = expiry;
-        }
+        addMortalEntity(entity);
     }
     if (entity->needsToCallUpdate()) {
         _entitiesToUpdate.insert(entity);
@@ -220,11 +239,7 @@ void EntitySimulation::changeEntity(EntityItemPointer entity) {
     if (!wasRemoved) {
         if (dirtyFlags & Simulation::DIRTY_LIFETIME) {
             if (entity->isMortal()) {
-                _mortalEntities.insert(entity);
-                quint64 expiry = entity->getExpiry();
-                if (expiry < _nextExpiry) {
-                    _nextExpiry = expiry;
-                }
+                addMortalEntity(entity);
             } else {
                 _mortalEntities.remove(entity);
             }
@@ -241,8 +256,7 @@ void EntitySimulation::changeEntity(EntityItemPointer entity) {
 
 void EntitySimulation::clearEntities() {
     QMutexLocker lock(&_mutex);
-    _mortalEntities.clear();
-    _nextExpiry = quint64(-1);
+    clearMortalEntities();
     _entitiesToUpdate.clear();
     _entitiesToSort.clear();
     _simpleKinematicEntities.clear();
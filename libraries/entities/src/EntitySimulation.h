@@ -12,6 +12,8 @@
 #ifndef hifi_EntitySimulation_h
 #define hifi_EntitySimulation_h
 
+#include <vector>
+
 #include <QtCore/QObject>
 #include <QSet>
 #include <QVector>
@@ -45,7 +47,7 @@ const int DIRTY_SIMULATION_FLAGS =
 class EntitySimulation : public QObject, public std::enable_shared_from_this<EntitySimulation> {
 Q_OBJECT
 public:
-    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(NULL), _nextExpiry(quint64(-1)) { }
+    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(NULL) { }
     virtual ~EntitySimulation() { setEntityTree(NULL); }
 
     inline EntitySimulationPointer getThisPointer() const {
@@ -110,7 +112,17 @@ protected:
     SetOfEntities _entitiesToDelete; // entities simulation decided needed to be deleted (EntityTree will actually delete)
 
 private:
+    struct Expiry {
+        quint64 time;
+        EntityItemWeakPointer entity;
+
+        // reversed, so that the soonest is on top of a std heap
+        bool operator<(const Expiry& other) const { return time > other.time; }
+    };
+
     void moveSimpleKinematics();
+    void addMortalEntity(const EntityItemPointer& entity);
+    void clearMortalEntities();
 
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
@@ -119,8 +131,9 @@ private:
     // An entity may be in more than one list.
     SetOfEntities _allEntities; // tracks all entities added the simulation
     SetOfEntities _mortalEntities; // entities that have an expiry
-    quint64 _nextExpiry;
-
+    // a min-heap on time of the expiries of _mortalEntities, with an entry left over for an entity until its time comes
+    // whenever it stops being mortal or its lifetime changes
+    std::vector<Expiry> _expiries;
 
     SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
 
@@ -10,6 +10,10 @@
 //
 
 #include "EntityTree.h"
+
+#include <algorithm>
+
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <QtCore/QQueue>
 
@@ -32,32 +36,11 @@
 #include "EntityDynamicFactoryInterface.h"
 
 
-static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
+// persisted entity records are QVariantMaps, so their stream version must never change for existing files
+static const QDataStream::Version PERSIST_RECORD_STREAM_VERSION = QDataStream::Qt_5_6;
 const float EntityTree::DEFAULT_MAX_TMP_ENTITY_LIFETIME = 60 * 60; // 1 hour
 
 
-// combines the ray cast arguments into a single object
-class RayArgs {
-public:
-    // Inputs
-    glm::vec3 origin;
-    glm::vec3 direction;
-    const QVector<EntityItemID>& entityIdsToInclude;
-    const QVector<EntityItemID>& entityIdsToDiscard;
-    bool visibleOnly;
-    bool collidableOnly;
-    bool precisionPicking;
-
-    // Outputs
-    OctreeElementPointer& element;
-    float& distance;
-    BoxFace& face;
-    glm::vec3& surfaceNormal;
-    void** intersectedObject;
-    bool found;
-};
-
-
 EntityTree::EntityTree(bool shouldReaverage) :
     Octree(shouldReaverage)
 {
@@ -78,7 +61,7 @@ void EntityTree::createRootElement() {
 }
 
 OctreeElementPointer EntityTree::createNewElement(unsigned char* octalCode) {
-    auto newElement = EntityTreeElementPointer(new EntityTreeElement(octalCode));
+    auto newElement = EntityTreeElement::makeElement(octalCode);
     newElement->setTree(std::static_pointer_cast<EntityTree>(shared_from_this()));
     return std::static_pointer_cast<OctreeElement>(newElement);
 }
@@ -90,8 +73,9 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     if (_simulation) {
         _simulation->clearEntities();
     }
-    QHash<EntityItemID, EntityItemPointer> localMap;
-    localMap.swap(_entityMap);
+    QVector<EntityItemPointer> localMap = _entityMap.values();
+    _entityMap.clear();
+    _pickBVH.clear();
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
@@ -140,11 +124,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
 }
 
 bool EntityTree::updateEntity(const EntityItemID& entityID, const EntityItemProperties& properties, const SharedNodePointer& senderNode) {
-    EntityItemPointer entity;
-    {
-        QReadLocker locker(&_entityMapLock);
-        entity = _entityMap.value(entityID);
-    }
+    EntityItemPointer entity = _entityMap.value(entityID);
     if (!entity) {
         return false;
     }
@@ -192,6 +172,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                     qCWarning(entities) << "failed to get query-cube for" << entity->getID();
                 }
                 UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
+                theOperator.setWantPruning(!_isEditingUnderReadLock);
                 recurseTreeWithOperator(&theOperator);
                 entity->setProperties(tempProperties);
                 _isDirty = true;
@@ -224,10 +205,11 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                         // so we apply the rules for ownership change:
                         // (1) higher priority wins
                         // (2) equal priority wins if ownership filter has expired except...
+                        // the lockout is the current owner's, a submitted owner has never had an expiry set
                         uint8_t oldPriority = entity->getSimulationPriority();
                         uint8_t newPriority = properties.getSimulationOwner().getPriority();
                         if (newPriority > oldPriority ||
-                             (newPriority == oldPriority && properties.getSimulationOwner().hasExpired())) {
+                             (newPriority == oldPriority && entity->getSimulationOwner().hasExpired())) {
                             simulationBlocked = false;
                         }
                     }
@@ -267,6 +249,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
             newQueryAACube = entity->getQueryAACube();
         }
         UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
+        theOperator.setWantPruning(!_isEditingUnderReadLock);
         recurseTreeWithOperator(&theOperator);
         entity->setProperties(properties);
 
@@ -509,7 +492,6 @@ void EntityTree::deleteEntities(QSet<EntityItemID> entityIDs, bool force, bool i
 }
 
 void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator) {
-    quint64 deletedAt = usecTimestampNow();
     const RemovedEntities& entities = theOperator.getEntities();
     foreach(const EntityToDeleteDetails& details, entities) {
         EntityItemPointer theEntity = details.entity;
@@ -528,8 +510,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
 
         if (getIsServer()) {
             // set up the deleted entities ID
-            QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-            _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            trackRecentlyDeletedEntity(theEntity->getEntityItemID());
         } else {
             // on the client side, we also remember that we deleted this entity, we don't care about the time
             trackDeletedEntity(theEntity->getEntityItemID());
@@ -587,39 +568,32 @@ bool EntityTree::findNearPointOperation(const OctreeElementPointer& element, voi
     return false;
 }
 
-bool findRayIntersectionOp(const OctreeElementPointer& element, void* extraData) {
-    RayArgs* args = static_cast<RayArgs*>(extraData);
-    bool keepSearching = true;
-    EntityTreeElementPointer entityTreeElementPointer = std::dynamic_pointer_cast<EntityTreeElement>(element);
-    if (entityTreeElementPointer->findRayIntersection(args->origin, args->direction, keepSearching,
-        args->element, args->distance, args->face, args->surfaceNormal, args->entityIdsToInclude,
-        args->entityIdsToDiscard, args->visibleOnly, args->collidableOnly, args->intersectedObject, args->precisionPicking)) {
-        args->found = true;
-    }
-    return keepSearching;
-}
-
 bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
                                     QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
                                     bool visibleOnly, bool collidableOnly, bool precisionPicking, 
                                     OctreeElementPointer& element, float& distance,
                                     BoxFace& face, glm::vec3& surfaceNormal, void** intersectedObject,
                                     Octree::lockType lockType, bool* accurateResult) {
-    RayArgs args = { origin, direction, entityIdsToInclude, entityIdsToDiscard,
-            visibleOnly, collidableOnly, precisionPicking,
-            element, distance, face, surfaceNormal,  intersectedObject, false };
     distance = FLT_MAX;
 
+    bool found = false;
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperation(findRayIntersectionOp, &args);
+        _pickBVH.findRayIntersection(origin, direction, distance, [&](const EntityItemPointer& entity, float& bestDistance) {
+            bool keepSearching = true;
+            if (EntityTreeElement::findEntityRayIntersection(entity, origin, direction, keepSearching, element,
+                    bestDistance, face, surfaceNormal, entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly,
+                    intersectedObject, precisionPicking)) {
+                found = true;
+            }
+        });
     }, requireLock);
 
     if (accurateResult) {
         *accurateResult = lockResult; // if user asked to accuracy or result, let them know this is accurate
     }
 
-    return args.found;
+    return found;
 }
 
 
@@ -968,7 +942,67 @@ bool EntityTree::isScriptInWhitelist(const QString& scriptProperty) {
 }
 
 int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
-                                     const SharedNodePointer& senderNode) {
+                                     const SharedNodePointer& senderNode, const OctreeDecodedEdits* decodedEdits) {
+    return processEditPacketDataInternal(message, editData, maxLength, senderNode, false, decodedEdits);
+}
+
+int EntityTree::processEditPacketDataUnderReadLock(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                   const SharedNodePointer& senderNode,
+                                                   const OctreeDecodedEdits* decodedEdits) {
+    return processEditPacketDataInternal(message, editData, maxLength, senderNode, true, decodedEdits);
+}
+
+OctreeDecodedEditsPointer EntityTree::decodeEditPacketData(const ReceivedMessage& message, int position) const {
+    // erases are cheap to read where they are processed
+    PacketType type = message.getType();
+    if (!getIsServer() ||
+            (type != PacketType::EntityAdd && type != PacketType::EntityEdit && type != PacketType::EntityPhysics)) {
+        return nullptr;
+    }
+
+    auto decodedEdits = std::make_shared<DecodedEdits>();
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(message.getRawMessage());
+    int size = (int)message.getSize();
+    while (position < size) {
+        DecodedEdits::Edit edit;
+        edit.editData = data + position;
+        edit.processedBytes = 0;
+        edit.isValid = EntityItemProperties::decodeEntityEditPacket(edit.editData, size - position, edit.processedBytes,
+                                                                    edit.entityItemID, edit.properties);
+        int processedBytes = edit.processedBytes;
+        decodedEdits->edits.push_back(std::move(edit));
+        // whatever follows an edit that doesn't decode is left to be decoded as it is processed
+        if (!decodedEdits->edits.back().isValid || processedBytes <= 0) {
+            break;
+        }
+        position += processedBytes;
+    }
+    return decodedEdits;
+}
+
+bool EntityTree::isInPlaceEdit(const EntityItemPointer& entity, const EntityItemProperties& properties) const {
+    // an edit can be applied under the read lock if updateEntity() won't have to move any entity between elements
+    if (properties.parentIDChanged() || properties.parentJointIndexChanged() || entity->hasChildren()) {
+        return false;
+    }
+
+    EntityTreeElementPointer containingElement = entity->getElement();
+    if (!containingElement) {
+        return false;
+    }
+
+    bool success;
+    AACube queryCube = entity->getQueryAACube(success);
+    if (!success || !containingElement->bestFitBounds(queryCube)) {
+        return false;
+    }
+
+    return !properties.queryAACubeChanged() || containingElement->bestFitBounds(properties.getQueryAACube());
+}
+
+int EntityTree::processEditPacketDataInternal(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                              const SharedNodePointer& senderNode, bool underReadLock,
+                                              const OctreeDecodedEdits* decodedEdits) {
 
     if (!getIsServer()) {
         qCWarning(entities) << "EntityTree::processEditPacketData() should only be called on a server tree.";
@@ -977,6 +1011,12 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
 
     int processedBytes = 0;
     bool isAdd = false;
+
+    // adds and erases always change the structure of the tree
+    if (underReadLock && message.getType() != PacketType::EntityEdit && message.getType() != PacketType::EntityPhysics) {
+        return EDIT_NEEDS_WRITE_LOCK;
+    }
+
     // we handle these types of "edit" packets
     switch (message.getType()) {
         case PacketType::EntityErase: {
@@ -1000,14 +1040,29 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
             bool suppressDisallowedServerScript = false;
             bool isPhysics = message.getType() == PacketType::EntityPhysics;
 
-            _totalEditMessages++;
-
             EntityItemID entityItemID;
             EntityItemProperties properties;
             startDecode = usecTimestampNow();
 
-            bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
-                                                                                entityItemID, properties);
+            bool validEditPacket = false;
+            const DecodedEdits::Edit* decodedEdit = nullptr;
+            if (auto decoded = dynamic_cast<const DecodedEdits*>(decodedEdits)) {
+                auto it = std::find_if(decoded->edits.cbegin(), decoded->edits.cend(), [&](const DecodedEdits::Edit& edit) {
+                    return edit.editData == editData;
+                });
+                if (it != decoded->edits.cend()) {
+                    decodedEdit = &(*it);
+                }
+            }
+            if (decodedEdit) {
+                processedBytes = decodedEdit->processedBytes;
+                validEditPacket = decodedEdit->isValid;
+                entityItemID = decodedEdit->entityItemID;
+                properties = decodedEdit->properties;
+            } else {
+                validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                                               entityItemID, properties);
+            }
             endDecode = usecTimestampNow();
 
             EntityItemPointer existingEntity;
@@ -1022,6 +1077,10 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                 }
             }
 
+            if (underReadLock && (!validEditPacket || !isInPlaceEdit(existingEntity, properties))) {
+                return EDIT_NEEDS_WRITE_LOCK;
+            }
+
             if (validEditPacket && !_entityScriptSourceWhitelist.isEmpty()) {
 
                 bool wasDeletedBecauseOfClientScript = false;
@@ -1038,8 +1097,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
 
                         // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
                         if (isAdd) {
-                            QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                            _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+                            trackRecentlyDeletedEntity(entityItemID);
                             validEditPacket = false;
                             wasDeletedBecauseOfClientScript = true;
                         } else {
@@ -1063,8 +1121,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                             // Make sure we didn't already need to send back a delete because the client script failed
                             // the whitelist check
                             if (!wasDeletedBecauseOfClientScript) {
-                                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+                                trackRecentlyDeletedEntity(entityItemID);
                                 validEditPacket = false;
                             }
                         } else {
@@ -1105,6 +1162,11 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                 }
                 endFilter = usecTimestampNow();
 
+                // the filter may have moved the entity somewhere it no longer fits in its element
+                if (underReadLock && wasChanged && !isInPlaceEdit(existingEntity, properties)) {
+                    return EDIT_NEEDS_WRITE_LOCK;
+                }
+
                 if (existingEntity && !isAdd) {
 
                     if (suppressDisallowedClientScript) {
@@ -1135,7 +1197,16 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                     if (!isPhysics) {
                         properties.setLastEditedBy(senderNode->getUUID());
                     }
-                    updateEntity(entityItemID, properties, senderNode);
+                    if (underReadLock) {
+                        // other edits and traversals only wait on this entity's element, not the whole tree
+                        _isEditingUnderReadLock = true;
+                        existingEntity->getElement()->withWriteLock([&] {
+                            updateEntity(existingEntity, properties, senderNode);
+                        });
+                        _isEditingUnderReadLock = false;
+                    } else {
+                        updateEntity(entityItemID, properties, senderNode);
+                    }
                     existingEntity->markAsChangedOnServer();
                     endUpdate = usecTimestampNow();
                     _totalUpdates++;
@@ -1179,8 +1250,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                         }
                     }
                     if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
-                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+                        trackRecentlyDeletedEntity(entityItemID);
                     }
                 } else {
                     static QString repeatedMessage =
@@ -1192,6 +1262,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
             }
 
 
+            _totalEditMessages++;
             _totalDecodeTime += endDecode - startDecode;
             _totalLookupTime += endLookup - startLookup;
             _totalUpdateTime += endUpdate - startUpdate;
@@ -1352,57 +1423,36 @@ void EntityTree::update() {
     }
 }
 
-quint64 EntityTree::getAdjustedConsiderSince(quint64 sinceTime) {
-    return (sinceTime - DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER);
+void EntityTree::trackRecentlyDeletedEntity(const QUuid& id) {
+    QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+    _recentlyDeletedEntityItemIDs.push_back(id);
 }
 
+quint64 EntityTree::getRecentlyDeletedEntitiesEnd() const {
+    QReadLocker locker(&_recentlyDeletedEntitiesLock);
+    return _recentlyDeletedEntitiesStart + _recentlyDeletedEntityItemIDs.size();
+}
 
-bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
-    quint64 considerEntitiesSince = getAdjustedConsiderSince(sinceTime);
-
-    // we can probably leverage the ordered nature of QMultiMap to do this quickly...
-    bool hasSomethingNewer = false;
+bool EntityTree::hasEntitiesDeletedSince(quint64 cursor) const {
+    return cursor < getRecentlyDeletedEntitiesEnd();
+}
 
+quint64 EntityTree::forEachEntityDeletedSince(quint64 cursor, std::function<void(const QUuid&)> actor) const {
     QReadLocker locker(&_recentlyDeletedEntitiesLock);
-    QMultiMap<quint64, QUuid>::const_iterator iterator = _recentlyDeletedEntityItemIDs.constBegin();
-    while (iterator != _recentlyDeletedEntityItemIDs.constEnd()) {
-        if (iterator.key() > considerEntitiesSince) {
-            hasSomethingNewer = true;
-            break; // if we have at least one item, we don't need to keep searching
-        }
-        ++iterator;
-    }
-
-#ifdef EXTRA_ERASE_DEBUGGING
-    if (hasSomethingNewer) {
-        int elapsed = usecTimestampNow() - considerEntitiesSince;
-        int difference = considerEntitiesSince - sinceTime;
-        qCDebug(entities) << "EntityTree::hasEntitiesDeletedSince() sinceTime:" << sinceTime 
-                    << "considerEntitiesSince:" << considerEntitiesSince << "elapsed:" << elapsed << "difference:" << difference;
+    // a cursor from before the deletes that were forgotten has nothing left to read of them
+    size_t index = cursor > _recentlyDeletedEntitiesStart ? (size_t)(cursor - _recentlyDeletedEntitiesStart) : 0;
+    for (; index < _recentlyDeletedEntityItemIDs.size(); ++index) {
+        actor(_recentlyDeletedEntityItemIDs[index]);
     }
-#endif
-
-    return hasSomethingNewer;
+    return _recentlyDeletedEntitiesStart + _recentlyDeletedEntityItemIDs.size();
 }
 
-// called by the server when it knows all nodes have been sent deleted packets
-void EntityTree::forgetEntitiesDeletedBefore(quint64 sinceTime) {
-    quint64 considerSinceTime = sinceTime - DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER;
-    QSet<quint64> keysToRemove;
+// called by the server with the earliest cursor of the nodes it sends deleted packets to
+void EntityTree::forgetEntitiesDeletedBefore(quint64 cursor) {
     QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-    QMultiMap<quint64, QUuid>::iterator iterator = _recentlyDeletedEntityItemIDs.begin();
-
-    // First find all the keys in the map that are older and need to be deleted
-    while (iterator != _recentlyDeletedEntityItemIDs.end()) {
-        if (iterator.key() <= considerSinceTime) {
-            keysToRemove << iterator.key();
-        }
-        ++iterator;
-    }
-
-    // Now run through the keysToRemove and remove them
-    foreach (quint64 value, keysToRemove) {
-        _recentlyDeletedEntityItemIDs.remove(value);
+    while (_recentlyDeletedEntitiesStart < cursor && !_recentlyDeletedEntityItemIDs.empty()) {
+        _recentlyDeletedEntityItemIDs.pop_front();
+        ++_recentlyDeletedEntitiesStart;
     }
 }
 
@@ -1498,11 +1548,7 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
 }
 
 EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& entityItemID)  /*const*/ {
-    EntityItemPointer entity;
-    {
-        QReadLocker locker(&_entityMapLock);
-        entity = _entityMap.value(entityItemID);
-    }
+    EntityItemPointer entity = _entityMap.value(entityItemID);
     if (entity) {
         return entity->getElement();
     }
@@ -1511,31 +1557,23 @@ EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& en
 
 void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
     EntityItemID id = entity->getEntityItemID();
-    QWriteLocker locker(&_entityMapLock);
-    EntityItemPointer otherEntity = _entityMap.value(id);
-    if (otherEntity) {
+    if (!_entityMap.insert(id, entity)) {
         qCWarning(entities) << "EntityTree::addEntityMapEntry() found pre-existing id " << id;
         assert(false);
-        return;
     }
-    _entityMap.insert(id, entity);
+    _pickBVH.entityAdded(entity);
 }
 
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
-    QWriteLocker locker(&_entityMapLock);
     _entityMap.remove(id);
+    _pickBVH.entityRemoved(id);
 }
 
 void EntityTree::debugDumpMap() {
-    // QHash's are implicitly shared, so we make a shared copy and use that instead.
-    // This way we might be able to avoid both a lock and a true copy.
-    QHash<EntityItemID, EntityItemPointer> localMap(_entityMap);
     qCDebug(entities) << "EntityTree::debugDumpMap() --------------------------";
-    QHashIterator<EntityItemID, EntityItemPointer> i(localMap);
-    while (i.hasNext()) {
-        i.next();
-        qCDebug(entities) << i.key() << ": " << i.value()->getElement().get();
-    }
+    _entityMap.forEach([&](const QUuid& id, const EntityItemPointer& entity) {
+        qCDebug(entities) << id << ": " << entity->getElement().get();
+    });
     qCDebug(entities) << "-----------------------------------------------------";
 }
 
@@ -1778,9 +1816,18 @@ bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer
     if (! entityDescription.contains("Entities")) {
         entityDescription["Entities"] = QVariantList();
     }
+
+    // only copy the properties while holding the lock, so edits can keep being applied while we convert them
+    QVector<EntityItemProperties> snapshot;
+    quint64 lockStart = usecTimestampNow();
+    withReadLock([&] {
+        RecurseOctreeToMapOperator theOperator(snapshot, element, skipThoseWithBadParents);
+        recurseTreeWithOperator(&theOperator);
+    });
+    _lastPersistLockUsecs = usecTimestampNow() - lockStart;
+
     QScriptEngine scriptEngine;
-    RecurseOctreeToMapOperator theOperator(entityDescription, element, &scriptEngine, skipDefaultValues, skipThoseWithBadParents);
-    recurseTreeWithOperator(&theOperator);
+    RecurseOctreeToMapOperator::writeToMap(entityDescription, snapshot, &scriptEngine, skipDefaultValues);
     return true;
 }
 
@@ -1799,22 +1846,108 @@ bool EntityTree::readFromMap(QVariantMap& map) {
 
     bool success = true;
     foreach (QVariant entityVariant, entitiesQList) {
-        // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
         QVariantMap entityMap = entityVariant.toMap();
-        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+        if (!addEntityFromMap(entityMap, scriptEngine)) {
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool EntityTree::addEntityFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine) {
+    // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
+    QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+    EntityItemProperties properties;
+    EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+    EntityItemID entityItemID;
+    if (entityMap.contains("id")) {
+        entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
+    } else {
+        entityItemID = EntityItemID(QUuid::createUuid());
+    }
+
+    EntityItemPointer entity = addEntity(entityItemID, properties);
+    if (!entity) {
+        qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+        return false;
+    }
+    return true;
+}
+
+bool EntityTree::writeToPersistRecords(OctreePersistRecords& records, bool skipThoseWithBadParents) {
+    struct ChangedEntity {
+        EntityItemID id;
+        quint64 lastEdited;
         EntityItemProperties properties;
-        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+    };
 
-        EntityItemID entityItemID;
-        if (entityMap.contains("id")) {
-            entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
-        } else {
-            entityItemID = EntityItemID(QUuid::createUuid());
+    OctreePersistRecords updatedRecords;
+    std::vector<ChangedEntity> changedEntities;
+
+    // under the lock take the records that can be reused, and copy the properties of the entities that changed
+    quint64 lockStart = usecTimestampNow();
+    withReadLock([&] {
+        updatedRecords.reserve(_entityMap.size());
+
+        _entityMap.forEach([&](const QUuid&, const EntityItemPointer& entityItem) {
+            if (skipThoseWithBadParents && !entityItem->isParentIDValid()) {
+                return;  // we weren't able to resolve a parent from _parentID, so don't save this entity.
+            }
+
+            // an entity that is moving changes without its last edited time changing, so it is always re-encoded
+            quint64 lastEdited = entityItem->getLastEdited();
+            auto existing = records.find(entityItem->getEntityItemID());
+            if (existing != records.end() && existing->lastEdited == lastEdited && !entityItem->isMoving()) {
+                updatedRecords.insert(existing.key(), *existing);
+            } else {
+                changedEntities.push_back({ entityItem->getEntityItemID(), lastEdited, entityItem->getProperties() });
+            }
+        });
+    });
+    _lastPersistLockUsecs = usecTimestampNow() - lockStart;
+
+    QScriptEngine scriptEngine;
+    for (const auto& changedEntity : changedEntities) {
+        QVariantMap entityMap =
+            EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, changedEntity.properties).toVariant().toMap();
+
+        OctreePersistRecord& record = updatedRecords[changedEntity.id];
+        record.lastEdited = changedEntity.lastEdited;
+        QDataStream recordStream(&record.data, QIODevice::WriteOnly);
+        recordStream.setVersion(PERSIST_RECORD_STREAM_VERSION);
+        recordStream << entityMap;
+    }
+
+    qCDebug(entities) << "Encoded" << changedEntities.size() << "of" << updatedRecords.size() << "entities for persist";
+
+    // entities that were deleted since the last save are dropped along with the old records
+    records.swap(updatedRecords);
+    return true;
+}
+
+bool EntityTree::readFromPersistRecords(const OctreePersistRecords& records) {
+    if (records.isEmpty()) {
+        // Empty or invalidly formed file.
+        return false;
+    }
+
+    QScriptEngine scriptEngine;
+
+    bool success = true;
+    for (auto it = records.cbegin(); it != records.cend(); ++it) {
+        QDataStream recordStream(it->data);
+        recordStream.setVersion(PERSIST_RECORD_STREAM_VERSION);
+
+        QVariantMap entityMap;
+        recordStream >> entityMap;
+        if (recordStream.status() != QDataStream::Ok) {
+            qCDebug(entities) << "reading persisted Entity failed:" << it.key();
+            success = false;
+            continue;
         }
 
-        EntityItemPointer entity = addEntity(entityItemID, properties);
-        if (!entity) {
-            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+        if (!addEntityFromMap(entityMap, scriptEngine)) {
             success = false;
         }
     }
@@ -12,16 +12,22 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <deque>
+#include <functional>
+#include <vector>
+
 #include <QSet>
 #include <QVector>
 
 #include <Octree.h>
 #include <SpatialParentFinder.h>
+#include <shared/ConcurrentUUIDMap.h>
 
 class EntityTree;
 typedef std::shared_ptr<EntityTree> EntityTreePointer;
 
 
+#include "EntityBVH.h"
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
 
@@ -89,7 +95,12 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const override;
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
-                                      const SharedNodePointer& senderNode) override;
+                                      const SharedNodePointer& senderNode,
+                                      const OctreeDecodedEdits* decodedEdits = nullptr) override;
+    virtual int processEditPacketDataUnderReadLock(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                   const SharedNodePointer& senderNode,
+                                                   const OctreeDecodedEdits* decodedEdits = nullptr) override;
+    virtual OctreeDecodedEditsPointer decodeEditPacketData(const ReceivedMessage& message, int position) const override;
 
     virtual bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
@@ -166,15 +177,14 @@ public:
         return _recentlyDeletedEntityItemIDs.size() > 0;
     }
 
-    bool hasEntitiesDeletedSince(quint64 sinceTime);
-    static quint64 getAdjustedConsiderSince(quint64 sinceTime);
-
-    QMultiMap<quint64, QUuid> getRecentlyDeletedEntityIDs() const { 
-        QReadLocker locker(&_recentlyDeletedEntitiesLock);
-        return _recentlyDeletedEntityItemIDs;
-    }
-
-    void forgetEntitiesDeletedBefore(quint64 sinceTime);
+    // The server side deletes are kept in the order they happened, and each node reads the ones it hasn't been sent
+    // from a cursor of its own, the index in that log of the first of them. Indices stay put as the deletes every
+    // node is past are forgotten.
+    quint64 getRecentlyDeletedEntitiesEnd() const;
+    bool hasEntitiesDeletedSince(quint64 cursor) const;
+    // calls the actor with each ID deleted from the cursor on, with the log locked, and returns the cursor past them
+    quint64 forEachEntityDeletedSince(quint64 cursor, std::function<void(const QUuid&)> actor) const;
+    void forgetEntitiesDeletedBefore(quint64 cursor);
 
     int processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
     int processEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode);
@@ -182,6 +192,11 @@ public:
     EntityTreeElementPointer getContainingElement(const EntityItemID& entityItemID)  /*const*/;
     void addEntityMapEntry(EntityItemPointer entity);
     void clearEntityMapEntry(const EntityItemID& id);
+    // f must not look up entities in the map
+    template <typename F>
+    void forEachEntity(F f) const {
+        _entityMap.forEach([&](const QUuid&, const EntityItemPointer& entity) { f(entity); });
+    }
     void debugDumpMap();
     virtual void dumpTree() override;
     virtual void pruneTree() override;
@@ -192,6 +207,7 @@ public:
                                        float x, float y, float z);
 
     void entityChanged(EntityItemPointer entity);
+    void entityBoundsChanged(const EntityItemPointer& entity) { _pickBVH.entityMoved(entity); }
 
     void emitEntityScriptChanging(const EntityItemID& entityItemID, bool reload);
     void emitEntityServerScriptChanging(const EntityItemID& entityItemID, bool reload);
@@ -208,6 +224,8 @@ public:
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
+    virtual bool writeToPersistRecords(OctreePersistRecords& records, bool skipThoseWithBadParents) override;
+    virtual bool readFromPersistRecords(const OctreePersistRecords& records) override;
 
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
@@ -283,15 +301,41 @@ protected:
     static bool sendEntitiesOperation(const OctreeElementPointer& element, void* extraData);
     static void bumpTimestamp(EntityItemProperties& properties);
 
+    bool addEntityFromMap(QVariantMap& entityMap, QScriptEngine& scriptEngine);
+
+    // the adds and edits of a message with their properties decoded, in the order they are in the message
+    class DecodedEdits : public OctreeDecodedEdits {
+    public:
+        struct Edit {
+            const unsigned char* editData;
+            int processedBytes;
+            bool isValid;
+            EntityItemID entityItemID;
+            EntityItemProperties properties;
+        };
+        std::vector<Edit> edits;
+    };
+
+    int processEditPacketDataInternal(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                      const SharedNodePointer& senderNode, bool underReadLock,
+                                      const OctreeDecodedEdits* decodedEdits);
+    bool isInPlaceEdit(const EntityItemPointer& entity, const EntityItemProperties& properties) const;
+
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
     bool isScriptInWhitelist(const QString& scriptURL);
     
+    // set while an edit is applied with only the tree's read lock, see processEditPacketDataUnderReadLock()
+    bool _isEditingUnderReadLock { false };
+
     QReadWriteLock _newlyCreatedHooksLock;
     QVector<NewlyCreatedEntityHook*> _newlyCreatedHooks;
 
+    void trackRecentlyDeletedEntity(const QUuid& id);
+
     mutable QReadWriteLock _recentlyDeletedEntitiesLock; /// lock of server side recent deletes
-    QMultiMap<quint64, QUuid> _recentlyDeletedEntityItemIDs; /// server side recent deletes
+    std::deque<QUuid> _recentlyDeletedEntityItemIDs; /// server side recent deletes, see getRecentlyDeletedEntitiesEnd()
+    quint64 _recentlyDeletedEntitiesStart { 0 }; /// the index of the first of them in the log
 
     mutable QReadWriteLock _deletedEntitiesLock; /// lock of client side recent deletes
     QSet<QUuid> _deletedEntityItemIDs; /// client side recent deletes
@@ -306,8 +350,9 @@ protected:
         _deletedEntityItemIDs << id;
     }
 
-    mutable QReadWriteLock _entityMapLock;
-    QHash<EntityItemID, EntityItemPointer> _entityMap;
+    // looked up without locking by script calls and edits, see ConcurrentUUIDMap
+    ConcurrentUUIDMap<EntityItem> _entityMap;
+    EntityBVH _pickBVH { _entityMap };
 
     EntitySimulationPointer _simulation;
 
@@ -23,6 +23,11 @@
 #include "EntityTree.h"
 #include "EntityTypes.h"
 
+// the encode pass may bring its own extra encode data, when encoding subtrees in parallel
+static OctreeElementExtraEncodeData* getExtraEncodeData(EntityNodeData* entityNodeData, EncodeBitstreamParams& params) {
+    return params.extraEncodeData ? params.extraEncodeData : &entityNodeData->extraEncodeData;
+}
+
 EntityTreeElement::EntityTreeElement(unsigned char* octalCode) : OctreeElement() {
     init(octalCode);
 };
@@ -31,8 +36,13 @@ EntityTreeElement::~EntityTreeElement() {
     _octreeMemoryUsage -= sizeof(EntityTreeElement);
 }
 
+EntityTreeElementPointer EntityTreeElement::makeElement(unsigned char* octalCode) {
+    // the elements of all the trees share a pool, with their control blocks in the same blocks
+    return std::allocate_shared<EntityTreeElement>(PoolAllocator<EntityTreeElement>(), octalCode);
+}
+
 OctreeElementPointer EntityTreeElement::createNewElement(unsigned char* octalCode) {
-    auto newChild = EntityTreeElementPointer(new EntityTreeElement(octalCode));
+    auto newChild = makeElement(octalCode);
     newChild->setTree(_myTree);
     return newChild;
 }
@@ -55,7 +65,7 @@ void EntityTreeElement::debugExtraEncodeData(EncodeBitstreamParams& params) cons
     auto entityNodeData = static_cast<EntityNodeData*>(params.nodeData);
     assert(entityNodeData);
 
-    OctreeElementExtraEncodeData* extraEncodeData = &entityNodeData->extraEncodeData;
+    OctreeElementExtraEncodeData* extraEncodeData = getExtraEncodeData(entityNodeData, params);
     assert(extraEncodeData); // EntityTrees always require extra encode data on their encoding passes
 
     if (extraEncodeData->contains(this)) {
@@ -72,7 +82,7 @@ void EntityTreeElement::initializeExtraEncodeData(EncodeBitstreamParams& params)
     auto entityNodeData = static_cast<EntityNodeData*>(params.nodeData);
     assert(entityNodeData);
 
-    OctreeElementExtraEncodeData* extraEncodeData = &entityNodeData->extraEncodeData;
+    OctreeElementExtraEncodeData* extraEncodeData = getExtraEncodeData(entityNodeData, params);
 
     assert(extraEncodeData); // EntityTrees always require extra encode data on their encoding passes
     // Check to see if this element yet has encode data... if it doesn't create it
@@ -105,7 +115,7 @@ bool EntityTreeElement::shouldIncludeChildData(int childIndex, EncodeBitstreamPa
     auto entityNodeData = static_cast<EntityNodeData*>(params.nodeData);
     assert(entityNodeData);
 
-    OctreeElementExtraEncodeData* extraEncodeData = &entityNodeData->extraEncodeData;
+    OctreeElementExtraEncodeData* extraEncodeData = getExtraEncodeData(entityNodeData, params);
     assert(extraEncodeData); // EntityTrees always require extra encode data on their encoding passes
     
     if (extraEncodeData->contains(this)) {
@@ -137,7 +147,7 @@ bool EntityTreeElement::alreadyFullyEncoded(EncodeBitstreamParams& params) const
     auto entityNodeData = static_cast<EntityNodeData*>(params.nodeData);
     assert(entityNodeData);
 
-    OctreeElementExtraEncodeData* extraEncodeData = &entityNodeData->extraEncodeData;
+    OctreeElementExtraEncodeData* extraEncodeData = getExtraEncodeData(entityNodeData, params);
     assert(extraEncodeData); // EntityTrees always require extra encode data on their encoding passes
 
     if (extraEncodeData->contains(this)) {
@@ -155,7 +165,7 @@ void EntityTreeElement::updateEncodedData(int childIndex, AppendState childAppen
     auto entityNodeData = static_cast<EntityNodeData*>(params.nodeData);
     assert(entityNodeData);
 
-    OctreeElementExtraEncodeData* extraEncodeData = &entityNodeData->extraEncodeData;
+    OctreeElementExtraEncodeData* extraEncodeData = getExtraEncodeData(entityNodeData, params);
     assert(extraEncodeData); // EntityTrees always require extra encode data on their encoding passes
 
     if (extraEncodeData->contains(this)) {
@@ -183,7 +193,7 @@ void EntityTreeElement::elementEncodeComplete(EncodeBitstreamParams& params) con
     auto entityNodeData = static_cast<EntityNodeData*>(params.nodeData);
     assert(entityNodeData);
 
-    OctreeElementExtraEncodeData* extraEncodeData = &entityNodeData->extraEncodeData;
+    OctreeElementExtraEncodeData* extraEncodeData = getExtraEncodeData(entityNodeData, params);
     assert(extraEncodeData); // EntityTrees always require extra encode data on their encoding passes
     assert(extraEncodeData->contains(this));
 
@@ -262,7 +272,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     Q_ASSERT_X(entityNodeData, "EntityTreeElement::appendElementData", "expected params.nodeData not to be null");
 
     // first, check the params.extraEncodeData to see if there's any partial re-encode data for this element
-    OctreeElementExtraEncodeData* extraEncodeData = &entityNodeData->extraEncodeData;
+    OctreeElementExtraEncodeData* extraEncodeData = getExtraEncodeData(entityNodeData, params);
 
     EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData = NULL;
     bool hadElementExtraData = false;
@@ -316,6 +326,12 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             // so we should assume that means we might have JSON filters to check
             auto jsonFilters = entityNodeData->getJSONParameters();
 
+            // the query cubes are tested against the keyhole a few at a time, as they are needed
+            const int KEYHOLE_BATCH_SIZE = PackedPlanes::BOXES_PER_TEST;
+            AACube batchCubes[KEYHOLE_BATCH_SIZE];
+            int batchFirst = 0;
+            int batchCount = 0;
+            int batchInKeyhole = 0;
 
             for (uint16_t i = 0; i < _entityItems.size(); i++) {
                 EntityItemPointer entity = _entityItems[i];
@@ -325,6 +341,12 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     includeThisEntity = false;
                 }
 
+                // skip what the node already has, filtered queries also send entities that just stopped matching
+                if (includeThisEntity && jsonFilters.isEmpty() &&
+                    entityNodeData->hasKnownEntityVersion(entity->getID(), entity->getLastChangedOnServer())) {
+                    includeThisEntity = false;
+                }
+
                 // if this entity has been updated since our last full send and there are json filters, check them
                 if (includeThisEntity && !jsonFilters.isEmpty()) {
 
@@ -359,9 +381,23 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     // simulation changing what's visible. consider the case where the entity contains an angular velocity
                     // the entity may not be in view and then in view a frame later, let the client side handle it's view
                     // frustum culling on rendering.
+                    if (i >= batchFirst + batchCount) {
+                        batchFirst = i;
+                        batchCount = std::min(KEYHOLE_BATCH_SIZE, _entityItems.size() - i);
+                        int batchKnown = 0;
+                        for (int j = 0; j < batchCount; j++) {
+                            bool success;
+                            batchCubes[j] = _entityItems[i + j]->getQueryAACube(success);
+                            if (success) {
+                                batchKnown |= (1 << j);
+                            }
+                        }
+                        batchInKeyhole = batchKnown & params.viewFrustum.cubesIntersectKeyhole(batchCubes, batchCount);
+                    }
+
                     bool success;
-                    AACube entityCube = entity->getQueryAACube(success);
-                    if (!success || !params.viewFrustum.cubeIntersectsKeyhole(entityCube)) {
+                    const AACube& entityCube = batchCubes[i - batchFirst];
+                    if (!(batchInKeyhole & (1 << (i - batchFirst)))) {
                         includeThisEntity = false; // out of view, don't include it
                     } else {
                         // Check the size of the entity, it's possible that a "too small to see" entity is included in a
@@ -437,6 +473,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                 // If the entity item got completely appended, then we can remove it from the extra encode data
                 if (appendEntityState == OctreeElement::COMPLETED) {
                     entityTreeElementExtraEncodeData->entities.remove(entity->getEntityItemID());
+                    entityNodeData->sentEntityVersion(entity->getID(), entity->getLastChangedOnServer());
                 }
 
                 // If any part of the entity items didn't fit, then the element is considered partial
@@ -637,79 +674,89 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
                                     bool visibleOnly, bool collidableOnly, void** intersectedObject, bool precisionPicking, float distanceToElementCube) {
 
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
-    int entityNumber = 0;
     bool somethingIntersected = false;
     forEachEntity([&](EntityItemPointer entity) {
-        if ( (visibleOnly && !entity->isVisible()) || (collidableOnly && (entity->getCollisionless() || entity->getShapeType() == SHAPE_TYPE_NONE))
-            || (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID()))
-            || (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(entity->getID())) ) {
-            return;
+        if (findEntityRayIntersection(entity, origin, direction, keepSearching, element, distance, face, surfaceNormal,
+                entityIdsToInclude, entityIDsToDiscard, visibleOnly, collidableOnly, intersectedObject, precisionPicking)) {
+            somethingIntersected = true;
         }
+    });
+    return somethingIntersected;
+}
 
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        if (!success) {
-            return;
-        }
+bool EntityTreeElement::findEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin,
+                                    const glm::vec3& direction, bool& keepSearching, OctreeElementPointer& element,
+                                    float& distance, BoxFace& face, glm::vec3& surfaceNormal,
+                                    const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIDsToDiscard,
+                                    bool visibleOnly, bool collidableOnly, void** intersectedObject, bool precisionPicking) {
+    if ( (visibleOnly && !entity->isVisible()) || (collidableOnly && (entity->getCollisionless() || entity->getShapeType() == SHAPE_TYPE_NONE))
+        || (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID()))
+        || (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(entity->getID())) ) {
+        return false;
+    }
 
-        float localDistance;
-        BoxFace localFace;
-        glm::vec3 localSurfaceNormal;
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    if (!success) {
+        return false;
+    }
 
-        // if the ray doesn't intersect with our cube, we can stop searching!
-        if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
-            return;
-        }
+    float localDistance;
+    BoxFace localFace;
+    glm::vec3 localSurfaceNormal;
 
-        // extents is the entity relative, scaled, centered extents of the entity
-        glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-        glm::mat4 translation = glm::translate(entity->getPosition());
-        glm::mat4 entityToWorldMatrix = translation * rotation;
-        glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
-
-        glm::vec3 dimensions = entity->getDimensions();
-        glm::vec3 registrationPoint = entity->getRegistrationPoint();
-        glm::vec3 corner = -(dimensions * registrationPoint);
-
-        AABox entityFrameBox(corner, dimensions);
-
-        glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
-        glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
-
-        // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
-        // and testing intersection there.
-        if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance,
-                                                localFace, localSurfaceNormal)) {
-            if (entityFrameBox.contains(entityFrameOrigin) || localDistance < distance) {
-                // now ask the entity if we actually intersect
-                if (entity->supportsDetailedRayIntersection()) {
-                    if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
-                        localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
-
-                        if (localDistance < distance) {
-                            distance = localDistance;
-                            face = localFace;
-                            surfaceNormal = localSurfaceNormal;
-                            *intersectedObject = (void*)entity.get();
-                            somethingIntersected = true;
-                        }
-                    }
-                } else {
-                    // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
-                    // Never intersect with particle entities
-                    if (localDistance < distance && entity->getType() != EntityTypes::ParticleEffect) {
+    // if the ray doesn't intersect with our cube, we can stop searching!
+    if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
+        return false;
+    }
+
+    // extents is the entity relative, scaled, centered extents of the entity
+    glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+    glm::mat4 translation = glm::translate(entity->getPosition());
+    glm::mat4 entityToWorldMatrix = translation * rotation;
+    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+
+    glm::vec3 dimensions = entity->getDimensions();
+    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+    glm::vec3 corner = -(dimensions * registrationPoint);
+
+    AABox entityFrameBox(corner, dimensions);
+
+    glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
+    glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+
+    // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
+    // and testing intersection there.
+    if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance,
+                                            localFace, localSurfaceNormal)) {
+        if (entityFrameBox.contains(entityFrameOrigin) || localDistance < distance) {
+            // now ask the entity if we actually intersect
+            if (entity->supportsDetailedRayIntersection()) {
+                if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
+                    localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
+
+                    if (localDistance < distance) {
                         distance = localDistance;
                         face = localFace;
-                        surfaceNormal = glm::vec3(rotation * glm::vec4(localSurfaceNormal, 1.0f));
+                        surfaceNormal = localSurfaceNormal;
                         *intersectedObject = (void*)entity.get();
-                        somethingIntersected = true;
+                        return true;
                     }
                 }
+            } else {
+                // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
+                // Never intersect with particle entities
+                if (localDistance < distance && entity->getType() != EntityTypes::ParticleEffect) {
+                    distance = localDistance;
+                    face = localFace;
+                    surfaceNormal = glm::vec3(rotation * glm::vec4(localSurfaceNormal, 1.0f));
+                    *intersectedObject = (void*)entity.get();
+                    return true;
+                }
             }
         }
-        entityNumber++;
-    });
-    return somethingIntersected;
+    }
+    return false;
 }
 
 // TODO: change this to use better bounding shape for entity than sphere
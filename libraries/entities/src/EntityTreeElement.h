@@ -16,6 +16,7 @@
 
 #include <OctreeElement.h>
 #include <QList>
+#include <shared/PoolAllocator.h>
 
 #include "EntityEditPacketSender.h"
 #include "EntityItem.h"
@@ -78,9 +79,12 @@ public:
 
 class EntityTreeElement : public OctreeElement, ReadWriteLockable {
     friend class EntityTree; // to allow createElement to new us...
+    friend class PoolAllocator<EntityTreeElement>; // to allow makeElement to construct us in place
 
     EntityTreeElement(unsigned char* octalCode = NULL);
 
+    static EntityTreeElementPointer makeElement(unsigned char* octalCode = NULL);
+
     virtual OctreeElementPointer createNewElement(unsigned char* octalCode = NULL) override;
 
 public:
@@ -154,6 +158,13 @@ public:
                          BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
                          const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly,
                          void** intersectedObject, bool precisionPicking, float distanceToElementCube);
+
+    // the ray test of one entity, true if it intersects the ray nearer than distance, which it then lowers
+    static bool findEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin,
+                         const glm::vec3& direction, bool& keepSearching, OctreeElementPointer& element, float& distance,
+                         BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
+                         const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly,
+                         void** intersectedObject, bool precisionPicking);
     virtual bool findSpherePenetration(const glm::vec3& center, float radius,
                         glm::vec3& penetration, void** penetratedObject) const override;
 
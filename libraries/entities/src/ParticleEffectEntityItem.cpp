@@ -591,50 +591,30 @@ void ParticleEffectEntityItem::setShapeType(ShapeType type) {
     }
 }
 
-void ParticleEffectEntityItem::integrateParticle(Particle& particle, float deltaTime) {
-    glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * particle.acceleration;
-    glm::vec3 at = particle.acceleration * deltaTime;
-    particle.position += particle.velocity * deltaTime + atSquared;
-    particle.velocity += at;
-}
-
 void ParticleEffectEntityItem::stepSimulation(float deltaTime) {
-    // update particles between head and tail
-    int popCount = 0;
-    for (Particle& particle : _particles) {
-        particle.lifetime += deltaTime;
-
-        // if particle has died.
-        if (particle.lifetime >= _lifespan) {
-            // move head forward
-            popCount++;
-        } else {
-            // Otherwise update it
-            integrateParticle(particle, deltaTime);
-        }
+    quint64 now = _lastSimulated;
+
+    // the particles die in the order they were emitted
+    quint64 lifespanUsecs = (quint64)(_lifespan * USECS_PER_SECOND);
+    while (!_particles.empty() && now - _particles.front().birthTime >= lifespanUsecs) {
+        _particles.pop_front();
     }
-    _particles.erase(_particles.begin(), _particles.begin() + popCount);
 
     // emit new particles, but only if we are emmitting
     if (getIsEmitting() && _emitRate > 0.0f && _lifespan > 0.0f && _polarStart <= _polarFinish) {
 
         float timeLeftInFrame = deltaTime;
         while (_timeUntilNextEmit < timeLeftInFrame) {
-            // overflow! move head forward by one.
-            // because the case of head == tail indicates an empty array, not a full one.
             // This can drop an existing older particle, but this is by design, newer particles are a higher priority.
             if (_particles.size() >= _maxParticles) {
                 _particles.pop_front();
             }
             
-            // emit a new particle at tail index.
+            // emit a new particle, as old as the rest of the frame
             _particles.push_back(createParticle(glm::mix(_previousPosition, getPosition(),
                 (deltaTime - timeLeftInFrame) / deltaTime)));
-            auto particle = _particles.back();
-            particle.lifetime += timeLeftInFrame;
-            
-            // Initialize it
-            integrateParticle(particle, deltaTime);
+            _particles.back().birthTime = now - (quint64)(timeLeftInFrame * USECS_PER_SECOND);
+            ++_particlesEmitted;
             
             // Advance in frame
             timeLeftInFrame -= _timeUntilNextEmit;
@@ -224,18 +224,20 @@ protected:
     
     Particle createParticle(const glm::vec3& position);
     void stepSimulation(float deltaTime);
-    void integrateParticle(Particle& particle, float deltaTime);
     
+    // A particle moves with a constant acceleration from where it was emitted, so where it is at any time follows
+    // from its emission alone: it is never stepped, the renderer moves it.
     struct Particle {
         float seed { 0.0f };
-        float lifetime { 0.0f };
+        quint64 birthTime { 0 }; // usecs
         glm::vec3 position { Vectors::ZERO };
         glm::vec3 velocity { Vectors::ZERO };
         glm::vec3 acceleration { Vectors::ZERO };
     };
     
-    // Particles container
+    // Particles container, oldest first
     Particles _particles;
+    quint64 _particlesEmitted { 0 }; // since the start, the last of them is at the back of _particles
     
     // Particles properties
     rgbColor _color;
@@ -13,16 +13,12 @@
 
 #include "EntityItemProperties.h"
 
-RecurseOctreeToMapOperator::RecurseOctreeToMapOperator(QVariantMap& map,
+RecurseOctreeToMapOperator::RecurseOctreeToMapOperator(QVector<EntityItemProperties>& snapshot,
                                                        const OctreeElementPointer& top,
-                                                       QScriptEngine* engine,
-                                                       bool skipDefaultValues,
                                                        bool skipThoseWithBadParents) :
         RecurseOctreeOperator(),
-        _map(map),
+        _snapshot(snapshot),
         _top(top),
-        _engine(engine),
-        _skipDefaultValues(skipDefaultValues),
         _skipThoseWithBadParents(skipThoseWithBadParents)
 {
     // if some element "top" was given, only save information for that element and its children.
@@ -43,29 +39,36 @@ bool RecurseOctreeToMapOperator::preRecursion(const OctreeElementPointer& elemen
 
 bool RecurseOctreeToMapOperator::postRecursion(const OctreeElementPointer& element) {
 
-    EntityItemProperties defaultProperties;
-
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-    QVariantList entitiesQList = qvariant_cast<QVariantList>(_map["Entities"]);
 
     entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
         if (_skipThoseWithBadParents && !entityItem->isParentIDValid()) {
             return;  // we weren't able to resolve a parent from _parentID, so don't save this entity.
         }
 
-        EntityItemProperties properties = entityItem->getProperties();
-        QScriptValue qScriptValues;
-        if (_skipDefaultValues) {
-            qScriptValues = EntityItemNonDefaultPropertiesToScriptValue(_engine, properties);
-        } else {
-            qScriptValues = EntityItemPropertiesToScriptValue(_engine, properties);
-        }
-        entitiesQList << qScriptValues.toVariant();
+        _snapshot << entityItem->getProperties();
     });
 
-    _map["Entities"] = entitiesQList;
     if (element == _top) {
         _withinTop = false;
     }
     return true;
 }
+
+void RecurseOctreeToMapOperator::writeToMap(QVariantMap& map, const QVector<EntityItemProperties>& snapshot,
+                                            QScriptEngine* engine, bool skipDefaultValues) {
+    QVariantList entitiesQList = qvariant_cast<QVariantList>(map["Entities"]);
+    entitiesQList.reserve(entitiesQList.size() + snapshot.size());
+
+    foreach (const EntityItemProperties& properties, snapshot) {
+        QScriptValue qScriptValues;
+        if (skipDefaultValues) {
+            qScriptValues = EntityItemNonDefaultPropertiesToScriptValue(engine, properties);
+        } else {
+            qScriptValues = EntityItemPropertiesToScriptValue(engine, properties);
+        }
+        entitiesQList << qScriptValues.toVariant();
+    }
+
+    map["Entities"] = entitiesQList;
+}
@@ -11,17 +11,21 @@
 
 #include "EntityTree.h"
 
+// Gathers the properties of the entities in the tree. This only copies properties, so that it can run under the
+// tree lock, and the slow conversion to a map is left to writeToMap() once the lock is released.
 class RecurseOctreeToMapOperator : public RecurseOctreeOperator {
 public:
-    RecurseOctreeToMapOperator(QVariantMap& map, const OctreeElementPointer& top, QScriptEngine* engine, bool skipDefaultValues,
+    RecurseOctreeToMapOperator(QVector<EntityItemProperties>& snapshot, const OctreeElementPointer& top,
                                bool skipThoseWithBadParents);
     bool preRecursion(const OctreeElementPointer& element) override;
     bool postRecursion(const OctreeElementPointer& element) override;
+
+    static void writeToMap(QVariantMap& map, const QVector<EntityItemProperties>& snapshot, QScriptEngine* engine,
+                           bool skipDefaultValues);
+
  private:
-    QVariantMap& _map;
+    QVector<EntityItemProperties>& _snapshot;
     OctreeElementPointer _top;
-    QScriptEngine* _engine;
     bool _withinTop;
-    bool _skipDefaultValues;
     bool _skipThoseWithBadParents;
 };
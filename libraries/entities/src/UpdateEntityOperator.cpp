@@ -260,7 +260,7 @@ bool UpdateEntityOperator::postRecursion(const OctreeElementPointer& element) {
     // 1) we're not removing the old
     // 2) we are removing the old, but this subtree doesn't contain the old
     // 3) we are removing the old, this subtree contains the old, but this element isn't a direct parent of _containingElement
-    if (!_removeOld || !subtreeContainsOld || !element->isParentOf(_containingElement)) {
+    if (_wantPruning && (!_removeOld || !subtreeContainsOld || !element->isParentOf(_containingElement))) {
         EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
         entityTreeElement->pruneChildren(); // take this opportunity to prune any empty leaves
     }
@@ -28,6 +28,10 @@ public:
     virtual bool preRecursion(const OctreeElementPointer& element) override;
     virtual bool postRecursion(const OctreeElementPointer& element) override;
     virtual OctreeElementPointer possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex) override;
+
+    // pruning changes the structure of the tree, which isn't allowed while only holding the tree's read lock
+    void setWantPruning(bool wantPruning) { _wantPruning = wantPruning; }
+
 private:
     EntityTreePointer _tree;
     EntityItemPointer _existingEntity;
@@ -49,6 +53,7 @@ private:
     bool subTreeContainsNewEntity(const OctreeElementPointer& element);
 
     bool _wantDebug;
+    bool _wantPruning { true };
 };
 
 #endif // hifi_UpdateEntityOperator_h
@@ -24,7 +24,13 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+#include <glm/gtx/component_wise.hpp>
 
 
 class Vertex {
@@ -388,6 +394,282 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
     return data.extracted;
 }
 
+// the number of vertices the post transform cache is modeled with, about what current hardware keeps
+static const int VERTEX_CACHE_SIZE = 32;
+
+static float vertexCacheScore(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // used by the last triangle, which of them goes first next is up to the rest of the score
+            score = 0.75f;
+        } else {
+            score = powf(1.0f - (float)(cachePosition - 3) / (VERTEX_CACHE_SIZE - 3), 1.5f);
+        }
+    }
+    // the vertices with few triangles left go first, so that none are left stranded for the end
+    return score + 2.0f / sqrtf((float)remainingTriangles);
+}
+
+// Reorders triangles so that they reuse the vertices their neighbours just transformed, after Tom Forsyth's
+// "Linear-Speed Vertex Cache Optimisation". The triangles are the same, only the order they're drawn in changes.
+static void optimizeTriangleOrder(QVector<int>& indices, int numVertices) {
+    int numTriangles = indices.size() / 3;
+    if (numTriangles < 2 || indices.size() % 3 != 0) {
+        return;
+    }
+    for (int index : indices) {
+        if (index < 0 || index >= numVertices) {
+            return;
+        }
+    }
+
+    // the remaining triangles of each vertex, packed in one array
+    std::vector<int> remainingTriangles(numVertices, 0);
+    for (int index : indices) {
+        ++remainingTriangles[index];
+    }
+    std::vector<int> firstTriangle(numVertices + 1, 0);
+    for (int i = 0; i < numVertices; ++i) {
+        firstTriangle[i + 1] = firstTriangle[i] + remainingTriangles[i];
+    }
+    std::vector<int> vertexTriangles(indices.size());
+    {
+        std::vector<int> filled(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (int i = 0; i < indices.size(); ++i) {
+            vertexTriangles[filled[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<int> cachePositions(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+    for (int i = 0; i < numVertices; ++i) {
+        vertexScores[i] = vertexCacheScore(-1, remainingTriangles[i]);
+    }
+    std::vector<float> triangleScores(numTriangles);
+    std::vector<bool> isAdded(numTriangles, false);
+    int bestTriangle = 0;
+    for (int i = 0; i < numTriangles; ++i) {
+        triangleScores[i] = vertexScores[indices[3 * i]] + vertexScores[indices[3 * i + 1]] +
+            vertexScores[indices[3 * i + 2]];
+        if (triangleScores[i] > triangleScores[bestTriangle]) {
+            bestTriangle = i;
+        }
+    }
+
+    QVector<int> ordered;
+    ordered.reserve(indices.size());
+    std::vector<int> cache;
+    std::vector<int> nextCache;
+    cache.reserve(VERTEX_CACHE_SIZE + 3);
+    nextCache.reserve(VERTEX_CACHE_SIZE + 3);
+    int nextUnadded = 0;
+
+    while (bestTriangle >= 0) {
+        isAdded[bestTriangle] = true;
+        const int* triangle = indices.constData() + 3 * bestTriangle;
+        nextCache.clear();
+        for (int i = 0; i < 3; ++i) {
+            int vertex = triangle[i];
+            ordered.push_back(vertex);
+            if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end()) {
+                nextCache.push_back(vertex);
+            }
+
+            // take the triangle off the ones of the vertex that remain
+            int* first = vertexTriangles.data() + firstTriangle[vertex];
+            int* last = first + remainingTriangles[vertex] - 1;
+            std::iter_swap(std::find(first, last, bestTriangle), last);
+            --remainingTriangles[vertex];
+        }
+
+        // the vertices of the triangle go to the front of the cache, the oldest fall off the back
+        for (int vertex : cache) {
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2]) {
+                nextCache.push_back(vertex);
+            }
+        }
+        cache.swap(nextCache);
+
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < (int)cache.size(); ++i) {
+            int vertex = cache[i];
+            cachePositions[vertex] = (i < VERTEX_CACHE_SIZE) ? i : -1;
+            vertexScores[vertex] = vertexCacheScore(cachePositions[vertex], remainingTriangles[vertex]);
+        }
+        for (int vertex : cache) {
+            for (int i = firstTriangle[vertex]; i < firstTriangle[vertex] + remainingTriangles[vertex]; ++i) {
+                int candidate = vertexTriangles[i];
+                const int* candidateVertices = indices.constData() + 3 * candidate;
+                triangleScores[candidate] = vertexScores[candidateVertices[0]] + vertexScores[candidateVertices[1]] +
+                    vertexScores[candidateVertices[2]];
+                if (triangleScores[candidate] > bestScore) {
+                    bestScore = triangleScores[candidate];
+                    bestTriangle = candidate;
+                }
+            }
+        }
+        if ((int)cache.size() > VERTEX_CACHE_SIZE) {
+            cache.resize(VERTEX_CACHE_SIZE);
+        }
+
+        if (bestTriangle < 0) {
+            // nothing left around the cache, start again from the next triangle in the original order
+            while (nextUnadded < numTriangles && isAdded[nextUnadded]) {
+                ++nextUnadded;
+            }
+            if (nextUnadded < numTriangles) {
+                bestTriangle = nextUnadded;
+            }
+        }
+    }
+
+    indices = ordered;
+}
+
+// Vertex clustering, after Rossignac and Borrel: the vertices in a cell of the grid all become the first of them that a
+// triangle uses, and the triangles left without three different corners are dropped. The vertices are the mesh's own,
+// so the level draws from the same vertex buffer, skin weights and all. A vertex keeps the same one for every part.
+static QVector<int> clusterTriangles(const QVector<int>& indices, const QVector<glm::vec3>& vertices,
+                                     const glm::vec3& origin, float cellSize,
+                                     std::unordered_map<uint64_t, int>& cellVertices, std::vector<int>& clusteredVertices) {
+    const int CELL_COORDINATE_BITS = 21;
+    const int MAX_CELL_COORDINATE = (1 << CELL_COORDINATE_BITS) - 1;
+    auto clusteredVertex = [&](int index) {
+        int& clustered = clusteredVertices[index];
+        if (clustered < 0) {
+            glm::ivec3 cell = glm::clamp(glm::ivec3(glm::floor((vertices[index] - origin) / cellSize)),
+                                         glm::ivec3(0), glm::ivec3(MAX_CELL_COORDINATE));
+            uint64_t key = ((uint64_t)cell.x << (2 * CELL_COORDINATE_BITS)) | ((uint64_t)cell.y << CELL_COORDINATE_BITS) |
+                (uint64_t)cell.z;
+            clustered = cellVertices.emplace(key, index).first->second;
+        }
+        return clustered;
+    };
+
+    QVector<int> clusteredIndices;
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        int a = clusteredVertex(indices[i]);
+        int b = clusteredVertex(indices[i + 1]);
+        int c = clusteredVertex(indices[i + 2]);
+        if (a != b && b != c && c != a) {
+            clusteredIndices << a << b << c;
+        }
+    }
+    return clusteredIndices;
+}
+
+// the meshes with fewer triangles than this are cheap enough to draw as they are at any size
+static const int MIN_TRIANGLES_FOR_LODS = 1000;
+// a level that doesn't take this much of the triangles of the one before it away isn't worth drawing instead of it
+static const float MAX_LOD_TRIANGLE_RATIO = 0.6f;
+
+static void buildLODs(const std::vector<QVector<int>>& partIndices, const QVector<glm::vec3>& vertices,
+                      QVector<int>& lodIndices, std::vector<model::Mesh::LOD>& lods) {
+    int numTriangles = 0;
+    for (const auto& indices : partIndices) {
+        numTriangles += indices.size() / 3;
+    }
+    if (numTriangles < MIN_TRIANGLES_FOR_LODS) {
+        return;
+    }
+    for (const auto& indices : partIndices) {
+        for (int index : indices) {
+            if (index < 0 || index >= vertices.size()) {
+                return;
+            }
+        }
+    }
+
+    glm::vec3 minimum = vertices[0];
+    glm::vec3 maximum = vertices[0];
+    for (const auto& vertex : vertices) {
+        minimum = glm::min(minimum, vertex);
+        maximum = glm::max(maximum, vertex);
+    }
+    float meshSize = glm::compMax(maximum - minimum);
+    if (meshSize <= 0.0f) {
+        return;
+    }
+
+    // as many cells across the mesh for each level, from finest to coarsest
+    const std::vector<int> LOD_CELLS_ACROSS = { 64, 32, 16 };
+    int previousNumTriangles = numTriangles;
+    for (int cellsAcross : LOD_CELLS_ACROSS) {
+        float cellSize = meshSize / (float)cellsAcross;
+        std::unordered_map<uint64_t, int> cellVertices;
+        std::vector<int> clusteredVertices(vertices.size(), -1);
+
+        model::Mesh::LOD lod;
+        lod.cellSize = cellSize;
+        QVector<int> levelIndices;
+        for (const auto& indices : partIndices) {
+            QVector<int> clusteredIndices = clusterTriangles(indices, vertices, minimum, cellSize, cellVertices,
+                                                             clusteredVertices);
+            optimizeTriangleOrder(clusteredIndices, vertices.size());
+            lod.parts.emplace_back(lodIndices.size() + levelIndices.size(), clusteredIndices.size(), 0,
+                                   model::Mesh::TRIANGLES);
+            levelIndices += clusteredIndices;
+        }
+
+        int levelNumTriangles = levelIndices.size() / 3;
+        if (levelNumTriangles > (int)(MAX_LOD_TRIANGLE_RATIO * previousNumTriangles)) {
+            continue;
+        }
+        lodIndices += levelIndices;
+        lods.push_back(lod);
+        previousNumTriangles = levelNumTriangles;
+    }
+}
+
+// Normals and tangents are uploaded as signed normalized bytes, with w at one as the vec3 they replace reads.
+// They are unit vectors, a byte per component is within half a degree of it
+static QVector<uint32_t> packUnitVectors(const QVector<glm::vec3>& vectors) {
+    QVector<uint32_t> packed;
+    packed.reserve(vectors.size());
+    for (const auto& vector : vectors) {
+        packed.push_back(glm::packSnorm4x8(glm::vec4(vector, 1.0f)));
+    }
+    return packed;
+}
+
+// texture coordinates are uploaded as normalized shorts when they are all within the texture, so none of them repeat
+static bool areTexCoordsPackable(const QVector<glm::vec2>& texCoords) {
+    return std::all_of(texCoords.begin(), texCoords.end(), [](const glm::vec2& texCoord) {
+        return texCoord.x >= 0.0f && texCoord.x <= 1.0f && texCoord.y >= 0.0f && texCoord.y <= 1.0f;
+    });
+}
+
+static QVector<uint32_t> packTexCoords(const QVector<glm::vec2>& texCoords) {
+    QVector<uint32_t> packed;
+    packed.reserve(texCoords.size());
+    for (const auto& texCoord : texCoords) {
+        packed.push_back(glm::packUnorm2x16(texCoord));
+    }
+    return packed;
+}
+
+// and colors as normalized bytes when none of them is brighter than white
+static bool areColorsPackable(const QVector<glm::vec3>& colors) {
+    return std::all_of(colors.begin(), colors.end(), [](const glm::vec3& color) {
+        return glm::all(glm::greaterThanEqual(color, glm::vec3(0.0f))) &&
+            glm::all(glm::lessThanEqual(color, glm::vec3(1.0f)));
+    });
+}
+
+static QVector<uint32_t> packColors(const QVector<glm::vec3>& colors) {
+    QVector<uint32_t> packed;
+    packed.reserve(colors.size());
+    for (const auto& color : colors) {
+        packed.push_back(glm::packUnorm4x8(glm::vec4(color, 1.0f)));
+    }
+    return packed;
+}
+
 void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     static QString repeatedMessage = LogHandler::getInstance().addRepeatedMessageRegex("buildModelMesh failed -- .*");
 
@@ -416,12 +698,44 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     gpu::BufferView vbv(vb, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
     mesh->setVertexBuffer(vbv);
 
+    // the attributes are packed to smaller formats where that loses nothing visible, the blended normals of meshes
+    // with blendshapes replace the packed ones with floats while they draw
+    bool areNormalsPacked = fbxMesh.blendshapes.isEmpty();
+    bool areColorsPacked = areColorsPackable(fbxMesh.colors);
+    bool areTexCoordsPacked = areTexCoordsPackable(fbxMesh.texCoords);
+    bool areTexCoords1Packed = areTexCoordsPackable(fbxMesh.texCoords1);
+
+    QVector<uint32_t> packedNormals = areNormalsPacked ? packUnitVectors(fbxMesh.normals) : QVector<uint32_t>();
+    QVector<uint32_t> packedTangents = packUnitVectors(fbxMesh.tangents);
+    QVector<uint32_t> packedColors = areColorsPacked ? packColors(fbxMesh.colors) : QVector<uint32_t>();
+    QVector<uint32_t> packedTexCoords = areTexCoordsPacked ? packTexCoords(fbxMesh.texCoords) : QVector<uint32_t>();
+    QVector<uint32_t> packedTexCoords1 = areTexCoords1Packed ? packTexCoords(fbxMesh.texCoords1) : QVector<uint32_t>();
+
+    const gpu::Byte* normalsData = areNormalsPacked ? (const gpu::Byte*)packedNormals.constData() :
+        (const gpu::Byte*)fbxMesh.normals.constData();
+    const gpu::Byte* colorsData = areColorsPacked ? (const gpu::Byte*)packedColors.constData() :
+        (const gpu::Byte*)fbxMesh.colors.constData();
+    const gpu::Byte* texCoordsData = areTexCoordsPacked ? (const gpu::Byte*)packedTexCoords.constData() :
+        (const gpu::Byte*)fbxMesh.texCoords.constData();
+    const gpu::Byte* texCoords1Data = areTexCoords1Packed ? (const gpu::Byte*)packedTexCoords1.constData() :
+        (const gpu::Byte*)fbxMesh.texCoords1.constData();
+
+    gpu::Element normalElement = areNormalsPacked ? gpu::Element(gpu::VEC4, gpu::NINT8, gpu::XYZW) :
+        gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ);
+    gpu::Element tangentElement = gpu::Element(gpu::VEC4, gpu::NINT8, gpu::XYZW);
+    gpu::Element colorElement = areColorsPacked ? gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA) :
+        gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::RGB);
+    gpu::Element texCoordElement = areTexCoordsPacked ? gpu::Element(gpu::VEC2, gpu::NUINT16, gpu::UV) :
+        gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV);
+    gpu::Element texCoord1Element = areTexCoords1Packed ? gpu::Element(gpu::VEC2, gpu::NUINT16, gpu::UV) :
+        gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV);
+
     // evaluate all attribute channels sizes
-    int normalsSize = fbxMesh.normals.size() * sizeof(glm::vec3);
-    int tangentsSize = fbxMesh.tangents.size() * sizeof(glm::vec3);
-    int colorsSize = fbxMesh.colors.size() * sizeof(glm::vec3);
-    int texCoordsSize = fbxMesh.texCoords.size() * sizeof(glm::vec2);
-    int texCoords1Size = fbxMesh.texCoords1.size() * sizeof(glm::vec2);
+    int normalsSize = fbxMesh.normals.size() * normalElement.getSize();
+    int tangentsSize = fbxMesh.tangents.size() * tangentElement.getSize();
+    int colorsSize = fbxMesh.colors.size() * colorElement.getSize();
+    int texCoordsSize = fbxMesh.texCoords.size() * texCoordElement.getSize();
+    int texCoords1Size = fbxMesh.texCoords1.size() * texCoord1Element.getSize();
 
     int clusterIndicesSize = fbxMesh.clusterIndices.size() * sizeof(uint8_t);
     if (fbxMesh.clusters.size() > UINT8_MAX) {
@@ -442,11 +756,11 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     // Copy all attribute data in a single attribute buffer
     auto attribBuffer = std::make_shared<gpu::Buffer>();
     attribBuffer->resize(totalAttributeSize);
-    attribBuffer->setSubData(normalsOffset, normalsSize, (gpu::Byte*) fbxMesh.normals.constData());
-    attribBuffer->setSubData(tangentsOffset, tangentsSize, (gpu::Byte*) fbxMesh.tangents.constData());
-    attribBuffer->setSubData(colorsOffset, colorsSize, (gpu::Byte*) fbxMesh.colors.constData());
-    attribBuffer->setSubData(texCoordsOffset, texCoordsSize, (gpu::Byte*) fbxMesh.texCoords.constData());
-    attribBuffer->setSubData(texCoords1Offset, texCoords1Size, (gpu::Byte*) fbxMesh.texCoords1.constData());
+    attribBuffer->setSubData(normalsOffset, normalsSize, normalsData);
+    attribBuffer->setSubData(tangentsOffset, tangentsSize, (const gpu::Byte*) packedTangents.constData());
+    attribBuffer->setSubData(colorsOffset, colorsSize, colorsData);
+    attribBuffer->setSubData(texCoordsOffset, texCoordsSize, texCoordsData);
+    attribBuffer->setSubData(texCoords1Offset, texCoords1Size, texCoords1Data);
 
     if (fbxMesh.clusters.size() < UINT8_MAX) {
         // yay! we can fit the clusterIndices within 8-bits
@@ -465,32 +779,26 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
 
     if (normalsSize) {
         mesh->addAttribute(gpu::Stream::NORMAL,
-                            model::BufferView(attribBuffer, normalsOffset, normalsSize,
-                            gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+                            model::BufferView(attribBuffer, normalsOffset, normalsSize, normalElement));
     }
     if (tangentsSize) {
         mesh->addAttribute(gpu::Stream::TANGENT,
-                            model::BufferView(attribBuffer, tangentsOffset, tangentsSize,
-                            gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+                            model::BufferView(attribBuffer, tangentsOffset, tangentsSize, tangentElement));
     }
     if (colorsSize) {
         mesh->addAttribute(gpu::Stream::COLOR,
-                            model::BufferView(attribBuffer, colorsOffset, colorsSize,
-                            gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::RGB)));
+                            model::BufferView(attribBuffer, colorsOffset, colorsSize, colorElement));
     }
     if (texCoordsSize) {
         mesh->addAttribute(gpu::Stream::TEXCOORD,
-                            model::BufferView( attribBuffer, texCoordsOffset, texCoordsSize,
-                            gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV)));
+                            model::BufferView(attribBuffer, texCoordsOffset, texCoordsSize, texCoordElement));
     }
     if (texCoords1Size) {
         mesh->addAttribute( gpu::Stream::TEXCOORD1,
-                            model::BufferView(attribBuffer, texCoords1Offset, texCoords1Size,
-                            gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV)));
+                            model::BufferView(attribBuffer, texCoords1Offset, texCoords1Size, texCoord1Element));
     } else if (texCoordsSize) {
         mesh->addAttribute(gpu::Stream::TEXCOORD1,
-                            model::BufferView(attribBuffer, texCoordsOffset, texCoordsSize,
-                            gpu::Element(gpu::VEC2, gpu::FLOAT, gpu::UV)));
+                            model::BufferView(attribBuffer, texCoordsOffset, texCoordsSize, texCoordElement));
     }
 
     if (clusterIndicesSize) {
@@ -528,28 +836,25 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
     int offset = 0;
 
     std::vector< model::Mesh::Part > parts;
+    std::vector<QVector<int>> allPartIndices;
     if (extractedMesh.parts.size() > 1) {
         indexNum = 0;
     }
     foreach(const FBXMeshPart& part, extractedMesh.parts) {
         model::Mesh::Part modelPart(indexNum, 0, 0, model::Mesh::TRIANGLES);
-        
-        if (part.quadTrianglesIndices.size()) {
-            indexBuffer->setSubData(offset,
-                            part.quadTrianglesIndices.size() * sizeof(int),
-                            (gpu::Byte*) part.quadTrianglesIndices.constData());
-            offset += part.quadTrianglesIndices.size() * sizeof(int);
-            indexNum += part.quadTrianglesIndices.size();
-            modelPart._numIndices += part.quadTrianglesIndices.size();
-        }
 
-        if (part.triangleIndices.size()) {
+        // the triangles of a part draw together, in the order that transforms the fewest vertices
+        QVector<int> partIndices = part.quadTrianglesIndices + part.triangleIndices;
+        optimizeTriangleOrder(partIndices, extractedMesh.vertices.size());
+        allPartIndices.push_back(partIndices);
+
+        if (partIndices.size()) {
             indexBuffer->setSubData(offset,
-                            part.triangleIndices.size() * sizeof(int),
-                            (gpu::Byte*) part.triangleIndices.constData());
-            offset += part.triangleIndices.size() * sizeof(int);
-            indexNum += part.triangleIndices.size();
-            modelPart._numIndices += part.triangleIndices.size();
+                            partIndices.size() * sizeof(int),
+                            (gpu::Byte*) partIndices.constData());
+            offset += partIndices.size() * sizeof(int);
+            indexNum += partIndices.size();
+            modelPart._numIndices += partIndices.size();
         }
 
         parts.push_back(modelPart);
@@ -568,6 +873,16 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
         return;
     }
 
+    // coarser levels of the parts, made here on the thread the model is read on
+    QVector<int> lodIndices;
+    std::vector<model::Mesh::LOD> lods;
+    buildLODs(allPartIndices, extractedMesh.vertices, lodIndices, lods);
+    if (!lods.empty()) {
+        auto lodIndexBuffer = std::make_shared<gpu::Buffer>();
+        lodIndexBuffer->setData(lodIndices.size() * sizeof(int), (const gpu::Byte*) lodIndices.constData());
+        mesh->setLODs(gpu::BufferView(lodIndexBuffer, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::XYZ)), lods);
+    }
+
     // model::Box box =
     mesh->evalPartBound(0);
 
@@ -0,0 +1,440 @@
+//
+//  FBXSerializer.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXSerializer.h"
+
+#include <memory>
+
+#include <QBuffer>
+#include <QDataStream>
+
+#include "ModelFormatLogging.h"
+
+const quint32 FBX_SERIALIZATION_VERSION = 1;
+
+namespace {
+
+const quint32 FBX_SERIALIZATION_MAGIC = 0x47584246; // "FBXG"
+
+// plain values and arrays of them are copied as they are in memory, the format is only read back on the same platform
+template <typename T>
+void writeValue(QDataStream& out, const T& value) {
+    out.writeRawData(reinterpret_cast<const char*>(&value), (int)sizeof(T));
+}
+
+template <typename T>
+void readValue(QDataStream& in, T& value) {
+    if (in.readRawData(reinterpret_cast<char*>(&value), (int)sizeof(T)) != (int)sizeof(T)) {
+        in.setStatus(QDataStream::ReadPastEnd);
+    }
+}
+
+template <typename T>
+void writeVector(QDataStream& out, const QVector<T>& vector) {
+    out << (quint32)vector.size();
+    out.writeRawData(reinterpret_cast<const char*>(vector.constData()), vector.size() * (int)sizeof(T));
+}
+
+template <typename T>
+void readVector(QDataStream& in, QVector<T>& vector) {
+    quint32 size = 0;
+    in >> size;
+
+    // a damaged size must not turn into a huge allocation
+    if (in.status() != QDataStream::Ok || size > (quint64)in.device()->bytesAvailable() / sizeof(T)) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        vector.clear();
+        return;
+    }
+
+    vector.resize(size);
+    int length = (int)(size * sizeof(T));
+    if (in.readRawData(reinterpret_cast<char*>(vector.data()), length) != length) {
+        in.setStatus(QDataStream::ReadPastEnd);
+    }
+}
+
+// the number of elements that follow, checked against what is left so that damaged data fails rather than allocates
+bool readCount(QDataStream& in, int& count) {
+    quint32 value = 0;
+    in >> value;
+    if (in.status() != QDataStream::Ok || value > (quint64)in.device()->bytesAvailable()) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return false;
+    }
+    count = (int)value;
+    return true;
+}
+
+void writeTexture(QDataStream& out, const FBXTexture& texture) {
+    out << texture.name << texture.filename << texture.content;
+    writeValue(out, texture.transform.getTranslation());
+    writeValue(out, texture.transform.getRotation());
+    writeValue(out, texture.transform.getScale());
+    out << (qint32)texture.maxNumPixels << (qint32)texture.texcoordSet << texture.texcoordSetName << texture.isBumpmap;
+}
+
+void readTexture(QDataStream& in, FBXTexture& texture) {
+    in >> texture.name >> texture.filename >> texture.content;
+
+    glm::vec3 translation;
+    glm::quat rotation;
+    glm::vec3 scale;
+    readValue(in, translation);
+    readValue(in, rotation);
+    readValue(in, scale);
+    texture.transform.setTranslation(translation);
+    texture.transform.setRotation(rotation);
+    texture.transform.setScale(scale);
+
+    qint32 maxNumPixels, texcoordSet;
+    in >> maxNumPixels >> texcoordSet >> texture.texcoordSetName >> texture.isBumpmap;
+    texture.maxNumPixels = maxNumPixels;
+    texture.texcoordSet = texcoordSet;
+}
+
+void writeMaterial(QDataStream& out, const FBXMaterial& material) {
+    writeValue(out, material.diffuseColor);
+    out << material.diffuseFactor;
+    writeValue(out, material.specularColor);
+    out << material.specularFactor;
+    writeValue(out, material.emissiveColor);
+    out << material.emissiveFactor << material.shininess << material.opacity << material.metallic << material.roughness
+        << material.emissiveIntensity << material.ambientFactor;
+    out << material.materialID << material.name << material.shadingModel;
+
+    for (auto texture : { &material.normalTexture, &material.albedoTexture, &material.opacityTexture,
+                          &material.glossTexture, &material.roughnessTexture, &material.specularTexture,
+                          &material.metallicTexture, &material.emissiveTexture, &material.occlusionTexture,
+                          &material.scatteringTexture, &material.lightmapTexture }) {
+        writeTexture(out, *texture);
+    }
+    writeValue(out, material.lightmapParams);
+
+    out << material.isPBSMaterial << material.useNormalMap << material.useAlbedoMap << material.useOpacityMap
+        << material.useRoughnessMap << material.useSpecularMap << material.useMetallicMap << material.useEmissiveMap
+        << material.useOcclusionMap;
+
+    // the readers only set the values of the material, the maps are added once it is on the network
+    auto& modelMaterial = material._material;
+    out << (bool)modelMaterial;
+    if (modelMaterial) {
+        writeValue(out, modelMaterial->getEmissive(false));
+        writeValue(out, modelMaterial->getAlbedo(false));
+        out << modelMaterial->getRoughness() << modelMaterial->getMetallic() << modelMaterial->getOpacity()
+            << modelMaterial->getScattering() << modelMaterial->isUnlit();
+    }
+}
+
+void readMaterial(QDataStream& in, FBXMaterial& material) {
+    readValue(in, material.diffuseColor);
+    in >> material.diffuseFactor;
+    readValue(in, material.specularColor);
+    in >> material.specularFactor;
+    readValue(in, material.emissiveColor);
+    in >> material.emissiveFactor >> material.shininess >> material.opacity >> material.metallic >> material.roughness
+       >> material.emissiveIntensity >> material.ambientFactor;
+    in >> material.materialID >> material.name >> material.shadingModel;
+
+    for (auto texture : { &material.normalTexture, &material.albedoTexture, &material.opacityTexture,
+                          &material.glossTexture, &material.roughnessTexture, &material.specularTexture,
+                          &material.metallicTexture, &material.emissiveTexture, &material.occlusionTexture,
+                          &material.scatteringTexture, &material.lightmapTexture }) {
+        readTexture(in, *texture);
+    }
+    readValue(in, material.lightmapParams);
+
+    in >> material.isPBSMaterial >> material.useNormalMap >> material.useAlbedoMap >> material.useOpacityMap
+       >> material.useRoughnessMap >> material.useSpecularMap >> material.useMetallicMap >> material.useEmissiveMap
+       >> material.useOcclusionMap;
+
+    bool hasModelMaterial = false;
+    in >> hasModelMaterial;
+    if (hasModelMaterial) {
+        glm::vec3 emissive, albedo;
+        float roughness, metallic, opacity, scattering;
+        bool isUnlit;
+        readValue(in, emissive);
+        readValue(in, albedo);
+        in >> roughness >> metallic >> opacity >> scattering >> isUnlit;
+
+        material._material = std::make_shared<model::Material>();
+        material._material->setEmissive(emissive, false);
+        material._material->setAlbedo(albedo, false);
+        material._material->setRoughness(roughness);
+        material._material->setMetallic(metallic);
+        material._material->setOpacity(opacity);
+        material._material->setScattering(scattering);
+        material._material->setUnlit(isUnlit);
+    }
+}
+
+void writeJoint(QDataStream& out, const FBXJoint& joint) {
+    writeVector(out, joint.shapeInfo.points);
+    writeVector(out, joint.freeLineage);
+    out << joint.isFree << (qint32)joint.parentIndex << joint.distanceToParent;
+    writeValue(out, joint.translation);
+    writeValue(out, joint.preTransform);
+    writeValue(out, joint.preRotation);
+    writeValue(out, joint.rotation);
+    writeValue(out, joint.postRotation);
+    writeValue(out, joint.postTransform);
+    writeValue(out, joint.transform);
+    writeValue(out, joint.rotationMin);
+    writeValue(out, joint.rotationMax);
+    writeValue(out, joint.inverseDefaultRotation);
+    writeValue(out, joint.inverseBindRotation);
+    writeValue(out, joint.bindTransform);
+    out << joint.name << joint.isSkeletonJoint << joint.bindTransformFoundInCluster << joint.hasGeometricOffset;
+    writeValue(out, joint.geometricTranslation);
+    writeValue(out, joint.geometricRotation);
+    writeValue(out, joint.geometricScaling);
+}
+
+void readJoint(QDataStream& in, FBXJoint& joint) {
+    readVector(in, joint.shapeInfo.points);
+    readVector(in, joint.freeLineage);
+    qint32 parentIndex;
+    in >> joint.isFree >> parentIndex >> joint.distanceToParent;
+    joint.parentIndex = parentIndex;
+    readValue(in, joint.translation);
+    readValue(in, joint.preTransform);
+    readValue(in, joint.preRotation);
+    readValue(in, joint.rotation);
+    readValue(in, joint.postRotation);
+    readValue(in, joint.postTransform);
+    readValue(in, joint.transform);
+    readValue(in, joint.rotationMin);
+    readValue(in, joint.rotationMax);
+    readValue(in, joint.inverseDefaultRotation);
+    readValue(in, joint.inverseBindRotation);
+    readValue(in, joint.bindTransform);
+    in >> joint.name >> joint.isSkeletonJoint >> joint.bindTransformFoundInCluster >> joint.hasGeometricOffset;
+    readValue(in, joint.geometricTranslation);
+    readValue(in, joint.geometricRotation);
+    readValue(in, joint.geometricScaling);
+}
+
+void writeMesh(QDataStream& out, const FBXMesh& mesh) {
+    out << (quint32)mesh.parts.size();
+    for (auto& part : mesh.parts) {
+        writeVector(out, part.quadIndices);
+        writeVector(out, part.quadTrianglesIndices);
+        writeVector(out, part.triangleIndices);
+        out << part.materialID;
+    }
+
+    writeVector(out, mesh.vertices);
+    writeVector(out, mesh.normals);
+    writeVector(out, mesh.tangents);
+    writeVector(out, mesh.colors);
+    writeVector(out, mesh.texCoords);
+    writeVector(out, mesh.texCoords1);
+    writeVector(out, mesh.clusterIndices);
+    writeVector(out, mesh.clusterWeights);
+    writeVector(out, mesh.clusters);
+    writeValue(out, mesh.meshExtents);
+    writeValue(out, mesh.modelTransform);
+
+    out << (quint32)mesh.blendshapes.size();
+    for (auto& blendshape : mesh.blendshapes) {
+        writeVector(out, blendshape.indices);
+        writeVector(out, blendshape.vertices);
+        writeVector(out, blendshape.normals);
+    }
+
+    out << (quint32)mesh.meshIndex;
+}
+
+void readMesh(QDataStream& in, FBXMesh& mesh) {
+    int numParts = 0;
+    if (!readCount(in, numParts)) {
+        return;
+    }
+    mesh.parts.resize(numParts);
+    for (auto& part : mesh.parts) {
+        readVector(in, part.quadIndices);
+        readVector(in, part.quadTrianglesIndices);
+        readVector(in, part.triangleIndices);
+        in >> part.materialID;
+    }
+
+    readVector(in, mesh.vertices);
+    readVector(in, mesh.normals);
+    readVector(in, mesh.tangents);
+    readVector(in, mesh.colors);
+    readVector(in, mesh.texCoords);
+    readVector(in, mesh.texCoords1);
+    readVector(in, mesh.clusterIndices);
+    readVector(in, mesh.clusterWeights);
+    readVector(in, mesh.clusters);
+    readValue(in, mesh.meshExtents);
+    readValue(in, mesh.modelTransform);
+
+    int numBlendshapes = 0;
+    if (!readCount(in, numBlendshapes)) {
+        return;
+    }
+    mesh.blendshapes.resize(numBlendshapes);
+    for (auto& blendshape : mesh.blendshapes) {
+        readVector(in, blendshape.indices);
+        readVector(in, blendshape.vertices);
+        readVector(in, blendshape.normals);
+    }
+
+    quint32 meshIndex;
+    in >> meshIndex;
+    mesh.meshIndex = meshIndex;
+}
+
+void setUpStream(QDataStream& stream) {
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+}
+
+}
+
+QByteArray serializeFBXGeometry(const FBXGeometry& geometry) {
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QDataStream out(&buffer);
+    setUpStream(out);
+
+    out << FBX_SERIALIZATION_MAGIC << FBX_SERIALIZATION_VERSION;
+    out << geometry.originalURL << geometry.author << geometry.applicationName;
+
+    out << (quint32)geometry.joints.size();
+    for (auto& joint : geometry.joints) {
+        writeJoint(out, joint);
+    }
+    out << geometry.jointIndices << geometry.hasSkeletonJoints;
+
+    out << (quint32)geometry.meshes.size();
+    for (auto& mesh : geometry.meshes) {
+        writeMesh(out, mesh);
+    }
+
+    out << (quint32)geometry.materials.size();
+    for (auto it = geometry.materials.constBegin(); it != geometry.materials.constEnd(); ++it) {
+        out << it.key();
+        writeMaterial(out, it.value());
+    }
+
+    writeValue(out, geometry.offset);
+    for (int jointIndex : { geometry.leftEyeJointIndex, geometry.rightEyeJointIndex, geometry.neckJointIndex,
+                            geometry.rootJointIndex, geometry.leanJointIndex, geometry.headJointIndex,
+                            geometry.leftHandJointIndex, geometry.rightHandJointIndex, geometry.leftToeJointIndex,
+                            geometry.rightToeJointIndex }) {
+        out << (qint32)jointIndex;
+    }
+    out << geometry.leftEyeSize << geometry.rightEyeSize;
+    writeVector(out, geometry.humanIKJointIndices);
+    writeValue(out, geometry.palmDirection);
+    writeValue(out, geometry.neckPivot);
+    writeValue(out, geometry.bindExtents);
+    writeValue(out, geometry.meshExtents);
+
+    out << (quint32)geometry.animationFrames.size();
+    for (auto& frame : geometry.animationFrames) {
+        writeVector(out, frame.rotations);
+        writeVector(out, frame.translations);
+    }
+
+    out << geometry.meshIndicesToModelNames << geometry.blendshapeChannelNames;
+
+    return data;
+}
+
+FBXGeometry* deserializeFBXGeometry(const QByteArray& data) {
+    QBuffer buffer(const_cast<QByteArray*>(&data));
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+    setUpStream(in);
+
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != FBX_SERIALIZATION_MAGIC || version != FBX_SERIALIZATION_VERSION) {
+        return nullptr;
+    }
+
+    std::unique_ptr<FBXGeometry> geometry(new FBXGeometry());
+    in >> geometry->originalURL >> geometry->author >> geometry->applicationName;
+
+    int numJoints = 0;
+    if (!readCount(in, numJoints)) {
+        return nullptr;
+    }
+    geometry->joints.resize(numJoints);
+    for (auto& joint : geometry->joints) {
+        readJoint(in, joint);
+    }
+    in >> geometry->jointIndices >> geometry->hasSkeletonJoints;
+
+    int numMeshes = 0;
+    if (!readCount(in, numMeshes)) {
+        return nullptr;
+    }
+    geometry->meshes.resize(numMeshes);
+    for (auto& mesh : geometry->meshes) {
+        readMesh(in, mesh);
+    }
+
+    int numMaterials = 0;
+    if (!readCount(in, numMaterials)) {
+        return nullptr;
+    }
+    for (int i = 0; i < numMaterials && in.status() == QDataStream::Ok; ++i) {
+        QString materialID;
+        in >> materialID;
+        readMaterial(in, geometry->materials[materialID]);
+    }
+
+    readValue(in, geometry->offset);
+    for (int* jointIndex : { &geometry->leftEyeJointIndex, &geometry->rightEyeJointIndex, &geometry->neckJointIndex,
+                             &geometry->rootJointIndex, &geometry->leanJointIndex, &geometry->headJointIndex,
+                             &geometry->leftHandJointIndex, &geometry->rightHandJointIndex, &geometry->leftToeJointIndex,
+                             &geometry->rightToeJointIndex }) {
+        qint32 value;
+        in >> value;
+        *jointIndex = value;
+    }
+    in >> geometry->leftEyeSize >> geometry->rightEyeSize;
+    readVector(in, geometry->humanIKJointIndices);
+    readValue(in, geometry->palmDirection);
+    readValue(in, geometry->neckPivot);
+    readValue(in, geometry->bindExtents);
+    readValue(in, geometry->meshExtents);
+
+    int numFrames = 0;
+    if (!readCount(in, numFrames)) {
+        return nullptr;
+    }
+    geometry->animationFrames.resize(numFrames);
+    for (auto& frame : geometry->animationFrames) {
+        readVector(in, frame.rotations);
+        readVector(in, frame.translations);
+    }
+
+    in >> geometry->meshIndicesToModelNames >> geometry->blendshapeChannelNames;
+
+    if (in.status() != QDataStream::Ok || !in.atEnd()) {
+        qCWarning(modelformat) << "Discarding damaged serialized geometry for" << geometry->originalURL;
+        return nullptr;
+    }
+
+    // the render meshes are built from the geometry just as the readers build them
+    for (auto& mesh : geometry->meshes) {
+        FBXReader::buildModelMesh(mesh, geometry->originalURL);
+    }
+
+    return geometry.release();
+}
@@ -0,0 +1,31 @@
+//
+//  FBXSerializer.h
+//  libraries/fbx/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_FBXSerializer_h
+#define hifi_FBXSerializer_h
+
+#include <QByteArray>
+
+#include "FBXReader.h"
+
+/// Bumped whenever the serialized form, or what the readers put into an FBXGeometry, changes.
+extern const quint32 FBX_SERIALIZATION_VERSION;
+
+/// Writes the geometry produced by readFBX or OBJReader in a binary form that can be read back without parsing the model.
+/// The render meshes and materials are not written, they are rebuilt when the geometry is read.
+QByteArray serializeFBXGeometry(const FBXGeometry& geometry);
+
+/// Reads geometry written by serializeFBXGeometry.
+/// Returns nullptr if the data was written by another version or is damaged.
+FBXGeometry* deserializeFBXGeometry(const QByteArray& data);
+
+#endif // hifi_FBXSerializer_h
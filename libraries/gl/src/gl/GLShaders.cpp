@@ -140,7 +140,8 @@ GLuint compileProgram(const std::vector<GLuint>& glshaders, std::string& error)
         return 0;
     }
 
-    // glProgramParameteri(glprogram, GL_PROGRAM_, GL_TRUE);
+    // Keep the linked binary around so that it can be cached
+    glProgramParameteri(glprogram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     // Create the program from the sub shaders
     for (auto so : glshaders) {
         glAttachShader(glprogram, so);
@@ -190,4 +191,41 @@ GLuint compileProgram(const std::vector<GLuint>& glshaders, std::string& error)
     return glprogram;
 }
 
+bool getProgramBinary(GLuint glprogram, GLenum& format, std::string& binary) {
+    GLint binaryLength = 0;
+    glGetProgramiv(glprogram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0) {
+        return false;
+    }
+
+    binary.resize(binaryLength);
+    GLsizei length = 0;
+    glGetProgramBinary(glprogram, binaryLength, &length, &format, &binary[0]);
+    if (length <= 0) {
+        return false;
+    }
+    binary.resize(length);
+    return true;
+}
+
+GLuint loadProgramBinary(GLenum format, const std::string& binary) {
+    GLuint glprogram = glCreateProgram();
+    if (!glprogram) {
+        qCDebug(glLogging) << "GLShader::loadProgramBinary - failed to create the gl program object";
+        return 0;
+    }
+
+    glProgramBinary(glprogram, format, binary.data(), (GLsizei)binary.size());
+
+    // A driver that was updated since the binary was made turns it down
+    GLint linked = 0;
+    glGetProgramiv(glprogram, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(glprogram);
+        return 0;
+    }
+
+    return glprogram;
+}
+
 }
@@ -24,6 +24,11 @@ namespace gl {
 
     GLuint compileProgram(const std::vector<GLuint>& glshaders, std::string& error);
 
+    // A linked program in the driver's own format, which only the same driver can load back
+    bool getProgramBinary(GLuint glprogram, GLenum& format, std::string& binary);
+    // The program loaded from a binary, or 0 if the driver could not load it
+    GLuint loadProgramBinary(GLenum format, const std::string& binary);
+
 }
 
 #endif
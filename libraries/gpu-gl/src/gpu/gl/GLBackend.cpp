@@ -108,6 +108,7 @@ GLBackend::CommandCall GLBackend::_commandCalls[Batch::NUM_COMMANDS] =
     (&::gpu::gl::GLBackend::do_clearFramebuffer),
     (&::gpu::gl::GLBackend::do_blit),
     (&::gpu::gl::GLBackend::do_generateTextureMips),
+    (&::gpu::gl::GLBackend::do_readbackFramebuffer),
 
     (&::gpu::gl::GLBackend::do_beginQuery),
     (&::gpu::gl::GLBackend::do_endQuery),
@@ -198,6 +199,7 @@ GLBackend::GLBackend() {
 GLBackend::~GLBackend() {
     killInput();
     killTransform();
+    killReadbacks();
 }
 
 void GLBackend::renderPassTransfer(const Batch& batch) {
@@ -292,6 +294,7 @@ void GLBackend::renderPassDraw(const Batch& batch) {
                 updateInput();
                 updateTransform(batch);
                 updatePipeline();
+                updateResourceTextures();
 
                 CommandCall call = _commandCalls[(*command)];
                 (this->*(call))(batch, *offset);
@@ -392,6 +395,8 @@ void GLBackend::do_restoreContextStereo(const Batch& batch, size_t paramOffset)
 
 void GLBackend::do_runLambda(const Batch& batch, size_t paramOffset) {
     std::function<void()> f = batch._lambdas.get(batch._params[paramOffset]._uint);
+    // the lambda may draw with the textures set so far
+    updateResourceTextures();
     f();
 }
 
@@ -777,6 +782,8 @@ void GLBackend::recycle() const {
     GLVariableAllocationSupport::manageMemory();
     GLVariableAllocationSupport::_frameTexturesCreated = 0;
 
+    processPendingReadbacks();
+
 }
 
 void GLBackend::setCameraCorrection(const Mat4& correction) {
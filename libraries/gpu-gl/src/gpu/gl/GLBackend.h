@@ -112,6 +112,7 @@ public:
     virtual void do_setIndexBuffer(const Batch& batch, size_t paramOffset) final;
     virtual void do_setIndirectBuffer(const Batch& batch, size_t paramOffset) final;
     virtual void do_generateTextureMips(const Batch& batch, size_t paramOffset) final;
+    virtual void do_readbackFramebuffer(const Batch& batch, size_t paramOffset) final;
 
     // Transform Stage
     virtual void do_setModelTransform(const Batch& batch, size_t paramOffset) final;
@@ -364,6 +365,9 @@ protected:
 
     struct UniformStageState {
         std::array<BufferPointer, MAX_NUM_UNIFORM_BUFFERS> _buffers;
+        // the range of the buffer bound, the same buffer may be bound again with another one
+        std::array<Offset, MAX_NUM_UNIFORM_BUFFERS> _offsets {};
+        std::array<Offset, MAX_NUM_UNIFORM_BUFFERS> _sizes {};
         //Buffers _buffers {  };
     } _uniform;
 
@@ -378,6 +382,11 @@ protected:
     // update resource cache and do the gl unbind call with the current gpu::Texture cached at slot s
     void releaseResourceTexture(uint32_t slot);
 
+    // do the gl bind call of a texture, or 0, to the unit of slot s
+    // A backend can hold on to it until the textures are updated for the next draw
+    virtual void bindResourceTexture(uint32_t slot, GLenum target, GLuint texture);
+    virtual void updateResourceTextures() {}
+
     void resetResourceStage();
 
     struct ResourceStageState {
@@ -425,6 +434,9 @@ protected:
     virtual GLShader* compileBackendProgram(const Shader& program);
     virtual GLShader* compileBackendShader(const Shader& shader);
     virtual std::string getBackendShaderHeader() const;
+    std::string getShaderDefines(Shader::Type type, int version) const;
+    // What a linked program version is cached under, the same for as long as its sources and the driver are
+    QByteArray getProgramCacheKey(const Shader& program, int version) const;
     virtual void makeProgramBindings(ShaderObject& shaderObject);
     class ElementResource {
     public:
@@ -452,6 +464,17 @@ protected:
         GLuint _drawFBO { 0 };
     } _output;
 
+    // Framebuffer readbacks waiting on the gpu, their handlers are called from recycle once the pixels are in
+    struct PendingReadback {
+        GLuint _pbo { 0 };
+        GLsync _fence { 0 };
+        GLsizei _numTexels { 0 };
+        Batch::ReadbackHandler _handler;
+    };
+    mutable std::list<PendingReadback> _pendingReadbacks;
+    void processPendingReadbacks() const;
+    void killReadbacks();
+
     void resetQueryStage();
     struct QueryStageState {
         uint32_t _rangeQueryDepth { 0 };
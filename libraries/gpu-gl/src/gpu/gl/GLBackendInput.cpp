@@ -30,6 +30,8 @@ void GLBackend::do_setInputFormat(const Batch& batch, size_t paramOffset) {
             _input._formatKey.clear();
             _input._invalidFormat = true;
         }
+    } else {
+        _stats._ISNumRedundantChanges++;
     }
 }
 
@@ -65,6 +67,8 @@ void GLBackend::do_setInputBuffer(const Batch& batch, size_t paramOffset) {
 
         if (isModified) {
             _input._invalidBuffers.set(channel);
+        } else {
+            _stats._ISNumRedundantChanges++;
         }
     }
 }
@@ -125,7 +129,10 @@ void GLBackend::do_setIndexBuffer(const Batch& batch, size_t paramOffset) {
     _input._indexBufferOffset = batch._params[paramOffset + 0]._uint;
 
     BufferPointer indexBuffer = batch._buffers.get(batch._params[paramOffset + 1]._uint);
-    if (indexBuffer != _input._indexBuffer) {
+    if (indexBuffer == _input._indexBuffer) {
+        _stats._ISNumRedundantChanges++;
+    } else {
+        _stats._ISNumIndexBufferChanges++;
         _input._indexBuffer = indexBuffer;
         if (indexBuffer) {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, getBufferID(*indexBuffer));
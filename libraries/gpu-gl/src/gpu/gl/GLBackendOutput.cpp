@@ -148,6 +148,78 @@ void GLBackend::do_clearFramebuffer(const Batch& batch, size_t paramOffset) {
     (void) CHECK_GL_ERROR();
 }
 
+void GLBackend::do_readbackFramebuffer(const Batch& batch, size_t paramOffset) {
+    auto framebuffer = batch._framebuffers.get(batch._params[paramOffset]._uint);
+    Vec4i region;
+    for (auto i = 0; i < 4; ++i) {
+        region[i] = batch._params[paramOffset + 1 + i]._int;
+    }
+    const auto& handler = batch._readbackHandlers.get(batch._params[paramOffset + 5]._uint);
+
+    auto readFBO = getFramebufferID(framebuffer);
+    if (!readFBO || !handler || region.z <= 0 || region.w <= 0) {
+        return;
+    }
+    if ((framebuffer->getWidth() < (region.x + region.z)) || (framebuffer->getHeight() < (region.y + region.w))) {
+        qCWarning(gpugllogging) << "GLBackend::do_readbackFramebuffer : framebuffer is too small to provide the region queried";
+        return;
+    }
+
+    PendingReadback readback;
+    readback._numTexels = region.z * region.w;
+    readback._handler = handler;
+
+    // Read into a pack buffer, so that the pixels are copied when the gpu gets there rather than now
+    glGenBuffers(1, &readback._pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback._pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, readback._numTexels * sizeof(float), nullptr, GL_STREAM_READ);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFBO);
+    glReadPixels(region.x, region.y, region.z, region.w, GL_RED, GL_FLOAT, nullptr);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback._fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _pendingReadbacks.push_back(readback);
+
+    (void) CHECK_GL_ERROR();
+}
+
+void GLBackend::processPendingReadbacks() const {
+    while (!_pendingReadbacks.empty()) {
+        auto readback = _pendingReadbacks.front();
+        auto status = glClientWaitSync(readback._fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            // The next ones were issued after this one, no need to look at them
+            break;
+        }
+        _pendingReadbacks.pop_front();
+
+        std::vector<float> texels;
+        if (status != GL_WAIT_FAILED) {
+            texels.resize(readback._numTexels);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback._pbo);
+            glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, readback._numTexels * sizeof(float), texels.data());
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+        glDeleteSync(readback._fence);
+        glDeleteBuffers(1, &readback._pbo);
+        (void) CHECK_GL_ERROR();
+
+        if (!texels.empty()) {
+            readback._handler(texels);
+        }
+    }
+}
+
+void GLBackend::killReadbacks() {
+    for (auto& readback : _pendingReadbacks) {
+        glDeleteSync(readback._fence);
+        glDeleteBuffers(1, &readback._pbo);
+    }
+    _pendingReadbacks.clear();
+}
+
 void GLBackend::downloadFramebuffer(const FramebufferPointer& srcFramebuffer, const Vec4i& region, QImage& destImage) {
     auto readFBO = getFramebufferID(srcFramebuffer);
     if (srcFramebuffer && readFBO) {
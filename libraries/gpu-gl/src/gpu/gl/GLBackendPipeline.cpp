@@ -23,6 +23,7 @@ void GLBackend::do_setPipeline(const Batch& batch, size_t paramOffset) {
     PipelinePointer pipeline = batch._pipelines.get(batch._params[paramOffset + 0]._uint);
 
     if (_pipeline._pipeline == pipeline) {
+        _stats._PSNumRedundantSetPipelines++;
         return;
     }
 
@@ -155,7 +156,7 @@ void GLBackend::resetUniformStage() {
 
 void GLBackend::do_setUniformBuffer(const Batch& batch, size_t paramOffset) {
     GLuint slot = batch._params[paramOffset + 3]._uint;
-    if (slot >(GLuint)MAX_NUM_UNIFORM_BUFFERS) {
+    if (slot >= (GLuint)MAX_NUM_UNIFORM_BUFFERS) {
         qCDebug(gpugllogging) << "GLBackend::do_setUniformBuffer: Trying to set a uniform Buffer at slot #" << slot << " which doesn't exist. MaxNumUniformBuffers = " << getMaxNumUniformBuffers();
         return;
     }
@@ -169,7 +170,9 @@ void GLBackend::do_setUniformBuffer(const Batch& batch, size_t paramOffset) {
     }
     
     // check cache before thinking
-    if (_uniform._buffers[slot] == uniformBuffer) {
+    if (_uniform._buffers[slot] == uniformBuffer && _uniform._offsets[slot] == (Offset)rangeStart &&
+            _uniform._sizes[slot] == (Offset)rangeSize) {
+        _stats._RSNumRedundantBinds++;
         return;
     }
 
@@ -179,6 +182,8 @@ void GLBackend::do_setUniformBuffer(const Batch& batch, size_t paramOffset) {
         glBindBufferRange(GL_UNIFORM_BUFFER, slot, object->_buffer, rangeStart, rangeSize);
 
         _uniform._buffers[slot] = uniformBuffer;
+        _uniform._offsets[slot] = rangeStart;
+        _uniform._sizes[slot] = rangeSize;
         (void) CHECK_GL_ERROR();
     } else {
         releaseUniformBuffer(slot);
@@ -192,9 +197,7 @@ void GLBackend::releaseResourceTexture(uint32_t slot) {
         auto* object = Backend::getGPUObject<GLTexture>(*tex);
         if (object) {
             GLuint target = object->_target;
-            glActiveTexture(GL_TEXTURE0 + slot);
-            glBindTexture(target, 0); // RELEASE
-            (void) CHECK_GL_ERROR();
+            bindResourceTexture(slot, target, 0); // RELEASE
         }
         tex.reset();
     }
@@ -207,6 +210,13 @@ void GLBackend::resetResourceStage() {
     for (uint32_t i = 0; i < _resource._textures.size(); i++) {
         releaseResourceTexture(i);
     }
+    updateResourceTextures();
+}
+
+void GLBackend::bindResourceTexture(uint32_t slot, GLenum target, GLuint texture) {
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(target, texture);
+    (void) CHECK_GL_ERROR();
 }
 
 
@@ -225,6 +235,7 @@ void GLBackend::do_setResourceBuffer(const Batch& batch, size_t paramOffset) {
     }
     // check cache before thinking
     if (_resource._buffers[slot] == resourceBuffer) {
+        _stats._RSNumRedundantBinds++;
         return;
     }
 
@@ -255,6 +266,7 @@ void GLBackend::do_setResourceTexture(const Batch& batch, size_t paramOffset) {
     }
     // check cache before thinking
     if (_resource._textures[slot] == resourceTexture) {
+        _stats._RSNumRedundantBinds++;
         return;
     }
 
@@ -266,10 +278,7 @@ void GLBackend::do_setResourceTexture(const Batch& batch, size_t paramOffset) {
     if (object) {
         GLuint to = object->_texture;
         GLuint target = object->_target;
-        glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(target, to);
-
-        (void) CHECK_GL_ERROR();
+        bindResourceTexture(slot, target, to);
 
         _resource._textures[slot] = resourceTexture;
 
@@ -9,6 +9,14 @@
 #include "GLShader.h"
 #include <gl/GLShaders.h>
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#include <PathUtils.h>
+
 using namespace gpu;
 using namespace gpu::gl;
 
@@ -56,6 +64,91 @@ static const std::array<std::string, GLShader::NumVersions> VERSION_DEFINES { {
     stereoVersion
 } };
 
+// Linked programs are cached on disk, with a name of the hash of what went into them and the driver they were made by
+static const QString PROGRAM_CACHE_DIRNAME = "shaders";
+static const QString PROGRAM_CACHE_EXT = ".bin";
+
+static const QString& getProgramCachePath() {
+    static const QString path = PathUtils::getAppLocalDataFilePath(PROGRAM_CACHE_DIRNAME);
+    return path;
+}
+
+static QString getProgramCacheFilePath(const QByteArray& key) {
+    return getProgramCachePath() + "/" + key.toHex() + PROGRAM_CACHE_EXT;
+}
+
+static bool isProgramCacheSupported() {
+    static const bool supported = [] {
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        return numFormats > 0 && QDir().mkpath(getProgramCachePath());
+    }();
+    return supported;
+}
+
+static GLuint loadCachedProgram(const QByteArray& key) {
+    QFile file(getProgramCacheFilePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    QDataStream in(&file);
+    quint32 format = 0;
+    QByteArray binary;
+    in >> format >> binary;
+
+    GLuint glprogram = 0;
+    if (in.status() == QDataStream::Ok) {
+        glprogram = ::gl::loadProgramBinary(format, binary.toStdString());
+    }
+    if (!glprogram) {
+        // It will be compiled again and replaced
+        file.remove();
+    }
+    return glprogram;
+}
+
+static void saveCachedProgram(const QByteArray& key, GLuint glprogram) {
+    GLenum format = 0;
+    std::string binary;
+    if (!::gl::getProgramBinary(glprogram, format, binary)) {
+        return;
+    }
+
+    QSaveFile file(getProgramCacheFilePath(key));
+    if (file.open(QIODevice::WriteOnly)) {
+        QDataStream out(&file);
+        out << (quint32)format << QByteArray(binary.data(), (int)binary.size());
+        file.commit();
+    }
+}
+
+std::string GLBackend::getShaderDefines(Shader::Type type, int version) const {
+    return getBackendShaderHeader() + "\n" + DOMAIN_DEFINES[type] + "\n" + VERSION_DEFINES[version];
+}
+
+QByteArray GLBackend::getProgramCacheKey(const Shader& program, int version) const {
+    static const std::string driver = [] {
+        std::string driver;
+        for (auto name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+            auto value = glGetString(name);
+            driver += value ? std::string((const char*)value) : std::string();
+            driver += "\n";
+        }
+        return driver;
+    }();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(driver.data(), (int)driver.size());
+    for (auto subShader : program.getShaders()) {
+        std::string defines = getShaderDefines(subShader->getType(), version);
+        const std::string& source = subShader->getSource().getCode();
+        hash.addData(defines.data(), (int)defines.size());
+        hash.addData(source.data(), (int)source.size());
+    }
+    return hash.result();
+}
+
 GLShader* GLBackend::compileBackendShader(const Shader& shader) {
     // Any GLSLprogram ? normally yes...
     const std::string& shaderSource = shader.getSource().getCode();
@@ -65,7 +158,7 @@ GLShader* GLBackend::compileBackendShader(const Shader& shader) {
     for (int version = 0; version < GLShader::NumVersions; version++) {
         auto& shaderObject = shaderObjects[version];
 
-        std::string shaderDefines = getBackendShaderHeader() + "\n" + DOMAIN_DEFINES[shader.getType()] + "\n" + VERSION_DEFINES[version];
+        std::string shaderDefines = getShaderDefines(shader.getType(), version);
         std::string error;
 
 #ifdef SEPARATE_PROGRAM
@@ -96,28 +189,43 @@ GLShader* GLBackend::compileBackendProgram(const Shader& program) {
     for (int version = 0; version < GLShader::NumVersions; version++) {
         auto& programObject = programObjects[version];
 
-        // Let's go through every shaders and make sure they are ready to go
-        std::vector< GLuint > shaderGLObjects;
-        for (auto subShader : program.getShaders()) {
-            auto object = GLShader::sync((*this), *subShader);
-            if (object) {
-                shaderGLObjects.push_back(object->_shaderObjects[version].glshader);
-            } else {
-                qCWarning(gpugllogging) << "GLBackend::compileBackendProgram - One of the shaders of the program is not compiled?";
-                return nullptr;
-            }
+        QByteArray cacheKey;
+        GLuint glprogram = 0;
+        if (isProgramCacheSupported()) {
+            cacheKey = getProgramCacheKey(program, version);
+            glprogram = loadCachedProgram(cacheKey);
         }
+        bool isCached = (glprogram != 0);
+
+        if (!isCached) {
+            // Let's go through every shaders and make sure they are ready to go
+            std::vector< GLuint > shaderGLObjects;
+            for (auto subShader : program.getShaders()) {
+                auto object = GLShader::sync((*this), *subShader);
+                if (object) {
+                    shaderGLObjects.push_back(object->_shaderObjects[version].glshader);
+                } else {
+                    qCWarning(gpugllogging) << "GLBackend::compileBackendProgram - One of the shaders of the program is not compiled?";
+                    return nullptr;
+                }
+            }
 
-        std::string error;
-        GLuint glprogram = ::gl::compileProgram(shaderGLObjects, error);
-        if (glprogram == 0) {
-            qCWarning(gpugllogging) << "GLBackend::compileBackendProgram - Program didn't link:\n" << error.c_str();
-            return nullptr;
+            std::string error;
+            glprogram = ::gl::compileProgram(shaderGLObjects, error);
+            if (glprogram == 0) {
+                qCWarning(gpugllogging) << "GLBackend::compileBackendProgram - Program didn't link:\n" << error.c_str();
+                return nullptr;
+            }
         }
 
         programObject.glprogram = glprogram;
 
         makeProgramBindings(programObject);
+
+        // The binary has the attribute locations in it but not the bindings, those are made again when it is loaded
+        if (!isCached && !cacheKey.isEmpty()) {
+            saveCachedProgram(cacheKey, glprogram);
+        }
     }
 
     // So far so good, the program versions have all been created successfully
@@ -506,12 +614,17 @@ void GLBackend::makeProgramBindings(ShaderObject& shaderObject) {
     }
 
     // Link again to take into account the assigned attrib location
-    glLinkProgram(glprogram);
-
-    GLint linked = 0;
-    glGetProgramiv(glprogram, GL_LINK_STATUS, &linked);
-    if (!linked) {
-        qCWarning(gpugllogging) << "GLShader::makeBindings - failed to link after assigning slotBindings?";
+    // A program loaded from its binary has them already, and nothing attached to link again
+    GLint numAttachedShaders = 0;
+    glGetProgramiv(glprogram, GL_ATTACHED_SHADERS, &numAttachedShaders);
+    if (numAttachedShaders > 0) {
+        glLinkProgram(glprogram);
+
+        GLint linked = 0;
+        glGetProgramiv(glprogram, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            qCWarning(gpugllogging) << "GLShader::makeBindings - failed to link after assigning slotBindings?";
+        }
     }
 }
 
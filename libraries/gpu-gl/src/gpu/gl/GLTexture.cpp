@@ -10,6 +10,7 @@
 
 #include <QtCore/QThread>
 #include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "GLBackend.h"
 
@@ -124,7 +125,9 @@ Size GLTexture::copyMipFaceFromTexture(uint16_t sourceMip, uint16_t targetMip, u
     auto mipSize = _gpuObject.getStoredMipFaceSize(sourceMip, face);
     if (mipData) {
         GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(_gpuObject.getTexelFormat(), _gpuObject.getStoredMipFormat());
-        return copyMipFaceLinesFromTexture(targetMip, face, dim, 0, texelFormat.internalFormat, texelFormat.format, texelFormat.type, mipSize, mipData->readData());
+        auto copiedSize = copyMipFaceLinesFromTexture(targetMip, face, dim, 0, texelFormat.internalFormat, texelFormat.format, texelFormat.type, mipSize, mipData->readData());
+        mipData->advise(storage::Residency::NotNeeded);
+        return copiedSize;
     } else {
         qCDebug(gpugllogging) << "Missing mipData level=" << sourceMip << " face=" << (int)face << " for texture " << _gpuObject.source().c_str();
     }
@@ -160,6 +163,7 @@ using TransferJobPointer = GLVariableAllocationSupport::TransferJobPointer;
 std::list<TextureWeakPointer> GLVariableAllocationSupport::_memoryManagedTextures;
 MemoryPressureState GLVariableAllocationSupport::_memoryPressureState { MemoryPressureState::Idle };
 std::atomic<bool> GLVariableAllocationSupport::_memoryPressureStateStale { false };
+uint64_t GLVariableAllocationSupport::_lastDesiredMipsUpdate { 0 };
 const uvec3 GLVariableAllocationSupport::INITIAL_MIP_TRANSFER_DIMENSIONS { 64, 64, 1 };
 WorkQueue GLVariableAllocationSupport::_transferQueue;
 WorkQueue GLVariableAllocationSupport::_promoteQueue;
@@ -172,22 +176,43 @@ size_t GLVariableAllocationSupport::_frameTexturesCreated { 0 };
 
 static const size_t DEFAULT_ALLOWED_TEXTURE_MEMORY = MB_TO_BYTES(DEFAULT_ALLOWED_TEXTURE_MEMORY_MB);
 
+// How often the renderer's mip feedback is looked at
+static const uint64_t DESIRED_MIPS_UPDATE_USECS = USECS_PER_SECOND / 2;
+
+// Work queue priorities are ordered by how many mips a texture is away from what it is drawn at, and then by
+// size, scaled to stay below one mip for any texture we can allocate
+static const float WORK_QUEUE_SIZE_SCALE = 1.0f / (float)(8192 * 8192 * 4);
+
 using TransferJob = GLVariableAllocationSupport::TransferJob;
 
 const uvec3 GLVariableAllocationSupport::MAX_TRANSFER_DIMENSIONS { 1024, 1024, 1 };
 const size_t GLVariableAllocationSupport::MAX_TRANSFER_SIZE = GLVariableAllocationSupport::MAX_TRANSFER_DIMENSIONS.x * GLVariableAllocationSupport::MAX_TRANSFER_DIMENSIONS.y * 4;
 
+// Each frame uploads about as much as the measured upload speed allows in this time, within the limits below
+static const float TRANSFER_TIME_BUDGET_USECS = 2000.0f;
+static const size_t MIN_TRANSFER_BUDGET = MB_TO_BYTES(1);
+static const size_t MAX_TRANSFER_BUDGET = MB_TO_BYTES(64);
+static const int MAX_TRANSFERS_PER_FRAME = 32;
+// Too small a transfer says more about call overhead than upload speed
+static const size_t MIN_MEASURED_TRANSFER_SIZE = 64 * 1024;
+static const float TRANSFER_SPEED_SMOOTHING = 0.1f;
+
+float GLVariableAllocationSupport::_transferBytesPerUsec { 1000.0f };
+
 #if THREADED_TEXTURE_BUFFERING
 
-TexturePointer GLVariableAllocationSupport::_currentTransferTexture;
-TransferJobPointer GLVariableAllocationSupport::_currentTransferJob;
+// Several jobs buffer at once so that uploads don't wait on the disk one mip at a time
+static const size_t MAX_BUFFERING_JOBS = 16;
+static const int NUM_BUFFERING_THREADS = 2;
+
+std::list<std::pair<TexturePointer, TransferJobPointer>> GLVariableAllocationSupport::_bufferingJobs;
 QThreadPool* TransferJob::_bufferThreadPool { nullptr };
 
 void TransferJob::startBufferingThread() {
     static std::once_flag once;
     std::call_once(once, [&] {
         _bufferThreadPool = new QThreadPool(qApp);
-        _bufferThreadPool->setMaxThreadCount(1);
+        _bufferThreadPool->setMaxThreadCount(NUM_BUFFERING_THREADS);
     });
 }
 
@@ -226,6 +251,10 @@ TransferJob::TransferJob(const GLTexture& parent, uint16_t sourceMip, uint16_t t
         auto mipStorage = _parent._gpuObject.accessStoredMipFace(sourceMip, face);
         if (mipStorage) {
             _mipData = mipStorage->createView(_transferSize, _transferOffset);
+            // a mip mapped from a KTX file is paged in here rather than by the transfer
+            if (_mipData) {
+                _mipData->advise(storage::Residency::Needed);
+            }
         } else {
             qCWarning(gpugllogging) << "Buffering failed because mip could not be retrieved from texture " << _parent._source.c_str() ;
         }
@@ -234,6 +263,8 @@ TransferJob::TransferJob(const GLTexture& parent, uint16_t sourceMip, uint16_t t
     _transferLambda = [=] {
         if (_mipData) {
             _parent.copyMipFaceLinesFromTexture(targetMip, face, transferDimensions, lineOffset, internalFormat, format, type, _mipData->size(), _mipData->readData());
+            // the GPU has its copy now, a demoted mip is paged in again from the file if it gets promoted
+            _mipData->advise(storage::Residency::NotNeeded);
             _mipData.reset();
         } else {
             qCWarning(gpugllogging) << "Transfer failed because mip could not be retrieved from texture " << _parent._source.c_str();
@@ -327,15 +358,19 @@ void GLVariableAllocationSupport::addToWorkQueue(const TexturePointer& texturePo
     switch (_memoryPressureState) {
         case MemoryPressureState::Oversubscribed:
             if (vargltexture->canDemote()) {
-                // Demote largest first
-                _demoteQueue.push({ texturePointer, (float)gltexture->size() });
+                // Demote what has more detail than it is drawn at first, then largest first
+                float surplusMips = (float)std::max(0, vargltexture->_desiredMip - vargltexture->_allocatedMip);
+                float sizePriority = std::min((float)gltexture->size() * WORK_QUEUE_SIZE_SCALE, 0.99f);
+                _demoteQueue.push({ texturePointer, surplusMips + sizePriority });
             }
             break;
 
         case MemoryPressureState::Undersubscribed:
-            if (vargltexture->canPromote()) {
-                // Promote smallest first
-                _promoteQueue.push({ texturePointer, 1.0f / (float)gltexture->size() });
+            if (vargltexture->wantsPromote()) {
+                // Promote what is furthest from the detail it is drawn at first, then smallest first
+                float missingMips = (float)(vargltexture->_allocatedMip - vargltexture->_desiredMip);
+                float sizePriority = std::min((float)gltexture->size() * WORK_QUEUE_SIZE_SCALE, 0.99f);
+                _promoteQueue.push({ texturePointer, missingMips - sizePriority });
             }
             break;
 
@@ -405,10 +440,21 @@ void GLVariableAllocationSupport::updateMemoryPressure() {
         lastAllowedMemoryAllocation = allowedMemoryAllocation;
     }
 
+    // The feedback from the renderer changes without anything else happening
+    uint64_t now = usecTimestampNow();
+    if (now - _lastDesiredMipsUpdate > DESIRED_MIPS_UPDATE_USECS) {
+        _memoryPressureStateStale = true;
+    }
+
     if (!_memoryPressureStateStale.exchange(false)) {
         return;
     }
 
+    bool updateDesiredMips = now - _lastDesiredMipsUpdate > DESIRED_MIPS_UPDATE_USECS;
+    if (updateDesiredMips) {
+        _lastDesiredMipsUpdate = now;
+    }
+
     PROFILE_RANGE(render_gpu_gl, __FUNCTION__);
 
     // Clear any defunct textures (weak pointers that no longer have a valid texture)
@@ -431,6 +477,7 @@ void GLVariableAllocationSupport::updateMemoryPressure() {
     bool canDemote = false;
     bool canPromote = false;
     bool hasTransfers = false;
+    bool desiredMipsChanged = false;
     for (const auto& texture : strongTextures) {
         // Race conditions can still leave nulls in the list, so we need to check
         if (!texture) {
@@ -438,16 +485,20 @@ void GLVariableAllocationSupport::updateMemoryPressure() {
         }
         GLTexture* gltexture = Backend::getGPUObject<GLTexture>(*texture);
         GLVariableAllocationSupport* vartexture = dynamic_cast<GLVariableAllocationSupport*>(gltexture);
+        if (updateDesiredMips) {
+            desiredMipsChanged |= vartexture->updateDesiredMip(*texture);
+        }
         // Track how much the texture thinks it should be using
-        idealMemoryAllocation += texture->evalTotalSize();
+        idealMemoryAllocation += texture->evalTotalSize(vartexture->_desiredMip);
         // Track how much we're actually using
         totalVariableMemoryAllocation += gltexture->size();
         canDemote |= vartexture->canDemote();
-        canPromote |= vartexture->canPromote();
+        canPromote |= vartexture->wantsPromote();
         hasTransfers |= vartexture->hasPendingTransfers();
     }
 
-    size_t unallocated = idealMemoryAllocation - totalVariableMemoryAllocation;
+    size_t unallocated = idealMemoryAllocation > totalVariableMemoryAllocation ?
+        idealMemoryAllocation - totalVariableMemoryAllocation : 0;
     float pressure = (float)totalVariableMemoryAllocation / (float)allowedMemoryAllocation;
 
     auto newState = MemoryPressureState::Idle;
@@ -459,7 +510,8 @@ void GLVariableAllocationSupport::updateMemoryPressure() {
         newState = MemoryPressureState::Transfer;
     }
 
-    if (newState != _memoryPressureState) {
+    // New feedback reorders the queues even if the state stays the same
+    if (newState != _memoryPressureState || (desiredMipsChanged && newState != MemoryPressureState::Idle)) {
         _memoryPressureState = newState;
         // Clear the existing queue
         _transferQueue = WorkQueue();
@@ -498,7 +550,7 @@ TexturePointer GLVariableAllocationSupport::getNextWorkQueueItem(WorkQueue& work
                 break;
 
             case MemoryPressureState::Undersubscribed:
-                if (vartexture->canPromote()) {
+                if (vartexture->wantsPromote()) {
                     return texture;
                 }
                 break;
@@ -554,25 +606,82 @@ void GLVariableAllocationSupport::processWorkQueue(WorkQueue& workQueue) {
             break;
 
         case MemoryPressureState::Transfer:
-            if (vartexture->executeNextTransfer(texture)) {
-                workQueue.pop();
-                addToWorkQueue(texture);
+        case MemoryPressureState::Idle:
+            Q_UNREACHABLE();
+            break;
+    }
+}
+
+void GLVariableAllocationSupport::processTransferQueue() {
+    PROFILE_RANGE(render_gpu_gl, __FUNCTION__);
 
 #if THREADED_TEXTURE_BUFFERING
-                // Eagerly start the next buffering job if possible
-                texture = getNextWorkQueueItem(workQueue);
-                if (texture) {
-                    gltexture = Backend::getGPUObject<GLTexture>(*texture);
-                    vartexture = dynamic_cast<GLVariableAllocationSupport*>(gltexture);
-                    vartexture->executeNextBuffer(texture);
-                }
+    // Let go of buffered jobs that won't be transferred, because a rebuilt transfer queue dropped them or because
+    // nothing else uses their texture anymore
+    _bufferingJobs.remove_if([](const std::pair<TexturePointer, TransferJobPointer>& bufferingJob) {
+        return bufferingJob.second->bufferingCompleted() &&
+            (bufferingJob.second.use_count() == 1 || bufferingJob.first.use_count() == 1);
+    });
 #endif
-            }
+
+    size_t transferBudget = (size_t)(_transferBytesPerUsec * TRANSFER_TIME_BUDGET_USECS);
+    transferBudget = std::max(MIN_TRANSFER_BUDGET, std::min(MAX_TRANSFER_BUDGET, transferBudget));
+
+    size_t transferred = 0;
+    uint64_t transferUsecs = 0;
+    int numTransfers = 0;
+    std::vector<TexturePointer> skippedTextures;
+    while (true) {
+        bool canTransfer = transferred < transferBudget && numTransfers < MAX_TRANSFERS_PER_FRAME;
+#if THREADED_TEXTURE_BUFFERING
+        // Once the budget is spent, keep going only to get what comes next buffering
+        if (!canTransfer && !canBufferMoreTransfers()) {
+            break;
+        }
+#else
+        if (!canTransfer) {
             break;
+        }
+#endif
 
-        case MemoryPressureState::Idle:
-            Q_UNREACHABLE();
+        auto texture = getNextWorkQueueItem(_transferQueue);
+        if (!texture) {
             break;
+        }
+        _transferQueue.pop();
+
+        GLTexture* gltexture = Backend::getGPUObject<GLTexture>(*texture);
+        GLVariableAllocationSupport* vartexture = dynamic_cast<GLVariableAllocationSupport*>(gltexture);
+
+        if (!canTransfer) {
+#if THREADED_TEXTURE_BUFFERING
+            vartexture->bufferNextTransfer(texture);
+#endif
+            skippedTextures.push_back(texture);
+            continue;
+        }
+
+        uint64_t start = usecTimestampNow();
+        size_t transferSize = 0;
+        if (vartexture->executeNextTransfer(texture, transferSize)) {
+            transferUsecs += usecTimestampNow() - start;
+            transferred += transferSize;
+            ++numTransfers;
+            // Back in the queue with the priority of its next mip
+            addToWorkQueue(texture);
+        } else {
+            // Still buffering, the textures behind it get their turn meanwhile
+            skippedTextures.push_back(texture);
+        }
+    }
+
+    for (const auto& texture : skippedTextures) {
+        addToWorkQueue(texture);
+    }
+
+    if (transferred >= MIN_MEASURED_TRANSFER_SIZE && transferUsecs > 0) {
+        float bytesPerUsec = (float)transferred / (float)transferUsecs;
+        _transferBytesPerUsec += (bytesPerUsec - _transferBytesPerUsec) * TRANSFER_SPEED_SMOOTHING;
     }
 }
 
@@ -582,8 +691,12 @@ void GLVariableAllocationSupport::processWorkQueues() {
     }
 
     auto& workQueue = getActiveWorkQueue();
-    // Do work on the front of the queue
-    processWorkQueue(workQueue);
+    if (MemoryPressureState::Transfer == _memoryPressureState) {
+        processTransferQueue();
+    } else {
+        // Do work on the front of the queue
+        processWorkQueue(workQueue);
+    }
 
     if (workQueue.empty()) {
         _memoryPressureState = MemoryPressureState::Idle;
@@ -591,27 +704,31 @@ void GLVariableAllocationSupport::processWorkQueues() {
     }
 }
 
+bool GLVariableAllocationSupport::updateDesiredMip(const Texture& texture) {
+    uint16 desiredMip = _minAllocatedMip;
+    if (texture.hasMipRequests()) {
+        uint16 requestedMip = texture.getRequestedMip();
+        if (requestedMip == Texture::MIP_NOT_REQUESTED) {
+            // Not drawn lately, the first to go when memory runs out
+            desiredMip = _maxAllocatedMip;
+        } else {
+            desiredMip = std::max(_minAllocatedMip, std::min(_maxAllocatedMip, requestedMip));
+        }
+    }
+
+    bool changed = desiredMip != _desiredMip;
+    _desiredMip = desiredMip;
+    return changed;
+}
+
 void GLVariableAllocationSupport::manageMemory() {
     PROFILE_RANGE(render_gpu_gl, __FUNCTION__);
     updateMemoryPressure();
     processWorkQueues();
 }
 
-bool GLVariableAllocationSupport::executeNextTransfer(const TexturePointer& currentTexture) {
-#if THREADED_TEXTURE_BUFFERING
-    // If a transfer job is active on the buffering thread, but has not completed it's buffering lambda,
-    // then we need to exit early, since we don't want to have the transfer job leave scope while it's 
-    // being used in another thread -- See https://highfidelity.fogbugz.com/f/cases/4626
-    if (_currentTransferJob && !_currentTransferJob->bufferingCompleted()) {
-        return false;
-    }
-#endif
-
+bool GLVariableAllocationSupport::executeNextTransfer(const TexturePointer& currentTexture, size_t& transferSize) {
     if (_populatedMip <= _allocatedMip) {
-#if THREADED_TEXTURE_BUFFERING
-        _currentTransferJob.reset();
-        _currentTransferTexture.reset();
-#endif
         return true;
     }
 
@@ -620,61 +737,59 @@ bool GLVariableAllocationSupport::executeNextTransfer(const TexturePointer& curr
         populateTransferQueue();
     }
 
-    bool result = false;
-    if (!_pendingTransfers.empty()) {
-#if THREADED_TEXTURE_BUFFERING
-        // If there is a current transfer, but it's not the top of the pending transfer queue, then it's an orphan, so we want to abandon it.
-        if (_currentTransferJob && _currentTransferJob != _pendingTransfers.front()) {
-            _currentTransferJob.reset();
-        }
+    if (_pendingTransfers.empty()) {
+        return false;
+    }
 
-        if (!_currentTransferJob) {
-            // Keeping hold of a strong pointer to the transfer job ensures that if the pending transfer queue is rebuilt, the transfer job
-            // doesn't leave scope, causing a crash in the buffering thread
-            _currentTransferJob = _pendingTransfers.front();
+    auto transferJob = _pendingTransfers.front();
+#if THREADED_TEXTURE_BUFFERING
+    // transfer jobs use asynchronous buffering of the texture data because it may involve disk IO, a job only
+    // transfers once its buffering is complete
+    if (!transferJob->bufferingCompleted()) {
+        bufferNextTransfer(currentTexture);
+        return false;
+    }
+#endif
 
-            // Keeping hold of a strong pointer during the transfer ensures that the transfer thread cannot try to access a destroyed texture
-            _currentTransferTexture = currentTexture;
-        }
+    transferJob->tryTransfer();
+    _pendingTransfers.pop();
+    transferSize = transferJob->getTransferSize();
 
-        // transfer jobs use asynchronous buffering of the texture data because it may involve disk IO, so we execute a try here to determine if the buffering 
-        // is complete
-        if (_currentTransferJob->tryTransfer()) {
-            _pendingTransfers.pop();
-            // Once a given job is finished, release the shared pointers keeping them alive
-            _currentTransferTexture.reset();
-            _currentTransferJob.reset();
-            result = true;
-        }
-#else
-        if (_pendingTransfers.front()->tryTransfer()) {
-            _pendingTransfers.pop();
-            result = true;
-        }
+#if THREADED_TEXTURE_BUFFERING
+    // Once a given job is finished, release the shared pointers keeping it alive
+    _bufferingJobs.remove_if([&](const std::pair<TexturePointer, TransferJobPointer>& bufferingJob) {
+        return bufferingJob.second == transferJob;
+    });
 #endif
-    }
-    return result;
+    return true;
 }
 
 #if THREADED_TEXTURE_BUFFERING
-void GLVariableAllocationSupport::executeNextBuffer(const TexturePointer& currentTexture) {
-    if (_currentTransferJob && !_currentTransferJob->bufferingCompleted()) {
-        return;
-    }
+bool GLVariableAllocationSupport::canBufferMoreTransfers() {
+    return _bufferingJobs.size() < MAX_BUFFERING_JOBS;
+}
 
+void GLVariableAllocationSupport::bufferNextTransfer(const TexturePointer& currentTexture) {
     // If the transfer queue is empty, rebuild it
     if (_pendingTransfers.empty()) {
         populateTransferQueue();
     }
 
-    if (!_pendingTransfers.empty()) {
-        if (!_currentTransferJob) {
-            _currentTransferJob = _pendingTransfers.front();
-            _currentTransferTexture = currentTexture;
-        }
+    if (_pendingTransfers.empty() || !canBufferMoreTransfers()) {
+        return;
+    }
 
-        _currentTransferJob->startBuffering();
+    // Already buffering or buffered, or nothing to buffer
+    const auto& transferJob = _pendingTransfers.front();
+    if (!transferJob->bufferingRequired()) {
+        return;
     }
+
+    // Keeping hold of strong pointers to the job and its texture ensures that neither leaves scope while the
+    // buffering thread uses them, even if the pending transfer queue is rebuilt in the meantime
+    // -- See https://highfidelity.fogbugz.com/f/cases/4626
+    _bufferingJobs.push_back({ currentTexture, transferJob });
+    transferJob->startBuffering();
 }
 #endif
 
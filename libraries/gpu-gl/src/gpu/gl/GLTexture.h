@@ -71,6 +71,7 @@ public:
         TransferJob(const GLTexture& parent, uint16_t sourceMip, uint16_t targetMip, uint8_t face, uint32_t lines = 0, uint32_t lineOffset = 0);
         ~TransferJob();
         bool tryTransfer();
+        size_t getTransferSize() const { return _transferSize; }
 
 #if THREADED_TEXTURE_BUFFERING
         void startBuffering();
@@ -93,14 +94,17 @@ public:
 protected:
     static size_t _frameTexturesCreated;
     static std::atomic<bool> _memoryPressureStateStale;
+    static uint64_t _lastDesiredMipsUpdate;
     static std::list<TextureWeakPointer> _memoryManagedTextures;
     static WorkQueue _transferQueue;
     static WorkQueue _promoteQueue;
     static WorkQueue _demoteQueue;
 #if THREADED_TEXTURE_BUFFERING
-    static TexturePointer _currentTransferTexture;
-    static TransferJobPointer _currentTransferJob;
+    // The jobs being buffered, with their texture, so that neither goes away while the buffering threads use them
+    static std::list<std::pair<TexturePointer, TransferJobPointer>> _bufferingJobs;
 #endif
+    // Measured upload speed, which sets how much is transferred each frame
+    static float _transferBytesPerUsec;
     static const uvec3 INITIAL_MIP_TRANSFER_DIMENSIONS;
     static const uvec3 MAX_TRANSFER_DIMENSIONS;
     static const size_t MAX_TRANSFER_SIZE;
@@ -109,6 +113,7 @@ protected:
     static void updateMemoryPressure();
     static void processWorkQueues();
     static void processWorkQueue(WorkQueue& workQueue);
+    static void processTransferQueue();
     static TexturePointer getNextWorkQueueItem(WorkQueue& workQueue);
     static void addToWorkQueue(const TexturePointer& texture);
     static WorkQueue& getActiveWorkQueue();
@@ -119,10 +124,16 @@ protected:
     bool canPromote() const { return _allocatedMip > _minAllocatedMip; }
     bool canDemote() const { return _allocatedMip < _maxAllocatedMip; }
     bool hasPendingTransfers() const { return _populatedMip > _allocatedMip; }
+    // Promotion stops at the detail the texture is drawn at
+    bool wantsPromote() const { return canPromote() && _allocatedMip > _desiredMip; }
+    // Returns true if the mip the renderer asks for has changed since last time
+    bool updateDesiredMip(const Texture& texture);
 #if THREADED_TEXTURE_BUFFERING
-    void executeNextBuffer(const TexturePointer& currentTexture);
+    static bool canBufferMoreTransfers();
+    void bufferNextTransfer(const TexturePointer& currentTexture);
 #endif
-    bool executeNextTransfer(const TexturePointer& currentTexture);
+    // Returns false if the next transfer is still being buffered, transferSize is what was uploaded
+    bool executeNextTransfer(const TexturePointer& currentTexture, size_t& transferSize);
     virtual void populateTransferQueue() = 0;
     virtual void promote() = 0;
     virtual void demote() = 0;
@@ -148,6 +159,8 @@ protected:
     // The lowest (highest resolution) mip that we will support, relative to the number
     // of mips in the gpu::Texture object
     uint16 _minAllocatedMip { 0 };
+    // The mip the renderer's screen space feedback asks for, between _minAllocatedMip and _maxAllocatedMip
+    uint16 _desiredMip { 0 };
     // Contains a series of lambdas that when executed will transfer data to the GPU, modify 
     // the _populatedMip and update the sampler in order to fully populate the allocated texture 
     // until _populatedMip == _allocatedMip
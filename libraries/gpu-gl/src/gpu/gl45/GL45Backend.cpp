@@ -154,6 +154,26 @@ void GL45Backend::do_drawIndexedInstanced(const Batch& batch, size_t paramOffset
 void GL45Backend::do_multiDrawIndirect(const Batch& batch, size_t paramOffset) {
     uint commandCount = batch._params[paramOffset + 0]._uint;
     GLenum mode = gl::PRIMITIVE_TO_GL[(Primitive)batch._params[paramOffset + 1]._uint];
+
+#ifdef GPU_STEREO_DRAWCALL_INSTANCED
+    // The commands in the indirect buffer draw each instance once, but the stereo shaders pick the eye from
+    // gl_InstanceID, so in stereo each command is drawn with twice its instances from the CPU copy of the buffer
+    if (isStereo() && _input._indirectBuffer) {
+        auto stride = _input._indirectBufferStride ? _input._indirectBufferStride : sizeof(Batch::DrawIndirectCommand);
+        auto commands = _input._indirectBuffer->getData() + _input._indirectBufferOffset;
+        for (uint i = 0; i < commandCount; ++i) {
+            auto command = reinterpret_cast<const Batch::DrawIndirectCommand*>(commands + i * stride);
+            GLint trueNumInstances = 2 * command->_instanceCount;
+            glDrawArraysInstancedBaseInstance(mode, command->_firstIndex, command->_count, trueNumInstances, command->_baseInstance);
+            _stats._DSNumTriangles += (trueNumInstances * command->_count) / 3;
+            _stats._DSNumDrawcalls += trueNumInstances;
+            _stats._DSNumAPIDrawcalls++;
+        }
+        (void)CHECK_GL_ERROR();
+        return;
+    }
+#endif
+
     glMultiDrawArraysIndirect(mode, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
     _stats._DSNumDrawcalls += commandCount;
     _stats._DSNumAPIDrawcalls++;
@@ -164,6 +184,27 @@ void GL45Backend::do_multiDrawIndexedIndirect(const Batch& batch, size_t paramOf
     uint commandCount = batch._params[paramOffset + 0]._uint;
     GLenum mode = gl::PRIMITIVE_TO_GL[(Primitive)batch._params[paramOffset + 1]._uint];
     GLenum indexType = gl::ELEMENT_TYPE_TO_GL[_input._indexBufferType];
+
+#ifdef GPU_STEREO_DRAWCALL_INSTANCED
+    if (isStereo() && _input._indirectBuffer) {
+        auto stride = _input._indirectBufferStride ? _input._indirectBufferStride : sizeof(Batch::DrawIndexedIndirectCommand);
+        auto commands = _input._indirectBuffer->getData() + _input._indirectBufferOffset;
+        auto typeByteSize = TYPE_SIZE[_input._indexBufferType];
+        for (uint i = 0; i < commandCount; ++i) {
+            auto command = reinterpret_cast<const Batch::DrawIndexedIndirectCommand*>(commands + i * stride);
+            GLint trueNumInstances = 2 * command->_instanceCount;
+            GLvoid* indexBufferByteOffset = reinterpret_cast<GLvoid*>(command->_firstIndex * typeByteSize + _input._indexBufferOffset);
+            glDrawElementsInstancedBaseVertexBaseInstance(mode, command->_count, indexType, indexBufferByteOffset,
+                trueNumInstances, command->_baseVertex, command->_baseInstance);
+            _stats._DSNumTriangles += (trueNumInstances * command->_count) / 3;
+            _stats._DSNumDrawcalls += trueNumInstances;
+            _stats._DSNumAPIDrawcalls++;
+        }
+        (void)CHECK_GL_ERROR();
+        return;
+    }
+#endif
+
     glMultiDrawElementsIndirect(mode, indexType, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
     _stats._DSNumDrawcalls += commandCount;
     _stats._DSNumAPIDrawcalls++;
@@ -201,6 +201,15 @@ protected:
     // Resource Stage
     bool bindResourceBuffer(uint32_t slot, BufferPointer& buffer) override;
     void releaseResourceBuffer(uint32_t slot) override;
+    void bindResourceTexture(uint32_t slot, GLenum target, GLuint texture) override;
+    void updateResourceTextures() override;
+
+    // The textures of the units, bound all at once for the next draw with the units that changed since the last one
+    struct TextureUnitsState {
+        std::array<GLuint, MAX_NUM_RESOURCE_TEXTURES> _textures {};
+        uint32_t _dirtyBegin { MAX_NUM_RESOURCE_TEXTURES };
+        uint32_t _dirtyEnd { 0 };
+    } _textureUnits;
 
     // Output stage
     void do_blit(const Batch& batch, size_t paramOffset) override;
@@ -98,6 +98,27 @@ GLTexture* GL45Backend::syncGPUObject(const TexturePointer& texturePointer) {
     return object;
 }
 
+void GL45Backend::bindResourceTexture(uint32_t slot, GLenum target, GLuint texture) {
+    // a texture is bound to its own target by glBindTextures
+    _textureUnits._textures[slot] = texture;
+    _textureUnits._dirtyBegin = std::min(_textureUnits._dirtyBegin, slot);
+    _textureUnits._dirtyEnd = std::max(_textureUnits._dirtyEnd, slot + 1);
+}
+
+void GL45Backend::updateResourceTextures() {
+    if (_textureUnits._dirtyBegin >= _textureUnits._dirtyEnd) {
+        return;
+    }
+
+    // the units in between that didn't change are bound again to the same textures
+    glBindTextures(_textureUnits._dirtyBegin, _textureUnits._dirtyEnd - _textureUnits._dirtyBegin,
+                   _textureUnits._textures.data() + _textureUnits._dirtyBegin);
+    (void)CHECK_GL_ERROR();
+
+    _textureUnits._dirtyBegin = MAX_NUM_RESOURCE_TEXTURES;
+    _textureUnits._dirtyEnd = 0;
+}
+
 void GL45Backend::initTextureManagementStage() {
     // enable the Sparse Texture on gl45
     _textureManagement._sparseCapable = true;
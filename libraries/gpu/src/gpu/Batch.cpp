@@ -12,6 +12,9 @@
 
 #include <string.h>
 
+#include <memory>
+#include <mutex>
+
 #include <QDebug>
 
 #if defined(NSIGHT_FOUND)
@@ -37,13 +40,79 @@ size_t Batch::_dataMax { BATCH_PREALLOCATE_MIN };
 size_t Batch::_objectsMax { BATCH_PREALLOCATE_MIN };
 size_t Batch::_drawCallInfosMax { BATCH_PREALLOCATE_MIN };
 
+std::atomic<size_t> Batch::_numStorageAllocations { 0 };
+std::atomic<size_t> Batch::_numStorageReuses { 0 };
+
+// The emptied storage of batches that went away, which new batches take over rather than allocate their own.
+// Batches are recorded on the main thread and go away on the render thread with their frame, so it is shared.
+namespace {
+
+struct BatchStorage {
+    Batch::Commands commands;
+    Batch::CommandOffsets commandOffsets;
+    Batch::Params params;
+    Batch::Bytes data;
+    Batch::TransformObjects objects;
+    Batch::DrawCallInfoBuffer drawCallInfos;
+    std::vector<Batch::Cache<BufferPointer>> buffers;
+    std::vector<Batch::Cache<TexturePointer>> textures;
+    std::vector<Batch::Cache<Stream::FormatPointer>> streamFormats;
+    std::vector<Batch::Cache<Transform>> transforms;
+    std::vector<Batch::Cache<PipelinePointer>> pipelines;
+    std::vector<Batch::Cache<FramebufferPointer>> framebuffers;
+};
+
+// about as many batches as there are in a frame
+const size_t MAX_POOLED_BATCH_STORAGE = 64;
+
+struct BatchStoragePool {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<BatchStorage>> storage;
+};
+
+// never destroyed, batches can outlive the statics at exit
+BatchStoragePool& getBatchStoragePool() {
+    static BatchStoragePool* pool = new BatchStoragePool();
+    return *pool;
+}
+
+}
+
 Batch::Batch() {
+    auto& pool = getBatchStoragePool();
+    std::unique_ptr<BatchStorage> storage;
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (!pool.storage.empty()) {
+            storage = std::move(pool.storage.back());
+            pool.storage.pop_back();
+        }
+    }
+
+    if (storage) {
+        _commands.swap(storage->commands);
+        _commandOffsets.swap(storage->commandOffsets);
+        _params.swap(storage->params);
+        _data.swap(storage->data);
+        _objects.swap(storage->objects);
+        _drawCallInfos.swap(storage->drawCallInfos);
+        _buffers._items.swap(storage->buffers);
+        _textures._items.swap(storage->textures);
+        _streamFormats._items.swap(storage->streamFormats);
+        _transforms._items.swap(storage->transforms);
+        _pipelines._items.swap(storage->pipelines);
+        _framebuffers._items.swap(storage->framebuffers);
+        _numStorageReuses++;
+        return;
+    }
+
     _commands.reserve(_commandsMax);
     _commandOffsets.reserve(_commandOffsetsMax);
     _params.reserve(_paramsMax);
     _data.reserve(_dataMax);
     _objects.reserve(_objectsMax);
     _drawCallInfos.reserve(_drawCallInfosMax);
+    _numStorageAllocations++;
 }
 
 Batch::Batch(const Batch& batch_) {
@@ -66,6 +135,7 @@ Batch::Batch(const Batch& batch_) {
     _drawCallInfos.swap(batch._drawCallInfos);
     _queries._items.swap(batch._queries._items);
     _lambdas._items.swap(batch._lambdas._items);
+    _readbackHandlers._items.swap(batch._readbackHandlers._items);
     _profileRanges._items.swap(batch._profileRanges._items);
     _names._items.swap(batch._names._items);
     _namedData.swap(batch._namedData);
@@ -74,12 +144,37 @@ Batch::Batch(const Batch& batch_) {
 }
 
 Batch::~Batch() {
-    _commandsMax = std::max(_commands.size(), _commandsMax);
-    _commandOffsetsMax = std::max(_commandOffsets.size(), _commandOffsetsMax);
-    _paramsMax = std::max(_params.size(), _paramsMax);
-    _dataMax = std::max(_data.size(), _dataMax);
-    _objectsMax = std::max(_objects.size(), _objectsMax);
-    _drawCallInfosMax = std::max(_drawCallInfos.size(), _drawCallInfosMax);
+    // the storage of a batch that was copied from has gone with the copy
+    if (_commands.capacity() == 0) {
+        return;
+    }
+
+    clear();
+
+    auto& pool = getBatchStoragePool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.storage.size() >= MAX_POOLED_BATCH_STORAGE) {
+            return;
+        }
+    }
+
+    std::unique_ptr<BatchStorage> storage(new BatchStorage());
+    _commands.swap(storage->commands);
+    _commandOffsets.swap(storage->commandOffsets);
+    _params.swap(storage->params);
+    _data.swap(storage->data);
+    _objects.swap(storage->objects);
+    _drawCallInfos.swap(storage->drawCallInfos);
+    _buffers._items.swap(storage->buffers);
+    _textures._items.swap(storage->textures);
+    _streamFormats._items.swap(storage->streamFormats);
+    _transforms._items.swap(storage->transforms);
+    _pipelines._items.swap(storage->pipelines);
+    _framebuffers._items.swap(storage->framebuffers);
+
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.storage.push_back(std::move(storage));
 }
 
 void Batch::clear() {
@@ -368,6 +463,17 @@ void Batch::generateTextureMips(const TexturePointer& texture) {
     _params.emplace_back(_textures.cache(texture));
 }
 
+void Batch::readbackFramebuffer(const FramebufferPointer& framebuffer, const Vec4i& region, const ReadbackHandler& handler) {
+    ADD_COMMAND(readbackFramebuffer);
+
+    _params.emplace_back(_framebuffers.cache(framebuffer));
+    _params.emplace_back(region.x);
+    _params.emplace_back(region.y);
+    _params.emplace_back(region.z);
+    _params.emplace_back(region.w);
+    _params.emplace_back(_readbackHandlers.cache(handler));
+}
+
 void Batch::beginQuery(const QueryPointer& query) {
     ADD_COMMAND(beginQuery);
 
@@ -480,16 +586,10 @@ const Batch::DrawCallInfoBuffer& Batch::getDrawCallInfoBuffer() const {
 
 void Batch::captureDrawCallInfoImpl() {
     if (_invalidModel) {
-        TransformObject object;
-        _currentModel.getMatrix(object._model);
-
-        // FIXME - we don't want to be using glm::inverse() here but it fixes the flickering issue we are 
-        // seeing with planky blocks in toybox. Our implementation of getInverseMatrix() is buggy in cases
-        // of non-uniform scale. We need to fix that. In the mean time, glm::inverse() works.
-        //_model.getInverseMatrix(_object._modelInverse);
-        object._modelInverse = glm::inverse(object._model);
-
-        _objects.emplace_back(object);
+        // getInverseMatrix() goes through a Transform, which can't hold the inverse of a non uniform scale
+        _objects.emplace_back();
+        auto& object = _objects.back();
+        _currentModel.getMatrixAndInverse(object._model, object._modelInverse);
 
         // Flag is clean
         _invalidModel = false;
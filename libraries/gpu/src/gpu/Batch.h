@@ -11,6 +11,7 @@
 #ifndef hifi_gpu_Batch_h
 #define hifi_gpu_Batch_h
 
+#include <atomic>
 #include <vector>
 #include <mutex>
 #include <functional>
@@ -97,6 +98,11 @@ public:
 
     void clear();
 
+    // How many batches had to allocate their storage, and how many took it over from batches that went away,
+    // since the application started
+    static size_t getNumStorageAllocations() { return _numStorageAllocations; }
+    static size_t getNumStorageReuses() { return _numStorageReuses; }
+
     // Batches may need to override the context level stereo settings
     // if they're performing framebuffer copy operations, like the 
     // deferred lighting resolution mechanism
@@ -209,6 +215,13 @@ public:
     // Generate the mips for a texture
     void generateTextureMips(const TexturePointer& texture);
 
+    // Read a region of the first color target of a framebuffer back, without waiting on the gpu
+    // The region is expressed in pixel space with xy the origin and zw the size.
+    // The handler receives the red channel of the region as floats, row by row from the bottom, once the gpu is done
+    // with it, a few frames later and from the thread of the backend. Meant for small float targets.
+    using ReadbackHandler = std::function<void(const std::vector<float>& texels)>;
+    void readbackFramebuffer(const FramebufferPointer& framebuffer, const Vec4i& region, const ReadbackHandler& handler);
+
     // Query Section
     void beginQuery(const QueryPointer& query);
     void endQuery(const QueryPointer& query);
@@ -300,6 +313,7 @@ public:
         COMMAND_clearFramebuffer,
         COMMAND_blit,
         COMMAND_generateTextureMips,
+        COMMAND_readbackFramebuffer,
 
         COMMAND_beginQuery,
         COMMAND_endQuery,
@@ -420,6 +434,7 @@ public:
     typedef Cache<QueryPointer>::Vector QueryCaches;
     typedef Cache<std::string>::Vector StringCaches;
     typedef Cache<std::function<void()>>::Vector LambdaCache;
+    typedef Cache<ReadbackHandler>::Vector ReadbackHandlerCaches;
 
     // Cache Data in a byte array if too big to fit in Param
     // FOr example Mat4s are going there
@@ -473,6 +488,7 @@ public:
     FramebufferCaches _framebuffers;
     QueryCaches _queries;
     LambdaCache _lambdas;
+    ReadbackHandlerCaches _readbackHandlers;
     StringCaches _profileRanges;
     StringCaches _names;
 
@@ -482,6 +498,9 @@ public:
     bool _enableSkybox { false };
 
 protected:
+    static std::atomic<size_t> _numStorageAllocations;
+    static std::atomic<size_t> _numStorageReuses;
+
     friend class Context;
     friend class Frame;
 
@@ -0,0 +1,140 @@
+//
+//  BufferHeap.cpp
+//  libraries/gpu/src/gpu
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "BufferHeap.h"
+
+#include <algorithm>
+
+using namespace gpu;
+
+const Size BufferHeap::DEFAULT_BLOCK_SIZE = 16 * 1024 * 1024;
+// enough for the offset of any vertex attribute or index type
+const Size BufferHeap::DEFAULT_ALIGNMENT = 16;
+
+BufferHeap::Block::Block(Size size) : buffer(std::make_shared<Buffer>()) {
+    buffer->resize(size);
+    _freeRanges[0] = size;
+}
+
+bool BufferHeap::Block::allocate(Size size, Size& offset) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto range = std::find_if(_freeRanges.begin(), _freeRanges.end(), [&](const std::pair<const Size, Size>& range) {
+        return range.second >= size;
+    });
+    if (range == _freeRanges.end()) {
+        return false;
+    }
+
+    offset = range->first;
+    Size remainingSize = range->second - size;
+    _freeRanges.erase(range);
+    if (remainingSize > 0) {
+        _freeRanges[offset + size] = remainingSize;
+    }
+    _allocatedSize += size;
+    return true;
+}
+
+void BufferHeap::Block::free(Size offset, Size size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _allocatedSize -= size;
+
+    auto next = _freeRanges.lower_bound(offset);
+    if (next != _freeRanges.end() && next->first == offset + size) {
+        size += next->second;
+        next = _freeRanges.erase(next);
+    }
+    if (next != _freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            return;
+        }
+    }
+    _freeRanges.emplace_hint(next, offset, size);
+}
+
+bool BufferHeap::Block::isEmpty() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _allocatedSize == 0;
+}
+
+Size BufferHeap::Block::getAllocatedSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _allocatedSize;
+}
+
+BufferHeap::BufferHeap(Size blockSize, Size alignment) : _blockSize(blockSize), _alignment(alignment) {}
+
+BufferView BufferHeap::allocate(Size size, const Byte* data, const Element& element) {
+    Size alignedSize = ((size + _alignment - 1) / _alignment) * _alignment;
+    if (size == 0 || alignedSize > _blockSize / 4) {
+        return BufferView(std::make_shared<Buffer>(size, data), 0, size, element);
+    }
+
+    BlockPointer block;
+    Size offset = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        releaseEmptyBlocks();
+
+        for (const auto& candidate : _blocks) {
+            if (candidate->allocate(alignedSize, offset)) {
+                block = candidate;
+                break;
+            }
+        }
+        if (!block) {
+            block = std::make_shared<Block>(_blockSize);
+            block->allocate(alignedSize, offset);
+            _blocks.push_back(block);
+        }
+    }
+
+    block->buffer->setSubData(offset, size, data);
+
+    // the view's buffer pointer points at the block's buffer, and gives back the range when the last copy of it goes
+    BufferPointer buffer(std::make_shared<Allocation>(block, offset, alignedSize), block->buffer.get());
+    return BufferView(buffer, offset, size, element);
+}
+
+void BufferHeap::releaseEmptyBlocks() {
+    // one empty block is kept, so that a model let go of and loaded again doesn't make a new one
+    bool isEmptyBlockKept = false;
+    _blocks.erase(std::remove_if(_blocks.begin(), _blocks.end(), [&](const BlockPointer& block) {
+        // only the heap holds on to it, nothing can allocate from it but the heap itself
+        if (block.use_count() > 1 || !block->isEmpty()) {
+            return false;
+        }
+        if (!isEmptyBlockKept) {
+            isEmptyBlockKept = true;
+            return false;
+        }
+        return true;
+    }), _blocks.end());
+}
+
+Size BufferHeap::getAllocatedSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Size allocatedSize = 0;
+    for (const auto& block : _blocks) {
+        allocatedSize += block->getAllocatedSize();
+    }
+    return allocatedSize;
+}
+
+Size BufferHeap::getCapacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _blockSize * _blocks.size();
+}
+
+size_t BufferHeap::getBlockCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _blocks.size();
+}
@@ -0,0 +1,89 @@
+//
+//  BufferHeap.h
+//  libraries/gpu/src/gpu
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_gpu_BufferHeap_h
+#define hifi_gpu_BufferHeap_h
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Buffer.h"
+
+namespace gpu {
+
+// Hands out ranges of a few large buffers, the blocks of the heap, for data that would otherwise each have had a small
+// buffer of its own, so that it is bound and uploaded with fewer of them.
+//
+// The range a view is given goes back to its block once the last copy of the view's buffer pointer is gone, and is
+// merged with the free ranges next to it. A block with nothing left in it is let go of the next time the heap
+// allocates. Data larger than a quarter of a block gets a buffer of its own, as it would have without the heap.
+//
+// Allocating writes to the sysmem of the blocks, so it is done on the thread that frames are made on, the same as any
+// other change to a buffer. Ranges can be freed from any thread.
+class BufferHeap {
+public:
+    static const Size DEFAULT_BLOCK_SIZE;
+    static const Size DEFAULT_ALIGNMENT;
+
+    BufferHeap(Size blockSize = DEFAULT_BLOCK_SIZE, Size alignment = DEFAULT_ALIGNMENT);
+
+    // copies the data into the heap, the view's offset is where in the buffer of its block it went
+    BufferView allocate(Size size, const Byte* data, const Element& element);
+
+    Size getAllocatedSize() const;
+    Size getCapacity() const;
+    size_t getBlockCount() const;
+
+private:
+    class Block {
+    public:
+        Block(Size size);
+
+        // first fit, false if there is no free range the size can fit in
+        bool allocate(Size size, Size& offset);
+        void free(Size offset, Size size);
+
+        bool isEmpty() const;
+        Size getAllocatedSize() const;
+
+        const BufferPointer buffer;
+
+    private:
+        mutable std::mutex _mutex;
+        std::map<Size, Size> _freeRanges; // the size of each free range, by its offset
+        Size _allocatedSize { 0 };
+    };
+    using BlockPointer = std::shared_ptr<Block>;
+
+    // what the buffer pointer of a view shares the ownership of, it holds on to the block it is in
+    class Allocation {
+    public:
+        Allocation(const BlockPointer& block, Size offset, Size size) : _block(block), _offset(offset), _size(size) {}
+        ~Allocation() { _block->free(_offset, _size); }
+
+    private:
+        const BlockPointer _block;
+        const Size _offset;
+        const Size _size;
+    };
+
+    void releaseEmptyBlocks();
+
+    const Size _blockSize;
+    const Size _alignment;
+
+    mutable std::mutex _mutex;
+    std::vector<BlockPointer> _blocks;
+};
+
+};
+
+#endif
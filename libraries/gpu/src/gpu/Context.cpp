@@ -21,15 +21,19 @@ void ContextStats::evalDelta(const ContextStats& begin, const ContextStats& end)
     _ISNumFormatChanges = end._ISNumFormatChanges - begin._ISNumFormatChanges;
     _ISNumInputBufferChanges = end._ISNumInputBufferChanges - begin._ISNumInputBufferChanges;
     _ISNumIndexBufferChanges = end._ISNumIndexBufferChanges - begin._ISNumIndexBufferChanges;
+    _ISNumRedundantChanges = end._ISNumRedundantChanges - begin._ISNumRedundantChanges;
 
+    _RSNumResourceBufferBounded = end._RSNumResourceBufferBounded - begin._RSNumResourceBufferBounded;
     _RSNumTextureBounded = end._RSNumTextureBounded - begin._RSNumTextureBounded;
     _RSAmountTextureMemoryBounded = end._RSAmountTextureMemoryBounded - begin._RSAmountTextureMemoryBounded;
+    _RSNumRedundantBinds = end._RSNumRedundantBinds - begin._RSNumRedundantBinds;
 
     _DSNumAPIDrawcalls = end._DSNumAPIDrawcalls - begin._DSNumAPIDrawcalls;
     _DSNumDrawcalls = end._DSNumDrawcalls - begin._DSNumDrawcalls;
     _DSNumTriangles= end._DSNumTriangles - begin._DSNumTriangles;
 
     _PSNumSetPipelines = end._PSNumSetPipelines - begin._PSNumSetPipelines;
+    _PSNumRedundantSetPipelines = end._PSNumRedundantSetPipelines - begin._PSNumRedundantSetPipelines;
 }
 
 
@@ -33,16 +33,20 @@ public:
     int _ISNumFormatChanges = 0;
     int _ISNumInputBufferChanges = 0;
     int _ISNumIndexBufferChanges = 0;
+    int _ISNumRedundantChanges = 0;
 
     int _RSNumResourceBufferBounded = 0;
     int _RSNumTextureBounded = 0;
     int _RSAmountTextureMemoryBounded = 0;
+    // uniform buffers, resource buffers and textures set to what was already bound to their slot
+    int _RSNumRedundantBinds = 0;
 
     int _DSNumAPIDrawcalls = 0;
     int _DSNumDrawcalls = 0;
     int _DSNumTriangles = 0;
 
     int _PSNumSetPipelines = 0;
+    int _PSNumRedundantSetPipelines = 0;
  
     ContextStats() {}
     ContextStats(const ContextStats& stats) = default;
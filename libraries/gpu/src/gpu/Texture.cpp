@@ -12,6 +12,8 @@
 
 #include "Texture.h"
 
+#include <chrono>
+
 #include <glm/gtc/constants.hpp>
 #include <glm/gtx/component_wise.hpp>
 
@@ -360,6 +362,37 @@ Size Texture::evalTotalSize(uint16 startingMip) const {
     return size * getNumSlices();
 }
 
+// A draw keeps its request for one to two periods, long enough to cover a few frames and the backend's updates
+static const uint64_t MIP_REQUEST_PERIOD_MSECS = 500;
+static const int MIP_REQUEST_MIP_BITS = 16;
+
+static uint64_t currentMipRequestPeriod() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    // never 0, which marks a texture that has never been requested
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now).count() / MIP_REQUEST_PERIOD_MSECS + 1;
+}
+
+const uint16 Texture::MIP_NOT_REQUESTED;
+
+void Texture::requestMip(uint16 mip) const {
+    uint64_t period = currentMipRequestPeriod();
+    uint64_t request = (period << MIP_REQUEST_MIP_BITS) | mip;
+    uint64_t current = _mipRequest.load();
+    while ((current >> MIP_REQUEST_MIP_BITS) < period || ((current >> MIP_REQUEST_MIP_BITS) == period && (uint16)current > mip)) {
+        if (_mipRequest.compare_exchange_weak(current, request)) {
+            break;
+        }
+    }
+}
+
+uint16 Texture::getRequestedMip() const {
+    uint64_t current = _mipRequest.load();
+    if (current == 0 || (current >> MIP_REQUEST_MIP_BITS) + 1 < currentMipRequestPeriod()) {
+        return MIP_NOT_REQUESTED;
+    }
+    return (uint16)current;
+}
+
 void Texture::setStoredMipFormat(const Element& format) {
     _storage->setFormat(format);
 }
@@ -469,6 +469,15 @@ public:
     uint16 getMinMip() const { return _minMip; }
     uint16 usedMipLevels() const { return (getNumMips() - _minMip); }
 
+    // Screen space feedback from the renderer: the most detailed mip a draw of this texture needs.
+    // Can be called from any thread, the backend uses it to decide how much of the texture to keep on the gpu.
+    void requestMip(uint16 mip) const;
+    // The most detailed mip requested recently, or MIP_NOT_REQUESTED if the texture hasn't been drawn lately
+    static const uint16 MIP_NOT_REQUESTED { (uint16)-1 };
+    uint16 getRequestedMip() const;
+    // False for textures that are not drawn through the feedback, the backend keeps those fully resident
+    bool hasMipRequests() const { return _mipRequest.load() != 0; }
+
     // Generate the sub mips automatically for the texture
     // If the storage version is not available (from CPU memory)
     // Only works for the standard formats
@@ -576,6 +585,9 @@ protected:
     uint16 _maxMipLevel { 0 };
 
     uint16 _minMip { 0 };
+
+    // The request period in the high bits, the most detailed mip asked for during it in the low 16
+    mutable std::atomic<uint64_t> _mipRequest { 0 };
  
     Type _type { TEX_1D };
 
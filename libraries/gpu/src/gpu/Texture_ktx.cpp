@@ -219,9 +219,10 @@ PixelsPointer KtxStorage::getMipFace(uint16 level, uint8 face) const {
     if (faceSize != 0 && faceOffset != 0) {
         auto file = maybeOpenFile();
         if (file) {
+            // the view keeps the file mapped, its pages are only in memory while they are read
             auto storageView = file->createView(faceSize, faceOffset);
             if (storageView) {
-                return storageView->toMemoryStorage();
+                return storageView;
             } else {
                 qWarning() << "Failed to get a valid storageView for faceSize=" << faceSize << "  faceOffset=" << faceOffset << "out of valid file " << QString::fromStdString(_filename);
             }
@@ -11,12 +11,16 @@
 
 #include "Image.h"
 
+#include <functional>
+
 #include <nvtt/nvtt.h>
 
 #include <QUrl>
 #include <QImage>
 #include <QBuffer>
 #include <QImageReader>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 #include <Finally.h>
 #include <Profile.h>
@@ -38,6 +42,7 @@ static Setting::Handle<bool> compressCubeTextures("hifi.graphics.compressCubeTex
 
 static const glm::uvec2 SPARSE_PAGE_SIZE(128);
 static const glm::uvec2 MAX_TEXTURE_SIZE(4096);
+static const int MAX_CUBE_FACE_COMPRESSION_THREADS = 6;
 bool DEV_DECIMATE_TEXTURES = false;
 std::atomic<size_t> DECIMATED_TEXTURE_COUNT{ 0 };
 std::atomic<size_t> RECTIFIED_TEXTURE_COUNT{ 0 };
@@ -205,7 +210,61 @@ void setCubeTexturesCompressionEnabled(bool enabled) {
 }
 
 
+// the size an image is decoded at, smaller than its own if it has more than the given number of pixels, or if a size
+// is larger than textures are made at and the texture made from it isn't a cube map
+static QSize getDecodedImageSize(const QSize& imageSize, int maxNumPixels, bool isCubemap) {
+    int imageWidth = imageSize.width();
+    int imageHeight = imageSize.height();
+    if (imageWidth * imageHeight > maxNumPixels) {
+        float scaleFactor = sqrtf(maxNumPixels / (float)(imageWidth * imageHeight));
+        imageWidth = (int)(scaleFactor * (float)imageWidth + 0.5f);
+        imageHeight = (int)(scaleFactor * (float)imageHeight + 0.5f);
+    }
+
+    // the same halving processSourceImage does, the layout of the faces of a cube map is found from its own size
+    if (!isCubemap) {
+        glm::uvec2 targetSize(imageWidth, imageHeight);
+        while (glm::any(glm::greaterThan(targetSize, MAX_TEXTURE_SIZE))) {
+            targetSize /= 2;
+        }
+        if (targetSize != glm::uvec2(imageWidth, imageHeight)) {
+            ++DECIMATED_TEXTURE_COUNT;
+        }
+        imageWidth = targetSize.x;
+        imageHeight = targetSize.y;
+    }
+    return QSize(imageWidth, imageHeight);
+}
+
+static QImage readImage(QImageReader& imageReader, const std::string& filename, int maxNumPixels, bool isCubemap) {
+    // Decode straight at the size the texture is made at, rather than decoding the whole image to scale a copy of it.
+    // A JPEG is then decoded from only as many of its coefficients as the smaller size needs.
+    QSize imageSize = imageReader.size();
+    if (imageSize.isValid()) {
+        QSize decodedSize = getDecodedImageSize(imageSize, maxNumPixels, isCubemap);
+        if (decodedSize != imageSize && !decodedSize.isEmpty()) {
+            imageReader.setScaledSize(decodedSize);
+            qCDebug(imagelogging).nospace() << "Downscaled " << filename.c_str() << " (" <<
+                imageSize << " to " << decodedSize << ")";
+        }
+        return imageReader.read();
+    }
+
+    // the size of some formats isn't known before they are read
+    QImage image = imageReader.read();
+    QSize decodedSize = getDecodedImageSize(image.size(), maxNumPixels, isCubemap);
+    if (!image.isNull() && decodedSize != image.size()) {
+        QImage newImage = image.scaled(decodedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        image.swap(newImage);
+        qCDebug(imagelogging).nospace() << "Downscaled " << filename.c_str() << " (" <<
+            newImage.size() << " to " << decodedSize << ")";
+    }
+    return image;
+}
+
 gpu::TexturePointer processImage(const QByteArray& content, const std::string& filename, int maxNumPixels, TextureUsage::Type textureType) {
+    bool isCubemap = (textureType == TextureUsage::CUBE_TEXTURE);
+
     // Help the QImage loader by extracting the image file format from the url filename ext.
     // Some tga are not created properly without it.
     auto filenameExtension = filename.substr(filename.find_last_of('.') + 1);
@@ -215,7 +274,7 @@ gpu::TexturePointer processImage(const QByteArray& content, const std::string& f
     QImage image;
 
     if (imageReader.canRead()) {
-        image = imageReader.read();
+        image = readImage(imageReader, filename, maxNumPixels, isCubemap);
     } else {
         // Extension could be incorrect, try to detect the format from the content
         QImageReader newImageReader;
@@ -226,34 +285,17 @@ gpu::TexturePointer processImage(const QByteArray& content, const std::string& f
         if (newImageReader.canRead()) {
             qCWarning(imagelogging) << "Image file" << filename.c_str() << "has extension" << filenameExtension.c_str()
                                     << "but is actually a" << qPrintable(newImageReader.format()) << "(recovering)";
-            image = newImageReader.read();
+            image = readImage(newImageReader, filename, maxNumPixels, isCubemap);
         }
     }
 
-    int imageWidth = image.width();
-    int imageHeight = image.height();
-
     // Validate that the image loaded
-    if (imageWidth == 0 || imageHeight == 0 || image.format() == QImage::Format_Invalid) {
+    if (image.width() == 0 || image.height() == 0 || image.format() == QImage::Format_Invalid) {
         QString reason(image.format() == QImage::Format_Invalid ? "(Invalid Format)" : "(Size is invalid)");
         qCWarning(imagelogging) << "Failed to load" << filename.c_str() << qPrintable(reason);
         return nullptr;
     }
 
-    // Validate the image is less than _maxNumPixels, and downscale if necessary
-    if (imageWidth * imageHeight > maxNumPixels) {
-        float scaleFactor = sqrtf(maxNumPixels / (float)(imageWidth * imageHeight));
-        int originalWidth = imageWidth;
-        int originalHeight = imageHeight;
-        imageWidth = (int)(scaleFactor * (float)imageWidth + 0.5f);
-        imageHeight = (int)(scaleFactor * (float)imageHeight + 0.5f);
-        QImage newImage = image.scaled(QSize(imageWidth, imageHeight), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        image.swap(newImage);
-        qCDebug(imagelogging).nospace() << "Downscaled " << filename.c_str() << " (" <<
-            QSize(originalWidth, originalHeight) << " to " <<
-            QSize(imageWidth, imageHeight) << ")";
-    }
-    
     auto loader = TextureUsage::getTextureLoaderForType(textureType);
     auto texture = loader(image, filename);
 
@@ -292,9 +334,9 @@ QImage processSourceImage(const QImage& srcImage, bool cubemap) {
     return srcImage;
 }
 
+// Collects the compressed mips, they are assigned to the texture once the compression is done
+// so that the faces of a cube can be compressed concurrently
 struct MyOutputHandler : public nvtt::OutputHandler {
-    MyOutputHandler(gpu::Texture* texture, int face) : _texture(texture), _face(face) {}
-
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
         _size = size;
         _miplevel = miplevel;
@@ -309,21 +351,27 @@ struct MyOutputHandler : public nvtt::OutputHandler {
         return true;
     }
     virtual void endImage() override {
-        if (_face >= 0) {
-            _texture->assignStoredMipFace(_miplevel, _face, _size, static_cast<const gpu::Byte*>(_data));
-        } else {
-            _texture->assignStoredMip(_miplevel, _size, static_cast<const gpu::Byte*>(_data));
-        }
+        _mips.emplace_back(_miplevel, std::make_shared<storage::MemoryStorage>(_size, static_cast<const gpu::Byte*>(_data)));
         free(_data);
         _data = nullptr;
     }
 
+    void assignMips(gpu::Texture* texture, int face) {
+        for (auto& mip : _mips) {
+            if (face >= 0) {
+                texture->assignStoredMipFace(mip.first, face, mip.second);
+            } else {
+                texture->assignStoredMip(mip.first, mip.second);
+            }
+        }
+        _mips.clear();
+    }
+
+    std::vector<std::pair<uint16, storage::StoragePointer>> _mips;
     gpu::Byte* _data{ nullptr };
     gpu::Byte* _current{ nullptr };
-    gpu::Texture* _texture{ nullptr };
     int _miplevel = 0;
     int _size = 0;
-    int _face = -1;
 };
 struct MyErrorHandler : public nvtt::ErrorHandler {
     virtual void error(nvtt::Error e) override {
@@ -331,13 +379,11 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
-void generateMips(gpu::Texture* texture, QImage& image, int face = -1) {
 #if CPU_MIPMAPS
-    PROFILE_RANGE(resource_parse, "generateMips");
-
-    if (image.format() != QImage::Format_ARGB32) {
-        image = image.convertToFormat(QImage::Format_ARGB32);
-    }
+// Compresses the mips of the image in the stored mip format of the texture, without touching the texture
+static void compressMips(const gpu::Texture* texture, const QImage& image, MyOutputHandler& outputHandler) {
+    PROFILE_RANGE(resource_parse, "compressMips");
+    assert(image.format() == QImage::Format_ARGB32);
 
     const int width = image.width(), height = image.height();
     const void* data = static_cast<const void*>(image.constBits());
@@ -442,18 +488,87 @@ void generateMips(gpu::Texture* texture, QImage& image, int face = -1) {
 
     nvtt::OutputOptions outputOptions;
     outputOptions.setOutputHeader(false);
-    MyOutputHandler outputHandler(texture, face);
     outputOptions.setOutputHandler(&outputHandler);
     MyErrorHandler errorHandler;
     outputOptions.setErrorHandler(&errorHandler);
 
     nvtt::Compressor compressor;
     compressor.process(inputOptions, compressionOptions, outputOptions);
+}
+#endif
+
+void generateMips(gpu::Texture* texture, QImage& image, int face = -1) {
+#if CPU_MIPMAPS
+    PROFILE_RANGE(resource_parse, "generateMips");
+
+    if (image.format() != QImage::Format_ARGB32) {
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    MyOutputHandler outputHandler;
+    compressMips(texture, image, outputHandler);
+    outputHandler.assignMips(texture, face);
 #else
     texture->autoGenerateMips(-1);
 #endif
 }
 
+#if CPU_MIPMAPS
+static QThreadPool* cubeFaceCompressionPool() {
+    static QThreadPool* pool = [] {
+        QThreadPool* pool = new QThreadPool();
+        // leave a core to the thread processing the cube, which computes its irradiance meanwhile
+        pool->setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount() - 1, MAX_CUBE_FACE_COMPRESSION_THREADS)));
+        return pool;
+    }();
+    return pool;
+}
+#endif
+
+// Generates the mips of the 6 faces at once, each face is compressed on its own thread
+// while the calling thread runs whileCompressing, which must not modify the texture or the faces
+static void generateCubeMips(gpu::Texture* texture, std::vector<QImage>& faces, const std::function<void()>& whileCompressing) {
+#if CPU_MIPMAPS
+    PROFILE_RANGE(resource_parse, "generateCubeMips");
+
+    // faces are shared with the irradiance, convert them here rather than in the compressing threads
+    for (auto& face : faces) {
+        if (face.format() != QImage::Format_ARGB32) {
+            face = face.convertToFormat(QImage::Format_ARGB32);
+        }
+    }
+
+    std::vector<MyOutputHandler> outputHandlers(faces.size());
+    std::vector<QFuture<void>> compressions;
+    compressions.reserve(faces.size());
+    for (size_t face = 0; face < faces.size(); ++face) {
+        const QImage* faceImage = &faces[face];
+        MyOutputHandler* outputHandler = &outputHandlers[face];
+        compressions.push_back(QtConcurrent::run(cubeFaceCompressionPool(), [texture, faceImage, outputHandler] {
+            compressMips(texture, *faceImage, *outputHandler);
+        }));
+    }
+    if (whileCompressing) {
+        whileCompressing();
+    }
+    for (auto& compression : compressions) {
+        compression.waitForFinished();
+    }
+
+    // the texture storage is not thread safe, the mips are assigned here
+    for (size_t face = 0; face < faces.size(); ++face) {
+        outputHandlers[face].assignMips(texture, (int)face);
+    }
+#else
+    for (uint8 face = 0; face < faces.size(); ++face) {
+        generateMips(texture, faces[face], face);
+    }
+    if (whileCompressing) {
+        whileCompressing();
+    }
+#endif
+}
+
 void processTextureAlpha(const QImage& srcImage, bool& validAlpha, bool& alphaAsMask) {
     PROFILE_RANGE(resource_parse, "processTextureAlpha");
     validAlpha = false;
@@ -984,12 +1099,9 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(const QImage&
             theTexture->setSource(srcImageName);
             theTexture->setStoredMipFormat(formatMip);
 
-            for (uint8 face = 0; face < faces.size(); ++face) {
-                generateMips(theTexture.get(), faces[face], face);
-            }
-
             // Generate irradiance while we are at it
-            if (generateIrradiance) {
+            gpu::SHPointer irradiance;
+            auto computeIrradiance = [&] {
                 PROFILE_RANGE(resource_parse, "generateIrradiance");
                 auto irradianceTexture = gpu::Texture::createCube(gpu::Element::COLOR_SRGBA_32, faces[0].width(), gpu::Texture::MAX_NUM_MIPS, gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR, gpu::Sampler::WRAP_CLAMP));
                 irradianceTexture->setSource(srcImageName);
@@ -1000,7 +1112,12 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(const QImage&
 
                 irradianceTexture->generateIrradiance();
 
-                auto irradiance = irradianceTexture->getIrradiance();
+                irradiance = irradianceTexture->getIrradiance();
+            };
+
+            generateCubeMips(theTexture.get(), faces, generateIrradiance ? computeIrradiance : std::function<void()>());
+
+            if (irradiance) {
                 theTexture->overrideIrradiance(irradiance);
             }
         }
@@ -10,14 +10,23 @@
 //
 
 #include "ModelCache.h"
+#include <AssetUtils.h>
 #include <Finally.h>
 #include <FSTReader.h>
 #include "FBXReader.h"
+#include "FBXSerializer.h"
 #include "OBJReader.h"
 
+#include <unordered_map>
+
 #include <gpu/Batch.h>
+#include <gpu/BufferHeap.h>
 #include <gpu/Stream.h>
 
+#include <QCryptographicHash>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QThreadPool>
 
 #include <Gzip.h>
@@ -141,6 +150,10 @@ public:
     virtual void run() override;
 
 private:
+    cache::FileCache::Key getCacheKey() const;
+    FBXGeometry* readCachedGeometry(const cache::FilePointer& file) const;
+    void writeCachedGeometry(const cache::FileCache::Key& key, const FBXGeometry& geometry) const;
+
     QWeakPointer<Resource> _resource;
     QUrl _url;
     QVariantHash _mapping;
@@ -178,7 +191,19 @@ void GeometryReader::run() {
 			_url.path().toLower().endsWith(".obj.gz"))) {
             FBXGeometry::Pointer fbxGeometry;
 
-            if (_url.path().toLower().endsWith(".fbx")) {
+            auto& fbxCache = DependencyManager::get<ModelCache>()->_fbxCache;
+            auto cacheKey = getCacheKey();
+            if (auto file = fbxCache->getFile(cacheKey)) {
+                fbxGeometry.reset(readCachedGeometry(file));
+            }
+            bool isCached = (bool)fbxGeometry;
+
+            if (isCached) {
+                // parsed on an earlier load
+            } else if (isModelProxyUrl(_url)) {
+                // the asset server makes the proxy of a model as an OBJ, whatever the model is
+                fbxGeometry.reset(OBJReader().readOBJ(_data, _mapping, _combineParts, _url));
+            } else if (_url.path().toLower().endsWith(".fbx")) {
                 fbxGeometry.reset(readFBX(_data, _mapping, _url.path()));
                 if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
                     throw QString("empty geometry, possibly due to an unsupported FBX version");
@@ -197,6 +222,10 @@ void GeometryReader::run() {
                 throw QString("unsupported format");
             }
 
+            if (!isCached && fbxGeometry) {
+                writeCachedGeometry(cacheKey, *fbxGeometry);
+            }
+
             // Ensure the resource has not been deleted
             auto resource = _resource.toStrongRef();
             if (!resource) {
@@ -220,6 +249,46 @@ void GeometryReader::run() {
     }
 }
 
+cache::FileCache::Key GeometryReader::getCacheKey() const {
+    // the mapping and the url both change what the readers produce, texture filenames are resolved against the url
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(QByteArray::number(FBX_SERIALIZATION_VERSION));
+    hash.addData(_url.toEncoded());
+    hash.addData(QJsonDocument(QJsonObject::fromVariantHash(_mapping)).toJson(QJsonDocument::Compact));
+    hash.addData(_combineParts ? "1" : "0");
+    hash.addData(_data);
+    return hash.result().toHex().toStdString();
+}
+
+FBXGeometry* GeometryReader::readCachedGeometry(const cache::FilePointer& file) const {
+    QFile cachedFile(QString::fromStdString(file->getFilepath()));
+    if (!cachedFile.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    // read straight from the mapped file rather than copying it into memory first
+    uchar* mappedData = cachedFile.map(0, cachedFile.size());
+    if (!mappedData) {
+        return nullptr;
+    }
+    FBXGeometry* geometry = deserializeFBXGeometry(QByteArray::fromRawData(reinterpret_cast<const char*>(mappedData),
+                                                                           (int)cachedFile.size()));
+    cachedFile.unmap(mappedData);
+
+    if (!geometry) {
+        qCDebug(modelnetworking) << "Ignoring unreadable cached geometry for" << _url;
+    }
+    return geometry;
+}
+
+void GeometryReader::writeCachedGeometry(const cache::FileCache::Key& key, const FBXGeometry& geometry) const {
+    QByteArray serialized = serializeFBXGeometry(geometry);
+    auto& fbxCache = DependencyManager::get<ModelCache>()->_fbxCache;
+    if (!fbxCache->writeFile(serialized.constData(), cache::FileCache::Metadata(key, serialized.size()), true)) {
+        qCWarning(modelnetworking) << "Failed to cache the parsed geometry of" << _url;
+    }
+}
+
 class GeometryDefinitionResource : public GeometryResource {
     Q_OBJECT
 public:
@@ -242,6 +311,44 @@ void GeometryDefinitionResource::downloadFinished(const QByteArray& data) {
     QThreadPool::globalInstance()->start(new GeometryReader(_self, _url, _mapping, data, _combineParts));
 }
 
+// the vertices and indices of the meshes of all models are drawn from a few large buffers
+static gpu::BufferHeap& getVertexHeap() {
+    static gpu::BufferHeap vertexHeap;
+    return vertexHeap;
+}
+
+static gpu::BufferHeap& getIndexHeap() {
+    static gpu::BufferHeap indexHeap;
+    return indexHeap;
+}
+
+static void moveMeshToHeaps(model::Mesh& mesh) {
+    // the attributes of a mesh are laid out in one buffer, which is moved whole so their offsets in it still hold
+    std::unordered_map<const gpu::Buffer*, gpu::BufferView> movedBuffers;
+    auto moveView = [&](gpu::BufferHeap& heap, const gpu::BufferView& view) {
+        const gpu::Buffer* buffer = view._buffer.get();
+        auto moved = movedBuffers.find(buffer);
+        if (moved == movedBuffers.end()) {
+            moved = movedBuffers.emplace(buffer, heap.allocate(buffer->getSize(), buffer->getData(), view._element)).first;
+        }
+        return gpu::BufferView(moved->second._buffer, moved->second._offset + view._offset, view._size, view._stride,
+                               view._element);
+    };
+
+    if (mesh.hasVertexData()) {
+        mesh.setVertexBuffer(moveView(getVertexHeap(), mesh.getVertexBuffer()));
+    }
+    for (int slot = 0; slot < gpu::Stream::NUM_INPUT_SLOTS; ++slot) {
+        auto attribute = mesh.getAttributeBuffer(slot);
+        if (attribute._buffer) {
+            mesh.addAttribute(slot, moveView(getVertexHeap(), attribute));
+        }
+    }
+    if (mesh.getIndexBuffer()._buffer) {
+        mesh.setIndexBuffer(moveView(getIndexHeap(), mesh.getIndexBuffer()));
+    }
+}
+
 void GeometryDefinitionResource::setGeometryDefinition(FBXGeometry::Pointer fbxGeometry) {
     // Assume ownership of the geometry pointer
     _fbxGeometry = fbxGeometry;
@@ -257,6 +364,11 @@ void GeometryDefinitionResource::setGeometryDefinition(FBXGeometry::Pointer fbxG
     std::shared_ptr<GeometryMeshParts> parts = std::make_shared<GeometryMeshParts>();
     int meshID = 0;
     for (const FBXMesh& mesh : _fbxGeometry->meshes) {
+        // on the main thread, like the other changes to buffers that frames are made from
+        if (mesh._mesh) {
+            moveMeshToHeaps(*mesh._mesh);
+        }
+
         // Copy mesh pointers
         meshes->emplace_back(mesh._mesh);
         int partID = 0;
@@ -273,10 +385,15 @@ void GeometryDefinitionResource::setGeometryDefinition(FBXGeometry::Pointer fbxG
     finishedLoading(true);
 }
 
+const std::string ModelCache::FBX_DIRNAME { "fbx_cache" };
+const std::string ModelCache::FBX_EXT { "fbxg" };
+
 ModelCache::ModelCache() {
     const qint64 GEOMETRY_DEFAULT_UNUSED_MAX_SIZE = DEFAULT_UNUSED_MAX_SIZE;
     setUnusedResourceCacheSize(GEOMETRY_DEFAULT_UNUSED_MAX_SIZE);
     setObjectName("ModelCache");
+
+    _fbxCache->initialize();
 }
 
 QSharedPointer<Resource> ModelCache::createResource(const QUrl& url, const QSharedPointer<Resource>& fallback,
@@ -14,6 +14,7 @@
 
 #include <DependencyManager.h>
 #include <ResourceCache.h>
+#include <shared/FileCache.h>
 
 #include <model/Material.h>
 #include <model/Asset.h>
@@ -81,6 +82,8 @@ public:
     GeometryResource(const QUrl& url, const QUrl& textureBaseUrl = QUrl()) :
         Resource(url), _textureBaseUrl(textureBaseUrl) {}
 
+    QString getType() const override { return "Geometry"; }
+
     virtual bool areTexturesLoaded() const override { return isLoaded() && Geometry::areTexturesLoaded(); }
 
     virtual void deleter() override;
@@ -112,6 +115,7 @@ public:
     void setResource(GeometryResource::Pointer resource);
 
     QUrl getURL() const { return (bool)_resource ? _resource->getURL() : QUrl(); }
+    const GeometryResource::Pointer& getResource() const { return _resource; }
     int getResourceDownloadAttempts() { return _resource ? _resource->getDownloadAttempts() : 0; }
     int getResourceDownloadAttemptsRemaining() { return _resource ? _resource->getDownloadAttemptsRemaining() : 0; }
 
@@ -152,8 +156,16 @@ protected:
                                                     const void* extra) override;
 
 private:
+    friend class GeometryReader;
+
     ModelCache();
     virtual ~ModelCache() = default;
+
+    static const std::string FBX_DIRNAME;
+    static const std::string FBX_EXT;
+
+    // parsed geometry, so that a model seen before is not parsed again
+    std::shared_ptr<cache::FileCache> _fbxCache { std::make_shared<cache::FileCache>(FBX_DIRNAME, FBX_EXT) };
 };
 
 class NetworkMaterial : public model::Material {
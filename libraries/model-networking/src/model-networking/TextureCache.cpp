@@ -34,6 +34,7 @@
 
 #include <image/Image.h>
 
+#include <AssetUtils.h>
 #include <NumericalConstants.h>
 #include <shared/NsightHelpers.h>
 
@@ -291,6 +292,15 @@ NetworkTexture::NetworkTexture(const QUrl& url, image::TextureUsage::Type type,
     _textureSource = std::make_shared<gpu::TextureSource>();
     _lowestRequestedMipLevel = 0;
 
+    // the asset server bakes its textures as color textures, at full size
+    bool isBakedType = type == image::TextureUsage::DEFAULT_TEXTURE || type == image::TextureUsage::ALBEDO_TEXTURE ||
+        type == image::TextureUsage::EMISSIVE_TEXTURE || type == image::TextureUsage::LIGHTMAP_TEXTURE;
+    if (!_sourceIsKTX && isBakedType && content.isEmpty() && maxNumPixels >= ABSOLUTE_MAX_TEXTURE_NUM_PIXELS &&
+        url.scheme() == URL_SCHEME_ATP && isBakeableTexturePath(url.path())) {
+        _sourceIsBaked = true;
+        _sourceIsKTX = true;
+    }
+
     if (type == image::TextureUsage::CUBE_TEXTURE) {
         setLoadPriority(this, SKYBOX_LOAD_PRIORITY);
     } else if (_sourceIsKTX) {
@@ -394,6 +404,7 @@ void NetworkTexture::makeRequest() {
         range.fromInclusive = 0;
         range.toExclusive = 1000;
         _ktxHeaderRequest->setByteRange(range);
+        _ktxHeaderRequest->setBakedTextureRequested(_sourceIsBaked);
 
         emit loading();
 
@@ -460,6 +471,8 @@ void NetworkTexture::startMipRangeRequest(uint16_t low, uint16_t high) {
         return;
     }
 
+    _ktxMipRequest->setBakedTextureRequested(_sourceIsBaked);
+
     _ktxMipLevelRangeInFlight = { low, high };
     if (isHighMipRequest) {
         static const int HIGH_MIP_MAX_SIZE = 5516;
@@ -518,6 +531,14 @@ void NetworkTexture::ktxInitialDataRequestFinished() {
         _ktxHeaderData = _ktxHeaderRequest->getData();
         _ktxHighMipData = _ktxMipRequest->getData();
         handleFinishedInitialLoad();
+    } else if (_sourceIsBaked && result == ResourceRequest::NotFound) {
+        // the asset server has not baked this texture, or not yet, so the original is processed here
+        qCDebug(networking).noquote() << "No baked KTX for" << _activeUrl.toDisplayString();
+        _sourceIsBaked = false;
+        _sourceIsKTX = false;
+        _ktxResourceState = PENDING_INITIAL_LOAD;
+        _url.setFragment(QString());
+        QMetaObject::invokeMethod(this, "attemptRequest", Qt::QueuedConnection);
     } else {
         if (handleFailedRequest(result)) {
             _ktxResourceState = PENDING_INITIAL_LOAD;
@@ -100,6 +100,8 @@ private:
     };
 
     bool _sourceIsKTX { false };
+    // streamed from the KTX the asset server baked, the original is processed instead if there is none
+    bool _sourceIsBaked { false };
     KTXResourceState _ktxResourceState { PENDING_INITIAL_LOAD };
 
     // The current mips that are currently being requested w/ _ktxMipRequest
@@ -11,8 +11,22 @@
 
 #include "Geometry.h"
 
+#include <glm/gtc/packing.hpp>
+
 using namespace model;
 
+// the normals and colors of a mesh may be packed to normalized bytes, this reads them back as the vec3 they were
+static glm::vec3 getAttributeVec3(const gpu::BufferView& view, gpu::BufferView::Index index) {
+    switch (view._element.getType()) {
+        case gpu::NINT8:
+            return glm::vec3(glm::unpackSnorm4x8(view.get<uint32_t>(index)));
+        case gpu::NUINT8:
+            return glm::vec3(glm::unpackUnorm4x8(view.get<uint32_t>(index)));
+        default:
+            return view.get<glm::vec3>(index);
+    }
+}
+
 Mesh::Mesh() :
     _vertexBuffer(gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)),
     _indexBuffer(gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX)),
@@ -24,7 +38,9 @@ Mesh::Mesh(const Mesh& mesh) :
     _vertexBuffer(mesh._vertexBuffer),
     _attributeBuffers(mesh._attributeBuffers),
     _indexBuffer(mesh._indexBuffer),
-    _partBuffer(mesh._partBuffer) {
+    _partBuffer(mesh._partBuffer),
+    _lodIndexBuffer(mesh._lodIndexBuffer),
+    _lods(mesh._lods) {
 }
 
 Mesh::~Mesh() {
@@ -90,6 +106,11 @@ void Mesh::setPartBuffer(const BufferView& buffer) {
     _partBuffer = buffer;
 }
 
+void Mesh::setLODs(const BufferView& indexBuffer, const std::vector<LOD>& lods) {
+    _lodIndexBuffer = indexBuffer;
+    _lods = lods;
+}
+
 Box Mesh::evalPartBound(int partNum) const {
     Box box;
     if (partNum < _partBuffer.getNum<Part>()) {
@@ -161,7 +182,7 @@ model::MeshPointer Mesh::map(std::function<glm::vec3(glm::vec3)> vertexFunc,
     unsigned char* colorDataCursor = resultColorData;
 
     for (gpu::BufferView::Index i = 0; i < numColors; i++) {
-        glm::vec3 color = colorFunc(colorsBufferView.get<glm::vec3>(i));
+        glm::vec3 color = colorFunc(getAttributeVec3(colorsBufferView, i));
         memcpy(colorDataCursor, &color, sizeof(color));
         colorDataCursor += sizeof(color);
     }
@@ -175,7 +196,7 @@ model::MeshPointer Mesh::map(std::function<glm::vec3(glm::vec3)> vertexFunc,
     unsigned char* normalDataCursor = resultNormalData;
 
     for (gpu::BufferView::Index i = 0; i < numNormals; i++) {
-        glm::vec3 normal = normalFunc(normalsBufferView.get<glm::vec3>(i));
+        glm::vec3 normal = normalFunc(getAttributeVec3(normalsBufferView, i));
         memcpy(normalDataCursor, &normal, sizeof(normal));
         normalDataCursor += sizeof(normal);
     }
@@ -251,7 +272,7 @@ void Mesh::forEach(std::function<void(glm::vec3)> vertexFunc,
     const gpu::BufferView& colorsBufferView = getAttributeBuffer(attributeTypeColor);
     gpu::BufferView::Index numColors =  (gpu::BufferView::Index)colorsBufferView.getNumElements();
     for (gpu::BufferView::Index i = 0; i < numColors; i++) {
-        colorFunc(colorsBufferView.get<glm::vec3>(i));
+        colorFunc(getAttributeVec3(colorsBufferView, i));
     }
 
     // normal data
@@ -259,7 +280,7 @@ void Mesh::forEach(std::function<void(glm::vec3)> vertexFunc,
     const gpu::BufferView& normalsBufferView = getAttributeBuffer(attributeTypeNormal);
     gpu::BufferView::Index numNormals =  (gpu::BufferView::Index)normalsBufferView.getNumElements();
     for (gpu::BufferView::Index i = 0; i < numNormals; i++) {
-        normalFunc(normalsBufferView.get<glm::vec3>(i));
+        normalFunc(getAttributeVec3(normalsBufferView, i));
     }
     // TODO -- other attributes
 
@@ -113,6 +113,19 @@ public:
     const BufferView& getPartBuffer() const { return _partBuffer; }
     size_t getNumParts() const { return _partBuffer.getNumElements(); }
 
+    // Coarser versions of the triangle parts, drawn in their place when the parts are small on screen. A level has a
+    // part for each part of the mesh, indexing the same vertices from an index buffer shared by all the levels, and
+    // none of its triangles are smaller than its cell size in mesh space. The levels go from finest to coarsest.
+    class LOD {
+    public:
+        float cellSize { 0.0f };
+        std::vector<Part> parts;
+    };
+
+    void setLODs(const BufferView& indexBuffer, const std::vector<LOD>& lods);
+    const BufferView& getLODIndexBuffer() const { return _lodIndexBuffer; }
+    const std::vector<LOD>& getLODs() const { return _lods; }
+
     // evaluate the bounding box of A part
     Box evalPartBound(int partNum) const;
     // evaluate the bounding boxes of the parts in the range [start, end]
@@ -147,6 +160,9 @@ protected:
 
     BufferView _partBuffer;
 
+    BufferView _lodIndexBuffer;
+    std::vector<LOD> _lods;
+
     void evalVertexFormat();
     void evalVertexStream();
 
@@ -210,7 +210,7 @@ AssetUpload* AssetClient::createUpload(const QByteArray& data) {
     return upload;
 }
 
-MessageID AssetClient::getAsset(const QString& hash, DataOffset start, DataOffset end,
+MessageID AssetClient::getAsset(const QString& hash, DataOffset start, DataOffset end, AssetEncoding encoding,
                                 ReceivedAssetCallback callback, ProgressCallback progressCallback) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -226,7 +226,7 @@ MessageID AssetClient::getAsset(const QString& hash, DataOffset start, DataOffse
 
         auto messageID = ++_currentID;
 
-        auto payloadSize = sizeof(messageID) + SHA256_HASH_LENGTH + sizeof(start) + sizeof(end);
+        auto payloadSize = sizeof(messageID) + SHA256_HASH_LENGTH + sizeof(start) + sizeof(end) + sizeof(encoding);
         auto packet = NLPacket::create(PacketType::AssetGet, payloadSize, true);
 
         qCDebug(asset_client) << "Requesting data from" << start << "to" << end << "of" << hash << "from asset-server.";
@@ -237,6 +237,7 @@ MessageID AssetClient::getAsset(const QString& hash, DataOffset start, DataOffse
 
         packet->writePrimitive(start);
         packet->writePrimitive(end);
+        packet->writePrimitive(encoding);
 
         if (nodeList->sendPacket(std::move(packet), *assetServer) != -1) {
             _pendingRequests[assetServer][messageID] = { QSharedPointer<ReceivedMessage>(), callback, progressCallback };
@@ -271,7 +272,7 @@ MessageID AssetClient::getAssetInfo(const QString& hash, GetInfoCallback callbac
         }
     }
 
-    callback(false, AssetServerError::NoError, { "", 0 });
+    callback(false, AssetServerError::NoError, { "", 0, 0 });
     return INVALID_MESSAGE_ID;
 }
 
@@ -285,10 +286,11 @@ void AssetClient::handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> messag
     AssetServerError error;
     message->readPrimitive(&error);
 
-    AssetInfo info { assetHash.toHex(), 0 };
+    AssetInfo info { assetHash.toHex(), 0, 0 };
 
     if (error == AssetServerError::NoError) {
         message->readPrimitive(&info.size);
+        message->readPrimitive(&info.compressedSize);
     }
 
     // Check if we have any pending requests for this node
@@ -650,6 +652,7 @@ MessageID AssetClient::uploadAsset(const QByteArray& data, UploadResultCallback
 
     if (assetServer) {
         auto packetList = NLPacketList::create(PacketType::AssetUpload, QByteArray(), true, true);
+        packetList->setPriority(udt::PacketList::Low);
 
         auto messageID = ++_currentID;
         packetList->writePrimitive(messageID);
@@ -763,7 +766,7 @@ void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
     {
         auto messageMapIt = _pendingInfoRequests.find(node);
         if (messageMapIt != _pendingInfoRequests.end()) {
-            AssetInfo info { "", 0 };
+            AssetInfo info { "", 0, 0 };
             for (const auto& value : messageMapIt->second) {
                 value.second(false, AssetServerError::NoError, info);
             }
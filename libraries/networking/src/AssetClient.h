@@ -38,6 +38,7 @@ class AssetUpload;
 struct AssetInfo {
     QString hash;
     int64_t size;
+    int64_t compressedSize; // 0 if the asset server has no compressed copy
 };
 
 using MappingOperationCallback = std::function<void(bool responseReceived, AssetServerError serverError, QSharedPointer<ReceivedMessage> message)>;
@@ -83,7 +84,7 @@ private:
     MessageID renameAssetMapping(const AssetPath& oldPath, const AssetPath& newPath, MappingOperationCallback callback);
 
     MessageID getAssetInfo(const QString& hash, GetInfoCallback callback);
-    MessageID getAsset(const QString& hash, DataOffset start, DataOffset end,
+    MessageID getAsset(const QString& hash, DataOffset start, DataOffset end, AssetEncoding encoding,
                   ReceivedAssetCallback callback, ProgressCallback progressCallback);
     MessageID uploadAsset(const QByteArray& data, UploadResultCallback callback);
 
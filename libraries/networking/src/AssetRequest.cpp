@@ -12,9 +12,11 @@
 #include "AssetRequest.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include <QtCore/QThread>
 
+#include <Gzip.h>
 #include <StatTracker.h>
 #include <Trace.h>
 
@@ -33,11 +35,33 @@ AssetRequest::AssetRequest(const QString& hash, const ByteRange& byteRange) :
     
 }
 
+static const int MAX_PARALLEL_CHUNK_REQUESTS = 4;
+static const int MAX_CHUNK_RETRIES = 3;
+
 AssetRequest::~AssetRequest() {
     auto assetClient = DependencyManager::get<AssetClient>();
     if (_assetRequestID) {
         assetClient->cancelGetAssetRequest(_assetRequestID);
     }
+    if (_assetInfoRequestID) {
+        assetClient->cancelGetAssetInfoRequest(_assetInfoRequestID);
+    }
+    for (auto& pendingChunk : _pendingChunks) {
+        assetClient->cancelGetAssetRequest(pendingChunk.second.requestID);
+    }
+}
+
+AssetRequest::Error AssetRequest::errorFromServerError(AssetServerError serverError) {
+    switch (serverError) {
+        case AssetServerError::NoError:
+            return NoError;
+        case AssetServerError::AssetNotFound:
+            return NotFound;
+        case AssetServerError::InvalidByteRange:
+            return InvalidByteRange;
+        default:
+            return UnknownError;
+    }
 }
 
 void AssetRequest::start() {
@@ -60,8 +84,18 @@ void AssetRequest::start() {
         return;
     }
     
-    // Try to load from cache
-    _data = loadFromCache(getUrl());
+    // the baked copy is read by ranges to stream its mips, it is never downloaded whole
+    if (_encoding == AssetEncoding::BakedTexture && !_byteRange.isSet()) {
+        _error = InvalidByteRange;
+        _state = Finished;
+
+        emit finished(this);
+        return;
+    }
+
+    // Try to load from cache, which holds the originals and the proxies of models
+    _data = (_encoding == AssetEncoding::Raw || _encoding == AssetEncoding::ModelProxy) ?
+        loadFromCache(getCacheUrl()) : QByteArray();
     if (!_data.isNull()) {
         _error = NoError;
 
@@ -75,12 +109,66 @@ void AssetRequest::start() {
 
     _state = WaitingForData;
 
+    if (_byteRange.isSet() || _encoding == AssetEncoding::ModelProxy) {
+        // proxies are made smaller than a chunk, and have no info of their own
+        requestAsset();
+    } else {
+        // the size decides whether the asset is downloaded in chunks
+        requestInfo();
+    }
+}
+
+void AssetRequest::finish(Error error) {
+    _error = error;
+    if (_error != NoError) {
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+    }
+
+    _state = Finished;
+    emit finished(this);
+}
+
+void AssetRequest::requestInfo() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
+
+    _assetInfoRequestID = assetClient->getAssetInfo(_hash,
+        [this, that](bool responseReceived, AssetServerError serverError, AssetInfo info) {
+
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+        _assetInfoRequestID = INVALID_MESSAGE_ID;
+
+        if (!responseReceived) {
+            finish(NetworkError);
+        } else if (serverError != AssetServerError::NoError) {
+            finish(errorFromServerError(serverError));
+        } else {
+            // take the compressed copy if the asset server has one, it's only kept when it is enough smaller
+            auto size = info.size;
+            if (info.compressedSize > 0) {
+                _encoding = AssetEncoding::Gzip;
+                size = info.compressedSize;
+            }
+
+            if (size > ASSET_CHUNK_SIZE) {
+                startChunkedDownload(size);
+            } else {
+                requestAsset();
+            }
+        }
+    });
+}
+
+void AssetRequest::requestAsset() {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
 
-    _assetRequestID = assetClient->getAsset(_hash, _byteRange.fromInclusive, _byteRange.toExclusive,
-        [this, that, hash](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+    _assetRequestID = assetClient->getAsset(_hash, _byteRange.fromInclusive, _byteRange.toExclusive, _encoding,
+        [this, that, hash](bool responseReceived, AssetServerError serverError, const QByteArray& receivedData) {
 
         if (!that) {
             qCWarning(asset_client) << "Got reply for dead asset request " << hash << "- error code" << _error;
@@ -89,43 +177,31 @@ void AssetRequest::start() {
         }
         _assetRequestID = INVALID_MESSAGE_ID;
 
+        Error error = NoError;
         if (!responseReceived) {
-            _error = NetworkError;
+            error = NetworkError;
         } else if (serverError != AssetServerError::NoError) {
-            switch (serverError) {
-                case AssetServerError::AssetNotFound:
-                    _error = NotFound;
-                    break;
-                case AssetServerError::InvalidByteRange:
-                    _error = InvalidByteRange;
-                    break;
-                default:
-                    _error = UnknownError;
-                    break;
-            }
+            error = errorFromServerError(serverError);
         } else {
-            if (!_byteRange.isSet() && hashData(data).toHex() != _hash) {
+            QByteArray data;
+            bool isVerifiable = !_byteRange.isSet() && _encoding != AssetEncoding::ModelProxy;
+            if (!decode(receivedData, data) || (isVerifiable && hashData(data).toHex() != _hash)) {
                 // the hash of the received data does not match what we expect, so we return an error
-                _error = HashVerificationFailed;
+                error = HashVerificationFailed;
             }
 
-            if (_error == NoError) {
+            if (error == NoError) {
                 _data = data;
-                _totalReceived += data.size();
-                emit progress(_totalReceived, data.size());
+                _totalReceived += receivedData.size();
+                emit progress(_totalReceived, receivedData.size());
 
                 if (!_byteRange.isSet()) {
-                    saveToCache(getUrl(), data);
+                    saveToCache(getCacheUrl(), data);
                 }
             }
         }
-        
-        if (_error != NoError) {
-            qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
-        }
-        
-        _state = Finished;
-        emit finished(this);
+
+        finish(error);
     }, [this, that](qint64 totalReceived, qint64 total) {
         if (!that) {
             // If the request is dead, return
@@ -134,3 +210,163 @@ void AssetRequest::start() {
         emit progress(totalReceived, total);
     });
 }
+
+QUrl AssetRequest::getCacheUrl() const {
+    return (_encoding == AssetEncoding::ModelProxy) ? getATPChunkUrl(_hash, _encoding, 0) : getUrl();
+}
+
+bool AssetRequest::decode(const QByteArray& receivedData, QByteArray& data) const {
+    if (_encoding == AssetEncoding::Gzip) {
+        return gunzip(receivedData, data);
+    }
+    data = receivedData;
+    return true;
+}
+
+DataOffset AssetRequest::chunkSize(int chunk) const {
+    return std::min(ASSET_CHUNK_SIZE, _size - chunk * ASSET_CHUNK_SIZE);
+}
+
+void AssetRequest::startChunkedDownload(DataOffset size) {
+    _size = size;
+    _numChunks = (int)((size + ASSET_CHUNK_SIZE - 1) / ASSET_CHUNK_SIZE);
+    _isChunkReceived.assign(_numChunks, false);
+    _chunkRetries.assign(_numChunks, 0);
+    _data.resize(size);
+
+    // pick up whatever an earlier download of this asset got through
+    for (int chunk = 0; chunk < _numChunks; ++chunk) {
+        auto cachedChunk = loadFromCache(getATPChunkUrl(_hash, _encoding, chunk));
+        if (cachedChunk.size() == chunkSize(chunk)) {
+            memcpy(_data.data() + chunk * ASSET_CHUNK_SIZE, cachedChunk.constData(), cachedChunk.size());
+            _isChunkReceived[chunk] = true;
+            ++_numChunksReceived;
+            _totalReceived += cachedChunk.size();
+        }
+    }
+
+    if (_numChunksReceived > 0) {
+        qCDebug(asset_client) << "Resuming download of" << _hash << "with" << _numChunksReceived << "of" << _numChunks
+            << "chunks from disk cache.";
+        emit progress(_totalReceived, _size);
+    }
+
+    if (_numChunksReceived == _numChunks) {
+        completeChunkedDownload();
+    } else {
+        requestChunks();
+    }
+}
+
+void AssetRequest::requestChunks() {
+    while (_state == WaitingForData && (int)_pendingChunks.size() < MAX_PARALLEL_CHUNK_REQUESTS
+           && _nextChunk < _numChunks) {
+        int chunk = _nextChunk++;
+        if (!_isChunkReceived[chunk]) {
+            requestChunk(chunk);
+        }
+    }
+}
+
+void AssetRequest::requestChunk(int chunk) {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
+
+    DataOffset start = chunk * ASSET_CHUNK_SIZE;
+    _pendingChunks[chunk] = PendingChunk();
+
+    auto requestID = assetClient->getAsset(_hash, start, start + chunkSize(chunk), _encoding,
+        [this, that, chunk](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+        handleChunkReply(chunk, responseReceived, serverError, data);
+    }, [this, that, chunk](qint64 totalReceived, qint64 total) {
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+
+        auto it = _pendingChunks.find(chunk);
+        if (it != _pendingChunks.end()) {
+            it->second.received = totalReceived;
+
+            qint64 received = _totalReceived;
+            for (auto& pendingChunk : _pendingChunks) {
+                received += pendingChunk.second.received;
+            }
+            emit progress(received, _size);
+        }
+    });
+
+    // a request that can't be sent has already been replied to
+    auto it = _pendingChunks.find(chunk);
+    if (it != _pendingChunks.end()) {
+        it->second.requestID = requestID;
+    }
+}
+
+void AssetRequest::handleChunkReply(int chunk, bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+    _pendingChunks.erase(chunk);
+
+    if (_state != WaitingForData) {
+        return;
+    }
+
+    if (!responseReceived) {
+        // the asset server went away or reset its connection, ask again in case it is back
+        if (_chunkRetries[chunk]++ < MAX_CHUNK_RETRIES) {
+            qCDebug(asset_client) << "Retrying chunk" << chunk << "of" << _hash;
+            requestChunk(chunk);
+        } else {
+            finish(NetworkError);
+        }
+        return;
+    }
+
+    if (serverError != AssetServerError::NoError) {
+        finish(errorFromServerError(serverError));
+        return;
+    }
+
+    if (data.size() != chunkSize(chunk)) {
+        finish(SizeVerificationFailed);
+        return;
+    }
+
+    memcpy(_data.data() + chunk * ASSET_CHUNK_SIZE, data.constData(), data.size());
+    _isChunkReceived[chunk] = true;
+    ++_numChunksReceived;
+    _totalReceived += data.size();
+    saveToCache(getATPChunkUrl(_hash, _encoding, chunk), data);
+
+    emit progress(_totalReceived, _size);
+
+    if (_numChunksReceived == _numChunks) {
+        completeChunkedDownload();
+    } else {
+        requestChunks();
+    }
+}
+
+void AssetRequest::completeChunkedDownload() {
+    QByteArray data;
+    bool isValid = decode(_data, data) && hashData(data).toHex() == _hash;
+    _data = data;
+
+    if (isValid) {
+        saveToCache(getUrl(), _data);
+    }
+
+    // the whole asset is cached now, and chunks that didn't add up to it are no use for a retry
+    for (int chunk = 0; chunk < _numChunks; ++chunk) {
+        removeFromCache(getATPChunkUrl(_hash, _encoding, chunk));
+    }
+
+    if (!isValid) {
+        _data.clear();
+    }
+    finish(isValid ? NoError : HashVerificationFailed);
+}
@@ -12,6 +12,9 @@
 #ifndef hifi_AssetRequest_h
 #define hifi_AssetRequest_h
 
+#include <map>
+#include <vector>
+
 #include <QByteArray>
 #include <QObject>
 #include <QString>
@@ -54,11 +57,43 @@ public:
 
     bool loadedFromCache() const { return _loadedFromCache; }
 
+    // asks for the KTX the asset server baked from this texture instead, which only comes by byte range
+    void setBakedTextureRequested(bool requested) { _encoding = requested ? AssetEncoding::BakedTexture : AssetEncoding::Raw; }
+
+    // asks for the proxy the asset server made of this model instead, the asset has no other hash to verify it by
+    void setModelProxyRequested(bool requested) { _encoding = requested ? AssetEncoding::ModelProxy : AssetEncoding::Raw; }
+
 signals:
     void finished(AssetRequest* thisRequest);
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    static Error errorFromServerError(AssetServerError serverError);
+
+    void requestInfo();
+    void requestAsset();
+    void finish(Error error);
+
+    // assets larger than ASSET_CHUNK_SIZE are fetched as several ranges at once, in whatever order they arrive
+    // each completed range is cached, so that a download that fails or is cancelled picks up where it left off
+    void startChunkedDownload(DataOffset size);
+    void requestChunks();
+    void requestChunk(int chunk);
+    void handleChunkReply(int chunk, bool responseReceived, AssetServerError serverError, const QByteArray& data);
+    void completeChunkedDownload();
+    DataOffset chunkSize(int chunk) const;
+
+    // the originals are cached under their own URL, the proxies of models as their only chunk
+    QUrl getCacheUrl() const;
+
+    // undoes the encoding the asset was sent with
+    bool decode(const QByteArray& receivedData, QByteArray& data) const;
+
+    struct PendingChunk {
+        MessageID requestID { INVALID_MESSAGE_ID };
+        qint64 received { 0 };
+    };
+
     int _requestID;
     State _state = NotStarted;
     Error _error = NoError;
@@ -67,8 +102,18 @@ private:
     QByteArray _data;
     int _numPendingRequests { 0 };
     MessageID _assetRequestID { INVALID_MESSAGE_ID };
+    MessageID _assetInfoRequestID { INVALID_MESSAGE_ID };
     const ByteRange _byteRange;
     bool _loadedFromCache { false };
+    AssetEncoding _encoding { AssetEncoding::Raw };
+
+    DataOffset _size { 0 };
+    int _numChunks { 0 };
+    int _nextChunk { 0 };
+    int _numChunksReceived { 0 };
+    std::vector<bool> _isChunkReceived;
+    std::vector<int> _chunkRetries;
+    std::map<int, PendingChunk> _pendingChunks;
 };
 
 #endif
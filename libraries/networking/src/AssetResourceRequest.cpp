@@ -129,6 +129,10 @@ void AssetResourceRequest::requestHash(const AssetHash& hash) {
     // Make request to atp
     auto assetClient = DependencyManager::get<AssetClient>();
     _assetRequest = assetClient->createRequest(hash, _byteRange);
+    _assetRequest->setBakedTextureRequested(_bakedTextureRequested);
+    if (isModelProxyUrl(_url)) {
+        _assetRequest->setModelProxyRequested(true);
+    }
 
     connect(_assetRequest, &AssetRequest::progress, this, &AssetResourceRequest::onDownloadProgress);
     connect(_assetRequest, &AssetRequest::finished, this, [this](AssetRequest* req) {
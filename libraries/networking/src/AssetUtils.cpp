@@ -14,6 +14,8 @@
 #include <memory>
 
 #include <QtCore/QCryptographicHash>
+#include <QtCore/QFileInfo>
+#include <QtCore/QUrlQuery>
 #include <QtNetwork/QAbstractNetworkCache>
 
 #include "NetworkAccessManager.h"
@@ -25,6 +27,14 @@ QUrl getATPUrl(const QString& hash) {
     return QUrl(QString("%1:%2").arg(URL_SCHEME_ATP, hash));
 }
 
+QUrl getATPChunkUrl(const QString& hash, AssetEncoding encoding, int chunk) {
+    // the disk cache drops URL fragments, so the chunk is in the query
+    QString chunkKey = (encoding == AssetEncoding::Gzip) ? "gzipchunk" :
+        (encoding == AssetEncoding::BakedTexture) ? "ktxchunk" :
+        (encoding == AssetEncoding::ModelProxy) ? "proxychunk" : "chunk";
+    return QUrl(QString("%1:%2?%3=%4").arg(URL_SCHEME_ATP, hash, chunkKey).arg(chunk));
+}
+
 QByteArray hashData(const QByteArray& data) {
     return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
 }
@@ -70,6 +80,13 @@ bool saveToCache(const QUrl& url, const QByteArray& file) {
     return false;
 }
 
+bool removeFromCache(const QUrl& url) {
+    if (auto cache = NetworkAccessManager::getInstance().cache()) {
+        return cache->remove(url);
+    }
+    return false;
+}
+
 bool isValidFilePath(const AssetPath& filePath) {
     QRegExp filePathRegex { ASSET_FILE_PATH_REGEX_STRING };
     return filePathRegex.exactMatch(filePath);
@@ -84,3 +101,33 @@ bool isValidHash(const AssetHash& hash) {
     QRegExp hashRegex { ASSET_HASH_REGEX_STRING };
     return hashRegex.exactMatch(hash);
 }
+
+bool isCompressibleAssetPath(const AssetPath& path) {
+    // text formats and models, the asset server only keeps a compressed copy that turns out to be enough smaller
+    static const QStringList COMPRESSIBLE_EXTENSIONS {
+        "fst", "json", "obj", "mtl", "fbx", "gltf", "js", "txt", "html", "css", "svg", "xml", "csv"
+    };
+    return COMPRESSIBLE_EXTENSIONS.contains(QFileInfo(path).suffix(), Qt::CaseInsensitive);
+}
+
+bool isBakeableTexturePath(const AssetPath& path) {
+    static const QStringList BAKEABLE_TEXTURE_EXTENSIONS { "jpg", "jpeg", "png", "tga", "bmp" };
+    return BAKEABLE_TEXTURE_EXTENSIONS.contains(QFileInfo(path).suffix(), Qt::CaseInsensitive);
+}
+
+bool isProxyableModelPath(const AssetPath& path) {
+    static const QStringList PROXYABLE_MODEL_EXTENSIONS { "fbx", "obj" };
+    return PROXYABLE_MODEL_EXTENSIONS.contains(QFileInfo(path).suffix(), Qt::CaseInsensitive);
+}
+
+QUrl getModelProxyUrl(const QUrl& modelUrl) {
+    QUrl proxyUrl = modelUrl;
+    QUrlQuery query;
+    query.addQueryItem(MODEL_PROXY_QUERY_ITEM, QString());
+    proxyUrl.setQuery(query);
+    return proxyUrl;
+}
+
+bool isModelProxyUrl(const QUrl& url) {
+    return url.scheme() == URL_SCHEME_ATP && QUrlQuery(url).hasQueryItem(MODEL_PROXY_QUERY_ITEM);
+}
@@ -30,6 +30,9 @@ const size_t SHA256_HASH_LENGTH = 32;
 const size_t SHA256_HASH_HEX_LENGTH = 64;
 const uint64_t MAX_UPLOAD_SIZE = 1000 * 1000 * 1000; // 1GB
 
+// assets larger than this are downloaded as ranges of this size, which are cached on their own until the asset completes
+const DataOffset ASSET_CHUNK_SIZE = 1024 * 1024; // 1MB
+
 const QString ASSET_FILE_PATH_REGEX_STRING = "^(\\/[^\\/\\0]+)+$";
 const QString ASSET_PATH_REGEX_STRING = "^\\/([^\\/\\0]+(\\/)?)+$";
 const QString ASSET_HASH_REGEX_STRING = QString("^[a-fA-F0-9]{%1}$").arg(SHA256_HASH_HEX_LENGTH);
@@ -44,6 +47,18 @@ enum AssetServerError : uint8_t {
     FileOperationFailed
 };
 
+// how the bytes of an asset are sent, compressible assets have a compressed copy alongside the original,
+// textures a copy baked to KTX, which is only sent by byte range, and large models a simplified proxy as OBJ
+enum class AssetEncoding : uint8_t {
+    Raw = 0,
+    Gzip,
+    BakedTexture,
+    ModelProxy
+};
+
+// the query item that asks for the simplified proxy of the model mapped to an ATP path, e.g. atp:/tree.fbx?proxy
+const QString MODEL_PROXY_QUERY_ITEM = "proxy";
+
 enum AssetMappingOperationType : uint8_t {
     Get = 0,
     GetAll,
@@ -53,14 +68,29 @@ enum AssetMappingOperationType : uint8_t {
 };
 
 QUrl getATPUrl(const QString& hash);
+QUrl getATPChunkUrl(const QString& hash, AssetEncoding encoding, int chunk);
 
 QByteArray hashData(const QByteArray& data);
 
 QByteArray loadFromCache(const QUrl& url);
 bool saveToCache(const QUrl& url, const QByteArray& file);
+bool removeFromCache(const QUrl& url);
 
 bool isValidFilePath(const AssetPath& path);
 bool isValidPath(const AssetPath& path);
 bool isValidHash(const QString& hashString);
 
+// true for the kinds of asset worth keeping a compressed copy of, going by the extension of a path they're mapped to
+bool isCompressibleAssetPath(const AssetPath& path);
+
+// true for the images the asset server bakes to KTX, going by the extension of a path they're mapped to
+bool isBakeableTexturePath(const AssetPath& path);
+
+// true for the models the asset server makes a proxy of, going by the extension of a path they're mapped to
+bool isProxyableModelPath(const AssetPath& path);
+
+// the URL of the proxy of a model mapped to an ATP path, and whether a URL is one
+QUrl getModelProxyUrl(const QUrl& modelUrl);
+bool isModelProxyUrl(const QUrl& url);
+
 #endif // hifi_AssetUtils_h
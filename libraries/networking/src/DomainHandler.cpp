@@ -11,6 +11,8 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include <QtCore/QJsonDocument>
 #include <QtCore/QDataStream>
 
@@ -98,6 +100,7 @@ void DomainHandler::softReset() {
     clearSettings();
 
     _connectionDenialsSinceKeypairRegen = 0;
+    _holdConnectRequestsUntil = 0;
 
     // cancel the failure timeout for any pending requests for settings
     QMetaObject::invokeMethod(&_settingsTimer, "stop");
@@ -373,6 +376,7 @@ bool DomainHandler::reasonSuggestsLogin(ConnectionRefusedReason reasonCode) {
         case ConnectionRefusedReason::Unknown:
         case ConnectionRefusedReason::ProtocolMismatch:
         case ConnectionRefusedReason::TooManyUsers:
+        case ConnectionRefusedReason::Queued:
             return false;
     }
     return false;
@@ -397,6 +401,15 @@ void DomainHandler::processDomainServerConnectionDeniedPacket(QSharedPointer<Rec
     auto extraInfoUtf8= message->readWithoutCopy(extraInfoSize);
     QString extraInfo = QString::fromUtf8(extraInfoUtf8);
 
+    if (reasonCode == ConnectionRefusedReason::Queued) {
+        // our request was not refused, just wait before asking again so we don't add to the load
+        const quint64 MAX_HOLD_MSECS = 10 * MSECS_PER_SECOND;
+        quint64 holdMsecs = std::min((quint64)extraInfo.toUInt(), MAX_HOLD_MSECS);
+        qCDebug(networking) << "The domain-server queued our connection request, retrying in" << holdMsecs << "ms";
+        _holdConnectRequestsUntil = usecTimestampNow() + holdMsecs * USECS_PER_MSEC;
+        return;
+    }
+
     // output to the log so the user knows they got a denied connection request
     // and check and signal for an access token so that we can make sure they are logged in
     qCWarning(networking) << "The domain-server denied a connection request: " << reasonMessage << " extraInfo:" << extraInfo;
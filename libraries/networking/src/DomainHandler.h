@@ -19,6 +19,8 @@
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
 
+#include <SharedUtil.h>
+
 #include "HifiSockAddr.h"
 #include "NetworkPeer.h"
 #include "NLPacket.h"
@@ -89,9 +91,13 @@ public:
         ProtocolMismatch,
         LoginError,
         NotAuthorized,
-        TooManyUsers
+        TooManyUsers,
+        Queued // not a refusal, the domain-server is busy admitting others, extra info is when to retry in msecs
     };
 
+    // true while the domain-server asked us to hold our next connect request
+    bool shouldHoldConnectRequest() const { return usecTimestampNow() < _holdConnectRequestsUntil; }
+
 public slots:
     void setSocketAndID(const QString& hostname, quint16 port = DEFAULT_DOMAIN_SERVER_PORT, const QUuid& id = QUuid());
     void setIceServerHostnameAndID(const QString& iceServerHostname, const QUuid& id);
@@ -147,6 +153,7 @@ private:
     QSet<QString> _domainConnectionRefusals;
     bool _hasCheckedForAccessToken { false };
     int _connectionDenialsSinceKeypairRegen { 0 };
+    quint64 _holdConnectRequestsUntil { 0 };
 
     QTimer _apiRefreshTimer;
 };
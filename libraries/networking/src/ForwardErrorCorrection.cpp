@@ -0,0 +1,269 @@
+//
+//  ForwardErrorCorrection.cpp
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardErrorCorrection.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "udt/PacketBufferPool.h"
+
+namespace {
+
+// members the decoder accepts in a group, more than the encoder sends so that it can be raised later
+const int MAX_DECODED_GROUP_SIZE = 32;
+
+// enough to cover the largest group even with other unreliable packets interleaved, and a few groups still waiting on
+// their last fragment
+const size_t MAX_RECORDED_PACKETS = 64;
+const size_t MAX_PENDING_GROUPS = 4;
+
+const int MEMBER_SIZE = sizeof(quint32) + sizeof(quint8) + sizeof(quint16);
+
+int fragmentHeaderSize(int numMembers) {
+    return sizeof(quint16) + sizeof(quint8) + numMembers * MEMBER_SIZE + sizeof(quint16);
+}
+
+void xorInto(QByteArray& parity, const char* data, int size) {
+    if (parity.size() < size) {
+        parity.append(QByteArray(size - parity.size(), 0));
+    }
+
+    char* parityData = parity.data();
+    for (int i = 0; i < size; ++i) {
+        parityData[i] ^= data[i];
+    }
+}
+
+// reads from a received packet without moving its read position, every read is bounds checked
+class FragmentReader {
+public:
+    FragmentReader(const char* data, int size) : _data(data), _size(size) {}
+
+    template <typename T> bool read(T& value) {
+        if (_position + (int)sizeof(T) > _size) {
+            return false;
+        }
+        memcpy(&value, _data + _position, sizeof(T));
+        _position += sizeof(T);
+        return true;
+    }
+
+    const char* remainingData() const { return _data + _position; }
+    int remainingSize() const { return _size - _position; }
+
+private:
+    const char* _data;
+    int _size;
+    int _position { 0 };
+};
+
+}
+
+int FEC::groupSizeForLossRate(float lossRate) {
+    if (!(lossRate >= MIN_LOSS_RATE)) {
+        return 0;
+    }
+
+    // aim for about ten times the parity the loss calls for - a group can only be rebuilt if just one of it is lost
+    return std::max(MIN_GROUP_SIZE, std::min(MAX_GROUP_SIZE, (int)(0.1f / lossRate)));
+}
+
+void FECEncoder::setGroupSize(int groupSize) {
+    groupSize = std::max(0, std::min(FEC::MAX_GROUP_SIZE, groupSize));
+    if (groupSize == 0) {
+        _members.clear();
+        _parity.clear();
+    }
+    _groupSize = groupSize;
+}
+
+std::vector<std::unique_ptr<NLPacket>> FECEncoder::addPacket(const NLPacket& packet) {
+    std::vector<std::unique_ptr<NLPacket>> parityPackets;
+    if (_groupSize == 0) {
+        return parityPackets;
+    }
+
+    _members.push_back({ (quint32)packet.getSequenceNumber(), packet.getType(), (quint16)packet.getPayloadSize() });
+    xorInto(_parity, packet.getPayload(), (int)packet.getPayloadSize());
+
+    if ((int)_members.size() < _groupSize) {
+        return parityPackets;
+    }
+
+    int headerSize = fragmentHeaderSize((int)_members.size());
+    int fragmentCapacity = NLPacket::maxPayloadSize(PacketType::FECParity) - headerSize;
+
+    int offset = 0;
+    do {
+        int fragmentSize = std::min(fragmentCapacity, _parity.size() - offset);
+
+        auto parityPacket = NLPacket::create(PacketType::FECParity, headerSize + fragmentSize);
+        parityPacket->writePrimitive(_groupNumber);
+        parityPacket->writePrimitive((quint8)_members.size());
+        for (auto& member : _members) {
+            parityPacket->writePrimitive(member.sequenceNumber);
+            parityPacket->writePrimitive((quint8)member.type);
+            parityPacket->writePrimitive(member.payloadSize);
+        }
+        parityPacket->writePrimitive((quint16)offset);
+        parityPacket->write(_parity.constData() + offset, fragmentSize);
+        parityPackets.push_back(std::move(parityPacket));
+
+        offset += fragmentSize;
+    } while (offset < _parity.size());
+
+    ++_groupNumber;
+    _members.clear();
+    _parity.clear();
+
+    return parityPackets;
+}
+
+bool FECDecoder::isActive(quint64 now) const {
+    return _lastParityTime != 0 && now - _lastParityTime < FEC::ACTIVE_TIMEOUT_USECS;
+}
+
+void FECDecoder::recordPacket(const udt::Packet& packet) {
+    PacketType type = NLPacket::typeInHeader(packet);
+    if (!_protectedTypes.contains(type)) {
+        return;
+    }
+
+    int headerSize = NLPacket::localHeaderSize(type);
+    if (packet.getPayloadSize() < headerSize) {
+        return;
+    }
+
+    if (_recordedPackets.size() >= MAX_RECORDED_PACKETS) {
+        _recordedPackets.pop_front();
+    }
+    _recordedPackets.push_back({ (quint32)packet.getSequenceNumber(),
+                                 QByteArray(packet.getPayload() + headerSize, (int)packet.getPayloadSize() - headerSize) });
+}
+
+const QByteArray* FECDecoder::findRecordedPayload(quint32 sequenceNumber) const {
+    // the packets we're after are the most recent ones
+    for (auto it = _recordedPackets.rbegin(); it != _recordedPackets.rend(); ++it) {
+        if (it->sequenceNumber == sequenceNumber) {
+            return &it->payload;
+        }
+    }
+    return nullptr;
+}
+
+std::unique_ptr<udt::Packet> FECDecoder::processParity(const udt::Packet& parityPacket, quint64 now) {
+    _lastParityTime = now;
+
+    int headerSize = NLPacket::localHeaderSize(PacketType::FECParity);
+    if (parityPacket.getPayloadSize() < headerSize) {
+        return nullptr;
+    }
+    FragmentReader reader(parityPacket.getPayload() + headerSize, (int)parityPacket.getPayloadSize() - headerSize);
+
+    quint16 groupNumber;
+    quint8 numMembers;
+    if (!reader.read(groupNumber) || !reader.read(numMembers) || numMembers == 0 || numMembers > MAX_DECODED_GROUP_SIZE) {
+        return nullptr;
+    }
+
+    std::vector<Member> members(numMembers);
+    int maxPayloadSize = 0;
+    for (auto& member : members) {
+        quint8 type;
+        if (!reader.read(member.sequenceNumber) || !reader.read(type) || !reader.read(member.payloadSize)) {
+            return nullptr;
+        }
+        member.type = (PacketType)type;
+        maxPayloadSize = std::max(maxPayloadSize, (int)member.payloadSize);
+
+        // from now on, keep copies of this type of packet in case one of them needs to be rebuilt
+        _protectedTypes.insert(member.type);
+    }
+
+    quint16 offset;
+    if (!reader.read(offset) || offset + reader.remainingSize() > maxPayloadSize) {
+        return nullptr;
+    }
+
+    auto group = std::find_if(_groups.begin(), _groups.end(), [&](const Group& group) {
+        return group.number == groupNumber;
+    });
+    if (group == _groups.end()) {
+        if (_groups.size() >= MAX_PENDING_GROUPS) {
+            _groups.pop_front();
+        }
+        _groups.push_back(Group());
+        group = _groups.end() - 1;
+        group->number = groupNumber;
+        group->members = members;
+        group->parity = QByteArray(maxPayloadSize, 0);
+    } else if (group->parity.size() != maxPayloadSize) {
+        // the group number has wrapped around onto a group we still had, or the fragments disagree
+        return nullptr;
+    }
+
+    if (group->isDone || std::find(group->fragmentOffsets.begin(), group->fragmentOffsets.end(), offset)
+            != group->fragmentOffsets.end()) {
+        return nullptr;
+    }
+    group->fragmentOffsets.push_back(offset);
+
+    // fragments cover separate byte ranges of the parity
+    memcpy(group->parity.data() + offset, reader.remainingData(), reader.remainingSize());
+    group->numParityBytes += reader.remainingSize();
+
+    if (group->numParityBytes < maxPayloadSize) {
+        return nullptr;
+    }
+
+    group->isDone = true;
+    return recover(*group, parityPacket);
+}
+
+std::unique_ptr<udt::Packet> FECDecoder::recover(const Group& group, const udt::Packet& parityPacket) {
+    const Member* missingMember = nullptr;
+    for (auto& member : group.members) {
+        if (!findRecordedPayload(member.sequenceNumber)) {
+            if (missingMember) {
+                // more than one is missing, there's nothing we can do for this group
+                return nullptr;
+            }
+            missingMember = &member;
+        }
+    }
+
+    if (!missingMember) {
+        return nullptr;
+    }
+
+    QByteArray payload = group.parity;
+    for (auto& member : group.members) {
+        if (&member != missingMember) {
+            auto recordedPayload = findRecordedPayload(member.sequenceNumber);
+            xorInto(payload, recordedPayload->constData(), std::min(recordedPayload->size(), payload.size()));
+        }
+    }
+
+    // build the packet as it would have come off the wire, sourced by the sender of the parity
+    auto packet = NLPacket::create(missingMember->type, missingMember->payloadSize);
+    packet->write(payload.constData(), missingMember->payloadSize);
+    packet->writeSourceID(NLPacket::sourceIDInHeader(parityPacket));
+    packet->writeSequenceNumber(udt::SequenceNumber((udt::SequenceNumber::UType)missingMember->sequenceNumber));
+
+    qint64 bufferCapacity = 0;
+    auto buffer = udt::PacketBufferPool::acquire(packet->getDataSize(), bufferCapacity);
+    memcpy(buffer.get(), packet->getData(), packet->getDataSize());
+
+    auto recoveredPacket = udt::Packet::fromReceivedPacket(std::move(buffer), packet->getDataSize(),
+                                                           parityPacket.getSenderSockAddr(), bufferCapacity);
+    recoveredPacket->setReceiveTime(parityPacket.getReceiveTime());
+    return recoveredPacket;
+}
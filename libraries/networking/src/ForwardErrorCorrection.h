@@ -0,0 +1,124 @@
+//
+//  ForwardErrorCorrection.h
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ForwardErrorCorrection_h
+#define hifi_ForwardErrorCorrection_h
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSet>
+
+#include <NumericalConstants.h>
+
+#include "NLPacket.h"
+
+// XOR parity for unreliable packets, so that a receiver can rebuild one packet lost out of each group
+//
+// After every few packets it protects, the sender sends an FECParity packet holding the XOR of their payloads along with
+// their UDT sequence numbers, types and sizes. A receiver that got all but one of them XORs the parity with the ones it
+// has to get the missing payload back. Parity that would not fit in one packet is split into fragments by byte range.
+//
+//    FECParity payload (one fragment)
+//    +----------------+----------------+-------------------------------------------+----------------+----------+
+//    | group (uint16) | count (uint8)  | count x (sequence (uint32), type (uint8), | offset (uint16)| parity   |
+//    |                |                |          payload size (uint16))           |                | bytes    |
+//    +----------------+----------------+-------------------------------------------+----------------+----------+
+
+namespace FEC {
+    // parity is sent once there is enough loss for it to be worth its bandwidth
+    const float MIN_LOSS_RATE = 0.005f;
+
+    // one parity packet for every 5 to 10 packets, 10-20% more bandwidth
+    const int MIN_GROUP_SIZE = 5;
+    const int MAX_GROUP_SIZE = 10;
+
+    // packets stop being recorded when the sender hasn't sent parity for this long
+    const quint64 ACTIVE_TIMEOUT_USECS = 5 * USECS_PER_SECOND;
+
+    // returns 0 if no parity should be sent
+    int groupSizeForLossRate(float lossRate);
+}
+
+// Builds the parity for the packets sent to one destination
+// Not thread-safe, the caller serializes access.
+class FECEncoder {
+public:
+    int getGroupSize() const { return _groupSize; }
+
+    // a group size of 0 stops parity being sent, and drops the group in progress
+    void setGroupSize(int groupSize);
+
+    // call with each protected packet once it has been sent, so that its sequence number has been written
+    // returns the parity packets to send if this packet completes a group
+    std::vector<std::unique_ptr<NLPacket>> addPacket(const NLPacket& packet);
+
+private:
+    struct Member {
+        quint32 sequenceNumber;
+        PacketType type;
+        quint16 payloadSize;
+    };
+
+    int _groupSize { 0 };
+    quint16 _groupNumber { 0 };
+    std::vector<Member> _members;
+    QByteArray _parity; // XOR of the payloads of _members so far
+};
+
+// Rebuilds lost packets from the parity packets sent from one sender
+// Not thread-safe, the caller serializes access.
+class FECDecoder {
+public:
+    // true if parity has been heard from this sender recently, packets only need to be recorded while it is
+    bool isActive(quint64 now) const;
+
+    // keeps a copy of the packet if it is of a type the sender protects
+    void recordPacket(const udt::Packet& packet);
+
+    // returns the packet rebuilt from this parity packet and the ones recorded, if exactly one of its group is missing
+    // the rebuilt packet is already verified, the parity packet it came from was
+    std::unique_ptr<udt::Packet> processParity(const udt::Packet& parityPacket, quint64 now);
+
+private:
+    struct Member {
+        quint32 sequenceNumber;
+        PacketType type;
+        quint16 payloadSize;
+    };
+
+    struct Group {
+        quint16 number;
+        std::vector<Member> members;
+        QByteArray parity;
+        std::vector<quint16> fragmentOffsets;
+        int numParityBytes { 0 };
+        bool isDone { false };
+    };
+
+    struct RecordedPacket {
+        quint32 sequenceNumber;
+        QByteArray payload;
+    };
+
+    const QByteArray* findRecordedPayload(quint32 sequenceNumber) const;
+    std::unique_ptr<udt::Packet> recover(const Group& group, const udt::Packet& parityPacket);
+
+    QSet<PacketType> _protectedTypes;
+    std::deque<RecordedPacket> _recordedPackets;
+    std::deque<Group> _groups;
+    quint64 _lastParityTime { 0 };
+};
+
+#endif // hifi_ForwardErrorCorrection_h
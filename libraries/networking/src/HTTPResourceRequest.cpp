@@ -73,6 +73,19 @@ void HTTPResourceRequest::doSend() {
         networkRequest.setRawHeader("Range", byteRange.toLatin1());
     }
     networkRequest.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, false);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    // many requests to the same CDN share one connection instead of waiting on the few there are per host, servers
+    // without it are still talked to with HTTP/1.1
+    networkRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+
+    // requests waiting on a connection to their host go out by priority, the load priorities of resources being
+    // relative to the default of 0, e.g. the lower mips of textures are below it and skyboxes above it
+    if (_priority > 0.0f) {
+        networkRequest.setPriority(QNetworkRequest::HighPriority);
+    } else if (_priority < 0.0f) {
+        networkRequest.setPriority(QNetworkRequest::LowPriority);
+    }
 
     _reply = NetworkAccessManager::getInstance().get(networkRequest);
     
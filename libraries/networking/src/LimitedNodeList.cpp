@@ -18,6 +18,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
 #include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
@@ -96,6 +97,18 @@ LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     // set &PacketReceiver::handleVerifiedPacket as the verified packet callback for the udt::Socket
     _nodeSocket.setPacketHandler(
         [this](std::unique_ptr<udt::Packet> packet) {
+            if (NLPacket::typeInHeader(*packet) == PacketType::FECParity) {
+                processFECParity(std::move(packet));
+                return;
+            }
+            if (NLPacket::typeInHeader(*packet) == PacketType::CoalescedPackets) {
+                processCoalescedPackets(std::move(packet));
+                return;
+            }
+
+            if (usecTimestampNow() - _lastFECParityTime < FEC::ACTIVE_TIMEOUT_USECS) {
+                recordFECPacket(*packet);
+            }
             _packetReceiver->handleVerifiedPacket(std::move(packet));
         }
     );
@@ -117,6 +130,11 @@ LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     // set our socketBelongsToNode method as the connection creation filter operator for the udt::Socket
     _nodeSocket.setConnectionCreationFilterOperator(std::bind(&LimitedNodeList::sockAddrBelongsToNode, this, _1));
 
+    // mark audio and avatar packets so that networks with QoS can give them priority over bulk traffic
+    _nodeSocket.setTrafficClassOperator([](const udt::Packet& packet) {
+        return PacketTypeEnum::getRealTimePacketTrafficClasses().value(NLPacket::typeInHeader(packet), udt::DSCP_DEFAULT);
+    });
+
     // handle when a socket connection has its receiver side reset - might need to emit clientConnectionToNodeReset
     connect(&_nodeSocket, &udt::Socket::clientHandshakeRequestComplete, this, &LimitedNodeList::clientConnectionToSockAddrReset);
 
@@ -214,12 +232,15 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
 
         static QMultiHash<QUuid, PacketType> sourcedVersionDebugSuppressMap;
         static QMultiHash<HifiSockAddr, PacketType> versionDebugSuppressMap;
+        static QMutex versionDebugSuppressMutex; // packets can be verified on any of the socket's receive workers
 
         bool hasBeenOutput = false;
         QString senderString;
         const HifiSockAddr& senderSockAddr = packet.getSenderSockAddr();
         QUuid sourceID;
 
+        QMutexLocker versionDebugSuppressLocker(&versionDebugSuppressMutex);
+
         if (PacketTypeEnum::getNonSourcedPackets().contains(headerType)) {
             hasBeenOutput = versionDebugSuppressMap.contains(senderSockAddr, headerType);
 
@@ -238,6 +259,8 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
             }
         }
 
+        versionDebugSuppressLocker.unlock();
+
         if (!hasBeenOutput) {
             qCDebug(networking) << "Packet version mismatch on" << headerType << "- Sender"
                 << senderString << "sent" << qPrintable(QString::number(headerVersion)) << "but"
@@ -306,6 +329,8 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
                 // check if the md5 hash in the header matches the hash we would expect
                 if (packetHeaderHash != expectedHash) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
+                    static QMutex hashDebugSuppressMutex;
+                    QMutexLocker hashDebugSuppressLocker(&hashDebugSuppressMutex);
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
                         qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
@@ -358,6 +383,9 @@ void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& conn
 
 static const qint64 ERROR_SENDING_PACKET_BYTES = -1;
 
+// packets bigger than this save too little of their datagram's overhead to be worth holding back
+static const qint64 MAX_COALESCED_PACKET_SIZE = 256;
+
 qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const Node& destinationNode) {
     Q_ASSERT(!packet.isPartOfMessage());
 
@@ -380,7 +408,26 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiS
     collectPacketStats(packet);
     fillPacketHeader(packet, connectionSecret);
 
-    return _nodeSocket.writePacket(packet, sockAddr);
+    // packets with parity keep datagrams of their own, the parity is made from their sequence numbers
+    PacketType packetType = packet.getType();
+    if (_coalescedTypes[(size_t)packetType] && !_fecEnabledTypes[(size_t)packetType]
+        && packet.getDataSize() <= MAX_COALESCED_PACKET_SIZE) {
+        coalescePacket(packet, sockAddr);
+        return packet.getDataSize();
+    }
+
+    if (_isCoalescedFlushQueued) {
+        // what was sent before this to the same place goes out before it
+        flushCoalescedPackets(sockAddr);
+    }
+
+    auto bytesWritten = _nodeSocket.writePacket(packet, sockAddr);
+
+    if (_fecEnabledTypes[(size_t)packet.getType()]) {
+        sendFECParity(packet, sockAddr, connectionSecret);
+    }
+
+    return bytesWritten;
 }
 
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode) {
@@ -484,6 +531,159 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
     }
 }
 
+void LimitedNodeList::setFECEnabled(PacketType packetType, bool enabled) {
+    // parity for parity would only ever protect parity
+    if (packetType != PacketType::FECParity) {
+        _fecEnabledTypes[(size_t)packetType] = enabled;
+    }
+}
+
+void LimitedNodeList::setCoalescingEnabled(PacketType packetType, bool enabled) {
+    if (packetType != PacketType::CoalescedPackets) {
+        _coalescedTypes[(size_t)packetType] = enabled;
+    }
+}
+
+void LimitedNodeList::coalescePacket(const NLPacket& packet, const HifiSockAddr& sockAddr) {
+    std::lock_guard<std::mutex> lock(_coalescedPacketsMutex);
+
+    auto& coalescedPacket = _coalescedPackets[sockAddr];
+    qint64 entrySize = sizeof(quint16) + packet.getDataSize();
+    if (coalescedPacket && coalescedPacket->bytesAvailableForWrite() < entrySize) {
+        _nodeSocket.writePacket(*coalescedPacket, sockAddr);
+        coalescedPacket.reset();
+    }
+    if (!coalescedPacket) {
+        coalescedPacket = NLPacket::create(PacketType::CoalescedPackets);
+    }
+
+    coalescedPacket->writePrimitive((quint16)packet.getDataSize());
+    coalescedPacket->write(packet.getData(), packet.getDataSize());
+
+    // everything coalesced until the thread of the node list gets back to its event loop goes out together
+    if (!_isCoalescedFlushQueued.exchange(true)) {
+        QMetaObject::invokeMethod(this, "flushCoalescedPackets", Qt::QueuedConnection);
+    }
+}
+
+void LimitedNodeList::flushCoalescedPackets(const HifiSockAddr& sockAddr) {
+    std::lock_guard<std::mutex> lock(_coalescedPacketsMutex);
+    auto it = _coalescedPackets.find(sockAddr);
+    if (it != _coalescedPackets.end()) {
+        _nodeSocket.writePacket(*it->second, sockAddr);
+        _coalescedPackets.erase(it);
+    }
+}
+
+void LimitedNodeList::flushCoalescedPackets() {
+    // packets coalesced from here on queue another flush
+    _isCoalescedFlushQueued = false;
+
+    std::lock_guard<std::mutex> lock(_coalescedPacketsMutex);
+    for (auto& coalescedPacket : _coalescedPackets) {
+        _nodeSocket.writePacket(*coalescedPacket.second, coalescedPacket.first);
+    }
+    _coalescedPackets.clear();
+}
+
+void LimitedNodeList::processCoalescedPackets(std::unique_ptr<udt::Packet> coalescedPacket) {
+    int headerSize = NLPacket::localHeaderSize(PacketType::CoalescedPackets);
+    const char* data = coalescedPacket->getPayload() + headerSize;
+    qint64 remainingSize = coalescedPacket->getPayloadSize() - headerSize;
+    const qint64 MIN_PACKET_SIZE = NLPacket::totalHeaderSize(PacketType::CoalescedPackets);
+
+    while (remainingSize >= (qint64)sizeof(quint16)) {
+        quint16 packetSize;
+        memcpy(&packetSize, data, sizeof(quint16));
+        data += sizeof(quint16);
+        remainingSize -= sizeof(quint16);
+        if (packetSize > remainingSize || packetSize < MIN_PACKET_SIZE) {
+            qCDebug(networking) << "Dropping the rest of a malformed CoalescedPackets from"
+                << coalescedPacket->getSenderSockAddr();
+            return;
+        }
+
+        // only plain unreliable packets are ever coalesced
+        udt::Packet::SequenceNumberAndBitField bitField;
+        memcpy(&bitField, data, sizeof(bitField));
+        if ((bitField & udt::BIT_FIELD_MASK) == 0) {
+            auto packetData = std::unique_ptr<char[]>(new char[packetSize]);
+            memcpy(packetData.get(), data, packetSize);
+            auto packet = udt::Packet::fromReceivedPacket(std::move(packetData), packetSize,
+                                                          coalescedPacket->getSenderSockAddr());
+            PacketType packetType = NLPacket::typeInHeader(*packet);
+            if (packetType != PacketType::CoalescedPackets && packetType != PacketType::FECParity
+                && isPacketVerified(*packet)) {
+                _packetReceiver->handleVerifiedPacket(std::move(packet));
+            }
+        }
+
+        data += packetSize;
+        remainingSize -= packetSize;
+    }
+}
+
+void LimitedNodeList::setFECLossRate(const Node& destinationNode, float lossRate) {
+    auto activeSocket = destinationNode.getActiveSocket();
+    if (!activeSocket) {
+        return;
+    }
+
+    int groupSize = FEC::groupSizeForLossRate(lossRate);
+
+    std::lock_guard<std::mutex> lock(_fecEncodersMutex);
+    auto it = _fecEncoders.find(*activeSocket);
+    if (it != _fecEncoders.end()) {
+        if (groupSize == 0) {
+            _fecEncoders.erase(it);
+        } else {
+            it->second.setGroupSize(groupSize);
+        }
+    } else if (groupSize != 0) {
+        _fecEncoders[*activeSocket].setGroupSize(groupSize);
+    }
+}
+
+void LimitedNodeList::sendFECParity(const NLPacket& packet, const HifiSockAddr& sockAddr, const QUuid& connectionSecret) {
+    std::vector<std::unique_ptr<NLPacket>> parityPackets;
+    {
+        std::lock_guard<std::mutex> lock(_fecEncodersMutex);
+        auto it = _fecEncoders.find(sockAddr);
+        if (it == _fecEncoders.end()) {
+            return;
+        }
+        parityPackets = it->second.addPacket(packet);
+    }
+
+    for (auto& parityPacket : parityPackets) {
+        sendUnreliablePacket(*parityPacket, sockAddr, connectionSecret);
+    }
+}
+
+void LimitedNodeList::recordFECPacket(const udt::Packet& packet) {
+    std::lock_guard<std::mutex> lock(_fecDecodersMutex);
+    auto it = _fecDecoders.find(packet.getSenderSockAddr());
+    if (it != _fecDecoders.end() && it->second.isActive(usecTimestampNow())) {
+        it->second.recordPacket(packet);
+    }
+}
+
+void LimitedNodeList::processFECParity(std::unique_ptr<udt::Packet> parityPacket) {
+    auto now = usecTimestampNow();
+    _lastFECParityTime = now;
+
+    std::unique_ptr<udt::Packet> recoveredPacket;
+    {
+        std::lock_guard<std::mutex> lock(_fecDecodersMutex);
+        recoveredPacket = _fecDecoders[parityPacket->getSenderSockAddr()].processParity(*parityPacket, now);
+    }
+
+    if (recoveredPacket) {
+        // the parity it was rebuilt from has been verified, so it goes straight to its listener
+        _packetReceiver->handleVerifiedPacket(std::move(recoveredPacket));
+    }
+}
+
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode,
                                    const HifiSockAddr& overridenSockAddr) {
     if (overridenSockAddr.isNull() && !destinationNode.getActiveSocket()) {
@@ -529,6 +729,18 @@ SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
     return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
  }
 
+void LimitedNodeList::publishNodeSnapshot() {
+    std::lock_guard<std::mutex> lock(_nodeSnapshotMutex);
+
+    auto snapshot = std::make_shared<NodeSnapshot>();
+    snapshot->version = std::atomic_load(&_nodeSnapshot)->version + 1;
+    snapshot->nodes.reserve(_nodeHash.size());
+    for (const auto& pair : _nodeHash) {
+        snapshot->nodes.push_back(pair.second);
+    }
+    std::atomic_store(&_nodeSnapshot, NodeSnapshotPointer(std::move(snapshot)));
+}
+
 void LimitedNodeList::eraseAllNodes() {
     QSet<SharedNodePointer> killedNodes;
 
@@ -546,6 +758,7 @@ void LimitedNodeList::eraseAllNodes() {
                 killedNodes.insert(it->second);
                 it = _nodeHash.unsafe_erase(it);
             }
+            publishNodeSnapshot();
         }
     }
 
@@ -573,6 +786,7 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
         {
             QWriteLocker writeLocker(&_nodeMutex);
             _nodeHash.unsafe_erase(it);
+            publishNodeSnapshot();
         }
 
         handleNodeKill(matchingNode);
@@ -597,6 +811,15 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
 
     if (auto activeSocket = node->getActiveSocket()) {
         _nodeSocket.cleanupConnection(*activeSocket);
+
+        {
+            std::lock_guard<std::mutex> lock(_fecEncodersMutex);
+            _fecEncoders.erase(*activeSocket);
+        }
+        {
+            std::lock_guard<std::mutex> lock(_fecDecodersMutex);
+            _fecDecoders.erase(*activeSocket);
+        }
     }
 }
 
@@ -651,6 +874,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
                 auto oldSoloNode = previousSoloIt->second;
 
                 _nodeHash.unsafe_erase(previousSoloIt);
+                publishNodeSnapshot();
                 handleNodeKill(oldSoloNode);
 
                 // convert the current lock back to a read lock for insertion of new node
@@ -661,6 +885,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
         // insert the new node and release our read lock
         _nodeHash.emplace(newNode->getUUID(), newNodePointer);
+        publishNodeSnapshot();
         readLocker.unlock();
 
         qCDebug(networking) << "Added" << *newNode;
@@ -14,10 +14,14 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <array>
+#include <atomic>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -37,6 +41,7 @@
 #include <SharedUtil.h>
 
 #include "DomainHandler.h"
+#include "ForwardErrorCorrection.h"
 #include "Node.h"
 #include "NLPacket.h"
 #include "NLPacketList.h"
@@ -137,9 +142,18 @@ public:
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
+    // unreliable packets of the enabled types get parity sent along with them, to destinations with enough loss for it
+    // to be worth it - see ForwardErrorCorrection.h
+    void setFECEnabled(PacketType packetType, bool enabled);
+    void setFECLossRate(const Node& destinationNode, float lossRate);
+
+    // small unreliable packets of the enabled types are held for a moment and sent to their destination together, in one
+    // CoalescedPackets datagram holding each of them whole, so that the receiver verifies and handles them one by one
+    void setCoalescingEnabled(PacketType packetType, bool enabled);
+
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
+    size_t size() const { return getNodeSnapshot()->nodes.size(); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
 
@@ -180,70 +194,67 @@ public:
     using value_type = SharedNodePointer;
     using const_iterator = std::vector<value_type>::const_iterator;
 
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
-    // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
+    // The nodes as they were after the last time one was added or removed. A snapshot never changes once it is
+    // published, so it is iterated without taking the node lock, and a newer one has a higher version.
+    struct NodeSnapshot {
+        quint64 version { 0 };
+        std::vector<SharedNodePointer> nodes;
+    };
+    using NodeSnapshotPointer = std::shared_ptr<const NodeSnapshot>;
+
+    NodeSnapshotPointer getNodeSnapshot() const { return std::atomic_load(&_nodeSnapshot); }
+
+    // Cede control of iteration over one snapshot of the nodes (e.g. for use by thread pools, that split the range)
+    // Use this for nested loops so that every level sees the same nodes
     template<typename NestedNodeLambda>
     void nestedEach(NestedNodeLambda functor, 
                     int* lockWaitOut = nullptr, 
                     int* nodeTransformOut = nullptr, 
                     int* functorOut = nullptr) {
         auto start = usecTimestampNow();
-        {
-            QReadLocker readLock(&_nodeMutex);
-            auto endLock = usecTimestampNow();
-            if (lockWaitOut) {
-                *lockWaitOut = (endLock - start);
-            }
-
-            // Size of _nodeHash could change at any time,
-            // so reserve enough memory for the current size
-            // and then back insert all the nodes found
-            std::vector<SharedNodePointer> nodes;
-            nodes.reserve(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), std::back_inserter(nodes), [&](const NodeHash::value_type& it) {
-                return it.second;
-            });
-            auto endTransform = usecTimestampNow();
-            if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
-            }
+        auto snapshot = getNodeSnapshot();
+        auto endSnapshot = usecTimestampNow();
+        if (lockWaitOut) {
+            *lockWaitOut = (endSnapshot - start);
+        }
+        // the snapshot is already a vector of the nodes
+        if (nodeTransformOut) {
+            *nodeTransformOut = 0;
+        }
 
-            functor(nodes.cbegin(), nodes.cend());
-            auto endFunctor = usecTimestampNow();
-            if (functorOut) {
-                *functorOut = (endFunctor - endTransform);
-            }
+        functor(snapshot->nodes.cbegin(), snapshot->nodes.cend());
+        auto endFunctor = usecTimestampNow();
+        if (functorOut) {
+            *functorOut = (endFunctor - endSnapshot);
         }
     }
 
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const auto& node : snapshot->nodes) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const auto& node : snapshot->nodes) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const auto& node : snapshot->nodes) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -251,25 +262,21 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const auto& node : snapshot->nodes) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
         return SharedNodePointer();
     }
 
-    // This is unsafe because it does not take a lock
-    // Must only be called when you know that a read lock on the node mutex is held
-    // and will be held for the duration of your iteration
+    // Kept for the callers inside a nestedEach, it iterates the current snapshot like eachNode
     template<typename NodeLambda>
     void unsafeEachNode(NodeLambda functor) {
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
-        }
+        eachNode(functor);
     }
 
     void putLocalPortIntoSharedMemory(const QString key, QObject* parent, quint16 localPort);
@@ -362,9 +369,23 @@ protected:
 
     bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr) { return findNodeWithAddr(sockAddr) != SharedNodePointer(); }
 
+    void sendFECParity(const NLPacket& packet, const HifiSockAddr& sockAddr, const QUuid& connectionSecret);
+    void recordFECPacket(const udt::Packet& packet);
+    void processFECParity(std::unique_ptr<udt::Packet> parityPacket);
+
+    void coalescePacket(const NLPacket& packet, const HifiSockAddr& sockAddr);
+    void flushCoalescedPackets(const HifiSockAddr& sockAddr);
+    void processCoalescedPackets(std::unique_ptr<udt::Packet> coalescedPacket);
+
     QUuid _sessionUUID;
+    // called after every change to _nodeHash, with _nodeMutex held
+    void publishNodeSnapshot();
+
     NodeHash _nodeHash;
     mutable QReadWriteLock _nodeMutex;
+    std::mutex _nodeSnapshotMutex; // nodes are added under a read lock, so their snapshots are built one at a time
+    // only accessed through std::atomic_load and std::atomic_store
+    NodeSnapshotPointer _nodeSnapshot { std::make_shared<NodeSnapshot>() };
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -391,6 +412,18 @@ protected:
     QMap<quint64, ConnectionStep> _lastConnectionTimes;
     bool _areConnectionTimesComplete = false;
 
+    std::array<std::atomic<bool>, (size_t)PacketType::NUM_PACKET_TYPE> _fecEnabledTypes {};
+    std::mutex _fecEncodersMutex;
+    std::unordered_map<HifiSockAddr, FECEncoder> _fecEncoders;
+    std::mutex _fecDecodersMutex;
+    std::unordered_map<HifiSockAddr, FECDecoder> _fecDecoders;
+    std::atomic<quint64> _lastFECParityTime { 0 }; // packets are only recorded while some sender is sending parity
+
+    std::array<std::atomic<bool>, (size_t)PacketType::NUM_PACKET_TYPE> _coalescedTypes {};
+    std::mutex _coalescedPacketsMutex;
+    std::unordered_map<HifiSockAddr, std::unique_ptr<NLPacket>> _coalescedPackets;
+    std::atomic<bool> _isCoalescedFlushQueued { false }; // set while some coalesced packets are waiting to be sent
+
     template<typename IteratorLambda>
     void eachNodeHashIterator(IteratorLambda functor) {
         QWriteLocker writeLock(&_nodeMutex);
@@ -399,6 +432,7 @@ protected:
         while (it != _nodeHash.end()) {
             functor(it);
         }
+        publishNodeSnapshot();
     }
 
 
@@ -406,6 +440,7 @@ private slots:
     void flagTimeForConnectionStep(ConnectionStep connectionStep, quint64 timestamp);
     void possiblyTimeoutSTUNAddressLookup();
     void addSTUNHandlerToUnfiltered(); // called once STUN socket known
+    void flushCoalescedPackets();
 };
 
 #endif // hifi_LimitedNodeList_h
@@ -14,6 +14,7 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QDataStream>
+#include <QtCore/QMutex>
 
 #include <SharedUtil.h>
 #include <UUID.h>
@@ -235,6 +236,9 @@ QDebug operator<<(QDebug debug, const NetworkPeer &peer) {
 using BandwidthRecorderPtr = QSharedPointer<BandwidthRecorder>;
 static QHash<QUuid, BandwidthRecorderPtr> PEER_BANDWIDTH;
 
+// bytes are recorded from whichever thread sends or receives the packet
+static QMutex PEER_BANDWIDTH_MUTEX;
+
 BandwidthRecorder& getBandwidthRecorder(const QUuid & uuid) {
     if (!PEER_BANDWIDTH.count(uuid)) {
         PEER_BANDWIDTH.insert(uuid, QSharedPointer<BandwidthRecorder>::create());
@@ -243,21 +247,25 @@ BandwidthRecorder& getBandwidthRecorder(const QUuid & uuid) {
 }
 
 void NetworkPeer::recordBytesSent(int count) const {
+    QMutexLocker locker(&PEER_BANDWIDTH_MUTEX);
     auto& bw = getBandwidthRecorder(_uuid);
     bw.updateOutboundData(0, count);
 }
 
 void NetworkPeer::recordBytesReceived(int count) const {
+    QMutexLocker locker(&PEER_BANDWIDTH_MUTEX);
     auto& bw = getBandwidthRecorder(_uuid);
     bw.updateInboundData(0, count);
 }
 
 float NetworkPeer::getOutboundBandwidth() const {
+    QMutexLocker locker(&PEER_BANDWIDTH_MUTEX);
     auto& bw = getBandwidthRecorder(_uuid);
     return bw.getAverageOutputKilobitsPerSecond(0);
 }
 
 float NetworkPeer::getInboundBandwidth() const {
+    QMutexLocker locker(&PEER_BANDWIDTH_MUTEX);
     auto& bw = getBandwidthRecorder(_uuid);
     return bw.getAverageInputKilobitsPerSecond(0);
 }
@@ -117,6 +117,11 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     // we definitely want STUN to update our public socket, so call the LNL to kick that off
     startSTUNPublicSocketUpdate();
 
+    // the keepalive pings to a node and its replies go out with the other small packets sent to it at the time
+    setCoalescingEnabled(PacketType::Ping, true);
+    setCoalescingEnabled(PacketType::PingReply, true);
+    setCoalescingEnabled(PacketType::EntityQuery, true);
+
     auto& packetReceiver = getPacketReceiver();
     packetReceiver.registerListener(PacketType::DomainList, this, "processDomainServerList");
     packetReceiver.registerListener(PacketType::Ping, this, "processPingPacket");
@@ -142,10 +147,13 @@ qint64 NodeList::sendStats(QJsonObject statsObject, HifiSockAddr destination) {
         return 0;
     }
 
+    // a full stats packet is a flag of 0, no removed keys, then the stats as binary JSON
     auto statsPacketList = NLPacketList::create(PacketType::NodeJsonStats, QByteArray(), true, true);
+    statsPacketList->setPriority(udt::PacketList::Low);
 
-    QJsonDocument jsonDocument(statsObject);
-    statsPacketList->write(jsonDocument.toBinaryData());
+    QDataStream statsStream(statsPacketList.get());
+    statsStream << (quint8)0 << QStringList();
+    statsPacketList->write(QJsonDocument(statsObject).toBinaryData());
 
     sendPacketList(std::move(statsPacketList), destination);
     return 0;
@@ -158,7 +166,42 @@ qint64 NodeList::sendStatsToDomainServer(QJsonObject statsObject) {
         return 0;
     }
 
-    return sendStats(statsObject, _domainHandler.getSockAddr());
+    // the stats packet list is reliable and ordered, so after a first full packet the domain-server can apply deltas:
+    // a flag of 1, the top level keys that are gone, then the top level values that changed as binary JSON
+    // (a full packet is still sent now and then, in case the domain-server lost our stats)
+    const int MAX_STATS_DELTAS = 30;
+    if (_lastDomainServerStats.isEmpty() || _numDomainServerStatsDeltas >= MAX_STATS_DELTAS) {
+        _lastDomainServerStats = statsObject;
+        _numDomainServerStatsDeltas = 0;
+        return sendStats(statsObject, _domainHandler.getSockAddr());
+    }
+
+    QStringList removedKeys;
+    for (auto it = _lastDomainServerStats.constBegin(); it != _lastDomainServerStats.constEnd(); ++it) {
+        if (!statsObject.contains(it.key())) {
+            removedKeys << it.key();
+        }
+    }
+
+    QJsonObject changedStats;
+    for (auto it = statsObject.constBegin(); it != statsObject.constEnd(); ++it) {
+        if (_lastDomainServerStats.value(it.key()) != it.value()) {
+            changedStats.insert(it.key(), it.value());
+        }
+    }
+
+    _lastDomainServerStats = statsObject;
+    ++_numDomainServerStatsDeltas;
+
+    auto statsPacketList = NLPacketList::create(PacketType::NodeJsonStats, QByteArray(), true, true);
+    statsPacketList->setPriority(udt::PacketList::Low);
+
+    QDataStream statsStream(statsPacketList.get());
+    statsStream << (quint8)1 << removedKeys;
+    statsPacketList->write(QJsonDocument(changedStats).toBinaryData());
+
+    sendPacketList(std::move(statsPacketList), _domainHandler.getSockAddr());
+    return 0;
 }
 
 void NodeList::timePingReply(ReceivedMessage& message, const SharedNodePointer& sendingNode) {
@@ -240,6 +283,8 @@ void NodeList::reset() {
     LimitedNodeList::reset();
 
     _numNoReplyDomainCheckIns = 0;
+    _domainListVersion = 0;
+    _lastDomainServerStats = QJsonObject();
 
     // lock and clear our set of ignored IDs
     _ignoredSetLock.lockForWrite();
@@ -294,6 +339,9 @@ void NodeList::sendDomainServerCheckIn() {
     } else if (_domainHandler.getIP().isNull() && _domainHandler.requiresICE()) {
         qCDebug(networking) << "Waiting for ICE discovered domain-server socket. Will not send domain-server check in.";
         handleICEConnectionToDomainServer();
+    } else if (!_domainHandler.isConnected() && _domainHandler.shouldHoldConnectRequest()) {
+        // the domain-server is busy with other connect requests and told us when to come back
+        return;
     } else if (!_domainHandler.getIP().isNull()) {
 
         PacketType domainPacketType = !_domainHandler.isConnected()
@@ -404,6 +452,9 @@ void NodeList::sendDomainServerCheckIn() {
                 const QByteArray& usernameSignature = accountManager->getAccountInfo().getUsernameSignature(connectionToken);
                 packetStream << usernameSignature;
             }
+        } else {
+            // let the domain-server know which list we have, so it only sends us what changed since
+            packetStream << _domainListVersion;
         }
 
         flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SendDSCheckIn);
@@ -624,6 +675,35 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> newPermissions;
     setPermissions(newPermissions);
 
+    // a delta only applies on top of the list it was computed from, otherwise we keep our version
+    // and the domain-server sends a full list after our next check in
+    quint32 baseVersion, listVersion;
+    packetStream >> baseVersion >> listVersion;
+    bool isDelta = baseVersion != 0;
+    if (isDelta && baseVersion != _domainListVersion) {
+        qCDebug(networking) << "Ignoring DomainList delta on top of version" << baseVersion
+            << "while at version" << _domainListVersion;
+        return;
+    }
+    _domainListVersion = listVersion;
+
+    if (isDelta) {
+        quint16 numRemovedNodes;
+        packetStream >> numRemovedNodes;
+        for (int i = 0; i < numRemovedNodes; ++i) {
+            QUuid removedNodeUUID;
+            packetStream >> removedNodeUUID;
+            killNodeWithUUID(removedNodeUUID);
+        }
+
+        // the nodes that did not change are not in the delta, keep the ones a full list would have kept alive
+        eachNode([&](const SharedNodePointer& node) {
+            if (node->getType() == NodeType::downstreamType(_ownerType) || node->getType() == NodeType::upstreamType(_ownerType)) {
+                node->setLastHeardMicrostamp(usecTimestampNow());
+            }
+        });
+    }
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
         parseNodeFromPacketStream(packetStream);
@@ -23,6 +23,7 @@
 #include <TBBHelpers.h>
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
 #include <QtCore/QMutex>
 #include <QtCore/QSet>
 #include <QtCore/QSharedPointer>
@@ -159,6 +160,11 @@ private:
     NodeSet _nodeTypesOfInterest;
     DomainHandler _domainHandler;
     int _numNoReplyDomainCheckIns;
+    quint32 _domainListVersion { 0 }; // of the last DomainList applied, 0 before the first
+
+    // the stats last sent to the domain-server, the next ones only carry the top level values that changed
+    QJsonObject _lastDomainServerStats;
+    int _numDomainServerStatsDeltas { 0 };
     HifiSockAddr _assignmentServerSocket;
     bool _isShuttingDown { false };
     QTimer _keepAlivePingTimer;
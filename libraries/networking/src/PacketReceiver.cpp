@@ -12,7 +12,8 @@
 
 #include "PacketReceiver.h"
 
-#include <QMutexLocker>
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
 
 #include "DependencyManager.h"
 #include "NetworkLogging.h"
@@ -26,6 +27,10 @@ PacketReceiver::PacketReceiver(QObject* parent) : QObject(parent) {
 }
 
 bool PacketReceiver::registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot) {
+    return registerListenerForTypes(std::move(types), listener, slot, false);
+}
+
+bool PacketReceiver::registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot, bool direct) {
     Q_ASSERT_X(!types.empty(), "PacketReceiver::registerListenerForTypes", "No types to register");
     Q_ASSERT_X(listener, "PacketReceiver::registerListenerForTypes", "No object to register");
     Q_ASSERT_X(slot, "PacketReceiver::registerListenerForTypes", "No slot to register");
@@ -54,44 +59,39 @@ bool PacketReceiver::registerListenerForTypes(PacketTypeList types, QObject* lis
     }
     
     // Register non sourced types
-    std::for_each(std::begin(types), middle, [this, &listener, &nonSourcedMethod](PacketType type) {
-        registerVerifiedListener(type, listener, nonSourcedMethod);
+    std::for_each(std::begin(types), middle, [this, &listener, &nonSourcedMethod, direct](PacketType type) {
+        registerVerifiedListener(type, listener, nonSourcedMethod, false, direct);
     });
     
     // Register sourced types
-    std::for_each(middle, std::end(types), [this, &listener, &sourcedMethod](PacketType type) {
-        registerVerifiedListener(type, listener, sourcedMethod);
+    std::for_each(middle, std::end(types), [this, &listener, &sourcedMethod, direct](PacketType type) {
+        registerVerifiedListener(type, listener, sourcedMethod, false, direct);
     });
     
     return true;
 }
 
-void PacketReceiver::registerDirectListener(PacketType type, QObject* listener, const char* slot) {
+bool PacketReceiver::registerDirectListener(PacketType type, QObject* listener, const char* slot) {
     Q_ASSERT_X(listener, "PacketReceiver::registerDirectListener", "No object to register");
     Q_ASSERT_X(slot, "PacketReceiver::registerDirectListener", "No slot to register");
-    
-    bool success = registerListener(type, listener, slot);
-    if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
-        
-        // if we successfully registered, add this object to the set of objects that are directly connected
-        _directlyConnectedObjects.insert(listener);
+
+    QMetaMethod matchingMethod = matchingMethodForListener(type, listener, slot);
+
+    if (matchingMethod.isValid()) {
+        qCDebug(networking) << "Registering a direct packet listener for packet list type" << type;
+        registerVerifiedListener(type, listener, matchingMethod, false, true);
+        return true;
+    } else {
+        qCWarning(networking) << "FAILED to Register a direct packet listener for packet list type" << type;
+        return false;
     }
 }
 
-void PacketReceiver::registerDirectListenerForTypes(PacketTypeList types,
-                                                    QObject* listener, const char* slot) {
+bool PacketReceiver::registerDirectListenerForTypes(PacketTypeList types, QObject* listener, const char* slot) {
     Q_ASSERT_X(listener, "PacketReceiver::registerDirectListenerForTypes", "No object to register");
     Q_ASSERT_X(slot, "PacketReceiver::registerDirectListenerForTypes", "No slot to register");
-    
-    // just call register listener for types to start
-    bool success = registerListenerForTypes(std::move(types), listener, slot);
-    if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
-        
-        // if we successfully registered, add this object to the set of objects that are directly connected
-        _directlyConnectedObjects.insert(listener);
-    }
+
+    return registerListenerForTypes(std::move(types), listener, slot, true);
 }
 
 bool PacketReceiver::registerListener(PacketType type, QObject* listener, const char* slot,
@@ -165,9 +165,22 @@ QMetaMethod PacketReceiver::matchingMethodForListener(PacketType type, QObject*
     }
 }
 
-void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object, const QMetaMethod& slot, bool deliverPending) {
+void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object, const QMetaMethod& slot,
+                                              bool deliverPending, bool direct) {
     Q_ASSERT_X(object, "PacketReceiver::registerVerifiedListener", "No object to register");
-    QMutexLocker locker(&_packetListenerLock);
+
+    static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
+    static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+
+    NodeArgument nodeArgument = NodeArgument::None;
+    auto parameterTypes = slot.parameterTypes();
+    if (parameterTypes.contains(SHARED_NODE_NORMALIZED)) {
+        nodeArgument = NodeArgument::SharedNodePointer;
+    } else if (parameterTypes.contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+        nodeArgument = NodeArgument::QSharedPointerNode;
+    }
+
+    QWriteLocker locker(&_packetListenerLock);
 
     if (_messageListenerMap.contains(type)) {
         qCWarning(networking) << "Registering a packet listener for packet type" << type
@@ -175,29 +188,24 @@ void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object,
     }
     
     // add the mapping
-    _messageListenerMap[type] = { QPointer<QObject>(object), slot, deliverPending };
+    _messageListenerMap[type] = { QPointer<QObject>(object), slot, deliverPending, direct, nodeArgument };
 }
 
 void PacketReceiver::unregisterListener(QObject* listener) {
     Q_ASSERT_X(listener, "PacketReceiver::unregisterListener", "No listener to unregister");
     
-    {
-        QMutexLocker packetListenerLocker(&_packetListenerLock);
-        
-        // clear any registrations for this listener in _messageListenerMap
-        auto it = _messageListenerMap.begin();
-        
-        while (it != _messageListenerMap.end()) {
-            if (it.value().object == listener) {
-                it = _messageListenerMap.erase(it);
-            } else {
-                ++it;
-            }
+    QWriteLocker packetListenerLocker(&_packetListenerLock);
+
+    // clear any registrations for this listener in _messageListenerMap
+    auto it = _messageListenerMap.begin();
+
+    while (it != _messageListenerMap.end()) {
+        if (it.value().object == listener) {
+            it = _messageListenerMap.erase(it);
+        } else {
+            ++it;
         }
     }
-    
-    QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
-    _directlyConnectedObjects.remove(listener);
 }
 
 void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
@@ -265,13 +273,15 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
         matchingNode = nodeList->nodeWithUUID(receivedMessage->getSourceID());
     }
     
-    QMutexLocker packetListenerLocker(&_packetListenerLock);
+    // delivering only reads the listener map, so the socket's receive workers can deliver packets at the same time
+    QReadLocker packetListenerLocker(&_packetListenerLock);
     
     bool listenerIsDead = false;
+    bool listenerIsMissing = false;
     
-    auto it = _messageListenerMap.find(receivedMessage->getType());
+    auto it = _messageListenerMap.constFind(receivedMessage->getType());
             
-    if (it != _messageListenerMap.end() && it->method.isValid()) {
+    if (it != _messageListenerMap.constEnd() && it->method.isValid()) {
          
         auto listener = it.value();
 
@@ -283,13 +293,7 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
             
             bool success = false;
 
-            Qt::ConnectionType connectionType;
-            // check if this is a directly connected listener
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
- 
-                connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
-            }
+            Qt::ConnectionType connectionType = listener.direct ? Qt::DirectConnection : Qt::AutoConnection;
             
             PacketType packetType = receivedMessage->getType();
             
@@ -297,19 +301,16 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
                 matchingNode->recordBytesReceived(receivedMessage->getSize());
 
                 QMetaMethod metaMethod = listener.method;
-                
-                static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
-                static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
-                
+
                 // one final check on the QPointer before we go to invoke
                 if (listener.object) {
-                    if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
+                    if (listener.nodeArgument == NodeArgument::SharedNodePointer) {
                         success = metaMethod.invoke(listener.object,
                                                     connectionType,
                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
                                                     Q_ARG(SharedNodePointer, matchingNode));
                         
-                    } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+                    } else if (listener.nodeArgument == NodeArgument::QSharedPointerNode) {
                         success = metaMethod.invoke(listener.object,
                                                     connectionType,
                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
@@ -327,6 +328,7 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
                 // one final check on the QPointer before we invoke
                 if (listener.object) {
                     success = listener.method.invoke(listener.object,
+                                                     connectionType,
                                                      Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
                 } else {
                     listenerIsDead = true;
@@ -346,18 +348,24 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
         if (listenerIsDead) {
             qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
                 << " has been destroyed. Removing from listener map.";
-            it = _messageListenerMap.erase(it);
-            
-            // if it exists, remove the listener from _directlyConnectedObjects
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
-                _directlyConnectedObjects.remove(listener.object);
-            }
         }
-    } else if (it == _messageListenerMap.end()) {
+    } else if (it == _messageListenerMap.constEnd()) {
         qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
-        
-        // insert a dummy listener so we don't print this again
-        _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
+        listenerIsMissing = true;
+    }
+
+    packetListenerLocker.unlock();
+
+    if (listenerIsDead || listenerIsMissing) {
+        QWriteLocker listenerWriteLocker(&_packetListenerLock);
+
+        // the map may have changed while it was unlocked
+        auto listenerIt = _messageListenerMap.find(receivedMessage->getType());
+        if (listenerIsDead && listenerIt != _messageListenerMap.end() && !listenerIt->object) {
+            _messageListenerMap.erase(listenerIt);
+        } else if (listenerIsMissing && listenerIt == _messageListenerMap.end()) {
+            // insert a dummy listener so we don't print this again
+            _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false, false, NodeArgument::None });
+        }
     }
 }
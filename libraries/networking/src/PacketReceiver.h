@@ -13,12 +13,13 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 
 #include <QtCore/QMap>
 #include <QtCore/QMetaMethod>
-#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 #include <QtCore/QSet>
@@ -62,6 +63,13 @@ public:
     // for the message is received.
     bool registerListener(PacketType type, QObject* listener, const char* slot, bool deliverPending = false);
     bool registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
+
+    // Direct listeners are invoked on the thread that receives the packet instead of through the listener's event loop,
+    // which saves an event per packet for hot packet types. The slot must be safe to call from that thread, typically by
+    // doing nothing more than pushing the message onto a lock-free queue (see MPSCRingBuffer) its owner drains.
+    bool registerDirectListener(PacketType type, QObject* listener, const char* slot);
+    bool registerDirectListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
+
     void unregisterListener(QObject* listener);
     
     void handleVerifiedPacket(std::unique_ptr<udt::Packet> packet);
@@ -69,34 +77,32 @@ public:
     void handleMessageFailure(HifiSockAddr from, udt::Packet::MessageNumber messageNumber);
     
 private:
+    enum class NodeArgument { None, SharedNodePointer, QSharedPointerNode };
+
     struct Listener {
         QPointer<QObject> object;
         QMetaMethod method;
         bool deliverPending;
+        bool direct;
+        NodeArgument nodeArgument; // worked out once at registration rather than from the method for every packet
     };
 
     void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
 
-    // these are brutal hacks for now - ideally GenericThread / ReceivedPacketProcessor
-    // should be changed to have a true event loop and be able to handle our QMetaMethod::invoke
-    void registerDirectListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
-    void registerDirectListener(PacketType type, QObject* listener, const char* slot);
-
+    bool registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot, bool direct);
     QMetaMethod matchingMethodForListener(PacketType type, QObject* object, const char* slot) const;
-    void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot, bool deliverPending = false);
+    void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot,
+                                  bool deliverPending = false, bool direct = false);
 
-    QMutex _packetListenerLock;
+    QReadWriteLock _packetListenerLock;
     QHash<PacketType, Listener> _messageListenerMap;
-    int _inPacketCount = 0;
-    int _inByteCount = 0;
-    bool _shouldDropPackets = false;
-    QMutex _directConnectSetMutex;
-    QSet<QObject*> _directlyConnectedObjects;
+
+    // unreliable packets can be handled on any of the socket's receive workers
+    std::atomic<int> _inPacketCount { 0 };
+    std::atomic<int> _inByteCount { 0 };
+    std::atomic<bool> _shouldDropPackets { false };
 
     std::unordered_map<std::pair<HifiSockAddr, udt::Packet::MessageNumber>, QSharedPointer<ReceivedMessage>> _pendingMessages;
-    
-    friend class EntityEditPacketSender;
-    friend class OctreePacketProcessor;
 };
 
 #endif // hifi_PacketReceiver_h
@@ -11,8 +11,12 @@
 
 #include "ResourceCache.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <limits>
+#include <mutex>
+#include <set>
 #include <assert.h>
 
 #include <QThread>
@@ -32,21 +36,112 @@
                            (((x) > (max)) ? (max) :\
                                             (x)))
 
+const float ResourceCacheSharedItems::MAX_TYPE_REQUEST_SHARE = 0.75f;
+
+// the heaps are cleaned out once the entries left behind by priority changes outnumber the live ones
+static const int MIN_STALE_PENDING_ENTRIES = 64;
+
+bool ResourceCacheSharedItems::PendingRequest::operator<(const PendingRequest& other) const {
+    if (isFile != other.isFile) {
+        return !isFile;
+    }
+    if (priority != other.priority) {
+        return priority < other.priority;
+    }
+    return sequenceNumber > other.sequenceNumber;
+}
+
 void ResourceCacheSharedItems::appendActiveRequest(QWeakPointer<Resource> resource) {
+    auto strongResource = resource.lock();
+    QString type = strongResource ? strongResource->getType() : QString();
+
     Lock lock(_mutex);
-    _loadingRequests.append(resource);
+    // a resource started directly while it was also queued is no longer pending
+    _pendingRequests.remove(resource.data());
+    _loadingRequests.append({ resource, type });
+    ++_loadingRequestsPerType[type];
 }
 
 void ResourceCacheSharedItems::appendPendingRequest(QWeakPointer<Resource> resource) {
+    auto strongResource = resource.lock();
+    if (!strongResource) {
+        return;
+    }
+    float priority = strongResource->getLoadPriority();
+
+    Lock lock(_mutex);
+    pushPendingRequest(strongResource, priority);
+}
+
+void ResourceCacheSharedItems::updatePendingRequest(QWeakPointer<Resource> resource) {
+    auto strongResource = resource.lock();
+    if (!strongResource) {
+        return;
+    }
+    float priority = strongResource->getLoadPriority();
+
     Lock lock(_mutex);
-    _pendingRequests.append(resource);
+    auto it = _pendingRequests.constFind(strongResource.data());
+    if (it == _pendingRequests.constEnd() || it->priority == priority) {
+        return;
+    }
+    pushPendingRequest(strongResource, priority);
+}
+
+void ResourceCacheSharedItems::pushPendingRequest(const QSharedPointer<Resource>& resource, float priority) {
+    PendingRequest request { resource, resource.data(), resource->getURL().scheme() == URL_SCHEME_FILE,
+                             priority, _nextSequenceNumber++ };
+
+    // replacing the request already kept for this resource leaves its heap entry stale
+    _pendingRequests[request.key] = request;
+
+    auto& heap = _pendingHeaps[resource->getType()];
+    heap.push_back(request);
+    std::push_heap(heap.begin(), heap.end());
+    ++_numHeapEntries;
+
+    if (_numHeapEntries > 2 * _pendingRequests.size() + MIN_STALE_PENDING_ENTRIES) {
+        removeStaleRequests();
+    }
+}
+
+bool ResourceCacheSharedItems::isCurrent(const PendingRequest& request) const {
+    auto it = _pendingRequests.constFind(request.key);
+    return it != _pendingRequests.constEnd() && it->sequenceNumber == request.sequenceNumber;
+}
+
+void ResourceCacheSharedItems::removeStaleRequests() {
+    for (auto it = _pendingRequests.begin(); it != _pendingRequests.end();) {
+        if (!it->resource) {
+            it = _pendingRequests.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    _numHeapEntries = 0;
+    for (auto it = _pendingHeaps.begin(); it != _pendingHeaps.end();) {
+        auto& heap = it.value();
+        heap.erase(std::remove_if(heap.begin(), heap.end(), [&](const PendingRequest& request) {
+            return !isCurrent(request);
+        }), heap.end());
+
+        if (heap.empty()) {
+            it = _pendingHeaps.erase(it);
+            continue;
+        }
+        std::make_heap(heap.begin(), heap.end());
+        _numHeapEntries += (int)heap.size();
+        ++it;
+    }
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _pendingRequests) {
+    for (auto& request : _pendingRequests) {
+        auto resource = request.resource.lock();
         if (resource) {
             result.append(resource);
         }
@@ -64,7 +159,8 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _loadingRequests) {
+    for (auto& request : _loadingRequests) {
+        auto resource = request.resource.lock();
         if (resource) {
             result.append(resource);
         }
@@ -85,9 +181,12 @@ void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
     // QWeakPointer has no operator== implementation for two weak ptrs, so
     // manually loop in case resource has been freed.
     for (int i = 0; i < _loadingRequests.size();) {
-        auto request = _loadingRequests.at(i);
+        auto& request = _loadingRequests.at(i);
         // Clear our resource and any freed resources
-        if (!request || request.data() == resource.data()) {
+        if (!request.resource || request.resource.data() == resource.data()) {
+            if (--_loadingRequestsPerType[request.type] <= 0) {
+                _loadingRequestsPerType.remove(request.type);
+            }
             _loadingRequests.removeAt(i);
             continue;
         }
@@ -95,40 +194,57 @@ void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
     }
 }
 
-QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    QSharedPointer<Resource> highestResource;
+QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest(int requestLimit) {
+    int maxRequestsPerType = std::max(1, (int)(requestLimit * MAX_TYPE_REQUEST_SHARE));
     Lock lock(_mutex);
 
-    bool currentHighestIsFile = false;
+    while (true) {
+        // the best request is at the top of one of the heaps, passing over any type that has used up its share
+        QString highestType;
+        PendingHeap* highestHeap = nullptr;
+        for (auto it = _pendingHeaps.begin(); it != _pendingHeaps.end(); ++it) {
+            if (_pendingHeaps.size() > 1 && _loadingRequestsPerType.value(it.key()) >= maxRequestsPerType) {
+                continue;
+            }
+            if (!highestHeap || highestHeap->front() < it->front()) {
+                highestType = it.key();
+                highestHeap = &it.value();
+            }
+        }
+
+        if (!highestHeap) {
+            return QSharedPointer<Resource>();
+        }
+
+        std::pop_heap(highestHeap->begin(), highestHeap->end());
+        PendingRequest request = highestHeap->back();
+        highestHeap->pop_back();
+        --_numHeapEntries;
+        if (highestHeap->empty()) {
+            _pendingHeaps.remove(highestType);
+        }
+
+        if (!isCurrent(request)) {
+            continue;
+        }
 
-    for (int i = 0; i < _pendingRequests.size();) {
         // Clear any freed resources
-        auto resource = _pendingRequests.at(i).lock();
+        auto resource = request.resource.lock();
         if (!resource) {
-            _pendingRequests.removeAt(i);
+            _pendingRequests.remove(request.key);
             continue;
         }
 
-        // Check load priority
+        // priorities are only pushed when they change, owners that have since gone away drop it back into its place
         float priority = resource->getLoadPriority();
-        bool isFile = resource->getURL().scheme() == URL_SCHEME_FILE;
-        if (priority >= highestPriority && (isFile || !currentHighestIsFile)) {
-            highestPriority = priority;
-            highestIndex = i;
-            highestResource = resource;
-            currentHighestIsFile = isFile;
+        if (priority < request.priority) {
+            pushPendingRequest(resource, priority);
+            continue;
         }
-        i++;
-    }
 
-    if (highestIndex >= 0) {
-        _pendingRequests.takeAt(highestIndex);
+        _pendingRequests.remove(request.key);
+        return resource;
     }
-
-    return highestResource;
 }
 
 ScriptableResource::ScriptableResource(const QUrl& url) :
@@ -217,6 +333,18 @@ ScriptableResource* ResourceCache::prefetch(const QUrl& url, void* extra) {
     return result;
 }
 
+std::atomic<int> ResourceCache::_lastLRUKey { 0 };
+
+// never destroyed, the caches can outlive the statics
+struct CacheRegistry {
+    std::mutex mutex;
+    std::vector<ResourceCache*> caches;
+};
+static CacheRegistry& cacheRegistry() {
+    static CacheRegistry* registry = new CacheRegistry();
+    return *registry;
+}
+
 ResourceCache::ResourceCache(QObject* parent) : QObject(parent) {
     auto nodeList = DependencyManager::get<NodeList>();
     if (nodeList) {
@@ -224,12 +352,57 @@ ResourceCache::ResourceCache(QObject* parent) : QObject(parent) {
         connect(&domainHandler, &DomainHandler::disconnectedFromDomain,
             this, &ResourceCache::clearATPAssets, Qt::DirectConnection);
     }
+
+    auto& registry = cacheRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.caches.push_back(this);
 }
 
 ResourceCache::~ResourceCache() {
+    {
+        auto& registry = cacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.caches.erase(std::remove(registry.caches.begin(), registry.caches.end(), this), registry.caches.end());
+    }
+
     clearUnusedResources();
 }
 
+std::vector<ResourceCache*> ResourceCache::getCaches() {
+    auto& registry = cacheRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.caches;
+}
+
+qint64 ResourceCache::evictUnusedResources(qint64 size) {
+    auto& registry = cacheRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    qint64 freed = 0;
+    std::set<ResourceCache*> evictedCaches;
+    while (freed < size) {
+        ResourceCache* oldestCache = nullptr;
+        int oldestKey = std::numeric_limits<int>::max();
+        for (auto cache : registry.caches) {
+            int key = cache->getOldestUnusedLRUKey();
+            if (key < oldestKey) {
+                oldestKey = key;
+                oldestCache = cache;
+            }
+        }
+        if (!oldestCache) {
+            break;
+        }
+        freed += oldestCache->evictOldestUnusedResource();
+        evictedCaches.insert(oldestCache);
+    }
+
+    for (auto cache : evictedCaches) {
+        cache->resetResourceCounters();
+    }
+    return freed;
+}
+
 void ResourceCache::clearATPAssets() {
     {
         QWriteLocker locker(&_resourcesLock);
@@ -406,22 +579,36 @@ void ResourceCache::removeUnusedResource(const QSharedPointer<Resource>& resourc
 }
 
 void ResourceCache::reserveUnusedResource(qint64 resourceSize) {
-    QWriteLocker locker(&_unusedResourcesLock);
-    while (!_unusedResources.empty() &&
-           _unusedResourcesSize + resourceSize > _unusedResourcesMaxSize) {
-        // unload the oldest resource
-        QMap<int, QSharedPointer<Resource> >::iterator it = _unusedResources.begin();
-        
-        it.value()->setCache(nullptr);
-        auto size = it.value()->getBytes();
+    // unload the oldest resources until there is room
+    while (_unusedResourcesSize + resourceSize > _unusedResourcesMaxSize &&
+           getOldestUnusedLRUKey() != std::numeric_limits<int>::max()) {
+        evictOldestUnusedResource();
+    }
+}
 
-        locker.unlock();
-        removeResource(it.value()->getURL(), size);
-        locker.relock();
+int ResourceCache::getOldestUnusedLRUKey() {
+    QReadLocker locker(&_unusedResourcesLock);
+    return _unusedResources.empty() ? std::numeric_limits<int>::max() : _unusedResources.firstKey();
+}
 
-        _unusedResourcesSize -= size;
-        _unusedResources.erase(it);
+qint64 ResourceCache::evictOldestUnusedResource() {
+    QWriteLocker locker(&_unusedResourcesLock);
+    if (_unusedResources.empty()) {
+        return 0;
     }
+
+    QMap<int, QSharedPointer<Resource> >::iterator it = _unusedResources.begin();
+
+    it.value()->setCache(nullptr);
+    auto size = it.value()->getBytes();
+
+    locker.unlock();
+    removeResource(it.value()->getURL(), size);
+    locker.relock();
+
+    _unusedResourcesSize -= size;
+    _unusedResources.erase(it);
+    return size;
 }
 
 void ResourceCache::clearUnusedResources() {
@@ -506,7 +693,7 @@ void ResourceCache::requestCompleted(QWeakPointer<Resource> resource) {
 
 bool ResourceCache::attemptHighestPriorityRequest() {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
-    auto resource = sharedItems->getHighestPendingRequest();
+    auto resource = sharedItems->getHighestPendingRequest(_requestLimit);
     return (resource && attemptRequest(resource));
 }
 
@@ -541,6 +728,7 @@ void Resource::ensureLoading() {
 void Resource::setLoadPriority(const QPointer<QObject>& owner, float priority) {
     if (!(_failedToLoad)) {
         _loadPriorities.insert(owner, priority);
+        updatePendingRequest();
     }
 }
 
@@ -552,11 +740,20 @@ void Resource::setLoadPriorities(const QHash<QPointer<QObject>, float>& prioriti
             it != priorities.constEnd(); it++) {
         _loadPriorities.insert(it.key(), it.value());
     }
+    updatePendingRequest();
 }
 
 void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
     if (!(_failedToLoad)) {
         _loadPriorities.remove(owner);
+        updatePendingRequest();
+    }
+}
+
+void Resource::updatePendingRequest() {
+    // only a resource waiting for a request slot can be queued
+    if (_startedLoading && !_request && _self) {
+        DependencyManager::get<ResourceCacheSharedItems>()->updatePendingRequest(_self);
     }
 }
 
@@ -689,6 +886,7 @@ void Resource::makeRequest() {
     }
     
     _request->setByteRange(_requestByteRange);
+    _request->setPriority(getLoadPriority());
 
     qCDebug(resourceLog).noquote() << "Starting request for:" << _url.toDisplayString();
     emit loading();
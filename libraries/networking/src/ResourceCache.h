@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
@@ -69,18 +70,57 @@ public:
     void appendPendingRequest(QWeakPointer<Resource> newRequest);
     void appendActiveRequest(QWeakPointer<Resource> newRequest);
     void removeRequest(QWeakPointer<Resource> doneRequest);
+
+    /// Moves a pending request to its place for its current load priority, does nothing if it isn't pending.
+    void updatePendingRequest(QWeakPointer<Resource> request);
+
     QList<QSharedPointer<Resource>> getPendingRequests();
     uint32_t getPendingRequestsCount() const;
     QList<QSharedPointer<Resource>> getLoadingRequests();
-    QSharedPointer<Resource> getHighestPendingRequest();
+
+    /// Takes the pending request to start next: local files first, then by load priority.
+    /// While other types of resource are waiting, one type can't hold more than its share of requestLimit.
+    QSharedPointer<Resource> getHighestPendingRequest(int requestLimit);
+
     uint32_t getLoadingRequestsCount() const;
 
+    // the most of the request limit one type of resource can hold while others are waiting
+    static const float MAX_TYPE_REQUEST_SHARE;
+
 private:
     ResourceCacheSharedItems() = default;
 
+    struct PendingRequest {
+        QWeakPointer<Resource> resource;
+        Resource* key; // only compared, the resource may be gone
+        bool isFile;
+        float priority; // as it was when queued, lowered if found to have dropped when it reaches the top
+        uint32_t sequenceNumber;
+
+        // heap order, the highest is the one to start next and ties go to the first queued
+        bool operator<(const PendingRequest& other) const;
+    };
+    using PendingHeap = std::vector<PendingRequest>;
+
+    struct LoadingRequest {
+        QWeakPointer<Resource> resource;
+        QString type; // kept since the resource may be gone by the time it is removed
+    };
+
+    void pushPendingRequest(const QSharedPointer<Resource>& resource, float priority);
+    bool isCurrent(const PendingRequest& request) const;
+    void removeStaleRequests();
+
     mutable Mutex _mutex;
-    QList<QWeakPointer<Resource>> _pendingRequests;
-    QList<QWeakPointer<Resource>> _loadingRequests;
+
+    // a heap per type of resource, entries are stale once they no longer match the one kept in _pendingRequests
+    QHash<QString, PendingHeap> _pendingHeaps;
+    QHash<Resource*, PendingRequest> _pendingRequests;
+    int _numHeapEntries { 0 };
+    uint32_t _nextSequenceNumber { 0 };
+
+    QList<LoadingRequest> _loadingRequests;
+    QHash<QString, int> _loadingRequestsPerType;
 };
 
 /// Wrapper to expose resources to JS/QML
@@ -238,6 +278,13 @@ public:
     void setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize);
     qint64 getUnusedResourceCacheSize() const { return _unusedResourcesMaxSize; }
 
+    /// All the resource caches of the process, to budget memory across them.
+    static std::vector<ResourceCache*> getCaches();
+
+    /// Unloads unused resources of any cache, least recently used first, until at least size bytes are freed.
+    /// \return the bytes freed, less than size if there were not enough unused resources
+    static qint64 evictUnusedResources(qint64 size);
+
     static QList<QSharedPointer<Resource>> getLoadingRequests();
 
     static int getPendingRequestCount();
@@ -310,6 +357,8 @@ private:
     friend class Resource;
 
     void reserveUnusedResource(qint64 resourceSize);
+    int getOldestUnusedLRUKey();
+    qint64 evictOldestUnusedResource();
     void resetResourceCounters();
     void removeResource(const QUrl& url, qint64 size = 0);
 
@@ -319,7 +368,8 @@ private:
     // Resources
     QHash<QUrl, QWeakPointer<Resource>> _resources;
     QReadWriteLock _resourcesLock { QReadWriteLock::Recursive };
-    int _lastLRUKey = 0;
+    // shared by the caches, so that their unused resources can be compared by recency
+    static std::atomic<int> _lastLRUKey;
 
     std::atomic<size_t> _numTotalResources { 0 };
     std::atomic<qint64> _totalResourcesSize { 0 };
@@ -427,6 +477,9 @@ protected slots:
 protected:
     virtual void init(bool resetLoaded = true);
 
+    /// Moves this resource to its new place in the queue if it is waiting to be requested.
+    void updatePendingRequest();
+
     /// Called by ResourceCache to begin loading this Resource.
     /// This method can be overriden to provide custom request functionality. If this is done,
     /// downloadFinished and ResourceCache::requestCompleted must be called.
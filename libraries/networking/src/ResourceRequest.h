@@ -73,6 +73,12 @@ public:
     void setCacheEnabled(bool value) { _cacheEnabled = value; }
     void setByteRange(ByteRange byteRange) { _byteRange = byteRange; }
 
+    // the load priority of the resource when it was sent, how it is used is up to the protocol
+    void setPriority(float priority) { _priority = priority; }
+
+    // asks for the copy of a texture the server baked to KTX, only the asset server has one
+    void setBakedTextureRequested(bool value) { _bakedTextureRequested = value; }
+
 public slots:
     void send();
 
@@ -90,6 +96,8 @@ protected:
     bool _cacheEnabled { true };
     bool _loadedFromCache { false };
     ByteRange _byteRange;
+    float _priority { 0.0f };
+    bool _bakedTextureRequested { false };
     bool _rangeRequestSuccessful { false };
     uint64_t _totalSizeOfResource { 0 };
 };
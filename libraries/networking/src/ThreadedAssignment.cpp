@@ -16,10 +16,12 @@
 #include <QtCore/QTimer>
 
 #include <LogHandler.h>
+#include <shared/Metrics.h>
 
 #include "ThreadedAssignment.h"
 
 #include "NetworkLogging.h"
+#include "udt/PacketBufferPool.h"
 
 ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     Assignment(message),
@@ -103,8 +105,27 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["outbound_bytes_per_s"] = bytesOutPerSecond;
     ioStats["outbound_packets_per_s"] = packetsOutPerSecond;
 
+    // packet buffer allocations served from (hits) or missing (misses) the pool since the last stats packet
+    auto bufferPoolStats = udt::PacketBufferPool::getStats();
+    udt::PacketBufferPool::resetStats();
+    ioStats["packet_buffer_pool_hits"] = (double)bufferPoolStats.hits;
+    ioStats["packet_buffer_pool_misses"] = (double)bufferPoolStats.misses;
+
     statsObject["io_stats"] = ioStats;
 
+    // the same rates for a metrics scraper
+    auto& registry = metrics::Registry::getInstance();
+    static auto& inboundBytes = registry.gauge("inbound_bytes_per_second", "Bytes received per second");
+    static auto& inboundPackets = registry.gauge("inbound_packets_per_second", "Packets received per second");
+    static auto& outboundBytes = registry.gauge("outbound_bytes_per_second", "Bytes sent per second");
+    static auto& outboundPackets = registry.gauge("outbound_packets_per_second", "Packets sent per second");
+    static auto& numNodes = registry.gauge("nodes", "Nodes this assignment knows of");
+    inboundBytes.set(bytesInPerSecond);
+    inboundPackets.set(packetsInPerSecond);
+    outboundBytes.set(bytesOutPerSecond);
+    outboundPackets.set(packetsOutPerSecond);
+    numNodes.set(nodeList->size());
+
     nodeList->sendStatsToDomainServer(statsObject);
 }
 
@@ -0,0 +1,370 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double USECS_PER_SECOND = 1000000.0;
+
+// 2 / ln(2), the smallest gain that lets Startup double the delivery rate every round trip
+static const double STARTUP_GAIN = 2.885;
+static const double DRAIN_GAIN = 1.0 / STARTUP_GAIN;
+static const double CONGESTION_WINDOW_GAIN = 2.0;
+
+// one phase probing for more bandwidth, one draining the queue that probing built, then six cruising at the estimate
+static const std::array<double, 8> PROBE_BANDWIDTH_GAINS {{ 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 }};
+static const int PROBE_BANDWIDTH_DRAIN_PHASE = 1;
+
+// Startup is done once the bandwidth has failed to grow by a quarter for three rounds in a row
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const int64_t MIN_RTT_WINDOW_USECS = 10000000;
+static const int64_t PROBE_RTT_DURATION_USECS = 200000;
+static const int MAX_RTT_SAMPLE_USECS = 10000000;
+static const int DEFAULT_RTT_USECS = DEFAULT_SYN_INTERVAL * 10;
+
+static const int MIN_CONGESTION_WINDOW_PACKETS = 4;
+static const int INITIAL_CONGESTION_WINDOW_PACKETS = 10;
+
+BBRCC::BBRCC() :
+    _pacingGain(STARTUP_GAIN),
+    _congestionWindowGain(STARTUP_GAIN)
+{
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    _congestionWindowSize = INITIAL_CONGESTION_WINDOW_PACKETS;
+
+    setAckInterval(1); // delivery rate and RTT are sampled from every ACK
+
+    updatePacketSendPeriod();
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    int newlyDelivered = seqoff(_lastACK, ack);
+    if (newlyDelivered <= 0) {
+        return false;
+    }
+
+    _lastACK = ack;
+    _delivered += newlyDelivered;
+    _deliveredTime = receiveTime;
+
+    if (_isInRecovery && ack >= _recoverySequenceNumber) {
+        _isInRecovery = false;
+    }
+
+    // ACKs are cumulative, so every packet up to this one has now been delivered
+    // the most recently sent of them gives us this ACK's rate and RTT samples
+    bool hasSample = false;
+    SentPacket sample {};
+    while (!_sentPackets.empty() && _sentPackets.front().sequenceNumber <= ack) {
+        sample = _sentPackets.front();
+        hasSample = true;
+        _sentPackets.pop_front();
+    }
+
+    _isRoundStart = false;
+
+    if (hasSample) {
+        if (sample.delivered >= _nextRoundDelivered) {
+            // a packet sent after the last round began has been ACKed, this starts the next round trip
+            _nextRoundDelivered = _delivered;
+            ++_roundCount;
+            _isRoundStart = true;
+
+            // a round spent in recovery may not have had a single usable rate, so that doesn't age the filter
+            if (_roundBandwidths[_roundBandwidthIndex] > 0.0) {
+                _roundBandwidthIndex = (_roundBandwidthIndex + 1) % BANDWIDTH_WINDOW_ROUNDS;
+                _roundBandwidths[_roundBandwidthIndex] = 0.0;
+            }
+        }
+
+        _firstSentTime = sample.sentTime;
+
+        if (sample.sequenceNumber == ack && !sample.wasRetransmitted) {
+            int rtt = (int)duration_cast<microseconds>(receiveTime - sample.sentTime).count();
+            updateMinRTT(std::min(std::max(rtt, 1), MAX_RTT_SAMPLE_USECS), receiveTime);
+        }
+
+        updateBandwidth(sample, receiveTime);
+    }
+
+    updateMode(receiveTime);
+    updateCongestionWindow(newlyDelivered);
+    updatePacketSendPeriod();
+
+    // losses are recovered through NAKs, we never ask for a fast re-transmit
+    return false;
+}
+
+void BBRCC::onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) {
+    // a lossy link drops packets whether or not we're over its bandwidth, so loss on its own doesn't change the model
+    // it only tells a bandwidth probe that it has gone far enough
+    _hadLossInCycle = true;
+
+    // ACKs stop at the lost packet until it is re-sent, and then jump past everything delivered behind it
+    // rates measured across that jump would be far higher than the link, so we hold off until it is ACKed past
+    _isInRecovery = true;
+    _recoverySequenceNumber = _sendCurrSeqNum;
+}
+
+void BBRCC::onTimeout() {
+    // nothing has been ACKed for a while, so fall back to a minimal window until ACKs start coming back
+    saveCongestionWindow();
+    _congestionWindowSize = MIN_CONGESTION_WINDOW_PACKETS;
+    _shouldRestoreCongestionWindow = true;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (seqNum <= _lastACK) {
+        return;
+    }
+
+    if (!_sentPackets.empty() && seqNum <= _sentPackets.back().sequenceNumber) {
+        // this is a re-transmission of a packet that is still in flight
+        int index = seqoff(_sentPackets.front().sequenceNumber, seqNum);
+        if (index >= 0 && index < packetsInFlight() && _sentPackets[index].sequenceNumber == seqNum) {
+            _sentPackets[index].wasRetransmitted = true;
+        }
+        return;
+    }
+
+    if (_sentPackets.empty()) {
+        // start measuring delivery from now, so that time spent idle doesn't count against the next rate sample
+        _deliveredTime = timePoint;
+        _firstSentTime = timePoint;
+    }
+
+    // if we could have sent sooner, with room in the window and pacing long since allowing it, then we ran out of
+    // things to send and the rate this packet is delivered at may be well under what the path can do
+    auto sinceLastSent = duration_cast<microseconds>(timePoint - _lastSentTime).count();
+    bool isAppLimited = packetsInFlight() + 1 < _congestionWindowSize && sinceLastSent > 2 * _packetSendPeriod;
+
+    _sentPackets.push_back({ seqNum, timePoint, _delivered, _deliveredTime, _firstSentTime,
+                             isAppLimited, _isInRecovery, false });
+    _lastSentTime = timePoint;
+}
+
+void BBRCC::updateBandwidth(const SentPacket& packet, p_high_resolution_clock::time_point receiveTime) {
+    if (packet.wasSentInRecovery) {
+        return;
+    }
+
+    // the packets delivered since this one was sent can't have arrived faster than they were sent or ACKed,
+    // so taking the longer of the two keeps ACKs bunched up on the way back from inflating the rate
+    auto sendInterval = duration_cast<microseconds>(packet.sentTime - packet.firstSentTime).count();
+    auto ackInterval = duration_cast<microseconds>(receiveTime - packet.deliveredTime).count();
+    auto interval = std::max(sendInterval, ackInterval);
+
+    // an interval shorter than the min RTT can't have measured a full round trip's worth of delivery
+    if (interval <= 0 || (_minRTT > 0 && interval < _minRTT)) {
+        return;
+    }
+
+    double deliveryRate = (double)(_delivered - packet.delivered) * USECS_PER_SECOND / interval;
+
+    // an app limited sample can only tell us the bandwidth is at least this much
+    if (packet.isAppLimited && deliveryRate < bottleneckBandwidth()) {
+        return;
+    }
+
+    double& roundBandwidth = _roundBandwidths[_roundBandwidthIndex];
+    roundBandwidth = std::max(roundBandwidth, deliveryRate);
+}
+
+void BBRCC::updateMinRTT(int rtt, p_high_resolution_clock::time_point receiveTime) {
+    bool hasExpired = _minRTT > 0
+        && duration_cast<microseconds>(receiveTime - _minRTTStamp).count() > MIN_RTT_WINDOW_USECS;
+
+    if (_minRTT < 0 || rtt <= _minRTT || hasExpired) {
+        _minRTT = rtt;
+        _minRTTStamp = receiveTime;
+    }
+
+    // the min RTT hasn't been seen for a while, it may only be hidden by our own queue - drain it to check
+    if (hasExpired && _mode != Mode::ProbeRTT) {
+        enterProbeRTT();
+    }
+}
+
+void BBRCC::updateMode(p_high_resolution_clock::time_point receiveTime) {
+    if (_isRoundStart && !_isPipeFilled) {
+        double bandwidth = bottleneckBandwidth();
+        if (bandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+            _fullBandwidth = bandwidth;
+            _fullBandwidthRounds = 0;
+        } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+            _isPipeFilled = true;
+        }
+    }
+
+    if (_mode == Mode::Startup && _isPipeFilled) {
+        // get rid of the queue Startup built up on its last rounds
+        _mode = Mode::Drain;
+        _pacingGain = DRAIN_GAIN;
+        _congestionWindowGain = STARTUP_GAIN;
+    }
+
+    if (_mode == Mode::Drain && packetsInFlight() <= bandwidthDelayProduct(1.0)) {
+        enterProbeBandwidth(receiveTime);
+    }
+
+    if (_mode == Mode::ProbeBandwidth) {
+        updateProbeBandwidthCycle(receiveTime);
+    } else if (_mode == Mode::ProbeRTT) {
+        updateProbeRTT(receiveTime);
+    }
+}
+
+void BBRCC::updateProbeBandwidthCycle(p_high_resolution_clock::time_point receiveTime) {
+    bool isFullLength = _minRTT > 0 && duration_cast<microseconds>(receiveTime - _cycleStamp).count() > _minRTT;
+    double gain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+
+    bool shouldAdvance;
+    if (gain > 1.0) {
+        // keep probing until we've had a full RTT of the higher rate and either filled the bigger pipe or hit loss
+        shouldAdvance = isFullLength && (_hadLossInCycle || packetsInFlight() >= bandwidthDelayProduct(gain));
+    } else if (gain < 1.0) {
+        // stop draining as soon as the queue is gone
+        shouldAdvance = isFullLength || packetsInFlight() <= bandwidthDelayProduct(1.0);
+    } else {
+        shouldAdvance = isFullLength;
+    }
+
+    if (shouldAdvance) {
+        _cycleIndex = (_cycleIndex + 1) % (int)PROBE_BANDWIDTH_GAINS.size();
+        _cycleStamp = receiveTime;
+        _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+        _hadLossInCycle = false;
+    }
+}
+
+void BBRCC::updateProbeRTT(p_high_resolution_clock::time_point receiveTime) {
+    if (!_hasProbeRTTDoneStamp) {
+        if (packetsInFlight() <= MIN_CONGESTION_WINDOW_PACKETS) {
+            // the queue is drained, hold the window down for a round trip and PROBE_RTT_DURATION_USECS
+            _probeRTTDoneStamp = receiveTime + microseconds(PROBE_RTT_DURATION_USECS);
+            _hasProbeRTTDoneStamp = true;
+            _isProbeRTTRoundDone = false;
+            _nextRoundDelivered = _delivered;
+        }
+    } else {
+        if (_isRoundStart) {
+            _isProbeRTTRoundDone = true;
+        }
+
+        if (_isProbeRTTRoundDone && receiveTime >= _probeRTTDoneStamp) {
+            _minRTTStamp = receiveTime;
+            _shouldRestoreCongestionWindow = true;
+
+            if (_isPipeFilled) {
+                enterProbeBandwidth(receiveTime);
+            } else {
+                _mode = Mode::Startup;
+                _pacingGain = STARTUP_GAIN;
+                _congestionWindowGain = STARTUP_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::updateCongestionWindow(int newlyDelivered) {
+    if (_shouldRestoreCongestionWindow) {
+        _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+        _shouldRestoreCongestionWindow = false;
+    }
+
+    int targetWindowSize = bandwidthDelayProduct(_congestionWindowGain);
+
+    if (_isPipeFilled) {
+        _congestionWindowSize = std::min(_congestionWindowSize + newlyDelivered, targetWindowSize);
+    } else if (_congestionWindowSize < targetWindowSize || _delivered < INITIAL_CONGESTION_WINDOW_PACKETS) {
+        _congestionWindowSize += newlyDelivered;
+    }
+
+    _congestionWindowSize = std::max(_congestionWindowSize, MIN_CONGESTION_WINDOW_PACKETS);
+
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = std::min(_congestionWindowSize, MIN_CONGESTION_WINDOW_PACKETS);
+    }
+
+    _congestionWindowSize = std::min(_congestionWindowSize, udt::MAX_PACKETS_IN_FLIGHT);
+}
+
+void BBRCC::updatePacketSendPeriod() {
+    double bandwidth = bottleneckBandwidth();
+    if (bandwidth <= 0.0) {
+        // nothing has been measured yet, spread the initial window out over the RTT
+        int rtt = _minRTT > 0 ? _minRTT : (_rtt > 0 ? _rtt : DEFAULT_RTT_USECS);
+        bandwidth = INITIAL_CONGESTION_WINDOW_PACKETS * USECS_PER_SECOND / rtt;
+    }
+
+    double sendPeriod = USECS_PER_SECOND / (_pacingGain * bandwidth);
+
+    // until Startup has found the bottleneck, a round with a poor delivery rate shouldn't slow us down
+    if (_isPipeFilled || _delivered == 0 || sendPeriod < _packetSendPeriod) {
+        setPacketSendPeriod(sendPeriod);
+    }
+}
+
+void BBRCC::enterProbeBandwidth(p_high_resolution_clock::time_point receiveTime) {
+    _mode = Mode::ProbeBandwidth;
+    _congestionWindowGain = CONGESTION_WINDOW_GAIN;
+
+    // start the cycle at a random phase other than the drain, so flows sharing a bottleneck don't probe in lockstep
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<> distribution(0, (int)PROBE_BANDWIDTH_GAINS.size() - 2);
+    _cycleIndex = distribution(generator);
+    if (_cycleIndex >= PROBE_BANDWIDTH_DRAIN_PHASE) {
+        ++_cycleIndex;
+    }
+
+    _cycleStamp = receiveTime;
+    _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+    _hadLossInCycle = false;
+}
+
+void BBRCC::enterProbeRTT() {
+    _mode = Mode::ProbeRTT;
+    _pacingGain = 1.0;
+    _congestionWindowGain = 1.0;
+    _hasProbeRTTDoneStamp = false;
+
+    saveCongestionWindow();
+}
+
+void BBRCC::saveCongestionWindow() {
+    if (_shouldRestoreCongestionWindow) {
+        // we haven't restored the last window we saved yet, don't replace it with one we've already cut down
+        _priorCongestionWindowSize = std::max(_priorCongestionWindowSize, _congestionWindowSize);
+    } else {
+        _priorCongestionWindowSize = _congestionWindowSize;
+    }
+}
+
+double BBRCC::bottleneckBandwidth() const {
+    return *std::max_element(_roundBandwidths.begin(), _roundBandwidths.end());
+}
+
+int BBRCC::bandwidthDelayProduct(double gain) const {
+    double bandwidth = bottleneckBandwidth();
+    if (_minRTT < 0 || bandwidth <= 0.0) {
+        return INITIAL_CONGESTION_WINDOW_PACKETS;
+    }
+
+    return (int)std::ceil(gain * bandwidth * _minRTT / USECS_PER_SECOND);
+}
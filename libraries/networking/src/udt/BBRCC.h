@@ -0,0 +1,124 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <array>
+#include <deque>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Congestion control modelled on BBR (https://queue.acm.org/detail.cfm?id=3022184).
+//
+// Rather than treating loss as the congestion signal, this keeps a model of the path - the bottleneck bandwidth as the
+// max delivery rate seen over the last few round trips, and the propagation delay as the min RTT seen over the last
+// few seconds - and paces packets out at that bandwidth, with a window of twice the bandwidth-delay product.
+// The pacing rate is periodically raised to probe for more bandwidth and lowered to drain any queue that built up.
+//
+// Every calculation is driven by the send and ACK receive times handed to us, never by the wall clock.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) override;
+    virtual void onTimeout() override;
+
+    virtual bool shouldNAK() override { return true; }
+    virtual bool shouldACK2() override { return false; }
+    virtual bool shouldProbe() override { return false; }
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    enum class Mode { Startup, Drain, ProbeBandwidth, ProbeRTT };
+
+    struct SentPacket {
+        SequenceNumber sequenceNumber;
+        p_high_resolution_clock::time_point sentTime;
+        int64_t delivered; // _delivered when this packet was sent
+        p_high_resolution_clock::time_point deliveredTime; // _deliveredTime when this packet was sent
+        p_high_resolution_clock::time_point firstSentTime; // _firstSentTime when this packet was sent
+        bool isAppLimited; // the sender had nothing else to send, so this packet's delivery rate says little about the path
+        bool wasSentInRecovery; // sent while ACKs were held up behind a loss, so its delivery counts are out of date
+        bool wasRetransmitted; // the RTT of a retransmitted packet is ambiguous
+    };
+
+    void updateBandwidth(const SentPacket& packet, p_high_resolution_clock::time_point receiveTime);
+    void updateMinRTT(int rtt, p_high_resolution_clock::time_point receiveTime);
+    void updateMode(p_high_resolution_clock::time_point receiveTime);
+    void updateProbeBandwidthCycle(p_high_resolution_clock::time_point receiveTime);
+    void updateProbeRTT(p_high_resolution_clock::time_point receiveTime);
+    void updateCongestionWindow(int newlyDelivered);
+    void updatePacketSendPeriod();
+
+    void enterProbeBandwidth(p_high_resolution_clock::time_point receiveTime);
+    void enterProbeRTT();
+    void saveCongestionWindow();
+
+    double bottleneckBandwidth() const; // packets per second
+    int bandwidthDelayProduct(double gain) const; // packets
+    int packetsInFlight() const { return (int)_sentPackets.size(); }
+
+    static const int BANDWIDTH_WINDOW_ROUNDS = 10;
+
+    std::deque<SentPacket> _sentPackets; // packets sent and not yet ACKed, in sequence order
+
+    SequenceNumber _lastACK; // sequence number of the last packet that was ACKed
+
+    int64_t _delivered { 0 }; // total packets ACKed over the connection
+    p_high_resolution_clock::time_point _deliveredTime; // time _delivered last changed
+    p_high_resolution_clock::time_point _firstSentTime; // time the most recently ACKed packet was sent
+    p_high_resolution_clock::time_point _lastSentTime; // time of the last new packet sent
+
+    std::array<double, BANDWIDTH_WINDOW_ROUNDS> _roundBandwidths {}; // max delivery rate for recent rounds, packets per second
+    int _roundBandwidthIndex { 0 }; // slot for the current round, only moves on from rounds that gave us a rate
+    int64_t _roundCount { 0 }; // number of round trips so far
+    int64_t _nextRoundDelivered { 0 }; // _delivered at which the current round trip ends
+    bool _isRoundStart { false }; // the last ACK started a new round trip
+
+    bool _isInRecovery { false }; // a loss was reported and hasn't been ACKed past yet
+    SequenceNumber _recoverySequenceNumber; // last packet sent when the loss was reported
+
+    int _minRTT { -1 }; // min RTT over the last MIN_RTT_WINDOW, in microseconds
+    p_high_resolution_clock::time_point _minRTTStamp; // time _minRTT was last set
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _congestionWindowGain;
+
+    double _fullBandwidth { 0.0 }; // bandwidth that Startup last grew significantly past, packets per second
+    int _fullBandwidthRounds { 0 }; // rounds since Startup last grew significantly
+    bool _isPipeFilled { false }; // Startup has found the bottleneck bandwidth
+
+    int _cycleIndex { 0 }; // current phase of the ProbeBandwidth gain cycle
+    p_high_resolution_clock::time_point _cycleStamp; // time the current phase began
+    bool _hadLossInCycle { false }; // loss was reported during the current phase
+
+    p_high_resolution_clock::time_point _probeRTTDoneStamp; // time ProbeRTT may end, once its window has drained
+    bool _hasProbeRTTDoneStamp { false };
+    bool _isProbeRTTRoundDone { false };
+
+    int _priorCongestionWindowSize { 0 }; // window to come back to after ProbeRTT or a timeout
+    bool _shouldRestoreCongestionWindow { false };
+};
+
+}
+
+#endif // hifi_BBRCC_h
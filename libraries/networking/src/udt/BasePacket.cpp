@@ -12,6 +12,7 @@
 #include "BasePacket.h"
 
 #include "../NetworkLogging.h"
+#include "PacketBufferPool.h"
 
 using namespace udt;
 
@@ -35,13 +36,13 @@ std::unique_ptr<BasePacket> BasePacket::create(qint64 size) {
     return packet;
 }
 
-std::unique_ptr<BasePacket> BasePacket::fromReceivedPacket(std::unique_ptr<char[]> data,
-                                                           qint64 size, const HifiSockAddr& senderSockAddr) {
+std::unique_ptr<BasePacket> BasePacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+                                                           const HifiSockAddr& senderSockAddr, qint64 bufferCapacity) {
     // Fail with invalid size
     Q_ASSERT(size >= 0);
     
     // allocate memory
-    auto packet = std::unique_ptr<BasePacket>(new BasePacket(std::move(data), size, senderSockAddr));
+    auto packet = std::unique_ptr<BasePacket>(new BasePacket(std::move(data), size, senderSockAddr, bufferCapacity));
     
     packet->open(QIODevice::ReadOnly);
     
@@ -60,15 +61,18 @@ BasePacket::BasePacket(qint64 size) {
     Q_ASSERT(size >= 0 || size < maxPayload);
     
     _packetSize = size;
-    _packet.reset(new char[_packetSize]());
+    _packet = PacketBufferPool::acquire(_packetSize, _bufferCapacity);
+    memset(_packet.get(), 0, _packetSize);
     _payloadCapacity = _packetSize;
     _payloadSize = 0;
     _payloadStart = _packet.get();
 }
 
-BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr,
+                       qint64 bufferCapacity) :
     _packetSize(size),
     _packet(std::move(data)),
+    _bufferCapacity(bufferCapacity < 0 ? size : bufferCapacity),
     _payloadStart(_packet.get()),
     _payloadCapacity(size),
     _payloadSize(size),
@@ -77,6 +81,10 @@ BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSock
     
 }
 
+BasePacket::~BasePacket() {
+    PacketBufferPool::release(std::move(_packet), _bufferCapacity);
+}
+
 BasePacket::BasePacket(const BasePacket& other) :
     QIODevice()
 {
@@ -84,8 +92,10 @@ BasePacket::BasePacket(const BasePacket& other) :
 }
 
 BasePacket& BasePacket::operator=(const BasePacket& other) {
+    PacketBufferPool::release(std::move(_packet), _bufferCapacity);
+
     _packetSize = other._packetSize;
-    _packet = std::unique_ptr<char[]>(new char[_packetSize]);
+    _packet = PacketBufferPool::acquire(_packetSize, _bufferCapacity);
     memcpy(_packet.get(), other._packet.get(), _packetSize);
     
     _payloadStart = _packet.get() + (other._payloadStart - other._packet.get());
@@ -109,8 +119,11 @@ BasePacket::BasePacket(BasePacket&& other) {
 }
 
 BasePacket& BasePacket::operator=(BasePacket&& other) {
+    PacketBufferPool::release(std::move(_packet), _bufferCapacity);
+
     _packetSize = other._packetSize;
     _packet = std::move(other._packet);
+    _bufferCapacity = other._bufferCapacity;
     
     _payloadStart = other._payloadStart;
     _payloadCapacity = other._payloadCapacity;
@@ -31,8 +31,11 @@ public:
     static const qint64 PACKET_WRITE_ERROR;
     
     static std::unique_ptr<BasePacket> create(qint64 size = -1);
+    // bufferCapacity is the allocated size of data, when it is known to be larger than size (-1 if it is not)
     static std::unique_ptr<BasePacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
-                                                          const HifiSockAddr& senderSockAddr);
+                                                          const HifiSockAddr& senderSockAddr, qint64 bufferCapacity = -1);
+
+    virtual ~BasePacket();
     
     // Current level's header size
     static int localHeaderSize();
@@ -92,7 +95,7 @@ public:
     
 protected:
     BasePacket(qint64 size);
-    BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr, qint64 bufferCapacity = -1);
     BasePacket(const BasePacket& other);
     BasePacket& operator=(const BasePacket& other);
     BasePacket(BasePacket&& other);
@@ -106,6 +109,7 @@ protected:
     
     qint64 _packetSize = 0;        // Total size of the allocated memory
     std::unique_ptr<char[]> _packet; // Allocated memory
+    qint64 _bufferCapacity = 0;    // Size of the allocation, returned with it to the PacketBufferPool
     
     char* _payloadStart = nullptr; // Start of the payload
     qint64 _payloadCapacity = 0;          // Total capacity of the payload
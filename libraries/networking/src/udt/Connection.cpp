@@ -116,6 +116,7 @@ SendQueue& Connection::getSendQueue() {
         QObject::connect(_sendQueue.get(), &SendQueue::packetSent, this, &Connection::packetSent);
         QObject::connect(_sendQueue.get(), &SendQueue::packetSent, this, &Connection::recordSentPackets);
         QObject::connect(_sendQueue.get(), &SendQueue::packetRetransmitted, this, &Connection::recordRetransmission);
+        QObject::connect(_sendQueue.get(), &SendQueue::packetBatchSent, this, &Connection::recordSentBatch);
         QObject::connect(_sendQueue.get(), &SendQueue::queueInactive, this, &Connection::queueInactive);
         QObject::connect(_sendQueue.get(), &SendQueue::timeout, this, &Connection::queueTimeout);
         QObject::connect(_sendQueue.get(), &SendQueue::shortCircuitLoss, this, &Connection::queueShortCircuitLoss);
@@ -272,6 +273,10 @@ void Connection::recordSentPackets(int wireSize, int payloadSize,
     _congestionControl->onPacketSent(wireSize, seqNum, timePoint);
 }
 
+void Connection::recordSentBatch(int numPackets) {
+    _stats.recordSentBatch(numPackets);
+}
+
 void Connection::recordRetransmission(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
     _stats.record(ConnectionStats::Stats::Retransmission);
 
@@ -515,6 +520,10 @@ bool Connection::processReceivedSequenceNumber(SequenceNumber sequenceNumber, in
         wasDuplicate = !_lossList.remove(sequenceNumber);
     }
     
+    if (!_lossList.isEmpty()) {
+        _stats.recordLossListSize(_lossList.getLength(), _lossList.getNumRanges());
+    }
+    
     // increment the counters for data packets received
     ++_packetsSinceACK;
     
@@ -70,6 +70,9 @@ public:
     void processControl(ControlPacketPointer controlPacket);
 
     void queueReceivedMessagePacket(std::unique_ptr<Packet> packet);
+
+    // called by the Socket for packets that arrived through a batched read
+    void recordReceivedBatchedPacket() { _stats.recordReceivedBatchedPacket(); }
     
     ConnectionStats::Stats sampleStats() { return _stats.sample(); }
     
@@ -89,6 +92,7 @@ signals:
 private slots:
     void recordSentPackets(int wireSize, int payloadSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint);
     void recordRetransmission(int wireSize, SequenceNumber sequenceNumber, p_high_resolution_clock::time_point timePoint);
+    void recordSentBatch(int numPackets);
     void queueInactive();
     void queueTimeout();
     void queueShortCircuitLoss(quint32 sequenceNumber);
@@ -11,6 +11,8 @@
 
 #include "ConnectionStats.h"
 
+#include <algorithm>
+
 using namespace udt;
 using namespace std::chrono;
 
@@ -80,6 +82,27 @@ void ConnectionStats::recordUnreliableReceivedPackets(int payload, int total) {
     _total.receivedUnreliableBytes += total;
 }
 
+void ConnectionStats::recordSentBatch(int numPackets) {
+    ++_currentSample.sentBatches;
+    ++_total.sentBatches;
+
+    _currentSample.sentBatchedPackets += numPackets;
+    _total.sentBatchedPackets += numPackets;
+}
+
+void ConnectionStats::recordReceivedBatchedPacket() {
+    ++_currentSample.receivedBatchedPackets;
+    ++_total.receivedBatchedPackets;
+}
+
+void ConnectionStats::recordLossListSize(int length, int ranges) {
+    _currentSample.maxLossListLength = std::max(_currentSample.maxLossListLength, length);
+    _total.maxLossListLength = std::max(_total.maxLossListLength, length);
+
+    _currentSample.maxLossListRanges = std::max(_currentSample.maxLossListRanges, ranges);
+    _total.maxLossListRanges = std::max(_total.maxLossListRanges, ranges);
+}
+
 static const double EWMA_CURRENT_SAMPLE_WEIGHT = 0.125;
 static const double EWMA_PREVIOUS_SAMPLES_WEIGHT = 1.0 - EWMA_CURRENT_SAMPLE_WEIGHT;
 
@@ -61,6 +61,15 @@ public:
         int receivedUnreliableUtilBytes { 0 };
         int sentUnreliableBytes { 0 };
         int receivedUnreliableBytes { 0 };
+
+        // batched socket I/O (sendmmsg/recvmmsg, where supported)
+        int sentBatches { 0 };
+        int sentBatchedPackets { 0 };
+        int receivedBatchedPackets { 0 };
+
+        // the largest the receive loss list got, in packets and in the ranges it keeps them in
+        int maxLossListLength { 0 };
+        int maxLossListRanges { 0 };
        
         // the following stats are trailing averages in the result, not totals
         int sendRate { 0 };
@@ -86,6 +95,11 @@ public:
     
     void recordUnreliableSentPackets(int payload, int total);
     void recordUnreliableReceivedPackets(int payload, int total);
+
+    void recordSentBatch(int numPackets);
+    void recordReceivedBatchedPacket();
+
+    void recordLossListSize(int length, int ranges);
     
     void recordSendRate(int sample);
     void recordReceiveRate(int sample);
@@ -28,6 +28,11 @@ namespace udt {
     static const int UDP_RECEIVE_BUFFER_SIZE_BYTES = 1048576;
     static const int DEFAULT_SYN_INTERVAL_USECS = 10 * 1000;
 
+    // DSCP code points that packets are marked with, they go in the upper six bits of the IP type of service byte
+    static const uint8_t DSCP_DEFAULT = 0;
+    static const uint8_t DSCP_EXPEDITED_FORWARDING = 46; // EF, for voice
+    static const uint8_t DSCP_ASSURED_FORWARDING_41 = 34; // AF41, for interactive video and the like
+
     
     // Header constants
 
@@ -26,7 +26,7 @@ int ControlPacket::maxPayloadSize() {
 }
 
 std::unique_ptr<ControlPacket> ControlPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
-                                                                 const HifiSockAddr &senderSockAddr) {
+                                                                 const HifiSockAddr &senderSockAddr, qint64 bufferCapacity) {
     // Fail with null data
     Q_ASSERT(data);
     
@@ -34,7 +34,7 @@ std::unique_ptr<ControlPacket> ControlPacket::fromReceivedPacket(std::unique_ptr
     Q_ASSERT(size >= 0);
     
     // allocate memory
-    auto packet = std::unique_ptr<ControlPacket>(new ControlPacket(std::move(data), size, senderSockAddr));
+    auto packet = std::unique_ptr<ControlPacket>(new ControlPacket(std::move(data), size, senderSockAddr, bufferCapacity));
     
     packet->open(QIODevice::ReadOnly);
     
@@ -56,8 +56,9 @@ ControlPacket::ControlPacket(Type type, qint64 size) :
     writeType();
 }
 
-ControlPacket::ControlPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
-    BasePacket(std::move(data), size, senderSockAddr)
+ControlPacket::ControlPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr,
+                             qint64 bufferCapacity) :
+    BasePacket(std::move(data), size, senderSockAddr, bufferCapacity)
 {
     // sanity check before we decrease the payloadSize with the payloadCapacity
     Q_ASSERT(_payloadSize == _payloadCapacity);
@@ -40,7 +40,7 @@ public:
     
     static std::unique_ptr<ControlPacket> create(Type type, qint64 size = -1);
     static std::unique_ptr<ControlPacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
-                                                             const HifiSockAddr& senderSockAddr);
+                                                             const HifiSockAddr& senderSockAddr, qint64 bufferCapacity = -1);
     // Current level's header size
     static int localHeaderSize();
     // Cumulated size of all the headers
@@ -53,7 +53,7 @@ public:
     
 private:
     ControlPacket(Type type, qint64 size = -1);
-    ControlPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    ControlPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr, qint64 bufferCapacity = -1);
     ControlPacket(ControlPacket&& other);
     ControlPacket(const ControlPacket& other) = delete;
     
@@ -12,14 +12,20 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <map>
 
 #include "SequenceNumber.h"
 
 namespace udt {
 
 class ControlPacket;
-    
+
+// Set of lost sequence numbers, kept as the ranges they form
+//
+// Ranges are keyed by their first sequence number, so finding the one a sequence number falls in is logarithmic in the
+// number of ranges, and appending past the last range is amortized constant time. Sequence numbers only compare
+// consistently when they are within SequenceNumber::THRESHOLD of each other, which always holds for the packets in
+// flight on a connection.
 class LossList {
 public:
     LossList() {}
@@ -30,13 +36,14 @@ public:
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere, merging with the ranges it overlaps or touches
     void insert(SequenceNumber start, SequenceNumber end);
     
     bool remove(SequenceNumber seq);
     void remove(SequenceNumber start, SequenceNumber end);
     
     int getLength() const { return _length; }
+    int getNumRanges() const { return (int)_lossList.size(); }
     bool isEmpty() const { return _length == 0; }
     SequenceNumber getFirstSequenceNumber() const;
     SequenceNumber popFirstSequenceNumber();
@@ -44,7 +51,12 @@ public:
     void write(ControlPacket& packet, int maxPairs = -1);
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    using Ranges = std::map<SequenceNumber, SequenceNumber>; // first sequence number of each range to its last
+    
+    // returns the range containing seq, or the first range after it
+    Ranges::iterator findRange(SequenceNumber seq);
+    
+    Ranges _lossList;
     int _length { 0 };
 };
     
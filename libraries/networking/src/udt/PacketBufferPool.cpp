@@ -0,0 +1,167 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <TBBHelpers.h>
+
+#include "Constants.h"
+
+using namespace udt;
+
+namespace {
+
+static const std::array<qint64, 4> SIZE_CLASSES {{ 128, 256, 512, MAX_PACKET_SIZE }};
+static const int NUM_SIZE_CLASSES = (int)SIZE_CLASSES.size();
+
+// buffers kept per size class, per thread and in the shared pool
+static const size_t MAX_THREAD_CACHED_BUFFERS = 32;
+static const int MAX_SHARED_BUFFERS = 1024;
+
+// smallest class that holds size, or -1 if it is larger than all of them
+int sizeClassForAcquire(qint64 size) {
+    for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        if (size <= SIZE_CLASSES[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// largest class that fits in capacity, or -1 if it is smaller than all of them
+int sizeClassForRelease(qint64 capacity) {
+    for (int i = NUM_SIZE_CLASSES - 1; i >= 0; --i) {
+        if (capacity >= SIZE_CLASSES[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+struct SharedPool {
+    std::array<tbb::concurrent_queue<char*>, NUM_SIZE_CLASSES> buffers;
+    std::array<std::atomic<int>, NUM_SIZE_CLASSES> sizes {};
+
+    std::atomic<quint64> hits { 0 };
+    std::atomic<quint64> misses { 0 };
+
+    bool push(int sizeClass, char* buffer) {
+        if (sizes[sizeClass].fetch_add(1, std::memory_order_relaxed) >= MAX_SHARED_BUFFERS) {
+            sizes[sizeClass].fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        buffers[sizeClass].push(buffer);
+        return true;
+    }
+
+    char* pop(int sizeClass) {
+        char* buffer = nullptr;
+        if (buffers[sizeClass].try_pop(buffer)) {
+            sizes[sizeClass].fetch_sub(1, std::memory_order_relaxed);
+        }
+        return buffer;
+    }
+};
+
+SharedPool& sharedPool() {
+    // intentionally leaked, so that thread caches torn down at exit always have somewhere to return buffers
+    static SharedPool* pool = new SharedPool;
+    return *pool;
+}
+
+struct ThreadCache {
+    std::array<std::vector<char*>, NUM_SIZE_CLASSES> buffers;
+
+    ~ThreadCache() {
+        auto& pool = sharedPool();
+        for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+            for (auto buffer : buffers[i]) {
+                if (!pool.push(i, buffer)) {
+                    delete[] buffer;
+                }
+            }
+        }
+    }
+};
+
+ThreadCache& threadCache() {
+    static thread_local ThreadCache cache;
+    return cache;
+}
+
+}
+
+std::unique_ptr<char[]> PacketBufferPool::acquire(qint64 size, qint64& capacity) {
+    auto& pool = sharedPool();
+    int sizeClass = sizeClassForAcquire(size);
+
+    if (sizeClass == -1) {
+        pool.misses.fetch_add(1, std::memory_order_relaxed);
+        capacity = size;
+        return std::unique_ptr<char[]>(new char[size]);
+    }
+
+    capacity = SIZE_CLASSES[sizeClass];
+
+    // try this thread's cache first, then the shared pool
+    auto& cached = threadCache().buffers[sizeClass];
+    char* buffer = nullptr;
+    if (!cached.empty()) {
+        buffer = cached.back();
+        cached.pop_back();
+    } else {
+        buffer = pool.pop(sizeClass);
+    }
+
+    if (buffer) {
+        pool.hits.fetch_add(1, std::memory_order_relaxed);
+        return std::unique_ptr<char[]>(buffer);
+    }
+
+    pool.misses.fetch_add(1, std::memory_order_relaxed);
+    return std::unique_ptr<char[]>(new char[capacity]);
+}
+
+void PacketBufferPool::release(std::unique_ptr<char[]> buffer, qint64 capacity) {
+    if (!buffer) {
+        return;
+    }
+
+    int sizeClass = sizeClassForRelease(capacity);
+    if (sizeClass == -1) {
+        return;
+    }
+
+    auto& cached = threadCache().buffers[sizeClass];
+    if (cached.size() < MAX_THREAD_CACHED_BUFFERS) {
+        cached.push_back(buffer.release());
+    } else if (sharedPool().push(sizeClass, buffer.get())) {
+        buffer.release();
+    }
+}
+
+PacketBufferPool::Stats PacketBufferPool::getStats() {
+    auto& pool = sharedPool();
+
+    Stats stats;
+    stats.hits = pool.hits.load(std::memory_order_relaxed);
+    stats.misses = pool.misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PacketBufferPool::resetStats() {
+    auto& pool = sharedPool();
+    pool.hits = 0;
+    pool.misses = 0;
+}
@@ -0,0 +1,47 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+namespace udt {
+
+// Recycles packet buffers in a few size classes (the largest being MAX_PACKET_SIZE).
+// Each thread keeps a small cache of its own, backed by a shared pool for buffers
+// that are released on a different thread than the one that acquired them
+// (e.g. received on the socket thread, freed on a mixer slave thread).
+class PacketBufferPool {
+public:
+    struct Stats {
+        quint64 hits { 0 };
+        quint64 misses { 0 };
+    };
+
+    // returns a buffer of at least size bytes, and its actual capacity
+    // the contents of a recycled buffer are undefined
+    static std::unique_ptr<char[]> acquire(qint64 size, qint64& capacity);
+
+    // capacity must not exceed the size the buffer was allocated with
+    // buffers that do not fit a size class, or that the pool has no room for, are freed
+    static void release(std::unique_ptr<char[]> buffer, qint64 capacity);
+
+    static Stats getStats();
+    static void resetStats();
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
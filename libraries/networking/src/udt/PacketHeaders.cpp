@@ -25,27 +25,30 @@ int packetTypeMetaTypeId = qRegisterMetaType<PacketType>();
 PacketVersion versionForPacketType(PacketType packetType) {
     switch (packetType) {
         case PacketType::DomainList:
-            return static_cast<PacketVersion>(DomainListVersion::GetMachineFingerprintFromUUIDSupport);
+            return static_cast<PacketVersion>(DomainListVersion::DeltaLists);
         case PacketType::EntityAdd:
         case PacketType::EntityEdit:
         case PacketType::EntityData:
         case PacketType::EntityPhysics:
-            return VERSION_ENTITIES_HAS_SHOULD_HIGHLIGHT;
+            return VERSION_ENTITIES_DICTIONARY_COMPRESSION;
         case PacketType::EntityQuery:
             return static_cast<PacketVersion>(EntityQueryPacketVersion::JSONFilterWithFamilyTree);
         case PacketType::AvatarIdentity:
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
         case PacketType::KillAvatar:
-            return static_cast<PacketVersion>(AvatarMixerPacketVersion::IsReplicatedInAvatarIdentity);
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::QuantizedBlendshapes);
+        case PacketType::NodeJsonStats:
+            return static_cast<PacketVersion>(NodeJsonStatsVersion::DeltaStats);
         case PacketType::MessagesData:
             return static_cast<PacketVersion>(MessageDataVersion::TextOrBinaryData);
         case PacketType::ICEServerHeartbeat:
             return 18; // ICE Server Heartbeat signing
         case PacketType::AssetGetInfo:
+        case PacketType::AssetGetInfoReply:
         case PacketType::AssetGet:
         case PacketType::AssetUpload:
-            return static_cast<PacketVersion>(AssetServerPacketVersion::RangeRequestSupport);
+            return static_cast<PacketVersion>(AssetServerPacketVersion::ModelProxies);
         case PacketType::NodeIgnoreRequest:
             return 18; // Introduction of node ignore request (which replaced an unused packet tpye)
 
@@ -59,6 +62,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
             return static_cast<PacketVersion>(DomainServerAddedNodeVersion::PermissionsGrid);
 
         case PacketType::MixedAudio:
+        case PacketType::ForwardedMixedAudio:
         case PacketType::SilentAudioFrame:
         case PacketType::InjectAudio:
         case PacketType::MicrophoneAudioNoEcho:
@@ -22,6 +22,8 @@
 #include <QtCore/QSet>
 #include <QtCore/QUuid>
 
+#include "Constants.h"
+
 // The enums are inside this PacketTypeEnum for run-time conversion of enum value to string via
 // Q_ENUMS, without requiring a macro that is called for each enum value.
 class PacketTypeEnum {
@@ -121,6 +123,9 @@ public:
         ReplicatedAvatarIdentity,
         ReplicatedKillAvatar,
         ReplicatedBulkAvatarData,
+        FECParity,
+        ForwardedMixedAudio,
+        CoalescedPackets,
         NUM_PACKET_TYPE
     };
 
@@ -137,6 +142,28 @@ public:
         return REPLICATED_PACKET_MAPPING;
     }
 
+    // the DSCP code point that packets of these types are marked with when sent unreliably, anything else is unmarked
+    const static QHash<PacketTypeEnum::Value, uint8_t> getRealTimePacketTrafficClasses() {
+        const static uint8_t VOICE = udt::DSCP_EXPEDITED_FORWARDING;
+        const static uint8_t INTERACTIVE = udt::DSCP_ASSURED_FORWARDING_41;
+        const static QHash<PacketTypeEnum::Value, uint8_t> REAL_TIME_PACKET_TRAFFIC_CLASSES {
+            { PacketTypeEnum::Value::MicrophoneAudioNoEcho, VOICE },
+            { PacketTypeEnum::Value::MicrophoneAudioWithEcho, VOICE },
+            { PacketTypeEnum::Value::InjectAudio, VOICE },
+            { PacketTypeEnum::Value::SilentAudioFrame, VOICE },
+            { PacketTypeEnum::Value::MixedAudio, VOICE },
+            { PacketTypeEnum::Value::ForwardedMixedAudio, VOICE },
+            { PacketTypeEnum::Value::ReplicatedMicrophoneAudioNoEcho, VOICE },
+            { PacketTypeEnum::Value::ReplicatedMicrophoneAudioWithEcho, VOICE },
+            { PacketTypeEnum::Value::ReplicatedInjectAudio, VOICE },
+            { PacketTypeEnum::Value::ReplicatedSilentAudioFrame, VOICE },
+            { PacketTypeEnum::Value::AvatarData, INTERACTIVE },
+            { PacketTypeEnum::Value::BulkAvatarData, INTERACTIVE },
+            { PacketTypeEnum::Value::ReplicatedBulkAvatarData, INTERACTIVE }
+        };
+        return REAL_TIME_PACKET_TRAFFIC_CLASSES;
+    }
+
     const static QSet<PacketTypeEnum::Value> getNonVerifiedPackets() {
         const static QSet<PacketTypeEnum::Value> NON_VERIFIED_PACKETS = QSet<PacketTypeEnum::Value>()
             << PacketTypeEnum::Value::NodeJsonStats << PacketTypeEnum::Value::EntityQuery
@@ -164,7 +191,8 @@ public:
             << PacketTypeEnum::Value::OctreeFileReplacement << PacketTypeEnum::Value::ReplicatedMicrophoneAudioNoEcho
             << PacketTypeEnum::Value::ReplicatedMicrophoneAudioWithEcho << PacketTypeEnum::Value::ReplicatedInjectAudio
             << PacketTypeEnum::Value::ReplicatedSilentAudioFrame << PacketTypeEnum::Value::ReplicatedAvatarIdentity
-            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData;
+            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData
+            << PacketTypeEnum::Value::CoalescedPackets;
         return NON_SOURCED_PACKETS;
     }
 };
@@ -258,6 +286,7 @@ const PacketVersion VERSION_ENTITIES_ZONE_FILTERS = 68;
 const PacketVersion VERSION_ENTITIES_HINGE_CONSTRAINT = 69;
 const PacketVersion VERSION_ENTITIES_BULLET_DYNAMICS = 70;
 const PacketVersion VERSION_ENTITIES_HAS_SHOULD_HIGHLIGHT = 71;
+const PacketVersion VERSION_ENTITIES_DICTIONARY_COMPRESSION = 72;
 
 enum class EntityQueryPacketVersion: PacketVersion {
     JSONFilter = 18,
@@ -266,7 +295,10 @@ enum class EntityQueryPacketVersion: PacketVersion {
 
 enum class AssetServerPacketVersion: PacketVersion {
     VegasCongestionControl = 19,
-    RangeRequestSupport
+    RangeRequestSupport,
+    CompressedAssets,
+    BakedTextures,
+    ModelProxies
 };
 
 enum class AvatarMixerPacketVersion : PacketVersion {
@@ -287,7 +319,9 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     AvatarIdentitySequenceId,
     MannequinDefaultAvatar,
     AvatarIdentitySequenceFront,
-    IsReplicatedInAvatarIdentity
+    IsReplicatedInAvatarIdentity,
+    JointDeltaData,
+    QuantizedBlendshapes
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
@@ -313,7 +347,8 @@ enum class DomainListVersion : PacketVersion {
     PrePermissionsGrid = 18,
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
-    GetMachineFingerprintFromUUIDSupport
+    GetMachineFingerprintFromUUIDSupport,
+    DeltaLists
 };
 
 enum class AudioVersion : PacketVersion {
@@ -326,6 +361,11 @@ enum class AudioVersion : PacketVersion {
     HighDynamicRangeVolume,
 };
 
+enum class NodeJsonStatsVersion : PacketVersion {
+    BinaryJSON = 17,
+    DeltaStats
+};
+
 enum class MessageDataVersion : PacketVersion {
     TextOrBinaryData = 18
 };
@@ -48,6 +48,7 @@ PacketList::PacketList(PacketList&& other) :
     _packets(std::move(other._packets)),
     _isOrdered(other._isOrdered),
     _isReliable(other._isReliable),
+    _priority(other._priority),
     _extendedHeader(std::move(other._extendedHeader))
 {
 }
@@ -30,6 +30,15 @@ class PacketList : public QIODevice {
 public:
     using MessageNumber = uint32_t;
     using PacketPointer = std::unique_ptr<Packet>;
+
+    // The reliable packet lists queued on a connection share its sends by their priority, so that a big transfer
+    // doesn't hold up the smaller messages queued after it. Packets sent on their own go out with Normal ones.
+    enum Priority {
+        Low,
+        Normal,
+        High,
+        NumPriorities
+    };
     
     static std::unique_ptr<PacketList> create(PacketType packetType, QByteArray extendedHeader = QByteArray(),
                                               bool isReliable = false, bool isOrdered = false);
@@ -38,6 +47,9 @@ public:
     PacketType getType() const { return _packetType; }
     bool isReliable() const { return _isReliable; }
     bool isOrdered() const { return _isOrdered; }
+
+    Priority getPriority() const { return _priority; }
+    void setPriority(Priority priority) { _priority = priority; }
     
     size_t getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0); }
     size_t getDataSize() const;
@@ -97,6 +109,7 @@ private:
     
     Packet::MessageNumber _messageNumber;
     bool _isReliable = false;
+    Priority _priority = Normal;
     
     std::unique_ptr<Packet> _currentPacket;
     
@@ -11,12 +11,17 @@
 
 #include "PacketQueue.h"
 
+#include <algorithm>
+
 #include "PacketList.h"
 
 using namespace udt;
 
+// how many more sends a priority gets than the one below it, when both have packets waiting
+static const int PRIORITY_WEIGHTS[PacketList::NumPriorities] = { 1, 4, 16 };
+
 PacketQueue::PacketQueue() {
-    _channels.emplace_back(new std::list<PacketPointer>());
+    _levels[PacketList::Normal].channels.emplace_back(new std::list<PacketPointer>());
 }
 
 MessageNumber PacketQueue::getNextMessageNumber() {
@@ -25,23 +30,60 @@ MessageNumber PacketQueue::getNextMessageNumber() {
     return _currentMessageNumber;
 }
 
+bool PacketQueue::isEmpty(const Level& level, Priority priority) const {
+    if (priority == PacketList::Normal) {
+        // Only the main channel and it is empty
+        return (level.channels.size() == 1) && level.channels.front()->empty();
+    }
+    return level.channels.empty();
+}
+
 bool PacketQueue::isEmpty() const {
     LockGuard locker(_packetsLock);
-    // Only the main channel and it is empty
-    return (_channels.size() == 1) && _channels.front()->empty();
+    for (int i = 0; i < PacketList::NumPriorities; ++i) {
+        if (!isEmpty(_levels[i], (Priority)i)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
     LockGuard locker(_packetsLock);
-    if (isEmpty()) {
+
+    int totalWeight = 0;
+    int chosen = -1;
+    for (int i = 0; i < PacketList::NumPriorities; ++i) {
+        auto& level = _levels[i];
+        if (isEmpty(level, (Priority)i)) {
+            // idle priorities don't save up sends for later
+            level.currentWeight = 0;
+            continue;
+        }
+        level.currentWeight += PRIORITY_WEIGHTS[i];
+        totalWeight += PRIORITY_WEIGHTS[i];
+        if (chosen == -1 || level.currentWeight > _levels[chosen].currentWeight) {
+            chosen = i;
+        }
+    }
+
+    if (chosen == -1) {
         return PacketPointer();
     }
 
-    // Find next non empty channel
-    if (_channels[nextIndex()]->empty()) {
-        nextIndex();
+    _levels[chosen].currentWeight -= totalWeight;
+    return takePacket(_levels[chosen], (Priority)chosen);
+}
+
+PacketQueue::PacketPointer PacketQueue::takePacket(Level& level, Priority priority) {
+    auto& channels = level.channels;
+
+    // Find next non empty channel, only the main channel can be empty
+    level.currentIndex = (level.currentIndex + 1) % channels.size();
+    if (channels[level.currentIndex]->empty()) {
+        level.currentIndex = (level.currentIndex + 1) % channels.size();
     }
-    auto& channel = _channels[_currentIndex];
+    auto& channel = channels[level.currentIndex];
     Q_ASSERT(!channel->empty());
 
     // Take front packet
@@ -49,23 +91,20 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     channel->pop_front();
 
     // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentIndex != 0) {
-        channel->swap(*_channels.back());
-        _channels.pop_back();
-        --_currentIndex;
+    bool isMainChannel = priority == PacketList::Normal && level.currentIndex == 0;
+    if (channel->empty() && !isMainChannel) {
+        channel->swap(*channels.back());
+        channels.pop_back();
+        // the channel moved in its place takes the next turn
+        level.currentIndex = (level.currentIndex + channels.size() - 1) % std::max(channels.size(), (size_t)1);
     }
 
     return packet;
 }
 
-unsigned int PacketQueue::nextIndex() {
-    _currentIndex = (_currentIndex + 1) % _channels.size();
-    return _currentIndex;
-}
-
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _levels[PacketList::Normal].channels.front()->push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
@@ -74,6 +113,7 @@ void PacketQueue::queuePacketList(PacketListPointer packetList) {
     }
 
     LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    auto& channels = _levels[packetList->getPriority()].channels;
+    channels.emplace_back(new std::list<PacketPointer>());
+    channels.back()->swap(packetList->_packets);
 }
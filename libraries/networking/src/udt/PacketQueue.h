@@ -18,11 +18,10 @@
 #include <mutex>
 
 #include "Packet.h"
+#include "PacketList.h"
 
 namespace udt {
     
-class PacketList;
-    
 using MessageNumber = uint32_t;
     
 class PacketQueue {
@@ -32,6 +31,7 @@ class PacketQueue {
     using PacketListPointer = std::unique_ptr<PacketList>;
     using Channel = std::unique_ptr<std::list<PacketPointer>>;
     using Channels = std::vector<Channel>;
+    using Priority = PacketList::Priority;
     
 public:
     PacketQueue();
@@ -44,14 +44,22 @@ public:
     Mutex& getLock() { return _packetsLock; }
     
 private:
+    // The channels of a priority take turns, and the priorities with packets are picked by a smooth weighted round
+    // robin, so that a priority with fewer packets to send gets its share of the sends before a busier one is done
+    struct Level {
+        Channels channels;
+        unsigned int currentIndex { 0 };
+        int currentWeight { 0 };
+    };
+
     MessageNumber getNextMessageNumber();
-    unsigned int nextIndex();
+    bool isEmpty(const Level& level, Priority priority) const;
+    PacketPointer takePacket(Level& level, Priority priority);
     
     MessageNumber _currentMessageNumber { 0 };
     
     mutable Mutex _packetsLock; // Protects the packets to be sent.
-    Channels _channels; // One channel per packet list + Main channel
-    unsigned int _currentIndex { 0 };
+    Level _levels[PacketList::NumPriorities]; // One channel per packet list, + Main channel at Normal priority
 };
 
 }
@@ -0,0 +1,67 @@
+//
+//  ReceiveWorker.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceiveWorker.h"
+
+using namespace udt;
+
+const size_t ReceiveWorker::DEFAULT_QUEUE_CAPACITY;
+
+ReceiveWorker::ReceiveWorker(Handler handler, size_t queueCapacity) :
+    _handler(std::move(handler)),
+    _queue(queueCapacity)
+{
+    setObjectName("udt::ReceiveWorker");
+}
+
+ReceiveWorker::~ReceiveWorker() {
+    {
+        Lock lock(_mutex);
+        _shouldStop = true;
+        _condition.notify_one();
+    }
+    wait();
+}
+
+bool ReceiveWorker::queuePacket(std::unique_ptr<Packet> packet) {
+    if (!_queue.push(std::move(packet))) {
+        return false;
+    }
+
+    // pairs with the fence in run - either we see that the worker is waiting, or it sees this packet before it waits
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_isWaiting.load(std::memory_order_relaxed)) {
+        Lock lock(_mutex);
+        _condition.notify_one();
+    }
+
+    return true;
+}
+
+void ReceiveWorker::run() {
+    std::unique_ptr<Packet> packet;
+
+    while (true) {
+        while (_queue.pop(packet)) {
+            _handler(std::move(packet));
+        }
+
+        Lock lock(_mutex);
+        _isWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        _condition.wait(lock, [&] { return _shouldStop || !_queue.empty(); });
+        _isWaiting.store(false, std::memory_order_relaxed);
+
+        if (_shouldStop && _queue.empty()) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//
+//  ReceiveWorker.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ReceiveWorker_h
+#define hifi_ReceiveWorker_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QThread>
+
+#include <shared/MPSCRingBuffer.h>
+
+#include "Packet.h"
+
+namespace udt {
+
+// Thread a Socket hands received packets to, so that the work done for each of them (verifying it, building the
+// message and delivering it to its listener) is spread over more than the socket's own thread.
+//
+// Packets come in through a lock-free queue and are handled in the order they were queued. The thread only sleeps
+// once that queue is empty, and the socket only has to wake it up in that case.
+class ReceiveWorker : public QThread {
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+public:
+    using Handler = std::function<void(std::unique_ptr<Packet>)>;
+
+    ReceiveWorker(Handler handler, size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+    ~ReceiveWorker(); // handles whatever is still queued, then stops the thread
+
+    // only call this from the socket thread
+    // returns false, dropping the packet, if the worker has fallen a full queue behind
+    bool queuePacket(std::unique_ptr<Packet> packet);
+
+    static const size_t DEFAULT_QUEUE_CAPACITY = 1024;
+
+protected:
+    void run() override;
+
+private:
+    Handler _handler;
+    MPSCRingBuffer<std::unique_ptr<Packet>> _queue;
+
+    Mutex _mutex;
+    std::condition_variable _condition;
+    std::atomic<bool> _isWaiting { false }; // set while the worker is (about to be) waiting on _condition
+    bool _shouldStop { false }; // guarded by _mutex
+};
+
+}
+
+#endif // hifi_ReceiveWorker_h
@@ -154,9 +154,7 @@ void SendQueue::ack(SequenceNumber ack) {
     {
         // remove any ACKed packets from the map of sent packets
         QWriteLocker locker(&_sentLock);
-        for (auto seq = SequenceNumber { (uint32_t) _lastACKSequenceNumber }; seq <= ack; ++seq) {
-            _sentPackets.erase(seq);
-        }
+        _sentPackets.removeUpTo(ack);
     }
     
     {   // remove any sequence numbers equal to or lower than this ACK in the loss list
@@ -258,22 +256,41 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     // write the sequence number and send the packet
     newPacket->writeSequenceNumber(sequenceNumber);
 
+    auto bytesWritten = sendPacket(*newPacket);
+
+    return addToSentList(std::move(newPacket), sequenceNumber, bytesWritten);
+}
+
+bool SendQueue::sendNewPacketPairAndAddToSentList(std::unique_ptr<Packet> firstPacket, SequenceNumber firstSequenceNumber,
+                                                  std::unique_ptr<Packet> secondPacket, SequenceNumber secondSequenceNumber) {
+    firstPacket->writeSequenceNumber(firstSequenceNumber);
+    secondPacket->writeSequenceNumber(secondSequenceNumber);
+
+    // send both packets of the pair in a single write, which also keeps them back to back on the wire
+    const char* data[] = { firstPacket->getData(), secondPacket->getData() };
+    const qint64 sizes[] = { firstPacket->getDataSize(), secondPacket->getDataSize() };
+    qint64 bytesWritten[2];
+    _socket->writeDatagrams(data, sizes, bytesWritten, 2, _destination);
+
+    emit packetBatchSent(2);
+
+    bool firstSent = addToSentList(std::move(firstPacket), firstSequenceNumber, bytesWritten[0]);
+    bool secondSent = addToSentList(std::move(secondPacket), secondSequenceNumber, bytesWritten[1]);
+    return firstSent && secondSent;
+}
+
+bool SendQueue::addToSentList(std::unique_ptr<Packet> newPacket, SequenceNumber sequenceNumber, qint64 bytesWritten) {
     // Save packet/payload size before we move it
     auto packetSize = newPacket->getWireSize();
     auto payloadSize = newPacket->getPayloadSize();
-    
-    auto bytesWritten = sendPacket(*newPacket);
 
     emit packetSent(packetSize, payloadSize, sequenceNumber, p_high_resolution_clock::now());
 
     {
         // Insert the packet we have just sent in the sent list
         QWriteLocker locker(&_sentLock);
-        auto& entry = _sentPackets[newPacket->getSequenceNumber()];
-        entry.first = 0; // No resend
-        entry.second.swap(newPacket);
+        _sentPackets.insert(sequenceNumber, std::move(newPacket));
     }
-    Q_ASSERT_X(!newPacket, "SendQueue::sendNewPacketAndAddToSentList()", "Overriden packet in sent list");
 
     if (bytesWritten < 0) {
         // this is a short-circuit loss - we failed to put this packet on the wire
@@ -417,23 +434,21 @@ int SendQueue::maybeSendNewPacket() {
             Q_ASSERT(firstPacket);
 
 
-            // attempt to send the first packet
-            if (sendNewPacketAndAddToSentList(move(firstPacket), nextNumber)) {
-                std::unique_ptr<Packet> secondPacket;
-                bool shouldSendPairTail = false;
-
-                if (_shouldSendProbes && ((uint32_t) nextNumber & 0xF) == 0) {
-                    // the first packet is the first in a probe pair - every 16 (rightmost 16 bits = 0) packets
-                    // pull off a second packet if we can before we unlock
-                    shouldSendPairTail = true;
+            // every 16 packets (rightmost 16 bits = 0) the first packet is the first in a probe pair
+            // pull off a second packet if we can, so that both go out in one write
+            bool shouldSendPairTail = _shouldSendProbes && ((uint32_t) nextNumber & 0xF) == 0;
+            std::unique_ptr<Packet> secondPacket;
+            if (shouldSendPairTail) {
+                secondPacket = _packets.takePacket();
+            }
 
-                    secondPacket = _packets.takePacket();
-                }
+            if (secondPacket) {
+                sendNewPacketPairAndAddToSentList(move(firstPacket), nextNumber, move(secondPacket), getNextSequenceNumber());
 
-                // do we have a second in a pair to send as well?
-                if (secondPacket) {
-                    sendNewPacketAndAddToSentList(move(secondPacket), getNextSequenceNumber());
-                } else if (shouldSendPairTail) {
+                // return the number of attempted packet sends
+                return 2;
+            } else if (sendNewPacketAndAddToSentList(move(firstPacket), nextNumber)) {
+                if (shouldSendPairTail) {
                     // we didn't get a second packet to send in the probe pair
                     // send a control packet of type ProbePairTail so the receiver can still do
                     // proper bandwidth estimation
@@ -470,11 +485,11 @@ bool SendQueue::maybeResendPacket() {
             QReadLocker sentLocker(&_sentLock);
             
             // see if we can find the packet to re-send
-            auto it = _sentPackets.find(resendNumber);
+            auto entryPointer = _sentPackets.find(resendNumber);
 
-            if (it != _sentPackets.end()) {
+            if (entryPointer) {
 
-                auto& entry = it->second;
+                auto& entry = *entryPointer;
                 // we found the packet - grab it
                 auto& resendPacket = *(entry.second);
                 ++entry.first; // Add 1 resend
@@ -482,7 +497,7 @@ bool SendQueue::maybeResendPacket() {
                 Packet::ObfuscationLevel level = (Packet::ObfuscationLevel)(entry.first < 2 ? 0 : (entry.first - 2) % 4);
 
                 auto wireSize = resendPacket.getWireSize();
-                auto sequenceNumber = it->first;
+                auto sequenceNumber = resendNumber;
 
                 if (level != Packet::NoObfuscation) {
 #ifdef UDT_CONNECTION_DEBUG
@@ -0,0 +1,93 @@
+//
+//  SentPacketBuffer.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketBuffer.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+const int SentPacketBuffer::DEFAULT_CAPACITY;
+
+SentPacketBuffer::SentPacketBuffer(int capacity) {
+    int powerOfTwoCapacity = 1;
+    while (powerOfTwoCapacity < capacity) {
+        powerOfTwoCapacity <<= 1;
+    }
+    _entries.resize(powerOfTwoCapacity);
+}
+
+void SentPacketBuffer::insert(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet) {
+    if (_size == 0) {
+        _firstSequenceNumber = sequenceNumber;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, sequenceNumber);
+    Q_ASSERT_X(offset >= _size, "SentPacketBuffer::insert()", "Sequence number is not past the last one in the buffer");
+    if (offset < _size) {
+        return;
+    }
+
+    if (offset >= capacity()) {
+        grow(offset + 1);
+    }
+
+    auto& entry = _entries[(_head + offset) & (capacity() - 1)];
+    entry.first = 0; // No resend
+    entry.second = std::move(packet);
+    _size = offset + 1;
+}
+
+SentPacketBuffer::PacketResendPair* SentPacketBuffer::find(SequenceNumber sequenceNumber) {
+    if (_size == 0) {
+        return nullptr;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, sequenceNumber);
+    if (offset < 0 || offset >= _size) {
+        return nullptr;
+    }
+
+    auto& entry = _entries[(_head + offset) & (capacity() - 1)];
+    return entry.second ? &entry : nullptr;
+}
+
+void SentPacketBuffer::removeUpTo(SequenceNumber ack) {
+    if (_size == 0 || ack < _firstSequenceNumber) {
+        return;
+    }
+
+    int numRemoved = std::min(seqlen(_firstSequenceNumber, ack), _size);
+    int mask = capacity() - 1;
+    for (int i = 0; i < numRemoved; ++i) {
+        _entries[(_head + i) & mask].second.reset();
+    }
+
+    _head = (_head + numRemoved) & mask;
+    _size -= numRemoved;
+    _firstSequenceNumber += (SequenceNumber::Type)numRemoved;
+}
+
+void SentPacketBuffer::grow(int minimumCapacity) {
+    int newCapacity = capacity();
+    while (newCapacity < minimumCapacity) {
+        newCapacity <<= 1;
+    }
+
+    // unwrap the ring into the new entries so that the oldest packet is at the front
+    std::vector<PacketResendPair> entries(newCapacity);
+    int mask = capacity() - 1;
+    for (int i = 0; i < _size; ++i) {
+        entries[i] = std::move(_entries[(_head + i) & mask]);
+    }
+
+    _entries.swap(entries);
+    _head = 0;
+}
@@ -0,0 +1,62 @@
+//
+//  SentPacketBuffer.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SentPacketBuffer_h
+#define hifi_SentPacketBuffer_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Packet.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+// Packets that have been sent and are waiting to be ACKed
+//
+// Packets go out with consecutive sequence numbers, so they are kept in a ring indexed by their offset from the oldest
+// unACKed one: looking a packet up for a retransmit is a subtraction, and an ACK pops everything it covers off the
+// front. The ring doubles when the window outgrows it and keeps that capacity afterwards.
+class SentPacketBuffer {
+public:
+    using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
+
+    SentPacketBuffer(int capacity = DEFAULT_CAPACITY);
+
+    bool isEmpty() const { return _size == 0; }
+    int size() const { return _size; } // includes any gaps left between inserted sequence numbers
+    int capacity() const { return (int)_entries.size(); }
+
+    // must always add past the last sequence number, sequence numbers that are skipped are left empty
+    void insert(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet);
+
+    // returns nullptr if the packet is not in the buffer, which means it has already been ACKed
+    PacketResendPair* find(SequenceNumber sequenceNumber);
+
+    // removes every packet up to and including ack
+    void removeUpTo(SequenceNumber ack);
+
+    static const int DEFAULT_CAPACITY = 256;
+
+private:
+    void grow(int minimumCapacity);
+
+    std::vector<PacketResendPair> _entries; // size is always a power of two
+    int _head { 0 }; // index of _firstSequenceNumber in _entries
+    int _size { 0 };
+    SequenceNumber _firstSequenceNumber;
+};
+
+}
+
+#endif // hifi_SentPacketBuffer_h
@@ -66,7 +66,7 @@ public:
         return *this;
     }
     inline SequenceNumber& operator-=(Type dec) {
-        _value = (_value < dec) ? MAX - (dec - _value + 1) : _value - dec;
+        _value = (_value < dec) ? MAX + 1 - (dec - _value) : _value - dec;
         return *this;
     }
     
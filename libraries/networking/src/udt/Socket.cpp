@@ -11,19 +11,29 @@
 
 #include "Socket.h"
 
+#include <algorithm>
+
 #ifdef Q_OS_ANDROID
 #include <sys/socket.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
 #include <QtCore/QThread>
 
 #include <shared/QtHelpers.h>
 #include <LogHandler.h>
 
 #include "../NetworkLogging.h"
+#include "BBRCC.h"
 #include "Connection.h"
 #include "ControlPacket.h"
 #include "Packet.h"
+#include "PacketBufferPool.h"
 #include "../NLPacket.h"
 #include "../NLPacketList.h"
 #include "PacketList.h"
@@ -54,6 +64,34 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     const int READY_READ_BACKUP_CHECK_MSECS = 2 * 1000;
     connect(_readyReadBackupTimer, &QTimer::timeout, this, &Socket::checkForReadyReadBackup);
     _readyReadBackupTimer->start(READY_READ_BACKUP_CHECK_MSECS);
+
+#if defined(Q_OS_LINUX)
+    // batched socket I/O can be turned off to fall back to the Qt socket path
+    if (qEnvironmentVariableIsSet("HIFI_DISABLE_BATCHED_SOCKET_IO")) {
+        qCDebug(networking) << "udt::Socket batched I/O disabled by HIFI_DISABLE_BATCHED_SOCKET_IO";
+        _useBatchedIO = false;
+    }
+
+    // marking real-time packets can be turned off for networks that drop or penalize marked packets
+    if (qEnvironmentVariableIsSet("HIFI_DISABLE_DSCP_MARKING")) {
+        qCDebug(networking) << "udt::Socket DSCP marking disabled by HIFI_DISABLE_DSCP_MARKING";
+        _useTrafficClasses = false;
+    }
+#endif
+
+    // BBR can be swapped in for TCP Vegas, for connections over lossy links where loss isn't a sign of congestion
+    if (qEnvironmentVariableIsSet("HIFI_UDT_BBR")) {
+        qCDebug(networking) << "udt::Socket using BBR congestion control, enabled by HIFI_UDT_BBR";
+        setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory>(new CongestionControlFactory<BBRCC>()));
+    }
+
+    // servers with many senders can spread the handling of unreliable packets over more threads
+    bool isNumReceiveWorkersSet = false;
+    int numReceiveWorkers = qEnvironmentVariableIntValue("HIFI_UDT_RECEIVE_WORKERS", &isNumReceiveWorkersSet);
+    if (isNumReceiveWorkersSet && numReceiveWorkers > 0) {
+        qCDebug(networking) << "udt::Socket using" << numReceiveWorkers << "receive workers, set by HIFI_UDT_RECEIVE_WORKERS";
+        setNumReceiveWorkers(numReceiveWorkers);
+    }
 }
 
 void Socket::bind(const QHostAddress& address, quint16 port) {
@@ -139,7 +177,8 @@ qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     // write the correct sequence number to the Packet here
     packet.writeSequenceNumber(sequenceNumber);
 
-    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+    uint8_t dscp = _trafficClassOperator ? _trafficClassOperator(packet) : DSCP_DEFAULT;
+    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr, dscp);
 }
 
 qint64 Socket::writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr) {
@@ -239,6 +278,108 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     return bytesWritten;
 }
 
+qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr, uint8_t dscp) {
+#if defined(Q_OS_LINUX)
+    if (_useTrafficClasses && dscp != DSCP_DEFAULT && sockAddr.getAddress().protocol() == QAbstractSocket::IPv4Protocol) {
+        sockaddr_in destination;
+        memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+        destination.sin_port = htons(sockAddr.getPort());
+
+        iovec datagram;
+        datagram.iov_base = const_cast<char*>(data);
+        datagram.iov_len = size;
+
+        // the type of service goes with this one datagram, the socket's own is left as it is for everything else
+        char control[CMSG_SPACE(sizeof(int))];
+        memset(control, 0, sizeof(control));
+
+        msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &destination;
+        message.msg_namelen = sizeof(destination);
+        message.msg_iov = &datagram;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        cmsghdr* typeOfService = CMSG_FIRSTHDR(&message);
+        typeOfService->cmsg_level = IPPROTO_IP;
+        typeOfService->cmsg_type = IP_TOS;
+        typeOfService->cmsg_len = CMSG_LEN(sizeof(int));
+        int typeOfServiceByte = dscp << 2;
+        memcpy(CMSG_DATA(typeOfService), &typeOfServiceByte, sizeof(int));
+
+        auto bytesWritten = sendmsg(_udpSocket.socketDescriptor(), &message, 0);
+        if (bytesWritten >= 0) {
+            return bytesWritten;
+        }
+        if (errno == EINVAL || errno == EPERM) {
+            // the kernel won't take a type of service with the datagram, so stop asking it to
+            qCDebug(networking) << "udt::Socket DSCP marking is not supported here, sending real-time packets unmarked";
+            _useTrafficClasses = false;
+        }
+        // let the unmarked path below handle (and report) the failure
+    }
+#else
+    Q_UNUSED(dscp);
+#endif
+
+    return writeDatagram(data, size, sockAddr);
+}
+
+void Socket::writeDatagrams(const char* const* data, const qint64* sizes, qint64* bytesWritten, int count,
+                            const HifiSockAddr& sockAddr) {
+    int numSent = 0;
+
+#if defined(Q_OS_LINUX)
+    static const int MAX_SEND_BATCH_SIZE = 16;
+    if (_useBatchedIO && count > 1 && sockAddr.getAddress().protocol() == QAbstractSocket::IPv4Protocol) {
+        sockaddr_in destination;
+        memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+        destination.sin_port = htons(sockAddr.getPort());
+
+        auto sd = _udpSocket.socketDescriptor();
+
+        while (numSent < count) {
+            int batchSize = std::min(count - numSent, MAX_SEND_BATCH_SIZE);
+
+            mmsghdr messages[MAX_SEND_BATCH_SIZE];
+            iovec iovecs[MAX_SEND_BATCH_SIZE];
+            memset(messages, 0, sizeof(mmsghdr) * batchSize);
+
+            for (int i = 0; i < batchSize; ++i) {
+                iovecs[i].iov_base = const_cast<char*>(data[numSent + i]);
+                iovecs[i].iov_len = sizes[numSent + i];
+                messages[i].msg_hdr.msg_name = &destination;
+                messages[i].msg_hdr.msg_namelen = sizeof(destination);
+                messages[i].msg_hdr.msg_iov = &iovecs[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            int batchSent = sendmmsg(sd, messages, batchSize, 0);
+            if (batchSent <= 0) {
+                // let the unbatched path below handle (and report) the failure
+                break;
+            }
+
+            for (int i = 0; i < batchSent; ++i) {
+                bytesWritten[numSent + i] = messages[i].msg_len;
+            }
+            numSent += batchSent;
+        }
+    }
+#endif
+
+    // anything left over is written one datagram at a time
+    for (int i = numSent; i < count; ++i) {
+        bytesWritten[i] = writeDatagram(data[i], sizes[i], sockAddr);
+    }
+}
+
 Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
     auto it = _connectionsHash.find(sockAddr);
 
@@ -288,6 +429,30 @@ void Socket::clearConnections() {
     }
 }
 
+void Socket::setNumReceiveWorkers(int numWorkers) {
+    if (QThread::currentThread() != thread()) {
+        BLOCKING_INVOKE_METHOD(this, "setNumReceiveWorkers", Q_ARG(int, numWorkers));
+        return;
+    }
+
+    numWorkers = std::max(numWorkers, 0);
+    if (numWorkers == (int)_receiveWorkers.size()) {
+        return;
+    }
+
+    // senders hash to different workers once the count changes, so the current workers finish what they have queued
+    // before any new ones start
+    _receiveWorkers.clear();
+
+    for (int i = 0; i < numWorkers; ++i) {
+        auto worker = new ReceiveWorker([this](std::unique_ptr<Packet> packet) {
+            processUnreliablePacket(std::move(packet));
+        });
+        worker->start();
+        _receiveWorkers.emplace_back(worker);
+    }
+}
+
 void Socket::cleanupConnection(HifiSockAddr sockAddr) {
     auto numErased = _connectionsHash.erase(sockAddr);
 
@@ -343,7 +508,8 @@ void Socket::readPendingDatagrams() {
         HifiSockAddr senderSockAddr;
 
         // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        qint64 bufferCapacity = 0;
+        auto buffer = PacketBufferPool::acquire(packetSizeWithHeader, bufferCapacity);
 
         // pull the datagram
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
@@ -356,73 +522,178 @@ void Socket::readPendingDatagrams() {
         if (sizeRead <= 0) {
             // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
             // on windows even if there's not a packet available)
+            PacketBufferPool::release(std::move(buffer), bufferCapacity);
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(buffer), packetSizeWithHeader, bufferCapacity, senderSockAddr, receiveTime, false);
+
+#if defined(Q_OS_LINUX)
+        // the first datagram is always read through the QUdpSocket, which re-arms its read notification
+        // whatever else is waiting is drained in batches
+        if (_useBatchedIO) {
+            readPendingDatagramsBatched();
+        }
+#endif
+    }
+}
+
+#if defined(Q_OS_LINUX)
+
+void Socket::readPendingDatagramsBatched() {
+    auto sd = _udpSocket.socketDescriptor();
+
+    mmsghdr messages[RECEIVE_BATCH_SIZE];
+    iovec iovecs[RECEIVE_BATCH_SIZE];
+    sockaddr_in senderAddresses[RECEIVE_BATCH_SIZE];
+
+    while (true) {
+        memset(messages, 0, sizeof(messages));
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
+        for (int i = 0; i < RECEIVE_BATCH_SIZE; ++i) {
+            if (!_receiveBatchBuffers[i]) {
+                qint64 bufferCapacity = 0;
+                _receiveBatchBuffers[i] = PacketBufferPool::acquire(udt::MAX_PACKET_SIZE, bufferCapacity);
             }
 
-            continue;
+            iovecs[i].iov_base = _receiveBatchBuffers[i].get();
+            iovecs[i].iov_len = udt::MAX_PACKET_SIZE;
+            messages[i].msg_hdr.msg_name = &senderAddresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        int numReceived = recvmmsg(sd, messages, RECEIVE_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (numReceived <= 0) {
+            // EAGAIN - the socket is drained
+            return;
+        }
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+        _readyReadBackupTimer->start();
+        auto receiveTime = p_high_resolution_clock::now();
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+        for (int i = 0; i < numReceived; ++i) {
+            int sizeRead = (int)messages[i].msg_len;
+            HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&senderAddresses[i]));
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
+            _lastPacketSizeRead = sizeRead;
+            _lastPacketSockAddr = senderSockAddr;
+
+            if (sizeRead <= 0 || (messages[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+                // empty, or larger than any packet we would send - drop it and re-use the buffer
+                continue;
             }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
-                        continue;
-                    }
+            // the packet takes ownership of the buffer (which goes back to the pool with it), a new one is acquired
+            // for the next batch
+            processDatagram(std::move(_receiveBatchBuffers[i]), sizeRead, udt::MAX_PACKET_SIZE,
+                            senderSockAddr, receiveTime, true);
+        }
+
+        if (numReceived < RECEIVE_BATCH_SIZE) {
+            return;
+        }
+    }
+}
+
+#endif
+
+void Socket::processDatagram(std::unique_ptr<char[]> buffer, int packetSizeWithHeader, qint64 bufferCapacity,
+                             const HifiSockAddr& senderSockAddr, p_high_resolution_clock::time_point receiveTime, bool isBatched) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr,
+                                                             bufferCapacity);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        }
+
+        return;
+    }
+
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr,
+                                                               bufferCapacity);
+        controlPacket->setReceiveTime(receiveTime);
+
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr);
+
+        if (connection) {
+            if (isBatched) {
+                connection->recordReceivedBatchedPacket();
+            }
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr, bufferCapacity);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        if (!_receiveWorkers.empty() && !packet->isReliable() && !packet->isPartOfMessage()) {
+            // nothing about this packet involves a connection, it can be verified and handled on its sender's worker
+            auto& worker = _receiveWorkers[std::hash<HifiSockAddr>()(senderSockAddr) % _receiveWorkers.size()];
+
+            if (!worker->queuePacket(std::move(packet))) {
+                static const QString FULL_WORKER_REGEX = "udt::Socket receive worker is full - dropping packet from";
+                static QString repeatedMessage
+                    = LogHandler::getInstance().addRepeatedMessageRegex(FULL_WORKER_REGEX);
+
+                qCDebug(networking) << "udt::Socket receive worker is full - dropping packet from" << senderSockAddr;
+            }
+            return;
+        }
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto connection = findOrCreateConnection(senderSockAddr);
+
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
+                    return;
                 }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+                if (isBatched) {
+                    connection->recordReceivedBatchedPacket();
                 }
             }
+
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
+                }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
+            }
         }
     }
 }
 
+void Socket::processUnreliablePacket(std::unique_ptr<Packet> packet) {
+    // the same as processDatagram does for an unreliable packet that isn't part of a message, on a receive worker
+    if ((!_packetFilterOperator || _packetFilterOperator(*packet)) && _packetHandler) {
+        _packetHandler(std::move(packet));
+    }
+}
+
 void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot) {
     auto it = _connectionsHash.find(destinationAddr);
     if (it != _connectionsHash.end()) {
@@ -14,6 +14,8 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
@@ -25,6 +27,7 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "ReceiveWorker.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -39,6 +42,7 @@ class SequenceNumber;
 
 using PacketFilterOperator = std::function<bool(const Packet&)>;
 using ConnectionCreationFilterOperator = std::function<bool(const HifiSockAddr&)>;
+using TrafficClassOperator = std::function<uint8_t(const Packet&)>;
 
 using BasePacketHandler = std::function<void(std::unique_ptr<BasePacket>)>;
 using PacketHandler = std::function<void(std::unique_ptr<Packet>)>;
@@ -65,6 +69,11 @@ public:
     qint64 writePacketList(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+
+    // Writes a batch of datagrams to the same address, using a single system call where supported (sendmmsg)
+    // bytesWritten receives the result for each datagram, as returned by writeDatagram
+    void writeDatagrams(const char* const* data, const qint64* sizes, qint64* bytesWritten, int count,
+                        const HifiSockAddr& sockAddr);
     
     void bind(const QHostAddress& address, quint16 port = 0);
     void rebind(quint16 port);
@@ -76,6 +85,11 @@ public:
     void setMessageFailureHandler(MessageFailureHandler handler) { _messageFailureHandler = handler; }
     void setConnectionCreationFilterOperator(ConnectionCreationFilterOperator filterOperator)
         { _connectionCreationFilterOperator = filterOperator; }
+
+    // Gives the DSCP code point an unreliable packet is marked with, so that networks with QoS can send real-time
+    // packets ahead of bulk ones. Reliable packets, and packets sent where marking isn't supported, are left unmarked.
+    void setTrafficClassOperator(TrafficClassOperator trafficClassOperator)
+        { _trafficClassOperator = trafficClassOperator; }
     
     void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler)
         { _unfilteredHandlers[senderSockAddr] = handler; }
@@ -98,6 +112,12 @@ signals:
 public slots:
     void cleanupConnection(HifiSockAddr sockAddr);
     void clearConnections();
+
+    // Verify and handle unreliable packets on this many ReceiveWorkers instead of the socket thread (0 to stop).
+    // Packets are spread over the workers by sender, so each sender's packets are still handled in order.
+    // Connections, and the reliable and message packets they process, stay on the socket thread.
+    // The packet filter and handler must be safe to call from any thread, and must not change once workers are set.
+    void setNumReceiveWorkers(int numWorkers);
     
 private slots:
     void readPendingDatagrams();
@@ -109,6 +129,13 @@ private slots:
 
 private:
     void setSystemBufferSizes();
+    qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr, uint8_t dscp);
+    void processDatagram(std::unique_ptr<char[]> buffer, int packetSizeWithHeader, qint64 bufferCapacity,
+                         const HifiSockAddr& senderSockAddr, p_high_resolution_clock::time_point receiveTime, bool isBatched);
+#if defined(Q_OS_LINUX)
+    void readPendingDatagramsBatched();
+#endif
+    void processUnreliablePacket(std::unique_ptr<Packet> packet);
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
@@ -127,6 +154,7 @@ private:
     MessageHandler _messageHandler;
     MessageFailureHandler _messageFailureHandler;
     ConnectionCreationFilterOperator _connectionCreationFilterOperator;
+    TrafficClassOperator _trafficClassOperator;
 
     Mutex _unreliableSequenceNumbersMutex;
 
@@ -148,6 +176,17 @@ private:
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
+
+#if defined(Q_OS_LINUX)
+    // receive buffers for recvmmsg, handed off to the packets read into them and replaced as needed
+    static const int RECEIVE_BATCH_SIZE = 32;
+    std::array<std::unique_ptr<char[]>, RECEIVE_BATCH_SIZE> _receiveBatchBuffers;
+    bool _useBatchedIO { true };
+    std::atomic<bool> _useTrafficClasses { true };
+#endif
+
+    // declared last so the workers are stopped before anything they use is destroyed
+    std::vector<std::unique_ptr<ReceiveWorker>> _receiveWorkers;
     
     friend UDTTest;
 };
@@ -18,6 +18,7 @@
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 
+#include "OctreeConstants.h"
 #include "OctreeLogging.h"
 #include "JurisdictionMap.h"
 
@@ -132,6 +133,68 @@ JurisdictionMap::JurisdictionMap(const char* rootHexCode, const char* endNodesHe
     }
 }
 
+// the octal code of a cell, given by its index in octal code order among the cells at its depth
+static OctalCodePtr octalCodeForCell(int cell, int depth) {
+    OctalCodePtr code = createOctalCodePtr(1);
+    *code = 0;
+    for (int level = depth - 1; level >= 0; level--) {
+        unsigned char* child = childOctalCode(code.get(), (char)((cell >> (3 * level)) & 7));
+        size_t childBytes = bytesRequiredForCodeLength(*child);
+        code = createOctalCodePtr(childBytes);
+        memcpy(code.get(), child, childBytes);
+        delete[] child;
+    }
+    return code;
+}
+
+// adds the largest cells below the given one that are entirely outside of the cells [first, last) at the depth
+static void addPartitionEndNodes(int cell, int cellDepth, int depth, int first, int last, OctalCodePtrList& endNodes) {
+    int shift = 3 * (depth - cellDepth);
+    int cellFirst = cell << shift;
+    int cellLast = (cell + 1) << shift;
+    if (cellLast <= first || cellFirst >= last) {
+        endNodes.push_back(octalCodeForCell(cell, cellDepth));
+    } else if (cellFirst < first || cellLast > last) {
+        for (int child = 0; child < NUMBER_OF_CHILDREN; child++) {
+            addPartitionEndNodes((cell << 3) | child, cellDepth + 1, depth, first, last, endNodes);
+        }
+    }
+}
+
+JurisdictionMap::JurisdictionMap(int partitionIndex, int partitionCount, NodeType_t type) : _nodeType(type) {
+    partitionCount = glm::clamp(partitionCount, 1, MAX_PARTITION_COUNT);
+    partitionIndex = glm::clamp(partitionIndex, 0, partitionCount - 1);
+
+    // several cells for each, so that they have about as many
+    const int MAX_PARTITION_DEPTH = 3;
+    int depth = 0;
+    int cells = 1;
+    while (cells < partitionCount * NUMBER_OF_CHILDREN && depth < MAX_PARTITION_DEPTH) {
+        depth++;
+        cells *= NUMBER_OF_CHILDREN;
+    }
+    int first = partitionIndex * cells / partitionCount;
+    int last = (partitionIndex + 1) * cells / partitionCount;
+
+    // the root is the deepest cell holding them all, the cells under it that aren't ours are end nodes
+    int rootDepth = depth;
+    while ((first >> (3 * (depth - rootDepth))) != ((last - 1) >> (3 * (depth - rootDepth)))) {
+        rootDepth--;
+    }
+    int root = first >> (3 * (depth - rootDepth));
+
+    OctalCodePtrList endNodes;
+    if (rootDepth < depth) {
+        for (int child = 0; child < NUMBER_OF_CHILDREN; child++) {
+            addPartitionEndNodes((root << 3) | child, rootDepth + 1, depth, first, last, endNodes);
+        }
+    }
+    init(octalCodeForCell(root, rootDepth), endNodes);
+
+    qCDebug(octree) << "JurisdictionMap::JurisdictionMap() partition" << partitionIndex << "of" << partitionCount
+        << "root" << octalCodeToHexString(_rootOctalCode.get()) << "end nodes" << (int)_endNodes.size();
+}
+
 std::tuple<OctalCodePtr, OctalCodePtrList> JurisdictionMap::getRootAndEndNodeOctalCodes() const {
     std::lock_guard<std::mutex> lock(_octalCodeMutex);
     return std::tuple<OctalCodePtr, OctalCodePtrList>(_rootOctalCode, _endNodes);
@@ -44,6 +44,11 @@ public:
     JurisdictionMap(const char* filename);
     JurisdictionMap(const char* rootHextString, const char* endNodesHextString);
 
+    // one of partitionCount servers splitting the tree between them, each taking a run of the cells a few levels down,
+    // in octal code order so that the cells of a server are close together
+    JurisdictionMap(int partitionIndex, int partitionCount, NodeType_t type = NodeType::EntityServer);
+    static const int MAX_PARTITION_COUNT = 512; // the cells three levels down
+
     ~JurisdictionMap();
 
     Area isMyJurisdiction(const unsigned char* nodeOctalCode, int childIndex) const;
@@ -17,6 +17,7 @@
 #include <cstdio>
 #include <cmath>
 #include <fstream> // to load voxels from file
+#include <vector>
 
 #include <QDataStream>
 #include <QDebug>
@@ -44,6 +45,7 @@
 #include <udt/PacketHeaders.h>
 #include <ResourceManager.h>
 #include <SharedUtil.h>
+#include <UUID.h>
 #include <PathUtils.h>
 #include <ViewFrustum.h>
 
@@ -55,7 +57,7 @@
 #include "OctreeUtils.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"json", "json.gz", "bin"};
 
 Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
@@ -910,6 +912,7 @@ int Octree::encodeTreeBitstream(const OctreeElementPointer& element,
         params.stopReason = EncodeBitstreamParams::NULL_NODE_DATA;
         return bytesWritten;
     }
+    OctreeSceneStats& stats = params.stats ? *params.stats : octreeQueryNode->stats;
 
     // If we're at a element that is out of view, then we can return, because no nodes below us will be in view!
     if (octreeQueryNode->getUsesFrustum() && !params.recurseEverything && !element->isInView(params.viewFrustum)) {
@@ -948,7 +951,7 @@ int Octree::encodeTreeBitstream(const OctreeElementPointer& element,
 
     // record some stats, this is the one element that we won't record below in the recursion function, so we need to
     // track it here
-    octreeQueryNode->stats.traversed(element);
+    stats.traversed(element);
 
     ViewFrustum::intersection parentLocationThisView = ViewFrustum::INTERSECT; // assume parent is in view, but not fully
 
@@ -1011,6 +1014,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         params.stopReason = EncodeBitstreamParams::NULL_NODE_DATA;
         return bytesAtThisLevel;
     }
+    OctreeSceneStats& stats = params.stats ? *params.stats : octreeQueryNode->stats;
 
 
     // Keep track of how deep we've encoded.
@@ -1041,7 +1045,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
 
         // If we're too far away for our render level, then just return
         if (element->distanceToCamera(params.viewFrustum) >= boundaryDistance) {
-            octreeQueryNode->stats.skippedDistance(element);
+            stats.skippedDistance(element);
             params.stopReason = EncodeBitstreamParams::LOD_SKIP;
             return bytesAtThisLevel;
         }
@@ -1057,7 +1061,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         // although technically, we really shouldn't ever be here, because our callers shouldn't be calling us if
         // we're out of view
         if (nodeLocationThisView == ViewFrustum::OUTSIDE) {
-            octreeQueryNode->stats.skippedOutOfView(element);
+            stats.skippedOutOfView(element);
             params.stopReason = EncodeBitstreamParams::OUT_OF_VIEW;
             return bytesAtThisLevel;
         }
@@ -1094,7 +1098,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         // if we're in deltaView mode, and this element has changed since it was last sent, then we do
         // need to send it.
         if (wasInView && !(params.deltaView && element->hasChangedSince(octreeQueryNode->getLastTimeBagEmpty() - CHANGE_FUDGE))) {
-            octreeQueryNode->stats.skippedWasInView(element);
+            stats.skippedWasInView(element);
             params.stopReason = EncodeBitstreamParams::WAS_IN_VIEW;
             return bytesAtThisLevel;
         }
@@ -1105,7 +1109,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
     if (!params.forceSendScene && !params.deltaView &&
         !element->hasChangedSince(octreeQueryNode->getLastTimeBagEmpty() - CHANGE_FUDGE)) {
 
-        octreeQueryNode->stats.skippedNoChange(element);
+        stats.skippedNoChange(element);
 
         params.stopReason = EncodeBitstreamParams::NO_CHANGE;
         return bytesAtThisLevel;
@@ -1179,7 +1183,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         // track stats
         // must check childElement here, because it could be we got here with no childElement
         if (childElement) {
-            octreeQueryNode->stats.traversed(childElement);
+            stats.traversed(childElement);
         }
     }
 
@@ -1199,7 +1203,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         if (!childIsInView) {
             // must check childElement here, because it could be we got here because there was no childElement
             if (childElement) {
-                octreeQueryNode->stats.skippedOutOfView(childElement);
+                stats.skippedOutOfView(childElement);
             }
         } else {
             // Before we consider this further, let's see if it's in our LOD scope...
@@ -1209,7 +1213,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
 
             if (!(distancesToChildren[i] < boundaryDistance)) {
                 // don't need to check childElement here, because we can't get here with no childElement
-                octreeQueryNode->stats.skippedDistance(childElement);
+                stats.skippedDistance(childElement);
             } else {
                 inViewCount++;
 
@@ -1230,11 +1234,11 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
                 // track some stats
                 // don't need to check childElement here, because we can't get here with no childElement
                 if (!shouldRender && childElement->isLeaf()) {
-                    octreeQueryNode->stats.skippedDistance(childElement);
+                    stats.skippedDistance(childElement);
                 }
                 // don't need to check childElement here, because we can't get here with no childElement
                 if (childIsOccluded) {
-                    octreeQueryNode->stats.skippedOccluded(childElement);
+                    stats.skippedOccluded(childElement);
                 }
 
                 // track children with actual color, only if the child wasn't previously in view!
@@ -1265,9 +1269,9 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
                         // otherwise just track stats of the items we discarded
                         // don't need to check childElement here, because we can't get here with no childElement
                         if (childWasInView) {
-                            octreeQueryNode->stats.skippedWasInView(childElement);
+                            stats.skippedWasInView(childElement);
                         } else {
-                            octreeQueryNode->stats.skippedNoChange(childElement);
+                            stats.skippedNoChange(childElement);
                         }
                     }
                 }
@@ -1286,7 +1290,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
     assert(continueThisLevel); // since we used reserved bits, this really shouldn't fail
     bytesAtThisLevel += sizeof(childrenDataBits); // keep track of byte count
 
-    octreeQueryNode->stats.colorBitsWritten(); // really data bits not just color bits
+    stats.colorBitsWritten(); // really data bits not just color bits
 
     // NOW might be a good time to give our tree subclass and this element a chance to set up and check any extra encode data
     element->initializeExtraEncodeData(params);
@@ -1357,7 +1361,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
 
                 // don't need to check childElement here, because we can't get here with no childElement
                 if (childAppendState != OctreeElement::NONE) {
-                    octreeQueryNode->stats.colorSent(childElement);
+                    stats.colorSent(childElement);
                 }
             }
         }
@@ -1385,7 +1389,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         if (continueThisLevel) {
             bytesAtThisLevel += sizeof(childrenExistInTreeBits); // keep track of byte count
 
-            octreeQueryNode->stats.existsBitsWritten();
+            stats.existsBitsWritten();
         } else {
             qCDebug(octree) << "WARNING UNEXPECTED CASE: Failed to append childrenExistInTreeBits";
             qCDebug(octree) << "This is not expected!!!!  -- continueThisLevel=FALSE....";
@@ -1399,7 +1403,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         if (continueThisLevel) {
             bytesAtThisLevel += sizeof(childrenExistInPacketBits); // keep track of byte count
 
-            octreeQueryNode->stats.existsInPacketBitsWritten();
+            stats.existsInPacketBitsWritten();
         } else {
             qCDebug(octree) << "WARNING UNEXPECTED CASE: Failed to append childrenExistInPacketBits";
             qCDebug(octree) << "This is not expected!!!!  -- continueThisLevel=FALSE....";
@@ -1508,7 +1512,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
 
                     // If this is the last of the child exists bits, then we're actually be rolling out the entire tree
                     if (childrenExistInPacketBits == 0) {
-                        octreeQueryNode->stats.childBitsRemoved(params.includeExistsBits);
+                        stats.childBitsRemoved(params.includeExistsBits);
                     }
 
                     if (!continueThisLevel) {
@@ -1563,7 +1567,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         if (continueThisLevel) {
             bytesAtThisLevel += (bytesAfterChild - bytesBeforeChild); // keep track of byte count for this child
 
-            octreeQueryNode->stats.colorSent(element);
+            stats.colorSent(element);
         }
 
         if (!continueThisLevel) {
@@ -1598,7 +1602,7 @@ int Octree::encodeTreeBitstreamRecursion(const OctreeElementPointer& element,
         bag.insert(element);
 
         // don't need to check element here, because we can't get here with no element
-        octreeQueryNode->stats.didntFit(element);
+        stats.didntFit(element);
 
         params.stopReason = EncodeBitstreamParams::DIDNT_FIT;
         bytesAtThisLevel = 0; // didn't fit
@@ -1629,6 +1633,10 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".bin")) {
+        return readFromBinaryFile(qFileName);
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -1928,6 +1936,8 @@ bool Octree::writeToFile(const char* fileName, const OctreeElementPointer& eleme
         success = writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         success = writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "bin" && !element) {
+        success = writeToBinaryFile(cFileName);
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -1982,6 +1992,159 @@ bool Octree::writeToJSONFile(const char* fileName, const OctreeElementPointer& e
     return success;
 }
 
+// The binary persist format is laid out so that it can be read straight out of a mapped file:
+//
+//     BinaryPersistHeader
+//     the data of each record, back to back
+//     a BinaryPersistTableEntry for each record, giving its ID and where its data is
+//
+// All values are little-endian. The table comes last so the file can be written in a single pass.
+namespace {
+
+const char BINARY_PERSIST_MAGIC[4] = { 'H', 'F', 'O', 'T' };
+const quint32 BINARY_PERSIST_FORMAT_VERSION = 1;
+
+struct BinaryPersistHeader {
+    char magic[4];
+    quint32 formatVersion;
+    quint32 bitstreamVersion;
+    quint32 numRecords;
+    quint64 tableOffset;
+};
+
+struct BinaryPersistTableEntry {
+    char id[NUM_BYTES_RFC4122_UUID];
+    quint64 lastEdited;
+    quint64 offset;
+    quint64 size;
+};
+
+}
+
+bool Octree::writeToBinaryFile(const char* fileName) {
+    qCDebug(octree, "Saving binary SVO to file %s...", fileName);
+
+    if (!writeToPersistRecords(_persistRecords, true)) {
+        qCritical("Failed to convert the octree to records while saving to binary.");
+        return false;
+    }
+
+    QFile persistFile(fileName);
+    if (!persistFile.open(QIODevice::WriteOnly)) {
+        qCritical("Could not write to binary description of entities.");
+        return false;
+    }
+
+    BinaryPersistHeader header;
+    memcpy(header.magic, BINARY_PERSIST_MAGIC, sizeof(header.magic));
+    header.formatVersion = BINARY_PERSIST_FORMAT_VERSION;
+    header.bitstreamVersion = versionForPacketType(expectedDataPacketType());
+    header.numRecords = _persistRecords.size();
+    header.tableOffset = 0;
+
+    std::vector<BinaryPersistTableEntry> table;
+    table.reserve(_persistRecords.size());
+
+    bool success = persistFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) != -1;
+    quint64 offset = sizeof(header);
+
+    for (auto it = _persistRecords.cbegin(); success && it != _persistRecords.cend(); ++it) {
+        BinaryPersistTableEntry entry;
+        QByteArray id = it.key().toRfc4122();
+        memcpy(entry.id, id.constData(), sizeof(entry.id));
+        entry.lastEdited = it->lastEdited;
+        entry.offset = offset;
+        entry.size = it->data.size();
+        table.push_back(entry);
+
+        success = persistFile.write(it->data) != -1;
+        offset += entry.size;
+    }
+
+    if (success) {
+        header.tableOffset = offset;
+        success = persistFile.write(reinterpret_cast<const char*>(table.data()),
+                                    table.size() * sizeof(BinaryPersistTableEntry)) != -1
+            && persistFile.seek(0)
+            && persistFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) != -1;
+    }
+
+    if (!success) {
+        qCritical("Could not write to binary description of entities.");
+    } else {
+        qCDebug(octree) << "Saved" << header.numRecords << "records to binary file" << fileName;
+    }
+
+    return success;
+}
+
+bool Octree::readFromBinaryFile(QString qFileName) {
+    QFile file(qFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot open binary file for reading: " << qFileName;
+        return false;
+    }
+
+    qint64 fileSize = file.size();
+    if (fileSize < (qint64)sizeof(BinaryPersistHeader)) {
+        qCritical() << "Binary file is too short:" << qFileName;
+        return false;
+    }
+
+    const uchar* fileData = file.map(0, fileSize);
+    if (!fileData) {
+        qCritical() << "Cannot map binary file for reading: " << qFileName;
+        return false;
+    }
+
+    BinaryPersistHeader header;
+    memcpy(&header, fileData, sizeof(header));
+
+    if (memcmp(header.magic, BINARY_PERSIST_MAGIC, sizeof(header.magic)) != 0
+        || header.formatVersion != BINARY_PERSIST_FORMAT_VERSION) {
+        qCritical() << "File is not in a supported binary format:" << qFileName;
+        return false;
+    }
+
+    quint64 tableSize = (quint64)header.numRecords * sizeof(BinaryPersistTableEntry);
+    if (header.tableOffset > (quint64)fileSize || tableSize > (quint64)fileSize - header.tableOffset) {
+        qCritical() << "Binary file has a corrupt record table:" << qFileName;
+        return false;
+    }
+
+    qCDebug(octree) << "Loading" << header.numRecords << "records from binary file" << qFileName << "...";
+
+    OctreePersistRecords records;
+    records.reserve(header.numRecords);
+
+    const uchar* tableData = fileData + header.tableOffset;
+    for (quint32 i = 0; i < header.numRecords; ++i) {
+        BinaryPersistTableEntry entry;
+        memcpy(&entry, tableData + i * sizeof(BinaryPersistTableEntry), sizeof(entry));
+
+        if (entry.offset > header.tableOffset || entry.size > header.tableOffset - entry.offset) {
+            qCritical() << "Binary file has a record outside of its data:" << qFileName;
+            return false;
+        }
+
+        QUuid id = QUuid::fromRfc4122(QByteArray::fromRawData(entry.id, sizeof(entry.id)));
+
+        // the record data stays in the mapped file, it is only decoded by readFromPersistRecords
+        OctreePersistRecord& record = records[id];
+        record.lastEdited = entry.lastEdited;
+        record.data = QByteArray::fromRawData(reinterpret_cast<const char*>(fileData + entry.offset), (int)entry.size);
+    }
+
+    emit importSize(1.0f, 1.0f, 1.0f);
+    emit importProgress(0);
+
+    bool success = readFromPersistRecords(records);
+
+    emit importProgress(100);
+
+    return success;
+}
+
 unsigned long Octree::getOctreeElementsCount() {
     unsigned long nodeCount = 0;
     recurseTreeWithOperation(countOctreeElementsOperation, &nodeCount);
@@ -12,11 +12,13 @@
 #ifndef hifi_Octree_h
 #define hifi_Octree_h
 
+#include <atomic>
 #include <memory>
 #include <set>
 
 #include <QHash>
 #include <QObject>
+#include <QUuid>
 #include <QtCore/QJsonObject>
 
 #include <shared/ReadWriteLockable.h>
@@ -38,6 +40,20 @@ using OctreePointer = std::shared_ptr<Octree>;
 
 extern QVector<QString> PERSIST_EXTENSIONS;
 
+// one item of the tree as stored in a binary persist file, keyed by the item's ID in OctreePersistRecords
+struct OctreePersistRecord {
+    quint64 lastEdited { 0 }; // lets a later save reuse data for items that haven't changed
+    QByteArray data;
+};
+using OctreePersistRecords = QHash<QUuid, OctreePersistRecord>;
+
+// the edits of an edit message decoded ahead of it being processed, by a tree that can, see decodeEditPacketData()
+class OctreeDecodedEdits {
+public:
+    virtual ~OctreeDecodedEdits() { }
+};
+using OctreeDecodedEditsPointer = std::shared_ptr<OctreeDecodedEdits>;
+
 /// derive from this class to use the Octree::recurseTreeWithOperator() method
 class RecurseOctreeOperator {
 public:
@@ -56,6 +72,8 @@ const bool WANT_EXISTS_BITS       = true;
 const bool COLLAPSE_EMPTY_TREE    = true;
 const bool DONT_COLLAPSE          = false;
 
+const int EDIT_NEEDS_WRITE_LOCK  = -1;
+
 const int DONT_CHOP              = 0;
 const int NO_BOUNDARY_ADJUST     = 0;
 const int LOW_RES_MOVING_ADJUST  = 1;
@@ -156,6 +174,11 @@ public:
     }
 
     std::function<void(const QUuid& dataID, quint64 itemLastEdited)> trackSend { [](const QUuid&, quint64){} };
+
+    // if set, these are used in place of the nodeData's scene stats and extra encode data, which lets
+    // disjoint subtrees for the same node be encoded on several threads at once
+    OctreeSceneStats* stats { nullptr };
+    OctreeElementExtraEncodeData* extraEncodeData { nullptr };
 };
 
 class ReadElementBufferToTreeArgs {
@@ -211,7 +234,25 @@ public:
     virtual PacketVersion expectedVersion() const { return versionForPacketType(expectedDataPacketType()); }
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
-                                      const SharedNodePointer& sourceNode) { return 0; }
+                                      const SharedNodePointer& sourceNode,
+                                      const OctreeDecodedEdits* decodedEdits = nullptr) { return 0; }
+
+    // Called with only the tree's read lock held, for trees that can apply edits that leave their structure alone
+    // without blocking everyone else. Returns EDIT_NEEDS_WRITE_LOCK, having changed nothing, for an edit that has to
+    // go through processEditPacketData() with the write lock instead.
+    virtual int processEditPacketDataUnderReadLock(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                   const SharedNodePointer& sourceNode,
+                                                   const OctreeDecodedEdits* decodedEdits = nullptr) {
+        return EDIT_NEEDS_WRITE_LOCK;
+    }
+
+    // Decodes the edits of a message from the given position on, without touching the tree or the message's position,
+    // so that it can be done with no lock held and on any thread while other messages are processed. What it returns
+    // is handed back to processEditPacketData() for the edits of that message, which are then not decoded again.
+    // Trees that don't decode ahead return nothing.
+    virtual OctreeDecodedEditsPointer decodeEditPacketData(const ReceivedMessage& message, int position) const {
+        return nullptr;
+    }
 
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
@@ -295,9 +336,13 @@ public:
     // Octree exporters
     bool writeToFile(const char* filename, const OctreeElementPointer& element = NULL, QString persistAsFileType = "json.gz");
     bool writeToJSONFile(const char* filename, const OctreeElementPointer& element = NULL, bool doGzip = false);
+    bool writeToBinaryFile(const char* filename);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) = 0;
 
+    // brings records up to date with the tree, only re-encoding the items that changed since the records were made
+    virtual bool writeToPersistRecords(OctreePersistRecords& records, bool skipThoseWithBadParents) { return false; }
+
     // Octree importers
     bool readFromFile(const char* filename);
     bool readFromURL(const QString& url); // will support file urls as well...
@@ -305,10 +350,17 @@ public:
     bool readSVOFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream, const QString& marketplaceID="");
     bool readJSONFromGzippedFile(QString qFileName);
+    bool readFromBinaryFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // the data of the records may point directly into a mapped file, so it must not be kept past the call
+    virtual bool readFromPersistRecords(const OctreePersistRecords& records) { return false; }
+
     unsigned long getOctreeElementsCount();
 
+    // how long the last save held the tree's lock to take a snapshot of its contents
+    quint64 getLastPersistLockUsecs() const { return _lastPersistLockUsecs; }
+
     bool getShouldReaverage() const { return _shouldReaverage; }
 
     void recurseElementWithOperation(const OctreeElementPointer& element, const RecurseOctreeOperation& operation,
@@ -375,6 +427,10 @@ protected:
 
     bool _isViewing;
     bool _isServer;
+
+    // the records of the last binary save, so the next one only has to encode what changed
+    OctreePersistRecords _persistRecords;
+    std::atomic<quint64> _lastPersistLockUsecs { 0 };
 };
 
 #endif // hifi_Octree_h
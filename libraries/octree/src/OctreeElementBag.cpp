@@ -14,6 +14,7 @@
 
 void OctreeElementBag::deleteAll() {
     _bagElements = Bag();
+    _queue = std::priority_queue<PrioritizedElement>();
 }
 
 /// does the bag contain elements?
@@ -24,12 +25,46 @@ bool OctreeElementBag::isEmpty() {
 }
 
 void OctreeElementBag::insert(const OctreeElementPointer& element) {
-    _bagElements[element.get()] = element;
+    auto inserted = _bagElements.emplace(element.get(), element);
+    if (!inserted.second) {
+        inserted.first->second = element;
+    } else if (_priorityFunction) {
+        _queue.push({ _priorityFunction(*element), element.get() });
+    }
+}
+
+void OctreeElementBag::setPriorityFunction(PriorityFunction priorityFunction) {
+    _priorityFunction = priorityFunction;
+    _queue = std::priority_queue<PrioritizedElement>();
+    if (_priorityFunction) {
+        for (auto& entry : _bagElements) {
+            if (auto element = entry.second.lock()) {
+                _queue.push({ _priorityFunction(*element), entry.first });
+            }
+        }
+    }
 }
 
 OctreeElementPointer OctreeElementBag::extract() {
     OctreeElementPointer result;
 
+    if (_priorityFunction) {
+        // the queue holds every element of the bag, elements that expired before they were prioritized aren't in it
+        while (!_queue.empty() && !result) {
+            auto it = _bagElements.find(_queue.top().element);
+            _queue.pop();
+            if (it != _bagElements.end()) {
+                result = it->second.lock();
+                _bagElements.erase(it);
+            }
+        }
+        if (!result && !_bagElements.empty()) {
+            // only expired elements are left
+            _bagElements = Bag();
+        }
+        return result;
+    }
+
     // Find the first element still alive
     Bag::iterator it = _bagElements.begin();
     while (it != _bagElements.end() && !result) {
@@ -16,7 +16,10 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
+#include <functional>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "OctreeElement.h"
 
@@ -24,10 +27,18 @@ class OctreeElementBag {
     using Bag = std::unordered_map<OctreeElement*, OctreeElementWeakPointer>;
     
 public:
+    using PriorityFunction = std::function<float(const OctreeElement& element)>;
+
     void insert(const OctreeElementPointer& element); // put a element into the bag
 
-    OctreeElementPointer extract(); /// pull a element out of the bag (could come in any order) and if all of the
-                                    /// elements have expired, a single null pointer will be returned
+    OctreeElementPointer extract(); /// pull a element out of the bag (in order of priority if there is a priority
+                                    /// function, any order otherwise) and if all of the elements have expired, a
+                                    /// single null pointer will be returned
+
+    /// elements of higher priority are extracted first, the priority of an element is taken as it is inserted
+    void setPriorityFunction(PriorityFunction priorityFunction);
+    void clearPriorityFunction() { setPriorityFunction(PriorityFunction()); }
+    const PriorityFunction& getPriorityFunction() const { return _priorityFunction; }
 
     bool isEmpty(); /// does the bag contain elements, 
                     /// if all of the contained elements are expired, they will not report as empty, and
@@ -37,7 +48,15 @@ public:
     size_t size() const { return _bagElements.size(); }
 
 private:
+    struct PrioritizedElement {
+        float priority;
+        OctreeElement* element;
+        bool operator<(const PrioritizedElement& other) const { return priority < other.priority; }
+    };
+
     Bag _bagElements;
+    PriorityFunction _priorityFunction;
+    std::priority_queue<PrioritizedElement> _queue; // the elements of the bag, when there is a priority function
 };
 
 class OctreeElementExtraEncodeDataBase {
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <zlib.h>
+
 #include <GLMHelpers.h>
 #include <PerfStat.h>
 
@@ -24,6 +26,23 @@ AtomicUIntStat OctreePacketData::_totalBytesOfValues { 0 };
 AtomicUIntStat OctreePacketData::_totalBytesOfPositions { 0 };
 AtomicUIntStat OctreePacketData::_totalBytesOfRawData { 0 };
 
+// Primes the compression of every packet, so that the first occurrence of one of these in a packet is already a
+// back reference. Entity packets are too small to build up much history of their own, and their strings are mostly
+// the same URLs and user data over and over. zlib looks farther back less cheaply, so the most common come last.
+// Sender and receiver must have the same dictionary, changing it needs a new packet version.
+static const char CONTENT_DICTIONARY[] =
+    ".dds\0.ktx\0.wav\0.mp3\0.ogg\0.svo\0.gltf\0.obj\0.jpg\0.png\0.json\0.js\0.fbx\0"
+    "file:///\0atp:/\0http://\0https://\0"
+    "https://hifi-content.s3.amazonaws.com/\0http://mpassets.highfidelity.com/\0"
+    "https://hifi-public.s3.amazonaws.com/\0"
+    "{\"Tex.CubeMap\":\"\0{\"diffuse\":\"\0{\"tex\":\"\0"
+    "{\"x\":0,\"y\":0,\"z\":0}\0{\"x\":1,\"y\":1,\"z\":1}\0"
+    "\"wearable\":{\"joints\":{\0\"equipHotspots\":[\0\"ignoreIK\":false\0\"ignoreIK\":true\0"
+    "\"triggerable\":true\0\"kinematic\":false\0\"cloneable\":true\0\"cloneLifetime\":\0"
+    "\"ProceduralEntity\":{\"version\":2,\"shaderUrl\":\"\0"
+    "{\"grabbableKey\":{\"grabbable\":false}}\0{\"grabbableKey\":{\"grabbable\":true}}\0"
+    "\"grabbableKey\":{\"grabbable\":false\0\"grabbableKey\":{\"grabbable\":true\0";
+
 struct aaCubeData {
     glm::vec3 corner;
     float scale;
@@ -55,6 +74,9 @@ void OctreePacketData::reset() {
 }
 
 OctreePacketData::~OctreePacketData() {
+    if (_deflateStream) {
+        deflateEnd(_deflateStream.get());
+    }
 }
 
 bool OctreePacketData::append(const unsigned char* data, int length) {
@@ -574,17 +596,26 @@ bool OctreePacketData::compressContent() {
     bool success = false;
     const int MAX_COMPRESSION = 9;
 
-    // we only want to compress the data payload, not the message header
-    const uchar* uncompressedData = &_uncompressed[0];
-    int uncompressedSize = _bytesInUse;
+    // the stream is kept from one packet to the next, only its state is reset, its buffers aren't allocated again
+    if (!_deflateStream) {
+        _deflateStream.reset(new z_stream());
+        if (deflateInit(_deflateStream.get(), MAX_COMPRESSION) != Z_OK) {
+            _deflateStream.reset();
+            return false;
+        }
+    } else {
+        deflateReset(_deflateStream.get());
+    }
+    deflateSetDictionary(_deflateStream.get(), (const Bytef*)CONTENT_DICTIONARY, sizeof(CONTENT_DICTIONARY) - 1);
 
-    QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+    // we only want to compress the data payload, not the message header
+    _deflateStream->next_in = &_uncompressed[0];
+    _deflateStream->avail_in = _bytesInUse;
+    _deflateStream->next_out = &_compressed[0];
+    _deflateStream->avail_out = MAX_OCTREE_PACKET_DATA_SIZE - 1;
 
-    if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
-        _compressedBytes = compressedData.size();
-        for (int i = 0; i < _compressedBytes; i++) {
-            _compressed[i] = compressedData[i];
-        }
+    if (deflate(_deflateStream.get(), Z_FINISH) == Z_STREAM_END) {
+        _compressedBytes = (int)_deflateStream->total_out;
         _dirty = false;
         success = true;
     }
@@ -598,20 +629,28 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
     if (data && length > 0) {
 
         if (_enableCompression) {
-            QByteArray compressedData;
-            for (int i = 0; i < length; i++) {
-                compressedData[i] = data[i];
-                _compressed[i] = compressedData[i];
-            }
+            length = std::min(length, (int)MAX_OCTREE_PACKET_DATA_SIZE);
+            memcpy(_compressed, data, length);
             _compressedBytes = length;
-            QByteArray uncompressedData = qUncompress(compressedData);
-            if (uncompressedData.size() <= _bytesAvailable) {
-                _bytesInUse = uncompressedData.size();
-                _bytesAvailable -= uncompressedData.size();
 
-                for (int i = 0; i < _bytesInUse; i++) {
-                    _uncompressed[i] = uncompressedData[i];
+            z_stream stream {};
+            if (inflateInit(&stream) == Z_OK) {
+                stream.next_in = _compressed;
+                stream.avail_in = length;
+                stream.next_out = _uncompressed;
+                stream.avail_out = _bytesAvailable;
+
+                int status = inflate(&stream, Z_FINISH);
+                if (status == Z_NEED_DICT) {
+                    inflateSetDictionary(&stream, (const Bytef*)CONTENT_DICTIONARY, sizeof(CONTENT_DICTIONARY) - 1);
+                    status = inflate(&stream, Z_FINISH);
+                }
+                // content that doesn't fit, or isn't whole, is left out altogether
+                if (status == Z_STREAM_END) {
+                    _bytesInUse = (int)stream.total_out;
+                    _bytesAvailable -= _bytesInUse;
                 }
+                inflateEnd(&stream);
             }
         } else {
             for (int i = 0; i < length; i++) {
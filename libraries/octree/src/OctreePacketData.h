@@ -23,6 +23,7 @@
 #define hifi_OctreePacketData_h
 
 #include <atomic>
+#include <memory>
 
 #include <QByteArray>
 #include <QString>
@@ -37,6 +38,8 @@
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
 
+struct z_stream_s;
+
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
 typedef unsigned char OCTREE_PACKET_FLAGS;
@@ -286,6 +289,7 @@ private:
     int _subTreeBytesReserved; // the number of reserved bytes at start of a subtree
 
     bool compressContent();
+    std::unique_ptr<z_stream_s> _deflateStream; // kept across packets, made on the first compression
     
     unsigned char _compressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _compressedBytes;
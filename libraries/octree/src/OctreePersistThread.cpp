@@ -62,6 +62,8 @@ QString OctreePersistThread::getPersistFileMimeType() const {
         return "application/json";
     } if (_persistAsFileType == "json.gz") {
         return "application/zip";
+    } if (_persistAsFileType == "bin") {
+        return "application/octet-stream";
     }
     return "";
 }
@@ -134,7 +136,9 @@ quint64 OctreePersistThread::getMostRecentBackupTimeInUsecs(const QString& forma
 
 void OctreePersistThread::possiblyReplaceContent() {
     // before we load the normal file, check if there's a pending replacement file
-    auto replacementFileName = _filename + REPLACEMENT_FILE_EXTENSION;
+    // replacement content is always gzipped JSON, whatever type we persist as
+    auto replacementTargetFileName = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS) + ".json.gz";
+    auto replacementFileName = replacementTargetFileName + REPLACEMENT_FILE_EXTENSION;
 
     QFile replacementFile { replacementFileName };
     if (replacementFile.exists()) {
@@ -161,7 +165,10 @@ void OctreePersistThread::possiblyReplaceContent() {
         }
 
         // rename the replacement file to match what the persist thread is just about to read
-        if (!replacementFile.rename(_filename)) {
+        if (QFile::exists(replacementTargetFileName) && replacementTargetFileName != _filename) {
+            QFile::remove(replacementTargetFileName);
+        }
+        if (!replacementFile.rename(replacementTargetFileName)) {
             qWarning() << "Could not replace models file with" << replacementFileName << "- starting with empty models file";
         }
     }
@@ -292,11 +299,13 @@ QByteArray OctreePersistThread::getPersistFileContents() const {
 void OctreePersistThread::persist() {
     if (_tree->isDirty() && _initialLoadComplete) {
 
+        quint64 pruneStart = usecTimestampNow();
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
             _tree->pruneTree();
             qCDebug(octree) << "DONE pruning Octree before saving...";
         });
+        quint64 pruneLockUsecs = usecTimestampNow() - pruneStart;
 
         qCDebug(octree) << "persist operation calling backup...";
         backup(); // handle backup if requested        
@@ -311,6 +320,13 @@ void OctreePersistThread::persist() {
 
             _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
             time(&_lastPersistTime);
+
+            // the tree only holds its lock to prune and to take a snapshot, serializing and writing happen off of it
+            _lastPersistLockUsecs = pruneLockUsecs + _tree->getLastPersistLockUsecs();
+            if (_lastPersistLockUsecs > _maxPersistLockUsecs) {
+                _maxPersistLockUsecs = _lastPersistLockUsecs.load();
+            }
+            qCDebug(octree) << "saving Octree held the tree lock for" << _lastPersistLockUsecs.load() << "usecs";
             _tree->clearDirtyBit(); // tree is clean after saving
             qCDebug(octree) << "DONE saving Octree to file...";
 
@@ -14,6 +14,8 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <atomic>
+
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
@@ -40,6 +42,8 @@ public:
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
+    quint64 getLastPersistLockTime() const { return _lastPersistLockUsecs; }
+    quint64 getMaxPersistLockTime() const { return _maxPersistLockUsecs; }
 
     void aboutToFinish(); /// call this to inform the persist thread that the owner is about to finish to support final persist
 
@@ -73,6 +77,8 @@ private:
     quint64 _loadTimeUSecs;
 
     time_t _lastPersistTime;
+    std::atomic<quint64> _lastPersistLockUsecs { 0 };
+    std::atomic<quint64> _maxPersistLockUsecs { 0 };
     quint64 _lastCheck;
     bool _wantBackup;
     QVector<BackupRule> _backupRules;
@@ -313,6 +313,8 @@ const NLPacket* OctreeQueryNode::getNextNackedPacket() {
 }
 
 void OctreeQueryNode::parseNackPacket(ReceivedMessage& message) {
+    _nackPacketsReceived++;
+
     // read sequence numbers
     while (message.getBytesLeftToRead()) {
         OCTREE_PACKET_SEQUENCE sequenceNumber;
@@ -12,6 +12,7 @@
 #ifndef hifi_OctreeQueryNode_h
 #define hifi_OctreeQueryNode_h
 
+#include <atomic>
 #include <iostream>
 
 #include <NodeData.h>
@@ -75,6 +76,9 @@ public:
     quint64 getLastTimeBagEmpty() const { return _lastTimeBagEmpty; }
     void setLastTimeBagEmpty() { _lastTimeBagEmpty = _sceneSendStartTime; }
 
+    // called by the send thread when every element of a scene has been sent (completed) or the scene was abandoned
+    virtual void sceneEnded(bool completed) { }
+
     bool hasLodChanged() const { return _lodChanged; }
 
     OctreeSceneStats stats;
@@ -99,6 +103,8 @@ public:
     void parseNackPacket(ReceivedMessage& message);
     bool hasNextNackedPacket() const;
     const NLPacket* getNextNackedPacket();
+    // the nack packets received since the last call, a sign that the client is sent more than it can take
+    int takeNackPacketsReceived() { return _nackPacketsReceived.exchange(0); }
 
     // call only from OctreeSendThread for the given node
     bool haveJSONParametersChanged();
@@ -145,6 +151,7 @@ private:
 
     SentPacketHistory _sentPacketHistory;
     QQueue<OCTREE_PACKET_SEQUENCE> _nackedSequenceNumbers;
+    std::atomic<int> _nackPacketsReceived { 0 };
 
     quint64 _sceneSendStartTime = 0;
 
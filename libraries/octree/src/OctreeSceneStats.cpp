@@ -339,6 +339,45 @@ void OctreeSceneStats::childBitsRemoved(bool includesExistsBits) {
     _treesRemoved++;
 }
 
+void OctreeSceneStats::accumulateElementStats(const OctreeSceneStats& other) {
+    _traversed += other._traversed;
+    _internal += other._internal;
+    _leaves += other._leaves;
+
+    _skippedDistance += other._skippedDistance;
+    _internalSkippedDistance += other._internalSkippedDistance;
+    _leavesSkippedDistance += other._leavesSkippedDistance;
+
+    _skippedOutOfView += other._skippedOutOfView;
+    _internalSkippedOutOfView += other._internalSkippedOutOfView;
+    _leavesSkippedOutOfView += other._leavesSkippedOutOfView;
+
+    _skippedWasInView += other._skippedWasInView;
+    _internalSkippedWasInView += other._internalSkippedWasInView;
+    _leavesSkippedWasInView += other._leavesSkippedWasInView;
+
+    _skippedNoChange += other._skippedNoChange;
+    _internalSkippedNoChange += other._internalSkippedNoChange;
+    _leavesSkippedNoChange += other._leavesSkippedNoChange;
+
+    _skippedOccluded += other._skippedOccluded;
+    _internalSkippedOccluded += other._internalSkippedOccluded;
+    _leavesSkippedOccluded += other._leavesSkippedOccluded;
+
+    _colorSent += other._colorSent;
+    _internalColorSent += other._internalColorSent;
+    _leavesColorSent += other._leavesColorSent;
+
+    _didntFit += other._didntFit;
+    _internalDidntFit += other._internalDidntFit;
+    _leavesDidntFit += other._leavesDidntFit;
+
+    _colorBitsWritten += other._colorBitsWritten;
+    _existsBitsWritten += other._existsBitsWritten;
+    _existsInPacketBitsWritten += other._existsInPacketBitsWritten;
+    _treesRemoved += other._treesRemoved;
+}
+
 int OctreeSceneStats::packIntoPacket() {
     _statsPacket->reset();
 
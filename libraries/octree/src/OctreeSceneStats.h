@@ -92,6 +92,10 @@ public:
     /// Fix up tracking statistics in case where bitmasks were removed for some reason
     void childBitsRemoved(bool includesExistsBits);
 
+    /// Add the element tracking statistics of an encode pass that was tracked separately, such as one subtree
+    /// of a scene encoded on another thread
+    void accumulateElementStats(const OctreeSceneStats& other);
+
     /// Pack the details of the statistics into a buffer for sending as a network packet
     int packIntoPacket();
 
@@ -249,28 +249,42 @@ void EntityMotionState::getWorldTransform(btTransform& worldTrans) const {
 
 // This callback is invoked by the physics simulation at the end of each simulation step...
 // iff the corresponding RigidBody is DYNAMIC and ACTIVE.
+// It only records the transform: the entity is updated in applyOutgoingTransform(), so that
+// synchronizing the motion states doesn't need the EntityTree lock.
 void EntityMotionState::setWorldTransform(const btTransform& worldTrans) {
+    assert(_entity);
+    _outgoingTransform = worldTrans;
+    _outgoingVelocity = getBodyLinearVelocity();
+    _outgoingAngularVelocity = getBodyAngularVelocity();
+    _hasOutgoingTransform = true;
+}
+
+void EntityMotionState::applyOutgoingTransform() {
+    if (!_hasOutgoingTransform) {
+        return;
+    }
+    _hasOutgoingTransform = false;
     assert(_entity);
     assert(entityTreeIsLocked());
     measureBodyAcceleration();
     bool positionSuccess;
-    _entity->setPosition(bulletToGLM(worldTrans.getOrigin()) + ObjectMotionState::getWorldOffset(), positionSuccess, false);
+    _entity->setPosition(bulletToGLM(_outgoingTransform.getOrigin()) + ObjectMotionState::getWorldOffset(), positionSuccess, false);
     if (!positionSuccess) {
         static QString repeatedMessage =
-            LogHandler::getInstance().addRepeatedMessageRegex("EntityMotionState::setWorldTransform "
+            LogHandler::getInstance().addRepeatedMessageRegex("EntityMotionState::applyOutgoingTransform "
                                                               "setPosition failed.*");
-        qCDebug(physics) << "EntityMotionState::setWorldTransform setPosition failed" << _entity->getID();
+        qCDebug(physics) << "EntityMotionState::applyOutgoingTransform setPosition failed" << _entity->getID();
     }
     bool orientationSuccess;
-    _entity->setOrientation(bulletToGLM(worldTrans.getRotation()), orientationSuccess, false);
+    _entity->setOrientation(bulletToGLM(_outgoingTransform.getRotation()), orientationSuccess, false);
     if (!orientationSuccess) {
         static QString repeatedMessage =
-            LogHandler::getInstance().addRepeatedMessageRegex("EntityMotionState::setWorldTransform "
+            LogHandler::getInstance().addRepeatedMessageRegex("EntityMotionState::applyOutgoingTransform "
                                                               "setOrientation failed.*");
-        qCDebug(physics) << "EntityMotionState::setWorldTransform setOrientation failed" << _entity->getID();
+        qCDebug(physics) << "EntityMotionState::applyOutgoingTransform setOrientation failed" << _entity->getID();
     }
-    _entity->setVelocity(getBodyLinearVelocity());
-    _entity->setAngularVelocity(getBodyAngularVelocity());
+    _entity->setVelocity(_outgoingVelocity);
+    _entity->setAngularVelocity(_outgoingAngularVelocity);
     _entity->setLastSimulated(usecTimestampNow());
 
     if (_entity->getSimulatorID().isNull()) {
@@ -282,7 +296,7 @@ void EntityMotionState::setWorldTransform(const btTransform& worldTrans) {
 
     #ifdef WANT_DEBUG
         quint64 now = usecTimestampNow();
-        qCDebug(physics) << "EntityMotionState::setWorldTransform()... changed entity:" << _entity->getEntityItemID();
+        qCDebug(physics) << "EntityMotionState::applyOutgoingTransform()... changed entity:" << _entity->getEntityItemID();
         qCDebug(physics) << "       last edited:" << _entity->getLastEdited()
                          << formatUsecTime(now - _entity->getLastEdited()) << "ago";
         qCDebug(physics) << "    last simulated:" << _entity->getLastSimulated()
@@ -388,12 +402,16 @@ bool EntityMotionState::remoteSimulationOutOfSync(uint32_t simulationStep) {
         bool hasAvatarAncestor = _entity->hasAncestorOfType(NestableType::Avatar);
 
         if (ancestryIsKnown && !hasAvatarAncestor) {
-            _serverVelocity += _serverAcceleration * dt;
-            _serverVelocity *= powf(1.0f - _body->getLinearDamping(), dt);
+            // step the same way EntityItem::stepKinematicMotion() does on the receiving end: the position moves with
+            // the velocity from before the step, and the acceleration, which is in the world-frame, is applied in
+            // the parent's frame after the damping
+            glm::vec3 deltaVelocity = (powf(1.0f - _body->getLinearDamping(), dt) - 1.0f) * _serverVelocity;
+            deltaVelocity += worldVelocityToLocal.transform(_serverAcceleration) * dt;
 
             // NOTE: we ignore the second-order acceleration term when integrating
             // the position forward because Bullet also does this.
             _serverPosition += dt * _serverVelocity;
+            _serverVelocity += deltaVelocity;
         }
     }
 
@@ -41,8 +41,9 @@ public:
     // this relays incoming position/rotation to the RigidBody
     virtual void getWorldTransform(btTransform& worldTrans) const override;
 
-    // this relays outgoing position/rotation to the EntityItem
+    // this records the outgoing position/rotation, for applyOutgoingTransform() to relay to the EntityItem
     virtual void setWorldTransform(const btTransform& worldTrans) override;
+    void applyOutgoingTransform();
 
     bool isCandidateForOwnership() const;
     bool remoteSimulationOutOfSync(uint32_t simulationStep);
@@ -115,6 +116,12 @@ protected:
     glm::vec3 _serverAcceleration;
     QByteArray _serverActionData;
 
+    // outgoing state of the RigidBody, from the last synchronization of the motion states
+    btTransform _outgoingTransform;
+    glm::vec3 _outgoingVelocity;
+    glm::vec3 _outgoingAngularVelocity;
+    bool _hasOutgoingTransform { false };
+
     glm::vec3 _lastVelocity;
     glm::vec3 _measuredAcceleration;
     quint64 _nextOwnershipBid { 0 };
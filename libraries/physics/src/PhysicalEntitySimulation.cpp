@@ -61,6 +61,7 @@ void PhysicalEntitySimulation::removeEntityInternal(EntityItemPointer entity) {
         EntitySimulation::removeEntityInternal(entity);
         QMutexLocker lock(&_mutex);
         _entitiesToAddToPhysics.remove(entity);
+        _shapeInfosBeingBuilt.remove(entity);
 
         EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
         if (motionState) {
@@ -110,6 +111,7 @@ void PhysicalEntitySimulation::changeEntityInternal(EntityItemPointer entity) {
         // The intent is for this object to be in the PhysicsEngine, but it has no MotionState yet.
         // Perhaps it's shape has changed and it can now be added?
         _entitiesToAddToPhysics.insert(entity);
+        _shapeInfosBeingBuilt.remove(entity);
         _simpleKinematicEntities.remove(entity); // just in case it's non-physical-kinematic
     } else if (entity->isMovingRelativeToParent()) {
         _simpleKinematicEntities.insert(entity);
@@ -148,6 +150,7 @@ void PhysicalEntitySimulation::clearEntitiesInternal() {
     _entitiesToRemoveFromPhysics.clear();
     _entitiesToRelease.clear();
     _entitiesToAddToPhysics.clear();
+    _shapeInfosBeingBuilt.clear();
     _pendingChanges.clear();
     _outgoingChanges.clear();
 }
@@ -208,31 +211,44 @@ void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& re
         assert(!entity->getPhysicsInfo());
         if (entity->isDead()) {
             prepareEntityForDelete(entity);
+            _shapeInfosBeingBuilt.remove(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
         } else if (!entity->shouldBePhysical()) {
             // this entity should no longer be on the internal _entitiesToAddToPhysics
+            _shapeInfosBeingBuilt.remove(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
             if (entity->isMovingRelativeToParent()) {
                 _simpleKinematicEntities.insert(entity);
             }
         } else if (entity->isReadyToComputeShape()) {
+            // hulls and meshes are built in the background: keep the info of the shape while it's built
+            // rather than compute it again every frame
             ShapeInfo shapeInfo;
-            entity->computeShapeInfo(shapeInfo);
-            int numPoints = shapeInfo.getLargestSubshapePointCount();
-            if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
-                if (numPoints > MAX_HULL_POINTS) {
-                    qWarning() << "convex hull with" << numPoints
-                        << "points for entity" << entity->getName()
-                        << "at" << entity->getPosition() << " will be reduced";
+            auto shapeInfoItr = _shapeInfosBeingBuilt.find(entity);
+            if (shapeInfoItr != _shapeInfosBeingBuilt.end()) {
+                shapeInfo = shapeInfoItr.value();
+            } else {
+                entity->computeShapeInfo(shapeInfo);
+                int numPoints = shapeInfo.getLargestSubshapePointCount();
+                if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
+                    if (numPoints > MAX_HULL_POINTS) {
+                        qWarning() << "convex hull with" << numPoints
+                            << "points for entity" << entity->getName()
+                            << "at" << entity->getPosition() << " will be reduced";
+                    }
                 }
             }
-            btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
+            btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->requestShape(shapeInfo));
             if (shape) {
+                _shapeInfosBeingBuilt.remove(entity);
                 EntityMotionState* motionState = new EntityMotionState(shape, entity);
                 entity->setPhysicsInfo(static_cast<void*>(motionState));
                 _physicalObjects.insert(motionState);
                 result.push_back(motionState);
                 entityItr = _entitiesToAddToPhysics.erase(entityItr);
+            } else if (shapeInfoItr == _shapeInfosBeingBuilt.end() && shapeInfo.getType() != SHAPE_TYPE_NONE) {
+                _shapeInfosBeingBuilt.insert(entity, shapeInfo);
+                ++entityItr;
             } else {
                 //qWarning() << "Failed to generate new shape for entity." << entity->getName();
                 ++entityItr;
@@ -284,6 +300,7 @@ void PhysicalEntitySimulation::handleChangedMotionStates(const VectorOfMotionSta
             EntityMotionState* entityState = static_cast<EntityMotionState*>(state);
             EntityItemPointer entity = entityState->getEntity();
             assert(entity.get());
+            entityState->applyOutgoingTransform();
             if (entityState->isCandidateForOwnership()) {
                 _outgoingChanges.insert(entityState);
             }
@@ -328,6 +328,15 @@ void PhysicsEngine::stepSimulation() {
     }
 }
 
+void PhysicsEngine::setMultithreaded(bool multithreaded) {
+    assert(_dynamicsWorld);
+    _dynamicsWorld->setMultithreaded(multithreaded);
+}
+
+bool PhysicsEngine::isMultithreaded() const {
+    return _dynamicsWorld && _dynamicsWorld->isMultithreaded();
+}
+
 void PhysicsEngine::harvestPerformanceStats() {
     // unfortunately the full context names get too long for our stats presentation format
     //QString contextName = PerformanceTimer::getContextName(); // TODO: how to show full context name?
@@ -357,6 +366,11 @@ void PhysicsEngine::recursivelyHarvestPerformanceStats(CProfileIterator* profile
         QString childContextName = parentContextName + QString("/") + QString(profileIterator->Get_Current_Name());
         uint64_t time = (uint64_t)((btScalar)MSECS_PER_SECOND * profileIterator->Get_Current_Total_Time());
         PerformanceTimer::addTimerRecord(childContextName, time);
+        // the substeps of a step all add up in the same context, also record how long one of them took
+        int numCalls = profileIterator->Get_Current_Total_Calls();
+        if (numCalls > 1 && QString(profileIterator->Get_Current_Name()) == "substep") {
+            PerformanceTimer::addTimerRecord(childContextName + QString("/average"), time / (uint64_t)numCalls);
+        }
         profileIterator->Next();
         ++numChildren;
     }
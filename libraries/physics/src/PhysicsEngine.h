@@ -52,6 +52,8 @@ public:
     void init();
 
     uint32_t getNumSubsteps();
+    int getNumCollisionObjects() const { return _dynamicsWorld ? _dynamicsWorld->getNumCollisionObjects() : 0; }
+    size_t getNumContacts() const { return _contactMap.size(); }
 
     void removeObjects(const VectorOfMotionStates& objects);
     void removeSetOfObjects(const SetOfMotionStates& objects); // only called during teardown
@@ -62,11 +64,16 @@ public:
 
     void stepSimulation();
     void harvestPerformanceStats();
+
+    void setMultithreaded(bool multithreaded);
+    bool isMultithreaded() const;
     void updateContactMap();
 
     bool hasOutgoingChanges() const { return _hasOutgoingChanges; }
 
     /// \return reference to list of changed MotionStates.  The list is only valid until beginning of next simulation loop.
+    /// The EntityMotionStates only record their new transforms, which handleChangedMotionStates() then applies to the entities,
+    /// so this doesn't need the EntityTree lock.
     const VectorOfMotionStates& getChangedMotionStates();
     const VectorOfMotionStates& getDeactivatedMotionStates() const { return _dynamicsWorld->getDeactivatedMotionStates(); }
 
@@ -9,17 +9,47 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <functional>
+
 #include <QDebug>
+#include <QRunnable>
 
 #include <glm/gtx/norm.hpp>
 
 #include "ShapeFactory.h"
 #include "ShapeManager.h"
 
+// Hulls and meshes take long enough to build to hitch the frame, and to be worth keeping around when they are released
+static bool isExpensiveShapeType(int type) {
+    return type == SHAPE_TYPE_COMPOUND || type == SHAPE_TYPE_SIMPLE_HULL ||
+        type == SHAPE_TYPE_SIMPLE_COMPOUND || type == SHAPE_TYPE_STATIC_MESH;
+}
+
+static const int NUM_SHAPE_BUILD_THREADS = 2;
+static const size_t MAX_RETAINED_SHAPES = 64;
+
+class ShapeBuildTask : public QRunnable {
+public:
+    using Callback = std::function<void(const btCollisionShape*)>;
+
+    ShapeBuildTask(const ShapeInfo& info, Callback callback) : _info(info), _callback(callback) {}
+
+    void run() override {
+        _callback(ShapeFactory::createShapeFromInfo(_info));
+    }
+
+private:
+    ShapeInfo _info;
+    Callback _callback;
+};
+
 ShapeManager::ShapeManager() {
+    _buildThreadPool.setMaxThreadCount(NUM_SHAPE_BUILD_THREADS);
 }
 
 ShapeManager::~ShapeManager() {
+    waitForPendingShapes();
+    collectBuiltShapes();
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
@@ -32,23 +62,106 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     if (info.getType() == SHAPE_TYPE_NONE) {
         return nullptr;
     }
+    collectBuiltShapes();
     DoubleHashKey key = info.getHash();
     ShapeReference* shapeRef = _shapeMap.find(key);
     if (shapeRef) {
+        if (shapeRef->refCount == 0) {
+            unretainShape(key);
+        }
         shapeRef->refCount++;
         return shapeRef->shape;
     }
     const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
     if (shape) {
-        ShapeReference newRef;
-        newRef.refCount = 1;
-        newRef.shape = shape;
-        newRef.key = key;
-        _shapeMap.insert(key, newRef);
+        addShape(key, shape, 1, isExpensiveShapeType(info.getType()));
     }
     return shape;
 }
 
+const btCollisionShape* ShapeManager::requestShape(const ShapeInfo& info) {
+    if (!isExpensiveShapeType(info.getType())) {
+        return getShape(info);
+    }
+    collectBuiltShapes();
+    DoubleHashKey key = info.getHash();
+    if (_shapeMap.find(key)) {
+        return getShape(info);
+    }
+    if (!_pendingBuilds.find(key)) {
+        _pendingBuilds.insert(key, 0);
+        _buildThreadPool.start(new ShapeBuildTask(info, [this, key](const btCollisionShape* shape) {
+            std::lock_guard<std::mutex> lock(_builtShapesMutex);
+            _builtShapes.push_back({ key, shape });
+        }));
+    }
+    return nullptr;
+}
+
+void ShapeManager::waitForPendingShapes() {
+    _buildThreadPool.waitForDone();
+}
+
+// private helper method
+void ShapeManager::addShape(const DoubleHashKey& key, const btCollisionShape* shape, int refCount, bool isExpensive) {
+    ShapeReference newRef;
+    newRef.refCount = refCount;
+    newRef.shape = shape;
+    newRef.key = key;
+    newRef.isExpensive = isExpensive;
+    _shapeMap.insert(key, newRef);
+}
+
+// private helper method
+void ShapeManager::collectBuiltShapes() {
+    std::vector<std::pair<DoubleHashKey, const btCollisionShape*>> builtShapes;
+    {
+        std::lock_guard<std::mutex> lock(_builtShapesMutex);
+        builtShapes.swap(_builtShapes);
+    }
+    for (auto& builtShape : builtShapes) {
+        const DoubleHashKey& key = builtShape.first;
+        _pendingBuilds.remove(key);
+        if (!builtShape.second) {
+            // the next request will try again
+            continue;
+        }
+        if (_shapeMap.find(key)) {
+            // getShape() built it in the meantime
+            ShapeFactory::deleteShape(builtShape.second);
+            continue;
+        }
+        // unreferenced until requested again, so it gets collected if nobody does
+        addShape(key, builtShape.second, 0, true);
+        retainShape(key);
+    }
+}
+
+// private helper method
+void ShapeManager::retainShape(const DoubleHashKey& key) {
+    unretainShape(key);
+    _retainedShapes.push_back(key);
+    while (_retainedShapes.size() > MAX_RETAINED_SHAPES) {
+        DoubleHashKey oldestKey = _retainedShapes.front();
+        _retainedShapes.pop_front();
+        ShapeReference* shapeRef = _shapeMap.find(oldestKey);
+        if (shapeRef && shapeRef->refCount == 0) {
+            ShapeFactory::deleteShape(shapeRef->shape);
+            _shapeMap.remove(oldestKey);
+        }
+    }
+}
+
+// private helper method
+void ShapeManager::unretainShape(const DoubleHashKey& key) {
+    for (auto itr = _retainedShapes.begin(); itr != _retainedShapes.end(); ++itr) {
+        if (itr->equals(key)) {
+            _retainedShapes.erase(itr);
+            return;
+        }
+    }
+}
+
 // private helper method
 bool ShapeManager::releaseShapeByKey(const DoubleHashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
@@ -89,13 +202,29 @@ void ShapeManager::collectGarbage() {
     int numShapes = _pendingGarbage.size();
     for (int i = 0; i < numShapes; ++i) {
         DoubleHashKey& key = _pendingGarbage[i];
+        ShapeReference* shapeRef = _shapeMap.find(key);
+        if (shapeRef && shapeRef->refCount == 0) {
+            if (shapeRef->isExpensive) {
+                retainShape(key);
+            } else {
+                ShapeFactory::deleteShape(shapeRef->shape);
+                _shapeMap.remove(key);
+            }
+        }
+    }
+    _pendingGarbage.clear();
+}
+
+void ShapeManager::collectAllGarbage() {
+    collectGarbage();
+    for (auto& key : _retainedShapes) {
         ShapeReference* shapeRef = _shapeMap.find(key);
         if (shapeRef && shapeRef->refCount == 0) {
             ShapeFactory::deleteShape(shapeRef->shape);
             _shapeMap.remove(key);
         }
     }
-    _pendingGarbage.clear();
+    _retainedShapes.clear();
 }
 
 int ShapeManager::getNumReferences(const ShapeInfo& info) const {
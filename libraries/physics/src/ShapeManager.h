@@ -12,6 +12,12 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <QThreadPool>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
@@ -28,12 +34,23 @@ public:
     /// \return pointer to shape
     const btCollisionShape* getShape(const ShapeInfo& info);
 
+    /// \return pointer to shape, like getShape(), or nullptr while a hull or mesh shape is built in the background
+    /// in which case the caller should ask again later
+    const btCollisionShape* requestShape(const ShapeInfo& info);
+
     /// \return true if shape was found and released
     bool releaseShape(const btCollisionShape* shape);
 
-    /// delete shapes that have zero references
+    /// delete shapes that have zero references, but for the most recently released hull and mesh shapes
+    /// which are kept until more of them are released, in case they are needed again
     void collectGarbage();
 
+    /// delete all the shapes that have zero references
+    void collectAllGarbage();
+
+    /// wait for the shapes being built in the background
+    void waitForPendingShapes();
+
     // validation methods
     int getNumShapes() const { return _shapeMap.size(); }
     int getNumReferences(const ShapeInfo& info) const;
@@ -42,17 +59,31 @@ public:
 
 private:
     bool releaseShapeByKey(const DoubleHashKey& key);
+    void addShape(const DoubleHashKey& key, const btCollisionShape* shape, int refCount, bool isExpensive);
+    void collectBuiltShapes();
+    void retainShape(const DoubleHashKey& key);
+    void unretainShape(const DoubleHashKey& key);
 
     class ShapeReference {
     public:
         int refCount;
         const btCollisionShape* shape;
         DoubleHashKey key;
-        ShapeReference() : refCount(0), shape(nullptr) {}
+        bool isExpensive;
+        ShapeReference() : refCount(0), shape(nullptr), isExpensive(false) {}
     };
 
     btHashMap<DoubleHashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<DoubleHashKey> _pendingGarbage;
+
+    // unreferenced hull and mesh shapes that are kept, oldest first
+    std::deque<DoubleHashKey> _retainedShapes;
+
+    // shapes being built in the background, and those that are done
+    QThreadPool _buildThreadPool;
+    btHashMap<DoubleHashKey, int> _pendingBuilds;
+    std::mutex _builtShapesMutex;
+    std::vector<std::pair<DoubleHashKey, const btCollisionShape*>> _builtShapes;
 };
 
 #endif // hifi_ShapeManager_h
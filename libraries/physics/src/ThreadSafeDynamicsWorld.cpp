@@ -17,8 +17,13 @@
 
 #include <LinearMath/btQuickprof.h>
 
+#include <TBBHelpers.h>
+
 #include "ThreadSafeDynamicsWorld.h"
 
+// Below this many bodies the integration isn't worth handing out to the job pool
+static const int MIN_BODIES_PER_INTEGRATION_JOB = 64;
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
@@ -73,6 +78,7 @@ int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep
         }
 
         for (int i=0;i<clampedSimulationSteps;i++) {
+            BT_PROFILE("substep");
             internalSingleStepSimulation(fixedTimeStep);
             onSubStep();
         }
@@ -90,6 +96,27 @@ int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep
     return subSteps;
 }
 
+void ThreadSafeDynamicsWorld::predictUnconstraintMotion(btScalar timeStep) {
+    int numBodies = m_nonStaticRigidBodies.size();
+    if (!_multithreaded || numBodies < 2 * MIN_BODIES_PER_INTEGRATION_JOB) {
+        btDiscreteDynamicsWorld::predictUnconstraintMotion(timeStep);
+        return;
+    }
+
+    BT_PROFILE("predictUnconstraintMotion");
+    // Each body only reads and writes its own state here
+    tbb::parallel_for(tbb::blocked_range<int>(0, numBodies, MIN_BODIES_PER_INTEGRATION_JOB), [&](const tbb::blocked_range<int>& range) {
+        for (int i = range.begin(); i < range.end(); ++i) {
+            btRigidBody* body = m_nonStaticRigidBodies[i];
+            if (!body->isStaticOrKinematicObject()) {
+                // velocities are integrated by the constraint solver
+                body->applyDamping(timeStep);
+                body->predictIntegratedTransform(timeStep, body->getInterpolationWorldTransform());
+            }
+        }
+    });
+}
+
 // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
 void ThreadSafeDynamicsWorld::synchronizeMotionState(btRigidBody* body) {
     btAssert(body);
@@ -158,23 +185,51 @@ void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
 }
 
 void ThreadSafeDynamicsWorld::saveKinematicState(btScalar timeStep) {
-///would like to iterate over m_nonStaticRigidBodies, but unfortunately old API allows
-///to switch status _after_ adding kinematic objects to the world
-///fix it for Bullet 3.x release
+    // btDiscreteDynamicsWorld visits all the collision objects because a body could be made kinematic after it is
+    // added to the world, but the PhysicsEngine re-inserts the bodies whose motion type changes
     BT_PROFILE("saveKinematicState");
-    for (int i=0;i<m_collisionObjects.size();i++)
-    {
-        btCollisionObject* colObj = m_collisionObjects[i];
-        btRigidBody* body = btRigidBody::upcast(colObj);
-        if (body && body->getActivationState() != ISLAND_SLEEPING)
-        {
-            if (body->isKinematicObject())
-            {
-                //to calculate velocities next frame
-                body->saveKinematicState(timeStep);
-            }
+    for (int i = 0; i < m_nonStaticRigidBodies.size(); i++) {
+        btRigidBody* body = m_nonStaticRigidBodies[i];
+        if (body->isKinematicObject() && body->getActivationState() != ISLAND_SLEEPING) {
+            //to calculate velocities next frame
+            body->saveKinematicState(timeStep);
         }
     }
 }
 
+void ThreadSafeDynamicsWorld::updateAabbs() {
+    if (m_forceUpdateAllAabbs) {
+        btDiscreteDynamicsWorld::updateAabbs();
+        return;
+    }
 
+    BT_PROFILE("updateAabbs");
+    for (int i = 0; i < m_nonStaticRigidBodies.size(); i++) {
+        btRigidBody* body = m_nonStaticRigidBodies[i];
+        if (body->isActive()) {
+            updateSingleAabb(body);
+        }
+    }
+    for (int i = 0; i < _nonRigidObjects.size(); i++) {
+        btCollisionObject* object = _nonRigidObjects[i];
+        if (object->isActive()) {
+            updateSingleAabb(object);
+        }
+    }
+}
+
+void ThreadSafeDynamicsWorld::addCollisionObject(btCollisionObject* object,
+                                                 short int collisionFilterGroup, short int collisionFilterMask) {
+    btDiscreteDynamicsWorld::addCollisionObject(object, collisionFilterGroup, collisionFilterMask);
+    // the rigid bodies are tracked by btDiscreteDynamicsWorld
+    if (!btRigidBody::upcast(object)) {
+        _nonRigidObjects.push_back(object);
+    }
+}
+
+void ThreadSafeDynamicsWorld::removeCollisionObject(btCollisionObject* object) {
+    if (!btRigidBody::upcast(object)) {
+        _nonRigidObjects.remove(object);
+    }
+    btDiscreteDynamicsWorld::removeCollisionObject(object);
+}
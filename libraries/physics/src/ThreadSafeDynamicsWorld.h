@@ -43,6 +43,19 @@ public:
     virtual void synchronizeMotionStates() override;
     virtual void saveKinematicState(btScalar timeStep) override;
 
+    // Only the non-static objects are visited, most domains have many more static ones.
+    // The Aabbs of static objects that move are updated by the PhysicsEngine when they change.
+    virtual void updateAabbs() override;
+    virtual void addCollisionObject(btCollisionObject* object,
+                                    short int collisionFilterGroup = btBroadphaseProxy::DefaultFilter,
+                                    short int collisionFilterMask = btBroadphaseProxy::AllFilter) override;
+    virtual void removeCollisionObject(btCollisionObject* object) override;
+
+    // When enabled the bodies are integrated on the job pool. The collision dispatch and the constraint solver
+    // of this version of Bullet are not thread safe (nor is its profiler), so they remain on the calling thread.
+    void setMultithreaded(bool multithreaded) { _multithreaded = multithreaded; }
+    bool isMultithreaded() const { return _multithreaded; }
+
     // btDiscreteDynamicsWorld::m_localTime is the portion of real-time that has not yet been simulated
     // but is used for MotionState::setWorldTransform() extrapolation (a feature that Bullet uses to provide
     // smoother rendering of objects when the physics simulation loop is ansynchronous to the render loop).
@@ -53,6 +66,9 @@ public:
 
     void addChangedMotionState(ObjectMotionState* motionState) { _changedMotionStates.push_back(motionState); }
 
+protected:
+    virtual void predictUnconstraintMotion(btScalar timeStep) override;
+
 private:
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
@@ -61,6 +77,8 @@ private:
     VectorOfMotionStates _deactivatedStates;
     SetOfMotionStates _activeStates;
     SetOfMotionStates _lastActiveStates;
+    btAlignedObjectArray<btCollisionObject*> _nonRigidObjects; // e.g. ghost objects of the character
+    bool _multithreaded { false };
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
@@ -24,6 +24,11 @@ public:
     virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) = 0;
 
     virtual void lostFrame(QByteArray& decodedBuffer) = 0;
+
+    // Produces the frame lost right before encodedBuffer, from the redundancy encodedBuffer carries
+    // for it when the codec sends any, otherwise the loss is concealed as lostFrame() does.
+    // encodedBuffer is decoded on its own afterwards.
+    virtual void recoverFrame(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) { lostFrame(decodedBuffer); }
 };
 
 class CodecPlugin : public Plugin {
@@ -170,6 +170,10 @@ public:
     }
 
     // By default the aspect ratio is just the render size
+    // Outside of this radius, in the normalized coordinates of each eye, only half of the pixels are shaded
+    // and the others are filled in from their neighbors. 0 shades every pixel.
+    virtual float getFoveatedRadius() const { return 0.0f; }
+
     virtual float getRecommendedAspectRatio() const {
         return aspect(getRecommendedRenderSize());
     }
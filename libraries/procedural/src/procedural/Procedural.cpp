@@ -224,6 +224,12 @@ bool Procedural::ready() {
         }
     }
 
+    // Until its program is linked, the caller draws what it would without the procedural
+    updateProgram();
+    if (!_opaquePipeline || !_transparentPipeline) {
+        return false;
+    }
+
     if (!_hasStartedFade) {
         _hasStartedFade = true;
         _isFading = true;
@@ -232,10 +238,7 @@ bool Procedural::ready() {
     return true;
 }
 
-void Procedural::prepare(gpu::Batch& batch, const glm::vec3& position, const glm::vec3& size, const glm::quat& orientation) {
-    _entityDimensions = size;
-    _entityPosition = position;
-    _entityOrientation = glm::mat3_cast(orientation);
+void Procedural::updateProgram() {
     if (_shaderUrl.isLocalFile()) {
         auto lastModified = (quint64)QFileInfo(_shaderPath).lastModified().toMSecsSinceEpoch();
         if (lastModified > _shaderModified) {
@@ -249,7 +252,7 @@ void Procedural::prepare(gpu::Batch& batch, const glm::vec3& position, const glm
         _shaderSource = _networkShader->_source;
     }
 
-    if (!_opaquePipeline || !_transparentPipeline || _shaderDirty) {
+    if (_shaderDirty) {
         if (!_vertexShader) {
             _vertexShader = gpu::Shader::createVertex(_vertexSource);
         }
@@ -278,36 +281,58 @@ void Procedural::prepare(gpu::Batch& batch, const glm::vec3& position, const glm
         // qCDebug(procedural) << "FragmentShader:\n" << fragmentShaderSource.c_str();
 
         _fragmentShader = gpu::Shader::createPixel(fragmentShaderSource);
-        _shader = gpu::Shader::createProgram(_vertexShader, _fragmentShader);
 
         gpu::Shader::BindingSet slotBindings;
         slotBindings.insert(gpu::Shader::Binding(std::string("iChannel0"), 0));
         slotBindings.insert(gpu::Shader::Binding(std::string("iChannel1"), 1));
         slotBindings.insert(gpu::Shader::Binding(std::string("iChannel2"), 2));
         slotBindings.insert(gpu::Shader::Binding(std::string("iChannel3"), 3));
-        gpu::Shader::makeProgram(*_shader, slotBindings);
+        // A compilation still on its way is left to finish, and its program is dropped
+        _pendingCompilation = ProceduralProgramCompiler::compile(
+            gpu::Shader::createProgram(_vertexShader, _fragmentShader), slotBindings);
+        _shaderDirty = false;
+    }
 
-        _opaquePipeline = gpu::Pipeline::create(_shader, _opaqueState);
-        _transparentPipeline = gpu::Pipeline::create(_shader, _transparentState);
-        for (size_t i = 0; i < NUM_STANDARD_UNIFORMS; ++i) {
-            const std::string& name = STANDARD_UNIFORM_NAMES[i];
-            _standardUniformSlots[i] = _shader->getUniforms().findLocation(name);
-        }
-        _start = usecTimestampNow();
-        _frameCount = 0;
+    if (!_pendingCompilation || _pendingCompilation->state == ProceduralProgramCompiler::Pending) {
+        return;
     }
 
+    if (_pendingCompilation->state == ProceduralProgramCompiler::Failed && _opaquePipeline && _transparentPipeline) {
+        // Keep drawing with the program that last worked
+        qCWarning(procedural) << "Failed to link the procedural shader" << _shaderUrl << ", keeping the previous one";
+        _pendingCompilation.reset();
+        return;
+    }
+
+    _shader = _pendingCompilation->program;
+    _pendingCompilation.reset();
+
+    _opaquePipeline = gpu::Pipeline::create(_shader, _opaqueState);
+    _transparentPipeline = gpu::Pipeline::create(_shader, _transparentState);
+    for (size_t i = 0; i < NUM_STANDARD_UNIFORMS; ++i) {
+        const std::string& name = STANDARD_UNIFORM_NAMES[i];
+        _standardUniformSlots[i] = _shader->getUniforms().findLocation(name);
+    }
+    _start = usecTimestampNow();
+    _frameCount = 0;
+    _programChanged = true;
+}
+
+void Procedural::prepare(gpu::Batch& batch, const glm::vec3& position, const glm::vec3& size, const glm::quat& orientation) {
+    _entityDimensions = size;
+    _entityPosition = position;
+    _entityOrientation = glm::mat3_cast(orientation);
     batch.setPipeline(isFading() ? _transparentPipeline : _opaquePipeline);
 
-    if (_shaderDirty || _uniformsDirty) {
+    if (_programChanged || _uniformsDirty) {
         setupUniforms();
     }
 
-    if (_shaderDirty || _uniformsDirty || _channelsDirty) {
-        setupChannels(_shaderDirty || _uniformsDirty);
+    if (_programChanged || _uniformsDirty || _channelsDirty) {
+        setupChannels(_programChanged || _uniformsDirty);
     }
 
-    _shaderDirty = _uniformsDirty = _channelsDirty = false;
+    _programChanged = _uniformsDirty = _channelsDirty = false;
 
     for (auto lambda : _uniforms) {
         lambda(batch);
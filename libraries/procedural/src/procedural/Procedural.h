@@ -24,6 +24,8 @@
 #include <model-networking/ShaderCache.h>
 #include <model-networking/TextureCache.h>
 
+#include "ProceduralProgramCompiler.h"
+
 using UniformLambdas = std::list<std::function<void(gpu::Batch& batch)>>;
 const size_t MAX_PROCEDURAL_TEXTURE_CHANNELS{ 4 };
 
@@ -85,6 +87,7 @@ protected:
     QJsonArray _parsedChannels;
     std::atomic_bool _proceduralDataDirty;
     bool _shaderDirty { true };
+    bool _programChanged { false };
     bool _uniformsDirty { true };
     bool _channelsDirty { true };
 
@@ -97,6 +100,7 @@ protected:
     gpu::ShaderPointer _vertexShader;
     gpu::ShaderPointer _fragmentShader;
     gpu::ShaderPointer _shader;
+    ProceduralProgramCompiler::CompilationPointer _pendingCompilation;
 
     // Entity metadata
     glm::vec3 _entityDimensions;
@@ -111,6 +115,8 @@ private:
     bool parseUniforms(const QJsonObject& uniforms);
     bool parseTextures(const QJsonArray& channels);
 
+    // Picks up changes to the shader source, and the program of a finished compilation
+    void updateProgram();
     void setupUniforms();
     void setupChannels(bool shouldCreate);
 
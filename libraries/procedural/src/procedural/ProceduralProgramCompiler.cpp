@@ -0,0 +1,139 @@
+//
+//  ProceduralProgramCompiler.cpp
+//  libraries/procedural/src/procedural
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ProceduralProgramCompiler.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QSurface>
+
+#include <gl/Config.h>
+#include <gl/OffscreenGLCanvas.h>
+
+#include "Logging.h"
+
+using CompilationPointer = ProceduralProgramCompiler::CompilationPointer;
+
+namespace {
+
+class CompilerThread : public QThread {
+public:
+    CompilerThread(OffscreenGLCanvas* canvas) : _canvas(canvas) {
+        setObjectName("ProceduralProgramCompiler");
+    }
+
+    void enqueue(const CompilationPointer& compilation) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(compilation);
+        }
+        _condition.notify_one();
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _isStopping = true;
+        }
+        _condition.notify_one();
+        wait();
+    }
+
+protected:
+    void run() override {
+        if (!_canvas->makeCurrent()) {
+            qCWarning(procedural) << "Failed to make the procedural program compiler context current";
+        }
+
+        while (true) {
+            CompilationPointer compilation;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this] { return _isStopping || !_queue.empty(); });
+                if (_isStopping) {
+                    break;
+                }
+                compilation = _queue.front();
+                _queue.pop_front();
+            }
+
+            bool isLinked = gpu::Shader::makeProgram(*compilation->program, compilation->bindings);
+            // the program is used from another context, it has to be all there before that one is told about it
+            glFinish();
+            compilation->state = isLinked ? ProceduralProgramCompiler::Succeeded : ProceduralProgramCompiler::Failed;
+        }
+
+        _canvas->doneCurrent();
+    }
+
+private:
+    OffscreenGLCanvas* _canvas;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<CompilationPointer> _queue;
+    bool _isStopping { false };
+};
+
+// made the first time a program is compiled with a context current, and stopped when the application quits
+CompilerThread* getCompilerThread() {
+    static CompilerThread* compilerThread { nullptr };
+    static bool isCreated { false };
+    if (isCreated) {
+        return compilerThread;
+    }
+
+    QOpenGLContext* currentContext = QOpenGLContext::currentContext();
+    if (!currentContext || !qApp) {
+        return nullptr;
+    }
+    isCreated = true;
+
+    QSurface* currentSurface = currentContext->surface();
+    // left to the end of the process, its context can't be made current again to go away once the thread is gone
+    auto canvas = new OffscreenGLCanvas();
+    canvas->setObjectName("ProceduralProgramCompilerContext");
+    bool isCanvasCreated = canvas->create(currentContext);
+    // creating a context shared with the current one leaves no context current
+    currentContext->makeCurrent(currentSurface);
+    if (!isCanvasCreated) {
+        qCWarning(procedural) << "Failed to create a context to compile procedural programs with, compiling them in place";
+        return nullptr;
+    }
+
+    compilerThread = new CompilerThread(canvas);
+    canvas->moveToThreadWithContext(compilerThread);
+    compilerThread->start();
+    QObject::connect(qApp, &QCoreApplication::aboutToQuit, [] {
+        compilerThread->stop();
+    });
+    return compilerThread;
+}
+
+}
+
+CompilationPointer ProceduralProgramCompiler::compile(const gpu::ShaderPointer& program,
+                                                      const gpu::Shader::BindingSet& bindings) {
+    auto compilation = std::make_shared<Compilation>();
+    compilation->program = program;
+    compilation->bindings = bindings;
+
+    auto compilerThread = getCompilerThread();
+    if (compilerThread && compilerThread->isRunning()) {
+        compilerThread->enqueue(compilation);
+    } else {
+        compilation->state = gpu::Shader::makeProgram(*program, bindings) ? Succeeded : Failed;
+    }
+    return compilation;
+}
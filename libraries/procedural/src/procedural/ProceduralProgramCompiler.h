@@ -0,0 +1,43 @@
+//
+//  ProceduralProgramCompiler.h
+//  libraries/procedural/src/procedural
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_ProceduralProgramCompiler_h
+#define hifi_ProceduralProgramCompiler_h
+
+#include <atomic>
+#include <memory>
+
+#include <gpu/Shader.h>
+
+// Compiles and links the programs of procedurals on a thread of its own, with a GL context shared with the one
+// current on the thread that asks for them, so that a new or edited shader doesn't stall the frame it shows up in.
+//
+// The program of a compilation isn't to be used before its state is no longer Pending. Without a current context to
+// share with, a program is made on the spot and its compilation is done when it is returned.
+class ProceduralProgramCompiler {
+public:
+    enum State {
+        Pending,
+        Succeeded,
+        Failed
+    };
+
+    struct Compilation {
+        gpu::ShaderPointer program;
+        gpu::Shader::BindingSet bindings;
+        std::atomic<int> state { Pending };
+    };
+    using CompilationPointer = std::shared_ptr<Compilation>;
+
+    static CompilationPointer compile(const gpu::ShaderPointer& program, const gpu::Shader::BindingSet& bindings);
+};
+
+#endif // hifi_ProceduralProgramCompiler_h
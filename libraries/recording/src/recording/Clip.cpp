@@ -13,6 +13,12 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/PointerClip.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <vector>
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -55,25 +61,16 @@ float Clip::position() const {
 }
 
 // FIXME move to frame?
-bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
-    if (frame.type == Frame::TYPE_INVALID) {
-        qWarning() << "Attempting to write invalid frame";
-        return true;
-    }
-
-    auto written = output.write((char*)&(frame.type), sizeof(FrameType));
+static bool writeFrameData(QIODevice& output, FrameType type, Frame::Time timeOffset, const QByteArray& frameData) {
+    auto written = output.write((char*)&type, sizeof(FrameType));
     if (written != sizeof(FrameType)) {
         return false;
     }
-    //qDebug(recordingLog) << "Writing frame with time offset " << frame.timeOffset;
-    written = output.write((char*)&(frame.timeOffset), sizeof(Frame::Time));
+    //qDebug(recordingLog) << "Writing frame with time offset " << timeOffset;
+    written = output.write((char*)&timeOffset, sizeof(Frame::Time));
     if (written != sizeof(Frame::Time)) {
         return false;
     }
-    QByteArray frameData = frame.data;
-    if (compressed) {
-        frameData = qCompress(frameData);
-    }
 
     uint16_t dataSize = frameData.size();
     written = output.write((char*)&dataSize, sizeof(FrameSize));
@@ -92,6 +89,14 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
 
 const QString Clip::FRAME_TYPE_MAP = QStringLiteral("frameTypes");
 const QString Clip::FRAME_COMREPSSION_FLAG = QStringLiteral("compressed");
+const QString Clip::FRAME_DELTAS = QStringLiteral("frameDeltas");
+const QString Clip::FRAME_INDEX = QStringLiteral("frameIndex");
+const QString Clip::FRAME_COUNT = QStringLiteral("frameCount");
+const QString Clip::FRAME_DURATION = QStringLiteral("frameDuration");
+
+// the index has an entry every few frames, and no more entries than fit in the header frame
+static const size_t MIN_FRAMES_PER_INDEX_ENTRY = 64;
+static const size_t MAX_FRAME_INDEX_ENTRIES = 2048;
 
 bool Clip::write(QIODevice& output) {
     auto frameTypes = Frame::getFrameTypes();
@@ -100,20 +105,83 @@ bool Clip::write(QIODevice& output) {
         frameTypeObj[frameTypeName] = frameTypes[frameTypeName];
     }
 
+    // Compress the frames first, so that the header can index where they are
+    struct CompressedFrame {
+        FrameType type;
+        Frame::Time timeOffset;
+        QByteArray data;
+    };
+    std::vector<CompressedFrame> frames;
+    QByteArray index;
+
+    // Most of a frame is the same as the previous frame of its type, so frames are stored as the difference
+    // to it (see PointerFrameEncoding). The first frame of each type after an index entry is stored whole,
+    // so that playback can start from any entry.
+    struct PreviousFrame {
+        quint64 dataOffset;
+        QByteArray data;
+    };
+    std::map<FrameType, PreviousFrame> previousFrames;
+
+    size_t framesPerEntry = std::max(MIN_FRAMES_PER_INDEX_ENTRY,
+        (frameCount() + MAX_FRAME_INDEX_ENTRIES - 1) / MAX_FRAME_INDEX_ENTRIES);
+    quint64 fileOffset = 0;
+
+    seek(0);
+
+    for (auto frame = nextFrame(); frame; frame = nextFrame()) {
+        if (frame->type == Frame::TYPE_INVALID) {
+            qWarning() << "Attempting to write invalid frame";
+            continue;
+        }
+
+        if (frames.size() % framesPerEntry == 0) {
+            PointerFrameIndexEntry entry { frame->timeOffset, (quint32)frames.size(), fileOffset };
+            index.append((const char*)&entry, sizeof(PointerFrameIndexEntry));
+            previousFrames.clear();
+        }
+
+        quint64 dataOffset = fileOffset + PointerClip::MINIMUM_FRAME_SIZE;
+        QByteArray encodedData;
+        auto previousFrame = previousFrames.find(frame->type);
+        if (previousFrame != previousFrames.end() && previousFrame->second.data.size() == frame->data.size()) {
+            encodedData.append((char)PointerFrameEncoding::DELTA_FRAME);
+            quint32 distance = (quint32)(dataOffset - previousFrame->second.dataOffset);
+            encodedData.append((const char*)&distance, sizeof(distance));
+            QByteArray delta = frame->data;
+            xorFrameData(delta, previousFrame->second.data);
+            encodedData.append(delta);
+        } else {
+            encodedData.append((char)PointerFrameEncoding::KEY_FRAME);
+            encodedData.append(frame->data);
+        }
+        previousFrames[frame->type] = { dataOffset, frame->data };
+
+        frames.push_back({ frame->type, frame->timeOffset, qCompress(encodedData) });
+        fileOffset = dataOffset + frames.back().data.size();
+    }
+
     QJsonObject rootObject;
     rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
     // Always mark new files as compressed
     rootObject.insert(FRAME_COMREPSSION_FLAG, true);
+    rootObject.insert(FRAME_DELTAS, true);
+    rootObject.insert(FRAME_COUNT, (double)frames.size());
+    rootObject.insert(FRAME_DURATION, frames.empty() ? 0.0 : (double)frames.back().timeOffset);
+    rootObject.insert(FRAME_INDEX, QString::fromLatin1(index.toBase64()));
     QByteArray headerFrameData = QJsonDocument(rootObject).toBinaryData();
+    if (headerFrameData.size() > std::numeric_limits<FrameSize>::max()) {
+        // without the index, readers parse all of the frames up front
+        rootObject.remove(FRAME_INDEX);
+        headerFrameData = QJsonDocument(rootObject).toBinaryData();
+    }
     // Never compress the header frame
-    if (!writeFrame(output, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }), false)) {
+    if (!writeFrameData(output, Frame::TYPE_HEADER, 0, headerFrameData)) {
         return false;
     }
 
-    seek(0);
-
-    for (auto frame = nextFrame(); frame; frame = nextFrame()) {
-        if (!writeFrame(output, *frame)) {
+    for (const auto& frame : frames) {
+        if (!writeFrameData(output, frame.type, frame.timeOffset, frame.data)) {
             return false;
         }
     }
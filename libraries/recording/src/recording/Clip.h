@@ -56,6 +56,12 @@ public:
     
     static const QString FRAME_TYPE_MAP;
     static const QString FRAME_COMREPSSION_FLAG;
+    // frames are stored as keyframes and deltas, see PointerFrameEncoding
+    static const QString FRAME_DELTAS;
+    // a sparse index of the frame times and where the frames are, see PointerFrameIndexEntry
+    static const QString FRAME_INDEX;
+    static const QString FRAME_COUNT;
+    static const QString FRAME_DURATION;
 
 protected:
     friend class WrapperClip;
@@ -45,26 +45,29 @@ FrameTranslationMap parseTranslationMap(const QJsonDocument& doc) {
 }
 
 
+// Parses the header of the frame at offset, returns false at the end of the data or if the frame is truncated
+static bool parseFrameHeader(const uchar* const start, const size_t& size, quint64 offset, PointerFrameHeader& header) {
+    if (offset > size || size - offset < (size_t)PointerClip::MINIMUM_FRAME_SIZE) {
+        return false;
+    }
+    auto current = start + offset;
+    memcpy(&(header.type), current, sizeof(FrameType));
+    current += sizeof(FrameType);
+    memcpy(&(header.timeOffset), current, sizeof(Frame::Time));
+    current += sizeof(Frame::Time);
+    memcpy(&(header.size), current, sizeof(FrameSize));
+    current += sizeof(FrameSize);
+    header.fileOffset = current - start;
+    return size - header.fileOffset >= header.size;
+}
+
 PointerFrameHeaderList parseFrameHeaders(uchar* const start, const size_t& size) {
     PointerFrameHeaderList results;
-    auto current = start;
-    auto end = current + size;
+    quint64 offset = 0;
     // Read all the frame headers
-    // FIXME move to Frame::readHeader?
-    while (end - current >= PointerClip::MINIMUM_FRAME_SIZE) {
-        PointerFrameHeader header;
-        memcpy(&(header.type), current, sizeof(FrameType));
-        current += sizeof(FrameType);
-        memcpy(&(header.timeOffset), current, sizeof(Frame::Time));
-        current += sizeof(Frame::Time);
-        memcpy(&(header.size), current, sizeof(FrameSize));
-        current += sizeof(FrameSize);
-        header.fileOffset = current - start;
-        if (end - current < header.size) {
-            current = end;
-            break;
-        }
-        current += header.size;
+    PointerFrameHeader header;
+    while (parseFrameHeader(start, size, offset, header)) {
+        offset = header.fileOffset + header.size;
         results.push_back(header);
     }
     qDebug(recordingLog) << "Parsed source data into " << results.size() << " frames";
@@ -80,6 +83,16 @@ void PointerClip::reset() {
     _data = nullptr;
     _size = 0;
     _header = QJsonDocument();
+    _translationMap.clear();
+    _isIndexed = false;
+    _index.clear();
+    _indexedFrameCount = 0;
+    _indexedDuration = 0;
+    _frameIndex = 0;
+    _cursorOffset = 0;
+    _isCursorValid = false;
+    _hasDeltas = false;
+    _decodedFrames.clear();
 }
 
 void PointerClip::init(uchar* data, size_t size) {
@@ -88,24 +101,20 @@ void PointerClip::init(uchar* data, size_t size) {
     _data = data;
     _size = size;
 
-    auto parsedFrameHeaders = parseFrameHeaders(data, size);
-    // Verify that at least one frame exists and that the first frame is a header
-    if (0 == parsedFrameHeaders.size()) {
+    // Grab the file header, which has to be the first frame
+    PointerFrameHeader fileHeaderFrameHeader;
+    if (!parseFrameHeader(data, size, 0, fileHeaderFrameHeader)) {
         qWarning() << "No frames found, invalid file";
         reset();
         return;
     }
+    if (fileHeaderFrameHeader.type != Frame::TYPE_HEADER) {
+        qWarning() << "Missing header frame, invalid file";
+        reset();
+        return;
+    }
 
-    // Grab the file header
     {
-        auto fileHeaderFrameHeader = *parsedFrameHeaders.begin();
-        parsedFrameHeaders.pop_front();
-        if (fileHeaderFrameHeader.type != Frame::TYPE_HEADER) {
-            qWarning() << "Missing header frame, invalid file";
-            reset();
-            return;
-        }
-
         QByteArray fileHeaderData((char*)_data + fileHeaderFrameHeader.fileOffset, fileHeaderFrameHeader.size);
         _header = QJsonDocument::fromBinaryData(fileHeaderData);
     }
@@ -113,48 +122,254 @@ void PointerClip::init(uchar* data, size_t size) {
     // Check for compression
     {
         _compressed = _header.object()[FRAME_COMREPSSION_FLAG].toBool();
+        _hasDeltas = _header.object()[FRAME_DELTAS].toBool();
     }
 
-    // Find the type enum translation map and fix up the frame headers
-    {
-        FrameTranslationMap translationMap = parseTranslationMap(_header);
-        if (translationMap.empty()) {
-            qWarning() << "Header missing frame type map, invalid file";
-            reset();
-            return;
-        }
+    // Find the type enum translation map
+    _translationMap = parseTranslationMap(_header);
+    if (_translationMap.empty()) {
+        qWarning() << "Header missing frame type map, invalid file";
+        reset();
+        return;
+    }
 
+    // An indexed clip is read as it is played
+    quint64 firstFrameOffset = fileHeaderFrameHeader.fileOffset + fileHeaderFrameHeader.size;
+    if (initIndex(firstFrameOffset)) {
+        return;
+    }
+
+    auto parsedFrameHeaders = parseFrameHeaders(data + firstFrameOffset, size - firstFrameOffset);
+
+    // Fix up the frame headers
+    {
         // Update the loaded headers with the frame data
         _frames.reserve(parsedFrameHeaders.size());
         for (auto& frameHeader : parsedFrameHeaders) {
-            if (!translationMap.contains(frameHeader.type)) {
+            if (!_translationMap.contains(frameHeader.type)) {
                 continue;
             }
-            frameHeader.type = translationMap[frameHeader.type];
+            frameHeader.type = _translationMap[frameHeader.type];
+            frameHeader.fileOffset += firstFrameOffset;
             _frames.push_back(frameHeader);
         }
     }
 
 }
 
-// Internal only function, needs no locking
+bool PointerClip::initIndex(quint64 firstFrameOffset) {
+    auto headerObj = _header.object();
+    if (!headerObj.contains(FRAME_INDEX)) {
+        return false;
+    }
+
+    QByteArray indexData = QByteArray::fromBase64(headerObj[FRAME_INDEX].toString().toLatin1());
+    auto entries = reinterpret_cast<const PointerFrameIndexEntry*>(indexData.constData());
+    size_t numEntries = indexData.size() / sizeof(PointerFrameIndexEntry);
+    if (numEntries == 0) {
+        qWarning() << "Empty frame index, reading all the frames";
+        return false;
+    }
+
+    _index.reserve(numEntries);
+    for (size_t i = 0; i < numEntries; ++i) {
+        PointerFrameIndexEntry entry;
+        memcpy(&entry, entries + i, sizeof(PointerFrameIndexEntry));
+        entry.fileOffset += firstFrameOffset;
+        if (entry.fileOffset >= _size || (!_index.empty() && entry.timeOffset < _index.back().timeOffset)) {
+            qWarning() << "Invalid frame index, reading all the frames";
+            _index.clear();
+            return false;
+        }
+        _index.push_back(entry);
+    }
+
+    _isIndexed = true;
+    _indexedFrameCount = (size_t)headerObj[FRAME_COUNT].toDouble();
+    _indexedDuration = (Frame::Time)headerObj[FRAME_DURATION].toDouble();
+    qDebug(recordingLog) << "Indexed" << _indexedFrameCount << "frames with" << _index.size() << "entries";
+
+    _frameIndex = 0;
+    _cursorOffset = _index.front().fileOffset;
+    loadCursor();
+    return true;
+}
+
+// Internal only functions, need no locking
+void PointerClip::loadCursor() const {
+    while ((_isCursorValid = parseFrameHeader(_data, _size, _cursorOffset, _cursor))) {
+        if (_translationMap.contains(_cursor.type)) {
+            _cursor.type = _translationMap[_cursor.type];
+            return;
+        }
+        // frames of unknown types are skipped, as they are when the clip is not indexed
+        _cursorOffset = _cursor.fileOffset + _cursor.size;
+        ++_frameIndex;
+    }
+}
+
+void PointerClip::advanceCursor() const {
+    if (_isCursorValid) {
+        _cursorOffset = _cursor.fileOffset + _cursor.size;
+        ++_frameIndex;
+        loadCursor();
+    }
+}
+
 FrameConstPointer PointerClip::readFrame(size_t frameIndex) const {
-    FramePointer result;
     if (frameIndex < _frames.size()) {
-        result = std::make_shared<Frame>();
-        const auto& header = _frames[frameIndex];
-        result->type = header.type;
-        result->timeOffset = header.timeOffset;
-        if (header.size) {
-            result->data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
-            if (_compressed) {
-                result->data = qUncompress(result->data);
-            }
+        return readFrame(_frames[frameIndex]);
+    }
+    return FrameConstPointer();
+}
+
+FrameConstPointer PointerClip::readFrame(const PointerFrameHeader& header) const {
+    FramePointer result = std::make_shared<Frame>();
+    result->type = header.type;
+    result->timeOffset = header.timeOffset;
+    result->data = readFrameData(header);
+    return result;
+}
+
+QByteArray PointerClip::readFrameData(const PointerFrameHeader& header) const {
+    QByteArray data;
+    if (header.size) {
+        data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
+        if (_compressed) {
+            data = qUncompress(data);
+        }
+    }
+    if (!_hasDeltas || data.isEmpty()) {
+        return data;
+    }
+
+    auto encoding = (PointerFrameEncoding)data.at(0);
+    if (encoding == PointerFrameEncoding::KEY_FRAME) {
+        data.remove(0, 1);
+    } else {
+        const int DELTA_HEADER_SIZE = 1 + sizeof(quint32);
+        quint32 distance = 0;
+        if (data.size() >= DELTA_HEADER_SIZE) {
+            memcpy(&distance, data.constData() + 1, sizeof(quint32));
+        }
+        data.remove(0, DELTA_HEADER_SIZE);
+
+        // the previous frame is usually the last one read, otherwise its chain is read back to its keyframe
+        PointerFrameHeader previousHeader;
+        quint64 previousOffset = header.fileOffset - distance;
+        auto decodedFrame = _decodedFrames.find(header.type);
+        if (decodedFrame != _decodedFrames.end() && decodedFrame->second.fileOffset == previousOffset) {
+            xorFrameData(data, decodedFrame->second.data);
+        } else if (distance > PointerClip::MINIMUM_FRAME_SIZE &&
+                distance <= header.fileOffset - PointerClip::MINIMUM_FRAME_SIZE &&
+                parseFrameHeader(_data, _size, previousOffset - PointerClip::MINIMUM_FRAME_SIZE, previousHeader)) {
+            previousHeader.type = header.type;
+            xorFrameData(data, readFrameData(previousHeader));
+        } else {
+            qCWarning(recordingLog) << "Missing the previous frame of a delta frame";
+        }
+    }
+
+    _decodedFrames[header.type] = { header.fileOffset, data };
+    return data;
+}
+
+float PointerClip::duration() const {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        return ArrayClip::duration();
+    }
+    return Frame::frameTimeToSeconds(_indexedDuration);
+}
+
+size_t PointerClip::frameCount() const {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        return ArrayClip::frameCount();
+    }
+    return _indexedFrameCount;
+}
+
+Clip::Pointer PointerClip::duplicate() const {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        return ArrayClip::duplicate();
+    }
+
+    auto result = newClip();
+    PointerFrameHeader header;
+    for (quint64 offset = _index.front().fileOffset; parseFrameHeader(_data, _size, offset, header);
+            offset = header.fileOffset + header.size) {
+        if (_translationMap.contains(header.type)) {
+            header.type = _translationMap[header.type];
+            result->addFrame(readFrame(header));
+        }
+    }
+    return result;
+}
+
+void PointerClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        ArrayClip::seekFrameTime(offset);
+        return;
+    }
+
+    // start from the last entry before the offset, the frames up to the next entry are scanned
+    auto itr = std::lower_bound(_index.begin(), _index.end(), offset,
+        [](const PointerFrameIndexEntry& a, Frame::Time b)->bool {
+            return a.timeOffset < b;
         }
+    );
+    if (itr != _index.begin()) {
+        --itr;
+    }
+    _frameIndex = itr->frameNumber;
+    _cursorOffset = itr->fileOffset;
+    loadCursor();
+    while (_isCursorValid && _cursor.timeOffset < offset) {
+        advanceCursor();
+    }
+}
+
+Frame::Time PointerClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        return ArrayClip::positionFrameTime();
+    }
+    return _isCursorValid ? _cursor.timeOffset : Frame::INVALID_TIME;
+}
+
+FrameConstPointer PointerClip::peekFrame() const {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        return ArrayClip::peekFrame();
+    }
+    return _isCursorValid ? readFrame(_cursor) : FrameConstPointer();
+}
+
+FrameConstPointer PointerClip::nextFrame() {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        return ArrayClip::nextFrame();
+    }
+    FrameConstPointer result;
+    if (_isCursorValid) {
+        result = readFrame(_cursor);
+        advanceCursor();
     }
     return result;
 }
 
+void PointerClip::skipFrame() {
+    Locker lock(_mutex);
+    if (!_isIndexed) {
+        ArrayClip::skipFrame();
+        return;
+    }
+    advanceCursor();
+}
+
 void PointerClip::addFrame(FrameConstPointer) {
     throw std::runtime_error("Pointer clips are read only, use duplicate to create a read/write clip");
 }
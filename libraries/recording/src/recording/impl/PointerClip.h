@@ -12,23 +12,53 @@
 
 #include "ArrayClip.h"
 
+#include <algorithm>
+#include <map>
 #include <mutex>
 
+#include <QtCore/QByteArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
 
 #include "../Frame.h"
 
 namespace recording {
 
 struct PointerFrameHeader : public FrameHeader {
-    FrameType type;
-    Frame::Time timeOffset;
     uint16_t size;
     quint64 fileOffset;
 };
 
 using PointerFrameHeaderList = std::list<PointerFrameHeader>;
 
+// In clips with FRAME_DELTAS, the (uncompressed) data of a frame starts with its encoding:
+//    KEY_FRAME, the data
+//    DELTA_FRAME, the distance back to the data of the previous frame of the type (quint32),
+//        the data XOR the data of that frame (which has the same size)
+enum class PointerFrameEncoding : uint8_t {
+    KEY_FRAME = 0,
+    DELTA_FRAME = 1
+};
+
+inline void xorFrameData(QByteArray& data, const QByteArray& reference) {
+    char* bytes = data.data();
+    const char* referenceBytes = reference.constData();
+    int size = std::min(data.size(), reference.size());
+    for (int i = 0; i < size; ++i) {
+        bytes[i] ^= referenceBytes[i];
+    }
+}
+
+// An entry of the sparse frame index stored in the header of a clip, see Clip::write
+struct PointerFrameIndexEntry {
+    Frame::Time timeOffset;
+    quint32 frameNumber;
+    quint64 fileOffset; // of the frame, from the end of the header frame
+};
+
+// A clip read in place from its data.
+// If the header carries a frame index, only the frame at the play position is parsed, and seeks start
+// from the nearest index entry. Otherwise the headers of all the frames are parsed up front.
 class PointerClip : public ArrayClip<PointerFrameHeader> {
 public:
     using Pointer = std::shared_ptr<PointerClip>;
@@ -42,15 +72,52 @@ public:
         return _header;
     }
 
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+    virtual Clip::Pointer duplicate() const override;
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+
     // FIXME move to frame?
     static const qint64 MINIMUM_FRAME_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
 protected:
     void reset() override;
     virtual FrameConstPointer readFrame(size_t index) const override;
+    FrameConstPointer readFrame(const PointerFrameHeader& header) const;
+    QByteArray readFrameData(const PointerFrameHeader& header) const;
     QJsonDocument _header;
     uchar* _data { nullptr };
     size_t _size { 0 };
     bool _compressed { true };
+    bool _hasDeltas { false };
+
+private:
+    bool initIndex(quint64 firstFrameOffset);
+    // parses the frame at the cursor offset, skipping frames of unknown types
+    void loadCursor() const;
+    void advanceCursor() const;
+
+    QMap<FrameType, FrameType> _translationMap;
+
+    bool _isIndexed { false };
+    std::vector<PointerFrameIndexEntry> _index;
+    size_t _indexedFrameCount { 0 };
+    Frame::Time _indexedDuration { 0 };
+
+    // the frame at the play position of an indexed clip (_frameIndex is its number)
+    mutable quint64 _cursorOffset { 0 };
+    mutable PointerFrameHeader _cursor;
+    mutable bool _isCursorValid { false };
+
+    // the last frame read of each type, which the next one is usually a delta to
+    struct DecodedFrame {
+        quint64 fileOffset;
+        QByteArray data;
+    };
+    mutable std::map<FrameType, DecodedFrame> _decodedFrames;
 };
 
 }
@@ -16,6 +16,7 @@
 
 
 #include <PathUtils.h>
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <gpu/Context.h>
 #include <gpu/StandardShaderLib.h>
@@ -33,6 +34,7 @@
 #include "ssao_debugOcclusion_frag.h"
 #include "ssao_makeHorizontalBlur_frag.h"
 #include "ssao_makeVerticalBlur_frag.h"
+#include "ssao_temporalAccumulation_frag.h"
 
 
 AmbientOcclusionFramebuffer::AmbientOcclusionFramebuffer() {
@@ -63,6 +65,11 @@ void AmbientOcclusionFramebuffer::clear() {
     _occlusionTexture.reset();
     _occlusionBlurredFramebuffer.reset();
     _occlusionBlurredTexture.reset();
+    for (int i = 0; i < 2; i++) {
+        _occlusionHistoryFramebuffers[i].reset();
+        _occlusionHistoryTextures[i].reset();
+    }
+    _isHistoryValid = false;
 }
 
 gpu::TexturePointer AmbientOcclusionFramebuffer::getLinearDepthTexture() {
@@ -81,6 +88,13 @@ void AmbientOcclusionFramebuffer::allocate() {
     _occlusionBlurredTexture = gpu::Texture::createRenderBuffer(gpu::Element::COLOR_RGBA_32, width, height, gpu::Texture::SINGLE_MIP, gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_LINEAR_MIP_POINT));
     _occlusionBlurredFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create("occlusionBlurred"));
     _occlusionBlurredFramebuffer->setRenderBuffer(0, _occlusionBlurredTexture);
+
+    for (int i = 0; i < 2; i++) {
+        _occlusionHistoryTextures[i] = gpu::Texture::createRenderBuffer(gpu::Element::COLOR_RGBA_32, width, height, gpu::Texture::SINGLE_MIP, gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT));
+        _occlusionHistoryFramebuffers[i] = gpu::FramebufferPointer(gpu::Framebuffer::create("occlusionHistory"));
+        _occlusionHistoryFramebuffers[i]->setRenderBuffer(0, _occlusionHistoryTextures[i]);
+    }
+    _isHistoryValid = false;
 }
 
 gpu::FramebufferPointer AmbientOcclusionFramebuffer::getOcclusionFramebuffer() {
@@ -111,6 +125,20 @@ gpu::TexturePointer AmbientOcclusionFramebuffer::getOcclusionBlurredTexture() {
     return _occlusionBlurredTexture;
 }
 
+gpu::FramebufferPointer AmbientOcclusionFramebuffer::getOcclusionHistoryFramebuffer(int index) {
+    if (!_occlusionHistoryFramebuffers[index]) {
+        allocate();
+    }
+    return _occlusionHistoryFramebuffers[index];
+}
+
+gpu::TexturePointer AmbientOcclusionFramebuffer::getOcclusionHistoryTexture(int index) {
+    if (!_occlusionHistoryTextures[index]) {
+        allocate();
+    }
+    return _occlusionHistoryTextures[index];
+}
+
 
 class GaussianDistribution {
 public:
@@ -172,6 +200,13 @@ const int AmbientOcclusionEffect_ParamsSlot = 1;
 const int AmbientOcclusionEffect_CameraCorrectionSlot = 2;
 const int AmbientOcclusionEffect_LinearDepthMapSlot = 0;
 const int AmbientOcclusionEffect_OcclusionMapSlot = 0;
+const int AmbientOcclusionEffect_OcclusionHistoryMapSlot = 1;
+
+// in temporal mode a frame takes this fraction of the samples, its weight in the history
+static const int TEMPORAL_SAMPLES_DIVIDER = 4;
+static const float TEMPORAL_WEIGHT = 0.25f;
+// rotation of the sampling spiral from one frame to the next, close to the golden angle
+static const float TEMPORAL_SPIRAL_ROTATION = 2.4f;
 
 AmbientOcclusionEffect::AmbientOcclusionEffect() {
 }
@@ -216,10 +251,12 @@ void AmbientOcclusionEffect::configure(const Config& config) {
         current.z = config.numSpiralTurns;
     }
 
-    if (config.numSamples != _parametersBuffer->getNumSamples()) {
+    _isTemporalEnabled = config.temporalEnabled;
+    int numSamples = _isTemporalEnabled ? std::max(1, config.numSamples / TEMPORAL_SAMPLES_DIVIDER) : config.numSamples;
+    if (numSamples != _parametersBuffer->getNumSamples()) {
         auto& current = _parametersBuffer.edit().sampleInfo;
-        current.x = config.numSamples;
-        current.y = 1.0f / config.numSamples;
+        current.x = numSamples;
+        current.y = 1.0f / numSamples;
     }
 
     if (config.fetchMipsEnabled != _parametersBuffer->isFetchMipsEnabled()) {
@@ -333,6 +370,30 @@ const gpu::PipelinePointer& AmbientOcclusionEffect::getVBlurPipeline() {
     return _vBlurPipeline;
 }
 
+const gpu::PipelinePointer& AmbientOcclusionEffect::getTemporalPipeline() {
+    if (!_temporalPipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawViewportQuadTransformTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(ssao_temporalAccumulation_frag));
+        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("deferredFrameTransformBuffer"), AmbientOcclusionEffect_FrameTransformSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("cameraCorrectionBuffer"), AmbientOcclusionEffect_CameraCorrectionSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("ambientOcclusionParamsBuffer"), AmbientOcclusionEffect_ParamsSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("occlusionMap"), AmbientOcclusionEffect_OcclusionMapSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("occlusionHistoryMap"), AmbientOcclusionEffect_OcclusionHistoryMapSlot));
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        gpu::StatePointer state = gpu::StatePointer(new gpu::State());
+
+        state->setColorWriteMask(true, true, true, false);
+
+        // Good to go add the brand new pipeline
+        _temporalPipeline = gpu::Pipeline::create(program, state);
+    }
+    return _temporalPipeline;
+}
+
 void AmbientOcclusionEffect::updateGaussianDistribution() {
     auto coefs = _parametersBuffer.edit()._gaussianCoefs;
     GaussianDistribution::evalSampling(coefs, Parameters::GAUSSIAN_COEFS_LENGTH, _parametersBuffer->getBlurRadius(), _parametersBuffer->getBlurDeviation());
@@ -365,10 +426,37 @@ void AmbientOcclusionEffect::run(const render::RenderContextPointer& renderConte
     }
 
     _framebuffer->updateLinearDepth(linearDepthTexture);
+
+    bool isTemporal = _isTemporalEnabled;
+    if (isTemporal) {
+        // a new spiral every frame, so the history averages many more samples than a frame takes
+        ++_frameCount;
+        _parametersBuffer.edit().ditheringInfo.y = fmodf((float)_frameCount * TEMPORAL_SPIRAL_ROTATION, TWO_PI);
+
+        // the first frame only fills the history
+        float weight = _framebuffer->isHistoryValid() ? TEMPORAL_WEIGHT : 1.0f;
+        if (weight != _parametersBuffer->getTemporalWeight()) {
+            _parametersBuffer.edit().blurInfo.w = weight;
+        }
+    } else {
+        _framebuffer->setHistoryValid(false);
+        if (_parametersBuffer->ditheringInfo.y != 0.0f || _parametersBuffer->getTemporalWeight() != 0.0f) {
+            _parametersBuffer.edit().ditheringInfo.y = 0.0f;
+            _parametersBuffer.edit().blurInfo.w = 0.0f;
+        }
+    }
   
     
     auto occlusionFBO = _framebuffer->getOcclusionFramebuffer();
     auto occlusionBlurredFBO = _framebuffer->getOcclusionBlurredFramebuffer();
+    gpu::FramebufferPointer historyFBO;
+    gpu::TexturePointer previousHistoryTexture;
+    if (isTemporal) {
+        historyFBO = _framebuffer->getOcclusionHistoryFramebuffer(_historyIndex);
+        previousHistoryTexture = _framebuffer->getOcclusionHistoryTexture(1 - _historyIndex);
+        _historyIndex = 1 - _historyIndex;
+        _framebuffer->setHistoryValid(true);
+    }
     
     outputs.edit0() = _framebuffer;
     outputs.edit1() = _parametersBuffer;
@@ -384,6 +472,7 @@ void AmbientOcclusionEffect::run(const render::RenderContextPointer& renderConte
     auto occlusionPipeline = getOcclusionPipeline();
     auto firstHBlurPipeline = getHBlurPipeline();
     auto lastVBlurPipeline = getVBlurPipeline();
+    auto temporalPipeline = isTemporal ? getTemporalPipeline() : gpu::PipelinePointer();
     
     gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
         batch.enableStereo(false);
@@ -413,12 +502,23 @@ void AmbientOcclusionEffect::run(const render::RenderContextPointer& renderConte
         batch.setResourceTexture(AmbientOcclusionEffect_LinearDepthMapSlot, _framebuffer->getLinearDepthTexture());
         batch.draw(gpu::TRIANGLE_STRIP, 4);
 
+        // The noisy occlusion is accumulated over the previous frames, reprojected, before the blur
+        auto occlusionMap = occlusionFBO->getRenderBuffer(0);
+        if (isTemporal) {
+            batch.setFramebuffer(historyFBO);
+            batch.setPipeline(temporalPipeline);
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionMap);
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionHistoryMapSlot, previousHistoryTexture);
+            batch.draw(gpu::TRIANGLE_STRIP, 4);
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionHistoryMapSlot, nullptr);
+            occlusionMap = historyFBO->getRenderBuffer(0);
+        }
         
         if (_parametersBuffer->getBlurRadius() > 0) {
             // Blur 1st pass
             batch.setFramebuffer(occlusionBlurredFBO);
             batch.setPipeline(firstHBlurPipeline);
-            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionFBO->getRenderBuffer(0));
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionMap);
             batch.draw(gpu::TRIANGLE_STRIP, 4);
 
             // Blur 2nd pass
@@ -426,6 +526,8 @@ void AmbientOcclusionEffect::run(const render::RenderContextPointer& renderConte
             batch.setPipeline(lastVBlurPipeline);
             batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionBlurredFBO->getRenderBuffer(0));
             batch.draw(gpu::TRIANGLE_STRIP, 4);
+        } else if (isTemporal) {
+            batch.blit(historyFBO, occlusionViewport, occlusionFBO, occlusionViewport);
         }
         
         
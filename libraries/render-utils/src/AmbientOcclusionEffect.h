@@ -30,6 +30,14 @@ public:
     
     gpu::FramebufferPointer getOcclusionBlurredFramebuffer();
     gpu::TexturePointer getOcclusionBlurredTexture();
+
+    // The accumulated occlusion of the previous frames, ping-ponged every frame
+    gpu::FramebufferPointer getOcclusionHistoryFramebuffer(int index);
+    gpu::TexturePointer getOcclusionHistoryTexture(int index);
+
+    // False until a history was accumulated at the current size
+    bool isHistoryValid() const { return _isHistoryValid; }
+    void setHistoryValid(bool valid) { _isHistoryValid = valid; }
     
     // Update the source framebuffer size which will drive the allocation of all the other resources.
     void updateLinearDepth(const gpu::TexturePointer& linearDepthBuffer);
@@ -47,7 +55,10 @@ protected:
     
     gpu::FramebufferPointer _occlusionBlurredFramebuffer;
     gpu::TexturePointer _occlusionBlurredTexture;
-    
+
+    gpu::FramebufferPointer _occlusionHistoryFramebuffers[2];
+    gpu::TexturePointer _occlusionHistoryTextures[2];
+    bool _isHistoryValid { false };
     
     glm::ivec2 _frameSize;
 };
@@ -60,6 +71,7 @@ class AmbientOcclusionEffectConfig : public render::GPUJobConfig::Persistent {
     Q_PROPERTY(bool ditheringEnabled MEMBER ditheringEnabled NOTIFY dirty)
     Q_PROPERTY(bool borderingEnabled MEMBER borderingEnabled NOTIFY dirty)
     Q_PROPERTY(bool fetchMipsEnabled MEMBER fetchMipsEnabled NOTIFY dirty)
+    Q_PROPERTY(bool temporalEnabled MEMBER temporalEnabled NOTIFY dirty)
     Q_PROPERTY(float radius MEMBER radius WRITE setRadius)
     Q_PROPERTY(float obscuranceLevel MEMBER obscuranceLevel WRITE setObscuranceLevel)
     Q_PROPERTY(float falloffBias MEMBER falloffBias WRITE setFalloffBias)
@@ -99,6 +111,7 @@ public:
     bool ditheringEnabled{ true }; // randomize the distribution of taps per pixel, should always be true
     bool borderingEnabled{ true }; // avoid evaluating information from non existing pixels out of the frame, should always be true
     bool fetchMipsEnabled{ true }; // fetch taps in sub mips to otpimize cache, should always be true
+    bool temporalEnabled{ false }; // take a quarter of the samples per frame and accumulate them over the previous frames
 
 signals:
     void dirty();
@@ -128,7 +141,7 @@ public:
         glm::vec4 ditheringInfo { 0.0f, 0.0f, 0.01f, 1.0f };
         // Sampling info
         glm::vec4 sampleInfo { 11.0f, 1.0f/11.0f, 7.0f, 1.0f };
-        // Blurring info
+        // Blurring info, w is the weight of the new frame in the temporal accumulation (0 when off)
         glm::vec4 blurInfo { 1.0f, 3.0f, 2.0f, 0.0f };
          // gaussian distribution coefficients first is the sampling radius (max is 6)
         const static int GAUSSIAN_COEFS_LENGTH = 8;
@@ -151,6 +164,7 @@ public:
         int getBlurRadius() const { return (int)blurInfo.y; }
         bool isDitheringEnabled() const { return ditheringInfo.x; }
         bool isBorderingEnabled() const { return ditheringInfo.w; }
+        float getTemporalWeight() const { return blurInfo.w; }
     };
     using ParametersBuffer = gpu::StructBuffer<Parameters>;
 
@@ -162,10 +176,16 @@ private:
     const gpu::PipelinePointer& getOcclusionPipeline();
     const gpu::PipelinePointer& getHBlurPipeline(); // first
     const gpu::PipelinePointer& getVBlurPipeline(); // second
+    const gpu::PipelinePointer& getTemporalPipeline();
 
     gpu::PipelinePointer _occlusionPipeline;
     gpu::PipelinePointer _hBlurPipeline;
     gpu::PipelinePointer _vBlurPipeline;
+    gpu::PipelinePointer _temporalPipeline;
+
+    bool _isTemporalEnabled { false };
+    int _historyIndex { 0 };
+    uint32_t _frameCount { 0 };
 
     AmbientOcclusionFramebufferPointer _framebuffer;
     
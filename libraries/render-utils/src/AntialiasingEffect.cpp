@@ -25,7 +25,6 @@
 
 #include "fxaa_vert.h"
 #include "fxaa_frag.h"
-#include "fxaa_blend_frag.h"
 
 
 Antialiasing::Antialiasing() {
@@ -39,21 +38,24 @@ Antialiasing::~Antialiasing() {
     }
 }
 
-const gpu::PipelinePointer& Antialiasing::getAntialiasingPipeline(RenderArgs* args) {
-    int width = args->_viewport.z;
-    int height = args->_viewport.w;
-
-    if (_antialiasingBuffer && _antialiasingBuffer->getSize() != uvec2(width, height)) {
+const gpu::PipelinePointer& Antialiasing::getAntialiasingPipeline(const gpu::FramebufferPointer& sourceBuffer) {
+    // the source is made again when the viewport changes size, its depth and stencil along with it
+    if (_antialiasingBuffer && _antialiasingBuffer->getDepthStencilBuffer() != sourceBuffer->getDepthStencilBuffer()) {
         _antialiasingBuffer.reset();
     }
 
     if (!_antialiasingBuffer) {
         // Link the antialiasing FBO to texture
+        auto size = sourceBuffer->getSize();
         _antialiasingBuffer = gpu::FramebufferPointer(gpu::Framebuffer::create("antialiasing"));
         auto format = gpu::Element::COLOR_SRGBA_32;
         auto defaultSampler = gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT);
-        _antialiasingTexture = gpu::Texture::createRenderBuffer(format, width, height, gpu::Texture::SINGLE_MIP, defaultSampler);
+        _antialiasingTexture = gpu::Texture::createRenderBuffer(format, size.x, size.y, gpu::Texture::SINGLE_MIP, defaultSampler);
         _antialiasingBuffer->setRenderBuffer(0, _antialiasingTexture);
+        // what is drawn after the antialiasing still tests against the depth and stencil of the frame
+        if (sourceBuffer->hasDepthStencil()) {
+            _antialiasingBuffer->setDepthStencilBuffer(sourceBuffer->getDepthStencilBuffer(), sourceBuffer->getDepthStencilBufferFormat());
+        }
     }
 
     if (!_antialiasingPipeline) {
@@ -81,34 +83,17 @@ const gpu::PipelinePointer& Antialiasing::getAntialiasingPipeline(RenderArgs* ar
     return _antialiasingPipeline;
 }
 
-const gpu::PipelinePointer& Antialiasing::getBlendPipeline() {
-    if (!_blendPipeline) {
-        auto vs = gpu::Shader::createVertex(std::string(fxaa_vert));
-        auto ps = gpu::Shader::createPixel(std::string(fxaa_blend_frag));
-        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
-
-        gpu::Shader::BindingSet slotBindings;
-        slotBindings.insert(gpu::Shader::Binding(std::string("colorTexture"), 0));
-
-        gpu::Shader::makeProgram(*program, slotBindings);
-
-        gpu::StatePointer state = gpu::StatePointer(new gpu::State());
-
-        state->setDepthTest(false, false, gpu::LESS_EQUAL);
-        PrepareStencil::testMask(*state);
-
-        // Good to go add the brand new pipeline
-        _blendPipeline = gpu::Pipeline::create(program, state);
-    }
-    return _blendPipeline;
-}
-
-void Antialiasing::run(const render::RenderContextPointer& renderContext, const gpu::FramebufferPointer& sourceBuffer) {
+void Antialiasing::run(const render::RenderContextPointer& renderContext, const gpu::FramebufferPointer& sourceBuffer, gpu::FramebufferPointer& outputBuffer) {
     assert(renderContext->args);
     assert(renderContext->args->hasViewFrustum());
 
     RenderArgs* args = renderContext->args;
 
+    outputBuffer = sourceBuffer;
+    if (!renderContext->jobConfig->enabled || !sourceBuffer) {
+        return;
+    }
+
     gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
         batch.enableStereo(false);
         batch.setViewportTransform(args->_viewport);
@@ -130,7 +115,7 @@ void Antialiasing::run(const render::RenderContextPointer& renderContext, const
         batch.setModelTransform(Transform());
 
         // FXAA step
-        auto pipeline = getAntialiasingPipeline(renderContext->args);
+        auto pipeline = getAntialiasingPipeline(sourceBuffer);
         batch.setResourceTexture(0, sourceBuffer->getRenderBuffer(0));
         batch.setFramebuffer(_antialiasingBuffer);
         batch.setPipeline(pipeline);
@@ -157,13 +142,9 @@ void Antialiasing::run(const render::RenderContextPointer& renderContext, const
         glm::vec2 texCoordBottomRight(1.0f, 1.0f);
         DependencyManager::get<GeometryCache>()->renderQuad(batch, bottomLeft, topRight, texCoordTopLeft, texCoordBottomRight, color, _geometryId);
 
-
-        // Blend step
-        getBlendPipeline();
-        batch.setResourceTexture(0, _antialiasingTexture);
-        batch.setFramebuffer(sourceBuffer);
-        batch.setPipeline(getBlendPipeline());
-
-        DependencyManager::get<GeometryCache>()->renderQuad(batch, bottomLeft, topRight, texCoordTopLeft, texCoordBottomRight, color, _geometryId);
+        batch.setResourceTexture(0, nullptr);
     });
+
+    // the rest of the frame goes on in the antialiased framebuffer, with no copy back to the source
+    outputBuffer = _antialiasingBuffer;
 }
@@ -20,21 +20,25 @@ class AntiAliasingConfig : public render::Job::Config {
     Q_OBJECT
     Q_PROPERTY(bool enabled MEMBER enabled)
 public:
-    AntiAliasingConfig() : render::Job::Config(true) {}
+    // The job runs even with FXAA turned off, to hand on the framebuffer the frame is finished in. The enabled property
+    // above is on the member itself, so it still turns FXAA on and off.
+    AntiAliasingConfig() : render::Job::Config(true) { alwaysEnabled = true; }
 };
 
+// Runs FXAA over the source framebuffer into a framebuffer of its own that shares the depth and stencil of the source,
+// and outputs that one for the rest of the frame to be drawn in and blitted from, instead of copying it back. Without
+// FXAA the output is the source itself.
 class Antialiasing {
 public:
     using Config = AntiAliasingConfig;
-    using JobModel = render::Job::ModelI<Antialiasing, gpu::FramebufferPointer, Config>;
+    using JobModel = render::Job::ModelIO<Antialiasing, gpu::FramebufferPointer, gpu::FramebufferPointer, Config>;
 
     Antialiasing();
     ~Antialiasing();
     void configure(const Config& config) {}
-    void run(const render::RenderContextPointer& renderContext, const gpu::FramebufferPointer& sourceBuffer);
+    void run(const render::RenderContextPointer& renderContext, const gpu::FramebufferPointer& sourceBuffer, gpu::FramebufferPointer& outputBuffer);
 
-    const gpu::PipelinePointer& getAntialiasingPipeline(RenderArgs* args);
-    const gpu::PipelinePointer& getBlendPipeline();
+    const gpu::PipelinePointer& getAntialiasingPipeline(const gpu::FramebufferPointer& sourceBuffer);
 
 private:
 
@@ -46,7 +50,6 @@ private:
     gpu::TexturePointer _antialiasingTexture;
 
     gpu::PipelinePointer _antialiasingPipeline;
-    gpu::PipelinePointer _blendPipeline;
     int _geometryId { 0 };
 };
 
@@ -22,9 +22,10 @@ CauterizedMeshPartPayload::CauterizedMeshPartPayload(ModelPointer model, int mes
 
 void CauterizedMeshPartPayload::updateTransformForCauterizedMesh(
         const Transform& renderTransform,
-        const gpu::BufferPointer& buffer) {
+        const Model::MeshState& meshState) {
     _cauterizedTransform = renderTransform;
-    _cauterizedClusterBuffer = buffer;
+    _cauterizedClusterBuffer = meshState.clusterBuffer;
+    _cauterizedSkinPoseBuffer = meshState.skinPoseBuffer;
 }
 
 void CauterizedMeshPartPayload::bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, RenderArgs::RenderMode renderMode) const {
@@ -41,14 +42,10 @@ void CauterizedMeshPartPayload::bindTransform(gpu::Batch& batch, const render::S
     }
 
     if (useCauterizedMesh) {
-        if (_cauterizedClusterBuffer) {
-            batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::SKINNING, _cauterizedClusterBuffer);
-        }
+        bindSkinning(batch, _cauterizedClusterBuffer, _cauterizedSkinPoseBuffer);
         batch.setModelTransform(_cauterizedTransform);
     } else {
-        if (_clusterBuffer) {
-            batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::SKINNING, _clusterBuffer);
-        }
+        bindSkinning(batch, _clusterBuffer, _skinPoseBuffer);
         batch.setModelTransform(_transform);
     }
 }
@@ -15,12 +15,13 @@ class CauterizedMeshPartPayload : public ModelMeshPartPayload {
 public:
     CauterizedMeshPartPayload(ModelPointer model, int meshIndex, int partIndex, int shapeIndex, const Transform& transform, const Transform& offsetTransform);
 
-    void updateTransformForCauterizedMesh(const Transform& renderTransform, const gpu::BufferPointer& buffer);
+    void updateTransformForCauterizedMesh(const Transform& renderTransform, const Model::MeshState& meshState);
 
     void bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, RenderArgs::RenderMode renderMode) const override;
 
 private:
     gpu::BufferPointer _cauterizedClusterBuffer;
+    gpu::BufferPointer _cauterizedSkinPoseBuffer;
     Transform _cauterizedTransform;
 };
 
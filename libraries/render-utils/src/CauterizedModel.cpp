@@ -26,6 +26,8 @@ CauterizedModel::~CauterizedModel() {
 void CauterizedModel::deleteGeometry() {
     Model::deleteGeometry();
     _cauterizeMeshStates.clear();
+    _cauterizeSkinPoses.clear();
+    _cauterizeSkinPoseBuffer.reset();
 }
 
 bool CauterizedModel::updateGeometry() {
@@ -101,10 +103,19 @@ void CauterizedModel::updateClusterMatrices() {
     }
     _needsUpdateClusterMatrices = false;
     const FBXGeometry& geometry = getFBXGeometry();
+    bool isSkinningWithDualQuaternions = updateSkinPoses();
 
     for (int i = 0; i < _meshStates.size(); i++) {
         Model::MeshState& state = _meshStates[i];
         const FBXMesh& mesh = geometry.meshes.at(i);
+
+        // The vertex shader composes the joint poses with the bind poses of the clusters
+        if (isSkinningWithDualQuaternions && state.clusterBindBuffer) {
+            state.skinPoseBuffer = _skinPoseBuffer;
+            continue;
+        }
+        state.skinPoseBuffer.reset();
+
         for (int j = 0; j < mesh.clusters.size(); j++) {
             const FBXCluster& cluster = mesh.clusters.at(j);
             auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
@@ -123,6 +134,33 @@ void CauterizedModel::updateClusterMatrices() {
         }
     }
 
+    if (isSkinningWithDualQuaternions) {
+        // The cauterized joints collapse to the translation of the neck, as with the zero scale of the matrices
+        gpu::BufferPointer cauterizeSkinPoseBuffer = _skinPoseBuffer;
+        if (!_cauterizeBoneSet.empty()) {
+            SkinPose cauterizePose;
+            cauterizePose.rotation = glm::quat();
+            cauterizePose.translationScale = glm::vec4(extractTranslation(_rig.getJointTransform(geometry.neckJointIndex)), 0.0f);
+
+            _cauterizeSkinPoses = _skinPoses;
+            for (int jointIndex : _cauterizeBoneSet) {
+                if (jointIndex >= 0 && jointIndex < (int)_cauterizeSkinPoses.size()) {
+                    _cauterizeSkinPoses[jointIndex] = cauterizePose;
+                }
+            }
+            uploadSkinPoses(_cauterizeSkinPoses, _cauterizeSkinPoseBuffer);
+            cauterizeSkinPoseBuffer = _cauterizeSkinPoseBuffer;
+        }
+
+        for (int i = 0; i < _cauterizeMeshStates.size() && i < _meshStates.size(); i++) {
+            _cauterizeMeshStates[i].skinPoseBuffer = _meshStates[i].clusterBindBuffer ? cauterizeSkinPoseBuffer : nullptr;
+        }
+    } else {
+        for (auto& state : _cauterizeMeshStates) {
+            state.skinPoseBuffer.reset();
+        }
+    }
+
     // as an optimization, don't build cautrizedClusterMatrices if the boneSet is empty.
     if (!_cauterizeBoneSet.empty()) {
         static const glm::mat4 zeroScale(
@@ -135,6 +173,9 @@ void CauterizedModel::updateClusterMatrices() {
         for (int i = 0; i < _cauterizeMeshStates.size(); i++) {
             Model::MeshState& state = _cauterizeMeshStates[i];
             const FBXMesh& mesh = geometry.meshes.at(i);
+            if (state.skinPoseBuffer) {
+                continue;
+            }
             for (int j = 0; j < mesh.clusters.size(); j++) {
                 const FBXCluster& cluster = mesh.clusters.at(j);
                 auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
@@ -217,7 +258,7 @@ void CauterizedModel::updateRenderItems() {
                             if (state.clusterMatrices.size() == 1) {
                                 renderTransform = modelTransform.worldTransform(Transform(state.clusterMatrices[0]));
                             }
-                            data.updateTransformForSkinnedMesh(renderTransform, modelTransform, state.clusterBuffer);
+                            data.updateTransformForSkinnedMesh(renderTransform, modelTransform, state);
 
                             // this stuff for cauterized mesh
                             CauterizedModel* cModel = static_cast<CauterizedModel*>(model.get());
@@ -226,7 +267,7 @@ void CauterizedModel::updateRenderItems() {
                             if (cState.clusterMatrices.size() == 1) {
                                 renderTransform = modelTransform.worldTransform(Transform(cState.clusterMatrices[0]));
                             }
-                            data.updateTransformForCauterizedMesh(renderTransform, cState.clusterBuffer);
+                            data.updateTransformForCauterizedMesh(renderTransform, cState);
                         }
                     }
                 });
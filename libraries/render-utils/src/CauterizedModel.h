@@ -42,6 +42,8 @@ public:
 protected:
     std::unordered_set<int> _cauterizeBoneSet;
     QVector<Model::MeshState> _cauterizeMeshStates;
+    std::vector<SkinPose> _cauterizeSkinPoses;
+    gpu::BufferPointer _cauterizeSkinPoseBuffer;
     bool _isCauterized { false };
     bool _enableCauterization { false };
 };
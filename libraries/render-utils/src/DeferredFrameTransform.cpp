@@ -31,6 +31,8 @@ void DeferredFrameTransform::update(RenderArgs* args) {
 
     //_parametersBuffer.edit<Parameters>()._ditheringInfo.y += 0.25f;
 
+    frameTransformBuffer.prevView = frameTransformBuffer.view;
+
     Transform cameraTransform;
     args->getViewFrustum().evalViewTransform(cameraTransform);
     cameraTransform.getMatrix(frameTransformBuffer.invView);
@@ -51,6 +51,8 @@ protected:
         glm::mat4 invView;
         // View matrix from world space to eye space (mono)
         glm::mat4 view;
+        // View matrix of the previous frame, to reproject what was computed then
+        glm::mat4 prevView;
 
         FrameTransform() {}
     };
@@ -214,6 +214,9 @@ static void loadLightProgram(const char* vertSource, const char* fragSource, boo
         // additive blending
         state->setBlendFunction(true, gpu::State::ONE, gpu::State::BLEND_OP_ADD, gpu::State::ONE);
 
+        // the local lights are only shaded over the tiles of the cluster grid that have some
+        state->setScissorEnable(true);
+
     } else {
         // Stencil test all the light passes for objects pixels only, not the background
         PrepareStencil::testShape(*state);
@@ -557,6 +560,10 @@ void RenderDeferredSetup::run(const render::RenderContextPointer& renderContext,
     }
 }
 
+// Past this share of the tiles lit, or this many runs of them, the local lights are shaded over the whole viewport at once
+const float MAX_LIT_TILES_RATIO_FOR_RUNS = 0.75f;
+const size_t MAX_LIT_TILE_RUNS = 64;
+
 RenderDeferredLocals::RenderDeferredLocals() :
     _localLightsBuffer(std::make_shared<gpu::Buffer>()) {
 
@@ -610,18 +617,53 @@ void RenderDeferredLocals::run(const render::RenderContextPointer& renderContext
             batch.setUniformBuffer(LIGHT_CLUSTER_GRID_CLUSTER_GRID_SLOT, lightClusters->_clusterGridBuffer);
             batch.setUniformBuffer(LIGHT_CLUSTER_GRID_CLUSTER_CONTENT_SLOT, lightClusters->_clusterContentBuffer);
 
+            // The tiles of the grid are even slices of the mono viewport, as long as the grid was made from the frustum
+            // drawn with this frame. In stereo each eye maps its pixels to the grid on its own, so the whole viewport
+            // is shaded there.
+            const auto& gridDims = lightClusters->_frustumGridBuffer->dims;
+            bool isGridOnScreen = !args->isStereo() &&
+                lightClusters->_frustum.getPosition() == viewFrustum.getPosition() &&
+                lightClusters->_frustum.getOrientation() == viewFrustum.getOrientation();
+            bool useTileRuns = false;
+            if (isGridOnScreen) {
+                int numLitTiles = lightClusters->evalLitTileRuns(_litTileRuns);
+                if (numLitTiles == 0) {
+                    // no light reaches any pixel of the viewport
+                    return;
+                }
+                useTileRuns = numLitTiles < (int)(MAX_LIT_TILES_RATIO_FOR_RUNS * (gridDims.x * gridDims.y)) &&
+                    _litTileRuns.size() <= MAX_LIT_TILE_RUNS;
+            }
+
+            auto drawLitTiles = [&] {
+                if (!useTileRuns) {
+                    batch.draw(gpu::TRIANGLE_STRIP, 4);
+                    return;
+                }
+                // the full screen quad is drawn once per run, cut down to it with the scissor
+                for (const auto& run : _litTileRuns) {
+                    int left = viewport.x + (run.x * viewport.z) / gridDims.x;
+                    int right = viewport.x + ((run.x + run.z) * viewport.z + gridDims.x - 1) / gridDims.x;
+                    int bottom = viewport.y + (run.y * viewport.w) / gridDims.y;
+                    int top = viewport.y + ((run.y + 1) * viewport.w + gridDims.y - 1) / gridDims.y;
+                    batch.setStateScissorRect(glm::ivec4(left, bottom, right - left, top - bottom));
+                    batch.draw(gpu::TRIANGLE_STRIP, 4);
+                }
+                batch.setStateScissorRect(viewport);
+            };
+
             // Local light pipeline
             batch.setPipeline(deferredLightingEffect->_localLight);
             batch._glUniform4fv(deferredLightingEffect->_localLightLocations->texcoordFrameTransform, 1, reinterpret_cast<const float*>(&textureFrameTransform));
 
-            batch.draw(gpu::TRIANGLE_STRIP, 4);
+            drawLitTiles();
 
              // Draw outline as well ?
             if (lightingModel->isShowLightContourEnabled()) {
                 batch.setPipeline(deferredLightingEffect->_localLightOutline);
                 batch._glUniform4fv(deferredLightingEffect->_localLightOutlineLocations->texcoordFrameTransform, 1, reinterpret_cast<const float*>(&textureFrameTransform));
 
-                batch.draw(gpu::TRIANGLE_STRIP, 4);
+                drawLitTiles();
             }
         }
     }
@@ -140,6 +140,10 @@ public:
 
     RenderDeferredLocals();
 
+protected:
+    // scratch of run, the runs of tiles the local lights are shaded over this frame
+    std::vector<glm::ivec3> _litTileRuns;
+
 };
 
 
@@ -12,6 +12,8 @@
 #include "RenderUtilsLogging.h"
 
 
+#include <algorithm>
+
 #include <gpu/Context.h>
 
 #include <gpu/StandardShaderLib.h>
@@ -139,6 +141,7 @@ uint32_t LightClusters::getNumClusters() const {
         return;
     }
     _clusterResourcesInvalid = false;
+    _clusterUploadInvalid = true;
     auto numClusters = getNumClusters();
     if (numClusters != (uint32_t) _clusterGrid.size()) {
         _clusterGrid.clear();
@@ -161,6 +164,41 @@ uint32_t LightClusters::getNumClusters() const {
     }
 }
 
+int LightClusters::evalLitTileRuns(std::vector<glm::ivec3>& runs) const {
+    runs.clear();
+    const auto& dims = _frustumGridBuffer->dims;
+    if ((int)_clusterGrid.size() < dims.x * dims.y * (dims.z + 1)) {
+        return 0;
+    }
+
+    // The upper 16 bits of a cluster are its number of point and spot lights
+    const uint32_t NUM_LIGHTS_MASK { 0xFFFF0000 };
+    const int layerSize = dims.x * dims.y;
+    int numLitTiles = 0;
+    for (int y = 0; y < dims.y; y++) {
+        int runStart = -1;
+        for (int x = 0; x <= dims.x; x++) {
+            bool isLit = false;
+            if (x < dims.x) {
+                auto cluster = x + y * dims.x;
+                for (int z = 0; z <= dims.z && !isLit; z++, cluster += layerSize) {
+                    isLit = (_clusterGrid[cluster] & NUM_LIGHTS_MASK) != 0;
+                }
+            }
+            if (isLit) {
+                numLitTiles++;
+                if (runStart < 0) {
+                    runStart = x;
+                }
+            } else if (runStart >= 0) {
+                runs.emplace_back(runStart, y, x - runStart);
+                runStart = -1;
+            }
+        }
+    }
+    return numLitTiles;
+}
+
 void LightClusters::setRangeNearFar(float rangeNear, float rangeFar) {
     bool changed = false;
 
@@ -239,14 +277,14 @@ bool reduceSphereToPlane(const glm::vec4& sphere, const glm::vec4& plane, glm::v
 
 
 uint32_t scanLightVolumeBoxSlice(FrustumGrid& grid, const FrustumGrid::Planes planes[3], int zSlice, int yMin, int yMax, int xMin, int xMax, LightClusters::LightID lightId, const glm::vec4& eyePosRadius,
-    std::vector< std::vector<LightClusters::LightIndex>>& clusterGrid) {
+    LightClusters::LightReferences& references) {
     glm::ivec3 gridPosToOffset(1, grid.dims.x, grid.dims.x * grid.dims.y);
     uint32_t numClustersTouched = 0;
 
     for (auto y = yMin; (y <= yMax); y++) {
         for (auto x = xMin; (x <= xMax); x++) {
             auto index = x + gridPosToOffset.y * y + gridPosToOffset.z * zSlice;
-            clusterGrid[index].emplace_back(lightId);
+            references.push_back({ (uint32_t)index, (LightClusters::LightIndex)lightId });
             numClustersTouched++;
         }
     }
@@ -255,7 +293,7 @@ uint32_t scanLightVolumeBoxSlice(FrustumGrid& grid, const FrustumGrid::Planes pl
 }
 
 uint32_t scanLightVolumeBox(FrustumGrid& grid, const FrustumGrid::Planes planes[3], int zMin, int zMax, int yMin, int yMax, int xMin, int xMax, LightClusters::LightID lightId, const glm::vec4& eyePosRadius,
-    std::vector< std::vector<LightClusters::LightIndex>>& clusterGrid) {
+    LightClusters::LightReferences& references) {
     glm::ivec3 gridPosToOffset(1, grid.dims.x, grid.dims.x * grid.dims.y);
     uint32_t numClustersTouched = 0;
 
@@ -263,7 +301,7 @@ uint32_t scanLightVolumeBox(FrustumGrid& grid, const FrustumGrid::Planes planes[
         for (auto y = yMin; (y <= yMax); y++) {
             for (auto x = xMin; (x <= xMax); x++) {
                 auto index = x + gridPosToOffset.y * y + gridPosToOffset.z * z;
-                clusterGrid[index].emplace_back(lightId);
+                references.push_back({ (uint32_t)index, (LightClusters::LightIndex)lightId });
                 numClustersTouched++;
             }
         }
@@ -273,12 +311,13 @@ uint32_t scanLightVolumeBox(FrustumGrid& grid, const FrustumGrid::Planes planes[
 }
 
 uint32_t scanLightVolumeSphere(FrustumGrid& grid, const FrustumGrid::Planes planes[3], int zMin, int zMax, int yMin, int yMax, int xMin, int xMax, LightClusters::LightID lightId, const glm::vec4& eyePosRadius,
-    std::vector< std::vector<LightClusters::LightIndex>>& clusterGrid) {
+    LightClusters::LightReferences& references) {
     glm::ivec3 gridPosToOffset(1, grid.dims.x, grid.dims.x * grid.dims.y);
     uint32_t numClustersTouched = 0;
     const auto& xPlanes = planes[0];
     const auto& yPlanes = planes[1];
     const auto& zPlanes = planes[2];
+    int numClusters = grid.frustumGrid_numClusters();
 
     // FInd the light origin cluster
     auto centerCluster = grid.frustumGrid_eyeToClusterPos(glm::vec3(eyePosRadius));
@@ -326,11 +365,11 @@ uint32_t scanLightVolumeSphere(FrustumGrid& grid, const FrustumGrid::Planes plan
 
             for (; (x <= xs); x++) {
                 auto index = grid.frustumGrid_clusterToIndex(ivec3(x, y, z));
-                if (index < (int)clusterGrid.size()) {
-                    clusterGrid[index].emplace_back(lightId);
+                if (index < numClusters) {
+                    references.push_back({ (uint32_t)index, (LightClusters::LightIndex)lightId });
                     numClustersTouched++;
                 } else {
-                    qCDebug(renderutils) << "WARNING: LightClusters::scanLightVolumeSphere invalid index found ? numClusters = " << clusterGrid.size() << " index = " << index << " found from cluster xyz = " << x << " " << y << " " << z;
+                    qCDebug(renderutils) << "WARNING: LightClusters::scanLightVolumeSphere invalid index found ? numClusters = " << numClusters << " index = " << index << " found from cluster xyz = " << x << " " << y << " " << z;
                 }
             }
         }
@@ -339,22 +378,20 @@ uint32_t scanLightVolumeSphere(FrustumGrid& grid, const FrustumGrid::Planes plan
     return numClustersTouched;
 }
 
+// A cluster encodes the number of its point and spot lights on 8 bits each
+static const uint32_t MAX_LIGHTS_PER_CLUSTER = 0xFF;
+static const uint16_t INVALID_CLUSTER_OFFSET = 0xFFFF;
+
 glm::ivec3 LightClusters::updateClusters() {
     // Make sure resource are in good shape
     updateClusterResource();
 
-    // Clean up last info
+    // Clean up last info, the references keep their storage from frame to frame
     uint32_t numClusters = (uint32_t)_clusterGrid.size();
-
-    std::vector< std::vector< LightIndex > > clusterGridPoint(numClusters);
-    std::vector< std::vector< LightIndex > > clusterGridSpot(numClusters);
-
-    _clusterGrid.clear();
-    _clusterGrid.resize(numClusters, EMPTY_CLUSTER);
-
     uint32_t maxNumIndices = (uint32_t)_clusterContent.size();
-    _clusterContent.clear();
-    _clusterContent.resize(maxNumIndices, INVALID_LIGHT);
+
+    _pointReferences.clear();
+    _spotReferences.clear();
 
 
     auto theFrustumGrid(_frustumGridBuffer.get());
@@ -491,29 +528,38 @@ glm::ivec3 LightClusters::updateClusters() {
         }
 
         // now voxelize
-        auto& clusterGrid = (isSpot ? clusterGridSpot : clusterGridPoint);
+        auto& references = (isSpot ? _spotReferences : _pointReferences);
         if (beyondFar) {
-            numClusterTouched += scanLightVolumeBoxSlice(theFrustumGrid, _gridPlanes, zMin, yMin, yMax, xMin, xMax, lightId, glm::vec4(glm::vec3(eyeOri), radius), clusterGrid);
+            numClusterTouched += scanLightVolumeBoxSlice(theFrustumGrid, _gridPlanes, zMin, yMin, yMax, xMin, xMax, lightId, glm::vec4(glm::vec3(eyeOri), radius), references);
         } else {
-            numClusterTouched += scanLightVolumeSphere(theFrustumGrid, _gridPlanes, zMin, zMax, yMin, yMax, xMin, xMax, lightId, glm::vec4(glm::vec3(eyeOri), radius), clusterGrid);
+            numClusterTouched += scanLightVolumeSphere(theFrustumGrid, _gridPlanes, zMin, zMax, yMin, yMax, xMin, xMax, lightId, glm::vec4(glm::vec3(eyeOri), radius), references);
         }
 
         numClusteredLights++;
     }
 
     // Lights have been gathered now reexpress in terms of 2 sequential buffers
+    // Count the lights of each cluster
+    _clusterPointCounts.assign(numClusters, 0);
+    _clusterSpotCounts.assign(numClusters, 0);
+    for (const auto& reference : _pointReferences) {
+        _clusterPointCounts[reference.cluster]++;
+    }
+    for (const auto& reference : _spotReferences) {
+        _clusterSpotCounts[reference.cluster]++;
+    }
+
     // Start filling from near to far and stops if it overflows
     bool checkBudget = false;
     if (numClusterTouched > maxNumIndices) {
         checkBudget = true;
     }
+    _newClusterGrid.assign(numClusters, EMPTY_CLUSTER);
+    _clusterOffsets.assign(numClusters, INVALID_CLUSTER_OFFSET);
     uint16_t indexOffset = 0;
-    for (int i = 0; i < (int) clusterGridPoint.size(); i++) {
-        auto& clusterPoint = clusterGridPoint[i];
-        auto& clusterSpot = clusterGridSpot[i];
-
-        uint8_t numLightsPoint = ((uint8_t)clusterPoint.size());
-        uint8_t numLightsSpot = ((uint8_t)clusterSpot.size());
+    for (uint32_t i = 0; i < numClusters; i++) {
+        uint8_t numLightsPoint = (uint8_t)std::min<uint32_t>(_clusterPointCounts[i], MAX_LIGHTS_PER_CLUSTER);
+        uint8_t numLightsSpot = (uint8_t)std::min<uint32_t>(_clusterSpotCounts[i], MAX_LIGHTS_PER_CLUSTER);
         uint16_t numLights = numLightsPoint + numLightsSpot;
         uint16_t offset = indexOffset;
 
@@ -525,23 +571,47 @@ glm::ivec3 LightClusters::updateClusters() {
         }
 
         // Encode the cluster grid: [ ContentOffset - 16bits, Num Point LIghts - 8bits, Num Spot Lights - 8bits] 
-        _clusterGrid[i] = (uint32_t)((0xFF000000 & (numLightsSpot << 24)) | (0x00FF0000 & (numLightsPoint << 16)) | (0x0000FFFF & offset));
+        _newClusterGrid[i] = (uint32_t)((0xFF000000 & (numLightsSpot << 24)) | (0x00FF0000 & (numLightsPoint << 16)) | (0x0000FFFF & offset));
 
+        // The point lights of the cluster go first, then the spot lights
+        _clusterOffsets[i] = offset;
+        _clusterPointCounts[i] = numLightsPoint;
+        _clusterSpotCounts[i] = numLightsSpot;
+        indexOffset += numLights;
+    }
 
-        if (numLightsPoint) {
-            memcpy(_clusterContent.data() + indexOffset, clusterPoint.data(), numLightsPoint * sizeof(LightIndex));
-            indexOffset += numLightsPoint;
+    // Scatter the references in the order of the lights, counting down what's left of each cluster
+    uint32_t contentSize = indexOffset;
+    _newClusterContent.resize(contentSize);
+    for (const auto& reference : _pointReferences) {
+        auto cluster = reference.cluster;
+        if (_clusterOffsets[cluster] != INVALID_CLUSTER_OFFSET && _clusterPointCounts[cluster] > 0) {
+            _newClusterContent[_clusterOffsets[cluster]++] = reference.light;
+            _clusterPointCounts[cluster]--;
         }
-        if (numLightsSpot) {
-            memcpy(_clusterContent.data() + indexOffset, clusterSpot.data(), numLightsSpot * sizeof(LightIndex));
-            indexOffset += numLightsSpot;
+    }
+    for (const auto& reference : _spotReferences) {
+        auto cluster = reference.cluster;
+        if (_clusterOffsets[cluster] != INVALID_CLUSTER_OFFSET && _clusterSpotCounts[cluster] > 0) {
+            // All the point lights of the cluster are in, the offset now points at its spot lights
+            _newClusterContent[_clusterOffsets[cluster]++] = reference.light;
+            _clusterSpotCounts[cluster]--;
         }
     }
 
-    // update the buffers
-    _clusterGridBuffer._buffer->setData(_clusterGridBuffer._size, (gpu::Byte*) _clusterGrid.data());
-    _clusterContentBuffer._buffer->setSubData(0, indexOffset * sizeof(LightIndex), (gpu::Byte*) _clusterContent.data());
-    
+    // update the buffers, only when their content changed, which it doesn't while the view and the lights stay
+    if (_clusterUploadInvalid || _newClusterGrid != _clusterGrid) {
+        _clusterGrid.swap(_newClusterGrid);
+        _clusterGridBuffer._buffer->setData(_clusterGridBuffer._size, (gpu::Byte*) _clusterGrid.data());
+    }
+    if (_clusterUploadInvalid || contentSize != _clusterContentSize ||
+        !std::equal(_newClusterContent.begin(), _newClusterContent.end(), _clusterContent.begin())) {
+        std::copy(_newClusterContent.begin(), _newClusterContent.end(), _clusterContent.begin());
+        _clusterContentSize = contentSize;
+        _clusterContentBuffer._buffer->setSubData(0, contentSize * sizeof(LightIndex), (gpu::Byte*) _clusterContent.data());
+    }
+    _clusterUploadInvalid = false;
+
     return glm::ivec3(numLightsIn, numClusteredLights, numClusterTouched);
 }
 
@@ -83,6 +83,10 @@ public:
 
     glm::ivec3  updateClusters();
 
+    // The tiles of the screen, the x,y columns of the grid, with a light in any of their clusters gathered in runs along
+    // each row of the grid, as x, y and the number of tiles. Returns the number of tiles lit.
+    int evalLitTileRuns(std::vector<glm::ivec3>& runs) const;
+
 
     ViewFrustum _frustum;
 
@@ -103,14 +107,33 @@ public:
 
     using LightIndex = uint16_t;
 
+    // A light touching a cluster, as found by the voxelization of the light volumes
+    struct LightReference {
+        uint32_t cluster;
+        LightIndex light;
+    };
+    using LightReferences = std::vector<LightReference>;
+
     std::vector<uint32_t> _clusterGrid;
     std::vector<LightIndex> _clusterContent;
+    uint32_t _clusterContentSize { 0 };
     gpu::BufferView _clusterGridBuffer;
     gpu::BufferView _clusterContentBuffer;
     uint32_t _clusterContentBudget { 0 };
 
     bool _clusterResourcesInvalid { true };
+    bool _clusterUploadInvalid { true };
     void updateClusterResource();
+
+protected:
+    // Scratch of updateClusters, kept to not reallocate every frame
+    LightReferences _pointReferences;
+    LightReferences _spotReferences;
+    std::vector<uint16_t> _clusterPointCounts;
+    std::vector<uint16_t> _clusterSpotCounts;
+    std::vector<uint16_t> _clusterOffsets;
+    std::vector<uint32_t> _newClusterGrid;
+    std::vector<LightIndex> _newClusterContent;
 };
 
 using LightClustersPointer = std::shared_ptr<LightClusters>;
@@ -18,15 +18,47 @@ std::string LightStage::_stageName { "LIGHT_STAGE"};
 LightStage::LightStage() {
 }
 
-LightStage::Shadow::Shadow(model::LightPointer light) : _light{ light}, _frustum{ std::make_shared<ViewFrustum>() } {
-    framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::createShadowmap(MAP_SIZE));
+// Margin a cached cascade is fit with around its slice of the view, relative to the radius of the slice
+static const float CACHED_CASCADE_MARGIN = 0.25f;
+// Weight of the logarithmic split of the view between the cascades, against the uniform one
+static const float CASCADE_SPLIT_LOG_WEIGHT = 0.75f;
+// Step the radius of a slice is rounded up to, so that the texels of its cascade keep their size
+static const float CASCADE_RADIUS_STEP = 1.0f / 16.0f;
+
+LightStage::Shadow::Cascade::Cascade() : _frustum{ std::make_shared<ViewFrustum>() } {
+}
+
+const glm::mat4& LightStage::Shadow::Cascade::getView() const {
+    return _frustum->getView();
+}
+
+const glm::mat4& LightStage::Shadow::Cascade::getProjection() const {
+    return _frustum->getProjection();
+}
+
+bool LightStage::Shadow::Cascade::needsRender(uint64_t casterSignature) const {
+    return !_isCached || _isFitDirty || casterSignature != _casterSignature;
+}
+
+void LightStage::Shadow::Cascade::setRendered(uint64_t casterSignature) {
+    _isFitDirty = false;
+    _casterSignature = casterSignature;
+}
+
+LightStage::Shadow::Shadow(model::LightPointer light) : _light{ light} {
+    framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::createShadowmap(ATLAS_SIZE));
     map = framebuffer->getDepthStencilBuffer();
+    for (int i = 0; i < MAX_CASCADE_COUNT; ++i) {
+        _cascades[i]._viewport = glm::ivec4((i % 2) * MAP_SIZE, (i / 2) * MAP_SIZE, MAP_SIZE, MAP_SIZE);
+    }
     Schema schema;
     _schemaBuffer = std::make_shared<gpu::Buffer>(sizeof(Schema), (const gpu::Byte*) &schema);
 }
 
-void LightStage::Shadow::setKeylightFrustum(const ViewFrustum& viewFrustum, float nearDepth, float farDepth) {
+void LightStage::Shadow::setKeylightCascadeFrustums(const ViewFrustum& viewFrustum, float nearDepth, float farDepth,
+        int cascadeCount, bool cacheFarCascades) {
     assert(nearDepth < farDepth);
+    cascadeCount = glm::clamp(cascadeCount, 1, (int)MAX_CASCADE_COUNT);
 
     // Orient the keylight frustum
     const auto& direction = glm::normalize(_light->getDirection());
@@ -40,56 +72,93 @@ void LightStage::Shadow::setKeylightFrustum(const ViewFrustum& viewFrustum, floa
         auto up = glm::normalize(glm::cross(side, direction));
         orientation = glm::quat_cast(glm::mat3(side, up, -direction));
     }
-    _frustum->setOrientation(orientation);
 
-    // Position the keylight frustum
-    _frustum->setPosition(viewFrustum.getPosition() - (nearDepth + farDepth)*direction);
+    // Split the view, the nearer cascades get the thinner slices
+    float logNearDepth = std::max(nearDepth, viewFrustum.getNearClip());
+    float sliceNearDepth = nearDepth;
+    for (int i = 0; i < cascadeCount; ++i) {
+        float sliceFarDepth = farDepth;
+        if (i + 1 < cascadeCount) {
+            float t = (float)(i + 1) / (float)cascadeCount;
+            float uniformDepth = nearDepth + (farDepth - nearDepth) * t;
+            float logDepth = logNearDepth * powf(farDepth / logNearDepth, t);
+            sliceFarDepth = glm::mix(uniformDepth, logDepth, CASCADE_SPLIT_LOG_WEIGHT);
+        }
 
-    const Transform view{ _frustum->getView()};
-    const Transform viewInverse{ view.getInverseMatrix() };
+        auto& cascade = _cascades[i];
+        bool isCached = cacheFarCascades && i > 0;
+        if (cascade._isCached != isCached) {
+            cascade._isCached = isCached;
+            cascade._isFitDirty = true;
+        }
+        fitCascade(i, viewFrustum, sliceNearDepth, sliceFarDepth, orientation);
 
-    auto nearCorners = viewFrustum.getCorners(nearDepth);
-    auto farCorners = viewFrustum.getCorners(farDepth);
+        sliceNearDepth = sliceFarDepth;
+    }
 
-    vec3 min{ viewInverse.transform(nearCorners.bottomLeft) };
-    vec3 max{ min };
-    // Expand keylight frustum  to fit view frustum
-    auto fitFrustum = [&min, &max, &viewInverse](const vec3& viewCorner) {
-        const auto corner = viewInverse.transform(viewCorner);
+    _cascadeCount = cascadeCount;
+    _schemaBuffer.edit<Schema>().cascadeCount = cascadeCount;
+}
 
-        min.x = glm::min(min.x, corner.x);
-        min.y = glm::min(min.y, corner.y);
-        min.z = glm::min(min.z, corner.z);
+void LightStage::Shadow::fitCascade(int cascadeIndex, const ViewFrustum& viewFrustum, float nearDepth, float farDepth,
+        const glm::quat& orientation) {
+    auto& cascade = _cascades[cascadeIndex];
+    const auto direction = orientation * -IDENTITY_FORWARD;
 
-        max.x = glm::max(max.x, corner.x);
-        max.y = glm::max(max.y, corner.y);
-        max.z = glm::max(max.z, corner.z);
+    // Bound the slice with a sphere, its radius does not change as the view turns
+    auto nearCorners = viewFrustum.getCorners(nearDepth);
+    auto farCorners = viewFrustum.getCorners(farDepth);
+    const glm::vec3 corners[] = {
+        nearCorners.topLeft, nearCorners.topRight, nearCorners.bottomLeft, nearCorners.bottomRight,
+        farCorners.topLeft, farCorners.topRight, farCorners.bottomLeft, farCorners.bottomRight
     };
-    fitFrustum(nearCorners.bottomRight);
-    fitFrustum(nearCorners.topLeft);
-    fitFrustum(nearCorners.topRight);
-    fitFrustum(farCorners.bottomLeft);
-    fitFrustum(farCorners.bottomRight);
-    fitFrustum(farCorners.topLeft);
-    fitFrustum(farCorners.topRight);
+    glm::vec3 center(0.0f);
+    for (const auto& corner : corners) {
+        center += corner;
+    }
+    center /= (float)(sizeof(corners) / sizeof(corners[0]));
+    float sliceRadius = 0.0f;
+    for (const auto& corner : corners) {
+        sliceRadius = std::max(sliceRadius, glm::distance(center, corner));
+    }
+    sliceRadius = ceilf(sliceRadius / CASCADE_RADIUS_STEP) * CASCADE_RADIUS_STEP;
 
-    glm::mat4 ortho = glm::ortho<float>(min.x, max.x, min.y, max.y, -max.z, -min.z);
-    _frustum->setProjection(ortho);
+    float fitRadius = cascade._isCached ? sliceRadius * (1.0f + CACHED_CASCADE_MARGIN) : sliceRadius;
+    glm::vec3 lightCenter = glm::inverse(orientation) * center;
 
-    // Calculate the frustum's internal state
-    _frustum->calculate();
+    // A cached cascade stays put as long as the slice is within its fit
+    if (cascade._isCached && cascade._fitRadius == fitRadius && cascade._lightDirection == direction &&
+        glm::distance(lightCenter, cascade._fitCenter) + sliceRadius <= fitRadius) {
+        return;
+    }
 
-    // Update the buffer
-    _schemaBuffer.edit<Schema>().projection = ortho;
-    _schemaBuffer.edit<Schema>().viewInverse = viewInverse.getMatrix();
-}
+    // Snap the fit to the texels of the cascade, for its edges not to shimmer as it moves
+    float texelSize = 2.0f * fitRadius / (float)MAP_SIZE;
+    lightCenter.x = floorf(lightCenter.x / texelSize) * texelSize;
+    lightCenter.y = floorf(lightCenter.y / texelSize) * texelSize;
 
-const glm::mat4& LightStage::Shadow::getView() const {
-    return _frustum->getView();
-}
+    cascade._fitCenter = lightCenter;
+    cascade._fitRadius = fitRadius;
+    cascade._lightDirection = direction;
+    cascade._isFitDirty = true;
 
-const glm::mat4& LightStage::Shadow::getProjection() const {
-    return _frustum->getProjection();
+    // Position the keylight frustum so that casters up to the radius of the fit toward the light are in
+    auto& frustum = *cascade._frustum;
+    frustum.setOrientation(orientation);
+    frustum.setPosition(orientation * lightCenter - 2.0f * fitRadius * direction);
+    frustum.setProjection(glm::ortho<float>(-fitRadius, fitRadius, -fitRadius, fitRadius, 0.0f, 3.0f * fitRadius));
+
+    // Calculate the frustum's internal state
+    frustum.calculate();
+
+    // Update the buffer, from world to the texture coordinates and depth of the cascade
+    static const glm::mat4 TEXCOORD_BIAS_MATRIX(
+        0.5f, 0.0f, 0.0f, 0.0f,
+        0.0f, 0.5f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.5f, 0.0f,
+        0.5f, 0.5f, 0.5f, 1.0f);
+    _schemaBuffer.edit<Schema>().reprojection[cascadeIndex] =
+        TEXCOORD_BIAS_MATRIX * frustum.getProjection() * glm::inverse(frustum.getView());
 }
 
 LightStage::Index LightStage::findLight(const LightPointer& light) const {
@@ -12,6 +12,7 @@
 #ifndef hifi_render_utils_LightStage_h
 #define hifi_render_utils_LightStage_h
 
+#include <array>
 #include <set>
 #include <unordered_map>
 
@@ -44,32 +45,77 @@ public:
     class Shadow {
     public:
         using UniformBufferView = gpu::BufferView;
+        // Size of the map of a single cascade
         static const int MAP_SIZE = 1024;
+        static const int MAX_CASCADE_COUNT = 4;
+        // The cascades are laid out two by two in the same shadow map
+        static const int ATLAS_SIZE = 2 * MAP_SIZE;
 
-        Shadow(model::LightPointer light);
+        // A slice of the view, seen from the light
+        class Cascade {
+        public:
+            Cascade();
+
+            const std::shared_ptr<ViewFrustum>& getFrustum() const { return _frustum; }
+
+            const glm::mat4& getView() const;
+            const glm::mat4& getProjection() const;
+
+            // Region of the shadow map the cascade is rendered in
+            glm::ivec4 getViewport() const { return _viewport; }
+
+            // A cached cascade is fit with a margin around the slice, so that it does not move with every step
+            // of the view, and only needs to be rendered again when its fit or its casters change
+            bool isCached() const { return _isCached; }
+            bool needsRender(uint64_t casterSignature) const;
+            void setRendered(uint64_t casterSignature);
 
-        void setKeylightFrustum(const ViewFrustum& viewFrustum, float nearDepth, float farDepth);
+        protected:
+            std::shared_ptr<ViewFrustum> _frustum;
+            glm::ivec4 _viewport;
 
-        const std::shared_ptr<ViewFrustum> getFrustum() const { return _frustum; }
+            glm::vec3 _lightDirection;
+            glm::vec3 _fitCenter; // in light space
+            float _fitRadius { 0.0f };
+            bool _isCached { false };
+            bool _isFitDirty { true };
+            uint64_t _casterSignature { 0 };
 
-        const glm::mat4& getView() const;
-        const glm::mat4& getProjection() const;
+            friend class Shadow;
+        };
+
+        Shadow(model::LightPointer light);
+
+        // Split the view between nearDepth and farDepth in cascadeCount slices, and fit a cascade around each slice.
+        // All but the first cascade are cached if cacheFarCascades is set.
+        void setKeylightCascadeFrustums(const ViewFrustum& viewFrustum, float nearDepth, float farDepth,
+            int cascadeCount, bool cacheFarCascades);
+
+        int getCascadeCount() const { return _cascadeCount; }
+        const Cascade& getCascade(int cascadeIndex) const { return _cascades[cascadeIndex]; }
+        Cascade& editCascade(int cascadeIndex) { return _cascades[cascadeIndex]; }
 
         const UniformBufferView& getBuffer() const { return _schemaBuffer; }
 
         gpu::FramebufferPointer framebuffer;
         gpu::TexturePointer map;
     protected:
+        void fitCascade(int cascadeIndex, const ViewFrustum& viewFrustum, float nearDepth, float farDepth,
+            const glm::quat& orientation);
+
         model::LightPointer _light;
-        std::shared_ptr<ViewFrustum> _frustum;
+        std::array<Cascade, MAX_CASCADE_COUNT> _cascades;
+        int _cascadeCount { 1 };
 
         class Schema {
         public:
-            glm::mat4 projection;
-            glm::mat4 viewInverse;
+            // World to cascade texture coordinates and depth
+            glm::mat4 reprojection[MAX_CASCADE_COUNT];
 
             glm::float32 bias = 0.005f;
-            glm::float32 scale = 1 / MAP_SIZE;
+            glm::float32 scale = 1.0f / ATLAS_SIZE;
+            glm::int32 cascadeCount = 1;
+            glm::float32 spare = 0.0f;
         };
         UniformBufferView _schemaBuffer = nullptr;
         
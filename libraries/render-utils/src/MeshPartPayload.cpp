@@ -11,6 +11,8 @@
 
 #include "MeshPartPayload.h"
 
+#include <glm/gtx/component_wise.hpp>
+
 #include <PerfStat.h>
 
 #include "DeferredLightingEffect.h"
@@ -58,6 +60,7 @@ void MeshPartPayload::updateMeshPart(const std::shared_ptr<const model::Mesh>& d
         _drawPart = _drawMesh->getPartBuffer().get<model::Mesh::Part>(partIndex);
         _localBound = _drawMesh->evalPartBound(partIndex);
     }
+    _lodLevel = 0;
 }
 
 void MeshPartPayload::updateTransform(const Transform& transform, const Transform& offsetTransform) {
@@ -113,12 +116,33 @@ ShapeKey MeshPartPayload::getShapeKey() const {
     return builder.build();
 }
 
+const model::Mesh::Part* MeshPartPayload::getLODPart() const {
+    if (_lodLevel <= 0 || !_drawMesh || _lodLevel > (int)_drawMesh->getLODs().size()) {
+        return nullptr;
+    }
+    const auto& parts = _drawMesh->getLODs()[_lodLevel - 1].parts;
+    return (_partIndex >= 0 && _partIndex < (int)parts.size()) ? &parts[_partIndex] : nullptr;
+}
+
+int MeshPartPayload::getDrawnNumIndices() const {
+    auto lodPart = getLODPart();
+    return lodPart ? lodPart->_numIndices : _drawPart._numIndices;
+}
+
 void MeshPartPayload::drawCall(gpu::Batch& batch) const {
+    auto lodPart = getLODPart();
+    if (lodPart) {
+        // the level's indices are in a buffer of their own, over the same vertices
+        const auto& lodIndexBuffer = _drawMesh->getLODIndexBuffer();
+        batch.setIndexBuffer(gpu::UINT32, lodIndexBuffer._buffer, lodIndexBuffer._offset);
+        batch.drawIndexed(gpu::TRIANGLES, lodPart->_numIndices, lodPart->_startIndex);
+        return;
+    }
     batch.drawIndexed(gpu::TRIANGLES, _drawPart._numIndices, _drawPart._startIndex);
 }
 
 void MeshPartPayload::bindMesh(gpu::Batch& batch) {
-    batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), 0);
+    batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), _drawMesh->getIndexBuffer()._offset);
 
     batch.setInputFormat((_drawMesh->getVertexFormat()));
 
@@ -131,17 +155,22 @@ void MeshPartPayload::bindMesh(gpu::Batch& batch) {
 }
 
 void MeshPartPayload::bindMaterial(gpu::Batch& batch, const ShapePipeline::LocationsPointer locations, bool enableTextures) const {
-    if (!_drawMaterial) {
+    bindMaterial(batch, _drawMaterial, locations, enableTextures);
+}
+
+void MeshPartPayload::bindMaterial(gpu::Batch& batch, const std::shared_ptr<const model::Material>& material,
+                                   const ShapePipeline::LocationsPointer locations, bool enableTextures) {
+    if (!material) {
         return;
     }
 
     auto textureCache = DependencyManager::get<TextureCache>();
 
-    batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::MATERIAL, _drawMaterial->getSchemaBuffer());
-    batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::TEXMAPARRAY, _drawMaterial->getTexMapArrayBuffer());
+    batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::MATERIAL, material->getSchemaBuffer());
+    batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::TEXMAPARRAY, material->getTexMapArrayBuffer());
 
-    const auto& materialKey = _drawMaterial->getKey();
-    const auto& textureMaps = _drawMaterial->getTextureMaps();
+    const auto& materialKey = material->getKey();
+    const auto& textureMaps = material->getTextureMaps();
 
     int numUnlit = 0;
     if (materialKey.isUnlit()) {
@@ -254,6 +283,74 @@ void MeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline::Loca
 }
 
 
+// Textures are assumed to be stretched across their part once, tiling and uv transforms would need more detail, so
+// ask for one mip more than that
+static const int TEXTURE_MIP_REQUEST_BIAS = 1;
+
+float MeshPartPayload::evalScreenSize(RenderArgs* args) const {
+    const auto& viewFrustum = args->getViewFrustum();
+    const float MIN_DISTANCE = 0.01f;
+    float distance = std::max(glm::distance(viewFrustum.getPosition(), _worldBound.calcCenter()), MIN_DISTANCE);
+    float pixelsPerRadian = viewFrustum.getProjection()[1][1] * 0.5f * (float)args->_viewport.w;
+    return glm::compMax(_worldBound.getDimensions()) / distance * pixelsPerRadian;
+}
+
+// no triangle of a level is drawn instead of the full detail one if its cells would be any larger on screen than this
+static const float MAX_LOD_CELL_PIXELS = 2.0f;
+// and the ones on either side of that have to be this far past it to be switched to, so that parts don't flicker
+static const float LOD_HYSTERESIS = 1.25f;
+
+void MeshPartPayload::updateLODLevel(RenderArgs* args) {
+    if (!_drawMesh || _drawMesh->getLODs().empty()) {
+        _lodLevel = 0;
+        return;
+    }
+    if (args->_renderMode != RenderArgs::DEFAULT_RENDER_MODE) {
+        return;
+    }
+
+    float localSize = glm::compMax(_localBound.getDimensions());
+    if (localSize <= 0.0f) {
+        _lodLevel = 0;
+        return;
+    }
+    // the cell sizes are in mesh space, whatever the model is scaled to
+    float pixelsPerUnit = evalScreenSize(args) / localSize;
+
+    const auto& lods = _drawMesh->getLODs();
+    _lodLevel = std::min(_lodLevel, (int)lods.size());
+    while (_lodLevel > 0 && lods[_lodLevel - 1].cellSize * pixelsPerUnit > MAX_LOD_CELL_PIXELS * LOD_HYSTERESIS) {
+        --_lodLevel;
+    }
+    while (_lodLevel < (int)lods.size() && lods[_lodLevel].cellSize * pixelsPerUnit < MAX_LOD_CELL_PIXELS / LOD_HYSTERESIS) {
+        ++_lodLevel;
+    }
+}
+
+void MeshPartPayload::requestTextureMips(RenderArgs* args) const {
+    // Only the main view decides how much detail is needed, shadows and secondary cameras get by with what it asks for
+    if (!_drawMaterial || !args->_enableTexturing || args->_renderMode != RenderArgs::DEFAULT_RENDER_MODE) {
+        return;
+    }
+
+    float screenSize = std::max(evalScreenSize(args), 1.0f);
+
+    for (const auto& textureMap : _drawMaterial->getTextureMaps()) {
+        if (!textureMap.second || !textureMap.second->isDefined()) {
+            continue;
+        }
+        auto texture = textureMap.second->getTextureView()._texture;
+        if (!texture) {
+            continue;
+        }
+
+        // One texel per pixel
+        float textureSize = (float)std::max(texture->getWidth(), texture->getHeight());
+        int mip = (int)floorf(log2f(std::max(textureSize / screenSize, 1.0f))) - TEXTURE_MIP_REQUEST_BIAS;
+        texture->requestMip((uint16_t)glm::clamp(mip, 0, (int)texture->getNumMips() - 1));
+    }
+}
+
 void MeshPartPayload::render(RenderArgs* args) {
     PerformanceTimer perfTimer("MeshPartPayload::render");
 
@@ -270,6 +367,8 @@ void MeshPartPayload::render(RenderArgs* args) {
 
     // apply material properties
     bindMaterial(batch, locations, args->_enableTexturing);
+    requestTextureMips(args);
+    updateLODLevel(args);
 
     if (args) {
         args->_details._materialSwitches++;
@@ -283,7 +382,7 @@ void MeshPartPayload::render(RenderArgs* args) {
 
     if (args) {
         const int INDICES_PER_TRIANGLE = 3;
-        args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+        args->_details._trianglesRendered += getDrawnNumIndices() / INDICES_PER_TRIANGLE;
     }
 }
 
@@ -318,6 +417,17 @@ template <> const ShapeKey shapeGetShapeKey(const ModelMeshPartPayload::Pointer&
 template <> void payloadRender(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args) {
     return payload->render(args);
 }
+
+template <> bool payloadCanRenderConcurrently(const ModelMeshPartPayload::Pointer& payload) {
+    return payload && payload->canRenderConcurrently();
+}
+
+template <> uint64_t payloadGetInstanceKey(const ModelMeshPartPayload::Pointer& payload) {
+    if (payload) {
+        return payload->getInstanceKey();
+    }
+    return 0;
+}
 }
 
 ModelMeshPartPayload::ModelMeshPartPayload(ModelPointer model, int _meshIndex, int partIndex, int shapeIndex, const Transform& transform, const Transform& offsetTransform) :
@@ -359,11 +469,13 @@ void ModelMeshPartPayload::notifyLocationChanged() {
 }
 
 void ModelMeshPartPayload::updateTransformForSkinnedMesh(const Transform& renderTransform, const Transform& boundTransform,
-        const gpu::BufferPointer& buffer) {
+        const Model::MeshState& meshState) {
     _transform = renderTransform;
     _worldBound = _adjustedLocalBound;
     _worldBound.transform(boundTransform);
-    _clusterBuffer = buffer;
+    _clusterBuffer = meshState.clusterBuffer;
+    _skinPoseBuffer = meshState.skinPoseBuffer;
+    _clusterBindBuffer = meshState.clusterBindBuffer;
 }
 
 ItemKey ModelMeshPartPayload::getKey() const {
@@ -482,6 +594,9 @@ ShapeKey ModelMeshPartPayload::getShapeKey() const {
     }
     if (isSkinned) {
         builder.withSkinned();
+        if (_skinPoseBuffer) {
+            builder.withDualQuatSkinned();
+        }
     }
     if (wireframe) {
         builder.withWireframe();
@@ -491,11 +606,11 @@ ShapeKey ModelMeshPartPayload::getShapeKey() const {
 
 void ModelMeshPartPayload::bindMesh(gpu::Batch& batch) {
     if (!_isBlendShaped) {
-        batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), 0);
+        batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), _drawMesh->getIndexBuffer()._offset);
         batch.setInputFormat((_drawMesh->getVertexFormat()));
         batch.setInputStream(0, _drawMesh->getVertexStream());
     } else {
-        batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), 0);
+        batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), _drawMesh->getIndexBuffer()._offset);
         batch.setInputFormat((_drawMesh->getVertexFormat()));
 
         ModelPointer model = _model.lock();
@@ -504,7 +619,7 @@ void ModelMeshPartPayload::bindMesh(gpu::Batch& batch) {
             batch.setInputBuffer(1, model->_blendedVertexBuffers[_meshIndex], _drawMesh->getNumVertices() * sizeof(glm::vec3), sizeof(glm::vec3));
             batch.setInputStream(2, _drawMesh->getVertexStream().makeRangedStream(2));
         } else {
-            batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), 0);
+            batch.setIndexBuffer(gpu::UINT32, (_drawMesh->getIndexBuffer()._buffer), _drawMesh->getIndexBuffer()._offset);
             batch.setInputFormat((_drawMesh->getVertexFormat()));
             batch.setInputStream(0, _drawMesh->getVertexStream());
         }
@@ -517,11 +632,19 @@ void ModelMeshPartPayload::bindMesh(gpu::Batch& batch) {
     }
 }
 
+void ModelMeshPartPayload::bindSkinning(gpu::Batch& batch, const gpu::BufferPointer& clusterBuffer,
+        const gpu::BufferPointer& skinPoseBuffer) const {
+    if (skinPoseBuffer && _clusterBindBuffer) {
+        batch.setResourceBuffer(ShapePipeline::Slot::RESOURCE_BUFFER::SKINNING_POSES, skinPoseBuffer);
+        batch.setResourceBuffer(ShapePipeline::Slot::RESOURCE_BUFFER::SKINNING_CLUSTERS, _clusterBindBuffer);
+    } else if (clusterBuffer) {
+        batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::SKINNING, clusterBuffer);
+    }
+}
+
 void ModelMeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline::LocationsPointer locations, RenderArgs::RenderMode renderMode) const {
     // Still relying on the raw data from the model
-    if (_clusterBuffer) {
-        batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::SKINNING, _clusterBuffer);
-    }
+    bindSkinning(batch, _clusterBuffer, _skinPoseBuffer);
     batch.setModelTransform(_transform);
 }
 
@@ -582,6 +705,11 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
         return;
     }
 
+    if (canRenderInstanced(args)) {
+        renderInstanced(args);
+        return;
+    }
+
     gpu::Batch& batch = *(args->_batch);
     auto locations =  args->_shapePipeline->locations;
     assert(locations);
@@ -593,6 +721,8 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
 
     // apply material properties
     bindMaterial(batch, locations, args->_enableTexturing);
+    requestTextureMips(args);
+    updateLODLevel(args);
 
     args->_details._materialSwitches++;
 
@@ -602,6 +732,70 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
         drawCall(batch);
     }
 
+    const int INDICES_PER_TRIANGLE = 3;
+    args->_details._trianglesRendered += getDrawnNumIndices() / INDICES_PER_TRIANGLE;
+}
+
+uint64_t ModelMeshPartPayload::getInstanceKey() const {
+    if (!_drawMesh || !_drawMaterial || _drawMaterial->getKey().isTranslucent() ||
+        _isSkinned || _isBlendShaped || _clusterBuffer || _skinPoseBuffer || _fadeState != FADE_COMPLETE) {
+        return 0;
+    }
+
+    // The same for the parts sharing mesh, part and material
+    uint64_t key = std::hash<const void*>()(_drawMesh.get());
+    key ^= (uint64_t)_partIndex + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    key ^= std::hash<const void*>()(_drawMaterial.get()) + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    return key ? key : 1;
+}
+
+bool ModelMeshPartPayload::canRenderInstanced(RenderArgs* args) const {
+    return args->_shapePipeline && getInstanceKey() != 0;
+}
+
+void ModelMeshPartPayload::renderInstanced(RenderArgs* args) {
+    gpu::Batch& batch = *(args->_batch);
+
+    // Recorded along with the instance name, the instanced draw reads it back per instance
+    batch.setModelTransform(_transform);
+
+    auto pipeline = args->_shapePipeline;
+    bool enableTextures = args->_enableTexturing;
+    uint64_t instanceKey = getInstanceKey();
+    if (_instanceName.empty() || pipeline != _instanceNamePipeline || instanceKey != _instanceNameKey ||
+        enableTextures != _instanceNameTextured) {
+        _instanceName = "model_part_" + std::to_string((size_t)_drawMesh.get()) + "_" + std::to_string(_partIndex) +
+            "_" + std::to_string((size_t)_drawMaterial.get()) + "_" +
+            std::to_string(std::hash<render::ShapePipelinePointer>()(pipeline)) + (enableTextures ? "" : "_untextured");
+        _instanceNamePipeline = pipeline;
+        _instanceNameKey = instanceKey;
+        _instanceNameTextured = enableTextures;
+    }
+
+    // The draw happens once the batch is finished, when this payload may be gone, so it keeps what it needs
+    auto drawMesh = _drawMesh;
+    auto drawMaterial = _drawMaterial;
+    auto drawPart = _drawPart;
+    bool hasColorAttrib = _hasColorAttrib;
+    batch.setupNamedCalls(_instanceName, [args, pipeline, enableTextures, drawMesh, drawMaterial, drawPart, hasColorAttrib](
+            gpu::Batch& batch, gpu::Batch::NamedBatchData& data) {
+        batch.setPipeline(pipeline->pipeline);
+        pipeline->prepare(batch, args);
+
+        batch.setIndexBuffer(gpu::UINT32, (drawMesh->getIndexBuffer()._buffer), drawMesh->getIndexBuffer()._offset);
+        batch.setInputFormat((drawMesh->getVertexFormat()));
+        batch.setInputStream(0, drawMesh->getVertexStream());
+        if (!hasColorAttrib) {
+            batch._glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+        }
+
+        MeshPartPayload::bindMaterial(batch, drawMaterial, pipeline->locations, enableTextures);
+
+        batch.drawIndexedInstanced((gpu::uint32)data.count(), gpu::TRIANGLES, drawPart._numIndices, drawPart._startIndex);
+    });
+
+    requestTextureMips(args);
+
     const int INDICES_PER_TRIANGLE = 3;
     args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
 }
@@ -617,3 +811,27 @@ void ModelMeshPartPayload::computeAdjustedLocalBound(const QVector<glm::mat4>& c
         }
     }
 }
+
+void ModelMeshPartPayload::computeAdjustedLocalBound(const QVector<FBXCluster>& clusters, const AnimPoseVec& jointPoses) {
+    if (_clusterBindBounds.size() != (size_t)clusters.size()) {
+        _clusterBindBounds.resize(clusters.size());
+        for (int i = 0; i < clusters.size(); ++i) {
+            _clusterBindBounds[i] = _localBound;
+            _clusterBindBounds[i].transform(clusters[i].inverseBindMatrix);
+        }
+    }
+
+    _adjustedLocalBound = _localBound;
+    for (int i = 0; i < clusters.size(); ++i) {
+        int jointIndex = clusters[i].jointIndex;
+        AABox clusterBound = _clusterBindBounds[i];
+        if (jointIndex >= 0 && jointIndex < (int)jointPoses.size()) {
+            clusterBound.transform((glm::mat4)jointPoses[jointIndex]);
+        }
+        if (i == 0) {
+            _adjustedLocalBound = clusterBound;
+        } else {
+            _adjustedLocalBound += clusterBound;
+        }
+    }
+}
@@ -54,8 +54,18 @@ public:
     void drawCall(gpu::Batch& batch) const;
     virtual void bindMesh(gpu::Batch& batch);
     virtual void bindMaterial(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, bool enableTextures) const;
+    static void bindMaterial(gpu::Batch& batch, const std::shared_ptr<const model::Material>& material,
+                             const render::ShapePipeline::LocationsPointer locations, bool enableTextures);
     virtual void bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, RenderArgs::RenderMode renderMode) const;
 
+    // Tells the gpu backend how much of the material's textures the part needs, from its size on screen
+    void requestTextureMips(RenderArgs* args) const;
+
+    // Picks the coarsest level of the mesh whose triangles are still small on screen, the main view picks it for the
+    // other views too
+    void updateLODLevel(RenderArgs* args);
+    int getDrawnNumIndices() const;
+
     // Payload resource cached values
     Transform _drawTransform;
     Transform _transform;
@@ -69,6 +79,11 @@ public:
 
     std::shared_ptr<const model::Material> _drawMaterial;
     model::Mesh::Part _drawPart;
+    int _lodLevel { 0 }; // 0 for the part itself, the level of the mesh one higher otherwise
+
+    // the pixels the part's largest dimension covers in the view
+    float evalScreenSize(RenderArgs* args) const;
+    const model::Mesh::Part* getLODPart() const;
 
     size_t getVerticesCount() const { return _drawMesh ? _drawMesh->getNumVertices() : 0; }
     size_t getMaterialTextureSize() { return _drawMaterial ? _drawMaterial->getTextureSize() : 0; }
@@ -93,7 +108,7 @@ public:
     void notifyLocationChanged() override;
     void updateTransformForSkinnedMesh(const Transform& renderTransform,
             const Transform& boundTransform,
-            const gpu::BufferPointer& buffer);
+            const Model::MeshState& meshState);
 
     float computeFadeAlpha();
 
@@ -103,15 +118,27 @@ public:
     render::ShapeKey getShapeKey() const override; // shape interface
     void render(RenderArgs* args) override;
 
+    // Once faded in and with its material settled, rendering a part only records into the batch
+    bool canRenderConcurrently() const { return _fadeState == FADE_COMPLETE && !_materialNeedsUpdate; }
+
     // ModelMeshPartPayload functions to perform render
     void bindMesh(gpu::Batch& batch) override;
     void bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, RenderArgs::RenderMode renderMode) const override;
 
     void initCache();
 
+    // Opaque parts that are neither skinned, blended nor fading only differ from other instances of their model by
+    // their transform, and are drawn together with them
+    uint64_t getInstanceKey() const;
+    bool canRenderInstanced(RenderArgs* args) const;
+    void renderInstanced(RenderArgs* args);
+
     void computeAdjustedLocalBound(const QVector<glm::mat4>& clusterMatrices);
+    void computeAdjustedLocalBound(const QVector<FBXCluster>& clusters, const AnimPoseVec& jointPoses);
 
     gpu::BufferPointer _clusterBuffer;
+    gpu::BufferPointer _skinPoseBuffer;
+    gpu::BufferPointer _clusterBindBuffer;
     ModelWeakPointer _model;
 
     int _meshIndex;
@@ -121,9 +148,21 @@ public:
     bool _isBlendShaped { false };
     bool _materialNeedsUpdate { true };
 
+protected:
+    void bindSkinning(gpu::Batch& batch, const gpu::BufferPointer& clusterBuffer, const gpu::BufferPointer& skinPoseBuffer) const;
+
 private:
+    // The local bound in the bind pose of each cluster
+    std::vector<AABox> _clusterBindBounds;
+
     quint64 _fadeStartTime { 0 };
     uint8_t _fadeState { FADE_WAITING_TO_START };
+
+    // Name of the instanced draw the part was last recorded in, kept as long as the pipeline and key are the same
+    std::string _instanceName;
+    render::ShapePipelinePointer _instanceNamePipeline;
+    uint64_t _instanceNameKey { 0 };
+    bool _instanceNameTextured { true };
 };
 
 namespace render {
@@ -132,6 +171,8 @@ namespace render {
     template <> int payloadGetLayer(const ModelMeshPartPayload::Pointer& payload);
     template <> const ShapeKey shapeGetShapeKey(const ModelMeshPartPayload::Pointer& payload);
     template <> void payloadRender(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args);
+    template <> bool payloadCanRenderConcurrently(const ModelMeshPartPayload::Pointer& payload);
+    template <> uint64_t payloadGetInstanceKey(const ModelMeshPartPayload::Pointer& payload);
 }
 
 #endif // hifi_MeshPartPayload_h
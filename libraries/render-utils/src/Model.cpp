@@ -116,6 +116,7 @@ Model::~Model() {
 }
 
 AbstractViewStateInterface* Model::_viewState = NULL;
+bool Model::_dualQuaternionSkinningEnabled = true;
 
 bool Model::needsFixupInScene() const {
     return (_needsFixupInScene || !_addedToScene) && !_needsReload && isLoaded();
@@ -250,7 +251,7 @@ void Model::updateRenderItems() {
                         if (state.clusterMatrices.size() == 1) {
                             renderTransform = modelTransform.worldTransform(Transform(state.clusterMatrices[0]));
                         }
-                        data.updateTransformForSkinnedMesh(renderTransform, modelTransform, state.clusterBuffer);
+                        data.updateTransformForSkinnedMesh(renderTransform, modelTransform, state);
                     }
                 }
             });
@@ -861,6 +862,18 @@ void Model::setURL(const QUrl& url) {
     onInvalidate();
 }
 
+void Model::setLoadingPriority(float priority) {
+    if (priority == _loadingPriority) {
+        return;
+    }
+    _loadingPriority = priority;
+
+    auto& resource = _renderWatcher.getResource();
+    if (resource && !resource->isLoaded()) {
+        resource->setLoadPriority(this, _loadingPriority);
+    }
+}
+
 void Model::loadURLFinished(bool success) {
     if (!success) {
         _visualGeometryRequestFailed = true;
@@ -1095,10 +1108,111 @@ void Model::updateRig(float deltaTime, glm::mat4 parentTransform) {
 void Model::computeMeshPartLocalBounds() {
     for (auto& part : _modelMeshRenderItems) {
         const Model::MeshState& state = _meshStates.at(part->_meshIndex);
-        part->computeAdjustedLocalBound(state.clusterMatrices);
+        if (state.skinPoseBuffer) {
+            // No cluster matrices to bound the part with, the joints move the bounds of the clusters instead
+            const FBXMesh& mesh = getFBXGeometry().meshes.at(part->_meshIndex);
+            part->computeAdjustedLocalBound(mesh.clusters, _rig.getJointPoses());
+        } else {
+            part->computeAdjustedLocalBound(state.clusterMatrices);
+        }
+    }
+}
+
+bool Model::packSkinPose(const AnimPose& pose, SkinPose& skinPose) {
+    const float UNIFORM_SCALE_EPSILON = 0.0001f;
+    const glm::vec3& scale = pose.scale();
+    float maxScale = glm::max(fabsf(scale.x), glm::max(fabsf(scale.y), fabsf(scale.z)));
+    if (scale.x < 0.0f || fabsf(scale.y - scale.x) > UNIFORM_SCALE_EPSILON * maxScale ||
+        fabsf(scale.z - scale.x) > UNIFORM_SCALE_EPSILON * maxScale) {
+        return false;
+    }
+    skinPose.rotation = pose.rot();
+    skinPose.translationScale = glm::vec4(pose.trans(), scale.x);
+    return true;
+}
+
+void Model::uploadSkinPoses(const std::vector<SkinPose>& skinPoses, gpu::BufferPointer& buffer) {
+    auto size = skinPoses.size() * sizeof(SkinPose);
+    if (!buffer) {
+        buffer = std::make_shared<gpu::Buffer>(size, (const gpu::Byte*) skinPoses.data());
+    } else if (buffer->getSize() != size) {
+        buffer->setData(size, (const gpu::Byte*) skinPoses.data());
+    } else {
+        buffer->setSubData(0, size, (const gpu::Byte*) skinPoses.data());
     }
 }
 
+void Model::initClusterBinds() {
+    _areClusterBindsInitialized = true;
+    _canSkinWithDualQuaternions = true;
+
+    const FBXGeometry& geometry = getFBXGeometry();
+    std::vector<SkinClusterBind> clusterBinds;
+    for (int i = 0; i < _meshStates.size() && _canSkinWithDualQuaternions; i++) {
+        const FBXMesh& mesh = geometry.meshes.at(i);
+        if (mesh.clusters.size() <= 1) {
+            continue;
+        }
+
+        clusterBinds.resize(mesh.clusters.size());
+        for (int j = 0; j < mesh.clusters.size(); j++) {
+            const FBXCluster& cluster = mesh.clusters.at(j);
+            AnimPose bindPose(cluster.inverseBindMatrix);
+
+            // A bind matrix that doesn't come back from its pose is sheared, it can't be skinned as a pose
+            const float BIND_MATRIX_EPSILON = 0.0001f;
+            glm::mat4 bindMatrix = bindPose;
+            bool isBindPose = true;
+            for (int k = 0; k < 4; k++) {
+                glm::vec4 delta = bindMatrix[k] - cluster.inverseBindMatrix[k];
+                float extent = glm::max(1.0f, glm::length(cluster.inverseBindMatrix[k]));
+                isBindPose = isBindPose && glm::length(delta) <= BIND_MATRIX_EPSILON * extent;
+            }
+            if (!isBindPose || !packSkinPose(bindPose, clusterBinds[j].pose)) {
+                _canSkinWithDualQuaternions = false;
+                break;
+            }
+            clusterBinds[j].jointIndex = glm::vec4((float)cluster.jointIndex, 0.0f, 0.0f, 0.0f);
+        }
+
+        if (_canSkinWithDualQuaternions) {
+            _meshStates[i].clusterBindBuffer = std::make_shared<gpu::Buffer>(clusterBinds.size() * sizeof(SkinClusterBind),
+                (const gpu::Byte*) clusterBinds.data());
+        }
+    }
+
+    if (!_canSkinWithDualQuaternions) {
+        qCDebug(renderutils) << "Model" << _url << "has sheared or non-uniformly scaled clusters, skinning them with matrices";
+        for (auto& state : _meshStates) {
+            state.clusterBindBuffer.reset();
+        }
+    }
+}
+
+bool Model::updateSkinPoses() {
+    if (!_dualQuaternionSkinningEnabled) {
+        return false;
+    }
+    if (!_areClusterBindsInitialized) {
+        initClusterBinds();
+    }
+    if (!_canSkinWithDualQuaternions) {
+        return false;
+    }
+
+    // O(joints) for the whole model, the meshes share the poses
+    const AnimPoseVec& jointPoses = _rig.getJointPoses();
+    _skinPoses.resize(jointPoses.size());
+    for (size_t i = 0; i < jointPoses.size(); i++) {
+        if (!packSkinPose(jointPoses[i], _skinPoses[i])) {
+            // Typically a non-uniform scale set on the model, back to its cluster matrices until it is uniform again
+            return false;
+        }
+    }
+    uploadSkinPoses(_skinPoses, _skinPoseBuffer);
+    return true;
+}
+
 // virtual
 void Model::updateClusterMatrices() {
     PerformanceTimer perfTimer("Model::updateClusterMatrices");
@@ -1108,9 +1222,18 @@ void Model::updateClusterMatrices() {
     }
     _needsUpdateClusterMatrices = false;
     const FBXGeometry& geometry = getFBXGeometry();
+    bool isSkinningWithDualQuaternions = updateSkinPoses();
     for (int i = 0; i < _meshStates.size(); i++) {
         MeshState& state = _meshStates[i];
         const FBXMesh& mesh = geometry.meshes.at(i);
+
+        // The vertex shader composes the joint poses with the bind poses of the clusters
+        if (isSkinningWithDualQuaternions && state.clusterBindBuffer) {
+            state.skinPoseBuffer = _skinPoseBuffer;
+            continue;
+        }
+        state.skinPoseBuffer.reset();
+
         for (int j = 0; j < mesh.clusters.size(); j++) {
             const FBXCluster& cluster = mesh.clusters.at(j);
             auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
@@ -1195,6 +1318,10 @@ void Model::deleteGeometry() {
     _deleteGeometryCounter++;
     _blendedVertexBuffers.clear();
     _meshStates.clear();
+    _skinPoses.clear();
+    _skinPoseBuffer.reset();
+    _areClusterBindsInitialized = false;
+    _canSkinWithDualQuaternions = false;
     _rig.destroyAnimGraph();
     _blendedBlendshapeCoefficients.clear();
     _renderGeometry.reset();
@@ -1388,6 +1515,7 @@ ModelBlender::~ModelBlender() {
 }
 
 void ModelBlender::noteRequiresBlend(ModelPointer model) {
+    Lock lock(_mutex);
     if (_pendingBlenders < QThread::idealThreadCount()) {
         if (model->maybeStartBlender()) {
             _pendingBlenders++;
@@ -1395,10 +1523,7 @@ void ModelBlender::noteRequiresBlend(ModelPointer model) {
         return;
     }
 
-    {
-        Lock lock(_mutex);
-        _modelsRequiringBlends.insert(model);
-    }
+    _modelsRequiringBlends.insert(model);
 }
 
 void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber,
@@ -1406,9 +1531,9 @@ void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber,
     if (model) {
         model->setBlendedVertices(blendNumber, geometry, vertices, normals);
     }
-    _pendingBlenders--;
     {
         Lock lock(_mutex);
+        _pendingBlenders--;
         for (auto i = _modelsRequiringBlends.begin(); i != _modelsRequiringBlends.end();) {
             auto weakPtr = *i;
             _modelsRequiringBlends.erase(i++); // remove front of the set
@@ -69,6 +69,10 @@ public:
 
     static void setAbstractViewStateInterface(AbstractViewStateInterface* viewState) { _viewState = viewState; }
 
+    // Skin the meshes in the vertex shader with the joint poses, rather than with cluster matrices computed per mesh
+    static void setDualQuaternionSkinningEnabled(bool enabled) { _dualQuaternionSkinningEnabled = enabled; }
+    static bool isDualQuaternionSkinningEnabled() { return _dualQuaternionSkinningEnabled; }
+
     Model(QObject* parent = nullptr, SpatiallyNestable* spatiallyNestableOverride = nullptr);
     virtual ~Model();
 
@@ -233,7 +237,8 @@ public:
     virtual bool updateGeometry();
     void setCollisionMesh(model::MeshPointer mesh);
 
-    void setLoadingPriority(float priority) { _loadingPriority = priority; }
+    // also moves the geometry in the download queue if it is still waiting to be requested
+    void setLoadingPriority(float priority);
 
     size_t getRenderInfoVertexCount() const { return _renderInfoVertexCount; }
     size_t getRenderInfoTextureSize();
@@ -245,6 +250,10 @@ public:
     public:
         QVector<glm::mat4> clusterMatrices;
         gpu::BufferPointer clusterBuffer;
+
+        // Set instead of the cluster buffer when skinning with dual quaternions
+        gpu::BufferPointer skinPoseBuffer;
+        gpu::BufferPointer clusterBindBuffer;
     };
 
     const MeshState& getMeshState(int index) { return _meshStates.at(index); }
@@ -321,6 +330,32 @@ protected:
     void snapToRegistrationPoint();
 
     void computeMeshPartLocalBounds();
+
+    // A pose as the dual quaternion skinning reads it: a rotation, then a translation and a uniform scale in w
+    class SkinPose {
+    public:
+        glm::quat rotation;
+        glm::vec4 translationScale;
+    };
+    class SkinClusterBind {
+    public:
+        SkinPose pose;
+        glm::vec4 jointIndex;
+    };
+
+    // False if the pose isn't uniformly scaled, then it can't be skinned with dual quaternions
+    static bool packSkinPose(const AnimPose& pose, SkinPose& skinPose);
+    static void uploadSkinPoses(const std::vector<SkinPose>& skinPoses, gpu::BufferPointer& buffer);
+
+    // Pack the joint poses and the bind poses of the clusters the first time, false if they can't be skinned
+    // with dual quaternions
+    bool updateSkinPoses();
+    void initClusterBinds();
+
+    std::vector<SkinPose> _skinPoses;
+    gpu::BufferPointer _skinPoseBuffer;
+    bool _areClusterBindsInitialized { false };
+    bool _canSkinWithDualQuaternions { false };
     virtual void updateRig(float deltaTime, glm::mat4 parentTransform);
 
     /// Restores the indexed joint to its default position.
@@ -378,6 +413,7 @@ protected:
 
 
     static AbstractViewStateInterface* _viewState;
+    static bool _dualQuaternionSkinningEnabled;
 
     QVector<std::shared_ptr<MeshPartPayload>> _collisionRenderItems;
     QMap<render::ItemID, render::PayloadPointer> _collisionRenderItemsMap;
@@ -429,6 +465,7 @@ class ModelBlender : public QObject, public Dependency {
 public:
 
     /// Adds the specified model to the list requiring vertex blends.
+    /// Thread safe, the cluster matrices of the avatars are updated on several threads.
     void noteRequiresBlend(ModelPointer model);
 
 public slots:
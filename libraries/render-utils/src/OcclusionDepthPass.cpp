@@ -0,0 +1,111 @@
+//
+//  OcclusionDepthPass.cpp
+//  libraries/render-utils/src/
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OcclusionDepthPass.h"
+
+#include <gpu/Context.h>
+#include <gpu/StandardShaderLib.h>
+#include <render/OcclusionStage.h>
+
+#include "occlusionDepth_downsample_frag.h"
+
+const int OcclusionDepthPass_LinearDepthMapSlot = 0;
+
+// Width of the depth read back, its height follows the aspect ratio of the view
+static const int OCCLUSION_DEPTH_WIDTH = 128;
+
+void OcclusionDepthPass::run(const render::RenderContextPointer& renderContext, const Inputs& linearDepthFramebuffer) {
+    assert(renderContext->args);
+    assert(renderContext->args->hasViewFrustum());
+    RenderArgs* args = renderContext->args;
+
+    // Only the main view is culled against the depth, in mono
+    if (args->_renderMode != RenderArgs::DEFAULT_RENDER_MODE || args->isStereo() || !linearDepthFramebuffer) {
+        return;
+    }
+    auto occlusionStage = renderContext->_scene->getStage<render::OcclusionStage>();
+    if (!occlusionStage) {
+        return;
+    }
+
+    auto sourceViewport = args->_viewport;
+    if (sourceViewport.z <= 0 || sourceViewport.w <= 0) {
+        return;
+    }
+    glm::ivec2 size(OCCLUSION_DEPTH_WIDTH, std::max(1, (OCCLUSION_DEPTH_WIDTH * sourceViewport.w) / sourceViewport.z));
+
+    if (!_occlusionDepthFramebuffer || _occlusionDepthFramebuffer->getWidth() != (uint16)size.x ||
+        _occlusionDepthFramebuffer->getHeight() != (uint16)size.y) {
+        auto occlusionDepthTexture = gpu::Texture::createRenderBuffer(gpu::Element(gpu::SCALAR, gpu::FLOAT, gpu::RED),
+            size.x, size.y, gpu::Texture::SINGLE_MIP, gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT));
+        _occlusionDepthFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create("occlusionDepth"));
+        _occlusionDepthFramebuffer->setRenderBuffer(0, occlusionDepthTexture);
+    }
+
+    auto pipeline = getDownsamplePipeline();
+    auto linearDepthTexture = linearDepthFramebuffer->getLinearDepthTexture();
+    auto framebuffer = _occlusionDepthFramebuffer;
+    auto sourceViewportLoc = _sourceViewportLoc;
+    auto destinationSizeLoc = _destinationSizeLoc;
+
+    // The stage gets the depth along with the frustum it was rendered with, a few frames from now
+    std::weak_ptr<render::OcclusionStage> weakOcclusionStage = occlusionStage;
+    ViewFrustum frustum = args->getViewFrustum();
+    auto readbackHandler = [weakOcclusionStage, size, frustum](const std::vector<float>& texels) {
+        auto occlusionStage = weakOcclusionStage.lock();
+        if (occlusionStage && texels.size() == (size_t)(size.x * size.y)) {
+            std::vector<float> depths = texels;
+            occlusionStage->setDepthPyramid(std::make_shared<render::DepthPyramid>(size, std::move(depths), frustum));
+        }
+    };
+
+    gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
+        batch.enableStereo(false);
+
+        glm::ivec4 destinationViewport(0, 0, size.x, size.y);
+        batch.setViewportTransform(destinationViewport);
+        batch.setProjectionTransform(glm::mat4());
+        batch.resetViewTransform();
+        batch.setModelTransform(Transform());
+
+        batch.setFramebuffer(framebuffer);
+        batch.setPipeline(pipeline);
+        batch._glUniform4iv(sourceViewportLoc, 1, (const int*)&sourceViewport);
+        glm::ivec4 destinationSize(size, 0, 0);
+        batch._glUniform4iv(destinationSizeLoc, 1, (const int*)&destinationSize);
+        batch.setResourceTexture(OcclusionDepthPass_LinearDepthMapSlot, linearDepthTexture);
+        batch.draw(gpu::TRIANGLE_STRIP, 4);
+        batch.setResourceTexture(OcclusionDepthPass_LinearDepthMapSlot, nullptr);
+
+        batch.readbackFramebuffer(framebuffer, destinationViewport, readbackHandler);
+    });
+}
+
+const gpu::PipelinePointer& OcclusionDepthPass::getDownsamplePipeline() {
+    if (!_downsamplePipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawViewportQuadTransformTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(occlusionDepth_downsample_frag));
+        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("linearDepthMap"), OcclusionDepthPass_LinearDepthMapSlot));
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        _sourceViewportLoc = program->getUniforms().findLocation("sourceViewport");
+        _destinationSizeLoc = program->getUniforms().findLocation("destinationSize");
+
+        gpu::StatePointer state = gpu::StatePointer(new gpu::State());
+        state->setColorWriteMask(true, false, false, false);
+
+        _downsamplePipeline = gpu::Pipeline::create(program, state);
+    }
+
+    return _downsamplePipeline;
+}
@@ -0,0 +1,45 @@
+//
+//  OcclusionDepthPass.h
+//  libraries/render-utils/src/
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OcclusionDepthPass_h
+#define hifi_OcclusionDepthPass_h
+
+#include <render/Engine.h>
+
+#include "SurfaceGeometryPass.h"
+
+class OcclusionDepthPassConfig : public render::Job::Config {
+    Q_OBJECT
+public:
+    OcclusionDepthPassConfig() : render::Job::Config(false) {}
+};
+
+// Reduces the linear depth of the main view to a small target keeping the farthest depth of the texels each of its
+// texels covers, and reads it back into the OcclusionStage for CullOccludedItems to test the next frames against.
+class OcclusionDepthPass {
+public:
+    using Inputs = LinearDepthFramebufferPointer;
+    using Config = OcclusionDepthPassConfig;
+    using JobModel = render::Job::ModelI<OcclusionDepthPass, Inputs, Config>;
+
+    void configure(const Config& config) {}
+    void run(const render::RenderContextPointer& renderContext, const Inputs& linearDepthFramebuffer);
+
+private:
+    const gpu::PipelinePointer& getDownsamplePipeline();
+
+    gpu::PipelinePointer _downsamplePipeline;
+    int _sourceViewportLoc { -1 };
+    int _destinationSizeLoc { -1 };
+
+    gpu::FramebufferPointer _occlusionDepthFramebuffer;
+};
+
+#endif // hifi_OcclusionDepthPass_h
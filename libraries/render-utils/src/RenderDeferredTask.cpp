@@ -39,6 +39,7 @@
 #include "AntialiasingEffect.h"
 #include "ToneMappingEffect.h"
 #include "SubsurfaceScattering.h"
+#include "OcclusionDepthPass.h"
 
 #include <gpu/StandardShaderLib.h>
 
@@ -98,6 +99,9 @@ void RenderDeferredTask::build(JobModel& task, const render::Varying& input, ren
     const auto linearDepthPassInputs = LinearDepthPass::Inputs(deferredFrameTransform, deferredFramebuffer).hasVarying();
     const auto linearDepthPassOutputs = task.addJob<LinearDepthPass>("LinearDepth", linearDepthPassInputs);
     const auto linearDepthTarget = linearDepthPassOutputs.getN<LinearDepthPass::Outputs>(0);
+
+    // Occlusion depth for the culling of the next frames
+    task.addJob<OcclusionDepthPass>("OcclusionDepth", linearDepthTarget);
     
     // Curvature pass
     const auto surfaceGeometryPassInputs = SurfaceGeometryPass::Inputs(deferredFrameTransform, deferredFramebuffer, linearDepthTarget).hasVarying();
@@ -205,8 +209,12 @@ void RenderDeferredTask::build(JobModel& task, const render::Varying& input, ren
     }
 
 
+    // Fill in the periphery skipped by foveated rendering
+    task.addJob<FillFoveatedStencil>("FillFoveatedStencil", primaryFramebuffer);
+
     // AA job to be revisited
-    task.addJob<Antialiasing>("Antialiasing", primaryFramebuffer);
+    // From here on the frame is in the antialiased framebuffer, or still in the primary one without FXAA
+    const auto antialiasedFramebuffer = task.addJob<Antialiasing>("Antialiasing", primaryFramebuffer);
 
     // Draw 2DWeb non AA
     const auto nonAAOverlaysInputs = DrawOverlay3D::Inputs(nonAAOverlays, lightingModel).hasVarying();
@@ -215,7 +223,7 @@ void RenderDeferredTask::build(JobModel& task, const render::Varying& input, ren
     task.addJob<EndGPURangeTimer>("ToneAndPostRangeTimer", toneAndPostRangeTimer);
 
     // Blit!
-    task.addJob<Blit>("Blit", primaryFramebuffer);
+    task.addJob<Blit>("Blit", antialiasedFramebuffer);
 }
 
 void BeginGPURangeTimer::run(const render::RenderContextPointer& renderContext, gpu::RangeTimerPointer& timer) {
@@ -292,40 +300,47 @@ void DrawStateSortDeferred::run(const RenderContextPointer& renderContext, const
 
     RenderArgs* args = renderContext->args;
 
-    gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
-        args->_batch = &batch;
+    glm::mat4 projMat;
+    Transform viewMat;
+    args->getViewFrustum().evalProjectionMatrix(projMat);
+    args->getViewFrustum().evalViewTransform(viewMat);
+    glm::ivec4 viewport = args->_viewport;
 
-        // Setup camera, projection and viewport for all items
-        batch.setViewportTransform(args->_viewport);
-        batch.setStateScissorRect(args->_viewport);
-
-        glm::mat4 projMat;
-        Transform viewMat;
-        args->getViewFrustum().evalProjectionMatrix(projMat);
-        args->getViewFrustum().evalViewTransform(viewMat);
+    // Setup camera, projection, viewport and lighting model for all items, in every batch they are recorded in
+    auto setupBatch = [=](gpu::Batch& batch) {
+        batch.setViewportTransform(viewport);
+        batch.setStateScissorRect(viewport);
 
         batch.setProjectionTransform(projMat);
         batch.setViewTransform(viewMat);
 
-        // Setup lighting model for all items;
         batch.setUniformBuffer(render::ShapePipeline::Slot::LIGHTING_MODEL, lightingModel->getParametersBuffer());
+    };
 
-        // From the lighting model define a global shapKey ORED with individiual keys
-        ShapeKey::Builder keyBuilder;
-        if (lightingModel->isWireframeEnabled()) {
-            keyBuilder.withWireframe();
-        }
-        ShapeKey globalKey = keyBuilder.build();
-        args->_globalShapeKey = globalKey._flags.to_ulong();
+    // From the lighting model define a global shapKey ORED with individiual keys
+    ShapeKey::Builder keyBuilder;
+    if (lightingModel->isWireframeEnabled()) {
+        keyBuilder.withWireframe();
+    }
+    ShapeKey globalKey = keyBuilder.build();
+    args->_globalShapeKey = globalKey._flags.to_ulong();
 
-        if (_stateSort) {
-            renderStateSortShapes(renderContext, _shapePlumber, inItems, _maxDrawn, globalKey);
-        } else {
-            renderShapes(renderContext, _shapePlumber, inItems, _maxDrawn, globalKey);
-        }
-        args->_batch = nullptr;
-        args->_globalShapeKey = 0;
-    });
+    if (_stateSort && _concurrentRecording) {
+        renderStateSortShapesConcurrently(renderContext, _shapePlumber, inItems, _maxDrawn, globalKey, setupBatch);
+    } else {
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            args->_batch = &batch;
+            setupBatch(batch);
+
+            if (_stateSort) {
+                renderStateSortShapes(renderContext, _shapePlumber, inItems, _maxDrawn, globalKey);
+            } else {
+                renderShapes(renderContext, _shapePlumber, inItems, _maxDrawn, globalKey);
+            }
+            args->_batch = nullptr;
+        });
+    }
+    args->_globalShapeKey = 0;
 
     config->setNumDrawn((int)inItems.size());
 }
@@ -86,6 +86,7 @@ class DrawStateSortConfig : public render::Job::Config {
         Q_PROPERTY(int numDrawn READ getNumDrawn NOTIFY numDrawnChanged)
         Q_PROPERTY(int maxDrawn MEMBER maxDrawn NOTIFY dirty)
         Q_PROPERTY(bool stateSort MEMBER stateSort NOTIFY dirty)
+        Q_PROPERTY(bool concurrentRecording MEMBER concurrentRecording NOTIFY dirty)
 public:
 
     int getNumDrawn() { return numDrawn; }
@@ -93,6 +94,7 @@ public:
 
     int maxDrawn{ -1 };
     bool stateSort{ true };
+    bool concurrentRecording{ true };
 
 signals:
     void numDrawnChanged();
@@ -111,13 +113,18 @@ public:
 
     DrawStateSortDeferred(render::ShapePlumberPointer shapePlumber) : _shapePlumber{ shapePlumber } {}
 
-    void configure(const Config& config) { _maxDrawn = config.maxDrawn; _stateSort = config.stateSort; }
+    void configure(const Config& config) {
+        _maxDrawn = config.maxDrawn;
+        _stateSort = config.stateSort;
+        _concurrentRecording = config.concurrentRecording;
+    }
     void run(const render::RenderContextPointer& renderContext, const Inputs& inputs);
 
 protected:
     render::ShapePlumberPointer _shapePlumber;
     int _maxDrawn; // initialized by Config
     bool _stateSort;
+    bool _concurrentRecording;
 };
 
 class DrawOverlay3DConfig : public render::Job::Config {
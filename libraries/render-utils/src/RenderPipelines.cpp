@@ -28,6 +28,9 @@
 #include "skin_model_vert.h"
 #include "skin_model_shadow_vert.h"
 #include "skin_model_normal_map_vert.h"
+#include "skin_model_dq_vert.h"
+#include "skin_model_shadow_dq_vert.h"
+#include "skin_model_normal_map_dq_vert.h"
 
 #include "simple_vert.h"
 #include "simple_textured_frag.h"
@@ -151,6 +154,9 @@ void initDeferredPipelines(render::ShapePlumber& plumber) {
     auto skinModelVertex = gpu::Shader::createVertex(std::string(skin_model_vert));
     auto skinModelNormalMapVertex = gpu::Shader::createVertex(std::string(skin_model_normal_map_vert));
     auto skinModelShadowVertex = gpu::Shader::createVertex(std::string(skin_model_shadow_vert));
+    auto skinModelDualQuatVertex = gpu::Shader::createVertex(std::string(skin_model_dq_vert));
+    auto skinModelNormalMapDualQuatVertex = gpu::Shader::createVertex(std::string(skin_model_normal_map_dq_vert));
+    auto skinModelShadowDualQuatVertex = gpu::Shader::createVertex(std::string(skin_model_shadow_dq_vert));
 
     // Pixel shaders
     auto simplePixel = gpu::Shader::createPixel(std::string(simple_textured_frag));
@@ -260,6 +266,32 @@ void initDeferredPipelines(render::ShapePlumber& plumber) {
     addPipeline(
         Key::Builder().withMaterial().withSkinned().withTranslucent().withTangents().withSpecular(),
         skinModelNormalMapVertex, modelTranslucentPixel);
+    // Dual quaternion skinned
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned(),
+        skinModelDualQuatVertex, modelPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTangents(),
+        skinModelNormalMapDualQuatVertex, modelNormalMapPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withSpecular(),
+        skinModelDualQuatVertex, modelSpecularMapPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTangents().withSpecular(),
+        skinModelNormalMapDualQuatVertex, modelNormalSpecularMapPixel);
+    // Dual quaternion skinned and Translucent
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTranslucent(),
+        skinModelDualQuatVertex, modelTranslucentPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTranslucent().withTangents(),
+        skinModelNormalMapDualQuatVertex, modelTranslucentPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTranslucent().withSpecular(),
+        skinModelDualQuatVertex, modelTranslucentPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTranslucent().withTangents().withSpecular(),
+        skinModelNormalMapDualQuatVertex, modelTranslucentPixel);
     // Depth-only
     addPipeline(
         Key::Builder().withDepthOnly(),
@@ -267,6 +299,9 @@ void initDeferredPipelines(render::ShapePlumber& plumber) {
     addPipeline(
         Key::Builder().withSkinned().withDepthOnly(),
         skinModelShadowVertex, modelShadowPixel);
+    addPipeline(
+        Key::Builder().withSkinned().withDualQuatSkinned().withDepthOnly(),
+        skinModelShadowDualQuatVertex, modelShadowPixel);
 }
 
 void initForwardPipelines(render::ShapePlumber& plumber) {
@@ -275,6 +310,8 @@ void initForwardPipelines(render::ShapePlumber& plumber) {
     auto modelNormalMapVertex = gpu::Shader::createVertex(std::string(model_normal_map_vert));
     auto skinModelVertex = gpu::Shader::createVertex(std::string(skin_model_vert));
     auto skinModelNormalMapVertex = gpu::Shader::createVertex(std::string(skin_model_normal_map_vert));
+    auto skinModelDualQuatVertex = gpu::Shader::createVertex(std::string(skin_model_dq_vert));
+    auto skinModelNormalMapDualQuatVertex = gpu::Shader::createVertex(std::string(skin_model_normal_map_dq_vert));
 
     // Pixel shaders
     auto modelPixel = gpu::Shader::createPixel(std::string(forward_model_frag));
@@ -314,6 +351,19 @@ void initForwardPipelines(render::ShapePlumber& plumber) {
     addPipeline(
         Key::Builder().withMaterial().withSkinned().withTangents().withSpecular(),
         skinModelNormalMapVertex, modelNormalSpecularMapPixel);
+    // Dual quaternion skinned
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned(),
+        skinModelDualQuatVertex, modelPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTangents(),
+        skinModelNormalMapDualQuatVertex, modelNormalMapPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withSpecular(),
+        skinModelDualQuatVertex, modelSpecularMapPixel);
+    addPipeline(
+        Key::Builder().withMaterial().withSkinned().withDualQuatSkinned().withTangents().withSpecular(),
+        skinModelNormalMapDualQuatVertex, modelNormalSpecularMapPixel);
 }
 
 void addPlumberPipeline(ShapePlumber& plumber,
@@ -366,16 +416,15 @@ void batchSetter(const ShapePipeline& pipeline, gpu::Batch& batch, RenderArgs* a
 
     // Set a default material
     if (pipeline.locations->materialBufferUnit >= 0) {
-        // Create a default schema
-        static bool isMaterialSet = false;
-        static model::Material material;
-        if (!isMaterialSet) {
-            material.setAlbedo(vec3(1.0f));
-            material.setOpacity(1.0f);
-            material.setMetallic(0.1f);
-            material.setRoughness(0.9f);
-            isMaterialSet = true;
-        }
+        // Create a default schema, once, pipelines can be prepared from several recording threads
+        static const model::Material material = [] {
+            model::Material defaultMaterial;
+            defaultMaterial.setAlbedo(vec3(1.0f));
+            defaultMaterial.setOpacity(1.0f);
+            defaultMaterial.setMetallic(0.1f);
+            defaultMaterial.setRoughness(0.9f);
+            return defaultMaterial;
+        }();
 
         // Set a default schema
         batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::MATERIAL, material.getSchemaBuffer());
@@ -11,6 +11,8 @@
 
 #include "RenderShadowTask.h"
 
+#include <cstring>
+
 #include <gpu/Context.h>
 
 #include <ViewFrustum.h>
@@ -21,15 +23,51 @@
 
 #include "DeferredLightingEffect.h"
 #include "FramebufferCache.h"
+#include "LightStage.h"
 
 #include "model_shadow_vert.h"
 #include "skin_model_shadow_vert.h"
+#include "skin_model_shadow_dq_vert.h"
 
 #include "model_shadow_frag.h"
 #include "skin_model_shadow_frag.h"
 
 using namespace render;
 
+// Changes as soon as a caster is added, removed or moved
+static uint64_t evalCasterSignature(const render::ShapeBounds& inShapes) {
+    // FNV-1a over each caster, summed up so that the order of the shapes does not matter
+    static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    static const uint64_t FNV_PRIME = 1099511628211ULL;
+    auto mix = [](uint64_t hash, uint32_t value) {
+        return (hash ^ value) * FNV_PRIME;
+    };
+    auto floatBits = [](float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    };
+
+    uint64_t signature = 0;
+    for (const auto& items : inShapes) {
+        for (const auto& item : items.second) {
+            uint64_t hash = mix(FNV_OFFSET_BASIS, item.id);
+            const auto& corner = item.bound.getCorner();
+            const auto& scale = item.bound.getScale();
+            for (int i = 0; i < 3; ++i) {
+                hash = mix(hash, floatBits(corner[i]));
+                hash = mix(hash, floatBits(scale[i]));
+            }
+            signature += hash;
+        }
+    }
+    return signature;
+}
+
+static std::string getCascadeTaskName(int cascadeIndex) {
+    return "ShadowCascade" + std::to_string(cascadeIndex);
+}
+
 void RenderShadowMap::run(const render::RenderContextPointer& renderContext,
                           const render::ShapeBounds& inShapes) {
     assert(renderContext->args);
@@ -39,9 +77,13 @@ void RenderShadowMap::run(const render::RenderContextPointer& renderContext,
     assert(lightStage);
     LightStage::Index globalLightIndex { 0 };
 
-    const auto globalLight = lightStage->getLight(globalLightIndex);
     const auto shadow = lightStage->getShadow(globalLightIndex);
-    if (!shadow) return;
+    if (!shadow || _cascadeIndex >= shadow->getCascadeCount()) return;
+
+    // A cached cascade is left as is until its fit or its casters change
+    auto& cascade = shadow->editCascade(_cascadeIndex);
+    uint64_t casterSignature = cascade.isCached() ? evalCasterSignature(inShapes) : 0;
+    if (!cascade.needsRender(casterSignature)) return;
 
     const auto& fbo = shadow->framebuffer;
 
@@ -50,28 +92,34 @@ void RenderShadowMap::run(const render::RenderContextPointer& renderContext,
         args->_batch = &batch;
         batch.enableStereo(false);
 
-        glm::ivec4 viewport{0, 0, fbo->getWidth(), fbo->getHeight()};
+        glm::ivec4 viewport = cascade.getViewport();
         batch.setViewportTransform(viewport);
         batch.setStateScissorRect(viewport);
 
+        // Only clear the region of the cascade, the others may be cached
         batch.setFramebuffer(fbo);
         batch.clearFramebuffer(
             gpu::Framebuffer::BUFFER_COLOR0 | gpu::Framebuffer::BUFFER_DEPTH,
             vec4(vec3(1.0, 1.0, 1.0), 0.0), 1.0, 0, true);
 
-        batch.setProjectionTransform(shadow->getProjection());
-        batch.setViewTransform(shadow->getView(), false);
+        batch.setProjectionTransform(cascade.getProjection());
+        batch.setViewTransform(cascade.getView(), false);
 
         auto shadowPipeline = _shapePlumber->pickPipeline(args, ShapeKey());
         auto shadowSkinnedPipeline = _shapePlumber->pickPipeline(args, ShapeKey::Builder().withSkinned());
+        auto shadowDualQuatSkinnedPipeline = _shapePlumber->pickPipeline(args,
+            ShapeKey::Builder().withSkinned().withDualQuatSkinned());
 
         std::vector<ShapeKey> skinnedShapeKeys{};
+        std::vector<ShapeKey> dualQuatSkinnedShapeKeys{};
 
         // Iterate through all inShapes and render the unskinned
         args->_shapePipeline = shadowPipeline;
         batch.setPipeline(shadowPipeline->pipeline);
         for (auto items : inShapes) {
-            if (items.first.isSkinned()) {
+            if (items.first.isDualQuatSkinned()) {
+                dualQuatSkinnedShapeKeys.push_back(items.first);
+            } else if (items.first.isSkinned()) {
                 skinnedShapeKeys.push_back(items.first);
             } else {
                 renderItems(renderContext, items.second);
@@ -85,9 +133,17 @@ void RenderShadowMap::run(const render::RenderContextPointer& renderContext,
             renderItems(renderContext, inShapes.at(key));
         }
 
+        args->_shapePipeline = shadowDualQuatSkinnedPipeline;
+        batch.setPipeline(shadowDualQuatSkinnedPipeline->pipeline);
+        for (const auto& key : dualQuatSkinnedShapeKeys) {
+            renderItems(renderContext, inShapes.at(key));
+        }
+
         args->_shapePipeline = nullptr;
         args->_batch = nullptr;
     });
+
+    cascade.setRendered(casterSignature);
 }
 
 void RenderShadowTask::build(JobModel& task, const render::Varying& input, render::Varying& output, CullFunctor cullFunctor) {
@@ -111,34 +167,54 @@ void RenderShadowTask::build(JobModel& task, const render::Varying& input, rende
         auto skinPixel = gpu::Shader::createPixel(std::string(skin_model_shadow_frag));
         gpu::ShaderPointer skinProgram = gpu::Shader::createProgram(skinVertex, skinPixel);
         shapePlumber->addPipeline(
-            ShapeKey::Filter::Builder().withSkinned(),
+            ShapeKey::Filter::Builder().withSkinned().withoutDualQuatSkinned(),
             skinProgram, state);
+
+        auto skinDualQuatVertex = gpu::Shader::createVertex(std::string(skin_model_shadow_dq_vert));
+        gpu::ShaderPointer skinDualQuatProgram = gpu::Shader::createProgram(skinDualQuatVertex, skinPixel);
+        shapePlumber->addPipeline(
+            ShapeKey::Filter::Builder().withSkinned().withDualQuatSkinned(),
+            skinDualQuatProgram, state);
     }
 
     const auto cachedMode = task.addJob<RenderShadowSetup>("ShadowSetup");
 
-    // CPU jobs:
-    // Fetch and cull the items from the scene
-    auto shadowFilter = ItemFilter::Builder::visibleWorldItems().withTypeShape().withOpaque().withoutLayered();
-    const auto shadowSelection = task.addJob<FetchSpatialTree>("FetchShadowSelection", shadowFilter);
-    const auto culledShadowSelection = task.addJob<CullSpatialSelection>("CullShadowSelection", shadowSelection, cullFunctor, RenderDetails::SHADOW, shadowFilter);
-
-    // Sort
-    const auto sortedPipelines = task.addJob<PipelineSortShapes>("PipelineSortShadowSort", culledShadowSelection);
-    const auto sortedShapes = task.addJob<DepthSortShapes>("DepthSortShadowMap", sortedPipelines);
-
-    // GPU jobs: Render to shadow map
-    task.addJob<RenderShadowMap>("RenderShadowMap", sortedShapes, shapePlumber);
+    // Each cascade culls and renders its own casters, the ones not in use are disabled by configure
+    for (int i = 0; i < LightStage::Shadow::MAX_CASCADE_COUNT; ++i) {
+        task.addJob<RenderShadowCascadeTask>(getCascadeTaskName(i), shapePlumber, cullFunctor, i);
+    }
 
     task.addJob<RenderShadowTeardown>("ShadowTeardown", cachedMode);
 }
 
 void RenderShadowTask::configure(const Config& configuration) {
     DependencyManager::get<DeferredLightingEffect>()->setShadowMapEnabled(configuration.enabled);
+
+    // Hand the cascades over to the jobs, they are configured right after
+    int cascadeCount = glm::clamp(configuration.cascadeCount, 1, (int)LightStage::Shadow::MAX_CASCADE_COUNT);
+    auto setupConfig = configuration.getConfig<RenderShadowSetup>("ShadowSetup");
+    if (setupConfig) {
+        setupConfig->cascadeCount = cascadeCount;
+        setupConfig->maxDistance = configuration.maxDistance;
+        setupConfig->cacheFarCascades = configuration.cacheFarCascades;
+    }
+    for (int i = 0; i < LightStage::Shadow::MAX_CASCADE_COUNT; ++i) {
+        auto cascadeConfig = configuration.getConfig<RenderShadowCascadeTask>(getCascadeTaskName(i));
+        if (cascadeConfig) {
+            cascadeConfig->enabled = (i < cascadeCount);
+        }
+    }
+
     // This is a task, so must still propogate configure() to its Jobs
 //    Task::configure(configuration);
 }
 
+void RenderShadowSetup::configure(const Config& configuration) {
+    _cascadeCount = configuration.cascadeCount;
+    _maxDistance = configuration.maxDistance;
+    _cacheFarCascades = configuration.cacheFarCascades;
+}
+
 void RenderShadowSetup::run(const render::RenderContextPointer& renderContext, Output& output) {
     auto lightStage = renderContext->_scene->getStage<LightStage>();
     assert(lightStage);
@@ -150,11 +226,10 @@ void RenderShadowSetup::run(const render::RenderContextPointer& renderContext, O
 
     auto nearClip = args->getViewFrustum().getNearClip();
     float nearDepth = -args->_boomOffset.z;
-    const int SHADOW_FAR_DEPTH = 20;
-    globalShadow->setKeylightFrustum(args->getViewFrustum(), nearDepth, nearClip + SHADOW_FAR_DEPTH);
+    globalShadow->setKeylightCascadeFrustums(args->getViewFrustum(), nearDepth, nearClip + _maxDistance,
+        _cascadeCount, _cacheFarCascades);
 
-    // Set the keylight render args
-    args->pushViewFrustum(*(globalShadow->getFrustum()));
+    // Set the keylight render args, each cascade pushes its own frustum
     args->_renderMode = RenderArgs::SHADOW_RENDER_MODE;
 }
 
@@ -162,6 +237,42 @@ void RenderShadowTeardown::run(const render::RenderContextPointer& renderContext
     RenderArgs* args = renderContext->args;
 
     // Reset the render args
-    args->popViewFrustum();
     args->_renderMode = input;
 };
+
+void RenderShadowCascadeTask::build(JobModel& task, const render::Varying& input, render::Varying& output,
+        ShapePlumberPointer shapePlumber, CullFunctor cullFunctor, int cascadeIndex) {
+    task.addJob<RenderShadowCascadeSetup>("ShadowCascadeSetup", cascadeIndex);
+
+    // CPU jobs:
+    // Fetch and cull the items from the scene
+    auto shadowFilter = ItemFilter::Builder::visibleWorldItems().withTypeShape().withOpaque().withoutLayered();
+    const auto shadowSelection = task.addJob<FetchSpatialTree>("FetchShadowSelection", shadowFilter);
+    const auto culledShadowSelection = task.addJob<CullSpatialSelection>("CullShadowSelection", shadowSelection, cullFunctor, RenderDetails::SHADOW, shadowFilter);
+
+    // Sort
+    const auto sortedPipelines = task.addJob<PipelineSortShapes>("PipelineSortShadowSort", culledShadowSelection);
+    const auto sortedShapes = task.addJob<DepthSortShapes>("DepthSortShadowMap", sortedPipelines);
+
+    // GPU jobs: Render to the region of the cascade in the shadow map
+    task.addJob<RenderShadowMap>("RenderShadowMap", sortedShapes, shapePlumber, cascadeIndex);
+
+    task.addJob<RenderShadowCascadeTeardown>("ShadowCascadeTeardown");
+}
+
+void RenderShadowCascadeSetup::run(const render::RenderContextPointer& renderContext) {
+    auto lightStage = renderContext->_scene->getStage<LightStage>();
+    assert(lightStage);
+    const auto globalShadow = lightStage->getShadow(0);
+
+    // Set the cascade frustum, to fetch and cull its casters
+    RenderArgs* args = renderContext->args;
+    args->pushViewFrustum(*(globalShadow->getCascade(_cascadeIndex).getFrustum()));
+}
+
+void RenderShadowCascadeTeardown::run(const render::RenderContextPointer& renderContext) {
+    RenderArgs* args = renderContext->args;
+
+    // Reset the render args
+    args->popViewFrustum();
+}
@@ -23,20 +23,29 @@ class RenderShadowMap {
 public:
     using JobModel = render::Job::ModelI<RenderShadowMap, render::ShapeBounds>;
 
-    RenderShadowMap(render::ShapePlumberPointer shapePlumber) : _shapePlumber{ shapePlumber } {}
+    RenderShadowMap(render::ShapePlumberPointer shapePlumber, int cascadeIndex) :
+        _shapePlumber{ shapePlumber }, _cascadeIndex{ cascadeIndex } {}
     void run(const render::RenderContextPointer& renderContext,
              const render::ShapeBounds& inShapes);
 
 protected:
     render::ShapePlumberPointer _shapePlumber;
+    int _cascadeIndex;
 };
 
 class RenderShadowTaskConfig : public render::Task::Config::Persistent {
     Q_OBJECT
     Q_PROPERTY(bool enabled MEMBER enabled NOTIFY dirty)
+    Q_PROPERTY(int cascadeCount MEMBER cascadeCount NOTIFY dirty)
+    Q_PROPERTY(float maxDistance MEMBER maxDistance NOTIFY dirty)
+    Q_PROPERTY(bool cacheFarCascades MEMBER cacheFarCascades NOTIFY dirty)
 public:
     RenderShadowTaskConfig() : render::Task::Config::Persistent(QStringList() << "Render" << "Engine" << "Shadows", false) {}
 
+    int cascadeCount{ 4 };
+    float maxDistance{ 40.0f };
+    bool cacheFarCascades{ true };
+
 signals:
     void dirty();
 };
@@ -52,11 +61,28 @@ public:
     void configure(const Config& configuration);
 };
 
+class RenderShadowSetupConfig : public render::Job::Config {
+    Q_OBJECT
+public:
+    // Set by RenderShadowTask from its own config
+    int cascadeCount{ 1 };
+    float maxDistance{ 20.0f };
+    bool cacheFarCascades{ false };
+};
+
 class RenderShadowSetup {
 public:
     using Output = RenderArgs::RenderMode;
-    using JobModel = render::Job::ModelO<RenderShadowSetup, Output>;
+    using Config = RenderShadowSetupConfig;
+    using JobModel = render::Job::ModelO<RenderShadowSetup, Output, Config>;
+
+    void configure(const Config& configuration);
     void run(const render::RenderContextPointer& renderContext, Output& output);
+
+protected:
+    int _cascadeCount{ 1 };
+    float _maxDistance{ 20.0f };
+    bool _cacheFarCascades{ false };
 };
 
 class RenderShadowTeardown {
@@ -66,4 +92,39 @@ public:
     void run(const render::RenderContextPointer& renderContext, const Input& input);
 };
 
+class RenderShadowCascadeTaskConfig : public render::Task::Config {
+    Q_OBJECT
+public:
+    // Enabled by RenderShadowTask for the cascades in use
+    RenderShadowCascadeTaskConfig() : render::Task::Config(true) {}
+};
+
+// Fetches the casters of a cascade from the spatial tree and renders them to its region of the shadow map
+class RenderShadowCascadeTask {
+public:
+    using Config = RenderShadowCascadeTaskConfig;
+    using JobModel = render::Task::Model<RenderShadowCascadeTask, Config>;
+
+    RenderShadowCascadeTask() {}
+    void build(JobModel& task, const render::Varying& inputs, render::Varying& outputs,
+        render::ShapePlumberPointer shapePlumber, render::CullFunctor cullFunctor, int cascadeIndex);
+};
+
+class RenderShadowCascadeSetup {
+public:
+    using JobModel = render::Job::Model<RenderShadowCascadeSetup>;
+
+    RenderShadowCascadeSetup(int cascadeIndex) : _cascadeIndex{ cascadeIndex } {}
+    void run(const render::RenderContextPointer& renderContext);
+
+protected:
+    int _cascadeIndex;
+};
+
+class RenderShadowCascadeTeardown {
+public:
+    using JobModel = render::Job::Model<RenderShadowCascadeTeardown>;
+    void run(const render::RenderContextPointer& renderContext);
+};
+
 #endif // hifi_RenderShadowTask_h
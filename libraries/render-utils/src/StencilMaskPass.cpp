@@ -18,6 +18,8 @@
 #include <gpu/StandardShaderLib.h>
 
 #include "stencil_drawMask_frag.h"
+#include "stencil_drawFoveatedMask_frag.h"
+#include "stencil_fillFoveatedMask_frag.h"
 
 using namespace render;
 
@@ -73,6 +75,23 @@ gpu::PipelinePointer PrepareStencil::getPaintStencilPipeline() {
     return _paintStencilPipeline;
 }
 
+gpu::PipelinePointer PrepareStencil::getFoveatedStencilPipeline() {
+    if (!_foveatedStencilPipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawUnitQuadTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(stencil_drawFoveatedMask_frag));
+        auto program = gpu::Shader::createProgram(vs, ps);
+        gpu::Shader::makeProgram((*program));
+        _foveatedRadiusLoc = program->getUniforms().findLocation("foveatedRadius");
+
+        auto state = std::make_shared<gpu::State>();
+        drawMask(*state);
+        state->setColorWriteMask(0);
+
+        _foveatedStencilPipeline = gpu::Pipeline::create(program, state);
+    }
+    return _foveatedStencilPipeline;
+}
+
 void PrepareStencil::run(const RenderContextPointer& renderContext, const gpu::FramebufferPointer& srcFramebuffer) {
     RenderArgs* args = renderContext->args;
 
@@ -101,6 +120,12 @@ void PrepareStencil::run(const RenderContextPointer& renderContext, const gpu::F
             batch.setPipeline(getPaintStencilPipeline());
             batch.draw(gpu::TRIANGLE_STRIP, 4);
         }
+
+        if (args->_foveatedRadius > 0.0f) {
+            batch.setPipeline(getFoveatedStencilPipeline());
+            batch._glUniform1f(_foveatedRadiusLoc, args->_foveatedRadius);
+            batch.draw(gpu::TRIANGLE_STRIP, 4);
+        }
     });
 }
 
@@ -122,4 +147,44 @@ void PrepareStencil::testMaskDrawShape(gpu::State& state) {
 
 void PrepareStencil::testShape(gpu::State& state) {
     state.setStencilTest(true, 0x00, gpu::State::StencilTest(PrepareStencil::STENCIL_SHAPE, 0xFF, gpu::EQUAL, gpu::State::STENCIL_OP_KEEP, gpu::State::STENCIL_OP_KEEP, gpu::State::STENCIL_OP_KEEP));
-}
\ No newline at end of file
+}
+
+gpu::PipelinePointer FillFoveatedStencil::getFillPipeline() {
+    if (!_fillPipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawUnitQuadTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(stencil_fillFoveatedMask_frag));
+        auto program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("colorTexture"), 0));
+        gpu::Shader::makeProgram((*program), slotBindings);
+
+        // the fill only writes the masked pixels and only reads the shaded ones
+        auto state = std::make_shared<gpu::State>();
+        state->setStencilTest(true, 0x00, gpu::State::StencilTest(PrepareStencil::STENCIL_MASK, 0xFF, gpu::EQUAL,
+            gpu::State::STENCIL_OP_KEEP, gpu::State::STENCIL_OP_KEEP, gpu::State::STENCIL_OP_KEEP));
+        state->setDepthTest(false, false, gpu::LESS_EQUAL);
+
+        _fillPipeline = gpu::Pipeline::create(program, state);
+    }
+    return _fillPipeline;
+}
+
+void FillFoveatedStencil::run(const RenderContextPointer& renderContext, const gpu::FramebufferPointer& framebuffer) {
+    RenderArgs* args = renderContext->args;
+
+    if (args->_displayMode != RenderArgs::STEREO_HMD || args->_foveatedRadius <= 0.0f || !framebuffer) {
+        return;
+    }
+
+    doInBatch(args->_context, [&](gpu::Batch& batch) {
+        batch.enableStereo(false);
+        batch.setFramebuffer(framebuffer);
+        batch.setViewportTransform(args->_viewport);
+
+        batch.setPipeline(getFillPipeline());
+        batch.setResourceTexture(0, framebuffer->getRenderBuffer(0));
+        batch.draw(gpu::TRIANGLE_STRIP, 4);
+        batch.setResourceTexture(0, nullptr);
+    });
+}
@@ -60,6 +60,10 @@ private:
     gpu::PipelinePointer _paintStencilPipeline;
     gpu::PipelinePointer getPaintStencilPipeline();
 
+    gpu::PipelinePointer _foveatedStencilPipeline;
+    gpu::PipelinePointer getFoveatedStencilPipeline();
+    int _foveatedRadiusLoc { -1 };
+
     model::MeshPointer _mesh;
     model::MeshPointer getMesh();
 
@@ -67,5 +71,17 @@ private:
     bool _forceDraw { false };
 };
 
+// Fills in the pixels of the periphery that PrepareStencil masked for foveated rendering, from their shaded neighbors
+class FillFoveatedStencil {
+public:
+    using JobModel = render::Job::ModelI<FillFoveatedStencil, gpu::FramebufferPointer>;
+
+    void run(const render::RenderContextPointer& renderContext, const gpu::FramebufferPointer& framebuffer);
+
+private:
+    gpu::PipelinePointer _fillPipeline;
+    gpu::PipelinePointer getFillPipeline();
+};
+
 
 #endif // hifi_StencilMaskPass_h
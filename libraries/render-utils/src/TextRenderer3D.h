@@ -16,12 +16,8 @@
 #include <glm/glm.hpp>
 #include <QColor>
 
-namespace gpu {
-class Batch;
-}
-class Font;
-
 #include "text/EffectType.h"
+#include "text/Font.h"
 #include "text/FontFamilies.h"
 
 // TextRenderer3D is actually a fairly thin wrapper around a Font class
@@ -53,6 +49,9 @@ private:
     glm::vec4 _color;
 
     std::shared_ptr<Font> _font;
+
+    // the glyph quads of what was drawn last
+    Font::DrawInfo _drawInfo;
 };
 
 
@@ -11,6 +11,7 @@
 #include "UpdateSceneTask.h"
 
 #include <render/SceneTask.h>
+#include <render/OcclusionStage.h>
 #include "LightStage.h"
 #include "BackgroundStage.h"
 #include "DeferredLightingEffect.h"
@@ -18,6 +19,7 @@
 void UpdateSceneTask::build(JobModel& task, const render::Varying& input, render::Varying& output) {
     task.addJob<LightStageSetup>("LightStageSetup");
     task.addJob<BackgroundStageSetup>("BackgroundStageSetup");
+    task.addJob<render::OcclusionStageSetup>("OcclusionStageSetup");
 
     task.addJob<DefaultLightingSetup>("DefaultLightingSetup");
 
@@ -26,8 +26,21 @@ public:
     glm::vec2 computeExtent(const QString& str) const;
     float getFontSize() const { return _fontSize; }
 
+    // The glyph quads of a string as it was laid out the last time it was drawn. A font is shared by everything that
+    // draws with it, so each of those keeps its own, and the quads are only made again when the string or its layout
+    // changes.
+    struct DrawInfo {
+        gpu::BufferPointer verticesBuffer;
+        gpu::BufferPointer indicesBuffer;
+        unsigned int numIndices { 0 };
+
+        QString string;
+        glm::vec2 origin;
+        glm::vec2 bounds;
+    };
+
     // Render string to batch
-    void drawString(gpu::Batch& batch, float x, float y, const QString& str,
+    void drawString(gpu::Batch& batch, DrawInfo& drawInfo, float x, float y, const QString& str,
         const glm::vec4* color, EffectType effectType,
         const glm::vec2& bound, bool layered = false);
 
@@ -40,7 +53,7 @@ private:
     glm::vec2 computeTokenExtent(const QString& str) const;
 
     const Glyph& getGlyph(const QChar& c) const;
-    void rebuildVertices(float x, float y, const QString& str, const glm::vec2& bounds);
+    void buildVertices(DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec2& bounds);
 
     void setupGPU();
 
@@ -66,19 +79,10 @@ private:
     gpu::PipelinePointer _layeredPipeline;
     gpu::TexturePointer _texture;
     gpu::Stream::FormatPointer _format;
-    gpu::BufferPointer _verticesBuffer;
-    gpu::BufferPointer _indicesBuffer;
-    gpu::BufferStreamPointer _stream;
-    unsigned int _numVertices = 0;
-    unsigned int _numIndices = 0;
 
     int _fontLoc = -1;
     int _outlineLoc = -1;
     int _colorLoc = -1;
-
-    // last string render characteristics
-    QString _lastStringRendered;
-    glm::vec2 _lastBounds;
 };
 
 #endif
@@ -115,6 +115,7 @@ namespace render {
         int _boundaryLevelAdjust { 0 };
         RenderMode _renderMode { DEFAULT_RENDER_MODE };
         DisplayMode _displayMode { MONO };
+        float _foveatedRadius { 0.0f }; // see DisplayPlugin::getFoveatedRadius
         OutlineFlags _outlineFlags{ RENDER_OUTLINE_NONE };
         DebugFlags _debugFlags { RENDER_DEBUG_NONE };
         gpu::Batch* _batch = nullptr;
@@ -14,8 +14,12 @@
 #include <algorithm>
 #include <assert.h>
 
+#include <NumericalConstants.h>
 #include <OctreeUtils.h>
 #include <PerfStat.h>
+#include <SharedUtil.h>
+
+#include "OcclusionStage.h"
 
 using namespace render;
 
@@ -29,33 +33,46 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
 
     details._considered += (int)inItems.size();
 
-    // Culling / LOD
-    for (auto item : inItems) {
-        if (item.bound.isNull()) {
-            outItems.emplace_back(item); // One more Item to render
-            continue;
-        }
-
-        // TODO: some entity types (like lights) might want to be rendered even
-        // when they are outside of the view frustum...
-        bool inView;
+    // Culling / LOD, the frustum tests a few items at a time
+    const int BATCH_SIZE = PackedPlanes::BOXES_PER_TEST;
+    for (size_t first = 0; first < inItems.size(); first += BATCH_SIZE) {
+        int count = std::min(BATCH_SIZE, (int)(inItems.size() - first));
+        int inView;
         {
             PerformanceTimer perfTimer("boxIntersectsFrustum");
-            inView = frustum.boxIntersectsFrustum(item.bound);
-        }
-        if (inView) {
-            bool bigEnoughToRender;
-            {
-                PerformanceTimer perfTimer("shouldRender");
-                bigEnoughToRender = cullFunctor(args, item.bound);
+            glm::vec3 minimums[BATCH_SIZE];
+            glm::vec3 maximums[BATCH_SIZE];
+            for (int i = 0; i < count; ++i) {
+                const auto& bound = inItems[first + i].bound;
+                minimums[i] = bound.getMinimumPoint();
+                maximums[i] = bound.getMaximumPoint();
             }
-            if (bigEnoughToRender) {
+            inView = frustum.boxesIntersectFrustum(minimums, maximums, count);
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const auto& item = inItems[first + i];
+            if (item.bound.isNull()) {
                 outItems.emplace_back(item); // One more Item to render
+                continue;
+            }
+
+            // TODO: some entity types (like lights) might want to be rendered even
+            // when they are outside of the view frustum...
+            if (inView & (1 << i)) {
+                bool bigEnoughToRender;
+                {
+                    PerformanceTimer perfTimer("shouldRender");
+                    bigEnoughToRender = cullFunctor(args, item.bound);
+                }
+                if (bigEnoughToRender) {
+                    outItems.emplace_back(item); // One more Item to render
+                } else {
+                    details._tooSmall++;
+                }
             } else {
-                details._tooSmall++;
+                details._outOfView++;
             }
-        } else {
-            details._outOfView++;
         }
     }
     details._rendered += (int)outItems.size();
@@ -112,6 +129,45 @@ void CullSpatialSelection::configure(const Config& config) {
     _skipCulling = config.skipCulling;
 }
 
+// Filters the items, then tests those that pass against the frustum a few at a time
+template <typename F>
+static void filterAndFrustumCull(const ScenePointer& scene, const ItemIDs& ids, const ItemFilter& filter,
+                                 const ViewFrustum& frustum, RenderDetails::Item& details, F inView) {
+    const int BATCH_SIZE = PackedPlanes::BOXES_PER_TEST;
+    ItemID batchIDs[BATCH_SIZE];
+    AABox batchBounds[BATCH_SIZE];
+    glm::vec3 minimums[BATCH_SIZE];
+    glm::vec3 maximums[BATCH_SIZE];
+    int count = 0;
+    auto cullBatch = [&] {
+        int batchInView = frustum.boxesIntersectFrustum(minimums, maximums, count);
+        for (int i = 0; i < count; ++i) {
+            if (batchInView & (1 << i)) {
+                inView(ItemBound(batchIDs[i], batchBounds[i]));
+            } else {
+                details._outOfView++;
+            }
+        }
+        count = 0;
+    };
+
+    for (auto id : ids) {
+        auto& item = scene->getItem(id);
+        if (filter.test(item.getKey())) {
+            batchIDs[count] = id;
+            batchBounds[count] = item.getBound();
+            minimums[count] = batchBounds[count].getMinimumPoint();
+            maximums[count] = batchBounds[count].getMaximumPoint();
+            if (++count == BATCH_SIZE) {
+                cullBatch();
+            }
+        }
+    }
+    if (count > 0) {
+        cullBatch();
+    }
+}
+
 void CullSpatialSelection::run(const RenderContextPointer& renderContext,
     const ItemSpatialTree::ItemSelection& inSelection, ItemBounds& outItems) {
     assert(renderContext->args);
@@ -154,14 +210,6 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
             */
         }
 
-        bool frustumTest(const AABox& bound) {
-            if (!_args->getViewFrustum().boxIntersectsFrustum(bound)) {
-                _renderDetails._outOfView++;
-                return false;
-            }
-            return true;
-        }
-
         bool solidAngleTest(const AABox& bound) {
             // FIXME: Keep this code here even though we don't use it yet
             //auto eyeToPoint = bound.calcCenter() - _eyePos;
@@ -266,31 +314,21 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
         // partial & fit items: filter & frustum cull
         {
             PerformanceTimer perfTimer("partialFitItems");
-            for (auto id : inSelection.partialItems) {
-                auto& item = scene->getItem(id);
-                if (_filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    if (test.frustumTest(itemBound.bound)) {
-                        outItems.emplace_back(itemBound);
-                    }
-                }
-            }
+            filterAndFrustumCull(scene, inSelection.partialItems, _filter, args->getViewFrustum(), details,
+                [&](const ItemBound& itemBound) {
+                    outItems.emplace_back(itemBound);
+                });
         }
 
         // partial & subcell items:: filter & frutum cull & solidangle cull
         {
             PerformanceTimer perfTimer("partialSmallItems");
-            for (auto id : inSelection.partialSubcellItems) {
-                auto& item = scene->getItem(id);
-                if (_filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    if (test.frustumTest(itemBound.bound)) {
-                        if (test.solidAngleTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                        }
+            filterAndFrustumCull(scene, inSelection.partialSubcellItems, _filter, args->getViewFrustum(), details,
+                [&](const ItemBound& itemBound) {
+                    if (test.solidAngleTest(itemBound.bound)) {
+                        outItems.emplace_back(itemBound);
                     }
-                }
-            }
+                });
         }
     }
 
@@ -304,3 +342,66 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
 
     std::static_pointer_cast<Config>(renderContext->jobConfig)->numItems = (int)outItems.size();
 }
+
+// How far the view can be from the one the depth was rendered from, for that depth to still hide what it hid then
+static const float MAX_OCCLUSION_VIEW_DISTANCE = 0.25f; // meters
+static const float MIN_OCCLUSION_VIEW_ALIGNMENT = cosf(glm::radians(2.0f));
+static const uint64_t MAX_OCCLUSION_DEPTH_AGE = 250 * USECS_PER_MSEC;
+
+static bool isDepthPyramidUsable(const DepthPyramid& depthPyramid, const RenderArgs* args) {
+    if (args->_renderMode != RenderArgs::DEFAULT_RENDER_MODE || args->isStereo()) {
+        return false;
+    }
+    if (usecTimestampNow() - depthPyramid.getTimestamp() > MAX_OCCLUSION_DEPTH_AGE) {
+        return false;
+    }
+
+    const auto& depthFrustum = depthPyramid.getFrustum();
+    const auto& frustum = args->getViewFrustum();
+    return glm::distance(depthFrustum.getPosition(), frustum.getPosition()) < MAX_OCCLUSION_VIEW_DISTANCE &&
+        glm::dot(depthFrustum.getDirection(), frustum.getDirection()) > MIN_OCCLUSION_VIEW_ALIGNMENT &&
+        depthFrustum.getFieldOfView() == frustum.getFieldOfView() &&
+        depthFrustum.getAspectRatio() == frustum.getAspectRatio();
+}
+
+void CullOccludedItems::configure(const Config& config) {
+    _cullOccluded = config.cullOccluded;
+}
+
+void CullOccludedItems::run(const RenderContextPointer& renderContext, const ItemBounds& inItems, ItemBounds& outItems) {
+    assert(renderContext->args);
+    assert(renderContext->args->hasViewFrustum());
+    RenderArgs* args = renderContext->args;
+    auto& scene = renderContext->_scene;
+    auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
+
+    DepthPyramidPointer depthPyramid;
+    if (_cullOccluded) {
+        auto occlusionStage = scene->getStage<OcclusionStage>();
+        if (occlusionStage) {
+            depthPyramid = occlusionStage->getDepthPyramid();
+        }
+        if (depthPyramid && !isDepthPyramidUsable(*depthPyramid, args)) {
+            depthPyramid.reset();
+        }
+    }
+
+    if (!depthPyramid) {
+        outItems = inItems;
+        config->numOccluded = 0;
+        return;
+    }
+
+    PerformanceTimer perfTimer("CullOccludedItems");
+
+    outItems.clear();
+    outItems.reserve(inItems.size());
+    for (auto& item : inItems) {
+        // Only shapes, lights and metas keep their effect on what is around them when they are hidden
+        if (!item.bound.isNull() && scene->getItem(item.id).getKey().isShape() && depthPyramid->isOccluded(item.bound)) {
+            continue;
+        }
+        outItems.emplace_back(item);
+    }
+    config->numOccluded = (int)(inItems.size() - outItems.size());
+}
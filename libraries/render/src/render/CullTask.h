@@ -109,6 +109,34 @@ namespace render {
         void run(const RenderContextPointer& renderContext, const ItemSpatialTree::ItemSelection& inSelection, ItemBounds& outItems);
     };
 
+
+    class CullOccludedItemsConfig : public Job::Config {
+        Q_OBJECT
+        Q_PROPERTY(int numOccluded READ getNumOccluded)
+        Q_PROPERTY(bool cullOccluded MEMBER cullOccluded WRITE setCullOccluded)
+    public:
+        int numOccluded{ 0 };
+        int getNumOccluded() { return numOccluded; }
+
+        bool cullOccluded{ false };
+    public slots:
+        void setCullOccluded(bool enabled) { cullOccluded = enabled; emit dirty(); }
+    signals:
+        void dirty();
+    };
+
+    // Culls the shapes hidden behind the depth of the last frames, as found in the OcclusionStage.
+    // Items are only culled while the view is close to the one that depth was rendered from.
+    class CullOccludedItems {
+        bool _cullOccluded{ false }; // initialized by Config
+    public:
+        using Config = CullOccludedItemsConfig;
+        using JobModel = Job::ModelIO<CullOccludedItems, ItemBounds, ItemBounds, Config>;
+
+        void configure(const Config& config);
+        void run(const RenderContextPointer& renderContext, const ItemBounds& inItems, ItemBounds& outItems);
+    };
+
 }
 
 #endif // hifi_render_CullTask_h;
\ No newline at end of file
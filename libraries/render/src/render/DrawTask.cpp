@@ -15,6 +15,11 @@
 #include <algorithm>
 #include <assert.h>
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtConcurrent>
+
 #include <PerfStat.h>
 #include <ViewFrustum.h>
 #include <gpu/Context.h>
@@ -81,14 +86,15 @@ void render::renderStateSortShapes(const RenderContextPointer& renderContext,
         numItemsToDraw = glm::min(numItemsToDraw, maxDrawnItems);
     }
 
+    // Buckets point into the scene rather than copy its items, each copy of an item is a copy of its payload pointer
     using SortedPipelines = std::vector<render::ShapeKey>;
-    using SortedShapes = std::unordered_map<render::ShapeKey, std::vector<Item>, render::ShapeKey::Hash, render::ShapeKey::KeyEqual>;
+    using SortedShapes = std::unordered_map<render::ShapeKey, std::vector<const Item*>, render::ShapeKey::Hash, render::ShapeKey::KeyEqual>;
     SortedPipelines sortedPipelines;
     SortedShapes sortedShapes;
-    std::vector<Item> ownPipelineBucket;
+    std::vector<const Item*> ownPipelineBucket;
 
     for (auto i = 0; i < numItemsToDraw; ++i) {
-        auto item = scene->getItem(inItems[i].id);
+        const auto& item = scene->getItem(inItems[i].id);
 
         {
             assert(item.getKey().isShape());
@@ -98,9 +104,9 @@ void render::renderStateSortShapes(const RenderContextPointer& renderContext,
                 if (bucket.empty()) {
                     sortedPipelines.push_back(key);
                 }
-                bucket.push_back(item);
+                bucket.push_back(&item);
             } else if (key.hasOwnPipeline()) {
-                ownPipelineBucket.push_back(item);
+                ownPipelineBucket.push_back(&item);
             } else {
                 qCDebug(renderlogging) << "Item could not be rendered with invalid key" << key;
             }
@@ -114,14 +120,178 @@ void render::renderStateSortShapes(const RenderContextPointer& renderContext,
         if (!args->_shapePipeline) {            
             continue;
         }
-        for (auto& item : bucket) {
-            args->_shapePipeline->prepareShapeItem(args, pipelineKey, item);
-            item.render(args);
+        for (auto item : bucket) {
+            args->_shapePipeline->prepareShapeItem(args, pipelineKey, *item);
+            item->render(args);
         }
     }
     args->_shapePipeline = nullptr;
-    for (auto& item : ownPipelineBucket) {
-        item.render(args);
+    for (auto item : ownPipelineBucket) {
+        item->render(args);
+    }
+}
+
+// Below this many items per batch, spreading a pass over the recording threads costs more than it saves
+static const size_t MIN_CONCURRENT_ITEMS_PER_BATCH = 64;
+static const int MAX_RECORDING_THREADS = 4;
+
+static QThreadPool* getRecordingThreadPool() {
+    static QThreadPool* recordingThreadPool = [] {
+        auto threadPool = new QThreadPool(qApp);
+        // leave a core to the render thread, which records what cannot be recorded concurrently
+        threadPool->setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount() - 1, MAX_RECORDING_THREADS)));
+        return threadPool;
+    }();
+    return recordingThreadPool;
+}
+
+namespace {
+    struct PipelineItem {
+        ShapeKey key;
+        ShapePipelinePointer pipeline;
+        const Item* item;
+        bool concurrent;
+        uint64_t instanceKey;
+    };
+    using PipelineItems = std::vector<PipelineItem>;
+}
+
+static void recordPipelineItems(RenderArgs* args, PipelineItems::const_iterator begin, PipelineItems::const_iterator end) {
+    for (auto it = begin; it != end; ++it) {
+        if (it->pipeline != args->_shapePipeline) {
+            args->_shapePipeline = it->pipeline;
+            args->_batch->setPipeline(it->pipeline->pipeline);
+            it->pipeline->prepare(*(args->_batch), args);
+        }
+        args->_shapePipeline->prepareShapeItem(args, it->key, *(it->item));
+        it->item->render(args);
+    }
+    args->_shapePipeline = nullptr;
+}
+
+void render::renderStateSortShapesConcurrently(const RenderContextPointer& renderContext,
+    const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems, const ShapeKey& globalKey,
+    const BatchSetup& setupBatch) {
+    auto& scene = renderContext->_scene;
+    RenderArgs* args = renderContext->args;
+
+    int numItemsToDraw = (int)inItems.size();
+    if (maxDrawnItems != -1) {
+        numItemsToDraw = glm::min(numItemsToDraw, maxDrawnItems);
+    }
+
+    using SortedPipelines = std::vector<render::ShapeKey>;
+    using SortedShapes = std::unordered_map<render::ShapeKey, std::vector<const Item*>, render::ShapeKey::Hash, render::ShapeKey::KeyEqual>;
+    SortedPipelines sortedPipelines;
+    SortedShapes sortedShapes;
+    std::vector<const Item*> ownPipelineBucket;
+
+    for (auto i = 0; i < numItemsToDraw; ++i) {
+        const auto& item = scene->getItem(inItems[i].id);
+
+        assert(item.getKey().isShape());
+        auto key = item.getShapeKey() | globalKey;
+        if (key.isValid() && !key.hasOwnPipeline()) {
+            auto& bucket = sortedShapes[key];
+            if (bucket.empty()) {
+                sortedPipelines.push_back(key);
+            }
+            bucket.push_back(&item);
+        } else if (key.hasOwnPipeline()) {
+            ownPipelineBucket.push_back(&item);
+        } else {
+            qCDebug(renderlogging) << "Item could not be rendered with invalid key" << key;
+        }
+    }
+
+    // The pipelines are looked up here, the plumber creates the missing ones on the way
+    PipelineItems sortedItems;
+    size_t numConcurrentItems = 0;
+    for (auto& pipelineKey : sortedPipelines) {
+        auto pipeline = shapeContext->findPipeline(pipelineKey);
+        if (!pipeline) {
+            continue;
+        }
+        auto bucketBegin = sortedItems.size();
+        for (auto item : sortedShapes[pipelineKey]) {
+            bool concurrent = item->canRenderConcurrently();
+            numConcurrentItems += concurrent ? 1 : 0;
+            sortedItems.push_back({ pipelineKey, pipeline, item, concurrent, item->getInstanceKey() });
+        }
+
+        // Gather the instances of a part, for them to land in the same batch and be drawn at once.
+        // Instances are drawn once their batch is finished, the others keep their order.
+        std::stable_sort(sortedItems.begin() + bucketBegin, sortedItems.end(), [](const PipelineItem& a, const PipelineItem& b) {
+            return a.instanceKey < b.instanceKey;
+        });
+    }
+
+    // The performance timers are not thread safe, nothing is recorded concurrently while they are on
+    int numConcurrentBatches = 0;
+    if (!PerformanceTimer::isActive()) {
+        numConcurrentBatches = (int)std::min((size_t)getRecordingThreadPool()->maxThreadCount(),
+            numConcurrentItems / MIN_CONCURRENT_ITEMS_PER_BATCH);
+    }
+
+    PipelineItems concurrentItems;
+    PipelineItems renderThreadItems;
+    if (numConcurrentBatches < 2) {
+        // Not worth it, everything goes in one batch in the order renderStateSortShapes would have recorded it
+        numConcurrentBatches = 0;
+        renderThreadItems.swap(sortedItems);
+    } else {
+        concurrentItems.reserve(numConcurrentItems);
+        renderThreadItems.reserve(sortedItems.size() - numConcurrentItems);
+        for (auto& sortedItem : sortedItems) {
+            (sortedItem.concurrent ? concurrentItems : renderThreadItems).push_back(sortedItem);
+        }
+    }
+
+    // One batch per recording thread, the last one for the render thread
+    std::vector<gpu::Batch> batches(numConcurrentBatches + 1);
+    std::vector<RenderArgs> concurrentArgs(numConcurrentBatches, *args);
+    std::vector<QFuture<void>> recordings;
+    size_t batchEnd = 0;
+    for (int i = 0; i < numConcurrentBatches; ++i) {
+        size_t batchBegin = batchEnd;
+        batchEnd = std::max(batchBegin, concurrentItems.size() * (i + 1) / numConcurrentBatches);
+        // Do not split the instances of a part over two batches
+        while (batchEnd > batchBegin && batchEnd < concurrentItems.size() && concurrentItems[batchEnd].instanceKey != 0 &&
+               concurrentItems[batchEnd].instanceKey == concurrentItems[batchEnd - 1].instanceKey &&
+               concurrentItems[batchEnd].pipeline == concurrentItems[batchEnd - 1].pipeline) {
+            ++batchEnd;
+        }
+        auto begin = concurrentItems.cbegin() + batchBegin;
+        auto end = concurrentItems.cbegin() + batchEnd;
+        RenderArgs* batchArgs = &concurrentArgs[i];
+        batchArgs->_batch = &batches[i];
+        batchArgs->_shapePipeline = nullptr;
+        batchArgs->_details = RenderDetails();
+        recordings.push_back(QtConcurrent::run(getRecordingThreadPool(), [batchArgs, begin, end, &setupBatch] {
+            setupBatch(*(batchArgs->_batch));
+            recordPipelineItems(batchArgs, begin, end);
+        }));
+    }
+
+    for (int i = 0; i < numConcurrentBatches; ++i) {
+        recordings[i].waitForFinished();
+        args->_details._materialSwitches += concurrentArgs[i]._details._materialSwitches;
+        args->_details._trianglesRendered += concurrentArgs[i]._details._trianglesRendered;
+    }
+
+    auto boundBatch = args->_batch;
+    auto& renderThreadBatch = batches.back();
+    args->_batch = &renderThreadBatch;
+    setupBatch(renderThreadBatch);
+    recordPipelineItems(args, renderThreadItems.cbegin(), renderThreadItems.cend());
+    for (auto item : ownPipelineBucket) {
+        item->render(args);
+    }
+    args->_batch = boundBatch;
+
+    // Whichever recording finished first, the frame gets the batches in the same order
+    for (auto& batch : batches) {
+        args->_context->appendFrameBatch(batch);
     }
 }
 
@@ -20,6 +20,12 @@ void renderItems(const RenderContextPointer& renderContext, const ItemBounds& in
 void renderShapes(const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems = -1, const ShapeKey& globalKey = ShapeKey());
 void renderStateSortShapes(const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems = -1, const ShapeKey& globalKey = ShapeKey());
 
+// Records what renderStateSortShapes would, with the items that can render concurrently spread over several recording threads.
+// Each thread records into a batch of its own started with setupBatch, the other items are recorded on the render thread
+// once they are done, and the batches are appended to the frame in that order. To be called outside of gpu::doInBatch.
+using BatchSetup = std::function<void(gpu::Batch& batch)>;
+void renderStateSortShapesConcurrently(const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems, const ShapeKey& globalKey, const BatchSetup& setupBatch);
+
 class DrawLightConfig : public Job::Config {
     Q_OBJECT
     Q_PROPERTY(int numDrawn READ getNumDrawn NOTIFY numDrawnChanged)
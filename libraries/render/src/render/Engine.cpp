@@ -33,6 +33,7 @@ public:
 
     void build(JobModel& task, const Varying& in, Varying& out) {
         task.addJob<EngineStats>("Stats");
+        task.addJob<EngineProfiler>("Profiler");
     }
 };
 
@@ -15,6 +15,7 @@
 #include <SettingHandle.h>
 
 #include "Scene.h"
+#include "JobProfiler.h"
 #include "../task/Task.h"
 #include "gpu/Batch.h"
 
@@ -26,8 +27,12 @@ namespace render {
     public:
         virtual ~RenderContext() {}
 
+        void beginJob(const std::string& name) override { _jobProfiler->beginJob(args, name); }
+        void endJob(const std::string& name, double msCPURunTime) override { _jobProfiler->endJob(args, name, msCPURunTime); }
+
         RenderArgs* args;
         ScenePointer _scene;
+        JobProfilerPointer _jobProfiler { std::make_shared<JobProfiler>() };
     };
     using RenderContextPointer = std::shared_ptr<RenderContext>;
 
@@ -96,7 +101,12 @@ namespace render {
 
         // Render a frame
         // Must have a scene registered and a context set
-        void run() { assert(_renderContext);  Task::run(_renderContext); }
+        // Profiling is switched for whole frames only, so the jobs profiled always begin and end in pairs
+        void run() {
+            assert(_renderContext);
+            _renderContext->isProfilingJobs = _renderContext->_jobProfiler->isEnabled();
+            Task::run(_renderContext);
+        }
 
     protected:
         RenderContextPointer _renderContext;
@@ -10,6 +10,7 @@
 //
 #include "EngineStats.h"
 
+#include <gpu/Batch.h>
 #include <gpu/Texture.h>
 
 using namespace render;
@@ -63,4 +64,41 @@ void EngineStats::run(const RenderContextPointer& renderContext) {
 
     config->frameSetPipelineCount = _gpuStats._PSNumSetPipelines;
     config->frameSetInputFormatCount = _gpuStats._ISNumFormatChanges;
+
+    config->frameRedundantInputCount = _gpuStats._ISNumRedundantChanges;
+    config->frameRedundantBindCount = _gpuStats._RSNumRedundantBinds;
+    config->frameRedundantPipelineCount = _gpuStats._PSNumRedundantSetPipelines;
+
+    auto numBatchStorageAllocations = gpu::Batch::getNumStorageAllocations();
+    auto numBatchStorageReuses = gpu::Batch::getNumStorageReuses();
+    config->frameBatchAllocationCount = (quint32)(numBatchStorageAllocations - _numBatchStorageAllocations);
+    config->frameBatchReuseCount = (quint32)(numBatchStorageReuses - _numBatchStorageReuses);
+    _numBatchStorageAllocations = numBatchStorageAllocations;
+    _numBatchStorageReuses = numBatchStorageReuses;
+}
+
+void EngineProfiler::run(const RenderContextPointer& renderContext) {
+    auto& jobProfiler = renderContext->_jobProfiler;
+    jobProfiler->setEnabled(_isProfiling);
+
+    auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
+    config->jobTimings.clear();
+    if (!_isProfiling) {
+        return;
+    }
+
+    for (const auto& timing : jobProfiler->getTimings()) {
+        QString path = QString::fromStdString(timing.path);
+        config->jobTimings.push_back(QVariantMap {
+            { "name", QString::fromStdString(timing.name) },
+            { "path", path },
+            { "depth", timing.depth },
+            { "cpuRunTime", timing.cpuRunTime },
+            { "gpuRunTime", timing.gpuRunTime },
+            { "batchRunTime", timing.batchRunTime }
+        });
+
+        // One counter track per job in the trace
+        PROFILE_COUNTER(render_gpu, path, { { "gpu", timing.gpuRunTime }, { "cpu", timing.cpuRunTime } });
+    }
 }
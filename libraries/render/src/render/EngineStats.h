@@ -61,6 +61,13 @@ namespace render {
         Q_PROPERTY(quint32 frameSetPipelineCount MEMBER frameSetPipelineCount NOTIFY dirty)
         Q_PROPERTY(quint32 frameSetInputFormatCount MEMBER frameSetInputFormatCount NOTIFY dirty)
 
+        Q_PROPERTY(quint32 frameRedundantInputCount MEMBER frameRedundantInputCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameRedundantBindCount MEMBER frameRedundantBindCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameRedundantPipelineCount MEMBER frameRedundantPipelineCount NOTIFY dirty)
+
+        Q_PROPERTY(quint32 frameBatchAllocationCount MEMBER frameBatchAllocationCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameBatchReuseCount MEMBER frameBatchReuseCount NOTIFY dirty)
+
 
     public:
         EngineStatsConfig() : Job::Config(true) {}
@@ -102,6 +109,15 @@ namespace render {
 
         quint32 frameSetInputFormatCount{ 0 };
 
+        // the batch commands that set what was already set, and were skipped
+        quint32 frameRedundantInputCount{ 0 };
+        quint32 frameRedundantBindCount{ 0 };
+        quint32 frameRedundantPipelineCount{ 0 };
+
+        // the batches that allocated their storage, and those that took it over from ones that went away
+        quint32 frameBatchAllocationCount{ 0 };
+        quint32 frameBatchReuseCount{ 0 };
+
 
 
         void emitDirty() { emit dirty(); }
@@ -113,6 +129,8 @@ namespace render {
     class EngineStats {
         gpu::ContextStats _gpuStats;
         QElapsedTimer _frameTimer;
+        size_t _numBatchStorageAllocations { 0 };
+        size_t _numBatchStorageReuses { 0 };
     public:
         using Config = EngineStatsConfig;
         using JobModel = Job::Model<EngineStats, Config>;
@@ -122,6 +140,40 @@ namespace render {
         void configure(const Config& configuration) {}
         void run(const RenderContextPointer& renderContext);
     };
+
+    class EngineProfilerConfig : public Job::Config {
+        Q_OBJECT
+        Q_PROPERTY(bool profiling MEMBER profiling NOTIFY dirty)
+    public:
+        EngineProfilerConfig() : Job::Config(true) {}
+
+        // Profile the cpu and gpu time of every job, from the next frame on
+        bool profiling { false };
+
+        // The rolling timings of the jobs as a depth first list of
+        // { name, path, depth, cpuRunTime, gpuRunTime, batchRunTime }, times in ms
+        Q_INVOKABLE QVariantList getJobTimings() const { return jobTimings; }
+
+        QVariantList jobTimings;
+
+        void emitDirty() { emit dirty(); }
+
+    signals:
+        void dirty();
+    };
+
+    // Switches the profiling of the jobs and publishes their timings, to scripts and to the gpu tracks of the trace
+    class EngineProfiler {
+    public:
+        using Config = EngineProfilerConfig;
+        using JobModel = Job::Model<EngineProfiler, Config>;
+
+        void configure(const Config& configuration) { _isProfiling = configuration.profiling; }
+        void run(const RenderContextPointer& renderContext);
+
+    protected:
+        bool _isProfiling { false };
+    };
 }
 
 #endif
\ No newline at end of file
@@ -318,6 +318,8 @@ public:
         virtual int getLayer() const = 0;
 
         virtual void render(RenderArgs* args) = 0;
+        virtual bool canRenderConcurrently() const = 0;
+        virtual uint64_t getInstanceKey() const = 0;
 
         virtual const ShapeKey getShapeKey() const = 0;
 
@@ -367,6 +369,12 @@ public:
     // Render call for the item
     void render(RenderArgs* args) const { _payload->render(args); }
 
+    // Can the item be rendered on a recording thread, at the same time as other items of its pass
+    bool canRenderConcurrently() const { return _payload->canRenderConcurrently(); }
+
+    // Items with the same non zero instance key are drawn as instances of each other, if the sort keeps them together
+    uint64_t getInstanceKey() const { return _payload->getInstanceKey(); }
+
     // Shape Type Interface
     const ShapeKey getShapeKey() const { return _payload->getShapeKey(); }
 
@@ -410,6 +418,14 @@ template <class T> const Item::Bound payloadGetBound(const std::shared_ptr<T>& p
 template <class T> int payloadGetLayer(const std::shared_ptr<T>& payloadData) { return 0; }
 template <class T> void payloadRender(const std::shared_ptr<T>& payloadData, RenderArgs* args) { }
 
+// Specialize to true if rendering the payload only records into args->_batch and touches no other state than its own,
+// so that it can be recorded off the render thread along with other items of its pass.
+template <class T> bool payloadCanRenderConcurrently(const std::shared_ptr<T>& payloadData) { return false; }
+
+// Specialize to identify the payloads that only differ from each other by their transform, and get drawn as instances.
+// 0 means the payload is drawn on its own.
+template <class T> uint64_t payloadGetInstanceKey(const std::shared_ptr<T>& payloadData) { return 0; }
+
 // Shape type interface
 // This allows shapes to characterize their pipeline via a ShapeKey, to be picked with a subclass of Shape.
 // When creating a new shape payload you need to create a specialized version, or the ShapeKey will be ownPipeline,
@@ -438,6 +454,8 @@ public:
 
 
     virtual void render(RenderArgs* args) override { payloadRender<T>(_data, args); }
+    virtual bool canRenderConcurrently() const override { return payloadCanRenderConcurrently<T>(_data); }
+    virtual uint64_t getInstanceKey() const override { return payloadGetInstanceKey<T>(_data); }
 
     // Shape Type interface
     virtual const ShapeKey getShapeKey() const override { return shapeGetShapeKey<T>(_data); }
@@ -0,0 +1,83 @@
+//
+//  JobProfiler.cpp
+//  render/src/render
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JobProfiler.h"
+
+#include <gpu/Context.h>
+
+using namespace render;
+
+void JobProfiler::beginJob(RenderArgs* args, const std::string& name) {
+    std::string path = _runningNodes.empty() ? name : _nodes[_runningNodes.back()].path + "/" + name;
+
+    size_t index;
+    auto found = _nodeIndices.find(path);
+    if (found != _nodeIndices.end()) {
+        index = found->second;
+    } else {
+        index = _nodes.size();
+        _nodes.emplace_back(name, path, (int)_runningNodes.size());
+        _nodeIndices[path] = index;
+        if (_runningNodes.empty()) {
+            _rootNodes.push_back(index);
+        } else {
+            _nodes[_runningNodes.back()].children.push_back(index);
+        }
+    }
+    _runningNodes.push_back(index);
+
+    if (args && args->_context) {
+        auto gpuTimer = _nodes[index].gpuTimer;
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            gpuTimer->begin(batch);
+        });
+    }
+}
+
+void JobProfiler::endJob(RenderArgs* args, const std::string& name, double msCPURunTime) {
+    if (_runningNodes.empty()) {
+        return;
+    }
+    auto& node = _nodes[_runningNodes.back()];
+    _runningNodes.pop_back();
+    assert(node.name == name);
+
+    node.cpuRunTime.addSample(msCPURunTime);
+
+    if (args && args->_context) {
+        auto gpuTimer = node.gpuTimer;
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            gpuTimer->end(batch);
+        });
+    }
+}
+
+void JobProfiler::appendTimings(const std::vector<size_t>& nodes, Timings& timings) const {
+    for (auto index : nodes) {
+        const auto& node = _nodes[index];
+        Timing timing;
+        timing.name = node.name;
+        timing.path = node.path;
+        timing.depth = node.depth;
+        timing.cpuRunTime = node.cpuRunTime.average;
+        timing.gpuRunTime = node.gpuTimer->getGPUAverage();
+        timing.batchRunTime = node.gpuTimer->getBatchAverage();
+        timings.push_back(timing);
+
+        appendTimings(node.children, timings);
+    }
+}
+
+JobProfiler::Timings JobProfiler::getTimings() const {
+    Timings timings;
+    timings.reserve(_nodes.size());
+    appendTimings(_rootNodes, timings);
+    return timings;
+}
@@ -0,0 +1,78 @@
+//
+//  JobProfiler.h
+//  render/src/render
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_JobProfiler_h
+#define hifi_render_JobProfiler_h
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SimpleMovingAverage.h>
+
+#include <gpu/Query.h>
+
+#include "Args.h"
+
+namespace render {
+
+    // Rolling cpu and gpu timings of every job run by the engine, as a tree of job paths.
+    // Each job is bracketed by a gpu range timer, so the gpu timings come a few frames late;
+    // where timer queries don't nest (Mac) only the outermost job gets a gpu timing.
+    class JobProfiler {
+    public:
+        static const int NUM_AVERAGED_RUNS { 8 };
+
+        struct Timing {
+            std::string name;
+            std::string path;
+            int depth { 0 };
+            double cpuRunTime { 0.0 };
+            double gpuRunTime { 0.0 };
+            double batchRunTime { 0.0 };
+        };
+        using Timings = std::vector<Timing>;
+
+        void setEnabled(bool enabled) { _isEnabled = enabled; }
+        bool isEnabled() const { return _isEnabled; }
+
+        // Called by the context around the run of each job, on the thread of the engine
+        void beginJob(RenderArgs* args, const std::string& name);
+        void endJob(RenderArgs* args, const std::string& name, double msCPURunTime);
+
+        // The timings of all the jobs profiled so far, depth first, the children of a task in the order they run
+        Timings getTimings() const;
+
+    protected:
+        struct Node {
+            Node(const std::string& name, const std::string& path, int depth) :
+                name(name), path(path), depth(depth), gpuTimer(std::make_shared<gpu::RangeTimer>(path)) {}
+
+            std::string name;
+            std::string path;
+            int depth;
+            MovingAverage<double, NUM_AVERAGED_RUNS> cpuRunTime;
+            gpu::RangeTimerPointer gpuTimer;
+            std::vector<size_t> children;
+        };
+
+        void appendTimings(const std::vector<size_t>& nodes, Timings& timings) const;
+
+        std::vector<Node> _nodes;
+        std::vector<size_t> _rootNodes;
+        std::unordered_map<std::string, size_t> _nodeIndices;
+        std::vector<size_t> _runningNodes;
+        bool _isEnabled { false };
+    };
+    using JobProfilerPointer = std::shared_ptr<JobProfiler>;
+
+}
+
+#endif // hifi_render_JobProfiler_h
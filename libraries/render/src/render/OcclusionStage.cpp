@@ -0,0 +1,119 @@
+//
+//  OcclusionStage.cpp
+//  render/src/render
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OcclusionStage.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <SharedUtil.h>
+
+using namespace render;
+
+std::string OcclusionStage::_stageName { "OCCLUSION_STAGE" };
+
+// Coarsest rectangle, in texels of its level, an item is compared against
+static const int MAX_TESTED_TEXELS_PER_SIDE = 4;
+
+// Relative margin the nearest depth of an item must be behind the depth by, for the precision of the readback
+static const float OCCLUSION_DEPTH_BIAS = 0.01f;
+
+DepthPyramid::DepthPyramid(const glm::ivec2& size, std::vector<float>&& depths, const ViewFrustum& frustum) :
+    _frustum(frustum),
+    _viewProjection(frustum.getProjection() * glm::inverse(frustum.getView())),
+    _timestamp(usecTimestampNow()) {
+    assert(depths.size() == (size_t)(size.x * size.y));
+    _levels.push_back({ size, std::move(depths) });
+
+    // Each texel of a level keeps the farthest of the 2 by 2 texels below it, odd sizes round up
+    while (_levels.back().size.x > 1 || _levels.back().size.y > 1) {
+        const auto& lower = _levels.back();
+        Level level;
+        level.size = glm::max((lower.size + glm::ivec2(1)) / 2, glm::ivec2(1));
+        level.depths.resize(level.size.x * level.size.y);
+        for (int y = 0; y < level.size.y; ++y) {
+            int y0 = 2 * y;
+            int y1 = std::min(y0 + 1, lower.size.y - 1);
+            for (int x = 0; x < level.size.x; ++x) {
+                int x0 = 2 * x;
+                int x1 = std::min(x0 + 1, lower.size.x - 1);
+                level.depths[y * level.size.x + x] = std::max(
+                    std::max(lower.depths[y0 * lower.size.x + x0], lower.depths[y0 * lower.size.x + x1]),
+                    std::max(lower.depths[y1 * lower.size.x + x0], lower.depths[y1 * lower.size.x + x1]));
+            }
+        }
+        _levels.push_back(std::move(level));
+    }
+}
+
+bool DepthPyramid::isOccluded(const AABox& box) const {
+    // Rectangle and nearest depth of the box as seen from the frustum
+    glm::vec2 minNDC(std::numeric_limits<float>::max());
+    glm::vec2 maxNDC(-std::numeric_limits<float>::max());
+    float nearestDepth = std::numeric_limits<float>::max();
+    for (int i = BOTTOM_LEFT_NEAR; i <= TOP_LEFT_FAR; ++i) {
+        glm::vec4 clipPosition = _viewProjection * glm::vec4(box.getVertex((BoxVertex)i), 1.0f);
+        if (clipPosition.w < _frustum.getNearClip()) {
+            // The box crosses the near plane, there is no depth in front of it
+            return false;
+        }
+        glm::vec2 ndc = glm::vec2(clipPosition) / clipPosition.w;
+        minNDC = glm::min(minNDC, ndc);
+        maxNDC = glm::max(maxNDC, ndc);
+        nearestDepth = std::min(nearestDepth, clipPosition.w);
+    }
+    if (maxNDC.x < -1.0f || maxNDC.y < -1.0f || minNDC.x > 1.0f || minNDC.y > 1.0f) {
+        // Out of the view the depth was rendered in, frustum culling has the last word on it
+        return false;
+    }
+
+    const auto& base = _levels.front();
+    glm::vec2 baseSize(base.size);
+    glm::ivec2 minTexel = glm::clamp(glm::ivec2(glm::floor((glm::clamp(minNDC, -1.0f, 1.0f) * 0.5f + 0.5f) * baseSize)),
+        glm::ivec2(0), base.size - glm::ivec2(1));
+    glm::ivec2 maxTexel = glm::clamp(glm::ivec2(glm::floor((glm::clamp(maxNDC, -1.0f, 1.0f) * 0.5f + 0.5f) * baseSize)),
+        glm::ivec2(0), base.size - glm::ivec2(1));
+
+    // Go up the levels until the rectangle covers a few texels only
+    int levelIndex = 0;
+    while (levelIndex + 1 < (int)_levels.size() &&
+           glm::max(maxTexel.x - minTexel.x, maxTexel.y - minTexel.y) >= MAX_TESTED_TEXELS_PER_SIDE) {
+        minTexel >>= 1;
+        maxTexel >>= 1;
+        ++levelIndex;
+    }
+
+    const auto& level = _levels[levelIndex];
+    float farthestDepth = 0.0f;
+    for (int y = minTexel.y; y <= maxTexel.y; ++y) {
+        for (int x = minTexel.x; x <= maxTexel.x; ++x) {
+            farthestDepth = std::max(farthestDepth, level.depths[y * level.size.x + x]);
+        }
+    }
+
+    return nearestDepth > farthestDepth * (1.0f + OCCLUSION_DEPTH_BIAS);
+}
+
+void OcclusionStage::setDepthPyramid(const DepthPyramidPointer& depthPyramid) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _depthPyramid = depthPyramid;
+}
+
+DepthPyramidPointer OcclusionStage::getDepthPyramid() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _depthPyramid;
+}
+
+void OcclusionStageSetup::run(const RenderContextPointer& renderContext) {
+    auto stage = renderContext->_scene->getStage(OcclusionStage::getName());
+    if (!stage) {
+        renderContext->_scene->resetStage(OcclusionStage::getName(), std::make_shared<OcclusionStage>());
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  OcclusionStage.h
+//  render/src/render
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_OcclusionStage_h
+#define hifi_render_OcclusionStage_h
+
+#include <mutex>
+#include <vector>
+
+#include <AABox.h>
+#include <ViewFrustum.h>
+
+#include "Engine.h"
+#include "Stage.h"
+
+namespace render {
+
+    // The linear depth of a past frame, reduced to the farthest depth of each texel, level after level.
+    // An item whose nearest point is farther than the farthest depth over the rectangle it covers was hidden then.
+    class DepthPyramid {
+    public:
+        // depths is the bottom level, row by row from the bottom of the view the frustum was rendered with
+        DepthPyramid(const glm::ivec2& size, std::vector<float>&& depths, const ViewFrustum& frustum);
+
+        const ViewFrustum& getFrustum() const { return _frustum; }
+        uint64_t getTimestamp() const { return _timestamp; }
+        int getNumLevels() const { return (int)_levels.size(); }
+
+        // Is the box, seen from the frustum, entirely behind the depth
+        bool isOccluded(const AABox& box) const;
+
+    protected:
+        struct Level {
+            glm::ivec2 size;
+            std::vector<float> depths;
+        };
+        std::vector<Level> _levels;
+
+        ViewFrustum _frustum;
+        glm::mat4 _viewProjection;
+        uint64_t _timestamp;
+    };
+    using DepthPyramidPointer = std::shared_ptr<const DepthPyramid>;
+
+    // Occlusion stage to hand the depth of the last frames to the culling of the next ones
+    class OcclusionStage : public Stage {
+    public:
+        static std::string _stageName;
+        static const std::string& getName() { return _stageName; }
+
+        // Thread safe, the depth is typically read back on the thread of the gpu backend
+        void setDepthPyramid(const DepthPyramidPointer& depthPyramid);
+        DepthPyramidPointer getDepthPyramid() const;
+
+    protected:
+        mutable std::mutex _mutex;
+        DepthPyramidPointer _depthPyramid;
+    };
+    using OcclusionStagePointer = std::shared_ptr<OcclusionStage>;
+
+    class OcclusionStageSetup {
+    public:
+        using JobModel = Job::Model<OcclusionStageSetup>;
+
+        void run(const RenderContextPointer& renderContext);
+    };
+
+}
+
+#endif // hifi_render_OcclusionStage_h
@@ -24,7 +24,8 @@ void RenderFetchCullSortTask::build(JobModel& task, const Varying& input, Varyin
     // Fetch and cull the items from the scene
     auto spatialFilter = ItemFilter::Builder::visibleWorldItems().withoutLayered();
     const auto spatialSelection = task.addJob<FetchSpatialTree>("FetchSceneSelection", spatialFilter);
-    const auto culledSpatialSelection = task.addJob<CullSpatialSelection>("CullSceneSelection", spatialSelection, cullFunctor, RenderDetails::ITEM, spatialFilter);
+    const auto frustumCulledSelection = task.addJob<CullSpatialSelection>("CullSceneSelection", spatialSelection, cullFunctor, RenderDetails::ITEM, spatialFilter);
+    const auto culledSpatialSelection = task.addJob<CullOccludedItems>("CullOccludedSelection", frustumCulledSelection);
 
     // Overlays are not culled
     const auto nonspatialSelection = task.addJob<FetchNonspatialItems>("FetchOverlaySelection");
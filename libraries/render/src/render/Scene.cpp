@@ -10,6 +10,7 @@
 //
 #include "Scene.h"
 
+#include <algorithm>
 #include <numeric>
 #include <gpu/Batch.h>
 #include "Logging.h"
@@ -103,14 +104,19 @@ void Scene::processTransactionQueue() {
         // Now we know for sure that we have enough items in the array to
         // capture anything coming from the transaction
 
+        ItemChanges changes;
+
         // resets and potential NEW items
-        resetItems(consolidatedTransaction._resetItems, consolidatedTransaction._resetPayloads);
+        resetItems(consolidatedTransaction._resetItems, consolidatedTransaction._resetPayloads, changes);
 
         // Update the numItemsAtomic counter AFTER the reset changes went through
         _numAllocatedItems.exchange(maxID);
 
         // updates
-        updateItems(consolidatedTransaction._updatedItems, consolidatedTransaction._updateFunctors);
+        updateItems(consolidatedTransaction._updatedItems, consolidatedTransaction._updateFunctors, changes);
+
+        // Move the reset and updated items in their containers, all at once
+        resetItemContainers(changes);
 
         // removes
         removeItems(consolidatedTransaction._removedItems);
@@ -127,26 +133,15 @@ void Scene::processTransactionQueue() {
     }
 }
 
-void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
+void Scene::resetItems(const ItemIDs& ids, Payloads& payloads, ItemChanges& changes) {
     auto resetPayload = payloads.begin();
     for (auto resetID : ids) {
         // Access the true item
         auto& item = _items[resetID];
-        auto oldKey = item.getKey();
-        auto oldCell = item.getCell();
+        changes.push_back({ resetID, item.getKey(), item.getCell() });
 
         // Reset the item with a new payload
         item.resetPayload(*resetPayload);
-        auto newKey = item.getKey();
-
-        // Update the item's container
-        assert((oldKey.isSpatial() == newKey.isSpatial()) || oldKey._flags.none());
-        if (newKey.isSpatial()) {
-            auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), resetID, newKey);
-            item.resetCell(newCell, newKey.isSmall());
-        } else {
-            _masterNonspatialSet.insert(resetID);
-        }
 
         // next loop
         resetPayload++;
@@ -172,7 +167,7 @@ void Scene::removeItems(const ItemIDs& ids) {
     }
 }
 
-void Scene::updateItems(const ItemIDs& ids, UpdateFunctors& functors) {
+void Scene::updateItems(const ItemIDs& ids, UpdateFunctors& functors, ItemChanges& changes) {
 
     auto updateFunctor = functors.begin();
     for (auto updateID : ids) {
@@ -183,36 +178,54 @@ void Scene::updateItems(const ItemIDs& ids, UpdateFunctors& functors) {
 
         // Access the true item
         auto& item = _items[updateID];
-        auto oldCell = item.getCell();
-        auto oldKey = item.getKey();
+        changes.push_back({ updateID, item.getKey(), item.getCell() });
 
         // Update the item
         item.update((*updateFunctor));
+
+        // next loop
+        updateFunctor++;
+    }
+}
+
+void Scene::resetItemContainers(ItemChanges& changes) {
+    // Only the first change of an item knows where it was before the transaction
+    std::stable_sort(changes.begin(), changes.end(), [](const ItemChange& a, const ItemChange& b) { return a.id < b.id; });
+    changes.erase(std::unique(changes.begin(), changes.end(), [](const ItemChange& a, const ItemChange& b) { return a.id == b.id; }),
+        changes.end());
+
+    ItemSpatialTree::ItemResets spatialResets;
+    spatialResets.reserve(changes.size());
+    for (const auto& change : changes) {
+        auto& item = _items[change.id];
+        auto oldKey = change.oldKey;
         auto newKey = item.getKey();
 
         // Update the item's container
-        if (oldKey.isSpatial() == newKey.isSpatial()) {
-            if (newKey.isSpatial()) {
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
-                item.resetCell(newCell, newKey.isSmall());
+        if (newKey.isSpatial()) {
+            ItemSpatialTree::ItemReset reset;
+            reset.item = change.id;
+            reset.bound = item.getBound();
+            reset.newKey = newKey;
+            if (oldKey.isSpatial()) {
+                reset.oldCell = change.oldCell;
+                reset.oldKey = oldKey;
+            } else {
+                _masterNonspatialSet.erase(change.id);
             }
+            spatialResets.push_back(reset);
         } else {
-            if (newKey.isSpatial()) {
-                _masterNonspatialSet.erase(updateID);
-
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
-                item.resetCell(newCell, newKey.isSmall());
-            } else {
-                _masterSpatialTree.removeItem(oldCell, oldKey, updateID);
+            if (oldKey.isSpatial()) {
+                _masterSpatialTree.removeItem(change.oldCell, oldKey, change.id);
                 item.resetCell();
-
-                _masterNonspatialSet.insert(updateID);
             }
+            _masterNonspatialSet.insert(change.id);
         }
+    }
 
-
-        // next loop
-        updateFunctor++;
+    _masterSpatialTree.resetItems(spatialResets);
+    for (const auto& reset : spatialResets) {
+        _items[reset.item].resetCell(reset.newCell, reset.newKey.isSmall());
     }
 }
 
@@ -138,9 +138,20 @@ protected:
     ItemSpatialTree _masterSpatialTree;
     ItemIDSet _masterNonspatialSet;
 
-    void resetItems(const ItemIDs& ids, Payloads& payloads);
+    // The key and cell of an item before the transaction touched it.
+    // However many times an item is reset or updated, its container is only reset once the transaction is applied.
+    class ItemChange {
+    public:
+        ItemID id;
+        ItemKey oldKey;
+        ItemCell oldCell;
+    };
+    using ItemChanges = std::vector<ItemChange>;
+
+    void resetItems(const ItemIDs& ids, Payloads& payloads, ItemChanges& changes);
     void removeItems(const ItemIDs& ids);
-    void updateItems(const ItemIDs& ids, UpdateFunctors& functors);
+    void updateItems(const ItemIDs& ids, UpdateFunctors& functors, ItemChanges& changes);
+    void resetItemContainers(ItemChanges& changes);
 
     // The Selection map
     mutable std::mutex _selectionsMutex; // mutable so it can be used in the thread safe getSelection const method
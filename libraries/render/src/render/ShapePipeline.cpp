@@ -73,6 +73,8 @@ void ShapePlumber::addPipeline(const Filter& filter, const gpu::ShaderPointer& p
     gpu::Shader::BindingSet slotBindings;
     slotBindings.insert(gpu::Shader::Binding(std::string("lightingModelBuffer"), Slot::BUFFER::LIGHTING_MODEL));
     slotBindings.insert(gpu::Shader::Binding(std::string("skinClusterBuffer"), Slot::BUFFER::SKINNING));
+    slotBindings.insert(gpu::Shader::Binding(std::string("skinPoseBuffer"), Slot::RESOURCE_BUFFER::SKINNING_POSES));
+    slotBindings.insert(gpu::Shader::Binding(std::string("skinClusterBindBuffer"), Slot::RESOURCE_BUFFER::SKINNING_CLUSTERS));
     slotBindings.insert(gpu::Shader::Binding(std::string("materialBuffer"), Slot::BUFFER::MATERIAL));
     slotBindings.insert(gpu::Shader::Binding(std::string("texMapArrayBuffer"), Slot::BUFFER::TEXMAPARRAY));
     slotBindings.insert(gpu::Shader::Binding(std::string("albedoMap"), Slot::MAP::ALBEDO));
@@ -110,12 +112,8 @@ void ShapePlumber::addPipeline(const Filter& filter, const gpu::ShaderPointer& p
     addPipelineHelper(filter, key, 0, shapePipeline);
 }
 
-const ShapePipelinePointer ShapePlumber::pickPipeline(RenderArgs* args, const Key& key) const {
+const ShapePipelinePointer ShapePlumber::findPipeline(const Key& key) const {
     assert(!_pipelineMap.empty());
-    assert(args);
-    assert(args->_batch);
-
-    PerformanceTimer perfTimer("ShapePlumber::pickPipeline");
 
     const auto& pipelineIterator = _pipelineMap.find(key);
     if (pipelineIterator == _pipelineMap.end()) {
@@ -127,7 +125,7 @@ const ShapePipelinePointer ShapePlumber::pickPipeline(RenderArgs* args, const Ke
                     // found a factory for the custom key, can now generate a shape pipeline for this case:
                     addPipelineHelper(Filter(key), key, 0, (factoryIt)->second(*this, key));
 
-                    return pickPipeline(args, key);
+                    return findPipeline(key);
                 } else {
                     qCDebug(renderlogging) << "ShapePlumber::Couldn't find a custom pipeline factory for " << key.getCustom() << " key is: " << key;
                 }
@@ -139,7 +137,19 @@ const ShapePipelinePointer ShapePlumber::pickPipeline(RenderArgs* args, const Ke
         return PipelinePointer(nullptr);
     }
 
-    PipelinePointer shapePipeline(pipelineIterator->second);
+    return pipelineIterator->second;
+}
+
+const ShapePipelinePointer ShapePlumber::pickPipeline(RenderArgs* args, const Key& key) const {
+    assert(args);
+    assert(args->_batch);
+
+    PerformanceTimer perfTimer("ShapePlumber::pickPipeline");
+
+    PipelinePointer shapePipeline = findPipeline(key);
+    if (!shapePipeline) {
+        return PipelinePointer(nullptr);
+    }
 
     // Setup the one pipeline (to rule them all)
     args->_batch->setPipeline(shapePipeline->pipeline);
@@ -32,6 +32,7 @@ public:
         SPECULAR,
         UNLIT,
         SKINNED,
+        DUAL_QUAT_SKINNED,
         DEPTH_ONLY,
         DEPTH_BIAS,
         WIREFRAME,
@@ -79,6 +80,7 @@ public:
         Builder& withSpecular() { _flags.set(SPECULAR); return (*this); }
         Builder& withUnlit() { _flags.set(UNLIT); return (*this); }
         Builder& withSkinned() { _flags.set(SKINNED); return (*this); }
+        Builder& withDualQuatSkinned() { _flags.set(DUAL_QUAT_SKINNED); return (*this); }
         Builder& withDepthOnly() { _flags.set(DEPTH_ONLY); return (*this); }
         Builder& withDepthBias() { _flags.set(DEPTH_BIAS); return (*this); }
         Builder& withWireframe() { _flags.set(WIREFRAME); return (*this); }
@@ -131,6 +133,9 @@ public:
             Builder& withSkinned() { _flags.set(SKINNED); _mask.set(SKINNED); return (*this); }
             Builder& withoutSkinned() { _flags.reset(SKINNED); _mask.set(SKINNED); return (*this); }
 
+            Builder& withDualQuatSkinned() { _flags.set(DUAL_QUAT_SKINNED); _mask.set(DUAL_QUAT_SKINNED); return (*this); }
+            Builder& withoutDualQuatSkinned() { _flags.reset(DUAL_QUAT_SKINNED); _mask.set(DUAL_QUAT_SKINNED); return (*this); }
+
             Builder& withDepthOnly() { _flags.set(DEPTH_ONLY); _mask.set(DEPTH_ONLY); return (*this); }
             Builder& withoutDepthOnly() { _flags.reset(DEPTH_ONLY); _mask.set(DEPTH_ONLY); return (*this); }
 
@@ -166,6 +171,7 @@ public:
     bool isUnlit() const { return _flags[UNLIT]; }
     bool isTranslucent() const { return _flags[TRANSLUCENT]; }
     bool isSkinned() const { return _flags[SKINNED]; }
+    bool isDualQuatSkinned() const { return _flags[DUAL_QUAT_SKINNED]; }
     bool isDepthOnly() const { return _flags[DEPTH_ONLY]; }
     bool isDepthBiased() const { return _flags[DEPTH_BIAS]; }
     bool isWireframe() const { return _flags[WIREFRAME]; }
@@ -205,6 +211,7 @@ inline QDebug operator<<(QDebug debug, const ShapeKey& key) {
                 << "isUnlit:" << key.isUnlit()
                 << "isTranslucent:" << key.isTranslucent()
                 << "isSkinned:" << key.isSkinned()
+                << "isDualQuatSkinned:" << key.isDualQuatSkinned()
                 << "isDepthOnly:" << key.isDepthOnly()
                 << "isDepthBiased:" << key.isDepthBiased()
                 << "isWireframe:" << key.isWireframe()
@@ -242,6 +249,11 @@ public:
             SCATTERING,
             LIGHT_AMBIENT,
         };
+
+        enum RESOURCE_BUFFER {
+            SKINNING_POSES = 0,
+            SKINNING_CLUSTERS,
+        };
     };
 
     class Locations {
@@ -318,6 +330,10 @@ public:
 
     const PipelinePointer pickPipeline(RenderArgs* args, const Key& key) const;
 
+    // Same lookup as pickPipeline, without setting the pipeline up on a batch.
+    // Once found, a pipeline can be set up with batch.setPipeline and prepare from any thread.
+    const PipelinePointer findPipeline(const Key& key) const;
+
 protected:
     void addPipelineHelper(const Filter& filter, Key key, int bit, const PipelinePointer& pipeline) const;
     mutable PipelineMap _pipelineMap;
@@ -13,38 +13,51 @@
 #include "ShapePipeline.h"
 
 #include <assert.h>
+#include <string.h>
 #include <ViewFrustum.h>
 
 using namespace render;
 
-struct ItemBoundSort {
-    float _centerDepth = 0.0f;
-    float _nearDepth = 0.0f;
-    float _farDepth = 0.0f;
-    ItemID _id = 0;
-    AABox _bounds;
-
-    ItemBoundSort() {}
-    ItemBoundSort(float centerDepth, float nearDepth, float farDepth, ItemID id, const AABox& bounds) : _centerDepth(centerDepth), _nearDepth(nearDepth), _farDepth(farDepth), _id(id), _bounds(bounds) {}
-};
+// the center depths of items are sorted on by the bits of their floats, whose order as unsigned integers is theirs
+// once negative ones have all their bits flipped and positive ones their sign bit, past the lowest mantissa bits
+static const int DEPTH_KEY_BITS = 24;
+static const int DEPTH_KEY_DIGIT_BITS = 8;
+static const int DEPTH_KEY_DIGIT_VALUES = 1 << DEPTH_KEY_DIGIT_BITS;
+
+static uint32_t depthKey(float depth, bool frontToBack) {
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    return (frontToBack ? bits : ~bits) >> (32 - DEPTH_KEY_BITS);
+}
 
-struct FrontToBackSort {
-    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) {
-        return (left._centerDepth < right._centerDepth);
-    }
-};
+// Sorts the index of each item, in the low half of its entry, on the depth key in the high half, with a counting pass
+// for each digit of the keys that isn't the same for all of them. Items with the same key keep the order they came in.
+static void sortOnDepthKeys(std::vector<uint64_t>& keyedIndices, uint32_t differingKeyBits) {
+    std::vector<uint64_t> sorted(keyedIndices.size());
+    for (int shift = 0; shift < DEPTH_KEY_BITS; shift += DEPTH_KEY_DIGIT_BITS) {
+        if (!((differingKeyBits >> shift) & (DEPTH_KEY_DIGIT_VALUES - 1))) {
+            continue;
+        }
 
-struct BackToFrontSort {
-    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) {
-        return (left._centerDepth > right._centerDepth);
+        size_t digitStarts[DEPTH_KEY_DIGIT_VALUES + 1] = { 0 };
+        for (auto keyedIndex : keyedIndices) {
+            digitStarts[((keyedIndex >> (32 + shift)) & (DEPTH_KEY_DIGIT_VALUES - 1)) + 1]++;
+        }
+        for (int digit = 0; digit < DEPTH_KEY_DIGIT_VALUES; ++digit) {
+            digitStarts[digit + 1] += digitStarts[digit];
+        }
+        for (auto keyedIndex : keyedIndices) {
+            sorted[digitStarts[(keyedIndex >> (32 + shift)) & (DEPTH_KEY_DIGIT_VALUES - 1)]++] = keyedIndex;
+        }
+        keyedIndices.swap(sorted);
     }
-};
+}
 
 void render::depthSortItems(const RenderContextPointer& renderContext, bool frontToBack, const ItemBounds& inItems, ItemBounds& outItems) {
     assert(renderContext->args);
     assert(renderContext->args->hasViewFrustum());
 
-    auto& scene = renderContext->_scene;
     RenderArgs* args = renderContext->args;
 
 
@@ -53,30 +66,27 @@ void render::depthSortItems(const RenderContextPointer& renderContext, bool fron
     outItems.reserve(inItems.size());
 
 
-    // Make a local dataset of the center distance and closest point distance
-    std::vector<ItemBoundSort> itemBoundSorts;
-    itemBoundSorts.reserve(outItems.size());
+    // Make a local dataset of the center distance
+    std::vector<uint64_t> keyedIndices;
+    keyedIndices.reserve(inItems.size());
 
-    for (auto itemDetails : inItems) {
-        auto item = scene->getItem(itemDetails.id);
-        auto bound = itemDetails.bound; // item.getBound();
-        float distance = args->getViewFrustum().distanceToCamera(bound.calcCenter());
+    uint32_t firstKey = 0;
+    uint32_t differingKeyBits = 0;
+    for (size_t i = 0; i < inItems.size(); ++i) {
+        float distance = args->getViewFrustum().distanceToCamera(inItems[i].bound.calcCenter());
 
-        itemBoundSorts.emplace_back(ItemBoundSort(distance, distance, distance, itemDetails.id, bound));
+        uint32_t key = depthKey(distance, frontToBack);
+        firstKey = (i == 0) ? key : firstKey;
+        differingKeyBits |= key ^ firstKey;
+        keyedIndices.push_back(((uint64_t)key << 32) | (uint32_t)i);
     }
 
     // sort against Z
-    if (frontToBack) {
-        FrontToBackSort frontToBackSort;
-        std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), frontToBackSort);
-    } else {
-        BackToFrontSort  backToFrontSort;
-        std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), backToFrontSort);
-    }
+    sortOnDepthKeys(keyedIndices, differingKeyBits);
 
     // Finally once sorted result to a list of itemID
-    for (auto& item : itemBoundSorts) {
-       outItems.emplace_back(ItemBound(item._id, item._bounds));
+    for (auto keyedIndex : keyedIndices) {
+       outItems.emplace_back(inItems[(uint32_t)keyedIndex]);
     }
 }
 
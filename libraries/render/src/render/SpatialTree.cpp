@@ -10,6 +10,10 @@
 //
 #include "SpatialTree.h"
 
+#include <algorithm>
+
+#include <QtConcurrent>
+
 #include <ViewFrustum.h>
 
 
@@ -418,6 +422,113 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
     }
 }
 
+// Below this many items, evaluating their locations concurrently costs more than it saves
+static const size_t MIN_CONCURRENT_ITEM_RESETS = 2048;
+
+void ItemSpatialTree::resetItems(ItemResets& resets) {
+    // Where the items belong, without touching the tree
+    auto evalReset = [this](ItemReset& reset) {
+        if (reset.newKey.isViewSpace()) {
+            // A very rare case, if we were adding items with boundary semantic expressed in view space
+            return;
+        }
+        Coord3f minCoordf, maxCoordf;
+        reset.location = evalLocation(reset.bound, minCoordf, maxCoordf);
+
+        // If Item bound fits in sub cell then tag as small
+        auto rangeSizef = maxCoordf - minCoordf;
+        float cellHalfSize = 0.5f * getCellWidth(reset.location.depth);
+        reset.newKey.setSmaller(std::max(std::max(rangeSizef.x, rangeSizef.y), rangeSizef.z) < cellHalfSize);
+    };
+    if (resets.size() >= MIN_CONCURRENT_ITEM_RESETS) {
+        QtConcurrent::blockingMap(resets, evalReset);
+    } else {
+        std::for_each(resets.begin(), resets.end(), evalReset);
+    }
+
+    // Find the cells, most items moving a little stay in theirs and do not need to walk down the tree
+    using CellItem = std::pair<Index, size_t>;
+    std::vector<CellItem> insertions;
+    std::vector<CellItem> removals;
+    for (size_t i = 0; i < resets.size(); ++i) {
+        auto& reset = resets[i];
+        reset.newCell = INVALID_CELL;
+        if (!reset.newKey.isViewSpace()) {
+            if (reset.oldCell != INVALID_CELL && getCellLocation(reset.oldCell) == reset.location) {
+                reset.newCell = reset.oldCell;
+            } else {
+                reset.newCell = indexCell(reset.location);
+            }
+        }
+
+        if (reset.newCell == reset.oldCell) {
+            if (reset.newCell != INVALID_CELL && reset.newKey._flags != reset.oldKey._flags) {
+                updateItem(reset.newCell, reset.oldKey, reset.newKey, reset.item);
+            }
+            continue;
+        }
+        if (reset.newCell != INVALID_CELL) {
+            insertions.emplace_back(reset.newCell, i);
+        }
+        if (reset.oldCell != INVALID_CELL) {
+            removals.emplace_back(reset.oldCell, i);
+        }
+    }
+
+    // Fill the bricks first, so that no cell an item enters gets cleaned along with the ones items leave
+    std::sort(insertions.begin(), insertions.end());
+    for (auto begin = insertions.begin(); begin != insertions.end();) {
+        auto end = std::find_if(begin, insertions.end(), [&](const CellItem& insertion) { return insertion.first != begin->first; });
+        accessCellBrick(begin->first, [&](Cell& cell, Brick& brick, Octree::Index cellID) {
+            for (auto it = begin; it != end; ++it) {
+                const auto& reset = resets[it->second];
+                (reset.newKey.isSmall() ? brick.subcellItems : brick.items).push_back(reset.item);
+            }
+            cell.setBrickFilled();
+        }, true);
+        begin = end;
+    }
+
+    std::sort(removals.begin(), removals.end());
+    ItemIDs removedItems;
+    ItemIDs removedSubcellItems;
+    for (auto begin = removals.begin(); begin != removals.end();) {
+        auto end = std::find_if(begin, removals.end(), [&](const CellItem& removal) { return removal.first != begin->first; });
+        removedItems.clear();
+        removedSubcellItems.clear();
+        for (auto it = begin; it != end; ++it) {
+            const auto& reset = resets[it->second];
+            (reset.oldKey.isSmall() ? removedSubcellItems : removedItems).push_back(reset.item);
+        }
+        std::sort(removedItems.begin(), removedItems.end());
+        std::sort(removedSubcellItems.begin(), removedSubcellItems.end());
+
+        bool emptyCell = false;
+        accessCellBrick(begin->first, [&](Cell& cell, Brick& brick, Octree::Index brickID) {
+            auto removeFrom = [](ItemIDs& itemList, const ItemIDs& removed) {
+                if (!removed.empty()) {
+                    itemList.erase(std::remove_if(itemList.begin(), itemList.end(), [&](const ItemID& item) {
+                        return std::binary_search(removed.begin(), removed.end(), item);
+                    }), itemList.end());
+                }
+            };
+            removeFrom(brick.items, removedItems);
+            removeFrom(brick.subcellItems, removedSubcellItems);
+
+            if (brick.items.empty() && brick.subcellItems.empty()) {
+                cell.setBrickEmpty();
+                emptyCell = true;
+            }
+        }, false); // do not create brick!
+
+        // Because we know the cell is now empty, lets try to clean the octree here
+        if (emptyCell) {
+            cleanCellBranch(begin->first);
+        }
+        begin = end;
+    }
+}
+
 int Octree::select(CellSelection& selection, const FrustumSelector& selector) const {
 
     Index cellID = ROOT_CELL;
@@ -428,12 +539,50 @@ int Octree::select(CellSelection& selection, const FrustumSelector& selector) co
     selectCellBrick(cellID, selection, false);
 
     // then traverse deeper
+    selectChildren(cell, selection, selector);
+
+    return (int)selection.size() - numSelectedsIn;
+}
+
+int Octree::selectChildren(const Cell& cell, CellSelection& selection, const FrustumSelector& selector) const {
+    int numSelectedsIn = (int)selection.size();
+
+    // the children are tested against the frustum a few at a time
+    const int BATCH_SIZE = PackedPlanes::BOXES_PER_TEST;
+    Index batchIDs[BATCH_SIZE];
+    Coord3f minimums[BATCH_SIZE];
+    Coord3f maximums[BATCH_SIZE];
+    int count = 0;
+    auto traverseBatch = [&] {
+        int outside;
+        int straddling;
+        selector.packedFrustum.testBoxes(minimums, maximums, count, outside, straddling);
+        for (int i = 0; i < count; i++) {
+            int bit = 1 << i;
+            if (!(outside & bit)) {
+                selectTraverse(batchIDs[i], selection, selector,
+                    (straddling & bit) ? Location::Intersect : Location::Inside);
+            }
+        }
+        count = 0;
+    };
+
     for (int i = 0; i < NUM_OCTANTS; i++) {
         Index subCellID = cell.child((Link)i);
         if (subCellID != INVALID_CELL) {
-            selectTraverse(subCellID, selection, selector);
+            auto location = getConcreteCell(subCellID).getlocation();
+            Coord3f cellSize = Coord3f(Octree::getInvDepthDimension(location.depth));
+            batchIDs[count] = subCellID;
+            minimums[count] = Coord3f(location.pos) * cellSize;
+            maximums[count] = minimums[count] + cellSize;
+            if (++count == BATCH_SIZE) {
+                traverseBatch();
+            }
         }
     }
+    if (count > 0) {
+        traverseBatch();
+    }
 
     return (int)selection.size() - numSelectedsIn;
 }
@@ -497,13 +646,11 @@ Octree::Location::Intersection Octree::Location::intersectCell(const Location& c
     return Inside;
 }
 
-int Octree::selectTraverse(Index cellID, CellSelection& selection, const FrustumSelector& selector) const {
+int Octree::selectTraverse(Index cellID, CellSelection& selection, const FrustumSelector& selector,
+                           Location::Intersection intersection) const {
     int numSelectedsIn = (int) selection.size();
     auto cell = getConcreteCell(cellID);
 
-    auto cellLocation = cell.getlocation();
-
-    auto intersection = Octree::Location::intersectCell(cellLocation, selector.frustum);
     switch (intersection) {
         case Octree::Location::Outside:
             // cell is outside, stop traversing this branch
@@ -530,12 +677,7 @@ int Octree::selectTraverse(Index cellID, CellSelection& selection, const Frustum
             selectCellBrick(cellID, selection, false);
 
             // then traverse deeper
-            for (int i = 0; i < NUM_OCTANTS; i++) {
-                Index subCellID = cell.child((Link)i);
-                if (subCellID != INVALID_CELL) {
-                    selectTraverse(subCellID, selection, selector);
-                }
-            }
+            selectChildren(cell, selection, selector);
         }
     }
 
@@ -589,6 +731,7 @@ int ItemSpatialTree::selectCells(CellSelection& selection, const ViewFrustum& fr
         octPlane.setNormalAndPoint(worldPlanes[i].getNormal(), evalCoordf(worldPlanes[i].getPoint(), ROOT_DEPTH));
         selector.frustum[i] = Coord4f(octPlane.getNormal(), octPlane.getDCoefficient());
     }
+    selector.packedFrustum.setPlanes(selector.frustum, ViewFrustum::NUM_PLANES);
 
     selector.eyePos = evalCoordf(frustum.getPosition(), ROOT_DEPTH);
     selector.setAngle(glm::radians(lodAngle));
@@ -21,6 +21,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/bit.hpp>
 #include <AABox.h>
+#include <PackedPlanes.h>
 
 // maybe we could avoid the Item inclusion here for the OCtree class?
 #include "Item.h"
@@ -312,6 +313,7 @@ namespace render {
         class FrustumSelector {
         public:
             Coord4f frustum[6];
+            PackedPlanes packedFrustum; // the same planes, to test the children of a cell together
             Coord3f eyePos;
             float   angle;
             float   squareTanAlpha;
@@ -332,7 +334,9 @@ namespace render {
         };
 
         int select(CellSelection& selection, const FrustumSelector& selector) const;
-        int selectTraverse(Index cellID, CellSelection& selection, const FrustumSelector& selector) const;
+        int selectTraverse(Index cellID, CellSelection& selection, const FrustumSelector& selector,
+                           Location::Intersection intersection) const;
+        int selectChildren(const Cell& cell, CellSelection& selection, const FrustumSelector& selector) const;
         int selectBranch(Index cellID, CellSelection& selection, const FrustumSelector& selector) const;
         int selectCellBrick(Index cellID, CellSelection& selection, bool inside) const;
 
@@ -442,6 +446,23 @@ namespace render {
 
         Index resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey);
 
+        // A reset of an item as done by resetItem, newKey is tagged small or not and newCell is where the item ends up
+        class ItemReset {
+        public:
+            ItemID item { Item::INVALID_ITEM_ID };
+            Index oldCell { INVALID_CELL };
+            ItemKey oldKey;
+            AABox bound;
+            ItemKey newKey;
+            Index newCell { INVALID_CELL };
+            Location location;
+        };
+        using ItemResets = std::vector<ItemReset>;
+
+        // Same as resetItem for many items at once, each item is expected once.
+        // The locations are evaluated concurrently, then each brick the items enter or leave is only edited once.
+        void resetItems(ItemResets& resets);
+
         // Selection and traverse
         int selectCells(CellSelection& selection, const ViewFrustum& frustum, float lodAngle) const;
 
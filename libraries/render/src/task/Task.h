@@ -33,7 +33,12 @@ class JobContext {
 public:
     virtual ~JobContext() {}
 
+    // Called around the run of every enabled job while isProfilingJobs is set, for the context to profile them
+    virtual void beginJob(const std::string& name) {}
+    virtual void endJob(const std::string& name, double msCPURunTime) {}
+
     std::shared_ptr<JobConfig> jobConfig { nullptr };
+    bool isProfilingJobs { false };
 };
 using JobContextPointer = std::shared_ptr<JobContext>;
 
@@ -158,11 +163,20 @@ public:
     virtual void run(const ContextPointer& renderContext) {
         PerformanceTimer perfTimer(_name.c_str());
         PROFILE_RANGE(render, _name.c_str());
+        bool isProfiled = renderContext->isProfilingJobs &&
+            std::static_pointer_cast<JobConfig>(_concept->getConfiguration())->isEnabled();
+        if (isProfiled) {
+            renderContext->beginJob(_name);
+        }
         auto start = usecTimestampNow();
 
         _concept->run(renderContext);
 
-        _concept->setCPURunTime((double)(usecTimestampNow() - start) / 1000.0);
+        double msRunTime = (double)(usecTimestampNow() - start) / 1000.0;
+        _concept->setCPURunTime(msRunTime);
+        if (isProfiled) {
+            renderContext->endJob(_name, msRunTime);
+        }
     }
 
 protected:
@@ -27,6 +27,7 @@ class ArrayBufferClass : public QObject, public QScriptClass {
 public:
     ArrayBufferClass(ScriptEngine* scriptEngine);
     QScriptValue newInstance(qint32 size);
+    // shares the data of the QByteArray, the buffer only gets its own copy when a script writes to it
     QScriptValue newInstance(const QByteArray& ba);
 
     QueryFlags queryProperty(const QScriptValue& object,
@@ -9,10 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QEventLoop>
 #include <QtCore/QFileInfo>
 #include <QtCore/QTimer>
@@ -154,16 +156,40 @@ QString ScriptEngine::logException(const QScriptValue& exception) {
 }
 
 int ScriptEngine::processLevelMaxRetries { ScriptRequest::MAX_RETRIES };
+
+// The entity scripts that passed the syntax check and the constructor preflight, in any engine of the process
+static std::mutex verifiedEntityScriptsMutex;
+static QSet<QByteArray> verifiedEntityScripts;
+
+static QByteArray hashProgram(const QString& sourceCode, const QString& fileName, int lineNumber = 1) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(fileName.toUtf8());
+    hash.addData(QByteArray::number(lineNumber));
+    hash.addData(sourceCode.toUtf8());
+    return hash.result();
+}
 ScriptEngine::ScriptEngine(Context context, const QString& scriptContents, const QString& fileNameString) :
     BaseScriptEngine(),
     _context(context),
     _scriptContents(scriptContents),
-    _timerFunctionMap(),
     _fileNameString(fileNameString),
     _arrayBufferClass(new ArrayBufferClass(this))
 {
     DependencyManager::get<ScriptEngines>()->addScriptEngine(this);
 
+    // the wheel timer is a child so that it moves to the thread of the script along with it
+    _timerWheelClock.start();
+    _timerWheelTimer = new QTimer(this);
+    _timerWheelTimer->setSingleShot(true);
+    _timerWheelTimer->setTimerType(Qt::PreciseTimer);
+    connect(_timerWheelTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+
+    // make sure the timers stop when the script does
+    connect(this, &ScriptEngine::scriptEnding, this, [this] {
+        _timerWheelTimer->stop();
+        _timerWheelDeadline = TimerWheel::NO_DEADLINE;
+    });
+
     connect(this, &QScriptEngine::signalHandlerException, this, [this](const QScriptValue& exception) {
         if (hasUncaughtException()) {
             // the engine's uncaughtException() seems to produce much better stack traces here
@@ -628,6 +654,9 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, AvatarEntityMapToScriptValue, AvatarEntityMapFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<QUuid>>(this);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID>>(this);
+    qScriptRegisterSequenceMetaType<QVector<EntityItemProperties>>(this);
+    qScriptRegisterSequenceMetaType<QVector<PickRay>>(this);
+    qScriptRegisterSequenceMetaType<QVector<RayToEntityIntersectionResult>>(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2> >(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat> >(this);
@@ -976,17 +1005,20 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
         return result;
     }
 
-    // Check syntax
-    auto syntaxError = lintScript(sourceCode, fileName);
-    if (syntaxError.isError()) {
-        if (!isEvaluating()) {
-            syntaxError.setProperty("detail", "evaluate");
+    // Check syntax, cached programs have been checked already
+    auto programHash = hashProgram(sourceCode, fileName, lineNumber);
+    if (!_programCache.contains(programHash)) {
+        auto syntaxError = lintScript(sourceCode, fileName);
+        if (syntaxError.isError()) {
+            if (!isEvaluating()) {
+                syntaxError.setProperty("detail", "evaluate");
+            }
+            raiseException(syntaxError);
+            maybeEmitUncaughtException("lint");
+            return syntaxError;
         }
-        raiseException(syntaxError);
-        maybeEmitUncaughtException("lint");
-        return syntaxError;
     }
-    QScriptProgram program { sourceCode, fileName, lineNumber };
+    QScriptProgram program = getProgram(programHash, sourceCode, fileName, lineNumber);
     if (program.isNull()) {
         // can this happen?
         auto err = makeError("could not create QScriptProgram for " + fileName);
@@ -1003,6 +1035,18 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
     return result;
 }
 
+QScriptProgram ScriptEngine::getProgram(const QByteArray& programHash, const QString& sourceCode,
+                                        const QString& fileName, int lineNumber) {
+    if (auto cachedProgram = _programCache.object(programHash)) {
+        return *cachedProgram;
+    }
+    QScriptProgram program { sourceCode, fileName, lineNumber };
+    if (!program.isNull()) {
+        _programCache.insert(programHash, new QScriptProgram(program));
+    }
+    return program;
+}
+
 void ScriptEngine::run() {
     auto filenameParts = _fileNameString.split("/");
     auto name = filenameParts.size() > 0 ? filenameParts[filenameParts.size() - 1] : "unknown";
@@ -1121,6 +1165,8 @@ void ScriptEngine::run() {
             break;
         }
 
+        processPendingEntityScriptLoads();
+
         if (!_isFinished && entityScriptingInterface->getEntityPacketSender()->serversExist()) {
             // release the queue of edit entity messages.
             entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
@@ -1163,7 +1209,8 @@ void ScriptEngine::run() {
     emit scriptEnding();
 
     if (entityScriptingInterface->getEntityPacketSender()->serversExist()) {
-        // release the queue of edit entity messages.
+        // release the queue of edit entity messages, including the edits still being coalesced
+        entityScriptingInterface->getEntityPacketSender()->releaseCoalescedEdits(true);
         entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
 
         // since we're in non-threaded mode, call process so that the packets are sent
@@ -1188,32 +1235,24 @@ void ScriptEngine::run() {
 // NOTE: This is private because it must be called on the same thread that created the timers, which is why
 // we want to only call it in our own run "shutdown" processing.
 void ScriptEngine::stopAllTimers() {
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
     int j {0};
-    while (i.hasNext()) {
-        i.next();
-        QTimer* timer = i.key();
+    for (auto timerID : _timers.keys()) {
         qCDebug(scriptengine) << getFilename() << "stopAllTimers[" << j++ << "]";
-        stopTimer(timer);
+        stopTimer(timerID);
     }
 }
 
 void ScriptEngine::stopAllTimersForEntityScript(const EntityItemID& entityID) {
-     // We could maintain a separate map of entityID => QTimer, but someone will have to prove to me that it's worth the complexity. -HRS
-    QVector<QTimer*> toDelete;
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
-    while (i.hasNext()) {
-        i.next();
-        if (i.value().definingEntityIdentifier != entityID) {
-            continue;
+     // We could maintain a separate map of entityID => timers, but someone will have to prove to me that it's worth the complexity. -HRS
+    QVector<TimerWheel::TimerID> toDelete;
+    for (auto i = _timers.cbegin(); i != _timers.cend(); ++i) {
+        if (i.value().callback.definingEntityIdentifier == entityID) {
+            toDelete << i.key(); // don't delete while we're iterating. save it.
         }
-        QTimer* timer = i.key();
-        toDelete << timer; // don't delete while we're iterating. save it.
     }
-    for (auto timer:toDelete) { // now reap 'em
-        stopTimer(timer);
+    for (auto timerID : toDelete) { // now reap 'em
+        stopTimer(timerID);
     }
-
 }
 
 void ScriptEngine::stop(bool marshal) {
@@ -1260,10 +1299,29 @@ void ScriptEngine::callAnimationStateHandler(QScriptValue callback, AnimVariantM
 void ScriptEngine::updateMemoryCost(const qint64& deltaSize) {
     if (deltaSize > 0) {
         reportAdditionalMemoryCost(deltaSize);
+
+        // the buffers are allocated on this thread, by the script running now
+        if (!currentEntityIdentifier.isNull()) {
+            std::lock_guard<std::mutex> lock(_entityScriptStatsMutex);
+            _entityScriptStats[currentEntityIdentifier].allocatedBytes += deltaSize;
+        }
     }
 }
 
+QHash<EntityItemID, EntityScriptStats> ScriptEngine::takeEntityScriptStats() {
+    QHash<EntityItemID, EntityScriptStats> stats;
+    std::lock_guard<std::mutex> lock(_entityScriptStatsMutex);
+    _entityScriptStats.swap(stats);
+    return stats;
+}
+
+void ScriptEngine::setThrottledEntityScripts(const QSet<EntityItemID>& entityIDs) {
+    std::lock_guard<std::mutex> lock(_entityScriptStatsMutex);
+    _throttledEntityScripts = entityIDs;
+}
+
 void ScriptEngine::timerFired() {
+    _timerWheelDeadline = TimerWheel::NO_DEADLINE;
     {
         auto engine = DependencyManager::get<ScriptEngines>();
         if (!engine || engine->isStopped()) {
@@ -1272,77 +1330,101 @@ void ScriptEngine::timerFired() {
         }
     }
 
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
-    CallbackData timerData = _timerFunctionMap.value(callingTimer);
+    // Collect the timers that are due before calling any of them back, the callbacks set and clear timers
+    std::vector<TimerWheel::TimerID> dueTimers;
+    uint64_t now = (uint64_t)_timerWheelClock.elapsed();
+    _timerWheel.advance(now, dueTimers);
 
-    if (!callingTimer->isActive()) {
-        // this timer is done, we can kill it
-        _timerFunctionMap.remove(callingTimer);
-        delete callingTimer;
-    }
+    auto preTimers = p_high_resolution_clock::now();
+    for (auto timerID : dueTimers) {
+        auto i = _timers.find(timerID);
+        if (i == _timers.end()) {
+            continue; // cleared since it was set
+        }
+        ScriptTimer timer = i.value();
+        const CallbackData& timerData = timer.callback;
 
-    // call the associated JS function, if it exists
-    if (timerData.function.isValid()) {
-        PROFILE_RANGE(script, __FUNCTION__);
-        auto preTimer = p_high_resolution_clock::now();
-        callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
-        auto postTimer = p_high_resolution_clock::now();
-        auto elapsed = (postTimer - preTimer);
-        _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
-    } else {
-        qCWarning(scriptengine) << "timerFired -- invalid function" << timerData.function.toVariant().toString();
-    }
-}
+        if (timer.isSingleShot) {
+            // this timer is done, we can forget it
+            _timers.erase(i);
+            _skippedTimers.remove(timerID);
+        } else {
+            _timerWheel.insert(timerID, now + std::max(timer.intervalMS, 1));
 
-QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
-    // create the timer, add it to the map, and start it
-    QTimer* newTimer = new QTimer(this);
-    newTimer->setSingleShot(isSingleShot);
+            if (!timerData.definingEntityIdentifier.isNull()) {
+                bool isThrottled;
+                {
+                    std::lock_guard<std::mutex> lock(_entityScriptStatsMutex);
+                    isThrottled = _throttledEntityScripts.contains(timerData.definingEntityIdentifier);
+                }
+                if (isThrottled && !_skippedTimers.remove(timerID)) {
+                    _skippedTimers.insert(timerID);
+                    continue;
+                }
+            }
+        }
 
-    // The default timer type is not very accurate below about 200ms http://doc.qt.io/qt-5/qt.html#TimerType-enum
-    static const int MIN_TIMEOUT_FOR_COARSE_TIMER = 200;
-    if (intervalMS < MIN_TIMEOUT_FOR_COARSE_TIMER) {
-        newTimer->setTimerType(Qt::PreciseTimer);
+        // call the associated JS function, if it exists
+        if (timerData.function.isValid()) {
+            PROFILE_RANGE(script, __FUNCTION__);
+            callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
+        } else {
+            qCWarning(scriptengine) << "timerFired -- invalid function" << timerData.function.toVariant().toString();
+        }
     }
+    auto postTimers = p_high_resolution_clock::now();
+    _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(postTimers - preTimers);
 
-    connect(newTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+    scheduleTimerWheel();
+}
 
-    // make sure the timer stops when the script does
-    connect(this, &ScriptEngine::scriptEnding, newTimer, &QTimer::stop);
+void ScriptEngine::scheduleTimerWheel() {
+    uint64_t deadline = _timerWheel.getNextDeadline();
+    if (deadline == TimerWheel::NO_DEADLINE || deadline >= _timerWheelDeadline) {
+        return; // the wheel timer already fires in time
+    }
+    _timerWheelDeadline = deadline;
 
+    uint64_t now = (uint64_t)_timerWheelClock.elapsed();
+    _timerWheelTimer->start(deadline > now ? (int)(deadline - now) : 0);
+}
 
+int ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
+    // add the timer to the map and to the wheel, the wheel timer fires when it is due
+    TimerWheel::TimerID timerID = _nextTimerID++;
     CallbackData timerData = { function, currentEntityIdentifier, currentSandboxURL };
-    _timerFunctionMap.insert(newTimer, timerData);
+    _timers.insert(timerID, { timerData, intervalMS, isSingleShot });
 
-    newTimer->start(intervalMS);
-    return newTimer;
+    uint64_t now = (uint64_t)_timerWheelClock.elapsed();
+    _timerWheel.insert(timerID, now + std::max(intervalMS, isSingleShot ? 0 : 1));
+    scheduleTimerWheel();
+    return (int)timerID;
 }
 
-QObject* ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
+int ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
     if (DependencyManager::get<ScriptEngines>()->isStopped()) {
         scriptWarningMessage("Script.setInterval() while shutting down is ignored... parent script:" + getFilename());
-        return NULL; // bail early
+        return 0; // bail early
     }
 
     return setupTimerWithInterval(function, intervalMS, false);
 }
 
-QObject* ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
+int ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
     if (DependencyManager::get<ScriptEngines>()->isStopped()) {
         scriptWarningMessage("Script.setTimeout() while shutting down is ignored... parent script:" + getFilename());
-        return NULL; // bail early
+        return 0; // bail early
     }
 
     return setupTimerWithInterval(function, timeoutMS, true);
 }
 
-void ScriptEngine::stopTimer(QTimer *timer) {
-    if (_timerFunctionMap.contains(timer)) {
-        timer->stop();
-        _timerFunctionMap.remove(timer);
-        delete timer;
+void ScriptEngine::stopTimer(TimerWheel::TimerID timerID) {
+    // the wheel drops the timer when it comes due
+    if (_timers.remove(timerID) > 0) {
+        _skippedTimers.remove(timerID);
     } else {
-        qCDebug(scriptengine) << "stopTimer -- not in _timerFunctionMap" << timer;
+        qCDebug(scriptengine) << "stopTimer -- not a timer" << timerID;
     }
 }
 
@@ -1635,13 +1717,14 @@ QScriptValue ScriptEngine::instantiateModule(const QScriptValue& module, const Q
     if (module.property("content-type").toString() == "application/json") {
         qCDebug(scriptengine_module) << "... parsing as JSON";
         closure.setProperty("__json", sourceCode);
-        result = evaluateInClosure(closure, { "module.exports = JSON.parse(__json)", modulePath });
+        const QString JSON_MODULE_SOURCE = "module.exports = JSON.parse(__json)";
+        result = evaluateInClosure(closure, getProgram(hashProgram(JSON_MODULE_SOURCE, modulePath), JSON_MODULE_SOURCE, modulePath));
     } else {
         // scoped vars for consistency with Node.js
         closure.setProperty("require", module.property("require"));
         closure.setProperty("__filename", modulePath, READONLY_HIDDEN_PROP_FLAGS);
         closure.setProperty("__dirname", QString(modulePath).replace(QRegExp("/[^/]*$"), ""), READONLY_HIDDEN_PROP_FLAGS);
-        result = evaluateInClosure(closure, { sourceCode, modulePath });
+        result = evaluateInClosure(closure, getProgram(hashProgram(sourceCode, modulePath), sourceCode, modulePath));
     }
     maybeEmitUncaughtException(__FUNCTION__);
     return result;
@@ -2047,16 +2130,18 @@ void ScriptEngine::processDeferredEntityLoads(const QString& entityScript, const
         }
 
         // if we made it here then the leading entity was successful so proceed with normal load
-        loadEntityScript(retry.entityID, retry.entityScript, false);
+        loadEntityScript(retry.entityID, retry.entityScript, false, retry.priority);
     }
 }
 
-void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload) {
+void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload,
+                                    float priority) {
     if (QThread::currentThread() != thread()) {
         QMetaObject::invokeMethod(this, "loadEntityScript",
             Q_ARG(const EntityItemID&, entityID),
             Q_ARG(const QString&, entityScript),
-            Q_ARG(bool, forceRedownload)
+            Q_ARG(bool, forceRedownload),
+            Q_ARG(float, priority)
         );
         return;
     }
@@ -2101,7 +2186,7 @@ void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString&
             qCDebug(scriptengine) << QString("loadEntityScript.deferring[%0] entity: %1 script: %2 (waiting on %3)")
                 .arg(_deferredEntityLoads.size()).arg(entityID.toString()).arg(entityScript).arg(currentEntityID.toString());
 #endif
-            _deferredEntityLoads.push_back({ entityID, entityScript });
+            _deferredEntityLoads.push_back({ entityID, entityScript, priority });
             return;
         }
     }
@@ -2125,7 +2210,7 @@ void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString&
     // note: see EntityTreeRenderer.cpp for shared pointer lifecycle management
     QWeakPointer<BaseScriptEngine> weakRef(sharedFromThis());
     scriptCache->getScriptContents(entityScript,
-        [this, weakRef, entityScript, entityID](const QString& url, const QString& contents, bool isURL, bool success, const QString& status) {
+        [this, weakRef, entityScript, entityID, priority](const QString& url, const QString& contents, bool isURL, bool success, const QString& status) {
             QSharedPointer<BaseScriptEngine> strongRef(weakRef);
             if (!strongRef) {
                 qCWarning(scriptengine) << "loadEntityScript.contentAvailable -- ScriptEngine was deleted during getScriptContents!!";
@@ -2141,21 +2226,47 @@ void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString&
 #ifdef DEBUG_ENTITY_STATES
                 qCDebug(scriptengine) << "loadEntityScript.contentAvailable" << status << QUrl(url).fileName() << entityID.toString();
 #endif
-                if (!isStopping() && _entityScripts.contains(entityID)) {
-                    entityScriptContentAvailable(entityID, url, contents, isURL, success, status);
-                } else {
-#ifdef DEBUG_ENTITY_STATES
-                    qCDebug(scriptengine) << "loadEntityScript.contentAvailable -- aborting";
-#endif
-                }
-                // recheck whether us since may have been set to BAD_SCRIPT_UUID_PLACEHOLDER in entityScriptContentAvailable
-                if (_occupiedScriptURLs.contains(entityScript) && _occupiedScriptURLs[entityScript] == entityID) {
-                    _occupiedScriptURLs.remove(entityScript);
+                _pendingEntityScriptLoads.push_back({ priority, entityID, entityScript, url, contents, isURL, success, status });
+                std::push_heap(_pendingEntityScriptLoads.begin(), _pendingEntityScriptLoads.end());
+                if (!_isRunning) {
+                    // there is no run loop to get to them
+                    processPendingEntityScriptLoads();
                 }
             });
     }, forceRedownload);
 }
 
+// constructs and preloads the fetched entity scripts in the order of their priority, until they have taken
+// up the time there is for them in this frame of the engine
+void ScriptEngine::processPendingEntityScriptLoads() {
+    if (_pendingEntityScriptLoads.empty()) {
+        return;
+    }
+    PROFILE_RANGE(script, __FUNCTION__);
+
+    static const quint64 ENTITY_SCRIPT_LOADS_TIME_BUDGET = 4 * USECS_PER_MSEC;
+    quint64 startTime = usecTimestampNow();
+    do {
+        std::pop_heap(_pendingEntityScriptLoads.begin(), _pendingEntityScriptLoads.end());
+        auto load = _pendingEntityScriptLoads.back();
+        _pendingEntityScriptLoads.pop_back();
+
+        // an entity unloaded or deleted while its script waited here no longer wants it
+        if (!isStopping() && _entityScripts.contains(load.entityID) &&
+                _entityScripts[load.entityID].status == EntityScriptStatus::LOADING) {
+            entityScriptContentAvailable(load.entityID, load.url, load.contents, load.isURL, load.success, load.status);
+        } else {
+#ifdef DEBUG_ENTITY_STATES
+            qCDebug(scriptengine) << "loadEntityScript.contentAvailable -- aborting";
+#endif
+        }
+        // recheck whether us since may have been set to BAD_SCRIPT_UUID_PLACEHOLDER in entityScriptContentAvailable
+        if (_occupiedScriptURLs.contains(load.entityScript) && _occupiedScriptURLs[load.entityScript] == load.entityID) {
+            _occupiedScriptURLs.remove(load.entityScript);
+        }
+    } while (!_pendingEntityScriptLoads.empty() && usecTimestampNow() - startTime < ENTITY_SCRIPT_LOADS_TIME_BUDGET);
+}
+
 // since all of these operations can be asynch we will always do the actual work in the response handler
 // for the download
 void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, const QString& scriptOrURL, const QString& contents, bool isURL, bool success , const QString& status) {
@@ -2212,85 +2323,97 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
         return;
     }
 
-    // SYNTAX ERRORS
-    auto syntaxError = lintScript(contents, fileName);
-    if (syntaxError.isError()) {
-        auto message = syntaxError.property("formatted").toString();
-        if (message.isEmpty()) {
-            message = syntaxError.toString();
+    // Copies of the same script pass or fail the same way, only the first one is checked
+    auto programHash = hashProgram(contents, fileName);
+    bool isVerified;
+    {
+        std::lock_guard<std::mutex> lock(verifiedEntityScriptsMutex);
+        isVerified = verifiedEntityScripts.contains(programHash);
+    }
+    if (!isVerified) {
+        // SYNTAX ERRORS
+        auto syntaxError = lintScript(contents, fileName);
+        if (syntaxError.isError()) {
+            auto message = syntaxError.property("formatted").toString();
+            if (message.isEmpty()) {
+                message = syntaxError.toString();
+            }
+            setError(QString("Bad syntax (%1)").arg(message), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+            syntaxError.setProperty("detail", entityID.toString());
+            emit unhandledException(syntaxError);
+            return;
+        }
+        QScriptProgram program { contents, fileName };
+        if (program.isNull()) {
+            setError("Bad program (isNull)", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+            emit unhandledException(makeError("program.isNull"));
+            return; // done processing script
         }
-        setError(QString("Bad syntax (%1)").arg(message), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        syntaxError.setProperty("detail", entityID.toString());
-        emit unhandledException(syntaxError);
-        return;
-    }
-    QScriptProgram program { contents, fileName };
-    if (program.isNull()) {
-        setError("Bad program (isNull)", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        emit unhandledException(makeError("program.isNull"));
-        return; // done processing script
-    }
 
-    if (isURL) {
-        setParentURL(scriptOrURL);
-    }
+        // SANITY/PERFORMANCE CHECK USING SANDBOX
+        const int SANDBOX_TIMEOUT = 0.25 * MSECS_PER_SECOND;
+        BaseScriptEngine sandbox;
+        sandbox.setProcessEventsInterval(SANDBOX_TIMEOUT);
+        QScriptValue testConstructor, exception;
+        {
+            QTimer timeout;
+            timeout.setSingleShot(true);
+            timeout.start(SANDBOX_TIMEOUT);
+            connect(&timeout, &QTimer::timeout, [&sandbox, SANDBOX_TIMEOUT, scriptOrURL]{
+                    qCDebug(scriptengine) << "ScriptEngine::entityScriptContentAvailable timeout(" << scriptOrURL << ")";
+
+                    // Guard against infinite loops and non-performant code
+                    sandbox.raiseException(
+                        sandbox.makeError(QString("Timed out (entity constructors are limited to %1ms)").arg(SANDBOX_TIMEOUT))
+                    );
+            });
 
-    // SANITY/PERFORMANCE CHECK USING SANDBOX
-    const int SANDBOX_TIMEOUT = 0.25 * MSECS_PER_SECOND;
-    BaseScriptEngine sandbox;
-    sandbox.setProcessEventsInterval(SANDBOX_TIMEOUT);
-    QScriptValue testConstructor, exception;
-    {
-        QTimer timeout;
-        timeout.setSingleShot(true);
-        timeout.start(SANDBOX_TIMEOUT);
-        connect(&timeout, &QTimer::timeout, [&sandbox, SANDBOX_TIMEOUT, scriptOrURL]{
-                qCDebug(scriptengine) << "ScriptEngine::entityScriptContentAvailable timeout(" << scriptOrURL << ")";
-
-                // Guard against infinite loops and non-performant code
-                sandbox.raiseException(
-                    sandbox.makeError(QString("Timed out (entity constructors are limited to %1ms)").arg(SANDBOX_TIMEOUT))
-                );
-        });
+            testConstructor = sandbox.evaluate(program);
 
-        testConstructor = sandbox.evaluate(program);
+            if (sandbox.hasUncaughtException()) {
+                exception = sandbox.cloneUncaughtException(QString("(preflight %1)").arg(entityID.toString()));
+                sandbox.clearExceptions();
+            } else if (testConstructor.isError()) {
+                exception = testConstructor;
+            }
+        }
 
-        if (sandbox.hasUncaughtException()) {
-            exception = sandbox.cloneUncaughtException(QString("(preflight %1)").arg(entityID.toString()));
-            sandbox.clearExceptions();
-        } else if (testConstructor.isError()) {
-            exception = testConstructor;
+        if (exception.isError()) {
+            // create a local copy using makeError to decouple from the sandbox engine
+            exception = makeError(exception);
+            setError(formatException(exception, _enableExtendedJSExceptions.get()), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+            emit unhandledException(exception);
+            return;
         }
-    }
 
-    if (exception.isError()) {
-        // create a local copy using makeError to decouple from the sandbox engine
-        exception = makeError(exception);
-        setError(formatException(exception, _enableExtendedJSExceptions.get()), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        emit unhandledException(exception);
-        return;
-    }
+        // CONSTRUCTOR VIABILITY
+        if (!testConstructor.isFunction()) {
+            QString testConstructorType = QString(testConstructor.toVariant().typeName());
+            if (testConstructorType == "") {
+                testConstructorType = "empty";
+            }
+            QString testConstructorValue = testConstructor.toString();
+            if (testConstructorValue.size() > MAX_DEBUG_VALUE_LENGTH) {
+                testConstructorValue = testConstructorValue.mid(0, MAX_DEBUG_VALUE_LENGTH) + "...";
+            }
+            auto message = QString("failed to load entity script -- expected a function, got %1, %2")
+                .arg(testConstructorType).arg(testConstructorValue);
 
-    // CONSTRUCTOR VIABILITY
-    if (!testConstructor.isFunction()) {
-        QString testConstructorType = QString(testConstructor.toVariant().typeName());
-        if (testConstructorType == "") {
-            testConstructorType = "empty";
-        }
-        QString testConstructorValue = testConstructor.toString();
-        if (testConstructorValue.size() > MAX_DEBUG_VALUE_LENGTH) {
-            testConstructorValue = testConstructorValue.mid(0, MAX_DEBUG_VALUE_LENGTH) + "...";
+            auto err = makeError(message);
+            err.setProperty("fileName", scriptOrURL);
+            err.setProperty("detail", "(constructor " + entityID.toString() + ")");
+
+            setError("Could not find constructor (" + testConstructorType + ")", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+            emit unhandledException(err);
+            return; // done processing script
         }
-        auto message = QString("failed to load entity script -- expected a function, got %1, %2")
-            .arg(testConstructorType).arg(testConstructorValue);
 
-        auto err = makeError(message);
-        err.setProperty("fileName", scriptOrURL);
-        err.setProperty("detail", "(constructor " + entityID.toString() + ")");
+        std::lock_guard<std::mutex> lock(verifiedEntityScriptsMutex);
+        verifiedEntityScripts.insert(programHash);
+    }
 
-        setError("Could not find constructor (" + testConstructorType + ")", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        emit unhandledException(err);
-        return; // done processing script
+    if (isURL) {
+        setParentURL(scriptOrURL);
     }
 
     // (this feeds into refreshFileScript)
@@ -2452,6 +2575,10 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     currentEntityIdentifier = entityID;
     currentSandboxURL = sandboxURL;
 
+    // a nested call is part of the time of the outermost entity script
+    bool isAccounted = !entityID.isNull() && oldIdentifier.isNull();
+    auto start = isAccounted ? p_high_resolution_clock::now() : p_high_resolution_clock::time_point();
+
 #if DEBUG_CURRENT_ENTITY
     QScriptValue oldData = this->globalObject().property("debugEntityID");
     this->globalObject().setProperty("debugEntityID", entityID.toScriptValue(this)); // Make the entityID available to javascript as a global.
@@ -2460,6 +2587,13 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
 #else
     operation();
 #endif
+    if (isAccounted) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - start);
+        std::lock_guard<std::mutex> lock(_entityScriptStatsMutex);
+        EntityScriptStats& stats = _entityScriptStats[entityID];
+        stats.callUsecs += elapsed.count();
+        stats.numCalls++;
+    }
     maybeEmitUncaughtException(!entityID.isNull() ? entityID.toString() : __FUNCTION__);
     currentEntityIdentifier = oldIdentifier;
     currentSandboxURL = oldSandboxURL;
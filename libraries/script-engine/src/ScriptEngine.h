@@ -12,8 +12,11 @@
 #ifndef hifi_ScriptEngine_h
 #define hifi_ScriptEngine_h
 
+#include <mutex>
 #include <vector>
 
+#include <QtCore/QCache>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QSet>
@@ -22,6 +25,8 @@
 
 #include <QtScript/QScriptEngine>
 
+#include <shared/TimerWheel.h>
+
 #include <AnimationCache.h>
 #include <AnimVariant.h>
 #include <AvatarData.h>
@@ -65,6 +70,7 @@ public:
     EntityItemID entityID;
     QString entityScript;
     //bool forceRedownload;
+    float priority;
 };
 
 typedef QList<CallbackData> CallbackList;
@@ -83,6 +89,15 @@ public:
     QUrl definingSandboxURL { QUrl("about:EntityScript") };
 };
 
+// What an entity script cost its engine since its stats were last taken.  The time spent in a callback that calls
+// into another entity script is counted for the first one.
+class EntityScriptStats {
+public:
+    quint64 callUsecs { 0 }; // wall time in the timers, event handlers, update callbacks and entity methods
+    int numCalls { 0 };
+    qint64 allocatedBytes { 0 }; // as reported to updateMemoryCost
+};
+
 class ScriptEngine : public BaseScriptEngine, public EntitiesScriptEngineProvider {
     Q_OBJECT
     Q_PROPERTY(QString context READ getContext)
@@ -175,10 +190,11 @@ public:
     QVariantMap fetchModuleSource(const QString& modulePath, const bool forceDownload = false);
     QScriptValue instantiateModule(const QScriptValue& module, const QString& sourceCode);
 
-    Q_INVOKABLE QObject* setInterval(const QScriptValue& function, int intervalMS);
-    Q_INVOKABLE QObject* setTimeout(const QScriptValue& function, int timeoutMS);
-    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
-    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    // the timers are ids of the timer wheel, 0 when the timer wasn't set
+    Q_INVOKABLE int setInterval(const QScriptValue& function, int intervalMS);
+    Q_INVOKABLE int setTimeout(const QScriptValue& function, int timeoutMS);
+    Q_INVOKABLE void clearInterval(const QVariant& timer) { stopTimer(timer.toUInt()); }
+    Q_INVOKABLE void clearTimeout(const QVariant& timer) { stopTimer(timer.toUInt()); }
 
     Q_INVOKABLE void print(const QString& message);
     Q_INVOKABLE QUrl resolvePath(const QString& path) const;
@@ -192,7 +208,9 @@ public:
     }
     QVariant cloneEntityScriptDetails(const EntityItemID& entityID);
     QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
-    Q_INVOKABLE void loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload);
+    // the scripts of higher priority are run first of those that have been fetched, see processPendingEntityScriptLoads
+    Q_INVOKABLE void loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload,
+                                      float priority = 0.0f);
     Q_INVOKABLE void unloadEntityScript(const EntityItemID& entityID, bool shouldRemoveFromMap = false); // will call unload method
     Q_INVOKABLE void unloadAllEntityScripts();
     Q_INVOKABLE void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
@@ -233,6 +251,11 @@ public:
     int getNumRunningEntityScripts() const;
     bool getEntityScriptDetails(const EntityItemID& entityID, EntityScriptDetails &details) const;
 
+    // these can be called from any thread
+    QHash<EntityItemID, EntityScriptStats> takeEntityScriptStats();
+    // the repeating timers of throttled entity scripts only call back every other time they fire
+    void setThrottledEntityScripts(const QSet<EntityItemID>& entityIDs);
+
 public slots:
     void callAnimationStateHandler(QScriptValue callback, AnimVariantMap parameters, QStringList names, bool useNames, AnimVariantResultHandler resultHandler);
     void updateMemoryCost(const qint64&);
@@ -274,9 +297,14 @@ protected:
     void setEntityScriptDetails(const EntityItemID& entityID, const EntityScriptDetails& details);
     void setParentURL(const QString& parentURL) { _parentURL = parentURL; }
     void processDeferredEntityLoads(const QString& entityScript, const EntityItemID& leaderID);
+    void processPendingEntityScriptLoads();
+
+    // The compiled program of the source, from the cache when it has been evaluated in this engine before
+    QScriptProgram getProgram(const QByteArray& programHash, const QString& sourceCode, const QString& fileName, int lineNumber = 1);
 
-    QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
-    void stopTimer(QTimer* timer);
+    int setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
+    void stopTimer(TimerWheel::TimerID timerID);
+    void scheduleTimerWheel();
 
     QHash<EntityItemID, RegisteredEventHandlers> _registeredHandlers;
     void forwardHandlerCall(const EntityItemID& entityID, const QString& eventName, QScriptValueList eventHanderArgs);
@@ -294,12 +322,52 @@ protected:
     std::atomic<bool> _isRunning { false };
     std::atomic<bool> _isStopping { false };
     bool _isInitialized { false };
-    QHash<QTimer*, CallbackData> _timerFunctionMap;
+
+    // All the timers of the script share a wheel, and a single timer that fires at its next deadline
+    class ScriptTimer {
+    public:
+        CallbackData callback;
+        int intervalMS;
+        bool isSingleShot;
+    };
+    QHash<TimerWheel::TimerID, ScriptTimer> _timers;
+    TimerWheel _timerWheel;
+    QElapsedTimer _timerWheelClock;
+    QTimer* _timerWheelTimer { nullptr };
+    uint64_t _timerWheelDeadline { TimerWheel::NO_DEADLINE };
+    TimerWheel::TimerID _nextTimerID { 1 };
+
     QSet<QUrl> _includedURLs;
+
+    // Programs are compiled for the engine they are first evaluated in, so each engine keeps its own
+    static const int MAX_CACHED_PROGRAMS = 256;
+    QCache<QByteArray, QScriptProgram> _programCache { MAX_CACHED_PROGRAMS };
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
+
+    std::mutex _entityScriptStatsMutex;
+    QHash<EntityItemID, EntityScriptStats> _entityScriptStats;
+    QSet<EntityItemID> _throttledEntityScripts;
+    QSet<TimerWheel::TimerID> _skippedTimers; // throttled timers that didn't call back the last time they fired
     QHash<QString, EntityItemID> _occupiedScriptURLs;
     QList<DeferredLoadEntity> _deferredEntityLoads;
 
+    // The entity scripts that have been fetched, in a heap on priority, to be constructed and preloaded a few at a time
+    // so that arriving in a domain full of them doesn't hold up the engine for seconds
+    class PendingEntityScriptLoad {
+    public:
+        float priority;
+        EntityItemID entityID;
+        QString entityScript;
+        QString url;
+        QString contents;
+        bool isURL;
+        bool success;
+        QString status;
+
+        bool operator<(const PendingEntityScriptLoad& other) const { return priority < other.priority; }
+    };
+    std::vector<PendingEntityScriptLoad> _pendingEntityScriptLoads;
+
     bool _isThreaded { false };
     QScriptEngineDebugger* _debugger { nullptr };
     bool _debuggable { false };
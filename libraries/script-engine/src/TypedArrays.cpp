@@ -9,6 +9,10 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
+
+#include <QtCore/QtEndian>
+
 #include <glm/glm.hpp>
 
 #include "ScriptEngine.h"
@@ -200,32 +204,56 @@ void TypedArray::setBytesPerElement(quint32 bytesPerElement) {
 }
 
 // templated helper functions
-// don't work for floats as they require single precision settings
+// Elements are read and written in place, writing only copies the buffer when its data is still shared with the
+// QByteArray it was created from
+template<class T>
+static bool isElementInBuffer(const QByteArray* arrayBuffer, uint id) {
+    return arrayBuffer && (quint64)id + sizeof(T) <= (quint64)arrayBuffer->size();
+}
+
 template<class T>
 QScriptValue propertyHelper(const QByteArray* arrayBuffer, const QScriptString& name, uint id) {
     bool ok = false;
     name.toArrayIndex(&ok);
     
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        
-        stream.setByteOrder(QDataStream::LittleEndian);
-        T result;
-        stream >> result;
-        return result;
+    if (ok && isElementInBuffer<T>(arrayBuffer, id)) {
+        return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(arrayBuffer->constData() + id));
     }
     return QScriptValue();
 }
 
 template<class T>
 void setPropertyHelper(QByteArray* arrayBuffer, const QScriptString& name, uint id, const QScriptValue& value) {
-    if (arrayBuffer && value.isNumber()) {
-        QDataStream stream(arrayBuffer, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        
-        stream << (T)value.toNumber();
+    if (isElementInBuffer<T>(arrayBuffer, id) && value.isNumber()) {
+        qToLittleEndian<T>((T)value.toNumber(), reinterpret_cast<uchar*>(arrayBuffer->data() + id));
+    }
+}
+
+// the floating point types go through the unsigned integers of the same size
+template<class T, class Bits>
+QScriptValue floatPropertyHelper(const QByteArray* arrayBuffer, const QScriptString& name, uint id) {
+    bool ok = false;
+    name.toArrayIndex(&ok);
+
+    if (ok && isElementInBuffer<T>(arrayBuffer, id)) {
+        Bits bits = qFromLittleEndian<Bits>(reinterpret_cast<const uchar*>(arrayBuffer->constData() + id));
+        T result;
+        memcpy(&result, &bits, sizeof(T));
+        if (isNaN(result)) {
+            return QScriptValue();
+        }
+        return result;
+    }
+    return QScriptValue();
+}
+
+template<class T, class Bits>
+void setFloatPropertyHelper(QByteArray* arrayBuffer, uint id, const QScriptValue& value) {
+    if (isElementInBuffer<T>(arrayBuffer, id) && value.isNumber()) {
+        T element = (T)value.toNumber();
+        Bits bits;
+        memcpy(&bits, &element, sizeof(T));
+        qToLittleEndian<Bits>(bits, reinterpret_cast<uchar*>(arrayBuffer->data() + id));
     }
 }
 
@@ -274,16 +302,16 @@ QScriptValue Uint8ClampedArrayClass::property(const QScriptValue& object, const
 void Uint8ClampedArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
+    if (isElementInBuffer<quint8>(ba, id) && value.isNumber()) {
+        quint8 element;
         if (value.toNumber() > 255) {
-            stream << (quint8)255;
+            element = 255;
         } else if (value.toNumber() < 0) {
-            stream << (quint8)0;
+            element = 0;
         } else {
-            stream << (quint8)glm::clamp(qRound(value.toNumber()), 0, 255);
+            element = (quint8)glm::clamp(qRound(value.toNumber()), 0, 255);
         }
+        ba->data()[id] = (char)element;
     }
 }
 
@@ -357,36 +385,15 @@ Float32ArrayClass::Float32ArrayClass(ScriptEngine* scriptEngine) : TypedArray(sc
 }
 
 QScriptValue Float32ArrayClass::property(const QScriptValue& object, const QScriptString& name, uint id) {
-    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
-    name.toArrayIndex(&ok);
-    
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
-        float result;
-        stream >> result;
-        if (isNaN(result)) {
-            return QScriptValue();
-        }
-        return result;
-    }
-    return TypedArray::property(object, name, id);
+    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
+    QScriptValue result = floatPropertyHelper<float, quint32>(arrayBuffer, name, id);
+    return (result.isValid()) ? result : TypedArray::property(object, name, id);
 }
 
 void Float32ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
-        stream << (float)value.toNumber();
-    }
+    setFloatPropertyHelper<float, quint32>(ba, id, value);
 }
 
 Float64ArrayClass::Float64ArrayClass(ScriptEngine* scriptEngine) : TypedArray(scriptEngine, FLOAT_64_ARRAY_CLASS_NAME) {
@@ -394,35 +401,14 @@ Float64ArrayClass::Float64ArrayClass(ScriptEngine* scriptEngine) : TypedArray(sc
 }
 
 QScriptValue Float64ArrayClass::property(const QScriptValue& object, const QScriptString& name, uint id) {
-    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
-    name.toArrayIndex(&ok);
-    
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
-        double result;
-        stream >> result;
-        if (isNaN(result)) {
-            return QScriptValue();
-        }
-        return result;
-    }
-    return TypedArray::property(object, name, id);
+    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
+    QScriptValue result = floatPropertyHelper<double, quint64>(arrayBuffer, name, id);
+    return (result.isValid()) ? result : TypedArray::property(object, name, id);
 }
 
 void Float64ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
-        stream << (double)value.toNumber();
-    }
+    setFloatPropertyHelper<double, quint64>(ba, id, value);
 }
 
@@ -13,7 +13,7 @@
 #define hifi_CPUDetect_h
 
 //
-// Lightweight functions to detect SSE/AVX/AVX2/AVX512 support
+// Lightweight functions to detect SSE/AVX/AVX2/AVX512/NEON support
 //
 
 #define MASK_SSE3       (1 << 0)                // SSE3
@@ -33,6 +33,17 @@
 #define ARCH_X86
 #endif
 
+#if defined(_M_ARM64) || defined(__aarch64__)
+#define ARCH_ARM64
+#elif defined(_M_ARM) || defined(__arm__)
+#define ARCH_ARM
+#endif
+
+#if defined(ARCH_ARM) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
 #if defined(ARCH_X86) && defined(_MSC_VER)
 
 #include <intrin.h>
@@ -155,4 +166,16 @@ static inline bool cpuSupportsAVX512() {
     return result;
 }
 
+static inline bool cpuSupportsNEON() {
+#if defined(ARCH_ARM64)
+    return true;    // NEON is mandatory on AArch64
+#elif defined(ARCH_ARM) && defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
 #endif // hifi_CPUDetect_h
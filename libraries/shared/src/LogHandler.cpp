@@ -12,7 +12,7 @@
 
 #include "LogHandler.h"
 
-#include <mutex>
+#include <chrono>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
@@ -22,14 +22,24 @@
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
+#include "NumericalConstants.h"
+
 QMutex LogHandler::_mutex;
 
+// the number of messages the writer can be behind by before the threads logging more wait for it
+static const size_t MESSAGE_QUEUE_CAPACITY = 4096;
+
+// how long the writer sleeps at most without being told about a new message
+static const std::chrono::milliseconds WRITER_WAKE_INTERVAL { 100 };
+
 LogHandler& LogHandler::getInstance() {
     static LogHandler staticInstance;
     return staticInstance;
 }
 
-LogHandler::LogHandler() {
+LogHandler::LogHandler() : _messageQueue(MESSAGE_QUEUE_CAPACITY) {
+    _writerThread = std::thread([this] { writeQueuedMessages(); });
+
     // when the log handler is first setup we should print our timezone
     QString timezoneString = "Time zone: " + QDateTime::currentDateTime().toString("t");
     printMessage(LogMsgType::LogInfo, QMessageLogContext(), timezoneString);
@@ -38,6 +48,7 @@ LogHandler::LogHandler() {
 LogHandler::~LogHandler() {
     flushRepeatedMessages();
     printMessage(LogMsgType::LogDebug, QMessageLogContext(), "LogHandler shutdown.");
+    stopWriter();
 }
 
 const char* stringForLogType(LogMsgType msgType) {
@@ -59,12 +70,9 @@ const char* stringForLogType(LogMsgType msgType) {
     }
 }
 
-// the following will produce 11/18 13:55:36
+// the following will produce 11/18 13:55:36, with .999 after it when milliseconds are displayed
 const QString DATE_STRING_FORMAT = "MM/dd hh:mm:ss";
 
-// the following will produce 11/18 13:55:36.999
-const QString DATE_STRING_FORMAT_WITH_MILLISECONDS = "MM/dd hh:mm:ss.zzz";
-
 void LogHandler::setTargetName(const QString& targetName) {
     QMutexLocker lock(&_mutex);
     _targetName = targetName;
@@ -106,17 +114,85 @@ void LogHandler::flushRepeatedMessages() {
     }
 }
 
-QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+void LogHandler::writeQueuedMessages() {
+    while (true) {
+        // anything pushed before the writer is told to stop is written before it does
+        bool isStopping = _isWriterStopping;
+
+        QString logMessage;
+        while (_messageQueue.pop(logMessage)) {
+            fprintf(stdout, "%s\n", qPrintable(logMessage));
+        }
+        if (isStopping) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(_writerMutex);
+        _writerCondition.wait_for(lock, WRITER_WAKE_INTERVAL);
+    }
+}
+
+void LogHandler::stopWriter() {
     QMutexLocker lock(&_mutex);
-    if (message.isEmpty()) {
-        return QString();
+    if (!_writerThread.joinable()) {
+        return;
     }
 
+    _isWriterStopping = true;
+    _writerCondition.notify_one();
+    _writerThread.join();
+
+    // the messages pushed while the writer was stopping, everything after it is written in place
+    QString logMessage;
+    while (_messageQueue.pop(logMessage)) {
+        fprintf(stdout, "%s\n", qPrintable(logMessage));
+    }
+}
+
+void LogHandler::writeMessage(const QString& logMessage, bool isFatal) {
+    if (isFatal) {
+        // the process aborts once this returns, the messages before this one have to be out first
+        stopWriter();
+    }
+
+    if (!_isWriterStopping) {
+        // a writer behind by a whole queue is waited for rather than losing messages
+        while (!_messageQueue.push(logMessage)) {
+            _writerCondition.notify_one();
+            std::this_thread::yield();
+        }
+        _writerCondition.notify_one();
+        return;
+    }
+
+    fprintf(stdout, "%s\n", qPrintable(logMessage));
+}
+
+// the date and time only change once a second, so each thread formats them once for each second it logs in
+static QString getTimestamp(bool shouldDisplayMilliseconds) {
+    thread_local qint64 timestampSecond { -1 };
+    thread_local QString timestamp;
+
+    QDateTime now = QDateTime::currentDateTime();
+    qint64 msecsSinceEpoch = now.toMSecsSinceEpoch();
+    qint64 second = msecsSinceEpoch / (qint64)MSECS_PER_SECOND;
+    if (second != timestampSecond) {
+        timestampSecond = second;
+        timestamp = now.toString(DATE_STRING_FORMAT);
+    }
+
+    if (shouldDisplayMilliseconds) {
+        return timestamp + QString(".%1").arg(msecsSinceEpoch % (qint64)MSECS_PER_SECOND, 3, 10, QChar('0'));
+    }
+    return timestamp;
+}
+
+bool LogHandler::shouldPrintMessage(LogMsgType type, const QString& message) {
     if (type == LogDebug) {
         // for debug messages, check if this matches any of our regexes for repeated log messages
-        foreach(const QString& regexString, getInstance()._repeatedMessageRegexes) {
-            QRegExp repeatRegex(regexString);
-            if (repeatRegex.indexIn(message) != -1) {
+        for (auto it = _repeatedMessageRegexes.begin(); it != _repeatedMessageRegexes.end(); ++it) {
+            const QString& regexString = it.key();
+            if (it.value().indexIn(message) != -1) {
 
                 if (!_repeatMessageCountHash.contains(regexString)) {
                     // we have a match but didn't have this yet - output the first one
@@ -130,55 +206,71 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
                     _lastRepeatedMessage[regexString] = message;
 
                     // return out, we're not printing this one
-                    return QString();
+                    return false;
                 }
             }
         }
     }
     if (type == LogDebug) {
         // see if this message is one we should only print once
-        foreach(const QString& regexString, getInstance()._onlyOnceMessageRegexes) {
-            QRegExp onlyOnceRegex(regexString);
-            if (onlyOnceRegex.indexIn(message) != -1) {
+        for (auto it = _onlyOnceMessageRegexes.begin(); it != _onlyOnceMessageRegexes.end(); ++it) {
+            if (it.value().indexIn(message) != -1) {
                 if (!_onlyOnceMessageCountHash.contains(message)) {
                     // we have a match and haven't yet printed this message.
                     _onlyOnceMessageCountHash[message] = 1;
-                    // break the foreach so we output the first match
+                    // break the loop so we output the first match
                     break;
                 } else {
                     // We've already printed this message, don't print it again.
-                    return QString();
+                    return false;
                 }
             }
         }
     }
+    return true;
+}
+
+QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+    if (message.isEmpty()) {
+        return QString();
+    }
+
+    QString targetName;
+    bool shouldOutputProcessID;
+    bool shouldOutputThreadID;
+    bool shouldDisplayMilliseconds;
+    {
+        QMutexLocker lock(&_mutex);
+        if (!shouldPrintMessage(type, message)) {
+            return QString();
+        }
+        targetName = _targetName;
+        shouldOutputProcessID = _shouldOutputProcessID;
+        shouldOutputThreadID = _shouldOutputThreadID;
+        shouldDisplayMilliseconds = _shouldDisplayMilliseconds;
+    }
 
     // log prefix is in the following format
     // [TIMESTAMP] [DEBUG] [PID] [TID] [TARGET] logged string
 
-    const QString* dateFormatPtr = &DATE_STRING_FORMAT;
-    if (_shouldDisplayMilliseconds) {
-        dateFormatPtr = &DATE_STRING_FORMAT_WITH_MILLISECONDS;
-    }
-
-    QString prefixString = QString("[%1] [%2] [%3]").arg(QDateTime::currentDateTime().toString(*dateFormatPtr),
+    QString prefixString = QString("[%1] [%2] [%3]").arg(getTimestamp(shouldDisplayMilliseconds),
         stringForLogType(type), context.category);
 
-    if (_shouldOutputProcessID) {
+    if (shouldOutputProcessID) {
         prefixString.append(QString(" [%1]").arg(QCoreApplication::applicationPid()));
     }
 
-    if (_shouldOutputThreadID) {
+    if (shouldOutputThreadID) {
         size_t threadID = (size_t)QThread::currentThreadId();
         prefixString.append(QString(" [%1]").arg(threadID));
     }
 
-    if (!_targetName.isEmpty()) {
-        prefixString.append(QString(" [%1]").arg(_targetName));
+    if (!targetName.isEmpty()) {
+        prefixString.append(QString(" [%1]").arg(targetName));
     }
 
     QString logMessage = QString("%1 %2").arg(prefixString, message.split('\n').join('\n' + prefixString + " "));
-    fprintf(stdout, "%s\n", qPrintable(logMessage));
+    writeMessage(logMessage, type == LogFatal);
     return logMessage;
 }
 
@@ -201,10 +293,10 @@ const QString& LogHandler::addRepeatedMessageRegex(const QString& regexString) {
     QMetaObject::invokeMethod(this, "setupRepeatedMessageFlusher");
 
     QMutexLocker lock(&_mutex);
-    return *_repeatedMessageRegexes.insert(regexString);
+    return _repeatedMessageRegexes.insert(regexString, QRegExp(regexString)).key();
 }
 
 const QString& LogHandler::addOnlyOnceMessageRegex(const QString& regexString) {
     QMutexLocker lock(&_mutex);
-    return *_onlyOnceMessageRegexes.insert(regexString);
+    return _onlyOnceMessageRegexes.insert(regexString, QRegExp(regexString)).key();
 }
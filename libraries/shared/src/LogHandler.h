@@ -13,12 +13,19 @@
 #ifndef hifi_LogHandler_h
 #define hifi_LogHandler_h
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <QHash>
 #include <QObject>
-#include <QSet>
+#include <QRegExp>
 #include <QString>
 #include <QMutex>
 
+#include "shared/MPSCRingBuffer.h"
+
 const int VERBOSE_LOG_INTERVAL_SECONDS = 5;
 
 enum LogMsgType {
@@ -31,6 +38,9 @@ enum LogMsgType {
 };
 
 /// Handles custom message handling and sending of stats/logs to Logstash instance
+///
+/// Messages are written to stdout by a thread of its own, so that the thread that logs one only formats it and pushes
+/// it onto a queue. A fatal message is written by the thread that logs it, once the ones before it are out.
 class LogHandler : public QObject {
     Q_OBJECT
 public:
@@ -62,18 +72,31 @@ private:
 
     void flushRepeatedMessages();
 
+    // false if the message matches a repeated or only once regex and isn't to be printed
+    bool shouldPrintMessage(LogMsgType type, const QString& message);
+
+    void writeMessage(const QString& logMessage, bool isFatal);
+    void writeQueuedMessages();
+    void stopWriter();
+
     QString _targetName;
     bool _shouldOutputProcessID { false };
     bool _shouldOutputThreadID { false };
     bool _shouldDisplayMilliseconds { false };
-    QSet<QString> _repeatedMessageRegexes;
+    QHash<QString, QRegExp> _repeatedMessageRegexes;
     QHash<QString, int> _repeatMessageCountHash;
     QHash<QString, QString> _lastRepeatedMessage;
 
-    QSet<QString> _onlyOnceMessageRegexes;
+    QHash<QString, QRegExp> _onlyOnceMessageRegexes;
     QHash<QString, int> _onlyOnceMessageCountHash;
 
     static QMutex _mutex;
+
+    MPSCRingBuffer<QString> _messageQueue;
+    std::mutex _writerMutex; // only for the writer to wait on
+    std::condition_variable _writerCondition;
+    std::atomic<bool> _isWriterStopping { false };
+    std::thread _writerThread;
 };
 
 #endif // hifi_LogHandler_h
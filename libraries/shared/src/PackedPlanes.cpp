@@ -0,0 +1,117 @@
+//
+//  PackedPlanes.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PackedPlanes.h"
+
+#include <algorithm>
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define PACKED_PLANES_SSE
+#endif
+
+void PackedPlanes::setPlanes(const ::Plane* planes, int count) {
+    _count = std::min(count, MAX_PLANES);
+    for (int i = 0; i < _count; ++i) {
+        _x[i] = planes[i].getNormal().x;
+        _y[i] = planes[i].getNormal().y;
+        _z[i] = planes[i].getNormal().z;
+        _d[i] = planes[i].getDCoefficient();
+    }
+}
+
+void PackedPlanes::setPlanes(const glm::vec4* planes, int count) {
+    _count = std::min(count, MAX_PLANES);
+    for (int i = 0; i < _count; ++i) {
+        _x[i] = planes[i].x;
+        _y[i] = planes[i].y;
+        _z[i] = planes[i].z;
+        _d[i] = planes[i].w;
+    }
+}
+
+// Along a normal, the farthest corner of a box is the one with the larger product on each axis, and the nearest the
+// one with the smaller. The sums are in the order of glm::dot, so that the results match Plane::distance.
+void PackedPlanes::testBoxes(const glm::vec3* minimums, const glm::vec3* maximums, int count,
+                             int& outside, int& straddling) const {
+    count = std::min(count, BOXES_PER_TEST);
+#ifdef PACKED_PLANES_SSE
+    // the unused lanes repeat the first box, and are masked out of the results
+    float minimum[3][BOXES_PER_TEST];
+    float maximum[3][BOXES_PER_TEST];
+    for (int i = 0; i < BOXES_PER_TEST; ++i) {
+        int box = (i < count) ? i : 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            minimum[axis][i] = minimums[box][axis];
+            maximum[axis][i] = maximums[box][axis];
+        }
+    }
+    __m128 minX = _mm_loadu_ps(minimum[0]);
+    __m128 minY = _mm_loadu_ps(minimum[1]);
+    __m128 minZ = _mm_loadu_ps(minimum[2]);
+    __m128 maxX = _mm_loadu_ps(maximum[0]);
+    __m128 maxY = _mm_loadu_ps(maximum[1]);
+    __m128 maxZ = _mm_loadu_ps(maximum[2]);
+    const __m128 zero = _mm_setzero_ps();
+
+    __m128 isOutside = zero;
+    __m128 isStraddling = zero;
+    for (int p = 0; p < _count; ++p) {
+        __m128 nx = _mm_set1_ps(_x[p]);
+        __m128 ny = _mm_set1_ps(_y[p]);
+        __m128 nz = _mm_set1_ps(_z[p]);
+        __m128 d = _mm_set1_ps(_d[p]);
+        __m128 minProductX = _mm_mul_ps(nx, minX);
+        __m128 maxProductX = _mm_mul_ps(nx, maxX);
+        __m128 minProductY = _mm_mul_ps(ny, minY);
+        __m128 maxProductY = _mm_mul_ps(ny, maxY);
+        __m128 minProductZ = _mm_mul_ps(nz, minZ);
+        __m128 maxProductZ = _mm_mul_ps(nz, maxZ);
+
+        __m128 farthest = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_max_ps(minProductX, maxProductX),
+            _mm_max_ps(minProductY, maxProductY)), _mm_max_ps(minProductZ, maxProductZ)), d);
+        __m128 nearest = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_min_ps(minProductX, maxProductX),
+            _mm_min_ps(minProductY, maxProductY)), _mm_min_ps(minProductZ, maxProductZ)), d);
+        isOutside = _mm_or_ps(isOutside, _mm_cmplt_ps(farthest, zero));
+        isStraddling = _mm_or_ps(isStraddling, _mm_cmplt_ps(nearest, zero));
+    }
+    int mask = (1 << count) - 1;
+    outside = _mm_movemask_ps(isOutside) & mask;
+    straddling = _mm_movemask_ps(isStraddling) & ~outside & mask;
+#else
+    outside = 0;
+    straddling = 0;
+    for (int i = 0; i < count; ++i) {
+        for (int p = 0; p < _count; ++p) {
+            float minProductX = _x[p] * minimums[i].x;
+            float maxProductX = _x[p] * maximums[i].x;
+            float minProductY = _y[p] * minimums[i].y;
+            float maxProductY = _y[p] * maximums[i].y;
+            float minProductZ = _z[p] * minimums[i].z;
+            float maxProductZ = _z[p] * maximums[i].z;
+            float farthest = std::max(minProductX, maxProductX) + std::max(minProductY, maxProductY) +
+                std::max(minProductZ, maxProductZ) + _d[p];
+            if (farthest < 0.0f) {
+                outside |= (1 << i);
+                break;
+            }
+            float nearest = std::min(minProductX, maxProductX) + std::min(minProductY, maxProductY) +
+                std::min(minProductZ, maxProductZ) + _d[p];
+            if (nearest < 0.0f) {
+                straddling |= (1 << i);
+            }
+        }
+    }
+    straddling &= ~outside;
+#endif
+}
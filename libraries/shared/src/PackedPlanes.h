@@ -0,0 +1,41 @@
+//
+//  PackedPlanes.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PackedPlanes_h
+#define hifi_PackedPlanes_h
+
+#include <glm/glm.hpp>
+
+#include "Plane.h"
+
+// The planes of a frustum, or of any convex volume, laid out component by component so that four axis aligned boxes
+// are tested against all of them at once. The normals point inside, as those of ViewFrustum do.
+class PackedPlanes {
+public:
+    static const int MAX_PLANES = 8;
+    static const int BOXES_PER_TEST = 4;
+
+    void setPlanes(const ::Plane* planes, int count);
+    void setPlanes(const glm::vec4* planes, int count); // the normal then the D coefficient
+
+    // Tests up to four boxes given by their corners. Sets the bit (1 << i) of outside for each box i entirely on the
+    // outer side of one of the planes, and of straddling for each one that isn't, but is partly on the outer side of one.
+    void testBoxes(const glm::vec3* minimums, const glm::vec3* maximums, int count,
+                   int& outside, int& straddling) const;
+
+private:
+    float _x[MAX_PLANES];
+    float _y[MAX_PLANES];
+    float _z[MAX_PLANES];
+    float _d[MAX_PLANES];
+    int _count { 0 };
+};
+
+#endif // hifi_PackedPlanes_h
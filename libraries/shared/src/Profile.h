@@ -103,9 +103,9 @@ inline void metadata(const QString& metadataType, const QVariantMap& args) {
 #define PROFILE_INSTANT(category, name, ...) instant(trace_##category(), name, ##__VA_ARGS__);
 #define PROFILE_SET_THREAD_NAME(threadName) metadata("thread_name", { { "name", threadName } });
 
-#define SAMPLE_PROFILE_RANGE(chance, category, name, ...) if (randFloat() <= chance) { PROFILE_RANGE(category, name); }
-#define SAMPLE_PROFILE_RANGE_EX(chance, category, name, ...) if (randFloat() <= chance) { PROFILE_RANGE_EX(category, name, argbColor, payload, ##__VA_ARGS__); }
-#define SAMPLE_PROFILE_COUNTER(chance, category, name, ...) if (randFloat() <= chance) { PROFILE_COUNTER(category, name, ##__VA_ARGS__); }
-#define SAMPLE_PROFILE_INSTANT(chance, category, name, ...) if (randFloat() <= chance) { PROFILE_INSTANT(category, name, ##__VA_ARGS__); }
+#define SAMPLE_PROFILE_RANGE(chance, category, name, ...) if (tracing::sample(chance)) { PROFILE_RANGE(category, name); }
+#define SAMPLE_PROFILE_RANGE_EX(chance, category, name, ...) if (tracing::sample(chance)) { PROFILE_RANGE_EX(category, name, argbColor, payload, ##__VA_ARGS__); }
+#define SAMPLE_PROFILE_COUNTER(chance, category, name, ...) if (tracing::sample(chance)) { PROFILE_COUNTER(category, name, ##__VA_ARGS__); }
+#define SAMPLE_PROFILE_INSTANT(chance, category, name, ...) if (tracing::sample(chance)) { PROFILE_INSTANT(category, name, ##__VA_ARGS__); }
 
 #endif
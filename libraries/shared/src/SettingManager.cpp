@@ -51,19 +51,31 @@ namespace Setting {
 
     void Manager::loadSetting(Interface* handle) {
         const auto& key = handle->getKey();
-        withWriteLock([&] {
-            QVariant loadedValue;
-            if (_pendingChanges.contains(key) && _pendingChanges[key] != UNSET_VALUE) {
-                loadedValue = _pendingChanges[key];
-            } else {
-                loadedValue = value(key);
+        QVariant loadedValue;
+        bool isChanged = false;
+        withReadLock([&] {
+            // a change that isn't in the file yet is newer than what is
+            auto change = _pendingChanges.find(key);
+            if (change == _pendingChanges.end()) {
+                change = _savingChanges.find(key);
+                if (change == _savingChanges.end()) {
+                    return;
+                }
             }
-            if (loadedValue.isValid()) {
-                handle->setVariant(loadedValue);
+            if (change.value() != UNSET_VALUE) {
+                loadedValue = change.value();
+                isChanged = true;
             }
         });
-    }
 
+        if (!isChanged) {
+            QMutexLocker lock(&_settingsMutex);
+            loadedValue = value(key);
+        }
+        if (loadedValue.isValid()) {
+            handle->setVariant(loadedValue);
+        }
+    }
 
     void Manager::saveSetting(Interface* handle) {
         const auto& key = handle->getKey();
@@ -96,10 +108,17 @@ namespace Setting {
     }
 
     void Manager::saveAll() {
-        bool forceSync = false;
+        // the changes are taken out all at once, so that the handles saving more don't wait on the file
         withWriteLock([&] {
-            for (auto key : _pendingChanges.keys()) {
-                auto newValue = _pendingChanges[key];
+            _savingChanges.swap(_pendingChanges);
+        });
+
+        bool forceSync = false;
+        {
+            QMutexLocker lock(&_settingsMutex);
+            for (auto change = _savingChanges.cbegin(); change != _savingChanges.cend(); ++change) {
+                const auto& key = change.key();
+                const auto& newValue = change.value();
                 auto savedValue = value(key, UNSET_VALUE);
                 if (newValue == savedValue) {
                     continue;
@@ -112,13 +131,16 @@ namespace Setting {
                     setValue(key, newValue);
                 }
             }
-            _pendingChanges.clear();
-        });
 
-        if (forceSync) {
-            sync();
+            if (forceSync) {
+                sync();
+            }
         }
 
+        withWriteLock([&] {
+            _savingChanges.clear();
+        });
+
         // Restart timer
         if (_saveTimer) {
             _saveTimer->start();
@@ -12,6 +12,7 @@
 #ifndef hifi_SettingManager_h
 #define hifi_SettingManager_h
 
+#include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QSettings>
 #include <QtCore/QTimer>
@@ -48,6 +49,8 @@ namespace Setting {
         QPointer<QTimer> _saveTimer = nullptr;
         const QVariant UNSET_VALUE { QUuid::createUuid() };
         QHash<QString, QVariant> _pendingChanges;
+        QHash<QString, QVariant> _savingChanges; // taken from the pending ones, being written to the file
+        QMutex _settingsMutex; // held while the settings are read from or written to the file
 
         friend class Interface;
         friend void cleanupPrivateInstance();
@@ -44,6 +44,10 @@ extern "C" FILE * __cdecl __iob_func(void) {
 #include <CoreFoundation/CoreFoundation.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <sys/sysinfo.h>
+#endif
+
 #include <QtCore/QDebug>
 #include <QDateTime>
 #include <QElapsedTimer>
@@ -882,6 +886,35 @@ bool getMemoryInfo(MemoryInfo& info) {
     info.processUsedMemoryBytes = pmc.PrivateUsage;
     info.processPeakUsedMemoryBytes = pmc.PeakPagefileUsage;
 
+    return true;
+#elif defined(Q_OS_LINUX)
+    struct sysinfo si;
+    if (sysinfo(&si) != 0) {
+        return false;
+    }
+
+    info.totalMemoryBytes = (uint64_t)si.totalram * si.mem_unit;
+    info.availMemoryBytes = (uint64_t)(si.freeram + si.bufferram) * si.mem_unit;
+    info.usedMemoryBytes = info.totalMemoryBytes - info.availMemoryBytes;
+
+    // the resident and peak resident sizes, in kB
+    FILE* status = fopen("/proc/self/status", "r");
+    if (!status) {
+        return false;
+    }
+    info.processUsedMemoryBytes = 0;
+    info.processPeakUsedMemoryBytes = 0;
+    char line[256];
+    unsigned long long kiloBytes;
+    while (fgets(line, sizeof(line), status)) {
+        if (sscanf(line, "VmRSS: %llu kB", &kiloBytes) == 1) {
+            info.processUsedMemoryBytes = kiloBytes * 1024;
+        } else if (sscanf(line, "VmHWM: %llu kB", &kiloBytes) == 1) {
+            info.processPeakUsedMemoryBytes = kiloBytes * 1024;
+        }
+    }
+    fclose(status);
+
     return true;
 #endif
 
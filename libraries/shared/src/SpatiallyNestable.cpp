@@ -70,6 +70,7 @@ void SpatiallyNestable::setParentID(const QUuid& parentID) {
             _parentKnowsMe = false;
         }
     });
+    worldTransformChanged();
 
     bool success = false;
     getParentPointer(success);
@@ -150,6 +151,7 @@ void SpatiallyNestable::forgetChild(SpatiallyNestablePointer newChild) const {
 
 void SpatiallyNestable::setParentJointIndex(quint16 parentJointIndex) {
     _parentJointIndex = parentJointIndex;
+    worldTransformChanged();
 }
 
 glm::vec3 SpatiallyNestable::worldToLocal(const glm::vec3& position,
@@ -400,6 +402,7 @@ void SpatiallyNestable::setPosition(const glm::vec3& position, bool& success, bo
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         Transform::mult(myWorldTransform, parentTransform, _transform);
         if (myWorldTransform.getTranslation() != position) {
             changed = true;
@@ -453,6 +456,7 @@ void SpatiallyNestable::setOrientation(const glm::quat& orientation, bool& succe
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         Transform::mult(myWorldTransform, parentTransform, _transform);
         if (myWorldTransform.getRotation() != orientation) {
             changed = true;
@@ -596,11 +600,36 @@ glm::vec3 SpatiallyNestable::getParentAngularVelocity(bool& success) const {
 
 const Transform SpatiallyNestable::getTransform(bool& success, int depth) const {
     Transform result;
+    bool isCached = false;
+    _transformLock.withReadLock([&] {
+        // relative to a parent that went away, it no longer holds
+        if (_worldTransformCached && !(_worldTransformHasParent && _parent.expired())) {
+            result = _worldTransform;
+            isCached = true;
+        }
+    });
+    if (isCached) {
+        success = true;
+        return result;
+    }
+
     // return a world-space transform for this object's location
+    uint32_t generation = _worldTransformGeneration;
     Transform parentTransform = getParentTransform(success, depth);
     _transformLock.withReadLock([&] {
         Transform::mult(result, parentTransform, _transform);
     });
+
+    SpatiallyNestablePointer parent = _parent.lock();
+    if (success && (!parent || (_parentJointIndex == INVALID_JOINT_INDEX && parent->hasCachedWorldTransform()))) {
+        _transformLock.withWriteLock([&] {
+            if (_worldTransformGeneration == generation) {
+                _worldTransform = result;
+                _worldTransformCached = true;
+                _worldTransformHasParent = (bool)parent;
+            }
+        });
+    }
     return result;
 }
 
@@ -653,6 +682,7 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
     bool changed = false;
     Transform parentTransform = getParentTransform(success);
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         Transform beforeTransform = _transform;
         Transform::inverseMult(_transform, parentTransform, transform);
         if (_transform != beforeTransform) {
@@ -696,6 +726,7 @@ void SpatiallyNestable::setScale(const glm::vec3& scale) {
     bool changed = false;
     // TODO: scale
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         if (_transform.getScale() != scale) {
             _transform.setScale(scale);
             changed = true;
@@ -717,6 +748,7 @@ void SpatiallyNestable::setScale(float value) {
     bool changed = false;
     // TODO: scale
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         glm::vec3 beforeScale = _transform.getScale();
         _transform.setScale(value);
         if (_transform.getScale() != beforeScale) {
@@ -747,6 +779,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
 
     bool changed = false;
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         if (_transform != transform) {
             _transform = transform;
             changed = true;
@@ -777,6 +810,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
     }
     bool changed = false;
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         if (_transform.getTranslation() != position) {
             _transform.setTranslation(position);
             changed = true;
@@ -804,6 +838,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
     }
     bool changed = false;
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         if (_transform.getRotation() != orientation) {
             _transform.setRotation(orientation);
             changed = true;
@@ -862,6 +897,7 @@ void SpatiallyNestable::setLocalScale(const glm::vec3& scale) {
     bool changed = false;
     // TODO: scale
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         if (_transform.getScale() != scale) {
             _transform.setScale(scale);
             changed = true;
@@ -937,11 +973,44 @@ void SpatiallyNestable::forEachDescendant(std::function<void(SpatiallyNestablePo
 }
 
 void SpatiallyNestable::locationChanged(bool tellPhysics) {
+    _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
+    });
     forEachChild([&](SpatiallyNestablePointer object) {
         object->locationChanged(tellPhysics);
     });
 }
 
+void SpatiallyNestable::invalidateWorldTransform() const {
+    ++_worldTransformGeneration;
+    _worldTransformCached = false;
+}
+
+void SpatiallyNestable::worldTransformChanged() const {
+    _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
+    });
+    foreach (SpatiallyNestablePointer child, getChildren()) {
+        child->worldTransformChanged();
+    }
+}
+
+bool SpatiallyNestable::hasCachedWorldTransform() const {
+    bool result = false;
+    _transformLock.withReadLock([&] {
+        result = _worldTransformCached;
+    });
+    return result;
+}
+
+void SpatiallyNestable::resolveWorldTransforms() const {
+    bool success;
+    getTransform(success);
+    foreach (SpatiallyNestablePointer child, getChildren()) {
+        child->resolveWorldTransforms();
+    }
+}
+
 AACube SpatiallyNestable::getMaximumAACube(bool& success) const {
     return AACube(getPosition(success) - glm::vec3(defaultAACubeSize / 2.0f), defaultAACubeSize);
 }
@@ -1117,6 +1186,7 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
 
     // transform
     _transformLock.withWriteLock([&] {
+        invalidateWorldTransform();
         if (_transform != localTransform) {
             _transform = localTransform;
             changed = true;
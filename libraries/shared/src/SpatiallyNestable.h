@@ -12,6 +12,8 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -142,6 +144,10 @@ public:
     QList<SpatiallyNestablePointer> getChildren() const;
     bool hasChildren() const;
 
+    // resolves the world transforms of this and its descendants that moved, parents first, so that the readers that
+    // follow find them cached
+    void resolveWorldTransforms() const;
+
     NestableType getNestableType() const { return _nestableType; }
 
     // this object's frame
@@ -221,6 +227,17 @@ private:
     glm::vec3 _angularVelocity;
     mutable bool _parentKnowsMe { false };
     bool _isDead { false };
+
+    // The world transform is kept until this or an ancestor moves, while no link up the chain is to a joint: joints
+    // can move without telling their children. The generation is bumped as it is invalidated, so that a transform
+    // resolved from an ancestor that moved meanwhile isn't kept.
+    void invalidateWorldTransform() const; // with _transformLock held for writing
+    void worldTransformChanged() const; // this and descendants
+    bool hasCachedWorldTransform() const;
+    mutable Transform _worldTransform;
+    mutable bool _worldTransformCached { false };
+    mutable bool _worldTransformHasParent { false };
+    mutable std::atomic<uint32_t> _worldTransformGeneration { 0 };
 };
 
 
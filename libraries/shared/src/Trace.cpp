@@ -8,7 +8,11 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
@@ -30,11 +34,90 @@
 #include <BuildInfo.h>
 
 #include "Gzip.h"
+#include "NumericalConstants.h"
 #include "PortableHighResolutionClock.h"
 #include "shared/GlobalAppProperties.h"
 
 using namespace tracing;
 
+// per thread, a power of two, a few seconds of the busier threads
+static const uint32_t RECORDING_RING_SIZE = 8192;
+static const size_t RECORDED_ID_SIZE = 12;
+static const size_t RECORDED_NAME_SIZE = 40;
+
+namespace tracing {
+
+struct RecordedEvent {
+    // odd while the event is being written, so that a reader can tell it tore
+    std::atomic<uint32_t> sequence { 0 };
+    EventType type;
+    char id[RECORDED_ID_SIZE];
+    qint64 timestamp;
+    qint64 threadID;
+    const QLoggingCategory* category;
+    char name[RECORDED_NAME_SIZE];
+};
+
+// only written by the thread that owns it
+struct RecordingRing {
+    std::atomic<bool> owned { false };
+    std::atomic<uint32_t> head { 0 }; // the number of events written
+    RecordedEvent events[RECORDING_RING_SIZE];
+};
+
+}
+
+namespace {
+
+// gives the ring back when its thread exits
+struct RecordingHandle {
+    uint32_t tracerID { 0 };
+    std::shared_ptr<RecordingRing> ring;
+
+    ~RecordingHandle() {
+        if (ring) {
+            ring->owned.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local RecordingHandle recordingHandle;
+
+std::atomic<uint32_t> nextTracerID { 1 };
+
+}
+
+static qint64 timestampNow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+}
+
+static void copyLatin1(char* destination, size_t size, const QString& source) {
+    size_t length = std::min((size_t)source.size(), size - 1);
+    const QChar* characters = source.constData();
+    for (size_t i = 0; i < length; ++i) {
+        destination[i] = characters[i].toLatin1();
+    }
+    destination[length] = '\0';
+}
+
+bool tracing::sample(float chance) {
+    static thread_local uint32_t state { 0 };
+    if (state == 0) {
+        state = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    }
+    // xorshift
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (float)(state >> 8) / (float)(1 << 24) < chance;
+}
+
+Tracer::Tracer() : _id(nextTracerID++) {
+}
+
+Tracer::~Tracer() {
+}
+
 bool tracing::enabled() {
     return DependencyManager::get<Tracer>()->isEnabled();
 }
@@ -104,30 +187,7 @@ void TraceEvent::writeJson(QTextStream& out) const {
 #endif
 }
 
-void Tracer::serialize(const QString& originalPath) {
-
-    QString path = originalPath;
-
-    // Filter for specific tokens potentially present in the path:
-    auto now = QDateTime::currentDateTime();
-
-    path = path.replace("{DATE}", now.date().toString("yyyyMMdd"));
-    path = path.replace("{TIME}", now.time().toString("HHmm"));
-
-    // If the filename is relative, turn it into an absolute path relative to the document directory.
-    QFileInfo originalFileInfo(path);
-    if (originalFileInfo.isRelative()) {
-        QString docsLocation = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
-        path = docsLocation + "/" + path;
-        QFileInfo info(path);
-        if (!info.absoluteDir().exists()) {
-            QString originalRelativePath = originalFileInfo.path();
-            QDir(docsLocation).mkpath(originalRelativePath);
-        }
-    }
-
-
-
+void Tracer::serialize(const QString& path) {
     std::list<TraceEvent> currentEvents;
     {
         std::lock_guard<std::mutex> guard(_eventsMutex);
@@ -137,18 +197,38 @@ void Tracer::serialize(const QString& originalPath) {
         }
     }
 
-    // If the file exists and we can't remove it, fail early
-    if (QFileInfo(path).exists() && !QFile::remove(path)) {
-        return;
+    write(path, toJson(currentEvents));
+
+#if 0
+    QByteArray data;
+    {
+
+        // "traceEvents":[
+        // {"args":{"nv_payload":0},"cat":"hifi.render","name":"render::Scene::processTransactionQueue","ph":"B","pid":14796,"tid":21636,"ts":68795933487}
+
+        QJsonArray traceEvents;
+
+        QJsonDocument document {
+            QJsonObject {
+                { "traceEvents", traceEvents },
+                { "otherData", QJsonObject {
+                    { "version", QString { "High Fidelity Interface v1.0" } +BuildInfo::VERSION }
+                } }
+            }
+        };
+        
+        data = document.toJson(QJsonDocument::Compact);
     }
+#endif
+}
 
-    // If we can't open a temp file for writing, fail early
+QByteArray Tracer::toJson(const std::list<TraceEvent>& events) {
     QByteArray data;
     {
         QTextStream out(&data);
         out << "[\n";
         bool first = true;
-        for (const auto& event : currentEvents) {
+        for (const auto& event : events) {
             if (first) {
                 first = false;
             } else {
@@ -158,7 +238,37 @@ void Tracer::serialize(const QString& originalPath) {
         }
         out << "\n]";
     }
+    return data;
+}
+
+void Tracer::write(const QString& originalPath, const QByteArray& json) {
 
+    QString path = originalPath;
+
+    // Filter for specific tokens potentially present in the path:
+    auto now = QDateTime::currentDateTime();
+
+    path = path.replace("{DATE}", now.date().toString("yyyyMMdd"));
+    path = path.replace("{TIME}", now.time().toString("HHmm"));
+
+    // If the filename is relative, turn it into an absolute path relative to the document directory.
+    QFileInfo originalFileInfo(path);
+    if (originalFileInfo.isRelative()) {
+        QString docsLocation = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+        path = docsLocation + "/" + path;
+        QFileInfo info(path);
+        if (!info.absoluteDir().exists()) {
+            QString originalRelativePath = originalFileInfo.path();
+            QDir(docsLocation).mkpath(originalRelativePath);
+        }
+    }
+
+    // If the file exists and we can't remove it, fail early
+    if (QFileInfo(path).exists() && !QFile::remove(path)) {
+        return;
+    }
+
+    QByteArray data = json;
     if (path.endsWith(".gz")) {
         QByteArray compressed;
         gzip(data, compressed);
@@ -173,28 +283,124 @@ void Tracer::serialize(const QString& originalPath) {
         file.write(data);
         file.close();
     }
+}
 
-#if 0
-    QByteArray data;
-    {
+void Tracer::startRecording() {
+    _recording.store(true, std::memory_order_relaxed);
+}
 
-        // "traceEvents":[
-        // {"args":{"nv_payload":0},"cat":"hifi.render","name":"render::Scene::processTransactionQueue","ph":"B","pid":14796,"tid":21636,"ts":68795933487}
+void Tracer::stopRecording() {
+    _recording.store(false, std::memory_order_relaxed);
+}
 
-        QJsonArray traceEvents;
+RecordingRing& Tracer::recordingRing() {
+    auto& handle = recordingHandle;
+    if (handle.ring && handle.tracerID == _id) {
+        return *handle.ring;
+    }
+    if (handle.ring) {
+        handle.ring->owned.store(false, std::memory_order_release);
+    }
 
-        QJsonDocument document {
-            QJsonObject {
-                { "traceEvents", traceEvents },
-                { "otherData", QJsonObject {
-                    { "version", QString { "High Fidelity Interface v1.0" } +BuildInfo::VERSION }
-                } }
+    // a thread that exited leaves its ring, and its last events, to the next thread
+    std::lock_guard<std::mutex> guard(_ringsMutex);
+    handle.ring.reset();
+    for (const auto& ring : _rings) {
+        bool owned = false;
+        if (ring->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+            handle.ring = ring;
+            break;
+        }
+    }
+    if (!handle.ring) {
+        handle.ring = std::make_shared<RecordingRing>();
+        handle.ring->owned.store(true, std::memory_order_relaxed);
+        _rings.push_back(handle.ring);
+    }
+    handle.tracerID = _id;
+    return *handle.ring;
+}
+
+void Tracer::record(const QLoggingCategory& category, const QString& name, EventType type, const QString& id,
+                    qint64 timestamp, qint64 threadID) {
+    auto& ring = recordingRing();
+    uint32_t index = ring.head.load(std::memory_order_relaxed);
+    auto& event = ring.events[index & (RECORDING_RING_SIZE - 1)];
+
+    uint32_t sequence = event.sequence.load(std::memory_order_relaxed);
+    event.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.type = type;
+    copyLatin1(event.id, RECORDED_ID_SIZE, id);
+    event.timestamp = timestamp;
+    event.threadID = threadID;
+    event.category = &category;
+    copyLatin1(event.name, RECORDED_NAME_SIZE, name);
+
+    event.sequence.store(sequence + 2, std::memory_order_release);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+QByteArray Tracer::getRecording(float seconds) {
+    qint64 since = timestampNow() - (qint64)(seconds * USECS_PER_SECOND);
+    auto processID = QCoreApplication::applicationPid();
+
+    std::list<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        events.insert(events.end(), _metadataEvents.begin(), _metadataEvents.end());
+    }
+
+    std::vector<std::shared_ptr<RecordingRing>> rings;
+    {
+        std::lock_guard<std::mutex> guard(_ringsMutex);
+        rings = _rings;
+    }
+
+    for (const auto& ring : rings) {
+        uint32_t head = ring->head.load(std::memory_order_acquire);
+        uint32_t first = head > RECORDING_RING_SIZE ? head - RECORDING_RING_SIZE : 0;
+        for (uint32_t i = first; i != head; ++i) {
+            const auto& event = ring->events[i & (RECORDING_RING_SIZE - 1)];
+
+            uint32_t sequence = event.sequence.load(std::memory_order_acquire);
+            EventType type = event.type;
+            char id[RECORDED_ID_SIZE];
+            memcpy(id, event.id, RECORDED_ID_SIZE);
+            qint64 timestamp = event.timestamp;
+            qint64 threadID = event.threadID;
+            const QLoggingCategory* category = event.category;
+            char name[RECORDED_NAME_SIZE];
+            memcpy(name, event.name, RECORDED_NAME_SIZE);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // skip the events the owner overwrote while they were copied
+            if ((sequence & 1) || sequence != event.sequence.load(std::memory_order_relaxed) ||
+                !category || timestamp < since) {
+                continue;
             }
-        };
-        
-        data = document.toJson(QJsonDocument::Compact);
+            id[RECORDED_ID_SIZE - 1] = '\0';
+            name[RECORDED_NAME_SIZE - 1] = '\0';
+            events.push_back({
+                QString::fromLatin1(id),
+                QString::fromLatin1(name),
+                type,
+                timestamp,
+                processID,
+                threadID,
+                *category,
+                QVariantMap(),
+                QVariantMap()
+            });
+        }
     }
-#endif
+
+    return toJson(events);
+}
+
+void Tracer::serializeRecording(const QString& path, float seconds) {
+    write(path, getRecording(seconds));
 }
 
 void Tracer::traceEvent(const QLoggingCategory& category,
@@ -243,13 +449,21 @@ void Tracer::traceEvent(const QLoggingCategory& category,
 void Tracer::traceEvent(const QLoggingCategory& category, 
     const QString& name, EventType type, const QString& id, 
     const QVariantMap& args, const QVariantMap& extra) {
-    if (!_enabled && type != Metadata) {
+    bool recording = type != Metadata && isRecording();
+    if (!_enabled && !recording && type != Metadata) {
         return;
     }
 
-    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
-    auto processID = QCoreApplication::applicationPid();
+    auto timestamp = timestampNow();
     auto threadID = int64_t(QThread::currentThreadId());
 
+    if (recording) {
+        record(category, name, type, id, timestamp, threadID);
+        if (!_enabled) {
+            return;
+        }
+    }
+
+    auto processID = QCoreApplication::applicationPid();
     traceEvent(category, name, type, timestamp, processID, threadID, id, args, extra);
 }
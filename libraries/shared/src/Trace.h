@@ -10,8 +10,12 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <atomic>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
@@ -76,8 +80,16 @@ struct TraceEvent {
     void writeJson(QTextStream& out) const;
 };
 
+// How far back Tracer::getRecording() looks by default
+const float DEFAULT_RECORDING_SECONDS = 5.0f;
+
+struct RecordingRing;
+
 class Tracer : public Dependency {
 public:
+    Tracer();
+    ~Tracer();
+
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
         const QString& id = "", 
@@ -88,7 +100,28 @@ public:
     void serialize(const QString& file);
     bool isEnabled() const { return _enabled; }
 
+    // The flight recorder, on by default: the latest events of each thread are kept in a fixed-size ring, so that
+    // what led up to a hitch can be dumped after the fact. Only the name, id and timestamp of an event are kept.
+    void startRecording();
+    void stopRecording();
+    bool isRecording() const { return _recording.load(std::memory_order_relaxed); }
+
+    // the events recorded over the last seconds, in the same JSON format as serialize()
+    QByteArray getRecording(float seconds = DEFAULT_RECORDING_SECONDS);
+    void serializeRecording(const QString& file, float seconds = DEFAULT_RECORDING_SECONDS);
+
+    // {DATE} and {TIME} in the path are filled in, a relative path is in the documents directory, .gz is compressed
+    static void write(const QString& path, const QByteArray& data);
+
+    // either capturing or recording
+    bool isActive() const { return _enabled || isRecording(); }
+
 private:
+    void record(const QLoggingCategory& category, const QString& name, EventType type, const QString& id,
+                qint64 timestamp, qint64 threadID);
+    RecordingRing& recordingRing();
+    QByteArray toJson(const std::list<TraceEvent>& events);
+
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
         qint64 timestamp, qint64 processID, qint64 threadID,
@@ -99,8 +132,16 @@ private:
     std::list<TraceEvent> _events;
     std::list<TraceEvent> _metadataEvents;
     std::mutex _eventsMutex;
+
+    const uint32_t _id;
+    std::atomic<bool> _recording { true };
+    std::vector<std::shared_ptr<RecordingRing>> _rings;
+    std::mutex _ringsMutex;
 };
 
+// true about once in 1 / chance calls, cheaper than randFloat() and without its shared state
+bool sample(float chance);
+
 inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
     const auto& tracer = DependencyManager::get<Tracer>();
     if (tracer) {
@@ -127,6 +127,9 @@ public:
     Mat4& getInverseMatrix(Mat4& result) const;
     Mat4& getInverseTransposeMatrix(Mat4& result) const;
 
+    // the matrix and its exact inverse, from the one rotation matrix, also with a non uniform scale
+    void getMatrixAndInverse(Mat4& matrix, Mat4& inverse) const;
+
     Mat4& getRotationScaleMatrix(Mat4& result) const;
     Mat4& getRotationScaleMatrixInverse(Mat4& result) const;
 
@@ -178,9 +181,6 @@ protected:
 
     mutable Flags _flags;
 
-    // Cached transform
-    mutable std::unique_ptr<Mat4> _matrix;
-
     bool isCacheInvalid() const { return _flags[FLAG_CACHE_INVALID]; }
     void validCache() const { _flags.set(FLAG_CACHE_INVALID, false); }
     void invalidCache() const { _flags.set(FLAG_CACHE_INVALID, true); }
@@ -197,9 +197,6 @@ protected:
 
     void flagUniform() { _flags.set(FLAG_NON_UNIFORM, false); }
     void flagNonUniform() { _flags.set(FLAG_NON_UNIFORM, true); }
-
-    void updateCache() const;
-    Mat4& getCachedMatrix(Mat4& result) const;
 };
 
 inline Transform& Transform::setIdentity() {
@@ -431,6 +428,19 @@ inline Transform::Mat4& Transform::getInverseTransposeMatrix(Transform::Mat4& re
     return result;
 }
 
+inline void Transform::getMatrixAndInverse(Mat4& matrix, Mat4& inverse) const {
+    Mat3 rot = isRotating() ? glm::mat3_cast(_rotation) : Mat3();
+
+    // [inverse] = [1 / scale] * [transposed rotation] * [-translation]
+    Vec3 inverseScale = isScaling() ? Vec3(1.0f) / _scale : Vec3(1.0f);
+    for (int i = 0; i < 3; i++) {
+        matrix[i] = Vec4(rot[i] * _scale[i], 0.0f);
+        inverse[i] = Vec4(rot[0][i] * inverseScale.x, rot[1][i] * inverseScale.y, rot[2][i] * inverseScale.z, 0.0f);
+    }
+    matrix[3] = Vec4(_translation, 1.0f);
+    inverse[3] = Vec4(-(Mat3(inverse) * _translation), 1.0f);
+}
+
 inline Transform::Mat4& Transform::getRotationScaleMatrix(Mat4& result) const {
     getMatrix(result);
     result[3] = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
@@ -539,20 +549,4 @@ inline Transform::Vec3 Transform::transform(const Vec3& pos) const {
     return Vec3(result.x / result.w, result.y / result.w, result.z / result.w);
 }
 
-inline Transform::Mat4& Transform::getCachedMatrix(Transform::Mat4& result) const {
-    updateCache();
-    result = (*_matrix);
-    return result;
-}
-
-inline void Transform::updateCache() const {
-    if (isCacheInvalid()) {
-        if (!_matrix.get()) {
-            _matrix.reset(new Mat4());
-        }
-        getMatrix((*_matrix));
-        validCache();
-    }
-}
-
 #endif
@@ -9,9 +9,19 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
+
 #include "GLMHelpers.h"
 #include "TriangleSet.h"
 
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define TRIANGLE_PACKET_SSE
+#endif
+
 
 void TriangleSet::insert(const Triangle& t) {
     _isBalanced = false;
@@ -83,6 +93,7 @@ void TriangleSet::balanceOctree() {
     for (size_t i = 0; i < _triangles.size(); i++) {
         _triangleOctree.insert(i);
     }
+    _triangleOctree.buildPackets();
 
     _isBalanced = true;
 
@@ -92,6 +103,97 @@ void TriangleSet::balanceOctree() {
 }
 
 
+#ifdef TRIANGLE_PACKET_SSE
+
+static inline __m128 dot3(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+
+// dot(n, cross(a, b))
+static inline __m128 tripleProduct(__m128 nx, __m128 ny, __m128 nz,
+                                   __m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+    __m128 cx = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+    __m128 cy = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+    __m128 cz = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+    return dot3(nx, ny, nz, cx, cy, cz);
+}
+
+#endif
+
+// The test of findRayTriangleIntersection, for the four triangles of a packet at once.
+// Returns a bit mask of the triangles the ray intersects, with their distances in distances.
+template <typename Packet>
+static int findRayTrianglePacketIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                             const Packet& packet, bool allowBackface, float distances[4]) {
+#ifdef TRIANGLE_PACKET_SSE
+    const __m128 zero = _mm_setzero_ps();
+    __m128 ox = _mm_set1_ps(origin.x);
+    __m128 oy = _mm_set1_ps(origin.y);
+    __m128 oz = _mm_set1_ps(origin.z);
+    __m128 dx = _mm_set1_ps(direction.x);
+    __m128 dy = _mm_set1_ps(direction.y);
+    __m128 dz = _mm_set1_ps(direction.z);
+
+    __m128 nx = _mm_loadu_ps(packet.normal[0]);
+    __m128 ny = _mm_loadu_ps(packet.normal[1]);
+    __m128 nz = _mm_loadu_ps(packet.normal[2]);
+
+    __m128 dividend = _mm_sub_ps(_mm_loadu_ps(packet.planeDistance), dot3(ox, oy, oz, nx, ny, nz));
+    __m128 divisor = dot3(nx, ny, nz, dx, dy, dz);
+
+    // the degenerate triangles padding a packet have no normal, so they fail this
+    __m128 mask = _mm_cmplt_ps(divisor, zero);
+    if (!allowBackface) {
+        mask = _mm_and_ps(mask, _mm_cmple_ps(dividend, zero));
+    }
+    if (_mm_movemask_ps(mask) == 0) {
+        return 0;
+    }
+
+    __m128 t = _mm_div_ps(dividend, divisor);
+    __m128 px = _mm_add_ps(ox, _mm_mul_ps(dx, t));
+    __m128 py = _mm_add_ps(oy, _mm_mul_ps(dy, t));
+    __m128 pz = _mm_add_ps(oz, _mm_mul_ps(dz, t));
+
+    // point - v1
+    __m128 ax = _mm_sub_ps(px, _mm_loadu_ps(packet.v1[0]));
+    __m128 ay = _mm_sub_ps(py, _mm_loadu_ps(packet.v1[1]));
+    __m128 az = _mm_sub_ps(pz, _mm_loadu_ps(packet.v1[2]));
+    // point - v0
+    __m128 bx = _mm_sub_ps(px, _mm_loadu_ps(packet.v0[0]));
+    __m128 by = _mm_sub_ps(py, _mm_loadu_ps(packet.v0[1]));
+    __m128 bz = _mm_sub_ps(pz, _mm_loadu_ps(packet.v0[2]));
+
+    __m128 fx = _mm_loadu_ps(packet.firstSide[0]);
+    __m128 fy = _mm_loadu_ps(packet.firstSide[1]);
+    __m128 fz = _mm_loadu_ps(packet.firstSide[2]);
+    __m128 sx = _mm_loadu_ps(packet.secondSide[0]);
+    __m128 sy = _mm_loadu_ps(packet.secondSide[1]);
+    __m128 sz = _mm_loadu_ps(packet.secondSide[2]);
+    __m128 tx = _mm_loadu_ps(packet.thirdSide[0]);
+    __m128 ty = _mm_loadu_ps(packet.thirdSide[1]);
+    __m128 tz = _mm_loadu_ps(packet.thirdSide[2]);
+
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(tripleProduct(nx, ny, nz, ax, ay, az, fx, fy, fz), zero));
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(tripleProduct(nx, ny, nz, sx, sy, sz, ax, ay, az), zero));
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(tripleProduct(nx, ny, nz, bx, by, bz, tx, ty, tz), zero));
+
+    _mm_storeu_ps(distances, t);
+    return _mm_movemask_ps(mask) & ((1 << packet.count) - 1);
+#else
+    int hits = 0;
+    for (int i = 0; i < packet.count; i++) {
+        glm::vec3 v0(packet.v0[0][i], packet.v0[1][i], packet.v0[2][i]);
+        glm::vec3 v1(packet.v1[0][i], packet.v1[1][i], packet.v1[2][i]);
+        glm::vec3 v2 = v1 + glm::vec3(packet.secondSide[0][i], packet.secondSide[1][i], packet.secondSide[2][i]);
+        if (findRayTriangleIntersection(origin, direction, v0, v1, v2, distances[i], allowBackface)) {
+            hits |= 1 << i;
+        }
+    }
+    return hits;
+#endif
+}
+
 // Determine of the given ray (origin/direction) in model space intersects with any triangles
 // in the set. If an intersection occurs, the distance and surface normal will be provided.
 bool TriangleSet::TriangleOctreeCell::findRayIntersectionInternal(const glm::vec3& origin, const glm::vec3& direction,
@@ -110,15 +212,15 @@ bool TriangleSet::TriangleOctreeCell::findRayIntersectionInternal(const glm::vec
         }
 
         if (precision) {
-            for (const auto& triangleIndex : _triangleIndices) {
-                const auto& triangle = _allTriangles[triangleIndex];
-                float thisTriangleDistance;
-                trianglesTouched++;
-                if (findRayTriangleIntersection(origin, direction, triangle, thisTriangleDistance, allowBackface)) {
-                    if (thisTriangleDistance < bestDistance) {
-                        bestDistance = thisTriangleDistance;
+            for (const auto& packet : _packets) {
+                float distances[4];
+                trianglesTouched += packet.count;
+                int hits = findRayTrianglePacketIntersection(origin, direction, packet, allowBackface, distances);
+                for (int i = 0; hits != 0; i++, hits >>= 1) {
+                    if ((hits & 1) && distances[i] < bestDistance) {
+                        bestDistance = distances[i];
                         intersectedSomething = true;
-                        surfaceNormal = triangle.getNormal();
+                        surfaceNormal = _allTriangles[packet.triangleIndices[i]].getNormal();
                         distance = bestDistance;
                     }
                 }
@@ -144,6 +246,7 @@ TriangleSet::TriangleOctreeCell::TriangleOctreeCell(std::vector<Triangle>& allTr
 void TriangleSet::TriangleOctreeCell::clear() {
     _population = 0;
     _triangleIndices.clear();
+    _packets.clear();
     _bounds.clear();
     _children.clear();
 }
@@ -154,6 +257,41 @@ void TriangleSet::TriangleOctreeCell::reset(const AABox& bounds, int depth) {
     _depth = depth;
 }
 
+void TriangleSet::TriangleOctreeCell::buildPackets() {
+    _packets.clear();
+    _packets.reserve((_triangleIndices.size() + 3) / 4);
+    for (size_t i = 0; i < _triangleIndices.size(); i++) {
+        if (i % 4 == 0) {
+            // the unused lanes stay zero, a triangle without a normal that no ray intersects
+            _packets.emplace_back();
+            memset(&_packets.back(), 0, sizeof(TrianglePacket));
+        }
+        auto& packet = _packets.back();
+        int lane = packet.count++;
+        size_t triangleIndex = _triangleIndices[i];
+        const Triangle& triangle = _allTriangles[triangleIndex];
+
+        glm::vec3 firstSide = triangle.v0 - triangle.v1;
+        glm::vec3 secondSide = triangle.v2 - triangle.v1;
+        glm::vec3 thirdSide = triangle.v2 - triangle.v0;
+        glm::vec3 normal = glm::cross(secondSide, firstSide);
+        for (int axis = 0; axis < 3; axis++) {
+            packet.v0[axis][lane] = triangle.v0[axis];
+            packet.v1[axis][lane] = triangle.v1[axis];
+            packet.firstSide[axis][lane] = firstSide[axis];
+            packet.secondSide[axis][lane] = secondSide[axis];
+            packet.thirdSide[axis][lane] = thirdSide[axis];
+            packet.normal[axis][lane] = normal[axis];
+        }
+        packet.planeDistance[lane] = glm::dot(normal, triangle.v1);
+        packet.triangleIndices[lane] = triangleIndex;
+    }
+
+    for (auto& child : _children) {
+        child.second.buildPackets();
+    }
+}
+
 void TriangleSet::TriangleOctreeCell::debugDump() {
     qDebug() << __FUNCTION__;
     qDebug() << "bounds:" << getBounds();
@@ -31,9 +31,26 @@ class TriangleSet {
 
         const AABox& getBounds() const { return _bounds; }
 
+        // lays out the triangles of this cell and its children for the packet ray test, once they are all inserted
+        void buildPackets();
+
         void debugDump();
 
     protected:
+        // four triangles of a cell, with what findRayTriangleIntersection derives from them precomputed, laid out
+        // so that one ray is tested against all four at once
+        struct TrianglePacket {
+            float v0[3][4];
+            float v1[3][4];
+            float firstSide[3][4];  // v0 - v1
+            float secondSide[3][4]; // v2 - v1
+            float thirdSide[3][4];  // v2 - v0
+            float normal[3][4];
+            float planeDistance[4]; // dot(normal, v1)
+            size_t triangleIndices[4];
+            int count;
+        };
+
         TriangleOctreeCell(std::vector<Triangle>& allTriangles, const AABox& bounds, int depth);
 
         // checks our internal list of triangles
@@ -46,6 +63,7 @@ class TriangleSet {
         int _population{ 0 };
         AABox _bounds;
         std::vector<size_t> _triangleIndices;
+        std::vector<TrianglePacket> _packets;
 
         friend class TriangleSet;
     };
@@ -107,6 +107,7 @@ void ViewFrustum::calculate() {
     _planes[RIGHT_PLANE].set3Points(_cornersWorld[BOTTOM_RIGHT_FAR], _cornersWorld[BOTTOM_RIGHT_NEAR], _cornersWorld[TOP_RIGHT_FAR]);
     _planes[NEAR_PLANE].set3Points(_cornersWorld[BOTTOM_RIGHT_NEAR], _cornersWorld[BOTTOM_LEFT_NEAR], _cornersWorld[TOP_LEFT_NEAR]);
     _planes[FAR_PLANE].set3Points(_cornersWorld[BOTTOM_LEFT_FAR], _cornersWorld[BOTTOM_RIGHT_FAR], _cornersWorld[TOP_RIGHT_FAR]);
+    _packedPlanes.setPlanes(_planes, NUM_FRUSTUM_PLANES);
 
     // Also calculate our projection matrix in case people want to project points...
     // Projection matrix : Field of View, ratio, display range : near to far
@@ -309,6 +310,28 @@ bool ViewFrustum::cubeIntersectsKeyhole(const AACube& cube) const {
     return true;
 }
 
+int ViewFrustum::boxesIntersectFrustum(const glm::vec3* minimums, const glm::vec3* maximums, int count) const {
+    int outside, straddling;
+    _packedPlanes.testBoxes(minimums, maximums, count, outside, straddling);
+    return ~outside & ((1 << count) - 1);
+}
+
+int ViewFrustum::cubesIntersectKeyhole(const AACube* cubes, int count) const {
+    const int MAX_CUBES = PackedPlanes::BOXES_PER_TEST;
+    count = std::min(count, MAX_CUBES);
+    glm::vec3 minimums[MAX_CUBES];
+    glm::vec3 maximums[MAX_CUBES];
+    int touchingSphere = 0;
+    for (int i = 0; i < count; ++i) {
+        minimums[i] = cubes[i].getMinimumPoint();
+        maximums[i] = cubes[i].getMaximumPoint();
+        if (cubes[i].touchesSphere(_position, _centerSphereRadius)) {
+            touchingSphere |= (1 << i);
+        }
+    }
+    return touchingSphere | boxesIntersectFrustum(minimums, maximums, count);
+}
+
 bool ViewFrustum::boxIntersectsKeyhole(const AABox& box) const {
     // check positive touch against central sphere
     if (box.touchesSphere(_position, _centerSphereRadius)) {
@@ -756,5 +779,6 @@ void ViewFrustum::invalidate() {
     for (int i = 0; i < NUM_FRUSTUM_PLANES; ++i) {
         _planes[i].invalidate();
     }
+    _packedPlanes.setPlanes(_planes, NUM_FRUSTUM_PLANES);
     _centerSphereRadius = -1.0e6f; // -10^6 should be negative enough
 }
@@ -20,6 +20,7 @@
 #include "AABox.h"
 #include "AACube.h"
 #include "CubeProjectedPolygon.h"
+#include "PackedPlanes.h"
 #include "Plane.h"
 #include "RegisteredMetaTypes.h"
 #include "Transform.h"
@@ -107,6 +108,11 @@ public:
     bool cubeIntersectsKeyhole(const AACube& cube) const;
     bool boxIntersectsKeyhole(const AABox& box) const;
 
+    // the tests above, of up to PackedPlanes::BOXES_PER_TEST boxes at once: they return a mask with the bit (1 << i)
+    // set for each box i in view
+    int boxesIntersectFrustum(const glm::vec3* minimums, const glm::vec3* maximums, int count) const;
+    int cubesIntersectKeyhole(const AACube* cubes, int count) const;
+
     // some frustum comparisons
     bool matches(const ViewFrustum& compareTo, bool debug = false) const;
     bool matches(const ViewFrustum* compareTo, bool debug = false) const { return matches(*compareTo, debug); }
@@ -137,6 +143,7 @@ public:
     enum PlaneIndex { TOP_PLANE = 0, BOTTOM_PLANE, LEFT_PLANE, RIGHT_PLANE, NEAR_PLANE, FAR_PLANE, NUM_PLANES };
 
     const ::Plane* getPlanes() const { return _planes; }
+    const PackedPlanes& getPackedPlanes() const { return _packedPlanes; }
 
     void invalidate(); // causes all reasonable intersection tests to fail
 
@@ -148,6 +155,7 @@ private:
     glm::mat4 _projection;
 
     ::Plane _planes[NUM_FRUSTUM_PLANES]; // plane normals point inside frustum
+    PackedPlanes _packedPlanes; // the same, to test several boxes at once
 
     glm::vec3 _position; // position in world-frame
     glm::quat _orientation; // orientation in world-frame
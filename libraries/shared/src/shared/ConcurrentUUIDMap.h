@@ -0,0 +1,230 @@
+//
+//  ConcurrentUUIDMap.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ConcurrentUUIDMap_h
+#define hifi_ConcurrentUUIDMap_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QVector>
+
+#include "../UUIDHasher.h"
+
+// Open addressing map from UUIDs to shared pointers, for tables that are read far more often than they are changed.
+//
+// Lookups never take a lock. Writers are serialized with each other, and publish a slot's key before marking it full,
+// so a reader only ever compares keys that won't change under it. Removed slots are left as tombstones until the
+// table is next rebuilt, and rebuilt tables are swapped in whole, so a reader still probing the old table keeps it
+// alive until it is done.
+template <typename T>
+class ConcurrentUUIDMap {
+public:
+    using Pointer = std::shared_ptr<T>;
+
+    ConcurrentUUIDMap() : _table(std::make_shared<Table>(MIN_CAPACITY)) {}
+
+    // returns a null pointer if there is no value for key
+    Pointer value(const QUuid& key) const;
+    bool contains(const QUuid& key) const { return (bool)value(key); }
+    int size() const { return _size.load(std::memory_order_relaxed); }
+
+    // returns false, leaving the map unchanged, if there already is a value for key
+    bool insert(const QUuid& key, const Pointer& value);
+    bool remove(const QUuid& key);
+    void clear();
+
+    // calls f(key, value) for every value in the map, values removed while this runs may or may not be visited
+    template <typename F>
+    void forEach(F f) const;
+    QVector<Pointer> values() const;
+
+private:
+    enum SlotState : uint8_t { EMPTY, FULL, REMOVED };
+
+    struct Slot {
+        std::atomic<uint8_t> state { EMPTY };
+        QUuid key;
+        Pointer value; // only accessed through std::atomic_load and std::atomic_store
+    };
+
+    struct Table {
+        Table(size_t capacity) : slots(new Slot[capacity]), mask(capacity - 1) {}
+
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;
+        size_t used { 0 }; // full and removed slots, only touched by writers
+    };
+    using TablePointer = std::shared_ptr<Table>;
+
+    static const size_t MIN_CAPACITY = 64; // must be a power of two
+
+    // with linear probing, keep tables at most 3/4 used and rebuild them at most 3/8 used
+    static bool isOverloaded(size_t used, size_t capacity) { return used * 4 > capacity * 3; }
+    static bool isLoaded(size_t used, size_t capacity) { return used * 8 > capacity * 3; }
+
+    // only called by writers, returns the slot holding key or nullptr
+    Slot* findFull(const Table& table, const QUuid& key) const;
+    void rebuild(size_t liveCount);
+
+    TablePointer _table; // only accessed through std::atomic_load and std::atomic_store
+    std::atomic<int> _size { 0 };
+    std::mutex _writeMutex;
+};
+
+template <typename T>
+const size_t ConcurrentUUIDMap<T>::MIN_CAPACITY;
+
+template <typename T>
+typename ConcurrentUUIDMap<T>::Pointer ConcurrentUUIDMap<T>::value(const QUuid& key) const {
+    TablePointer table = std::atomic_load(&_table);
+
+    size_t index = UUIDHasher()(key) & table->mask;
+    for (size_t probes = 0; probes <= table->mask; ++probes) {
+        const Slot& slot = table->slots[index];
+        uint8_t state = slot.state.load(std::memory_order_acquire);
+        if (state == EMPTY) {
+            break;
+        }
+        if (state == FULL && slot.key == key) {
+            return std::atomic_load(&slot.value);
+        }
+        index = (index + 1) & table->mask;
+    }
+    return Pointer();
+}
+
+template <typename T>
+typename ConcurrentUUIDMap<T>::Slot* ConcurrentUUIDMap<T>::findFull(const Table& table, const QUuid& key) const {
+    size_t index = UUIDHasher()(key) & table.mask;
+    for (size_t probes = 0; probes <= table.mask; ++probes) {
+        Slot& slot = table.slots[index];
+        uint8_t state = slot.state.load(std::memory_order_relaxed);
+        if (state == EMPTY) {
+            break;
+        }
+        if (state == FULL && slot.key == key) {
+            return &slot;
+        }
+        index = (index + 1) & table.mask;
+    }
+    return nullptr;
+}
+
+template <typename T>
+bool ConcurrentUUIDMap<T>::insert(const QUuid& key, const Pointer& value) {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+
+    // only writers store the table, so under the write mutex it can be read directly
+    if (findFull(*_table, key)) {
+        return false;
+    }
+
+    if (isOverloaded(_table->used + 1, _table->mask + 1)) {
+        rebuild(_size + 1);
+    }
+
+    Table& table = *_table;
+    size_t index = UUIDHasher()(key) & table.mask;
+    while (table.slots[index].state.load(std::memory_order_relaxed) != EMPTY) {
+        index = (index + 1) & table.mask;
+    }
+
+    Slot& slot = table.slots[index];
+    slot.key = key;
+    std::atomic_store(&slot.value, value);
+    slot.state.store(FULL, std::memory_order_release);
+
+    ++table.used;
+    ++_size;
+    return true;
+}
+
+template <typename T>
+bool ConcurrentUUIDMap<T>::remove(const QUuid& key) {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+
+    Slot* slot = findFull(*_table, key);
+    if (!slot) {
+        return false;
+    }
+
+    // the tombstone keeps its key, a reader that is comparing it sees the same key until the table is rebuilt
+    slot->state.store(REMOVED, std::memory_order_release);
+    std::atomic_store(&slot->value, Pointer());
+    --_size;
+    return true;
+}
+
+template <typename T>
+void ConcurrentUUIDMap<T>::clear() {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    std::atomic_store(&_table, std::make_shared<Table>(MIN_CAPACITY));
+    _size = 0;
+}
+
+template <typename T>
+void ConcurrentUUIDMap<T>::rebuild(size_t liveCount) {
+    size_t capacity = MIN_CAPACITY;
+    while (isLoaded(liveCount, capacity)) {
+        capacity *= 2;
+    }
+
+    TablePointer newTable = std::make_shared<Table>(capacity);
+    const Table& oldTable = *_table;
+    for (size_t i = 0; i <= oldTable.mask; ++i) {
+        const Slot& oldSlot = oldTable.slots[i];
+        if (oldSlot.state.load(std::memory_order_relaxed) != FULL) {
+            continue;
+        }
+
+        size_t index = UUIDHasher()(oldSlot.key) & newTable->mask;
+        while (newTable->slots[index].state.load(std::memory_order_relaxed) != EMPTY) {
+            index = (index + 1) & newTable->mask;
+        }
+
+        Slot& slot = newTable->slots[index];
+        slot.key = oldSlot.key;
+        slot.value = std::atomic_load(&oldSlot.value);
+        slot.state.store(FULL, std::memory_order_relaxed);
+        ++newTable->used;
+    }
+
+    // the new table is only visible to readers once it is complete
+    std::atomic_store(&_table, newTable);
+}
+
+template <typename T>
+template <typename F>
+void ConcurrentUUIDMap<T>::forEach(F f) const {
+    TablePointer table = std::atomic_load(&_table);
+    for (size_t i = 0; i <= table->mask; ++i) {
+        const Slot& slot = table->slots[i];
+        if (slot.state.load(std::memory_order_acquire) == FULL) {
+            Pointer value = std::atomic_load(&slot.value);
+            if (value) {
+                f(slot.key, value);
+            }
+        }
+    }
+}
+
+template <typename T>
+QVector<typename ConcurrentUUIDMap<T>::Pointer> ConcurrentUUIDMap<T>::values() const {
+    QVector<Pointer> result;
+    result.reserve(size());
+    forEach([&](const QUuid&, const Pointer& value) {
+        result.push_back(value);
+    });
+    return result;
+}
+
+#endif // hifi_ConcurrentUUIDMap_h
@@ -16,6 +16,7 @@
 #include <queue>
 #include <cassert>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QSaveFile>
@@ -40,6 +41,14 @@ using namespace cache;
 static const char DIR_SEP = '/';
 static const char EXT_SEP = '.';
 
+static const char* INDEX_SNAPSHOT_NAME = "cache.index";
+static const char* INDEX_JOURNAL_NAME = "cache.journal";
+static const quint32 INDEX_MAGIC = 0x48464349; // "HFCI"
+static const quint32 INDEX_VERSION = 1;
+static const QDataStream::Version INDEX_STREAM_VERSION = QDataStream::Qt_5_6;
+// the journal is folded into a new snapshot once it has this many records, or twice as many as there are files
+static const size_t MIN_INDEX_JOURNAL_RECORDS_TO_COMPACT = 1000;
+
 const size_t FileCache::DEFAULT_MAX_SIZE { GB_TO_BYTES(5) };
 const size_t FileCache::MAX_MAX_SIZE { GB_TO_BYTES(100) };
 const size_t FileCache::DEFAULT_MIN_FREE_STORAGE_SPACE { GB_TO_BYTES(1) };
@@ -64,12 +73,14 @@ std::string getCachePath(const std::string& dirname_str) {
 }
 
 void FileCache::setMinFreeSize(size_t size) {
+    Lock lock(_mutex);
     _minFreeSpaceSize = size;
     clean();
     emit dirty();
 }
 
 void FileCache::setMaxSize(size_t maxSize) {
+    Lock lock(_mutex);
     _maxSize = std::min(maxSize, MAX_MAX_SIZE);
     clean();
     emit dirty();
@@ -83,6 +94,14 @@ FileCache::FileCache(const std::string& dirname, const std::string& ext, QObject
 }
 
 FileCache::~FileCache() {
+    if (_reconcileThread.joinable()) {
+        // the reconciliation may have been the last to let go of the cache
+        if (_reconcileThread.get_id() == std::this_thread::get_id()) {
+            _reconcileThread.detach();
+        } else {
+            _reconcileThread.join();
+        }
+    }
     clear();
 }
 
@@ -96,28 +115,243 @@ void FileCache::initialize() {
     QDir dir(_dirpath.c_str());
 
     if (dir.exists()) {
-        auto nameFilters = QStringList(("*." + _ext).c_str());
-        auto filters = QDir::Filters(QDir::NoDotAndDotDot | QDir::Files);
-        auto sort = QDir::SortFlags(QDir::Time);
-        auto files = dir.entryList(nameFilters, filters, sort);
-
-        // load persisted files
-        foreach(QString filename, files) {
-            const Key key = filename.section('.', 0, 0).toStdString();
-            const std::string filepath = dir.filePath(filename).toStdString();
-            const size_t length = QFileInfo(filepath.c_str()).size();
-            addFile(Metadata(key, length), filepath);
-        }
+        std::vector<Key> indexedKeys;
+        if (readIndex(indexedKeys)) {
+            qCDebug(file_cache, "[%s] Initialized %s from its index of %d files", _dirname.c_str(), _dirpath.c_str(),
+                (int)indexedKeys.size());
+
+            _reconcileThread = std::thread(&FileCache::reconcileIndex, FileCacheWeakPointer(shared_from_this()),
+                std::move(indexedKeys));
+        } else {
+            auto nameFilters = QStringList(("*." + _ext).c_str());
+            auto filters = QDir::Filters(QDir::NoDotAndDotDot | QDir::Files);
+            auto sort = QDir::SortFlags(QDir::Time);
+            auto files = dir.entryList(nameFilters, filters, sort);
+
+            // load persisted files
+            foreach(QString filename, files) {
+                const Key key = filename.section('.', 0, 0).toStdString();
+                const std::string filepath = dir.filePath(filename).toStdString();
+                const QFileInfo fileInfo(filepath.c_str());
+                auto file = addFile(Metadata(key, fileInfo.size()), filepath);
+                file->_modified = fileInfo.lastRead().toMSecsSinceEpoch();
+                file->_verified = true;
+            }
 
-        qCDebug(file_cache, "[%s] Initialized %s", _dirname.c_str(), _dirpath.c_str());
+            writeIndex();
+            qCDebug(file_cache, "[%s] Initialized %s", _dirname.c_str(), _dirpath.c_str());
+        }
     } else {
         dir.mkpath(_dirpath.c_str());
+        writeIndex();
         qCDebug(file_cache, "[%s] Created %s", _dirname.c_str(), _dirpath.c_str());
     }
 
     _initialized = true;
 }
 
+bool FileCache::readIndex(std::vector<Key>& keys) {
+    QFile snapshot(QString::fromStdString(_dirpath + DIR_SEP + INDEX_SNAPSHOT_NAME));
+    if (!snapshot.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    struct Entry {
+        size_t length;
+        int64_t modified;
+    };
+    std::unordered_map<Key, Entry> entries;
+
+    QDataStream in(&snapshot);
+    in.setVersion(INDEX_STREAM_VERSION);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION) {
+        qCWarning(file_cache, "[%s] Ignoring an index of a different version", _dirname.c_str());
+        return false;
+    }
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QByteArray key;
+        quint64 length;
+        qint64 modified;
+        in >> key >> length >> modified;
+        entries[key.toStdString()] = { (size_t)length, modified };
+    }
+    if (in.status() != QDataStream::Ok) {
+        qCWarning(file_cache, "[%s] Failed to read the index", _dirname.c_str());
+        return false;
+    }
+
+    _indexJournalCount = 0;
+    _indexJournal.setFileName(QString::fromStdString(_dirpath + DIR_SEP + INDEX_JOURNAL_NAME));
+    if (_indexJournal.open(QIODevice::ReadWrite)) {
+        QDataStream journal(&_indexJournal);
+        journal.setVersion(INDEX_STREAM_VERSION);
+        qint64 recordedSize = 0;
+        while (!journal.atEnd()) {
+            quint8 type;
+            QByteArray key;
+            quint64 length;
+            qint64 modified;
+            journal >> type >> key >> length >> modified;
+            if (journal.status() != QDataStream::Ok) {
+                // the last record didn't make it to the disk whole
+                break;
+            }
+            recordedSize = _indexJournal.pos();
+            ++_indexJournalCount;
+
+            if ((IndexRecord)type == IndexRecord::Remove) {
+                entries.erase(key.toStdString());
+            } else {
+                entries[key.toStdString()] = { (size_t)length, modified };
+            }
+        }
+        _indexJournal.resize(recordedSize);
+        _indexJournal.seek(recordedSize);
+    }
+
+    // the files start out unused, without going through releaseFile since the cache is only cleaned once they all are
+    keys.reserve(entries.size());
+    for (const auto& entry : entries) {
+        File* rawFile = createFile(Metadata(entry.first, entry.second.length), getFilepath(entry.first)).release();
+        FilePointer file(rawFile, std::bind(&File::deleter, rawFile));
+        file->_parent = shared_from_this();
+        file->_modified = entry.second.modified;
+        _files[entry.first] = file;
+        _unusedFiles.insert(file);
+        _numTotalFiles += 1;
+        _totalFilesSize += file->getLength();
+        _numUnusedFiles += 1;
+        _unusedFilesSize += file->getLength();
+        keys.push_back(entry.first);
+    }
+    clean();
+    emit dirty();
+
+    return true;
+}
+
+bool FileCache::writeIndex() {
+    // hold on to the files while they are written down, so that none are released into the cache meanwhile
+    std::vector<FilePointer> files;
+    files.reserve(_files.size());
+    for (const auto& entry : _files) {
+        auto file = entry.second.lock();
+        if (file) {
+            files.push_back(file);
+        }
+    }
+
+    QSaveFile snapshot(QString::fromStdString(_dirpath + DIR_SEP + INDEX_SNAPSHOT_NAME));
+    if (snapshot.open(QIODevice::WriteOnly)) {
+        QDataStream out(&snapshot);
+        out.setVersion(INDEX_STREAM_VERSION);
+        out << INDEX_MAGIC << INDEX_VERSION << (quint32)files.size();
+        for (const auto& file : files) {
+            out << QByteArray::fromStdString(file->getKey()) << (quint64)file->getLength() << (qint64)file->_modified;
+        }
+    }
+    if (!snapshot.commit()) {
+        qCWarning(file_cache, "[%s] Failed to write the index", _dirname.c_str());
+        return false;
+    }
+
+    // what was in the journal is all in the snapshot now
+    _indexJournal.close();
+    _indexJournal.setFileName(QString::fromStdString(_dirpath + DIR_SEP + INDEX_JOURNAL_NAME));
+    _indexJournal.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    _indexJournalCount = 0;
+    return true;
+}
+
+void FileCache::appendIndexRecord(IndexRecord type, const File& file) {
+    if (!_indexJournal.isOpen()) {
+        return;
+    }
+
+    QDataStream out(&_indexJournal);
+    out.setVersion(INDEX_STREAM_VERSION);
+    out << (quint8)type << QByteArray::fromStdString(file.getKey()) << (quint64)file.getLength()
+        << (qint64)file._modified;
+    _indexJournal.flush();
+
+    if (++_indexJournalCount > std::max(MIN_INDEX_JOURNAL_RECORDS_TO_COMPACT, 2 * _files.size())) {
+        writeIndex();
+    }
+}
+
+void FileCache::reconcileIndex(FileCacheWeakPointer weakCache, std::vector<Key> indexedKeys) {
+    // the cache is only held while it is being changed, it goes if it is let go of meanwhile
+    std::string dirpath;
+    std::string ext;
+    {
+        auto cache = weakCache.lock();
+        if (!cache) {
+            return;
+        }
+        dirpath = cache->_dirpath;
+        ext = cache->_ext;
+    }
+
+    // eject the files that were removed from the directory behind the cache's back
+    for (const auto& key : indexedKeys) {
+        const std::string filepath = dirpath + DIR_SEP + key + EXT_SEP + ext;
+        if (QFileInfo::exists(filepath.c_str())) {
+            continue;
+        }
+
+        auto cache = weakCache.lock();
+        if (!cache) {
+            return;
+        }
+        Lock lock(cache->_mutex);
+        const auto it = cache->_files.find(key);
+        if (it != cache->_files.cend()) {
+            auto file = it->second.lock();
+            if (file && !file->_verified && !QFileInfo::exists(filepath.c_str())) {
+                qCDebug(file_cache, "[%s] Ejecting missing %s", cache->_dirname.c_str(), key.c_str());
+                cache->eject(file);
+            }
+        }
+    }
+
+    // and add those that were put there that it doesn't know of
+    QDir dir(dirpath.c_str());
+    auto nameFilters = QStringList(("*." + ext).c_str());
+    auto filenames = dir.entryList(nameFilters, QDir::Filters(QDir::NoDotAndDotDot | QDir::Files));
+    foreach(QString filename, filenames) {
+        const Key key = filename.section('.', 0, 0).toStdString();
+        {
+            auto cache = weakCache.lock();
+            if (!cache) {
+                return;
+            }
+            Lock lock(cache->_mutex);
+            if (cache->_files.find(key) != cache->_files.cend()) {
+                continue;
+            }
+        }
+
+        const std::string filepath = dir.filePath(filename).toStdString();
+        const QFileInfo fileInfo(filepath.c_str());
+
+        auto cache = weakCache.lock();
+        if (!cache) {
+            return;
+        }
+        Lock lock(cache->_mutex);
+        if (cache->_files.find(key) == cache->_files.cend() && fileInfo.exists()) {
+            qCDebug(file_cache, "[%s] Adding unindexed %s", cache->_dirname.c_str(), key.c_str());
+            auto file = cache->addFile(Metadata(key, fileInfo.size()), filepath);
+            file->_modified = fileInfo.lastRead().toMSecsSinceEpoch();
+            file->_verified = true;
+        }
+    }
+}
+
 std::unique_ptr<File> FileCache::createFile(Metadata&& metadata, const std::string& filepath) {
     return std::unique_ptr<File>(new cache::File(std::move(metadata), filepath));
 }
@@ -173,6 +407,8 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
         && saveFile.commit()) {
 
         file = addFile(std::move(metadata), filepath);
+        file->_verified = true;
+        appendIndexRecord(IndexRecord::Add, *file);
     } else {
         qCWarning(file_cache, "[%s] Failed to write %s", _dirname.c_str(), metadata.key.c_str());
     }
@@ -194,8 +430,19 @@ FilePointer FileCache::getFile(const Key& key) {
     const auto it = _files.find(key);
     if (it != _files.cend()) {
         file = it->second.lock();
+        if (file && !file->_verified) {
+            // the index may have outlived the file
+            if (QFileInfo::exists(file->getFilepath().c_str())) {
+                file->_verified = true;
+            } else {
+                qCDebug(file_cache, "[%s] Ejecting missing %s", _dirname.c_str(), key.c_str());
+                eject(file);
+                return FilePointer();
+            }
+        }
         if (file) {
             file->touch();
+            appendIndexRecord(IndexRecord::Access, *file);
             // if it exists, it is active - remove it from the cache
             if (_unusedFiles.erase(file)) {
                 assert(!file->_locked);
@@ -230,6 +477,7 @@ void FileCache::addUnusedFile(const FilePointer& file) {
     _unusedFiles.insert(file);
     _numUnusedFiles += 1;
     _unusedFilesSize += file->getLength();
+    appendIndexRecord(IndexRecord::Add, *file);
     clean();
 
     emit dirty();
@@ -267,6 +515,7 @@ void FileCache::eject(FilePointer file) {
     if (0 != _files.erase(key)) {
         _numTotalFiles -= 1;
         _totalFilesSize -= length;
+        appendIndexRecord(IndexRecord::Remove, *file);
     }
     if (0 != _unusedFiles.erase(file)) {
         _numUnusedFiles -= 1;
@@ -345,7 +594,7 @@ File::File(Metadata&& metadata, const std::string& filepath) :
     _key(std::move(metadata.key)),
     _length(metadata.length),
     _filepath(filepath),
-    _modified(QFileInfo(_filepath.c_str()).lastRead().toMSecsSinceEpoch()) {
+    _modified(QDateTime::currentMSecsSinceEpoch()) {
 }
 
 File::~File() {
@@ -357,7 +606,8 @@ File::~File() {
 }
 
 void File::touch() {
+    // the access time is kept in the index, the file's is for when there is no index to go on
     utime(_filepath.c_str(), nullptr);
-    _modified = std::max<int64_t>(QFileInfo(_filepath.c_str()).lastRead().toMSecsSinceEpoch(), _modified);
+    _modified = std::max<int64_t>(QDateTime::currentMSecsSinceEpoch(), _modified);
 }
 
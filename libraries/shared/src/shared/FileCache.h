@@ -17,10 +17,13 @@
 #include <unordered_set>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <QObject>
 #include <QLoggingCategory>
+#include <QtCore/QFile>
 
 Q_DECLARE_LOGGING_CATEGORY(file_cache)
 
@@ -113,6 +116,15 @@ private:
 
     std::string getFilepath(const Key& key);
 
+    // The files in the cache are kept in an index on disk, a snapshot of them and a journal of what happened to them
+    // since, so that it doesn't have to look through the directory and every file in it on startup
+    enum class IndexRecord : uint8_t { Add, Access, Remove };
+    bool readIndex(std::vector<Key>& keys);
+    bool writeIndex();
+    void appendIndexRecord(IndexRecord type, const File& file);
+    // makes the index agree with the directory once it has been loaded from the index
+    static void reconcileIndex(FileCacheWeakPointer weakCache, std::vector<Key> indexedKeys);
+
     FilePointer addFile(Metadata&& metadata, const std::string& filepath);
     void addUnusedFile(const FilePointer& file);
     void releaseFile(File* file);
@@ -137,6 +149,10 @@ private:
     const std::string _dirpath;
     bool _initialized { false };
 
+    QFile _indexJournal;
+    size_t _indexJournalCount { 0 };
+    std::thread _reconcileThread;
+
     Mutex _mutex;
     Map _files;
     Set _unusedFiles;
@@ -172,6 +188,7 @@ private:
     FileCacheWeakPointer _parent;
     int64_t _modified { 0 };
     bool _locked { false };
+    bool _verified { false }; // if it has been seen in the directory since the cache started
 
     bool _shouldPersist { false };
 };
@@ -0,0 +1,114 @@
+//
+//  MPSCRingBuffer.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MPSCRingBuffer_h
+#define hifi_MPSCRingBuffer_h
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+// Bounded queue that any number of threads can push onto while a single thread pops, without taking a lock.
+//
+// Each slot carries a sequence number that says whose turn it is: producers claim a position by advancing the tail,
+// fill the slot and then publish it by bumping the slot's sequence, and the consumer hands the slot back for the next
+// lap around the ring by bumping it again once it has taken the value out.
+template <typename T>
+class MPSCRingBuffer {
+public:
+    // capacity must be a power of two
+    MPSCRingBuffer(size_t capacity = DEFAULT_CAPACITY);
+
+    MPSCRingBuffer(const MPSCRingBuffer&) = delete;
+    MPSCRingBuffer& operator=(const MPSCRingBuffer&) = delete;
+
+    size_t capacity() const { return _mask + 1; }
+
+    // returns false, leaving value untouched, if the buffer is full
+    bool push(T value);
+
+    // only call these from the consuming thread
+    bool pop(T& value);
+    bool empty() const;
+
+    static const size_t DEFAULT_CAPACITY = 64;
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _mask;
+
+    std::atomic<size_t> _tail { 0 }; // next position to push to
+    size_t _head { 0 }; // next position to pop from, only touched by the consumer
+};
+
+template <typename T>
+const size_t MPSCRingBuffer<T>::DEFAULT_CAPACITY;
+
+template <typename T>
+MPSCRingBuffer<T>::MPSCRingBuffer(size_t capacity) : _slots(new Slot[capacity]), _mask(capacity - 1) {
+    assert(capacity > 0 && (capacity & _mask) == 0);
+    for (size_t i = 0; i < capacity; ++i) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool MPSCRingBuffer<T>::push(T value) {
+    size_t position = _tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &_slots[position & _mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+        if (difference == 0) {
+            // the slot is free for this lap, claim it
+            if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // the consumer hasn't taken the value from the last lap yet
+            return false;
+        } else {
+            // another producer claimed this position first
+            position = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->value = std::move(value);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool MPSCRingBuffer<T>::pop(T& value) {
+    Slot& slot = _slots[_head & _mask];
+    if (slot.sequence.load(std::memory_order_acquire) != _head + 1) {
+        return false;
+    }
+
+    value = std::move(slot.value);
+    slot.value = T();
+    slot.sequence.store(_head + _mask + 1, std::memory_order_release);
+    ++_head;
+    return true;
+}
+
+template <typename T>
+bool MPSCRingBuffer<T>::empty() const {
+    return _slots[_head & _mask].sequence.load(std::memory_order_acquire) != _head + 1;
+}
+
+#endif // hifi_MPSCRingBuffer_h
@@ -0,0 +1,130 @@
+//
+//  Metrics.cpp
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Metrics.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+
+using namespace metrics;
+
+Histogram::Histogram(const std::vector<double>& upperBounds) :
+    _upperBounds(upperBounds),
+    _buckets(new std::atomic<uint64_t>[upperBounds.size() + 1]) {
+    for (size_t i = 0; i <= _upperBounds.size(); ++i) {
+        _buckets[i] = 0;
+    }
+}
+
+void Histogram::observe(double value) {
+    size_t bucket = std::lower_bound(_upperBounds.begin(), _upperBounds.end(), value) - _upperBounds.begin();
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+
+    double sum = _sum.load(std::memory_order_relaxed);
+    while (!_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+const std::vector<double>& metrics::timingBucketsUsecs() {
+    static const std::vector<double> BUCKETS {
+        50.0, 100.0, 250.0, 500.0, 1000.0, 2500.0, 5000.0, 10000.0, 25000.0, 50000.0, 100000.0, 250000.0, 1000000.0
+    };
+    return BUCKETS;
+}
+
+Registry& Registry::getInstance() {
+    static Registry instance;
+    return instance;
+}
+
+Registry::Family& Registry::family(const QString& name, const QString& help, Type type) {
+    auto it = _families.find(name);
+    if (it == _families.end()) {
+        it = _families.emplace(name, Family()).first;
+        it->second.type = type;
+        it->second.help = help;
+    } else if (it->second.type != type) {
+        qWarning() << "Metric" << name << "is registered with two different types";
+    }
+    return it->second;
+}
+
+Counter& Registry::counter(const QString& name, const QString& help, const QString& labels) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& metric = family(name, help, Type::Counter).counters[labels];
+    if (!metric) {
+        metric.reset(new Counter());
+    }
+    return *metric;
+}
+
+Gauge& Registry::gauge(const QString& name, const QString& help, const QString& labels) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& metric = family(name, help, Type::Gauge).gauges[labels];
+    if (!metric) {
+        metric.reset(new Gauge());
+    }
+    return *metric;
+}
+
+Histogram& Registry::histogram(const QString& name, const QString& help, const std::vector<double>& upperBounds,
+                               const QString& labels) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& metric = family(name, help, Type::Histogram).histograms[labels];
+    if (!metric) {
+        metric.reset(new Histogram(upperBounds));
+    }
+    return *metric;
+}
+
+static QByteArray labelSet(const QString& labels, const QString& extraLabel = QString()) {
+    QString joined = labels;
+    if (!extraLabel.isEmpty()) {
+        joined = joined.isEmpty() ? extraLabel : joined + "," + extraLabel;
+    }
+    return joined.isEmpty() ? QByteArray() : ("{" + joined + "}").toUtf8();
+}
+
+QByteArray Registry::toOpenMetrics() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    QByteArray text;
+    for (const auto& namedFamily : _families) {
+        QByteArray name = namedFamily.first.toUtf8();
+        const auto& family = namedFamily.second;
+
+        static const char* TYPE_NAMES[] = { "counter", "gauge", "histogram" };
+        text += "# TYPE " + name + " " + TYPE_NAMES[(int)family.type] + "\n";
+        text += "# HELP " + name + " " + family.help.toUtf8() + "\n";
+
+        for (const auto& counter : family.counters) {
+            text += name + "_total" + labelSet(counter.first) + " " + QByteArray::number((qulonglong)counter.second->get()) + "\n";
+        }
+        for (const auto& gauge : family.gauges) {
+            text += name + labelSet(gauge.first) + " " + QByteArray::number(gauge.second->get()) + "\n";
+        }
+        for (const auto& histogram : family.histograms) {
+            const auto& bounds = histogram.second->getUpperBounds();
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i <= bounds.size(); ++i) {
+                cumulative += histogram.second->getBucketCount(i);
+                QString bound = (i < bounds.size()) ? QString::number(bounds[i]) : QString("+Inf");
+                text += name + "_bucket" + labelSet(histogram.first, "le=\"" + bound + "\"") + " "
+                    + QByteArray::number((qulonglong)cumulative) + "\n";
+            }
+            text += name + "_count" + labelSet(histogram.first) + " " + QByteArray::number((qulonglong)cumulative) + "\n";
+            text += name + "_sum" + labelSet(histogram.first) + " " + QByteArray::number(histogram.second->getSum()) + "\n";
+        }
+    }
+    text += "# EOF\n";
+    return text;
+}
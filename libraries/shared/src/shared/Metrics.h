@@ -0,0 +1,100 @@
+//
+//  Metrics.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Shared_Metrics_h
+#define hifi_Shared_Metrics_h
+
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+// A process wide registry of counters, gauges and histograms, exported in the OpenMetrics text format.
+// Looking a metric up takes a lock, so hot paths look it up once and keep the reference; updating it is lock free.
+namespace metrics {
+
+class Counter {
+public:
+    void increment(uint64_t amount = 1) { _value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value { 0 };
+};
+
+class Gauge {
+public:
+    void set(double value) { _value.store(value, std::memory_order_relaxed); }
+    double get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> _value { 0.0 };
+};
+
+// counts the observations in buckets of ascending upper bounds, the last bucket (+Inf) is implied
+class Histogram {
+public:
+    Histogram(const std::vector<double>& upperBounds);
+
+    void observe(double value);
+
+    const std::vector<double>& getUpperBounds() const { return _upperBounds; }
+    uint64_t getBucketCount(size_t bucket) const { return _buckets[bucket].load(std::memory_order_relaxed); }
+    uint64_t getCount() const { return _count.load(std::memory_order_relaxed); }
+    double getSum() const { return _sum.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<double> _upperBounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> _buckets; // not cumulative, one more than the bounds
+    std::atomic<uint64_t> _count { 0 };
+    std::atomic<double> _sum { 0.0 };
+};
+
+// the upper bounds of a timing in microseconds, from 50us to 1s
+const std::vector<double>& timingBucketsUsecs();
+
+class Registry {
+public:
+    static Registry& getInstance();
+
+    // labels are written as they go between the braces, for instance: slave="0"
+    Counter& counter(const QString& name, const QString& help, const QString& labels = QString());
+    Gauge& gauge(const QString& name, const QString& help, const QString& labels = QString());
+    Histogram& histogram(const QString& name, const QString& help, const std::vector<double>& upperBounds,
+                         const QString& labels = QString());
+
+    QByteArray toOpenMetrics() const;
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Family {
+        Type type;
+        QString help;
+        std::map<QString, std::unique_ptr<Counter>> counters;
+        std::map<QString, std::unique_ptr<Gauge>> gauges;
+        std::map<QString, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const QString& name, const QString& help, Type type);
+
+    mutable std::mutex _mutex;
+    std::map<QString, Family> _families;
+};
+
+}
+
+#endif // hifi_Shared_Metrics_h
@@ -0,0 +1,72 @@
+//
+//  PoolAllocator.cpp
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PoolAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+BlockPool::BlockPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab) :
+    // every block is big enough to link it while it's free, and is aligned from the start of its slab
+    _blockSize(((std::max(blockSize, sizeof(FreeBlock)) + blockAlignment - 1) / blockAlignment) * blockAlignment),
+    _blocksPerSlab(std::max(blocksPerSlab, (size_t)1))
+{
+    assert(blockAlignment > 0 && blockAlignment <= alignof(std::max_align_t));
+}
+
+BlockPool::~BlockPool() {
+    for (auto slab : _slabs) {
+        ::operator delete(slab);
+    }
+}
+
+void BlockPool::addSlab() {
+    auto slab = static_cast<char*>(::operator new(_blockSize * _blocksPerSlab));
+    _slabs.push_back(slab);
+
+    // link the blocks in the order of their addresses, so that the ones made one after another are adjacent
+    for (size_t i = _blocksPerSlab; i > 0; --i) {
+        auto block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * _blockSize);
+        block->next = _freeBlocks;
+        _freeBlocks = block;
+    }
+}
+
+void* BlockPool::allocate() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_freeBlocks) {
+        addSlab();
+    }
+    auto block = _freeBlocks;
+    _freeBlocks = block->next;
+    ++_allocatedCount;
+    return block;
+}
+
+void BlockPool::deallocate(void* block) {
+    if (!block) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = _freeBlocks;
+    _freeBlocks = freeBlock;
+    --_allocatedCount;
+}
+
+size_t BlockPool::getAllocatedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _allocatedCount;
+}
+
+size_t BlockPool::getCapacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _slabs.size() * _blocksPerSlab;
+}
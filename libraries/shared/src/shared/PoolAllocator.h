@@ -0,0 +1,114 @@
+//
+//  PoolAllocator.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PoolAllocator_h
+#define hifi_PoolAllocator_h
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Blocks of one size carved out of slabs of many, so that objects made and destroyed by the million are next to each
+// other in memory and don't each cost a trip to the heap and its bookkeeping.
+//
+// The freed blocks are kept for the next ones to be made, the slabs are only given back when the pool goes away.
+class BlockPool {
+public:
+    BlockPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab);
+    ~BlockPool();
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    void* allocate();
+    void deallocate(void* block);
+
+    size_t getBlockSize() const { return _blockSize; }
+    size_t getAllocatedCount() const;
+    size_t getCapacity() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void addSlab();
+
+    const size_t _blockSize;
+    const size_t _blocksPerSlab;
+
+    mutable std::mutex _mutex;
+    FreeBlock* _freeBlocks { nullptr };
+    std::vector<char*> _slabs;
+    size_t _allocatedCount { 0 };
+};
+
+// A standard allocator of single objects from a BlockPool for their type, mostly for std::allocate_shared, which
+// rebinds it to a type that has the shared pointer control block and the object together. Arrays go to the heap.
+//
+// The pool of a type is never destroyed, since objects can outlive the statics of the process. Each module that
+// allocates a type has a pool of its own for it, and the blocks are freed by the code that made them.
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    static const size_t BLOCKS_PER_SLAB = 1024;
+
+    PoolAllocator() {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        if (count == 1) {
+            return static_cast<T*>(getPool().allocate());
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        if (count == 1) {
+            getPool().deallocate(pointer);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    // a type that keeps its constructor to itself can make this allocator a friend to be made through it
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args) {
+        ::new((void*)pointer) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* pointer) {
+        pointer->~U();
+    }
+
+    static BlockPool& getPool() {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "the blocks of a pool are only aligned like the heap");
+        static BlockPool* pool = new BlockPool(sizeof(T), alignof(T), BLOCKS_PER_SLAB);
+        return *pool;
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return false;
+}
+
+#endif // hifi_PoolAllocator_h
@@ -12,6 +12,11 @@
 #include <QtCore/QDebug>
 #include <QtCore/QLoggingCategory>
 
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 Q_LOGGING_CATEGORY(storagelogging, "hifi.core.storage")
 
 using namespace storage;
@@ -98,4 +103,35 @@ FileStorage::~FileStorage() {
     if (_file.isOpen()) {
         _file.close();
     }
-}
\ No newline at end of file
+}
+
+void FileStorage::adviseRange(Residency residency, const uint8_t* data, size_t size) const {
+#if defined(Q_OS_UNIX)
+    if (!_mapped || size == 0) {
+        return;
+    }
+
+    static const uintptr_t MAPPED_PAGE_SIZE = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t begin = (uintptr_t)data;
+    uintptr_t end = begin + size;
+
+    if (residency == Residency::Needed) {
+        begin -= begin % MAPPED_PAGE_SIZE;
+        madvise((void*)begin, end - begin, MADV_WILLNEED);
+
+        // the read ahead is asynchronous, touching every page makes sure they are in when this returns
+        volatile uint8_t sum = 0;
+        for (const uint8_t* page = data; page < data + size; page += MAPPED_PAGE_SIZE) {
+            sum += *page;
+        }
+        sum += data[size - 1];
+    } else {
+        // the pages at either end can be shared with the neighbouring data, only the pages entirely within are let go
+        begin += (MAPPED_PAGE_SIZE - begin % MAPPED_PAGE_SIZE) % MAPPED_PAGE_SIZE;
+        end -= end % MAPPED_PAGE_SIZE;
+        if (begin < end) {
+            madvise((void*)begin, end - begin, MADV_DONTNEED);
+        }
+    }
+#endif
+}
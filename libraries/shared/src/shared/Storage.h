@@ -20,6 +20,12 @@ namespace storage {
     class Storage;
     using StoragePointer = std::shared_ptr<const Storage>;
 
+    // Whether the bytes of a storage are about to be read, for storage that pages them in from a file
+    enum class Residency : uint8_t {
+        Needed,     // read the pages in now, rather than on first access
+        NotNeeded   // the pages can leave memory, they are read from the file again if need be
+    };
+
     // Abstract class to represent memory that stored _somewhere_ (in system memory or in a file, for example)
     class Storage : public std::enable_shared_from_this<Storage> {
     public:
@@ -33,6 +39,10 @@ namespace storage {
         StoragePointer toFileStorage(const QString& filename) const;
         StoragePointer toMemoryStorage() const;
 
+        void advise(Residency residency) const { adviseRange(residency, data(), size()); }
+        // a no-op unless the storage is a mapped file, or a view of one
+        virtual void adviseRange(Residency residency, const uint8_t* data, size_t size) const {}
+
         // Aliases to prevent having to re-write a ton of code
         inline size_t getSize() const { return size(); }
         inline const uint8_t* readData() const { return data(); }
@@ -63,6 +73,7 @@ namespace storage {
         uint8_t* mutableData() override { return _hasWriteAccess ? _mapped : nullptr; }
         size_t size() const override { return _file.size(); }
         operator bool() const override { return _valid; }
+        void adviseRange(Residency residency, const uint8_t* data, size_t size) const override;
     private:
 
         bool _valid { false };
@@ -78,6 +89,9 @@ namespace storage {
         uint8_t* mutableData() override { throw std::runtime_error("Cannot modify ViewStorage");  }
         size_t size() const override { return _size; }
         operator bool() const override { return *_owner; }
+        void adviseRange(Residency residency, const uint8_t* data, size_t size) const override {
+            _owner->adviseRange(residency, data, size);
+        }
     private:
         const storage::StoragePointer _owner;
         const size_t _size;
@@ -0,0 +1,114 @@
+//
+//  TimerWheel.cpp
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+void TimerWheel::insert(TimerID id, uint64_t deadline) {
+    Entry entry { id, deadline };
+    if (deadline <= _now) {
+        _expired.push_back(entry);
+    } else {
+        place(entry);
+    }
+}
+
+void TimerWheel::place(const Entry& entry) {
+    // The level is the lowest one whose lap covers the remaining ticks; the slot is picked from the bits of the
+    // deadline so that it is reached on the tick the deadline falls in at the granularity of the level.
+    uint64_t delta = entry.deadline > _now ? entry.deadline - _now : 0;
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        int shift = level * SLOT_BITS;
+        if ((delta >> (shift + SLOT_BITS)) == 0) {
+            _slots[level][(entry.deadline >> shift) & SLOT_MASK].push_back(entry);
+            _levelSizes[level]++;
+            _size++;
+            return;
+        }
+    }
+    _overflow.push_back(entry);
+    _size++;
+}
+
+void TimerWheel::cascade(int level) {
+    int index = (int)((_now >> (level * SLOT_BITS)) & SLOT_MASK);
+    if (index == 0) {
+        // the level above wraps too, its slot goes down first
+        if (level + 1 < NUM_LEVELS) {
+            cascade(level + 1);
+        } else if (!_overflow.empty()) {
+            Slot overflow;
+            overflow.swap(_overflow);
+            _size -= overflow.size();
+            for (const auto& entry : overflow) {
+                place(entry);
+            }
+        }
+    }
+
+    Slot slot;
+    slot.swap(_slots[level][index]);
+    _levelSizes[level] -= slot.size();
+    _size -= slot.size();
+    for (const auto& entry : slot) {
+        place(entry);
+    }
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<TimerID>& dueTimers) {
+    for (const auto& entry : _expired) {
+        dueTimers.push_back(entry.id);
+    }
+    _expired.clear();
+
+    while (_now < now && _size > 0) {
+        // Nothing happens before the next lap of the lowest level that has timers, skip to the tick before it
+        int level = 0;
+        while (level < NUM_LEVELS && _levelSizes[level] == 0) {
+            level++;
+        }
+        if (level > 0) {
+            uint64_t lapMask = (1ULL << (level * SLOT_BITS)) - 1;
+            _now = std::min(now - 1, _now | lapMask);
+        }
+
+        _now++;
+        if ((_now & SLOT_MASK) == 0) {
+            cascade(1);
+        }
+
+        Slot& slot = _slots[0][_now & SLOT_MASK];
+        for (const auto& entry : slot) {
+            dueTimers.push_back(entry.id);
+        }
+        _levelSizes[0] -= slot.size();
+        _size -= slot.size();
+        slot.clear();
+    }
+    _now = std::max(_now, now);
+}
+
+uint64_t TimerWheel::getNextDeadline() const {
+    if (!_expired.empty()) {
+        return _now;
+    }
+    if (_size == 0) {
+        return NO_DEADLINE;
+    }
+
+    // Only the first level is tick accurate, the timers of the levels above come due at the earliest when it wraps
+    for (uint64_t tick = _now + 1; (tick & SLOT_MASK) != 0; tick++) {
+        if (!_slots[0][tick & SLOT_MASK].empty()) {
+            return tick;
+        }
+    }
+    return (_now | SLOT_MASK) + 1;
+}
@@ -0,0 +1,69 @@
+//
+//  TimerWheel.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheel_h
+#define hifi_TimerWheel_h
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Hierarchical timing wheel, keeps the deadlines of any number of timers in constant time per insertion
+// instead of a system timer each.
+//
+// Time is counted in ticks. The first level has a slot per tick for the next 256 ticks, each further level has a slot
+// per lap of the level below, and the timers of a slot are cascaded down a level when the time reaches it.
+// Timers can't be removed, the owner drops the ids it doesn't know anymore when they come due.
+class TimerWheel {
+public:
+    using TimerID = uint32_t;
+
+    static const uint64_t NO_DEADLINE = std::numeric_limits<uint64_t>::max();
+
+    TimerWheel(uint64_t now = 0) : _now(now) {}
+
+    // Timers with a deadline at or before the current tick are due on the next advance
+    void insert(TimerID id, uint64_t deadline);
+
+    // Moves the time forward to now, appending the ids of the timers that are due in the order of their deadlines
+    void advance(uint64_t now, std::vector<TimerID>& dueTimers);
+
+    // The tick to advance to next, at or before which no timer is due, or NO_DEADLINE when the wheel is empty
+    uint64_t getNextDeadline() const;
+
+    uint64_t getNow() const { return _now; }
+    size_t size() const { return _size + _expired.size(); }
+    bool isEmpty() const { return size() == 0; }
+
+private:
+    static const int SLOT_BITS = 8;
+    static const int NUM_SLOTS = 1 << SLOT_BITS;
+    static const uint64_t SLOT_MASK = NUM_SLOTS - 1;
+    static const int NUM_LEVELS = 4;
+
+    struct Entry {
+        TimerID id;
+        uint64_t deadline;
+    };
+    using Slot = std::vector<Entry>;
+
+    void place(const Entry& entry);
+    void cascade(int level);
+
+    Slot _slots[NUM_LEVELS][NUM_SLOTS];
+    size_t _levelSizes[NUM_LEVELS] {};
+    Slot _overflow; // beyond the reach of the last level
+    Slot _expired; // inserted at or before the current tick
+    uint64_t _now;
+    size_t _size { 0 }; // in the slots and the overflow
+};
+
+#endif // hifi_TimerWheel_h
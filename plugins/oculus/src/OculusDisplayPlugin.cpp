@@ -164,8 +164,9 @@ void OculusDisplayPlugin::hmdPresent() {
         auto result = ovr_CommitTextureSwapChain(_session, _textureSwapChain);
         Q_ASSERT(OVR_SUCCESS(result));
         _sceneLayer.SensorSampleTime = _currentPresentFrameInfo.sensorSampleTime;
-        _sceneLayer.RenderPose[ovrEyeType::ovrEye_Left] = ovrPoseFromGlm(_currentPresentFrameInfo.renderPose);
-        _sceneLayer.RenderPose[ovrEyeType::ovrEye_Right] = ovrPoseFromGlm(_currentPresentFrameInfo.renderPose);
+        // the scene was rendered with the pose latched on the present thread, the compositor warps from there
+        _sceneLayer.RenderPose[ovrEyeType::ovrEye_Left] = ovrPoseFromGlm(_currentPresentFrameInfo.presentPose);
+        _sceneLayer.RenderPose[ovrEyeType::ovrEye_Right] = ovrPoseFromGlm(_currentPresentFrameInfo.presentPose);
 
         auto submitStart = usecTimestampNow();
         uint64_t nonSubmitInterval = 0;
@@ -223,7 +224,7 @@ void OculusDisplayPlugin::hmdPresent() {
 
 
 QJsonObject OculusDisplayPlugin::getHardwareStats() const {
-    QJsonObject hardwareStats;
+    QJsonObject hardwareStats = Parent::getHardwareStats();
     hardwareStats["asw_active"] = _aswActive.load();
     hardwareStats["app_dropped_frame_count"] = _appDroppedFrames.load();
     hardwareStats["compositor_dropped_frame_count"] = _compositorDroppedFrames.load();
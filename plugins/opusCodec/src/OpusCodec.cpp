@@ -0,0 +1,166 @@
+//
+//  OpusCodec.cpp
+//  plugins/opusCodec/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QDebug>
+
+#include <opus/opus.h>
+
+#include <AudioConstants.h>
+
+#include "OpusCodec.h"
+
+const char* OpusCodec::NAME { "opus" };
+
+// about a third of the HiFi codec, which is good enough for voice
+static const int BITRATE_PER_CHANNEL = 32000;
+static const int COMPLEXITY = 5;
+// the loss the redundancy for the previous frame is sized for, in percent
+static const int EXPECTED_PACKET_LOSS = 10;
+// the largest packet a single Opus frame can take
+static const int MAX_ENCODED_SIZE = 1275;
+
+void OpusCodec::init() {
+}
+
+void OpusCodec::deinit() {
+}
+
+bool OpusCodec::activate() {
+    CodecPlugin::activate();
+    return true;
+}
+
+void OpusCodec::deactivate() {
+    CodecPlugin::deactivate();
+}
+
+bool OpusCodec::isSupported() const {
+    return true;
+}
+
+class OpusCodecEncoder : public Encoder {
+public:
+    OpusCodecEncoder(int sampleRate, int numChannels) {
+        int error;
+        _encoder = opus_encoder_create(sampleRate, numChannels, OPUS_APPLICATION_VOIP, &error);
+        if (error != OPUS_OK) {
+            qWarning() << "Could not create the Opus encoder:" << opus_strerror(error);
+            _encoder = nullptr;
+            return;
+        }
+
+        opus_encoder_ctl(_encoder, OPUS_SET_BITRATE(BITRATE_PER_CHANNEL * numChannels));
+        opus_encoder_ctl(_encoder, OPUS_SET_VBR(1));
+        opus_encoder_ctl(_encoder, OPUS_SET_COMPLEXITY(COMPLEXITY));
+        opus_encoder_ctl(_encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+        opus_encoder_ctl(_encoder, OPUS_SET_INBAND_FEC(1));
+        opus_encoder_ctl(_encoder, OPUS_SET_PACKET_LOSS_PERC(EXPECTED_PACKET_LOSS));
+        opus_encoder_ctl(_encoder, OPUS_SET_DTX(1));
+    }
+
+    virtual ~OpusCodecEncoder() {
+        if (_encoder) {
+            opus_encoder_destroy(_encoder);
+        }
+    }
+
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
+        encodedBuffer.resize(MAX_ENCODED_SIZE);
+        int encodedSize = -1;
+        if (_encoder) {
+            encodedSize = opus_encode(_encoder, (const opus_int16*)decodedBuffer.constData(),
+                                      AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL,
+                                      (unsigned char*)encodedBuffer.data(), MAX_ENCODED_SIZE);
+        }
+        if (encodedSize < 0) {
+            // the decoders conceal the missing frame
+            encodedBuffer.clear();
+            return;
+        }
+        encodedBuffer.resize(encodedSize);
+    }
+
+private:
+    OpusEncoder* _encoder { nullptr };
+};
+
+class OpusCodecDecoder : public Decoder {
+public:
+    OpusCodecDecoder(int sampleRate, int numChannels) : _numChannels(numChannels) {
+        _decodedSize = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * sizeof(int16_t) * numChannels;
+
+        int error;
+        _decoder = opus_decoder_create(sampleRate, numChannels, &error);
+        if (error != OPUS_OK) {
+            qWarning() << "Could not create the Opus decoder:" << opus_strerror(error);
+            _decoder = nullptr;
+        }
+    }
+
+    virtual ~OpusCodecDecoder() {
+        if (_decoder) {
+            opus_decoder_destroy(_decoder);
+        }
+    }
+
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        decodeFrame(encodedBuffer.isEmpty() ? nullptr : &encodedBuffer, false, decodedBuffer);
+    }
+
+    virtual void lostFrame(QByteArray& decodedBuffer) override {
+        // this performs packet loss concealment
+        decodeFrame(nullptr, false, decodedBuffer);
+    }
+
+    virtual void recoverFrame(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        // decodes the redundancy for the previous frame, the decoder conceals it when there is none
+        decodeFrame(encodedBuffer.isEmpty() ? nullptr : &encodedBuffer, true, decodedBuffer);
+    }
+
+private:
+    void decodeFrame(const QByteArray* encodedBuffer, bool decodeRedundancy, QByteArray& decodedBuffer) {
+        decodedBuffer.resize(_decodedSize);
+        int decodedSamples = -1;
+        if (_decoder) {
+            decodedSamples = opus_decode(_decoder,
+                                         encodedBuffer ? (const unsigned char*)encodedBuffer->constData() : nullptr,
+                                         encodedBuffer ? encodedBuffer->size() : 0,
+                                         (opus_int16*)decodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL,
+                                         decodeRedundancy ? 1 : 0);
+        }
+        if (decodedSamples < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL) {
+            int decodedBytes = std::max(decodedSamples, 0) * (int)sizeof(int16_t) * _numChannels;
+            memset(decodedBuffer.data() + decodedBytes, 0, _decodedSize - decodedBytes);
+        }
+    }
+
+    OpusDecoder* _decoder { nullptr };
+    int _numChannels;
+    int _decodedSize;
+};
+
+Encoder* OpusCodec::createEncoder(int sampleRate, int numChannels) {
+    return new OpusCodecEncoder(sampleRate, numChannels);
+}
+
+Decoder* OpusCodec::createDecoder(int sampleRate, int numChannels) {
+    return new OpusCodecDecoder(sampleRate, numChannels);
+}
+
+void OpusCodec::releaseEncoder(Encoder* encoder) {
+    delete encoder;
+}
+
+void OpusCodec::releaseDecoder(Decoder* decoder) {
+    delete decoder;
+}
@@ -0,0 +1,44 @@
+//
+//  OpusCodec.h
+//  plugins/opusCodec/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OpusCodec_h
+#define hifi_OpusCodec_h
+
+#include <plugins/CodecPlugin.h>
+
+// Variable bitrate Opus, tuned for voice. Each frame carries a low bitrate copy of the previous one
+// for the decoders to recover a single lost frame, silence is sent as a few bytes a frame,
+// and the other losses are concealed by the decoder.
+class OpusCodec : public CodecPlugin {
+    Q_OBJECT
+
+public:
+    // Plugin functions
+    bool isSupported() const override;
+    const QString getName() const override { return NAME; }
+
+    void init() override;
+    void deinit() override;
+
+    /// Called when a plugin is being activated for use.  May be called multiple times.
+    bool activate() override;
+    /// Called when a plugin is no longer being used.  May be called multiple times.
+    void deactivate() override;
+
+    virtual Encoder* createEncoder(int sampleRate, int numChannels) override;
+    virtual Decoder* createDecoder(int sampleRate, int numChannels) override;
+    virtual void releaseEncoder(Encoder* encoder) override;
+    virtual void releaseDecoder(Decoder* decoder) override;
+
+private:
+    static const char* NAME;
+};
+
+#endif // hifi_OpusCodec_h
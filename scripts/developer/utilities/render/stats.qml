@@ -97,6 +97,47 @@ Item {
             ]
         }
 
+        PlotPerf {
+            title: "Redundant State Changes"
+            height: parent.evalEvenHeight()
+            object: stats.config
+            plots: [
+                {
+                    prop: "frameRedundantBindCount",
+                    label: "Bindings",
+                    color: "#00B4EF"
+                },
+                {
+                    prop: "frameRedundantPipelineCount",
+                    label: "Pipelines",
+                    color: "#E2334D"
+                },
+                {
+                    prop: "frameRedundantInputCount",
+                    label: "Inputs",
+                    color: "#1AC567"
+                }
+            ]
+        }
+
+        PlotPerf {
+            title: "Batches"
+            height: parent.evalEvenHeight()
+            object: stats.config
+            plots: [
+                {
+                    prop: "frameBatchAllocationCount",
+                    label: "Allocated",
+                    color: "#E2334D"
+                },
+                {
+                    prop: "frameBatchReuseCount",
+                    label: "Reused",
+                    color: "#1AC567"
+                }
+            ]
+        }
+
         property var drawOpaqueConfig: Render.getConfig("RenderMainView.DrawOpaqueDeferred")
         property var drawTransparentConfig: Render.getConfig("RenderMainView.DrawTransparentDeferred")
         property var drawLightConfig: Render.getConfig("RenderMainView.DrawLight")
@@ -8,6 +8,9 @@
 //
 
 #include "AnimTests.h"
+
+#include <glm/gtx/transform.hpp>
+
 #include <AnimNodeLoader.h>
 #include <AnimClip.h>
 #include <AnimBlendLinear.h>
@@ -15,6 +18,8 @@
 #include <AnimVariant.h>
 #include <AnimExpression.h>
 #include <AnimUtil.h>
+#include <AnimSkeleton.h>
+#include <AnimCompressedFrames.h>
 
 #include <../QTestExtensions.h>
 
@@ -422,6 +427,131 @@ void AnimTests::testAnimPose() {
     }
 }
 
+void AnimTests::testAnimPoseProduct() {
+    const float PI = (float)M_PI;
+    std::vector<AnimPose> poses = {
+        AnimPose::identity,
+        AnimPose(glm::vec3(2.0f), glm::angleAxis(PI / 2.0f, glm::vec3(1.0f, 0.0f, 0.0f)), glm::vec3(10.0f, 0.0f, 0.0f)),
+        AnimPose(glm::vec3(0.5f), glm::angleAxis(PI / 3.0f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f))), glm::vec3(-1.0f, 5.0f, 7.5f)),
+        AnimPose(glm::vec3(1.0f, 0.5f, 1.5f), glm::angleAxis(PI / 6.0f, glm::vec3(0.0f, 0.0f, 1.0f)), glm::vec3(0.0f, -5.0f, 2.0f)),
+        AnimPose(glm::vec3(-1.0f, 1.0f, 1.0f), glm::angleAxis(PI, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(3.0f, 0.0f, 1.0f))
+    };
+
+    // uniformly scaled poses compose directly, the others through matrices, both have to agree with matrices
+    for (auto& a : poses) {
+        for (auto& b : poses) {
+            glm::mat4 rawMat = (glm::mat4)a * (glm::mat4)b;
+            glm::mat4 poseMat = a * b;
+            QCOMPARE_WITH_ABS_ERROR(rawMat, poseMat, EPSILON);
+        }
+        glm::mat4 rawInverseMat = glm::inverse((glm::mat4)a);
+        glm::mat4 poseInverseMat = a.inverse();
+        QCOMPARE_WITH_ABS_ERROR(rawInverseMat, poseInverseMat, EPSILON);
+    }
+}
+
+void AnimTests::testBlend() {
+    const float PI = (float)M_PI;
+    AnimPose a(glm::vec3(1.0f), glm::angleAxis(PI / 4.0f, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(1.0f, 0.0f, 0.0f));
+    AnimPose b(glm::vec3(2.0f), -glm::angleAxis(-PI / 2.0f, glm::vec3(1.0f, 0.0f, 0.0f)), glm::vec3(0.0f, 2.0f, 0.0f));
+
+    for (float alpha : { 0.0f, 0.25f, 0.5f, 1.0f }) {
+        AnimPose result;
+        ::blend(1, &a, &b, alpha, &result);
+
+        QVERIFY(glm::distance(result.scale(), glm::mix(a.scale(), b.scale(), alpha)) < EPSILON);
+        QVERIFY(glm::distance(result.trans(), glm::mix(a.trans(), b.trans(), alpha)) < EPSILON);
+        glm::quat expectedRot = safeLerp(a.rot(), b.rot(), alpha);
+        QVERIFY(fabsf(glm::dot(result.rot(), expectedRot) - 1.0f) < EPSILON);
+    }
+}
+
+void AnimTests::testCompressedFrames() {
+    const int NUM_FRAMES = 90;
+    const int NUM_JOINTS = 3;
+    std::vector<AnimPoseVec> frames(NUM_FRAMES);
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        float t = (float)frame / (float)NUM_FRAMES;
+        frames[frame].push_back(AnimPose(glm::vec3(1.0f), glm::quat(), glm::vec3(0.0f, 1.0f, 0.0f)));
+        frames[frame].push_back(AnimPose(glm::vec3(1.0f), glm::angleAxis(2.0f * t, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(0.0f, 0.5f, 0.0f)));
+        frames[frame].push_back(AnimPose(glm::vec3(2.0f), glm::normalize(glm::quat(1.0f, 0.0f, sinf(6.0f * t), 0.0f)),
+            glm::vec3(sinf(6.0f * t), 0.25f, 0.0f)));
+    }
+
+    AnimCompressedFrames compressed(frames);
+    QCOMPARE(compressed.getNumFrames(), NUM_FRAMES);
+    QCOMPARE(compressed.getNumJoints(), NUM_JOINTS);
+    QVERIFY(compressed.getMemorySize() < NUM_FRAMES * NUM_JOINTS * sizeof(AnimPose));
+
+    const float ROTATION_ERROR = 0.002f;
+    const float TRANSLATION_ERROR = 0.003f;
+    AnimPoseVec poses;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        compressed.getFrame(frame, poses);
+        QCOMPARE((int)poses.size(), NUM_JOINTS);
+        for (int joint = 0; joint < NUM_JOINTS; joint++) {
+            const AnimPose& expected = frames[frame][joint];
+            QVERIFY(fabsf(glm::dot(poses[joint].rot(), expected.rot())) > 1.0f - ROTATION_ERROR);
+            QVERIFY(glm::distance(poses[joint].trans(), expected.trans()) < TRANSLATION_ERROR);
+            QVERIFY(glm::distance(poses[joint].scale(), expected.scale()) < TRANSLATION_ERROR);
+        }
+    }
+
+    // frames out of range are clamped
+    compressed.getFrame(NUM_FRAMES + 10, poses);
+    QVERIFY(glm::distance(poses[2].trans(), frames[NUM_FRAMES - 1][2].trans()) < TRANSLATION_ERROR);
+}
+
+// A skeleton the size of an avatar rig: 10 chains of 7 joints hanging from the root
+static const int NUM_BENCHMARK_JOINTS = 70;
+static const int BENCHMARK_CHAIN_LENGTH = 7;
+
+static AnimSkeleton::Pointer makeBenchmarkSkeleton() {
+    std::vector<FBXJoint> joints(NUM_BENCHMARK_JOINTS);
+    for (int i = 0; i < NUM_BENCHMARK_JOINTS; ++i) {
+        FBXJoint& joint = joints[i];
+        joint.isFree = false;
+        joint.parentIndex = (i == 0) ? -1 : ((i % BENCHMARK_CHAIN_LENGTH == 1) ? 0 : i - 1);
+        joint.distanceToParent = 1.0f;
+        joint.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+        joint.name = QString("joint%1").arg(i);
+        joint.isSkeletonJoint = true;
+        joint.bindTransformFoundInCluster = false;
+        joint.hasGeometricOffset = false;
+        joint.transform = (i == 0) ? glm::mat4() : joints[joint.parentIndex].transform * glm::translate(joint.translation);
+        joint.bindTransform = joint.transform;
+    }
+    return std::make_shared<AnimSkeleton>(joints);
+}
+
+static AnimPoseVec makeBenchmarkPoses(float angle) {
+    AnimPoseVec poses;
+    poses.reserve(NUM_BENCHMARK_JOINTS);
+    for (int i = 0; i < NUM_BENCHMARK_JOINTS; ++i) {
+        glm::quat rot = glm::angleAxis(angle * (float)(i % BENCHMARK_CHAIN_LENGTH), glm::normalize(glm::vec3(1.0f, 0.5f, 0.25f)));
+        poses.push_back(AnimPose(glm::vec3(1.0f), rot, glm::vec3(0.0f, 0.1f, 0.0f)));
+    }
+    return poses;
+}
+
+void AnimTests::benchmarkBlend() {
+    AnimPoseVec a = makeBenchmarkPoses(0.1f);
+    AnimPoseVec b = makeBenchmarkPoses(-0.2f);
+    AnimPoseVec result(NUM_BENCHMARK_JOINTS);
+    QBENCHMARK {
+        ::blend(NUM_BENCHMARK_JOINTS, a.data(), b.data(), 0.3f, result.data());
+    }
+}
+
+void AnimTests::benchmarkRelativeToAbsolute() {
+    AnimSkeleton::Pointer skeleton = makeBenchmarkSkeleton();
+    AnimPoseVec relativePoses = makeBenchmarkPoses(0.1f);
+    QBENCHMARK {
+        AnimPoseVec poses = relativePoses;
+        skeleton->convertRelativePosesToAbsolute(poses);
+    }
+}
+
 void AnimTests::testExpressionTokenizer() {
     QString str = "(10 +  x) >= 20.1 && (y != !z)";
     AnimExpression e("x");
@@ -27,6 +27,11 @@ private slots:
     void testVariant();
     void testAccumulateTime();
     void testAnimPose();
+    void testAnimPoseProduct();
+    void testBlend();
+    void testCompressedFrames();
+    void benchmarkBlend();
+    void benchmarkRelativeToAbsolute();
     void testExpressionTokenizer();
     void testExpressionParser();
     void testExpressionEvaluator();
@@ -0,0 +1,236 @@
+//
+//  AudioSIMDTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSIMDTests.h"
+
+#include <cmath>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <AudioFOA.h>
+#include <AudioHRTF.h>
+#include <AudioSRC.h>
+#include <CPUDetect.h>
+
+QTEST_MAIN(AudioSIMDTests)
+
+using FIRFunction = void(*)(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+using RotateFunction = void(*)(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames);
+
+// kernel variants, as built into the audio library
+#if defined(ARCH_X86)
+void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_1x4_AVX512(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void rotate_3x3_AVX2(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames);
+#elif defined(ARCH_ARM) || defined(ARCH_ARM64)
+void FIR_1x4_NEON(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void rotate_3x3_NEON(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames);
+#endif
+
+static void FIR_1x4_scalar(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+    float* dst[4] = { dst0, dst1, dst2, dst3 };
+    for (int c = 0; c < 4; c++) {
+        for (int i = 0; i < numFrames; i++) {
+            float acc = 0.0f;
+            for (int k = 0; k < HRTF_TAPS; k++) {
+                acc += coef[c][k] * src[i - k];
+            }
+            dst[c][i] = acc;
+        }
+    }
+}
+
+static void rotate_3x3_scalar(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        float m[3][3];
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                m[r][c] = m1[r][c] + win[i] * (m0[r][c] - m1[r][c]);
+            }
+        }
+        float x = m[0][0] * buf[1][i] + m[0][1] * buf[2][i] + m[0][2] * buf[3][i];
+        float y = m[1][0] * buf[1][i] + m[1][1] * buf[2][i] + m[1][2] * buf[3][i];
+        float z = m[2][0] * buf[1][i] + m[2][1] * buf[2][i] + m[2][2] * buf[3][i];
+        buf[1][i] = x;
+        buf[2][i] = y;
+        buf[3][i] = z;
+    }
+}
+
+struct FIRVariant {
+    const char* name;
+    FIRFunction function;
+    bool (*isSupported)();
+};
+
+struct RotateVariant {
+    const char* name;
+    RotateFunction function;
+    bool (*isSupported)();
+};
+
+static bool alwaysSupported() { return true; }
+
+static const FIRVariant FIR_VARIANTS[] = {
+    { "scalar", FIR_1x4_scalar, alwaysSupported },
+#if defined(ARCH_X86)
+    { "AVX2", FIR_1x4_AVX2, cpuSupportsAVX2 },
+    { "AVX512", FIR_1x4_AVX512, cpuSupportsAVX512 },
+#elif defined(ARCH_ARM) || defined(ARCH_ARM64)
+    { "NEON", FIR_1x4_NEON, cpuSupportsNEON },
+#endif
+};
+
+static const RotateVariant ROTATE_VARIANTS[] = {
+    { "scalar", rotate_3x3_scalar, alwaysSupported },
+#if defined(ARCH_X86)
+    { "AVX2", rotate_3x3_AVX2, cpuSupportsAVX2 },
+#elif defined(ARCH_ARM) || defined(ARCH_ARM64)
+    { "NEON", rotate_3x3_NEON, cpuSupportsNEON },
+#endif
+};
+
+static const float EPSILON = 1e-4f;
+
+static float randomFloat() {
+    return (float)qrand() / RAND_MAX * 2.0f - 1.0f;
+}
+
+void AudioSIMDTests::fir_data() {
+    QTest::addColumn<int>("variant");
+    for (int i = 0; i < (int)(sizeof(FIR_VARIANTS) / sizeof(FIR_VARIANTS[0])); i++) {
+        QTest::newRow(FIR_VARIANTS[i].name) << i;
+    }
+}
+
+void AudioSIMDTests::fir() {
+    QFETCH(int, variant);
+    const FIRVariant& fir = FIR_VARIANTS[variant];
+    if (!fir.isSupported()) {
+        QSKIP("not supported by this CPU");
+    }
+
+    float input[HRTF_TAPS + HRTF_BLOCK];
+    float coef[4][HRTF_TAPS];
+    for (auto& sample : input) {
+        sample = randomFloat();
+    }
+    for (auto& channel : coef) {
+        for (auto& tap : channel) {
+            tap = randomFloat() / HRTF_TAPS;
+        }
+    }
+
+    float expected[4][HRTF_BLOCK];
+    float actual[4][HRTF_BLOCK];
+    FIR_1x4_scalar(&input[HRTF_TAPS], expected[0], expected[1], expected[2], expected[3], coef, HRTF_BLOCK);
+    fir.function(&input[HRTF_TAPS], actual[0], actual[1], actual[2], actual[3], coef, HRTF_BLOCK);
+
+    for (int c = 0; c < 4; c++) {
+        for (int i = 0; i < HRTF_BLOCK; i++) {
+            QVERIFY(fabsf(actual[c][i] - expected[c][i]) < EPSILON);
+        }
+    }
+
+    QBENCHMARK {
+        fir.function(&input[HRTF_TAPS], actual[0], actual[1], actual[2], actual[3], coef, HRTF_BLOCK);
+    }
+}
+
+void AudioSIMDTests::rotate_data() {
+    QTest::addColumn<int>("variant");
+    for (int i = 0; i < (int)(sizeof(ROTATE_VARIANTS) / sizeof(ROTATE_VARIANTS[0])); i++) {
+        QTest::newRow(ROTATE_VARIANTS[i].name) << i;
+    }
+}
+
+void AudioSIMDTests::rotate() {
+    QFETCH(int, variant);
+    const RotateVariant& rotate = ROTATE_VARIANTS[variant];
+    if (!rotate.isSupported()) {
+        QSKIP("not supported by this CPU");
+    }
+
+    float m0[3][3];
+    float m1[3][3];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            m0[r][c] = randomFloat();
+            m1[r][c] = randomFloat();
+        }
+    }
+
+    float win[FOA_BLOCK];
+    float expected[4][FOA_BLOCK];
+    float actual[4][FOA_BLOCK];
+    for (int i = 0; i < FOA_BLOCK; i++) {
+        win[i] = (float)i / FOA_BLOCK;
+        for (int c = 0; c < 4; c++) {
+            expected[c][i] = actual[c][i] = randomFloat();
+        }
+    }
+
+    float* expectedBuffers[4] = { expected[0], expected[1], expected[2], expected[3] };
+    float* actualBuffers[4] = { actual[0], actual[1], actual[2], actual[3] };
+    rotate_3x3_scalar(expectedBuffers, m0, m1, win, FOA_BLOCK);
+    rotate.function(actualBuffers, m0, m1, win, FOA_BLOCK);
+
+    for (int c = 1; c < 4; c++) {
+        for (int i = 0; i < FOA_BLOCK; i++) {
+            QVERIFY(fabsf(actual[c][i] - expected[c][i]) < EPSILON);
+        }
+    }
+
+    QBENCHMARK {
+        rotate.function(actualBuffers, m0, m1, win, FOA_BLOCK);
+    }
+}
+
+void AudioSIMDTests::benchmarkHRTF() {
+    AudioHRTF hrtf;
+    int16_t input[HRTF_BLOCK];
+    float output[2 * HRTF_BLOCK] = {};
+    for (auto& sample : input) {
+        sample = (int16_t)(randomFloat() * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    float azimuth = 0.0f;
+    QBENCHMARK {
+        hrtf.render(input, output, 1, azimuth, 2.0f, 0.5f, HRTF_BLOCK);
+        azimuth += 0.01f;
+    }
+}
+
+void AudioSIMDTests::benchmarkFOA() {
+    AudioFOA foa;
+    int16_t input[4 * FOA_BLOCK];
+    float output[2 * FOA_BLOCK] = {};
+    for (auto& sample : input) {
+        sample = (int16_t)(randomFloat() * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    QBENCHMARK {
+        foa.render(input, output, 0, 1.0f, 0.0f, 0.0f, 0.0f, 0.5f, FOA_BLOCK);
+    }
+}
+
+void AudioSIMDTests::benchmarkSRC() {
+    const int INPUT_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    AudioSRC src(AudioConstants::SAMPLE_RATE, 48000, 2);
+    int16_t input[2 * INPUT_FRAMES];
+    std::vector<int16_t> output(2 * src.getMaxOutput(INPUT_FRAMES));
+    for (auto& sample : input) {
+        sample = (int16_t)(randomFloat() * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    QBENCHMARK {
+        src.render(input, output.data(), INPUT_FRAMES);
+    }
+}
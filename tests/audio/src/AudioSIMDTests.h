@@ -0,0 +1,31 @@
+//
+//  AudioSIMDTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSIMDTests_h
+#define hifi_AudioSIMDTests_h
+
+#include <QtTest/QtTest>
+
+// Compares the SIMD variants of the audio kernels against scalar references, and benchmarks each variant
+// that the running CPU supports. Run with -tickcounter or -iterations N for stable numbers.
+class AudioSIMDTests : public QObject {
+    Q_OBJECT
+private slots:
+    void fir_data();
+    void fir();
+    void rotate_data();
+    void rotate();
+
+    void benchmarkHRTF();
+    void benchmarkFOA();
+    void benchmarkSRC();
+};
+
+#endif // hifi_AudioSIMDTests_h
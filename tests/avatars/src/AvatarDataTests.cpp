@@ -0,0 +1,123 @@
+//
+//  AvatarDataTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarDataTests.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarData.h>
+
+QTEST_MAIN(AvatarDataTests)
+
+static const int NUM_JOINTS = 20;
+static const float ROTATION_TOLERANCE = 0.9999f; // minimum dot product with the sent rotation
+static const float TRANSLATION_TOLERANCE = 0.01f;
+
+static void setJoints(AvatarData& avatar, float angle) {
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        glm::quat rotation = glm::angleAxis(angle + 0.1f * i, glm::normalize(glm::vec3(1.0f, (float)i, 0.5f)));
+        avatar.setJointData(i, rotation, glm::vec3(0.01f * i, 0.1f, -0.05f * i));
+    }
+}
+
+static QByteArray encodeJointDelta(const AvatarData& avatar, AvatarDataPacket::JointKeyframe& keyframe,
+                                   AvatarDataPacket::HasFlags& hasFlags) {
+    QVector<JointData> lastSentJointData;
+    return avatar.toByteArray(AvatarData::SendJointDeltaData, 0, lastSentJointData, hasFlags,
+                              false, false, glm::vec3(0.0f), nullptr, nullptr, &keyframe);
+}
+
+static void compareJoints(const AvatarData& sent, const AvatarData& received) {
+    QCOMPARE(received.getJointCount(), NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        QVERIFY(fabsf(glm::dot(sent.getJointRotation(i), received.getJointRotation(i))) > ROTATION_TOLERANCE);
+        QVERIFY(glm::distance(sent.getJointTranslation(i), received.getJointTranslation(i)) < TRANSLATION_TOLERANCE);
+    }
+}
+
+void AvatarDataTests::jointDeltaRoundTrip() {
+    AvatarData sender;
+    AvatarData receiver;
+    AvatarDataPacket::JointKeyframe keyframe;
+    AvatarDataPacket::HasFlags hasFlags;
+
+    setJoints(sender, 0.0f);
+    QByteArray bytes = encodeJointDelta(sender, keyframe, hasFlags);
+    QVERIFY(hasFlags & AvatarDataPacket::PACKET_HAS_JOINT_DELTA_DATA);
+    QVERIFY(!(hasFlags & AvatarDataPacket::PACKET_HAS_JOINT_DATA));
+    QVERIFY(keyframe.isValid);
+    QCOMPARE(keyframe.age, 0);
+
+    QCOMPARE(receiver.parseDataFromBuffer(bytes), bytes.size());
+    compareJoints(sender, receiver);
+
+    // every joint moves well past the culling thresholds
+    for (int frame = 1; frame < AvatarDataPacket::JOINT_KEYFRAME_INTERVAL; ++frame) {
+        setJoints(sender, 0.5f * frame);
+        bytes = encodeJointDelta(sender, keyframe, hasFlags);
+        QCOMPARE(keyframe.age, frame);
+
+        QCOMPARE(receiver.parseDataFromBuffer(bytes), bytes.size());
+        compareJoints(sender, receiver);
+    }
+
+    // an unchanged avatar is sent as empty deltas, and the receiver falls back to the keyframe
+    setJoints(sender, 0.0f);
+    QByteArray unchangedBytes = encodeJointDelta(sender, keyframe, hasFlags);
+    QVERIFY(unchangedBytes.size() < bytes.size());
+    QCOMPARE(receiver.parseDataFromBuffer(unchangedBytes), unchangedBytes.size());
+    compareJoints(sender, receiver);
+
+    // and then the keyframe is refreshed
+    uint8_t lastKeyframeID = keyframe.id;
+    encodeJointDelta(sender, keyframe, hasFlags);
+    QCOMPARE(keyframe.age, 0);
+    QVERIFY(keyframe.id != lastKeyframeID);
+}
+
+void AvatarDataTests::jointDeltaMissedKeyframe() {
+    AvatarData sender;
+    AvatarData receiver;
+    AvatarDataPacket::JointKeyframe keyframe;
+    AvatarDataPacket::HasFlags hasFlags;
+
+    setJoints(sender, 0.0f);
+    encodeJointDelta(sender, keyframe, hasFlags); // lost
+
+    setJoints(sender, 1.0f);
+    QByteArray bytes = encodeJointDelta(sender, keyframe, hasFlags);
+    QCOMPARE(receiver.parseDataFromBuffer(bytes), bytes.size());
+    QCOMPARE(receiver.getJointCount(), 0);
+}
+
+void AvatarDataTests::preparedData() {
+    AvatarData sender;
+    AvatarData receiver;
+    AvatarDataPacket::JointKeyframe keyframe;
+    AvatarDataPacket::HasFlags hasFlags;
+
+    setJoints(sender, 0.0f);
+    QByteArray bytes = encodeJointDelta(sender, keyframe, hasFlags);
+    auto prepared = receiver.prepareDataFromBuffer(bytes + QByteArray(16, '\0'));
+    QCOMPARE(prepared.size, bytes.size());
+    QVERIFY(prepared.areJointsApplicable);
+    QCOMPARE(prepared.joints.size(), NUM_JOINTS);
+
+    // preparing doesn't change the avatar
+    QCOMPARE(receiver.getJointCount(), 0);
+    QCOMPARE(receiver.parsePreparedData(prepared), bytes.size());
+    compareJoints(sender, receiver);
+
+    setJoints(sender, 1.0f);
+    bytes = encodeJointDelta(sender, keyframe, hasFlags);
+    prepared = receiver.prepareDataFromBuffer(bytes);
+    QCOMPARE(receiver.parsePreparedData(prepared), bytes.size());
+    compareJoints(sender, receiver);
+}
@@ -0,0 +1,29 @@
+//
+//  AvatarDataTests.h
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarDataTests_h
+#define hifi_AvatarDataTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarDataTests : public QObject {
+    Q_OBJECT
+private slots:
+    // joints sent as a keyframe, and then as deltas against it, come out as they went in
+    void jointDeltaRoundTrip();
+
+    // deltas against a keyframe the receiver never got are read past, and leave its joints alone
+    void jointDeltaMissedKeyframe();
+
+    // data that is prepared ahead, with a few more bytes after it, knows its size and is parsed as it was sent
+    void preparedData();
+};
+
+#endif // hifi_AvatarDataTests_h
@@ -0,0 +1,144 @@
+//
+//  AvatarSortTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarSortTests.h"
+
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <AvatarData.h>
+#include <ViewFrustum.h>
+
+QTEST_MAIN(AvatarSortTests)
+
+static const float AVATAR_RADIUS = 0.5f;
+static const float WORLD_SIZE = 100.0f;
+static const float STEP_SIZE = 0.05f; // how far an avatar moves between frames
+
+static QList<AvatarSharedPointer> createAvatars(int numAvatars, std::mt19937& generator) {
+    std::uniform_real_distribution<float> distribution(-WORLD_SIZE, WORLD_SIZE);
+    QList<AvatarSharedPointer> avatars;
+    for (int i = 0; i < numAvatars; ++i) {
+        auto avatar = std::make_shared<AvatarData>();
+        avatar->setPosition(glm::vec3(distribution(generator), 0.0f, distribution(generator)));
+        avatars << avatar;
+    }
+    return avatars;
+}
+
+static void moveAvatars(QList<AvatarSharedPointer>& avatars, std::mt19937& generator) {
+    std::uniform_real_distribution<float> distribution(-STEP_SIZE, STEP_SIZE);
+    for (auto& avatar : avatars) {
+        avatar->setPosition(avatar->getPosition() + glm::vec3(distribution(generator), 0.0f, distribution(generator)));
+    }
+}
+
+static ViewFrustum createView() {
+    ViewFrustum view;
+    view.setPosition(glm::vec3(0.0f));
+    view.setOrientation(glm::quat());
+    view.setProjection(glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f));
+    view.calculate();
+    return view;
+}
+
+static uint64_t lastUpdated(AvatarSharedPointer avatar) {
+    return 0;
+}
+
+static float boundingRadius(AvatarSharedPointer avatar) {
+    return AVATAR_RADIUS;
+}
+
+static bool neverIgnore(AvatarSharedPointer avatar) {
+    return false;
+}
+
+void AvatarSortTests::incrementalOrder() {
+    std::mt19937 generator(1);
+    auto avatars = createAvatars(200, generator);
+    ViewFrustum view = createView();
+
+    // the two sorts run at slightly different times, take age out of the priority so they compare exactly
+    float ageCoefficient = AvatarData::_avatarSortCoefficientAge;
+    AvatarData::_avatarSortCoefficientAge = 0.0f;
+
+    std::vector<AvatarPriority> incremental;
+    for (int frame = 0; frame < 10; ++frame) {
+        moveAvatars(avatars, generator);
+        if (frame == 5) {
+            // drop some avatars, and add a few new ones
+            avatars.erase(avatars.begin(), avatars.begin() + 20);
+            avatars.append(createAvatars(10, generator));
+        }
+
+        AvatarData::sortAvatars(avatars, view, incremental, lastUpdated, boundingRadius, neverIgnore);
+
+        std::priority_queue<AvatarPriority> full;
+        AvatarData::sortAvatars(avatars, view, full, lastUpdated, boundingRadius, neverIgnore);
+
+        QCOMPARE(incremental.size(), full.size());
+        for (size_t i = 0; i < incremental.size(); ++i) {
+            if (i > 0) {
+                QVERIFY(incremental[i - 1].priority >= incremental[i].priority);
+            }
+            QCOMPARE(incremental[i].priority, full.top().priority);
+            full.pop();
+        }
+    }
+
+    AvatarData::_avatarSortCoefficientAge = ageCoefficient;
+}
+
+void AvatarSortTests::benchmarkFullRebuild_data() {
+    QTest::addColumn<int>("numAvatars");
+    QTest::newRow("50") << 50;
+    QTest::newRow("200") << 200;
+    QTest::newRow("1000") << 1000;
+}
+
+void AvatarSortTests::benchmarkFullRebuild() {
+    QFETCH(int, numAvatars);
+
+    std::mt19937 generator(1);
+    auto avatars = createAvatars(numAvatars, generator);
+    ViewFrustum view = createView();
+
+    QBENCHMARK {
+        moveAvatars(avatars, generator);
+
+        std::priority_queue<AvatarPriority> sortedAvatars;
+        AvatarData::sortAvatars(avatars, view, sortedAvatars, lastUpdated, boundingRadius, neverIgnore);
+        while (!sortedAvatars.empty()) {
+            sortedAvatars.pop();
+        }
+    }
+}
+
+void AvatarSortTests::benchmarkIncremental_data() {
+    benchmarkFullRebuild_data();
+}
+
+void AvatarSortTests::benchmarkIncremental() {
+    QFETCH(int, numAvatars);
+
+    std::mt19937 generator(1);
+    auto avatars = createAvatars(numAvatars, generator);
+    ViewFrustum view = createView();
+
+    std::vector<AvatarPriority> sortedAvatars;
+    AvatarData::sortAvatars(avatars, view, sortedAvatars, lastUpdated, boundingRadius, neverIgnore);
+
+    QBENCHMARK {
+        moveAvatars(avatars, generator);
+        AvatarData::sortAvatars(avatars, view, sortedAvatars, lastUpdated, boundingRadius, neverIgnore);
+    }
+}
@@ -0,0 +1,29 @@
+//
+//  AvatarSortTests.h
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSortTests_h
+#define hifi_AvatarSortTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarSortTests : public QObject {
+    Q_OBJECT
+private slots:
+    // the incremental sort gives the same order as the full rebuild, as avatars move, come and go
+    void incrementalOrder();
+
+    // full priority_queue rebuild vs. incremental re-sort of last frame's order
+    void benchmarkFullRebuild_data();
+    void benchmarkFullRebuild();
+    void benchmarkIncremental_data();
+    void benchmarkIncremental();
+};
+
+#endif // hifi_AvatarSortTests_h
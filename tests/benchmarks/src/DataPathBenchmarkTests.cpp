@@ -0,0 +1,240 @@
+//
+//  DataPathBenchmarkTests.cpp
+//  tests/benchmarks/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DataPathBenchmarkTests.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <AACube.h>
+#include <AudioConstants.h>
+#include <AudioHRTF.h>
+#include <AudioRingBuffer.h>
+#include <AudioSRC.h>
+#include <AvatarData.h>
+#include <OctreePacketData.h>
+#include <PropertyFlags.h>
+#include <SequenceNumberStats.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+#include <udt/LossList.h>
+
+QTEST_MAIN(DataPathBenchmarkTests)
+
+static const int NUM_JOINTS = 60;
+static const int NUM_CUBES = 1000;
+
+// about as many properties as an entity has
+enum BenchmarkProperty {
+    BENCHMARK_PROPERTY_FIRST = 0,
+    BENCHMARK_PROPERTY_COUNT = 120
+};
+
+static void setJoints(AvatarData& avatar, float angle) {
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        glm::quat rotation = glm::angleAxis(angle + 0.1f * i, glm::normalize(glm::vec3(1.0f, (float)i, 0.5f)));
+        avatar.setJointData(i, rotation, glm::vec3(0.01f * i, 0.1f, -0.05f * i));
+    }
+}
+
+// appends entity-like records until the packet is full, returns the number of records
+static int appendEntities(OctreePacketData& packetData) {
+    int records = 0;
+    while (true) {
+        bool success = packetData.appendValue(QUuid())
+            && packetData.appendValue((quint64)usecTimestampNow())
+            && packetData.appendPosition(glm::vec3(records, 2.0f, -records))
+            && packetData.appendValue(glm::quat())
+            && packetData.appendValue(glm::vec3(0.5f))
+            && packetData.appendValue((uint32_t)records)
+            && packetData.appendValue(0.25f)
+            && packetData.appendValue(QString("Box"));
+        if (!success) {
+            return records;
+        }
+        ++records;
+    }
+}
+
+void DataPathBenchmarkTests::initTestCase() {
+    // the same inputs every run
+    srand(1);
+}
+
+void DataPathBenchmarkTests::octreePacketDataAppend() {
+    OctreePacketData packetData(false);
+    QBENCHMARK {
+        packetData.reset();
+        appendEntities(packetData);
+    }
+}
+
+void DataPathBenchmarkTests::octreePacketDataCompress() {
+    OctreePacketData packetData(true);
+    QBENCHMARK {
+        packetData.reset();
+        appendEntities(packetData);
+        packetData.getFinalizedData();
+    }
+    QVERIFY(packetData.getFinalizedSize() > 0);
+}
+
+void DataPathBenchmarkTests::avatarDataToByteArray() {
+    AvatarData avatar;
+    setJoints(avatar, 0.0f);
+    QVector<JointData> lastSentJointData;
+    AvatarDataPacket::HasFlags hasFlags;
+    QByteArray bytes;
+    QBENCHMARK {
+        bytes = avatar.toByteArray(AvatarData::SendAllData, 0, lastSentJointData, hasFlags,
+                                   false, false, glm::vec3(0.0f), nullptr);
+    }
+    QVERIFY(!bytes.isEmpty());
+}
+
+void DataPathBenchmarkTests::avatarDataParse() {
+    AvatarData sender;
+    setJoints(sender, 0.0f);
+    QVector<JointData> lastSentJointData;
+    AvatarDataPacket::HasFlags hasFlags;
+    QByteArray bytes = sender.toByteArray(AvatarData::SendAllData, 0, lastSentJointData, hasFlags,
+                                          false, false, glm::vec3(0.0f), nullptr);
+
+    AvatarData receiver;
+    int parsed = 0;
+    QBENCHMARK {
+        parsed = receiver.parseDataFromBuffer(bytes);
+    }
+    QCOMPARE(parsed, bytes.size());
+}
+
+void DataPathBenchmarkTests::audioHRTFRender() {
+    AudioHRTF hrtf;
+    int16_t input[HRTF_BLOCK];
+    float output[2 * HRTF_BLOCK] = {};
+    for (auto& sample : input) {
+        sample = (int16_t)((randFloat() - 0.5f) * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    // a moving source, so the interpolated filters are exercised
+    float azimuth = 0.0f;
+    QBENCHMARK {
+        hrtf.render(input, output, 1, azimuth, 2.0f, 0.5f, HRTF_BLOCK);
+        azimuth += 0.01f;
+    }
+}
+
+void DataPathBenchmarkTests::audioSRCRender() {
+    const int INPUT_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    AudioSRC src(48000, AudioConstants::SAMPLE_RATE, 1);
+    std::vector<int16_t> input(INPUT_FRAMES);
+    std::vector<int16_t> output(src.getMaxOutput(INPUT_FRAMES));
+    for (auto& sample : input) {
+        sample = (int16_t)((randFloat() - 0.5f) * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    QBENCHMARK {
+        src.render(input.data(), output.data(), INPUT_FRAMES);
+    }
+}
+
+void DataPathBenchmarkTests::audioRingBufferWriteRead() {
+    const int FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+    AudioRingBuffer ringBuffer(FRAME_SAMPLES);
+    std::vector<int16_t> input(FRAME_SAMPLES);
+    std::vector<int16_t> output(FRAME_SAMPLES);
+    for (auto& sample : input) {
+        sample = (int16_t)((randFloat() - 0.5f) * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    QBENCHMARK {
+        ringBuffer.writeSamples(input.data(), FRAME_SAMPLES);
+        ringBuffer.readSamples(output.data(), FRAME_SAMPLES);
+    }
+    QCOMPARE(output, input);
+}
+
+void DataPathBenchmarkTests::sequenceNumberStats() {
+    // a second of audio from one sender, with some loss and reordering
+    const int NUM_PACKETS = 100;
+    std::vector<quint16> sequence;
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        if (i % 17 == 0) {
+            continue;
+        }
+        sequence.push_back((quint16)(i % 23 == 0 ? i - 2 : i));
+    }
+
+    SequenceNumberStats stats;
+    quint16 offset = 0;
+    QBENCHMARK {
+        for (auto number : sequence) {
+            stats.sequenceNumberReceived(number + offset);
+        }
+        offset += NUM_PACKETS;
+    }
+}
+
+void DataPathBenchmarkTests::lossList() {
+    using udt::SequenceNumber;
+    const int NUM_RANGES = 64;
+    udt::LossList lossList;
+    QBENCHMARK {
+        // losses reported by one NAK, then resent and removed one at a time
+        for (int i = 0; i < NUM_RANGES; ++i) {
+            lossList.append(SequenceNumber(10 * i), SequenceNumber(10 * i + 3));
+        }
+        while (!lossList.isEmpty()) {
+            lossList.popFirstSequenceNumber();
+        }
+    }
+}
+
+void DataPathBenchmarkTests::propertyFlagsEncode() {
+    PropertyFlags<BenchmarkProperty> flags;
+    // every other property changed, the worst case for the run length encoding
+    for (int i = BENCHMARK_PROPERTY_FIRST; i < BENCHMARK_PROPERTY_COUNT; i += 2) {
+        flags.setHasProperty((BenchmarkProperty)i);
+    }
+
+    QByteArray encoded;
+    QBENCHMARK {
+        encoded = flags.encode();
+    }
+    QVERIFY(!encoded.isEmpty());
+}
+
+void DataPathBenchmarkTests::viewFrustumCulling() {
+    ViewFrustum view;
+    view.setProjection(glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 500.0f));
+    view.setPosition(glm::vec3(0.0f));
+    view.calculate();
+
+    std::vector<AACube> cubes;
+    cubes.reserve(NUM_CUBES);
+    for (int i = 0; i < NUM_CUBES; ++i) {
+        glm::vec3 corner(randFloatInRange(-200.0f, 200.0f), randFloatInRange(-20.0f, 20.0f),
+                         randFloatInRange(-200.0f, 200.0f));
+        cubes.push_back(AACube(corner, randFloatInRange(0.1f, 10.0f)));
+    }
+
+    int visible = 0;
+    QBENCHMARK {
+        visible = 0;
+        for (const auto& cube : cubes) {
+            if (view.cubeIntersectsKeyhole(cube) || view.calculateCubeFrustumIntersection(cube) != ViewFrustum::OUTSIDE) {
+                ++visible;
+            }
+        }
+    }
+    QVERIFY(visible > 0 && visible < NUM_CUBES);
+}
@@ -0,0 +1,38 @@
+//
+//  DataPathBenchmarkTests.h
+//  tests/benchmarks/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DataPathBenchmarkTests_h
+#define hifi_DataPathBenchmarkTests_h
+
+#include <QtTest/QtTest>
+
+// Benchmarks of the primitives on the hot paths of the mixers and the entity server. Each slot measures one
+// operation on a realistically sized input, so results compare across builds rather than across slots.
+// For results a script can read, run with -o results.xml,xml (or -csv), and -iterations N or -minimumvalue for
+// stable numbers.
+class DataPathBenchmarkTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void octreePacketDataAppend();
+    void octreePacketDataCompress();
+    void avatarDataToByteArray();
+    void avatarDataParse();
+    void audioHRTFRender();
+    void audioSRCRender();
+    void audioRingBufferWriteRead();
+    void sequenceNumberStats();
+    void lossList();
+    void propertyFlagsEncode();
+    void viewFrustumCulling();
+};
+
+#endif // hifi_DataPathBenchmarkTests_h
@@ -0,0 +1,283 @@
+//
+//  CongestionControlTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CongestionControlTests.h"
+
+#include <cmath>
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <udt/BBRCC.h>
+#include <udt/CongestionControl.h>
+#include <udt/TCPVegasCC.h>
+
+QTEST_MAIN(CongestionControlTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+namespace {
+
+// A link trace is a list of segments, each holding the bottleneck bandwidth, propagation RTT and random loss of the
+// link for a while. Segments recorded from real links can be dropped straight into the table below.
+struct TraceSegment {
+    int durationMsecs;
+    int packetsPerSecond;
+    int rttMsecs;
+    double lossRate;
+};
+
+struct LinkTrace {
+    const char* name;
+    int queuePackets; // packets the bottleneck can buffer before it tail drops
+    std::vector<TraceSegment> segments;
+};
+
+const std::vector<LinkTrace> LINK_TRACES {
+    { "wired", 200, { { 20000, 3000, 40, 0.0 } } },
+    { "wifi", 100, { { 20000, 2000, 30, 0.01 } } },
+    { "long haul", 300, { { 30000, 1500, 180, 0.005 } } },
+    { "bandwidth drop", 200, { { 10000, 3000, 60, 0.002 }, { 10000, 1000, 60, 0.002 }, { 10000, 3000, 60, 0.002 } } }
+};
+
+const SequenceNumber INITIAL_SEQUENCE_NUMBER { SequenceNumber::MAX - 1000 }; // makes every replay wrap around
+
+// exposes what udt::Connection feeds a congestion control, so the replay can drive it instead
+template <typename T>
+class ReplayedCC : public T {
+public:
+    using T::setInitialSendSequenceNumber;
+    using T::setSendCurrentSequenceNumber;
+    using T::setRTT;
+    using T::setMaxCongestionWindowSize;
+
+    double packetSendPeriod() const { return T::_packetSendPeriod; }
+    int congestionWindowSize() const { return T::_congestionWindowSize; }
+};
+
+struct ReplayResult {
+    int64_t delivered { 0 }; // packets the receiver got in order
+    int64_t capacity { 0 }; // packets the link could have carried
+    bool hadInvalidState { false }; // the send period or window went somewhere the send queue can't use
+
+    double utilization() const { return capacity > 0 ? (double)delivered / capacity : 0.0; }
+};
+
+// Plays a bulk transfer over the trace against a congestion control, on a simulated clock.
+// The sender paces packets out at the send period and keeps at most a window of them in flight, the bottleneck queues
+// them behind each other at the link rate, and the receiver ACKs every packet and NAKs the gaps it sees.
+template <typename T>
+ReplayResult replay(const LinkTrace& trace) {
+    enum EventType { Arrival, ACK, NAK };
+    struct Event {
+        int64_t time;
+        EventType type;
+        int64_t first;
+        int64_t last;
+
+        bool operator>(const Event& other) const { return time > other.time; }
+    };
+
+    ReplayedCC<T> cc;
+    ReplayResult result;
+
+    int64_t traceEnd = 0;
+    for (auto& segment : trace.segments) {
+        traceEnd += segment.durationMsecs * 1000;
+        result.capacity += (int64_t)segment.durationMsecs * segment.packetsPerSecond / 1000;
+    }
+
+    auto segmentAt = [&](int64_t now) -> const TraceSegment& {
+        int64_t segmentEnd = 0;
+        for (auto& segment : trace.segments) {
+            segmentEnd += segment.durationMsecs * 1000;
+            if (now < segmentEnd) {
+                return segment;
+            }
+        }
+        return trace.segments.back();
+    };
+
+    auto start = p_high_resolution_clock::now();
+    auto timePoint = [&](int64_t usecs) { return start + microseconds(usecs); };
+    auto sequenceNumber = [&](int64_t index) { return INITIAL_SEQUENCE_NUMBER + (SequenceNumber::Type)(index % (SequenceNumber::MAX + 1)); };
+
+    cc.init();
+    cc.setRTT(DEFAULT_SYN_INTERVAL * 10);
+    cc.setMaxCongestionWindowSize(udt::MAX_PACKETS_IN_FLIGHT);
+    cc.setInitialSendSequenceNumber(INITIAL_SEQUENCE_NUMBER);
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::mt19937 lossGenerator(1);
+    std::uniform_real_distribution<double> lossDistribution(0.0, 1.0);
+
+    // sender
+    int64_t nextIndex = 0;
+    int64_t lastACKed = -1;
+    double nextSendTime = 0.0;
+    std::deque<int64_t> lossList;
+    int64_t lastProgressTime = 0;
+
+    // bottleneck
+    int64_t linkFreeTime = 0;
+    std::deque<int64_t> queuedDepartures;
+
+    // receiver
+    std::vector<bool> received;
+    int64_t highestReceived = -1;
+    int64_t contiguousReceived = -1;
+
+    auto transmit = [&](int64_t index, int64_t now) {
+        cc.onPacketSent(udt::MAX_PACKET_SIZE_WITH_UDP_HEADER, sequenceNumber(index), timePoint(now));
+
+        const TraceSegment& segment = segmentAt(now);
+        while (!queuedDepartures.empty() && queuedDepartures.front() <= now) {
+            queuedDepartures.pop_front();
+        }
+        if ((int)queuedDepartures.size() >= trace.queuePackets || lossDistribution(lossGenerator) < segment.lossRate) {
+            return;
+        }
+
+        linkFreeTime = std::max(linkFreeTime, now) + 1000000 / segment.packetsPerSecond;
+        queuedDepartures.push_back(linkFreeTime);
+        events.push({ linkFreeTime + segment.rttMsecs * 500, Arrival, index, index });
+    };
+
+    int64_t now = 0;
+    while (now < traceEnd) {
+        int windowSize = std::min(cc.congestionWindowSize(), udt::MAX_PACKETS_IN_FLIGHT);
+        double sendPeriod = cc.packetSendPeriod();
+        if (!std::isfinite(sendPeriod) || sendPeriod < 0.0 || windowSize <= 0) {
+            result.hadInvalidState = true;
+            break;
+        }
+
+        // send whatever the window and pacing allow right now, losses first
+        while (nextSendTime <= now) {
+            while (!lossList.empty() && lossList.front() <= lastACKed) {
+                lossList.pop_front();
+            }
+
+            int64_t index;
+            if (!lossList.empty()) {
+                index = lossList.front();
+                lossList.pop_front();
+            } else if (nextIndex - lastACKed - 1 < windowSize) {
+                index = nextIndex++;
+            } else {
+                break;
+            }
+
+            transmit(index, now);
+            nextSendTime = std::max(nextSendTime, (double)now - sendPeriod) + sendPeriod;
+        }
+
+        // nothing ACKed in a while, everything still in flight is presumed lost
+        // the replay knows what the receiver is missing, so it stands in for the loss list a real receiver would keep
+        const TraceSegment& segment = segmentAt(now);
+        int64_t timeout = 2 * segment.rttMsecs * 1000 + 200000;
+        if (lastACKed + 1 < nextIndex && now - lastProgressTime >= timeout) {
+            cc.setSendCurrentSequenceNumber(sequenceNumber(nextIndex - 1));
+            cc.onTimeout();
+            lossList.clear();
+            for (int64_t index = lastACKed + 1; index < nextIndex; ++index) {
+                if (index >= (int64_t)received.size() || !received[index]) {
+                    lossList.push_back(index);
+                }
+            }
+            lastProgressTime = now;
+        }
+
+        // step to whatever happens next
+        int64_t nextTime = lastProgressTime + timeout;
+        if (!events.empty()) {
+            nextTime = std::min(nextTime, events.top().time);
+        }
+        if (!lossList.empty() || nextIndex - lastACKed - 1 < windowSize) {
+            nextTime = std::min(nextTime, (int64_t)std::ceil(nextSendTime));
+        }
+        now = std::max(now + 1, nextTime);
+
+        while (!events.empty() && events.top().time <= now) {
+            Event event = events.top();
+            events.pop();
+
+            if (event.type == Arrival) {
+                if ((int64_t)received.size() <= event.first) {
+                    received.resize(event.first + 1, false);
+                }
+                received[event.first] = true;
+
+                if (event.first > highestReceived + 1) {
+                    events.push({ event.time + segment.rttMsecs * 500, NAK, highestReceived + 1, event.first - 1 });
+                }
+                highestReceived = std::max(highestReceived, event.first);
+
+                while (contiguousReceived + 1 < (int64_t)received.size() && received[contiguousReceived + 1]) {
+                    ++contiguousReceived;
+                }
+                events.push({ event.time + segment.rttMsecs * 500, ACK, contiguousReceived, contiguousReceived });
+
+            } else if (event.type == ACK) {
+                if (event.first > lastACKed) {
+                    lastACKed = event.first;
+                    lastProgressTime = event.time;
+
+                    cc.setSendCurrentSequenceNumber(sequenceNumber(nextIndex - 1));
+                    if (cc.onACK(sequenceNumber(event.first), timePoint(event.time))) {
+                        lossList.push_front(event.first + 1);
+                    }
+                }
+
+            } else if (event.type == NAK) {
+                cc.setSendCurrentSequenceNumber(sequenceNumber(nextIndex - 1));
+                cc.onLoss(sequenceNumber(event.first), sequenceNumber(event.last));
+                for (int64_t index = event.first; index <= event.last; ++index) {
+                    lossList.push_back(index);
+                }
+            }
+        }
+    }
+
+    result.delivered = contiguousReceived + 1;
+    return result;
+}
+
+template <typename T>
+void replayAll(const char* ccName, double minUtilization) {
+    for (auto& trace : LINK_TRACES) {
+        ReplayResult result = replay<T>(trace);
+
+        qDebug() << ccName << "on" << trace.name << "delivered" << result.delivered << "of" << result.capacity
+            << "packets, utilization" << result.utilization();
+
+        QVERIFY2(!result.hadInvalidState, trace.name);
+        QVERIFY2(result.delivered > 0, trace.name);
+        QVERIFY2(result.utilization() >= minUtilization, trace.name);
+    }
+}
+
+}
+
+// DefaultCC and TCPVegasCC time some of their adjustments with the wall clock rather than the times they're handed,
+// so against the simulated clock we can only check that they make progress
+void CongestionControlTests::defaultCCReplayTest() {
+    replayAll<DefaultCC>("DefaultCC", 0.0);
+}
+
+void CongestionControlTests::tcpVegasCCReplayTest() {
+    replayAll<TCPVegasCC>("TCPVegasCC", 0.0);
+}
+
+void CongestionControlTests::bbrCCReplayTest() {
+    replayAll<BBRCC>("BBRCC", 0.75);
+}
@@ -0,0 +1,29 @@
+//
+//  CongestionControlTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionControlTests_h
+#define hifi_CongestionControlTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class CongestionControlTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Replay each link trace against each congestion control, checking that it keeps the transfer going
+    void defaultCCReplayTest();
+    void tcpVegasCCReplayTest();
+
+    // Check that BBR keeps most of the link busy on every trace, including the lossy ones
+    void bbrCCReplayTest();
+};
+
+#endif // hifi_CongestionControlTests_h
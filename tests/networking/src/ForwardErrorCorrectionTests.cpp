@@ -0,0 +1,145 @@
+//
+//  ForwardErrorCorrectionTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardErrorCorrectionTests.h"
+
+#include <set>
+
+#include <ForwardErrorCorrection.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(ForwardErrorCorrectionTests)
+
+namespace {
+
+const QUuid SOURCE_ID = QUuid::createUuid();
+const int GROUP_SIZE = FEC::MIN_GROUP_SIZE;
+
+std::unique_ptr<NLPacket> createPacket(int sequenceNumber, int payloadSize) {
+    auto packet = NLPacket::create(PacketType::MixedAudio, payloadSize);
+    for (int i = 0; i < payloadSize; ++i) {
+        packet->writePrimitive((quint8)(sequenceNumber * 31 + i));
+    }
+    packet->writeSourceID(SOURCE_ID);
+    packet->writeSequenceNumber(udt::SequenceNumber((udt::SequenceNumber::Type)sequenceNumber));
+    return packet;
+}
+
+// what the other end gets out of the socket
+std::unique_ptr<udt::Packet> receive(const NLPacket& packet) {
+    std::unique_ptr<char[]> data(new char[packet.getDataSize()]);
+    memcpy(data.get(), packet.getData(), packet.getDataSize());
+    return udt::Packet::fromReceivedPacket(std::move(data), packet.getDataSize(), HifiSockAddr());
+}
+
+QByteArray payloadOf(const udt::Packet& packet) {
+    int headerSize = NLPacket::localHeaderSize(NLPacket::typeInHeader(packet));
+    return QByteArray(packet.getPayload() + headerSize, (int)packet.getPayloadSize() - headerSize);
+}
+
+// sends a group through an encoder and into a decoder, minus the lost packets
+// returns what the decoder rebuilt, and the packet it should have rebuilt in expected
+std::unique_ptr<udt::Packet> sendGroup(const std::vector<int>& payloadSizes, const std::set<int>& lost,
+                                       std::unique_ptr<NLPacket>& expected, int& numParityPackets) {
+    FECEncoder encoder;
+    encoder.setGroupSize((int)payloadSizes.size());
+    FECDecoder decoder;
+
+    // the decoder only starts recording once it has heard parity, the first group primes it
+    std::vector<std::unique_ptr<NLPacket>> parityPackets;
+    for (int i = 0; i < (int)payloadSizes.size(); ++i) {
+        parityPackets = encoder.addPacket(*createPacket(i, 1));
+    }
+    for (auto& parityPacket : parityPackets) {
+        decoder.processParity(*receive(*parityPacket), usecTimestampNow());
+    }
+
+    std::unique_ptr<udt::Packet> recovered;
+    for (int i = 0; i < (int)payloadSizes.size(); ++i) {
+        int sequenceNumber = (int)payloadSizes.size() + i;
+        auto packet = createPacket(sequenceNumber, payloadSizes[i]);
+        parityPackets = encoder.addPacket(*packet);
+
+        if (lost.count(i)) {
+            expected = std::move(packet);
+        } else {
+            decoder.recordPacket(*receive(*packet));
+        }
+    }
+
+    numParityPackets = (int)parityPackets.size();
+    for (auto& parityPacket : parityPackets) {
+        auto packet = decoder.processParity(*receive(*parityPacket), usecTimestampNow());
+        if (packet) {
+            recovered = std::move(packet);
+        }
+    }
+    return recovered;
+}
+
+}
+
+void ForwardErrorCorrectionTests::groupSizeTest() {
+    QCOMPARE(FEC::groupSizeForLossRate(0.0f), 0);
+    QCOMPARE(FEC::groupSizeForLossRate(FEC::MIN_LOSS_RATE / 2.0f), 0);
+    QCOMPARE(FEC::groupSizeForLossRate(FEC::MIN_LOSS_RATE), FEC::MAX_GROUP_SIZE);
+    QCOMPARE(FEC::groupSizeForLossRate(0.5f), FEC::MIN_GROUP_SIZE);
+
+    FECEncoder encoder;
+    QCOMPARE((int)encoder.addPacket(*createPacket(0, 10)).size(), 0);
+
+    encoder.setGroupSize(GROUP_SIZE);
+    for (int i = 0; i < GROUP_SIZE - 1; ++i) {
+        QCOMPARE((int)encoder.addPacket(*createPacket(i, 10)).size(), 0);
+    }
+    QCOMPARE((int)encoder.addPacket(*createPacket(GROUP_SIZE, 10)).size(), 1);
+}
+
+void ForwardErrorCorrectionTests::recoverTest() {
+    // differently sized payloads, the lost one is neither the first nor the largest
+    std::vector<int> payloadSizes { 100, 250, 30, 180, 0 };
+    std::unique_ptr<NLPacket> expected;
+    int numParityPackets;
+    auto recovered = sendGroup(payloadSizes, { 2 }, expected, numParityPackets);
+
+    QCOMPARE(numParityPackets, 1);
+    QVERIFY(recovered);
+    QCOMPARE(NLPacket::typeInHeader(*recovered), expected->getType());
+    QCOMPARE(NLPacket::sourceIDInHeader(*recovered), SOURCE_ID);
+    QCOMPARE(recovered->getSequenceNumber(), expected->getSequenceNumber());
+    QCOMPARE(payloadOf(*recovered), QByteArray(expected->getPayload(), (int)expected->getPayloadSize()));
+}
+
+void ForwardErrorCorrectionTests::recoverFragmentedTest() {
+    // full packets, so that the parity takes more than one packet to send
+    int maxPayloadSize = NLPacket::maxPayloadSize(PacketType::MixedAudio);
+    std::vector<int> payloadSizes(GROUP_SIZE, maxPayloadSize);
+    std::unique_ptr<NLPacket> expected;
+    int numParityPackets;
+    auto recovered = sendGroup(payloadSizes, { GROUP_SIZE - 1 }, expected, numParityPackets);
+
+    QCOMPARE(numParityPackets, 2);
+    QVERIFY(recovered);
+    QCOMPARE(payloadOf(*recovered), QByteArray(expected->getPayload(), (int)expected->getPayloadSize()));
+}
+
+void ForwardErrorCorrectionTests::twoLostTest() {
+    std::vector<int> payloadSizes(GROUP_SIZE, 100);
+    std::unique_ptr<NLPacket> expected;
+    int numParityPackets;
+    QVERIFY(!sendGroup(payloadSizes, { 0, 3 }, expected, numParityPackets));
+}
+
+void ForwardErrorCorrectionTests::nothingLostTest() {
+    std::vector<int> payloadSizes(GROUP_SIZE, 100);
+    std::unique_ptr<NLPacket> expected;
+    int numParityPackets;
+    QVERIFY(!sendGroup(payloadSizes, {}, expected, numParityPackets));
+}
@@ -0,0 +1,28 @@
+//
+//  ForwardErrorCorrectionTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ForwardErrorCorrectionTests_h
+#define hifi_ForwardErrorCorrectionTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ForwardErrorCorrectionTests : public QObject {
+    Q_OBJECT
+private slots:
+    void groupSizeTest();
+    void recoverTest();
+    void recoverFragmentedTest();
+    void twoLostTest();
+    void nothingLostTest();
+};
+
+#endif // hifi_ForwardErrorCorrectionTests_h
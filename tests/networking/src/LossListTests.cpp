@@ -0,0 +1,103 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <udt/LossList.h>
+
+QTEST_MAIN(LossListTests)
+
+using namespace udt;
+
+static SequenceNumber seq(SequenceNumber::Type value) {
+    return SequenceNumber { value };
+}
+
+void LossListTests::appendTest() {
+    LossList lossList;
+    QVERIFY(lossList.isEmpty());
+
+    lossList.append(seq(10));
+    lossList.append(seq(11), seq(14));
+    lossList.append(seq(20));
+
+    QCOMPARE(lossList.getLength(), 6);
+    QCOMPARE(lossList.getNumRanges(), 2);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(10));
+}
+
+void LossListTests::insertTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(12));
+    lossList.append(seq(20), seq(22));
+    lossList.append(seq(30), seq(32));
+
+    // in a gap, touching nothing
+    lossList.insert(seq(15), seq(16));
+    QCOMPARE(lossList.getLength(), 11);
+    QCOMPARE(lossList.getNumRanges(), 4);
+
+    // touching the ranges on either side
+    lossList.insert(seq(13), seq(14));
+    QCOMPARE(lossList.getLength(), 13);
+    QCOMPARE(lossList.getNumRanges(), 3);
+
+    // overlapping everything
+    lossList.insert(seq(5), seq(40));
+    QCOMPARE(lossList.getLength(), 36);
+    QCOMPARE(lossList.getNumRanges(), 1);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(5));
+}
+
+void LossListTests::removeTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(20));
+
+    QVERIFY(!lossList.remove(seq(9)));
+    QVERIFY(lossList.remove(seq(10)));
+    QVERIFY(lossList.remove(seq(20)));
+    QCOMPARE(lossList.getLength(), 9);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(11));
+
+    // from the middle of the range
+    QVERIFY(lossList.remove(seq(15)));
+    QVERIFY(!lossList.remove(seq(15)));
+    QCOMPARE(lossList.getLength(), 8);
+    QCOMPARE(lossList.getNumRanges(), 2);
+
+    // a range across both halves
+    lossList.remove(seq(13), seq(17));
+    QCOMPARE(lossList.getLength(), 4);
+    QCOMPARE(lossList.getNumRanges(), 2);
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(11));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(12));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(18));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(19));
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::wrapTest() {
+    LossList lossList;
+    lossList.append(seq(SequenceNumber::MAX - 2), seq(SequenceNumber::MAX));
+    lossList.append(seq(0), seq(2));
+
+    QCOMPARE(lossList.getLength(), 6);
+    QCOMPARE(lossList.getNumRanges(), 1);
+
+    QVERIFY(lossList.remove(seq(0)));
+    QCOMPARE(lossList.getNumRanges(), 2);
+
+    // filling the gap back in, by way of the sequence number before zero
+    lossList.insert(seq(0) - 1, seq(0));
+    QCOMPARE(lossList.getLength(), 6);
+    QCOMPARE(lossList.getNumRanges(), 1);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(SequenceNumber::MAX - 2));
+}
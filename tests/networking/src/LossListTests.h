@@ -0,0 +1,32 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that appended and inserted ranges merge with the ones they touch
+    void appendTest();
+    void insertTest();
+
+    // Test removing single sequence numbers and ranges, splitting the ranges they fall in
+    void removeTest();
+
+    // Test ranges that wrap around SequenceNumber::MAX
+    void wrapTest();
+};
+
+#endif // hifi_LossListTests_h
@@ -13,6 +13,7 @@
 #include "../QTestExtensions.h"
 
 #include <NLPacket.h>
+#include <udt/PacketBufferPool.h>
 
 QTEST_MAIN(PacketTests)
 
@@ -180,3 +181,36 @@ void PacketTests::primitiveTest() {
     QCOMPARE(recvPacket->peekPrimitive(&noValue), 0);
     QCOMPARE(recvPacket->readPrimitive(&noValue), 0);
 }
+
+void PacketTests::bufferPoolTest() {
+    // a buffer released on this thread is handed back by the next acquire of the same size class
+    qint64 capacity = 0;
+    auto buffer = udt::PacketBufferPool::acquire(udt::MAX_PACKET_SIZE, capacity);
+    QCOMPARE(capacity, (qint64)udt::MAX_PACKET_SIZE);
+
+    auto address = buffer.get();
+    udt::PacketBufferPool::release(std::move(buffer), capacity);
+
+    udt::PacketBufferPool::resetStats();
+    buffer = udt::PacketBufferPool::acquire(udt::MAX_PACKET_SIZE, capacity);
+    QCOMPARE(buffer.get(), address);
+    QCOMPARE(udt::PacketBufferPool::getStats().hits, (quint64)1);
+
+    // a destroyed packet returns its buffer, and a packet built on a recycled buffer starts out zeroed
+    memset(buffer.get(), 0xff, capacity);
+    udt::PacketBufferPool::release(std::move(buffer), capacity);
+
+    auto packet = NLPacket::create(PacketType::Unknown);
+    QCOMPARE(packet->getData(), address);
+    for (qint64 i = packet->getDataSize(); i < udt::MAX_PACKET_SIZE; ++i) {
+        QCOMPARE(packet->getData()[i], (char)0);
+    }
+
+    packet.reset();
+    buffer = udt::PacketBufferPool::acquire(udt::MAX_PACKET_SIZE, capacity);
+    QCOMPARE(buffer.get(), address);
+
+    // buffers too large for any size class are not pooled
+    auto largeBuffer = udt::PacketBufferPool::acquire(udt::MAX_PACKET_SIZE + 1, capacity);
+    QCOMPARE(capacity, (qint64)udt::MAX_PACKET_SIZE + 1);
+}
@@ -0,0 +1,208 @@
+//
+//  SentPacketBufferTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketBufferTests.h"
+
+#include <unordered_map>
+
+#include <udt/Constants.h>
+#include <udt/SentPacketBuffer.h>
+
+QTEST_MAIN(SentPacketBufferTests)
+
+using namespace udt;
+
+namespace {
+
+SequenceNumber seq(SequenceNumber::Type value) {
+    return SequenceNumber { value };
+}
+
+std::unique_ptr<Packet> createPacket(SequenceNumber sequenceNumber) {
+    auto packet = Packet::create(0, true);
+    packet->writeSequenceNumber(sequenceNumber);
+    return packet;
+}
+
+const int ACKED_PER_ACK = 32;
+const int NAKED_EVERY = 10;
+
+}
+
+void SentPacketBufferTests::findTest() {
+    SentPacketBuffer sentPackets;
+    QVERIFY(sentPackets.isEmpty());
+    QVERIFY(!sentPackets.find(seq(10)));
+
+    for (SequenceNumber::Type i = 10; i < 20; ++i) {
+        sentPackets.insert(seq(i), createPacket(seq(i)));
+    }
+    QCOMPARE(sentPackets.size(), 10);
+
+    QVERIFY(!sentPackets.find(seq(9)));
+    QVERIFY(!sentPackets.find(seq(20)));
+    for (SequenceNumber::Type i = 10; i < 20; ++i) {
+        auto entry = sentPackets.find(seq(i));
+        QVERIFY(entry);
+        QCOMPARE(entry->first, (uint8_t)0);
+        QCOMPARE(entry->second->getSequenceNumber(), seq(i));
+    }
+
+    // skipped sequence numbers are left empty
+    sentPackets.insert(seq(25), createPacket(seq(25)));
+    QCOMPARE(sentPackets.size(), 16);
+    QVERIFY(!sentPackets.find(seq(22)));
+    QVERIFY(sentPackets.find(seq(25)));
+}
+
+void SentPacketBufferTests::removeUpToTest() {
+    SentPacketBuffer sentPackets;
+    for (SequenceNumber::Type i = 100; i < 200; ++i) {
+        sentPackets.insert(seq(i), createPacket(seq(i)));
+    }
+
+    // ACKs of packets that were already removed do nothing
+    sentPackets.removeUpTo(seq(50));
+    QCOMPARE(sentPackets.size(), 100);
+
+    sentPackets.removeUpTo(seq(149));
+    QCOMPARE(sentPackets.size(), 50);
+    QVERIFY(!sentPackets.find(seq(149)));
+    QVERIFY(sentPackets.find(seq(150)));
+
+    // an ACK past the last packet sent empties the buffer
+    sentPackets.removeUpTo(seq(1000));
+    QVERIFY(sentPackets.isEmpty());
+    QVERIFY(!sentPackets.find(seq(150)));
+
+    // and the next packet starts it again
+    sentPackets.insert(seq(1001), createPacket(seq(1001)));
+    QCOMPARE(sentPackets.size(), 1);
+    QVERIFY(sentPackets.find(seq(1001)));
+}
+
+void SentPacketBufferTests::growTest() {
+    SentPacketBuffer sentPackets(16);
+    QCOMPARE(sentPackets.capacity(), 16);
+
+    // move the head off the start of the ring before it has to grow
+    for (SequenceNumber::Type i = 0; i < 10; ++i) {
+        sentPackets.insert(seq(i), createPacket(seq(i)));
+    }
+    sentPackets.removeUpTo(seq(5));
+
+    for (SequenceNumber::Type i = 10; i < 100; ++i) {
+        sentPackets.insert(seq(i), createPacket(seq(i)));
+    }
+    QCOMPARE(sentPackets.capacity(), 128);
+    QCOMPARE(sentPackets.size(), 94);
+
+    for (SequenceNumber::Type i = 6; i < 100; ++i) {
+        auto entry = sentPackets.find(seq(i));
+        QVERIFY(entry);
+        QCOMPARE(entry->second->getSequenceNumber(), seq(i));
+    }
+}
+
+void SentPacketBufferTests::wrapTest() {
+    SentPacketBuffer sentPackets;
+    SequenceNumber first = seq(SequenceNumber::MAX - 10);
+
+    SequenceNumber sequenceNumber = first;
+    for (int i = 0; i < 20; ++i) {
+        sentPackets.insert(sequenceNumber, createPacket(sequenceNumber));
+        ++sequenceNumber;
+    }
+    QCOMPARE(sentPackets.size(), 20);
+    QVERIFY(sentPackets.find(seq(SequenceNumber::MAX)));
+    QVERIFY(sentPackets.find(seq(0)));
+    QVERIFY(sentPackets.find(seq(8)));
+    QVERIFY(!sentPackets.find(seq(9)));
+
+    sentPackets.removeUpTo(seq(2));
+    QCOMPARE(sentPackets.size(), 6);
+    QVERIFY(!sentPackets.find(seq(SequenceNumber::MAX)));
+    QVERIFY(sentPackets.find(seq(3)));
+}
+
+void SentPacketBufferTests::benchmarkSentPacketBuffer_data() {
+    QTest::addColumn<int>("windowSize");
+    QTest::newRow("1024") << 1024;
+    QTest::newRow("max packets in flight") << udt::MAX_PACKETS_IN_FLIGHT;
+}
+
+void SentPacketBufferTests::benchmarkSentPacketBuffer() {
+    QFETCH(int, windowSize);
+
+    SentPacketBuffer sentPackets;
+    SequenceNumber next = seq(SequenceNumber::MAX - windowSize / 2);
+
+    QBENCHMARK {
+        SequenceNumber first = next;
+        for (int i = 0; i < windowSize; ++i) {
+            sentPackets.insert(next, createPacket(next));
+            ++next;
+        }
+
+        SequenceNumber nak = first;
+        for (int i = 0; i < windowSize; i += NAKED_EVERY) {
+            auto entry = sentPackets.find(nak);
+            QVERIFY(entry);
+            ++entry->first;
+            nak += (SequenceNumber::Type)NAKED_EVERY;
+        }
+
+        SequenceNumber ack = first;
+        for (int i = 0; i < windowSize; i += ACKED_PER_ACK) {
+            ack += (SequenceNumber::Type)ACKED_PER_ACK;
+            sentPackets.removeUpTo(ack - 1);
+        }
+        QVERIFY(sentPackets.isEmpty());
+    }
+}
+
+void SentPacketBufferTests::benchmarkUnorderedMap_data() {
+    benchmarkSentPacketBuffer_data();
+}
+
+void SentPacketBufferTests::benchmarkUnorderedMap() {
+    QFETCH(int, windowSize);
+
+    std::unordered_map<SequenceNumber, SentPacketBuffer::PacketResendPair> sentPackets;
+    SequenceNumber next = seq(SequenceNumber::MAX - windowSize / 2);
+
+    QBENCHMARK {
+        SequenceNumber first = next;
+        for (int i = 0; i < windowSize; ++i) {
+            auto& entry = sentPackets[next];
+            entry.first = 0;
+            entry.second = createPacket(next);
+            ++next;
+        }
+
+        SequenceNumber nak = first;
+        for (int i = 0; i < windowSize; i += NAKED_EVERY) {
+            auto it = sentPackets.find(nak);
+            QVERIFY(it != sentPackets.end());
+            ++it->second.first;
+            nak += (SequenceNumber::Type)NAKED_EVERY;
+        }
+
+        SequenceNumber lastACK = first;
+        for (int i = 0; i < windowSize; i += ACKED_PER_ACK) {
+            SequenceNumber ack = lastACK + (SequenceNumber::Type)ACKED_PER_ACK;
+            for (auto sequenceNumber = lastACK; sequenceNumber < ack; ++sequenceNumber) {
+                sentPackets.erase(sequenceNumber);
+            }
+            lastACK = ack;
+        }
+        QVERIFY(sentPackets.empty());
+    }
+}
@@ -0,0 +1,34 @@
+//
+//  SentPacketBufferTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SentPacketBufferTests_h
+#define hifi_SentPacketBufferTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class SentPacketBufferTests : public QObject {
+    Q_OBJECT
+private slots:
+    void findTest();
+    void removeUpToTest();
+    void growTest();
+    void wrapTest();
+
+    // a window of packets is sent, part of it NAKed and retransmitted, and all of it ACKed a few packets at a time
+    // the unordered_map SendQueue used to keep its sent packets in is measured the same way for comparison
+    void benchmarkSentPacketBuffer_data();
+    void benchmarkSentPacketBuffer();
+    void benchmarkUnorderedMap_data();
+    void benchmarkUnorderedMap();
+};
+
+#endif // hifi_SentPacketBufferTests_h
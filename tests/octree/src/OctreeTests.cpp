@@ -12,6 +12,8 @@
 //    * need to add expected results and accumulation of test success/failure
 //
 
+#include <algorithm>
+
 #include <QDebug>
 
 #include <ByteCountCoding.h>
@@ -19,7 +21,9 @@
 #include <EntityTree.h>
 #include <EntityTreeElement.h>
 #include <Octree.h>
+#include <JurisdictionMap.h>
 #include <OctreeConstants.h>
+#include <OctreePacketData.h>
 #include <PropertyFlags.h>
 #include <SharedUtil.h>
 
@@ -827,3 +831,75 @@ void OctreeTests::elementAddChildTests() {
         }
     }
 }
+
+void OctreeTests::packetDataCompressionTests() {
+    // the kind of content entity packets have, strings that repeat from one entity to the next
+    OctreePacketData sent(true);
+    for (int i = 0; i < 8; i++) {
+        QVERIFY(sent.appendValue(QUuid::createUuid()));
+        QVERIFY(sent.appendValue(glm::vec3((float)i, 1.0f, -2.0f)));
+        QVERIFY(sent.appendValue(QString("https://hifi-content.s3.amazonaws.com/models/model%1.fbx").arg(i)));
+        QVERIFY(sent.appendValue(QString("{\"grabbableKey\":{\"grabbable\":false}}")));
+    }
+    int compressedSize = sent.getFinalizedSize();
+    QVERIFY(compressedSize > 0);
+    QVERIFY(compressedSize < sent.getUncompressedSize());
+
+    OctreePacketData received(true);
+    received.loadFinalizedContent(sent.getFinalizedData(), compressedSize);
+    QCOMPARE(received.getUncompressedSize(), sent.getUncompressedSize());
+    QCOMPARE(memcmp(received.getUncompressedData(), sent.getUncompressedData(), sent.getUncompressedSize()), 0);
+
+    // the same packet data compresses the next content from scratch
+    sent.reset();
+    QVERIFY(sent.appendValue(QString("atp:/scripts/script.js")));
+    received.loadFinalizedContent(sent.getFinalizedData(), sent.getFinalizedSize());
+    QCOMPARE(received.getUncompressedSize(), sent.getUncompressedSize());
+    QCOMPARE(memcmp(received.getUncompressedData(), sent.getUncompressedData(), sent.getUncompressedSize()), 0);
+
+    // content that isn't whole is left out
+    received.loadFinalizedContent(sent.getFinalizedData(), sent.getFinalizedSize() / 2);
+    QCOMPARE(received.getUncompressedSize(), 0);
+}
+
+void OctreeTests::jurisdictionPartitionTests() {
+    // the cells four levels down, deeper than the partitions go
+    const int DEPTH = 4;
+    std::vector<OctalCodePtr> cells;
+    cells.push_back(createOctalCodePtr(1));
+    *cells.back() = 0;
+    for (int level = 0; level < DEPTH; level++) {
+        std::vector<OctalCodePtr> children;
+        for (const auto& cell : cells) {
+            for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+                unsigned char* child = childOctalCode(cell.get(), (char)i);
+                size_t bytes = bytesRequiredForCodeLength(*child);
+                children.push_back(createOctalCodePtr(bytes));
+                memcpy(children.back().get(), child, bytes);
+                delete[] child;
+            }
+        }
+        cells.swap(children);
+    }
+
+    // every cell is in the jurisdiction of one partition, and the partitions are about the same size
+    for (int count : { 1, 2, 3, 8, 10, 100 }) {
+        std::vector<JurisdictionMap> partitions;
+        for (int i = 0; i < count; i++) {
+            partitions.push_back(JurisdictionMap(i, count));
+        }
+        std::vector<int> sizes(count, 0);
+        for (const auto& cell : cells) {
+            int owners = 0;
+            for (int i = 0; i < count; i++) {
+                if (partitions[i].isMyJurisdiction(cell.get(), CHECK_NODE_ONLY) == JurisdictionMap::WITHIN) {
+                    owners++;
+                    sizes[i]++;
+                }
+            }
+            QCOMPARE(owners, 1);
+        }
+        auto range = std::minmax_element(sizes.begin(), sizes.end());
+        QVERIFY(*range.second - *range.first <= (int)cells.size() / count / 4 + 8);
+    }
+}
@@ -27,6 +27,9 @@ private slots:
 
     void elementAddChildTests();
 
+    void packetDataCompressionTests();
+    void jurisdictionPartitionTests();
+
     // TODO: Break these into separate test functions
 };
 
@@ -15,6 +15,7 @@
 
 #include <GLMHelpers.h>
 #include <NumericalConstants.h>
+#include <SharedUtil.h>
 #include <ViewFrustum.h>
 
 //#include <StreamUtils.h>
@@ -1345,3 +1346,62 @@ void ViewFrustumTests::testBoxIntersectsKeyhole() {
     box.setBox(boxCenter - halfScaleOffset, boxScale);
     QCOMPARE(view.boxIntersectsKeyhole(box), false); // outside back
 }
+
+static ViewFrustum makeBatchTestView() {
+    ViewFrustum view;
+    view.setProjection(glm::perspective(PI / 2.0f, 16.0f / 9.0f, 0.1f, 100.0f));
+    view.setPosition(glm::vec3(1.2f, 3.4f, 5.6f));
+    view.setOrientation(glm::angleAxis(PI / 5.0f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f))));
+    view.setCenterRadius(5.0f);
+    view.calculate();
+    return view;
+}
+
+void ViewFrustumTests::testBoxesIntersectFrustum() {
+    ViewFrustum view = makeBatchTestView();
+    srand(1);
+
+    const int NUM_BATCHES = 1000;
+    const int BATCH_SIZE = PackedPlanes::BOXES_PER_TEST;
+    for (int batch = 0; batch < NUM_BATCHES; batch++) {
+        // every size of batch, so that the unused lanes are exercised too
+        int count = 1 + batch % BATCH_SIZE;
+        glm::vec3 minimums[BATCH_SIZE];
+        glm::vec3 maximums[BATCH_SIZE];
+        int expected = 0;
+        for (int i = 0; i < count; i++) {
+            glm::vec3 corner(randFloatInRange(-120.0f, 120.0f), randFloatInRange(-120.0f, 120.0f),
+                             randFloatInRange(-120.0f, 120.0f));
+            glm::vec3 scale(randFloatInRange(0.1f, 20.0f), randFloatInRange(0.1f, 20.0f), randFloatInRange(0.1f, 20.0f));
+            minimums[i] = corner;
+            maximums[i] = corner + scale;
+            if (view.boxIntersectsFrustum(AABox(corner, scale))) {
+                expected |= (1 << i);
+            }
+        }
+        QCOMPARE(view.boxesIntersectFrustum(minimums, maximums, count), expected);
+    }
+}
+
+void ViewFrustumTests::testCubesIntersectKeyhole() {
+    ViewFrustum view = makeBatchTestView();
+    srand(2);
+
+    const int NUM_BATCHES = 1000;
+    const int BATCH_SIZE = PackedPlanes::BOXES_PER_TEST;
+    for (int batch = 0; batch < NUM_BATCHES; batch++) {
+        int count = 1 + batch % BATCH_SIZE;
+        AACube cubes[BATCH_SIZE];
+        int expected = 0;
+        for (int i = 0; i < count; i++) {
+            // near the eye, so that some only touch the central sphere
+            glm::vec3 corner(randFloatInRange(-20.0f, 20.0f), randFloatInRange(-20.0f, 20.0f),
+                             randFloatInRange(-20.0f, 20.0f));
+            cubes[i] = AACube(view.getPosition() + corner, randFloatInRange(0.1f, 5.0f));
+            if (view.cubeIntersectsKeyhole(cubes[i])) {
+                expected |= (1 << i);
+            }
+        }
+        QCOMPARE(view.cubesIntersectKeyhole(cubes, count), expected);
+    }
+}
@@ -27,6 +27,8 @@ private slots:
     void testSphereIntersectsKeyhole();
     void testCubeIntersectsKeyhole();
     void testBoxIntersectsKeyhole();
+    void testBoxesIntersectFrustum();
+    void testCubesIntersectKeyhole();
 };
 
 #endif // hifi_ViewFruxtumTests_h
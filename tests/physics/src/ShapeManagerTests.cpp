@@ -185,7 +185,7 @@ void ShapeManagerTests::addCapsuleShape() {
     */
 }
 
-void ShapeManagerTests::addCompoundShape() {
+static ShapeInfo makeCompoundShapeInfo(int numHulls) {
     // initialize some points for generating tetrahedral convex hulls
     QVector<glm::vec3> tetrahedron;
     tetrahedron.push_back(glm::vec3(1.0f, 1.0f, 1.0f));
@@ -196,7 +196,6 @@ void ShapeManagerTests::addCompoundShape() {
 
     // compute the points of the hulls
     ShapeInfo::PointCollection pointCollection;
-    int numHulls = 5;
     glm::vec3 offsetNormal(1.0f, 0.0f, 0.0f);
     Extents extents;
     for (int i = 0; i < numHulls; ++i) {
@@ -216,6 +215,12 @@ void ShapeManagerTests::addCompoundShape() {
     glm::vec3 halfExtents = 0.5f * (extents.maximum - extents.minimum);
     info.setParams(SHAPE_TYPE_COMPOUND, halfExtents);
     info.setPointCollection(pointCollection);
+    return info;
+}
+
+void ShapeManagerTests::addCompoundShape() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
 
     // create the shape
     ShapeManager shapeManager;
@@ -238,8 +243,46 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 1);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 
-    // collect garbage
+    // collect garbage, the hulls are kept in case they are needed again
     shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shapeManager.getNumReferences(info), 0);
+    const btCollisionShape* otherShape = shapeManager.getShape(info);
+    QCOMPARE(otherShape, shape);
+    shapeManager.releaseShape(otherShape);
+
+    // until all garbage is collected
+    shapeManager.collectAllGarbage();
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+void ShapeManagerTests::addCompoundShapeInBackground() {
+    int numHulls = 3;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
+
+    // the first request starts building the shape, which isn't there yet
+    ShapeManager shapeManager;
+    const btCollisionShape* shape = shapeManager.requestShape(info);
+    QVERIFY(shape == nullptr);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+
+    // once built, the next request gets it
+    shapeManager.waitForPendingShapes();
+    shape = shapeManager.requestShape(info);
+    QVERIFY(shape != nullptr);
+    QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<const btCompoundShape*>(shape)->getNumChildShapes(), numHulls);
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shapeManager.getNumReferences(info), 1);
+
+    // further requests get the same shape right away
+    const btCollisionShape* otherShape = shapeManager.requestShape(info);
+    QCOMPARE(otherShape, shape);
+    QCOMPARE(shapeManager.getNumReferences(info), 2);
+
+    // simple shapes are never deferred
+    ShapeInfo boxInfo;
+    boxInfo.setBox(glm::vec3(1.0f));
+    QVERIFY(shapeManager.requestShape(boxInfo) != nullptr);
+}
@@ -0,0 +1,246 @@
+//
+//  Benchmark.cpp
+//  tests/render-perf/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+#include <gpu/Texture.h>
+#include <NumericalConstants.h>
+
+// differences below a twentieth of a millisecond are noise, however large they are relative to the baseline
+static const double NOISE_FLOOR_MSECS = 0.05;
+
+static glm::vec3 toVec3(const QJsonValue& value) {
+    auto array = value.toArray();
+    return glm::vec3(array.at(0).toDouble(), array.at(1).toDouble(), array.at(2).toDouble());
+}
+
+static glm::quat toQuat(const QJsonValue& value) {
+    auto array = value.toArray();
+    if (array.size() < 4) {
+        return glm::quat();
+    }
+    return glm::normalize(glm::quat(array.at(3).toDouble(), array.at(0).toDouble(), array.at(1).toDouble(),
+                                    array.at(2).toDouble()));
+}
+
+bool Benchmark::load(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open benchmark" << fileName;
+        return false;
+    }
+    QJsonParseError error;
+    auto document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (!document.isObject()) {
+        qWarning() << "Cannot parse benchmark" << fileName << error.errorString();
+        return false;
+    }
+    auto object = document.object();
+
+    QFileInfo fileInfo(fileName);
+    _name = object["name"].toString(fileInfo.baseName());
+    _scenePath = object["scene"].toString();
+    if (!_scenePath.isEmpty() && QFileInfo(_scenePath).isRelative()) {
+        _scenePath = fileInfo.absolutePath() + "/" + _scenePath;
+    }
+    _warmupSeconds = (float)object["warmupSeconds"].toDouble(_warmupSeconds);
+    _loadTimeoutSeconds = (float)object["loadTimeoutSeconds"].toDouble(_loadTimeoutSeconds);
+    _measureSeconds = (float)object["measureSeconds"].toDouble(_measureSeconds);
+    _tolerancePercent = (float)object["tolerancePercent"].toDouble(_tolerancePercent);
+
+    _path.clear();
+    for (const auto& value : object["path"].toArray()) {
+        auto keyframe = value.toObject();
+        _path.push_back({ (float)keyframe["time"].toDouble(), toVec3(keyframe["position"]), toQuat(keyframe["orientation"]) });
+    }
+    std::sort(_path.begin(), _path.end(), [](const Keyframe& a, const Keyframe& b) {
+        return a.time < b.time;
+    });
+    if (_path.empty()) {
+        qWarning() << "Benchmark" << fileName << "has no camera path";
+        return false;
+    }
+
+    _phase = LOADING;
+    _phaseStart = 0;
+    _frames.clear();
+    _stages.clear();
+    return true;
+}
+
+void Benchmark::samplePath(float time, glm::vec3& position, glm::quat& orientation) const {
+    float duration = _path.back().time;
+    if (duration > 0.0f) {
+        time = fmodf(time, duration);
+    }
+    auto next = std::upper_bound(_path.begin(), _path.end(), time, [](float time, const Keyframe& keyframe) {
+        return time < keyframe.time;
+    });
+    if (next == _path.begin() || next == _path.end()) {
+        const auto& keyframe = (next == _path.end()) ? _path.back() : _path.front();
+        position = keyframe.position;
+        orientation = keyframe.orientation;
+        return;
+    }
+    const auto& previous = *(next - 1);
+    float alpha = (time - previous.time) / (next->time - previous.time);
+    position = glm::mix(previous.position, next->position, alpha);
+    orientation = glm::slerp(previous.orientation, next->orientation, alpha);
+}
+
+void Benchmark::update(uint64_t now, bool isLoading, glm::vec3& position, glm::quat& orientation) {
+    if (_phaseStart == 0) {
+        _phaseStart = now;
+    }
+    float seconds = (float)(now - _phaseStart) / USECS_PER_SECOND;
+
+    switch (_phase) {
+        case LOADING:
+            if (!isLoading || seconds >= _loadTimeoutSeconds) {
+                if (isLoading) {
+                    qWarning() << "Benchmark" << _name << "is still loading after" << seconds << "seconds";
+                }
+                qDebug() << "Benchmark" << _name << "warming up";
+                _phase = WARMUP;
+                _phaseStart = now;
+            }
+            break;
+
+        case WARMUP:
+            if (seconds >= _warmupSeconds) {
+                qDebug() << "Benchmark" << _name << "measuring";
+                _phase = MEASURE;
+                _phaseStart = now;
+                seconds = 0.0f;
+            }
+            break;
+
+        case MEASURE:
+            if (seconds >= _measureSeconds) {
+                qDebug() << "Benchmark" << _name << "done after" << _frames.size() << "frames";
+                _phase = DONE;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    samplePath(_phase == MEASURE ? seconds : 0.0f, position, orientation);
+}
+
+void Benchmark::addFrame(const Frame& frame) {
+    if (_phase == MEASURE) {
+        _frames.push_back(frame);
+    }
+}
+
+template <typename F>
+static QJsonObject summarize(const std::vector<Benchmark::Frame>& frames, F getValue) {
+    std::vector<double> values;
+    values.reserve(frames.size());
+    double total = 0.0;
+    for (const auto& frame : frames) {
+        values.push_back(getValue(frame));
+        total += values.back();
+    }
+    if (values.empty()) {
+        return QJsonObject();
+    }
+    std::sort(values.begin(), values.end());
+    auto percentile = [&](double p) {
+        return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+    };
+    return QJsonObject {
+        { "mean", total / values.size() },
+        { "p50", percentile(0.5) },
+        { "p95", percentile(0.95) },
+        { "p99", percentile(0.99) },
+        { "max", values.back() }
+    };
+}
+
+QJsonObject Benchmark::getResults() const {
+    QJsonObject stages;
+    for (const auto& stage : _stages) {
+        stages[QString::fromStdString(stage.path)] = QJsonObject {
+            { "cpuMsecs", stage.cpuRunTime },
+            { "gpuMsecs", stage.gpuRunTime }
+        };
+    }
+
+    return QJsonObject {
+        { "name", _name },
+        { "frames", (int)_frames.size() },
+        { "cpuMsecs", summarize(_frames, [](const Frame& frame) { return frame.cpuMsecs; }) },
+        { "gpuMsecs", summarize(_frames, [](const Frame& frame) { return frame.gpuMsecs; }) },
+        { "drawcalls", summarize(_frames, [](const Frame& frame) { return (double)frame.drawcalls; }) },
+        { "triangles", summarize(_frames, [](const Frame& frame) { return (double)frame.triangles; }) },
+        { "stages", stages },
+        { "memory", QJsonObject {
+            { "gpuUsedBytes", (double)gpu::Context::getUsedGPUMemSize() },
+            { "gpuTextureBytes", (double)gpu::Context::getTextureGPUMemSize() },
+            { "gpuBufferBytes", (double)gpu::Context::getBufferGPUMemSize() },
+            { "cpuTextureBytes", (double)gpu::Texture::getTextureCPUMemSize() }
+        } }
+    };
+}
+
+// flattens { "a": { "b": 1 } } into { "a.b": 1 }
+static void flatten(const QJsonObject& object, const QString& prefix, QVariantMap& values) {
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        QString key = prefix.isEmpty() ? it.key() : prefix + "." + it.key();
+        if (it.value().isObject()) {
+            flatten(it.value().toObject(), key, values);
+        } else if (it.value().isDouble()) {
+            values[key] = it.value().toDouble();
+        }
+    }
+}
+
+int Benchmark::compare(const QJsonObject& results, const QJsonObject& baseline, float tolerancePercent) {
+    QVariantMap current;
+    QVariantMap base;
+    flatten(results, QString(), current);
+    flatten(baseline, QString(), base);
+
+    // the frame count and the worst frame are too noisy to gate on
+    current.remove("frames");
+    double tolerance = 1.0 + tolerancePercent / 100.0;
+
+    int regressions = 0;
+    for (auto it = current.begin(); it != current.end(); ++it) {
+        if (!base.contains(it.key()) || it.key().endsWith(".max")) {
+            continue;
+        }
+        double value = it.value().toDouble();
+        double baseValue = base[it.key()].toDouble();
+        bool isTime = it.key().contains("Msecs");
+        bool isRegression = value > baseValue * tolerance && (!isTime || value - baseValue > NOISE_FLOOR_MSECS);
+
+        QString change = baseValue > 0.0 ? QString::number(100.0 * (value - baseValue) / baseValue, 'f', 1) + "%" : "-";
+        if (isRegression) {
+            ++regressions;
+            qWarning().noquote() << "REGRESSION" << it.key() << baseValue << "->" << value << change;
+        } else {
+            qDebug().noquote() << it.key() << baseValue << "->" << value << change;
+        }
+    }
+    return regressions;
+}
@@ -0,0 +1,88 @@
+//
+//  Benchmark.h
+//  tests/render-perf/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+#include <GLMHelpers.h>
+#include <gpu/Context.h>
+#include <render/JobProfiler.h>
+
+// A repeatable render benchmark, described by a JSON file:
+//   {
+//     "name": "...",
+//     "scene": "scene.json",      the content snapshot, relative to the benchmark file
+//     "warmupSeconds": 5,         after the scene finished loading, to settle the caches
+//     "loadTimeoutSeconds": 60,
+//     "measureSeconds": 20,       the path loops if it is shorter
+//     "path": [ { "time": 0, "position": [ x, y, z ], "orientation": [ x, y, z, w ] }, ... ],
+//     "tolerancePercent": 10      how much slower than the baseline counts as a regression
+//   }
+// The camera sits at the start of the path until the measurement starts, then follows it.
+class Benchmark {
+public:
+    enum Phase {
+        LOADING = 0,
+        WARMUP,
+        MEASURE,
+        DONE
+    };
+
+    struct Frame {
+        double cpuMsecs;
+        double gpuMsecs;
+        int drawcalls;
+        int triangles;
+    };
+
+    // returns false, and logs why, if the file can't be read
+    bool load(const QString& fileName);
+
+    const QString& getName() const { return _name; }
+    const QString& getScenePath() const { return _scenePath; }
+    float getTolerancePercent() const { return _tolerancePercent; }
+    Phase getPhase() const { return _phase; }
+
+    // advances the phase and returns the camera pose for the frame about to render
+    void update(uint64_t now, bool isLoading, glm::vec3& position, glm::quat& orientation);
+    void addFrame(const Frame& frame);
+    void setStages(const render::JobProfiler::Timings& timings) { _stages = timings; }
+
+    QJsonObject getResults() const;
+
+    // compares results to a baseline, logs every metric and returns the number of regressions
+    static int compare(const QJsonObject& results, const QJsonObject& baseline, float tolerancePercent);
+
+private:
+    struct Keyframe {
+        float time;
+        glm::vec3 position;
+        glm::quat orientation;
+    };
+
+    void samplePath(float time, glm::vec3& position, glm::quat& orientation) const;
+
+    QString _name;
+    QString _scenePath;
+    float _warmupSeconds { 5.0f };
+    float _loadTimeoutSeconds { 60.0f };
+    float _measureSeconds { 20.0f };
+    float _tolerancePercent { 10.0f };
+    std::vector<Keyframe> _path;
+
+    Phase _phase { LOADING };
+    uint64_t _phaseStart { 0 };
+    std::vector<Frame> _frames;
+    render::JobProfiler::Timings _stages;
+};
@@ -16,8 +16,11 @@
 
 #include <QProcessEnvironment>
 
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QDir>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QSettings>
@@ -54,9 +57,11 @@
 #include <WebEntityItem.h>
 #include <OctreeUtils.h>
 #include <render/Engine.h>
+#include <render/EngineStats.h>
 #include <Model.h>
 #include <model/Stage.h>
 #include <TextureCache.h>
+#include <ResourceCache.h>
 #include <FramebufferCache.h>
 #include <model-networking/ModelCache.h>
 #include <GeometryCache.h>
@@ -72,6 +77,7 @@
 #include <AddressManager.h>
 #include <SceneScriptingInterface.h>
 
+#include "Benchmark.h"
 #include "Camera.hpp"
 
 Q_DECLARE_LOGGING_CATEGORY(renderperflogging)
@@ -205,6 +211,7 @@ public:
     std::mutex _frameLock;
     std::queue<gpu::FramePointer> _pendingFrames;
     gpu::FramePointer _activeFrame;
+    gpu::ContextStats _lastFrameStats;
     QSize _size;
     static const size_t FRAME_TIME_BUFFER_SIZE { 8192 };
 
@@ -213,6 +220,11 @@ public:
         _pendingFrames.push(frame);
     }
 
+    gpu::ContextStats getLastFrameStats() {
+        std::unique_lock<std::mutex> lock(_frameLock);
+        return _lastFrameStats;
+    }
+
     void initialize(QWindow* window, gl::Context& initContext) {
         setObjectName("RenderThread");
         _context.setWindow(window);
@@ -280,6 +292,10 @@ public:
         _backend->syncCache();
         if (frame && !frame->batches.empty()) {
             _gpuContext->executeFrame(frame);
+            {
+                std::unique_lock<std::mutex> lock(_frameLock);
+                _gpuContext->getFrameStats(_lastFrameStats);
+            }
 
             {
 
@@ -590,6 +606,28 @@ public:
         _commandIndex = 0;
     }
 
+    // Runs the benchmark instead of the commands, writes its results, then exits with 1 if they regressed
+    // from the baseline
+    bool loadBenchmark(const QString& fileName, const QString& resultsFile, const QString& baselineFile) {
+        std::unique_ptr<Benchmark> benchmark { new Benchmark() };
+        if (!benchmark->load(fileName)) {
+            return false;
+        }
+        _resultsFile = resultsFile;
+        _baselineFile = baselineFile;
+        _commands.clear();
+
+        auto profilerConfig = _renderEngine->getConfiguration()->getConfig<render::EngineProfiler>("Profiler");
+        if (profilerConfig) {
+            profilerConfig->setProperty("profiling", true);
+        }
+        if (!benchmark->getScenePath().isEmpty()) {
+            importScene(benchmark->getScenePath());
+        }
+        _benchmark.swap(benchmark);
+        return true;
+    }
+
 protected:
 
     bool eventFilter(QObject *obj, QEvent *event) override {
@@ -679,6 +717,7 @@ private:
             return;
         }
         _renderCount = _renderThread._presentCount.load();
+        auto frameStart = usecTimestampNow();
         update();
 
         RenderArgs renderArgs(_renderThread._gpuContext, DEFAULT_OCTREE_SIZE_SCALE,
@@ -725,6 +764,19 @@ private:
         // Final framebuffer that will be handled to the display-plugin
         render(&renderArgs);
 
+        if (_benchmark) {
+            auto frameStats = _renderThread.getLastFrameStats();
+            _benchmark->addFrame({
+                (double)(usecTimestampNow() - frameStart) / USECS_PER_MSEC,
+                renderArgs._context->getFrameTimerGPUAverage(),
+                frameStats._DSNumDrawcalls,
+                frameStats._DSNumTriangles
+            });
+            if (_benchmark->getPhase() == Benchmark::DONE) {
+                finishBenchmark();
+            }
+        }
+
         if (_fps != _renderThread._fps) {
             _fps = _renderThread._fps;
             updateText();
@@ -779,6 +831,34 @@ private:
 #endif
     }
 
+    void finishBenchmark() {
+        _benchmark->setStages(_renderEngine->getRenderContext()->_jobProfiler->getTimings());
+        auto results = _benchmark->getResults();
+        if (!_resultsFile.isEmpty()) {
+            QFile file(_resultsFile);
+            if (file.open(QIODevice::WriteOnly)) {
+                file.write(QJsonDocument(results).toJson());
+            } else {
+                qWarning() << "Cannot write benchmark results to" << _resultsFile;
+            }
+        }
+
+        int regressions = 0;
+        if (!_baselineFile.isEmpty()) {
+            QFile file(_baselineFile);
+            if (file.open(QIODevice::ReadOnly)) {
+                auto baseline = QJsonDocument::fromJson(file.readAll()).object();
+                regressions = Benchmark::compare(results, baseline, _benchmark->getTolerancePercent());
+                qDebug() << "Benchmark" << _benchmark->getName() << "found" << regressions << "regressions";
+            } else {
+                qWarning() << "Cannot read benchmark baseline" << _baselineFile;
+            }
+        }
+
+        _benchmark.reset();
+        QCoreApplication::exit(regressions > 0 ? 1 : 0);
+    }
+
     void runCommand(const QString& command) {
         qDebug() << "Running command: " << command;
         QStringList commandParams = command.split(QRegularExpression(QString("\\s")));
@@ -850,6 +930,15 @@ private:
 
         runNextCommand(now);
 
+        if (_benchmark) {
+            bool isLoading = ResourceCache::getLoadingRequestCount() > 0 || ResourceCache::getPendingRequestCount() > 0;
+            glm::vec3 position;
+            glm::quat orientation;
+            _benchmark->update(now, isLoading, position, orientation);
+            _camera.setPosition(position);
+            _camera.setRotation(orientation);
+        }
+
         float delta = now - last;
         // Update the camera
         _camera.update(delta / USECS_PER_SECOND);
@@ -1107,6 +1196,10 @@ private:
     int _commandIndex { -1 };
     uint64_t _nextCommandTime { 0 };
 
+    std::unique_ptr<Benchmark> _benchmark;
+    QString _resultsFile;
+    QString _baselineFile;
+
     //TextOverlay* _textOverlay;
     static bool _cullingEnabled;
 
@@ -1148,11 +1241,43 @@ int main(int argc, char** argv) {
 
     qInstallMessageHandler(messageHandler);
     QLoggingCategory::setFilterRules(LOG_FILTER_RULES);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders a scene, or benchmarks it along a camera path");
+    parser.addHelpOption();
+    const QCommandLineOption benchmarkOption("benchmark", "run the benchmark described by <file> and exit", "file");
+    const QCommandLineOption resultsOption("results", "write the benchmark results to <file>", "file");
+    const QCommandLineOption baselineOption("baseline", "compare the results to the baseline in <file>", "file");
+    const QCommandLineOption compareOption("compare", "compare the results in <file> to the baseline, and exit", "file");
+    const QCommandLineOption toleranceOption("tolerance", "percent slower than the baseline that is a regression, for --compare", "percent", "10");
+    parser.addOption(benchmarkOption);
+    parser.addOption(resultsOption);
+    parser.addOption(baselineOption);
+    parser.addOption(compareOption);
+    parser.addOption(toleranceOption);
+    parser.process(app);
+
+    // comparing results offline doesn't render anything
+    if (parser.isSet(compareOption)) {
+        QFile resultsFile(parser.value(compareOption));
+        QFile baselineFile(parser.value(baselineOption));
+        if (!resultsFile.open(QIODevice::ReadOnly) || !baselineFile.open(QIODevice::ReadOnly)) {
+            qWarning() << "--compare needs readable results and --baseline files";
+            return 2;
+        }
+        auto results = QJsonDocument::fromJson(resultsFile.readAll()).object();
+        auto baseline = QJsonDocument::fromJson(baselineFile.readAll()).object();
+        return Benchmark::compare(results, baseline, parser.value(toleranceOption).toFloat()) > 0 ? 1 : 0;
+    }
+
     QTestWindow::setup();
     QTestWindow window;
     //window.loadCommands("C:/Users/bdavis/Git/dreaming/exports2/commands.txt");
-    app.exec();
-    return 0;
+    if (parser.isSet(benchmarkOption) &&
+        !window.loadBenchmark(parser.value(benchmarkOption), parser.value(resultsOption), parser.value(baselineOption))) {
+        return 2;
+    }
+    return app.exec();
 }
 
 #include "main.moc"
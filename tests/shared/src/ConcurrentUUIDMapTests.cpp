@@ -0,0 +1,114 @@
+//
+//  ConcurrentUUIDMapTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ConcurrentUUIDMapTests.h"
+
+#include <atomic>
+#include <thread>
+
+#include <shared/ConcurrentUUIDMap.h>
+
+QTEST_MAIN(ConcurrentUUIDMapTests)
+
+void ConcurrentUUIDMapTests::insertAndRemove() {
+    ConcurrentUUIDMap<int> map;
+    QUuid id = QUuid::createUuid();
+
+    QVERIFY(!map.value(id));
+    QVERIFY(map.insert(id, std::make_shared<int>(1)));
+    QVERIFY(!map.insert(id, std::make_shared<int>(2)));
+    QCOMPARE(*map.value(id), 1);
+    QCOMPARE(map.size(), 1);
+
+    QVERIFY(map.remove(id));
+    QVERIFY(!map.remove(id));
+    QVERIFY(!map.value(id));
+    QCOMPARE(map.size(), 0);
+
+    // the same key can come back after being removed
+    QVERIFY(map.insert(id, std::make_shared<int>(3)));
+    QCOMPARE(*map.value(id), 3);
+}
+
+void ConcurrentUUIDMapTests::growAndShrink() {
+    const int NUM_VALUES = 10000;
+
+    ConcurrentUUIDMap<int> map;
+    QVector<QUuid> ids;
+    for (int i = 0; i < NUM_VALUES; ++i) {
+        ids.push_back(QUuid::createUuid());
+        QVERIFY(map.insert(ids[i], std::make_shared<int>(i)));
+    }
+    QCOMPARE(map.size(), NUM_VALUES);
+
+    for (int i = 0; i < NUM_VALUES; i += 2) {
+        QVERIFY(map.remove(ids[i]));
+    }
+    QCOMPARE(map.size(), NUM_VALUES / 2);
+    QCOMPARE(map.values().size(), NUM_VALUES / 2);
+
+    for (int i = 0; i < NUM_VALUES; ++i) {
+        auto value = map.value(ids[i]);
+        if (i % 2) {
+            QVERIFY(value);
+            QCOMPARE(*value, i);
+        } else {
+            QVERIFY(!value);
+        }
+    }
+
+    map.clear();
+    QCOMPARE(map.size(), 0);
+    QVERIFY(!map.value(ids[1]));
+}
+
+void ConcurrentUUIDMapTests::concurrentReads() {
+    const int NUM_STABLE_VALUES = 1000;
+    const int NUM_CHURN_PASSES = 20;
+    const int NUM_CHURN_VALUES = 5000;
+
+    ConcurrentUUIDMap<int> map;
+    QVector<QUuid> ids;
+    for (int i = 0; i < NUM_STABLE_VALUES; ++i) {
+        ids.push_back(QUuid::createUuid());
+        map.insert(ids[i], std::make_shared<int>(i));
+    }
+
+    // values that are never removed must always be found while other values come and go and the table is rebuilt
+    std::atomic<bool> stop { false };
+    std::atomic<int> misses { 0 };
+    std::thread reader([&] {
+        while (!stop) {
+            for (int i = 0; i < NUM_STABLE_VALUES; ++i) {
+                auto value = map.value(ids[i]);
+                if (!value || *value != i) {
+                    ++misses;
+                }
+            }
+        }
+    });
+
+    for (int pass = 0; pass < NUM_CHURN_PASSES; ++pass) {
+        QVector<QUuid> churnIDs;
+        for (int i = 0; i < NUM_CHURN_VALUES; ++i) {
+            churnIDs.push_back(QUuid::createUuid());
+            map.insert(churnIDs.back(), std::make_shared<int>(-1));
+        }
+        for (auto& id : churnIDs) {
+            map.remove(id);
+        }
+    }
+
+    stop = true;
+    reader.join();
+
+    QCOMPARE(misses.load(), 0);
+    QCOMPARE(map.size(), NUM_STABLE_VALUES);
+}
@@ -0,0 +1,25 @@
+//
+//  ConcurrentUUIDMapTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ConcurrentUUIDMapTests_h
+#define hifi_ConcurrentUUIDMapTests_h
+
+#include <QtTest/QtTest>
+
+class ConcurrentUUIDMapTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void insertAndRemove();
+    void growAndShrink();
+    void concurrentReads();
+};
+
+#endif // hifi_ConcurrentUUIDMapTests_h
@@ -156,6 +156,19 @@ void FileCacheTests::testWipe() {
     QCOMPARE(getCacheDirectorySize(), (size_t)0);
 }
 
+void FileCacheTests::testIndexedFileRemoved() {
+    auto cache = makeFileCache(_testDir.path());
+    QVERIFY(cache->writeFile(TEST_DATA.data(), FileCache::Metadata(getFileKey(0), TEST_DATA.size())).get());
+    QVERIFY(cache->writeFile(TEST_DATA.data(), FileCache::Metadata(getFileKey(1), TEST_DATA.size())).get());
+    cache.reset();
+
+    // the next cache comes up from its index, which still has the file removed from under it
+    QVERIFY(QDir(_testDir.path()).remove(QString::fromStdString(getFileKey(0)) + ".tmp"));
+    cache = makeFileCache(_testDir.path());
+    QVERIFY(!cache->getFile(getFileKey(0)).get());
+    QVERIFY(cache->getFile(getFileKey(1)).get());
+    QCOMPARE(cache->getNumTotalFiles(), (size_t)1);
+}
 
 void FileCacheTests::cleanupTestCase() {
 }
@@ -0,0 +1,81 @@
+//
+//  MPSCRingBufferTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MPSCRingBufferTests.h"
+
+#include <thread>
+#include <vector>
+
+#include <shared/MPSCRingBuffer.h>
+
+QTEST_MAIN(MPSCRingBufferTests)
+
+void MPSCRingBufferTests::pushAndPop() {
+    MPSCRingBuffer<int> buffer(4);
+    int value = -1;
+
+    QVERIFY(buffer.empty());
+    QVERIFY(!buffer.pop(value));
+
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(buffer.push(i));
+    }
+    QVERIFY(!buffer.push(4));
+
+    // values come out in order, and popping one makes room for another
+    QVERIFY(buffer.pop(value));
+    QCOMPARE(value, 0);
+    QVERIFY(buffer.push(4));
+
+    for (int i = 1; i <= 4; ++i) {
+        QVERIFY(buffer.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(buffer.empty());
+}
+
+void MPSCRingBufferTests::concurrentProducers() {
+    const int NUM_PRODUCERS = 4;
+    const int NUM_VALUES_PER_PRODUCER = 100000;
+
+    MPSCRingBuffer<int> buffer(64);
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < NUM_PRODUCERS; ++producer) {
+        producers.emplace_back([&buffer, producer] {
+            for (int i = 0; i < NUM_VALUES_PER_PRODUCER; ++i) {
+                while (!buffer.push(producer * NUM_VALUES_PER_PRODUCER + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // every value arrives exactly once, and each producer's values arrive in the order it pushed them
+    std::vector<int> lastValues(NUM_PRODUCERS, -1);
+    int numReceived = 0;
+    bool inOrder = true;
+    while (numReceived < NUM_PRODUCERS * NUM_VALUES_PER_PRODUCER) {
+        int value;
+        if (buffer.pop(value)) {
+            int producer = value / NUM_VALUES_PER_PRODUCER;
+            int index = value % NUM_VALUES_PER_PRODUCER;
+            inOrder = inOrder && index == lastValues[producer] + 1;
+            lastValues[producer] = index;
+            ++numReceived;
+        }
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    QVERIFY(inOrder);
+    QVERIFY(buffer.empty());
+}
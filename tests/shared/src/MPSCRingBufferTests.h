@@ -0,0 +1,24 @@
+//
+//  MPSCRingBufferTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MPSCRingBufferTests_h
+#define hifi_MPSCRingBufferTests_h
+
+#include <QtTest/QtTest>
+
+class MPSCRingBufferTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void pushAndPop();
+    void concurrentProducers();
+};
+
+#endif // hifi_MPSCRingBufferTests_h
@@ -0,0 +1,45 @@
+//
+//  MetricsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MetricsTests.h"
+
+#include <shared/Metrics.h>
+
+QTEST_MAIN(MetricsTests)
+
+void MetricsTests::histogramBuckets() {
+    metrics::Histogram histogram({ 10.0, 100.0 });
+    histogram.observe(5.0);
+    histogram.observe(10.0); // bounds are inclusive
+    histogram.observe(50.0);
+    histogram.observe(500.0);
+
+    QCOMPARE((int)histogram.getBucketCount(0), 2);
+    QCOMPARE((int)histogram.getBucketCount(1), 1);
+    QCOMPARE((int)histogram.getBucketCount(2), 1);
+    QCOMPARE((int)histogram.getCount(), 4);
+    QCOMPARE(histogram.getSum(), 565.0);
+}
+
+void MetricsTests::openMetricsText() {
+    auto& registry = metrics::Registry::getInstance();
+    registry.counter("test_requests", "Requests").increment(3);
+    registry.gauge("test_level", "Level", "side=\"left\"").set(0.5);
+    registry.histogram("test_usecs", "Timing", { 1.0 }).observe(2.0);
+
+    QString text = QString::fromUtf8(registry.toOpenMetrics());
+    QVERIFY(text.contains("# TYPE test_requests counter\n"));
+    QVERIFY(text.contains("test_requests_total 3\n"));
+    QVERIFY(text.contains("test_level{side=\"left\"} 0.5\n"));
+    QVERIFY(text.contains("test_usecs_bucket{le=\"1\"} 0\n"));
+    QVERIFY(text.contains("test_usecs_bucket{le=\"+Inf\"} 1\n"));
+    QVERIFY(text.contains("test_usecs_count 1\n"));
+    QVERIFY(text.endsWith("# EOF\n"));
+}
@@ -0,0 +1,99 @@
+//
+//  PoolAllocatorTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PoolAllocatorTests.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <shared/PoolAllocator.h>
+
+QTEST_MAIN(PoolAllocatorTests)
+
+namespace {
+
+class Counted {
+public:
+    static int count;
+
+    Counted(int value) : value(value) { ++count; }
+    ~Counted() { --count; }
+
+    int value;
+};
+
+int Counted::count = 0;
+
+}
+
+void PoolAllocatorTests::reuseFreedBlocks() {
+    BlockPool pool(24, 8, 4);
+    QCOMPARE((int)pool.getBlockSize(), 24);
+
+    void* first = pool.allocate();
+    void* second = pool.allocate();
+    QVERIFY(first != second);
+    QCOMPARE((int)pool.getAllocatedCount(), 2);
+
+    pool.deallocate(first);
+    QCOMPARE((int)pool.getAllocatedCount(), 1);
+    QCOMPARE(pool.allocate(), first);
+
+    pool.deallocate(first);
+    pool.deallocate(second);
+    QCOMPARE((int)pool.getAllocatedCount(), 0);
+    QCOMPARE((int)pool.getCapacity(), 4);
+}
+
+void PoolAllocatorTests::growBySlabs() {
+    // blocks are at least big enough to be linked and are rounded up to their alignment
+    BlockPool pool(1, 16, 3);
+    QCOMPARE((int)pool.getBlockSize(), 16);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 7; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    QCOMPARE((int)pool.getCapacity(), 9);
+    for (auto block : blocks) {
+        QCOMPARE((int)(reinterpret_cast<uintptr_t>(block) % 16), 0);
+    }
+
+    // the blocks of a slab are handed out one after another
+    QCOMPARE(static_cast<char*>(blocks[1]) - static_cast<char*>(blocks[0]), (ptrdiff_t)16);
+
+    for (auto block : blocks) {
+        pool.deallocate(block);
+    }
+    QCOMPARE((int)pool.getAllocatedCount(), 0);
+}
+
+void PoolAllocatorTests::sharedPointers() {
+    {
+        std::vector<std::shared_ptr<Counted>> pointers;
+        for (int i = 0; i < 10; ++i) {
+            pointers.push_back(std::allocate_shared<Counted>(PoolAllocator<Counted>(), i));
+        }
+        QCOMPARE(Counted::count, 10);
+        QCOMPARE(pointers[7]->value, 7);
+
+        // what is pooled is the control block with the object in it
+        std::weak_ptr<Counted> weakPointer = pointers[0];
+        pointers.clear();
+        QCOMPARE(Counted::count, 0);
+        QVERIFY(weakPointer.expired());
+    }
+
+    PoolAllocator<Counted> allocator;
+    Counted* array = allocator.allocate(3);
+    QVERIFY(array);
+    allocator.deallocate(array, 3);
+}
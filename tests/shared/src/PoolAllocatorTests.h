@@ -0,0 +1,25 @@
+//
+//  PoolAllocatorTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PoolAllocatorTests_h
+#define hifi_PoolAllocatorTests_h
+
+#include <QtTest/QtTest>
+
+class PoolAllocatorTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void reuseFreedBlocks();
+    void growBySlabs();
+    void sharedPointers();
+};
+
+#endif // hifi_PoolAllocatorTests_h
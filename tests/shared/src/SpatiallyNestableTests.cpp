@@ -0,0 +1,98 @@
+//
+//  SpatiallyNestableTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatiallyNestableTests.h"
+
+#include <QtCore/QHash>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SpatiallyNestable.h>
+#include <StreamUtils.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(SpatiallyNestableTests)
+
+class TestNestable : public SpatiallyNestable {
+public:
+    TestNestable() : SpatiallyNestable(NestableType::Entity, QUuid::createUuid()) {}
+};
+
+class TestParentFinder : public SpatialParentFinder {
+public:
+    SpatiallyNestableWeakPointer find(QUuid parentID, bool& success, SpatialParentTree* entityTree) const override {
+        success = true;
+        return _nestables.value(parentID);
+    }
+
+    QHash<QUuid, SpatiallyNestableWeakPointer> _nestables;
+};
+
+static std::shared_ptr<TestNestable> makeNestable(const QUuid& parentID = QUuid()) {
+    auto nestable = std::make_shared<TestNestable>();
+    DependencyManager::get<SpatialParentFinder>().staticCast<TestParentFinder>()->
+        _nestables[nestable->getID()] = nestable;
+    if (!parentID.isNull()) {
+        nestable->setParentID(parentID);
+    }
+    return nestable;
+}
+
+void SpatiallyNestableTests::initTestCase() {
+    DependencyManager::registerInheritance<SpatialParentFinder, TestParentFinder>();
+    DependencyManager::set<TestParentFinder>();
+}
+
+void SpatiallyNestableTests::cachedTransformFollowsAncestors() {
+    auto root = makeNestable();
+    auto child = makeNestable(root->getID());
+    auto grandchild = makeNestable(child->getID());
+    root->setPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    child->setLocalPosition(glm::vec3(0.0f, 2.0f, 0.0f));
+    grandchild->setLocalPosition(glm::vec3(0.0f, 0.0f, 3.0f));
+
+    root->resolveWorldTransforms();
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(), glm::vec3(1.0f, 2.0f, 3.0f), EPSILON);
+
+    // moving an ancestor reaches the cached transforms below it
+    root->setPosition(glm::vec3(-1.0f, 0.0f, 0.0f));
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(), glm::vec3(-1.0f, 2.0f, 3.0f), EPSILON);
+
+    root->setOrientation(glm::angleAxis(PI, Vectors::UNIT_Y));
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(), glm::vec3(-1.0f, 2.0f, -3.0f), EPSILON);
+
+    child->setLocalPosition(glm::vec3(0.0f));
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(), glm::vec3(-1.0f, 0.0f, -3.0f), EPSILON);
+}
+
+void SpatiallyNestableTests::cachedTransformFollowsReparenting() {
+    auto first = makeNestable();
+    auto second = makeNestable();
+    first->setPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    second->setPosition(glm::vec3(0.0f, 1.0f, 0.0f));
+
+    auto child = makeNestable(first->getID());
+    child->setLocalPosition(glm::vec3(0.0f, 0.0f, 1.0f));
+    QCOMPARE_WITH_ABS_ERROR(child->getPosition(), glm::vec3(1.0f, 0.0f, 1.0f), EPSILON);
+
+    child->setParentID(second->getID());
+    QCOMPARE_WITH_ABS_ERROR(child->getPosition(), glm::vec3(0.0f, 1.0f, 1.0f), EPSILON);
+
+    // a parent at a joint isn't cached through, the joints move on their own
+    child->setParentJointIndex(0);
+    second->setPosition(glm::vec3(0.0f, 2.0f, 0.0f));
+    QCOMPARE_WITH_ABS_ERROR(child->getPosition(), glm::vec3(0.0f, 2.0f, 1.0f), EPSILON);
+}
+
+void SpatiallyNestableTests::cleanupTestCase() {
+    DependencyManager::destroy<SpatialParentFinder>();
+}
@@ -75,3 +75,22 @@ void StorageTests::testConversion() {
         QCOMPARE(fileInfo.size(), (qint64)newSize);
     }
 }
+
+void StorageTests::testResidencyAdvice() {
+    StoragePointer storagePointer = std::unique_ptr<MemoryStorage>(new MemoryStorage(_testData.size(), _testData.data()));
+    storagePointer = storagePointer->toFileStorage(_testFile);
+
+    // advice is a hint, the data reads the same whether its pages stayed in memory or not
+    auto view = storagePointer->createView(_testData.size() - 1, 1);
+    view->advise(Residency::Needed);
+    QCOMPARE(memcmp(_testData.data() + 1, view->data(), view->size()), 0);
+    view->advise(Residency::NotNeeded);
+    QCOMPARE(memcmp(_testData.data() + 1, view->data(), view->size()), 0);
+    storagePointer->advise(Residency::NotNeeded);
+    QCOMPARE(memcmp(_testData.data(), storagePointer->data(), _testData.size()), 0);
+
+    // memory storage ignores it
+    storagePointer = storagePointer->toMemoryStorage();
+    storagePointer->advise(Residency::NotNeeded);
+    QCOMPARE(memcmp(_testData.data(), storagePointer->data(), _testData.size()), 0);
+}
@@ -0,0 +1,79 @@
+//
+//  TimerWheelTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheelTests.h"
+
+#include <vector>
+
+#include <shared/TimerWheel.h>
+
+QTEST_MAIN(TimerWheelTests)
+
+void TimerWheelTests::dueInOrder() {
+    TimerWheel wheel(1000);
+    std::vector<TimerWheel::TimerID> due;
+
+    wheel.insert(1, 1030);
+    wheel.insert(2, 1010);
+    wheel.insert(3, 1020);
+    wheel.insert(4, 900); // already past
+    QCOMPARE((int)wheel.size(), 4);
+
+    wheel.advance(1015, due);
+    QCOMPARE(due, (std::vector<TimerWheel::TimerID> { 4, 2 }));
+
+    due.clear();
+    wheel.advance(1015, due);
+    QVERIFY(due.empty());
+
+    wheel.advance(2000, due);
+    QCOMPARE(due, (std::vector<TimerWheel::TimerID> { 3, 1 }));
+    QVERIFY(wheel.isEmpty());
+    QCOMPARE(wheel.getNow(), (uint64_t)2000);
+}
+
+void TimerWheelTests::cascadeFromUpperLevels() {
+    TimerWheel wheel(255);
+    std::vector<TimerWheel::TimerID> due;
+
+    // one timer per level, and one past the reach of the wheel
+    const uint64_t deadlines[] = { 300, 70000, 20000000, 5000000000ULL, 255 + 65535 };
+    for (TimerWheel::TimerID i = 0; i < 5; i++) {
+        wheel.insert(i, deadlines[i]);
+    }
+
+    // each timer comes due on its tick, not before
+    std::vector<TimerWheel::TimerID> expected { 0, 4, 1, 2, 3 };
+    std::vector<uint64_t> sorted { 300, 255 + 65535, 70000, 20000000, 5000000000ULL };
+    for (size_t i = 0; i < sorted.size(); i++) {
+        due.clear();
+        wheel.advance(sorted[i] - 1, due);
+        QVERIFY(due.empty());
+        wheel.advance(sorted[i], due);
+        QCOMPARE(due, (std::vector<TimerWheel::TimerID> { expected[i] }));
+    }
+    QVERIFY(wheel.isEmpty());
+}
+
+void TimerWheelTests::nextDeadline() {
+    TimerWheel wheel(100);
+    QCOMPARE(wheel.getNextDeadline(), TimerWheel::NO_DEADLINE);
+
+    wheel.insert(1, 140);
+    QCOMPARE(wheel.getNextDeadline(), (uint64_t)140);
+
+    // far timers only wake the wheel up when its first level wraps, at 256
+    TimerWheel farWheel(100);
+    farWheel.insert(1, 10000);
+    QCOMPARE(farWheel.getNextDeadline(), (uint64_t)256);
+
+    farWheel.insert(2, 50);
+    QCOMPARE(farWheel.getNextDeadline(), (uint64_t)100);
+}
@@ -10,6 +10,9 @@
 
 #include <QtTest/QtTest>
 #include <QtGui/QDesktopServices>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 #include <Profile.h>
 
@@ -45,3 +48,31 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+
+void TraceTests::testRecording() {
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    QVERIFY(tracer->isRecording());
+    QVERIFY(!tracer->isEnabled());
+
+    // more events than the ring holds, only the latest ones are kept
+    for (int i = 0; i < 20000; ++i) {
+        PROFILE_RANGE(test, "RecordedEvent")
+    }
+    {
+        PROFILE_RANGE(test, "LastEvent")
+    }
+
+    auto json = QJsonDocument::fromJson(tracer->getRecording());
+    QVERIFY(json.isArray());
+    auto events = json.array();
+    QVERIFY(events.size() > 0);
+    QVERIFY(events.size() < 40000);
+    QCOMPARE(events.last().toObject()["name"].toString(), QString("LastEvent"));
+    QCOMPARE(events.last().toObject()["ph"].toString(), QString("E"));
+
+    tracer->stopRecording();
+    {
+        PROFILE_RANGE(test, "UnrecordedEvent")
+    }
+    QVERIFY(!tracer->getRecording().contains("UnrecordedEvent"));
+}
@@ -96,3 +96,18 @@ void TransformTests::getInverseMatrix() {
     QCOMPARE_WITH_ABS_ERROR(ya, yb, EPSILON);
     QCOMPARE_WITH_ABS_ERROR(za, zb, EPSILON);
 }
+
+void TransformTests::getMatrixAndInverse() {
+    Transform xform;
+    xform.setTranslation(vec3(1.0f, -2.0f, 10.0f));
+    xform.setRotation(glm::angleAxis(0.7f, glm::normalize(vec3(1.0f, 2.0f, 3.0f))));
+    xform.setScale(vec3(-1.0f, 2.0f, 0.5f));
+
+    mat4 matrix;
+    mat4 inverse;
+    xform.getMatrixAndInverse(matrix, inverse);
+
+    QCOMPARE_WITH_ABS_ERROR(matrix, xform.getMatrix(), EPSILON);
+    // a non uniform scale with a rotation, which getInverseMatrix() doesn't have right
+    QCOMPARE_WITH_ABS_ERROR(inverse, glm::inverse(matrix), EPSILON);
+}
@@ -18,6 +18,7 @@ class TransformTests : public QObject {
 private slots:
     void getMatrix();
     void getInverseMatrix();
+    void getMatrixAndInverse();
 };
 
 #endif // hifi_TransformTests_h
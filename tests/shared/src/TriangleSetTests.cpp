@@ -0,0 +1,96 @@
+//
+//  TriangleSetTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSetTests.h"
+
+#include <map>
+#include <vector>
+
+#include <SharedUtil.h>
+#include <TriangleSet.h>
+
+QTEST_MAIN(TriangleSetTests)
+
+static const int NUM_TRIANGLES = 1000;
+static const int NUM_RAYS = 1000;
+static const float DISTANCE_TOLERANCE = 0.0001f;
+
+static glm::vec3 randomPoint(float range) {
+    return glm::vec3(randFloatInRange(-range, range), randFloatInRange(-range, range), randFloatInRange(-range, range));
+}
+
+static std::vector<Triangle> randomTriangles() {
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < NUM_TRIANGLES; i++) {
+        glm::vec3 center = randomPoint(10.0f);
+        triangles.push_back({ center + randomPoint(0.5f), center + randomPoint(0.5f), center + randomPoint(0.5f) });
+    }
+    return triangles;
+}
+
+void TriangleSetTests::rayIntersectionMatchesScalar() {
+    srand(1);
+    std::vector<Triangle> triangles = randomTriangles();
+    TriangleSet triangleSet;
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+
+    int hits = 0;
+    for (int i = 0; i < NUM_RAYS; i++) {
+        glm::vec3 origin = randomPoint(20.0f);
+        glm::vec3 direction = glm::normalize(randomPoint(10.0f) - origin);
+
+        // the nearest intersection, one triangle at a time
+        bool expectedHit = false;
+        float expectedDistance = std::numeric_limits<float>::max();
+        for (const auto& triangle : triangles) {
+            float distance;
+            if (findRayTriangleIntersection(origin, direction, triangle, distance) && distance < expectedDistance) {
+                expectedDistance = distance;
+                expectedHit = true;
+            }
+        }
+
+        float distance;
+        BoxFace face;
+        glm::vec3 normal;
+        bool hit = triangleSet.findRayIntersection(origin, direction, distance, face, normal, true);
+        QCOMPARE(hit, expectedHit);
+        if (hit) {
+            QVERIFY(fabsf(distance - expectedDistance) < DISTANCE_TOLERANCE);
+            hits++;
+        }
+    }
+    // the rays aim at the triangles, enough of them should hit to make this meaningful
+    QVERIFY(hits > NUM_RAYS / 10);
+}
+
+void TriangleSetTests::benchmarkRayIntersection() {
+    srand(1);
+    TriangleSet triangleSet;
+    for (const auto& triangle : randomTriangles()) {
+        triangleSet.insert(triangle);
+    }
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays;
+    for (int i = 0; i < NUM_RAYS; i++) {
+        glm::vec3 origin = randomPoint(20.0f);
+        rays.push_back({ origin, glm::normalize(randomPoint(10.0f) - origin) });
+    }
+
+    QBENCHMARK {
+        for (const auto& ray : rays) {
+            float distance;
+            BoxFace face;
+            glm::vec3 normal;
+            triangleSet.findRayIntersection(ray.first, ray.second, distance, face, normal, true);
+        }
+    }
+}
@@ -0,0 +1,286 @@
+//
+//  LoadClient.cpp
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadClient.h"
+
+#include <QtCore/QFile>
+
+#include <AbstractAudioInterface.h>
+#include <AudioConstants.h>
+#include <EntityItemProperties.h>
+#include <MessagesClient.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <Transform.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+
+// without a recording the avatar walks a circle
+static const float WALK_RADIUS = 2.0f;
+static const float WALK_PERIOD_SECONDS = 20.0f;
+
+// the entity of a client that died is cleaned up by the entity server eventually
+static const float ENTITY_LIFETIME_SECONDS = 3600.0f;
+
+static const QString CHANNEL_PREFIX = "load-client.";
+
+LoadClient::LoadClient(const Settings& settings, QObject* parent) :
+    QObject(parent),
+    _settings(settings),
+    _avatar(std::make_shared<AvatarData>()),
+    _entityID(QUuid::createUuid())
+{
+    _origin = glm::vec3((randFloat() - 0.5f) * _settings.spread, 0.0f, (randFloat() - 0.5f) * _settings.spread);
+    _avatar->setPosition(_origin);
+    _avatar->setDisplayName("load-client");
+
+    // every edit is sent, they are the load
+    _entityEditSender.setEditCoalescingWindow(0);
+
+    for (auto timer : { &_avatarTimer, &_audioTimer, &_entityTimer, &_messageTimer }) {
+        timer->setTimerType(Qt::PreciseTimer);
+    }
+    connect(&_avatarTimer, &QTimer::timeout, this, &LoadClient::sendAvatar);
+    connect(&_audioTimer, &QTimer::timeout, this, &LoadClient::sendAudio);
+    connect(&_entityTimer, &QTimer::timeout, this, &LoadClient::sendEntityEdit);
+    connect(&_messageTimer, &QTimer::timeout, this, &LoadClient::sendMessage);
+    connect(&_reportTimer, &QTimer::timeout, this, &LoadClient::report);
+}
+
+QString LoadClient::getChannel() const {
+    return CHANNEL_PREFIX + _avatar->getSessionUUID().toString();
+}
+
+void LoadClient::start() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    connect(nodeList.data(), &NodeList::uuidChanged, this, [this](const QUuid& sessionUUID) {
+        _avatar->setSessionUUID(sessionUUID);
+        DependencyManager::get<MessagesClient>()->subscribe(getChannel());
+    });
+    connect(nodeList.data(), &NodeList::nodeActivated, this, &LoadClient::nodeActivated);
+
+    auto& packetReceiver = nodeList->getPacketReceiver();
+    packetReceiver.registerListener(PacketType::MixedAudio, this, "handleMixedAudio");
+    packetReceiver.registerListener(PacketType::SilentAudioFrame, this, "handleMixedAudio");
+    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "handleBulkAvatarData");
+
+    connect(DependencyManager::get<MessagesClient>().data(), &MessagesClient::messageReceived,
+            this, &LoadClient::handleMessage);
+
+    if (!_settings.audioFile.isEmpty()) {
+        QFile file(_settings.audioFile);
+        if (file.open(QIODevice::ReadOnly)) {
+            _audioClip = file.readAll();
+        } else {
+            qWarning() << "Cannot read audio clip" << _settings.audioFile;
+        }
+    }
+    if (!_settings.recordingFile.isEmpty()) {
+        loadRecording();
+    }
+
+    _startTime = usecTimestampNow();
+    _lastReportTime = _startTime;
+
+    if (_settings.avatarRate > 0.0f) {
+        _avatarTimer.start((int)(MSECS_PER_SECOND / _settings.avatarRate));
+    }
+    // the audio of a recording is sent as its frames play
+    if (!_audioClip.isEmpty() || _settings.recordingFile.isEmpty()) {
+        // a frame is not a whole number of milliseconds, frames are sent as they fall due
+        _nextAudioFrameTime = _startTime;
+        _audioTimer.start(1);
+    }
+    if (_settings.entityEditRate > 0.0f) {
+        _entityTimer.start((int)(MSECS_PER_SECOND / _settings.entityEditRate));
+    }
+    if (_settings.messageRate > 0.0f) {
+        _messageTimer.start((int)(MSECS_PER_SECOND / _settings.messageRate));
+    }
+    _reportTimer.start(_settings.reportIntervalSecs * MSECS_PER_SECOND);
+}
+
+void LoadClient::loadRecording() {
+    using namespace recording;
+    auto clip = Clip::fromFile(_settings.recordingFile);
+    if (!clip) {
+        qWarning() << "Cannot read recording" << _settings.recordingFile;
+        return;
+    }
+
+    static const FrameType AVATAR_FRAME_TYPE = Frame::registerFrameType(AvatarData::FRAME_NAME);
+    Frame::registerFrameHandler(AVATAR_FRAME_TYPE, [this](Frame::ConstPointer frame) {
+        AvatarData::fromFrame(frame->data, *_avatar);
+    });
+    if (_audioClip.isEmpty()) {
+        static const FrameType AUDIO_FRAME_TYPE = Frame::registerFrameType(AudioConstants::getAudioFrameName());
+        Frame::registerFrameHandler(AUDIO_FRAME_TYPE, [this](Frame::ConstPointer frame) {
+            sendAudioFrame(frame->data);
+        });
+    }
+
+    // the recording plays around where this client started, from a random point so that clients replaying it
+    // don't move in step
+    _avatar->setRecordingBasis();
+    _deck.queueClip(clip);
+    _deck.loop(true);
+    _deck.seek(randFloat() * clip->duration());
+    _deck.play();
+}
+
+void LoadClient::nodeActivated(SharedNodePointer node) {
+    if (node->getType() == NodeType::AvatarMixer) {
+        _avatar->markIdentityDataChanged();
+        _avatar->sendIdentityPacket();
+    } else if (node->getType() == NodeType::EntityServer && _settings.entityEditRate > 0.0f && !_entityAdded) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setName("load-client");
+        properties.setPosition(_origin + Vectors::UP);
+        properties.setDimensions(glm::vec3(0.2f));
+        properties.setLifetime(ENTITY_LIFETIME_SECONDS);
+        properties.setLastEdited(usecTimestampNow());
+        _entityEditSender.queueEditEntityMessage(PacketType::EntityAdd, EntityTreePointer(), _entityID, properties);
+        _entityEditSender.releaseQueuedMessages();
+        _entityAdded = true;
+    }
+}
+
+void LoadClient::sendAvatar() {
+    if (_avatar->getSessionUUID().isNull()) {
+        return;
+    }
+    if (_settings.recordingFile.isEmpty()) {
+        float angle = TWO_PI * (float)(usecTimestampNow() - _startTime) / USECS_PER_SECOND / WALK_PERIOD_SECONDS;
+        _avatar->setPosition(_origin + WALK_RADIUS * glm::vec3(cosf(angle), 0.0f, sinf(angle)));
+        _avatar->setOrientation(glm::angleAxis(-angle, Vectors::UP));
+    }
+    _avatar->sendAvatarDataPacket();
+    _counts.avatarSent++;
+}
+
+void LoadClient::sendAudio() {
+    static const int FRAME_BYTES = AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
+    while (_nextAudioFrameTime <= usecTimestampNow()) {
+        _nextAudioFrameTime += AudioConstants::NETWORK_FRAME_USECS;
+        if (_audioClip.size() < FRAME_BYTES) {
+            // keeps a stream open at the mixer, which mixes for this client all the same
+            sendAudioFrame(QByteArray());
+            continue;
+        }
+        if (_audioClipOffset + FRAME_BYTES > _audioClip.size()) {
+            _audioClipOffset = 0;
+        }
+        sendAudioFrame(_audioClip.mid(_audioClipOffset, FRAME_BYTES));
+        _audioClipOffset += FRAME_BYTES;
+    }
+}
+
+void LoadClient::sendAudioFrame(const QByteArray& frame) {
+    Transform transform;
+    transform.setTranslation(_avatar->getPosition());
+    transform.setRotation(_avatar->getOrientation());
+    auto packetType = frame.isEmpty() ? PacketType::SilentAudioFrame : PacketType::MicrophoneAudioNoEcho;
+    AbstractAudioInterface::emitAudioPacket(frame.constData(), frame.size(), _audioSequenceNumber, transform,
+                                            _avatar->getPosition(), glm::vec3(0.0f), packetType, QString());
+    _counts.audioSent++;
+}
+
+void LoadClient::sendEntityEdit() {
+    if (!_entityAdded) {
+        return;
+    }
+    float seconds = (float)(usecTimestampNow() - _startTime) / USECS_PER_SECOND;
+    EntityItemProperties properties;
+    properties.setPosition(_origin + Vectors::UP * (1.0f + 0.5f * sinf(seconds)));
+    properties.setLastEdited(usecTimestampNow());
+    _entityEditSender.queueEditEntityMessage(PacketType::EntityEdit, EntityTreePointer(), _entityID, properties);
+    _entityEditSender.releaseQueuedMessages();
+    _counts.entityEdits++;
+}
+
+void LoadClient::sendMessage() {
+    if (_avatar->getSessionUUID().isNull()) {
+        return;
+    }
+    DependencyManager::get<MessagesClient>()->sendMessage(getChannel(), QString::number(usecTimestampNow()));
+    _counts.messagesSent++;
+}
+
+void LoadClient::handleMessage(QString channel, QString message, QUuid senderUUID, bool localOnly) {
+    if (localOnly || senderUUID != _avatar->getSessionUUID() || channel != getChannel()) {
+        return;
+    }
+    uint64_t sent = message.toULongLong();
+    uint64_t now = usecTimestampNow();
+    if (sent == 0 || sent > now) {
+        return;
+    }
+    uint64_t roundTrip = now - sent;
+    _counts.messagesReceived++;
+    _counts.messageRoundTripUsecs += roundTrip;
+    _counts.maxMessageRoundTripUsecs = std::max(_counts.maxMessageRoundTripUsecs, roundTrip);
+}
+
+void LoadClient::handleMixedAudio(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    quint16 sequence;
+    message->readPrimitive(&sequence);
+
+    // a sequence number jumping far ahead is a mixer that restarted, not loss
+    static const quint16 MAX_SEQUENCE_GAP = 1000;
+    if (_hasMixedAudioSequence) {
+        quint16 gap = sequence - (quint16)(_lastMixedAudioSequence + 1);
+        if (gap < MAX_SEQUENCE_GAP) {
+            _counts.audioLost += gap;
+        }
+    }
+    _hasMixedAudioSequence = true;
+    _lastMixedAudioSequence = sequence;
+    _counts.audioReceived++;
+}
+
+void LoadClient::handleBulkAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    _counts.avatarReceived++;
+}
+
+void LoadClient::report() {
+    uint64_t now = usecTimestampNow();
+    double seconds = std::max((double)(now - _lastReportTime) / USECS_PER_SECOND, 0.001);
+    _lastReportTime = now;
+
+    auto mixerPing = [](NodeType_t type) {
+        auto node = DependencyManager::get<NodeList>()->soloNodeOfType(type);
+        return (node && node->getActiveSocket()) ? node->getPingMs() : -1;
+    };
+
+    int audioExpected = _counts.audioReceived + _counts.audioLost;
+    QJsonObject report {
+        { "connected", DependencyManager::get<NodeList>()->getDomainHandler().isConnected() },
+        { "avatarSentRate", _counts.avatarSent / seconds },
+        { "avatarReceivedRate", _counts.avatarReceived / seconds },
+        { "audioSentRate", _counts.audioSent / seconds },
+        { "audioReceivedRate", _counts.audioReceived / seconds },
+        { "audioLoss", audioExpected > 0 ? (double)_counts.audioLost / audioExpected : 0.0 },
+        { "entityEditRate", _counts.entityEdits / seconds },
+        { "messageSentRate", _counts.messagesSent / seconds },
+        { "messageReceivedRate", _counts.messagesReceived / seconds },
+        { "messageRoundTripMsecs", _counts.messagesReceived > 0 ?
+            (double)_counts.messageRoundTripUsecs / _counts.messagesReceived / USECS_PER_MSEC : 0.0 },
+        { "maxMessageRoundTripMsecs", (double)_counts.maxMessageRoundTripUsecs / USECS_PER_MSEC },
+        { "avatarMixerPingMsecs", mixerPing(NodeType::AvatarMixer) },
+        { "audioMixerPingMsecs", mixerPing(NodeType::AudioMixer) },
+        { "messagesMixerPingMsecs", mixerPing(NodeType::MessagesMixer) },
+        { "entityServerPingMsecs", mixerPing(NodeType::EntityServer) }
+    };
+    _counts = Counts();
+
+    emit reported(report);
+}
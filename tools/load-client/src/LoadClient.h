@@ -0,0 +1,108 @@
+//
+//  LoadClient.h
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadClient_h
+#define hifi_LoadClient_h
+
+#include <memory>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <AvatarData.h>
+#include <EntityEditPacketSender.h>
+#include <EntityItemID.h>
+#include <Node.h>
+#include <ReceivedMessage.h>
+#include <recording/Deck.h>
+
+// One synthetic client of a domain: an avatar replaying a recording, or walking a circle without one, that streams
+// audio to the audio mixer, and optionally edits an entity of its own and echoes messages through the messages mixer.
+// Every report interval it reports what it sent, what came back and the round trip of its messages.
+class LoadClient : public QObject {
+    Q_OBJECT
+public:
+    struct Settings {
+        QString recordingFile;      // .hfr, its avatar frames and audio frames are replayed
+        QString audioFile;          // raw 24 kHz mono 16 bit, looped, instead of the audio of the recording
+        float avatarRate { 45.0f }; // per second
+        float entityEditRate { 0.0f };
+        float messageRate { 1.0f };
+        float spread { 10.0f };     // meters around the origin the client starts in
+        int reportIntervalSecs { 5 };
+    };
+
+    LoadClient(const Settings& settings, QObject* parent = nullptr);
+
+    void start();
+
+signals:
+    // rates per second over the last interval and the round trip of the messages
+    void reported(QJsonObject report);
+
+private slots:
+    void sendAvatar();
+    void sendAudio();
+    void sendEntityEdit();
+    void sendMessage();
+    void report();
+
+    void nodeActivated(SharedNodePointer node);
+    void handleMessage(QString channel, QString message, QUuid senderUUID, bool localOnly);
+    void handleMixedAudio(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+    void handleBulkAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+
+private:
+    void loadRecording();
+    void sendAudioFrame(const QByteArray& frame);
+    QString getChannel() const;
+
+    Settings _settings;
+    std::shared_ptr<AvatarData> _avatar;
+    recording::Deck _deck;
+    glm::vec3 _origin;
+    uint64_t _startTime { 0 };
+
+    QByteArray _audioClip;
+    int _audioClipOffset { 0 };
+    quint16 _audioSequenceNumber { 0 };
+    uint64_t _nextAudioFrameTime { 0 };
+
+    EntityEditPacketSender _entityEditSender;
+    EntityItemID _entityID;
+    bool _entityAdded { false };
+
+    QTimer _avatarTimer;
+    QTimer _audioTimer;
+    QTimer _entityTimer;
+    QTimer _messageTimer;
+    QTimer _reportTimer;
+
+    struct Counts {
+        int avatarSent { 0 };
+        int avatarReceived { 0 };
+        int audioSent { 0 };
+        int audioReceived { 0 };
+        int audioLost { 0 };
+        int entityEdits { 0 };
+        int messagesSent { 0 };
+        int messagesReceived { 0 };
+        uint64_t messageRoundTripUsecs { 0 };
+        uint64_t maxMessageRoundTripUsecs { 0 };
+    };
+    Counts _counts;
+    uint64_t _lastReportTime { 0 };
+
+    bool _hasMixedAudioSequence { false };
+    quint16 _lastMixedAudioSequence { 0 };
+};
+
+#endif // hifi_LoadClient_h
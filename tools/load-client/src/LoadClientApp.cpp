@@ -0,0 +1,335 @@
+//
+//  LoadClientApp.cpp
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadClientApp.h"
+
+#include <cstdio>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QLoggingCategory>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <DependencyManager.h>
+#include <MessagesClient.h>
+#include <NetworkLogging.h>
+#include <NetworkingConstants.h>
+#include <NumericalConstants.h>
+#include <SettingHandle.h>
+#include <SharedLogging.h>
+#include <SharedUtil.h>
+
+#include <BuildInfo.h>
+
+// the report fields summed over the clients, the others are averaged or, for the maxima, the largest
+static const QStringList SUMMED_FIELDS = {
+    "avatarSentRate", "avatarReceivedRate", "audioSentRate", "audioReceivedRate",
+    "entityEditRate", "messageSentRate", "messageReceivedRate"
+};
+
+LoadClientApp::LoadClientApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    setApplicationName(BuildInfo::LOAD_CLIENT_NAME);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity synthetic load client");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "127.0.0.1");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption recordingOption("recording", "avatar recording (.hfr) to replay", "path");
+    parser.addOption(recordingOption);
+
+    const QCommandLineOption audioOption("audio", "raw 24 kHz mono 16 bit audio to loop", "path");
+    parser.addOption(audioOption);
+
+    const QCommandLineOption avatarRateOption("avatar-rate", "avatar updates per second", "45");
+    parser.addOption(avatarRateOption);
+
+    const QCommandLineOption entityEditRateOption("entity-edit-rate", "entity edits per second", "0");
+    parser.addOption(entityEditRateOption);
+
+    const QCommandLineOption messageRateOption("message-rate", "messages per second", "1");
+    parser.addOption(messageRateOption);
+
+    const QCommandLineOption spreadOption("spread", "meters around the origin the clients start in", "10");
+    parser.addOption(spreadOption);
+
+    const QCommandLineOption reportIntervalOption("report-interval", "seconds between reports", "5");
+    parser.addOption(reportIntervalOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run, forever if 0", "0");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption clientsOption("clients", "number of client processes to spawn", "1");
+    parser.addOption(clientsOption);
+
+    const QCommandLineOption spawnIntervalOption("spawn-interval", "milliseconds between spawned clients", "200");
+    parser.addOption(spawnIntervalOption);
+
+    const QCommandLineOption jsonOption("json", "print the reports as JSON lines");
+    parser.addOption(jsonOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _verbose = parser.isSet(verboseOutput);
+    _json = parser.isSet(jsonOption);
+    if (!_verbose) {
+        QLoggingCategory::setFilterRules("qt.network.ssl.warning=false");
+
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtWarningMsg, false);
+
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtWarningMsg, false);
+    }
+
+    QString domainServerAddress = "127.0.0.1:40103";
+    if (parser.isSet(domainAddressOption)) {
+        domainServerAddress = parser.value(domainAddressOption);
+    }
+
+    LoadClient::Settings settings;
+    settings.recordingFile = parser.value(recordingOption);
+    settings.audioFile = parser.value(audioOption);
+    if (parser.isSet(avatarRateOption)) {
+        settings.avatarRate = parser.value(avatarRateOption).toFloat();
+    }
+    if (parser.isSet(entityEditRateOption)) {
+        settings.entityEditRate = parser.value(entityEditRateOption).toFloat();
+    }
+    if (parser.isSet(messageRateOption)) {
+        settings.messageRate = parser.value(messageRateOption).toFloat();
+    }
+    if (parser.isSet(spreadOption)) {
+        settings.spread = parser.value(spreadOption).toFloat();
+    }
+    if (parser.isSet(reportIntervalOption)) {
+        settings.reportIntervalSecs = std::max(parser.value(reportIntervalOption).toInt(), 1);
+    }
+    _reportIntervalSecs = settings.reportIntervalSecs;
+
+    int duration = parser.value(durationOption).toInt();
+    if (duration > 0) {
+        QTimer::singleShot(duration * MSECS_PER_SECOND, this, [this] { finish(0); });
+    }
+
+    int clients = parser.isSet(clientsOption) ? parser.value(clientsOption).toInt() : 1;
+    if (clients > 1) {
+        // the spawned clients get the same settings, they run until this monitor stops them
+        _clientArguments = QStringList { "-d", domainServerAddress, "--clients", "1", "--json",
+            "--avatar-rate", QString::number(settings.avatarRate),
+            "--entity-edit-rate", QString::number(settings.entityEditRate),
+            "--message-rate", QString::number(settings.messageRate),
+            "--spread", QString::number(settings.spread),
+            "--report-interval", QString::number(settings.reportIntervalSecs) };
+        if (!settings.recordingFile.isEmpty()) {
+            _clientArguments << "--recording" << settings.recordingFile;
+        }
+        if (!settings.audioFile.isEmpty()) {
+            _clientArguments << "--audio" << settings.audioFile;
+        }
+        int spawnInterval = parser.isSet(spawnIntervalOption) ? parser.value(spawnIntervalOption).toInt() : 200;
+        startMonitor(clients, spawnInterval);
+    } else {
+        startClient(settings, domainServerAddress);
+    }
+}
+
+void LoadClientApp::startClient(const LoadClient::Settings& settings, const QString& domainServerAddress) {
+    if (_verbose) {
+        qDebug() << "domain-server address is" << domainServerAddress;
+    }
+
+    Setting::init();
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityLoadClient)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent);
+
+    auto accountManager = DependencyManager::get<AccountManager>();
+    accountManager->setIsAgent(true);
+    accountManager->setAuthURL(NetworkingConstants::METAVERSE_SERVER_URL);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // setup a timer for domain-server check ins
+    QTimer* domainCheckInTimer = new QTimer(nodeList.data());
+    connect(domainCheckInTimer, &QTimer::timeout, nodeList.data(), &NodeList::sendDomainServerCheckIn);
+    domainCheckInTimer->start(DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    // start the nodeThread so its event loop is running
+    // (must happen after the checkin timer is created with the nodelist as it's parent)
+    nodeList->startThread();
+
+    auto messagesClient = DependencyManager::set<MessagesClient>();
+    messagesClient->startThread();
+
+    const DomainHandler& domainHandler = nodeList->getDomainHandler();
+    connect(&domainHandler, &DomainHandler::domainConnectionRefused, this, &LoadClientApp::domainConnectionRefused);
+    connect(nodeList.data(), &NodeList::packetVersionMismatch, this, &LoadClientApp::notifyPacketVersionMismatch);
+    nodeList->addSetOfNodeTypesToNodeInterestSet(NodeSet() << NodeType::AudioMixer << NodeType::AvatarMixer
+                                                 << NodeType::EntityServer << NodeType::MessagesMixer);
+
+    _client = new LoadClient(settings, this);
+    connect(_client, &LoadClient::reported, this, &LoadClientApp::printReport);
+    _client->start();
+
+    DependencyManager::get<AddressManager>()->handleLookupString(domainServerAddress, false);
+}
+
+void LoadClientApp::startMonitor(int clients, int spawnIntervalMsecs) {
+    _clientsToSpawn = clients;
+    connect(&_spawnTimer, &QTimer::timeout, this, &LoadClientApp::spawnClient);
+    // staggered, a thousand clients connecting at once measure the domain-server rather than the mixers
+    _spawnTimer.start(std::max(spawnIntervalMsecs, 1));
+
+    connect(&_aggregateTimer, &QTimer::timeout, this, &LoadClientApp::printAggregate);
+    _aggregateTimer.start(_reportIntervalSecs * MSECS_PER_SECOND);
+}
+
+void LoadClientApp::spawnClient() {
+    if (_processes.size() >= _clientsToSpawn) {
+        _spawnTimer.stop();
+        return;
+    }
+    auto process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    connect(process, &QProcess::readyReadStandardOutput, this, &LoadClientApp::readClientReports);
+    connect(process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            this, [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
+        qWarning() << "Client" << _processes.indexOf(process) << "exited with" << exitCode;
+        _lastReports.remove(process);
+    });
+    process->start(applicationFilePath(), _clientArguments);
+    _processes.push_back(process);
+}
+
+void LoadClientApp::readClientReports() {
+    auto process = qobject_cast<QProcess*>(sender());
+    if (!process) {
+        return;
+    }
+    while (process->canReadLine()) {
+        auto document = QJsonDocument::fromJson(process->readLine());
+        if (document.isObject()) {
+            _lastReports[process] = document.object();
+        }
+    }
+}
+
+void LoadClientApp::printAggregate() {
+    QJsonObject aggregate;
+    QMap<QString, int> counts;
+    int connected = 0;
+    for (const auto& report : _lastReports) {
+        connected += report["connected"].toBool() ? 1 : 0;
+        for (auto it = report.begin(); it != report.end(); ++it) {
+            if (!it.value().isDouble()) {
+                continue;
+            }
+            double value = it.value().toDouble();
+            if (it.key().endsWith("PingMsecs") && value < 0.0) {
+                continue;
+            }
+            double current = aggregate[it.key()].toDouble();
+            if (it.key().startsWith("max")) {
+                aggregate[it.key()] = std::max(current, value);
+            } else {
+                aggregate[it.key()] = current + value;
+                counts[it.key()]++;
+            }
+        }
+    }
+    for (auto it = counts.begin(); it != counts.end(); ++it) {
+        if (!SUMMED_FIELDS.contains(it.key())) {
+            aggregate[it.key()] = aggregate[it.key()].toDouble() / it.value();
+        }
+    }
+    aggregate["clients"] = _processes.size();
+    aggregate["reporting"] = _lastReports.size();
+    aggregate["connected"] = connected;
+
+    printReport(aggregate);
+}
+
+void LoadClientApp::printReport(QJsonObject report) {
+    if (_json) {
+        // one line per report, read by the monitor
+        fprintf(stdout, "%s\n", QJsonDocument(report).toJson(QJsonDocument::Compact).constData());
+    } else {
+        QString line = QString::number(usecTimestampNow() / USECS_PER_SECOND);
+        for (auto it = report.begin(); it != report.end(); ++it) {
+            line += " " + it.key() + "=" + (it.value().isBool() ? QString(it.value().toBool() ? "true" : "false") :
+                QString::number(it.value().toDouble(), 'g', 4));
+        }
+        fprintf(stdout, "%s\n", qPrintable(line));
+    }
+    fflush(stdout);
+}
+
+void LoadClientApp::domainConnectionRefused(const QString& reasonMessage, int reasonCodeInt, const QString& extraInfo) {
+    qWarning() << "Domain connection refused:" << reasonMessage;
+}
+
+void LoadClientApp::notifyPacketVersionMismatch() {
+    qWarning() << "Packet version mismatch, the load client and the domain are different builds";
+    finish(1);
+}
+
+void LoadClientApp::finish(int exitCode) {
+    if (!_processes.isEmpty()) {
+        for (auto process : _processes) {
+            process->disconnect(this);
+            process->terminate();
+        }
+        for (auto process : _processes) {
+            if (!process->waitForFinished(MSECS_PER_SECOND)) {
+                process->kill();
+            }
+        }
+        QCoreApplication::exit(exitCode);
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (nodeList) {
+        // send the domain a disconnect packet, force stoppage of domain-server check-ins
+        nodeList->getDomainHandler().disconnect();
+        nodeList->setIsShuttingDown(true);
+
+        // tell the packet receiver we're shutting down, so it can drop packets
+        nodeList->getPacketReceiver().setShouldDropPackets(true);
+
+        // remove the NodeList from the DependencyManager
+        DependencyManager::destroy<NodeList>();
+    }
+
+    QCoreApplication::exit(exitCode);
+}
@@ -0,0 +1,60 @@
+//
+//  LoadClientApp.h
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadClientApp_h
+#define hifi_LoadClientApp_h
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QProcess>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+#include <NodeList.h>
+
+#include "LoadClient.h"
+
+// Connects one synthetic client to a domain, or with --clients N above one, spawns N client processes and aggregates
+// their reports. The NodeList is a singleton, so a process can't be more than one client of a domain.
+class LoadClientApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    LoadClientApp(int argc, char* argv[]);
+
+private slots:
+    void domainConnectionRefused(const QString& reasonMessage, int reasonCodeInt, const QString& extraInfo);
+    void notifyPacketVersionMismatch();
+    void printReport(QJsonObject report);
+
+    void spawnClient();
+    void readClientReports();
+    void printAggregate();
+
+private:
+    void startClient(const LoadClient::Settings& settings, const QString& domainServerAddress);
+    void startMonitor(int clients, int spawnIntervalMsecs);
+    void finish(int exitCode);
+
+    bool _verbose { false };
+    bool _json { false };
+    int _reportIntervalSecs { 5 };
+    LoadClient* _client { nullptr };
+
+    // monitor
+    QStringList _clientArguments;
+    QList<QProcess*> _processes;
+    int _clientsToSpawn { 0 };
+    QTimer _spawnTimer;
+    QTimer _aggregateTimer;
+    QMap<QProcess*, QJsonObject> _lastReports;
+};
+
+#endif // hifi_LoadClientApp_h